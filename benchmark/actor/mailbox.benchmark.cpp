@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// A scheduler that doesn't run anything until asked to, which isolates the cost of
+// pushing and receiving messages from that of thread hand-off.
+class ManualScheduler : public Scheduler {
+public:
+    void schedule(std::weak_ptr<Mailbox> mailbox) override {
+        pending.push_back(std::move(mailbox));
+    }
+
+    void run() {
+        while (!pending.empty()) {
+            auto mailbox = std::move(pending.back());
+            pending.pop_back();
+            Mailbox::maybeReceive(std::move(mailbox));
+        }
+    }
+
+private:
+    std::vector<std::weak_ptr<Mailbox>> pending;
+};
+
+class Counter {
+public:
+    Counter(ActorRef<Counter>) {}
+
+    void add(std::size_t value) {
+        sum += value;
+    }
+
+    void signal(std::promise<void>* promise) {
+        promise->set_value();
+    }
+
+    std::size_t sum = 0;
+};
+
+} // end namespace
+
+static void Actor_PushReceive(::benchmark::State& state) {
+    // Real processes always have worker threads; without one, the C library may take
+    // single-threaded shortcuts for locks and reference counts, skewing the results.
+    ThreadPool pool(1);
+
+    ManualScheduler scheduler;
+    Actor<Counter> counter(scheduler);
+
+    const std::size_t batch = state.range_x();
+    while (state.KeepRunning()) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            counter.invoke(&Counter::add, i);
+        }
+        scheduler.run();
+    }
+
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+static void Actor_MultipleProducers(::benchmark::State& state) {
+    ThreadPool pool(1);
+    Actor<Counter> counter(pool);
+    ActorRef<Counter> ref = counter.self();
+
+    const std::size_t producers = state.range_x();
+    constexpr std::size_t messagesPerProducer = 10000;
+
+    while (state.KeepRunning()) {
+        std::vector<std::thread> threads;
+        for (std::size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&] {
+                for (std::size_t i = 0; i < messagesPerProducer; ++i) {
+                    ref.invoke(&Counter::add, i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        std::promise<void> done;
+        counter.invoke(&Counter::signal, &done);
+        done.get_future().wait();
+    }
+
+    state.SetItemsProcessed(state.iterations() * producers * messagesPerProducer);
+}
+
+BENCHMARK(Actor_PushReceive)->Arg(1)->Arg(64)->Arg(1024);
+BENCHMARK(Actor_MultipleProducers)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
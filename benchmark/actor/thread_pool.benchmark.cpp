@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Number of actors that wake up at once, comparable to the number of tiles in a viewport
+// after a style change.
+constexpr std::size_t tileCount = 256;
+
+// Number of messages each tile actor processes, e.g. setData, setLayers, glyphs and icons
+// becoming available and a few placement configs.
+constexpr std::size_t messagesPerTile = 8;
+
+class TileWorkerStub {
+public:
+    TileWorkerStub(ActorRef<TileWorkerStub> self_, std::atomic<std::size_t>& remaining_, std::promise<void>& done_)
+        : self(std::move(self_)), remaining(remaining_), done(done_) {
+    }
+
+    void layout(std::size_t step) {
+        // Stand-in for a chunk of layout work.
+        double sum = 0;
+        for (std::size_t i = 1; i < 2000; ++i) {
+            sum += std::sqrt(double(i * (step + 1)));
+        }
+        ::benchmark::DoNotOptimize(sum);
+
+        if (step + 1 < messagesPerTile) {
+            self.invoke(&TileWorkerStub::layout, step + 1);
+        } else if (remaining.fetch_sub(1) == 1) {
+            done.set_value();
+        }
+    }
+
+private:
+    ActorRef<TileWorkerStub> self;
+    std::atomic<std::size_t>& remaining;
+    std::promise<void>& done;
+};
+
+template <class Pool>
+void layoutTiles(::benchmark::State& state) {
+    Pool pool(state.range_x());
+
+    while (state.KeepRunning()) {
+        std::atomic<std::size_t> remaining { tileCount };
+        std::promise<void> done;
+
+        std::vector<std::unique_ptr<Actor<TileWorkerStub>>> tiles;
+        tiles.reserve(tileCount);
+        for (std::size_t i = 0; i < tileCount; ++i) {
+            tiles.push_back(std::make_unique<Actor<TileWorkerStub>>(pool, std::ref(remaining), std::ref(done)));
+        }
+
+        for (auto& tile : tiles) {
+            tile->invoke(&TileWorkerStub::layout, std::size_t(0));
+        }
+
+        done.get_future().wait();
+    }
+
+    // Reported as items/s, i.e. tiles per second.
+    state.SetItemsProcessed(state.iterations() * tileCount);
+}
+
+void threadCounts(::benchmark::internal::Benchmark* benchmark) {
+    const int cores = std::max(1u, std::thread::hardware_concurrency());
+    for (int threads = 1; threads < cores; threads *= 2) {
+        benchmark->Arg(threads);
+    }
+    benchmark->Arg(cores);
+}
+
+} // end namespace
+
+static void Actor_ThreadPool(::benchmark::State& state) {
+    layoutTiles<ThreadPool>(state);
+}
+
+static void Actor_WorkStealingThreadPool(::benchmark::State& state) {
+    layoutTiles<WorkStealingThreadPool>(state);
+}
+
+BENCHMARK(Actor_ThreadPool)->Apply(threadCounts)->UseRealTime();
+BENCHMARK(Actor_WorkStealingThreadPool)->Apply(threadCounts)->UseRealTime();
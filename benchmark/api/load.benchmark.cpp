@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/backend_scope.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/gl/offscreen_view.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/test/simulated_file_source.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <cstdio>
+
+using namespace mbgl;
+
+namespace {
+
+const LatLng manhattan { 40.726989, -73.992857 };
+
+SimulatedFileSource::Conditions conditions(int64_t index) {
+    switch (index) {
+    case 0:
+        return SimulatedFileSource::Conditions::datacenter();
+    case 1:
+        return SimulatedFileSource::Conditions::lte();
+    default:
+        return SimulatedFileSource::Conditions::threeG();
+    }
+}
+
+const char* const conditionNames[] = { "datacenter", "lte", "3g" };
+
+} // end namespace
+
+// Loads and renders the view of render.benchmark.cpp with a new map each iteration, answering
+// its requests from the fixture as a network with the conditions given by the argument would:
+// 0 for a datacenter, 1 for LTE and 2 for 3G. Each condition sees the same latencies and
+// failures on every run.
+static void API_loadView(::benchmark::State& state) {
+    util::RunLoop loop;
+    HeadlessBackend backend;
+    BackendScope scope { backend };
+    OffscreenView view { backend.getContext(), { 1000, 1000 } };
+    ThreadPool threadPool { 4 };
+
+    NetworkStatus::Set(NetworkStatus::Status::Offline);
+    DefaultFileSource origin { "benchmark/fixtures/api/cache.db", "." };
+    origin.setAccessToken("foobar");
+    SimulatedFileSource fileSource { origin, conditions(state.range_x()) };
+
+    const std::string style = util::read_file("benchmark/fixtures/api/query_style.json");
+
+    while (state.KeepRunning()) {
+        Map map { backend, view.getSize(), 1, fileSource, threadPool, MapMode::Still };
+        map.setStyleJSON(style);
+        map.setLatLngZoom(manhattan, 15);
+        mbgl::benchmark::render(map, view);
+    }
+
+    const SimulatedFileSource::Stats& stats = fileSource.getStats();
+    char label[128];
+    std::snprintf(label, sizeof(label), "%s requests=%zu failures=%zu maxWaiting=%zu",
+                  conditionNames[state.range_x()], stats.requests, stats.failures, stats.maxWaiting);
+    state.SetLabel(label);
+    state.SetBytesProcessed(stats.bytes);
+}
+
+BENCHMARK(API_loadView)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
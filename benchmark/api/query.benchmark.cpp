@@ -69,6 +69,34 @@ static void API_queryRenderedFeaturesLayerFromHighDensity(::benchmark::State& st
     }
 }
 
+static void API_queryRenderedFeatureHandlesAll(::benchmark::State& state) {
+    QueryBenchmark bench;
+
+    while (state.KeepRunning()) {
+        bench.map.queryRenderedFeatureHandles(bench.box);
+    }
+}
+
+static void API_queryRenderedFeatureHandlesLayerFromHighDensity(::benchmark::State& state) {
+    QueryBenchmark bench;
+
+    while (state.KeepRunning()) {
+        bench.map.queryRenderedFeatureHandles(bench.box, {{{"road-street" }}, {}});
+    }
+}
+
+static void API_queryRenderedFeatureHandlesPoint(::benchmark::State& state) {
+    QueryBenchmark bench;
+    const ScreenCoordinate point { 500, 500 };
+
+    while (state.KeepRunning()) {
+        bench.map.queryRenderedFeatureHandles(point);
+    }
+}
+
 BENCHMARK(API_queryRenderedFeaturesAll);
 BENCHMARK(API_queryRenderedFeaturesLayerFromLowDensity);
 BENCHMARK(API_queryRenderedFeaturesLayerFromHighDensity);
+BENCHMARK(API_queryRenderedFeatureHandlesAll);
+BENCHMARK(API_queryRenderedFeatureHandlesLayerFromHighDensity);
+BENCHMARK(API_queryRenderedFeatureHandlesPoint);
@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/map/camera.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/backend_scope.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/gl/offscreen_view.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/sprite/sprite_image.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <cmath>
+
+using namespace mbgl;
+
+namespace {
+
+// The fixture only contains the tiles at zoom level 15 around this point, so the camera must
+// stay between zoom levels 15 and 16 to keep the map from waiting for tiles that it can't get.
+const LatLng manhattan { 40.726989, -73.992857 };
+
+class RenderBenchmark {
+public:
+    RenderBenchmark(MapMode mode) : map(backend, view.getSize(), 1, fileSource, threadPool, mode) {
+        NetworkStatus::Set(NetworkStatus::Status::Offline);
+        fileSource.setAccessToken("foobar");
+
+        map.setStyleJSON(util::read_file("benchmark/fixtures/api/query_style.json"));
+        map.setLatLngZoom(manhattan, 15);
+
+        auto decoded = decodeImage(util::read_file("benchmark/fixtures/api/default_marker.png"));
+        auto image = std::make_unique<SpriteImage>(std::move(decoded), 1.0);
+        map.addImage("test-icon", std::move(image));
+    }
+
+    util::RunLoop loop;
+    HeadlessBackend backend;
+    BackendScope scope { backend };
+    OffscreenView view{ backend.getContext(), { 1000, 1000 } };
+    DefaultFileSource fileSource{ "benchmark/fixtures/api/cache.db", "." };
+    ThreadPool threadPool{ 4 };
+    Map map;
+};
+
+} // end namespace
+
+// Renders the same view repeatedly. The argument is the zoom level multiplied by 10.
+static void API_renderStill(::benchmark::State& state) {
+    RenderBenchmark bench { MapMode::Still };
+    bench.map.setZoom(state.range_x() / 10.0);
+    mbgl::benchmark::render(bench.map, bench.view);
+
+    while (state.KeepRunning()) {
+        mbgl::benchmark::render(bench.map, bench.view);
+    }
+}
+
+// Renders the frames of flyTo() animations back and forth across Manhattan. Each iteration is
+// a frame; use --benchmark_repetitions to see how much frame times vary.
+static void API_renderFlyTo(::benchmark::State& state) {
+    RenderBenchmark bench { MapMode::Continuous };
+
+    bench.map.render(bench.view);
+    while (!bench.map.isFullyLoaded()) {
+        util::RunLoop::Get()->runOnce();
+        bench.map.render(bench.view);
+    }
+
+    const std::vector<CameraOptions> cameras = [] {
+        CameraOptions a;
+        a.center = LatLng { 40.7245, -73.9975 };
+        a.zoom = 15.5;
+        CameraOptions b;
+        b.center = LatLng { 40.7295, -73.9880 };
+        b.zoom = 15.8;
+        return std::vector<CameraOptions> { a, b };
+    }();
+
+    bool flying = false;
+    std::size_t next = 0;
+    AnimationOptions animation { Milliseconds(1000) };
+    animation.minZoom = 15;
+    animation.transitionFinishFn = [&] { flying = false; };
+
+    while (state.KeepRunning()) {
+        if (!flying) {
+            flying = true;
+            bench.map.flyTo(cameras[next], animation);
+            next = (next + 1) % cameras.size();
+        }
+        bench.map.render(bench.view);
+    }
+}
+
+// Renders the frames of a rotation of the map by one degree per frame, which places the symbols
+// again at each angle and orders those that may overlap by their position on the screen.
+static void API_renderRotate(::benchmark::State& state) {
+    RenderBenchmark bench { MapMode::Continuous };
+    bench.map.setPitch(45);
+
+    bench.map.render(bench.view);
+    while (!bench.map.isFullyLoaded()) {
+        util::RunLoop::Get()->runOnce();
+        bench.map.render(bench.view);
+    }
+
+    double bearing = 0;
+    while (state.KeepRunning()) {
+        bearing = std::fmod(bearing + 1, 360);
+        bench.map.setBearing(bearing);
+        util::RunLoop::Get()->runOnce();
+        bench.map.render(bench.view);
+    }
+}
+
+BENCHMARK(API_renderStill)->Arg(150)->Arg(154)->Arg(158);
+BENCHMARK(API_renderFlyTo);
+BENCHMARK(API_renderRotate);
@@ -0,0 +1,296 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/map/camera.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/backend_scope.hpp>
+#include <mbgl/map/frame_stats.hpp>
+#include <mbgl/map/memory_usage.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/gl/offscreen_view.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Recorded gestures, replayed against the fixture of render.benchmark.cpp, which only contains
+// the tiles at zoom level 15 around Lower Manhattan. A trace is a starting camera and camera
+// changes at times in milliseconds from the start of the trace:
+//
+//   { "start": camera, "events": [ { "time": 0, "type": "jumpTo", ...camera }, ... ] }
+//
+// The types are jumpTo, easeTo and flyTo; the last two take a "duration" in milliseconds. A
+// camera has any of "center" ([longitude, latitude]), "zoom", "bearing" and "pitch" in degrees.
+const char* const traces[] = {
+    "pan",
+    "pinch",
+    "animate",
+};
+
+// The interval of the display that frames are paced to.
+const Duration frameInterval = std::chrono::microseconds(16667);
+
+// How long a trace may take to load what its last view needs, after its last camera change.
+const Duration completionTimeout = Seconds(10);
+
+struct TraceEvent {
+    enum class Type { JumpTo, EaseTo, FlyTo };
+
+    Duration time;
+    Type type;
+    CameraOptions camera;
+    Duration duration;
+};
+
+struct Trace {
+    CameraOptions start;
+    std::vector<TraceEvent> events;
+
+    // When the last camera change of the trace ends.
+    Duration end() const {
+        Duration result = Duration::zero();
+        for (const auto& event : events) {
+            result = std::max(result, event.time + event.duration);
+        }
+        return result;
+    }
+};
+
+CameraOptions parseCamera(const JSValue& value) {
+    CameraOptions camera;
+    if (value.HasMember("center")) {
+        const JSValue& center = value["center"];
+        camera.center = LatLng { center[rapidjson::SizeType(1)].GetDouble(), center[rapidjson::SizeType(0)].GetDouble() };
+    }
+    if (value.HasMember("zoom")) {
+        camera.zoom = value["zoom"].GetDouble();
+    }
+    if (value.HasMember("bearing")) {
+        camera.angle = -value["bearing"].GetDouble() * util::DEG2RAD;
+    }
+    if (value.HasMember("pitch")) {
+        camera.pitch = value["pitch"].GetDouble() * util::DEG2RAD;
+    }
+    return camera;
+}
+
+Trace parseTrace(const std::string& name) {
+    JSDocument document;
+    document.Parse<0>(util::read_file("benchmark/fixtures/api/traces/" + name + ".json").c_str());
+    if (document.HasParseError() || !document.IsObject()) {
+        throw std::runtime_error("malformed trace " + name);
+    }
+
+    Trace trace;
+    trace.start = parseCamera(document["start"]);
+    for (const auto& value : document["events"].GetArray()) {
+        TraceEvent event;
+        event.time = Milliseconds(value["time"].GetInt());
+        const std::string type = value["type"].GetString();
+        if (type == "jumpTo") {
+            event.type = TraceEvent::Type::JumpTo;
+        } else if (type == "easeTo") {
+            event.type = TraceEvent::Type::EaseTo;
+        } else if (type == "flyTo") {
+            event.type = TraceEvent::Type::FlyTo;
+        } else {
+            throw std::runtime_error("unknown camera change " + type + " in trace " + name);
+        }
+        event.camera = parseCamera(value);
+        event.duration = value.HasMember("duration") ? Milliseconds(value["duration"].GetInt())
+                                                     : Duration::zero();
+        trace.events.push_back(std::move(event));
+    }
+    return trace;
+}
+
+// Draws frames only when the map asks for one, like the platforms do.
+class ReplayBackend : public HeadlessBackend {
+public:
+    void invalidate() override {
+        needsRender = true;
+    }
+
+    bool needsRender = false;
+};
+
+class ReplayBenchmark {
+public:
+    ReplayBenchmark() : map(backend, view.getSize(), 1, fileSource, threadPool, MapMode::Continuous) {
+        NetworkStatus::Set(NetworkStatus::Status::Offline);
+        fileSource.setAccessToken("foobar");
+        map.setStyleJSON(util::read_file("benchmark/fixtures/api/query_style.json"));
+    }
+
+    // Moves the camera to the start of the trace and waits for the view to load, untimed.
+    void reset(const Trace& trace) {
+        map.cancelTransitions();
+        map.jumpTo(trace.start);
+        do {
+            loop.runOnce();
+            map.render(view);
+        } while (!map.isFullyLoaded());
+        backend.needsRender = false;
+    }
+
+    util::RunLoop loop;
+    ReplayBackend backend;
+    BackendScope scope { backend };
+    OffscreenView view { backend.getContext(), { 1000, 1000 } };
+    DefaultFileSource fileSource { "benchmark/fixtures/api/cache.db", "." };
+    ThreadPool threadPool { 4 };
+    Map map;
+};
+
+struct ReplayResults {
+    std::vector<Duration> frames;
+    std::size_t droppedFrames = 0;
+    std::size_t tiles = 0;
+    Duration completion = Duration::zero();
+    bool incomplete = false;
+    std::size_t peakMemory = 0;
+
+    Duration percentile(double fraction) const {
+        if (frames.empty()) {
+            return Duration::zero();
+        }
+        std::vector<Duration> sorted = frames;
+        std::sort(sorted.begin(), sorted.end());
+        const std::size_t rank = std::ceil(fraction * sorted.size());
+        return sorted[std::max<std::size_t>(rank, 1) - 1];
+    }
+};
+
+std::size_t totalMemory(const MemoryUsage& usage) {
+    // Buffer data is counted as GPU memory.
+    std::size_t total = usage.glyphAtlas + usage.spriteAtlas + usage.lineAtlas + usage.fileSource + usage.gpu;
+    for (const auto& source : usage.sources) {
+        const MemoryUsage::Tiles& tiles = source.second.tiles;
+        total += tiles.tileData + tiles.vertexData + tiles.featureIndex + tiles.collisionTile +
+                 source.second.cachedTiles;
+    }
+    return total;
+}
+
+// Replays the trace in real time, drawing frames at display intervals while the map asks for
+// them, until the view at the end of the trace has loaded.
+void replay(ReplayBenchmark& bench, const Trace& trace, ReplayResults& results) {
+    const Duration end = trace.end();
+    const TimePoint start = Clock::now();
+    TimePoint tick = start;
+    std::size_t next = 0;
+
+    while (true) {
+        std::this_thread::sleep_until(tick);
+        const Duration elapsed = Clock::now() - start;
+
+        for (; next < trace.events.size() && trace.events[next].time <= elapsed; next++) {
+            const TraceEvent& event = trace.events[next];
+            AnimationOptions animation { event.duration };
+            animation.minZoom = 15;
+            switch (event.type) {
+            case TraceEvent::Type::JumpTo:
+                bench.map.jumpTo(event.camera);
+                break;
+            case TraceEvent::Type::EaseTo:
+                bench.map.easeTo(event.camera, animation);
+                break;
+            case TraceEvent::Type::FlyTo:
+                bench.map.flyTo(event.camera, animation);
+                break;
+            }
+        }
+
+        bench.loop.runOnce();
+
+        if (bench.backend.needsRender) {
+            bench.backend.needsRender = false;
+            const TimePoint frameStart = Clock::now();
+            bench.map.render(bench.view);
+            const Duration frame = Clock::now() - frameStart;
+            results.frames.push_back(frame);
+
+            // A frame that misses the next display interval drops the frames it overlaps.
+            const auto missed = frame / frameInterval;
+            results.droppedFrames += missed;
+            tick += frameInterval * missed;
+
+            std::size_t tiles = 0;
+            for (const auto& source : bench.map.getFrameStats().renderTiles) {
+                tiles += source.second;
+            }
+            results.tiles = std::max(results.tiles, tiles);
+            results.peakMemory = std::max(results.peakMemory, totalMemory(bench.map.getMemoryUsage()));
+        }
+
+        if (next == trace.events.size() && elapsed >= end) {
+            if (bench.map.isFullyLoaded() && !bench.backend.needsRender) {
+                results.completion = std::max(results.completion, elapsed - end);
+                return;
+            }
+            if (elapsed - end > completionTimeout) {
+                results.incomplete = true;
+                return;
+            }
+        }
+
+        tick += frameInterval;
+    }
+}
+
+std::string milliseconds(Duration duration) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1fms", std::chrono::duration<double, std::milli>(duration).count());
+    return text;
+}
+
+} // end namespace
+
+// Replays the recorded trace given by the argument, and labels the results with percentiles of
+// the frame times, the number of dropped frames per replay, the most tiles rendered at once, the
+// longest time it took to load the last view after the last camera change, and the peak memory
+// of the map. Each iteration is a replay of the whole trace.
+static void API_replayTrace(::benchmark::State& state) {
+    const std::string name = traces[state.range_x()];
+    const Trace trace = parseTrace(name);
+
+    ReplayBenchmark bench;
+    ReplayResults results;
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        bench.reset(trace);
+        state.ResumeTiming();
+
+        replay(bench, trace, results);
+    }
+
+    char label[256];
+    std::snprintf(label, sizeof(label), "%s p50=%s p95=%s p99=%s dropped=%.1f tiles=%zu complete=%s%s peak=%.1fMB",
+                  name.c_str(),
+                  milliseconds(results.percentile(0.50)).c_str(),
+                  milliseconds(results.percentile(0.95)).c_str(),
+                  milliseconds(results.percentile(0.99)).c_str(),
+                  double(results.droppedFrames) / state.iterations(),
+                  results.tiles,
+                  milliseconds(results.completion).c_str(),
+                  results.incomplete ? " (timed out)" : "",
+                  results.peakMemory / (1024.0 * 1024.0));
+    state.SetLabel(label);
+    state.SetItemsProcessed(results.frames.size());
+}
+
+BENCHMARK(API_replayTrace)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
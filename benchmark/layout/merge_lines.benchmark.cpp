@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/layout/merge_lines.hpp>
+#include <mbgl/layout/symbol_feature.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/utf.hpp>
+
+#include <vector>
+
+using namespace mbgl;
+
+// Joins the road label lines of a tile that have the same name, as symbol layouts with line
+// placement do. Each item is a feature.
+static void MergeLines_RoadLabels(::benchmark::State& state) {
+    const VectorTileData data(std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    const auto layer = data.getLayer("road_label");
+
+    // Merging changes the features, so each iteration merges new ones, made while the timer is
+    // paused. Their allocations are left out of the count.
+    auto features = [&] {
+        std::vector<SymbolFeature> result;
+        for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+            SymbolFeature feature(layer->getFeature(i));
+            optional<Value> name = feature.getValue("name");
+            if (name && name->is<std::string>()) {
+                feature.text = util::utf8_to_utf16::convert(name->get<std::string>());
+            }
+            feature.index = i;
+            result.push_back(std::move(feature));
+        }
+        return result;
+    };
+
+    std::size_t allocations = 0;
+    std::size_t count = 0;
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        std::vector<SymbolFeature> merged = features();
+        count = merged.size();
+        const std::size_t start = mbgl::benchmark::allocations();
+        state.ResumeTiming();
+
+        util::mergeLines(merged);
+
+        state.PauseTiming();
+        allocations += mbgl::benchmark::allocations() - start;
+        merged.clear();
+        state.ResumeTiming();
+    }
+
+    mbgl::benchmark::labelAllocations(state, allocations, state.iterations() * count);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(MergeLines_RoadLabels);
@@ -2,10 +2,13 @@
 
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/style/conversion/filter.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
 
 #include <rapidjson/document.h>
 
@@ -24,6 +27,14 @@ static void Parse_Filter(benchmark::State& state) {
     }
 }
 
+static void Parse_CompileFilter(benchmark::State& state) {
+    const style::Filter filter = parse(R"FILTER(["any", ["==", "foo", "bar"], ["in", "baz", 1, 2, 3]])FILTER");
+
+    while (state.KeepRunning()) {
+        style::CompiledFilter compiled(filter);
+    }
+}
+
 static void Parse_EvaluateFilter(benchmark::State& state) {
     const style::Filter filter = parse(R"FILTER(["==", "foo", "bar"])FILTER");
     const PropertyMap properties = { { "foo", std::string("bar") } };
@@ -38,5 +49,66 @@ static void Parse_EvaluateFilter(benchmark::State& state) {
     }
 }
 
+static const char* tileFilter = R"FILTER(["all", ["==", "$type", "LineString"], ["in", "class", "motorway", "primary"]])FILTER";
+
+// Filters every feature of a source layer after materializing it.
+static void Parse_EvaluateTileFilter(benchmark::State& state) {
+    const style::Filter filter = parse(tileFilter);
+    const VectorTileData data(std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    const GeometryTileLayer& layer = *data.getLayer("road");
+
+    while (state.KeepRunning()) {
+        for (std::size_t i = 0; i < layer.featureCount(); ++i) {
+            auto feature = layer.getFeature(i);
+            benchmark::DoNotOptimize(filter(*feature));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * layer.featureCount());
+}
+
+// Filters every feature of a source layer before materializing it.
+static void Parse_EvaluateEncodedTileFilter(benchmark::State& state) {
+    const style::CompiledFilter filter(parse(tileFilter));
+    const VectorTileData data(std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    const GeometryTileLayer& layer = *data.getLayer("road");
+
+    while (state.KeepRunning()) {
+        for (std::size_t i = 0; i < layer.featureCount(); ++i) {
+            benchmark::DoNotOptimize(layer.getMatchingFeature(i, filter));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * layer.featureCount());
+}
+
+static const char* styleFilter = R"FILTER(["all", ["==", "$type", "Polygon"], ["any", ["==", "foo", "baz"], ["in", "class", "a", "b", "c"], ["!has", "bar"]]])FILTER";
+static const PropertyMap styleProperties = { { "foo", std::string("bar") }, { "bar", 1.0 }, { "class", std::string("c") } };
+
+static void Parse_EvaluateNestedFilter(benchmark::State& state) {
+    const style::Filter filter = parse(styleFilter);
+    const Feature feature { Polygon<double>(), styleProperties };
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(filter(feature));
+    }
+}
+
+static void Parse_EvaluateNestedCompiledFilter(benchmark::State& state) {
+    const style::CompiledFilter filter(parse(styleFilter));
+    const Feature feature { Polygon<double>(), styleProperties };
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(filter(feature));
+    }
+}
+
 BENCHMARK(Parse_Filter);
+BENCHMARK(Parse_CompileFilter);
 BENCHMARK(Parse_EvaluateFilter);
+BENCHMARK(Parse_EvaluateNestedFilter);
+BENCHMARK(Parse_EvaluateNestedCompiledFilter);
+BENCHMARK(Parse_EvaluateTileFilter);
+BENCHMARK(Parse_EvaluateEncodedTileFilter);
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/renderer/line_bucket.hpp>
+#include <mbgl/renderer/tessellation_cache.hpp>
+#include <mbgl/style/bucket_parameters.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <utility>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+using Features = std::vector<std::pair<std::unique_ptr<GeometryTileFeature>, GeometryCollection>>;
+
+// The features of a source layer of a streets tile, with their decoded geometries.
+Features layerFeatures(const char* name) {
+    const VectorTileData data(std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    const auto layer = data.getLayer(name);
+
+    Features features;
+    for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+        auto feature = layer->getFeature(i);
+        GeometryCollection geometries = feature->getGeometries();
+        features.emplace_back(std::move(feature), std::move(geometries));
+    }
+    return features;
+}
+
+const style::BucketParameters parameters { { 10, 163, 395 }, MapMode::Continuous };
+
+} // end namespace
+
+// Builds the vertices of the roads of a tile, with the default layout properties. Each item is a
+// feature.
+static void Bucket_LineAddGeometry(::benchmark::State& state) {
+    const Features features = layerFeatures("road");
+
+    const std::size_t start = mbgl::benchmark::allocations();
+    while (state.KeepRunning()) {
+        LineBucket bucket { parameters, {}, {} };
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            bucket.addFeature(*features[i].first, features[i].second, i);
+        }
+        ::benchmark::DoNotOptimize(bucket.vertices.vertexSize());
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations() * features.size());
+    state.SetItemsProcessed(state.iterations() * features.size());
+}
+
+// Classifies the rings of the polygons of the source layer given by the argument, water or
+// landuse, and tessellates them with earcut. The tessellation cache is off, so that every polygon
+// is tessellated.
+static void Bucket_FillEarcut(::benchmark::State& state) {
+    const Features features = layerFeatures(state.range_x() ? "landuse" : "water");
+
+    TessellationCache& cache = TessellationCache::get();
+    const std::size_t maximumBytes = cache.getMaximumBytes();
+    cache.setMaximumBytes(0);
+
+    const std::size_t start = mbgl::benchmark::allocations();
+    while (state.KeepRunning()) {
+        FillBucket bucket { parameters, {} };
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            bucket.addFeature(*features[i].first, features[i].second, i);
+        }
+        ::benchmark::DoNotOptimize(bucket.triangles.indexSize());
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations() * features.size());
+    state.SetItemsProcessed(state.iterations() * features.size());
+
+    cache.setMaximumBytes(maximumBytes);
+}
+
+BENCHMARK(Bucket_LineAddGeometry);
+BENCHMARK(Bucket_FillEarcut)->Arg(0)->Arg(1);
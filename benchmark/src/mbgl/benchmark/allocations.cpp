@@ -0,0 +1,65 @@
+#include <mbgl/benchmark/util.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> allocationCount { 0 };
+
+void* allocate(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+} // end namespace
+
+// The benchmarks replace the global allocation functions to count the allocations of the code
+// they measure. Replacing the throwing forms is enough, as the others call them by default;
+// the counting is too cheap to show in the times.
+void* operator new(std::size_t size) {
+    if (void* pointer = allocate(size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace mbgl {
+namespace benchmark {
+
+std::size_t allocations() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void labelAllocations(::benchmark::State& state, std::size_t count, std::size_t operations) {
+    char label[64];
+    std::snprintf(label, sizeof(label), "%.1f allocations/op", operations ? double(count) / operations : 0.0);
+    state.SetLabel(label);
+}
+
+} // namespace benchmark
+} // namespace mbgl
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <cstddef>
+
+namespace benchmark {
+class State;
+} // namespace benchmark
+
 namespace mbgl {
 
 class Map;
@@ -9,5 +15,11 @@ namespace benchmark {
 
 void render(Map&, OffscreenView&);
 
+// The number of calls to operator new that all threads of the benchmark made so far.
+std::size_t allocations();
+
+// Labels the benchmark with the allocations that each of the operations it timed made on average.
+void labelAllocations(::benchmark::State&, std::size_t allocations, std::size_t operations);
+
 } // namespace benchmark
 } // namespace mbgl
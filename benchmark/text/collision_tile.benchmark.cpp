@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Point labels of 120 by 24 pixels at every 32nd pixel of the tile, which is denser than any
+// real tile: most of them collide with their neighbours.
+std::vector<CollisionFeature> denseLabels() {
+    const float boxScale = util::EXTENT / util::tileSize;
+    const int step = 32 * boxScale;
+
+    std::vector<CollisionFeature> features;
+    std::size_t index = 0;
+    for (int y = step / 2; y < util::EXTENT; y += step) {
+        for (int x = step / 2; x < util::EXTENT; x += step) {
+            const Anchor anchor(x, y, 0, 0.5f);
+            features.emplace_back(GeometryCoordinates { { int16_t(x), int16_t(y) } }, anchor,
+                                  -12, 12, -60, 60, boxScale, 2, style::SymbolPlacementType::Point,
+                                  IndexedSubfeature { index, 0, 0, uint32_t(index) },
+                                  CollisionFeature::AlignmentType::Straight);
+            index++;
+        }
+    }
+    return features;
+}
+
+} // end namespace
+
+static void CollisionTile_DensePlacement(::benchmark::State& state) {
+    auto features = denseLabels();
+    PlacementConfig config;
+    config.angle = state.range_x() * M_PI / 180;
+    config.pitch = state.range_y() * M_PI / 180;
+
+    const std::size_t start = mbgl::benchmark::allocations();
+    while (state.KeepRunning()) {
+        CollisionTile collisionTile(config);
+        std::size_t placed = 0;
+        for (auto& feature : features) {
+            const float scale = collisionTile.placeFeature(feature, false, false);
+            collisionTile.insertFeature(feature, scale, false);
+            placed += scale < collisionTile.maxScale;
+        }
+        ::benchmark::DoNotOptimize(placed);
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations() * features.size());
+    state.SetItemsProcessed(state.iterations() * features.size());
+}
+
+BENCHMARK(CollisionTile_DensePlacement)->ArgPair(0, 0)->ArgPair(30, 0)->ArgPair(0, 60);
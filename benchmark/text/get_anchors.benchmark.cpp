@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/layout/clip_lines.hpp>
+#include <mbgl/text/get_anchors.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <vector>
+
+using namespace mbgl;
+
+// Places the anchors of labels of 100 by 24 pixels along the roads of a tile, with the default
+// layout properties of a symbol layer at a tile pixel ratio of 8. Each item is a line.
+static void GetAnchors_Roads(::benchmark::State& state) {
+    const VectorTileData data(std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    const auto layer = data.getLayer("road");
+
+    std::vector<GeometryCoordinates> lines;
+    for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+        for (auto& line : util::clipLines(layer->getFeature(i)->getGeometries(), 0, 0, util::EXTENT, util::EXTENT)) {
+            lines.push_back(std::move(line));
+        }
+    }
+
+    const float tilePixelRatio = 8;
+    const float glyphSize = 24;
+    const float textMaxBoxScale = tilePixelRatio * 16 / glyphSize;
+
+    const std::size_t start = mbgl::benchmark::allocations();
+    while (state.KeepRunning()) {
+        for (const auto& line : lines) {
+            ::benchmark::DoNotOptimize(getAnchors(line, tilePixelRatio * 250, 45 * util::DEG2RAD,
+                                                  -50, 50, 0, 0, glyphSize, textMaxBoxScale, 1));
+        }
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations() * lines.size());
+    state.SetItemsProcessed(state.iterations() * lines.size());
+}
+
+BENCHMARK(GetAnchors_Roads);
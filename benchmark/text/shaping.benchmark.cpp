@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/text/bidi.hpp>
+#include <mbgl/text/shaping.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/utf.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+GlyphPositions glyphsFor(const std::u16string& text) {
+    GlyphPositions glyphs;
+    for (const char16_t chr : text) {
+        Glyph glyph;
+        glyph.metrics.width = 20;
+        glyph.metrics.height = 20;
+        glyph.metrics.advance = 22;
+        glyphs.emplace(chr, glyph);
+    }
+    return glyphs;
+}
+
+Shaping shape(const std::u16string& text, BiDi& bidi, const GlyphPositions& glyphs) {
+    return getShaping(text, 10 * 24, 1.2 * 24, 0.5, 0.5, 0.5, 0, { 0, 0 }, 24,
+                      WritingModeType::Horizontal, bidi, glyphs);
+}
+
+void shape(::benchmark::State& state, const std::u16string& text) {
+    const GlyphPositions glyphs = glyphsFor(text);
+    BiDi bidi;
+
+    const std::size_t start = mbgl::benchmark::allocations();
+    while (state.KeepRunning()) {
+        const Shaping shaping = shape(text, bidi, glyphs);
+        ::benchmark::DoNotOptimize(shaping.positionedGlyphs.data());
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations());
+}
+
+// The names of the place, road and water labels of a streets tile.
+std::vector<std::u16string> tileLabels() {
+    const VectorTileData data(std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+
+    std::vector<std::u16string> labels;
+    for (const auto& name : { "place_label", "road_label", "water_label" }) {
+        auto layer = data.getLayer(name);
+        if (!layer) {
+            continue;
+        }
+        for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+            optional<Value> value = layer->getFeature(i)->getValue("name");
+            if (value && value->is<std::string>()) {
+                labels.push_back(util::utf8_to_utf16::convert(value->get<std::string>()));
+            }
+        }
+    }
+    return labels;
+}
+
+GlyphPositions glyphsFor(const std::vector<std::u16string>& texts) {
+    std::u16string all;
+    for (const auto& text : texts) {
+        all += text;
+    }
+    return glyphsFor(all);
+}
+
+} // end namespace
+
+// Ideographic text can be broken after every character, which makes line breaking quadratic in
+// the length of the label.
+static void Shaping_Ideographic(::benchmark::State& state) {
+    std::u16string text;
+    for (int i = 0; i < state.range_x(); i++) {
+        text.push_back(u'\u4e00' + i % 64);
+    }
+    shape(state, text);
+}
+
+static void Shaping_Words(::benchmark::State& state) {
+    std::u16string text;
+    while (text.size() < std::size_t(state.range_x())) {
+        text += u"Avenue ";
+    }
+    text.resize(state.range_x());
+    shape(state, text);
+}
+
+// Shapes the labels of a real tile. Each item is a label.
+static void Shaping_TileLabels(::benchmark::State& state) {
+    const std::vector<std::u16string> labels = tileLabels();
+    const GlyphPositions glyphs = glyphsFor(labels);
+    BiDi bidi;
+
+    const std::size_t start = mbgl::benchmark::allocations();
+    while (state.KeepRunning()) {
+        for (const auto& label : labels) {
+            const Shaping shaping = shape(label, bidi, glyphs);
+            ::benchmark::DoNotOptimize(shaping.positionedGlyphs.data());
+        }
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations() * labels.size());
+    state.SetItemsProcessed(state.iterations() * labels.size());
+}
+
+// Breaks the labels of a real tile into lines, without shaping them.
+static void Shaping_LineBreaks(::benchmark::State& state) {
+    const std::vector<std::u16string> labels = tileLabels();
+    const GlyphPositions glyphs = glyphsFor(labels);
+
+    const std::size_t start = mbgl::benchmark::allocations();
+    while (state.KeepRunning()) {
+        for (const auto& label : labels) {
+            ::benchmark::DoNotOptimize(determineLineBreaks(label, 0, 10 * 24, WritingModeType::Horizontal, glyphs));
+        }
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations() * labels.size());
+    state.SetItemsProcessed(state.iterations() * labels.size());
+}
+
+BENCHMARK(Shaping_Ideographic)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(Shaping_Words)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(Shaping_TileLabels);
+BENCHMARK(Shaping_LineBreaks);
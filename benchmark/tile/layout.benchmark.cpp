@@ -0,0 +1,202 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/layout/symbol_layout.hpp>
+#include <mbgl/map/zoom_history.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/symbol_bucket.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/style/bucket_parameters.hpp>
+#include <mbgl/style/cascade_parameters.hpp>
+#include <mbgl/style/class_dictionary.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/group_by_layout.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/style/layers/symbol_layer_impl.hpp>
+#include <mbgl/style/parser.hpp>
+#include <mbgl/style/property_evaluation_parameters.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+// Lays out the tiles of benchmark/fixtures/api/cache.db with the layers of the query style the
+// way GeometryTileWorker does, without the message passing around it.
+class LayoutBenchmark {
+public:
+    LayoutBenchmark() : database("benchmark/fixtures/api/cache.db") {
+        Parser parser;
+        parser.parse(util::read_file("benchmark/fixtures/api/query_style.json"));
+
+        ZoomHistory zoomHistory;
+        zoomHistory.update(zoom, Clock::now());
+
+        const CascadeParameters cascadeParameters { { ClassID::Default }, Clock::now(), {} };
+        const PropertyEvaluationParameters evaluationParameters {
+            zoom, Clock::time_point::max(), zoomHistory, Duration::zero()
+        };
+
+        for (auto& layer : parser.layers) {
+            if (layer->baseImpl->source != "composite" ||
+                layer->baseImpl->visibility == VisibilityType::None) {
+                continue;
+            }
+            layer->baseImpl->cascade(cascadeParameters);
+            layer->baseImpl->evaluate(evaluationParameters);
+            if (layer->baseImpl->needsRendering(zoom)) {
+                layers.push_back(std::move(layer));
+            }
+        }
+        groups = groupByLayout(layers);
+
+        for (const auto& fontStack : parser.fontStacks()) {
+            const GlyphRange range { 0, 255 };
+            auto response = database.get(Resource::glyphs(parser.glyphURL, fontStack, range));
+            if (!response || !response->data) {
+                continue;
+            }
+
+            GlyphPositions& positions = glyphs[fontStack];
+            for (auto& glyph : parseGlyphPBF(range, response->data->toString())) {
+                const Rect<uint16_t> rect { 0, 0,
+                    static_cast<uint16_t>(glyph.bitmap.size.width),
+                    static_cast<uint16_t>(glyph.bitmap.size.height) };
+                positions.emplace(glyph.id, Glyph { rect, glyph.metrics });
+            }
+        }
+    }
+
+    std::unique_ptr<const GeometryTileData> loadTile(std::size_t index) {
+        const auto& tile = tiles.at(index);
+        auto response = database.get(Resource::tile(
+            "mapbox://tiles/mapbox.mapbox-terrain-v2,mapbox.mapbox-streets-v7/{z}/{x}/{y}.vector.pbf",
+            1, tile.canonical.x, tile.canonical.y, tile.canonical.z, Tileset::Scheme::XYZ));
+        return std::make_unique<VectorTileData>(response->data);
+    }
+
+    // Builds the buckets of all layers and the symbol layouts, without shaping and placing the
+    // symbols.
+    std::vector<std::unique_ptr<SymbolLayout>> layout(const GeometryTileData& data, const OverscaledTileID& id) {
+        const BucketParameters parameters { id, MapMode::Still };
+        FeatureIndex featureIndex;
+        GlyphDependencies glyphDependencies;
+        IconDependencyMap iconDependencies;
+        std::vector<std::unique_ptr<Bucket>> buckets;
+        std::vector<std::unique_ptr<SymbolLayout>> symbolLayouts;
+
+        for (const auto& group : groups) {
+            const Layer& leader = *group.at(0);
+            auto geometryLayer = data.getLayer(leader.baseImpl->sourceLayer);
+            if (!geometryLayer) {
+                continue;
+            }
+
+            std::vector<std::string> layerIDs;
+            for (const Layer* layer : group) {
+                layerIDs.push_back(layer->getID());
+            }
+            const uint16_t bucketID = featureIndex.setBucketLayerIDs(leader.getID(), layerIDs);
+            const uint16_t sourceLayerID = featureIndex.addSourceLayerName(leader.baseImpl->sourceLayer);
+
+            if (leader.is<SymbolLayer>()) {
+                symbolLayouts.push_back(leader.as<SymbolLayer>()->impl->createLayout(
+                    parameters, group, *geometryLayer, glyphDependencies, iconDependencies));
+                symbolLayouts.back()->setFeatureIndexIDs(sourceLayerID, bucketID);
+                continue;
+            }
+
+            const CompiledFilter& filter = *leader.baseImpl->compiledFilter;
+            std::unique_ptr<Bucket> bucket = leader.baseImpl->createBucket(parameters, group);
+            GeometryCollection geometries;
+            for (std::size_t i = 0; i < geometryLayer->featureCount(); i++) {
+                std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getMatchingFeature(i, filter);
+                if (!feature) {
+                    continue;
+                }
+
+                feature->readGeometries(geometries);
+                bucket->addFeature(*feature, geometries, i);
+                featureIndex.insert(geometries, i, sourceLayerID, bucketID);
+            }
+            buckets.push_back(std::move(bucket));
+        }
+
+        ::benchmark::DoNotOptimize(buckets);
+        return symbolLayouts;
+    }
+
+    static constexpr float zoom = 15;
+
+    // The tiles stored in the fixture.
+    const std::vector<OverscaledTileID> tiles {
+        { 15, 9648, 12318 },
+        { 15, 9649, 12318 },
+    };
+
+    OfflineDatabase database;
+    std::vector<std::unique_ptr<Layer>> layers;
+    std::vector<std::vector<const Layer*>> groups;
+    GlyphPositionMap glyphs;
+};
+
+constexpr float LayoutBenchmark::zoom;
+
+} // end namespace
+
+static void Layout_Tile(::benchmark::State& state) {
+    LayoutBenchmark bench;
+    const OverscaledTileID& id = bench.tiles.at(state.range_x());
+    auto data = bench.loadTile(state.range_x());
+
+    while (state.KeepRunning()) {
+        ::benchmark::DoNotOptimize(bench.layout(*data, id));
+    }
+}
+
+static void Layout_SymbolPrepare(::benchmark::State& state) {
+    LayoutBenchmark bench;
+    const OverscaledTileID& id = bench.tiles.at(state.range_x());
+    auto data = bench.loadTile(state.range_x());
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        auto symbolLayouts = bench.layout(*data, id);
+        state.ResumeTiming();
+
+        for (auto& symbolLayout : symbolLayouts) {
+            symbolLayout->prepare(bench.glyphs, {});
+        }
+    }
+}
+
+static void Layout_SymbolPlacement(::benchmark::State& state) {
+    LayoutBenchmark bench;
+    const OverscaledTileID& id = bench.tiles.at(state.range_x());
+    auto data = bench.loadTile(state.range_x());
+
+    auto symbolLayouts = bench.layout(*data, id);
+    for (auto& symbolLayout : symbolLayouts) {
+        symbolLayout->prepare(bench.glyphs, {});
+    }
+
+    while (state.KeepRunning()) {
+        CollisionTile collisionTile { PlacementConfig() };
+        for (auto& symbolLayout : symbolLayouts) {
+            if (symbolLayout->hasSymbolInstances()) {
+                ::benchmark::DoNotOptimize(symbolLayout->place(collisionTile));
+            }
+        }
+    }
+}
+
+BENCHMARK(Layout_Tile)->Arg(0)->Arg(1);
+BENCHMARK(Layout_SymbolPrepare)->Arg(0)->Arg(1);
+BENCHMARK(Layout_SymbolPlacement)->Arg(0)->Arg(1);
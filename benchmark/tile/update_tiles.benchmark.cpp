@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/annotation/annotation_manager.hpp>
+#include <mbgl/map/transform.hpp>
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/style/source_impl.hpp>
+#include <mbgl/style/sources/raster_source.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/style/update_parameters.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/tileset.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+// Leaves all requests pending, so that only the tile bookkeeping is measured.
+class PendingFileSource : public FileSource {
+public:
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override {
+        return std::make_unique<AsyncRequest>();
+    }
+};
+
+} // end namespace
+
+// Pans a viewport of about 60 raster tiles by a quarter of a tile in each update, the way a
+// gesture does from frame to frame.
+static void Source_UpdateTiles_Pan(::benchmark::State& state) {
+    util::RunLoop loop;
+    PendingFileSource fileSource;
+    ThreadPool threadPool { 1 };
+    AnnotationManager annotationManager { 1.0 };
+    Style style { fileSource, 1.0 };
+
+    Transform transform;
+    transform.resize({ 2048, 1536 });
+    transform.setLatLngZoom({ 37.78, -122.42 }, 10);
+    TransformState transformState = transform.getState();
+
+    UpdateParameters parameters { 1.0, MapDebugOptions(), transformState, threadPool,
+                                  fileSource, MapMode::Continuous, annotationManager, style };
+    parameters.cameraMoving = true;
+
+    Tileset tileset;
+    tileset.tiles = { "{z}/{x}/{y}.png" };
+    RasterSource source("source", tileset, 256);
+    source.baseImpl->loaded = true;
+
+    std::size_t step = 0;
+    while (state.KeepRunning()) {
+        // Pans back and forth over two tiles.
+        const double dx = (step++ / 8) % 2 ? -64 : 64;
+        transform.moveBy({ dx, 0 });
+        transformState = transform.getState();
+        source.baseImpl->updateTiles(parameters);
+    }
+}
+
+BENCHMARK(Source_UpdateTiles_Pan);
@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// A layer of lines and two of polygons.
+const char* const layerNames[] = { "road", "water", "landuse" };
+
+const VectorTileData& streetsTile() {
+    static const VectorTileData data(std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    return data;
+}
+
+std::vector<GeometryCollection> layerGeometries(const GeometryTileLayer& layer) {
+    std::vector<GeometryCollection> geometries;
+    for (std::size_t i = 0; i < layer.featureCount(); ++i) {
+        geometries.push_back(layer.getFeature(i)->getGeometries());
+    }
+    return geometries;
+}
+
+} // end namespace
+
+// Decodes the geometries of every feature of the source layer given by the argument into new
+// collections. Each item is a feature.
+static void VectorTile_getGeometries(::benchmark::State& state) {
+    const GeometryTileLayer& layer = *streetsTile().getLayer(layerNames[state.range_x()]);
+    std::vector<std::unique_ptr<GeometryTileFeature>> features;
+    for (std::size_t i = 0; i < layer.featureCount(); ++i) {
+        features.push_back(layer.getFeature(i));
+    }
+
+    const std::size_t start = mbgl::benchmark::allocations();
+    while (state.KeepRunning()) {
+        for (const auto& feature : features) {
+            ::benchmark::DoNotOptimize(feature->getGeometries());
+        }
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations() * features.size());
+    state.SetItemsProcessed(state.iterations() * features.size());
+}
+
+// Decodes the same geometries into a collection that keeps its memory between features, as
+// buckets do.
+static void VectorTile_readGeometries(::benchmark::State& state) {
+    const GeometryTileLayer& layer = *streetsTile().getLayer(layerNames[state.range_x()]);
+    std::vector<std::unique_ptr<GeometryTileFeature>> features;
+    for (std::size_t i = 0; i < layer.featureCount(); ++i) {
+        features.push_back(layer.getFeature(i));
+    }
+
+    GeometryCollection geometries;
+    const std::size_t start = mbgl::benchmark::allocations();
+    while (state.KeepRunning()) {
+        for (const auto& feature : features) {
+            feature->readGeometries(geometries);
+            ::benchmark::DoNotOptimize(geometries.data());
+        }
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations() * features.size());
+    state.SetItemsProcessed(state.iterations() * features.size());
+}
+
+// Sorts the rings of the polygons of the source layer given by the argument into outer rings and
+// their holes.
+static void VectorTile_classifyRings(::benchmark::State& state) {
+    const auto geometries = layerGeometries(*streetsTile().getLayer(layerNames[state.range_x()]));
+
+    const std::size_t start = mbgl::benchmark::allocations();
+    while (state.KeepRunning()) {
+        for (const auto& geometry : geometries) {
+            ::benchmark::DoNotOptimize(classifyRings(geometry));
+        }
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations() * geometries.size());
+    state.SetItemsProcessed(state.iterations() * geometries.size());
+}
+
+// Sorts them into polygons that keep their memory between features, as fill buckets do.
+static void VectorTile_classifyRingsInto(::benchmark::State& state) {
+    const auto geometries = layerGeometries(*streetsTile().getLayer(layerNames[state.range_x()]));
+
+    std::vector<GeometryCollection> polygons;
+    const std::size_t start = mbgl::benchmark::allocations();
+    while (state.KeepRunning()) {
+        for (const auto& geometry : geometries) {
+            ::benchmark::DoNotOptimize(classifyRings(geometry, polygons));
+        }
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations() * geometries.size());
+    state.SetItemsProcessed(state.iterations() * geometries.size());
+}
+
+BENCHMARK(VectorTile_getGeometries)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(VectorTile_readGeometries)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK(VectorTile_classifyRings)->Arg(1)->Arg(2);
+BENCHMARK(VectorTile_classifyRingsInto)->Arg(1)->Arg(2);
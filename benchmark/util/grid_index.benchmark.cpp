@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/grid_index.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <mapbox/geometry/envelope.hpp>
+
+#include <vector>
+
+using namespace mbgl;
+
+// Indexes the lines and rings of all features of a tile by their bounding boxes, the way the
+// feature index of a tile does, and queries it with boxes of the size in tile units given by the
+// argument at every 512th unit of the tile: small ones as for taps, large ones as for selections.
+// Each item is a query.
+static void GridIndex_Query(::benchmark::State& state) {
+    const VectorTileData data(std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+
+    GridIndex<IndexedSubfeature> grid(util::EXTENT, 16, 0);
+    uint32_t sortIndex = 0;
+    for (const auto& name : { "landuse", "water", "waterway", "road", "admin", "place_label", "road_label" }) {
+        const auto layer = data.getLayer(name);
+        if (!layer) {
+            continue;
+        }
+        for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+            for (const auto& ring : layer->getFeature(i)->getGeometries()) {
+                grid.insert(IndexedSubfeature { i, 0, 0, sortIndex++ }, mapbox::geometry::envelope(ring));
+            }
+        }
+    }
+
+    const int16_t size = state.range_x();
+    std::vector<GridIndex<IndexedSubfeature>::BBox> queries;
+    for (int16_t y = 0; y < util::EXTENT; y += 512) {
+        for (int16_t x = 0; x < util::EXTENT; x += 512) {
+            queries.push_back({ { x, y }, { int16_t(x + size), int16_t(y + size) } });
+        }
+    }
+
+    const std::size_t start = mbgl::benchmark::allocations();
+    while (state.KeepRunning()) {
+        for (const auto& query : queries) {
+            ::benchmark::DoNotOptimize(grid.query(query));
+        }
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations() * queries.size());
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK(GridIndex_Query)->Arg(16)->Arg(256)->Arg(2048);
@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/thread.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+class Counter {
+public:
+    void add(std::size_t value) {
+        sum += value;
+    }
+
+    std::size_t get() {
+        return sum;
+    }
+
+    void echo(std::size_t value, std::function<void(std::size_t)> callback) {
+        sum += value;
+        callback(value);
+    }
+
+private:
+    std::size_t sum = 0;
+};
+
+} // end namespace
+
+// Tasks posted from the main thread to the RunLoop of another, as the main thread does to the
+// file source's.
+static void RunLoop_Invoke(::benchmark::State& state) {
+    util::Thread<Counter> counter({ "Counter" });
+
+    const std::size_t batch = state.range_x();
+    while (state.KeepRunning()) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            counter.invoke(&Counter::add, i);
+        }
+        ::benchmark::DoNotOptimize(counter.invokeSync(&Counter::get));
+    }
+
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+// Requests that are answered on the RunLoop of the thread that made them, as the file source
+// answers those of the main thread.
+static void RunLoop_InvokeWithCallback(::benchmark::State& state) {
+    util::RunLoop loop;
+    util::Thread<Counter> counter({ "Counter" });
+
+    const std::size_t batch = state.range_x();
+    std::vector<std::unique_ptr<AsyncRequest>> requests;
+    requests.reserve(batch);
+
+    while (state.KeepRunning()) {
+        std::size_t answered = 0;
+        for (std::size_t i = 0; i < batch; ++i) {
+            requests.push_back(counter.invokeWithCallback(&Counter::echo, i, [&](std::size_t) {
+                if (++answered == batch) {
+                    loop.stop();
+                }
+            }));
+        }
+        loop.run();
+        requests.clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+BENCHMARK(RunLoop_Invoke)->Arg(1)->Arg(64)->Arg(1024)->UseRealTime();
+BENCHMARK(RunLoop_InvokeWithCallback)->Arg(1)->Arg(64)->Arg(1024)->UseRealTime();
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/map/transform.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/tile_cover.hpp>
+
+using namespace mbgl;
+
+// Covers a viewport of 2048 by 1536 pixels at zoom level 15, pitched by the number of degrees
+// given by the argument. Each item is a tile.
+static void TileCover_Transform(::benchmark::State& state) {
+    Transform transform;
+    transform.resize({ 2048, 1536 });
+    transform.setLatLngZoom({ 37.78, -122.42 }, 15);
+    transform.setPitch(state.range_x() * util::DEG2RAD);
+    const TransformState transformState = transform.getState();
+
+    const std::size_t start = mbgl::benchmark::allocations();
+    std::size_t tiles = 0;
+    while (state.KeepRunning()) {
+        const auto cover = util::tileCover(transformState, 15);
+        tiles = cover.size();
+        ::benchmark::DoNotOptimize(cover.data());
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations());
+    state.SetItemsProcessed(state.iterations() * tiles);
+}
+
+// Covers the bounds of San Francisco at the zoom level given by the argument, as offline regions
+// do. Each item is a tile.
+static void TileCover_Bounds(::benchmark::State& state) {
+    const LatLngBounds sanFrancisco = LatLngBounds::hull({ 37.6609, -122.5744 }, { 37.8271, -122.3204 });
+    const int32_t z = state.range_x();
+
+    const std::size_t start = mbgl::benchmark::allocations();
+    std::size_t tiles = 0;
+    while (state.KeepRunning()) {
+        const auto cover = util::tileCover(sanFrancisco, z);
+        tiles = cover.size();
+        ::benchmark::DoNotOptimize(cover.data());
+    }
+    mbgl::benchmark::labelAllocations(state, mbgl::benchmark::allocations() - start, state.iterations());
+    state.SetItemsProcessed(state.iterations() * tiles);
+}
+
+BENCHMARK(TileCover_Transform)->Arg(0)->Arg(60);
+BENCHMARK(TileCover_Bounds)->Arg(10)->Arg(14);
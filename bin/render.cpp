@@ -6,6 +6,7 @@
 #include <mbgl/gl/headless_backend.hpp>
 #include <mbgl/gl/offscreen_view.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/work_stealing_thread_pool.hpp>
 #include <mbgl/storage/default_file_source.hpp>
 
 #pragma GCC diagnostic push
@@ -37,6 +38,7 @@ int main(int argc, char *argv[]) {
     std::vector<std::string> classes;
     std::string token;
     bool debug = false;
+    bool workStealing = false;
 
     po::options_description desc("Allowed options");
     desc.add_options()
@@ -52,6 +54,7 @@ int main(int argc, char *argv[]) {
         ("class,c", po::value(&classes)->value_name("name"), "Class name")
         ("token,t", po::value(&token)->value_name("key")->default_value(token), "Mapbox access token")
         ("debug", po::bool_switch(&debug)->default_value(debug), "Debug mode")
+        ("work-stealing", po::bool_switch(&workStealing)->default_value(workStealing), "Use the work-stealing thread pool")
         ("output,o", po::value(&output)->value_name("file")->default_value(output), "Output file name")
         ("cache,d", po::value(&cache_file)->value_name("file")->default_value(cache_file), "Cache database file name")
         ("assets,d", po::value(&asset_root)->value_name("file")->default_value(asset_root), "Directory to which asset:// URLs will resolve")
@@ -87,8 +90,13 @@ int main(int argc, char *argv[]) {
     HeadlessBackend backend;
     BackendScope scope { backend };
     OffscreenView view(backend.getContext(), { width * pixelRatio, height * pixelRatio });
-    ThreadPool threadPool(4);
-    Map map(backend, mbgl::Size { width, height }, pixelRatio, fileSource, threadPool, MapMode::Still);
+    std::unique_ptr<Scheduler> threadPool;
+    if (workStealing) {
+        threadPool = std::make_unique<WorkStealingThreadPool>(4);
+    } else {
+        threadPool = std::make_unique<ThreadPool>(4);
+    }
+    Map map(backend, mbgl::Size { width, height }, pixelRatio, fileSource, *threadPool, MapMode::Still);
 
     if (style_path.find("://") == std::string::npos) {
         style_path = std::string("file://") + style_path;
@@ -1,20 +1,50 @@
 # Do not edit. Regenerate this with ./scripts/generate-benchmark-files.sh
 
 set(MBGL_BENCHMARK_FILES
+    # actor
+    benchmark/actor/mailbox.benchmark.cpp
+    benchmark/actor/thread_pool.benchmark.cpp
+
     # api
+    benchmark/api/load.benchmark.cpp
     benchmark/api/query.benchmark.cpp
+    benchmark/api/render.benchmark.cpp
+    benchmark/api/replay.benchmark.cpp
 
     # include/mbgl
     benchmark/include/mbgl/benchmark.hpp
 
+    # layout
+    benchmark/layout/merge_lines.benchmark.cpp
+
     # parse
     benchmark/parse/filter.benchmark.cpp
+    benchmark/parse/style.benchmark.cpp
+
+    # renderer
+    benchmark/renderer/bucket.benchmark.cpp
 
     # src
     benchmark/src/main.cpp
 
     # src/mbgl/benchmark
+    benchmark/src/mbgl/benchmark/allocations.cpp
     benchmark/src/mbgl/benchmark/benchmark.cpp
     benchmark/src/mbgl/benchmark/util.cpp
     benchmark/src/mbgl/benchmark/util.hpp
+
+    # text
+    benchmark/text/collision_tile.benchmark.cpp
+    benchmark/text/get_anchors.benchmark.cpp
+    benchmark/text/shaping.benchmark.cpp
+
+    # tile
+    benchmark/tile/layout.benchmark.cpp
+    benchmark/tile/update_tiles.benchmark.cpp
+    benchmark/tile/vector_tile.benchmark.cpp
+
+    # util
+    benchmark/util/grid_index.benchmark.cpp
+    benchmark/util/run_loop.benchmark.cpp
+    benchmark/util/tile_cover.benchmark.cpp
 )
@@ -1,5 +1,6 @@
 add_executable(mbgl-benchmark
     ${MBGL_BENCHMARK_FILES}
+    test/src/mbgl/test/simulated_file_source.cpp
 )
 
 target_compile_options(mbgl-benchmark
@@ -11,6 +12,7 @@ target_include_directories(mbgl-benchmark
     PRIVATE benchmark/include
     PRIVATE benchmark/src
     PRIVATE platform/default
+    PRIVATE test/src
 )
 
 target_link_libraries(mbgl-benchmark
@@ -19,6 +21,7 @@ target_link_libraries(mbgl-benchmark
 
 target_add_mason_package(mbgl-benchmark PRIVATE benchmark)
 target_add_mason_package(mbgl-benchmark PRIVATE rapidjson)
+target_add_mason_package(mbgl-benchmark PRIVATE protozero)
 
 mbgl_platform_benchmark()
 
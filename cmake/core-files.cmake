@@ -8,6 +8,8 @@ set(MBGL_CORE_FILES
     src/mbgl/actor/actor_ref.hpp
     src/mbgl/actor/mailbox.cpp
     src/mbgl/actor/message.hpp
+    src/mbgl/actor/message_pool.cpp
+    src/mbgl/actor/message_pool.hpp
 
     # algorithm
     src/mbgl/algorithm/covered_by_children.hpp
@@ -28,12 +30,16 @@ set(MBGL_CORE_FILES
     src/mbgl/annotation/fill_annotation_impl.hpp
     src/mbgl/annotation/line_annotation_impl.cpp
     src/mbgl/annotation/line_annotation_impl.hpp
+    src/mbgl/annotation/shape_annotation_batch.cpp
+    src/mbgl/annotation/shape_annotation_batch.hpp
     src/mbgl/annotation/shape_annotation_impl.cpp
     src/mbgl/annotation/shape_annotation_impl.hpp
     src/mbgl/annotation/style_sourced_annotation_impl.cpp
     src/mbgl/annotation/style_sourced_annotation_impl.hpp
     src/mbgl/annotation/symbol_annotation_impl.cpp
     src/mbgl/annotation/symbol_annotation_impl.hpp
+    src/mbgl/annotation/symbol_annotation_instances.cpp
+    src/mbgl/annotation/symbol_annotation_instances.hpp
 
     # csscolorparser
     src/csscolorparser/csscolorparser.cpp
@@ -43,14 +49,19 @@ set(MBGL_CORE_FILES
     src/mbgl/geometry/anchor.hpp
     src/mbgl/geometry/binpack.hpp
     src/mbgl/geometry/debug_font_data.hpp
+    src/mbgl/geometry/dem_data.cpp
+    src/mbgl/geometry/dem_data.hpp
     src/mbgl/geometry/feature_index.cpp
     src/mbgl/geometry/feature_index.hpp
     src/mbgl/geometry/line_atlas.cpp
     src/mbgl/geometry/line_atlas.hpp
+    src/mbgl/geometry/shelf_pack.hpp
 
     # gl
     src/mbgl/gl/attribute.cpp
     src/mbgl/gl/attribute.hpp
+    src/mbgl/gl/buffer_arena.cpp
+    src/mbgl/gl/buffer_arena.hpp
     src/mbgl/gl/color_mode.cpp
     src/mbgl/gl/color_mode.hpp
     src/mbgl/gl/context.cpp
@@ -67,9 +78,17 @@ set(MBGL_CORE_FILES
     src/mbgl/gl/framebuffer.hpp
     src/mbgl/gl/gl.cpp
     src/mbgl/gl/gl.hpp
+    src/mbgl/gl/gpu_timer.cpp
+    src/mbgl/gl/gpu_timer.hpp
     src/mbgl/gl/index_buffer.hpp
+    src/mbgl/gl/instancing_extension.hpp
+    src/mbgl/gl/multisample_extension.hpp
     src/mbgl/gl/object.cpp
     src/mbgl/gl/object.hpp
+    src/mbgl/gl/parallel_shader_compile_extension.hpp
+    src/mbgl/gl/pixel_buffer_extension.hpp
+    src/mbgl/gl/pixel_readback.cpp
+    src/mbgl/gl/pixel_readback.hpp
     src/mbgl/gl/primitives.hpp
     src/mbgl/gl/program.hpp
     src/mbgl/gl/program_binary_extension.hpp
@@ -80,6 +99,7 @@ set(MBGL_CORE_FILES
     src/mbgl/gl/stencil_mode.cpp
     src/mbgl/gl/stencil_mode.hpp
     src/mbgl/gl/texture.hpp
+    src/mbgl/gl/timer_query_extension.hpp
     src/mbgl/gl/types.hpp
     src/mbgl/gl/uniform.cpp
     src/mbgl/gl/uniform.hpp
@@ -94,6 +114,8 @@ set(MBGL_CORE_FILES
     src/mbgl/layout/merge_lines.cpp
     src/mbgl/layout/merge_lines.hpp
     src/mbgl/layout/symbol_feature.hpp
+    src/mbgl/layout/symbol_feature_cache.cpp
+    src/mbgl/layout/symbol_feature_cache.hpp
     src/mbgl/layout/symbol_instance.cpp
     src/mbgl/layout/symbol_instance.hpp
     src/mbgl/layout/symbol_layout.cpp
@@ -104,14 +126,23 @@ set(MBGL_CORE_FILES
     include/mbgl/map/backend_scope.hpp
     include/mbgl/map/camera.hpp
     include/mbgl/map/change.hpp
+    include/mbgl/map/frame_stats.hpp
     include/mbgl/map/map.hpp
     include/mbgl/map/map_observer.hpp
+    include/mbgl/map/memory_usage.hpp
+    include/mbgl/map/metatile.hpp
     include/mbgl/map/mode.hpp
     include/mbgl/map/query.hpp
     include/mbgl/map/view.hpp
     src/mbgl/map/backend.cpp
     src/mbgl/map/backend_scope.cpp
+    src/mbgl/map/frame_budget.cpp
+    src/mbgl/map/frame_budget.hpp
     src/mbgl/map/map.cpp
+    src/mbgl/map/metatile.cpp
+    src/mbgl/map/query.cpp
+    src/mbgl/map/tile_snapshot.cpp
+    src/mbgl/map/tile_snapshot.hpp
     src/mbgl/map/transform.cpp
     src/mbgl/map/transform.hpp
     src/mbgl/map/transform_state.cpp
@@ -131,6 +162,8 @@ set(MBGL_CORE_FILES
     src/parsedate/parsedate.h
 
     # programs
+    src/mbgl/programs/annotation_icon_program.cpp
+    src/mbgl/programs/annotation_icon_program.hpp
     src/mbgl/programs/attributes.hpp
     src/mbgl/programs/binary_program.cpp
     src/mbgl/programs/binary_program.hpp
@@ -139,11 +172,22 @@ set(MBGL_CORE_FILES
     src/mbgl/programs/collision_box_program.cpp
     src/mbgl/programs/collision_box_program.hpp
     src/mbgl/programs/debug_program.hpp
+    src/mbgl/programs/fill_extrusion_program.cpp
+    src/mbgl/programs/fill_extrusion_program.hpp
+    src/mbgl/programs/fill_pick_program.cpp
+    src/mbgl/programs/fill_pick_program.hpp
     src/mbgl/programs/fill_program.cpp
     src/mbgl/programs/fill_program.hpp
+    src/mbgl/programs/heatmap_program.cpp
+    src/mbgl/programs/heatmap_program.hpp
+    src/mbgl/programs/hillshade_program.cpp
+    src/mbgl/programs/hillshade_program.hpp
+    src/mbgl/programs/layer_group_program.hpp
     src/mbgl/programs/line_program.cpp
     src/mbgl/programs/line_program.hpp
     src/mbgl/programs/program.hpp
+    src/mbgl/programs/program_pack.cpp
+    src/mbgl/programs/program_pack.hpp
     src/mbgl/programs/program_parameters.hpp
     src/mbgl/programs/programs.hpp
     src/mbgl/programs/raster_program.cpp
@@ -160,20 +204,34 @@ set(MBGL_CORE_FILES
     src/mbgl/renderer/debug_bucket.hpp
     src/mbgl/renderer/fill_bucket.cpp
     src/mbgl/renderer/fill_bucket.hpp
+    src/mbgl/renderer/fill_extrusion_bucket.cpp
+    src/mbgl/renderer/fill_extrusion_bucket.hpp
     src/mbgl/renderer/frame_history.cpp
     src/mbgl/renderer/frame_history.hpp
+    src/mbgl/renderer/heatmap_bucket.cpp
+    src/mbgl/renderer/heatmap_bucket.hpp
+    src/mbgl/renderer/hillshade_bucket.cpp
+    src/mbgl/renderer/hillshade_bucket.hpp
     src/mbgl/renderer/line_bucket.cpp
     src/mbgl/renderer/line_bucket.hpp
     src/mbgl/renderer/paint_parameters.hpp
     src/mbgl/renderer/painter.cpp
     src/mbgl/renderer/painter.hpp
+    src/mbgl/renderer/painter_annotation.cpp
     src/mbgl/renderer/painter_background.cpp
     src/mbgl/renderer/painter_circle.cpp
     src/mbgl/renderer/painter_clipping.cpp
     src/mbgl/renderer/painter_debug.cpp
     src/mbgl/renderer/painter_fill.cpp
+    src/mbgl/renderer/painter_fill_extrusion.cpp
+    src/mbgl/renderer/painter_heatmap.cpp
+    src/mbgl/renderer/painter_hillshade.cpp
+    src/mbgl/renderer/painter_layer_groups.cpp
     src/mbgl/renderer/painter_line.cpp
+    src/mbgl/renderer/painter_picking.cpp
+    src/mbgl/renderer/painter_programs.cpp
     src/mbgl/renderer/painter_raster.cpp
+    src/mbgl/renderer/painter_redraw.cpp
     src/mbgl/renderer/painter_symbol.cpp
     src/mbgl/renderer/raster_bucket.cpp
     src/mbgl/renderer/raster_bucket.hpp
@@ -183,22 +241,44 @@ set(MBGL_CORE_FILES
     src/mbgl/renderer/render_tile.hpp
     src/mbgl/renderer/symbol_bucket.cpp
     src/mbgl/renderer/symbol_bucket.hpp
+    src/mbgl/renderer/tessellation_cache.cpp
+    src/mbgl/renderer/tessellation_cache.hpp
 
     # shaders
+    src/mbgl/shaders/annotation_icon.cpp
+    src/mbgl/shaders/annotation_icon.hpp
     src/mbgl/shaders/circle.cpp
     src/mbgl/shaders/circle.hpp
+    src/mbgl/shaders/circle_instanced.cpp
+    src/mbgl/shaders/circle_instanced.hpp
     src/mbgl/shaders/collision_box.cpp
     src/mbgl/shaders/collision_box.hpp
     src/mbgl/shaders/debug.cpp
     src/mbgl/shaders/debug.hpp
+    src/mbgl/shaders/extrusion_texture.cpp
+    src/mbgl/shaders/extrusion_texture.hpp
     src/mbgl/shaders/fill.cpp
     src/mbgl/shaders/fill.hpp
+    src/mbgl/shaders/fill_extrusion.cpp
+    src/mbgl/shaders/fill_extrusion.hpp
     src/mbgl/shaders/fill_outline.cpp
     src/mbgl/shaders/fill_outline.hpp
     src/mbgl/shaders/fill_outline_pattern.cpp
     src/mbgl/shaders/fill_outline_pattern.hpp
     src/mbgl/shaders/fill_pattern.cpp
     src/mbgl/shaders/fill_pattern.hpp
+    src/mbgl/shaders/fill_pick.cpp
+    src/mbgl/shaders/fill_pick.hpp
+    src/mbgl/shaders/heatmap.cpp
+    src/mbgl/shaders/heatmap.hpp
+    src/mbgl/shaders/heatmap_texture.cpp
+    src/mbgl/shaders/heatmap_texture.hpp
+    src/mbgl/shaders/hillshade.cpp
+    src/mbgl/shaders/hillshade.hpp
+    src/mbgl/shaders/hillshade_prepare.cpp
+    src/mbgl/shaders/hillshade_prepare.hpp
+    src/mbgl/shaders/layer_group.cpp
+    src/mbgl/shaders/layer_group.hpp
     src/mbgl/shaders/line.cpp
     src/mbgl/shaders/line.hpp
     src/mbgl/shaders/line_pattern.cpp
@@ -213,8 +293,12 @@ set(MBGL_CORE_FILES
     src/mbgl/shaders/shaders.hpp
     src/mbgl/shaders/symbol_icon.cpp
     src/mbgl/shaders/symbol_icon.hpp
+    src/mbgl/shaders/symbol_icon_instanced.cpp
+    src/mbgl/shaders/symbol_icon_instanced.hpp
     src/mbgl/shaders/symbol_sdf.cpp
     src/mbgl/shaders/symbol_sdf.hpp
+    src/mbgl/shaders/symbol_sdf_instanced.cpp
+    src/mbgl/shaders/symbol_sdf_instanced.hpp
 
     # sprite
     include/mbgl/sprite/sprite_image.hpp
@@ -233,6 +317,7 @@ set(MBGL_CORE_FILES
     include/mbgl/storage/online_file_source.hpp
     include/mbgl/storage/resource.hpp
     include/mbgl/storage/response.hpp
+    src/mbgl/storage/archive_file_source.hpp
     src/mbgl/storage/asset_file_source.hpp
     src/mbgl/storage/http_file_source.hpp
     src/mbgl/storage/local_file_source.hpp
@@ -241,6 +326,7 @@ set(MBGL_CORE_FILES
     src/mbgl/storage/response.cpp
 
     # style
+    include/mbgl/style/binary_style.hpp
     include/mbgl/style/conversion.hpp
     include/mbgl/style/data_driven_property_value.hpp
     include/mbgl/style/filter.hpp
@@ -252,11 +338,17 @@ set(MBGL_CORE_FILES
     include/mbgl/style/transition_options.hpp
     include/mbgl/style/types.hpp
     include/mbgl/style/undefined.hpp
+    src/mbgl/style/binary_style.cpp
+    src/mbgl/style/binary_style_conversion.hpp
     src/mbgl/style/bucket_parameters.cpp
     src/mbgl/style/bucket_parameters.hpp
+    src/mbgl/style/camera_function_cache.cpp
+    src/mbgl/style/camera_function_cache.hpp
     src/mbgl/style/cascade_parameters.hpp
     src/mbgl/style/class_dictionary.cpp
     src/mbgl/style/class_dictionary.hpp
+    src/mbgl/style/compiled_filter.cpp
+    src/mbgl/style/compiled_filter.hpp
     src/mbgl/style/cross_faded_property_evaluator.cpp
     src/mbgl/style/cross_faded_property_evaluator.hpp
     src/mbgl/style/data_driven_property_evaluator.hpp
@@ -280,8 +372,14 @@ set(MBGL_CORE_FILES
     src/mbgl/style/source_impl.cpp
     src/mbgl/style/source_impl.hpp
     src/mbgl/style/source_observer.hpp
+    src/mbgl/style/source_query.cpp
+    src/mbgl/style/source_query.hpp
+    src/mbgl/style/source_query_worker.cpp
+    src/mbgl/style/source_query_worker.hpp
     src/mbgl/style/style.cpp
     src/mbgl/style/style.hpp
+    src/mbgl/style/style_snapshot.cpp
+    src/mbgl/style/style_snapshot.hpp
     src/mbgl/style/tile_source_impl.cpp
     src/mbgl/style/tile_source_impl.hpp
     src/mbgl/style/types.cpp
@@ -297,6 +395,7 @@ set(MBGL_CORE_FILES
     include/mbgl/style/conversion/geojson_options.hpp
     include/mbgl/style/conversion/layer.hpp
     include/mbgl/style/conversion/make_property_setters.hpp
+    include/mbgl/style/conversion/native_property_setters.hpp
     include/mbgl/style/conversion/property_setter.hpp
     include/mbgl/style/conversion/property_value.hpp
     include/mbgl/style/conversion/source.hpp
@@ -325,6 +424,8 @@ set(MBGL_CORE_FILES
     include/mbgl/style/layers/custom_layer.hpp
     include/mbgl/style/layers/fill_extrusion_layer.hpp
     include/mbgl/style/layers/fill_layer.hpp
+    include/mbgl/style/layers/heatmap_layer.hpp
+    include/mbgl/style/layers/hillshade_layer.hpp
     include/mbgl/style/layers/line_layer.hpp
     include/mbgl/style/layers/raster_layer.hpp
     include/mbgl/style/layers/symbol_layer.hpp
@@ -351,6 +452,16 @@ set(MBGL_CORE_FILES
     src/mbgl/style/layers/fill_layer_impl.hpp
     src/mbgl/style/layers/fill_layer_properties.cpp
     src/mbgl/style/layers/fill_layer_properties.hpp
+    src/mbgl/style/layers/heatmap_layer.cpp
+    src/mbgl/style/layers/heatmap_layer_impl.cpp
+    src/mbgl/style/layers/heatmap_layer_impl.hpp
+    src/mbgl/style/layers/heatmap_layer_properties.cpp
+    src/mbgl/style/layers/heatmap_layer_properties.hpp
+    src/mbgl/style/layers/hillshade_layer.cpp
+    src/mbgl/style/layers/hillshade_layer_impl.cpp
+    src/mbgl/style/layers/hillshade_layer_impl.hpp
+    src/mbgl/style/layers/hillshade_layer_properties.cpp
+    src/mbgl/style/layers/hillshade_layer_properties.hpp
     src/mbgl/style/layers/line_layer.cpp
     src/mbgl/style/layers/line_layer_impl.cpp
     src/mbgl/style/layers/line_layer_impl.hpp
@@ -369,11 +480,21 @@ set(MBGL_CORE_FILES
 
     # style/sources
     include/mbgl/style/sources/geojson_source.hpp
+    include/mbgl/style/sources/raster_dem_source.hpp
     include/mbgl/style/sources/raster_source.hpp
     include/mbgl/style/sources/vector_source.hpp
+    src/mbgl/style/sources/cluster_index.cpp
+    src/mbgl/style/sources/cluster_index.hpp
+    src/mbgl/style/sources/geojson_parser.cpp
+    src/mbgl/style/sources/geojson_parser.hpp
     src/mbgl/style/sources/geojson_source.cpp
     src/mbgl/style/sources/geojson_source_impl.cpp
     src/mbgl/style/sources/geojson_source_impl.hpp
+    src/mbgl/style/sources/geojson_source_worker.cpp
+    src/mbgl/style/sources/geojson_source_worker.hpp
+    src/mbgl/style/sources/raster_dem_source.cpp
+    src/mbgl/style/sources/raster_dem_source_impl.cpp
+    src/mbgl/style/sources/raster_dem_source_impl.hpp
     src/mbgl/style/sources/raster_source.cpp
     src/mbgl/style/sources/raster_source_impl.cpp
     src/mbgl/style/sources/raster_source_impl.hpp
@@ -387,6 +508,8 @@ set(MBGL_CORE_FILES
     src/mbgl/text/check_max_angle.hpp
     src/mbgl/text/collision_feature.cpp
     src/mbgl/text/collision_feature.hpp
+    src/mbgl/text/collision_grid.cpp
+    src/mbgl/text/collision_grid.hpp
     src/mbgl/text/collision_tile.cpp
     src/mbgl/text/collision_tile.hpp
     src/mbgl/text/get_anchors.cpp
@@ -399,25 +522,46 @@ set(MBGL_CORE_FILES
     src/mbgl/text/glyph_pbf.cpp
     src/mbgl/text/glyph_pbf.hpp
     src/mbgl/text/glyph_range.hpp
+    src/mbgl/text/glyph_store.cpp
+    src/mbgl/text/glyph_store.hpp
+    src/mbgl/text/local_glyph_rasterizer.hpp
     src/mbgl/text/placement_config.hpp
     src/mbgl/text/quads.cpp
     src/mbgl/text/quads.hpp
     src/mbgl/text/shaping.cpp
     src/mbgl/text/shaping.hpp
+    src/mbgl/text/shaping_cache.cpp
+    src/mbgl/text/shaping_cache.hpp
+    src/mbgl/text/tiny_sdf.cpp
+    src/mbgl/text/tiny_sdf.hpp
 
     # tile
+    src/mbgl/tile/feature_state.cpp
+    src/mbgl/tile/feature_state.hpp
     src/mbgl/tile/geojson_tile.cpp
     src/mbgl/tile/geojson_tile.hpp
+    src/mbgl/tile/geojson_tile_data.cpp
+    src/mbgl/tile/geojson_tile_data.hpp
     src/mbgl/tile/geometry_tile.cpp
     src/mbgl/tile/geometry_tile.hpp
     src/mbgl/tile/geometry_tile_data.cpp
     src/mbgl/tile/geometry_tile_data.hpp
     src/mbgl/tile/geometry_tile_worker.cpp
     src/mbgl/tile/geometry_tile_worker.hpp
+    src/mbgl/tile/overzoom_bucket_cache.cpp
+    src/mbgl/tile/overzoom_bucket_cache.hpp
+    src/mbgl/tile/property_columns.cpp
+    src/mbgl/tile/property_columns.hpp
+    src/mbgl/tile/raster_dem_tile.cpp
+    src/mbgl/tile/raster_dem_tile.hpp
+    src/mbgl/tile/raster_dem_tile_worker.cpp
+    src/mbgl/tile/raster_dem_tile_worker.hpp
     src/mbgl/tile/raster_tile.cpp
     src/mbgl/tile/raster_tile.hpp
     src/mbgl/tile/raster_tile_worker.cpp
     src/mbgl/tile/raster_tile_worker.hpp
+    src/mbgl/tile/shared_layout_cache.cpp
+    src/mbgl/tile/shared_layout_cache.hpp
     src/mbgl/tile/tile.cpp
     src/mbgl/tile/tile.hpp
     src/mbgl/tile/tile_cache.cpp
@@ -427,12 +571,17 @@ set(MBGL_CORE_FILES
     src/mbgl/tile/tile_loader.hpp
     src/mbgl/tile/tile_loader_impl.hpp
     src/mbgl/tile/tile_observer.hpp
+    src/mbgl/tile/tile_trace.cpp
+    src/mbgl/tile/tile_trace.hpp
     src/mbgl/tile/vector_tile.cpp
     src/mbgl/tile/vector_tile.hpp
+    src/mbgl/tile/vector_tile_data.cpp
+    src/mbgl/tile/vector_tile_data.hpp
 
     # util
     include/mbgl/util/async_request.hpp
     include/mbgl/util/async_task.hpp
+    include/mbgl/util/buffer.hpp
     include/mbgl/util/char_array_buffer.hpp
     include/mbgl/util/chrono.hpp
     include/mbgl/util/color.hpp
@@ -454,11 +603,13 @@ set(MBGL_CORE_FILES
     include/mbgl/util/noncopyable.hpp
     include/mbgl/util/optional.hpp
     include/mbgl/util/platform.hpp
+    include/mbgl/util/premultiply.hpp
     include/mbgl/util/projection.hpp
     include/mbgl/util/range.hpp
     include/mbgl/util/run_loop.hpp
     include/mbgl/util/size.hpp
     include/mbgl/util/string.hpp
+    include/mbgl/util/tile_url_template.hpp
     include/mbgl/util/tileset.hpp
     include/mbgl/util/timer.hpp
     include/mbgl/util/traits.hpp
@@ -468,16 +619,20 @@ set(MBGL_CORE_FILES
     include/mbgl/util/work_request.hpp
     include/mbgl/util/work_task.hpp
     include/mbgl/util/work_task_impl.hpp
+    include/mbgl/util/work_task_queue.hpp
     src/mbgl/util/chrono.cpp
     src/mbgl/util/clip_id.cpp
     src/mbgl/util/clip_id.hpp
     src/mbgl/util/color.cpp
+    src/mbgl/util/compressed_image.cpp
+    src/mbgl/util/compressed_image.hpp
     src/mbgl/util/compression.cpp
     src/mbgl/util/constants.cpp
     src/mbgl/util/convert.cpp
     src/mbgl/util/dtoa.cpp
     src/mbgl/util/dtoa.hpp
     src/mbgl/util/event.cpp
+    src/mbgl/util/flat_map.hpp
     src/mbgl/util/font_stack.cpp
     src/mbgl/util/geo.cpp
     src/mbgl/util/geojson.cpp
@@ -505,10 +660,11 @@ set(MBGL_CORE_FILES
     src/mbgl/util/mat4.cpp
     src/mbgl/util/mat4.hpp
     src/mbgl/util/math.hpp
+    src/mbgl/util/monotonic_arena.cpp
+    src/mbgl/util/monotonic_arena.hpp
     src/mbgl/util/offscreen_texture.cpp
     src/mbgl/util/offscreen_texture.hpp
     src/mbgl/util/premultiply.cpp
-    src/mbgl/util/premultiply.hpp
     src/mbgl/util/rapidjson.hpp
     src/mbgl/util/rect.hpp
     src/mbgl/util/std.hpp
@@ -522,6 +678,7 @@ set(MBGL_CORE_FILES
     src/mbgl/util/tile_coordinate.hpp
     src/mbgl/util/tile_cover.cpp
     src/mbgl/util/tile_cover.hpp
+    src/mbgl/util/tile_url_template.cpp
     src/mbgl/util/token.hpp
     src/mbgl/util/type_list.hpp
     src/mbgl/util/url.cpp
@@ -532,4 +689,5 @@ set(MBGL_CORE_FILES
     src/mbgl/util/work_queue.cpp
     src/mbgl/util/work_queue.hpp
     src/mbgl/util/work_request.cpp
+    src/mbgl/util/work_task_queue.cpp
 )
@@ -17,10 +17,14 @@ target_sources(mbgl-node
     PRIVATE platform/node/src/node_map.cpp
     PRIVATE platform/node/src/node_request.hpp
     PRIVATE platform/node/src/node_request.cpp
+    PRIVATE platform/node/src/node_style_snapshot.hpp
+    PRIVATE platform/node/src/node_style_snapshot.cpp
     PRIVATE platform/node/src/node_feature.hpp
     PRIVATE platform/node/src/node_feature.cpp
     PRIVATE platform/node/src/node_thread_pool.hpp
     PRIVATE platform/node/src/node_thread_pool.cpp
+    PRIVATE platform/node/src/node_render_thread.hpp
+    PRIVATE platform/node/src/node_render_thread.cpp
     PRIVATE platform/node/src/util/async_queue.hpp
 )
 
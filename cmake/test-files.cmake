@@ -4,6 +4,7 @@ set(MBGL_TEST_FILES
     # actor
     test/actor/actor.test.cpp
     test/actor/actor_ref.test.cpp
+    test/actor/work_stealing_thread_pool.test.cpp
 
     # algorithm
     test/algorithm/covered_by_children.test.cpp
@@ -21,16 +22,23 @@ set(MBGL_TEST_FILES
 
     # geometry
     test/geometry/binpack.test.cpp
+    test/geometry/dem_data.test.cpp
+    test/geometry/line_atlas.test.cpp
+    test/geometry/shelf_pack.test.cpp
 
     # gl
     test/gl/bucket.test.cpp
+    test/gl/context.test.cpp
     test/gl/object.test.cpp
 
     # include/mbgl
     test/include/mbgl/test.hpp
 
     # map
+    test/map/frame_budget.test.cpp
     test/map/map.test.cpp
+    test/map/metatile.test.cpp
+    test/map/tile_snapshot.test.cpp
     test/map/transform.test.cpp
 
     # math
@@ -40,6 +48,11 @@ set(MBGL_TEST_FILES
 
     # programs
     test/programs/binary_program.test.cpp
+    test/programs/program_pack.test.cpp
+    test/programs/symbol_program.test.cpp
+
+    # renderer
+    test/renderer/tessellation_cache.test.cpp
 
     # sprite
     test/sprite/sprite_atlas.test.cpp
@@ -53,6 +66,8 @@ set(MBGL_TEST_FILES
     test/src/mbgl/test/fixture_log_observer.hpp
     test/src/mbgl/test/getrss.cpp
     test/src/mbgl/test/getrss.hpp
+    test/src/mbgl/test/simulated_file_source.cpp
+    test/src/mbgl/test/simulated_file_source.hpp
     test/src/mbgl/test/stub_file_source.cpp
     test/src/mbgl/test/stub_file_source.hpp
     test/src/mbgl/test/stub_geometry_tile_feature.hpp
@@ -74,7 +89,14 @@ set(MBGL_TEST_FILES
     test/storage/offline_download.test.cpp
     test/storage/online_file_source.test.cpp
     test/storage/resource.test.cpp
+    test/storage/response_cache.test.cpp
+    test/storage/simulated_file_source.test.cpp
     test/storage/sqlite.test.cpp
+    test/storage/tile_archive.test.cpp
+
+    # style
+    test/style/binary_style.test.cpp
+    test/style/cluster_index.test.cpp
 
     # style/conversion
     test/style/conversion/function.test.cpp
@@ -91,8 +113,10 @@ set(MBGL_TEST_FILES
     test/style/function/source_function.test.cpp
 
     # style
+    test/style/geojson_parser.test.cpp
     test/style/group_by_layout.test.cpp
     test/style/paint_property.test.cpp
+    test/style/paint_property_binder.test.cpp
     test/style/source.test.cpp
     test/style/style.test.cpp
     test/style/style_layer.test.cpp
@@ -100,27 +124,45 @@ set(MBGL_TEST_FILES
     test/style/tile_source.test.cpp
 
     # text
+    test/text/bidi.test.cpp
+    test/text/collision_grid.test.cpp
+    test/text/collision_tile.test.cpp
     test/text/glyph_atlas.test.cpp
     test/text/glyph_pbf.test.cpp
+    test/text/glyph_store.test.cpp
     test/text/quads.test.cpp
+    test/text/shaping_cache.test.cpp
+    test/text/tiny_sdf.test.cpp
 
     # tile
     test/tile/annotation_tile.test.cpp
+    test/tile/feature_state.test.cpp
     test/tile/geojson_tile.test.cpp
     test/tile/geometry_tile_data.test.cpp
+    test/tile/overzoom_bucket_cache.test.cpp
     test/tile/raster_tile.test.cpp
+    test/tile/shared_layout_cache.test.cpp
+    test/tile/symbol_feature_cache.test.cpp
+    test/tile/tile_cache.test.cpp
     test/tile/tile_coordinate.test.cpp
     test/tile/tile_id.test.cpp
+    test/tile/tile_trace.test.cpp
     test/tile/vector_tile.test.cpp
 
     # util
     test/util/async_task.test.cpp
+    test/util/compressed_image.test.cpp
+    test/util/flat_map.test.cpp
     test/util/geo.test.cpp
+    test/util/grid_index.test.cpp
     test/util/http_timeout.test.cpp
+    test/util/i18n.test.cpp
     test/util/image.test.cpp
+    test/util/logging.test.cpp
     test/util/mapbox.test.cpp
     test/util/memory.test.cpp
     test/util/merge_lines.test.cpp
+    test/util/monotonic_arena.test.cpp
     test/util/number_conversions.test.cpp
     test/util/offscreen_texture.test.cpp
     test/util/projection.test.cpp
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <vector>
 
 namespace mbgl {
 
@@ -12,22 +14,53 @@ class Message;
 class Mailbox : public std::enable_shared_from_this<Mailbox> {
 public:
     Mailbox(Scheduler&);
+    ~Mailbox();
 
     void push(std::unique_ptr<Message>);
 
+    // Like push(), except that a message of the same kind that is still pending is superseded
+    // by this one: it is replaced in place if it is the last message in the queue, and dropped
+    // otherwise, so that messages are still received in the order they were sent.
+    void pushLatest(std::unique_ptr<Message>);
+
+    // Releases the pending messages without receiving them, and waits for a message that is
+    // being received to return. Messages pushed after that are released right away; refs to an
+    // actor may still send it messages while it is being destroyed.
     void close();
     void receive();
 
     static void maybeReceive(std::weak_ptr<Mailbox>);
 
+    // A scheduling hint. Schedulers that support it receive mailboxes with a higher priority
+    // before any with a lower one. It takes effect the next time the mailbox is scheduled.
+    void setPriority(int32_t);
+    int32_t getPriority() const;
+
 private:
     Scheduler& scheduler;
 
+    std::atomic<int32_t> priority { 0 };
+
     std::mutex closingMutex;
-    bool closing { false };
+    std::atomic<bool> closing { false };
+
+    // An intrusive, lock-free multi-producer/single-consumer queue (Vyukov). Producers append
+    // at `head`; the single consumer -- there is never more than one receive() at a time --
+    // removes from `tail`. `size` counts queued messages and decides when to schedule.
+    Message* pop();
+    void enqueue(Message*);
+
+    // Pending messages sent with pushLatest(). Each non-empty slot has exactly one
+    // corresponding message in the queue, which runs whatever the slot holds at that time.
+    class Slot;
+    class SlotMessage;
+    std::mutex slotsMutex;
+    std::vector<std::unique_ptr<Slot>> slots;
 
-    std::mutex queueMutex;
-    std::queue<std::unique_ptr<Message>> queue;
+    std::unique_ptr<Message> stub;
+    std::atomic<Message*> head;
+    Message* tail;
+    std::atomic<std::size_t> size { 0 };
 };
 
 } // namespace mbgl
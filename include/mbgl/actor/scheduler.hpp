@@ -19,7 +19,16 @@ class Mailbox;
         concurrency within a mailbox
 
       Subject to these constraints, processing can happen on whatever thread in the
-      pool is available.
+      pool is available. Mailboxes with a higher priority (see `Mailbox::setPriority`)
+      are processed before those with a lower priority; mailboxes of equal priority are
+      processed in the order in which they were scheduled.
+
+    * `WorkStealingThreadPool` provides the same guarantees as `ThreadPool`, but gives
+      each thread its own lock-free deque and lets idle threads steal from their peers.
+      It does not take mailbox priorities into account.
+      Mailboxes scheduled from within the pool stay on the scheduling thread where
+      possible. It's preferable when many actors wake up at once on machines with many
+      cores.
 
     * `RunLoop` is a `Scheduler` that is typically used to create a mailbox and
       `ActorRef` for an object that lives on the main thread and is not itself wrapped
@@ -33,6 +42,11 @@ class Scheduler {
 public:
     virtual ~Scheduler() = default;
     virtual void schedule(std::weak_ptr<Mailbox>) = 0;
+
+    // Hints that the scheduled work is on the critical path of an interaction such as a gesture,
+    // so that schedulers which own threads run them on the fastest cores. Calls that start and
+    // end an interaction come in pairs, and nest when several maps share the scheduler.
+    virtual void setInteractive(bool) {}
 };
 
 } // namespace mbgl
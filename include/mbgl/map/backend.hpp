@@ -29,7 +29,9 @@ public:
     virtual void updateAssumedState() = 0;
 
     // Called when the map needs to be rendered; the backend should call Map::render() at some point
-    // in the near future. (Not called for Map::renderStill() mode.)
+    // in the near future. (Not called for Map::renderStill() mode.) Backends that are driven by
+    // the display's refresh should only note that the map is invalid, and render it once on the
+    // next tick with the predicted presentation time, however often this is called in between.
     virtual void invalidate() = 0;
 
 protected:
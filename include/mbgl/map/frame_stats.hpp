@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+// A profile of the most recently rendered frame.
+class FrameStats {
+public:
+    // CPU time spent in each stage of the frame. Stages that didn't run in the frame are zero.
+    Duration recalculateStyle = Duration::zero();
+    Duration updateTiles = Duration::zero();
+    Duration upload = Duration::zero();
+    Duration clipping = Duration::zero();
+    Duration opaquePass = Duration::zero();
+    Duration translucentPass = Duration::zero();
+    Duration cleanup = Duration::zero();
+
+    // GPU time spent in each stage, measured with timer queries. The GPU finishes frames after
+    // the CPU, so these belong to a frame a few frames back. Empty if the GL implementation
+    // doesn't support GL_EXT_disjoint_timer_query or GL_ARB_timer_query.
+    std::vector<std::pair<std::string, Duration>> gpuStages;
+
+    // The fraction of the viewport that was drawn: 1 when the frame was drawn in full, and 0
+    // when nothing changed since the last frame, in views that preserve their contents.
+    float redrawnArea = 1;
+
+    // The number of layer groups that were composited from their textures, and how many of them
+    // were drawn into their textures first; see Map::setLayerCaching().
+    std::size_t layerGroups = 0;
+    std::size_t layerGroupsDrawn = 0;
+
+    std::size_t draws = 0;
+    std::size_t programSwitches = 0;
+    std::size_t textureBinds = 0;
+    std::size_t vertexArrayBinds = 0;
+
+    // In the overdraw debug mode of debug builds, the average number of fragments drawn per
+    // pixel, measured up to 8 before the debug overlays. Zero otherwise.
+    float overdraw = 0;
+
+    // The number of tiles rendered for each source, by source ID.
+    std::unordered_map<std::string, std::size_t> renderTiles;
+};
+
+} // namespace mbgl
@@ -4,8 +4,11 @@
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/map/map_observer.hpp>
 #include <mbgl/map/mode.hpp>
+#include <mbgl/map/frame_stats.hpp>
+#include <mbgl/map/memory_usage.hpp>
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/feature.hpp>
+#include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/size.hpp>
 #include <mbgl/annotation/annotation.hpp>
@@ -16,6 +19,7 @@
 #include <cstdint>
 #include <string>
 #include <functional>
+#include <utility>
 #include <vector>
 #include <memory>
 
@@ -26,14 +30,18 @@ class View;
 class FileSource;
 class Scheduler;
 class SpriteImage;
+class Metatile;
 
 namespace style {
 class Source;
 class Layer;
+class StyleSnapshot;
 } // namespace style
 
 class Map : private util::noncopyable {
 public:
+    // When a local font family is given, CJK ideographs and Hangul syllables are drawn with that
+    // font on platforms that support it, instead of downloading their glyph ranges.
     explicit Map(Backend&,
                  Size size,
                  float pixelRatio,
@@ -43,7 +51,8 @@ public:
                  GLContextMode contextMode = GLContextMode::Unique,
                  ConstrainMode constrainMode = ConstrainMode::HeightOnly,
                  ViewportMode viewportMode = ViewportMode::Default,
-                 const std::string& programCacheDir = "");
+                 const std::string& programCacheDir = "",
+                 optional<std::string> localFontFamily = {});
     ~Map();
 
     // Register a callback that will get called (on the render thread) when all resources have
@@ -51,12 +60,31 @@ public:
     using StillImageCallback = std::function<void (std::exception_ptr)>;
     void renderStill(View&, StillImageCallback callback);
 
+    // Renders an image for each of the cameras into the view, one after the other, and leaves the
+    // map at the last camera. The tiles of all cameras are loaded before the first image is
+    // rendered, and are shared between them. The callback is called with the index of each camera
+    // once its image is in the view, and must read the image before returning. After an error, it
+    // is called once more with the error and the index of the camera that wasn't rendered, and the
+    // remaining cameras are dropped.
+    using StillImagesCallback = std::function<void (std::exception_ptr, std::size_t index)>;
+    void renderStills(View&, std::vector<CameraOptions>, StillImagesCallback callback);
+
+    // Resizes the map to the metatile and renders it in one pass. The view must have the size of the
+    // metatile in device pixels; Metatile::slice() cuts its image into those of the tiles.
+    void renderMetatile(View&, const Metatile&, StillImageCallback callback);
+
     // Triggers a repaint.
     void triggerRepaint();
 
     // Main render function.
     void render(View&);
 
+    // Renders the frame that the display presents at the given time, as predicted by the display
+    // link that ticks at its refresh. Transitions and animations are sampled at that time rather
+    // than at the time the frame happens to be drawn, so that they advance evenly from one
+    // refresh to the next. See Backend::invalidate().
+    void render(View&, TimePoint presentationTime);
+
     // Styling
     void addClass(const std::string&);
     void removeClass(const std::string&);
@@ -70,6 +98,17 @@ public:
 
     void setStyleURL(const std::string&);
     void setStyleJSON(const std::string&);
+    // Loads a style that style::encodeBinaryStyle has encoded from its JSON, which skips parsing
+    // the JSON. getStyleJSON returns an empty string for such styles.
+    void setStyleBinary(const std::string&);
+    // Loads copies of the style that another map took a snapshot of, without parsing it or
+    // loading the TileJSON, GeoJSON data and sprite that the other map had loaded. The snapshot
+    // can be shared by any number of maps on the thread that took it. getStyleJSON returns an
+    // empty string for such styles.
+    void setStyleSnapshot(std::shared_ptr<const style::StyleSnapshot>);
+    // Takes a snapshot of the style, leaving out annotations and custom layers. Throws if the
+    // style isn't loaded.
+    std::shared_ptr<const style::StyleSnapshot> getStyleSnapshot() const;
     std::string getStyleURL() const;
     std::string getStyleJSON() const;
 
@@ -156,6 +195,14 @@ public:
     ScreenCoordinate pixelForLatLng(const LatLng&) const;
     LatLng latLngForPixel(const ScreenCoordinate&) const;
 
+    // Convert many points at once, which is cheaper than converting them one at a time. The
+    // overloads that take a vector write the results to it, and reuse its capacity from one
+    // call to the next.
+    std::vector<ScreenCoordinate> pixelsForLatLngs(const std::vector<LatLng>&) const;
+    void pixelsForLatLngs(const std::vector<LatLng>&, std::vector<ScreenCoordinate>&) const;
+    std::vector<LatLng> latLngsForPixels(const std::vector<ScreenCoordinate>&) const;
+    void latLngsForPixels(const std::vector<ScreenCoordinate>&, std::vector<LatLng>&) const;
+
     // Annotations
     void addAnnotationIcon(const std::string&, std::shared_ptr<const SpriteImage>);
     void removeAnnotationIcon(const std::string&);
@@ -165,6 +212,12 @@ public:
     void updateAnnotation(AnnotationID, const Annotation&);
     void removeAnnotation(AnnotationID);
 
+    // Draws the icons of point annotations straight from a GPU buffer, rather than laying them out
+    // into tiles. Moving an annotation then only rewrites its own instance, but its icon is no
+    // longer placed against the style's labels and is drawn above all layers.
+    void setInstancedPointAnnotations(bool);
+    bool getInstancedPointAnnotations() const;
+
     // Sources
     std::vector<style::Source*> getSources();
     style::Source* getSource(const std::string& sourceID);
@@ -193,12 +246,129 @@ public:
     std::vector<Feature> queryRenderedFeatures(const ScreenCoordinate&, const RenderedQueryOptions& options = {});
     std::vector<Feature> queryRenderedFeatures(const ScreenBox&,        const RenderedQueryOptions& options = {});
 
+    // Finds the same features as queryRenderedFeatures, but doesn't convert them, e.g. for hit
+    // testing on every pointer move.
+    std::vector<RenderedFeatureHandle> queryRenderedFeatureHandles(const ScreenCoordinate&, const RenderedQueryOptions& options = {});
+    std::vector<RenderedFeatureHandle> queryRenderedFeatureHandles(const ScreenBox&,        const RenderedQueryOptions& options = {});
+
+    // Returns the feature at the point that is rendered on top, like the first one of the top-most
+    // layer that queryRenderedFeatureHandles finds. While feature picking is enabled and the map
+    // is at rest, points that only fill layers are queried at are looked up by reading a pixel of
+    // the picking buffer; other queries, and those the buffer can't answer, use the feature index.
+    optional<RenderedFeatureHandle> pickRenderedFeature(const ScreenCoordinate&, const RenderedQueryOptions& options = {});
+
+    // Draws the fills of the map into the picking buffer whenever the map comes to rest. Their
+    // tiles are laid out anew when it is switched, with the feature of each vertex. Off by default.
+    void setFeaturePicking(bool);
+    bool getFeaturePicking() const;
+
     AnnotationIDs queryPointAnnotations(const ScreenBox&);
 
+    // Feature state
+    // Sets values that the data-driven paint properties of fill, line and circle layers read in
+    // place of the feature's properties of the same name. The source layer is the one that the
+    // style layers name, which is empty for GeoJSON sources. Only the buckets of the tiles whose
+    // features changed state are repainted; they aren't laid out again. An empty state removes
+    // the feature's state. Filters, layout properties and symbol layers don't read states.
+    void setFeatureState(const std::string& sourceID, const std::string& sourceLayer,
+                         const FeatureIdentifier&, PropertyMap state);
+    PropertyMap getFeatureState(const std::string& sourceID, const std::string& sourceLayer,
+                                const FeatureIdentifier&) const;
+
     // Memory
     void setSourceTileCacheSize(size_t);
+
+    // Limits the bytes of the buffers, textures and renderbuffers that the map holds on the GPU.
+    // After each frame that leaves it over budget, the buffers of the cached tiles are freed,
+    // and then those of the loaded tiles that aren't rendered. Their vertex data is kept to
+    // upload them again when they are rendered, unless setReleaseBucketData() freed it, in
+    // which case cached tiles are evicted instead. Zero, the default, means no limit.
+    void setGPUMemoryBudget(std::size_t);
+    std::size_t getGPUMemoryBudget() const;
+
+    // Sets the size in bytes of the process-wide cache through which maps that show the same
+    // style share the layout of their vector tiles. The cache is disabled by default.
+    static void setSharedLayoutCacheSize(size_t);
+
+    // Sets the size in bytes of the process-wide cache of triangulated polygons, which lets
+    // overzoomed tiles and maps showing the same data skip tessellating large polygons again.
+    // Defaults to 8 MB; 0 disables the cache.
+    static void setTessellationCacheSize(size_t);
+
+    // Adds the glyphs of a glyph PBF to the process-wide store through which maps share the
+    // glyphs they load. Preloaded ranges are kept even while no map uses them, so that maps
+    // whose style uses the same glyph URL template don't have to request them. Throws if the
+    // data is malformed.
+    static void preloadGlyphs(const std::string& glyphURL, const FontStack&,
+                              std::pair<uint16_t, uint16_t> range, const std::string& data);
+    static void clearPreloadedGlyphs();
+
+    // Sets whether tiles free the CPU copies of their vertex, index and image data once it has
+    // been uploaded, which roughly halves the memory held by rendered and cached tiles. Buckets
+    // that are already uploaded are not affected. Off by default.
+    void setReleaseBucketData(bool);
+
+    // Draws runs of adjacent fill, line and circle layers into textures somewhat larger than the
+    // viewport, and while the map only pans, composites the textures instead of drawing the layers
+    // again. A run is drawn again when its tiles, the style, the zoom, the bearing or the size
+    // change, or when it would leave its texture; nothing is cached while the map is pitched.
+    // Each run takes about twice the memory of the framebuffer. Off by default.
+    void setLayerCaching(bool);
+    bool getLayerCaching() const;
+
+    // In continuous mode, lays out the tiles around the viewport, and those a zoom level above and
+    // below it, while the camera doesn't move, so that a small pan or zoom finds them ready. They
+    // are only loaded from the cache of the file source, behind all other tiles, and are no more
+    // than the tile cache holds. Off by default.
+    void setIdlePrelayout(bool);
+    bool getIdlePrelayout() const;
+
+    // In still mode, holds the rendering of each image back until no continuous map of the
+    // process has drawn a frame for a tenth of a second, so that maps rendering in the background
+    // don't take GPU time from a map that is being interacted with. Off by default.
+    void setYieldsToContinuousMaps(bool);
+    bool getYieldsToContinuousMaps() const;
+
     void onLowMemory();
 
+    // Returns the profile of the most recently rendered frame.
+    FrameStats getFrameStats() const;
+
+    // Sets the time that rendering a frame in continuous mode should take. While frames take
+    // longer on average, they are rendered at lower qualities, until the map is idle again.
+    // Zero, the default, disables the budget.
+    void setFrameBudget(Duration);
+    Duration getFrameBudget() const;
+    RenderQuality getRenderQuality() const;
+
+    // Returns the latency of each pipeline stage of the loaded tiles, from requesting the
+    // data to uploading the buckets, in the Chrome trace-event JSON format.
+    std::string getTileTraces() const;
+
+    // Returns an approximate breakdown of the memory held by the tiles, caches and atlases.
+    MemoryUsage getMemoryUsage() const;
+
+    // Warm start
+    // Returns the tiles of the tile sources that were rendered last, to be passed to
+    // setTileSnapshot() when a map starts at the same camera, e.g. after the app restarts.
+    std::string getTileSnapshot() const;
+
+    // Looks up the tiles of a snapshot in the cache right away, without waiting for the style
+    // and its TileJSON, so that the sources' tile requests join the lookups or find them done.
+    // Throws std::runtime_error if the snapshot is malformed.
+    void setTileSnapshot(const std::string& data);
+
+    // Program cache
+    // Compiles and links every variant of every program for each pixel ratio, with and without
+    // overdraw, and returns their binaries as a program pack for the current GPU driver. Nothing
+    // is written to the program cache. Throws if the driver doesn't support binary programs.
+    std::string generateProgramPack(const std::vector<float>& pixelRatios);
+
+    // Adds the programs of a program pack that match this map's pixel ratio to the program
+    // cache, if the pack was generated with the same GPU driver and the driver accepts them.
+    // Returns the number of programs that were added.
+    std::size_t importProgramPack(const std::string& data);
+
     // Debug
     void setDebug(MapDebugOptions);
     void cycleDebugOptions();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mbgl/map/mode.hpp>
 #include <mbgl/style/source.hpp>
 
 #include <cstdint>
@@ -37,6 +38,9 @@ public:
     virtual void onDidFinishRenderingMap(RenderMode) {}
     virtual void onDidFinishLoadingStyle() {}
     virtual void onSourceChanged(style::Source&) {}
+
+    // Called when frames start being rendered at another quality to hold the frame budget.
+    virtual void onRenderQualityChanged(RenderQuality) {}
 };
 
 } // namespace mbgl
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+// An approximate breakdown of the memory held by a map, in bytes.
+class MemoryUsage {
+public:
+    class Tiles {
+    public:
+        // The source data of the tiles, as received. Vector tile layers are decoded on demand.
+        std::size_t tileData = 0;
+
+        // Vertex, index and image data of the buckets that is held in CPU memory.
+        std::size_t vertexData = 0;
+
+        // Vertex buffers, index buffers and textures of the buckets in GPU memory.
+        std::size_t bufferData = 0;
+
+        // The indexes used to query rendered features.
+        std::size_t featureIndex = 0;
+        std::size_t collisionTile = 0;
+
+        std::size_t total() const {
+            return tileData + vertexData + bufferData + featureIndex + collisionTile;
+        }
+    };
+
+    class Source {
+    public:
+        // Tiles that are loaded or loading for the current view.
+        Tiles tiles;
+
+        // Tiles held by the source's tile cache for later reuse.
+        std::size_t cachedTiles = 0;
+    };
+
+    // By source ID.
+    std::unordered_map<std::string, Source> sources;
+
+    // The atlas images. Once uploaded, their textures take as much GPU memory again.
+    std::size_t glyphAtlas = 0;
+    std::size_t spriteAtlas = 0;
+    std::size_t lineAtlas = 0;
+
+    // Memory held by the file source's caches, such as the page cache of the offline database.
+    std::size_t fileSource = 0;
+
+    // The buffers, textures and renderbuffers of the map's GL context, which includes the
+    // buffer data of the tiles. Limited by Map::setGPUMemoryBudget().
+    std::size_t gpu = 0;
+};
+
+} // namespace mbgl
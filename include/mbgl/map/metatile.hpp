@@ -0,0 +1,44 @@
+#pragma once
+
+#include <mbgl/map/camera.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/size.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+// A block of adjacent tiles that is rendered as one image and then cut into the images of its
+// tiles. Symbols are laid out and placed once for the whole block, so labels are consistent across
+// the seams between its tiles. The image extends `buffer` pixels beyond the block on each side,
+// so that labels near its outer edges aren't clipped by the viewport; render it on a map with
+// ConstrainMode::None so that a buffer beyond the poles doesn't move the camera.
+class Metatile {
+public:
+    // The block of `count` × `count` tiles at zoom level `z` whose top left tile is `x`/`y`. It is
+    // cut short at the edges of the world.
+    Metatile(uint8_t z, uint32_t x, uint32_t y, uint32_t count, uint16_t tileSize = 512, uint16_t buffer = 0);
+
+    uint32_t getColumns() const { return columns; }
+    uint32_t getRows() const { return rows; }
+
+    // The size of the map, in logical pixels, and the camera to render the block with.
+    Size getSize() const;
+    CameraOptions getCamera() const;
+
+    // Cuts a rendered image of the block into the images of its tiles, top row first and left to
+    // right within a row. The image may be in device pixels of an integer pixel ratio.
+    std::vector<PremultipliedImage> slice(const PremultipliedImage&) const;
+
+private:
+    const uint8_t z;
+    const uint32_t x;
+    const uint32_t y;
+    const uint32_t columns;
+    const uint32_t rows;
+    const uint16_t tileSize;
+    const uint16_t buffer;
+};
+
+} // namespace mbgl
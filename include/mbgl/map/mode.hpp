@@ -37,6 +37,17 @@ enum class ViewportMode : EnumType {
     FlippedY,
 };
 
+// The quality at which frames are rendered. While frames take longer than the frame budget,
+// the quality is lowered one level at a time; each level also includes the ones before it.
+enum class RenderQuality : EnumType {
+    Full,
+    NoCollisionDebug, // collision boxes aren't drawn, even if the debug option is set
+    NoFadeIn,         // symbols appear and disappear without fading
+    SinglePassHalos,  // halos are drawn with their glyphs' fills, and may cover neighbouring glyphs
+    ReducedUploads,   // fewer buckets are uploaded per frame; tiles show their parents longer
+    Lowest = ReducedUploads,
+};
+
 enum class MapDebugOptions : EnumType {
     NoDebug     = 0,
     TileBorders = 1 << 1,
@@ -1,13 +1,24 @@
 #pragma once
 
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/feature.hpp>
 #include <mbgl/style/filter.hpp>
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace mbgl {
 
+class CanonicalTileID;
+class GeometryTileData;
+class GeometryTileLayer;
+
+namespace style {
+class Layer;
+} // namespace style
+
 /**
  * Options for query rendered features.
  */
@@ -19,4 +30,37 @@ public:
     optional<style::Filter> filter;
 };
 
-}
+/**
+ * A rendered feature that is found by Map::queryRenderedFeatureHandles without converting it:
+ * the style layer it was rendered with, and its index in the data of a tile. Its identifier,
+ * properties and geometry are read on demand. The handle retains the tile's data, but the style
+ * layer is only valid until it is removed from the style.
+ */
+class RenderedFeatureHandle {
+public:
+    RenderedFeatureHandle(const style::Layer&,
+                          std::shared_ptr<const GeometryTileData>,
+                          const GeometryTileLayer& sourceLayer,
+                          std::size_t index,
+                          const CanonicalTileID&);
+
+    const style::Layer& getLayer() const { return *layer; }
+    std::size_t getIndex() const { return index; }
+
+    optional<FeatureIdentifier> getID() const;
+    optional<Value> getValue(const std::string& key) const;
+
+    /** Converts the feature, as it is returned by Map::queryRenderedFeatures. */
+    Feature getFeature() const;
+
+private:
+    const style::Layer* layer;
+    std::shared_ptr<const GeometryTileData> data;
+    const GeometryTileLayer* sourceLayer;
+    std::size_t index;
+    uint8_t z;
+    uint32_t x;
+    uint32_t y;
+};
+
+} // namespace mbgl
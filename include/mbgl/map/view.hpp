@@ -15,6 +15,19 @@ public:
     // calling .bind() repeatedly is a no-op and that the appropriate gl::Context values are
     // set to the current state.
     virtual void bind() = 0;
+
+    // Whether the renderable object still holds what was drawn into it last, so that frames only
+    // need to draw the parts of it that changed since. Views that lose their contents, e.g. by
+    // swapping buffers, must return false.
+    virtual bool preservesContents() const {
+        return false;
+    }
+
+    // Whether the renderable object is multisampled, which smooths the edges of fills without the
+    // outlines that are drawn around them otherwise.
+    virtual bool isMultisampled() const {
+        return false;
+    }
 };
 
 } // namespace mbgl
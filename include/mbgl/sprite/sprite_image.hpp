@@ -2,6 +2,7 @@
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/geo.hpp>
+#include <mbgl/util/geometry.hpp>
 #include <mbgl/util/image.hpp>
 
 #include <string>
@@ -14,7 +15,13 @@ class SpriteImage : private util::noncopyable {
 public:
     SpriteImage(PremultipliedImage&&, float pixelRatio, bool sdf = false);
 
-    PremultipliedImage image;
+    // An image of an area of a sprite sheet, which refers to the pixels of the sheet instead of
+    // copying them. The sheet is shared by the images of its sprite.
+    SpriteImage(std::shared_ptr<const PremultipliedImage> sheet, Point<uint32_t> origin, Size,
+                float pixelRatio, bool sdf = false);
+
+    // Size of the image in pixels.
+    const Size size;
 
     // Pixel ratio of the sprite image.
     const float pixelRatio;
@@ -22,8 +29,21 @@ public:
     // Whether this image should be interpreted as a signed distance field icon.
     const bool sdf;
 
-    float getWidth() const { return image.size.width / pixelRatio; }
-    float getHeight() const { return image.size.height / pixelRatio; }
+    float getWidth() const { return size.width / pixelRatio; }
+    float getHeight() const { return size.height / pixelRatio; }
+
+    // Returns a copy of the pixels of the image.
+    PremultipliedImage getImage() const;
+
+    // Copies an area of the image into another image, like PremultipliedImage::copy().
+    void copy(PremultipliedImage& dst, const Point<uint32_t>& srcPt, const Point<uint32_t>& dstPt,
+              const Size&) const;
+
+private:
+    void validate() const;
+
+    std::shared_ptr<const PremultipliedImage> pixels;
+    const Point<uint32_t> origin;
 };
 
 } // namespace mbgl
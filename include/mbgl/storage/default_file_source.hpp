@@ -20,16 +20,28 @@ public:
      * There is no size limit for offline resources. If a user never creates any offline
      * regions, we want the database to remain fairly small (order tens or low hundreds
      * of megabytes).
+     *
+     * With writeAheadLog, the database is switched to a write-ahead log with fewer syncs to
+     * disk, which speeds up writes at the risk of losing the most recent ones on power loss;
+     * the database itself is never corrupted. Without it, a database that was switched before
+     * is switched back. Either way the schema is unchanged, so the database stays readable by
+     * every release.
      */
     DefaultFileSource(const std::string& cachePath,
                       const std::string& assetRoot,
-                      uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+                      uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE,
+                      bool writeAheadLog = false);
     ~DefaultFileSource() override;
 
     bool supportsOptionalRequests() const override {
         return true;
     }
 
+    void preconnect(const std::string& url) override;
+
+    // Reports the memory held by SQLite, mostly the page cache of the offline database.
+    std::size_t getMemoryUsage() const override;
+
     void setAPIBaseURL(const std::string&);
     std::string getAPIBaseURL() const;
 
@@ -109,12 +121,57 @@ public:
      */
     void deleteOfflineRegion(OfflineRegion&&, std::function<void (std::exception_ptr)>);
 
+    /*
+     * Write an offline region, with all of its resources that are in the database, to an
+     * archive file at the given path, so that the region can be provisioned on other devices
+     * with `importOfflineRegion` rather than downloaded resource by resource. The archive is
+     * written sequentially, and holds the data of resources as it is stored, mostly compressed.
+     *
+     * When the operation is complete or encounters an error, the given callback will be
+     * executed on the database thread; it is the responsibility of the SDK bindings
+     * to re-execute a user-provided callback on the main thread.
+     */
+    void exportOfflineRegion(OfflineRegion&, const std::string& path,
+                             std::function<void (std::exception_ptr)>) const;
+
+    /*
+     * Create an offline region from an archive file written by `exportOfflineRegion`. The
+     * region and all of its resources are inserted in a single transaction, so that a corrupt
+     * or incomplete archive leaves the database as it was.
+     *
+     * When the operation is complete or encounters an error, the given callback will be
+     * executed on the database thread; it is the responsibility of the SDK bindings
+     * to re-execute a user-provided callback on the main thread.
+     *
+     * Note that the resulting region will be in an inactive download state. Activating it
+     * downloads whatever resources the archive lacks.
+     */
+    void importOfflineRegion(const std::string& path,
+                             std::function<void (std::exception_ptr, optional<OfflineRegion>)>);
+
     /*
      * Changing or bypassing this limit without permission from Mapbox is prohibited
      * by the Mapbox Terms of Service.
      */
     void setOfflineMapboxTileCountLimit(uint64_t) const;
 
+    /*
+     * Compress tiles stored from now on with a dictionary per tileset, trained on the first
+     * tiles stored for it. Vector tiles compress considerably better this way, which mostly
+     * benefits large offline regions. Tiles are readable however they were stored. Off by
+     * default.
+     */
+    void setTileCompressionDictionaries(bool);
+
+    /*
+     * Set the number of bytes of response data that are held in memory in front of the
+     * database, so that resources which are requested again soon after, e.g. by another map or
+     * as a style is reloaded, are answered without reading them from it. Stale responses are
+     * revalidated as they would be when read from the database. Defaults to
+     * util::DEFAULT_RESPONSE_CACHE_SIZE; 0 disables the memory cache.
+     */
+    void setResponseCacheSize(std::size_t);
+
     /*
      * Pause file request activity.
      *
@@ -140,6 +197,7 @@ private:
     const std::unique_ptr<util::Thread<Impl>> thread;
     const std::unique_ptr<FileSource> assetFileSource;
     const std::unique_ptr<FileSource> localFileSource;
+    const std::unique_ptr<FileSource> archiveFileSource;
     std::string cachedBaseURL = mbgl::util::API_BASE_URL;
     std::string cachedAccessToken;
 };
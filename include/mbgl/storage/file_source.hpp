@@ -6,8 +6,10 @@
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/async_request.hpp>
 
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <string>
 
 namespace mbgl {
 
@@ -31,6 +33,16 @@ public:
     virtual bool supportsOptionalRequests() const {
         return false;
     }
+
+    // Hints that requests to the host of the given URL, a tile URL template for example, are
+    // about to follow, so that the file source can open a connection to it ahead of time.
+    virtual void preconnect(const std::string& /* url */) {
+    }
+
+    // Returns the approximate number of bytes of memory held by the caches of this file source.
+    virtual std::size_t getMemoryUsage() const {
+        return 0;
+    }
 };
 
 } // namespace mbgl
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <mbgl/util/chrono.hpp>
+
 #include <atomic>
+#include <cstddef>
 #include <mutex>
 #include <unordered_set>
 
@@ -25,8 +28,19 @@ public:
     static void Subscribe(util::AsyncTask* async);
     static void Unsubscribe(util::AsyncTask* async);
 
+    // An estimate of the throughput of the network in bytes per second, a moving average over
+    // the transfers that file sources record, or 0 until there's one. Platforms that measure
+    // the link themselves can set it instead; setting it to 0 forgets the estimate.
+    static double GetThroughput();
+    static void SetThroughput(double);
+    static void RecordTransfer(std::size_t bytes, Duration);
+
+    // Whether the estimate is so low that resources should be requested at a lower resolution.
+    static bool IsSlow();
+
 private:
     static std::atomic<bool> online;
+    static std::atomic<double> throughput;
     static std::mutex mtx;
     static std::unordered_set<util::AsyncTask*> observers;
 };
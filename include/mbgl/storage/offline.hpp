@@ -32,6 +32,12 @@ public:
     /* Private */
     std::vector<CanonicalTileID> tileCover(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
 
+    // The zoom levels of the tiles of a source, which are none if min > max.
+    Range<uint8_t> coveringZoomRange(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
+
+    // The number of tiles per source, computed without enumerating them.
+    uint64_t tileCount(SourceType, uint16_t tileSize, const Range<uint8_t>& zoomRange) const;
+
     const std::string styleURL;
     const LatLngBounds bounds;
     const double minZoom;
@@ -128,6 +134,21 @@ public:
      */
     bool requiredResourceCountIsPrecise = false;
 
+    /**
+     * The rate, in bytes per second, at which resources have been downloaded from the
+     * network since the download was last activated. Resources that were already in the
+     * database don't count towards it. It is zero while the download is inactive.
+     */
+    double downloadRate = 0;
+
+    /**
+     * An estimate of how long it takes to download the remaining resources, at the rate
+     * at which resources have been downloaded so far. It is only present while the
+     * download is active, once `requiredResourceCountIsPrecise` is true and at least one
+     * resource has been downloaded from the network.
+     */
+    optional<Duration> estimatedTimeRemaining;
+
     bool complete() const {
         return completedResourceCount == requiredResourceCount;
     }
@@ -22,6 +22,10 @@ public:
 
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
 
+    // Connects to the host of the given tile URL template, unless a resource transform may send
+    // its tiles elsewhere.
+    void preconnect(const std::string& url) override;
+
 private:
     friend class OnlineFileRequest;
 
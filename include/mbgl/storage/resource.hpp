@@ -3,8 +3,11 @@
 #include <mbgl/storage/response.hpp>
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/tile_url_template.hpp>
 #include <mbgl/util/tileset.hpp>
 
+#include <cstdint>
+#include <limits>
 #include <string>
 
 namespace mbgl {
@@ -50,19 +53,44 @@ public:
                          int8_t z,
                          Tileset::Scheme scheme,
                          Necessity = Required);
+    // Builds the URL from a template that was parsed beforehand, e.g. once for each source.
+    static Resource tile(const TileURLTemplate&,
+                         float pixelRatio,
+                         int32_t x,
+                         int32_t y,
+                         int8_t z,
+                         Tileset::Scheme scheme,
+                         Necessity = Required);
     static Resource glyphs(const std::string& urlTemplate,
                            const FontStack& fontStack,
                            const std::pair<uint16_t, uint16_t>& glyphRange);
     static Resource spriteImage(const std::string& base, float pixelRatio);
     static Resource spriteJSON(const std::string& base, float pixelRatio);
 
+    // Requests that are due while the file source has as many as it can in flight wait their
+    // turn; those with a higher priority go first. Tiles of the map are prioritized by their
+    // distance from the center of the viewport, followed by tiles that are loaded ahead of a
+    // camera animation, and then by revalidations of stale resources that were served from the
+    // cache; resources of offline downloads come last. Styles, TileJSON and sprites go before
+    // everything else, since no tile can be requested or drawn without them.
+    static constexpr int32_t StylePriority = std::numeric_limits<int32_t>::max();
+    static constexpr int32_t OfflineDownloadPriority = std::numeric_limits<int32_t>::min();
+    static constexpr int32_t RevalidationPriority = OfflineDownloadPriority + 1;
+
     Kind kind;
     Necessity necessity;
     std::string url;
+    int32_t priority = 0;
 
     // Includes auxiliary data if this is a tile request.
     optional<TileData> tileData;
 
+    // Asks file sources that support optional requests to answer a required request that the
+    // cache can't satisfy with a NotFound error first, as they would an optional request, and
+    // then with the response from the network. With it, one request does the work of an optional
+    // request followed by a required one.
+    bool reportCacheMiss = false;
+
     optional<Timestamp> priorModified = {};
     optional<Timestamp> priorExpires = {};
     optional<std::string> priorEtag = {};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mbgl/util/buffer.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/variant.hpp>
@@ -17,6 +18,7 @@ public:
 
 public:
     class Error;
+    class Timing;
     // When this object is empty, the response was successful.
     std::unique_ptr<const Error> error;
 
@@ -28,12 +30,15 @@ public:
     bool notModified = false;
 
     // The actual data of the response. Present only for non-error, non-notModified responses.
-    std::shared_ptr<const std::string> data;
+    std::shared_ptr<const Buffer> data;
 
     optional<Timestamp> modified;
     optional<Timestamp> expires;
     optional<std::string> etag;
 
+    // Present only for responses that came from the network.
+    std::unique_ptr<const Timing> timing;
+
     bool isFresh() const {
         return expires ? *expires > util::now() : !error;
     }
@@ -60,6 +65,22 @@ public:
     Error(Reason, std::string = "", optional<Timestamp> = {});
 };
 
+// Where the time between scheduling a network request and receiving its response went.
+class Response::Timing {
+public:
+    // When the request was ready to go out, but had to wait for a free connection.
+    TimePoint queued;
+
+    // When the request was handed to the HTTP implementation.
+    TimePoint started;
+
+    // When the response was received.
+    TimePoint finished;
+
+    // Time spent storing the response in the offline database.
+    Duration store = Duration::zero();
+};
+
 std::ostream& operator<<(std::ostream&, Response::Error::Reason);
 
 } // namespace mbgl
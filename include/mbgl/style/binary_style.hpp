@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+namespace mbgl {
+namespace style {
+
+// Encodes the JSON of a style into the binary form that Map::setStyleBinary loads. The binary
+// form holds the same document, laid out so that it can be read in place, without parsing text
+// or building a document. It can be produced once, offline, and shipped in place of the JSON.
+// Throws std::runtime_error if the JSON is malformed.
+std::string encodeBinaryStyle(const std::string& json);
+
+} // namespace style
+} // namespace mbgl
@@ -3,7 +3,9 @@
 #include <mbgl/style/layer.hpp>
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/heatmap_layer.hpp>
 #include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/hillshade_layer.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
 #include <mbgl/style/layers/raster_layer.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
@@ -11,6 +13,7 @@
 #include <mbgl/style/conversion/constant.hpp>
 #include <mbgl/style/conversion/filter.hpp>
 #include <mbgl/style/conversion/make_property_setters.hpp>
+#include <mbgl/style/conversion/native_property_setters.hpp>
 
 namespace mbgl {
 namespace style {
@@ -28,7 +31,11 @@ optional<Error> setLayoutProperty(Layer& layer, const std::string& name, const V
 
 template <class V>
 optional<Error> setPaintProperty(Layer& layer, const std::string& name, const V& value, const optional<std::string>& klass) {
-    static const auto setters = makePaintPropertySetters<V>();
+    static const auto setters = [] {
+        auto result = makePaintPropertySetters<V>();
+        addNativePaintPropertySetters<V>(result);
+        return result;
+    }();
     auto it = setters.find(name);
     if (it == setters.end()) {
         return Error { "property not found" };
@@ -96,10 +103,14 @@ public:
             converted = convertVectorLayer<LineLayer>(*id, value, error);
         } else if (*type == "circle") {
             converted = convertVectorLayer<CircleLayer>(*id, value, error);
+        } else if (*type == "heatmap") {
+            converted = convertVectorLayer<HeatmapLayer>(*id, value, error);
         } else if (*type == "symbol") {
             converted = convertVectorLayer<SymbolLayer>(*id, value, error);
         } else if (*type == "raster") {
-            converted = convertRasterLayer(*id, value, error);
+            converted = convertRasterLayer<RasterLayer>(*id, value, error);
+        } else if (*type == "hillshade") {
+            converted = convertRasterLayer<HillshadeLayer>(*id, value, error);
         } else if (*type == "background") {
             converted = convertBackgroundLayer(*id, value, error);
         } else {
@@ -196,7 +207,7 @@ private:
         return { std::move(layer) };
     }
 
-    template <class V>
+    template <class LayerType, class V>
     optional<std::unique_ptr<Layer>> convertRasterLayer(const std::string& id, const V& value, Error& error) const {
         auto sourceValue = objectMember(value, "source");
         if (!sourceValue) {
@@ -210,7 +221,7 @@ private:
             return {};
         }
 
-        return { std::make_unique<RasterLayer>(id, *source) };
+        return { std::make_unique<LayerType>(id, *source) };
     }
 
     template <class V>
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <mbgl/style/conversion/property_setter.hpp>
+
+#include <mbgl/style/layers/heatmap_layer.hpp>
+#include <mbgl/style/layers/hillshade_layer.hpp>
+
+#include <unordered_map>
+
+namespace mbgl {
+namespace style {
+namespace conversion {
+
+// Setters for the paint properties of the native-only layer types. The style specification that
+// make_property_setters.hpp is generated from doesn't have these layers, so they are written by
+// hand and added to the generated ones.
+template <class V>
+void addNativePaintPropertySetters(std::unordered_map<std::string, PaintPropertySetter<V>>& result) {
+    result["heatmap-radius"] = &setPaintProperty<V, HeatmapLayer, DataDrivenPropertyValue<float>, &HeatmapLayer::setHeatmapRadius>;
+    result["heatmap-radius-transition"] = &setTransition<V, HeatmapLayer, &HeatmapLayer::setHeatmapRadiusTransition>;
+    result["heatmap-weight"] = &setPaintProperty<V, HeatmapLayer, DataDrivenPropertyValue<float>, &HeatmapLayer::setHeatmapWeight>;
+    result["heatmap-weight-transition"] = &setTransition<V, HeatmapLayer, &HeatmapLayer::setHeatmapWeightTransition>;
+    result["heatmap-intensity"] = &setPaintProperty<V, HeatmapLayer, PropertyValue<float>, &HeatmapLayer::setHeatmapIntensity>;
+    result["heatmap-intensity-transition"] = &setTransition<V, HeatmapLayer, &HeatmapLayer::setHeatmapIntensityTransition>;
+    result["heatmap-color"] = &setStopsPaintProperty<V, HeatmapLayer, ExponentialStops<Color>, &HeatmapLayer::setHeatmapColor, &HeatmapLayer::getDefaultHeatmapColor>;
+    result["heatmap-opacity"] = &setPaintProperty<V, HeatmapLayer, PropertyValue<float>, &HeatmapLayer::setHeatmapOpacity>;
+    result["heatmap-opacity-transition"] = &setTransition<V, HeatmapLayer, &HeatmapLayer::setHeatmapOpacityTransition>;
+
+    result["hillshade-illumination-direction"] = &setPaintProperty<V, HillshadeLayer, PropertyValue<float>, &HillshadeLayer::setHillshadeIlluminationDirection>;
+    result["hillshade-illumination-direction-transition"] = &setTransition<V, HillshadeLayer, &HillshadeLayer::setHillshadeIlluminationDirectionTransition>;
+    result["hillshade-illumination-anchor"] = &setPaintProperty<V, HillshadeLayer, PropertyValue<HillshadeIlluminationAnchorType>, &HillshadeLayer::setHillshadeIlluminationAnchor>;
+    result["hillshade-illumination-anchor-transition"] = &setTransition<V, HillshadeLayer, &HillshadeLayer::setHillshadeIlluminationAnchorTransition>;
+    result["hillshade-exaggeration"] = &setPaintProperty<V, HillshadeLayer, PropertyValue<float>, &HillshadeLayer::setHillshadeExaggeration>;
+    result["hillshade-exaggeration-transition"] = &setTransition<V, HillshadeLayer, &HillshadeLayer::setHillshadeExaggerationTransition>;
+    result["hillshade-shadow-color"] = &setPaintProperty<V, HillshadeLayer, PropertyValue<Color>, &HillshadeLayer::setHillshadeShadowColor>;
+    result["hillshade-shadow-color-transition"] = &setTransition<V, HillshadeLayer, &HillshadeLayer::setHillshadeShadowColorTransition>;
+    result["hillshade-highlight-color"] = &setPaintProperty<V, HillshadeLayer, PropertyValue<Color>, &HillshadeLayer::setHillshadeHighlightColor>;
+    result["hillshade-highlight-color-transition"] = &setTransition<V, HillshadeLayer, &HillshadeLayer::setHillshadeHighlightColorTransition>;
+    result["hillshade-accent-color"] = &setPaintProperty<V, HillshadeLayer, PropertyValue<Color>, &HillshadeLayer::setHillshadeAccentColor>;
+    result["hillshade-accent-color-transition"] = &setTransition<V, HillshadeLayer, &HillshadeLayer::setHillshadeAccentColorTransition>;
+}
+
+} // namespace conversion
+} // namespace style
+} // namespace mbgl
@@ -5,6 +5,7 @@
 #include <mbgl/style/conversion/constant.hpp>
 #include <mbgl/style/conversion/property_value.hpp>
 #include <mbgl/style/conversion/data_driven_property_value.hpp>
+#include <mbgl/style/conversion/function.hpp>
 #include <mbgl/style/conversion/transition_options.hpp>
 
 #include <string>
@@ -53,6 +54,34 @@ optional<Error> setPaintProperty(Layer& layer, const V& value, const optional<st
     return {};
 }
 
+// For paint properties that are neither zoom functions nor set per class, such as the color
+// ramps that are keyed by another input. Leaving one undefined restores its default.
+template <class V, class L, class Stops, void (L::*setter)(Stops), Stops (*defaultValue)()>
+optional<Error> setStopsPaintProperty(Layer& layer, const V& value, const optional<std::string>& klass) {
+    L* typedLayer = layer.as<L>();
+    if (!typedLayer) {
+        return Error { "layer doesn't support this property" };
+    }
+
+    if (klass) {
+        return Error { "property can't be set per class" };
+    }
+
+    if (isUndefined(value)) {
+        (typedLayer->*setter)(defaultValue());
+        return {};
+    }
+
+    Error error;
+    optional<Stops> stops = convert<Stops>(value, error);
+    if (!stops) {
+        return error;
+    }
+
+    (typedLayer->*setter)(*stops);
+    return {};
+}
+
 template <class V, class L, void (L::*setter)(const TransitionOptions&, const optional<std::string>&)>
 optional<Error> setTransition(Layer& layer, const V& value, const optional<std::string>& klass) {
     L* typedLayer = layer.as<L>();
@@ -7,6 +7,7 @@
 #include <mbgl/style/source.hpp>
 #include <mbgl/style/sources/geojson_source.hpp>
 #include <mbgl/style/sources/raster_source.hpp>
+#include <mbgl/style/sources/raster_dem_source.hpp>
 #include <mbgl/style/sources/vector_source.hpp>
 
 namespace mbgl {
@@ -36,7 +37,9 @@ public:
         }
 
         if (*type == "raster") {
-            return convertRasterSource(id, value, error);
+            return convertRasterSource<RasterSource>(id, value, error);
+        } else if (*type == "raster-dem") {
+            return convertRasterSource<RasterDEMSource>(id, value, error);
         } else if (*type == "vector") {
             return convertVectorSource(id, value, error);
         } else if (*type == "geojson") {
@@ -69,7 +72,7 @@ private:
         return { *url };
     }
 
-    template <class V>
+    template <class TileSourceType, class V>
     optional<std::unique_ptr<Source>> convertRasterSource(const std::string& id,
                                                           const V& value,
                                                           Error& error) const {
@@ -89,7 +92,7 @@ private:
             tileSize = *size;
         }
 
-        return { std::make_unique<RasterSource>(id, std::move(*urlOrTileset), tileSize) };
+        return { std::make_unique<TileSourceType>(id, std::move(*urlOrTileset), tileSize) };
     }
 
     template <class V>
@@ -3,11 +3,68 @@
 #include <mbgl/style/filter.hpp>
 #include <mbgl/util/geometry.hpp>
 
+#include <cassert>
 #include <type_traits>
 
 namespace mbgl {
 namespace style {
 
+template <class Op>
+struct FilterComparator {
+    const Op& op;
+
+    template <class T>
+    bool operator()(const T& lhs, const T& rhs) const {
+        return op(lhs, rhs);
+    }
+
+    template <class T0, class T1>
+    auto operator()(const T0& lhs, const T1& rhs) const
+        -> typename std::enable_if_t<std::is_arithmetic<T0>::value && !std::is_same<T0, bool>::value &&
+                                     std::is_arithmetic<T1>::value && !std::is_same<T1, bool>::value, bool> {
+        return op(double(lhs), double(rhs));
+    }
+
+    template <class T0, class T1>
+    auto operator()(const T0&, const T1&) const
+        -> typename std::enable_if_t<!std::is_arithmetic<T0>::value || std::is_same<T0, bool>::value ||
+                                     !std::is_arithmetic<T1>::value || std::is_same<T1, bool>::value, bool> {
+        return false;
+    }
+
+    bool operator()(const NullValue&,
+                    const NullValue&) const {
+        // Should be unreachable; null is not currently allowed by the style specification.
+        assert(false);
+        return false;
+    }
+
+    bool operator()(const std::vector<Value>&,
+                    const std::vector<Value>&) const {
+        // Should be unreachable; nested values are not currently allowed by the style specification.
+        assert(false);
+        return false;
+    }
+
+    bool operator()(const PropertyMap&,
+                    const PropertyMap&) const {
+        // Should be unreachable; nested values are not currently allowed by the style specification.
+        assert(false);
+        return false;
+    }
+};
+
+// Compares two values the way filters do: numbers of different types are compared as
+// doubles, and values of otherwise different types never satisfy the comparison.
+template <class Op>
+bool compareValues(const Value& lhs, const Value& rhs, const Op& op) {
+    return Value::binary_visit(lhs, rhs, FilterComparator<Op> { op });
+}
+
+inline bool equalValues(const Value& lhs, const Value& rhs) {
+    return compareValues(lhs, rhs, [] (const auto& lhs_, const auto& rhs_) { return lhs_ == rhs_; });
+}
+
 /*
    A visitor that evaluates a `Filter` for a given feature.
 
@@ -32,32 +89,32 @@ public:
 
     bool operator()(const EqualsFilter& filter) const {
         optional<Value> actual = propertyAccessor(filter.key);
-        return actual && equal(*actual, filter.value);
+        return actual && equalValues(*actual, filter.value);
     }
 
     bool operator()(const NotEqualsFilter& filter) const {
         optional<Value> actual = propertyAccessor(filter.key);
-        return !actual || !equal(*actual, filter.value);
+        return !actual || !equalValues(*actual, filter.value);
     }
 
     bool operator()(const LessThanFilter& filter) const {
         optional<Value> actual = propertyAccessor(filter.key);
-        return actual && compare(*actual, filter.value, [] (const auto& lhs_, const auto& rhs_) { return lhs_ < rhs_; });
+        return actual && compareValues(*actual, filter.value, [] (const auto& lhs_, const auto& rhs_) { return lhs_ < rhs_; });
     }
 
     bool operator()(const LessThanEqualsFilter& filter) const {
         optional<Value> actual = propertyAccessor(filter.key);
-        return actual && compare(*actual, filter.value, [] (const auto& lhs_, const auto& rhs_) { return lhs_ <= rhs_; });
+        return actual && compareValues(*actual, filter.value, [] (const auto& lhs_, const auto& rhs_) { return lhs_ <= rhs_; });
     }
 
     bool operator()(const GreaterThanFilter& filter) const {
         optional<Value> actual = propertyAccessor(filter.key);
-        return actual && compare(*actual, filter.value, [] (const auto& lhs_, const auto& rhs_) { return lhs_ > rhs_; });
+        return actual && compareValues(*actual, filter.value, [] (const auto& lhs_, const auto& rhs_) { return lhs_ > rhs_; });
     }
 
     bool operator()(const GreaterThanEqualsFilter& filter) const {
         optional<Value> actual = propertyAccessor(filter.key);
-        return actual && compare(*actual, filter.value, [] (const auto& lhs_, const auto& rhs_) { return lhs_ >= rhs_; });
+        return actual && compareValues(*actual, filter.value, [] (const auto& lhs_, const auto& rhs_) { return lhs_ >= rhs_; });
     }
 
     bool operator()(const InFilter& filter) const {
@@ -65,7 +122,7 @@ public:
         if (!actual)
             return false;
         for (const auto& v: filter.values) {
-            if (equal(*actual, v)) {
+            if (equalValues(*actual, v)) {
                 return true;
             }
         }
@@ -77,7 +134,7 @@ public:
         if (!actual)
             return true;
         for (const auto& v: filter.values) {
-            if (equal(*actual, v)) {
+            if (equalValues(*actual, v)) {
                 return false;
             }
         }
@@ -180,61 +237,6 @@ public:
     bool operator()(const NotHasIdentifierFilter&) const {
         return !featureIdentifier;
     }
-
-private:
-    template <class Op>
-    struct Comparator {
-        const Op& op;
-
-        template <class T>
-        bool operator()(const T& lhs, const T& rhs) const {
-            return op(lhs, rhs);
-        }
-
-        template <class T0, class T1>
-        auto operator()(const T0& lhs, const T1& rhs) const
-            -> typename std::enable_if_t<std::is_arithmetic<T0>::value && !std::is_same<T0, bool>::value &&
-                                         std::is_arithmetic<T1>::value && !std::is_same<T1, bool>::value, bool> {
-            return op(double(lhs), double(rhs));
-        }
-
-        template <class T0, class T1>
-        auto operator()(const T0&, const T1&) const
-            -> typename std::enable_if_t<!std::is_arithmetic<T0>::value || std::is_same<T0, bool>::value ||
-                                         !std::is_arithmetic<T1>::value || std::is_same<T1, bool>::value, bool> {
-            return false;
-        }
-
-        bool operator()(const NullValue&,
-                        const NullValue&) const {
-            // Should be unreachable; null is not currently allowed by the style specification.
-            assert(false);
-            return false;
-        }
-
-        bool operator()(const std::vector<Value>&,
-                        const std::vector<Value>&) const {
-            // Should be unreachable; nested values are not currently allowed by the style specification.
-            assert(false);
-            return false;
-        }
-
-        bool operator()(const PropertyMap&,
-                        const PropertyMap&) const {
-            // Should be unreachable; nested values are not currently allowed by the style specification.
-            assert(false);
-            return false;
-        }
-    };
-
-    template <class Op>
-    bool compare(const Value& lhs, const Value& rhs, const Op& op) const {
-        return Value::binary_visit(lhs, rhs, Comparator<Op> { op });
-    }
-
-    bool equal(const Value& lhs, const Value& rhs) const {
-        return compare(lhs, rhs, [] (const auto& lhs_, const auto& rhs_) { return lhs_ == rhs_; });
-    }
 };
 
 inline bool Filter::operator()(const Feature& feature) const {
@@ -5,6 +5,8 @@
 #include <mbgl/util/interpolate.hpp>
 #include <mbgl/util/variant.hpp>
 
+#include <cstdint>
+
 namespace mbgl {
 namespace style {
 
@@ -35,6 +37,11 @@ public:
     }
 
     Stops stops;
+
+    // Identical functions that were deduplicated share a serial, by which they are evaluated
+    // once per zoom level for all the layers that use them. Zero for a function that wasn't
+    // deduplicated; changing the stops must reset it.
+    uint64_t serial = 0;
 };
 
 } // namespace style
@@ -6,6 +6,7 @@
 #include <cassert>
 #include <utility>
 #include <map>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -20,13 +21,12 @@ class CategoricalStops {
 public:
     using Stops = std::map<CategoricalValue, T>;
 
+    // The stops are fixed once constructed; they're looked up in sorted arrays of each type of
+    // value, so that looking up a string doesn't copy it.
     Stops stops;
 
     CategoricalStops() = default;
-    CategoricalStops(Stops stops_)
-        : stops(std::move(stops_)) {
-        assert(stops.size() > 0);
-    }
+    CategoricalStops(Stops stops_);
 
     optional<T> evaluate(const Value&) const;
 
@@ -34,6 +34,12 @@ public:
                            const CategoricalStops& rhs) {
         return lhs.stops == rhs.stops;
     }
+
+private:
+    optional<T> falseStop;
+    optional<T> trueStop;
+    std::vector<std::pair<int64_t, T>> integerStops;
+    std::vector<std::pair<std::string, T>> stringStops;
 };
 
 } // namespace style
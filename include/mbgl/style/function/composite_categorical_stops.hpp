@@ -2,6 +2,8 @@
 
 #include <mbgl/style/function/categorical_stops.hpp>
 
+#include <vector>
+
 namespace mbgl {
 namespace style {
 
@@ -9,21 +11,31 @@ template <class T>
 class CompositeCategoricalStops {
 public:
     using Stops = std::map<float, std::map<CategoricalValue, T>>;
+
+    // The stops are fixed once constructed; see zoomStops().
     Stops stops;
 
     CompositeCategoricalStops() = default;
     CompositeCategoricalStops(Stops stops_)
         : stops(std::move(stops_)) {
+        inner.reserve(stops.size());
+        for (const auto& stop : stops) {
+            inner.emplace_back(stop.first, CategoricalStops<T>(stop.second));
+        }
     }
 
-    CategoricalStops<T> innerStops(const std::map<CategoricalValue, T>& stops_) const {
-        return CategoricalStops<T>(stops_);
+    // The inner stops of each zoom level, in the order of the zoom levels.
+    const std::vector<std::pair<float, CategoricalStops<T>>>& zoomStops() const {
+        return inner;
     }
 
     friend bool operator==(const CompositeCategoricalStops& lhs,
                            const CompositeCategoricalStops& rhs) {
         return lhs.stops == rhs.stops;
     }
+
+private:
+    std::vector<std::pair<float, CategoricalStops<T>>> inner;
 };
 
 } // namespace style
@@ -3,6 +3,7 @@
 #include <mbgl/style/function/exponential_stops.hpp>
 
 #include <map>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -12,6 +13,7 @@ class CompositeExponentialStops {
 public:
     using Stops = std::map<float, std::map<float, T>>;
 
+    // The stops are fixed once constructed; see zoomStops().
     Stops stops;
     float base = 1.0f;
 
@@ -19,16 +21,24 @@ public:
     CompositeExponentialStops(Stops stops_, float base_ = 1.0f)
         : stops(std::move(stops_)),
           base(base_) {
+        inner.reserve(stops.size());
+        for (const auto& stop : stops) {
+            inner.emplace_back(stop.first, ExponentialStops<T>(stop.second, base));
+        }
     }
 
-    ExponentialStops<T> innerStops(const std::map<float, T>& stops_) const {
-        return ExponentialStops<T>(stops_, base);
+    // The inner stops of each zoom level, in the order of the zoom levels.
+    const std::vector<std::pair<float, ExponentialStops<T>>>& zoomStops() const {
+        return inner;
     }
 
     friend bool operator==(const CompositeExponentialStops& lhs,
                            const CompositeExponentialStops& rhs) {
         return lhs.stops == rhs.stops && lhs.base == rhs.base;
     }
+
+private:
+    std::vector<std::pair<float, ExponentialStops<T>>> inner;
 };
 
 } // namespace style
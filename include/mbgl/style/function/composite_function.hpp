@@ -7,6 +7,8 @@
 #include <mbgl/util/range.hpp>
 #include <mbgl/util/variant.hpp>
 
+#include <algorithm>
+#include <iterator>
 #include <string>
 #include <tuple>
 
@@ -53,25 +55,10 @@ public:
     coveringRanges(float zoom) const {
         return stops.match(
             [&] (const auto& s) {
-                assert(!s.stops.empty());
-                auto minIt = s.stops.lower_bound(zoom);
-                auto maxIt = s.stops.upper_bound(zoom);
-                
-                // lower_bound yields first element >= zoom, but we want the *last*
-                // element <= zoom, so if we found a stop > zoom, back up by one.
-                if (minIt != s.stops.begin() && minIt->first > zoom) {
-                    minIt--;
-                }
-                
+                const auto covering = coveringStops(s.zoomStops(), zoom);
                 return std::make_tuple(
-                    Range<float> {
-                        minIt == s.stops.end() ? s.stops.rbegin()->first : minIt->first,
-                        maxIt == s.stops.end() ? s.stops.rbegin()->first : maxIt->first
-                    },
-                    Range<InnerStops> {
-                        s.innerStops(minIt == s.stops.end() ? s.stops.rbegin()->second : minIt->second),
-                        s.innerStops(maxIt == s.stops.end() ? s.stops.rbegin()->second : maxIt->second)
-                    }
+                    Range<float> { covering.min->first, covering.max->first },
+                    Range<InnerStops> { covering.min->second, covering.max->second }
                 );
             }
         );
@@ -98,15 +85,7 @@ public:
     }
 
     T evaluate(float zoom, const GeometryTileFeature& feature, T finalDefaultValue) const {
-        std::tuple<Range<float>, Range<InnerStops>> ranges = coveringRanges(zoom);
-        Range<T> resultRange = evaluate(std::get<1>(ranges), feature, finalDefaultValue);
-        // If the covering stop range is constant, just return the output value directly.
-        if (resultRange.min == resultRange.max) return resultRange.min;
-        // Otherwise, interpolate between the two stops.
-        return util::interpolate(
-            resultRange.min,
-            resultRange.max,
-            util::interpolationFactor(1.0f, std::get<0>(ranges), zoom));
+        return evaluateAtZoom(zoom, feature, finalDefaultValue);
     }
 
     friend bool operator==(const CompositeFunction& lhs,
@@ -118,6 +97,45 @@ public:
     std::string property;
     Stops stops;
     optional<T> defaultValue;
+
+private:
+    // Evaluates the covering inner stops in place, rather than copying them into a range.
+    template <class Feature>
+    T evaluateAtZoom(float zoom, const Feature& feature, T finalDefaultValue) const {
+        return stops.match(
+            [&] (const auto& s) {
+                const auto covering = coveringStops(s.zoomStops(), zoom);
+                const T fallback = defaultValue.value_or(finalDefaultValue);
+                optional<Value> v = feature.getValue(property);
+                if (!v) {
+                    return fallback;
+                }
+                const T min = covering.min->second.evaluate(*v).value_or(fallback);
+                const T max = covering.max->second.evaluate(*v).value_or(fallback);
+                // If the covering stop range is constant, just return the output value directly.
+                if (min == max) return min;
+                // Otherwise, interpolate between the two stops.
+                return util::interpolate(
+                    min,
+                    max,
+                    util::interpolationFactor(1.0f, { covering.min->first, covering.max->first }, zoom));
+            }
+        );
+    }
+
+    // The last zoom level stop at or below the given zoom level, or the first if there's none, and
+    // the first above it, or the last if there's none.
+    template <class ZoomStops>
+    static Range<const typename ZoomStops::value_type*> coveringStops(const ZoomStops& zoomStops, float zoom) {
+        assert(!zoomStops.empty());
+        auto maxIt = std::upper_bound(zoomStops.begin(), zoomStops.end(), zoom,
+            [] (float z, const typename ZoomStops::value_type& stop) { return z < stop.first; });
+        auto minIt = maxIt == zoomStops.begin() ? maxIt : std::prev(maxIt);
+        if (maxIt == zoomStops.end()) {
+            maxIt = std::prev(zoomStops.end());
+        }
+        return { &*minIt, &*maxIt };
+    }
 };
 
 } // namespace style
@@ -3,6 +3,7 @@
 #include <mbgl/style/function/interval_stops.hpp>
 
 #include <map>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -11,21 +12,31 @@ template <class T>
 class CompositeIntervalStops {
 public:
     using Stops = std::map<float, std::map<float, T>>;
+
+    // The stops are fixed once constructed; see zoomStops().
     Stops stops;
 
     CompositeIntervalStops() = default;
     CompositeIntervalStops(Stops stops_)
         : stops(std::move(stops_)) {
+        inner.reserve(stops.size());
+        for (const auto& stop : stops) {
+            inner.emplace_back(stop.first, IntervalStops<T>(stop.second));
+        }
     }
 
-    IntervalStops<T> innerStops(const std::map<float, T>& stops_) const {
-        return IntervalStops<T>(stops_);
+    // The inner stops of each zoom level, in the order of the zoom levels.
+    const std::vector<std::pair<float, IntervalStops<T>>>& zoomStops() const {
+        return inner;
     }
 
     friend bool operator==(const CompositeIntervalStops& lhs,
                            const CompositeIntervalStops& rhs) {
         return lhs.stops == rhs.stops;
     }
+
+private:
+    std::vector<std::pair<float, IntervalStops<T>>> inner;
 };
 
 } // namespace style
@@ -3,7 +3,9 @@
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/interpolate.hpp>
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -13,6 +15,8 @@ class ExponentialStops {
 public:
     using Stops = std::map<float, T>;
 
+    // The stops are fixed once constructed; they're evaluated from contiguous copies of the
+    // inputs and outputs.
     Stops stops;
     float base = 1.0f;
 
@@ -20,10 +24,16 @@ public:
     ExponentialStops(Stops stops_, float base_ = 1.0f)
         : stops(std::move(stops_)),
           base(base_) {
+        inputs.reserve(stops.size());
+        outputs.reserve(stops.size());
+        for (const auto& stop : stops) {
+            inputs.push_back(stop.first);
+            outputs.push_back(stop.second);
+        }
     }
 
     optional<T> evaluate(const Value& value) const {
-        if (stops.empty()) {
+        if (inputs.empty()) {
             assert(false);
             return T();
         }
@@ -33,14 +43,14 @@ public:
             return T();
         }
 
-        auto it = stops.upper_bound(*z);
-        if (it == stops.end()) {
-            return stops.rbegin()->second;
-        } else if (it == stops.begin()) {
-            return stops.begin()->second;
+        const std::size_t i = std::upper_bound(inputs.begin(), inputs.end(), *z) - inputs.begin();
+        if (i == inputs.size()) {
+            return outputs.back();
+        } else if (i == 0) {
+            return outputs.front();
         } else {
-            return util::interpolate(std::prev(it)->second, it->second,
-                util::interpolationFactor(base, { std::prev(it)->first, it->first }, *z));
+            return util::interpolate(outputs[i - 1], outputs[i],
+                util::interpolationFactor(base, { inputs[i - 1], inputs[i] }, *z));
         }
     }
 
@@ -48,6 +58,10 @@ public:
                            const ExponentialStops& rhs) {
         return lhs.stops == rhs.stops && lhs.base == rhs.base;
     }
+
+private:
+    std::vector<float> inputs;
+    std::vector<T> outputs;
 };
 
 } // namespace style
@@ -2,7 +2,9 @@
 
 #include <mbgl/util/feature.hpp>
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -11,15 +13,24 @@ template <class T>
 class IntervalStops {
 public:
     using Stops = std::map<float, T>;
+
+    // The stops are fixed once constructed; they're evaluated from contiguous copies of the
+    // inputs and outputs.
     Stops stops;
 
     IntervalStops() = default;
     IntervalStops(Stops stops_)
         : stops(std::move(stops_)) {
+        inputs.reserve(stops.size());
+        outputs.reserve(stops.size());
+        for (const auto& stop : stops) {
+            inputs.push_back(stop.first);
+            outputs.push_back(stop.second);
+        }
     }
 
     optional<T> evaluate(const Value& value) const {
-        if (stops.empty()) {
+        if (inputs.empty()) {
             assert(false);
             return {};
         }
@@ -29,13 +40,13 @@ public:
             return {};
         }
 
-        auto it = stops.upper_bound(*z);
-        if (it == stops.end()) {
-            return stops.rbegin()->second;
-        } else if (it == stops.begin()) {
-            return stops.begin()->second;
+        const std::size_t i = std::upper_bound(inputs.begin(), inputs.end(), *z) - inputs.begin();
+        if (i == inputs.size()) {
+            return outputs.back();
+        } else if (i == 0) {
+            return outputs.front();
         } else {
-            return std::prev(it)->second;
+            return outputs[i - 1];
         }
     }
 
@@ -43,6 +54,10 @@ public:
                            const IntervalStops& rhs) {
         return lhs.stops == rhs.stops;
     }
+
+private:
+    std::vector<float> inputs;
+    std::vector<T> outputs;
 };
 
 } // namespace style
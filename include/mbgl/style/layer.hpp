@@ -18,6 +18,8 @@ class RasterLayer;
 class BackgroundLayer;
 class CustomLayer;
 class FillExtrusionLayer;
+class HeatmapLayer;
+class HillshadeLayer;
 
 /**
  * The runtime representation of a [layer](https://www.mapbox.com/mapbox-gl-style-spec/#layers) from the Mapbox Style
@@ -46,6 +48,8 @@ protected:
         Background,
         Custom,
         FillExtrusion,
+        Heatmap,
+        Hillshade,
     };
 
     class Impl;
@@ -101,6 +105,10 @@ public:
             return visitor(*as<CustomLayer>());
         case Type::FillExtrusion:
             return visitor(*as<FillExtrusionLayer>());
+        case Type::Heatmap:
+            return visitor(*as<HeatmapLayer>());
+        case Type::Hillshade:
+            return visitor(*as<HillshadeLayer>());
         }
     }
 
@@ -125,6 +133,7 @@ public:
     any peer;
 
     friend std::string layoutKey(const Layer&);
+    friend class Style;
 };
 
 } // namespace style
@@ -1,6 +1,11 @@
 #pragma once
 
 #include <mbgl/style/layer.hpp>
+#include <mbgl/util/traits.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -15,7 +20,34 @@ namespace style {
 using CustomLayerInitializeFunction = void (*)(void* context);
 
 /**
- * Parameters that define the current camera position for a CustomLayerRenderFunction.
+ * A tile that covers part of the viewport at the current integer zoom level, and the matrix
+ * that takes points within it, in tile units from 0 to 8192, to clip space.
+ */
+struct CustomLayerTile {
+    uint8_t z;
+    uint32_t x;
+    uint32_t y;
+    // The copy of the world the tile is in: 0 for the one around longitude 0.
+    int16_t wrap;
+    std::array<double, 16> matrix;
+};
+
+/**
+ * Buffers that the map draws the quad of a whole tile from, which custom layers may draw from
+ * as well but must not modify. The vertex buffer holds four vertices of two 16 bit signed
+ * integers each, the corners of the tile in tile units, in triangle strip order; the index
+ * buffer holds the 16 bit indices of two triangles made of them.
+ */
+struct CustomLayerTileQuad {
+    uint32_t vertexBuffer;
+    std::size_t vertexByteOffset;
+    uint32_t indexBuffer;
+    std::size_t indexByteOffset;
+};
+
+/**
+ * Parameters that define the current camera position for a CustomLayerRenderFunction, and the
+ * resources of the map that it can use.
  */
 struct CustomLayerRenderParameters {
     double width;
@@ -26,13 +58,53 @@ struct CustomLayerRenderParameters {
     double bearing;
     double pitch;
     double fieldOfView;
+
+    std::vector<CustomLayerTile> tiles;
+    CustomLayerTileQuad tileQuad;
+};
+
+/**
+ * The parts of the GL state that a custom layer changes when it renders. Only those that it
+ * declares are restored once it has rendered, so a layer that declares few of them saves the
+ * map from setting up the rest again.
+ */
+enum class CustomLayerGLState : uint32_t {
+    None        = 0,
+    // Depth testing, its function, the depth mask and range.
+    Depth       = 1 << 0,
+    // Stencil testing, its function and operations, and the stencil mask.
+    Stencil     = 1 << 1,
+    // Blending, its equation, function and color, and the color mask.
+    Color       = 1 << 2,
+    // Scissor testing and the scissor box.
+    Scissor     = 1 << 3,
+    // The program in use.
+    Program     = 1 << 4,
+    // The bound vertex array object, vertex buffer and element buffer.
+    Buffers     = 1 << 5,
+    // The active texture unit and the textures bound to the units that the map uses.
+    Textures    = 1 << 6,
+    // The bound framebuffer and the viewport.
+    Framebuffer = 1 << 7,
+    // The line width, clear values, and pixel storage and transfer modes.
+    Other       = 1 << 8,
+    All         = 0xFFFFFFFF,
 };
 
+constexpr CustomLayerGLState operator|(CustomLayerGLState lhs, CustomLayerGLState rhs) {
+    return CustomLayerGLState(mbgl::underlying_type(lhs) | mbgl::underlying_type(rhs));
+}
+
+constexpr bool operator&(CustomLayerGLState lhs, CustomLayerGLState rhs) {
+    return mbgl::underlying_type(lhs) & mbgl::underlying_type(rhs);
+}
+
 /**
  * Render the layer. This method is called once per frame. The implementation should not make
  * any assumptions about the GL state (other than that the correct context is active). It may
- * make changes to the state, and is not required to reset values such as the depth mask, stencil
- * mask, and corresponding test flags to their original values.
+ * make changes to the state that it declared when it was added, and is not required to reset
+ * values such as the depth mask, stencil mask, and corresponding test flags to their original
+ * values.
  * Make sure that you are drawing your fragments with a z value of 1 to take advantage of the
  * opaque fragment culling in case there are opaque layers above your custom layer.
  */
@@ -52,7 +124,8 @@ public:
                 CustomLayerInitializeFunction,
                 CustomLayerRenderFunction,
                 CustomLayerDeinitializeFunction,
-                void* context);
+                void* context,
+                CustomLayerGLState = CustomLayerGLState::All);
     ~CustomLayer() final;
 
     // Private implementation
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <mbgl/style/layer.hpp>
+#include <mbgl/style/filter.hpp>
+#include <mbgl/style/property_value.hpp>
+#include <mbgl/style/data_driven_property_value.hpp>
+#include <mbgl/style/function/exponential_stops.hpp>
+
+#include <mbgl/util/color.hpp>
+
+namespace mbgl {
+namespace style {
+
+class TransitionOptions;
+
+// Draws the density of points as a heat map: each point adds a kernel of its weight to an
+// accumulated density, which is then colored by the layer's color ramp.
+class HeatmapLayer : public Layer {
+public:
+    HeatmapLayer(const std::string& layerID, const std::string& sourceID);
+    ~HeatmapLayer() final;
+
+    // Source
+    const std::string& getSourceID() const;
+    const std::string& getSourceLayer() const;
+    void setSourceLayer(const std::string& sourceLayer);
+
+    void setFilter(const Filter&);
+    const Filter& getFilter() const;
+
+    // Paint properties
+
+    static DataDrivenPropertyValue<float> getDefaultHeatmapRadius();
+    DataDrivenPropertyValue<float> getHeatmapRadius(const optional<std::string>& klass = {}) const;
+    void setHeatmapRadius(DataDrivenPropertyValue<float>, const optional<std::string>& klass = {});
+    void setHeatmapRadiusTransition(const TransitionOptions&, const optional<std::string>& klass = {});
+    TransitionOptions getHeatmapRadiusTransition(const optional<std::string>& klass = {}) const;
+
+    static DataDrivenPropertyValue<float> getDefaultHeatmapWeight();
+    DataDrivenPropertyValue<float> getHeatmapWeight(const optional<std::string>& klass = {}) const;
+    void setHeatmapWeight(DataDrivenPropertyValue<float>, const optional<std::string>& klass = {});
+    void setHeatmapWeightTransition(const TransitionOptions&, const optional<std::string>& klass = {});
+    TransitionOptions getHeatmapWeightTransition(const optional<std::string>& klass = {}) const;
+
+    static PropertyValue<float> getDefaultHeatmapIntensity();
+    PropertyValue<float> getHeatmapIntensity(const optional<std::string>& klass = {}) const;
+    void setHeatmapIntensity(PropertyValue<float>, const optional<std::string>& klass = {});
+    void setHeatmapIntensityTransition(const TransitionOptions&, const optional<std::string>& klass = {});
+    TransitionOptions getHeatmapIntensityTransition(const optional<std::string>& klass = {}) const;
+
+    static PropertyValue<float> getDefaultHeatmapOpacity();
+    PropertyValue<float> getHeatmapOpacity(const optional<std::string>& klass = {}) const;
+    void setHeatmapOpacity(PropertyValue<float>, const optional<std::string>& klass = {});
+    void setHeatmapOpacityTransition(const TransitionOptions&, const optional<std::string>& klass = {});
+    TransitionOptions getHeatmapOpacityTransition(const optional<std::string>& klass = {}) const;
+
+    // The colors of densities from 0 to 1. Unlike the other paint properties, the ramp is
+    // keyed by density rather than zoom, and doesn't depend on the style's classes.
+    static ExponentialStops<Color> getDefaultHeatmapColor();
+    const ExponentialStops<Color>& getHeatmapColor() const;
+    void setHeatmapColor(ExponentialStops<Color>);
+
+    // Private implementation
+
+    class Impl;
+    Impl* const impl;
+
+    HeatmapLayer(const Impl&);
+    HeatmapLayer(const HeatmapLayer&) = delete;
+};
+
+template <>
+inline bool Layer::is<HeatmapLayer>() const {
+    return type == Type::Heatmap;
+}
+
+} // namespace style
+} // namespace mbgl
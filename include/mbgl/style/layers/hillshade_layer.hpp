@@ -0,0 +1,77 @@
+#pragma once
+
+#include <mbgl/style/layer.hpp>
+#include <mbgl/style/filter.hpp>
+#include <mbgl/style/property_value.hpp>
+#include <mbgl/style/data_driven_property_value.hpp>
+
+#include <mbgl/util/color.hpp>
+
+namespace mbgl {
+namespace style {
+
+class TransitionOptions;
+
+// Shades the terrain of a raster-dem source as if it were lit from one direction.
+class HillshadeLayer : public Layer {
+public:
+    HillshadeLayer(const std::string& layerID, const std::string& sourceID);
+    ~HillshadeLayer() final;
+
+    // Source
+    const std::string& getSourceID() const;
+
+    // Paint properties
+
+    static PropertyValue<float> getDefaultHillshadeIlluminationDirection();
+    PropertyValue<float> getHillshadeIlluminationDirection(const optional<std::string>& klass = {}) const;
+    void setHillshadeIlluminationDirection(PropertyValue<float>, const optional<std::string>& klass = {});
+    void setHillshadeIlluminationDirectionTransition(const TransitionOptions&, const optional<std::string>& klass = {});
+    TransitionOptions getHillshadeIlluminationDirectionTransition(const optional<std::string>& klass = {}) const;
+
+    static PropertyValue<HillshadeIlluminationAnchorType> getDefaultHillshadeIlluminationAnchor();
+    PropertyValue<HillshadeIlluminationAnchorType> getHillshadeIlluminationAnchor(const optional<std::string>& klass = {}) const;
+    void setHillshadeIlluminationAnchor(PropertyValue<HillshadeIlluminationAnchorType>, const optional<std::string>& klass = {});
+    void setHillshadeIlluminationAnchorTransition(const TransitionOptions&, const optional<std::string>& klass = {});
+    TransitionOptions getHillshadeIlluminationAnchorTransition(const optional<std::string>& klass = {}) const;
+
+    static PropertyValue<float> getDefaultHillshadeExaggeration();
+    PropertyValue<float> getHillshadeExaggeration(const optional<std::string>& klass = {}) const;
+    void setHillshadeExaggeration(PropertyValue<float>, const optional<std::string>& klass = {});
+    void setHillshadeExaggerationTransition(const TransitionOptions&, const optional<std::string>& klass = {});
+    TransitionOptions getHillshadeExaggerationTransition(const optional<std::string>& klass = {}) const;
+
+    static PropertyValue<Color> getDefaultHillshadeShadowColor();
+    PropertyValue<Color> getHillshadeShadowColor(const optional<std::string>& klass = {}) const;
+    void setHillshadeShadowColor(PropertyValue<Color>, const optional<std::string>& klass = {});
+    void setHillshadeShadowColorTransition(const TransitionOptions&, const optional<std::string>& klass = {});
+    TransitionOptions getHillshadeShadowColorTransition(const optional<std::string>& klass = {}) const;
+
+    static PropertyValue<Color> getDefaultHillshadeHighlightColor();
+    PropertyValue<Color> getHillshadeHighlightColor(const optional<std::string>& klass = {}) const;
+    void setHillshadeHighlightColor(PropertyValue<Color>, const optional<std::string>& klass = {});
+    void setHillshadeHighlightColorTransition(const TransitionOptions&, const optional<std::string>& klass = {});
+    TransitionOptions getHillshadeHighlightColorTransition(const optional<std::string>& klass = {}) const;
+
+    static PropertyValue<Color> getDefaultHillshadeAccentColor();
+    PropertyValue<Color> getHillshadeAccentColor(const optional<std::string>& klass = {}) const;
+    void setHillshadeAccentColor(PropertyValue<Color>, const optional<std::string>& klass = {});
+    void setHillshadeAccentColorTransition(const TransitionOptions&, const optional<std::string>& klass = {});
+    TransitionOptions getHillshadeAccentColorTransition(const optional<std::string>& klass = {}) const;
+
+    // Private implementation
+
+    class Impl;
+    Impl* const impl;
+
+    HillshadeLayer(const Impl&);
+    HillshadeLayer(const HillshadeLayer&) = delete;
+};
+
+template <>
+inline bool Layer::is<HillshadeLayer>() const {
+    return type == Type::Hillshade;
+}
+
+} // namespace style
+} // namespace mbgl
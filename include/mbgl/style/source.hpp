@@ -8,11 +8,15 @@
 #include <mbgl/style/types.hpp>
 #include <mbgl/style/query.hpp>
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace mbgl {
+
+class AsyncRequest;
+
 namespace style {
 
 /**
@@ -61,6 +65,16 @@ public:
 
     std::vector<Feature> querySourceFeatures(const SourceQueryOptions& options = {});
 
+    // Called with the features of the tiles as the tiles are queried, and with `done` set for
+    // the last of them.
+    using SourceQueryCallback = std::function<void (std::vector<Feature>, bool done)>;
+
+    // Queries the features of the loaded tiles like the function above, but on the worker
+    // threads, one tile at a time per thread. Features that appear in several tiles are passed
+    // to the callback once, if they have an ID. The callback is called on the calling thread,
+    // never before this returns. Releasing the returned request cancels the query.
+    std::unique_ptr<AsyncRequest> querySourceFeatures(const SourceQueryOptions&, SourceQueryCallback);
+
     // Private implementation
     class Impl;
     const std::unique_ptr<Impl> baseImpl;
@@ -2,10 +2,13 @@
 
 #include <mbgl/style/source.hpp>
 #include <mbgl/util/geojson.hpp>
+#include <mbgl/util/feature.hpp>
 #include <mbgl/util/optional.hpp>
 
 #include <mapbox/geojson.hpp>
 
+#include <functional>
+
 namespace mapbox {
 
 namespace geojsonvt {
@@ -34,6 +37,17 @@ struct GeoJSONOptions {
     bool cluster = false;
     uint16_t clusterRadius = 50;
     uint8_t clusterMaxZoom = 17;
+
+    // How the zoom levels of the clusters are built. Supercluster builds all of them when the
+    // source is indexed, each from the clusters of the level above. The others cluster each level
+    // from the points themselves, on the worker threads: all of them concurrently, or only once a
+    // tile at the zoom level is needed. Tiles of a level that isn't built yet keep their data.
+    enum class ClusterLevels : uint8_t {
+        Hierarchical,
+        Parallel,
+        Lazy
+    };
+    ClusterLevels clusterLevels = ClusterLevels::Hierarchical;
 };
 
 class GeoJSONSource : public Source {
@@ -43,8 +57,22 @@ public:
     void setURL(const std::string& url);
     void setGeoJSON(const GeoJSON&);
 
+    // Adds the features, replacing any of the source's features with the same IDs, and removes
+    // the features with the removed IDs. Unlike setGeoJSON(), reloads only the tiles that the
+    // changes touch (or all tiles of a clustered source). Throws std::invalid_argument for
+    // features without an ID; features of the source without one can't be changed.
+    void updateFeatures(const FeatureCollection& features,
+                        const std::vector<FeatureIdentifier>& removed = {});
+    void setFeature(const Feature&);
+    void removeFeature(const FeatureIdentifier&);
+
     optional<std::string> getURL() const;
 
+    // The source's data is parsed and indexed on the worker threads. While data fetched from the
+    // source's URL is parsed, the callback is called on the map's thread with the fraction of the
+    // data that has been read, from 0 to 1. The source is loaded once indexing follows.
+    void setProgressCallback(std::function<void (double progress)>);
+
     // Private implementation
 
     class Impl;
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <mbgl/style/source.hpp>
+#include <mbgl/util/tileset.hpp>
+#include <mbgl/util/variant.hpp>
+
+namespace mbgl {
+namespace style {
+
+// A source of elevation tiles in the Mapbox Terrain-RGB encoding, for hillshade layers.
+class RasterDEMSource : public Source {
+public:
+    RasterDEMSource(std::string id, variant<std::string, Tileset> urlOrTileset, uint16_t tileSize);
+
+    optional<std::string> getURL() const;
+
+    // Private implementation
+
+    class Impl;
+    Impl* const impl;
+};
+
+template <>
+inline bool Source::is<RasterDEMSource>() const {
+    return type == SourceType::RasterDEM;
+}
+
+} // namespace style
+} // namespace mbgl
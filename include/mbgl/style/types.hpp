@@ -8,6 +8,7 @@ namespace mbgl {
 enum class SourceType : uint8_t {
     Vector,
     Raster,
+    RasterDEM,
     GeoJSON,
     Video,
     Annotations
@@ -50,6 +51,11 @@ enum class CirclePitchScaleType : bool {
     Viewport,
 };
 
+enum class HillshadeIlluminationAnchorType : bool {
+    Map,
+    Viewport,
+};
+
 enum class SymbolPlacementType : bool {
     Point,
     Line,
@@ -2,11 +2,17 @@
 
 #include <mbgl/util/noncopyable.hpp>
 
+#include <cstdint>
+
 namespace mbgl {
 
 class AsyncRequest : private util::noncopyable {
 public:
     virtual ~AsyncRequest() = default;
+
+    // Changes the priority of a request that may still have to wait its turn. See
+    // Resource::priority.
+    virtual void setPriority(int32_t) {}
 };
 
 } // namespace mbgl
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace mbgl {
+
+// Read-only bytes, such as the data of a response, that are shared by std::shared_ptr. The bytes
+// either live in a string that the buffer owns, or in memory that something else owns and keeps
+// valid for as long as the buffer holds on to it: a memory-mapped file, say. Either way, handing
+// the bytes on to parsers doesn't copy them.
+class Buffer : private util::noncopyable {
+public:
+    explicit Buffer(std::string string_)
+        : string(std::move(string_)),
+          begin(string.data()),
+          length(string.size()) {
+    }
+
+    Buffer(const char* data_, std::size_t size_, std::shared_ptr<const void> owner_)
+        : owner(std::move(owner_)),
+          begin(data_),
+          length(size_) {
+    }
+
+    const char* data() const { return begin; }
+    const uint8_t* bytes() const { return reinterpret_cast<const uint8_t*>(begin); }
+    std::size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    // Copies the bytes, for code that needs them as a string.
+    std::string toString() const { return { begin, length }; }
+
+private:
+    const std::string string;
+    const std::shared_ptr<const void> owner;
+    const char* const begin;
+    const std::size_t length;
+};
+
+inline bool operator==(const Buffer& lhs, const Buffer& rhs) {
+    return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+inline bool operator==(const Buffer& lhs, const std::string& rhs) {
+    return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+inline bool operator==(const std::string& lhs, const Buffer& rhs) {
+    return rhs == lhs;
+}
+
+inline bool operator!=(const Buffer& lhs, const Buffer& rhs) {
+    return !(lhs == rhs);
+}
+
+inline bool operator!=(const Buffer& lhs, const std::string& rhs) {
+    return !(lhs == rhs);
+}
+
+inline bool operator!=(const std::string& lhs, const Buffer& rhs) {
+    return !(rhs == lhs);
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Buffer& buffer) {
+    return os.write(buffer.data(), buffer.size());
+}
+
+} // namespace mbgl
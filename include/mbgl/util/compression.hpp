@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace mbgl {
 namespace util {
@@ -8,5 +9,30 @@ namespace util {
 std::string compress(const std::string& raw);
 std::string decompress(const std::string& raw);
 
+// Compress and decompress straight from a buffer, such as a memory-mapped file. Decompression
+// takes zlib as well as gzip data.
+std::string compress(const char* raw, std::size_t size);
+std::string decompress(const char* raw, std::size_t size);
+
+// Compresses with a preset dictionary, which must be passed to decompress the result again.
+std::string compress(const std::string& raw, const std::string& dictionary);
+std::string decompress(const std::string& raw, const std::string& dictionary);
+std::string compress(const char* raw, std::size_t size, const std::string& dictionary);
+
+// Decompresses data whose decompressed size was recorded when it was compressed. The result is
+// allocated once and inflated into in place, rather than assembled out of blocks. The size is
+// only a hint: data that turns out to be larger still decompresses.
+std::string decompress(const char* raw, std::size_t size, std::size_t uncompressedSize);
+std::string decompress(const char* raw, std::size_t size, std::size_t uncompressedSize,
+                       const std::string& dictionary);
+
+// The largest dictionary that compression makes use of.
+constexpr std::size_t maxCompressionDictionarySize = 32 * 1024;
+
+// Builds a preset dictionary of up to `size` bytes out of the substrings that occur in the most
+// samples, such as the layer names, keys and values that tiles of the same tileset share.
+std::string trainCompressionDictionary(const std::vector<std::string>& samples,
+                                       std::size_t size = maxCompressionDictionarySize);
+
 } // namespace util
 } // namespace mbgl
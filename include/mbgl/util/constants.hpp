@@ -40,6 +40,15 @@ constexpr float  MAX_ZOOM_F = MAX_ZOOM;
 
 constexpr uint64_t DEFAULT_MAX_CACHE_SIZE = 50 * 1024 * 1024;
 
+// Limits the data of the responses that are held in memory in front of the offline database.
+constexpr std::size_t DEFAULT_RESPONSE_CACHE_SIZE = 8 * 1024 * 1024;
+
+// Limits the memory held by the tile caches of all sources of a style.
+constexpr std::size_t DEFAULT_TILE_CACHE_BYTES = 128 * 1024 * 1024;
+
+// Limits the bucket data uploaded to the GPU in a single continuous mode frame.
+constexpr std::size_t DEFAULT_UPLOAD_BYTES_PER_FRAME = 4 * 1024 * 1024;
+
 constexpr Duration DEFAULT_FADE_DURATION = Milliseconds(300);
 constexpr Seconds CLOCK_SKEW_RETRY_TIMEOUT { 30 };
 
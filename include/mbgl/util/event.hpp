@@ -43,7 +43,10 @@ constexpr EventSeverity disabledEventSeverities[] = {
 #ifndef NDEBUG
     EventSeverity(-1) // Avoid zero size array
 #else
-    EventSeverity::Debug
+    EventSeverity::Debug,
+#ifdef MBGL_DISABLE_INFO_LOGGING
+    EventSeverity::Info,
+#endif
 #endif
 };
 
@@ -124,8 +124,42 @@ using UnassociatedImage = Image<ImageAlphaMode::Unassociated>;
 using PremultipliedImage = Image<ImageAlphaMode::Premultiplied>;
 using AlphaImage = Image<ImageAlphaMode::Exclusive>;
 
-// TODO: don't use std::string for binary data.
-PremultipliedImage decodeImage(const std::string&);
-std::string encodePNG(const PremultipliedImage&);
+PremultipliedImage decodeImage(const uint8_t* data, std::size_t size);
+
+inline PremultipliedImage decodeImage(const std::string& string) {
+    return decodeImage(reinterpret_cast<const uint8_t*>(string.data()), string.size());
+}
+
+// Decodes the image without premultiplying its colors, for consumers that need them unassociated.
+// Decoders that produce unassociated colors return them as is, rather than premultiplying them
+// only for the caller to reverse it.
+UnassociatedImage decodeUnassociatedImage(const uint8_t* data, std::size_t size);
+
+class Scheduler;
+
+// Options for encodePNG(), which trade the size of the encoded image for the time it takes.
+class PNGEncodeOptions {
+public:
+    // Predicts each scanline from the previous one, as the PNG filter types do. Adaptive picks
+    // the filter that predicts best for each scanline, which compresses photographic imagery
+    // well but takes longer.
+    enum class Filter : uint8_t { None, Sub, Up, Average, Paeth, Adaptive };
+
+    // The zlib compression level, from 0 (no compression) to 9 (smallest), or -1 for the default.
+    int compressionLevel = -1;
+
+    Filter filter = Filter::None;
+
+    // Writes images with at most 256 colors with a palette. Their scanlines are a quarter of
+    // the size, and are deflated without filtering them.
+    bool palette = true;
+
+    // Filters and deflates stripes of `stripeRows` rows at once on the scheduler, if any. The
+    // call blocks until they are done, so it must not be made from a thread of the scheduler.
+    Scheduler* scheduler = nullptr;
+    uint32_t stripeRows = 128;
+};
+
+std::string encodePNG(const PremultipliedImage&, const PNGEncodeOptions& = {});
 
 } // namespace mbgl
@@ -35,25 +35,43 @@ private:
         return i < N && (l[i] == e || includes(e, l, i + 1));
     }
 
+    // Whether a severity is compiled in at all. The severity of the functions below is known at
+    // compile time, so calls at disabled severities compile to nothing.
+    constexpr static bool enabled(const EventSeverity severity) {
+        return !includes(severity, disabledEventSeverities);
+    }
+
 public:
     template <typename ...Args>
     static void Debug(Event event, Args&& ...args) {
-        Record(EventSeverity::Debug, event, ::std::forward<Args>(args)...);
+        constexpr bool debug = enabled(EventSeverity::Debug);
+        if (debug) {
+            Record(EventSeverity::Debug, event, ::std::forward<Args>(args)...);
+        }
     }
 
     template <typename ...Args>
     static void Info(Event event, Args&& ...args) {
-        Record(EventSeverity::Info, event, ::std::forward<Args>(args)...);
+        constexpr bool info = enabled(EventSeverity::Info);
+        if (info) {
+            Record(EventSeverity::Info, event, ::std::forward<Args>(args)...);
+        }
     }
 
     template <typename ...Args>
     static void Warning(Event event, Args&& ...args) {
-        Record(EventSeverity::Warning, event, ::std::forward<Args>(args)...);
+        constexpr bool warning = enabled(EventSeverity::Warning);
+        if (warning) {
+            Record(EventSeverity::Warning, event, ::std::forward<Args>(args)...);
+        }
     }
 
     template <typename ...Args>
     static void Error(Event event, Args&& ...args) {
-        Record(EventSeverity::Error, event, ::std::forward<Args>(args)...);
+        constexpr bool error = enabled(EventSeverity::Error);
+        if (error) {
+            Record(EventSeverity::Error, event, ::std::forward<Args>(args)...);
+        }
     }
 
     template <typename ...Args>
@@ -73,7 +91,10 @@ private:
 
     // This method is the data sink that must be implemented by each platform we
     // support. It should ideally output the error message in a human readable
-    // format to the developer.
+    // format to the developer. Messages reach it from a thread of its own, not the
+    // thread that logged them, except for errors, which are written right away after
+    // the messages before them. Each event is limited to a number of messages a
+    // second; observers still see every message.
     static void platformRecord(EventSeverity severity, const std::string &msg);
 };
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -23,6 +25,23 @@ void setCurrentThreadName(const std::string& name);
 // Makes the current thread low priority.
 void makeThreadLowPriority();
 
+// The kind of cores that a thread should run on, on devices with cores of different speeds. It's
+// a hint: platforms that don't let threads choose their cores ignore it.
+enum class ThreadPlacement : uint8_t {
+    Any,
+    // The fastest cores, or the quality of service of interactive work.
+    Performance,
+    // The most efficient cores, or the quality of service of background work.
+    Efficiency,
+};
+
+// Returns the number of the fastest cores of the device, which is the number of all its cores
+// where they are alike.
+std::size_t getPerformanceCoreCount();
+
+// Asks the OS to run the current thread on the given kind of cores.
+void setCurrentThreadPlacement(ThreadPlacement);
+
 // Shows an alpha image with the specified dimensions in a named window.
 void showDebugImage(std::string name, const char *data, size_t width, size_t height);
 
@@ -6,12 +6,11 @@
 #include <mbgl/util/util.hpp>
 #include <mbgl/util/work_task.hpp>
 #include <mbgl/util/work_request.hpp>
+#include <mbgl/util/work_task_queue.hpp>
 
 #include <atomic>
 #include <functional>
 #include <utility>
-#include <queue>
-#include <mutex>
 
 namespace mbgl {
 namespace util {
@@ -77,8 +76,6 @@ public:
 private:
     MBGL_STORE_THREAD(tid)
 
-    using Queue = std::queue<std::shared_ptr<WorkTask>>;
-
     void push(std::shared_ptr<WorkTask>);
 
     void schedule(std::weak_ptr<Mailbox> mailbox) override {
@@ -87,23 +84,11 @@ private:
         });
     }
 
-    void withMutex(std::function<void()>&& fn) {
-        std::lock_guard<std::mutex> lock(mutex);
-        fn();
-    }
-
     void process() {
-        Queue queue_;
-        withMutex([&] { queue_.swap(queue); });
-
-        while (!queue_.empty()) {
-            (*(queue_.front()))();
-            queue_.pop();
-        }
+        queue.process();
     }
 
-    Queue queue;
-    std::mutex mutex;
+    WorkTaskQueue queue;
 
     std::unique_ptr<Impl> impl;
 };
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// A tile URL template such as "https://example.com/{z}/{x}/{y}{ratio}.png", split once into its
+// literal text and its {tokens}. Building the URL of a tile is then a single pass over the
+// segments into a string that is reserved up front, rather than a search for each token.
+class TileURLTemplate {
+public:
+    explicit TileURLTemplate(std::string source);
+
+    const std::string& getSource() const {
+        return source;
+    }
+
+    // Whether the URL differs between pixel ratios, i.e. the template has a {ratio} token.
+    bool hasRatio() const {
+        return ratio;
+    }
+
+    // The coordinates are those of the XYZ scheme; TMS sources flip y before calling this.
+    std::string url(float pixelRatio, int32_t x, int32_t y, int8_t z) const;
+
+private:
+    enum class Token : uint8_t {
+        Literal,
+        Z,
+        X,
+        Y,
+        QuadKey,
+        BBox,
+        Prefix,
+        Ratio,
+    };
+
+    struct Segment {
+        Token token;
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    std::string source;
+    std::vector<Segment> segments;
+    std::size_t literalLength = 0;
+    bool ratio = false;
+};
+
+} // namespace mbgl
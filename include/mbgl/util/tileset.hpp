@@ -5,9 +5,12 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <memory>
 
 namespace mbgl {
 
+class TileURLTemplate;
+
 class Tileset {
 public:
     enum class Scheme : bool { XYZ, TMS };
@@ -17,7 +20,20 @@ public:
     std::string attribution;
     Scheme scheme = Scheme::XYZ;
 
+    // The first of the tile URLs, parsed once by the source for all of its tiles. It isn't part
+    // of the TileJSON, so tilesets compare equal regardless of it.
+    std::shared_ptr<const TileURLTemplate> urlTemplate;
+
     // TileJSON also includes center, zoom, and bounds, but they are not used by mbgl.
 };
 
+inline bool operator==(const Tileset& a, const Tileset& b) {
+    return a.tiles == b.tiles && a.zoomRange == b.zoomRange && a.attribution == b.attribution &&
+           a.scheme == b.scheme;
+}
+
+inline bool operator!=(const Tileset& a, const Tileset& b) {
+    return !(a == b);
+}
+
 } // namespace mbgl
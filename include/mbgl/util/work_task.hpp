@@ -6,6 +6,10 @@
 
 namespace mbgl {
 
+namespace util {
+class WorkTaskQueue;
+} // namespace util
+
 // A movable type-erasing function wrapper. This allows to store arbitrary invokable
 // things (like std::function<>, or the result of a movable-only std::bind()) in the queue.
 // Source: http://stackoverflow.com/a/29642072/331379
@@ -21,6 +25,14 @@ public:
 
     template <class Fn, class... Args>
     static std::shared_ptr<WorkTask> makeWithCallback(Fn&&, Args&&...);
+
+private:
+    friend class util::WorkTaskQueue;
+
+    // Set while the task is queued on a RunLoop, which links tasks through themselves rather
+    // than allocating a node for each.
+    std::shared_ptr<WorkTask> queued;
+    WorkTask* next = nullptr;
 };
 
 } // namespace mbgl
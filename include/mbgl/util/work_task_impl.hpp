@@ -10,8 +10,16 @@ namespace mbgl {
 template <class F, class P>
 class WorkTaskImpl : public WorkTask {
 public:
+    // Tasks without a callback keep their flag to themselves, which saves allocating it.
+    WorkTaskImpl(F f, P p)
+      : canceled(ownCanceled),
+        func(std::move(f)),
+        params(std::move(p)) {
+    }
+
     WorkTaskImpl(F f, P p, std::shared_ptr<std::atomic<bool>> canceled_)
-      : canceled(std::move(canceled_)),
+      : sharedCanceled(std::move(canceled_)),
+        canceled(*sharedCanceled),
         func(std::move(f)),
         params(std::move(p)) {
     }
@@ -19,7 +27,7 @@ public:
     void operator()() override {
         // Lock the mutex while processing so that cancel() will block.
         std::lock_guard<std::recursive_mutex> lock(mutex);
-        if (!*canceled) {
+        if (!canceled) {
             invoke(std::make_index_sequence<std::tuple_size<P>::value>{});
         }
     }
@@ -34,7 +42,7 @@ public:
     // do nothing.
     void cancel() override {
         std::lock_guard<std::recursive_mutex> lock(mutex);
-        *canceled = true;
+        canceled = true;
     }
 
 private:
@@ -44,7 +52,9 @@ private:
     }
 
     std::recursive_mutex mutex;
-    std::shared_ptr<std::atomic<bool>> canceled;
+    std::atomic<bool> ownCanceled { false };
+    std::shared_ptr<std::atomic<bool>> sharedCanceled;
+    std::atomic<bool>& canceled;
 
     F func;
     P params;
@@ -52,14 +62,10 @@ private:
 
 template <class Fn, class... Args>
 std::shared_ptr<WorkTask> WorkTask::make(Fn&& fn, Args&&... args) {
-    auto flag = std::make_shared<std::atomic<bool>>();
-    *flag = false;
-
     auto tuple = std::make_tuple(std::forward<Args>(args)...);
     return std::make_shared<WorkTaskImpl<std::decay_t<Fn>, decltype(tuple)>>(
         std::forward<Fn>(fn),
-        std::move(tuple),
-        flag);
+        std::move(tuple));
 }
 
 namespace detail {
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <memory>
+
+namespace mbgl {
+
+class WorkTask;
+
+namespace util {
+
+// The tasks posted to a RunLoop. Any thread may push without taking a lock, by linking the task
+// itself onto a stack; the thread of the loop takes the whole stack at once and runs the tasks in
+// the order they were pushed. Tasks pushed while others run wait for the next call to process().
+class WorkTaskQueue : private util::noncopyable {
+public:
+    WorkTaskQueue() = default;
+    ~WorkTaskQueue();
+
+    void push(std::shared_ptr<WorkTask>);
+    void process();
+
+private:
+    // Drops the tasks of a list that won't run, e.g. because one before them threw.
+    static void release(WorkTask*);
+
+    std::atomic<WorkTask*> head { nullptr };
+};
+
+} // namespace util
+} // namespace mbgl
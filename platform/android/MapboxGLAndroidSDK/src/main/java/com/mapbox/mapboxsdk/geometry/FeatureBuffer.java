@@ -0,0 +1,405 @@
+package com.mapbox.mapboxsdk.geometry;
+
+import android.support.annotation.NonNull;
+
+import com.google.gson.JsonArray;
+import com.google.gson.JsonElement;
+import com.google.gson.JsonNull;
+import com.google.gson.JsonObject;
+import com.google.gson.JsonPrimitive;
+import com.mapbox.services.commons.geojson.Feature;
+import com.mapbox.services.commons.geojson.Geometry;
+import com.mapbox.services.commons.geojson.GeometryCollection;
+import com.mapbox.services.commons.geojson.LineString;
+import com.mapbox.services.commons.geojson.MultiLineString;
+import com.mapbox.services.commons.geojson.MultiPoint;
+import com.mapbox.services.commons.geojson.MultiPolygon;
+import com.mapbox.services.commons.geojson.Point;
+import com.mapbox.services.commons.geojson.Polygon;
+import com.mapbox.services.commons.models.Position;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.Charset;
+import java.util.AbstractList;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * Features serialized into a direct {@link ByteBuffer}, the way they cross between Java and
+ * native code in a single call rather than in one for each coordinate and property.
+ * <p>
+ * Features are only turned into {@link Feature} objects as they are got, so that a query for
+ * thousands of them costs little until they are looked at. The layout is described in
+ * platform/android/src/geojson/feature_buffer.hpp.
+ * </p>
+ * Internal use.
+ */
+public final class FeatureBuffer extends AbstractList<Feature> {
+
+  private static final Charset UTF_8 = Charset.forName("UTF-8");
+
+  private static final byte POINT = 1;
+  private static final byte MULTI_POINT = 2;
+  private static final byte LINE_STRING = 3;
+  private static final byte MULTI_LINE_STRING = 4;
+  private static final byte POLYGON = 5;
+  private static final byte MULTI_POLYGON = 6;
+  private static final byte GEOMETRY_COLLECTION = 7;
+
+  private static final byte NULL = 0;
+  private static final byte BOOLEAN = 1;
+  private static final byte UNSIGNED = 2;
+  private static final byte SIGNED = 3;
+  private static final byte DOUBLE = 4;
+  private static final byte STRING = 5;
+  private static final byte ARRAY = 6;
+  private static final byte OBJECT = 7;
+
+  private final ByteBuffer buffer;
+  private final Feature[] features;
+
+  /**
+   * Reads the features of a buffer that native code wrote.
+   *
+   * @param buffer the buffer, or null for no features
+   */
+  public FeatureBuffer(ByteBuffer buffer) {
+    this.buffer = buffer != null ? buffer.order(ByteOrder.nativeOrder()) : null;
+    this.features = new Feature[buffer != null ? buffer.getInt(0) : 0];
+  }
+
+  @Override
+  public int size() {
+    return features.length;
+  }
+
+  /**
+   * Gets a feature, which is decoded the first time it is got.
+   *
+   * @param index the index of the feature
+   * @return the feature
+   */
+  @Override
+  public Feature get(int index) {
+    if (index < 0 || index >= features.length) {
+      throw new IndexOutOfBoundsException("Feature " + index + " of " + features.length);
+    }
+    if (features[index] == null) {
+      Reader reader = new Reader(buffer, buffer.getInt(4 * (1 + index)));
+      features[index] = reader.feature();
+    }
+    return features[index];
+  }
+
+  /**
+   * Serializes features into a direct buffer, for native code to read.
+   *
+   * @param features the features
+   * @return the buffer
+   */
+  @NonNull
+  public static ByteBuffer encode(@NonNull List<Feature> features) {
+    Writer writer = new Writer();
+    writer.putInt(features.size());
+
+    // The offsets of the features are filled in as they are written.
+    int offsets = writer.buffer.position();
+    for (int i = 0; i < features.size(); i++) {
+      writer.putInt(0);
+    }
+
+    for (int i = 0; i < features.size(); i++) {
+      writer.buffer.putInt(offsets + 4 * i, writer.buffer.position());
+      writer.feature(features.get(i));
+    }
+
+    ByteBuffer encoded = writer.buffer;
+    encoded.flip();
+    ByteBuffer direct = ByteBuffer.allocateDirect(encoded.remaining()).order(ByteOrder.nativeOrder());
+    direct.put(encoded);
+    direct.flip();
+    return direct;
+  }
+
+  private static final class Reader {
+
+    private final ByteBuffer buffer;
+    private int position;
+
+    Reader(ByteBuffer buffer, int position) {
+      this.buffer = buffer;
+      this.position = position;
+    }
+
+    Feature feature() {
+      String id = buffer.get(position++) != 0 ? string() : null;
+      Geometry geometry = geometry();
+      JsonObject properties = object();
+      return Feature.fromGeometry(geometry, properties, id);
+    }
+
+    Geometry geometry() {
+      byte type = buffer.get(position++);
+      switch (type) {
+        case POINT:
+          return Point.fromCoordinates(point());
+        case MULTI_POINT:
+          return MultiPoint.fromCoordinates(points());
+        case LINE_STRING:
+          return LineString.fromCoordinates(points());
+        case MULTI_LINE_STRING:
+          return MultiLineString.fromCoordinates(lines());
+        case POLYGON:
+          return Polygon.fromCoordinates(lines());
+        case MULTI_POLYGON: {
+          double[][][][] polygons = new double[count()][][][];
+          for (int i = 0; i < polygons.length; i++) {
+            polygons[i] = lines();
+          }
+          return MultiPolygon.fromCoordinates(polygons);
+        }
+        case GEOMETRY_COLLECTION: {
+          int count = count();
+          List<Geometry> geometries = new ArrayList<>(count);
+          for (int i = 0; i < count; i++) {
+            geometries.add(geometry());
+          }
+          return GeometryCollection.fromGeometries(geometries);
+        }
+        default:
+          throw new IllegalStateException("Unsupported geometry type " + type);
+      }
+    }
+
+    JsonElement value() {
+      byte type = buffer.get(position++);
+      switch (type) {
+        case NULL:
+          return JsonNull.INSTANCE;
+        case BOOLEAN:
+          return new JsonPrimitive(buffer.get(position++) != 0);
+        case UNSIGNED:
+        case SIGNED: {
+          long number = buffer.getLong(position);
+          position += 8;
+          return new JsonPrimitive(number);
+        }
+        case DOUBLE: {
+          double number = buffer.getDouble(position);
+          position += 8;
+          return new JsonPrimitive(number);
+        }
+        case STRING:
+          return new JsonPrimitive(string());
+        case ARRAY: {
+          int count = count();
+          JsonArray array = new JsonArray();
+          for (int i = 0; i < count; i++) {
+            array.add(value());
+          }
+          return array;
+        }
+        case OBJECT:
+          return object();
+        default:
+          throw new IllegalStateException("Unsupported value type " + type);
+      }
+    }
+
+    JsonObject object() {
+      int count = count();
+      JsonObject object = new JsonObject();
+      for (int i = 0; i < count; i++) {
+        String key = string();
+        object.add(key, value());
+      }
+      return object;
+    }
+
+    double[] point() {
+      double x = buffer.getDouble(position);
+      double y = buffer.getDouble(position + 8);
+      position += 16;
+      return new double[] {x, y};
+    }
+
+    double[][] points() {
+      double[][] points = new double[count()][];
+      for (int i = 0; i < points.length; i++) {
+        points[i] = point();
+      }
+      return points;
+    }
+
+    double[][][] lines() {
+      double[][][] lines = new double[count()][][];
+      for (int i = 0; i < lines.length; i++) {
+        lines[i] = points();
+      }
+      return lines;
+    }
+
+    String string() {
+      int length = count();
+      byte[] bytes = new byte[length];
+      ByteBuffer view = buffer.duplicate();
+      view.position(position);
+      view.get(bytes);
+      position += length;
+      return new String(bytes, UTF_8);
+    }
+
+    int count() {
+      int count = buffer.getInt(position);
+      position += 4;
+      return count;
+    }
+  }
+
+  private static final class Writer {
+
+    ByteBuffer buffer = ByteBuffer.allocate(4096).order(ByteOrder.nativeOrder());
+
+    void feature(Feature feature) {
+      String id = feature.getId();
+      putByte(id != null ? 1 : 0);
+      if (id != null) {
+        putString(id);
+      }
+      geometry(feature.getGeometry());
+
+      JsonObject properties = feature.getProperties();
+      if (properties != null) {
+        object(properties);
+      } else {
+        putInt(0);
+      }
+    }
+
+    @SuppressWarnings("unchecked")
+    void geometry(Geometry geometry) {
+      if (geometry instanceof Point) {
+        putByte(POINT);
+        putPosition(((Point) geometry).getCoordinates());
+      } else if (geometry instanceof MultiPoint) {
+        putByte(MULTI_POINT);
+        putPositions(((MultiPoint) geometry).getCoordinates());
+      } else if (geometry instanceof LineString) {
+        putByte(LINE_STRING);
+        putPositions(((LineString) geometry).getCoordinates());
+      } else if (geometry instanceof MultiLineString) {
+        putByte(MULTI_LINE_STRING);
+        putLines(((MultiLineString) geometry).getCoordinates());
+      } else if (geometry instanceof Polygon) {
+        putByte(POLYGON);
+        putLines(((Polygon) geometry).getCoordinates());
+      } else if (geometry instanceof MultiPolygon) {
+        putByte(MULTI_POLYGON);
+        List<List<List<Position>>> polygons = ((MultiPolygon) geometry).getCoordinates();
+        putInt(polygons.size());
+        for (List<List<Position>> polygon : polygons) {
+          putLines(polygon);
+        }
+      } else if (geometry instanceof GeometryCollection) {
+        putByte(GEOMETRY_COLLECTION);
+        List<Geometry> geometries = ((GeometryCollection) geometry).getGeometries();
+        putInt(geometries.size());
+        for (Geometry child : geometries) {
+          geometry(child);
+        }
+      } else {
+        throw new IllegalArgumentException("Unsupported GeoJSON type: "
+          + (geometry != null ? geometry.getType() : null));
+      }
+    }
+
+    void value(JsonElement element) {
+      if (element == null || element.isJsonNull()) {
+        putByte(NULL);
+      } else if (element.isJsonPrimitive()) {
+        JsonPrimitive primitive = element.getAsJsonPrimitive();
+        if (primitive.isBoolean()) {
+          putByte(BOOLEAN);
+          putByte(primitive.getAsBoolean() ? 1 : 0);
+        } else if (primitive.isNumber()) {
+          putByte(DOUBLE);
+          putDouble(primitive.getAsDouble());
+        } else {
+          putByte(STRING);
+          putString(primitive.getAsString());
+        }
+      } else if (element.isJsonArray()) {
+        JsonArray array = element.getAsJsonArray();
+        putByte(ARRAY);
+        putInt(array.size());
+        for (JsonElement child : array) {
+          value(child);
+        }
+      } else {
+        putByte(OBJECT);
+        object(element.getAsJsonObject());
+      }
+    }
+
+    void object(JsonObject object) {
+      putInt(object.entrySet().size());
+      for (Map.Entry<String, JsonElement> entry : object.entrySet()) {
+        putString(entry.getKey());
+        value(entry.getValue());
+      }
+    }
+
+    void putPosition(Position position) {
+      putDouble(position.getLongitude());
+      putDouble(position.getLatitude());
+    }
+
+    void putPositions(List<Position> positions) {
+      putInt(positions.size());
+      for (Position position : positions) {
+        putPosition(position);
+      }
+    }
+
+    void putLines(List<List<Position>> lines) {
+      putInt(lines.size());
+      for (List<Position> line : lines) {
+        putPositions(line);
+      }
+    }
+
+    void putString(String string) {
+      byte[] bytes = string.getBytes(UTF_8);
+      putInt(bytes.length);
+      reserve(bytes.length);
+      buffer.put(bytes);
+    }
+
+    void putByte(int value) {
+      reserve(1);
+      buffer.put((byte) value);
+    }
+
+    void putInt(int value) {
+      reserve(4);
+      buffer.putInt(value);
+    }
+
+    void putDouble(double value) {
+      reserve(8);
+      buffer.putDouble(value);
+    }
+
+    private void reserve(int size) {
+      if (buffer.remaining() < size) {
+        ByteBuffer grown = ByteBuffer.allocate(Math.max(buffer.capacity() * 2, buffer.position() + size))
+          .order(ByteOrder.nativeOrder());
+        buffer.flip();
+        grown.put(buffer);
+        buffer = grown;
+      }
+    }
+  }
+}
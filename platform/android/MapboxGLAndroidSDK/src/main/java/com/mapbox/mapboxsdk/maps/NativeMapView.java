@@ -18,6 +18,7 @@ import com.mapbox.mapboxsdk.annotations.Marker;
 import com.mapbox.mapboxsdk.annotations.Polygon;
 import com.mapbox.mapboxsdk.annotations.Polyline;
 import com.mapbox.mapboxsdk.constants.MapboxConstants;
+import com.mapbox.mapboxsdk.geometry.FeatureBuffer;
 import com.mapbox.mapboxsdk.geometry.LatLng;
 import com.mapbox.mapboxsdk.geometry.LatLngBounds;
 import com.mapbox.mapboxsdk.geometry.ProjectedMeters;
@@ -841,9 +842,8 @@ final class NativeMapView {
     if (isDestroyedOn("queryRenderedFeatures")) {
       return new ArrayList<>();
     }
-    Feature[] features = nativeQueryRenderedFeaturesForPoint(coordinates.x / pixelRatio,
-      coordinates.y / pixelRatio, layerIds, filter != null ? filter.toArray() : null);
-    return features != null ? Arrays.asList(features) : new ArrayList<Feature>();
+    return new FeatureBuffer(nativeQueryRenderedFeaturesForPoint(coordinates.x / pixelRatio,
+      coordinates.y / pixelRatio, layerIds, filter != null ? filter.toArray() : null));
   }
 
   @NonNull
@@ -853,14 +853,13 @@ final class NativeMapView {
     if (isDestroyedOn("queryRenderedFeatures")) {
       return new ArrayList<>();
     }
-    Feature[] features = nativeQueryRenderedFeaturesForBox(
+    return new FeatureBuffer(nativeQueryRenderedFeaturesForBox(
       coordinates.left / pixelRatio,
       coordinates.top / pixelRatio,
       coordinates.right / pixelRatio,
       coordinates.bottom / pixelRatio,
       layerIds,
-      filter != null ? filter.toArray() : null);
-    return features != null ? Arrays.asList(features) : new ArrayList<Feature>();
+      filter != null ? filter.toArray() : null));
   }
 
   public void scheduleTakeSnapshot() {
@@ -1101,15 +1100,15 @@ final class NativeMapView {
 
   private native void nativeTakeSnapshot();
 
-  private native Feature[] nativeQueryRenderedFeaturesForPoint(float x, float y,
+  private native ByteBuffer nativeQueryRenderedFeaturesForPoint(float x, float y,
+                                                                 String[] layerIds,
+                                                                 Object[] filter);
+
+  private native ByteBuffer nativeQueryRenderedFeaturesForBox(float left, float top,
+                                                               float right, float bottom,
                                                                String[] layerIds,
                                                                Object[] filter);
 
-  private native Feature[] nativeQueryRenderedFeaturesForBox(float left, float top,
-                                                             float right, float bottom,
-                                                             String[] layerIds,
-                                                             Object[] filter);
-
   int getWidth() {
     if (isDestroyedOn("")) {
       return 0;
@@ -4,14 +4,15 @@ import android.support.annotation.NonNull;
 import android.support.annotation.Nullable;
 import android.support.annotation.UiThread;
 
+import com.mapbox.mapboxsdk.geometry.FeatureBuffer;
 import com.mapbox.mapboxsdk.style.layers.Filter;
 import com.mapbox.services.commons.geojson.Feature;
 import com.mapbox.services.commons.geojson.FeatureCollection;
 import com.mapbox.services.commons.geojson.Geometry;
 
 import java.net.URL;
+import java.nio.ByteBuffer;
 import java.util.ArrayList;
-import java.util.Arrays;
 import java.util.List;
 
 /**
@@ -197,7 +198,7 @@ public class GeoJsonSource extends Source {
    * @param features the GeoJSON FeatureCollection
    */
   public void setGeoJson(FeatureCollection features) {
-    nativeSetFeatureCollection(features);
+    nativeSetFeatureBuffer(FeatureBuffer.encode(features.getFeatures()));
   }
 
   /**
@@ -235,8 +236,7 @@ public class GeoJsonSource extends Source {
    */
   @NonNull
   public List<Feature> querySourceFeatures(@Nullable Filter.Statement filter) {
-    Feature[] features = querySourceFeatures(filter != null ? filter.toArray() : null);
-    return features != null ? Arrays.asList(features) : new ArrayList<Feature>();
+    return new FeatureBuffer(querySourceFeatures(filter != null ? filter.toArray() : null));
   }
 
   protected native void initialize(String layerId, Object options);
@@ -245,13 +245,13 @@ public class GeoJsonSource extends Source {
 
   private native void nativeSetGeoJsonString(String geoJson);
 
-  private native void nativeSetFeatureCollection(FeatureCollection geoJson);
+  private native void nativeSetFeatureBuffer(ByteBuffer features);
 
   private native void nativeSetFeature(Feature feature);
 
   private native void nativeSetGeometry(Geometry<?> geometry);
 
-  private native Feature[] querySourceFeatures(Object[] filter);
+  private native ByteBuffer querySourceFeatures(Object[] filter);
 
   @Override
   protected native void finalize() throws Throwable;
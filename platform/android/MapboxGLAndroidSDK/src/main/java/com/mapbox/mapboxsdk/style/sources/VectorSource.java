@@ -5,12 +5,12 @@ import android.support.annotation.Nullable;
 import android.support.annotation.Size;
 import android.support.annotation.UiThread;
 
+import com.mapbox.mapboxsdk.geometry.FeatureBuffer;
 import com.mapbox.mapboxsdk.style.layers.Filter;
 import com.mapbox.services.commons.geojson.Feature;
 
 import java.net.URL;
-import java.util.ArrayList;
-import java.util.Arrays;
+import java.nio.ByteBuffer;
 import java.util.List;
 
 /**
@@ -70,10 +70,9 @@ public class VectorSource extends Source {
   @NonNull
   public List<Feature> querySourceFeatures(@Size(min = 1) String[] sourceLayerIds,
                                            @Nullable Filter.Statement filter) {
-    Feature[] features = querySourceFeatures(
+    return new FeatureBuffer(querySourceFeatures(
       sourceLayerIds,
-      filter != null ? filter.toArray() : null);
-    return features != null ? Arrays.asList(features) : new ArrayList<Feature>();
+      filter != null ? filter.toArray() : null));
   }
 
   protected native void initialize(String layerId, Object payload);
@@ -81,7 +80,7 @@ public class VectorSource extends Source {
   @Override
   protected native void finalize() throws Throwable;
 
-  private native Feature[] querySourceFeatures(String[] sourceLayerId,
-                                               Object[] filter);
+  private native ByteBuffer querySourceFeatures(String[] sourceLayerId,
+                                                 Object[] filter);
 
 }
@@ -0,0 +1,74 @@
+package com.mapbox.mapboxsdk.geometry;
+
+import com.google.gson.JsonArray;
+import com.google.gson.JsonObject;
+import com.mapbox.services.commons.geojson.Feature;
+import com.mapbox.services.commons.geojson.LineString;
+import com.mapbox.services.commons.geojson.Point;
+import com.mapbox.services.commons.models.Position;
+
+import org.junit.Test;
+
+import java.nio.ByteBuffer;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNull;
+import static org.junit.Assert.assertTrue;
+
+public class FeatureBufferTest {
+
+  private static final double DELTA = 1e-15;
+
+  @Test
+  public void testNullBuffer() {
+    assertEquals("no features", 0, new FeatureBuffer(null).size());
+  }
+
+  @Test
+  public void testRoundTrip() {
+    JsonObject properties = new JsonObject();
+    properties.addProperty("name", "Ünïcödé");
+    properties.addProperty("rank", 3.5);
+    properties.addProperty("visible", true);
+    JsonArray tags = new JsonArray();
+    tags.add("a");
+    tags.add("b");
+    properties.add("tags", tags);
+
+    List<Feature> features = new ArrayList<>();
+    features.add(Feature.fromGeometry(Point.fromCoordinates(new double[] {1.5, -2.5}), properties, "first"));
+    features.add(Feature.fromGeometry(LineString.fromCoordinates(new double[][] {{0, 0}, {10, 20}})));
+
+    ByteBuffer buffer = FeatureBuffer.encode(features);
+    assertTrue("buffer is direct", buffer.isDirect());
+
+    FeatureBuffer decoded = new FeatureBuffer(buffer);
+    assertEquals("feature count", 2, decoded.size());
+
+    Feature point = decoded.get(0);
+    assertEquals("id", "first", point.getId());
+    Position position = ((Point) point.getGeometry()).getCoordinates();
+    assertEquals("longitude", 1.5, position.getLongitude(), DELTA);
+    assertEquals("latitude", -2.5, position.getLatitude(), DELTA);
+    JsonObject decodedProperties = point.getProperties();
+    assertEquals("string property", "Ünïcödé", decodedProperties.get("name").getAsString());
+    assertEquals("number property", 3.5, decodedProperties.get("rank").getAsDouble(), DELTA);
+    assertTrue("boolean property", decodedProperties.get("visible").getAsBoolean());
+    assertEquals("array property", tags, decodedProperties.get("tags"));
+
+    Feature line = decoded.get(1);
+    assertNull("no id", line.getId());
+    List<Position> positions = ((LineString) line.getGeometry()).getCoordinates();
+    assertEquals("position count", 2, positions.size());
+    assertEquals("longitude", 10, positions.get(1).getLongitude(), DELTA);
+    assertEquals("latitude", 20, positions.get(1).getLatitude(), DELTA);
+  }
+
+  @Test(expected = IndexOutOfBoundsException.class)
+  public void testOutOfBounds() {
+    new FeatureBuffer(FeatureBuffer.encode(Arrays.<Feature>asList())).get(0);
+  }
+}
@@ -16,7 +16,6 @@ if ((ANDROID_ABI STREQUAL "armeabi") OR (ANDROID_ABI STREQUAL "armeabi-v7a") OR
 endif()
 
 mason_use(jni.hpp VERSION 3.0.0 HEADER_ONLY)
-mason_use(libzip VERSION 1.1.3)
 mason_use(nunicode VERSION 1.7.1)
 mason_use(sqlite VERSION 3.14.2)
 mason_use(gtest VERSION 1.8.0)
@@ -36,6 +35,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/android/src/http_file_source.cpp
         PRIVATE platform/android/src/asset_file_source.cpp
         PRIVATE platform/default/default_file_source.cpp
+        PRIVATE platform/default/archive_file_source.cpp
         PRIVATE platform/default/local_file_source.cpp
         PRIVATE platform/default/online_file_source.cpp
 
@@ -45,6 +45,12 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/mbgl/storage/offline_database.hpp
         PRIVATE platform/default/mbgl/storage/offline_download.cpp
         PRIVATE platform/default/mbgl/storage/offline_download.hpp
+        PRIVATE platform/default/mbgl/storage/response_cache.cpp
+        PRIVATE platform/default/mbgl/storage/response_cache.hpp
+        PRIVATE platform/default/mbgl/storage/tile_archive.cpp
+        PRIVATE platform/default/mbgl/storage/tile_archive.hpp
+        PRIVATE platform/default/mbgl/util/mapped_file.cpp
+        PRIVATE platform/default/mbgl/util/mapped_file.hpp
         PRIVATE platform/default/sqlite3.cpp
         PRIVATE platform/default/sqlite3.hpp
 
@@ -53,6 +59,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/android/src/thread.cpp
         PRIVATE platform/default/string_stdlib.cpp
         PRIVATE platform/default/bidi.cpp
+        PRIVATE platform/default/local_glyph_rasterizer.cpp
         PRIVATE platform/default/utf.cpp
 
         # Image handling
@@ -68,6 +75,9 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/mbgl/util/shared_thread_pool.hpp
         PRIVATE platform/default/mbgl/util/default_thread_pool.cpp
         PRIVATE platform/default/mbgl/util/default_thread_pool.hpp
+        PRIVATE platform/default/mbgl/util/work_stealing_deque.hpp
+        PRIVATE platform/default/mbgl/util/work_stealing_thread_pool.cpp
+        PRIVATE platform/default/mbgl/util/work_stealing_thread_pool.hpp
     )
 
     target_include_directories(mbgl-core
@@ -76,7 +86,6 @@ macro(mbgl_platform_core)
 
     target_add_mason_package(mbgl-core PUBLIC sqlite)
     target_add_mason_package(mbgl-core PUBLIC nunicode)
-    target_add_mason_package(mbgl-core PUBLIC libzip)
     target_add_mason_package(mbgl-core PUBLIC geojson)
     target_add_mason_package(mbgl-core PUBLIC jni.hpp)
     target_add_mason_package(mbgl-core PUBLIC rapidjson)
@@ -177,6 +186,8 @@ add_library(mbgl-android STATIC
     platform/android/src/native_map_view.hpp
 
     # Java core classes
+    platform/android/src/java/nio.cpp
+    platform/android/src/java/nio.hpp
     platform/android/src/java/util.cpp
     platform/android/src/java/util.hpp
 
@@ -189,6 +200,8 @@ add_library(mbgl-android STATIC
     # GeoJSON
     platform/android/src/geojson/feature.cpp
     platform/android/src/geojson/feature.hpp
+    platform/android/src/geojson/feature_buffer.cpp
+    platform/android/src/geojson/feature_buffer.hpp
     platform/android/src/geojson/feature_collection.cpp
     platform/android/src/geojson/feature_collection.hpp
     platform/android/src/geojson/geometry.cpp
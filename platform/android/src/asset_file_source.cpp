@@ -1,113 +1,240 @@
 #include <mbgl/storage/asset_file_source.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/util/mapped_file.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/util.hpp>
 #include <mbgl/util/thread.hpp>
 #include <mbgl/util/url.hpp>
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wshadow"
-#include <zip.h>
-#pragma GCC diagnostic pop
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <zlib.h>
 
 namespace {
 
-struct ZipHolder {
-    ZipHolder(struct zip* archive_) : archive(archive_) {}
+// Assets are served out of a mapping of the APK, so the threads mostly wait for page faults and
+// inflate, which they can do side by side.
+const std::size_t threadCount = 3;
 
-    ~ZipHolder() {
-        if (archive) ::zip_close(archive);
-    }
+const uint32_t endOfCentralDirectorySignature = 0x06054B50;
+const uint32_t centralDirectoryEntrySignature = 0x02014B50;
+const uint32_t localHeaderSignature = 0x04034B50;
 
-    struct zip* archive;
-};
+const std::size_t endOfCentralDirectorySize = 22;
+const std::size_t centralDirectoryEntrySize = 46;
+const std::size_t localHeaderSize = 30;
 
-struct ZipFileHolder {
-    ZipFileHolder(struct zip_file* file_) : file(file_) {}
-
-    ~ZipFileHolder() {
-        if (file) ::zip_fclose(file);
-    }
+const uint16_t stored = 0;
+const uint16_t deflated = 8;
 
-    struct zip_file* file;
-};
+// The largest comment that can follow the end of the central directory.
+const std::size_t maxCommentSize = 0xFFFF;
 
-}
+} // namespace
 
 namespace mbgl {
 
-class AssetFileRequest : public AsyncRequest {
+// The assets of an APK, which is a zip archive. The APK is mapped once and its central directory
+// indexed once, and both are shared by all the threads. Assets that are stored uncompressed are
+// handed out as Buffers into the mapping; the others are inflated straight out of it.
+class AssetArchive {
 public:
-    AssetFileRequest(std::unique_ptr<WorkRequest> workRequest_)
-        : workRequest(std::move(workRequest_)) {
+    explicit AssetArchive(std::string path_)
+        : path(std::move(path_)) {
     }
 
-    std::unique_ptr<WorkRequest> workRequest;
-};
+    std::shared_ptr<const Buffer> get(const std::string& name) {
+        std::call_once(opened, [this] { open(); });
 
-class AssetFileSource::Impl {
-public:
-    Impl(const std::string& root_)
-        : root(root_) {
+        auto it = entries.find(name);
+        if (it == entries.end()) {
+            return nullptr;
+        }
+        const Entry& entry = it->second;
+
+        // The data follows a local header, whose name and extra fields needn't match the lengths
+        // of those in the central directory.
+        const char* header = slice(entry.localHeaderOffset, localHeaderSize);
+        if (readUint32(header) != localHeaderSignature) {
+            throw std::runtime_error("Corrupt local header in zip archive");
+        }
+        const std::size_t dataOffset = entry.localHeaderOffset + localHeaderSize +
+            readUint16(header + 26) + readUint16(header + 28);
+        const char* data = slice(dataOffset, entry.compressedSize);
+
+        switch (entry.method) {
+        case stored:
+            if (entry.compressedSize != entry.size) {
+                throw std::runtime_error("Corrupt entry in zip archive");
+            }
+            return std::make_shared<Buffer>(data, entry.size, file);
+        case deflated:
+            return std::make_shared<Buffer>(inflate(data, entry.compressedSize, entry.size));
+        default:
+            throw std::runtime_error("Unsupported compression method in zip archive");
+        }
     }
 
-    void request(const std::string& url, FileSource::Callback callback) {
-        ZipHolder archive = ::zip_open(root.c_str(), 0, nullptr);
-        if (!archive.archive) {
-            reportError(Response::Error::Reason::Other, "Could not open zip archive", callback);
-            return;
+private:
+    struct Entry {
+        uint16_t method;
+        std::size_t compressedSize;
+        std::size_t size;
+        std::size_t localHeaderOffset;
+    };
+
+    // Reads the central directory. Throws if the archive can't be mapped or isn't a zip archive;
+    // since std::call_once doesn't count a call that throws, the next request tries again.
+    void open() {
+        entries.clear();
+        file = std::make_shared<const MappedFile>(path);
+
+        if (file->size < endOfCentralDirectorySize) {
+            throw std::runtime_error("Could not open zip archive");
         }
 
-        struct zip_stat stat;
-        ::zip_stat_init(&stat);
+        // The end of the central directory record is followed by a comment of unknown length.
+        std::size_t end = file->size - endOfCentralDirectorySize;
+        const std::size_t first = end > maxCommentSize ? end - maxCommentSize : 0;
+        while (readUint32(file->data + end) != endOfCentralDirectorySignature) {
+            if (end == first) {
+                throw std::runtime_error("Could not open zip archive");
+            }
+            end--;
+        }
 
-        std::string path = std::string("assets/") + mbgl::util::percentDecode(url.substr(8));
+        const char* record = file->data + end;
+        const uint16_t count = readUint16(record + 10);
+        const uint32_t directorySize = readUint32(record + 12);
+        const uint32_t directoryOffset = readUint32(record + 16);
+
+        const char* directory = slice(directoryOffset, directorySize);
+        std::size_t offset = 0;
+        entries.reserve(count);
+        for (uint16_t i = 0; i < count; i++) {
+            if (directorySize - offset < centralDirectoryEntrySize) {
+                throw std::runtime_error("Corrupt central directory in zip archive");
+            }
+            const char* entry = directory + offset;
+            if (readUint32(entry) != centralDirectoryEntrySignature) {
+                throw std::runtime_error("Corrupt central directory in zip archive");
+            }
+
+            const uint16_t nameLength = readUint16(entry + 28);
+            const std::size_t entryLength = centralDirectoryEntrySize + nameLength +
+                readUint16(entry + 30) + readUint16(entry + 32);
+            if (directorySize - offset < entryLength) {
+                throw std::runtime_error("Corrupt central directory in zip archive");
+            }
+
+            // Only assets are ever requested, so the code and resources of the APK aren't indexed.
+            std::string name(entry + centralDirectoryEntrySize, nameLength);
+            if (name.compare(0, 7, "assets/") == 0) {
+                entries.emplace(std::move(name), Entry {
+                    readUint16(entry + 10),
+                    readUint32(entry + 20),
+                    readUint32(entry + 24),
+                    readUint32(entry + 42),
+                });
+            }
+
+            offset += entryLength;
+        }
+    }
 
-        int ret = ::zip_stat(archive.archive, path.c_str(), 0, &stat);
-        if (ret < 0 || !(stat.valid & ZIP_STAT_SIZE)) {
-            reportError(Response::Error::Reason::NotFound, "Could not stat file in zip archive", callback);
-            return;
+    const char* slice(std::size_t offset, std::size_t length) const {
+        if (offset > file->size || length > file->size - offset) {
+            throw std::runtime_error("Truncated zip archive");
         }
+        return file->data + offset;
+    }
 
-        ZipFileHolder file = ::zip_fopen(archive.archive, path.c_str(), 0);
-        if (!file.file) {
-            reportError(Response::Error::Reason::NotFound, "Could not open file in zip archive", callback);
-            return;
+    static uint16_t readUint16(const char* data) {
+        return uint16_t(uint8_t(data[0])) | uint16_t(uint8_t(data[1])) << 8;
+    }
+
+    static uint32_t readUint32(const char* data) {
+        return uint32_t(readUint16(data)) | uint32_t(readUint16(data + 2)) << 16;
+    }
+
+    // Zip entries are raw deflate streams, without the zlib header that util::decompress expects.
+    static std::string inflate(const char* data, std::size_t size, std::size_t uncompressedSize) {
+        std::string result(uncompressedSize, char());
+        if (!uncompressedSize) {
+            return result;
+        }
+
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+            throw std::runtime_error("failed to initialize inflate");
         }
 
-        std::shared_ptr<std::string> buf = std::make_shared<std::string>();
-        buf->resize(stat.size);
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream.avail_in = uInt(size);
+        stream.next_out = reinterpret_cast<Bytef*>(&result[0]);
+        stream.avail_out = uInt(uncompressedSize);
+
+        const int code = ::inflate(&stream, Z_FINISH);
+        inflateEnd(&stream);
 
-        ret = ::zip_fread(file.file, &buf->front(), stat.size);
-        if (ret < 0) {
-            reportError(Response::Error::Reason::Other, "Could not read file in zip archive", callback);
-            return;
+        if (code != Z_STREAM_END || stream.total_out != uncompressedSize) {
+            throw std::runtime_error("Could not read file in zip archive");
         }
+        return result;
+    }
 
-        Response response;
-        response.data = buf;
-        callback(response);
+    const std::string path;
+    std::once_flag opened;
+    std::shared_ptr<const MappedFile> file;
+    std::unordered_map<std::string, Entry> entries;
+};
+
+class AssetFileSource::Impl {
+public:
+    Impl(std::shared_ptr<AssetArchive> archive_)
+        : archive(std::move(archive_)) {
     }
 
-    void reportError(Response::Error::Reason reason, const char * message, FileSource::Callback callback) {
+    void request(const std::string& url, FileSource::Callback callback) {
+        const std::string path = std::string("assets/") + mbgl::util::percentDecode(url.substr(8));
+
         Response response;
-        response.error = std::make_unique<Response::Error>(reason, message);
+        try {
+            response.data = archive->get(path);
+            if (!response.data) {
+                response.error = std::make_unique<Response::Error>(
+                    Response::Error::Reason::NotFound, "Could not find file in zip archive");
+            }
+        } catch (...) {
+            response.error = std::make_unique<Response::Error>(
+                Response::Error::Reason::Other,
+                util::toString(std::current_exception()));
+        }
+
         callback(response);
     }
 
 private:
-    std::string root;
+    const std::shared_ptr<AssetArchive> archive;
 };
 
-AssetFileSource::AssetFileSource(const std::string& root)
-    : thread(std::make_unique<util::Thread<Impl>>(
-        util::ThreadContext{"AssetFileSource", util::ThreadPriority::Low},
-        root)) {
+AssetFileSource::AssetFileSource(const std::string& root) {
+    auto archive = std::make_shared<AssetArchive>(root);
+    for (std::size_t i = 0; i < threadCount; i++) {
+        threads.push_back(std::make_unique<util::Thread<Impl>>(
+            util::ThreadContext{"AssetFileSource", util::ThreadPriority::Low},
+            archive));
+    }
 }
 
 AssetFileSource::~AssetFileSource() = default;
 
 std::unique_ptr<AsyncRequest> AssetFileSource::request(const Resource& resource, Callback callback) {
-    return thread->invokeWithCallback(&Impl::request, resource.url, callback);
+    return threads[nextThread++ % threads.size()]->invokeWithCallback(&Impl::request, resource.url, callback);
 }
 
 }
@@ -0,0 +1,395 @@
+#include "feature_buffer.hpp"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace mbgl {
+namespace android {
+namespace geojson {
+
+namespace {
+
+class Writer {
+public:
+    template <class T>
+    void number(T value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <class T>
+    void numberAt(std::size_t offset, T value) {
+        std::memcpy(&buffer[offset], &value, sizeof(T));
+    }
+
+    void string(const std::string& value) {
+        count(value.size());
+        buffer.append(value);
+    }
+
+    void count(std::size_t value) {
+        if (value > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("too many elements to serialize");
+        }
+        number<uint32_t>(value);
+    }
+
+    template <class Points>
+    void points(const Points& points) {
+        count(points.size());
+        for (const auto& point : points) {
+            number<double>(point.x);
+            number<double>(point.y);
+        }
+    }
+
+    template <class Lines>
+    void lines(const Lines& lines) {
+        count(lines.size());
+        for (const auto& line : lines) {
+            points(line);
+        }
+    }
+
+    void geometry(const mapbox::geometry::geometry<double>& value) {
+        value.match(
+            [&] (const mapbox::geometry::point<double>& point) {
+                number<uint8_t>(FeatureBuffer::Point);
+                number<double>(point.x);
+                number<double>(point.y);
+            },
+            [&] (const mapbox::geometry::multi_point<double>& multiPoint) {
+                number<uint8_t>(FeatureBuffer::MultiPoint);
+                points(multiPoint);
+            },
+            [&] (const mapbox::geometry::line_string<double>& lineString) {
+                number<uint8_t>(FeatureBuffer::LineString);
+                points(lineString);
+            },
+            [&] (const mapbox::geometry::multi_line_string<double>& multiLineString) {
+                number<uint8_t>(FeatureBuffer::MultiLineString);
+                lines(multiLineString);
+            },
+            [&] (const mapbox::geometry::polygon<double>& polygon) {
+                number<uint8_t>(FeatureBuffer::Polygon);
+                lines(polygon);
+            },
+            [&] (const mapbox::geometry::multi_polygon<double>& multiPolygon) {
+                number<uint8_t>(FeatureBuffer::MultiPolygon);
+                count(multiPolygon.size());
+                for (const auto& polygon : multiPolygon) {
+                    lines(polygon);
+                }
+            },
+            [&] (const mapbox::geometry::geometry_collection<double>& collection) {
+                number<uint8_t>(FeatureBuffer::GeometryCollection);
+                count(collection.size());
+                for (const auto& child : collection) {
+                    geometry(child);
+                }
+            });
+    }
+
+    void value(const mbgl::Value& value) {
+        value.match(
+            [&] (const mapbox::geometry::null_value_t&) {
+                number<uint8_t>(FeatureBuffer::Null);
+            },
+            [&] (bool boolean) {
+                number<uint8_t>(FeatureBuffer::Boolean);
+                number<uint8_t>(boolean);
+            },
+            [&] (uint64_t unsignedNumber) {
+                number<uint8_t>(FeatureBuffer::Unsigned);
+                number<uint64_t>(unsignedNumber);
+            },
+            [&] (int64_t signedNumber) {
+                number<uint8_t>(FeatureBuffer::Signed);
+                number<int64_t>(signedNumber);
+            },
+            [&] (double doubleNumber) {
+                number<uint8_t>(FeatureBuffer::Double);
+                number<double>(doubleNumber);
+            },
+            [&] (const std::string& string_) {
+                number<uint8_t>(FeatureBuffer::String);
+                string(string_);
+            },
+            [&] (const std::vector<mbgl::Value>& array) {
+                number<uint8_t>(FeatureBuffer::Array);
+                count(array.size());
+                for (const auto& element : array) {
+                    this->value(element);
+                }
+            },
+            [&] (const mbgl::PropertyMap& object) {
+                number<uint8_t>(FeatureBuffer::Object);
+                properties(object);
+            });
+    }
+
+    void properties(const mbgl::PropertyMap& object) {
+        count(object.size());
+        for (const auto& member : object) {
+            string(member.first);
+            value(member.second);
+        }
+    }
+
+    std::string buffer;
+};
+
+// Feature identifiers are strings on the Java side.
+class FeatureIdVisitor {
+public:
+    template <class T>
+    std::string operator()(const T& i) const {
+        return std::to_string(i);
+    }
+
+    std::string operator()(const std::string& i) const {
+        return i;
+    }
+};
+
+class Reader {
+public:
+    Reader(const char* data_, std::size_t size_) : data(data_), size(size_) {}
+
+    template <class T>
+    T number() {
+        T value;
+        std::memcpy(&value, bytes(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    template <class T>
+    T numberAt(std::size_t offset_) {
+        if (offset_ > size || size - offset_ < sizeof(T)) {
+            truncated();
+        }
+        T value;
+        std::memcpy(&value, data + offset_, sizeof(T));
+        return value;
+    }
+
+    std::string string() {
+        const uint32_t length = number<uint32_t>();
+        return std::string(bytes(length), length);
+    }
+
+    // Counts are checked against what is left, so that a corrupt one doesn't reserve an
+    // allocation that the buffer couldn't possibly fill.
+    uint32_t count(std::size_t minimumElementSize) {
+        const uint32_t count_ = number<uint32_t>();
+        if (count_ > (size - offset) / minimumElementSize) {
+            truncated();
+        }
+        return count_;
+    }
+
+    mapbox::geometry::point<double> point() {
+        const double x = number<double>();
+        const double y = number<double>();
+        return { x, y };
+    }
+
+    template <class Points>
+    Points points() {
+        Points result;
+        const uint32_t n = count(2 * sizeof(double));
+        result.reserve(n);
+        for (uint32_t i = 0; i < n; i++) {
+            result.push_back(point());
+        }
+        return result;
+    }
+
+    template <class Lines>
+    Lines lines() {
+        Lines result;
+        const uint32_t n = count(sizeof(uint32_t));
+        result.reserve(n);
+        for (uint32_t i = 0; i < n; i++) {
+            result.push_back(points<typename Lines::value_type>());
+        }
+        return result;
+    }
+
+    mapbox::geometry::geometry<double> geometry() {
+        switch (number<uint8_t>()) {
+        case FeatureBuffer::Point:
+            return point();
+        case FeatureBuffer::MultiPoint:
+            return points<mapbox::geometry::multi_point<double>>();
+        case FeatureBuffer::LineString:
+            return points<mapbox::geometry::line_string<double>>();
+        case FeatureBuffer::MultiLineString:
+            return lines<mapbox::geometry::multi_line_string<double>>();
+        case FeatureBuffer::Polygon:
+            return lines<mapbox::geometry::polygon<double>>();
+        case FeatureBuffer::MultiPolygon: {
+            mapbox::geometry::multi_polygon<double> multiPolygon;
+            const uint32_t n = count(sizeof(uint32_t));
+            multiPolygon.reserve(n);
+            for (uint32_t i = 0; i < n; i++) {
+                multiPolygon.push_back(lines<mapbox::geometry::polygon<double>>());
+            }
+            return multiPolygon;
+        }
+        case FeatureBuffer::GeometryCollection: {
+            mapbox::geometry::geometry_collection<double> collection;
+            const uint32_t n = count(sizeof(uint8_t));
+            collection.reserve(n);
+            for (uint32_t i = 0; i < n; i++) {
+                collection.push_back(geometry());
+            }
+            return collection;
+        }
+        default:
+            throw std::runtime_error("Unsupported geometry type in feature buffer");
+        }
+    }
+
+    mbgl::Value value() {
+        switch (number<uint8_t>()) {
+        case FeatureBuffer::Null:
+            return mapbox::geometry::null_value;
+        case FeatureBuffer::Boolean:
+            return bool(number<uint8_t>());
+        case FeatureBuffer::Unsigned:
+            return number<uint64_t>();
+        case FeatureBuffer::Signed:
+            return number<int64_t>();
+        case FeatureBuffer::Double:
+            return number<double>();
+        case FeatureBuffer::String:
+            return string();
+        case FeatureBuffer::Array: {
+            std::vector<mbgl::Value> array;
+            const uint32_t n = count(sizeof(uint8_t));
+            array.reserve(n);
+            for (uint32_t i = 0; i < n; i++) {
+                array.push_back(value());
+            }
+            return array;
+        }
+        case FeatureBuffer::Object:
+            return properties();
+        default:
+            throw std::runtime_error("Unsupported value type in feature buffer");
+        }
+    }
+
+    mbgl::PropertyMap properties() {
+        mbgl::PropertyMap object;
+        const uint32_t n = count(sizeof(uint32_t) + sizeof(uint8_t));
+        object.reserve(n);
+        for (uint32_t i = 0; i < n; i++) {
+            std::string key = string();
+            object.emplace(std::move(key), value());
+        }
+        return object;
+    }
+
+    mbgl::Feature feature() {
+        optional<mapbox::geometry::identifier> id;
+        if (number<uint8_t>()) {
+            id = { string() };
+        }
+        auto geometry_ = geometry();
+        auto properties_ = properties();
+        return mbgl::Feature { std::move(geometry_), std::move(properties_), std::move(id) };
+    }
+
+    void seek(std::size_t offset_) {
+        if (offset_ > size) {
+            truncated();
+        }
+        offset = offset_;
+    }
+
+private:
+    const char* bytes(std::size_t length) {
+        if (length > size - offset) {
+            truncated();
+        }
+        const char* result = data + offset;
+        offset += length;
+        return result;
+    }
+
+    [[noreturn]] static void truncated() {
+        throw std::runtime_error("Feature buffer is truncated");
+    }
+
+    const char* data;
+    std::size_t size;
+    std::size_t offset = 0;
+};
+
+} // namespace
+
+std::string FeatureBuffer::encode(const std::vector<mbgl::Feature>& features) {
+    Writer writer;
+    writer.count(features.size());
+
+    // The offsets are filled in as the features are written, so that Java can read any of
+    // them without reading the ones before it.
+    const std::size_t offsets = writer.buffer.size();
+    writer.buffer.resize(offsets + features.size() * sizeof(uint32_t));
+
+    for (std::size_t i = 0; i < features.size(); i++) {
+        const mbgl::Feature& feature = features[i];
+        if (writer.buffer.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("too many features to serialize");
+        }
+        writer.numberAt<uint32_t>(offsets + i * sizeof(uint32_t), writer.buffer.size());
+
+        writer.number<uint8_t>(bool(feature.id));
+        if (feature.id) {
+            writer.string(mapbox::geometry::identifier::visit(*feature.id, FeatureIdVisitor()));
+        }
+        writer.geometry(feature.geometry);
+        writer.properties(feature.properties);
+    }
+
+    return std::move(writer.buffer);
+}
+
+mbgl::FeatureCollection FeatureBuffer::decode(const char* data, std::size_t size) {
+    Reader reader(data, size);
+    const uint32_t count = reader.count(sizeof(uint32_t));
+
+    mbgl::FeatureCollection collection;
+    collection.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        reader.seek(reader.numberAt<uint32_t>(sizeof(uint32_t) * (1 + i)));
+        collection.push_back(reader.feature());
+    }
+
+    return collection;
+}
+
+jni::Object<java::nio::ByteBuffer> FeatureBuffer::toJava(jni::JNIEnv& env, const std::vector<mbgl::Feature>& features) {
+    const std::string encoded = encode(features);
+    if (encoded.size() > std::size_t(std::numeric_limits<jni::jint>::max())) {
+        throw std::runtime_error("too many features to serialize");
+    }
+
+    auto buffer = java::nio::ByteBuffer::allocateDirect(env, jni::jint(encoded.size()));
+    std::memcpy(java::nio::ByteBuffer::getAddress(env, buffer), encoded.data(), encoded.size());
+    return buffer;
+}
+
+mbgl::FeatureCollection FeatureBuffer::convert(jni::JNIEnv& env, jni::Object<java::nio::ByteBuffer> buffer) {
+    const void* data = java::nio::ByteBuffer::getAddress(env, buffer);
+    if (!data) {
+        throw std::runtime_error("Feature buffer is not a direct buffer");
+    }
+    return decode(static_cast<const char*>(data), java::nio::ByteBuffer::getCapacity(env, buffer));
+}
+
+} // namespace geojson
+} // namespace android
+} // namespace mbgl
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/geojson.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <jni/jni.hpp>
+
+#include "../java/nio.hpp"
+
+#include <string>
+#include <vector>
+
+namespace mbgl {
+namespace android {
+namespace geojson {
+
+/**
+ * Features serialized into a direct ByteBuffer, so that they cross JNI in a single call rather
+ * than in one for each coordinate and property. FeatureBuffer.java reads them lazily, and writes
+ * the same layout. All numbers are in native byte order:
+ *
+ *   buffer:   uint32 count, uint32 offset of each feature from the start of the buffer, features
+ *   feature:  uint8 has id, [string id], geometry, uint32 count, (string key, value) properties
+ *   geometry: uint8 GeometryType, followed by
+ *             Point: double x, double y
+ *             MultiPoint, LineString: uint32 count, points
+ *             MultiLineString, Polygon: uint32 count, line strings or rings
+ *             MultiPolygon: uint32 count, polygons
+ *             GeometryCollection: uint32 count, geometries
+ *   value:    uint8 ValueType, followed by nothing for null, uint8 for booleans, uint64, int64,
+ *             double, string, uint32 count and values for arrays, or uint32 count and
+ *             (string key, value) for objects
+ *   string:   uint32 length, UTF-8 bytes
+ */
+class FeatureBuffer : private mbgl::util::noncopyable {
+public:
+
+    enum GeometryType : uint8_t {
+        Point = 1,
+        MultiPoint = 2,
+        LineString = 3,
+        MultiLineString = 4,
+        Polygon = 5,
+        MultiPolygon = 6,
+        GeometryCollection = 7,
+    };
+
+    enum ValueType : uint8_t {
+        Null = 0,
+        Boolean = 1,
+        Unsigned = 2,
+        Signed = 3,
+        Double = 4,
+        String = 5,
+        Array = 6,
+        Object = 7,
+    };
+
+    static std::string encode(const std::vector<mbgl::Feature>&);
+
+    // Throws std::runtime_error if the buffer is truncated or holds a type it doesn't know.
+    static mbgl::FeatureCollection decode(const char* data, std::size_t size);
+
+    static jni::Object<java::nio::ByteBuffer> toJava(jni::JNIEnv&, const std::vector<mbgl::Feature>&);
+
+    static mbgl::FeatureCollection convert(jni::JNIEnv&, jni::Object<java::nio::ByteBuffer>);
+
+};
+
+} // namespace geojson
+} // namespace android
+} // namespace mbgl
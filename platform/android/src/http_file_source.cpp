@@ -126,11 +126,11 @@ void HTTPRequest::onResponse(jni::JNIEnv& env, int code,
 
     if (code == 200) {
         if (body) {
-            auto data = std::make_shared<std::string>(body.Length(env), char());
-            jni::GetArrayRegion(env, *body, 0, data->size(), reinterpret_cast<jbyte*>(&(*data)[0]));
-            response.data = data;
+            std::string data(body.Length(env), char());
+            jni::GetArrayRegion(env, *body, 0, data.size(), reinterpret_cast<jbyte*>(&data[0]));
+            response.data = std::make_shared<Buffer>(std::move(data));
         } else {
-            response.data = std::make_shared<std::string>();
+            response.data = std::make_shared<Buffer>(std::string());
         }
     } else if (code == 204 || (code == 404 && resource.kind == Resource::Kind::Tile)) {
         response.noContent = true;
@@ -186,6 +186,10 @@ std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource,
     return std::make_unique<HTTPRequest>(*impl->env, resource, callback);
 }
 
+void HTTPFileSource::preconnect(const std::string&) {
+    // OkHttp pools connections, and multiplexes requests over HTTP/2, on its own.
+}
+
 uint32_t HTTPFileSource::maximumConcurrentRequests() {
     return 20;
 }
@@ -1,5 +1,6 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/string.hpp>
+#include <mbgl/util/premultiply.hpp>
 
 #include <string>
 
@@ -8,15 +9,19 @@
 
 namespace mbgl {
 
-PremultipliedImage decodeImage(const std::string& string) {
+PremultipliedImage decodeImage(const uint8_t* data, std::size_t size) {
     auto env{ android::AttachEnv() };
 
-    auto array = jni::Array<jni::jbyte>::New(*env, string.size());
-    jni::SetArrayRegion(*env, *array, 0, string.size(),
-                        reinterpret_cast<const signed char*>(string.data()));
+    auto array = jni::Array<jni::jbyte>::New(*env, size);
+    jni::SetArrayRegion(*env, *array, 0, size, reinterpret_cast<const signed char*>(data));
 
-    auto bitmap = android::BitmapFactory::DecodeByteArray(*env, array, 0, string.size());
+    auto bitmap = android::BitmapFactory::DecodeByteArray(*env, array, 0, size);
     return android::Bitmap::GetImage(*env, bitmap);
 }
 
+UnassociatedImage decodeUnassociatedImage(const uint8_t* data, std::size_t size) {
+    // Bitmaps are premultiplied.
+    return util::unpremultiply(decodeImage(data, size));
+}
+
 } // namespace mbgl
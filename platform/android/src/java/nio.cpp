@@ -0,0 +1,31 @@
+#include "nio.hpp"
+
+namespace mbgl {
+namespace android {
+namespace java {
+namespace nio {
+
+jni::Object<ByteBuffer> ByteBuffer::allocateDirect(jni::JNIEnv& env, jni::jint capacity) {
+    static auto method = ByteBuffer::javaClass.GetStaticMethod<jni::Object<ByteBuffer> (jni::jint)>(env, "allocateDirect");
+    return ByteBuffer::javaClass.Call(env, method, capacity);
+}
+
+void* ByteBuffer::getAddress(jni::JNIEnv& env, jni::Object<ByteBuffer> buffer) {
+    return jni::GetDirectBufferAddress(env, *buffer.Get());
+}
+
+std::size_t ByteBuffer::getCapacity(jni::JNIEnv& env, jni::Object<ByteBuffer> buffer) {
+    return jni::GetDirectBufferCapacity(env, *buffer.Get());
+}
+
+jni::Class<ByteBuffer> ByteBuffer::javaClass;
+
+void registerNative(jni::JNIEnv& env) {
+    ByteBuffer::javaClass = *jni::Class<ByteBuffer>::Find(env).NewGlobalRef(env).release();
+}
+
+
+} // namespace nio
+} // namespace java
+} // namespace android
+} // namespace mbgl
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <jni/jni.hpp>
+
+namespace mbgl {
+namespace android {
+namespace java {
+namespace nio {
+
+class ByteBuffer : private mbgl::util::noncopyable {
+public:
+
+    static constexpr auto Name() { return "java/nio/ByteBuffer"; };
+
+    static jni::Object<ByteBuffer> allocateDirect(jni::JNIEnv&, jni::jint capacity);
+
+    // The memory of a direct buffer, which is null for buffers that aren't direct.
+    static void* getAddress(jni::JNIEnv&, jni::Object<ByteBuffer>);
+    static std::size_t getCapacity(jni::JNIEnv&, jni::Object<ByteBuffer>);
+
+    static jni::Class<ByteBuffer> javaClass;
+
+};
+
+void registerNative(jni::JNIEnv&);
+
+
+} // namespace nio
+} // namespace java
+} // namespace android
+} // namespace mbgl
@@ -30,6 +30,7 @@
 #include "gson/json_element.hpp"
 #include "gson/json_object.hpp"
 #include "gson/json_primitive.hpp"
+#include "java/nio.hpp"
 #include "java_types.hpp"
 #include "native_map_view.hpp"
 #include "offline/offline_manager.hpp"
@@ -108,6 +109,7 @@ void registerNatives(JavaVM *vm) {
     // Basic types
     java::registerNatives(env);
     java::util::registerNative(env);
+    java::nio::registerNative(env);
     PointF::registerNative(env);
     RectF::registerNative(env);
 
@@ -18,6 +18,7 @@
 #include "graphics/pointf.hpp"
 #include "graphics/rectf.hpp"
 #include "geojson/feature.hpp"
+#include "geojson/feature_buffer.hpp"
 #include "geometry/lat_lng.hpp"
 #include "geometry/projected_meters.hpp"
 #include "style/layers/layers.hpp"
@@ -219,13 +220,14 @@ public:
 
     jni::Array<jlong> queryPointAnnotations(JNIEnv&, jni::Object<RectF>);
 
-    jni::Array<jni::Object<geojson::Feature>> queryRenderedFeaturesForPoint(JNIEnv&, jni::jfloat, jni::jfloat,
-                                                                   jni::Array<jni::String>,
-                                                                   jni::Array<jni::Object<>> jfilter);
+    // The features are returned serialized, see geojson::FeatureBuffer.
+    jni::Object<java::nio::ByteBuffer> queryRenderedFeaturesForPoint(JNIEnv&, jni::jfloat, jni::jfloat,
+                                                                     jni::Array<jni::String>,
+                                                                     jni::Array<jni::Object<>> jfilter);
 
-    jni::Array<jni::Object<geojson::Feature>> queryRenderedFeaturesForBox(JNIEnv&, jni::jfloat, jni::jfloat, jni::jfloat,
-                                                                 jni::jfloat, jni::Array<jni::String>,
-                                                                 jni::Array<jni::Object<>> jfilter);
+    jni::Object<java::nio::ByteBuffer> queryRenderedFeaturesForBox(JNIEnv&, jni::jfloat, jni::jfloat, jni::jfloat,
+                                                                   jni::jfloat, jni::Array<jni::String>,
+                                                                   jni::Array<jni::Object<>> jfilter);
 
     jni::Array<jni::Object<Layer>> getLayers(JNIEnv&);
 
@@ -213,7 +213,7 @@ LOOP_HANDLE RunLoop::getLoopHandle() {
 }
 
 void RunLoop::push(std::shared_ptr<WorkTask> task) {
-    withMutex([&] { queue.push(std::move(task)); });
+    queue.push(std::move(task));
     impl->wake();
 }
 
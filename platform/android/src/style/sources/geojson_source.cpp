@@ -8,7 +8,6 @@
 // C++ -> Java conversion
 #include "../../conversion/conversion.hpp"
 #include "../../conversion/collection.hpp"
-#include "../../geojson/conversion/feature.hpp"
 #include "../conversion/url_or_tileset.hpp"
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/style/conversion/geojson_options.hpp>
@@ -62,11 +61,11 @@ namespace android {
         source.as<mbgl::style::GeoJSONSource>()->GeoJSONSource::setGeoJSON(*converted);
     }
 
-    void GeoJSONSource::setFeatureCollection(jni::JNIEnv& env, jni::Object<geojson::FeatureCollection> jFeatures) {
+    void GeoJSONSource::setFeatureBuffer(jni::JNIEnv& env, jni::Object<java::nio::ByteBuffer> jFeatures) {
         using namespace mbgl::android::geojson;
 
         // Convert the jni object
-        auto features = FeatureCollection::convert(env, jFeatures);
+        auto features = FeatureBuffer::convert(env, jFeatures);
 
         // Update the core source
         source.as<mbgl::style::GeoJSONSource>()->GeoJSONSource::setGeoJSON(GeoJSON(features));
@@ -97,14 +96,14 @@ namespace android {
         source.as<mbgl::style::GeoJSONSource>()->GeoJSONSource::setURL(jni::Make<std::string>(env, url));
     }
 
-    jni::Array<jni::Object<geojson::Feature>> GeoJSONSource::querySourceFeatures(jni::JNIEnv& env,
-                                                                        jni::Array<jni::Object<>> jfilter) {
+    jni::Object<java::nio::ByteBuffer> GeoJSONSource::querySourceFeatures(jni::JNIEnv& env,
+                                                                          jni::Array<jni::Object<>> jfilter) {
         using namespace mbgl::android::conversion;
         using namespace mbgl::android::geojson;
 
         auto filter = toFilter(env, jfilter);
         auto features = source.querySourceFeatures({ {},  filter });
-        return *convert<jni::Array<jni::Object<Feature>>, std::vector<mbgl::Feature>>(env, features);
+        return FeatureBuffer::toJava(env, features);
     }
 
     jni::Class<GeoJSONSource> GeoJSONSource::javaClass;
@@ -127,7 +126,7 @@ namespace android {
             "initialize",
             "finalize",
             METHOD(&GeoJSONSource::setGeoJSONString, "nativeSetGeoJsonString"),
-            METHOD(&GeoJSONSource::setFeatureCollection, "nativeSetFeatureCollection"),
+            METHOD(&GeoJSONSource::setFeatureBuffer, "nativeSetFeatureBuffer"),
             METHOD(&GeoJSONSource::setFeature, "nativeSetFeature"),
             METHOD(&GeoJSONSource::setGeometry, "nativeSetGeometry"),
             METHOD(&GeoJSONSource::setURL, "nativeSetUrl"),
@@ -4,7 +4,7 @@
 #include <mbgl/style/sources/geojson_source.hpp>
 #include "../../geojson/geometry.hpp"
 #include "../../geojson/feature.hpp"
-#include "../../geojson/feature_collection.hpp"
+#include "../../geojson/feature_buffer.hpp"
 #include <jni/jni.hpp>
 
 namespace mbgl {
@@ -27,7 +27,8 @@ public:
 
     void setGeoJSONString(jni::JNIEnv&, jni::String);
 
-    void setFeatureCollection(jni::JNIEnv&, jni::Object<geojson::FeatureCollection>);
+    // Sets features that FeatureBuffer.java serialized.
+    void setFeatureBuffer(jni::JNIEnv&, jni::Object<java::nio::ByteBuffer>);
 
     void setFeature(jni::JNIEnv&, jni::Object<geojson::Feature>);
 
@@ -35,8 +36,8 @@ public:
 
     void setURL(jni::JNIEnv&, jni::String);
 
-    jni::Array<jni::Object<geojson::Feature>> querySourceFeatures(jni::JNIEnv&,
-                                                                  jni::Array<jni::Object<>> jfilter);
+    jni::Object<java::nio::ByteBuffer> querySourceFeatures(jni::JNIEnv&,
+                                                           jni::Array<jni::Object<>> jfilter);
 
     jni::jobject* createJavaPeer(jni::JNIEnv&);
 
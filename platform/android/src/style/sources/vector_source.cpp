@@ -7,7 +7,7 @@
 // C++ -> Java conversion
 #include "../../conversion/conversion.hpp"
 #include "../../conversion/collection.hpp"
-#include "../../geojson/conversion/feature.hpp"
+#include "../../geojson/feature_buffer.hpp"
 #include "../conversion/url_or_tileset.hpp"
 
 #include <mbgl/util/variant.hpp>
@@ -34,16 +34,16 @@ namespace android {
 
     VectorSource::~VectorSource() = default;
 
-    jni::Array<jni::Object<geojson::Feature>> VectorSource::querySourceFeatures(jni::JNIEnv& env,
-                                                                             jni::Array<jni::String> jSourceLayerIds,
-                                                                             jni::Array<jni::Object<>> jfilter) {
+    jni::Object<java::nio::ByteBuffer> VectorSource::querySourceFeatures(jni::JNIEnv& env,
+                                                                      jni::Array<jni::String> jSourceLayerIds,
+                                                                      jni::Array<jni::Object<>> jfilter) {
         using namespace mbgl::android::conversion;
         using namespace mbgl::android::geojson;
 
         mbgl::optional<std::vector<std::string>> sourceLayerIds = { toVector(env, jSourceLayerIds) };
         auto filter = toFilter(env, jfilter);
         auto features = source.querySourceFeatures({ sourceLayerIds,  filter });
-        return *convert<jni::Array<jni::Object<Feature>>, std::vector<mbgl::Feature>>(env, features);
+        return FeatureBuffer::toJava(env, features);
     }
 
     jni::Class<VectorSource> VectorSource::javaClass;
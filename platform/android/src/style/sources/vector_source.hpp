@@ -2,7 +2,7 @@
 
 #include "source.hpp"
 #include <mbgl/style/sources/vector_source.hpp>
-#include "../../geojson/feature.hpp"
+#include "../../geojson/feature_buffer.hpp"
 #include <jni/jni.hpp>
 
 namespace mbgl {
@@ -23,8 +23,8 @@ public:
 
     ~VectorSource();
 
-    jni::Array<jni::Object<geojson::Feature>> querySourceFeatures(jni::JNIEnv&, jni::Array<jni::String>,
-                                                                  jni::Array<jni::Object<>> jfilter);
+    jni::Object<java::nio::ByteBuffer> querySourceFeatures(jni::JNIEnv&, jni::Array<jni::String>,
+                                                           jni::Array<jni::Object<>> jfilter);
 
     jni::jobject* createJavaPeer(jni::JNIEnv&);
 
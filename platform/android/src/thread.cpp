@@ -1,6 +1,13 @@
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/platform.hpp>
+#include <mbgl/util/string.hpp>
 
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <sched.h>
 #include <sys/prctl.h>
 #include <sys/resource.h>
 
@@ -33,5 +40,49 @@ void makeThreadLowPriority() {
     setpriority(PRIO_PROCESS, 0, 19);
 }
 
+namespace {
+
+// The maximum frequency of each core, or zero where the kernel doesn't tell. The cores of
+// big.LITTLE designs differ in their maximum frequency.
+const std::vector<unsigned long>& coreFrequencies() {
+    static const std::vector<unsigned long> frequencies = [] {
+        std::vector<unsigned long> result(std::max(1u, std::thread::hardware_concurrency()), 0);
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            std::ifstream file("/sys/devices/system/cpu/cpu" + util::toString(i) + "/cpufreq/cpuinfo_max_freq");
+            file >> result[i];
+        }
+        return result;
+    }();
+    return frequencies;
+}
+
+} // namespace
+
+std::size_t getPerformanceCoreCount() {
+    const auto& frequencies = coreFrequencies();
+    const unsigned long fastest = *std::max_element(frequencies.begin(), frequencies.end());
+    return std::count(frequencies.begin(), frequencies.end(), fastest);
+}
+
+void setCurrentThreadPlacement(ThreadPlacement placement) {
+    const auto& frequencies = coreFrequencies();
+    const unsigned long fastest = *std::max_element(frequencies.begin(), frequencies.end());
+    const unsigned long slowest = *std::min_element(frequencies.begin(), frequencies.end());
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (std::size_t i = 0; i < frequencies.size() && i < CPU_SETSIZE; ++i) {
+        if (placement == ThreadPlacement::Any ||
+            (placement == ThreadPlacement::Performance && frequencies[i] == fastest) ||
+            (placement == ThreadPlacement::Efficiency && frequencies[i] == slowest)) {
+            CPU_SET(i, &set);
+        }
+    }
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        Log::Warning(Event::General, "Couldn't set thread affinity");
+    }
+}
+
 } // namespace platform
 } // namespace mbgl
@@ -19,6 +19,15 @@
 
 namespace mbgl {
 
+// Wraps the bytes of the NSData object, which keeps them alive, without copying them.
+static std::shared_ptr<const Buffer> bufferFromData(NSData* data) {
+    if (!data) {
+        return std::make_shared<Buffer>(std::string());
+    }
+    std::shared_ptr<const void> owner(CFBridgingRetain(data), CFRelease);
+    return std::make_shared<Buffer>(static_cast<const char*>([data bytes]), [data length], std::move(owner));
+}
+
 // Data that is shared between the requesting thread and the thread running the completion handler.
 class HTTPRequestShared {
 public:
@@ -192,6 +201,10 @@ HTTPFileSource::HTTPFileSource()
 
 HTTPFileSource::~HTTPFileSource() = default;
 
+void HTTPFileSource::preconnect(const std::string&) {
+    // NSURLSession pools connections, and multiplexes requests over HTTP/2, on its own.
+}
+
 uint32_t HTTPFileSource::maximumConcurrentRequests() {
     return 20;
 }
@@ -232,8 +245,7 @@ std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource,
 
                 if (error) {
                     if (data) {
-                        response.data =
-                            std::make_shared<std::string>((const char*)[data bytes], [data length]);
+                        response.data = bufferFromData(data);
                     }
 
                     switch ([error code]) {
@@ -285,7 +297,7 @@ std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource,
                     }
 
                     if (responseCode == 200) {
-                        response.data = std::make_shared<std::string>((const char *)[data bytes], [data length]);
+                        response.data = bufferFromData(data);
                     } else if (responseCode == 204 || (responseCode == 404 && resource.kind == Resource::Kind::Tile)) {
                         response.noContent = true;
                     } else if (responseCode == 304) {
@@ -1,4 +1,5 @@
 #include <mbgl/util/image+MGLAdditions.hpp>
+#include <mbgl/util/premultiply.hpp>
 
 #import <ImageIO/ImageIO.h>
 
@@ -83,10 +84,9 @@ mbgl::PremultipliedImage MGLPremultipliedImageFromCGImage(CGImageRef src) {
 
 namespace mbgl {
 
-PremultipliedImage decodeImage(const std::string& source) {
+PremultipliedImage decodeImage(const uint8_t* source, std::size_t size) {
     CFDataHandle data(CFDataCreateWithBytesNoCopy(
-        kCFAllocatorDefault, reinterpret_cast<const unsigned char*>(source.data()), source.size(),
-        kCFAllocatorNull));
+        kCFAllocatorDefault, source, size, kCFAllocatorNull));
     if (!data) {
         throw std::runtime_error("CFDataCreateWithBytesNoCopy failed");
     }
@@ -104,4 +104,9 @@ PremultipliedImage decodeImage(const std::string& source) {
     return MGLPremultipliedImageFromCGImage(*image);
 }
 
+UnassociatedImage decodeUnassociatedImage(const uint8_t* source, std::size_t size) {
+    // Core Graphics only draws into premultiplied bitmaps.
+    return util::unpremultiply(decodeImage(source, size));
+}
+
 } // namespace mbgl
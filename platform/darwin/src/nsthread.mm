@@ -3,6 +3,8 @@
 #include <mbgl/util/platform.hpp>
 
 #include <pthread.h>
+#include <sys/qos.h>
+#include <sys/sysctl.h>
 
 namespace mbgl {
 namespace platform {
@@ -22,5 +24,26 @@ void makeThreadLowPriority() {
     [[NSThread currentThread] setThreadPriority:0.0];
 }
 
+std::size_t getPerformanceCoreCount() {
+    // Level 0 is the performance cores of Apple silicon. Older OS versions don't report levels.
+    int count = 0;
+    size_t size = sizeof(count);
+    if (sysctlbyname("hw.perflevel0.logicalcpu", &count, &size, nullptr, 0) == 0 && count > 0) {
+        return count;
+    }
+    return [[NSProcessInfo processInfo] activeProcessorCount];
+}
+
+void setCurrentThreadPlacement(ThreadPlacement placement) {
+    // Darwin doesn't let threads pick their cores, but places them by their quality of service.
+    qos_class_t qos = QOS_CLASS_DEFAULT;
+    if (placement == ThreadPlacement::Performance) {
+        qos = QOS_CLASS_USER_INTERACTIVE;
+    } else if (placement == ThreadPlacement::Efficiency) {
+        qos = QOS_CLASS_UTILITY;
+    }
+    pthread_set_qos_class_self_np(qos, 0);
+}
+
 }
 }
@@ -36,7 +36,7 @@ RunLoop::~RunLoop() {
 }
 
 void RunLoop::push(std::shared_ptr<WorkTask> task) {
-    withMutex([&] { queue.push(std::move(task)); });
+    queue.push(std::move(task));
     impl->async->send();
 }
 
@@ -0,0 +1,71 @@
+#include <mbgl/storage/archive_file_source.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/storage/tile_archive.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/url.hpp>
+
+#include <unordered_map>
+
+namespace {
+
+const char* protocol = "archive://";
+const std::size_t protocolLength = 10;
+
+} // namespace
+
+namespace mbgl {
+
+class ArchiveFileSource::Impl {
+public:
+    void request(const Resource& resource, FileSource::Callback callback) {
+        Response response;
+
+        try {
+            if (!resource.tileData) {
+                throw std::runtime_error("Archives only contain tiles");
+            }
+
+            const auto& tileData = *resource.tileData;
+            const std::string& urlTemplate = tileData.urlTemplate;
+            const auto end = urlTemplate.find("/{", protocolLength);
+            const auto path = util::percentDecode(urlTemplate.substr(protocolLength, end - protocolLength));
+
+            auto it = archives.find(path);
+            if (it == archives.end()) {
+                it = archives.emplace(path, TileArchive::open(path)).first;
+            }
+
+            response.data = it->second->get({ uint8_t(tileData.z), uint32_t(tileData.x), uint32_t(tileData.y) });
+            if (!response.data) {
+                response.noContent = true;
+            }
+        } catch (...) {
+            response.error = std::make_unique<Response::Error>(
+                Response::Error::Reason::Other,
+                util::toString(std::current_exception()));
+        }
+
+        callback(response);
+    }
+
+private:
+    std::unordered_map<std::string, std::unique_ptr<TileArchive>> archives;
+};
+
+ArchiveFileSource::ArchiveFileSource()
+    : thread(std::make_unique<util::Thread<Impl>>(util::ThreadContext{"ArchiveFileSource", util::ThreadPriority::Low})) {
+}
+
+ArchiveFileSource::~ArchiveFileSource() = default;
+
+std::unique_ptr<AsyncRequest> ArchiveFileSource::request(const Resource& resource, Callback callback) {
+    return thread->invokeWithCallback(&Impl::request, resource, callback);
+}
+
+bool ArchiveFileSource::acceptsURL(const std::string& url) {
+    return url.compare(0, protocolLength, protocol) == 0;
+}
+
+} // namespace mbgl
@@ -4,12 +4,20 @@
 #include <mbgl/util/thread.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/util.hpp>
-#include <mbgl/util/io.hpp>
+#include <mbgl/util/mapped_file.hpp>
 
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+namespace {
+
+// Files are mapped rather than read, so the threads mostly wait for page faults, which they can
+// do side by side.
+const std::size_t threadCount = 3;
+
+} // namespace
+
 namespace mbgl {
 
 class AssetFileSource::Impl {
@@ -40,7 +48,7 @@ public:
             response.error = std::make_unique<Response::Error>(Response::Error::Reason::NotFound);
         } else {
             try {
-                response.data = std::make_shared<std::string>(util::read_file(path));
+                response.data = MappedFile::read(path);
             } catch (...) {
                 response.error = std::make_unique<Response::Error>(
                     Response::Error::Reason::Other,
@@ -55,16 +63,18 @@ private:
     std::string root;
 };
 
-AssetFileSource::AssetFileSource(const std::string& root)
-    : thread(std::make_unique<util::Thread<Impl>>(
-        util::ThreadContext{"AssetFileSource", util::ThreadPriority::Low},
-        root)) {
+AssetFileSource::AssetFileSource(const std::string& root) {
+    for (std::size_t i = 0; i < threadCount; i++) {
+        threads.push_back(std::make_unique<util::Thread<Impl>>(
+            util::ThreadContext{"AssetFileSource", util::ThreadPriority::Low},
+            root));
+    }
 }
 
 AssetFileSource::~AssetFileSource() = default;
 
 std::unique_ptr<AsyncRequest> AssetFileSource::request(const Resource& resource, Callback callback) {
-    return thread->invokeWithCallback(&Impl::request, resource.url, callback);
+    return threads[nextThread++ % threads.size()]->invokeWithCallback(&Impl::request, resource.url, callback);
 }
 
 } // namespace mbgl
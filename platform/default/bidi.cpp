@@ -1,22 +1,70 @@
 #include <mbgl/text/bidi.hpp>
+#include <mbgl/util/thread_local.hpp>
 #include <mbgl/util/traits.hpp>
 
 #include <unicode/ubidi.h>
 #include <unicode/ushape.h>
 
+#include <algorithm>
 #include <memory>
 
 namespace mbgl {
 
-class BiDiImpl {
-public:
-    BiDiImpl() : bidiText(ubidi_open()), bidiLine(ubidi_open()) {
+namespace {
+
+// The ICU objects of a thread, which all BiDi objects on it share. They keep the buffers that
+// they grew for the longest text so far, rather than each symbol layout opening its own.
+struct Contexts {
+    Contexts() : text(ubidi_open()), line(ubidi_open()) {
+    }
+    ~Contexts() {
+        ubidi_close(text);
+        ubidi_close(line);
+    }
+
+    UBiDi* const text;
+    UBiDi* const line;
+};
+
+util::ThreadLocal<Contexts>& contexts = *new util::ThreadLocal<Contexts>;
+
+Contexts& localContexts() {
+    Contexts* local = contexts.get();
+    if (!local) {
+        local = new Contexts;
+        contexts.set(local);
     }
-    ~BiDiImpl() {
-        ubidi_close(bidiText);
-        ubidi_close(bidiLine);
+    return *local;
+}
+
+// Whether the bidirectional algorithm or Arabic shaping could change the text: that is, whether
+// it has right-to-left or Arabic characters, BiDi controls, or paragraph separators, which end
+// lines of their own. Most labels have none of them, and skip ICU altogether.
+bool needsBiDi(const std::u16string& text) {
+    for (char16_t c : text) {
+        if (c < 0x0590) {
+            if (c == 0x000A || c == 0x000D || (c >= 0x001C && c <= 0x001E) || c == 0x0085) {
+                return true;
+            }
+        } else if (c <= 0x08FF ||                    // Hebrew through Arabic Extended-A
+                   c == 0x200E || c == 0x200F ||     // LRM and RLM
+                   (c >= 0x202A && c <= 0x202E) ||   // Embeddings and overrides
+                   (c >= 0x2066 && c <= 0x2069) ||   // Isolates
+                   c == 0x2029 ||                    // Paragraph separator
+                   (c >= 0xD802 && c <= 0xD803) ||   // Right-to-left scripts of U+10800 to U+10FFF
+                   (c >= 0xD83A && c <= 0xD83B) ||   // Right-to-left scripts of U+1E800 to U+1EFFF
+                   (c >= 0xFB1D && c <= 0xFDFF) ||   // Hebrew and Arabic presentation forms
+                   (c >= 0xFE70 && c <= 0xFEFE)) {   // Arabic presentation forms
+            return true;
+        }
     }
+    return false;
+}
+
+} // namespace
 
+class BiDiImpl {
+public:
     UBiDi* bidiText = nullptr;
     UBiDi* bidiLine = nullptr;
 };
@@ -27,6 +75,10 @@ BiDi::~BiDi() = default;
 // Takes UTF16 input in logical order and applies Arabic shaping to the input while maintaining
 // logical order. Output won't be intelligible until the bidirectional algorithm is applied
 std::u16string applyArabicShaping(const std::u16string& input) {
+    if (!needsBiDi(input)) {
+        return input;
+    }
+
     UErrorCode errorCode = U_ZERO_ERROR;
 
     const int32_t outputLength =
@@ -52,7 +104,7 @@ std::u16string applyArabicShaping(const std::u16string& input) {
     return outputText;
 }
 
-void BiDi::mergeParagraphLineBreaks(std::set<size_t>& lineBreakPoints) {
+void BiDi::mergeParagraphLineBreaks(std::vector<std::size_t>& lineBreakPoints) {
     int32_t paragraphCount = ubidi_countParagraphs(impl->bidiText);
     for (int32_t i = 0; i < paragraphCount; i++) {
         UErrorCode errorCode = U_ZERO_ERROR;
@@ -64,11 +116,14 @@ void BiDi::mergeParagraphLineBreaks(std::set<size_t>& lineBreakPoints) {
                                      u_errorName(errorCode));
         }
 
-        lineBreakPoints.insert(static_cast<std::size_t>(paragraphEndIndex));
+        lineBreakPoints.push_back(static_cast<std::size_t>(paragraphEndIndex));
     }
+
+    std::sort(lineBreakPoints.begin(), lineBreakPoints.end());
+    lineBreakPoints.erase(std::unique(lineBreakPoints.begin(), lineBreakPoints.end()), lineBreakPoints.end());
 }
 
-std::vector<std::u16string> BiDi::applyLineBreaking(std::set<std::size_t> lineBreakPoints) {
+std::vector<std::u16string> BiDi::applyLineBreaking(std::vector<std::size_t> lineBreakPoints) {
     // BiDi::getLine will error if called across a paragraph boundary, so we need to ensure that all
     // paragraph boundaries are included in the set of line break points. The calling code might not
     // include the line break because it didn't need to wrap at that point, or because the text was
@@ -88,7 +143,29 @@ std::vector<std::u16string> BiDi::applyLineBreaking(std::set<std::size_t> lineBr
 }
 
 std::vector<std::u16string> BiDi::processText(const std::u16string& input,
-                                              std::set<std::size_t> lineBreakPoints) {
+                                              std::vector<std::size_t> lineBreakPoints) {
+    // ICU makes no paragraph of an empty text, so that's left to it.
+    if (!input.empty() && !needsBiDi(input)) {
+        // Text that is left-to-right throughout is displayed in logical order, and is one
+        // paragraph that ends with the text.
+        lineBreakPoints.push_back(input.size());
+        std::sort(lineBreakPoints.begin(), lineBreakPoints.end());
+        lineBreakPoints.erase(std::unique(lineBreakPoints.begin(), lineBreakPoints.end()), lineBreakPoints.end());
+
+        std::vector<std::u16string> lines;
+        lines.reserve(lineBreakPoints.size());
+        std::size_t start = 0;
+        for (std::size_t lineBreakPoint : lineBreakPoints) {
+            lines.push_back(input.substr(start, lineBreakPoint - start));
+            start = lineBreakPoint;
+        }
+        return lines;
+    }
+
+    Contexts& local = localContexts();
+    impl->bidiText = local.text;
+    impl->bidiLine = local.line;
+
     UErrorCode errorCode = U_ZERO_ERROR;
 
     ubidi_setPara(impl->bidiText, mbgl::utf16char_cast<const UChar*>(input.c_str()), static_cast<int32_t>(input.size()),
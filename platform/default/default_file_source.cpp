@@ -1,16 +1,28 @@
 #include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/archive_file_source.hpp>
 #include <mbgl/storage/asset_file_source.hpp>
 #include <mbgl/storage/local_file_source.hpp>
 #include <mbgl/storage/online_file_source.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/offline_download.hpp>
+#include <mbgl/storage/response_cache.hpp>
+
+#include "sqlite3.hpp"
 
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/timer.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/work_request.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace {
 
@@ -20,14 +32,182 @@ bool isAssetURL(const std::string& url) {
     return std::equal(assetProtocol.begin(), assetProtocol.end(), url.begin());
 }
 
+// The number of threads that look up requested resources in the cache at the same time.
+const std::size_t cacheReaderCount = 2;
+
+// Writes to the cache are made in one transaction once this many are pending, or once the
+// oldest of them has waited this long.
+const std::size_t cacheWriteBatchSize = 64;
+const mbgl::Duration cacheWriteBatchDelay = mbgl::Milliseconds(500);
+
+// The cache is trimmed a batch at a time once no writes have been made for this long, and the
+// thread is yielded to other requests between batches.
+const mbgl::Duration cacheTrimDelay = mbgl::Seconds(1);
+const mbgl::Duration cacheTrimInterval = mbgl::Milliseconds(50);
+
+// Stale resources served from the cache are revalidated in the background, at most this many
+// per interval, so that a viewport whose cache expired at once doesn't hold up the tiles it is
+// missing.
+const std::size_t revalidationBatchSize = 4;
+const mbgl::Duration revalidationInterval = mbgl::Milliseconds(100);
+
 } // namespace
 
 namespace mbgl {
 
+namespace {
+
+// Requests that are made for the same resource while one is waiting for its first response share
+// it; see DefaultFileSource::Impl::request(). Those that revalidate a response they already have
+// only share with requests that have the same one.
+std::string sharedRequestKey(const Resource& resource) {
+    std::string key = util::toString(int(resource.kind)) + (resource.necessity ? (resource.reportCacheMiss ? " rm " : " r ") : " o ") + resource.url;
+    if (resource.tileData) {
+        key += '\n' + resource.tileData->urlTemplate + ' ' + util::toString(int(resource.tileData->pixelRatio)) +
+               ' ' + util::toString(int(resource.tileData->z)) + '/' + util::toString(resource.tileData->x) +
+               '/' + util::toString(resource.tileData->y);
+    }
+    key += '\n';
+    if (resource.priorModified) {
+        key += util::toString(resource.priorModified->time_since_epoch().count());
+    }
+    key += '\n';
+    if (resource.priorExpires) {
+        key += util::toString(resource.priorExpires->time_since_epoch().count());
+    }
+    key += '\n';
+    if (resource.priorEtag) {
+        key += *resource.priorEtag;
+    }
+    return key;
+}
+
+// Looks up resources in the cache through a read-only connection of its own, so that lookups
+// run alongside each other and don't wait for writes to the database.
+class CacheReader {
+public:
+    CacheReader(const std::string& cachePath)
+        : database(cachePath, util::DEFAULT_MAX_CACHE_SIZE, OfflineDatabase::Mode::ReadOnly) {
+    }
+
+    void get(const Resource& resource, std::function<void (optional<Response>)> callback) {
+        callback(database.get(resource));
+    }
+
+private:
+    OfflineDatabase database;
+};
+
+// Stores responses in the cache and updates the access times of cache hits behind the requests
+// they belong to, grouping them into transactions so that the disk is synced once per batch
+// rather than once per resource. Evicts from the cache in the pauses between them.
+class CacheWriter {
+public:
+    CacheWriter(const std::string& cachePath, uint64_t maximumCacheSize, OfflineDatabase::Journal journal)
+        : database(cachePath, maximumCacheSize, OfflineDatabase::Mode::ReadWrite, journal) {
+    }
+
+    ~CacheWriter() {
+        flush();
+    }
+
+    void put(const Resource& resource, const Response& response) {
+        add({ resource, response });
+    }
+
+    void markAccessed(const Resource& resource) {
+        add({ resource, {} });
+    }
+
+    void setTileCompression(OfflineDatabase::TileCompression compression) {
+        database.setTileCompression(compression);
+    }
+
+    // Evicts from the cache while it's idle, so that puts rarely evict on their own, and returns
+    // the pages that deleted regions freed.
+    void trim() {
+        if (!pending.empty()) {
+            // The flush of the pending writes starts it again.
+            return;
+        }
+
+        bool more = false;
+        try {
+            more = database.trimAmbientCache();
+        } catch (...) {
+            Log::Error(Event::Database, "Unable to trim the cache: %s", util::toString(std::current_exception()).c_str());
+        }
+        if (more) {
+            trimTimer.start(cacheTrimInterval, Duration::zero(), [this] { trim(); });
+        }
+    }
+
+private:
+    struct Write {
+        Resource resource;
+        // Absent for access time updates.
+        optional<Response> response;
+    };
+
+    void add(Write write) {
+        pending.push_back(std::move(write));
+        if (pending.size() >= cacheWriteBatchSize) {
+            flush();
+        } else if (pending.size() == 1) {
+            timer.start(cacheWriteBatchDelay, Duration::zero(), [this] { flush(); });
+        }
+    }
+
+    void flush() {
+        timer.stop();
+        if (pending.empty()) {
+            return;
+        }
+        trimTimer.start(cacheTrimDelay, Duration::zero(), [this] { trim(); });
+
+        std::vector<Write> writes;
+        writes.swap(pending);
+
+        // Each put evicts what it needs within the transaction, and sees the pages taken by the
+        // puts before it, so the batch as a whole stays within the maximum cache size.
+        try {
+            database.batch([&] {
+                for (const auto& write : writes) {
+                    if (write.response) {
+                        database.put(write.resource, *write.response);
+                    } else {
+                        database.markAccessed(write.resource);
+                    }
+                }
+            });
+        } catch (...) {
+            // The resources are requested from the network again if they're needed.
+            Log::Error(Event::Database, "Unable to write to the cache: %s", util::toString(std::current_exception()).c_str());
+        }
+    }
+
+    OfflineDatabase database;
+    std::vector<Write> pending;
+    util::Timer timer;
+    util::Timer trimTimer;
+};
+
+} // namespace
+
 class DefaultFileSource::Impl {
 public:
-    Impl(const std::string& cachePath, uint64_t maximumCacheSize)
-        : offlineDatabase(cachePath, maximumCacheSize) {
+    Impl(const std::string& cachePath, uint64_t maximumCacheSize, OfflineDatabase::Journal journal)
+        : offlineDatabase(cachePath, maximumCacheSize, OfflineDatabase::Mode::ReadWrite, journal) {
+        // Each connection to an in-memory database opens a database of its own, so it can only
+        // be used through offlineDatabase.
+        if (cachePath != ":memory:") {
+            for (std::size_t i = 0; i < cacheReaderCount; i++) {
+                readers.push_back(std::make_unique<util::Thread<CacheReader>>(
+                    util::ThreadContext{"DefaultFileSource/Read", util::ThreadPriority::Low}, cachePath));
+            }
+            writer = std::make_unique<util::Thread<CacheWriter>>(
+                util::ThreadContext{"DefaultFileSource/Write", util::ThreadPriority::Low}, cachePath, maximumCacheSize, journal);
+        }
     }
 
     void setAPIBaseURL(const std::string& url) {
@@ -50,6 +230,10 @@ public:
         onlineFileSource.setResourceTransform(std::move(transform));
     }
 
+    void preconnect(const std::string& url) {
+        onlineFileSource.preconnect(url);
+    }
+
     void listRegions(std::function<void (std::exception_ptr, optional<std::vector<OfflineRegion>>)> callback) {
         try {
             callback({}, offlineDatabase.listRegions());
@@ -90,12 +274,32 @@ public:
         try {
             downloads.erase(region.getID());
             offlineDatabase.deleteRegion(std::move(region));
+            if (writer) {
+                writer->invoke(&CacheWriter::trim);
+            }
             callback({});
         } catch (...) {
             callback(std::current_exception());
         }
     }
 
+    void exportRegion(int64_t regionID, const std::string& path, std::function<void (std::exception_ptr)> callback) {
+        try {
+            offlineDatabase.exportRegion(regionID, path);
+            callback({});
+        } catch (...) {
+            callback(std::current_exception());
+        }
+    }
+
+    void importRegion(const std::string& path, std::function<void (std::exception_ptr, optional<OfflineRegion>)> callback) {
+        try {
+            callback({}, offlineDatabase.importRegion(path));
+        } catch (...) {
+            callback(std::current_exception(), {});
+        }
+    }
+
     void setRegionObserver(int64_t regionID, std::unique_ptr<OfflineRegionObserver> observer) {
         getDownload(regionID).setObserver(std::move(observer));
     }
@@ -105,50 +309,274 @@ public:
     }
 
     void request(AsyncRequest* req, Resource resource, Callback callback) {
-        Resource revalidation = resource;
+        std::string key = sharedRequestKey(resource);
+        auto it = pendingSharedRequests.find(key);
+        if (it != pendingSharedRequests.end()) {
+            subscribe(req, it->second, resource.priority, std::move(callback));
+            return;
+        }
 
-        const bool hasPrior = resource.priorEtag || resource.priorModified || resource.priorExpires;
-        if (!hasPrior || resource.necessity == Resource::Optional) {
-            auto offlineResponse = offlineDatabase.get(resource);
-
-            if (resource.necessity == Resource::Optional && !offlineResponse) {
-                // Ensure there's always a response that we can send, so the caller knows that
-                // there's no optional data available in the cache.
-                offlineResponse.emplace();
-                offlineResponse->noContent = true;
-                offlineResponse->error = std::make_unique<Response::Error>(
-                    Response::Error::Reason::NotFound, "Not found in offline database");
+        auto shared = std::make_shared<SharedRequest>();
+        shared->key = std::move(key);
+        pendingSharedRequests.emplace(*shared->key, shared);
+        subscribe(req, shared, resource.priority, std::move(callback));
+
+        SharedRequest* sharedRequest = shared.get();
+        startRequest(sharedRequest, std::move(resource), [this, sharedRequest] (Response response) {
+            // Requests made from now on start over, and may be answered by the cache.
+            if (sharedRequest->key) {
+                this->pendingSharedRequests.erase(*sharedRequest->key);
+                sharedRequest->key = {};
             }
+            for (const auto& subscriber : sharedRequest->subscribers) {
+                subscriber.second.callback(response);
+            }
+        });
+    }
+
+    void cancel(AsyncRequest* req) {
+        auto it = subscriptions.find(req);
+        if (it == subscriptions.end()) {
+            return;
+        }
+        std::shared_ptr<SharedRequest> shared = std::move(it->second);
+        subscriptions.erase(it);
+        shared->subscribers.erase(req);
 
+        if (!shared->subscribers.empty()) {
+            updatePriority(*shared);
+            return;
+        }
+        if (shared->key) {
+            pendingSharedRequests.erase(*shared->key);
+        }
+        tasks.erase(shared.get());
+        priorities.erase(shared.get());
+        revalidations.erase(shared.get());
+        backgroundRequests.erase(shared.get());
+    }
+
+    void setPriority(AsyncRequest* req, int32_t priority) {
+        auto it = subscriptions.find(req);
+        if (it != subscriptions.end()) {
+            it->second->subscribers.at(req).priority = priority;
+            updatePriority(*it->second);
+        }
+    }
+
+    // Reads the resource from the cache, and requests it from the network if it's required and
+    // missing or stale there.
+    void startRequest(AsyncRequest* req, Resource resource, Callback callback) {
+        const bool hasPrior = resource.priorEtag || resource.priorModified || resource.priorExpires;
+        if (hasPrior && resource.necessity != Resource::Optional) {
+            requestOnline(req, std::move(resource), std::move(callback));
+        } else if (optional<Response> heldResponse = responseCache.get(resource)) {
+            if (writer) {
+                writer->invoke(&CacheWriter::markAccessed, resource);
+            }
+            respond(req, resource, std::move(heldResponse), callback);
+        } else if (readers.empty()) {
+            optional<Response> offlineResponse = offlineDatabase.get(resource);
             if (offlineResponse) {
-                revalidation.priorModified = offlineResponse->modified;
-                revalidation.priorExpires = offlineResponse->expires;
-                revalidation.priorEtag = offlineResponse->etag;
-                callback(*offlineResponse);
+                responseCache.put(resource, *offlineResponse);
             }
+            respond(req, resource, std::move(offlineResponse), callback);
+        } else {
+            // Readers don't update access times so that they don't write; the writer does.
+            auto& reader = *readers[nextReader++ % readers.size()];
+            tasks[req] = reader.invokeWithCallback(&CacheReader::get, resource,
+                                                   [=] (optional<Response> offlineResponse) {
+                if (offlineResponse) {
+                    this->responseCache.put(resource, *offlineResponse);
+                    this->writer->invoke(&CacheWriter::markAccessed, resource);
+                }
+                this->respond(req, resource, std::move(offlineResponse), callback);
+            });
+        }
+    }
+
+    void respond(AsyncRequest* req, const Resource& resource, optional<Response> offlineResponse, const Callback& callback) {
+        Resource revalidation = resource;
+
+        if ((resource.necessity == Resource::Optional || resource.reportCacheMiss) && !offlineResponse) {
+            // Ensure there's always a response that we can send, so the caller knows that
+            // there's no data available in the cache.
+            offlineResponse.emplace();
+            offlineResponse->noContent = true;
+            offlineResponse->error = std::make_unique<Response::Error>(
+                Response::Error::Reason::NotFound, "Not found in offline database");
         }
 
-        if (resource.necessity == Resource::Required) {
-            tasks[req] = onlineFileSource.request(revalidation, [=] (Response onlineResponse) {
-                this->offlineDatabase.put(revalidation, onlineResponse);
-                callback(onlineResponse);
-            });
+        bool stale = false;
+        if (offlineResponse) {
+            revalidation.priorModified = offlineResponse->modified;
+            revalidation.priorExpires = offlineResponse->expires;
+            revalidation.priorEtag = offlineResponse->etag;
+            // Responses without an expiration date are revalidated right away, like expired ones.
+            stale = !offlineResponse->error &&
+                    (!offlineResponse->expires || *offlineResponse->expires <= util::now());
+            callback(*offlineResponse);
+        }
+
+        if (resource.necessity != Resource::Required) {
+            tasks.erase(req);
+        } else if (stale) {
+            // The cached response is in use already, so revalidating it can wait for the
+            // requests of resources that aren't available at all.
+            tasks.erase(req);
+            revalidate(req, std::move(revalidation), callback);
+        } else {
+            requestOnline(req, std::move(revalidation), callback);
         }
     }
 
-    void cancel(AsyncRequest* req) {
-        tasks.erase(req);
+    void revalidate(AsyncRequest* req, Resource resource, Callback callback) {
+        revalidations.erase(req);
+        revalidations.emplace(req, Revalidation { std::move(resource), std::move(callback) });
+        revalidationQueue.push_back(req);
+        if (!revalidating) {
+            revalidating = true;
+            revalidationTimer.start(Duration::zero(), revalidationInterval, [this] { startRevalidations(); });
+        }
+    }
+
+    void startRevalidations() {
+        std::size_t started = 0;
+        while (started < revalidationBatchSize && !revalidationQueue.empty()) {
+            AsyncRequest* req = revalidationQueue.front();
+            revalidationQueue.pop_front();
+
+            // Requests that were cancelled while they waited are no longer in the map.
+            auto it = revalidations.find(req);
+            if (it == revalidations.end()) {
+                continue;
+            }
+            Revalidation revalidation = std::move(it->second);
+            revalidations.erase(it);
+
+            // Kept behind the requests of the viewport even as its tile's priority changes.
+            priorities.erase(req);
+            backgroundRequests.insert(req);
+            revalidation.resource.priority = Resource::RevalidationPriority;
+            requestOnline(req, std::move(revalidation.resource), std::move(revalidation.callback));
+            started++;
+        }
+
+        if (revalidationQueue.empty()) {
+            revalidating = false;
+            revalidationTimer.stop();
+        }
+    }
+
+    void requestOnline(AsyncRequest* req, Resource resource, Callback callback) {
+        auto priority = priorities.find(req);
+        if (priority != priorities.end()) {
+            resource.priority = priority->second;
+        }
+
+        tasks[req] = onlineFileSource.request(resource, [=] (Response onlineResponse) {
+            this->responseCache.put(resource, onlineResponse);
+            if (this->writer) {
+                // Stored behind the response, which doesn't wait for the write.
+                this->writer->invoke(&CacheWriter::put, resource, onlineResponse);
+                callback(onlineResponse);
+                return;
+            }
+
+            const TimePoint start = Clock::now();
+            this->offlineDatabase.put(resource, onlineResponse);
+            if (onlineResponse.timing) {
+                auto timing = std::make_unique<Response::Timing>(*onlineResponse.timing);
+                timing->store = Clock::now() - start;
+                onlineResponse.timing = std::move(timing);
+            }
+            callback(onlineResponse);
+        });
     }
 
     void setOfflineMapboxTileCountLimit(uint64_t limit) {
         offlineDatabase.setOfflineMapboxTileCountLimit(limit);
     }
 
+    void setTileCompression(OfflineDatabase::TileCompression compression) {
+        offlineDatabase.setTileCompression(compression);
+        if (writer) {
+            writer->invoke(&CacheWriter::setTileCompression, compression);
+        }
+    }
+
+    void setResponseCacheSize(std::size_t size) {
+        responseCache.setMaximumBytes(size);
+    }
+
     void put(const Resource& resource, const Response& response) {
         offlineDatabase.put(resource, response);
+        responseCache.put(resource, response);
+    }
+
+    void pauseDatabaseThreads() {
+        for (auto& reader : readers) {
+            reader->pause();
+        }
+        if (writer) {
+            writer->pause();
+        }
+    }
+
+    void resumeDatabaseThreads() {
+        for (auto& reader : readers) {
+            reader->resume();
+        }
+        if (writer) {
+            writer->resume();
+        }
     }
 
 private:
+    // Requests made for the same resource at once share one of these, which reads the cache and
+    // fetches the resource once for all of them, and passes every response on to each. It keys
+    // the shared request in the maps of tasks, priorities and revalidations below.
+    struct Subscriber {
+        Callback callback;
+        int32_t priority;
+    };
+    class SharedRequest : public AsyncRequest {
+    public:
+        // Present until the first response, while other requests can still join.
+        optional<std::string> key;
+        std::unordered_map<AsyncRequest*, Subscriber> subscribers;
+    };
+
+    void subscribe(AsyncRequest* req, std::shared_ptr<SharedRequest> shared, int32_t priority, Callback callback) {
+        shared->subscribers.emplace(req, Subscriber { std::move(callback), priority });
+        if (shared->subscribers.size() > 1) {
+            updatePriority(*shared);
+        }
+        subscriptions.emplace(req, std::move(shared));
+    }
+
+    // A shared request goes as early as the most urgent of the requests that share it.
+    void updatePriority(SharedRequest& shared) {
+        int32_t priority = std::numeric_limits<int32_t>::min();
+        for (const auto& subscriber : shared.subscribers) {
+            priority = std::max(priority, subscriber.second.priority);
+        }
+        setSharedPriority(&shared, priority);
+    }
+
+    void setSharedPriority(AsyncRequest* req, int32_t priority) {
+        if (backgroundRequests.count(req)) {
+            return;
+        }
+        // Remembered for requests that are still reading the cache or waiting to be
+        // revalidated when they change.
+        priorities[req] = priority;
+        auto it = tasks.find(req);
+        if (it != tasks.end()) {
+            it->second->setPriority(priority);
+        }
+    }
+
     OfflineDownload& getDownload(int64_t regionID) {
         auto it = downloads.find(regionID);
         if (it != downloads.end()) {
@@ -158,19 +586,50 @@ private:
             std::make_unique<OfflineDownload>(regionID, offlineDatabase.getRegionDefinition(regionID), offlineDatabase, onlineFileSource)).first->second;
     }
 
+    // Serves offline regions, and the cache when it is kept in memory.
     OfflineDatabase offlineDatabase;
+
+    // Look up requested resources and store the responses to them in the cache on threads of
+    // their own, so that neither waits for the other or holds up network requests.
+    std::vector<std::unique_ptr<util::Thread<CacheReader>>> readers;
+    std::unique_ptr<util::Thread<CacheWriter>> writer;
+    std::size_t nextReader = 0;
+
+    // Answers the requests for resources that were read or stored recently without a lookup.
+    ResponseCache responseCache { util::DEFAULT_RESPONSE_CACHE_SIZE };
+
     OnlineFileSource onlineFileSource;
     std::unordered_map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
+    std::unordered_map<AsyncRequest*, int32_t> priorities;
+
+    // Stale cached resources waiting for their revalidation to start, in the order they were
+    // served in, and the requests whose revalidation has started.
+    struct Revalidation {
+        Resource resource;
+        Callback callback;
+    };
+    std::unordered_map<AsyncRequest*, Revalidation> revalidations;
+    std::deque<AsyncRequest*> revalidationQueue;
+    std::unordered_set<AsyncRequest*> backgroundRequests;
+    util::Timer revalidationTimer;
+    bool revalidating = false;
+
+    std::unordered_map<std::string, std::shared_ptr<SharedRequest>> pendingSharedRequests;
+    std::unordered_map<AsyncRequest*, std::shared_ptr<SharedRequest>> subscriptions;
+
     std::unordered_map<int64_t, std::unique_ptr<OfflineDownload>> downloads;
 };
 
 DefaultFileSource::DefaultFileSource(const std::string& cachePath,
                                      const std::string& assetRoot,
-                                     uint64_t maximumCacheSize)
+                                     uint64_t maximumCacheSize,
+                                     bool writeAheadLog)
     : thread(std::make_unique<util::Thread<Impl>>(util::ThreadContext{"DefaultFileSource", util::ThreadPriority::Low},
-            cachePath, maximumCacheSize)),
+            cachePath, maximumCacheSize,
+            writeAheadLog ? OfflineDatabase::Journal::WriteAhead : OfflineDatabase::Journal::Rollback)),
       assetFileSource(std::make_unique<AssetFileSource>(assetRoot)),
-      localFileSource(std::make_unique<LocalFileSource>()) {
+      localFileSource(std::make_unique<LocalFileSource>()),
+      archiveFileSource(std::make_unique<ArchiveFileSource>()) {
 }
 
 DefaultFileSource::~DefaultFileSource() = default;
@@ -202,6 +661,16 @@ void DefaultFileSource::setResourceTransform(std::function<std::string(Resource:
     });
 }
 
+void DefaultFileSource::preconnect(const std::string& url) {
+    if (!isAssetURL(url) && !LocalFileSource::acceptsURL(url) && !ArchiveFileSource::acceptsURL(url)) {
+        thread->invoke(&Impl::preconnect, url);
+    }
+}
+
+std::size_t DefaultFileSource::getMemoryUsage() const {
+    return mapbox::sqlite::memoryUsed();
+}
+
 std::unique_ptr<AsyncRequest> DefaultFileSource::request(const Resource& resource, Callback callback) {
     class DefaultFileRequest : public AsyncRequest {
     public:
@@ -214,6 +683,10 @@ std::unique_ptr<AsyncRequest> DefaultFileSource::request(const Resource& resourc
             thread.invoke(&DefaultFileSource::Impl::cancel, this);
         }
 
+        void setPriority(int32_t priority) override {
+            thread.invoke(&DefaultFileSource::Impl::setPriority, this, priority);
+        }
+
         util::Thread<DefaultFileSource::Impl>& thread;
         std::unique_ptr<AsyncRequest> workRequest;
     };
@@ -222,6 +695,8 @@ std::unique_ptr<AsyncRequest> DefaultFileSource::request(const Resource& resourc
         return assetFileSource->request(resource, callback);
     } else if (LocalFileSource::acceptsURL(resource.url)) {
         return localFileSource->request(resource, callback);
+    } else if (ArchiveFileSource::acceptsURL(resource.url)) {
+        return archiveFileSource->request(resource, callback);
     } else {
         return std::make_unique<DefaultFileRequest>(resource, callback, *thread);
     }
@@ -247,6 +722,14 @@ void DefaultFileSource::deleteOfflineRegion(OfflineRegion&& region, std::functio
     thread->invoke(&Impl::deleteRegion, std::move(region), callback);
 }
 
+void DefaultFileSource::exportOfflineRegion(OfflineRegion& region, const std::string& path, std::function<void (std::exception_ptr)> callback) const {
+    thread->invoke(&Impl::exportRegion, region.getID(), path, callback);
+}
+
+void DefaultFileSource::importOfflineRegion(const std::string& path, std::function<void (std::exception_ptr, optional<OfflineRegion>)> callback) {
+    thread->invoke(&Impl::importRegion, path, callback);
+}
+
 void DefaultFileSource::setOfflineRegionObserver(OfflineRegion& region, std::unique_ptr<OfflineRegionObserver> observer) {
     thread->invoke(&Impl::setRegionObserver, region.getID(), std::move(observer));
 }
@@ -263,12 +746,23 @@ void DefaultFileSource::setOfflineMapboxTileCountLimit(uint64_t limit) const {
     thread->invokeSync(&Impl::setOfflineMapboxTileCountLimit, limit);
 }
 
+void DefaultFileSource::setTileCompressionDictionaries(bool enabled) {
+    thread->invoke(&Impl::setTileCompression,
+                   enabled ? OfflineDatabase::TileCompression::Dictionary : OfflineDatabase::TileCompression::Zlib);
+}
+
+void DefaultFileSource::setResponseCacheSize(std::size_t size) {
+    thread->invoke(&Impl::setResponseCacheSize, size);
+}
+
 void DefaultFileSource::pause() {
+    thread->invokeSync(&Impl::pauseDatabaseThreads);
     thread->pause();
 }
 
 void DefaultFileSource::resume() {
     thread->resume();
+    thread->invokeSync(&Impl::resumeDatabaseThreads);
 }
 
 // For testing only:
@@ -10,14 +10,18 @@
 #include <mbgl/util/timer.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/http_header.hpp>
+#include <mbgl/util/url.hpp>
 
 #include <curl/curl.h>
 
+#include <algorithm>
 #include <queue>
 #include <map>
+#include <unordered_set>
 #include <cassert>
 #include <cstring>
 #include <cstdio>
+#include <cstdlib>
 
 static void handleError(CURLMcode code) {
     if (code != CURLM_OK) {
@@ -33,6 +37,13 @@ static void handleError(CURLcode code) {
 
 namespace mbgl {
 
+// The most that a Content-Length header makes a request reserve for its data up front.
+constexpr uint64_t maximumReservation = 64 * 1024 * 1024;
+
+// The most connections to open to a host that can't multiplex requests over HTTP/2; further
+// requests to it wait for one of them to become free.
+constexpr long maximumHostConnections = 20;
+
 class HTTPFileSource::Impl {
 public:
     Impl();
@@ -46,6 +57,10 @@ public:
     CURL *getHandle();
     void returnHandle(CURL *handle);
     void checkMultiInfo();
+    void preconnect(const std::string& url);
+
+    // Sets the options that requests and preconnections have in common.
+    void setCommonOptions(CURL *handle);
 
     // Used as the CURL timer function to periodically check for socket updates.
     util::Timer timeout;
@@ -54,12 +69,18 @@ public:
     // block and spawn threads.
     CURLM *multi = nullptr;
 
-    // CURL share handles are used for sharing session state (e.g.)
+    // CURL share handles are used for sharing session state: resolved host names, and TLS
+    // sessions so that new connections to a host can resume them instead of doing a full handshake.
     CURLSH *share = nullptr;
 
     // A queue that we use for storing resuable CURL easy handles to avoid creating and destroying
     // them all the time.
     std::queue<CURL *> handles;
+
+    // HEAD requests that open connections ahead of the requests that will reuse them, and the
+    // origins that they were made to.
+    std::unordered_set<CURL *> preconnections;
+    std::unordered_set<std::string> preconnectedOrigins;
 };
 
 class HTTPRequest : public AsyncRequest {
@@ -78,7 +99,7 @@ private:
     FileSource::Callback callback;
 
     // Will store the current response.
-    std::shared_ptr<std::string> data;
+    std::string data;
     std::unique_ptr<Response> response;
 
     optional<std::string> retryAfter;
@@ -95,16 +116,31 @@ HTTPFileSource::Impl::Impl() {
         throw std::runtime_error("Could not init cURL");
     }
 
+    // All handles are used on the same thread, so the share handle needs no locking.
     share = curl_share_init();
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
 
     multi = curl_multi_init();
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, handleSocket));
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, startTimeout));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this));
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | 0) // Added in 7.43.0
+    handleError(curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX));
+#endif
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (30) << 8 | 0) // Added in 7.30.0
+    handleError(curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, maximumHostConnections));
+#endif
 }
 
 HTTPFileSource::Impl::~Impl() {
+    for (auto handle : preconnections) {
+        curl_multi_remove_handle(multi, handle);
+        curl_easy_cleanup(handle);
+    }
+    preconnections.clear();
+
     while (!handles.empty()) {
         curl_easy_cleanup(handles.front());
         handles.pop();
@@ -141,6 +177,16 @@ void HTTPFileSource::Impl::checkMultiInfo() {
     while ((message = curl_multi_info_read(multi, &pending))) {
         switch (message->msg) {
         case CURLMSG_DONE: {
+            auto it = preconnections.find(message->easy_handle);
+            if (it != preconnections.end()) {
+                // The connection stays open for the requests that follow; the response doesn't
+                // matter.
+                handleError(curl_multi_remove_handle(multi, *it));
+                returnHandle(*it);
+                preconnections.erase(it);
+                break;
+            }
+
             HTTPRequest *baton = nullptr;
             curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, (char *)&baton);
             assert(baton);
@@ -170,6 +216,45 @@ void HTTPFileSource::Impl::perform(curl_socket_t s, util::RunLoop::Event events)
     checkMultiInfo();
 }
 
+void HTTPFileSource::Impl::setCommonOptions(CURL *handle) {
+    handleError(curl_easy_setopt(handle, CURLOPT_CAINFO, "ca-bundle.crt"));
+    handleError(curl_easy_setopt(handle, CURLOPT_USERAGENT, "MapboxGL/1.0"));
+    handleError(curl_easy_setopt(handle, CURLOPT_SHARE, share));
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (47) << 8 | 0) // Added in 7.47.0
+    // Negotiates HTTP/2 with hosts that support it, so that requests share a connection.
+    // Libraries built without HTTP/2 fail to set this, and stick to HTTP/1.1.
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | 0) // Added in 7.43.0
+    // Waits for a connection that is still being opened to a host, in case it turns out to be
+    // one that can be multiplexed, rather than opening another one right away.
+    handleError(curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L));
+#endif
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (25) << 8 | 0) // Added in 7.25.0
+    handleError(curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L));
+#endif
+}
+
+void HTTPFileSource::Impl::preconnect(const std::string& url) {
+    const util::URL parts(url);
+    const std::string scheme = url.substr(parts.scheme.first, parts.scheme.second);
+    if (scheme != "http" && scheme != "https") {
+        return;
+    }
+
+    const std::string origin = url.substr(0, parts.domain.first + parts.domain.second) + "/";
+    if (origin.find('{') != std::string::npos || !preconnectedOrigins.insert(origin).second) {
+        return;
+    }
+
+    CURL *handle = getHandle();
+    setCommonOptions(handle);
+    handleError(curl_easy_setopt(handle, CURLOPT_URL, origin.c_str()));
+    handleError(curl_easy_setopt(handle, CURLOPT_NOBODY, 1L));
+    handleError(curl_multi_add_handle(multi, handle));
+    preconnections.insert(handle);
+}
+
 int HTTPFileSource::Impl::handleSocket(CURL * /* handle */, curl_socket_t s, int action, void *userp,
                               void * /* socketp */) {
     assert(userp);
@@ -244,9 +329,9 @@ HTTPRequest::HTTPRequest(HTTPFileSource::Impl* context_, Resource resource_, Fil
         curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
     }
 
+    context->setCommonOptions(handle);
     handleError(curl_easy_setopt(handle, CURLOPT_PRIVATE, this));
     handleError(curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, error));
-    handleError(curl_easy_setopt(handle, CURLOPT_CAINFO, "ca-bundle.crt"));
     handleError(curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1));
     handleError(curl_easy_setopt(handle, CURLOPT_URL, resource.url.c_str()));
     handleError(curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeCallback));
@@ -258,8 +343,6 @@ HTTPRequest::HTTPRequest(HTTPFileSource::Impl* context_, Resource resource_, Fil
 #else
     handleError(curl_easy_setopt(handle, CURLOPT_ENCODING, "gzip, deflate"));
 #endif
-    handleError(curl_easy_setopt(handle, CURLOPT_USERAGENT, "MapboxGL/1.0"));
-    handleError(curl_easy_setopt(handle, CURLOPT_SHARE, context->share));
 
     // Start requesting the information.
     handleError(curl_multi_add_handle(context->multi, handle));
@@ -277,16 +360,12 @@ HTTPRequest::~HTTPRequest() {
 }
 
 // This function is called when we have new data for a request. We just append it to the string
-// containing the previous data.
+// containing the previous data, which has room for all of it once we know its length.
 size_t HTTPRequest::writeCallback(void *const contents, const size_t size, const size_t nmemb, void *userp) {
     assert(userp);
     auto impl = reinterpret_cast<HTTPRequest *>(userp);
 
-    if (!impl->data) {
-        impl->data = std::make_shared<std::string>();
-    }
-
-    impl->data->append((char *)contents, size * nmemb);
+    impl->data.append((char *)contents, size * nmemb);
     return size * nmemb;
 }
 
@@ -333,6 +412,10 @@ size_t HTTPRequest::headerCallback(char *const buffer, const size_t size, const
         baton->retryAfter = std::string(buffer + begin, length - begin - 2); // remove \r\n
     } else if ((begin = headerMatches("x-rate-limit-reset: ", buffer, length)) != std::string::npos) {
         baton->xRateLimitReset = std::string(buffer + begin, length - begin - 2); // remove \r\n
+    } else if ((begin = headerMatches("content-length: ", buffer, length)) != std::string::npos) {
+        // Only a hint: the length of a compressed body differs from that of the data.
+        const std::string value { buffer + begin, length - begin - 2 }; // remove \r\n
+        baton->data.reserve(std::min<uint64_t>(std::strtoull(value.c_str(), nullptr, 10), maximumReservation));
     }
 
     return length;
@@ -368,11 +451,8 @@ void HTTPRequest::handleResult(CURLcode code) {
         curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode);
 
         if (responseCode == 200) {
-            if (data) {
-                response->data = std::move(data);
-            } else {
-                response->data = std::make_shared<std::string>();
-            }
+            // Hands the string on without copying it.
+            response->data = std::make_shared<Buffer>(std::move(data));
         } else if (responseCode == 204 || (responseCode == 404 && resource.kind == Resource::Kind::Tile)) {
             response->noContent = true;
         } else if (responseCode == 304) {
@@ -411,7 +491,19 @@ std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource,
     return std::make_unique<HTTPRequest>(impl.get(), resource, callback);
 }
 
+void HTTPFileSource::preconnect(const std::string& url) {
+    impl->preconnect(url);
+}
+
 uint32_t HTTPFileSource::maximumConcurrentRequests() {
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | 0)
+    // With HTTP/2, requests to a host are streams of one connection, which servers commonly
+    // allow 100 of. Hosts that only speak HTTP/1.1 are held to maximumHostConnections.
+    static const bool multiplexing = curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2;
+    if (multiplexing) {
+        return 100;
+    }
+#endif
     return 20;
 }
 
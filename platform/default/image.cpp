@@ -5,16 +5,25 @@
 namespace mbgl {
 
 #if !defined(__ANDROID__) && !defined(__APPLE__)
-PremultipliedImage decodeWebP(const uint8_t*, size_t);
+UnassociatedImage decodeWebP(const uint8_t*, size_t);
 #endif // !defined(__ANDROID__) && !defined(__APPLE__)
 
-PremultipliedImage decodePNG(const uint8_t*, size_t);
-PremultipliedImage decodeJPEG(const uint8_t*, size_t);
+UnassociatedImage decodePNG(const uint8_t*, size_t);
+UnassociatedImage decodeJPEG(const uint8_t*, size_t);
 
-PremultipliedImage decodeImage(const std::string& string) {
-    const uint8_t* data = reinterpret_cast<const uint8_t*>(string.data());
-    const size_t size = string.size();
+namespace {
 
+bool isJPEG(const uint8_t* data, std::size_t size) {
+    if (size >= 2) {
+        uint16_t magic = ((data[0] << 8) | data[1]) & 0xffff;
+        return magic == 0xFFD8;
+    }
+    return false;
+}
+
+} // namespace
+
+UnassociatedImage decodeUnassociatedImage(const uint8_t* data, std::size_t size) {
 #if !defined(__ANDROID__) && !defined(__APPLE__)
     if (size >= 12) {
         uint32_t riff_magic = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
@@ -32,14 +41,21 @@ PremultipliedImage decodeImage(const std::string& string) {
         }
     }
 
-    if (size >= 2) {
-        uint16_t magic = ((data[0] << 8) | data[1]) & 0xffff;
-        if (magic == 0xFFD8) {
-            return decodeJPEG(data, size);
-        }
+    if (isJPEG(data, size)) {
+        return decodeJPEG(data, size);
     }
 
     throw std::runtime_error("unsupported image type");
 }
 
+PremultipliedImage decodeImage(const uint8_t* data, std::size_t size) {
+    if (isJPEG(data, size)) {
+        // JPEGs are opaque, so premultiplying them wouldn't change them.
+        UnassociatedImage image = decodeJPEG(data, size);
+        return { image.size, std::move(image.data) };
+    }
+
+    return util::premultiply(decodeUnassociatedImage(data, size));
+}
+
 } // namespace mbgl
@@ -89,7 +89,7 @@ struct jpeg_info_guard {
     jpeg_decompress_struct* i_;
 };
 
-PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
+UnassociatedImage decodeJPEG(const uint8_t* data, size_t size) {
     util::CharArrayBuffer dataBuffer { reinterpret_cast<const char*>(data), size };
     std::istream stream(&dataBuffer);
 
@@ -106,6 +106,17 @@ PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
     if (ret != JPEG_HEADER_OK)
         throw std::runtime_error("JPEG Reader: failed to read header");
 
+#if defined(JCS_EXTENSIONS)
+    // libjpeg-turbo converts to RGBA itself, so that scanlines can be decoded straight into the
+    // image.
+    const bool extendedRGBA = cinfo.jpeg_color_space == JCS_YCbCr ||
+                              cinfo.jpeg_color_space == JCS_RGB ||
+                              cinfo.jpeg_color_space == JCS_GRAYSCALE;
+    if (extendedRGBA) {
+        cinfo.out_color_space = JCS_EXT_RGBA;
+    }
+#endif
+
     jpeg_start_decompress(&cinfo);
 
     if (cinfo.out_color_space == JCS_UNKNOWN)
@@ -119,9 +130,22 @@ PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
     size_t components = cinfo.output_components;
     size_t rowStride = components * width;
 
-    PremultipliedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
+    UnassociatedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
     uint8_t* dst = image.data.get();
 
+#if defined(JCS_EXTENSIONS)
+    if (extendedRGBA) {
+        while (cinfo.output_scanline < cinfo.output_height) {
+            JSAMPROW row = dst + cinfo.output_scanline * width * 4;
+            jpeg_read_scanlines(&cinfo, &row, 1);
+        }
+
+        jpeg_finish_decompress(&cinfo);
+
+        return image;
+    }
+#endif
+
     JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr) &cinfo, JPOOL_IMAGE, rowStride, 1);
 
     while (cinfo.output_scanline < cinfo.output_height) {
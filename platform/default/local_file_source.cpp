@@ -4,7 +4,7 @@
 #include <mbgl/util/thread.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/util.hpp>
-#include <mbgl/util/io.hpp>
+#include <mbgl/util/mapped_file.hpp>
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -15,6 +15,10 @@ namespace {
 const char* protocol = "file://";
 const std::size_t protocolLength = 7;
 
+// Files are mapped rather than read, so the threads mostly wait for page faults, which they can
+// do side by side.
+const std::size_t threadCount = 3;
+
 } // namespace
 
 namespace mbgl {
@@ -36,7 +40,7 @@ public:
             response.error = std::make_unique<Response::Error>(Response::Error::Reason::NotFound);
         } else {
             try {
-                response.data = std::make_shared<std::string>(util::read_file(path));
+                response.data = MappedFile::read(path);
             } catch (...) {
                 response.error = std::make_unique<Response::Error>(
                     Response::Error::Reason::Other,
@@ -49,14 +53,17 @@ public:
 
 };
 
-LocalFileSource::LocalFileSource()
-    : thread(std::make_unique<util::Thread<Impl>>(util::ThreadContext{"LocalFileSource", util::ThreadPriority::Low})) {
+LocalFileSource::LocalFileSource() {
+    for (std::size_t i = 0; i < threadCount; i++) {
+        threads.push_back(std::make_unique<util::Thread<Impl>>(
+            util::ThreadContext{"LocalFileSource", util::ThreadPriority::Low}));
+    }
 }
 
 LocalFileSource::~LocalFileSource() = default;
 
 std::unique_ptr<AsyncRequest> LocalFileSource::request(const Resource& resource, Callback callback) {
-    return thread->invokeWithCallback(&Impl::request, resource.url, callback);
+    return threads[nextThread++ % threads.size()]->invokeWithCallback(&Impl::request, resource.url, callback);
 }
 
 bool LocalFileSource::acceptsURL(const std::string& url) {
@@ -0,0 +1,24 @@
+#include <mbgl/text/local_glyph_rasterizer.hpp>
+
+namespace mbgl {
+
+class LocalGlyphRasterizer::Impl {
+};
+
+LocalGlyphRasterizer::LocalGlyphRasterizer(const optional<std::string>)
+    : impl(std::make_unique<Impl>()) {
+}
+
+LocalGlyphRasterizer::~LocalGlyphRasterizer() = default;
+
+bool LocalGlyphRasterizer::canRasterizeGlyph(const FontStack&, GlyphID) {
+    return false;
+}
+
+SDFGlyph LocalGlyphRasterizer::rasterizeGlyph(const FontStack&, GlyphID glyphID) {
+    SDFGlyph glyph;
+    glyph.id = glyphID;
+    return glyph;
+}
+
+} // namespace mbgl
@@ -8,6 +8,14 @@ HeadlessDisplay::HeadlessDisplay() {
     // no-op
 }
 
+HeadlessDisplay::HeadlessDisplay(std::size_t)
+    : HeadlessDisplay() {
+}
+
+std::size_t HeadlessDisplay::deviceCount() {
+    return 1;
+}
+
 HeadlessDisplay::~HeadlessDisplay() {
     // no-op
 }
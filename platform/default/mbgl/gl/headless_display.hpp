@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 
 namespace mbgl {
@@ -7,8 +8,16 @@ namespace mbgl {
 class HeadlessDisplay {
 public:
     HeadlessDisplay();
+
+    // Opens a display on one of the GPUs of the machine, numbered from 0 to deviceCount() - 1.
+    explicit HeadlessDisplay(std::size_t device);
+
     ~HeadlessDisplay();
 
+    // The number of GPUs that displays can be opened on, which is 1 on platforms that can only
+    // open the default display.
+    static std::size_t deviceCount();
+
     template <typename DisplayAttribute>
     DisplayAttribute attribute() const;
 
@@ -2,8 +2,10 @@
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/framebuffer.hpp>
 #include <mbgl/gl/renderbuffer.hpp>
+#include <mbgl/gl/pixel_readback.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <cassert>
 
@@ -11,14 +13,18 @@ namespace mbgl {
 
 class OffscreenView::Impl {
 public:
-    Impl(gl::Context& context_, const Size size_) : context(context_), size(std::move(size_)) {
+    Impl(gl::Context& context_, const Size size_, const uint32_t samples_)
+        : context(context_),
+          size(std::move(size_)),
+          samples(samples_ > 1 ? std::min(samples_, context.getMaxSamples()) : 1),
+          readback(context) {
         assert(!size.isEmpty());
     }
 
     void bind() {
         if (!framebuffer) {
-            color = context.createRenderbuffer<gl::RenderbufferType::RGBA>(size);
-            depthStencil = context.createRenderbuffer<gl::RenderbufferType::DepthStencil>(size);
+            color = context.createRenderbuffer<gl::RenderbufferType::RGBA>(size, samples);
+            depthStencil = context.createRenderbuffer<gl::RenderbufferType::DepthStencil>(size, samples);
             framebuffer = context.createFramebuffer(*color, *depthStencil);
         } else {
             context.bindFramebuffer = framebuffer->framebuffer;
@@ -27,24 +33,55 @@ public:
         context.viewport = { 0, 0, size };
     }
 
+    bool isMultisampled() const {
+        return samples > 1;
+    }
+
     PremultipliedImage readStillImage() {
+        resolve();
         return context.readFramebuffer<PremultipliedImage>(size);
     }
 
+    void startReadStillImage() {
+        resolve();
+        readback.read(size);
+    }
+
+    PremultipliedImage finishReadStillImage() {
+        return readback.collect();
+    }
+
     const Size& getSize() const {
         return size;
     }
 
 private:
+    // Multisampled renderbuffers can't be read, so their samples are averaged into plain ones
+    // first, which are bound for reading after.
+    void resolve() {
+        if (!isMultisampled() || !framebuffer) {
+            return;
+        }
+        if (!resolvedFramebuffer) {
+            resolvedColor = context.createRenderbuffer<gl::RenderbufferType::RGBA>(size);
+            resolvedFramebuffer = context.createFramebuffer(*resolvedColor);
+        }
+        context.resolveFramebuffer(*framebuffer, *resolvedFramebuffer);
+    }
+
     gl::Context& context;
     const Size size;
+    const uint32_t samples;
     optional<gl::Framebuffer> framebuffer;
     optional<gl::Renderbuffer<gl::RenderbufferType::RGBA>> color;
     optional<gl::Renderbuffer<gl::RenderbufferType::DepthStencil>> depthStencil;
+    optional<gl::Framebuffer> resolvedFramebuffer;
+    optional<gl::Renderbuffer<gl::RenderbufferType::RGBA>> resolvedColor;
+    gl::PixelReadback readback;
 };
 
-OffscreenView::OffscreenView(gl::Context& context, const Size size)
-    : impl(std::make_unique<Impl>(context, std::move(size))) {
+OffscreenView::OffscreenView(gl::Context& context, const Size size, const uint32_t samples)
+    : impl(std::make_unique<Impl>(context, std::move(size), samples)) {
 }
 
 OffscreenView::~OffscreenView() = default;
@@ -53,10 +90,26 @@ void OffscreenView::bind() {
     impl->bind();
 }
 
+bool OffscreenView::preservesContents() const {
+    return true;
+}
+
+bool OffscreenView::isMultisampled() const {
+    return impl->isMultisampled();
+}
+
 PremultipliedImage OffscreenView::readStillImage() {
     return impl->readStillImage();
 }
 
+void OffscreenView::startReadStillImage() {
+    impl->startReadStillImage();
+}
+
+PremultipliedImage OffscreenView::finishReadStillImage() {
+    return impl->finishReadStillImage();
+}
+
 const Size& OffscreenView::getSize() const {
     return impl->getSize();
 }
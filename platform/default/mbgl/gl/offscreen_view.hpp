@@ -11,13 +11,23 @@ class Context;
 
 class OffscreenView : public View {
 public:
-    OffscreenView(gl::Context&, Size size = { 256, 256 });
+    // Renders with the given number of samples per pixel, as far as the context supports
+    // multisampled renderbuffers, and with one otherwise.
+    OffscreenView(gl::Context&, Size size = { 256, 256 }, uint32_t samples = 1);
     ~OffscreenView();
 
     void bind() override;
+    // The framebuffer keeps what was drawn into it, as long as only one map renders into the view.
+    bool preservesContents() const override;
+    bool isMultisampled() const override;
 
     PremultipliedImage readStillImage();
 
+    // Starts reading the rendered image without waiting for the GPU to finish rendering it. The
+    // view may be rendered to again before the image is collected with finishReadStillImage().
+    void startReadStillImage();
+    PremultipliedImage finishReadStillImage();
+
     const Size& getSize() const;
 
 private:
@@ -0,0 +1,76 @@
+#include <mbgl/map/map_snapshotter.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/backend_scope.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/gl/offscreen_view.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/thread.hpp>
+
+#include <deque>
+#include <utility>
+
+namespace mbgl {
+
+class MapSnapshotter::Impl {
+public:
+    Impl(FileSource& fileSource,
+         std::shared_ptr<const style::StyleSnapshot> style,
+         Size size,
+         float pixelRatio,
+         const std::string& programCacheDir)
+        : view(backend.getContext(), { static_cast<uint32_t>(size.width * pixelRatio),
+                                       static_cast<uint32_t>(size.height * pixelRatio) }),
+          map(backend, size, pixelRatio, fileSource, threadPool, MapMode::Still,
+              GLContextMode::Unique, ConstrainMode::HeightOnly, ViewportMode::Default,
+              programCacheDir) {
+        map.setYieldsToContinuousMaps(true);
+        map.setStyleSnapshot(std::move(style));
+    }
+
+    void snapshot(CameraOptions camera, Callback callback) {
+        requests.emplace_back(std::move(camera), std::move(callback));
+        if (requests.size() == 1) {
+            renderNext();
+        }
+    }
+
+private:
+    void renderNext() {
+        map.jumpTo(requests.front().first);
+        map.renderStill(view, [this] (std::exception_ptr error) {
+            Callback callback = std::move(requests.front().second);
+            requests.pop_front();
+            callback(error, error ? PremultipliedImage() : view.readStillImage());
+            if (!requests.empty()) {
+                renderNext();
+            }
+        });
+    }
+
+    // The worker is created on the snapshotter's thread, whose low priority it inherits.
+    ThreadPool threadPool { 1 };
+    HeadlessBackend backend;
+    BackendScope scope { backend };
+    OffscreenView view;
+    Map map;
+
+    std::deque<std::pair<CameraOptions, Callback>> requests;
+};
+
+MapSnapshotter::MapSnapshotter(FileSource& fileSource,
+                               std::shared_ptr<const style::StyleSnapshot> style,
+                               Size size,
+                               float pixelRatio,
+                               const std::string& programCacheDir)
+    : thread(std::make_unique<util::Thread<Impl>>(
+          util::ThreadContext{ "MapSnapshotter", util::ThreadPriority::Low },
+          fileSource, std::move(style), size, pixelRatio, programCacheDir)) {
+}
+
+MapSnapshotter::~MapSnapshotter() = default;
+
+std::unique_ptr<AsyncRequest> MapSnapshotter::snapshot(const CameraOptions& camera, Callback callback) {
+    return thread->invokeWithCallback(&Impl::snapshot, camera, std::move(callback));
+}
+
+} // namespace mbgl
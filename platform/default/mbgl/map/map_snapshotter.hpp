@@ -0,0 +1,54 @@
+#pragma once
+
+#include <mbgl/map/camera.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/size.hpp>
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class AsyncRequest;
+class FileSource;
+
+namespace style {
+class StyleSnapshot;
+} // namespace style
+
+namespace util {
+template <class> class Thread;
+} // namespace util
+
+// Renders images of a style in the background, for thumbnails and share images, without a
+// second map on the thread of the visible one and without blocking it. The snapshotter keeps a
+// still map on a low-priority thread of its own, with its own GL context and worker. The map is
+// loaded from a snapshot of the visible map's style, and shares its tiles through the file
+// source's caches and their layouts through the SharedLayoutCache, when it is enabled. It holds
+// every image back until the continuous maps of the process are idle; see
+// Map::setYieldsToContinuousMaps().
+class MapSnapshotter : private util::noncopyable {
+public:
+    // The size is in logical pixels, and the images are that size times the pixel ratio.
+    MapSnapshotter(FileSource&,
+                   std::shared_ptr<const style::StyleSnapshot>,
+                   Size size,
+                   float pixelRatio,
+                   const std::string& programCacheDir = "");
+    ~MapSnapshotter();
+
+    // Renders an image at the camera. Requests are rendered one after the other, in the order
+    // they're made. The callback is called on the calling thread, which must have a RunLoop,
+    // unless the request is destroyed first.
+    using Callback = std::function<void (std::exception_ptr, PremultipliedImage)>;
+    std::unique_ptr<AsyncRequest> snapshot(const CameraOptions&, Callback);
+
+private:
+    class Impl;
+    const std::unique_ptr<util::Thread<Impl>> thread;
+};
+
+} // namespace mbgl
@@ -24,6 +24,20 @@ OfflineTilePyramidRegionDefinition::OfflineTilePyramidRegionDefinition(
 }
 
 std::vector<CanonicalTileID> OfflineTilePyramidRegionDefinition::tileCover(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+    const Range<uint8_t> range = coveringZoomRange(type, tileSize, zoomRange);
+
+    std::vector<CanonicalTileID> result;
+
+    for (int32_t z = range.min; z <= range.max; z++) {
+        for (const auto& tile : util::tileCover(bounds, z)) {
+            result.emplace_back(tile.canonical);
+        }
+    }
+
+    return result;
+}
+
+Range<uint8_t> OfflineTilePyramidRegionDefinition::coveringZoomRange(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
     double minZ = std::max<double>(util::coveringZoomLevel(minZoom, type, tileSize), zoomRange.min);
     double maxZ = std::min<double>(util::coveringZoomLevel(maxZoom, type, tileSize), zoomRange.max);
 
@@ -32,12 +46,15 @@ std::vector<CanonicalTileID> OfflineTilePyramidRegionDefinition::tileCover(Sourc
     assert(minZ < std::numeric_limits<uint8_t>::max());
     assert(maxZ < std::numeric_limits<uint8_t>::max());
 
-    std::vector<CanonicalTileID> result;
+    return { static_cast<uint8_t>(minZ), static_cast<uint8_t>(maxZ) };
+}
 
-    for (uint8_t z = minZ; z <= maxZ; z++) {
-        for (const auto& tile : util::tileCover(bounds, z)) {
-            result.emplace_back(tile.canonical);
-        }
+uint64_t OfflineTilePyramidRegionDefinition::tileCount(SourceType type, uint16_t tileSize, const Range<uint8_t>& zoomRange) const {
+    const Range<uint8_t> range = coveringZoomRange(type, tileSize, zoomRange);
+
+    uint64_t result = 0;
+    for (int32_t z = range.min; z <= range.max; z++) {
+        result += util::TileCover(bounds, z).size();
     }
 
     return result;
@@ -8,17 +8,68 @@
 
 #include "sqlite3.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
 namespace mbgl {
 
+namespace {
+
+// Access times only decide the order of eviction, so they are only updated once they're older
+// than this: getting a resource again within it doesn't write to the database.
+const Seconds accessedGranularity = std::chrono::minutes(5);
+
+// Once the ambient cache fills past the high watermark, trimAmbientCache() evicts from it until
+// it's back below the low watermark, so that puts find room without evicting themselves.
+const double cacheHighWatermark = 0.9;
+const double cacheLowWatermark = 0.75;
+
+// The most pages that a single incremental vacuum returns to the file system, so that freeing
+// the pages of a large deleted region doesn't hold the database for minutes; see vacuumBatch().
+const uint64_t vacuumBatchPages = 1024;
+
+bool isStale(Timestamp accessed) {
+    return accessed < util::now() - accessedGranularity;
+}
+
+// Inflates a blob straight out of the row of the statement. Rows written since schema version 7
+// record their decompressed size, so that the result is allocated once.
+std::string decompress(const std::pair<const char*, std::size_t>& blob,
+                       optional<int64_t> uncompressedSize,
+                       const std::string* dictionary) {
+    if (uncompressedSize) {
+        return dictionary
+            ? util::decompress(blob.first, blob.second, *uncompressedSize, *dictionary)
+            : util::decompress(blob.first, blob.second, *uncompressedSize);
+    }
+    return dictionary
+        ? util::decompress(std::string(blob.first, blob.second), *dictionary)
+        : util::decompress(blob.first, blob.second);
+}
+
+} // namespace
+
 OfflineDatabase::Statement::~Statement() {
     stmt.reset();
     stmt.clearBindings();
 }
 
-OfflineDatabase::OfflineDatabase(std::string path_, uint64_t maximumCacheSize_)
+OfflineDatabase::OfflineDatabase(std::string path_, uint64_t maximumCacheSize_, Mode mode_, Journal journal)
     : path(std::move(path_)),
+      mode(mode_),
       maximumCacheSize(maximumCacheSize_) {
-    ensureSchema();
+    if (mode == Mode::ReadOnly) {
+        connect(mapbox::sqlite::ReadOnly);
+        hasStats = userVersion() >= 8;
+    } else {
+        ensureSchema();
+        if (path != ":memory:") {
+            setJournal(journal);
+        }
+    }
 }
 
 OfflineDatabase::~OfflineDatabase() {
@@ -49,7 +100,10 @@ void OfflineDatabase::ensureSchema() {
             case 2: migrateToVersion3(); // fall through
             case 3: // no-op and fall through
             case 4: migrateToVersion5(); // fall through
-            case 5: return;
+            case 5: migrateToVersion6(); // fall through
+            case 6: migrateToVersion7(); // fall through
+            case 7: migrateToVersion8(); // fall through
+            case 8: return;
             default: throw std::runtime_error("unknown schema version");
             }
 
@@ -83,7 +137,7 @@ void OfflineDatabase::ensureSchema() {
         db->exec("PRAGMA journal_mode = DELETE");
         db->exec("PRAGMA synchronous = FULL");
         db->exec(schema);
-        db->exec("PRAGMA user_version = 5");
+        db->exec("PRAGMA user_version = 8");
     } catch (...) {
         Log::Error(Event::Database, "Unexpected error creating database schema: %s", util::toString(std::current_exception()).c_str());
         throw;
@@ -126,6 +180,160 @@ void OfflineDatabase::migrateToVersion5() {
     db->exec("PRAGMA user_version = 5");
 }
 
+void OfflineDatabase::migrateToVersion6() {
+    mapbox::sqlite::Transaction transaction(*db);
+    db->exec("CREATE TABLE tile_dictionaries ("
+             "  url_template TEXT NOT NULL PRIMARY KEY,"
+             "  dictionary BLOB NOT NULL"
+             ")");
+    db->exec("PRAGMA user_version = 6");
+    transaction.commit();
+}
+
+void OfflineDatabase::migrateToVersion7() {
+    mapbox::sqlite::Transaction transaction(*db);
+    db->exec("ALTER TABLE resources ADD COLUMN uncompressed_size INTEGER");
+    db->exec("ALTER TABLE tiles ADD COLUMN uncompressed_size INTEGER");
+    db->exec("PRAGMA user_version = 7");
+    transaction.commit();
+}
+
+void OfflineDatabase::migrateToVersion8() {
+    mapbox::sqlite::Transaction transaction(*db);
+    // clang-format off
+    db->exec("CREATE TABLE region_stats ("
+             "  region_id INTEGER NOT NULL PRIMARY KEY REFERENCES regions(id) ON DELETE CASCADE,"
+             "  resource_count INTEGER NOT NULL DEFAULT 0,"
+             "  resource_size INTEGER NOT NULL DEFAULT 0,"
+             "  tile_count INTEGER NOT NULL DEFAULT 0,"
+             "  tile_size INTEGER NOT NULL DEFAULT 0"
+             ")");
+    db->exec("CREATE TABLE offline_stats ("
+             "  mapbox_tile_count INTEGER NOT NULL"
+             ")");
+
+    // Counted once here; the triggers keep the counts from now on.
+    db->exec("INSERT INTO region_stats (region_id, resource_count, resource_size, tile_count, tile_size) "
+             "SELECT id, "
+             "  (SELECT COUNT(*) FROM region_resources WHERE region_id = regions.id), "
+             "  (SELECT IFNULL(SUM(LENGTH(data)), 0) FROM region_resources, resources "
+             "   WHERE region_id = regions.id AND resource_id = resources.id), "
+             "  (SELECT COUNT(*) FROM region_tiles WHERE region_id = regions.id), "
+             "  (SELECT IFNULL(SUM(LENGTH(data)), 0) FROM region_tiles, tiles "
+             "   WHERE region_id = regions.id AND tile_id = tiles.id) "
+             "FROM regions");
+    db->exec("INSERT INTO offline_stats (mapbox_tile_count) "
+             "SELECT COUNT(DISTINCT id) "
+             "FROM region_tiles, tiles "
+             "WHERE tile_id = tiles.id "
+             "AND url_template LIKE 'mapbox://%'");
+
+    db->exec("CREATE TRIGGER regions_insert AFTER INSERT ON regions "
+             "BEGIN "
+             "  INSERT INTO region_stats (region_id) VALUES (NEW.id); "
+             "END");
+    db->exec("CREATE TRIGGER region_resources_insert AFTER INSERT ON region_resources "
+             "BEGIN "
+             "  UPDATE region_stats "
+             "  SET resource_count = resource_count + 1, "
+             "      resource_size = resource_size + (SELECT IFNULL(LENGTH(data), 0) FROM resources WHERE id = NEW.resource_id) "
+             "  WHERE region_id = NEW.region_id; "
+             "END");
+    db->exec("CREATE TRIGGER region_resources_delete AFTER DELETE ON region_resources "
+             "BEGIN "
+             "  UPDATE region_stats "
+             "  SET resource_count = resource_count - 1, "
+             "      resource_size = resource_size - (SELECT IFNULL(LENGTH(data), 0) FROM resources WHERE id = OLD.resource_id) "
+             "  WHERE region_id = OLD.region_id; "
+             "END");
+    db->exec("CREATE TRIGGER region_tiles_insert AFTER INSERT ON region_tiles "
+             "BEGIN "
+             "  UPDATE region_stats "
+             "  SET tile_count = tile_count + 1, "
+             "      tile_size = tile_size + (SELECT IFNULL(LENGTH(data), 0) FROM tiles WHERE id = NEW.tile_id) "
+             "  WHERE region_id = NEW.region_id; "
+             "  UPDATE offline_stats "
+             "  SET mapbox_tile_count = mapbox_tile_count + 1 "
+             "  WHERE NOT EXISTS (SELECT 1 FROM region_tiles WHERE tile_id = NEW.tile_id AND region_id != NEW.region_id) "
+             "    AND (SELECT url_template FROM tiles WHERE id = NEW.tile_id) LIKE 'mapbox://%'; "
+             "END");
+    db->exec("CREATE TRIGGER region_tiles_delete AFTER DELETE ON region_tiles "
+             "BEGIN "
+             "  UPDATE region_stats "
+             "  SET tile_count = tile_count - 1, "
+             "      tile_size = tile_size - (SELECT IFNULL(LENGTH(data), 0) FROM tiles WHERE id = OLD.tile_id) "
+             "  WHERE region_id = OLD.region_id; "
+             "  UPDATE offline_stats "
+             "  SET mapbox_tile_count = mapbox_tile_count - 1 "
+             "  WHERE NOT EXISTS (SELECT 1 FROM region_tiles WHERE tile_id = OLD.tile_id) "
+             "    AND (SELECT url_template FROM tiles WHERE id = OLD.tile_id) LIKE 'mapbox://%'; "
+             "END");
+    db->exec("CREATE TRIGGER resources_update_data AFTER UPDATE OF data ON resources "
+             "WHEN IFNULL(LENGTH(NEW.data), 0) != IFNULL(LENGTH(OLD.data), 0) "
+             "BEGIN "
+             "  UPDATE region_stats "
+             "  SET resource_size = resource_size + IFNULL(LENGTH(NEW.data), 0) - IFNULL(LENGTH(OLD.data), 0) "
+             "  WHERE region_id IN (SELECT region_id FROM region_resources WHERE resource_id = NEW.id); "
+             "END");
+    db->exec("CREATE TRIGGER tiles_update_data AFTER UPDATE OF data ON tiles "
+             "WHEN IFNULL(LENGTH(NEW.data), 0) != IFNULL(LENGTH(OLD.data), 0) "
+             "BEGIN "
+             "  UPDATE region_stats "
+             "  SET tile_size = tile_size + IFNULL(LENGTH(NEW.data), 0) - IFNULL(LENGTH(OLD.data), 0) "
+             "  WHERE region_id IN (SELECT region_id FROM region_tiles WHERE tile_id = NEW.id); "
+             "END");
+    // clang-format on
+    db->exec("PRAGMA user_version = 8");
+    transaction.commit();
+}
+
+// The journal is not part of the schema. Unlike schema version 4, choosing it doesn't migrate
+// the database to a new version that later releases would have to migrate away from again:
+//
+// - user_version is unchanged, and databases in either journal mode can be opened by every
+//   release that reads their version; SQLite itself recovers a write-ahead log left behind by a
+//   crash.
+// - The journal mode is persistent in the file, and it is only switched when the requested
+//   mode differs from it. A database is not switched back and forth on every launch, only
+//   when the application changes its choice.
+// - Switching requires that no other connection has the database open, so it happens here,
+//   before DefaultFileSource opens its other connections.
+// - The sync mode is a property of each connection, and is set on every read-write one:
+//   FULL with the rollback journal as before, NORMAL with the write-ahead log, under which a
+//   power loss may roll back the latest transactions but can't corrupt the database.
+void OfflineDatabase::setJournal(Journal journal) {
+    const char* wanted = journal == Journal::WriteAhead ? "wal" : "delete";
+
+    const std::string current = [&] {
+        // The statement must be finalized before switching, as it holds a read transaction.
+        auto stmt = db->prepare("PRAGMA journal_mode");
+        stmt.run();
+        return stmt.get<std::string>(0);
+    }();
+
+    if (current != wanted) {
+        Log::Info(Event::Database, "Switching the offline database to journal mode %s", wanted);
+        db->exec(std::string("PRAGMA journal_mode = ") + wanted);
+    }
+
+    db->exec(journal == Journal::WriteAhead ? "PRAGMA synchronous = NORMAL" : "PRAGMA synchronous = FULL");
+}
+
+void OfflineDatabase::batch(const std::function<void ()>& fn) {
+    assert(!inBatch);
+
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    inBatch = true;
+    try {
+        fn();
+    } catch (...) {
+        inBatch = false;
+        throw;
+    }
+    inBatch = false;
+    transaction.commit();
+}
+
 OfflineDatabase::Statement OfflineDatabase::getStatement(const char * sql) {
     auto it = statements.find(sql);
 
@@ -168,17 +376,35 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
         return { false, 0 };
     }
 
-    std::string compressedData;
-    bool compressed = false;
-    uint64_t size = 0;
+    // The bytes to store: the data of the response, or its compressed data if that is smaller.
+    std::shared_ptr<const Buffer> data = response.data;
+    Compression compression = Uncompressed;
+    optional<int64_t> uncompressedSize;
+
+    if (data) {
+        std::shared_ptr<const std::string> dictionary;
+        if (resource.kind == Resource::Kind::Tile && tileCompression == TileCompression::Dictionary) {
+            assert(resource.tileData);
+            dictionary = getTileDictionary(resource.tileData->urlTemplate);
+            if (!dictionary) {
+                addTileDictionarySample(resource.tileData->urlTemplate, data->toString());
+            }
+        }
 
-    if (response.data) {
-        compressedData = util::compress(*response.data);
-        compressed = compressedData.size() < response.data->size();
-        size = compressed ? compressedData.size() : response.data->size();
+        std::string compressedData = dictionary
+            ? util::compress(data->data(), data->size(), *dictionary)
+            : util::compress(data->data(), data->size());
+        if (compressedData.size() < data->size()) {
+            compression = dictionary ? ZlibDictionary : Zlib;
+            uncompressedSize = int64_t(data->size());
+            data = std::make_shared<Buffer>(std::move(compressedData));
+        }
     }
 
-    if (evict_ && !evict(size)) {
+    const uint64_t size = data ? data->size() : 0;
+
+    // Revalidated entries only have their expiration date updated, and keep their data.
+    if (evict_ && !response.notModified && !evict(size)) {
         Log::Debug(Event::Database, "Unable to make space for entry");
         return { false, 0 };
     }
@@ -187,32 +413,41 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
 
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
-        inserted = putTile(*resource.tileData, response,
-                compressed ? compressedData : *response.data,
-                compressed);
+        inserted = putTile(*resource.tileData, response, data.get(), compression, uncompressedSize);
     } else {
-        inserted = putResource(resource, response,
-                compressed ? compressedData : *response.data,
-                compressed);
+        inserted = putResource(resource, response, data.get(), compression, uncompressedSize);
     }
 
     return { inserted, size };
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
+void OfflineDatabase::markAccessed(const Resource& resource) {
+    if (resource.kind == Resource::Kind::Tile) {
+        assert(resource.tileData);
+        markTileAccessed(*resource.tileData);
+    } else {
+        markResourceAccessed(resource);
+    }
+}
+
+void OfflineDatabase::markResourceAccessed(const Resource& resource) {
     // clang-format off
     Statement accessedStmt = getStatement(
-        "UPDATE resources SET accessed = ?1 WHERE url = ?2");
+        "UPDATE resources SET accessed = ?1 WHERE url = ?2 AND accessed < ?3");
     // clang-format on
 
-    accessedStmt->bind(1, util::now());
+    const Timestamp now = util::now();
+    accessedStmt->bind(1, now);
     accessedStmt->bind(2, resource.url);
+    accessedStmt->bind(3, now - accessedGranularity);
     accessedStmt->run();
+}
 
+optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
     // clang-format off
     Statement stmt = getStatement(
-        //        0      1        2       3        4
-        "SELECT etag, expires, modified, data, compressed "
+        //        0      1        2       3        4           5            6
+        "SELECT etag, expires, modified, data, compressed, accessed, uncompressed_size "
         "FROM resources "
         "WHERE url = ?");
     // clang-format on
@@ -230,15 +465,20 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
     response.expires  = stmt->get<optional<Timestamp>>(1);
     response.modified = stmt->get<optional<Timestamp>>(2);
 
-    optional<std::string> data = stmt->get<optional<std::string>>(3);
-    if (!data) {
+    const auto data = stmt->getBlob(3);
+    const optional<int64_t> uncompressedSize = stmt->get<optional<int64_t>>(6);
+    size = data.second;
+    if (!data.first) {
         response.noContent = true;
     } else if (stmt->get<int>(4)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
-        size = data->length();
+        response.data = std::make_shared<Buffer>(decompress(data, uncompressedSize, nullptr));
     } else {
-        response.data = std::make_shared<std::string>(*data);
-        size = data->length();
+        response.data = std::make_shared<Buffer>(std::string(data.first, data.second));
+    }
+
+    // Lookups that miss, or that hit a recently accessed resource, don't write.
+    if (mode == Mode::ReadWrite && isStale(stmt->get<Timestamp>(5))) {
+        markResourceAccessed(resource);
     }
 
     return std::make_pair(response, size);
@@ -259,8 +499,9 @@ optional<int64_t> OfflineDatabase::hasResource(const Resource& resource) {
 
 bool OfflineDatabase::putResource(const Resource& resource,
                                   const Response& response,
-                                  const std::string& data,
-                                  bool compressed) {
+                                  const Buffer* data,
+                                  Compression compression,
+                                  optional<int64_t> uncompressedSize) {
     if (response.notModified) {
         // clang-format off
         Statement update = getStatement(
@@ -280,8 +521,11 @@ bool OfflineDatabase::putResource(const Resource& resource,
     // We can't use REPLACE because it would change the id value.
 
     // Begin an immediate-mode transaction to ensure that two writers do not attempt
-    // to INSERT a resource at the same moment.
-    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    // to INSERT a resource at the same moment. A batch already holds one.
+    optional<mapbox::sqlite::Transaction> transaction;
+    if (!inBatch) {
+        transaction.emplace(*db, mapbox::sqlite::Transaction::Immediate);
+    }
 
     // clang-format off
     Statement update = getStatement(
@@ -292,8 +536,9 @@ bool OfflineDatabase::putResource(const Resource& resource,
         "    modified   = ?4, "
         "    accessed   = ?5, "
         "    data       = ?6, "
-        "    compressed = ?7 "
-        "WHERE url      = ?8 ");
+        "    compressed = ?7, "
+        "    uncompressed_size = ?8 "
+        "WHERE url      = ?9 ");
     // clang-format on
 
     update->bind(1, int(resource.kind));
@@ -301,26 +546,29 @@ bool OfflineDatabase::putResource(const Resource& resource,
     update->bind(3, response.expires);
     update->bind(4, response.modified);
     update->bind(5, util::now());
-    update->bind(8, resource.url);
+    update->bind(9, resource.url);
 
-    if (response.noContent) {
+    if (response.noContent || !data) {
         update->bind(6, nullptr);
         update->bind(7, false);
     } else {
-        update->bindBlob(6, data.data(), data.size(), false);
-        update->bind(7, compressed);
+        update->bindBlob(6, data->data(), data->size(), false);
+        update->bind(7, int(compression));
     }
+    update->bind(8, uncompressedSize);
 
     update->run();
     if (update->changes() != 0) {
-        transaction.commit();
+        if (transaction) {
+            transaction->commit();
+        }
         return false;
     }
 
     // clang-format off
     Statement insert = getStatement(
-        "INSERT INTO resources (url, kind, etag, expires, modified, accessed, data, compressed) "
-        "VALUES                (?1,  ?2,   ?3,   ?4,      ?5,       ?6,       ?7,   ?8) ");
+        "INSERT INTO resources (url, kind, etag, expires, modified, accessed, data, compressed, uncompressed_size) "
+        "VALUES                (?1,  ?2,   ?3,   ?4,      ?5,       ?6,       ?7,   ?8,         ?9) ");
     // clang-format on
 
     insert->bind(1, resource.url);
@@ -330,21 +578,24 @@ bool OfflineDatabase::putResource(const Resource& resource,
     insert->bind(5, response.modified);
     insert->bind(6, util::now());
 
-    if (response.noContent) {
+    if (response.noContent || !data) {
         insert->bind(7, nullptr);
         insert->bind(8, false);
     } else {
-        insert->bindBlob(7, data.data(), data.size(), false);
-        insert->bind(8, compressed);
+        insert->bindBlob(7, data->data(), data->size(), false);
+        insert->bind(8, int(compression));
     }
+    insert->bind(9, uncompressedSize);
 
     insert->run();
-    transaction.commit();
+    if (transaction) {
+        transaction->commit();
+    }
 
     return true;
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
+void OfflineDatabase::markTileAccessed(const Resource::TileData& tile) {
     // clang-format off
     Statement accessedStmt = getStatement(
         "UPDATE tiles "
@@ -353,21 +604,26 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
         "  AND pixel_ratio  = ?3 "
         "  AND x            = ?4 "
         "  AND y            = ?5 "
-        "  AND z            = ?6 ");
+        "  AND z            = ?6 "
+        "  AND accessed     < ?7 ");
     // clang-format on
 
-    accessedStmt->bind(1, util::now());
+    const Timestamp now = util::now();
+    accessedStmt->bind(1, now);
     accessedStmt->bind(2, tile.urlTemplate);
     accessedStmt->bind(3, tile.pixelRatio);
     accessedStmt->bind(4, tile.x);
     accessedStmt->bind(5, tile.y);
     accessedStmt->bind(6, tile.z);
+    accessedStmt->bind(7, now - accessedGranularity);
     accessedStmt->run();
+}
 
+optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
     // clang-format off
     Statement stmt = getStatement(
-        //        0      1        2       3        4
-        "SELECT etag, expires, modified, data, compressed "
+        //        0      1        2       3        4           5            6
+        "SELECT etag, expires, modified, data, compressed, accessed, uncompressed_size "
         "FROM tiles "
         "WHERE url_template = ?1 "
         "  AND pixel_ratio  = ?2 "
@@ -393,20 +649,95 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
     response.expires  = stmt->get<optional<Timestamp>>(1);
     response.modified = stmt->get<optional<Timestamp>>(2);
 
-    optional<std::string> data = stmt->get<optional<std::string>>(3);
-    if (!data) {
+    const auto data = stmt->getBlob(3);
+    const int compression = stmt->get<int>(4);
+    const optional<int64_t> uncompressedSize = stmt->get<optional<int64_t>>(6);
+    size = data.second;
+    if (!data.first) {
         response.noContent = true;
-    } else if (stmt->get<int>(4)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
-        size = data->length();
+    } else if (compression == ZlibDictionary) {
+        auto dictionary = getTileDictionary(tile.urlTemplate);
+        if (!dictionary) {
+            throw std::runtime_error("missing compression dictionary of " + tile.urlTemplate);
+        }
+        response.data = std::make_shared<Buffer>(decompress(data, uncompressedSize, dictionary.get()));
+    } else if (compression) {
+        response.data = std::make_shared<Buffer>(decompress(data, uncompressedSize, nullptr));
     } else {
-        response.data = std::make_shared<std::string>(*data);
-        size = data->length();
+        response.data = std::make_shared<Buffer>(std::string(data.first, data.second));
+    }
+
+    // Lookups that miss, or that hit a recently accessed tile, don't write.
+    if (mode == Mode::ReadWrite && isStale(stmt->get<Timestamp>(5))) {
+        markTileAccessed(tile);
     }
 
     return std::make_pair(response, size);
 }
 
+std::shared_ptr<const std::string> OfflineDatabase::getTileDictionary(const std::string& urlTemplate) {
+    auto it = tileDictionaries.find(urlTemplate);
+    if (it != tileDictionaries.end()) {
+        return it->second;
+    }
+
+    // clang-format off
+    Statement stmt = getStatement(
+        "SELECT dictionary FROM tile_dictionaries WHERE url_template = ?1");
+    // clang-format on
+
+    stmt->bind(1, urlTemplate);
+    if (!stmt->run()) {
+        // Another connection may still add one, so the absence isn't kept.
+        return nullptr;
+    }
+
+    auto dictionary = std::make_shared<const std::string>(stmt->get<std::string>(0));
+    tileDictionaries.emplace(urlTemplate, dictionary);
+    return dictionary;
+}
+
+// A dictionary is trained once this many tiles, or this many bytes of them, have been put for
+// its url template.
+static const std::size_t tileDictionarySampleCount = 64;
+static const std::size_t tileDictionarySampleBytes = 1024 * 1024;
+
+void OfflineDatabase::addTileDictionarySample(const std::string& urlTemplate, const std::string& data) {
+    TileDictionarySamples& samples = tileDictionarySamples[urlTemplate];
+    samples.samples.push_back(data);
+    samples.bytes += data.size();
+
+    if (samples.samples.size() < tileDictionarySampleCount && samples.bytes < tileDictionarySampleBytes) {
+        return;
+    }
+
+    const std::string dictionary = util::trainCompressionDictionary(samples.samples);
+    tileDictionarySamples.erase(urlTemplate);
+
+    if (dictionary.empty()) {
+        return;
+    }
+
+    // Another connection may have stored a dictionary for the template in the meantime, in
+    // which case that one is used.
+    // clang-format off
+    Statement stmt = getStatement(
+        "INSERT OR IGNORE INTO tile_dictionaries (url_template, dictionary) "
+        "VALUES                                  (?1,           ?2) ");
+    // clang-format on
+
+    stmt->bind(1, urlTemplate);
+    stmt->bindBlob(2, dictionary.data(), dictionary.size(), false);
+    stmt->run();
+}
+
+void OfflineDatabase::setTileCompression(TileCompression compression) {
+    tileCompression = compression;
+    if (compression != TileCompression::Dictionary) {
+        tileDictionarySamples.clear();
+    }
+}
+
 optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
     // clang-format off
     Statement stmt = getStatement(
@@ -434,8 +765,9 @@ optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
 
 bool OfflineDatabase::putTile(const Resource::TileData& tile,
                               const Response& response,
-                              const std::string& data,
-                              bool compressed) {
+                              const Buffer* data,
+                              Compression compression,
+                              optional<int64_t> uncompressedSize) {
     if (response.notModified) {
         // clang-format off
         Statement update = getStatement(
@@ -463,8 +795,11 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     // We can't use REPLACE because it would change the id value.
 
     // Begin an immediate-mode transaction to ensure that two writers do not attempt
-    // to INSERT a resource at the same moment.
-    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    // to INSERT a resource at the same moment. A batch already holds one.
+    optional<mapbox::sqlite::Transaction> transaction;
+    if (!inBatch) {
+        transaction.emplace(*db, mapbox::sqlite::Transaction::Immediate);
+    }
 
     // clang-format off
     Statement update = getStatement(
@@ -474,42 +809,46 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         "    expires        = ?3, "
         "    accessed       = ?4, "
         "    data           = ?5, "
-        "    compressed     = ?6 "
-        "WHERE url_template = ?7 "
-        "  AND pixel_ratio  = ?8 "
-        "  AND x            = ?9 "
-        "  AND y            = ?10 "
-        "  AND z            = ?11 ");
+        "    compressed     = ?6, "
+        "    uncompressed_size = ?7 "
+        "WHERE url_template = ?8 "
+        "  AND pixel_ratio  = ?9 "
+        "  AND x            = ?10 "
+        "  AND y            = ?11 "
+        "  AND z            = ?12 ");
     // clang-format on
 
     update->bind(1, response.modified);
     update->bind(2, response.etag);
     update->bind(3, response.expires);
     update->bind(4, util::now());
-    update->bind(7, tile.urlTemplate);
-    update->bind(8, tile.pixelRatio);
-    update->bind(9, tile.x);
-    update->bind(10, tile.y);
-    update->bind(11, tile.z);
+    update->bind(8, tile.urlTemplate);
+    update->bind(9, tile.pixelRatio);
+    update->bind(10, tile.x);
+    update->bind(11, tile.y);
+    update->bind(12, tile.z);
 
-    if (response.noContent) {
+    if (response.noContent || !data) {
         update->bind(5, nullptr);
         update->bind(6, false);
     } else {
-        update->bindBlob(5, data.data(), data.size(), false);
-        update->bind(6, compressed);
+        update->bindBlob(5, data->data(), data->size(), false);
+        update->bind(6, int(compression));
     }
+    update->bind(7, uncompressedSize);
 
     update->run();
     if (update->changes() != 0) {
-        transaction.commit();
+        if (transaction) {
+            transaction->commit();
+        }
         return false;
     }
 
     // clang-format off
     Statement insert = getStatement(
-        "INSERT INTO tiles (url_template, pixel_ratio, x,  y,  z,  modified,  etag,  expires,  accessed,  data, compressed) "
-        "VALUES            (?1,           ?2,          ?3, ?4, ?5, ?6,        ?7,    ?8,       ?9,        ?10,  ?11) ");
+        "INSERT INTO tiles (url_template, pixel_ratio, x,  y,  z,  modified,  etag,  expires,  accessed,  data, compressed, uncompressed_size) "
+        "VALUES            (?1,           ?2,          ?3, ?4, ?5, ?6,        ?7,    ?8,       ?9,        ?10,  ?11,        ?12) ");
     // clang-format on
 
     insert->bind(1, tile.urlTemplate);
@@ -522,16 +861,19 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     insert->bind(8, response.expires);
     insert->bind(9, util::now());
 
-    if (response.noContent) {
+    if (response.noContent || !data) {
         insert->bind(10, nullptr);
         insert->bind(11, false);
     } else {
-        insert->bindBlob(10, data.data(), data.size(), false);
-        insert->bind(11, compressed);
+        insert->bindBlob(10, data->data(), data->size(), false);
+        insert->bind(11, int(compression));
     }
+    insert->bind(12, uncompressedSize);
 
     insert->run();
-    transaction.commit();
+    if (transaction) {
+        transaction->commit();
+    }
 
     return true;
 }
@@ -583,6 +925,12 @@ OfflineRegionMetadata OfflineDatabase::updateMetadata(const int64_t regionID, co
 }
 
 void OfflineDatabase::deleteRegion(OfflineRegion&& region) {
+    assert(!inBatch);
+
+    // The resources that only the region used become part of the ambient cache, which is evicted
+    // back to its maximum size in the same transaction rather than in one per batch.
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+
     // clang-format off
     Statement stmt = getStatement(
         "DELETE FROM regions WHERE id = ?");
@@ -592,10 +940,10 @@ void OfflineDatabase::deleteRegion(OfflineRegion&& region) {
     stmt->run();
 
     evict(0);
-    db->exec("PRAGMA incremental_vacuum");
+    transaction.commit();
 
-    // Ensure that the cached offlineTileCount value is recalculated.
-    offlineMapboxTileCount = {};
+    // The rest of the freed pages are returned by trimAmbientCache().
+    vacuumBatch();
 }
 
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getRegionResource(int64_t regionID, const Resource& resource) {
@@ -618,21 +966,28 @@ optional<int64_t> OfflineDatabase::hasRegionResource(int64_t regionID, const Res
     return response;
 }
 
-uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& resource, const Response& response) {
-    uint64_t size = putInternal(resource, response, false).second;
-    bool previouslyUnused = markUsed(regionID, resource);
+std::vector<optional<int64_t>> OfflineDatabase::hasRegionResources(int64_t regionID, const std::vector<Resource>& resources) {
+    std::vector<optional<int64_t>> result;
+    result.reserve(resources.size());
 
-    if (offlineMapboxTileCount
-        && resource.kind == Resource::Kind::Tile
-        && util::mapbox::isMapboxURL(resource.url)
-        && previouslyUnused) {
-        *offlineMapboxTileCount += 1;
-    }
+    // Each resource that is found is also linked to the region, which is a write.
+    batch([&] {
+        for (const auto& resource : resources) {
+            result.push_back(hasRegionResource(regionID, resource));
+        }
+    });
 
+    return result;
+}
+
+uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& resource, const Response& response) {
+    uint64_t size = putInternal(resource, response, false).second;
+    markUsed(regionID, resource);
     return size;
 }
 
-bool OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
+void OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
+    // The triggers on region_tiles and region_resources count what each insert adds.
     if (resource.kind == Resource::Kind::Tile) {
         // clang-format off
         Statement insert = getStatement(
@@ -654,31 +1009,6 @@ bool OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
         insert->bind(5, tile.y);
         insert->bind(6, tile.z);
         insert->run();
-
-        if (insert->changes() == 0) {
-            return false;
-        }
-
-        // clang-format off
-        Statement select = getStatement(
-            "SELECT region_id "
-            "FROM region_tiles, tiles "
-            "WHERE region_id   != ?1 "
-            "  AND url_template = ?2 "
-            "  AND pixel_ratio  = ?3 "
-            "  AND x            = ?4 "
-            "  AND y            = ?5 "
-            "  AND z            = ?6 "
-            "LIMIT 1 ");
-        // clang-format on
-
-        select->bind(1, regionID);
-        select->bind(2, tile.urlTemplate);
-        select->bind(3, tile.pixelRatio);
-        select->bind(4, tile.x);
-        select->bind(5, tile.y);
-        select->bind(6, tile.z);
-        return !select->run();
     } else {
         // clang-format off
         Statement insert = getStatement(
@@ -691,23 +1021,6 @@ bool OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
         insert->bind(1, regionID);
         insert->bind(2, resource.url);
         insert->run();
-
-        if (insert->changes() == 0) {
-            return false;
-        }
-
-        // clang-format off
-        Statement select = getStatement(
-            "SELECT region_id "
-            "FROM region_resources, resources "
-            "WHERE region_id    != ?1 "
-            "  AND resources.url = ?2 "
-            "LIMIT 1 ");
-        // clang-format on
-
-        select->bind(1, regionID);
-        select->bind(2, resource.url);
-        return !select->run();
     }
 }
 
@@ -726,10 +1039,26 @@ OfflineRegionDefinition OfflineDatabase::getRegionDefinition(int64_t regionID) {
 OfflineRegionStatus OfflineDatabase::getRegionCompletedStatus(int64_t regionID) {
     OfflineRegionStatus result;
 
-    std::tie(result.completedResourceCount, result.completedResourceSize)
-        = getCompletedResourceCountAndSize(regionID);
-    std::tie(result.completedTileCount, result.completedTileSize)
-        = getCompletedTileCountAndSize(regionID);
+    if (hasStats) {
+        // clang-format off
+        Statement stmt = getStatement(
+            "SELECT resource_count, resource_size, tile_count, tile_size "
+            "FROM region_stats "
+            "WHERE region_id = ?1 ");
+        // clang-format on
+        stmt->bind(1, regionID);
+        if (stmt->run()) {
+            result.completedResourceCount = stmt->get<int64_t>(0);
+            result.completedResourceSize = stmt->get<int64_t>(1);
+            result.completedTileCount = stmt->get<int64_t>(2);
+            result.completedTileSize = stmt->get<int64_t>(3);
+        }
+    } else {
+        std::tie(result.completedResourceCount, result.completedResourceSize)
+            = getCompletedResourceCountAndSize(regionID);
+        std::tie(result.completedTileCount, result.completedTileSize)
+            = getCompletedTileCountAndSize(regionID);
+    }
 
     result.completedResourceCount += result.completedTileCount;
     result.completedResourceSize += result.completedTileSize;
@@ -763,6 +1092,322 @@ std::pair<int64_t, int64_t> OfflineDatabase::getCompletedTileCountAndSize(int64_
     return { stmt->get<int64_t>(0), stmt->get<int64_t>(1) };
 }
 
+namespace {
+
+// Archives of offline regions consist of a header with the definition and metadata of the
+// region, followed by one record for each of its resources and tiles, and an end marker. All
+// numbers are little-endian; strings and data are prefixed with their length.
+const char archiveMagic[] = { 'M', 'B', 'G', 'L', 'R', 'G', 'N', '\0' };
+const uint32_t archiveVersion = 1;
+
+// Files are read and written in chunks of this size.
+const std::size_t archiveChunkSize = 1024 * 1024;
+
+enum ArchiveRecord : uint8_t {
+    End = 0,
+    ResourceRecord = 1,
+    TileRecord = 2,
+};
+
+enum ArchiveFlags : uint8_t {
+    HasEtag = 1 << 0,
+    HasExpires = 1 << 1,
+    HasModified = 1 << 2,
+    HasData = 1 << 3,
+    IsCompressed = 1 << 4,
+};
+
+class ArchiveWriter {
+public:
+    explicit ArchiveWriter(const std::string& path)
+        : buffer(archiveChunkSize) {
+        file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Cannot write " + path);
+        }
+        file.exceptions(std::ios::failbit | std::ios::badbit);
+    }
+
+    void bytes(const void* data, std::size_t size) {
+        file.write(static_cast<const char*>(data), size);
+    }
+
+    template <class T>
+    void number(T value) {
+        uint8_t data[sizeof(T)];
+        for (std::size_t i = 0; i < sizeof(T); i++) {
+            data[i] = uint8_t(uint64_t(value) >> (8 * i));
+        }
+        bytes(data, sizeof(T));
+    }
+
+    void string(const void* data, std::size_t size) {
+        number<uint32_t>(size);
+        bytes(data, size);
+    }
+
+    void string(const std::string& value) {
+        string(value.data(), value.size());
+    }
+
+    void timestamp(const Timestamp& value) {
+        number<int64_t>(value.time_since_epoch().count());
+    }
+
+    void close() {
+        file.close();
+    }
+
+private:
+    std::vector<char> buffer;
+    std::ofstream file;
+};
+
+class ArchiveReader {
+public:
+    explicit ArchiveReader(const std::string& path)
+        : buffer(archiveChunkSize) {
+        file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+        file.open(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            throw std::runtime_error("Cannot read " + path);
+        }
+        remaining = file.tellg();
+        file.seekg(0);
+    }
+
+    void bytes(void* data, std::size_t size) {
+        if (size > remaining || !file.read(static_cast<char*>(data), size)) {
+            throw std::runtime_error("Offline region archive is truncated");
+        }
+        remaining -= size;
+    }
+
+    template <class T>
+    T number() {
+        uint8_t data[sizeof(T)];
+        bytes(data, sizeof(T));
+        uint64_t value = 0;
+        for (std::size_t i = 0; i < sizeof(T); i++) {
+            value |= uint64_t(data[i]) << (8 * i);
+        }
+        return T(value);
+    }
+
+    std::string string() {
+        const uint32_t size = number<uint32_t>();
+        if (size > remaining) {
+            throw std::runtime_error("Offline region archive is truncated");
+        }
+        std::string value(size, '\0');
+        bytes(&value[0], size);
+        return value;
+    }
+
+    Timestamp timestamp() {
+        return Timestamp(Seconds(number<int64_t>()));
+    }
+
+private:
+    std::vector<char> buffer;
+    std::ifstream file;
+    uint64_t remaining = 0;
+};
+
+} // namespace
+
+void OfflineDatabase::exportRegion(int64_t regionID, const std::string& archivePath) {
+    // A read transaction, so that the region is written as it is at one point in time.
+    mapbox::sqlite::Transaction transaction(*db);
+
+    // clang-format off
+    Statement region = getStatement(
+        "SELECT definition, description FROM regions WHERE id = ?1");
+    // clang-format on
+
+    region->bind(1, regionID);
+    if (!region->run()) {
+        throw std::runtime_error("No offline region with id " + util::toString(regionID));
+    }
+
+    try {
+        ArchiveWriter writer(archivePath);
+        writer.bytes(archiveMagic, sizeof(archiveMagic));
+        writer.number<uint32_t>(archiveVersion);
+        writer.string(region->get<std::string>(0));
+        const auto metadata = region->get<std::vector<uint8_t>>(1);
+        writer.string(metadata.data(), metadata.size());
+
+        // Writes what the resources and tiles have in common, given the columns etag, expires,
+        // modified, data and compressed, in this order.
+        const auto writeData = [&] (Statement& stmt, int column,
+                                    const std::string* urlTemplate) {
+            const auto etag = stmt->get<optional<std::string>>(column);
+            const auto expires = stmt->get<optional<Timestamp>>(column + 1);
+            const auto modified = stmt->get<optional<Timestamp>>(column + 2);
+            auto data = stmt->get<optional<std::string>>(column + 3);
+            const int compression = stmt->get<int>(column + 4);
+
+            // Other databases don't have the same dictionaries, so such tiles are recompressed.
+            if (data && compression == ZlibDictionary) {
+                auto dictionary = getTileDictionary(*urlTemplate);
+                if (!dictionary) {
+                    throw std::runtime_error("missing compression dictionary of " + *urlTemplate);
+                }
+                data = util::compress(util::decompress(*data, *dictionary));
+            }
+
+            writer.number<uint8_t>((etag ? HasEtag : 0) |
+                                   (expires ? HasExpires : 0) |
+                                   (modified ? HasModified : 0) |
+                                   (data ? HasData : 0) |
+                                   (data && compression != Uncompressed ? IsCompressed : 0));
+            if (etag) {
+                writer.string(*etag);
+            }
+            if (expires) {
+                writer.timestamp(*expires);
+            }
+            if (modified) {
+                writer.timestamp(*modified);
+            }
+            if (data) {
+                writer.string(*data);
+            }
+        };
+
+        // clang-format off
+        Statement resources = getStatement(
+            //        0     1    2      3        4         5     6
+            "SELECT kind, url, etag, expires, modified, data, compressed "
+            "FROM region_resources, resources "
+            "WHERE region_id = ?1 "
+            "  AND resource_id = resources.id ");
+        // clang-format on
+
+        resources->bind(1, regionID);
+        while (resources->run()) {
+            writer.number<uint8_t>(ResourceRecord);
+            writer.number<uint8_t>(resources->get<int>(0));
+            writer.string(resources->get<std::string>(1));
+            writeData(resources, 2, nullptr);
+        }
+
+        // clang-format off
+        Statement tiles = getStatement(
+            //            0           1        2  3  4   5      6        7         8     9
+            "SELECT url_template, pixel_ratio, x, y, z, etag, expires, modified, data, compressed "
+            "FROM region_tiles, tiles "
+            "WHERE region_id = ?1 "
+            "  AND tile_id = tiles.id ");
+        // clang-format on
+
+        tiles->bind(1, regionID);
+        while (tiles->run()) {
+            const std::string urlTemplate = tiles->get<std::string>(0);
+            writer.number<uint8_t>(TileRecord);
+            writer.string(urlTemplate);
+            writer.number<uint8_t>(tiles->get<int>(1));
+            writer.number<int32_t>(tiles->get<int>(2));
+            writer.number<int32_t>(tiles->get<int>(3));
+            writer.number<int8_t>(tiles->get<int>(4));
+            writeData(tiles, 5, &urlTemplate);
+        }
+
+        writer.number<uint8_t>(End);
+        writer.close();
+    } catch (...) {
+        std::remove(archivePath.c_str());
+        throw;
+    }
+
+    transaction.commit();
+}
+
+OfflineRegion OfflineDatabase::importRegion(const std::string& archivePath) {
+    ArchiveReader reader(archivePath);
+
+    char magic[sizeof(archiveMagic)];
+    reader.bytes(magic, sizeof(magic));
+    if (!std::equal(magic, magic + sizeof(magic), archiveMagic)) {
+        throw std::runtime_error(archivePath + " is not an offline region archive");
+    }
+    const uint32_t version = reader.number<uint32_t>();
+    if (version != archiveVersion) {
+        throw std::runtime_error("Unsupported offline region archive version " + util::toString(version));
+    }
+
+    const OfflineRegionDefinition definition = decodeOfflineRegionDefinition(reader.string());
+    const std::string metadata = reader.string();
+
+    optional<OfflineRegion> region;
+    batch([&] {
+        region.emplace(createRegion(definition, OfflineRegionMetadata(metadata.begin(), metadata.end())));
+
+        while (true) {
+            const uint8_t record = reader.number<uint8_t>();
+            if (record == End) {
+                break;
+            }
+
+            optional<Resource> resource;
+            if (record == ResourceRecord) {
+                const uint8_t kind = reader.number<uint8_t>();
+                if (kind == Resource::Kind::Tile || kind > Resource::Kind::SpriteJSON) {
+                    throw std::runtime_error("Offline region archive is corrupt");
+                }
+                resource.emplace(Resource::Kind(kind), reader.string());
+            } else if (record == TileRecord) {
+                Resource::TileData tile;
+                tile.urlTemplate = reader.string();
+                tile.pixelRatio = reader.number<uint8_t>();
+                tile.x = reader.number<int32_t>();
+                tile.y = reader.number<int32_t>();
+                tile.z = reader.number<int8_t>();
+                const std::string url = tile.urlTemplate;
+                resource.emplace(Resource::Kind::Tile, url, std::move(tile));
+            } else {
+                throw std::runtime_error("Offline region archive is corrupt");
+            }
+
+            Response response;
+            const uint8_t flags = reader.number<uint8_t>();
+            if (flags & HasEtag) {
+                response.etag = reader.string();
+            }
+            if (flags & HasExpires) {
+                response.expires = reader.timestamp();
+            }
+            if (flags & HasModified) {
+                response.modified = reader.timestamp();
+            }
+
+            std::unique_ptr<Buffer> data;
+            if (flags & HasData) {
+                data = std::make_unique<Buffer>(reader.string());
+            } else {
+                response.noContent = true;
+            }
+            const Compression compression = (flags & IsCompressed) ? Zlib : Uncompressed;
+
+            // The data is stored as it was exported, without decompressing it.
+            if (resource->kind == Resource::Kind::Tile) {
+                putTile(*resource->tileData, response, data.get(), compression, {});
+            } else {
+                putResource(*resource, response, data.get(), compression, {});
+            }
+            markUsed(region->getID(), *resource);
+        }
+
+        if (getOfflineMapboxTileCount() > offlineMapboxTileCountLimit) {
+            throw std::runtime_error("Importing the offline region would exceed the Mapbox tile count limit");
+        }
+    });
+
+    return std::move(*region);
+}
+
 template <class T>
 T OfflineDatabase::getPragma(const char * sql) {
     Statement stmt = getStatement(sql);
@@ -780,81 +1425,121 @@ T OfflineDatabase::getPragma(const char * sql) {
 // and as it approaches to the hard limit (i.e. the actual file size) we
 // delete an arbitrary number of old cache entries. The free pages approach saves
 // us from calling VACCUM or keeping a running total, which can be costly.
+uint64_t OfflineDatabase::usedSize() {
+    const uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
+    const uint64_t pageCount = getPragma<int64_t>("PRAGMA page_count");
+    return pageSize * (pageCount - getPragma<int64_t>("PRAGMA freelist_count"));
+}
+
 bool OfflineDatabase::evict(uint64_t neededFreeSize) {
     uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
-    uint64_t pageCount = getPragma<int64_t>("PRAGMA page_count");
-
-    auto usedSize = [&] {
-        return pageSize * (pageCount - getPragma<int64_t>("PRAGMA freelist_count"));
-    };
 
     // The addition of pageSize is a fudge factor to account for non `data` column
     // size, and because pages can get fragmented on the database.
     while (usedSize() + neededFreeSize + pageSize > maximumCacheSize) {
-        // clang-format off
-        Statement accessedStmt = getStatement(
-            "SELECT max(accessed) "
-            "FROM ( "
-            "    SELECT accessed "
-            "    FROM resources "
-            "    LEFT JOIN region_resources "
-            "    ON resource_id = resources.id "
-            "    WHERE resource_id IS NULL "
-            "  UNION ALL "
-            "    SELECT accessed "
-            "    FROM tiles "
-            "    LEFT JOIN region_tiles "
-            "    ON tile_id = tiles.id "
-            "    WHERE tile_id IS NULL "
-            "  ORDER BY accessed ASC LIMIT ?1 "
-            ") "
-        );
-        accessedStmt->bind(1, 50);
-        // clang-format on
-        if (!accessedStmt->run()) {
+        if (!evictBatch()) {
             return false;
         }
-        Timestamp accessed = accessedStmt->get<Timestamp>(0);
+    }
 
-        // clang-format off
-        Statement stmt1 = getStatement(
-            "DELETE FROM resources "
-            "WHERE id IN ( "
-            "  SELECT id FROM resources "
-            "  LEFT JOIN region_resources "
-            "  ON resource_id = resources.id "
-            "  WHERE resource_id IS NULL "
-            "  AND accessed <= ?1 "
-            ") ");
-        // clang-format on
-        stmt1->bind(1, accessed);
-        stmt1->run();
-        uint64_t changes1 = stmt1->changes();
+    return true;
+}
 
-        // clang-format off
-        Statement stmt2 = getStatement(
-            "DELETE FROM tiles "
-            "WHERE id IN ( "
-            "  SELECT id FROM tiles "
-            "  LEFT JOIN region_tiles "
-            "  ON tile_id = tiles.id "
-            "  WHERE tile_id IS NULL "
-            "  AND accessed <= ?1 "
-            ") ");
-        // clang-format on
-        stmt2->bind(1, accessed);
-        stmt2->run();
-        uint64_t changes2 = stmt2->changes();
+bool OfflineDatabase::evictBatch() {
+    // clang-format off
+    Statement accessedStmt = getStatement(
+        "SELECT max(accessed) "
+        "FROM ( "
+        "    SELECT accessed "
+        "    FROM resources "
+        "    LEFT JOIN region_resources "
+        "    ON resource_id = resources.id "
+        "    WHERE resource_id IS NULL "
+        "  UNION ALL "
+        "    SELECT accessed "
+        "    FROM tiles "
+        "    LEFT JOIN region_tiles "
+        "    ON tile_id = tiles.id "
+        "    WHERE tile_id IS NULL "
+        "  ORDER BY accessed ASC LIMIT ?1 "
+        ") "
+    );
+    accessedStmt->bind(1, 50);
+    // clang-format on
+    if (!accessedStmt->run()) {
+        return false;
+    }
+    Timestamp accessed = accessedStmt->get<Timestamp>(0);
 
-        // The cached value of offlineTileCount does not need to be updated
-        // here because only non-offline tiles can be removed by eviction.
+    // clang-format off
+    Statement stmt1 = getStatement(
+        "DELETE FROM resources "
+        "WHERE id IN ( "
+        "  SELECT id FROM resources "
+        "  LEFT JOIN region_resources "
+        "  ON resource_id = resources.id "
+        "  WHERE resource_id IS NULL "
+        "  AND accessed <= ?1 "
+        ") ");
+    // clang-format on
+    stmt1->bind(1, accessed);
+    stmt1->run();
+    uint64_t changes1 = stmt1->changes();
 
-        if (changes1 == 0 && changes2 == 0) {
-            return false;
-        }
+    // clang-format off
+    Statement stmt2 = getStatement(
+        "DELETE FROM tiles "
+        "WHERE id IN ( "
+        "  SELECT id FROM tiles "
+        "  LEFT JOIN region_tiles "
+        "  ON tile_id = tiles.id "
+        "  WHERE tile_id IS NULL "
+        "  AND accessed <= ?1 "
+        ") ");
+    // clang-format on
+    stmt2->bind(1, accessed);
+    stmt2->run();
+    uint64_t changes2 = stmt2->changes();
+
+    // The stats don't change here, because only tiles and resources that aren't part of any
+    // region are evicted.
+
+    return changes1 != 0 || changes2 != 0;
+}
+
+bool OfflineDatabase::vacuumBatch() {
+    // Trimming the ambient cache frees the pages that it fills again as it grows back, so those
+    // are kept.
+    const uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
+    const uint64_t keptPages = maximumCacheSize * (cacheHighWatermark - cacheLowWatermark) / pageSize;
+    const uint64_t freePages = getPragma<int64_t>("PRAGMA freelist_count");
+    if (freePages <= keptPages) {
+        return false;
     }
 
-    return true;
+    const uint64_t pages = std::min(freePages - keptPages, vacuumBatchPages);
+    db->exec("PRAGMA incremental_vacuum(" + util::toString(pages) + ")");
+    return freePages - pages > keptPages;
+}
+
+bool OfflineDatabase::trimAmbientCache() {
+    assert(!inBatch);
+
+    const uint64_t used = usedSize();
+    if (!trimming && used <= maximumCacheSize * cacheHighWatermark) {
+        return vacuumBatch();
+    }
+    trimming = used > maximumCacheSize * cacheLowWatermark;
+    if (!trimming) {
+        return vacuumBatch();
+    }
+
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    const bool evicted = evictBatch();
+    transaction.commit();
+
+    trimming = evicted && usedSize() > maximumCacheSize * cacheLowWatermark;
+    return trimming || vacuumBatch();
 }
 
 void OfflineDatabase::setOfflineMapboxTileCountLimit(uint64_t limit) {
@@ -870,15 +1555,20 @@ bool OfflineDatabase::offlineMapboxTileCountLimitExceeded() {
 }
 
 uint64_t OfflineDatabase::getOfflineMapboxTileCount() {
-    // Calculating this on every call would be much simpler than caching and
-    // manually updating the value, but it would make offline downloads an O(n²)
-    // operation, because the database query below involves an index scan of
-    // region_tiles.
-
-    if (offlineMapboxTileCount) {
-        return *offlineMapboxTileCount;
+    if (!hasStats) {
+        return countOfflineMapboxTiles();
     }
 
+    // clang-format off
+    Statement stmt = getStatement(
+        "SELECT mapbox_tile_count FROM offline_stats");
+    // clang-format on
+
+    stmt->run();
+    return stmt->get<int64_t>(0);
+}
+
+uint64_t OfflineDatabase::countOfflineMapboxTiles() {
     // clang-format off
     Statement stmt = getStatement(
         "SELECT COUNT(DISTINCT id) "
@@ -888,9 +1578,7 @@ uint64_t OfflineDatabase::getOfflineMapboxTileCount() {
     // clang-format on
 
     stmt->run();
-
-    offlineMapboxTileCount = stmt->get<int64_t>(0);
-    return *offlineMapboxTileCount;
+    return stmt->get<int64_t>(0);
 }
 
 } // namespace mbgl
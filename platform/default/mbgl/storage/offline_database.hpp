@@ -7,9 +7,11 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/mapbox.hpp>
 
+#include <functional>
 #include <unordered_map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace mapbox {
 namespace sqlite {
@@ -20,21 +22,67 @@ class Statement;
 
 namespace mbgl {
 
+class Buffer;
 class Response;
 class TileID;
 
 class OfflineDatabase : private util::noncopyable {
 public:
+    enum class Mode : bool {
+        ReadWrite,
+        // Connects to an existing database without checking its schema, and doesn't update the
+        // access times of the resources it gets; see markAccessed().
+        ReadOnly,
+    };
+
+    enum class Journal : bool {
+        // A rollback journal with a full sync of every transaction, as databases have always
+        // been written.
+        Rollback,
+        // A write-ahead log with syncs only at checkpoints: a power loss may lose the most
+        // recent transactions, but never corrupts the database. See setJournal().
+        WriteAhead,
+    };
+
+    enum class TileCompression : bool {
+        // Each tile on its own.
+        Zlib,
+        // With a preset dictionary per tileset, trained on the first tiles stored for it; tiles
+        // of vector tilesets share most of their layer names, keys and values. Tiles stored
+        // before the dictionary are kept as they are.
+        Dictionary,
+    };
+
     // Limits affect ambient caching (put) only; resources required by offline
     // regions are exempt.
-    OfflineDatabase(std::string path, uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+    OfflineDatabase(std::string path,
+                    uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE,
+                    Mode = Mode::ReadWrite,
+                    Journal = Journal::Rollback);
     ~OfflineDatabase();
 
     optional<Response> get(const Resource&);
 
+    // Updates the access time of a cached resource, which decides the order of eviction. Access
+    // times are kept to within a few minutes: one that's more recent than that isn't updated, and
+    // neither is it when get() finds the resource.
+    void markAccessed(const Resource&);
+
+    // Makes all writes that fn() makes in a single transaction, which is synced to disk once
+    // rather than once for each of them. If fn() throws, none of its writes are made.
+    void batch(const std::function<void ()>& fn);
+
     // Return value is (inserted, stored size)
     std::pair<bool, uint64_t> put(const Resource&, const Response&);
 
+    // Evicts a batch of the least recently used resources of the ambient cache in a transaction
+    // of its own, and returns whether there are more to evict. Meant to be called repeatedly when
+    // idle: once the cache fills past 90% of its maximum size, it evicts until the cache is back
+    // below 75%, so that put() doesn't have to evict. put() still evicts what it needs to.
+    // Once there is nothing to evict, it returns the pages that deleted regions freed to the file
+    // system instead, a batch at a time.
+    bool trimAmbientCache();
+
     std::vector<OfflineRegion> listRegions();
 
     OfflineRegion createRegion(const OfflineRegionDefinition&,
@@ -42,16 +90,35 @@ public:
 
     OfflineRegionMetadata updateMetadata(const int64_t regionID, const OfflineRegionMetadata&);
 
+    // Deletes the region in a single transaction. The resources that only the region used are
+    // left to the ambient cache, which is evicted back to its maximum size. Only a batch of the
+    // pages that this frees is returned to the file system; see trimAmbientCache().
     void deleteRegion(OfflineRegion&&);
 
     // Return value is (response, stored size)
     optional<std::pair<Response, uint64_t>> getRegionResource(int64_t regionID, const Resource&);
     optional<int64_t> hasRegionResource(int64_t regionID, const Resource&);
+    // Checks many resources in a single transaction, rather than in one for each of them. The
+    // stored size of each resource, if any, is returned in the order of the resources.
+    std::vector<optional<int64_t>> hasRegionResources(int64_t regionID, const std::vector<Resource>&);
     uint64_t putRegionResource(int64_t regionID, const Resource&, const Response&);
 
     OfflineRegionDefinition getRegionDefinition(int64_t regionID);
     OfflineRegionStatus getRegionCompletedStatus(int64_t regionID);
 
+    // Writes the region, with the resources and tiles it uses, to an archive file in a single
+    // sequential pass. Their data is written as stored, compressed or not.
+    void exportRegion(int64_t regionID, const std::string& path);
+
+    // Creates a region from an archive that exportRegion() wrote, in a single transaction: the
+    // region is imported either in full or not at all. Throws if the archive is corrupt, or if
+    // importing it would exceed the Mapbox tile count limit.
+    OfflineRegion importRegion(const std::string& path);
+
+    // Decides how tiles that are put from now on are compressed. Tiles compressed either way
+    // can be read regardless.
+    void setTileCompression(TileCompression);
+
     void setOfflineMapboxTileCountLimit(uint64_t);
     uint64_t getOfflineMapboxTileCountLimit();
     bool offlineMapboxTileCountLimitExceeded();
@@ -64,6 +131,10 @@ private:
     void removeExisting();
     void migrateToVersion3();
     void migrateToVersion5();
+    void migrateToVersion6();
+    void migrateToVersion7();
+    void migrateToVersion8();
+    void setJournal(Journal);
 
     class Statement {
     public:
@@ -80,28 +151,46 @@ private:
 
     Statement getStatement(const char *);
 
+    void markTileAccessed(const Resource::TileData&);
+    void markResourceAccessed(const Resource&);
+
+    // The values of the `compressed` column.
+    enum Compression : int {
+        Uncompressed = 0,
+        Zlib = 1,
+        // Compressed with the dictionary of the tile's url_template in tile_dictionaries.
+        ZlibDictionary = 2,
+    };
+
     optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&);
     optional<int64_t> hasTile(const Resource::TileData&);
     bool putTile(const Resource::TileData&, const Response&,
-                 const std::string&, bool compressed);
+                 const Buffer* data, Compression, optional<int64_t> uncompressedSize);
 
     optional<std::pair<Response, uint64_t>> getResource(const Resource&);
     optional<int64_t> hasResource(const Resource&);
     bool putResource(const Resource&, const Response&,
-                     const std::string&, bool compressed);
+                     const Buffer* data, Compression, optional<int64_t> uncompressedSize);
+
+    std::shared_ptr<const std::string> getTileDictionary(const std::string& urlTemplate);
+    void addTileDictionarySample(const std::string& urlTemplate, const std::string& data);
 
     optional<std::pair<Response, uint64_t>> getInternal(const Resource&);
     optional<int64_t> hasInternal(const Resource&);
     std::pair<bool, uint64_t> putInternal(const Resource&, const Response&, bool evict);
 
-    // Return value is true iff the resource was previously unused by any other regions.
-    bool markUsed(int64_t regionID, const Resource&);
+    void markUsed(int64_t regionID, const Resource&);
 
+    // Count what region_stats and offline_stats keep, for read-only databases of schema versions
+    // before 8, which don't have them.
     std::pair<int64_t, int64_t> getCompletedResourceCountAndSize(int64_t regionID);
     std::pair<int64_t, int64_t> getCompletedTileCountAndSize(int64_t regionID);
+    uint64_t countOfflineMapboxTiles();
 
     const std::string path;
+    const Mode mode;
     std::unique_ptr<::mapbox::sqlite::Database> db;
+    bool inBatch = false;
     std::unordered_map<const char *, std::unique_ptr<::mapbox::sqlite::Statement>> statements;
 
     template <class T>
@@ -109,10 +198,30 @@ private:
 
     uint64_t maximumCacheSize;
 
+    TileCompression tileCompression = TileCompression::Zlib;
+
+    // Dictionaries never change once stored, so they are kept once read.
+    std::unordered_map<std::string, std::shared_ptr<const std::string>> tileDictionaries;
+
+    // Tiles of url templates that have no dictionary yet, to train one on.
+    struct TileDictionarySamples {
+        std::vector<std::string> samples;
+        std::size_t bytes = 0;
+    };
+    std::unordered_map<std::string, TileDictionarySamples> tileDictionarySamples;
+
     uint64_t offlineMapboxTileCountLimit = util::mapbox::DEFAULT_OFFLINE_TILE_COUNT_LIMIT;
-    optional<uint64_t> offlineMapboxTileCount;
+    bool hasStats = true;
 
+    uint64_t usedSize();
     bool evict(uint64_t neededFreeSize);
+    // Evicts the least recently used resources that aren't part of any region, and returns
+    // whether there were any.
+    bool evictBatch();
+    // Returns a batch of free pages to the file system, beyond those that the ambient cache would
+    // fill again, and returns whether there are more.
+    bool vacuumBatch();
+    bool trimming = false;
 };
 
 } // namespace mbgl
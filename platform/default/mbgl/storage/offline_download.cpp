@@ -13,6 +13,8 @@
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tileset.hpp>
 
+#include <algorithm>
+#include <iterator>
 #include <set>
 
 namespace mbgl {
@@ -64,7 +66,7 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
     }
 
     style::Parser parser;
-    parser.parse(*styleResponse->data);
+    parser.parse(styleResponse->data->toString());
 
     result.requiredResourceCountIsPrecise = true;
 
@@ -73,7 +75,8 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
 
         switch (type) {
         case SourceType::Vector:
-        case SourceType::Raster: {
+        case SourceType::Raster:
+        case SourceType::RasterDEM: {
             style::TileSourceImpl* tileSource =
                 static_cast<style::TileSourceImpl*>(source->baseImpl.get());
             const variant<std::string, Tileset>& urlOrTileset = tileSource->getURLOrTileset();
@@ -81,15 +84,15 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
 
             if (urlOrTileset.is<Tileset>()) {
                 result.requiredResourceCount +=
-                    definition.tileCover(type, tileSize, urlOrTileset.get<Tileset>().zoomRange).size();
+                    definition.tileCount(type, tileSize, urlOrTileset.get<Tileset>().zoomRange);
             } else {
                 result.requiredResourceCount += 1;
                 const std::string& url = urlOrTileset.get<std::string>();
                 optional<Response> sourceResponse = offlineDatabase.get(Resource::source(url));
                 if (sourceResponse) {
                     result.requiredResourceCount +=
-                        definition.tileCover(type, tileSize, style::TileSourceImpl::parseTileJSON(
-                            *sourceResponse->data, url, type, tileSize).zoomRange).size();
+                        definition.tileCount(type, tileSize, style::TileSourceImpl::parseTileJSON(
+                            sourceResponse->data->toString(), url, type, tileSize).zoomRange);
                 } else {
                     result.requiredResourceCountIsPrecise = false;
                 }
@@ -127,19 +130,26 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
 void OfflineDownload::activateDownload() {
     status = OfflineRegionStatus();
     status.downloadState = OfflineRegionDownloadState::Active;
+    concurrency = HTTPFileSource::maximumConcurrentRequests();
+    minimumLatency = {};
+    averageLatency = Duration::zero();
+    downloadStarted = {};
+    downloadedCount = 0;
+    downloadedSize = 0;
     status.requiredResourceCount++;
     ensureResource(Resource::style(definition.styleURL), [&](Response styleResponse) {
         status.requiredResourceCountIsPrecise = true;
 
         style::Parser parser;
-        parser.parse(*styleResponse.data);
+        parser.parse(styleResponse.data->toString());
 
         for (const auto& source : parser.sources) {
             SourceType type = source->baseImpl->type;
 
             switch (type) {
             case SourceType::Vector:
-            case SourceType::Raster: {
+            case SourceType::Raster:
+            case SourceType::RasterDEM: {
                 const style::TileSourceImpl* tileSource =
                     static_cast<style::TileSourceImpl*>(source->baseImpl.get());
                 const variant<std::string, Tileset>& urlOrTileset = tileSource->getURLOrTileset();
@@ -155,7 +165,7 @@ void OfflineDownload::activateDownload() {
 
                     ensureResource(Resource::source(url), [=](Response sourceResponse) {
                         queueTiles(type, tileSize, style::TileSourceImpl::parseTileJSON(
-                            *sourceResponse.data, url, type, tileSize));
+                            sourceResponse.data->toString(), url, type, tileSize));
 
                         requiredSourceURLs.erase(url);
                         if (requiredSourceURLs.empty()) {
@@ -199,6 +209,16 @@ void OfflineDownload::activateDownload() {
     });
 }
 
+namespace {
+
+// How many queued resources are checked against the database at once.
+const std::size_t checkBatchSize = 256;
+
+// The fewest concurrent requests that errors and congestion reduce the download to.
+const std::size_t minimumConcurrency = 2;
+
+} // namespace
+
 /*
    Fill up our own request queue by requesting the next few resources. This is called
    when activating the download, or when a request completes successfully.
@@ -215,22 +235,43 @@ void OfflineDownload::activateDownload() {
    of the same type. For instance if a server is unreachable, all the requests to that
    host are going to error. In that case, continuing to try subsequent resources after
    the first few errors is fruitless anyway.
+
+   Queued resources are first checked against the database in batches, so that resuming
+   a download that is mostly complete skips the resources it already has at the cost of a
+   single transaction per batch. The next batch is checked before the resources known to
+   be missing run out, so that there is always another request to make.
 */
 void OfflineDownload::continueDownload() {
-    if (resourcesRemaining.empty() && status.complete()) {
+    if (resourcesRemaining.empty() && tilesRemaining.empty() && resourcesMissing.empty() &&
+        status.complete()) {
         setState(OfflineRegionDownloadState::Inactive);
         return;
     }
 
-    while (!resourcesRemaining.empty() && requests.size() < HTTPFileSource::maximumConcurrentRequests()) {
-        ensureResource(resourcesRemaining.front());
-        resourcesRemaining.pop_front();
+    while (!resourcesMissing.empty() && requests.size() < concurrency) {
+        Resource resource = std::move(resourcesMissing.front());
+        resourcesMissing.pop_front();
+        requestResource(resource);
+        if (status.downloadState != OfflineRegionDownloadState::Active) {
+            return;
+        }
+    }
+
+    if (!checkRequest && (!resourcesRemaining.empty() || !tilesRemaining.empty()) &&
+        resourcesMissing.size() < concurrency) {
+        checkRequest = util::RunLoop::Get()->invokeCancellable([this]() {
+            checkRequest.reset();
+            checkResources();
+        });
     }
 }
 
 void OfflineDownload::deactivateDownload() {
     requiredSourceURLs.clear();
     resourcesRemaining.clear();
+    tilesRemaining.clear();
+    resourcesMissing.clear();
+    checkRequest.reset();
     requests.clear();
 }
 
@@ -240,11 +281,75 @@ void OfflineDownload::queueResource(Resource resource) {
 }
 
 void OfflineDownload::queueTiles(SourceType type, uint16_t tileSize, const Tileset& tileset) {
-    for (const auto& tile : definition.tileCover(type, tileSize, tileset.zoomRange)) {
-        status.requiredResourceCount++;
-        resourcesRemaining.push_back(
-            Resource::tile(tileset.tiles[0], definition.pixelRatio, tile.x, tile.y, tile.z, tileset.scheme));
+    const Range<uint8_t> zoomRange = definition.coveringZoomRange(type, tileSize, tileset.zoomRange);
+    if (zoomRange.min > zoomRange.max) {
+        return;
     }
+
+    status.requiredResourceCount += definition.tileCount(type, tileSize, tileset.zoomRange);
+    tilesRemaining.push_back({ TileURLTemplate(tileset.tiles[0]), tileset.scheme, zoomRange.min, zoomRange.max,
+                               util::TileCover(definition.bounds, zoomRange.min) });
+}
+
+optional<Resource> OfflineDownload::nextTile() {
+    while (!tilesRemaining.empty()) {
+        QueuedTiles& tiles = tilesRemaining.front();
+
+        if (optional<UnwrappedTileID> tile = tiles.cover.next()) {
+            const CanonicalTileID& tileID = tile->canonical;
+            return Resource::tile(tiles.urlTemplate, definition.pixelRatio,
+                                  tileID.x, tileID.y, tileID.z, tiles.scheme);
+        }
+
+        if (tiles.z < tiles.maxZ) {
+            tiles.z++;
+            tiles.cover = util::TileCover(definition.bounds, tiles.z);
+        } else {
+            tilesRemaining.pop_front();
+        }
+    }
+
+    return {};
+}
+
+void OfflineDownload::checkResources() {
+    // Resources other than tiles go first; the tiles are generated to fill up the batch.
+    const std::size_t count = std::min(checkBatchSize, resourcesRemaining.size());
+    std::vector<Resource> batch(std::make_move_iterator(resourcesRemaining.begin()),
+                                std::make_move_iterator(resourcesRemaining.begin() + count));
+    resourcesRemaining.erase(resourcesRemaining.begin(), resourcesRemaining.begin() + count);
+
+    while (batch.size() < checkBatchSize) {
+        optional<Resource> tile = nextTile();
+        if (!tile) {
+            break;
+        }
+        batch.push_back(std::move(*tile));
+    }
+
+    const std::vector<optional<int64_t>> sizes = offlineDatabase.hasRegionResources(id, batch);
+
+    bool changed = false;
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        if (!sizes[i]) {
+            resourcesMissing.push_back(std::move(batch[i]));
+            continue;
+        }
+
+        changed = true;
+        status.completedResourceCount++;
+        status.completedResourceSize += *sizes[i];
+        if (batch[i].kind == Resource::Kind::Tile) {
+            status.completedTileCount += 1;
+            status.completedTileSize += *sizes[i];
+        }
+    }
+
+    if (changed) {
+        observer->statusChanged(status);
+    }
+
+    continueDownload();
 }
 
 void OfflineDownload::ensureResource(const Resource& resource,
@@ -279,40 +384,108 @@ void OfflineDownload::ensureResource(const Resource& resource,
             return;
         }
 
+        requestResource(resource, callback);
+    });
+}
+
+void OfflineDownload::requestResource(const Resource& resource,
+                                      std::function<void(Response)> callback) {
+    if (checkTileCountLimit(resource)) {
+        return;
+    }
+
+    if (!downloadStarted) {
+        downloadStarted = Clock::now();
+    }
+
+    // Resources of the map that share the file source go first.
+    Resource onlineResource = resource;
+    onlineResource.priority = Resource::OfflineDownloadPriority;
+
+    auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
+    *fileRequestsIt = onlineFileSource.request(onlineResource, [=](Response onlineResponse) {
+        adaptConcurrency(onlineResponse);
+
+        if (onlineResponse.error) {
+            observer->responseError(*onlineResponse.error);
+            return;
+        }
+
+        requests.erase(fileRequestsIt);
+
+        if (callback) {
+            callback(onlineResponse);
+        }
+
+        status.completedResourceCount++;
+        uint64_t resourceSize = offlineDatabase.putRegionResource(id, resource, onlineResponse);
+        status.completedResourceSize += resourceSize;
+        if (resource.kind == Resource::Kind::Tile) {
+            status.completedTileCount += 1;
+            status.completedTileSize += resourceSize;
+        }
+        updateDownloadRate(onlineResponse.data ? onlineResponse.data->size() : 0);
+
+        observer->statusChanged(status);
+
         if (checkTileCountLimit(resource)) {
             return;
         }
 
-        auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
-        *fileRequestsIt = onlineFileSource.request(resource, [=](Response onlineResponse) {
-            if (onlineResponse.error) {
-                observer->responseError(*onlineResponse.error);
-                return;
-            }
+        continueDownload();
+    });
+}
 
-            requests.erase(fileRequestsIt);
+void OfflineDownload::adaptConcurrency(const Response& response) {
+    const std::size_t maximumConcurrency = HTTPFileSource::maximumConcurrentRequests();
 
-            if (callback) {
-                callback(onlineResponse);
-            }
+    // An error that is down to the server or the connection is likely shared by the requests
+    // that follow, so back off quickly; the request that failed is retried by the file source.
+    if (response.error) {
+        if (response.error->reason != Response::Error::Reason::NotFound) {
+            concurrency = std::max(minimumConcurrency, concurrency / 2);
+        }
+        return;
+    }
 
-            status.completedResourceCount++;
-            uint64_t resourceSize = offlineDatabase.putRegionResource(id, resource, onlineResponse);
-            status.completedResourceSize += resourceSize;
-            if (resource.kind == Resource::Kind::Tile) {
-                status.completedTileCount += 1;
-                status.completedTileSize += resourceSize;
-            }
+    // Responses that didn't come from the network say nothing about it.
+    if (!response.timing) {
+        return;
+    }
 
-            observer->statusChanged(status);
+    const Duration latency = response.timing->finished - response.timing->started;
+    if (!minimumLatency || latency < *minimumLatency) {
+        minimumLatency = latency;
+    }
+    averageLatency = averageLatency == Duration::zero()
+        ? latency
+        : (averageLatency * 7 + latency) / 8;
+
+    // Latency that grows well beyond the fastest response means that requests are waiting
+    // on each other somewhere on the way, and that more of them won't go any faster.
+    if (averageLatency > *minimumLatency * 2) {
+        concurrency = std::max(minimumConcurrency, concurrency - 1);
+    } else {
+        concurrency = std::min(maximumConcurrency, concurrency + 1);
+    }
+}
 
-            if (checkTileCountLimit(resource)) {
-                return;
-            }
+void OfflineDownload::updateDownloadRate(uint64_t size) {
+    downloadedCount++;
+    downloadedSize += size;
 
-            continueDownload();
-        });
-    });
+    const double elapsed = std::chrono::duration<double>(Clock::now() - *downloadStarted).count();
+    if (elapsed <= 0) {
+        return;
+    }
+
+    status.downloadRate = downloadedSize / elapsed;
+
+    if (status.requiredResourceCountIsPrecise) {
+        const uint64_t remaining = status.requiredResourceCount - status.completedResourceCount;
+        status.estimatedTimeRemaining = std::chrono::duration_cast<Duration>(
+            std::chrono::duration<double>(elapsed * remaining / downloadedCount));
+    }
 }
 
 bool OfflineDownload::checkTileCountLimit(const Resource& resource) {
@@ -2,6 +2,9 @@
 
 #include <mbgl/storage/offline.hpp>
 #include <mbgl/storage/resource.hpp>
+#include <mbgl/util/tile_cover.hpp>
+#include <mbgl/util/tileset.hpp>
+#include <mbgl/util/tile_url_template.hpp>
 
 #include <list>
 #include <unordered_set>
@@ -14,7 +17,6 @@ class OfflineDatabase;
 class FileSource;
 class AsyncRequest;
 class Response;
-class Tileset;
 
 namespace style {
 class Parser;
@@ -46,6 +48,23 @@ private:
      * is deactivated, all in progress requests are cancelled.
      */
     void ensureResource(const Resource&, std::function<void (Response)> = {});
+
+    /*
+     * Check whether the next batch of queued resources is already stored in the database,
+     * all in one go, and move those that aren't to `resourcesMissing`.
+     */
+    void checkResources();
+
+    // Request a resource that isn't stored in the database, and store it.
+    void requestResource(const Resource&, std::function<void (Response)> = {});
+
+    /*
+     * Adapt the number of concurrent requests to the responses: fewer after an error or
+     * when latency grows beyond what an idle connection shows, more otherwise.
+     */
+    void adaptConcurrency(const Response&);
+    void updateDownloadRate(uint64_t size);
+
     bool checkTileCountLimit(const Resource& resource);
 
     int64_t id;
@@ -59,6 +78,32 @@ private:
     std::unordered_set<std::string> requiredSourceURLs;
     std::deque<Resource> resourcesRemaining;
 
+    /*
+     * The tiles of each tile source, enumerated one zoom level at a time as the resources
+     * are checked, rather than queued up front: large regions count millions of tiles.
+     */
+    struct QueuedTiles {
+        TileURLTemplate urlTemplate;
+        Tileset::Scheme scheme;
+        uint8_t z;
+        uint8_t maxZ;
+        util::TileCover cover;
+    };
+    std::deque<QueuedTiles> tilesRemaining;
+    optional<Resource> nextTile();
+
+    // Resources that have been checked and must be requested.
+    std::deque<Resource> resourcesMissing;
+    std::unique_ptr<AsyncRequest> checkRequest;
+
+    std::size_t concurrency = 0;
+    optional<Duration> minimumLatency;
+    Duration averageLatency = Duration::zero();
+
+    optional<TimePoint> downloadStarted;
+    uint64_t downloadedCount = 0;
+    uint64_t downloadedSize = 0;
+
     void queueResource(Resource);
     void queueTiles(SourceType, uint16_t tileSize, const Tileset&);
 };
@@ -7,6 +7,7 @@ CREATE TABLE resources (                   -- Generic table for style, source, s
   etag TEXT,
   data BLOB,
   compressed INTEGER NOT NULL DEFAULT 0,
+  uncompressed_size INTEGER,               -- Size of compressed data once decompressed, if known.
   accessed INTEGER NOT NULL,
   UNIQUE (url)
 );
@@ -23,10 +24,16 @@ CREATE TABLE tiles (
   etag TEXT,
   data BLOB,
   compressed INTEGER NOT NULL DEFAULT 0,
+  uncompressed_size INTEGER,               -- Size of compressed data once decompressed, if known.
   accessed INTEGER NOT NULL,
   UNIQUE (url_template, pixel_ratio, z, x, y)
 );
 
+CREATE TABLE tile_dictionaries (           -- Preset dictionaries that tiles with compressed = 2 are compressed with.
+  url_template TEXT NOT NULL PRIMARY KEY,
+  dictionary BLOB NOT NULL
+);
+
 CREATE TABLE regions (
   id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
   definition TEXT NOT NULL,   -- JSON formatted definition of region. Regions may be of variant types:
@@ -47,6 +54,83 @@ CREATE TABLE region_tiles (
   UNIQUE (region_id, tile_id)
 );
 
+CREATE TABLE region_stats (               -- Completed resources and tiles of each region, kept by the triggers below.
+  region_id INTEGER NOT NULL PRIMARY KEY REFERENCES regions(id) ON DELETE CASCADE,
+  resource_count INTEGER NOT NULL DEFAULT 0,
+  resource_size INTEGER NOT NULL DEFAULT 0,
+  tile_count INTEGER NOT NULL DEFAULT 0,
+  tile_size INTEGER NOT NULL DEFAULT 0
+);
+
+CREATE TABLE offline_stats (              -- A single row.
+  mapbox_tile_count INTEGER NOT NULL      -- Distinct mapbox:// tiles used by any region.
+);
+
+INSERT INTO offline_stats (mapbox_tile_count) VALUES (0);
+
+-- Triggers maintaining the stats, so that reading them doesn't scan the regions
+
+CREATE TRIGGER regions_insert AFTER INSERT ON regions
+BEGIN
+  INSERT INTO region_stats (region_id) VALUES (NEW.id);
+END;
+
+CREATE TRIGGER region_resources_insert AFTER INSERT ON region_resources
+BEGIN
+  UPDATE region_stats
+  SET resource_count = resource_count + 1,
+      resource_size = resource_size + (SELECT IFNULL(LENGTH(data), 0) FROM resources WHERE id = NEW.resource_id)
+  WHERE region_id = NEW.region_id;
+END;
+
+CREATE TRIGGER region_resources_delete AFTER DELETE ON region_resources
+BEGIN
+  UPDATE region_stats
+  SET resource_count = resource_count - 1,
+      resource_size = resource_size - (SELECT IFNULL(LENGTH(data), 0) FROM resources WHERE id = OLD.resource_id)
+  WHERE region_id = OLD.region_id;
+END;
+
+CREATE TRIGGER region_tiles_insert AFTER INSERT ON region_tiles
+BEGIN
+  UPDATE region_stats
+  SET tile_count = tile_count + 1,
+      tile_size = tile_size + (SELECT IFNULL(LENGTH(data), 0) FROM tiles WHERE id = NEW.tile_id)
+  WHERE region_id = NEW.region_id;
+  UPDATE offline_stats
+  SET mapbox_tile_count = mapbox_tile_count + 1
+  WHERE NOT EXISTS (SELECT 1 FROM region_tiles WHERE tile_id = NEW.tile_id AND region_id != NEW.region_id)
+    AND (SELECT url_template FROM tiles WHERE id = NEW.tile_id) LIKE 'mapbox://%';
+END;
+
+CREATE TRIGGER region_tiles_delete AFTER DELETE ON region_tiles
+BEGIN
+  UPDATE region_stats
+  SET tile_count = tile_count - 1,
+      tile_size = tile_size - (SELECT IFNULL(LENGTH(data), 0) FROM tiles WHERE id = OLD.tile_id)
+  WHERE region_id = OLD.region_id;
+  UPDATE offline_stats
+  SET mapbox_tile_count = mapbox_tile_count - 1
+  WHERE NOT EXISTS (SELECT 1 FROM region_tiles WHERE tile_id = OLD.tile_id)
+    AND (SELECT url_template FROM tiles WHERE id = OLD.tile_id) LIKE 'mapbox://%';
+END;
+
+CREATE TRIGGER resources_update_data AFTER UPDATE OF data ON resources
+WHEN IFNULL(LENGTH(NEW.data), 0) != IFNULL(LENGTH(OLD.data), 0)
+BEGIN
+  UPDATE region_stats
+  SET resource_size = resource_size + IFNULL(LENGTH(NEW.data), 0) - IFNULL(LENGTH(OLD.data), 0)
+  WHERE region_id IN (SELECT region_id FROM region_resources WHERE resource_id = NEW.id);
+END;
+
+CREATE TRIGGER tiles_update_data AFTER UPDATE OF data ON tiles
+WHEN IFNULL(LENGTH(NEW.data), 0) != IFNULL(LENGTH(OLD.data), 0)
+BEGIN
+  UPDATE region_stats
+  SET tile_size = tile_size + IFNULL(LENGTH(NEW.data), 0) - IFNULL(LENGTH(OLD.data), 0)
+  WHERE region_id IN (SELECT region_id FROM region_tiles WHERE tile_id = NEW.id);
+END;
+
 -- Indexes for efficient eviction queries
 
 CREATE INDEX resources_accessed
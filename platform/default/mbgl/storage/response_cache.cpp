@@ -0,0 +1,103 @@
+#include <mbgl/storage/response_cache.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <iterator>
+
+namespace mbgl {
+
+ResponseCache::ResponseCache(std::size_t maximumBytes_)
+    : maximumBytes(maximumBytes_) {
+}
+
+void ResponseCache::setMaximumBytes(std::size_t maximumBytes_) {
+    maximumBytes = maximumBytes_;
+    evict();
+}
+
+// Tiles are keyed by their coordinates rather than by their URL, like in the database.
+std::string ResponseCache::key(const Resource& resource) {
+    if (resource.kind == Resource::Kind::Tile && resource.tileData) {
+        const Resource::TileData& tile = *resource.tileData;
+        return tile.urlTemplate + '\n' + util::toString(int(tile.pixelRatio)) + ' ' +
+               util::toString(int(tile.z)) + '/' + util::toString(tile.x) + '/' +
+               util::toString(tile.y);
+    }
+    return resource.url;
+}
+
+optional<Response> ResponseCache::get(const Resource& resource) {
+    auto it = index.find(key(resource));
+    if (it == index.end()) {
+        return {};
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->response;
+}
+
+void ResponseCache::put(const Resource& resource, const Response& response) {
+    if (response.error) {
+        return;
+    }
+
+    std::string resourceKey = key(resource);
+    auto it = index.find(resourceKey);
+
+    if (response.notModified) {
+        if (it != index.end()) {
+            Response& held = it->second->response;
+            held.expires = response.expires;
+            if (response.modified) {
+                held.modified = response.modified;
+            }
+            if (response.etag) {
+                held.etag = response.etag;
+            }
+            entries.splice(entries.begin(), entries, it->second);
+        }
+        return;
+    }
+
+    if (it != index.end()) {
+        erase(it->second);
+    }
+
+    const std::size_t entryBytes = resourceKey.size() + (response.data ? response.data->size() : 0);
+    if (entryBytes > maximumBytes / 4) {
+        return;
+    }
+
+    Response held = response;
+    held.timing = nullptr;
+    entries.push_front(Entry { resourceKey, std::move(held), entryBytes });
+    index.emplace(std::move(resourceKey), entries.begin());
+    bytes += entryBytes;
+    evict();
+}
+
+void ResponseCache::remove(const Resource& resource) {
+    auto it = index.find(key(resource));
+    if (it != index.end()) {
+        erase(it->second);
+    }
+}
+
+void ResponseCache::clear() {
+    entries.clear();
+    index.clear();
+    bytes = 0;
+}
+
+void ResponseCache::erase(Entries::iterator it) {
+    bytes -= it->bytes;
+    index.erase(it->key);
+    entries.erase(it);
+}
+
+void ResponseCache::evict() {
+    while (bytes > maximumBytes) {
+        erase(std::prev(entries.end()));
+    }
+}
+
+} // namespace mbgl
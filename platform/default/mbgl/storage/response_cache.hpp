@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+class Resource;
+
+// Holds the responses that were last read from or stored in the offline database, so that
+// resources which are requested again soon after, such as the glyphs, sprites and TileJSON of a
+// style that another map shows or that is reloaded, are answered without a database lookup. The
+// responses share their data with those that were handed out, and keep their expiration dates
+// and etags, so that stale ones are revalidated as if they had been read from the database.
+// The least recently used responses are evicted once their data takes more than the maximum
+// number of bytes; responses that would take more than a quarter of it aren't held at all.
+class ResponseCache : private util::noncopyable {
+public:
+    explicit ResponseCache(std::size_t maximumBytes);
+
+    void setMaximumBytes(std::size_t);
+    std::size_t getBytes() const { return bytes; }
+
+    // Returns a copy of the response to the resource, without the timing of its request.
+    optional<Response> get(const Resource&);
+
+    // Errors aren't held. Not Modified responses only update the expiration date, modification
+    // date and etag of the response that is held already.
+    void put(const Resource&, const Response&);
+
+    void remove(const Resource&);
+    void clear();
+
+private:
+    struct Entry {
+        std::string key;
+        Response response;
+        std::size_t bytes;
+    };
+
+    // The most recently used first.
+    using Entries = std::list<Entry>;
+
+    static std::string key(const Resource&);
+    void erase(Entries::iterator);
+    void evict();
+
+    std::size_t maximumBytes;
+    std::size_t bytes = 0;
+    Entries entries;
+    std::unordered_map<std::string, Entries::iterator> index;
+};
+
+} // namespace mbgl
@@ -0,0 +1,278 @@
+#include <mbgl/storage/tile_archive.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/buffer.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/mapped_file.hpp>
+#include <mbgl/util/string.hpp>
+
+#include "sqlite3.hpp"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace mbgl {
+
+namespace {
+
+const char sqliteMagic[] = "SQLite format 3";
+const char pmtilesMagic[] = "PMTiles";
+
+bool isGzip(const char* data, std::size_t size) {
+    return size >= 2 && uint8_t(data[0]) == 0x1F && uint8_t(data[1]) == 0x8B;
+}
+
+// MBTiles: tiles are rows of an SQLite database, flipped along y. SQLite reads the database
+// through a memory mapping of its own, rather than reading its pages into its page cache.
+class MBTilesArchive : public TileArchive {
+public:
+    explicit MBTilesArchive(const std::string& path)
+        : db(path, mapbox::sqlite::ReadOnly),
+          statement(prepare(db)) {
+    }
+
+    std::shared_ptr<const Buffer> get(const CanonicalTileID& tileID) override {
+        statement.reset();
+        statement.bind(1, int64_t(tileID.z));
+        statement.bind(2, int64_t(tileID.x));
+        statement.bind(3, int64_t((1ull << tileID.z) - 1 - tileID.y));
+        if (!statement.run()) {
+            return nullptr;
+        }
+
+        // The blob is only valid until the statement is reset, so it can't be handed out as is.
+        auto data = statement.get<std::string>(0);
+        if (isGzip(data.data(), data.size())) {
+            return std::make_shared<Buffer>(util::decompress(data));
+        }
+        return std::make_shared<Buffer>(std::move(data));
+    }
+
+private:
+    static mapbox::sqlite::Statement prepare(mapbox::sqlite::Database& database) {
+        // The upper limit that SQLite is compiled with by default; maps cost address space only.
+        database.exec("PRAGMA mmap_size = 2147418112");
+        return database.prepare(
+            "SELECT tile_data FROM tiles "
+            "WHERE zoom_level = ?1 AND tile_column = ?2 AND tile_row = ?3");
+    }
+
+    mapbox::sqlite::Database db;
+    mapbox::sqlite::Statement statement;
+};
+
+// PMTiles (v3): a header is followed by a root directory, which lists tiles by their position on
+// a Hilbert curve through each zoom level, and may point to leaf directories for parts of the
+// curve. See https://github.com/protomaps/PMTiles/blob/main/spec/v3/spec.md.
+class PMTilesArchive : public TileArchive {
+public:
+    explicit PMTilesArchive(const std::string& path)
+        : file(std::make_shared<const MappedFile>(path)) {
+        if (file->size < headerSize || uint8_t(file->data[7]) != 3) {
+            throw std::runtime_error(path + " is not a PMTiles v3 archive");
+        }
+
+        rootOffset = readUint64(8);
+        rootLength = readUint64(16);
+        leafOffset = readUint64(40);
+        tileOffset = readUint64(56);
+        internalCompression = Compression(file->data[97]);
+        tileCompression = Compression(file->data[98]);
+
+        root = readDirectory(rootOffset, rootLength);
+    }
+
+    std::shared_ptr<const Buffer> get(const CanonicalTileID& tileID) override {
+        const uint64_t id = tileIDOnCurve(tileID);
+
+        const std::vector<Entry>* directory = &root;
+        for (int depth = 0; depth < maxDepth; depth++) {
+            const Entry* entry = find(*directory, id);
+            if (!entry) {
+                return nullptr;
+            }
+            if (entry->runLength > 0) {
+                const char* data = slice(tileOffset + entry->offset, entry->length);
+                if (tileCompression == Compression::None ||
+                    (tileCompression == Compression::Unknown && !isGzip(data, entry->length))) {
+                    return std::make_shared<Buffer>(data, entry->length, file);
+                }
+                return std::make_shared<Buffer>(decompress(tileCompression, data, entry->length));
+            }
+            directory = &leaf(leafOffset + entry->offset, entry->length);
+        }
+
+        throw std::runtime_error("PMTiles directories are nested too deeply");
+    }
+
+private:
+    enum class Compression : uint8_t {
+        Unknown = 0,
+        None = 1,
+        Gzip = 2,
+    };
+
+    struct Entry {
+        uint64_t id;
+        uint64_t offset;
+        uint32_t length;
+        // The number of consecutive tiles with this data, or 0 for a leaf directory.
+        uint32_t runLength;
+    };
+
+    static constexpr std::size_t headerSize = 127;
+    static constexpr int maxDepth = 4;
+    static constexpr std::size_t maxLeaves = 64;
+
+    static uint64_t tileIDOnCurve(const CanonicalTileID& tileID) {
+        // The tiles of all lower zoom levels come first.
+        uint64_t id = ((1ull << (2 * tileID.z)) - 1) / 3;
+
+        uint64_t x = tileID.x;
+        uint64_t y = tileID.y;
+        for (uint64_t s = (1ull << tileID.z) / 2; s > 0; s /= 2) {
+            const uint64_t rx = (x & s) > 0;
+            const uint64_t ry = (y & s) > 0;
+            id += s * s * ((3 * rx) ^ ry);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = s - 1 - x;
+                    y = s - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return id;
+    }
+
+    static const Entry* find(const std::vector<Entry>& directory, uint64_t id) {
+        auto it = std::upper_bound(directory.begin(), directory.end(), id,
+                                   [] (uint64_t id_, const Entry& entry) { return id_ < entry.id; });
+        if (it == directory.begin()) {
+            return nullptr;
+        }
+        --it;
+        if (it->runLength == 0 || id - it->id < it->runLength) {
+            return &*it;
+        }
+        return nullptr;
+    }
+
+    static std::string decompress(Compression compression, const char* data, std::size_t size) {
+        switch (compression) {
+        case Compression::Unknown:
+            return isGzip(data, size) ? util::decompress(data, size) : std::string(data, size);
+        case Compression::None:
+            return std::string(data, size);
+        case Compression::Gzip:
+            return util::decompress(data, size);
+        }
+        throw std::runtime_error("Unsupported PMTiles compression " + util::toString(int(compression)));
+    }
+
+    const char* slice(uint64_t offset, uint64_t length) const {
+        if (offset > file->size || length > file->size - offset) {
+            throw std::runtime_error("PMTiles archive is truncated");
+        }
+        return file->data + offset;
+    }
+
+    uint64_t readUint64(std::size_t offset) const {
+        uint64_t value = 0;
+        for (std::size_t i = 0; i < 8; i++) {
+            value |= uint64_t(uint8_t(file->data[offset + i])) << (8 * i);
+        }
+        return value;
+    }
+
+    std::vector<Entry> readDirectory(uint64_t offset, uint64_t length) const {
+        const std::string data = decompress(internalCompression, slice(offset, length), length);
+        const char* pos = data.data();
+        const char* const end = pos + data.size();
+
+        const auto varint = [&] () {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (pos == end) {
+                    throw std::runtime_error("PMTiles directory is truncated");
+                }
+                const uint8_t byte = *pos++;
+                value |= uint64_t(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            throw std::runtime_error("PMTiles directory is corrupt");
+        };
+
+        const uint64_t count = varint();
+        if (count > data.size()) {
+            throw std::runtime_error("PMTiles directory is corrupt");
+        }
+
+        std::vector<Entry> entries(count);
+        uint64_t id = 0;
+        for (auto& entry : entries) {
+            id += varint();
+            entry.id = id;
+        }
+        for (auto& entry : entries) {
+            entry.runLength = varint();
+        }
+        for (auto& entry : entries) {
+            entry.length = varint();
+        }
+        for (std::size_t i = 0; i < entries.size(); i++) {
+            const uint64_t value = varint();
+            // Zero means the data follows right after the data of the previous entry.
+            entries[i].offset = (value == 0 && i > 0)
+                ? entries[i - 1].offset + entries[i - 1].length
+                : value - 1;
+        }
+        return entries;
+    }
+
+    const std::vector<Entry>& leaf(uint64_t offset, uint64_t length) {
+        auto it = leaves.find(offset);
+        if (it == leaves.end()) {
+            if (leaves.size() >= maxLeaves) {
+                leaves.clear();
+            }
+            it = leaves.emplace(offset, readDirectory(offset, length)).first;
+        }
+        return it->second;
+    }
+
+    // Shared with the buffers of uncompressed tiles, which point into it.
+    const std::shared_ptr<const MappedFile> file;
+    uint64_t rootOffset;
+    uint64_t rootLength;
+    uint64_t leafOffset;
+    uint64_t tileOffset;
+    Compression internalCompression;
+    Compression tileCompression;
+
+    std::vector<Entry> root;
+    std::map<uint64_t, std::vector<Entry>> leaves;
+};
+
+} // namespace
+
+std::unique_ptr<TileArchive> TileArchive::open(const std::string& path) {
+    std::string magic;
+    {
+        const MappedFile file(path);
+        magic.assign(file.data, std::min<std::size_t>(file.size, sizeof(sqliteMagic)));
+    }
+
+    if (magic.compare(0, sizeof(pmtilesMagic) - 1, pmtilesMagic) == 0) {
+        return std::make_unique<PMTilesArchive>(path);
+    } else if (magic == std::string(sqliteMagic, sizeof(sqliteMagic))) {
+        return std::make_unique<MBTilesArchive>(path);
+    } else {
+        throw std::runtime_error(path + " is neither an MBTiles nor a PMTiles archive");
+    }
+}
+
+} // namespace mbgl
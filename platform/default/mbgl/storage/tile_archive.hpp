@@ -0,0 +1,29 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class Buffer;
+class CanonicalTileID;
+
+// A read-only archive of the tiles of a tileset, either an MBTiles database or a PMTiles (v3)
+// file. Archives are memory-mapped, so that reading a tile costs no more than decompressing
+// it; tiles that aren't compressed are handed out as buffers that point into the mapping.
+class TileArchive : private util::noncopyable {
+public:
+    virtual ~TileArchive() = default;
+
+    // Opens the archive at the given path, telling the formats apart by their content. Throws
+    // if the file can't be read or is neither format.
+    static std::unique_ptr<TileArchive> open(const std::string& path);
+
+    // Returns the decompressed data of the tile, or nullptr if the archive doesn't contain it.
+    // Throws if the archive is corrupt.
+    virtual std::shared_ptr<const Buffer> get(const CanonicalTileID&) = 0;
+};
+
+} // namespace mbgl
@@ -10,6 +10,7 @@ ThreadPool::ThreadPool(std::size_t count) {
     for (std::size_t i = 0; i < count; ++i) {
         threads.emplace_back([this, i]() {
             platform::setCurrentThreadName(std::string{ "Worker " } + util::toString(i + 1));
+            platform::ThreadPlacement currentPlacement = platform::ThreadPlacement::Any;
 
             while (true) {
                 std::unique_lock<std::mutex> lock(mutex);
@@ -22,10 +23,16 @@ ThreadPool::ThreadPool(std::size_t count) {
                     return;
                 }
 
-                auto mailbox = queue.front();
+                auto mailbox = queue.top().mailbox;
                 queue.pop();
                 lock.unlock();
 
+                const platform::ThreadPlacement desiredPlacement = placement;
+                if (desiredPlacement != currentPlacement) {
+                    platform::setCurrentThreadPlacement(desiredPlacement);
+                    currentPlacement = desiredPlacement;
+                }
+
                 Mailbox::maybeReceive(mailbox);
             }
         });
@@ -46,12 +53,27 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    int32_t priority = 0;
+    if (auto locked = mailbox.lock()) {
+        priority = locked->getPriority();
+    }
+
     {
         std::lock_guard<std::mutex> lock(mutex);
-        queue.push(mailbox);
+        queue.push({ priority, sequence++, std::move(mailbox) });
     }
 
     cv.notify_one();
 }
 
+void ThreadPool::setInteractive(bool interactive) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (interactive) {
+        interactions++;
+    } else if (interactions > 0) {
+        interactions--;
+    }
+    placement = interactions > 0 ? platform::ThreadPlacement::Performance : platform::ThreadPlacement::Any;
+}
+
 } // namespace mbgl
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/platform.hpp>
 
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -16,12 +19,32 @@ public:
 
     void schedule(std::weak_ptr<Mailbox>) override;
 
+    // Moves the threads to the fastest cores while any interaction is in progress. Each thread
+    // moves before it receives its next message.
+    void setInteractive(bool) override;
+
 private:
+    struct Item {
+        int32_t priority;
+        uint64_t sequence;
+        std::weak_ptr<Mailbox> mailbox;
+
+        // Orders by descending priority, then by ascending sequence number.
+        bool operator<(const Item& other) const {
+            return priority != other.priority ? priority < other.priority
+                                              : sequence > other.sequence;
+        }
+    };
+
     std::vector<std::thread> threads;
-    std::queue<std::weak_ptr<Mailbox>> queue;
+    std::priority_queue<Item> queue;
+    uint64_t sequence { 0 };
     std::mutex mutex;
     std::condition_variable cv;
     bool terminate { false };
+
+    std::size_t interactions { 0 };
+    std::atomic<platform::ThreadPlacement> placement { platform::ThreadPlacement::Any };
 };
 
 } // namespace mbgl
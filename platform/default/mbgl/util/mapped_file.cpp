@@ -0,0 +1,56 @@
+#include <mbgl/util/mapped_file.hpp>
+#include <mbgl/util/buffer.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mbgl {
+
+MappedFile::MappedFile(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+    }
+
+    struct stat buf;
+    if (fstat(fd, &buf) == -1 || !S_ISREG(buf.st_mode)) {
+        ::close(fd);
+        throw std::runtime_error(path + " is not a file");
+    }
+
+    size = buf.st_size;
+    if (size) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            const int error = errno;
+            ::close(fd);
+            throw std::runtime_error("Cannot map " + path + ": " + std::strerror(error));
+        }
+        data = static_cast<const char*>(mapping);
+    }
+
+    // The mapping stays valid without the file descriptor.
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data) {
+        munmap(const_cast<char*>(data), size);
+    }
+}
+
+std::shared_ptr<const Buffer> MappedFile::read(const std::string& path) {
+    auto file = std::make_shared<const MappedFile>(path);
+    if (!file->data) {
+        return std::make_shared<Buffer>(std::string());
+    }
+    return std::make_shared<Buffer>(file->data, file->size, file);
+}
+
+} // namespace mbgl
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class Buffer;
+
+// A read-only memory mapping of a whole file. Pages are read in as they are touched, and stay
+// shared with the page cache, so that handing out Buffers into the mapping copies nothing. Throws
+// std::runtime_error if the file can't be opened or mapped, or isn't a regular file.
+class MappedFile : private util::noncopyable {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    // Maps a file into a Buffer that keeps the mapping alive for as long as it is shared.
+    static std::shared_ptr<const Buffer> read(const std::string& path);
+
+    // Null for empty files, which can't be mapped.
+    const char* data = nullptr;
+    std::size_t size = 0;
+};
+
+} // namespace mbgl
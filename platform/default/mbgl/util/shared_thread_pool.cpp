@@ -1,12 +1,19 @@
 #include "shared_thread_pool.hpp"
 
+#include <mbgl/util/platform.hpp>
+
+#include <algorithm>
+
 namespace mbgl {
 
 std::shared_ptr<ThreadPool> sharedThreadPool() {
     static std::weak_ptr<ThreadPool> weak;
     auto pool = weak.lock();
     if (!pool) {
-        weak = pool = std::make_shared<ThreadPool>(4);
+        // As many workers as the device has fast cores, so that none of them is left behind on a
+        // slow core while the others finish, but at least two and at most four.
+        const std::size_t count = std::min<std::size_t>(std::max<std::size_t>(platform::getPerformanceCoreCount(), 2), 4);
+        weak = pool = std::make_shared<ThreadPool>(count);
     }
     return pool;
 }
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+/*
+    A lock-free, single-owner work-stealing deque of pointers (Chase & Lev, "Dynamic Circular
+    Work-Stealing Deque", with the memory orderings from Lê et al., "Correct and Efficient
+    Work-Stealing for Weak Memory Models").
+
+    Only the owning thread may call `push` and `pop`, which operate on the bottom of the deque
+    in LIFO order. Any thread may call `steal`, which takes from the top in FIFO order. Both
+    `pop` and `steal` return `nullptr` when the deque is empty or when they lost a race for
+    the last element.
+
+    Arrays that have been outgrown are retained until the deque is destroyed, since a
+    concurrent thief may still be reading from them.
+*/
+template <class T>
+class WorkStealingDeque : private util::noncopyable {
+public:
+    explicit WorkStealingDeque(std::int64_t capacity = 64)
+        : array(new Array(capacity)) {
+        arrays.emplace_back(array.load(std::memory_order_relaxed));
+    }
+
+    void push(T* item) {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+
+        if (b - t > a->capacity - 1) {
+            a = grow(a, b, t);
+        }
+
+        a->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    T* pop() {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Empty.
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = a->get(b);
+        if (t == b) {
+            // Last element; race against thieves for it.
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    T* steal() {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return nullptr;
+        }
+
+        Array* a = array.load(std::memory_order_acquire);
+        T* item = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    bool empty() const {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = top.load(std::memory_order_relaxed);
+        return b <= t;
+    }
+
+private:
+    struct Array {
+        explicit Array(std::int64_t capacity_)
+            : capacity(capacity_),
+              mask(capacity_ - 1),
+              items(new std::atomic<T*>[capacity_]) {
+            // The capacity must be a power of two.
+            assert((capacity & mask) == 0);
+        }
+
+        T* get(std::int64_t i) const {
+            return items[i & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t i, T* item) {
+            items[i & mask].store(item, std::memory_order_relaxed);
+        }
+
+        const std::int64_t capacity;
+        const std::int64_t mask;
+        std::unique_ptr<std::atomic<T*>[]> items;
+    };
+
+    Array* grow(Array* old, std::int64_t b, std::int64_t t) {
+        auto grown = std::make_unique<Array>(old->capacity * 2);
+        for (std::int64_t i = t; i < b; ++i) {
+            grown->put(i, old->get(i));
+        }
+        Array* result = grown.get();
+        arrays.push_back(std::move(grown));
+        array.store(result, std::memory_order_release);
+        return result;
+    }
+
+    std::atomic<std::int64_t> top { 0 };
+    std::atomic<std::int64_t> bottom { 0 };
+    std::atomic<Array*> array;
+
+    // Owner-only; keeps every array alive for the lifetime of the deque.
+    std::vector<std::unique_ptr<Array>> arrays;
+};
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,137 @@
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/util/platform.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+// Number of unsuccessful rounds over all deques before a worker goes to sleep.
+static constexpr std::size_t spinRounds = 64;
+
+WorkStealingThreadPool::WorkStealingThreadPool(std::size_t count) {
+    assert(count > 0);
+
+    workers.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        workers.emplace_back(std::make_unique<Worker>(i));
+    }
+
+    threads.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        threads.emplace_back([this, i]() {
+            platform::setCurrentThreadName(std::string{ "Worker " } + util::toString(i + 1));
+            run(*workers[i]);
+        });
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        terminate = true;
+    }
+
+    cv.notify_all();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Release any tasks that were still queued.
+    for (auto& worker : workers) {
+        while (Task* task = worker->deque.pop()) {
+            delete task;
+        }
+    }
+}
+
+void WorkStealingThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    auto task = std::make_unique<Task>(std::move(mailbox));
+
+    if (Worker* worker = current.get()) {
+        worker->deque.push(task.release());
+    } else {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        injection.push(std::move(task));
+    }
+
+    pending.fetch_add(1);
+    notify();
+}
+
+void WorkStealingThreadPool::notify() {
+    // Both `pending` and `sleeping` are sequentially consistent: either a worker about to sleep
+    // observes the new task, or we observe the sleeper and wake it up.
+    if (sleeping.load() > 0) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        cv.notify_one();
+    }
+}
+
+void WorkStealingThreadPool::run(Worker& worker) {
+    current.set(&worker);
+
+    std::minstd_rand random(static_cast<std::minstd_rand::result_type>(worker.index + 1));
+    std::size_t idleRounds = 0;
+
+    while (!terminate) {
+        if (Task* task = take(worker, random)) {
+            pending.fetch_sub(1);
+            idleRounds = 0;
+
+            std::unique_ptr<Task> owned(task);
+            Mailbox::maybeReceive(std::move(*owned));
+            continue;
+        }
+
+        if (++idleRounds < spinRounds) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        sleeping.fetch_add(1);
+        cv.wait(lock, [this] {
+            return pending.load() > 0 || terminate;
+        });
+        sleeping.fetch_sub(1);
+        idleRounds = 0;
+    }
+
+    current.set(nullptr);
+}
+
+WorkStealingThreadPool::Task* WorkStealingThreadPool::take(Worker& worker, std::minstd_rand& random) {
+    if (Task* task = worker.deque.pop()) {
+        return task;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        if (!injection.empty()) {
+            Task* task = injection.front().release();
+            injection.pop();
+            return task;
+        }
+    }
+
+    const std::size_t count = workers.size();
+    const std::size_t start = random() % count;
+    for (std::size_t i = 0; i < count; ++i) {
+        Worker& victim = *workers[(start + i) % count];
+        if (&victim == &worker) {
+            continue;
+        }
+        if (Task* task = victim.deque.steal()) {
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
+} // namespace mbgl
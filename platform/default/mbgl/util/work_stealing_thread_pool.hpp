@@ -0,0 +1,67 @@
+#pragma once
+
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/thread_local.hpp>
+#include <mbgl/util/work_stealing_deque.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    A `Scheduler` that distributes mailboxes over a fixed set of worker threads, each of which
+    owns a lock-free work-stealing deque.
+
+    Mailboxes scheduled from a worker thread -- most commonly a mailbox re-scheduling itself at
+    the end of `Mailbox::receive()`, or an actor messaging another actor -- are pushed onto that
+    worker's own deque and are likely to be received by the same thread next, keeping the
+    actor's state warm in that core's cache. Mailboxes scheduled from any other thread go into
+    a shared injection queue. Idle workers first drain their own deque, then the injection
+    queue, and then try to steal from the deques of randomly chosen peers before going to sleep.
+
+    It preserves the same per-mailbox ordering guarantees as `ThreadPool`.
+*/
+class WorkStealingThreadPool : public Scheduler {
+public:
+    WorkStealingThreadPool(std::size_t count);
+    ~WorkStealingThreadPool() override;
+
+    void schedule(std::weak_ptr<Mailbox>) override;
+
+private:
+    using Task = std::weak_ptr<Mailbox>;
+
+    struct Worker {
+        Worker(std::size_t index_) : index(index_) {}
+
+        const std::size_t index;
+        util::WorkStealingDeque<Task> deque;
+    };
+
+    void run(Worker&);
+    Task* take(Worker&, std::minstd_rand&);
+    void notify();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    util::ThreadLocal<Worker> current;
+
+    std::mutex injectionMutex;
+    std::queue<std::unique_ptr<Task>> injection;
+
+    // Number of tasks that have been scheduled but not yet taken by a worker.
+    std::atomic<std::size_t> pending { 0 };
+    std::atomic<std::size_t> sleeping { 0 };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<bool> terminate { false };
+};
+
+} // namespace mbgl
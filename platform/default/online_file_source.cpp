@@ -17,12 +17,21 @@
 
 #include <algorithm>
 #include <cassert>
-#include <list>
+#include <map>
+#include <set>
 #include <unordered_set>
-#include <unordered_map>
 
 namespace mbgl {
 
+namespace {
+
+// Requests are refreshed once their resources expire, at most this long after, together with
+// those of the other resources that expire in the meantime, so that the tiles of live data
+// arrive in batches rather than one after another.
+const Duration refreshWindow = Seconds(2);
+
+} // namespace
+
 class OnlineFileRequest : public AsyncRequest {
 public:
     using Callback = std::function<void (Response)>;
@@ -31,6 +40,7 @@ public:
     ~OnlineFileRequest() override;
 
     void networkIsReachableAgain();
+    void setPriority(int32_t) override;
     void schedule();
     void schedule(optional<Timestamp> expires);
     void completed(Response);
@@ -51,6 +61,14 @@ public:
     uint32_t failedRequests = 0;
     Response::Error::Reason failedRequestReason = Response::Error::Reason::Success;
     optional<Timestamp> retryAfter;
+
+    // When the request became ready to be activated, and the order in which it did, which breaks
+    // ties between pending requests of the same priority.
+    TimePoint queued;
+    uint64_t sequence = 0;
+
+    // When the batch that the request is waiting to be refreshed with is due, if it is.
+    optional<TimePoint> refreshDue;
 };
 
 class OnlineFileSource::Impl {
@@ -82,16 +100,24 @@ public:
 
     void remove(OnlineFileRequest* request) {
         allRequests.erase(request);
+        cancelRefresh(request);
         if (activeRequests.erase(request)) {
             activatePendingRequest();
         } else {
-            auto it = pendingRequestsMap.find(request);
-            if (it != pendingRequestsMap.end()) {
-                pendingRequestsList.erase(it->second);
-                pendingRequestsMap.erase(it);
-            }
+            // Requests that are cancelled while they wait, such as those for tiles that left the
+            // viewport, give up their place right away.
+            pendingRequests.erase(request);
+        }
+    }
+
+    void setPriority(OnlineFileRequest* request, int32_t priority) {
+        // The order of pending requests depends on their priority, so they are taken out while
+        // it changes.
+        const bool pending = pendingRequests.erase(request);
+        request->resource.priority = priority;
+        if (pending) {
+            pendingRequests.insert(request);
         }
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
     }
 
     void activateOrQueueRequest(OnlineFileRequest* request) {
@@ -99,6 +125,8 @@ public:
         assert(activeRequests.find(request) == activeRequests.end());
         assert(!request->request);
 
+        request->queued = Clock::now();
+        request->sequence = nextSequence++;
         if (activeRequests.size() >= HTTPFileSource::maximumConcurrentRequests()) {
             queueRequest(request);
         } else {
@@ -107,38 +135,71 @@ public:
     }
 
     void queueRequest(OnlineFileRequest* request) {
-        auto it = pendingRequestsList.insert(pendingRequestsList.end(), request);
-        pendingRequestsMap.emplace(request, std::move(it));
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
+        pendingRequests.insert(request);
     }
 
     void activateRequest(OnlineFileRequest* request) {
         activeRequests.insert(request);
+        const TimePoint started = Clock::now();
         request->request = httpFileSource.request(request->resource, [=] (Response response) {
+            auto timing = std::make_unique<Response::Timing>();
+            timing->queued = request->queued;
+            timing->started = started;
+            timing->finished = Clock::now();
+            if (!response.error && response.data) {
+                NetworkStatus::RecordTransfer(response.data->size(), timing->finished - started);
+            }
+            response.timing = std::move(timing);
+
             activeRequests.erase(request);
             activatePendingRequest();
             request->request.reset();
             request->completed(response);
         });
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
     }
 
     void activatePendingRequest() {
-        if (pendingRequestsList.empty()) {
+        if (pendingRequests.empty()) {
             return;
         }
 
-        OnlineFileRequest* request = pendingRequestsList.front();
-        pendingRequestsList.pop_front();
-
-        pendingRequestsMap.erase(request);
+        OnlineFileRequest* request = *pendingRequests.begin();
+        pendingRequests.erase(pendingRequests.begin());
 
         activateRequest(request);
-        assert(pendingRequestsMap.size() == pendingRequestsList.size());
+    }
+
+    void scheduleRefresh(OnlineFileRequest* request, TimePoint due) {
+        assert(!request->refreshDue);
+
+        // Joins the first batch that isn't due before the resource expires, if it's due soon
+        // enough; otherwise starts a batch that others may join.
+        auto it = refreshes.lower_bound(due);
+        if (it == refreshes.end() || it->first > due + refreshWindow) {
+            it = refreshes.emplace(due + refreshWindow, std::unordered_set<OnlineFileRequest*>()).first;
+            if (it == refreshes.begin()) {
+                startRefreshTimer();
+            }
+        }
+        it->second.insert(request);
+        request->refreshDue = it->first;
+    }
+
+    void cancelRefresh(OnlineFileRequest* request) {
+        if (!request->refreshDue) {
+            return;
+        }
+        auto it = refreshes.find(*request->refreshDue);
+        assert(it != refreshes.end());
+        it->second.erase(request);
+        if (it->second.empty()) {
+            refreshes.erase(it);
+        }
+        request->refreshDue = {};
     }
 
     bool isPending(OnlineFileRequest* request) {
-        return pendingRequestsMap.find(request) != pendingRequestsMap.end();
+        return pendingRequests.find(request) != pendingRequests.end();
     }
 
     bool isActive(OnlineFileRequest* request) {
@@ -149,6 +210,12 @@ public:
         resourceTransform = std::move(transform);
     }
 
+    void preconnect(const std::string& url) {
+        if (!resourceTransform && NetworkStatus::Get() != NetworkStatus::Status::Offline) {
+            httpFileSource.preconnect(url);
+        }
+    }
+
 private:
     void networkIsReachableAgain() {
         for (auto& request : allRequests) {
@@ -156,8 +223,40 @@ private:
         }
     }
 
+    void startRefreshTimer() {
+        if (refreshes.empty()) {
+            refreshTimer.stop();
+            return;
+        }
+        const Duration timeout = std::max(Duration::zero(), refreshes.begin()->first - Clock::now());
+        refreshTimer.start(timeout, Duration::zero(), [this] { refresh(); });
+    }
+
+    void refresh() {
+        const TimePoint now = Clock::now();
+        while (!refreshes.empty() && refreshes.begin()->first <= now) {
+            std::unordered_set<OnlineFileRequest*> batch = std::move(refreshes.begin()->second);
+            refreshes.erase(refreshes.begin());
+            for (auto request : batch) {
+                request->refreshDue = {};
+                activateOrQueueRequest(request);
+            }
+        }
+        startRefreshTimer();
+    }
+
     ResourceTransform resourceTransform;
 
+    // Orders pending requests by priority, and then by the order they became pending in.
+    struct PendingOrder {
+        bool operator()(const OnlineFileRequest* a, const OnlineFileRequest* b) const {
+            if (a->resource.priority != b->resource.priority) {
+                return a->resource.priority > b->resource.priority;
+            }
+            return a->sequence < b->sequence;
+        }
+    };
+
     /**
      * The lifetime of a request is:
      *
@@ -167,12 +266,18 @@ private:
      * 4. Back to #1
      *
      * Requests in any state are in `allRequests`. Requests in the pending state are in
-     * `pendingRequests`. Requests in the active state are in `activeRequests`.
+     * `pendingRequests`, highest priority first. Requests in the active state are in
+     * `activeRequests`.
      */
     std::unordered_set<OnlineFileRequest*> allRequests;
-    std::list<OnlineFileRequest*> pendingRequestsList;
-    std::unordered_map<OnlineFileRequest*, std::list<OnlineFileRequest*>::iterator> pendingRequestsMap;
+    std::set<OnlineFileRequest*, PendingOrder> pendingRequests;
     std::unordered_set<OnlineFileRequest*> activeRequests;
+    uint64_t nextSequence = 0;
+
+    // Requests waiting for their resources to expire, in batches by when they are refreshed.
+    // A single timer fires for the earliest batch.
+    std::map<TimePoint, std::unordered_set<OnlineFileRequest*>> refreshes;
+    util::Timer refreshTimer;
 
     HTTPFileSource httpFileSource;
     util::AsyncTask reachability { std::bind(&Impl::networkIsReachableAgain, this) };
@@ -220,6 +325,10 @@ void OnlineFileSource::setResourceTransform(ResourceTransform&& transform) {
     impl->setResourceTransform(std::move(transform));
 }
 
+void OnlineFileSource::preconnect(const std::string& url) {
+    impl->preconnect(util::mapbox::normalizeTileURL(apiBaseURL, url, accessToken));
+}
+
 OnlineFileRequest::OnlineFileRequest(Resource resource_, Callback callback_, OnlineFileSource::Impl& impl_)
     : impl(impl_),
       resource(std::move(resource_)),
@@ -281,6 +390,9 @@ void OnlineFileRequest::schedule(optional<Timestamp> expires) {
         return;
     }
 
+    timer.stop();
+    impl.cancelRefresh(this);
+
     // If we're not being asked for a forced refresh, calculate a timeout that depends on how many
     // consecutive errors we've encountered, and on the expiration time, if present.
     Duration timeout = std::min(
@@ -300,6 +412,13 @@ void OnlineFileRequest::schedule(optional<Timestamp> expires) {
         timeout = Duration::max();
     }
 
+    // Refreshes of resources that are merely waiting to expire are batched with others; retries
+    // keep their own timers, since their backoff is specific to the request.
+    if (timeout > Duration::zero() && timeout != Duration::max() && failedRequests == 0) {
+        impl.scheduleRefresh(this, Clock::now() + timeout);
+        return;
+    }
+
     timer.start(timeout, Duration::zero(), [&] {
         impl.activateOrQueueRequest(this);
     });
@@ -353,6 +472,12 @@ void OnlineFileRequest::completed(Response response) {
     callback_(response);
 }
 
+void OnlineFileRequest::setPriority(int32_t priority) {
+    if (priority != resource.priority) {
+        impl.setPriority(this, priority);
+    }
+}
+
 void OnlineFileRequest::networkIsReachableAgain() {
     // We need all requests to fail at least once before we are going to start retrying
     // them, and we only immediately restart request that failed due to connection issues.
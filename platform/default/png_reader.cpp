@@ -1,5 +1,4 @@
 #include <mbgl/util/image.hpp>
-#include <mbgl/util/premultiply.hpp>
 #include <mbgl/util/char_array_buffer.hpp>
 #include <mbgl/util/logging.hpp>
 
@@ -62,7 +61,7 @@ struct png_struct_guard {
     png_infopp i_;
 };
 
-PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
+UnassociatedImage decodePNG(const uint8_t* data, size_t size) {
     util::CharArrayBuffer dataBuffer { reinterpret_cast<const char*>(data), size };
     std::istream stream(&dataBuffer);
 
@@ -136,7 +135,7 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
 
     png_read_end(png_ptr, nullptr);
 
-    return util::premultiply(std::move(image));
+    return image;
 }
 
 } // namespace mbgl
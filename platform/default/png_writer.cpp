@@ -1,20 +1,35 @@
-#include <mbgl/util/compression.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/premultiply.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/scheduler.hpp>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wshadow"
 #include <boost/crc.hpp>
 #pragma GCC diagnostic pop
 
+#include <zlib.h>
+
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
 
 #define NETWORK_BYTE_UINT32(value)                                                                 \
     char(value >> 24), char(value >> 16), char(value >> 8), char(value >> 0)
 
+namespace mbgl {
+
 namespace {
 
+using Filter = PNGEncodeOptions::Filter;
+
 void addChunk(std::string& png, const char* type, const char* data = "", const uint32_t size = 0) {
     assert(strlen(type) == 4);
 
@@ -33,45 +48,298 @@ void addChunk(std::string& png, const char* type, const char* data = "", const u
     png.append(crc, 4);
 }
 
-} // namespace
+// The unfiltered scanlines of an image, with `bpp` bytes per pixel.
+struct Scanlines {
+    const uint8_t* data;
+    std::size_t stride;
+    std::size_t bpp;
+    uint32_t height;
+};
 
-namespace mbgl {
+uint8_t paethPredictor(const uint8_t a, const uint8_t b, const uint8_t c) {
+    const int p = int(a) + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+}
+
+// Writes a scanline filtered with the PNG filter type `type`: each byte is stored as the
+// difference to its prediction from the byte to its left (a), the one above (b) and the one
+// above and to the left (c).
+void filterScanline(const uint8_t type, const Scanlines& scanlines, const uint32_t y, uint8_t* out) {
+    const uint8_t* row = scanlines.data + y * scanlines.stride;
+    const uint8_t* prior = y > 0 ? row - scanlines.stride : nullptr;
+    const std::size_t bpp = scanlines.bpp;
+
+    for (std::size_t i = 0; i < scanlines.stride; i++) {
+        const uint8_t a = i >= bpp ? row[i - bpp] : 0;
+        const uint8_t b = prior ? prior[i] : 0;
+        const uint8_t c = prior && i >= bpp ? prior[i - bpp] : 0;
+        uint8_t prediction = 0;
+        switch (type) {
+        case 1: prediction = a; break;
+        case 2: prediction = b; break;
+        case 3: prediction = (int(a) + b) / 2; break;
+        case 4: prediction = paethPredictor(a, b, c); break;
+        }
+        out[i] = row[i] - prediction;
+    }
+}
+
+// Appends the scanlines from `begin` to `end`, each prefixed with the type of its filter.
+void filterScanlines(const Scanlines& scanlines, const Filter filter, const uint32_t begin,
+                     const uint32_t end, std::string& out) {
+    const std::size_t stride = scanlines.stride;
+    out.resize((end - begin) * (1 + stride));
+    auto* data = reinterpret_cast<uint8_t*>(&out[0]);
+
+    std::vector<uint8_t> candidate(filter == Filter::Adaptive ? stride : 0);
+    for (uint32_t y = begin; y < end; y++, data += 1 + stride) {
+        if (filter != Filter::Adaptive) {
+            data[0] = static_cast<uint8_t>(filter);
+            filterScanline(data[0], scanlines, y, data + 1);
+            continue;
+        }
+
+        // Picks the filter whose differences are smallest in sum, taken as signed bytes, which
+        // is the heuristic that libpng uses as well.
+        uint64_t best = std::numeric_limits<uint64_t>::max();
+        for (uint8_t type = 0; type <= 4; type++) {
+            filterScanline(type, scanlines, y, candidate.data());
+            uint64_t sum = 0;
+            for (const uint8_t value : candidate) {
+                sum += std::abs(static_cast<int8_t>(value));
+            }
+            if (sum < best) {
+                best = sum;
+                data[0] = type;
+                std::copy(candidate.begin(), candidate.end(), data + 1);
+            }
+        }
+    }
+}
+
+// A stripe of scanlines deflated on its own, which ends on a byte boundary so that the stripes
+// can be concatenated into one deflate stream.
+struct EncodedStripe {
+    std::string data;
+    uint32_t adler;
+    std::size_t length;
+};
+
+EncodedStripe encodeStripe(const Scanlines& scanlines, const PNGEncodeOptions& options,
+                           const Filter filter, const uint32_t begin, const uint32_t end) {
+    std::string raw;
+    filterScanlines(scanlines, filter, begin, end, raw);
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+
+    // Raw deflate, without the zlib header and checksum, which are added around all stripes.
+    if (deflateInit2(&stream, options.compressionLevel, Z_DEFLATED, -MAX_WBITS, 8,
+                     filter == Filter::None ? Z_DEFAULT_STRATEGY : Z_FILTERED) != Z_OK) {
+        throw std::runtime_error("failed to initialize deflate");
+    }
+
+    const bool last = end == scanlines.height;
+    stream.next_in = reinterpret_cast<Bytef*>(&raw[0]);
+    stream.avail_in = uInt(raw.size());
+
+    // The bound doesn't include the empty block that a sync flush ends with.
+    EncodedStripe result { std::string(deflateBound(&stream, raw.size()) + 16, '\0'),
+                           uint32_t(adler32(adler32(0, Z_NULL, 0), stream.next_in, stream.avail_in)),
+                           raw.size() };
+
+    int code;
+    do {
+        if (stream.total_out == result.data.size()) {
+            result.data.resize(result.data.size() * 2);
+        }
+        stream.next_out = reinterpret_cast<Bytef*>(&result.data[stream.total_out]);
+        stream.avail_out = uInt(result.data.size() - stream.total_out);
+        code = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    } while (last ? code == Z_OK : (code == Z_OK && stream.avail_out == 0));
+
+    // A flush reports a buffer error when it had nothing left to write.
+    const bool failed = last ? code != Z_STREAM_END : (code != Z_OK && code != Z_BUF_ERROR);
+    const std::string message = stream.msg ? stream.msg : "deflate error";
+    result.data.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    if (failed) {
+        throw std::runtime_error(message);
+    }
+
+    return result;
+}
+
+// Encodes a stripe on a scheduler, for the caller to wait for.
+class StripeEncoder {
+public:
+    StripeEncoder(ActorRef<StripeEncoder>, const Scanlines& scanlines_,
+                  const PNGEncodeOptions& options_, const Filter filter_)
+        : scanlines(scanlines_), options(options_), filter(filter_) {
+    }
+
+    void encode(uint32_t begin, uint32_t end, std::promise<EncodedStripe> promise) {
+        try {
+            promise.set_value(encodeStripe(scanlines, options, filter, begin, end));
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    }
+
+private:
+    const Scanlines& scanlines;
+    const PNGEncodeOptions& options;
+    const Filter filter;
+};
+
+// Returns the zlib stream of the scanlines.
+std::string compressScanlines(const Scanlines& scanlines, const PNGEncodeOptions& options, const Filter filter) {
+    std::vector<EncodedStripe> stripes;
+    if (options.scheduler && options.stripeRows > 0 && scanlines.height > options.stripeRows) {
+        std::vector<std::future<EncodedStripe>> futures;
+        std::vector<std::unique_ptr<Actor<StripeEncoder>>> encoders;
+        for (uint32_t begin = 0; begin < scanlines.height; begin += options.stripeRows) {
+            const uint32_t end = std::min(begin + options.stripeRows, scanlines.height);
+            std::promise<EncodedStripe> promise;
+            futures.push_back(promise.get_future());
+            encoders.push_back(std::make_unique<Actor<StripeEncoder>>(*options.scheduler, scanlines, options, filter));
+            encoders.back()->invoke(&StripeEncoder::encode, begin, end, std::move(promise));
+        }
+        for (auto& future : futures) {
+            stripes.push_back(future.get());
+        }
+    } else {
+        stripes.push_back(encodeStripe(scanlines, options, filter, 0, scanlines.height));
+    }
+
+    // The header declares the deflate method with a 32K window, along with the compression level.
+    const int level = options.compressionLevel;
+    const char header[2] = { 0x78, char(level == 0 || level == 1 ? 0x01 : level >= 7 ? 0xDA : 0x9C) };
+
+    std::size_t size = sizeof(header) + 4;
+    for (const auto& stripe : stripes) {
+        size += stripe.data.size();
+    }
+
+    std::string result;
+    result.reserve(size);
+    result.append(header, sizeof(header));
+    uLong adler = adler32(0, Z_NULL, 0);
+    for (const auto& stripe : stripes) {
+        result.append(stripe.data);
+        adler = adler32_combine(adler, stripe.adler, stripe.length);
+    }
+    const char checksum[4] = { NETWORK_BYTE_UINT32(uint32_t(adler)) };
+    result.append(checksum, 4);
+    return result;
+}
+
+// The colors of an image with at most 256 of them, and the index of the color of each pixel.
+struct PaletteImage {
+    std::vector<uint32_t> colors;
+    std::vector<uint8_t> indices;
+};
+
+optional<PaletteImage> reduceToPalette(const UnassociatedImage& image) {
+    PaletteImage result;
+    result.indices.resize(image.size.area());
+
+    std::unordered_map<uint32_t, uint8_t> indices;
+    const uint8_t* pixel = image.data.get();
+
+    // Neighbouring pixels mostly have the same color, so the most recent one is looked up first.
+    uint32_t previous = 0;
+    uint8_t previousIndex = 0;
+    bool hasPrevious = false;
+
+    for (std::size_t i = 0; i < result.indices.size(); i++, pixel += 4) {
+        uint32_t color;
+        memcpy(&color, pixel, 4);
+        if (!hasPrevious || color != previous) {
+            auto it = indices.find(color);
+            if (it == indices.end()) {
+                if (result.colors.size() == 256) {
+                    return {};
+                }
+                it = indices.emplace(color, uint8_t(result.colors.size())).first;
+                result.colors.push_back(color);
+            }
+            previous = color;
+            previousIndex = it->second;
+            hasPrevious = true;
+        }
+        result.indices[i] = previousIndex;
+    }
+
+    return result;
+}
+
+} // namespace
 
 // Encode PNGs without libpng.
-std::string encodePNG(const PremultipliedImage& pre) {
+std::string encodePNG(const PremultipliedImage& pre, const PNGEncodeOptions& options) {
     // Make copy of the image so that we can unpremultiply it.
     const auto src = util::unpremultiply(pre.clone());
 
+    optional<PaletteImage> palette;
+    if (options.palette && src.valid()) {
+        palette = reduceToPalette(src);
+    }
+
     // PNG magic bytes
     const char preamble[8] = { char(0x89), 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
 
-    // IHDR chunk for our RGBA image.
+    // IHDR chunk for our RGBA or palette image.
     const char ihdr[13] = {
         NETWORK_BYTE_UINT32(src.size.width),  // width
         NETWORK_BYTE_UINT32(src.size.height), // height
         8,                                    // bit depth == 8 bits
-        6,                                    // color type == RGBA
+        char(palette ? 3 : 6),                // color type == palette or RGBA
         0,                                    // compression method == deflate
         0,                                    // filter method == default
         0,                                    // interlace method == none
     };
 
     // Prepare the (compressed) data chunk.
-    const auto stride = src.stride();
     std::string idat;
-    for (uint32_t y = 0; y < src.size.height; y++) {
-        // Every scanline needs to be prefixed with one byte that indicates the filter type.
-        idat.append(1, 0); // filter type 0
-        idat.append((const char*)(src.data.get() + y * stride), stride);
+    if (palette) {
+        // Filters seldom predict the indices of a palette any better than they are.
+        idat = compressScanlines({ palette->indices.data(), src.size.width, 1, src.size.height },
+                                 options, Filter::None);
+    } else {
+        idat = compressScanlines({ src.data.get(), src.stride(), 4, src.size.height },
+                                 options, options.filter);
+    }
+
+    std::string plte;
+    std::string trns;
+    if (palette) {
+        for (const uint32_t color : palette->colors) {
+            const auto* rgba = reinterpret_cast<const char*>(&color);
+            plte.append(rgba, 3);
+            trns.append(1, rgba[3]);
+        }
+        // Entries after the last translucent one may be left out, as they are opaque.
+        const auto lastTranslucent = trns.find_last_not_of(char(0xFF));
+        trns.resize(lastTranslucent == std::string::npos ? 0 : lastTranslucent + 1);
     }
-    idat = util::compress(idat);
 
     // Assemble the PNG.
     std::string png;
-    png.reserve((8 /* preamble */) + (12 + 13 /* IHDR */) +
-                (12 + idat.size() /* IDAT */) + (12 /* IEND */));
+    png.reserve((8 /* preamble */) + (12 + 13 /* IHDR */) + (12 + plte.size() /* PLTE */) +
+                (12 + trns.size() /* tRNS */) + (12 + idat.size() /* IDAT */) + (12 /* IEND */));
     png.append(preamble, 8);
     addChunk(png, "IHDR", ihdr, 13);
+    if (palette) {
+        addChunk(png, "PLTE", plte.data(), static_cast<uint32_t>(plte.size()));
+        if (!trns.empty()) {
+            addChunk(png, "tRNS", trns.data(), static_cast<uint32_t>(trns.size()));
+        }
+    }
     addChunk(png, "IDAT", idat.data(), static_cast<uint32_t>(idat.size()));
     addChunk(png, "IEND");
     return png;
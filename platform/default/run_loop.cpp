@@ -131,7 +131,7 @@ LOOP_HANDLE RunLoop::getLoopHandle() {
 }
 
 void RunLoop::push(std::shared_ptr<WorkTask> task) {
-    withMutex([&] { queue.push(std::move(task)); });
+    queue.push(std::move(task));
     impl->async->send();
 }
 
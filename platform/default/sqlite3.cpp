@@ -94,6 +94,10 @@ const static bool sqliteVersionCheck __attribute__((unused)) = []() {
     return true;
 }();
 
+int64_t memoryUsed() {
+    return sqlite3_memory_used();
+}
+
 Database::Database(const std::string &filename, int flags)
     : impl(std::make_unique<DatabaseImpl>(filename.c_str(), flags))
 {
@@ -254,6 +258,14 @@ void Statement::bind(
     impl->check(sqlite3_bind_int64(impl->stmt, offset, std::chrono::system_clock::to_time_t(value)));
 }
 
+template <> void Statement::bind(int offset, optional<int64_t> value) {
+    if (!value) {
+        bind(offset, nullptr);
+    } else {
+        bind(offset, *value);
+    }
+}
+
 template <> void Statement::bind(int offset, optional<std::string> value) {
     if (!value) {
         bind(offset, nullptr);
@@ -312,6 +324,17 @@ template <> std::string Statement::get(int offset) {
     };
 }
 
+std::pair<const char*, std::size_t> Statement::getBlob(int offset) {
+    assert(impl);
+    if (sqlite3_column_type(impl->stmt, offset) == SQLITE_NULL) {
+        return { nullptr, 0 };
+    }
+    // sqlite3_column_blob returns a null pointer for blobs of zero bytes as well.
+    const char* data = reinterpret_cast<const char*>(sqlite3_column_blob(impl->stmt, offset));
+    const std::size_t size = sqlite3_column_bytes(impl->stmt, offset);
+    return { data ? data : "", size };
+}
+
 template <> std::vector<uint8_t> Statement::get(int offset) {
     assert(impl);
     const uint8_t* begin = reinterpret_cast<const uint8_t*>(sqlite3_column_blob(impl->stmt, offset));
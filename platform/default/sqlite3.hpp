@@ -5,6 +5,8 @@
 #include <stdexcept>
 #include <chrono>
 #include <memory>
+#include <cstdint>
+#include <utility>
 
 namespace mapbox {
 namespace sqlite {
@@ -31,6 +33,10 @@ struct Exception : std::runtime_error {
     const int code = OK;
 };
 
+// Returns the number of bytes of heap memory currently held by SQLite for all open databases,
+// including their page caches.
+int64_t memoryUsed();
+
 class DatabaseImpl;
 class Statement;
 class StatementImpl;
@@ -79,6 +85,10 @@ public:
 
     template <typename T> T get(int offset);
 
+    // Points at the bytes of a blob column without copying them. They stay valid until the
+    // statement is run again or reset. The pointer is null only for NULL values.
+    std::pair<const char*, std::size_t> getBlob(int offset);
+
     bool run();
     void reset();
     void clearBindings();
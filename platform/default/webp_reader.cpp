@@ -1,5 +1,4 @@
 #include <mbgl/util/image.hpp>
-#include <mbgl/util/premultiply.hpp>
 #include <mbgl/util/logging.hpp>
 
 extern "C"
@@ -9,7 +8,7 @@ extern "C"
 
 namespace mbgl {
 
-PremultipliedImage decodeWebP(const uint8_t* data, size_t size) {
+UnassociatedImage decodeWebP(const uint8_t* data, size_t size) {
     int width = 0, height = 0;
     if (WebPGetInfo(data, size, &width, &height) == 0) {
         throw std::runtime_error("failed to retrieve WebP basic header information");
@@ -23,9 +22,7 @@ PremultipliedImage decodeWebP(const uint8_t* data, size_t size) {
         throw std::runtime_error("failed to decode WebP data");
     }
 
-    UnassociatedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) },
-                            std::move(webp));
-    return util::premultiply(std::move(image));
+    return { { static_cast<uint32_t>(width), static_cast<uint32_t>(height) }, std::move(webp) };
 }
 
 } // namespace mbgl
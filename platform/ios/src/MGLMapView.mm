@@ -301,6 +301,8 @@ public:
 
     CADisplayLink *_displayLink;
     BOOL _needsDisplayRefresh;
+    /// When the frame that the display link is drawing will be presented.
+    mbgl::optional<mbgl::TimePoint> _presentationTime;
 
     NSUInteger _changeDelimiterSuppressionDepth;
 
@@ -903,7 +905,14 @@ public:
         // The OpenGL implementation automatically enables the OpenGL context for us.
         mbgl::BackendScope scope { *_mbglView, mbgl::BackendScope::ScopeType::Implicit };
 
-        _mbglMap->render(*_mbglView);
+        if (_presentationTime)
+        {
+            _mbglMap->render(*_mbglView, *_presentationTime);
+        }
+        else
+        {
+            _mbglMap->render(*_mbglView);
+        }
 
         [self updateUserLocationAnnotationView];
     }
@@ -1024,7 +1033,12 @@ public:
     {
         _needsDisplayRefresh = NO;
 
+        // However often the map was invalidated since the last tick, it is drawn once, for the
+        // refresh that follows frameInterval refreshes after the one this tick is for.
+        CFTimeInterval untilPresentation = _displayLink.timestamp + _displayLink.duration * _displayLink.frameInterval - CACurrentMediaTime();
+        _presentationTime = mbgl::Clock::now() + std::chrono::duration_cast<mbgl::Duration>(std::chrono::duration<CFTimeInterval>(MAX(untilPresentation, 0)));
         [self.glView display];
+        _presentationTime = {};
     }
 }
 
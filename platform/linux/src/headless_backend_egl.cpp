@@ -6,6 +6,7 @@
 #include <EGL/egl.h>
 
 #include <cassert>
+#include <cstring>
 
 namespace mbgl {
 
@@ -14,8 +15,14 @@ struct EGLImpl : public HeadlessBackend::Impl {
             : glContext(glContext_),
               display(display_),
               config(config_) {
-        // Create a dummy pbuffer. We will render to framebuffers anyway, but we need a pbuffer to
-        // activate the context.
+        // We render to framebuffers anyway, so contexts are activated without a surface where
+        // EGL_KHR_surfaceless_context allows it, as HeadlessDisplay chooses its config for.
+        const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+        if (extensions && strstr(extensions, "EGL_KHR_surfaceless_context")) {
+            return;
+        }
+
+        // Otherwise create a dummy pbuffer to activate the context.
         // Note that to be able to create pbuffer surfaces, we need to choose a config that
         // includes EGL_SURFACE_TYPE, EGL_PBUFFER_BIT in HeadlessDisplay.
         const EGLint surfAttribs[] = {
@@ -1,22 +1,80 @@
 #include <mbgl/gl/headless_display.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/optional.hpp>
 #include <mbgl/util/string.hpp>
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 namespace mbgl {
 
+namespace {
+
+bool hasExtension(const char* extensions, const char* name) {
+    return extensions && strstr(extensions, name);
+}
+
+// Enumerates the GPUs of the machine, through EGL_EXT_device_enumeration and displays opened on
+// them with EGL_EXT_platform_device, but only where both are supported.
+std::vector<EGLDeviceEXT> queryDevices() {
+    const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (!(hasExtension(extensions, "EGL_EXT_device_enumeration") || hasExtension(extensions, "EGL_EXT_device_base")) ||
+        !hasExtension(extensions, "EGL_EXT_platform_device")) {
+        return {};
+    }
+
+    auto queryDevicesEXT = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(eglGetProcAddress("eglQueryDevicesEXT"));
+    if (!queryDevicesEXT) {
+        return {};
+    }
+
+    EGLint count = 0;
+    if (!queryDevicesEXT(0, nullptr, &count) || count <= 0) {
+        return {};
+    }
+
+    std::vector<EGLDeviceEXT> devices(count);
+    if (!queryDevicesEXT(count, devices.data(), &count)) {
+        return {};
+    }
+    devices.resize(count);
+    return devices;
+}
+
+EGLDisplay getDeviceDisplay(std::size_t device) {
+    const std::vector<EGLDeviceEXT> devices = queryDevices();
+    if (devices.empty()) {
+        return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    if (device >= devices.size()) {
+        throw std::runtime_error("EGL device " + util::toString(device) + " doesn't exist.\n");
+    }
+
+    auto getPlatformDisplayEXT = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (!getPlatformDisplayEXT) {
+        throw std::runtime_error("eglGetPlatformDisplayEXT() is missing.\n");
+    }
+    return getPlatformDisplayEXT(EGL_PLATFORM_DEVICE_EXT, devices[device], nullptr);
+}
+
+} // namespace
+
 class HeadlessDisplay::Impl {
 public:
-    Impl();
+    Impl(optional<std::size_t> device);
     ~Impl();
 
     EGLDisplay display = EGL_NO_DISPLAY;
     EGLConfig config = 0;
 };
 
-HeadlessDisplay::Impl::Impl() {
-    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+HeadlessDisplay::Impl::Impl(optional<std::size_t> device) {
+    display = device ? getDeviceDisplay(*device) : eglGetDisplay(EGL_DEFAULT_DISPLAY);
     if (display == EGL_NO_DISPLAY) {
         throw std::runtime_error("Failed to obtain a valid EGL display.\n");
     }
@@ -31,8 +89,12 @@ HeadlessDisplay::Impl::Impl() {
         throw std::runtime_error("eglBindAPI() failed");
     }
 
+    // Contexts that can be made current without a surface don't need a config that supports
+    // pbuffers, which displays of devices may not have.
+    const bool surfaceless = hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
     const EGLint attribs[] = {
-        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
         EGL_NONE
     };
 
@@ -56,10 +118,18 @@ EGLConfig& HeadlessDisplay::attribute() const {
 }
 
 HeadlessDisplay::HeadlessDisplay()
-    : impl(std::make_unique<Impl>()) {
+    : impl(std::make_unique<Impl>(optional<std::size_t>())) {
+}
+
+HeadlessDisplay::HeadlessDisplay(std::size_t device)
+    : impl(std::make_unique<Impl>(device)) {
 }
 
 HeadlessDisplay::~HeadlessDisplay() {
 }
 
+std::size_t HeadlessDisplay::deviceCount() {
+    return std::max<std::size_t>(queryDevices().size(), 1);
+}
+
 } // namespace mbgl
@@ -73,6 +73,14 @@ HeadlessDisplay::HeadlessDisplay()
     : impl(std::make_unique<Impl>()) {
 }
 
+HeadlessDisplay::HeadlessDisplay(std::size_t)
+    : HeadlessDisplay() {
+}
+
+std::size_t HeadlessDisplay::deviceCount() {
+    return 1;
+}
+
 HeadlessDisplay::~HeadlessDisplay() {
 }
 
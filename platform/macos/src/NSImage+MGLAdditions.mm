@@ -16,7 +16,7 @@
 }
 
 - (nullable instancetype)initWithMGLSpriteImage:(const mbgl::SpriteImage *)spriteImage {
-    CGImageRef image = CGImageFromMGLPremultipliedImage(spriteImage->image.clone());
+    CGImageRef image = CGImageFromMGLPremultipliedImage(spriteImage->getImage());
     if (!image) {
         return nil;
     }
@@ -3,9 +3,11 @@
 #include "node_feature.hpp"
 #include "node_conversion.hpp"
 #include "node_geojson.hpp"
+#include "node_style_snapshot.hpp"
 
 #include <mbgl/gl/headless_display.hpp>
 #include <mbgl/util/exception.hpp>
+#include <mbgl/util/premultiply.hpp>
 #include <mbgl/style/conversion/source.hpp>
 #include <mbgl/style/conversion/layer.hpp>
 #include <mbgl/style/conversion/filter.hpp>
@@ -15,6 +17,10 @@
 
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 namespace node_mbgl {
 
 struct NodeMap::RenderOptions {
@@ -27,12 +33,35 @@ struct NodeMap::RenderOptions {
     unsigned int height = 512;
     std::vector<std::string> classes;
     mbgl::MapDebugOptions debugOptions = mbgl::MapDebugOptions::NoDebug;
+    ImageFormat format = ImageFormat::Premultiplied;
+    mbgl::PNGEncodeOptions png;
 };
 
 Nan::Persistent<v8::Function> NodeMap::constructor;
 
-static std::shared_ptr<mbgl::HeadlessDisplay> sharedDisplay() {
-    static auto display = std::make_shared<mbgl::HeadlessDisplay>();
+// The number of framebuffer sizes whose views are kept for later renders, e.g. for a tile server
+// that renders tiles of several sizes.
+static constexpr std::size_t maximumPooledViews = 4;
+
+// On machines with several GPUs, maps are spread over all of them in turn, so that rendering
+// throughput grows with the number of GPUs. Otherwise maps use the default display.
+static std::size_t nextDevice() {
+    static std::atomic<std::size_t> next { 0 };
+    return next++ % mbgl::HeadlessDisplay::deviceCount();
+}
+
+static std::shared_ptr<mbgl::HeadlessDisplay> createDisplay(std::size_t device) {
+    return mbgl::HeadlessDisplay::deviceCount() > 1 ? std::make_shared<mbgl::HeadlessDisplay>(device)
+                                                    : std::make_shared<mbgl::HeadlessDisplay>();
+}
+
+// Maps on the main thread share the display connection of their device.
+static std::shared_ptr<mbgl::HeadlessDisplay> sharedDisplay(std::size_t device = 0) {
+    static std::vector<std::shared_ptr<mbgl::HeadlessDisplay>> displays(mbgl::HeadlessDisplay::deviceCount());
+    auto& display = displays.at(device);
+    if (!display) {
+        display = createDisplay(device);
+    }
     return display;
 }
 
@@ -40,8 +69,8 @@ static const char* releasedMessage() {
     return "Map resources have already been released";
 }
 
-NodeBackend::NodeBackend()
-    : HeadlessBackend(sharedDisplay()) {}
+NodeBackend::NodeBackend(std::shared_ptr<mbgl::HeadlessDisplay> display)
+    : HeadlessBackend(std::move(display)) {}
 
 void NodeBackend::onDidFailLoadingMap(std::exception_ptr error) {
     std::rethrow_exception(error);
@@ -55,6 +84,7 @@ void NodeMap::Init(v8::Local<v8::Object> target) {
 
     Nan::SetPrototypeMethod(tpl, "load", Load);
     Nan::SetPrototypeMethod(tpl, "loaded", Loaded);
+    Nan::SetPrototypeMethod(tpl, "getStyleSnapshot", GetStyleSnapshot);
     Nan::SetPrototypeMethod(tpl, "render", Render);
     Nan::SetPrototypeMethod(tpl, "release", Release);
 
@@ -113,6 +143,12 @@ void NodeMap::Init(v8::Local<v8::Object> target) {
  * over the internet
  * @param {Function} [options.cancel]
  * @param {number} options.ratio pixel ratio
+ * @param {number} [options.threads] the number of native worker threads to lay out tiles on,
+ * shared by all maps that ask for the same number. By default, tiles are laid out on the libuv
+ * threadpool.
+ * @param {boolean} [options.renderThread=false] render on a native thread and OpenGL context of
+ * this map's own rather than on the main thread, so that several maps render in parallel. Tiles
+ * are still requested through `options.request` on the main thread.
  * @example
  * var map = new mbgl.Map({ request: function() {} });
  * map.load(require('./test/fixtures/style.json'));
@@ -149,6 +185,18 @@ void NodeMap::New(const Nan::FunctionCallbackInfo<v8::Value>& info) {
         return Nan::ThrowError("Options object 'ratio' property must be a number");
     }
 
+    if (Nan::Has(options, Nan::New("threads").ToLocalChecked()).FromJust()) {
+        auto threads = Nan::Get(options, Nan::New("threads").ToLocalChecked()).ToLocalChecked();
+        if (!threads->IsUint32() || threads->Uint32Value() == 0) {
+            return Nan::ThrowError("Options object 'threads' property must be a positive integer");
+        }
+    }
+
+    if (Nan::Has(options, Nan::New("renderThread").ToLocalChecked()).FromJust()
+     && !Nan::Get(options, Nan::New("renderThread").ToLocalChecked()).ToLocalChecked()->IsBoolean()) {
+        return Nan::ThrowError("Options object 'renderThread' property must be a boolean");
+    }
+
     info.This()->SetInternalField(1, options);
 
     try {
@@ -179,7 +227,8 @@ std::string StringifyStyle(v8::Local<v8::Value> styleHandle) {
  *
  * @function
  * @name load
- * @param {string|Object} stylesheet either an object or a JSON representation
+ * @param {string|Object|StyleSnapshot} stylesheet either an object, a JSON representation, or
+ * a snapshot that another map took with `getStyleSnapshot`
  * @returns {undefined} loads stylesheet into map
  * @throws {Error} if stylesheet is missing or invalid
  * @example
@@ -188,10 +237,14 @@ std::string StringifyStyle(v8::Local<v8::Value> styleHandle) {
  *
  * // providing a string
  * map.load(fs.readFileSync('./test/fixtures/style.json', 'utf8'));
+ *
+ * // providing a snapshot, which skips parsing the style and loading what the other map loaded
+ * map.load(otherMap.getStyleSnapshot());
  */
 void NodeMap::Load(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     // Reset the flag as this could be the second time
     // we are calling this (being the previous successful).
@@ -201,6 +254,17 @@ void NodeMap::Load(const Nan::FunctionCallbackInfo<v8::Value>& info) {
         return Nan::ThrowError("Requires a map style as first argument");
     }
 
+    if (auto snapshot = NodeStyleSnapshot::Get(info[0])) {
+        try {
+            nodeMap->map->setStyleSnapshot(std::move(snapshot));
+        } catch (const std::exception &ex) {
+            return Nan::ThrowError(ex.what());
+        }
+
+        nodeMap->loaded = true;
+        return info.GetReturnValue().SetUndefined();
+    }
+
     std::string style;
 
     if (info[0]->IsObject()) {
@@ -225,6 +289,7 @@ void NodeMap::Load(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 void NodeMap::Loaded(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     bool loaded = false;
 
@@ -237,6 +302,34 @@ void NodeMap::Loaded(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     info.GetReturnValue().Set(Nan::New(loaded));
 }
 
+/**
+ * Take a snapshot of the loaded style, which other maps in the process load much faster than
+ * the style itself: they share the parsed style, the TileJSON and GeoJSON data of its sources
+ * and its sprite. Annotations and custom layers are left out.
+ *
+ * @function
+ * @name getStyleSnapshot
+ * @returns {StyleSnapshot} an opaque snapshot of the style, to pass to `load`
+ * @throws {Error} if no style is loaded
+ * @example
+ * var snapshot = map.getStyleSnapshot();
+ * otherMap.load(snapshot);
+ */
+void NodeMap::GetStyleSnapshot(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
+    if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
+
+    std::shared_ptr<const mbgl::style::StyleSnapshot> snapshot;
+    try {
+        snapshot = nodeMap->map->getStyleSnapshot();
+    } catch (const std::exception &ex) {
+        return Nan::ThrowError(ex.what());
+    }
+
+    info.GetReturnValue().Set(NodeStyleSnapshot::Create(std::move(snapshot)));
+}
+
 NodeMap::RenderOptions NodeMap::ParseOptions(v8::Local<v8::Object> obj) {
     Nan::HandleScope scope;
 
@@ -309,6 +402,47 @@ NodeMap::RenderOptions NodeMap::ParseOptions(v8::Local<v8::Object> obj) {
         }
     }
 
+    if (Nan::Has(obj, Nan::New("format").ToLocalChecked()).FromJust()) {
+        const std::string format { *Nan::Utf8String(Nan::Get(obj, Nan::New("format").ToLocalChecked()).ToLocalChecked()) };
+        if (format == "premultiplied") {
+            options.format = ImageFormat::Premultiplied;
+        } else if (format == "unpremultiplied") {
+            options.format = ImageFormat::Unpremultiplied;
+        } else if (format == "png") {
+            options.format = ImageFormat::PNG;
+        } else {
+            throw mbgl::util::Exception("Options object 'format' property must be 'premultiplied', 'unpremultiplied' or 'png'");
+        }
+    }
+
+    if (Nan::Has(obj, Nan::New("compressionLevel").ToLocalChecked()).FromJust()) {
+        auto level = Nan::Get(obj, Nan::New("compressionLevel").ToLocalChecked()).ToLocalChecked();
+        if (!level->IsInt32() || level->Int32Value() < 0 || level->Int32Value() > 9) {
+            throw mbgl::util::Exception("Options object 'compressionLevel' property must be an integer between 0 and 9");
+        }
+        options.png.compressionLevel = level->Int32Value();
+    }
+
+    if (Nan::Has(obj, Nan::New("pngFilter").ToLocalChecked()).FromJust()) {
+        using Filter = mbgl::PNGEncodeOptions::Filter;
+        const std::string filter { *Nan::Utf8String(Nan::Get(obj, Nan::New("pngFilter").ToLocalChecked()).ToLocalChecked()) };
+        if (filter == "none") {
+            options.png.filter = Filter::None;
+        } else if (filter == "sub") {
+            options.png.filter = Filter::Sub;
+        } else if (filter == "up") {
+            options.png.filter = Filter::Up;
+        } else if (filter == "average") {
+            options.png.filter = Filter::Average;
+        } else if (filter == "paeth") {
+            options.png.filter = Filter::Paeth;
+        } else if (filter == "adaptive") {
+            options.png.filter = Filter::Adaptive;
+        } else {
+            throw mbgl::util::Exception("Options object 'pngFilter' property must be 'none', 'sub', 'up', 'average', 'paeth' or 'adaptive'");
+        }
+    }
+
     return options;
 }
 
@@ -324,6 +458,12 @@ NodeMap::RenderOptions NodeMap::ParseOptions(v8::Local<v8::Object> obj) {
  * of the map
  * @param {number} [options.bearing=0] rotation
  * @param {Array<string>} [options.classes=[]] style classes
+ * @param {string} [options.format='premultiplied'] the pixels to call back with: `premultiplied` or
+ * `unpremultiplied` RGBA pixels, or a `png` image. Conversions run off the main thread.
+ * @param {number} [options.compressionLevel] the zlib compression level of a `png` image, from 0
+ * (fastest) to 9 (smallest). Images with at most 256 colors are written with a palette.
+ * @param {string} [options.pngFilter='none'] how the rows of a `png` image are predicted: `none`,
+ * `sub`, `up`, `average`, `paeth`, or `adaptive` to pick the best of them for each row.
  * @param {Function} callback
  * @returns {undefined} calls callback
  * @throws {Error} if stylesheet is not loaded or if map is already rendering
@@ -348,31 +488,61 @@ void NodeMap::Render(const Nan::FunctionCallbackInfo<v8::Value>& info) {
         return Nan::ThrowError("Map is currently rendering an image");
     }
 
-    auto options = ParseOptions(Nan::To<v8::Object>(info[0]).ToLocalChecked());
+    RenderOptions options;
+    try {
+        options = ParseOptions(Nan::To<v8::Object>(info[0]).ToLocalChecked());
+    } catch (mbgl::util::Exception &ex) {
+        return Nan::ThrowTypeError(ex.what());
+    }
 
     assert(!nodeMap->callback);
     assert(!nodeMap->image.data);
     nodeMap->callback = std::make_unique<Nan::Callback>(info[1].As<v8::Function>());
 
     try {
-        nodeMap->startRender(std::move(options));
+        if (nodeMap->renderThread) {
+            nodeMap->renderThread->invoke([&] { nodeMap->startRender(std::move(options)); });
+        } else {
+            nodeMap->startRender(std::move(options));
+        }
     } catch (mbgl::util::Exception &ex) {
         return Nan::ThrowError(ex.what());
     }
 
+    // Retain this object, otherwise it might get destructed before we are finished rendering the
+    // still image.
+    nodeMap->Ref();
+
+    // Similarly, we're now waiting for the async to be called, so we need to make sure that it
+    // keeps the loop alive.
+    uv_ref(reinterpret_cast<uv_handle_t *>(nodeMap->async));
+
     info.GetReturnValue().SetUndefined();
 }
 
 void NodeMap::startRender(NodeMap::RenderOptions options) {
+    format = options.format;
+    pngOptions = options.png;
+    // Native worker pools deflate stripes of PNG images in parallel. Those of libuv don't, as the
+    // image is encoded on the libuv threadpool, which must not wait for its own threads.
+    pngOptions.scheduler = dynamic_cast<NodeThreadPool*>(scheduler.get()) ? nullptr : scheduler.get();
     map->setSize({ options.width, options.height });
 
     const mbgl::Size fbSize{ static_cast<uint32_t>(options.width * pixelRatio),
                              static_cast<uint32_t>(options.height * pixelRatio) };
-    if (!view || view->getSize() != fbSize) {
-        view.reset();
-        mbgl::BackendScope scope { backend };
-        view = std::make_unique<mbgl::OffscreenView>(backend.getContext(), fbSize);
+    auto it = std::find_if(views.begin(), views.end(), [&](const auto& pooled) {
+        return pooled->getSize() == fbSize;
+    });
+    if (it != views.end()) {
+        std::rotate(it, it + 1, views.end());
+    } else {
+        mbgl::BackendScope scope { *backend };
+        if (views.size() >= maximumPooledViews) {
+            views.erase(views.begin());
+        }
+        views.push_back(std::make_unique<mbgl::OffscreenView>(backend->getContext(), fbSize));
     }
+    view = views.back().get();
 
     if (map->getClasses() != options.classes) {
         map->setClasses(options.classes);
@@ -403,40 +573,116 @@ void NodeMap::startRender(NodeMap::RenderOptions options) {
         if (eptr) {
             error = std::move(eptr);
             uv_async_send(async);
-        } else {
-            assert(!image.data);
+        } else if (renderThread) {
+            // The context can only be used on the render thread, so the pixels are read here.
             image = view->readStillImage();
+            encodeImage();
+            uv_async_send(async);
+        } else {
+            // The pixels are collected in renderFinished, by when the GPU has had time to
+            // finish rendering them.
+            view->startReadStillImage();
             uv_async_send(async);
         }
     });
-
-    // Retain this object, otherwise it might get destructed before we are finished rendering the
-    // still image.
-    Ref();
-
-    // Similarly, we're now waiting for the async to be called, so we need to make sure that it
-    // keeps the loop alive.
-    uv_ref(reinterpret_cast<uv_handle_t *>(async));
 }
 
 void NodeMap::renderFinished() {
-    Nan::HandleScope scope;
-
     // We're done with this render call, so we're unrefing so that the loop could close.
     uv_unref(reinterpret_cast<uv_handle_t *>(async));
 
+    if (!error && !renderThread) {
+        assert(!image.data);
+        {
+            mbgl::BackendScope scope { *backend };
+            image = view->finishReadStillImage();
+        }
+
+        if (format != ImageFormat::Premultiplied) {
+            // The pending work request keeps the loop alive in the meantime.
+            auto work = new uv_work_t;
+            work->data = this;
+            uv_queue_work(uv_default_loop(), work, [](uv_work_t* w) {
+                reinterpret_cast<NodeMap *>(w->data)->encodeImage();
+            }, [](uv_work_t* w, int) {
+                auto nodeMap = reinterpret_cast<NodeMap *>(w->data);
+                delete w;
+                nodeMap->deliverImage();
+            });
+            return;
+        }
+    }
+
+    deliverImage();
+}
+
+void NodeMap::encodeImage() {
+    if (error || !image.data) {
+        return;
+    }
+
+    try {
+        switch (format) {
+        case ImageFormat::Premultiplied:
+            break;
+        case ImageFormat::Unpremultiplied:
+            unpremultipliedImage = mbgl::util::unpremultiply(std::move(image));
+            break;
+        case ImageFormat::PNG:
+            encodedImage = mbgl::encodePNG(image, pngOptions);
+            image = mbgl::PremultipliedImage();
+            break;
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+}
+
+// Hands the pixels to a Buffer that frees them once it is garbage collected.
+static v8::Local<v8::Object> externalBuffer(std::unique_ptr<uint8_t[]> data, std::size_t length) {
+    auto buffer = Nan::NewBuffer(
+        reinterpret_cast<char *>(data.get()), length,
+        // Retain the data until the buffer is deleted.
+        [](char *, void * hint) {
+            delete [] reinterpret_cast<uint8_t*>(hint);
+        },
+        data.get()
+    ).ToLocalChecked();
+    data.release();
+    return buffer;
+}
+
+static v8::Local<v8::Object> externalBuffer(std::string data) {
+    auto string = new std::string(std::move(data));
+    return Nan::NewBuffer(
+        &(*string)[0], string->size(),
+        [](char *, void * hint) {
+            delete reinterpret_cast<std::string*>(hint);
+        },
+        string
+    ).ToLocalChecked();
+}
+
+void NodeMap::deliverImage() {
+    Nan::HandleScope scope;
+
     // There is no render pending anymore, we the GC could now delete this object if it went out
     // of scope.
     Unref();
 
-    // Move the callback and image out of the way so that the callback can start a new render call.
+    // Move the callback and images out of the way so that the callback can start a new render
+    // call.
     auto cb = std::move(callback);
     auto img = std::move(image);
+    auto unpremultiplied = std::move(unpremultipliedImage);
+    auto encoded = std::move(encodedImage);
+    encodedImage.clear();
     assert(cb);
 
     // These have to be empty to be prepared for the next render call.
     assert(!callback);
     assert(!image.data);
+    assert(!unpremultipliedImage.data);
 
     if (error) {
         std::string errorMessage;
@@ -456,20 +702,12 @@ void NodeMap::renderFinished() {
         assert(!error);
 
         cb->Call(1, argv);
-    } else if (img.data) {
-        v8::Local<v8::Object> pixels = Nan::NewBuffer(
-            reinterpret_cast<char *>(img.data.get()), img.bytes(),
-            // Retain the data until the buffer is deleted.
-            [](char *, void * hint) {
-                delete [] reinterpret_cast<uint8_t*>(hint);
-            },
-            img.data.get()
-        ).ToLocalChecked();
-        img.data.release();
-
+    } else if (img.data || unpremultiplied.data || !encoded.empty()) {
         v8::Local<v8::Value> argv[] = {
             Nan::Null(),
-            pixels
+            !encoded.empty() ? externalBuffer(std::move(encoded))
+                : unpremultiplied.data ? externalBuffer(std::move(unpremultiplied.data), unpremultiplied.bytes())
+                : externalBuffer(std::move(img.data), img.bytes())
         };
         cb->Call(2, argv);
     } else {
@@ -505,12 +743,27 @@ void NodeMap::release() {
         delete reinterpret_cast<uv_async_t *>(h);
     });
 
-    map.reset();
+    if (renderThread) {
+        // The map and the GL objects have to be destroyed on the thread that created them.
+        renderThread->invoke([&] {
+            map.reset();
+            views.clear();
+            backend.reset();
+        });
+        renderThread.reset();
+    } else {
+        map.reset();
+    }
+}
+
+std::unique_ptr<RenderThread::Pause> NodeMap::pause() {
+    return renderThread ? std::make_unique<RenderThread::Pause>(*renderThread) : nullptr;
 }
 
 void NodeMap::AddClass(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() <= 0 || !info[0]->IsString()) {
         return Nan::ThrowTypeError("First argument must be a string");
@@ -531,6 +784,7 @@ void NodeMap::AddSource(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() != 2) {
         return Nan::ThrowTypeError("Two argument required");
@@ -556,6 +810,7 @@ void NodeMap::AddLayer(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() != 1) {
         return Nan::ThrowTypeError("One argument required");
@@ -577,6 +832,7 @@ void NodeMap::RemoveLayer(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() != 1) {
         return Nan::ThrowTypeError("One argument required");
@@ -595,6 +851,7 @@ void NodeMap::AddImage(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() != 3) {
         return Nan::ThrowTypeError("Three arguments required");
@@ -656,6 +913,7 @@ void NodeMap::RemoveImage(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() != 1) {
         return Nan::ThrowTypeError("One argument required");
@@ -674,6 +932,7 @@ void NodeMap::SetLayoutProperty(const Nan::FunctionCallbackInfo<v8::Value>& info
 
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() < 3) {
         return Nan::ThrowTypeError("Three arguments required");
@@ -706,6 +965,7 @@ void NodeMap::SetPaintProperty(const Nan::FunctionCallbackInfo<v8::Value>& info)
 
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() < 3) {
         return Nan::ThrowTypeError("Three arguments required");
@@ -748,6 +1008,10 @@ struct SetFilterVisitor {
         Nan::ThrowTypeError("layer doesn't support filters");
     }
 
+    void operator()(mbgl::style::HillshadeLayer&) {
+        Nan::ThrowTypeError("layer doesn't support filters");
+    }
+
     void operator()(mbgl::style::BackgroundLayer&) {
         Nan::ThrowTypeError("layer doesn't support filters");
     }
@@ -764,6 +1028,7 @@ void NodeMap::SetFilter(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() < 2) {
         return Nan::ThrowTypeError("Two arguments required");
@@ -796,6 +1061,7 @@ void NodeMap::SetFilter(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 void NodeMap::SetCenter(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() <= 0 || !info[0]->IsArray()) {
         return Nan::ThrowTypeError("First argument must be an array");
@@ -819,6 +1085,7 @@ void NodeMap::SetCenter(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 void NodeMap::SetZoom(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() <= 0 || !info[0]->IsNumber()) {
         return Nan::ThrowTypeError("First argument must be a number");
@@ -836,6 +1103,7 @@ void NodeMap::SetZoom(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 void NodeMap::SetBearing(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() <= 0 || !info[0]->IsNumber()) {
         return Nan::ThrowTypeError("First argument must be a number");
@@ -853,6 +1121,7 @@ void NodeMap::SetBearing(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 void NodeMap::SetPitch(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() <= 0 || !info[0]->IsNumber()) {
         return Nan::ThrowTypeError("First argument must be a number");
@@ -870,6 +1139,7 @@ void NodeMap::SetPitch(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 void NodeMap::DumpDebugLogs(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     nodeMap->map->dumpDebugLogs();
     info.GetReturnValue().SetUndefined();
@@ -881,6 +1151,7 @@ void NodeMap::QueryRenderedFeatures(const Nan::FunctionCallbackInfo<v8::Value>&
 
     auto nodeMap = Nan::ObjectWrap::Unwrap<NodeMap>(info.Holder());
     if (!nodeMap->map) return Nan::ThrowError(releasedMessage());
+    const auto pause = nodeMap->pause();
 
     if (info.Length() <= 0 || !info[0]->IsArray()) {
         return Nan::ThrowTypeError("First argument must be an array");
@@ -969,14 +1240,44 @@ NodeMap::NodeMap(v8::Local<v8::Object> options)
                            ->NumberValue()
                      : 1.0;
       }()),
-      map(std::make_unique<mbgl::Map>(backend,
-                                      mbgl::Size{ 256, 256 },
-                                      pixelRatio,
-                                      *this,
-                                      threadpool,
-                                      mbgl::MapMode::Still)),
+      scheduler([&]() -> std::shared_ptr<mbgl::Scheduler> {
+          Nan::HandleScope scope;
+          if (Nan::Has(options, Nan::New("threads").ToLocalChecked()).FromJust()) {
+              return sharedWorkerPool(Nan::Get(options, Nan::New("threads").ToLocalChecked())
+                                          .ToLocalChecked()
+                                          ->Uint32Value());
+          }
+          return std::make_shared<NodeThreadPool>();
+      }()),
       async(new uv_async_t) {
 
+    {
+        Nan::HandleScope scope;
+        if (Nan::Has(options, Nan::New("renderThread").ToLocalChecked()).FromJust()
+         && Nan::Get(options, Nan::New("renderThread").ToLocalChecked()).ToLocalChecked()->BooleanValue()) {
+            renderThread = std::make_unique<RenderThread>();
+            fileSource = std::make_unique<ForwardingFileSource>(*this, renderThread->getLoop());
+        }
+    }
+
+    const std::size_t device = nextDevice();
+    auto createMap = [&] {
+        // Maps on render threads of their own don't share a display connection, which isn't
+        // safe to use from several threads at once.
+        backend = std::make_unique<NodeBackend>(renderThread ? createDisplay(device) : sharedDisplay(device));
+        map = std::make_unique<mbgl::Map>(*backend,
+                                          mbgl::Size{ 256, 256 },
+                                          pixelRatio,
+                                          fileSource ? static_cast<mbgl::FileSource&>(*fileSource) : *this,
+                                          *scheduler,
+                                          mbgl::MapMode::Still);
+    };
+    if (renderThread) {
+        renderThread->invoke(createMap);
+    } else {
+        createMap();
+    }
+
     async->data = this;
     uv_async_init(uv_default_loop(), async, [](uv_async_t* h) {
         reinterpret_cast<NodeMap *>(h->data)->renderFinished();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "node_thread_pool.hpp"
+#include "node_render_thread.hpp"
 
 #include <mbgl/map/map.hpp>
 #include <mbgl/storage/file_source.hpp>
@@ -19,7 +20,7 @@ namespace node_mbgl {
 
 class NodeBackend : public mbgl::HeadlessBackend {
 public:
-    NodeBackend();
+    NodeBackend(std::shared_ptr<mbgl::HeadlessDisplay>);
     void onDidFailLoadingMap(std::exception_ptr) final;
 };
 
@@ -27,6 +28,7 @@ class NodeMap : public Nan::ObjectWrap,
                 public mbgl::FileSource {
 public:
     struct RenderOptions;
+    enum class ImageFormat { Premultiplied, Unpremultiplied, PNG };
     class RenderWorker;
 
     NodeMap(v8::Local<v8::Object>);
@@ -39,6 +41,7 @@ public:
     static void New(const Nan::FunctionCallbackInfo<v8::Value>&);
     static void Load(const Nan::FunctionCallbackInfo<v8::Value>&);
     static void Loaded(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void GetStyleSnapshot(const Nan::FunctionCallbackInfo<v8::Value>&);
     static void Render(const Nan::FunctionCallbackInfo<v8::Value>&);
     static void Release(const Nan::FunctionCallbackInfo<v8::Value>&);
     static void AddClass(const Nan::FunctionCallbackInfo<v8::Value>&);
@@ -59,21 +62,37 @@ public:
 
     void startRender(RenderOptions options);
     void renderFinished();
+    // Converts the rendered image to the requested format. As it doesn't use V8, it runs on the
+    // render thread or the libuv threadpool.
+    void encodeImage();
+    void deliverImage();
 
     void release();
 
+    // Keeps the render thread, if any, from using the map while the caller does.
+    std::unique_ptr<RenderThread::Pause> pause();
+
     static RenderOptions ParseOptions(v8::Local<v8::Object>);
 
     std::unique_ptr<mbgl::AsyncRequest> request(const mbgl::Resource&, mbgl::FileSource::Callback);
 
     const float pixelRatio;
-    NodeBackend backend;
-    std::unique_ptr<mbgl::OffscreenView> view;
-    NodeThreadPool threadpool;
+    // Set when the map renders on a native thread of its own rather than on the main thread.
+    std::unique_ptr<RenderThread> renderThread;
+    std::unique_ptr<NodeBackend> backend;
+    // Views of recently rendered sizes, the most recently used one last.
+    std::vector<std::unique_ptr<mbgl::OffscreenView>> views;
+    mbgl::OffscreenView* view = nullptr;
+    const std::shared_ptr<mbgl::Scheduler> scheduler;
+    std::unique_ptr<ForwardingFileSource> fileSource;
     std::unique_ptr<mbgl::Map> map;
 
     std::exception_ptr error;
+    ImageFormat format = ImageFormat::Premultiplied;
+    mbgl::PNGEncodeOptions pngOptions;
     mbgl::PremultipliedImage image;
+    mbgl::UnassociatedImage unpremultipliedImage;
+    std::string encodedImage;
     std::unique_ptr<Nan::Callback> callback;
 
     // Async for delivering the notifications of render completion.
@@ -0,0 +1,123 @@
+#include "node_render_thread.hpp"
+
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/platform.hpp>
+
+#include <mutex>
+
+namespace node_mbgl {
+
+RenderThread::RenderThread() {
+    std::promise<void> running;
+    thread = std::thread([&] {
+        mbgl::platform::setCurrentThreadName("Map Render");
+
+        mbgl::util::RunLoop runLoop(mbgl::util::RunLoop::Type::New);
+        loop = &runLoop;
+        running.set_value();
+        runLoop.run();
+    });
+    running.get_future().get();
+}
+
+RenderThread::~RenderThread() {
+    loop->stop();
+    thread.join();
+}
+
+void RenderThread::invoke(std::function<void ()> fn) {
+    std::promise<void> done;
+    loop->invoke([&] {
+        try {
+            fn();
+            done.set_value();
+        } catch (...) {
+            done.set_exception(std::current_exception());
+        }
+    });
+    done.get_future().get();
+}
+
+RenderThread::Pause::Pause(RenderThread& renderThread) {
+    std::promise<void> parked;
+    std::shared_future<void> resuming = resumed.get_future().share();
+    renderThread.loop->invoke([&parked, resuming] {
+        parked.set_value();
+        resuming.wait();
+    });
+    parked.get_future().wait();
+}
+
+RenderThread::Pause::~Pause() {
+    resumed.set_value();
+}
+
+// The state of a forwarded request, which the main thread and the render thread share.
+class ForwardingFileSource::Request : public mbgl::AsyncRequest {
+public:
+    struct State {
+        // Guards `canceled`, so that the main thread doesn't invoke a response on the render
+        // thread's RunLoop once it may have been destroyed.
+        std::mutex mutex;
+        bool canceled = false;
+
+        // Only used on the main thread.
+        std::unique_ptr<mbgl::AsyncRequest> request;
+    };
+
+    Request(std::shared_ptr<State> state_, mbgl::util::RunLoop& mainLoop_)
+        : state(std::move(state_)), mainLoop(mainLoop_) {
+    }
+
+    ~Request() override {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->canceled = true;
+        }
+        mainLoop.invoke([state = state] {
+            state->request.reset();
+        });
+    }
+
+private:
+    const std::shared_ptr<State> state;
+    mbgl::util::RunLoop& mainLoop;
+};
+
+ForwardingFileSource::ForwardingFileSource(mbgl::FileSource& target_, mbgl::util::RunLoop& renderLoop_)
+    : target(target_), mainLoop(*mbgl::util::RunLoop::Get()), renderLoop(renderLoop_) {
+}
+
+std::unique_ptr<mbgl::AsyncRequest> ForwardingFileSource::request(const mbgl::Resource& resource, Callback callback) {
+    auto state = std::make_shared<Request::State>();
+
+    mainLoop.invoke([this, state, resource, callback] {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->canceled) {
+                return;
+            }
+        }
+
+        state->request = target.request(resource, [this, state, callback] (mbgl::Response response) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->canceled) {
+                return;
+            }
+            renderLoop.invoke([state, callback, response] {
+                // The request may have been canceled while this was queued.
+                {
+                    std::lock_guard<std::mutex> guard(state->mutex);
+                    if (state->canceled) {
+                        return;
+                    }
+                }
+                callback(response);
+            });
+        });
+    });
+
+    return std::make_unique<Request>(std::move(state), mainLoop);
+}
+
+} // namespace node_mbgl
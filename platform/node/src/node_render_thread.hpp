@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+
+namespace node_mbgl {
+
+// A native thread with a RunLoop of its own, for a map that renders in parallel with the maps on
+// other threads rather than taking turns on the main thread.
+class RenderThread {
+public:
+    RenderThread();
+    ~RenderThread();
+
+    mbgl::util::RunLoop& getLoop() { return *loop; }
+
+    // Runs fn on the render thread and waits for it to return. Rethrows its exceptions.
+    void invoke(std::function<void ()> fn);
+
+    // Makes the render thread wait between two of its tasks for as long as it exists, so that the
+    // calling thread may use objects that are otherwise only used on the render thread, with V8
+    // values that can't be passed to it.
+    class Pause {
+    public:
+        explicit Pause(RenderThread&);
+        ~Pause();
+
+    private:
+        std::promise<void> resumed;
+    };
+
+private:
+    mbgl::util::RunLoop* loop = nullptr;
+    std::thread thread;
+};
+
+// Forwards the requests of a map on a render thread to a file source on the main thread, and
+// their responses back to the render thread. Requests may also be made on the main thread while
+// the render thread is paused; their responses still go to the render thread.
+class ForwardingFileSource : public mbgl::FileSource {
+public:
+    // Constructed on the main thread.
+    ForwardingFileSource(mbgl::FileSource& target, mbgl::util::RunLoop& renderLoop);
+
+    std::unique_ptr<mbgl::AsyncRequest> request(const mbgl::Resource&, Callback) override;
+
+private:
+    class Request;
+
+    mbgl::FileSource& target;
+    mbgl::util::RunLoop& mainLoop;
+    mbgl::util::RunLoop& renderLoop;
+};
+
+} // namespace node_mbgl
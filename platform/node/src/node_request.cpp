@@ -99,10 +99,11 @@ void NodeRequest::HandleCallback(const Nan::FunctionCallbackInfo<v8::Value>& inf
         if (Nan::Has(res, Nan::New("data").ToLocalChecked()).FromJust()) {
             auto data = Nan::Get(res, Nan::New("data").ToLocalChecked()).ToLocalChecked();
             if (node::Buffer::HasInstance(data)) {
-                response.data = std::make_shared<std::string>(
+                // The buffer belongs to the JavaScript heap, so it can't be shared across threads.
+                response.data = std::make_shared<mbgl::Buffer>(std::string(
                     node::Buffer::Data(data),
                     node::Buffer::Length(data)
-                );
+                ));
             } else {
                 return Nan::ThrowTypeError("Response data must be a Buffer");
             }
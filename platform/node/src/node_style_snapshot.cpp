@@ -0,0 +1,44 @@
+#include "node_style_snapshot.hpp"
+
+namespace node_mbgl {
+
+Nan::Persistent<v8::Function> NodeStyleSnapshot::constructor;
+Nan::Persistent<v8::FunctionTemplate> NodeStyleSnapshot::constructorTemplate;
+
+void NodeStyleSnapshot::Init() {
+    v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+    tpl->SetClassName(Nan::New("StyleSnapshot").ToLocalChecked());
+
+    constructorTemplate.Reset(tpl);
+    constructor.Reset(tpl->GetFunction());
+}
+
+void NodeStyleSnapshot::New(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    if (!info.IsConstructCall()) {
+        return Nan::ThrowTypeError("Use the new operator to create new StyleSnapshot objects");
+    }
+
+    auto snapshot = new NodeStyleSnapshot();
+    snapshot->Wrap(info.This());
+    info.GetReturnValue().Set(info.This());
+}
+
+v8::Local<v8::Object> NodeStyleSnapshot::Create(std::shared_ptr<const mbgl::style::StyleSnapshot> snapshot) {
+    Nan::EscapableHandleScope scope;
+
+    auto instance = Nan::NewInstance(Nan::New(constructor)).ToLocalChecked();
+    Nan::ObjectWrap::Unwrap<NodeStyleSnapshot>(instance)->snapshot = std::move(snapshot);
+
+    return scope.Escape(instance);
+}
+
+std::shared_ptr<const mbgl::style::StyleSnapshot> NodeStyleSnapshot::Get(v8::Local<v8::Value> value) {
+    if (!value->IsObject() || !Nan::New(constructorTemplate)->HasInstance(value)) {
+        return nullptr;
+    }
+    return Nan::ObjectWrap::Unwrap<NodeStyleSnapshot>(value.As<v8::Object>())->snapshot;
+}
+
+}
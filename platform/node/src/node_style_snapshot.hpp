@@ -0,0 +1,39 @@
+#pragma once
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wshadow"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+#include <memory>
+
+namespace mbgl {
+namespace style {
+class StyleSnapshot;
+} // namespace style
+} // namespace mbgl
+
+namespace node_mbgl {
+
+// The JavaScript handle of a style snapshot, which maps load rather than parsing the style.
+// Snapshots are only made by map.getStyleSnapshot(), and have no methods of their own.
+class NodeStyleSnapshot : public Nan::ObjectWrap {
+public:
+    static Nan::Persistent<v8::Function> constructor;
+    static Nan::Persistent<v8::FunctionTemplate> constructorTemplate;
+
+    static void Init();
+
+    static void New(const Nan::FunctionCallbackInfo<v8::Value>&);
+
+    static v8::Local<v8::Object> Create(std::shared_ptr<const mbgl::style::StyleSnapshot>);
+
+    // Returns the snapshot if the value is a snapshot handle, or null otherwise.
+    static std::shared_ptr<const mbgl::style::StyleSnapshot> Get(v8::Local<v8::Value>);
+
+private:
+    std::shared_ptr<const mbgl::style::StyleSnapshot> snapshot;
+};
+
+}
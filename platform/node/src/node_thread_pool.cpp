@@ -2,6 +2,9 @@
 #include "util/async_queue.hpp"
 
 #include <mbgl/actor/mailbox.hpp>
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <map>
 
 namespace node_mbgl {
 
@@ -34,4 +37,15 @@ void NodeThreadPool::Worker::WorkComplete() {
     // no-op to avoid calling nullptr callback
 }
 
+std::shared_ptr<mbgl::Scheduler> sharedWorkerPool(std::size_t threads) {
+    // Only ever accessed from the main thread.
+    static std::map<std::size_t, std::weak_ptr<mbgl::Scheduler>> pools;
+    auto& weak = pools[threads];
+    auto pool = weak.lock();
+    if (!pool) {
+        weak = pool = std::make_shared<mbgl::WorkStealingThreadPool>(threads);
+    }
+    return pool;
+}
+
 } // namespace node_mbgl
@@ -2,6 +2,8 @@
 
 #include <mbgl/actor/scheduler.hpp>
 
+#include <memory>
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 #pragma GCC diagnostic ignored "-Wshadow"
@@ -34,4 +36,9 @@ private:
     };
 };
 
+// Returns a native pool of `threads` worker threads, shared by all maps that ask for the same
+// number of threads while it is alive. Unlike NodeThreadPool, it doesn't compete with the file
+// system, DNS and zlib work on the libuv threadpool.
+std::shared_ptr<mbgl::Scheduler> sharedWorkerPool(std::size_t threads);
+
 } // namespace node_mbgl
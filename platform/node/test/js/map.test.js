@@ -89,6 +89,49 @@ test('Map', function(t) {
         t.end();
     });
 
+    t.test('optional threads property must be a positive integer', function(t) {
+        var options = {
+            request: function() {}
+        };
+
+        options.threads = 'test';
+        t.throws(function() {
+            new mbgl.Map(options);
+        }, /Options object 'threads' property must be a positive integer/);
+
+        options.threads = 0;
+        t.throws(function() {
+            new mbgl.Map(options);
+        }, /Options object 'threads' property must be a positive integer/);
+
+        options.threads = 2;
+        t.doesNotThrow(function() {
+            var map = new mbgl.Map(options);
+            map.release();
+        });
+
+        t.end();
+    });
+
+    t.test('optional renderThread property must be a boolean', function(t) {
+        var options = {
+            request: function() {}
+        };
+
+        options.renderThread = 'test';
+        t.throws(function() {
+            new mbgl.Map(options);
+        }, /Options object 'renderThread' property must be a boolean/);
+
+        options.renderThread = true;
+        t.doesNotThrow(function() {
+            var map = new mbgl.Map(options);
+            map.release();
+        });
+
+        t.end();
+    });
+
     t.test('instanceof mbgl.Map', function(t) {
         var options = {
             request: function() {},
@@ -105,6 +148,7 @@ test('Map', function(t) {
         t.deepEqual(keys, [
             'load',
             'loaded',
+            'getStyleSnapshot',
             'render',
             'release',
             'addClass',
@@ -371,6 +415,32 @@ test('Map', function(t) {
             t.end();
         });
 
+        t.test('accepts a style snapshot', { timeout: 1000 }, function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+            var snapshot = map.getStyleSnapshot();
+
+            var copy = new mbgl.Map(options);
+            t.doesNotThrow(function() {
+                copy.load(snapshot);
+            });
+
+            map.release();
+            copy.release();
+            t.end();
+        });
+
+        t.test('requires a loaded style to take a snapshot', function(t) {
+            var map = new mbgl.Map(options);
+
+            t.throws(function() {
+                map.getStyleSnapshot();
+            }, /Can't take a snapshot/);
+
+            map.release();
+            t.end();
+        });
+
         t.test('does not immediately trigger any tile loads', function(t) {
             var map = new mbgl.Map({
                 request: function(req) {
@@ -439,6 +509,34 @@ test('Map', function(t) {
             t.end();
         });
 
+        t.test('requires a known format', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+
+            t.throws(function() {
+                map.render({ format: 'jpeg' }, function() {});
+            }, /Options object 'format' property must be 'premultiplied', 'unpremultiplied' or 'png'/);
+
+            map.release();
+            t.end();
+        });
+
+        t.test('requires a valid PNG compression level and filter', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+
+            t.throws(function() {
+                map.render({ format: 'png', compressionLevel: 10 }, function() {});
+            }, /Options object 'compressionLevel' property must be an integer between 0 and 9/);
+
+            t.throws(function() {
+                map.render({ format: 'png', pngFilter: 'diagonal' }, function() {});
+            }, /Options object 'pngFilter' property must be 'none', 'sub', 'up', 'average', 'paeth' or 'adaptive'/);
+
+            map.release();
+            t.end();
+        });
+
         t.test('returns an error delayed', function(t) {
             var delay = 0;
             var map = new mbgl.Map({
@@ -494,6 +592,42 @@ test('Map', function(t) {
             });
         });
 
+        t.test('returns an unpremultiplied image', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+            map.render({ format: 'unpremultiplied' }, function(err, pixels) {
+                t.error(err);
+                map.release();
+                t.ok(pixels instanceof Buffer);
+                t.equal(pixels.length, 512 * 512 * 4)
+                t.end();
+            });
+        });
+
+        t.test('returns a PNG image', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+            map.render({ format: 'png' }, function(err, png) {
+                t.error(err);
+                map.release();
+                t.ok(png instanceof Buffer);
+                t.equal(png.toString('binary', 1, 4), 'PNG');
+                t.end();
+            });
+        });
+
+        t.test('returns a PNG image with encoding options', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+            map.render({ format: 'png', compressionLevel: 1, pngFilter: 'adaptive' }, function(err, png) {
+                t.error(err);
+                map.release();
+                t.ok(png instanceof Buffer);
+                t.equal(png.toString('binary', 1, 4), 'PNG');
+                t.end();
+            });
+        });
+
         t.test('can be called several times in serial', function(t) {
             var completed = 0;
             var remaining = 10;
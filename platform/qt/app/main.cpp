@@ -10,6 +10,10 @@ int main(int argc, char **argv)
     settings.setCacheDatabasePath("/tmp/mbgl-cache.db");
     settings.setCacheDatabaseMaximumSize(20 * 1024 * 1024);
 
+    if (app.arguments().contains("--threaded")) {
+        settings.setRenderingMode(QMapboxGLSettings::ThreadedRendering);
+    }
+
     MapWindow window(settings);
 
     window.resize(800, 600);
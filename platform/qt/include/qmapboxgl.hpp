@@ -35,6 +35,11 @@ public:
         FlippedYViewport
     };
 
+    enum RenderingMode {
+        DirectRendering = 0,
+        ThreadedRendering
+    };
+
     GLContextMode contextMode() const;
     void setContextMode(GLContextMode);
 
@@ -44,6 +49,9 @@ public:
     ViewportMode viewportMode() const;
     void setViewportMode(ViewportMode);
 
+    RenderingMode renderingMode() const;
+    void setRenderingMode(RenderingMode);
+
     unsigned cacheDatabaseMaximumSize() const;
     void setCacheDatabaseMaximumSize(unsigned);
 
@@ -63,6 +71,7 @@ private:
     GLContextMode m_contextMode;
     ConstrainMode m_constrainMode;
     ViewportMode m_viewportMode;
+    RenderingMode m_renderingMode;
 
     unsigned m_cacheMaximumSize;
     QString m_cacheDatabasePath;
@@ -14,6 +14,7 @@ set(CMAKE_INCLUDE_CURRENT_DIR ON)
 
 set(MBGL_QT_FILES
     # File source
+    PRIVATE platform/default/archive_file_source.cpp
     PRIVATE platform/default/asset_file_source.cpp
     PRIVATE platform/default/default_file_source.cpp
     PRIVATE platform/default/local_file_source.cpp
@@ -25,6 +26,12 @@ set(MBGL_QT_FILES
     PRIVATE platform/default/mbgl/storage/offline_database.hpp
     PRIVATE platform/default/mbgl/storage/offline_download.cpp
     PRIVATE platform/default/mbgl/storage/offline_download.hpp
+    PRIVATE platform/default/mbgl/storage/response_cache.cpp
+    PRIVATE platform/default/mbgl/storage/response_cache.hpp
+    PRIVATE platform/default/mbgl/storage/tile_archive.cpp
+    PRIVATE platform/default/mbgl/storage/tile_archive.hpp
+    PRIVATE platform/default/mbgl/util/mapped_file.cpp
+    PRIVATE platform/default/mbgl/util/mapped_file.hpp
     PRIVATE platform/default/sqlite3.hpp
 
     # Misc
@@ -35,6 +42,9 @@ set(MBGL_QT_FILES
     PRIVATE platform/default/mbgl/util/shared_thread_pool.hpp
     PRIVATE platform/default/mbgl/util/default_thread_pool.cpp
     PRIVATE platform/default/mbgl/util/default_thread_pool.hpp
+    PRIVATE platform/default/mbgl/util/work_stealing_deque.hpp
+    PRIVATE platform/default/mbgl/util/work_stealing_thread_pool.cpp
+    PRIVATE platform/default/mbgl/util/work_stealing_thread_pool.hpp
 
     # Platform integration
     PRIVATE platform/qt/src/async_task.cpp
@@ -44,6 +54,7 @@ set(MBGL_QT_FILES
     PRIVATE platform/qt/src/http_request.cpp
     PRIVATE platform/qt/src/http_request.hpp
     PRIVATE platform/qt/src/image.cpp
+    PRIVATE platform/qt/src/local_glyph_rasterizer.cpp
     PRIVATE platform/qt/src/run_loop.cpp
     PRIVATE platform/qt/src/run_loop_impl.hpp
     PRIVATE platform/qt/src/sqlite3.cpp
@@ -15,12 +15,15 @@ std::u16string applyArabicShaping(const std::u16string& input) {
     return input;
 }
 
-void BiDi::mergeParagraphLineBreaks(std::set<std::size_t>& lineBreakPoints) {
-    lineBreakPoints.insert(static_cast<std::size_t>(impl->string.length()));
+void BiDi::mergeParagraphLineBreaks(std::vector<std::size_t>& lineBreakPoints) {
+    const auto end = static_cast<std::size_t>(impl->string.length());
+    if (lineBreakPoints.empty() || lineBreakPoints.back() != end) {
+        lineBreakPoints.push_back(end);
+    }
 }
 
 std::vector<std::u16string>
-BiDi::applyLineBreaking(std::set<std::size_t> lineBreakPoints) {
+BiDi::applyLineBreaking(std::vector<std::size_t> lineBreakPoints) {
     mergeParagraphLineBreaks(lineBreakPoints);
 
     std::vector<std::u16string> transformedLines;
@@ -39,7 +42,7 @@ BiDi::BiDi() : impl(std::make_unique<BiDiImpl>())
 
 BiDi::~BiDi() = default;
 
-std::vector<std::u16string> BiDi::processText(const std::u16string& input, std::set<std::size_t> lineBreakPoints) {
+std::vector<std::u16string> BiDi::processText(const std::u16string& input, std::vector<std::size_t> lineBreakPoints) {
     impl->string = QString::fromUtf16(reinterpret_cast<const ushort*>(input.data()), int(input.size()));
     return applyLineBreaking(lineBreakPoints);
 }
@@ -69,6 +69,19 @@ void HTTPFileSource::Impl::cancel(HTTPRequest* req)
     }
 }
 
+void HTTPFileSource::Impl::preconnect(const QUrl& url)
+{
+#if QT_VERSION >= 0x050200
+    if (url.scheme() == QLatin1String("https")) {
+        m_manager->connectToHostEncrypted(url.host(), url.port(443));
+    } else if (url.scheme() == QLatin1String("http")) {
+        m_manager->connectToHost(url.host(), url.port(80));
+    }
+#else
+    Q_UNUSED(url);
+#endif
+}
+
 void HTTPFileSource::Impl::onReplyFinished()
 {
     QNetworkReply* reply = qobject_cast<QNetworkReply *>(sender());
@@ -100,6 +113,10 @@ std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource,
     return std::make_unique<HTTPRequest>(impl.get(), resource, callback);
 }
 
+void HTTPFileSource::preconnect(const std::string& url) {
+    impl->preconnect(QUrl(QString::fromStdString(url)));
+}
+
 uint32_t HTTPFileSource::maximumConcurrentRequests() {
 #if QT_VERSION >= 0x050000
     return 20;
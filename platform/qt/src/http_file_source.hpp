@@ -25,6 +25,7 @@ public:
 
     void request(HTTPRequest *);
     void cancel(HTTPRequest *);
+    void preconnect(const QUrl &);
 
 public slots:
     void onReplyFinished();
@@ -94,11 +94,9 @@ void HTTPRequest::handleNetworkReply(QNetworkReply *reply)
     switch(responseCode) {
     case 200: {
         QByteArray bytes = reply->readAll();
-        if (bytes.isEmpty()) {
-            response.data = std::make_shared<std::string>();
-        } else {
-            response.data = std::make_shared<std::string>(bytes.constData(), bytes.size());
-        }
+        // QByteArray shares its data, so the buffer can hold on to it instead of copying it.
+        auto holder = std::make_shared<const QByteArray>(std::move(bytes));
+        response.data = std::make_shared<Buffer>(holder->constData(), holder->size(), holder);
         break;
     }
     case 204:
@@ -1,4 +1,5 @@
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/premultiply.hpp>
 
 #include <QBuffer>
 #include <QByteArray>
@@ -6,7 +7,7 @@
 
 namespace mbgl {
 
-std::string encodePNG(const PremultipliedImage& pre) {
+std::string encodePNG(const PremultipliedImage& pre, const PNGEncodeOptions& options) {
     QImage image(pre.data.get(), pre.size.width, pre.size.height,
         QImage::Format_ARGB32_Premultiplied);
 
@@ -14,20 +15,42 @@ std::string encodePNG(const PremultipliedImage& pre) {
     QBuffer buffer(&array);
 
     buffer.open(QIODevice::WriteOnly);
-    image.rgbSwapped().save(&buffer, "PNG");
+    // Qt maps the quality of PNG images to the zlib compression level, from 100 (fastest) to 0
+    // (smallest). Filters and palettes are left to Qt.
+    const int quality = options.compressionLevel < 0 ? -1 : (9 - options.compressionLevel) * 100 / 9;
+    image.rgbSwapped().save(&buffer, "PNG", quality);
 
     return std::string(array.constData(), array.size());
 }
 
 #if !defined(QT_IMAGE_DECODERS)
-PremultipliedImage decodeJPEG(const uint8_t*, size_t);
-PremultipliedImage decodeWebP(const uint8_t*, size_t);
+UnassociatedImage decodeJPEG(const uint8_t*, size_t);
+UnassociatedImage decodeWebP(const uint8_t*, size_t);
 #endif
 
-PremultipliedImage decodeImage(const std::string& string) {
-    const uint8_t* data = reinterpret_cast<const uint8_t*>(string.data());
-    const size_t size = string.size();
+namespace {
 
+template <ImageAlphaMode Mode>
+Image<Mode> decodeQImage(const uint8_t* data, std::size_t size, QImage::Format format) {
+    QImage image =
+        QImage::fromData(data, size)
+        .rgbSwapped()
+        .convertToFormat(format);
+
+    if (image.isNull()) {
+        throw std::runtime_error("Unsupported image type");
+    }
+
+    auto img = std::make_unique<uint8_t[]>(image.byteCount());
+    memcpy(img.get(), image.constBits(), image.byteCount());
+
+    return { { static_cast<uint32_t>(image.width()), static_cast<uint32_t>(image.height()) },
+             std::move(img) };
+}
+
+} // namespace
+
+UnassociatedImage decodeUnassociatedImage(const uint8_t* data, std::size_t size) {
 #if !defined(QT_IMAGE_DECODERS)
     if (size >= 12) {
         uint32_t riff_magic = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
@@ -45,19 +68,30 @@ PremultipliedImage decodeImage(const std::string& string) {
     }
 #endif
 
-    QImage image =
-        QImage::fromData(data, size)
-        .rgbSwapped()
-        .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    return decodeQImage<ImageAlphaMode::Unassociated>(data, size, QImage::Format_ARGB32);
+}
 
-    if (image.isNull()) {
-        throw std::runtime_error("Unsupported image type");
+PremultipliedImage decodeImage(const uint8_t* data, std::size_t size) {
+#if !defined(QT_IMAGE_DECODERS)
+    if (size >= 12) {
+        uint32_t riff_magic = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+        uint32_t webp_magic = (data[8] << 24) | (data[9] << 16) | (data[10] << 8) | data[11];
+        if (riff_magic == 0x52494646 && webp_magic == 0x57454250) {
+            return util::premultiply(decodeWebP(data, size));
+        }
     }
 
-    auto img = std::make_unique<uint8_t[]>(image.byteCount());
-    memcpy(img.get(), image.constBits(), image.byteCount());
+    if (size >= 2) {
+        uint16_t magic = ((data[0] << 8) | data[1]) & 0xffff;
+        if (magic == 0xFFD8) {
+            // JPEGs are opaque, so premultiplying them wouldn't change them.
+            UnassociatedImage image = decodeJPEG(data, size);
+            return { image.size, std::move(image.data) };
+        }
+    }
+#endif
 
-    return { { static_cast<uint32_t>(image.width()), static_cast<uint32_t>(image.height()) },
-             std::move(img) };
-}
+    return decodeQImage<ImageAlphaMode::Premultiplied>(data, size, QImage::Format_ARGB32_Premultiplied);
 }
+
+} // namespace mbgl
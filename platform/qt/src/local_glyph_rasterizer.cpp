@@ -0,0 +1,79 @@
+#include <mbgl/text/local_glyph_rasterizer.hpp>
+#include <mbgl/text/tiny_sdf.hpp>
+#include <mbgl/util/i18n.hpp>
+
+#include <QChar>
+#include <QFont>
+#include <QFontMetrics>
+#include <QImage>
+#include <QPainter>
+#include <QString>
+
+namespace mbgl {
+
+class LocalGlyphRasterizer::Impl {
+public:
+    explicit Impl(const optional<std::string> fontFamily_) : fontFamily(fontFamily_) {
+        if (fontFamily) {
+            font.setFamily(QString::fromStdString(*fontFamily));
+            font.setPixelSize(glyphSize);
+        }
+    }
+
+    const optional<std::string> fontFamily;
+    QFont font;
+};
+
+LocalGlyphRasterizer::LocalGlyphRasterizer(const optional<std::string> fontFamily)
+    : impl(std::make_unique<Impl>(fontFamily)) {
+}
+
+LocalGlyphRasterizer::~LocalGlyphRasterizer() = default;
+
+bool LocalGlyphRasterizer::canRasterizeGlyph(const FontStack&, GlyphID glyphID) {
+    return impl->fontFamily && util::i18n::allowsFixedWidthGlyphGeneration(glyphID);
+}
+
+SDFGlyph LocalGlyphRasterizer::rasterizeGlyph(const FontStack&, GlyphID glyphID) {
+    SDFGlyph glyph;
+    glyph.id = glyphID;
+
+    const QFontMetrics metrics(impl->font);
+    if (!metrics.inFont(QChar(glyphID))) {
+        return glyph;
+    }
+
+    glyph.metrics.width = glyphSize;
+    glyph.metrics.height = glyphSize;
+    glyph.metrics.left = 0;
+    glyph.metrics.top = glyphTop;
+    glyph.metrics.advance = glyphSize;
+
+    const int border = SDFGlyph::borderSize;
+    const int size = glyphSize + 2 * border;
+
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setFont(impl->font);
+    painter.setPen(Qt::black);
+    painter.drawText(QPoint(border, border + metrics.ascent()), QString(QChar(glyphID)));
+    painter.end();
+
+    AlphaImage raster({ uint32_t(size), uint32_t(size) });
+    for (int y = 0; y < size; y++) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+        for (int x = 0; x < size; x++) {
+            raster.data[y * size + x] = qAlpha(line[x]);
+        }
+    }
+
+    // Glyph PBFs are encoded with a radius of 8 pixels and a cutoff of 0.25.
+    glyph.bitmap = util::transformRasterToSDF(raster, 8, 0.25);
+
+    return glyph;
+}
+
+} // namespace mbgl
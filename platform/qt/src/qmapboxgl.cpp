@@ -162,6 +162,22 @@ std::unique_ptr<const mbgl::SpriteImage> toSpriteImage(const QImage &sprite) {
     \sa viewportMode()
 */
 
+/*!
+    \enum QMapboxGLSettings::RenderingMode
+
+    This enum selects the thread the map is rendered on.
+
+    \value DirectRendering  QMapboxGL::render() draws the map on the calling thread,
+    into the framebuffer currently bound on the current OpenGL context.
+
+    \value ThreadedRendering  QMapboxGL owns a render thread with an OpenGL context
+    shared with the one current at construction time. Style evaluation, tile updates
+    and drawing happen on that thread, and QMapboxGL::render() only presents the
+    latest finished frame as a texture.
+
+    \sa renderingMode()
+*/
+
 /*!
     Constructs a QMapboxGLSettings object with the default values. The default
     configuration is valid for initializing a QMapboxGL.
@@ -170,6 +186,7 @@ QMapboxGLSettings::QMapboxGLSettings()
     : m_contextMode(QMapboxGLSettings::SharedGLContext)
     , m_constrainMode(QMapboxGLSettings::ConstrainHeightOnly)
     , m_viewportMode(QMapboxGLSettings::DefaultViewport)
+    , m_renderingMode(QMapboxGLSettings::DirectRendering)
     , m_cacheMaximumSize(mbgl::util::DEFAULT_MAX_CACHE_SIZE)
     , m_cacheDatabasePath(":memory:")
     , m_assetPath(QCoreApplication::applicationDirPath())
@@ -235,6 +252,29 @@ void QMapboxGLSettings::setViewportMode(ViewportMode mode)
     m_viewportMode = mode;
 }
 
+/*!
+    Returns the rendering mode. Threaded rendering keeps the thread calling
+    QMapboxGL::render() responsive while the map is being drawn.
+
+    Threaded rendering requires Qt 5.8 or later, and an OpenGL context to be
+    current when the QMapboxGL is constructed. Otherwise the map falls back to
+    direct rendering.
+
+    By default, it is set to QMapboxGLSettings::DirectRendering.
+*/
+QMapboxGLSettings::RenderingMode QMapboxGLSettings::renderingMode() const
+{
+    return m_renderingMode;
+}
+
+/*!
+    Sets the rendering \a mode.
+*/
+void QMapboxGLSettings::setRenderingMode(RenderingMode mode)
+{
+    m_renderingMode = mode;
+}
+
 /*!
     Returns the cache database maximum hard size in bytes. The database
     will grow until the limit is reached. Setting a maximum size smaller
@@ -466,7 +506,7 @@ QMapboxGL::~QMapboxGL()
 */
 void QMapboxGL::cycleDebugOptions()
 {
-    d_ptr->mapObj->cycleDebugOptions();
+    d_ptr->invoke([&] { d_ptr->mapObj->cycleDebugOptions(); });
 }
 
 /*!
@@ -482,12 +522,12 @@ void QMapboxGL::cycleDebugOptions()
 */
 QString QMapboxGL::styleJson() const
 {
-    return QString::fromStdString(d_ptr->mapObj->getStyleJSON());
+    return d_ptr->invoke([&] { return QString::fromStdString(d_ptr->mapObj->getStyleJSON()); });
 }
 
 void QMapboxGL::setStyleJson(const QString &style)
 {
-    d_ptr->mapObj->setStyleJSON(style.toStdString());
+    d_ptr->invoke([&] { d_ptr->mapObj->setStyleJSON(style.toStdString()); });
 }
 
 /*!
@@ -507,12 +547,12 @@ void QMapboxGL::setStyleJson(const QString &style)
 */
 QString QMapboxGL::styleUrl() const
 {
-    return QString::fromStdString(d_ptr->mapObj->getStyleURL());
+    return d_ptr->invoke([&] { return QString::fromStdString(d_ptr->mapObj->getStyleURL()); });
 }
 
 void QMapboxGL::setStyleUrl(const QString &url)
 {
-    d_ptr->mapObj->setStyleURL(url.toStdString());
+    d_ptr->invoke([&] { d_ptr->mapObj->setStyleURL(url.toStdString()); });
 }
 
 /*!
@@ -524,12 +564,15 @@ void QMapboxGL::setStyleUrl(const QString &url)
 */
 double QMapboxGL::latitude() const
 {
-    return d_ptr->mapObj->getLatLng(d_ptr->margins).latitude();
+    return d_ptr->invoke([&] { return d_ptr->mapObj->getLatLng(d_ptr->margins).latitude(); });
 }
 
 void QMapboxGL::setLatitude(double latitude_)
 {
-    d_ptr->mapObj->setLatLng(mbgl::LatLng { latitude_, longitude() }, d_ptr->margins);
+    d_ptr->post([this, latitude_, margins = d_ptr->margins] {
+        const double longitude_ = d_ptr->mapObj->getLatLng(margins).longitude();
+        d_ptr->mapObj->setLatLng(mbgl::LatLng { latitude_, longitude_ }, margins);
+    });
 }
 
 /*!
@@ -542,12 +585,15 @@ void QMapboxGL::setLatitude(double latitude_)
 */
 double QMapboxGL::longitude() const
 {
-    return d_ptr->mapObj->getLatLng(d_ptr->margins).longitude();
+    return d_ptr->invoke([&] { return d_ptr->mapObj->getLatLng(d_ptr->margins).longitude(); });
 }
 
 void QMapboxGL::setLongitude(double longitude_)
 {
-    d_ptr->mapObj->setLatLng(mbgl::LatLng { latitude(), longitude_ }, d_ptr->margins);
+    d_ptr->post([this, longitude_, margins = d_ptr->margins] {
+        const double latitude_ = d_ptr->mapObj->getLatLng(margins).latitude();
+        d_ptr->mapObj->setLatLng(mbgl::LatLng { latitude_, longitude_ }, margins);
+    });
 }
 
 /*!
@@ -565,12 +611,14 @@ void QMapboxGL::setLongitude(double longitude_)
 */
 double QMapboxGL::scale() const
 {
-    return std::pow(2.0, d_ptr->mapObj->getZoom());
+    return d_ptr->invoke([&] { return std::pow(2.0, d_ptr->mapObj->getZoom()); });
 }
 
 void QMapboxGL::setScale(double scale_, const QPointF &center)
 {
-    d_ptr->mapObj->setZoom(std::log2(scale_), mbgl::ScreenCoordinate { center.x(), center.y() });
+    d_ptr->post([this, scale_, center] {
+        d_ptr->mapObj->setZoom(std::log2(scale_), mbgl::ScreenCoordinate { center.x(), center.y() });
+    });
 }
 
 /*!
@@ -585,12 +633,14 @@ void QMapboxGL::setScale(double scale_, const QPointF &center)
 */
 double QMapboxGL::zoom() const
 {
-    return d_ptr->mapObj->getZoom();
+    return d_ptr->invoke([&] { return d_ptr->mapObj->getZoom(); });
 }
 
 void QMapboxGL::setZoom(double zoom_)
 {
-    d_ptr->mapObj->setZoom(zoom_, d_ptr->margins);
+    d_ptr->post([this, zoom_, margins = d_ptr->margins] {
+        d_ptr->mapObj->setZoom(zoom_, margins);
+    });
 }
 
 /*!
@@ -600,7 +650,7 @@ void QMapboxGL::setZoom(double zoom_)
 */
 double QMapboxGL::minimumZoom() const
 {
-    return d_ptr->mapObj->getMinZoom();
+    return d_ptr->invoke([&] { return d_ptr->mapObj->getMinZoom(); });
 }
 
 /*!
@@ -610,7 +660,7 @@ double QMapboxGL::minimumZoom() const
 */
 double QMapboxGL::maximumZoom() const
 {
-    return d_ptr->mapObj->getMaxZoom();
+    return d_ptr->invoke([&] { return d_ptr->mapObj->getMaxZoom(); });
 }
 
 /*!
@@ -623,13 +673,15 @@ double QMapboxGL::maximumZoom() const
 */
 Coordinate QMapboxGL::coordinate() const
 {
-    const mbgl::LatLng& latLng = d_ptr->mapObj->getLatLng(d_ptr->margins);
+    const mbgl::LatLng latLng = d_ptr->invoke([&] { return d_ptr->mapObj->getLatLng(d_ptr->margins); });
     return Coordinate(latLng.latitude(), latLng.longitude());
 }
 
 void QMapboxGL::setCoordinate(const QMapbox::Coordinate &coordinate_)
 {
-    d_ptr->mapObj->setLatLng(mbgl::LatLng { coordinate_.first, coordinate_.second }, d_ptr->margins);
+    d_ptr->post([this, coordinate_, margins = d_ptr->margins] {
+        d_ptr->mapObj->setLatLng(mbgl::LatLng { coordinate_.first, coordinate_.second }, margins);
+    });
 }
 
 /*!
@@ -645,8 +697,10 @@ void QMapboxGL::setCoordinate(const QMapbox::Coordinate &coordinate_)
 */
 void QMapboxGL::setCoordinateZoom(const QMapbox::Coordinate &coordinate_, double zoom_)
 {
-    d_ptr->mapObj->setLatLngZoom(
-            mbgl::LatLng { coordinate_.first, coordinate_.second }, zoom_, d_ptr->margins);
+    d_ptr->post([this, coordinate_, zoom_, margins = d_ptr->margins] {
+        d_ptr->mapObj->setLatLngZoom(
+                mbgl::LatLng { coordinate_.first, coordinate_.second }, zoom_, margins);
+    });
 }
 
 /*!
@@ -675,7 +729,9 @@ void QMapboxGL::jumpTo(const QMapboxGLCameraOptions& camera)
 
     mbglCamera.padding = d_ptr->margins;
 
-    d_ptr->mapObj->jumpTo(mbglCamera);
+    d_ptr->post([this, mbglCamera] {
+        d_ptr->mapObj->jumpTo(mbglCamera);
+    });
 }
 
 /*!
@@ -692,17 +748,21 @@ void QMapboxGL::jumpTo(const QMapboxGLCameraOptions& camera)
 */
 double QMapboxGL::bearing() const
 {
-    return d_ptr->mapObj->getBearing();
+    return d_ptr->invoke([&] { return d_ptr->mapObj->getBearing(); });
 }
 
 void QMapboxGL::setBearing(double degrees)
 {
-    d_ptr->mapObj->setBearing(degrees, d_ptr->margins);
+    d_ptr->post([this, degrees, margins = d_ptr->margins] {
+        d_ptr->mapObj->setBearing(degrees, margins);
+    });
 }
 
 void QMapboxGL::setBearing(double degrees, const QPointF &center)
 {
-    d_ptr->mapObj->setBearing(degrees, mbgl::ScreenCoordinate { center.x(), center.y() });
+    d_ptr->post([this, degrees, center] {
+        d_ptr->mapObj->setBearing(degrees, mbgl::ScreenCoordinate { center.x(), center.y() });
+    });
 }
 
 /*!
@@ -716,12 +776,14 @@ void QMapboxGL::setBearing(double degrees, const QPointF &center)
 */
 double QMapboxGL::pitch() const
 {
-    return d_ptr->mapObj->getPitch();
+    return d_ptr->invoke([&] { return d_ptr->mapObj->getPitch(); });
 }
 
 void QMapboxGL::setPitch(double pitch_)
 {
-    d_ptr->mapObj->setPitch(pitch_);
+    d_ptr->post([this, pitch_] {
+        d_ptr->mapObj->setPitch(pitch_);
+    });
 }
 
 /*!
@@ -729,7 +791,7 @@ void QMapboxGL::setPitch(double pitch_)
 */
 QMapboxGL::NorthOrientation QMapboxGL::northOrientation() const
 {
-    return static_cast<QMapboxGL::NorthOrientation>(d_ptr->mapObj->getNorthOrientation());
+    return d_ptr->invoke([&] { return static_cast<QMapboxGL::NorthOrientation>(d_ptr->mapObj->getNorthOrientation()); });
 }
 
 /*!
@@ -737,7 +799,9 @@ QMapboxGL::NorthOrientation QMapboxGL::northOrientation() const
 */
 void QMapboxGL::setNorthOrientation(NorthOrientation orientation)
 {
-    d_ptr->mapObj->setNorthOrientation(static_cast<mbgl::NorthOrientation>(orientation));
+    d_ptr->post([this, orientation] {
+        d_ptr->mapObj->setNorthOrientation(static_cast<mbgl::NorthOrientation>(orientation));
+    });
 }
 
 /*!
@@ -747,7 +811,9 @@ void QMapboxGL::setNorthOrientation(NorthOrientation orientation)
 */
 void QMapboxGL::setGestureInProgress(bool progress)
 {
-    d_ptr->mapObj->setGestureInProgress(progress);
+    d_ptr->post([this, progress] {
+        d_ptr->mapObj->setGestureInProgress(progress);
+    });
 }
 
 /*!
@@ -762,7 +828,7 @@ void QMapboxGL::setGestureInProgress(bool progress)
 */
 void QMapboxGL::addClass(const QString &className)
 {
-    d_ptr->mapObj->addClass(className.toStdString());
+    d_ptr->invoke([&] { d_ptr->mapObj->addClass(className.toStdString()); });
 }
 
 /*!
@@ -773,7 +839,7 @@ void QMapboxGL::addClass(const QString &className)
 */
 void QMapboxGL::removeClass(const QString &className)
 {
-    d_ptr->mapObj->removeClass(className.toStdString());
+    d_ptr->invoke([&] { d_ptr->mapObj->removeClass(className.toStdString()); });
 }
 
 /*!
@@ -784,7 +850,7 @@ void QMapboxGL::removeClass(const QString &className)
 */
 bool QMapboxGL::hasClass(const QString &className) const
 {
-    return d_ptr->mapObj->hasClass(className.toStdString());
+    return d_ptr->invoke([&] { return d_ptr->mapObj->hasClass(className.toStdString()); });
 }
 
 /*!
@@ -795,7 +861,7 @@ bool QMapboxGL::hasClass(const QString &className) const
 */
 void QMapboxGL::setClasses(const QStringList &classNames)
 {
-    d_ptr->mapObj->setClasses(fromQStringList(classNames));
+    d_ptr->invoke([&] { d_ptr->mapObj->setClasses(fromQStringList(classNames)); });
 }
 
 /*!
@@ -806,11 +872,13 @@ void QMapboxGL::setClasses(const QStringList &classNames)
 */
 QStringList QMapboxGL::getClasses() const
 {
-    QStringList classNames;
-    for (const std::string &mbglClass : d_ptr->mapObj->getClasses()) {
-        classNames << QString::fromStdString(mbglClass);
-    }
-    return classNames;
+    return d_ptr->invoke([&]() -> QStringList {
+        QStringList classNames;
+        for (const std::string &mbglClass : d_ptr->mapObj->getClasses()) {
+            classNames << QString::fromStdString(mbglClass);
+        }
+        return classNames;
+    });
 }
 
 /*!
@@ -825,7 +893,7 @@ void QMapboxGL::setTransitionOptions(qint64 duration, qint64 delay) {
         return std::chrono::duration_cast<mbgl::Duration>(mbgl::Milliseconds(value));
     };
 
-    d_ptr->mapObj->setTransitionOptions(mbgl::style::TransitionOptions{ convert(duration), convert(delay) });
+    d_ptr->invoke([&] { d_ptr->mapObj->setTransitionOptions(mbgl::style::TransitionOptions{ convert(duration), convert(delay) }); });
 }
 
 mbgl::Annotation asMapboxGLAnnotation(const QMapbox::Annotation & annotation) {
@@ -883,7 +951,7 @@ mbgl::Annotation asMapboxGLAnnotation(const QMapbox::Annotation & annotation) {
 */
 QMapbox::AnnotationID QMapboxGL::addAnnotation(const QMapbox::Annotation &annotation)
 {
-    return d_ptr->mapObj->addAnnotation(asMapboxGLAnnotation(annotation));
+    return d_ptr->invoke([&] { return d_ptr->mapObj->addAnnotation(asMapboxGLAnnotation(annotation)); });
 }
 
 /*!
@@ -893,7 +961,7 @@ QMapbox::AnnotationID QMapboxGL::addAnnotation(const QMapbox::Annotation &annota
 */
 void QMapboxGL::updateAnnotation(QMapbox::AnnotationID id, const QMapbox::Annotation &annotation)
 {
-    d_ptr->mapObj->updateAnnotation(id, asMapboxGLAnnotation(annotation));
+    d_ptr->invoke([&] { d_ptr->mapObj->updateAnnotation(id, asMapboxGLAnnotation(annotation)); });
 }
 
 /*!
@@ -901,7 +969,7 @@ void QMapboxGL::updateAnnotation(QMapbox::AnnotationID id, const QMapbox::Annota
 */
 void QMapboxGL::removeAnnotation(QMapbox::AnnotationID id)
 {
-    d_ptr->mapObj->removeAnnotation(id);
+    d_ptr->invoke([&] { d_ptr->mapObj->removeAnnotation(id); });
 }
 
 /*!
@@ -941,18 +1009,20 @@ void QMapboxGL::removeAnnotation(QMapbox::AnnotationID id)
 */
 void QMapboxGL::setLayoutProperty(const QString& layer, const QString& property, const QVariant& value)
 {
-    using namespace mbgl::style;
+    d_ptr->invoke([&] {
+        using namespace mbgl::style;
 
-    Layer* layer_ = d_ptr->mapObj->getLayer(layer.toStdString());
-    if (!layer_) {
-        qWarning() << "Layer not found:" << layer;
-        return;
-    }
+        Layer* layer_ = d_ptr->mapObj->getLayer(layer.toStdString());
+        if (!layer_) {
+            qWarning() << "Layer not found:" << layer;
+            return;
+        }
 
-    if (conversion::setLayoutProperty(*layer_, property.toStdString(), value)) {
-        qWarning() << "Error setting layout property:" << layer << "-" << property;
-        return;
-    }
+        if (conversion::setLayoutProperty(*layer_, property.toStdString(), value)) {
+            qWarning() << "Error setting layout property:" << layer << "-" << property;
+            return;
+        }
+    });
 }
 
 /*!
@@ -1010,23 +1080,25 @@ void QMapboxGL::setLayoutProperty(const QString& layer, const QString& property,
 */
 void QMapboxGL::setPaintProperty(const QString& layer, const QString& property, const QVariant& value, const QString& styleClass)
 {
-    using namespace mbgl::style;
+    d_ptr->invoke([&] {
+        using namespace mbgl::style;
 
-    Layer* layer_ = d_ptr->mapObj->getLayer(layer.toStdString());
-    if (!layer_) {
-        qWarning() << "Layer not found:" << layer;
-        return;
-    }
+        Layer* layer_ = d_ptr->mapObj->getLayer(layer.toStdString());
+        if (!layer_) {
+            qWarning() << "Layer not found:" << layer;
+            return;
+        }
 
-    mbgl::optional<std::string> klass;
-    if (!styleClass.isEmpty()) {
-        klass = styleClass.toStdString();
-    }
+        mbgl::optional<std::string> klass;
+        if (!styleClass.isEmpty()) {
+            klass = styleClass.toStdString();
+        }
 
-    if (conversion::setPaintProperty(*layer_, property.toStdString(), value, klass)) {
-        qWarning() << "Error setting paint property:" << layer << "-" << property;
-        return;
-    }
+        if (conversion::setPaintProperty(*layer_, property.toStdString(), value, klass)) {
+            qWarning() << "Error setting paint property:" << layer << "-" << property;
+            return;
+        }
+    });
 }
 
 /*!
@@ -1035,7 +1107,7 @@ void QMapboxGL::setPaintProperty(const QString& layer, const QString& property,
 */
 bool QMapboxGL::isFullyLoaded() const
 {
-    return d_ptr->mapObj->isFullyLoaded();
+    return d_ptr->invoke([&] { return d_ptr->mapObj->isFullyLoaded(); });
 }
 
 /*!
@@ -1045,7 +1117,9 @@ bool QMapboxGL::isFullyLoaded() const
 */
 void QMapboxGL::moveBy(const QPointF &offset)
 {
-    d_ptr->mapObj->moveBy(mbgl::ScreenCoordinate { offset.x(), offset.y() });
+    d_ptr->post([this, offset] {
+        d_ptr->mapObj->moveBy(mbgl::ScreenCoordinate { offset.x(), offset.y() });
+    });
 }
 
 /*!
@@ -1055,7 +1129,9 @@ void QMapboxGL::moveBy(const QPointF &offset)
     can be used for implementing a pinch gesture.
 */
 void QMapboxGL::scaleBy(double scale_, const QPointF &center) {
-    d_ptr->mapObj->setZoom(d_ptr->mapObj->getZoom() + std::log2(scale_), mbgl::ScreenCoordinate { center.x(), center.y() });
+    d_ptr->post([this, scale_, center] {
+        d_ptr->mapObj->setZoom(d_ptr->mapObj->getZoom() + std::log2(scale_), mbgl::ScreenCoordinate { center.x(), center.y() });
+    });
 }
 
 /*!
@@ -1066,9 +1142,11 @@ void QMapboxGL::scaleBy(double scale_, const QPointF &center) {
 */
 void QMapboxGL::rotateBy(const QPointF &first, const QPointF &second)
 {
-    d_ptr->mapObj->rotateBy(
-            mbgl::ScreenCoordinate { first.x(), first.y() },
-            mbgl::ScreenCoordinate { second.x(), second.y() });
+    d_ptr->post([this, first, second] {
+        d_ptr->mapObj->rotateBy(
+                mbgl::ScreenCoordinate { first.x(), first.y() },
+                mbgl::ScreenCoordinate { second.x(), second.y() });
+    });
 }
 
 /*!
@@ -1089,12 +1167,16 @@ void QMapboxGL::resize(const QSize& size, const QSize& framebufferSize)
     d_ptr->size = size;
     d_ptr->fbSize = framebufferSize;
 
-    d_ptr->mapObj->setSize(sanitizedSize(size));
+    d_ptr->post([this, size, framebufferSize] {
+        d_ptr->renderFramebufferSize = sanitizedSize(framebufferSize);
+        d_ptr->mapObj->setSize(sanitizedSize(size));
+    });
 }
 
 /*!
     If Mapbox GL needs to rebind the default framebuffer, it will use the
-    ID supplied here.
+    ID supplied here. In QMapboxGLSettings::ThreadedRendering mode, this is
+    the framebuffer render() presents the finished frames into.
 */
 void QMapboxGL::setFramebufferObject(quint32 fbo) {
     d_ptr->fbObject = fbo;
@@ -1113,7 +1195,7 @@ void QMapboxGL::addAnnotationIcon(const QString &name, const QImage &icon)
 {
     if (icon.isNull()) return;
 
-    d_ptr->mapObj->addAnnotationIcon(name.toStdString(), toSpriteImage(icon));
+    d_ptr->invoke([&] { d_ptr->mapObj->addAnnotationIcon(name.toStdString(), toSpriteImage(icon)); });
 }
 
 /*!
@@ -1121,7 +1203,7 @@ void QMapboxGL::addAnnotationIcon(const QString &name, const QImage &icon)
 */
 double QMapboxGL::metersPerPixelAtLatitude(double latitude, double zoom) const
 {
-    return d_ptr->mapObj->getMetersPerPixelAtLatitude(latitude, zoom);
+    return d_ptr->invoke([&] { return d_ptr->mapObj->getMetersPerPixelAtLatitude(latitude, zoom); });
 }
 
 /*!
@@ -1129,8 +1211,10 @@ double QMapboxGL::metersPerPixelAtLatitude(double latitude, double zoom) const
 */
 QMapbox::ProjectedMeters QMapboxGL::projectedMetersForCoordinate(const QMapbox::Coordinate &coordinate_) const
 {
-    auto projectedMeters = d_ptr->mapObj->projectedMetersForLatLng(mbgl::LatLng { coordinate_.first, coordinate_.second });
-    return QMapbox::ProjectedMeters(projectedMeters.northing(), projectedMeters.easting());
+    return d_ptr->invoke([&]() -> QMapbox::ProjectedMeters {
+        auto projectedMeters = d_ptr->mapObj->projectedMetersForLatLng(mbgl::LatLng { coordinate_.first, coordinate_.second });
+        return QMapbox::ProjectedMeters(projectedMeters.northing(), projectedMeters.easting());
+    });
 }
 
 /*!
@@ -1138,8 +1222,10 @@ QMapbox::ProjectedMeters QMapboxGL::projectedMetersForCoordinate(const QMapbox::
 */
 QMapbox::Coordinate QMapboxGL::coordinateForProjectedMeters(const QMapbox::ProjectedMeters &projectedMeters) const
 {
-    auto latLng = d_ptr->mapObj->latLngForProjectedMeters(mbgl::ProjectedMeters { projectedMeters.first, projectedMeters.second });
-    return QMapbox::Coordinate(latLng.latitude(), latLng.longitude());
+    return d_ptr->invoke([&]() -> QMapbox::Coordinate {
+        auto latLng = d_ptr->mapObj->latLngForProjectedMeters(mbgl::ProjectedMeters { projectedMeters.first, projectedMeters.second });
+        return QMapbox::Coordinate(latLng.latitude(), latLng.longitude());
+    });
 }
 
 /*!
@@ -1155,10 +1241,12 @@ QMapbox::Coordinate QMapboxGL::coordinateForProjectedMeters(const QMapbox::Proje
 */
 QPointF QMapboxGL::pixelForCoordinate(const QMapbox::Coordinate &coordinate_) const
 {
-    const mbgl::ScreenCoordinate pixel =
-        d_ptr->mapObj->pixelForLatLng(mbgl::LatLng { coordinate_.first, coordinate_.second });
+    return d_ptr->invoke([&]() -> QPointF {
+        const mbgl::ScreenCoordinate pixel =
+            d_ptr->mapObj->pixelForLatLng(mbgl::LatLng { coordinate_.first, coordinate_.second });
 
-    return QPointF(pixel.x, pixel.y);
+        return QPointF(pixel.x, pixel.y);
+    });
 }
 
 /*!
@@ -1166,10 +1254,12 @@ QPointF QMapboxGL::pixelForCoordinate(const QMapbox::Coordinate &coordinate_) co
 */
 QMapbox::Coordinate QMapboxGL::coordinateForPixel(const QPointF &pixel) const
 {
-    const mbgl::LatLng latLng =
-        d_ptr->mapObj->latLngForPixel(mbgl::ScreenCoordinate { pixel.x(), pixel.y() });
+    return d_ptr->invoke([&]() -> QMapbox::Coordinate {
+        const mbgl::LatLng latLng =
+            d_ptr->mapObj->latLngForPixel(mbgl::ScreenCoordinate { pixel.x(), pixel.y() });
 
-    return Coordinate(latLng.latitude(), latLng.longitude());
+        return Coordinate(latLng.latitude(), latLng.longitude());
+    });
 }
 
 /*!
@@ -1178,10 +1268,12 @@ QMapbox::Coordinate QMapboxGL::coordinateForPixel(const QPointF &pixel) const
 */
 QMapbox::CoordinateZoom QMapboxGL::coordinateZoomForBounds(const QMapbox::Coordinate &sw, QMapbox::Coordinate &ne) const
 {
-    auto bounds = mbgl::LatLngBounds::hull(mbgl::LatLng { sw.first, sw.second }, mbgl::LatLng { ne.first, ne.second });
-    mbgl::CameraOptions camera = d_ptr->mapObj->cameraForLatLngBounds(bounds, d_ptr->margins);
+    return d_ptr->invoke([&]() -> QMapbox::CoordinateZoom {
+        auto bounds = mbgl::LatLngBounds::hull(mbgl::LatLng { sw.first, sw.second }, mbgl::LatLng { ne.first, ne.second });
+        mbgl::CameraOptions camera = d_ptr->mapObj->cameraForLatLngBounds(bounds, d_ptr->margins);
 
-    return {{ (*camera.center).latitude(), (*camera.center).longitude() }, *camera.zoom };
+        return {{ (*camera.center).latitude(), (*camera.center).longitude() }, *camera.zoom };
+    });
 }
 
 /*!
@@ -1192,22 +1284,24 @@ QMapbox::CoordinateZoom QMapboxGL::coordinateZoomForBounds(const QMapbox::Coordi
     double newBearing, double newPitch)
 
 {
-    // FIXME: mbgl::Map::cameraForLatLngBounds should
-    // take bearing and pitch as input too, so this
-    // hack won't be needed.
-    double currentBearing = bearing();
-    double currentPitch = pitch();
+    return d_ptr->invoke([&]() -> QMapbox::CoordinateZoom {
+        // FIXME: mbgl::Map::cameraForLatLngBounds should
+        // take bearing and pitch as input too, so this
+        // hack won't be needed.
+        double currentBearing = bearing();
+        double currentPitch = pitch();
 
-    setBearing(newBearing);
-    setPitch(newPitch);
+        setBearing(newBearing);
+        setPitch(newPitch);
 
-    auto bounds = mbgl::LatLngBounds::hull(mbgl::LatLng { sw.first, sw.second }, mbgl::LatLng { ne.first, ne.second });
-    mbgl::CameraOptions camera = d_ptr->mapObj->cameraForLatLngBounds(bounds, d_ptr->margins);
+        auto bounds = mbgl::LatLngBounds::hull(mbgl::LatLng { sw.first, sw.second }, mbgl::LatLng { ne.first, ne.second });
+        mbgl::CameraOptions camera = d_ptr->mapObj->cameraForLatLngBounds(bounds, d_ptr->margins);
 
-    setBearing(currentBearing);
-    setPitch(currentPitch);
+        setBearing(currentBearing);
+        setPitch(currentPitch);
 
-    return {{ (*camera.center).latitude(), (*camera.center).longitude() }, *camera.zoom };
+        return {{ (*camera.center).latitude(), (*camera.center).longitude() }, *camera.zoom };
+    });
 }
 
 /*!
@@ -1266,7 +1360,7 @@ void QMapboxGL::addSource(const QString &id, const QVariantMap &params)
         return;
     }
 
-    d_ptr->mapObj->addSource(std::move(*source));
+    d_ptr->invoke([&] { d_ptr->mapObj->addSource(std::move(*source)); });
 }
 
 /*!
@@ -1274,7 +1368,7 @@ void QMapboxGL::addSource(const QString &id, const QVariantMap &params)
 */
 bool QMapboxGL::sourceExists(const QString& sourceID)
 {
-    return !!d_ptr->mapObj->getSource(sourceID.toStdString());
+    return d_ptr->invoke([&] { return !!d_ptr->mapObj->getSource(sourceID.toStdString()); });
 }
 
 /*!
@@ -1285,28 +1379,30 @@ bool QMapboxGL::sourceExists(const QString& sourceID)
 */
 void QMapboxGL::updateSource(const QString &id, const QVariantMap &params)
 {
-    using namespace mbgl::style;
-    using namespace mbgl::style::conversion;
+    d_ptr->invoke([&] {
+        using namespace mbgl::style;
+        using namespace mbgl::style::conversion;
 
-    auto source = d_ptr->mapObj->getSource(id.toStdString());
-    if (!source) {
-        addSource(id, params);
-        return;
-    }
+        auto source = d_ptr->mapObj->getSource(id.toStdString());
+        if (!source) {
+            addSource(id, params);
+            return;
+        }
 
-    auto sourceGeoJSON = source->as<GeoJSONSource>();
-    if (!sourceGeoJSON) {
-        qWarning() << "Unable to update source: only GeoJSON sources are mutable.";
-        return;
-    }
+        auto sourceGeoJSON = source->as<GeoJSONSource>();
+        if (!sourceGeoJSON) {
+            qWarning() << "Unable to update source: only GeoJSON sources are mutable.";
+            return;
+        }
 
-    if (params.contains("data")) {
-        Error error;
-        auto result = convertGeoJSON(params["data"], error);
-        if (result) {
-            sourceGeoJSON->setGeoJSON(*result);
+        if (params.contains("data")) {
+            Error error;
+            auto result = convertGeoJSON(params["data"], error);
+            if (result) {
+                sourceGeoJSON->setGeoJSON(*result);
+            }
         }
-    }
+    });
 }
 
 /*!
@@ -1316,11 +1412,13 @@ void QMapboxGL::updateSource(const QString &id, const QVariantMap &params)
 */
 void QMapboxGL::removeSource(const QString& id)
 {
-    auto sourceIDStdString = id.toStdString();
+    d_ptr->invoke([&] {
+        auto sourceIDStdString = id.toStdString();
 
-    if (d_ptr->mapObj->getSource(sourceIDStdString)) {
-        d_ptr->mapObj->removeSource(sourceIDStdString);
-    }
+        if (d_ptr->mapObj->getSource(sourceIDStdString)) {
+            d_ptr->mapObj->removeSource(sourceIDStdString);
+        }
+    });
 }
 
 /*!
@@ -1338,15 +1436,17 @@ void QMapboxGL::addCustomLayer(const QString &id,
         void *context,
         char *before)
 {
-    d_ptr->mapObj->addLayer(std::make_unique<mbgl::style::CustomLayer>(
-            id.toStdString(),
-            reinterpret_cast<mbgl::style::CustomLayerInitializeFunction>(initFn),
-            // This cast is safe as long as both mbgl:: and QMapbox::
-            // CustomLayerRenderParameters members remains the same.
-            (mbgl::style::CustomLayerRenderFunction)renderFn,
-            reinterpret_cast<mbgl::style::CustomLayerDeinitializeFunction>(deinitFn),
-            context),
-            before ? mbgl::optional<std::string>(before) : mbgl::optional<std::string>());
+    d_ptr->invoke([&] {
+        d_ptr->mapObj->addLayer(std::make_unique<mbgl::style::CustomLayer>(
+                id.toStdString(),
+                reinterpret_cast<mbgl::style::CustomLayerInitializeFunction>(initFn),
+                // This cast is safe as long as both mbgl:: and QMapbox::
+                // CustomLayerRenderParameters members remains the same.
+                (mbgl::style::CustomLayerRenderFunction)renderFn,
+                reinterpret_cast<mbgl::style::CustomLayerDeinitializeFunction>(deinitFn),
+                context),
+                before ? mbgl::optional<std::string>(before) : mbgl::optional<std::string>());
+    });
 }
 
 /*!
@@ -1380,7 +1480,7 @@ void QMapboxGL::addLayer(const QVariantMap &params)
         return;
     }
 
-    d_ptr->mapObj->addLayer(std::move(*layer));
+    d_ptr->invoke([&] { d_ptr->mapObj->addLayer(std::move(*layer)); });
 }
 
 /*!
@@ -1388,7 +1488,7 @@ void QMapboxGL::addLayer(const QVariantMap &params)
 */
 bool QMapboxGL::layerExists(const QString& id)
 {
-    return !!d_ptr->mapObj->getLayer(id.toStdString());
+    return d_ptr->invoke([&] { return !!d_ptr->mapObj->getLayer(id.toStdString()); });
 }
 
 /*!
@@ -1396,7 +1496,7 @@ bool QMapboxGL::layerExists(const QString& id)
 */
 void QMapboxGL::removeLayer(const QString& id)
 {
-    d_ptr->mapObj->removeLayer(id.toStdString());
+    d_ptr->invoke([&] { d_ptr->mapObj->removeLayer(id.toStdString()); });
 }
 
 /*!
@@ -1413,7 +1513,7 @@ void QMapboxGL::addImage(const QString &id, const QImage &image)
 {
     if (image.isNull()) return;
 
-    d_ptr->mapObj->addImage(id.toStdString(), toSpriteImage(image));
+    d_ptr->invoke([&] { d_ptr->mapObj->addImage(id.toStdString(), toSpriteImage(image)); });
 }
 
 /*!
@@ -1421,7 +1521,7 @@ void QMapboxGL::addImage(const QString &id, const QImage &image)
 */
 void QMapboxGL::removeImage(const QString &id)
 {
-    d_ptr->mapObj->removeImage(id.toStdString());
+    d_ptr->invoke([&] { d_ptr->mapObj->removeImage(id.toStdString()); });
 }
 
 /*!
@@ -1446,43 +1546,45 @@ void QMapboxGL::removeImage(const QString &id)
 */
 void QMapboxGL::setFilter(const QString& layer, const QVariant& filter)
 {
-    using namespace mbgl::style;
-    using namespace mbgl::style::conversion;
+    d_ptr->invoke([&] {
+        using namespace mbgl::style;
+        using namespace mbgl::style::conversion;
 
-    Layer* layer_ = d_ptr->mapObj->getLayer(layer.toStdString());
-    if (!layer_) {
-        qWarning() << "Layer not found:" << layer;
-        return;
-    }
+        Layer* layer_ = d_ptr->mapObj->getLayer(layer.toStdString());
+        if (!layer_) {
+            qWarning() << "Layer not found:" << layer;
+            return;
+        }
 
-    Filter filter_;
+        Filter filter_;
 
-    Error error;
-    mbgl::optional<Filter> converted = convert<Filter>(filter, error);
-    if (!converted) {
-        qWarning() << "Error parsing filter:" << error.message.c_str();
-        return;
-    }
-    filter_ = std::move(*converted);
+        Error error;
+        mbgl::optional<Filter> converted = convert<Filter>(filter, error);
+        if (!converted) {
+            qWarning() << "Error parsing filter:" << error.message.c_str();
+            return;
+        }
+        filter_ = std::move(*converted);
 
-    if (layer_->is<FillLayer>()) {
-        layer_->as<FillLayer>()->setFilter(filter_);
-        return;
-    }
-    if (layer_->is<LineLayer>()) {
-        layer_->as<LineLayer>()->setFilter(filter_);
-        return;
-    }
-    if (layer_->is<SymbolLayer>()) {
-        layer_->as<SymbolLayer>()->setFilter(filter_);
-        return;
-    }
-    if (layer_->is<CircleLayer>()) {
-        layer_->as<CircleLayer>()->setFilter(filter_);
-        return;
-    }
+        if (layer_->is<FillLayer>()) {
+            layer_->as<FillLayer>()->setFilter(filter_);
+            return;
+        }
+        if (layer_->is<LineLayer>()) {
+            layer_->as<LineLayer>()->setFilter(filter_);
+            return;
+        }
+        if (layer_->is<SymbolLayer>()) {
+            layer_->as<SymbolLayer>()->setFilter(filter_);
+            return;
+        }
+        if (layer_->is<CircleLayer>()) {
+            layer_->as<CircleLayer>()->setFilter(filter_);
+            return;
+        }
 
-    qWarning() << "Layer doesn't support filters";
+        qWarning() << "Layer doesn't support filters";
+    });
 }
 
 /*!
@@ -1493,6 +1595,11 @@ void QMapboxGL::setFilter(const QString& layer, const QVariant& filter)
 
     This function should be called only after the signal needsRendering() is
     emitted at least once.
+
+    In QMapboxGLSettings::ThreadedRendering mode the map is drawn on the render
+    thread, and this function draws the latest finished frame as a texture into
+    the framebuffer object set with setFramebufferObject(). needsRendering() is
+    then emitted whenever a new frame is ready.
 */
 void QMapboxGL::render()
 {
@@ -1504,6 +1611,13 @@ void QMapboxGL::render()
     }
 #endif
 
+#if QT_VERSION >= 0x050800
+    if (d_ptr->isThreaded()) {
+        d_ptr->renderThread->present(d_ptr->fbObject, d_ptr->fbSize);
+        return;
+    }
+#endif
+
     // The OpenGL implementation automatically enables the OpenGL context for us.
     mbgl::BackendScope scope { *d_ptr, mbgl::BackendScope::ScopeType::Implicit };
 
@@ -1557,13 +1671,34 @@ QMapboxGLPrivate::QMapboxGLPrivate(QMapboxGL *q, const QMapboxGLSettings &settin
         settings.cacheDatabaseMaximumSize()))
     , threadPool(mbgl::sharedThreadPool())
 {
-    mapObj = std::make_unique<mbgl::Map>(
-            *this, sanitizedSize(size),
-            pixelRatio, *fileSourceObj, *threadPool,
-            mbgl::MapMode::Continuous,
-            static_cast<mbgl::GLContextMode>(settings.contextMode()),
-            static_cast<mbgl::ConstrainMode>(settings.constrainMode()),
-            static_cast<mbgl::ViewportMode>(settings.viewportMode()));
+    if (settings.renderingMode() == QMapboxGLSettings::ThreadedRendering) {
+#if QT_VERSION >= 0x050800
+        if (QOpenGLContext *shareContext = QOpenGLContext::currentContext()) {
+            renderThread = std::make_unique<QMapboxGLRenderThread>(shareContext);
+        } else {
+            qWarning() << "Threaded rendering needs a current OpenGL context, using direct rendering";
+        }
+#else
+        qWarning() << "Threaded rendering needs Qt 5.8 or later, using direct rendering";
+#endif
+    }
+
+    // Qt changes the OpenGL state behind our back when it creates
+    // the framebuffers of the render thread.
+    const auto contextMode = renderThread
+        ? mbgl::GLContextMode::Shared
+        : static_cast<mbgl::GLContextMode>(settings.contextMode());
+
+    // The map belongs to the render thread, if any.
+    invoke([&] {
+        mapObj = std::make_unique<mbgl::Map>(
+                *this, sanitizedSize(size),
+                pixelRatio, *fileSourceObj, *threadPool,
+                mbgl::MapMode::Continuous,
+                contextMode,
+                static_cast<mbgl::ConstrainMode>(settings.constrainMode()),
+                static_cast<mbgl::ViewportMode>(settings.viewportMode()));
+    });
 
     qRegisterMetaType<QMapboxGL::MapChange>("QMapboxGL::MapChange");
 
@@ -1577,28 +1712,73 @@ QMapboxGLPrivate::QMapboxGLPrivate(QMapboxGL *q, const QMapboxGLSettings &settin
 
 QMapboxGLPrivate::~QMapboxGLPrivate()
 {
+    // The map and its OpenGL resources have to be released
+    // on the render thread, before it stops.
+    invoke([&] { mapObj.reset(); });
+    renderThread.reset();
 }
 
 mbgl::Size QMapboxGLPrivate::framebufferSize() const {
-    return sanitizedSize(fbSize);
+    return renderFramebufferSize;
+}
+
+quint32 QMapboxGLPrivate::framebufferObject() const {
+#if QT_VERSION >= 0x050800
+    if (renderThread) {
+        return renderThread->framebuffer();
+    }
+#endif
+    return fbObject;
 }
 
 void QMapboxGLPrivate::updateAssumedState() {
-    assumeFramebufferBinding(fbObject);
+    assumeFramebufferBinding(framebufferObject());
     assumeViewportSize(framebufferSize());
 }
 
 void QMapboxGLPrivate::bind() {
-    setFramebufferBinding(fbObject);
+    setFramebufferBinding(framebufferObject());
     setViewportSize(framebufferSize());
 }
 
 void QMapboxGLPrivate::invalidate()
 {
-    if (!dirty) {
-        emit needsRendering();
-        dirty = true;
+    if (dirty) {
+        return;
+    }
+
+    dirty = true;
+
+#if QT_VERSION >= 0x050800
+    // Called on the render thread, which draws the frame on its next iteration.
+    if (renderThread) {
+        renderThread->runLoop().invoke([this] { renderFrame(); });
+        return;
     }
+#endif
+
+    emit needsRendering();
+}
+
+void QMapboxGLPrivate::renderFrame()
+{
+#if QT_VERSION >= 0x050800
+    dirty = false;
+
+    if (renderFramebufferSize.isEmpty()) {
+        return;
+    }
+
+    renderThread->beginFrame(renderFramebufferSize);
+    {
+        mbgl::BackendScope scope { *this, mbgl::BackendScope::ScopeType::Implicit };
+        mapObj->render(*this);
+    }
+    renderThread->endFrame();
+
+    // Asks the owner of the QMapboxGL to present the new frame.
+    emit needsRendering();
+#endif
 }
 
 void QMapboxGLPrivate::onCameraWillChange(mbgl::MapObserver::CameraChangeMode mode)
@@ -1702,3 +1882,124 @@ void QMapboxGLPrivate::connectionEstablished()
 {
     mbgl::NetworkStatus::Reachable();
 }
+
+#if QT_VERSION >= 0x050800
+
+QMapboxGLRenderThread::QMapboxGLRenderThread(QOpenGLContext *shareContext)
+    : m_context(std::make_unique<QOpenGLContext>())
+    , m_surface(std::make_unique<QOffscreenSurface>())
+    , m_ownerThread(QThread::currentThread())
+{
+    m_context->setFormat(shareContext->format());
+    m_context->setShareContext(shareContext);
+    m_context->create();
+
+    // Offscreen surfaces have to be created on the GUI thread.
+    m_surface->setFormat(m_context->format());
+    m_surface->create();
+
+    m_context->moveToThread(this);
+
+    start();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_started.wait(lock, [this] { return m_runLoop != nullptr; });
+}
+
+QMapboxGLRenderThread::~QMapboxGLRenderThread()
+{
+    m_runLoop->invoke([this] { releaseFramebuffers(); });
+    m_runLoop->stop();
+    wait();
+}
+
+void QMapboxGLRenderThread::run()
+{
+    mbgl::util::RunLoop loop(mbgl::util::RunLoop::Type::New);
+
+    // The context stays current on the render thread for its whole lifetime.
+    m_context->makeCurrent(m_surface.get());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_runLoop = &loop;
+    }
+    m_started.notify_one();
+
+    loop.run();
+
+    m_context->doneCurrent();
+    m_context->moveToThread(m_ownerThread);
+}
+
+void QMapboxGLRenderThread::beginFrame(const mbgl::Size &size)
+{
+    const QSize framebufferSize(size.width, size.height);
+
+    auto &back = m_framebuffers[Back];
+    if (!back || back->size() != framebufferSize) {
+        back = std::make_unique<QOpenGLFramebufferObject>(
+            framebufferSize, QOpenGLFramebufferObject::CombinedDepthStencil);
+    }
+}
+
+quint32 QMapboxGLRenderThread::framebuffer() const
+{
+    return m_framebuffers[Back] ? m_framebuffers[Back]->handle() : 0;
+}
+
+void QMapboxGLRenderThread::endFrame()
+{
+    // The frame is sampled from the presenting context, so it has to be
+    // complete before it is handed over.
+    m_context->functions()->glFinish();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::swap(m_framebuffers[Back], m_framebuffers[Pending]);
+    m_pendingIsNew = true;
+}
+
+void QMapboxGLRenderThread::releaseFramebuffers()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &framebuffer : m_framebuffers) {
+        framebuffer.reset();
+    }
+    m_pendingIsNew = false;
+}
+
+bool QMapboxGLRenderThread::present(quint32 fbo, const QSize &size)
+{
+    GLuint texture = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pendingIsNew) {
+            std::swap(m_framebuffers[Pending], m_framebuffers[Front]);
+            m_pendingIsNew = false;
+        }
+
+        // Only the presenting thread touches the front buffer, so its
+        // texture stays valid after the lock is released.
+        if (!m_framebuffers[Front]) {
+            return false;
+        }
+        texture = m_framebuffers[Front]->texture();
+    }
+
+    QOpenGLFunctions *gl = QOpenGLContext::currentContext()->functions();
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    gl->glViewport(0, 0, size.width(), size.height());
+
+    if (!m_blitter) {
+        m_blitter = std::make_unique<QOpenGLTextureBlitter>();
+        m_blitter->create();
+    }
+
+    m_blitter->bind();
+    m_blitter->blit(texture, QMatrix4x4(), QOpenGLTextureBlitter::OriginBottomLeft);
+    m_blitter->release();
+
+    return true;
+}
+
+#endif
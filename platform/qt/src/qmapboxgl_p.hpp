@@ -8,10 +8,74 @@
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/util/geo.hpp>
+#include <mbgl/util/run_loop.hpp>
 
 #include <QObject>
 #include <QSize>
 
+#if QT_VERSION >= 0x050800
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QOpenGLTextureBlitter>
+#include <QMatrix4x4>
+#include <QOffscreenSurface>
+#include <QThread>
+#endif
+
+#include <array>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+
+#if QT_VERSION >= 0x050800
+
+// Owns the OpenGL context and the framebuffers of a map rendered in
+// QMapboxGLSettings::ThreadedRendering mode. Frames are triple buffered:
+// the render thread draws into the back buffer and publishes it as the
+// pending one, while the thread calling QMapboxGL::render() draws the
+// front buffer as a texture.
+class QMapboxGLRenderThread : public QThread
+{
+public:
+    explicit QMapboxGLRenderThread(QOpenGLContext *shareContext);
+    ~QMapboxGLRenderThread();
+
+    mbgl::util::RunLoop& runLoop() { return *m_runLoop; }
+
+    // Render thread.
+    void beginFrame(const mbgl::Size &);
+    quint32 framebuffer() const;
+    void endFrame();
+    void releaseFramebuffers();
+
+    // Presenting thread.
+    bool present(quint32 fbo, const QSize &);
+
+private:
+    void run() final;
+
+    std::unique_ptr<QOpenGLContext> m_context;
+    std::unique_ptr<QOffscreenSurface> m_surface;
+    QThread *m_ownerThread;
+
+    std::mutex m_mutex;
+    std::condition_variable m_started;
+    mbgl::util::RunLoop *m_runLoop { nullptr };
+
+    enum { Back = 0, Pending, Front };
+    std::array<std::unique_ptr<QOpenGLFramebufferObject>, 3> m_framebuffers;
+    bool m_pendingIsNew { false };
+
+    std::unique_ptr<QOpenGLTextureBlitter> m_blitter;
+};
+
+#else
+
+class QMapboxGLRenderThread {};
+
+#endif
+
 class QMapboxGLPrivate : public QObject, public mbgl::View, public mbgl::Backend
 {
     Q_OBJECT
@@ -21,6 +85,7 @@ public:
     virtual ~QMapboxGLPrivate();
 
     mbgl::Size framebufferSize() const;
+    quint32 framebufferObject() const;
 
     // mbgl::View implementation.
     void bind() final;
@@ -58,6 +123,22 @@ public:
 
     bool dirty { false };
 
+    // Runs fn on the thread owning mapObj and returns its result, blocking
+    // until it is done in QMapboxGLSettings::ThreadedRendering mode.
+    template <typename Fn>
+    auto invoke(Fn&& fn);
+
+    // Runs fn on the thread owning mapObj without waiting for it. Used to hand
+    // camera changes over to the render thread.
+    template <typename Fn>
+    void post(Fn&& fn);
+
+    bool isThreaded() const { return bool(renderThread); }
+    void renderFrame();
+
+    std::unique_ptr<QMapboxGLRenderThread> renderThread;
+    mbgl::Size renderFramebufferSize;
+
 private:
     mbgl::gl::ProcAddress initializeExtension(const char*) override;
 
@@ -69,3 +150,29 @@ signals:
     void mapChanged(QMapboxGL::MapChange);
     void copyrightsChanged(const QString &copyrightsHtml);
 };
+
+template <typename Fn>
+auto QMapboxGLPrivate::invoke(Fn&& fn)
+{
+#if QT_VERSION >= 0x050800
+    if (renderThread && mbgl::util::RunLoop::Get() != &renderThread->runLoop()) {
+        std::packaged_task<decltype(fn())()> task(std::forward<Fn>(fn));
+        auto result = task.get_future();
+        renderThread->runLoop().invoke([&] { task(); });
+        return result.get();
+    }
+#endif
+    return fn();
+}
+
+template <typename Fn>
+void QMapboxGLPrivate::post(Fn&& fn)
+{
+#if QT_VERSION >= 0x050800
+    if (renderThread && mbgl::util::RunLoop::Get() != &renderThread->runLoop()) {
+        renderThread->runLoop().invoke(std::forward<Fn>(fn));
+        return;
+    }
+#endif
+    fn();
+}
@@ -111,6 +111,11 @@ template <typename T>
 using optional = std::experimental::optional<T>;
 
 
+int64_t memoryUsed() {
+    // Qt's SQL module doesn't expose the memory statistics of the SQLite driver.
+    return 0;
+}
+
 Database::Database(const std::string& file, int flags)
         : impl(std::make_unique<DatabaseImpl>(file.c_str(), flags)) {
     assert(impl);
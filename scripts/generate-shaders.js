@@ -8,7 +8,17 @@ const outputPath = 'src/mbgl/shaders';
 
 require('./style-code');
 
-const vertexPrelude = fs.readFileSync(path.join(inputPath, '_prelude.vertex.glsl'));
+const vertexPrelude = fs.readFileSync(path.join(inputPath, '_prelude.vertex.glsl')) + `
+// Unpack the first of a pair of paint values, for the program variants that
+// don't interpolate the property; see PaintPropertyBinders::variant().
+float unpack_vec2(const vec2 packedValue) {
+    return packedValue[0];
+}
+
+vec4 unpack_vec4(const vec4 packedColors) {
+    return decode_color(vec2(packedColors[0], packedColors[1]));
+}
+`;
 const fragmentPrelude = fs.readFileSync(path.join(inputPath, '_prelude.fragment.glsl'));
 
 writeIfModified(path.join(outputPath, 'preludes.hpp'), `// NOTE: DO NOT CHANGE THIS FILE. IT IS AUTOMATICALLY GENERATED.
@@ -79,7 +89,11 @@ ${fragmentPrelude}
                     "varying {precision} {type} {name};"
                 ],
                 initialize: [
-                    "{name} = unpack_mix_{a_type}(a_{name}, a_{name}_t);"
+                    "#ifdef ZOOM_CONSTANT_a_{name}",
+                    "    {name} = unpack_{a_type}(a_{name});",
+                    "#else",
+                    "    {name} = unpack_mix_{a_type}(a_{name}, a_{name}_t);",
+                    "#endif"
                 ]
             });
     }
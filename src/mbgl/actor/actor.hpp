@@ -61,6 +61,18 @@ public:
         mailbox->push(actor::makeMessage(object, fn, std::forward<Args>(args)...));
     }
 
+    // Like `invoke`, but supersedes a still-pending message for the same member function,
+    // for messages where only the most recent state matters. See Mailbox::pushLatest.
+    template <typename Fn, class... Args>
+    void invokeLatest(Fn fn, Args&&... args) {
+        mailbox->pushLatest(actor::makeMessage(object, fn, std::forward<Args>(args)...));
+    }
+
+    // See Mailbox::setPriority.
+    void setPriority(int32_t priority) {
+        mailbox->setPriority(priority);
+    }
+
     ActorRef<std::decay_t<Object>> self() {
         return ActorRef<std::decay_t<Object>>(object, mailbox);
     }
@@ -35,6 +35,21 @@ public:
         }
     }
 
+    // See Actor::invokeLatest.
+    template <typename Fn, class... Args>
+    void invokeLatest(Fn fn, Args&&... args) {
+        if (auto mailbox = weakMailbox.lock()) {
+            mailbox->pushLatest(actor::makeMessage(object, fn, std::forward<Args>(args)...));
+        }
+    }
+
+    // See Mailbox::setPriority.
+    void setPriority(int32_t priority) {
+        if (auto mailbox = weakMailbox.lock()) {
+            mailbox->setPriority(priority);
+        }
+    }
+
 private:
     Object& object;
     std::weak_ptr<Mailbox> weakMailbox;
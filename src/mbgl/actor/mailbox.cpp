@@ -3,28 +3,185 @@
 #include <mbgl/actor/scheduler.hpp>
 
 #include <cassert>
+#include <thread>
 
 namespace mbgl {
 
+namespace {
+
+// Placeholder node that keeps the queue non-empty, so that producers never have to touch
+// `tail`.
+class StubMessage : public Message {
+public:
+    void operator()() override {
+        assert(false);
+    }
+};
+
+} // namespace
+
+class Mailbox::Slot {
+public:
+    std::unique_ptr<Message> pending;
+    // The message in the queue that will run `pending`, if it hasn't been received yet. A
+    // superseded one finds the slot empty and does nothing.
+    Message* queued = nullptr;
+};
+
+class Mailbox::SlotMessage : public Message {
+public:
+    SlotMessage(Mailbox& mailbox_, Slot& slot_)
+        : mailbox(mailbox_), slot(slot_) {
+    }
+
+    void operator()() override {
+        std::unique_ptr<Message> message;
+        {
+            std::lock_guard<std::mutex> slotsLock(mailbox.slotsMutex);
+            message = std::move(slot.pending);
+            slot.queued = nullptr;
+        }
+        if (message) {
+            (*message)();
+        }
+    }
+
+private:
+    Mailbox& mailbox;
+    Slot& slot;
+};
+
 Mailbox::Mailbox(Scheduler& scheduler_)
-    : scheduler(scheduler_) {
+    : scheduler(scheduler_),
+      stub(std::make_unique<StubMessage>()),
+      head(stub.get()),
+      tail(stub.get()) {
+}
+
+Mailbox::~Mailbox() {
+    // No producers or consumers are left; release any messages that were never received.
+    while (size > 0) {
+        delete pop();
+        --size;
+    }
+}
+
+void Mailbox::enqueue(Message* message) {
+    message->next.store(nullptr, std::memory_order_relaxed);
+    Message* previous = head.exchange(message, std::memory_order_acq_rel);
+    previous->next.store(message, std::memory_order_release);
+}
+
+Message* Mailbox::pop() {
+    // Only called while `size` guarantees that at least one message has been enqueued.
+    // A producer may still be in the middle of linking it in, in which case we wait for it.
+    while (true) {
+        Message* first = tail;
+        Message* next = first->next.load(std::memory_order_acquire);
+
+        if (first == stub.get()) {
+            if (!next) {
+                std::this_thread::yield();
+                continue;
+            }
+            tail = next;
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            tail = next;
+            return first;
+        }
+
+        if (first != head.load(std::memory_order_acquire)) {
+            // Another producer has swapped `head` but not linked its message yet.
+            std::this_thread::yield();
+            continue;
+        }
+
+        // `first` is the last message; put the stub back behind it so that it can be removed.
+        enqueue(stub.get());
+        next = first->next.load(std::memory_order_acquire);
+        if (next) {
+            tail = next;
+            return first;
+        }
+
+        std::this_thread::yield();
+    }
 }
 
 void Mailbox::push(std::unique_ptr<Message> message) {
-    assert(!closing);
+    if (closing) {
+        return;
+    }
 
-    std::lock_guard<std::mutex> queueLock(queueMutex);
-    bool wasEmpty = queue.empty();
-    queue.push(std::move(message));
-    if (wasEmpty) {
+    enqueue(message.release());
+    if (size.fetch_add(1) == 0) {
         scheduler.schedule(shared_from_this());
     }
 }
 
+void Mailbox::pushLatest(std::unique_ptr<Message> message) {
+    if (closing) {
+        return;
+    }
+
+    Slot* target = nullptr;
+    std::unique_ptr<Message> slotMessage;
+    {
+        std::lock_guard<std::mutex> slotsLock(slotsMutex);
+        for (auto& slot : slots) {
+            if (slot->pending && slot->pending->isSameKind(*message)) {
+                if (slot->queued == head.load(std::memory_order_acquire)) {
+                    // Nothing was sent after the pending message; it can run this one instead.
+                    slot->pending = std::move(message);
+                    return;
+                }
+                // Messages sent after the pending one must not be overtaken by this one, so it
+                // is dropped and this one is queued behind them.
+                slot->pending.reset();
+            }
+            if (!slot->queued && !target) {
+                target = slot.get();
+            }
+        }
+        if (!target) {
+            slots.push_back(std::make_unique<Slot>());
+            target = slots.back().get();
+        }
+        target->pending = std::move(message);
+        slotMessage = std::make_unique<SlotMessage>(*this, *target);
+        target->queued = slotMessage.get();
+    }
+
+    push(std::move(slotMessage));
+}
+
 void Mailbox::close() {
+    // Set before taking the lock: a receive() that is running when close() is called may
+    // otherwise be followed by another one that gets the lock first and receives the next
+    // message.
+    closing = true;
+
     // Block until the scheduler is guaranteed not to be executing receive().
     std::lock_guard<std::mutex> closingLock(closingMutex);
-    closing = true;
+
+    // No receive() can run anymore, so this is the only consumer. The messages are released
+    // now rather than with the mailbox, which the scheduler may keep alive for a while, so that
+    // the data they hold is freed as soon as the actor is gone. A message that a producer
+    // pushed just before seeing `closing` is released with the mailbox.
+    while (size > 0) {
+        delete pop();
+        --size;
+    }
+
+    std::lock_guard<std::mutex> slotsLock(slotsMutex);
+    for (auto& slot : slots) {
+        slot->pending.reset();
+        slot->queued = nullptr;
+    }
 }
 
 void Mailbox::receive() {
@@ -34,24 +191,25 @@ void Mailbox::receive() {
         return;
     }
 
-    std::unique_ptr<Message> message;
-    bool wasEmpty;
-
-    {
-        std::lock_guard<std::mutex> queueLock(queueMutex);
-        assert(!queue.empty());
-        message = std::move(queue.front());
-        queue.pop();
-        wasEmpty = queue.empty();
-    }
+    assert(size > 0);
+    std::unique_ptr<Message> message(pop());
 
     (*message)();
+    message.reset();
 
-    if (!wasEmpty) {
+    if (size.fetch_sub(1) > 1) {
         scheduler.schedule(shared_from_this());
     }
 }
 
+void Mailbox::setPriority(int32_t priority_) {
+    priority = priority_;
+}
+
+int32_t Mailbox::getPriority() const {
+    return priority;
+}
+
 void Mailbox::maybeReceive(std::weak_ptr<Mailbox> mailbox) {
     if (auto locked = mailbox.lock()) {
         locked->receive();
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <tuple>
 #include <utility>
 
 namespace mbgl {
 
+class Mailbox;
+
 // A movable type-erasing function wrapper. This allows to store arbitrary invokable
 // things (like std::function<>, or the result of a movable-only std::bind()) in the queue.
 // Source: http://stackoverflow.com/a/29642072/331379
@@ -11,6 +17,24 @@ class Message {
 public:
     virtual ~Message() = default;
     virtual void operator()() = 0;
+
+    // Used by `Mailbox::pushLatest`: a message supersedes a pending message of the same kind.
+    // Messages that invoke the same member function are of the same kind.
+    virtual bool isSameKind(const Message&) const { return false; }
+
+    // Returns an address that is unique to the dynamic type of the message.
+    virtual const void* kind() const { return nullptr; }
+
+    // Messages are allocated and freed at a high rate by the actor system; their storage
+    // is recycled through `actor::MessagePool`.
+    static void* operator new(std::size_t);
+    static void operator delete(void*, std::size_t);
+
+private:
+    friend class Mailbox;
+
+    // Link to the next message in the mailbox queue.
+    std::atomic<Message*> next { nullptr };
 };
 
 template <class Object, class MemberFn, class ArgsTuple>
@@ -26,6 +50,16 @@ public:
         invoke(std::make_index_sequence<std::tuple_size<ArgsTuple>::value>());
     }
 
+    const void* kind() const override {
+        static const char tag = 0;
+        return &tag;
+    }
+
+    bool isSameKind(const Message& other) const override {
+        return other.kind() == kind() &&
+            static_cast<const MessageImpl&>(other).memberFn == memberFn;
+    }
+
     template <std::size_t... I>
     void invoke(std::index_sequence<I...>) {
         (object.*memberFn)(std::move(std::get<I>(argsTuple))...);
@@ -0,0 +1,158 @@
+#include <mbgl/actor/message_pool.hpp>
+#include <mbgl/actor/message.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <array>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace mbgl {
+namespace actor {
+
+namespace {
+
+constexpr std::array<std::size_t, 3> classSizes {{ 64, 128, 256 }};
+
+// Number of blocks a thread keeps per size class before handing them to the depot.
+constexpr std::size_t batchSize = 64;
+
+// Maximum number of batches the depot keeps per size class; beyond that, memory is
+// returned to the system.
+constexpr std::size_t maxDepotBatches = 64;
+
+struct Block {
+    Block* next;
+};
+
+struct FreeList {
+    Block* head = nullptr;
+    std::size_t count = 0;
+
+    void push(void* ptr) {
+        auto block = static_cast<Block*>(ptr);
+        block->next = head;
+        head = block;
+        ++count;
+    }
+
+    void* pop() {
+        Block* block = head;
+        head = block->next;
+        --count;
+        return block;
+    }
+
+    void release() {
+        while (head) {
+            ::operator delete(pop());
+        }
+    }
+};
+
+class Depot {
+public:
+    bool take(std::size_t sizeClass, FreeList& list) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& batches = full[sizeClass];
+        if (batches.empty()) {
+            return false;
+        }
+        list = batches.back();
+        batches.pop_back();
+        return true;
+    }
+
+    void give(std::size_t sizeClass, FreeList& list) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& batches = full[sizeClass];
+            if (batches.size() < maxDepotBatches) {
+                batches.push_back(list);
+                list = {};
+                return;
+            }
+        }
+        list.release();
+    }
+
+private:
+    std::mutex mutex;
+    std::array<std::vector<FreeList>, classSizes.size()> full;
+};
+
+// Neither is ever destroyed, so that threads exiting late can still return their blocks.
+Depot& depot = *new Depot;
+
+struct Cache {
+    ~Cache() {
+        for (std::size_t i = 0; i < lists.size(); ++i) {
+            if (lists[i].count) {
+                depot.give(i, lists[i]);
+            }
+        }
+    }
+
+    std::array<FreeList, classSizes.size()> lists;
+};
+
+util::ThreadLocal<Cache>& caches = *new util::ThreadLocal<Cache>;
+
+Cache& localCache() {
+    Cache* cache = caches.get();
+    if (!cache) {
+        cache = new Cache;
+        caches.set(cache);
+    }
+    return *cache;
+}
+
+std::size_t sizeClassFor(std::size_t size) {
+    std::size_t i = 0;
+    while (i < classSizes.size() && size > classSizes[i]) {
+        ++i;
+    }
+    return i;
+}
+
+} // namespace
+
+void* MessagePool::allocate(std::size_t size) {
+    const std::size_t sizeClass = sizeClassFor(size);
+    if (sizeClass == classSizes.size()) {
+        return ::operator new(size);
+    }
+
+    FreeList& list = localCache().lists[sizeClass];
+    if (list.head || depot.take(sizeClass, list)) {
+        return list.pop();
+    }
+
+    return ::operator new(classSizes[sizeClass]);
+}
+
+void MessagePool::deallocate(void* ptr, std::size_t size) {
+    const std::size_t sizeClass = sizeClassFor(size);
+    if (sizeClass == classSizes.size()) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    FreeList& list = localCache().lists[sizeClass];
+    if (list.count == batchSize) {
+        depot.give(sizeClass, list);
+    }
+    list.push(ptr);
+}
+
+} // namespace actor
+
+void* Message::operator new(std::size_t size) {
+    return actor::MessagePool::allocate(size);
+}
+
+void Message::operator delete(void* ptr, std::size_t size) {
+    actor::MessagePool::deallocate(ptr, size);
+}
+
+} // namespace mbgl
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mbgl {
+namespace actor {
+
+/*
+    A size-class allocator for actor messages. Freed blocks are kept in small per-thread free
+    lists; full lists are handed to a shared depot in batches, from which threads that mostly
+    allocate (e.g. the main thread sending messages to workers) can refill theirs. In a steady
+    state, sending a message therefore does not touch the heap, and the depot lock is taken
+    only once per batch.
+
+    Requests larger than the largest size class are forwarded to the global operator new.
+*/
+class MessagePool {
+public:
+    static void* allocate(std::size_t);
+    static void deallocate(void*, std::size_t);
+};
+
+} // namespace actor
+} // namespace mbgl
@@ -1,8 +1,6 @@
 #include <mbgl/algorithm/generate_clip_ids_impl.hpp>
 #include <mbgl/algorithm/covered_by_children.hpp>
 
-#include <mbgl/util/std.hpp>
-
 #include <list>
 #include <vector>
 #include <bitset>
@@ -31,29 +29,37 @@ bool ClipIDGenerator::Leaf::operator==(const Leaf& other) const {
     return children == other.children;
 }
 
-std::map<UnwrappedTileID, ClipID> ClipIDGenerator::getStencils() const {
-    std::map<UnwrappedTileID, ClipID> stencils;
+std::vector<std::pair<UnwrappedTileID, ClipID>> ClipIDGenerator::getStencils() const {
+    // Tile IDs can't be assigned, so the leaves are sorted by reference.
+    std::vector<const std::pair<const UnwrappedTileID, Leaf>*> leaves;
+    leaves.reserve(pool.size());
+    for (auto& pair : pool) {
+        leaves.push_back(&pair);
+    }
+    std::sort(leaves.begin(), leaves.end(),
+              [](const auto a, const auto b) { return a->first < b->first; });
 
     // Merge everything.
-    for (auto& pair : pool) {
-        auto& id = pair.first;
-        auto& leaf = pair.second;
-        auto res = stencils.emplace(id, leaf.clip);
-        if (!res.second) {
+    std::vector<std::pair<UnwrappedTileID, ClipID>> merged;
+    merged.reserve(leaves.size());
+    for (const auto leaf : leaves) {
+        if (!merged.empty() && merged.back().first == leaf->first) {
             // Merge with the existing ClipID when there was already an element with the
             // same tile ID.
-            res.first->second |= leaf.clip;
+            merged.back().second |= leaf->second.clip;
+        } else {
+            merged.emplace_back(leaf->first, leaf->second.clip);
         }
     }
 
-    for (auto it = stencils.begin(); it != stencils.end(); ++it) {
+    for (auto it = merged.begin(); it != merged.end(); ++it) {
         auto& childId = it->first;
         auto& childClip = it->second;
 
         // Loop through all preceding stencils, and find all parents.
 
         for (auto parentIt = std::reverse_iterator<decltype(it)>(it);
-             parentIt != stencils.rend(); ++parentIt) {
+             parentIt != merged.rend(); ++parentIt) {
             auto& parentId = parentIt->first;
             if (childId.isChildOf(parentId)) {
                 // Once we have a parent, we add the bits  that this ID hasn't set yet.
@@ -66,9 +72,17 @@ std::map<UnwrappedTileID, ClipID> ClipIDGenerator::getStencils() const {
     }
 
     // Remove tiles that are entirely covered by children.
-    util::erase_if(stencils, [&](const auto& stencil) {
-        return algorithm::coveredByChildren(stencil.first, stencils);
-    });
+    std::vector<std::pair<UnwrappedTileID, ClipID>> stencils;
+    stencils.reserve(merged.size());
+    for (auto it = merged.begin(); it != merged.end(); ++it) {
+        const UnwrappedTileID& id = it->first;
+        const auto wrapEnd = std::lower_bound(
+            it, merged.end(), UnwrappedTileID{ static_cast<int16_t>(id.wrap + 1), { 0, 0, 0 } },
+            [](const auto& a, const auto& b) { return a.first < b; });
+        if (!algorithm::coveredByChildren(id, std::next(it), wrapEnd)) {
+            stencils.push_back(*it);
+        }
+    }
 
     return stencils;
 }
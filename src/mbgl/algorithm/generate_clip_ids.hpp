@@ -22,13 +22,21 @@ private:
     };
 
     uint8_t bit_offset = 0;
+    bool overlapping = false;
     std::unordered_multimap<UnwrappedTileID, Leaf> pool;
 
 public:
     template <typename Renderables>
     void update(Renderables& renderables);
 
-    std::map<UnwrappedTileID, ClipID> getStencils() const;
+    // Returns the stencil masks to draw, sorted by tile ID.
+    std::vector<std::pair<UnwrappedTileID, ClipID>> getStencils() const;
+
+    // Whether any of the renderables covers another one of the same update, in which case they
+    // can't be clipped to their tile boundaries without the stencil buffer.
+    bool hasOverlaps() const {
+        return overlapping;
+    }
 };
 
 } // namespace algorithm
@@ -34,6 +34,7 @@ void ClipIDGenerator::update(Renderables& renderables) {
             auto& childTileID = child_it->first;
             if (childTileID.isChildOf(tileID)) {
                 leaf.add(childTileID.canonical);
+                overlapping = overlapping || child_it->second.used;
             }
         }
 
@@ -4,11 +4,24 @@
 #include <mbgl/util/range.hpp>
 #include <mbgl/storage/resource.hpp>
 
+#include <algorithm>
+#include <functional>
 #include <unordered_set>
 
 namespace mbgl {
 namespace algorithm {
 
+// The zoom level at which the data of an ideal tile is laid out. In pitched views, ideal tiles far
+// from the camera may have lower zoom levels than the others; those aren't overzoomed, and are
+// laid out at their own zoom level.
+inline uint8_t dataTileZoomFor(const UnwrappedTileID& idealTileID,
+                               const Range<uint8_t>& zoomRange,
+                               const uint8_t dataTileZoom) {
+    return idealTileID.canonical.z < std::min(dataTileZoom, zoomRange.max)
+        ? idealTileID.canonical.z
+        : dataTileZoom;
+}
+
 template <typename GetTileFn,
           typename CreateTileFn,
           typename RetainTileFn,
@@ -20,18 +33,40 @@ void updateRenderables(GetTileFn getTile,
                        RenderTileFn renderTile,
                        const IdealTileIDs& idealTileIDs,
                        const Range<uint8_t>& zoomRange,
-                       const uint8_t dataTileZoom) {
+                       const uint8_t dataTileZoom,
+                       const uint8_t descendantZoomLevels = 1) {
     std::unordered_set<UnwrappedTileID> checked;
     bool covered;
     int32_t overscaledZ;
 
+    // Renders the loaded descendants of a tile, down to the given zoom level, and returns whether
+    // they cover it entirely.
+    std::function<bool(const OverscaledTileID&, int16_t, int32_t)> renderDescendants =
+        [&](const OverscaledTileID& parentDataTileID, int16_t wrap, int32_t maxZ) {
+        bool coveredByDescendants = true;
+        for (const auto& childTileID : parentDataTileID.canonical.children()) {
+            const OverscaledTileID childDataTileID(parentDataTileID.overscaledZ + 1, childTileID);
+            auto child = getTile(childDataTileID);
+            if (child && child->isRenderable()) {
+                retainTile(*child, Resource::Necessity::Optional);
+                renderTile(childDataTileID.unwrapTo(wrap), *child);
+            } else if (childDataTileID.overscaledZ < maxZ) {
+                coveredByDescendants = renderDescendants(childDataTileID, wrap, maxZ) && coveredByDescendants;
+            } else {
+                coveredByDescendants = false;
+            }
+        }
+        return coveredByDescendants;
+    };
+
     // for (all in the set of ideal tiles of the source) {
     for (const auto& idealRenderTileID : idealTileIDs) {
         assert(idealRenderTileID.canonical.z >= zoomRange.min);
         assert(idealRenderTileID.canonical.z <= zoomRange.max);
         assert(dataTileZoom >= idealRenderTileID.canonical.z);
 
-        const OverscaledTileID idealDataTileID(dataTileZoom, idealRenderTileID.canonical);
+        const uint8_t idealDataTileZoom = dataTileZoomFor(idealRenderTileID, zoomRange, dataTileZoom);
+        const OverscaledTileID idealDataTileID(idealDataTileZoom, idealRenderTileID.canonical);
         auto tile = getTile(idealDataTileID);
         if (!tile) {
             tile = createTile(idealDataTileID);
@@ -48,7 +83,7 @@ void updateRenderables(GetTileFn getTile,
             // The tile isn't loaded yet, but retain it anyway because it's an ideal tile.
             retainTile(*tile, Resource::Necessity::Required);
             covered = true;
-            overscaledZ = dataTileZoom + 1;
+            overscaledZ = idealDataTileZoom + 1;
             if (overscaledZ > zoomRange.max) {
                 // We're looking for an overzoomed child tile.
                 const auto childDataTileID = idealDataTileID.scaledTo(overscaledZ);
@@ -60,24 +95,16 @@ void updateRenderables(GetTileFn getTile,
                     covered = false;
                 }
             } else {
-                // Check all four actual child tiles.
-                for (const auto& childTileID : idealDataTileID.canonical.children()) {
-                    const OverscaledTileID childDataTileID(overscaledZ, childTileID);
-                    tile = getTile(childDataTileID);
-                    if (tile && tile->isRenderable()) {
-                        retainTile(*tile, Resource::Necessity::Optional);
-                        renderTile(childDataTileID.unwrapTo(idealRenderTileID.wrap), *tile);
-                    } else {
-                        // At least one child tile doesn't exist, so we are going to look for
-                        // parents as well.
-                        covered = false;
-                    }
-                }
+                // Check all four actual child tiles, and the tiles below them up to the given
+                // number of zoom levels. If at least one of them doesn't exist, we are going to
+                // look for parents as well.
+                const int32_t maxZ = std::min<int32_t>(zoomRange.max, idealDataTileZoom + descendantZoomLevels);
+                covered = renderDescendants(idealDataTileID, idealRenderTileID.wrap, maxZ);
             }
 
             if (!covered) {
                 // We couldn't find child tiles that entirely cover the ideal tile.
-                for (overscaledZ = dataTileZoom - 1; overscaledZ >= zoomRange.min; --overscaledZ) {
+                for (overscaledZ = idealDataTileZoom - 1; overscaledZ >= zoomRange.min; --overscaledZ) {
                     const auto parentDataTileID = idealDataTileID.scaledTo(overscaledZ);
                     const auto parentRenderTileID =
                         parentDataTileID.unwrapTo(idealRenderTileID.wrap);
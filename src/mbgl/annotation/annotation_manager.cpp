@@ -5,13 +5,19 @@
 #include <mbgl/annotation/line_annotation_impl.hpp>
 #include <mbgl/annotation/fill_annotation_impl.hpp>
 #include <mbgl/annotation/style_sourced_annotation_impl.hpp>
+#include <mbgl/annotation/shape_annotation_batch.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/map/transform_state.hpp>
+#include <mbgl/util/string.hpp>
 
 #include <boost/function_output_iterator.hpp>
 
+#include <algorithm>
+#include <set>
+
 namespace mbgl {
 
 using namespace style;
@@ -20,7 +26,8 @@ const std::string AnnotationManager::SourceID = "com.mapbox.annotations";
 const std::string AnnotationManager::PointLayerID = "com.mapbox.annotations.points";
 
 AnnotationManager::AnnotationManager(float pixelRatio)
-    : spriteAtlas({ 1024, 1024 }, pixelRatio) {
+    : spriteAtlas({ 1024, 1024 }, pixelRatio),
+      symbolInstances(spriteAtlas) {
 
     struct NullFileSource : public FileSource {
         std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override {
@@ -54,11 +61,15 @@ Update AnnotationManager::updateAnnotation(const AnnotationID& id, const Annotat
 
 void AnnotationManager::removeAnnotation(const AnnotationID& id) {
     if (symbolAnnotations.find(id) != symbolAnnotations.end()) {
+        if (instancedSymbols) {
+            symbolInstances.remove(id);
+        } else {
+            invalidate(id, symbolAnnotations.at(id)->annotation.geometry);
+        }
         symbolTree.remove(symbolAnnotations.at(id));
         symbolAnnotations.erase(id);
     } else if (shapeAnnotations.find(id) != shapeAnnotations.end()) {
-        obsoleteShapeAnnotationLayers.insert(shapeAnnotations.at(id)->layerID);
-        shapeAnnotations.erase(id);
+        removeShape(id);
     } else {
         assert(false); // Should never happen
     }
@@ -66,26 +77,70 @@ void AnnotationManager::removeAnnotation(const AnnotationID& id) {
 
 void AnnotationManager::add(const AnnotationID& id, const SymbolAnnotation& annotation, const uint8_t) {
     auto impl = std::make_shared<SymbolAnnotationImpl>(id, annotation);
+    if (instancedSymbols) {
+        symbolInstances.add(id, annotation);
+    } else {
+        invalidate(id, annotation.geometry);
+    }
     symbolTree.insert(impl);
     symbolAnnotations.emplace(id, impl);
 }
 
 void AnnotationManager::add(const AnnotationID& id, const LineAnnotation& annotation, const uint8_t maxZoom) {
-    ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
-        std::make_unique<LineAnnotationImpl>(id, annotation, maxZoom)).first->second;
-    obsoleteShapeAnnotationLayers.erase(impl.layerID);
+    addShape(id, std::make_unique<LineAnnotationImpl>(id, annotation, maxZoom));
 }
 
 void AnnotationManager::add(const AnnotationID& id, const FillAnnotation& annotation, const uint8_t maxZoom) {
-    ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
-        std::make_unique<FillAnnotationImpl>(id, annotation, maxZoom)).first->second;
-    obsoleteShapeAnnotationLayers.erase(impl.layerID);
+    addShape(id, std::make_unique<FillAnnotationImpl>(id, annotation, maxZoom));
 }
 
 void AnnotationManager::add(const AnnotationID& id, const StyleSourcedAnnotation& annotation, const uint8_t maxZoom) {
-    ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
-        std::make_unique<StyleSourcedAnnotationImpl>(id, annotation, maxZoom)).first->second;
-    obsoleteShapeAnnotationLayers.erase(impl.layerID);
+    addShape(id, std::make_unique<StyleSourcedAnnotationImpl>(id, annotation, maxZoom));
+}
+
+void AnnotationManager::addShape(const AnnotationID& id, std::unique_ptr<ShapeAnnotationImpl> annotation) {
+    ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id, std::move(annotation)).first->second;
+    shapeTree.insert({ shapeAnnotationBounds(impl.geometry()), id });
+
+    if (auto key = impl.batchKey()) {
+        auto& batches = shapeAnnotationBatches[*key];
+        if (batches.empty() || batches.back()->full()) {
+            batches.push_back(std::make_unique<ShapeAnnotationBatch>(*key,
+                "com.mapbox.annotations.shape.batch." + util::toString(nextBatchID++), impl.maxZoom));
+        }
+        impl.batch = batches.back().get();
+        impl.batch->add(impl);
+    } else {
+        obsoleteShapeAnnotationLayers.erase(impl.layerID);
+    }
+
+    allTilesInvalid = true;
+}
+
+void AnnotationManager::removeShape(const AnnotationID& id) {
+    auto it = shapeAnnotations.find(id);
+    ShapeAnnotationImpl& impl = *it->second;
+    shapeTree.remove(std::make_pair(shapeAnnotationBounds(impl.geometry()), id));
+
+    if (impl.batch) {
+        impl.batch->remove(id);
+        if (impl.batch->empty()) {
+            obsoleteShapeAnnotationLayers.insert(impl.batch->layerID);
+            const std::string key = impl.batch->key;
+            auto& batches = shapeAnnotationBatches.at(key);
+            batches.erase(std::find_if(batches.begin(), batches.end(), [&] (const auto& batch) {
+                return batch.get() == impl.batch;
+            }));
+            if (batches.empty()) {
+                shapeAnnotationBatches.erase(key);
+            }
+        }
+    } else {
+        obsoleteShapeAnnotationLayers.insert(impl.layerID);
+    }
+
+    shapeAnnotations.erase(it);
+    allTilesInvalid = true;
 }
 
 Update AnnotationManager::update(const AnnotationID& id, const SymbolAnnotation& annotation, const uint8_t maxZoom) {
@@ -107,6 +162,15 @@ Update AnnotationManager::update(const AnnotationID& id, const SymbolAnnotation&
         result |= Update::AnnotationData | Update::AnnotationStyle;
     }
 
+    if (result != Update::Nothing && instancedSymbols) {
+        // Rewrites the annotation's instance rather than adding it anew.
+        symbolTree.remove(it->second);
+        it->second = std::make_shared<SymbolAnnotationImpl>(id, annotation);
+        symbolTree.insert(it->second);
+        symbolInstances.update(id, annotation);
+        return Update::Repaint;
+    }
+
     if (result != Update::Nothing) {
         removeAndAdd(id, annotation, maxZoom);
     }
@@ -161,13 +225,38 @@ std::unique_ptr<AnnotationTileData> AnnotationManager::getTileData(const Canonic
 
     LatLngBounds tileBounds(tileID);
 
-    symbolTree.query(boost::geometry::index::intersects(tileBounds),
-        boost::make_function_output_iterator([&](const auto& val){
-            val->updateLayer(tileID, pointLayer);
-        }));
+    if (!instancedSymbols) {
+        symbolTree.query(boost::geometry::index::intersects(tileBounds),
+            boost::make_function_output_iterator([&](const auto& val){
+                val->updateLayer(tileID, pointLayer);
+            }));
+    }
 
-    for (const auto& shape : shapeAnnotations) {
-        shape.second->updateTileData(tileID, *tileData);
+    // The tile holds the features within its buffer, which is narrower than a tile.
+    const uint32_t lastRow = (1u << tileID.z) - 1;
+    const LatLngBounds northBounds(CanonicalTileID(tileID.z, tileID.x, tileID.y > 0 ? tileID.y - 1 : 0));
+    const LatLngBounds southBounds(CanonicalTileID(tileID.z, tileID.x, std::min(tileID.y + 1, lastRow)));
+    const double tileWidth = util::DEGREES_MAX / (1u << tileID.z);
+
+    // Shapes across the antimeridian are wrapped into the tiles of the other side.
+    std::set<ShapeAnnotationBatch*> batches;
+    std::set<ShapeAnnotationImpl*> shapes;
+    for (const double shift : { -util::DEGREES_MAX, 0.0, util::DEGREES_MAX }) {
+        const LatLngBounds bufferedBounds = LatLngBounds::hull(
+            { southBounds.south(), northBounds.west() - tileWidth + shift },
+            { northBounds.north(), northBounds.east() + tileWidth + shift });
+
+        shapeTree.query(boost::geometry::index::intersects(bufferedBounds),
+            boost::make_function_output_iterator([&](const auto& val) {
+                ShapeAnnotationImpl& shape = *shapeAnnotations.at(val.second);
+                if (shape.batch) {
+                    if (batches.insert(shape.batch).second) {
+                        shape.batch->updateTileData(tileID, *tileData);
+                    }
+                } else if (shapes.insert(&shape).second) {
+                    shape.updateTileData(tileID, *tileData);
+                }
+            }));
     }
 
     return tileData;
@@ -192,8 +281,14 @@ void AnnotationManager::updateStyle(Style& style) {
         style.addLayer(std::move(layer));
     }
 
+    // Adds the layers in the order of the annotations' IDs, a batch's layer at its first annotation.
+    std::set<const ShapeAnnotationBatch*> styledBatches;
     for (const auto& shape : shapeAnnotations) {
-        shape.second->updateStyle(style);
+        if (!shape.second->batch) {
+            shape.second->updateStyle(style);
+        } else if (styledBatches.insert(shape.second->batch).second) {
+            shape.second->batch->updateStyle(style);
+        }
     }
 
     for (const auto& layer : obsoleteShapeAnnotationLayers) {
@@ -205,10 +300,103 @@ void AnnotationManager::updateStyle(Style& style) {
     obsoleteShapeAnnotationLayers.clear();
 }
 
+Update AnnotationManager::setInstancedSymbols(bool instanced) {
+    if (instanced == instancedSymbols) {
+        return Update::Nothing;
+    }
+
+    instancedSymbols = instanced;
+    symbolInstances.clear();
+    if (instancedSymbols) {
+        for (const auto& pair : symbolAnnotations) {
+            symbolInstances.add(pair.first, pair.second->annotation);
+        }
+    }
+
+    // The tiles gain or lose their symbols.
+    for (const auto& pair : symbolAnnotations) {
+        invalidate(pair.first, pair.second->annotation.geometry);
+    }
+    return Update::AnnotationData;
+}
+
+AnnotationIDs AnnotationManager::querySymbolInstances(const ScreenBox& box, const TransformState& state) {
+    // TransformState's screen coordinates have their origin at the bottom left.
+    const double height = state.getSize().height;
+    const double padding = symbolInstances.getMaxIconSize() / 2;
+
+    LatLngBounds bounds = LatLngBounds::empty();
+    for (const auto& corner : { ScreenCoordinate { box.min.x - padding, box.min.y - padding },
+                                ScreenCoordinate { box.max.x + padding, box.min.y - padding },
+                                ScreenCoordinate { box.max.x + padding, box.max.y + padding },
+                                ScreenCoordinate { box.min.x - padding, box.max.y + padding } }) {
+        bounds.extend(state.screenCoordinateToLatLng({ corner.x, height - corner.y }));
+    }
+
+    // The box may show copies of the world other than the one that the annotations are in.
+    std::set<AnnotationID> ids;
+    for (const double shift : { -util::DEGREES_MAX, 0.0, util::DEGREES_MAX }) {
+        const LatLngBounds shifted = LatLngBounds::hull(
+            { bounds.south(), bounds.west() + shift },
+            { bounds.north(), bounds.east() + shift });
+
+        symbolTree.query(boost::geometry::index::intersects(shifted),
+            boost::make_function_output_iterator([&](const auto& val) {
+                const SymbolAnnotation& annotation = val->annotation;
+                const auto icon = symbolInstances.getIcon(annotation);
+                if (!icon) {
+                    return;
+                }
+
+                ScreenCoordinate point = state.latLngToScreenCoordinate(
+                    { annotation.geometry.y, annotation.geometry.x - shift });
+                point.y = height - point.y;
+                if (point.x + icon->width / 2 >= box.min.x && point.x - icon->width / 2 <= box.max.x &&
+                    point.y + icon->height / 2 >= box.min.y && point.y - icon->height / 2 <= box.max.y) {
+                    ids.insert(val->id);
+                }
+            }));
+    }
+
+    return AnnotationIDs(ids.begin(), ids.end());
+}
+
+void AnnotationManager::invalidate(const AnnotationID& id, const Point<double>& point) {
+    const LatLng latLng(point.y, point.x);
+    auto it = invalidBounds.find(id);
+    if (it == invalidBounds.end()) {
+        invalidBounds.emplace(id, LatLngBounds::singleton(latLng));
+    } else {
+        it->second.extend(latLng);
+    }
+}
+
+bool AnnotationManager::isInvalid(const CanonicalTileID& tileID) const {
+    if (allTilesInvalid) {
+        return true;
+    }
+
+    // Unlike LatLngBounds::intersects(), includes the edges, as the symbol tree queries do.
+    const LatLngBounds tileBounds(tileID);
+    for (const auto& entry : invalidBounds) {
+        const LatLngBounds& bounds = entry.second;
+        if (bounds.south() <= tileBounds.north() && bounds.north() >= tileBounds.south() &&
+            bounds.west() <= tileBounds.east() && bounds.east() >= tileBounds.west()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void AnnotationManager::updateData() {
     for (auto& tile : tiles) {
-        tile->setData(getTileData(tile->id.canonical));
+        if (isInvalid(tile->id.canonical)) {
+            tile->setData(getTileData(tile->id.canonical));
+        }
     }
+
+    invalidBounds.clear();
+    allTilesInvalid = false;
 }
 
 void AnnotationManager::addTile(AnnotationTile& tile) {
@@ -222,15 +410,21 @@ void AnnotationManager::removeTile(AnnotationTile& tile) {
 
 void AnnotationManager::addIcon(const std::string& name, std::shared_ptr<const SpriteImage> sprite) {
     spriteAtlas.setSprite(name, sprite);
+    if (instancedSymbols) {
+        symbolInstances.updateIcons();
+    }
 }
 
 void AnnotationManager::removeIcon(const std::string& name) {
     spriteAtlas.removeSprite(name);
+    if (instancedSymbols) {
+        symbolInstances.updateIcons();
+    }
 }
 
 double AnnotationManager::getTopOffsetPixelsForIcon(const std::string& name) {
     auto sprite = spriteAtlas.getSprite(name);
-    return sprite ? -(sprite->image.size.height / sprite->pixelRatio) / 2 : 0;
+    return sprite ? -(sprite->size.height / sprite->pixelRatio) / 2 : 0;
 }
 
 } // namespace mbgl
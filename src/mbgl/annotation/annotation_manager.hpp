@@ -2,26 +2,31 @@
 
 #include <mbgl/annotation/annotation.hpp>
 #include <mbgl/annotation/symbol_annotation_impl.hpp>
+#include <mbgl/annotation/symbol_annotation_instances.hpp>
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/map/update.hpp>
+#include <mbgl/util/geo.hpp>
 #include <mbgl/util/noncopyable.hpp>
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace mbgl {
 
-class LatLngBounds;
 class AnnotationTile;
 class AnnotationTileData;
 class SymbolAnnotationImpl;
 class ShapeAnnotationImpl;
+class ShapeAnnotationBatch;
 
 namespace style {
 class Style;
 } // namespace style
 
+class TransformState;
+
 class AnnotationManager : private util::noncopyable {
 public:
     AnnotationManager(float pixelRatio);
@@ -36,6 +41,16 @@ public:
     double getTopOffsetPixelsForIcon(const std::string& name);
     SpriteAtlas& getSpriteAtlas() { return spriteAtlas; }
 
+    // Draws symbol annotations as instances rather than as symbols of the annotation tiles, see
+    // SymbolAnnotationInstances. Returns the updates that switching requires.
+    Update setInstancedSymbols(bool);
+    bool getInstancedSymbols() const { return instancedSymbols; }
+    SymbolAnnotationInstances& getSymbolInstances() { return symbolInstances; }
+
+    // Returns the instanced symbol annotations whose icons intersect the box, in screen
+    // coordinates with the origin at the top left.
+    AnnotationIDs querySymbolInstances(const ScreenBox&, const TransformState&);
+
     void updateStyle(style::Style&);
     void updateData();
 
@@ -56,10 +71,17 @@ private:
     Update update(const AnnotationID&, const FillAnnotation&, const uint8_t);
     Update update(const AnnotationID&, const StyleSourcedAnnotation&, const uint8_t);
 
+    void addShape(const AnnotationID&, std::unique_ptr<ShapeAnnotationImpl>);
+    void removeShape(const AnnotationID&);
+
     void removeAndAdd(const AnnotationID&, const Annotation&, const uint8_t);
 
     std::unique_ptr<AnnotationTileData> getTileData(const CanonicalTileID&);
 
+    // Records that the tiles covering the point need new data.
+    void invalidate(const AnnotationID&, const Point<double>&);
+    bool isInvalid(const CanonicalTileID&) const;
+
     AnnotationID nextID = 0;
 
     using SymbolAnnotationTree = boost::geometry::index::rtree<std::shared_ptr<const SymbolAnnotationImpl>, boost::geometry::index::rstar<16, 4>>;
@@ -67,13 +89,32 @@ private:
     // <https://github.com/mapbox/mapbox-gl-native/issues/5691>
     using SymbolAnnotationMap = std::map<AnnotationID, std::shared_ptr<SymbolAnnotationImpl>>;
     using ShapeAnnotationMap = std::map<AnnotationID, std::unique_ptr<ShapeAnnotationImpl>>;
+    using ShapeAnnotationTree = boost::geometry::index::rtree<std::pair<LatLngBounds, AnnotationID>, boost::geometry::index::rstar<16, 4>>;
+    // The batches of each batch key, in the order that their layers were added in. Annotations
+    // join the last batch of their key.
+    using ShapeAnnotationBatchMap = std::unordered_map<std::string, std::vector<std::unique_ptr<ShapeAnnotationBatch>>>;
 
     SymbolAnnotationTree symbolTree;
     SymbolAnnotationMap symbolAnnotations;
     ShapeAnnotationMap shapeAnnotations;
+    // The bounds of the shape annotations, so that tiles only ask the shapes they show for data.
+    ShapeAnnotationTree shapeTree;
+    ShapeAnnotationBatchMap shapeAnnotationBatches;
+    uint64_t nextBatchID = 0;
     std::unordered_set<std::string> obsoleteShapeAnnotationLayers;
     std::unordered_set<AnnotationTile*> tiles;
+
+    // The bounds of the changes to each symbol annotation since tiles last got new data, which
+    // spans all of the annotation's positions when it is updated repeatedly in between. Tiles
+    // that don't intersect any keep their data. Changes to shape annotations invalidate all
+    // tiles, as their tiles hold geometry beyond their edges.
+    std::unordered_map<AnnotationID, LatLngBounds> invalidBounds;
+    bool allTilesInvalid = false;
     SpriteAtlas spriteAtlas;
+
+    bool instancedSymbols = false;
+    // Declared after the atlas, as it holds on to icons of the atlas until it is destroyed.
+    SymbolAnnotationInstances symbolInstances;
 };
 
 } // namespace mbgl
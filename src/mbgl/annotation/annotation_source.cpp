@@ -22,6 +22,10 @@ void AnnotationSource::Impl::loadDescription(FileSource&) {
     loaded = true;
 }
 
+std::unique_ptr<Source> AnnotationSource::Impl::clone(const std::string&) const {
+    throw std::runtime_error("Annotation sources can't be copied");
+}
+
 std::unique_ptr<Tile> AnnotationSource::Impl::createTile(const OverscaledTileID& tileID,
                                                          const style::UpdateParameters& parameters) {
     return std::make_unique<AnnotationTile>(tileID, parameters);
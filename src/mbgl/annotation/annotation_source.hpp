@@ -18,6 +18,9 @@ public:
 
     void loadDescription(FileSource&) final;
 
+    // Annotations belong to their map, which adds their source to each style it loads.
+    std::unique_ptr<style::Source> clone(const std::string& id) const final;
+
     optional<Range<uint8_t>> getZoomRange() const final;
 
 private:
@@ -23,7 +23,7 @@ void AnnotationTile::setNecessity(Necessity) {}
 
 AnnotationTileFeature::AnnotationTileFeature(const AnnotationID id_,
                                              FeatureType type_, GeometryCollection geometries_,
-                                             std::unordered_map<std::string, std::string> properties_)
+                                             PropertyMap properties_)
     : id(id_),
       type(type_),
       properties(std::move(properties_)),
@@ -2,6 +2,7 @@
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/util/string.hpp>
 
 namespace mbgl {
 
@@ -31,4 +32,44 @@ const ShapeAnnotationGeometry& FillAnnotationImpl::geometry() const {
     return annotation.geometry;
 }
 
+optional<std::string> FillAnnotationImpl::batchKey() const {
+    if (!constantValue(annotation.opacity) || !constantValue(annotation.color)) {
+        return {};
+    }
+    // An undefined outline color draws the outline in the fill color, and in a different order.
+    if (annotation.outlineColor.isUndefined()) {
+        return "fill." + util::toString(maxZoom);
+    }
+    if (!constantValue(annotation.outlineColor)) {
+        return {};
+    }
+    return "fill.outline." + util::toString(maxZoom);
+}
+
+PropertyMap FillAnnotationImpl::featureProperties() const {
+    PropertyMap properties {
+        { "opacity", double(*constantValue(annotation.opacity)) },
+        { "color", colorValue(*constantValue(annotation.color)) }
+    };
+    if (!annotation.outlineColor.isUndefined()) {
+        properties.emplace("outline-color", colorValue(*constantValue(annotation.outlineColor)));
+    }
+    return properties;
+}
+
+void FillAnnotationImpl::updateBatchStyle(Style& style, const std::string& batchLayerID) const {
+    if (style.getLayer(batchLayerID)) {
+        return;
+    }
+
+    auto newLayer = std::make_unique<FillLayer>(batchLayerID, AnnotationManager::SourceID);
+    newLayer->setSourceLayer(batchLayerID);
+    newLayer->setFillOpacity(SourceFunction<float>("opacity", IdentityStops<float>()));
+    newLayer->setFillColor(SourceFunction<Color>("color", IdentityStops<Color>()));
+    if (!annotation.outlineColor.isUndefined()) {
+        newLayer->setFillOutlineColor(SourceFunction<Color>("outline-color", IdentityStops<Color>()));
+    }
+    style.addLayer(std::move(newLayer), AnnotationManager::PointLayerID);
+}
+
 } // namespace mbgl
@@ -2,6 +2,7 @@
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/util/string.hpp>
 
 namespace mbgl {
 
@@ -32,4 +33,33 @@ const ShapeAnnotationGeometry& LineAnnotationImpl::geometry() const {
     return annotation.geometry;
 }
 
+optional<std::string> LineAnnotationImpl::batchKey() const {
+    // Line widths aren't data-driven, so lines share a layer only with lines of the same width.
+    if (!annotation.width.isConstant() || !constantValue(annotation.opacity) || !constantValue(annotation.color)) {
+        return {};
+    }
+    return "line." + util::toString(annotation.width.asConstant()) + "." + util::toString(maxZoom);
+}
+
+PropertyMap LineAnnotationImpl::featureProperties() const {
+    return {
+        { "opacity", double(*constantValue(annotation.opacity)) },
+        { "color", colorValue(*constantValue(annotation.color)) }
+    };
+}
+
+void LineAnnotationImpl::updateBatchStyle(Style& style, const std::string& batchLayerID) const {
+    if (style.getLayer(batchLayerID)) {
+        return;
+    }
+
+    auto newLayer = std::make_unique<LineLayer>(batchLayerID, AnnotationManager::SourceID);
+    newLayer->setSourceLayer(batchLayerID);
+    newLayer->setLineJoin(LineJoinType::Round);
+    newLayer->setLineOpacity(SourceFunction<float>("opacity", IdentityStops<float>()));
+    newLayer->setLineWidth(annotation.width);
+    newLayer->setLineColor(SourceFunction<Color>("color", IdentityStops<Color>()));
+    style.addLayer(std::move(newLayer), AnnotationManager::PointLayerID);
+}
+
 } // namespace mbgl
@@ -12,6 +12,10 @@ public:
     void updateStyle(style::Style&) const final;
     const ShapeAnnotationGeometry& geometry() const final;
 
+    optional<std::string> batchKey() const final;
+    PropertyMap featureProperties() const final;
+    void updateBatchStyle(style::Style&, const std::string& layerID) const final;
+
 private:
     const LineAnnotation annotation;
 };
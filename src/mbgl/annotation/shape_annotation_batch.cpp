@@ -0,0 +1,54 @@
+#include <mbgl/annotation/shape_annotation_batch.hpp>
+#include <mbgl/annotation/shape_annotation_impl.hpp>
+#include <mbgl/annotation/annotation_tile.hpp>
+#include <mbgl/tile/tile_id.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+const std::size_t ShapeAnnotationBatch::maxSize = 512;
+
+ShapeAnnotationBatch::ShapeAnnotationBatch(std::string key_, std::string layerID_, const uint8_t maxZoom_)
+    : key(std::move(key_)),
+      layerID(std::move(layerID_)),
+      maxZoom(maxZoom_) {
+}
+
+void ShapeAnnotationBatch::add(const ShapeAnnotationImpl& annotation) {
+    assert(annotation.batchKey() == key);
+    annotations.emplace(annotation.id, &annotation);
+    shapeTiler.reset();
+}
+
+void ShapeAnnotationBatch::remove(const AnnotationID& id) {
+    annotations.erase(id);
+    shapeTiler.reset();
+}
+
+void ShapeAnnotationBatch::updateStyle(style::Style& style) const {
+    if (!annotations.empty()) {
+        annotations.begin()->second->updateBatchStyle(style, layerID);
+    }
+}
+
+void ShapeAnnotationBatch::updateTileData(const CanonicalTileID& tileID, AnnotationTileData& data) {
+    if (!shapeTiler) {
+        mapbox::geometry::feature_collection<double> features;
+        features.reserve(annotations.size());
+        for (const auto& entry : annotations) {
+            const ShapeAnnotationImpl& annotation = *entry.second;
+            Feature feature = ShapeAnnotationGeometry::visit(annotation.geometry(), [] (const auto& geom) {
+                return Feature { geom };
+            });
+            feature.id = static_cast<uint64_t>(annotation.id);
+            feature.properties = annotation.featureProperties();
+            features.emplace_back(std::move(feature));
+        }
+        shapeTiler = ShapeAnnotationImpl::createShapeTiler(features, maxZoom);
+    }
+
+    ShapeAnnotationImpl::addTileFeatures(*shapeTiler, tileID, data, layerID);
+}
+
+} // namespace mbgl
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mapbox/geojsonvt.hpp>
+
+#include <mbgl/annotation/annotation.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class AnnotationTileData;
+class CanonicalTileID;
+class ShapeAnnotationImpl;
+
+namespace style {
+class Style;
+} // namespace style
+
+// Shape annotations with the same batch key, drawn by a single layer from a single tile index
+// rather than by a layer and an index each. The layer styles each annotation's features with
+// data-driven properties, so that the annotations only need to agree on the properties that
+// aren't data-driven. Adding or removing an annotation rebuilds the index of its batch alone.
+class ShapeAnnotationBatch : private util::noncopyable {
+public:
+    ShapeAnnotationBatch(std::string key, std::string layerID, uint8_t maxZoom);
+
+    void add(const ShapeAnnotationImpl&);
+    void remove(const AnnotationID&);
+
+    bool empty() const { return annotations.empty(); }
+    // Batches are kept small enough for rebuilding their index to stay cheap.
+    bool full() const { return annotations.size() >= maxSize; }
+
+    void updateStyle(style::Style&) const;
+    void updateTileData(const CanonicalTileID&, AnnotationTileData&);
+
+    const std::string key;
+    const std::string layerID;
+    const uint8_t maxZoom;
+
+    static const std::size_t maxSize;
+
+private:
+    // Sorted by ID, so that newer annotations are drawn above older ones.
+    std::map<AnnotationID, const ShapeAnnotationImpl*> annotations;
+    std::unique_ptr<mapbox::geojsonvt::GeoJSONVT> shapeTiler;
+};
+
+} // namespace mbgl
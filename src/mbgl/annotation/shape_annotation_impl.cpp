@@ -7,6 +7,10 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/geometry.hpp>
 
+#include <mapbox/geometry/envelope.hpp>
+
+#include <algorithm>
+
 namespace mbgl {
 
 using namespace style;
@@ -19,22 +23,37 @@ ShapeAnnotationImpl::ShapeAnnotationImpl(const AnnotationID id_, const uint8_t m
 }
 
 void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, AnnotationTileData& data) {
-    static const double baseTolerance = 4;
-
     if (!shapeTiler) {
         mapbox::geometry::feature_collection<double> features;
-        features.emplace_back(ShapeAnnotationGeometry::visit(geometry(), [] (auto&& geom) {
+        Feature feature = ShapeAnnotationGeometry::visit(geometry(), [] (auto&& geom) {
             return Feature { std::move(geom) };
-        }));
-        mapbox::geojsonvt::Options options;
-        options.maxZoom = maxZoom;
-        options.buffer = 255u;
-        options.extent = util::EXTENT;
-        options.tolerance = baseTolerance;
-        shapeTiler = std::make_unique<mapbox::geojsonvt::GeoJSONVT>(features, options);
+        });
+        feature.id = static_cast<uint64_t>(id);
+        features.emplace_back(std::move(feature));
+        shapeTiler = createShapeTiler(features, maxZoom);
     }
 
-    const auto& shapeTile = shapeTiler->getTile(tileID.z, tileID.x, tileID.y);
+    addTileFeatures(*shapeTiler, tileID, data, layerID);
+}
+
+std::unique_ptr<geojsonvt::GeoJSONVT>
+ShapeAnnotationImpl::createShapeTiler(const mapbox::geometry::feature_collection<double>& features,
+                                      const uint8_t maxZoom) {
+    static const double baseTolerance = 4;
+
+    geojsonvt::Options options;
+    options.maxZoom = maxZoom;
+    options.buffer = 255u;
+    options.extent = util::EXTENT;
+    options.tolerance = baseTolerance;
+    return std::make_unique<geojsonvt::GeoJSONVT>(features, options);
+}
+
+void ShapeAnnotationImpl::addTileFeatures(geojsonvt::GeoJSONVT& shapeTiler,
+                                          const CanonicalTileID& tileID,
+                                          AnnotationTileData& data,
+                                          const std::string& layerID) {
+    const auto& shapeTile = shapeTiler.getTile(tileID.z, tileID.x, tileID.y);
     if (shapeTile.features.empty())
         return;
 
@@ -47,14 +66,41 @@ void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, Annotati
         GeometryCollection renderGeometry = apply_visitor(toGeometryCollection, shapeFeature.geometry);
 
         assert(featureType != FeatureType::Unknown);
+        assert(shapeFeature.id && shapeFeature.id->is<uint64_t>());
 
         // https://github.com/mapbox/geojson-vt-cpp/issues/44
         if (featureType == FeatureType::Polygon) {
             renderGeometry = fixupPolygons(renderGeometry);
         }
 
-        layer.features.emplace_back(id, featureType, renderGeometry);
+        layer.features.emplace_back(static_cast<AnnotationID>(shapeFeature.id->get<uint64_t>()),
+                                    featureType, renderGeometry, shapeFeature.properties);
+    }
+}
+
+std::string ShapeAnnotationImpl::colorValue(const Color& color) {
+    // Colors are premultiplied, but parsed as if they weren't.
+    if (color.a == 0) {
+        return "rgba(0,0,0,0)";
+    }
+    return Color {
+        std::min(color.r / color.a, 1.0f),
+        std::min(color.g / color.a, 1.0f),
+        std::min(color.b / color.a, 1.0f),
+        color.a
+    }.stringify();
+}
+
+LatLngBounds shapeAnnotationBounds(const ShapeAnnotationGeometry& geometry) {
+    const auto box = ShapeAnnotationGeometry::visit(geometry, [] (const auto& geom) {
+        return mapbox::geometry::envelope(geom);
+    });
+    if (box.min.x > box.max.x || box.min.y > box.max.y) {
+        return LatLngBounds::singleton({});
     }
+    return LatLngBounds::hull(
+        { util::clamp(box.min.y, -util::LATITUDE_MAX, util::LATITUDE_MAX), box.min.x },
+        { util::clamp(box.max.y, -util::LATITUDE_MAX, util::LATITUDE_MAX), box.max.x });
 }
 
 } // namespace mbgl
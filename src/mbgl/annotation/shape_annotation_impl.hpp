@@ -3,7 +3,10 @@
 #include <mapbox/geojsonvt.hpp>
 
 #include <mbgl/annotation/annotation.hpp>
+#include <mbgl/util/geo.hpp>
 #include <mbgl/util/geometry.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <string>
 #include <memory>
@@ -12,6 +15,7 @@ namespace mbgl {
 
 class AnnotationTileData;
 class CanonicalTileID;
+class ShapeAnnotationBatch;
 
 namespace style {
 class Style;
@@ -25,14 +29,47 @@ public:
     virtual void updateStyle(style::Style&) const = 0;
     virtual const ShapeAnnotationGeometry& geometry() const = 0;
 
+    // Annotations with the same batch key share a layer and a tile index, see
+    // ShapeAnnotationBatch. Annotations that need a layer of their own have none.
+    virtual optional<std::string> batchKey() const { return {}; }
+    // The properties of the annotation's features, which the layer of its batch is styled by.
+    virtual PropertyMap featureProperties() const { return {}; }
+    // Adds the layer of a batch of annotations with this annotation's batch key.
+    virtual void updateBatchStyle(style::Style&, const std::string&) const {}
+
     void updateTileData(const CanonicalTileID&, AnnotationTileData&);
 
+    // Builds the tile index of updateTileData(), for annotations with the given maximum zoom.
+    static std::unique_ptr<mapbox::geojsonvt::GeoJSONVT>
+    createShapeTiler(const mapbox::geometry::feature_collection<double>&, uint8_t maxZoom);
+    // Adds the features of the tile to the layer, taking their annotation IDs from their IDs.
+    static void addTileFeatures(mapbox::geojsonvt::GeoJSONVT&, const CanonicalTileID&,
+                                AnnotationTileData&, const std::string& layerID);
+
     const AnnotationID id;
     const uint8_t maxZoom;
     const std::string layerID;
     std::unique_ptr<mapbox::geojsonvt::GeoJSONVT> shapeTiler;
+
+    // The batch that draws the annotation instead of its own layer, if any.
+    ShapeAnnotationBatch* batch = nullptr;
+
+protected:
+    // Encodes a color for a property that a color function's identity stops decode.
+    static std::string colorValue(const Color&);
 };
 
+// Returns the value of a property that is neither undefined nor a function.
+template <class T>
+optional<T> constantValue(const style::DataDrivenPropertyValue<T>& value) {
+    return value.match(
+        [] (const T& constant) { return optional<T>(constant); },
+        [] (const auto&) { return optional<T>(); });
+}
+
+// Returns the bounds of the annotation's geometry, which aren't wrapped.
+LatLngBounds shapeAnnotationBounds(const ShapeAnnotationGeometry&);
+
 struct CloseShapeAnnotation {
     ShapeAnnotationGeometry operator()(const mbgl::LineString<double> &geom) const {
         return geom;
@@ -0,0 +1,271 @@
+#include <mbgl/annotation/symbol_annotation_instances.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/math/clamp.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/projection.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+
+namespace mbgl {
+
+namespace {
+
+// Quads drawn without instancing are indexed with 16 bits.
+const std::size_t maxQuadsPerSegment = std::numeric_limits<uint16_t>::max() / 4;
+
+// Beyond this, the places that changed cover so much of the view that it is drawn in full.
+const std::size_t maxTrackedChanges = 256;
+
+Point<uint32_t> project(const Point<double>& geometry) {
+    const LatLng latLng(util::clamp(geometry.y, -util::LATITUDE_MAX, util::LATITUDE_MAX), geometry.x);
+    Point<double> p = Projection::project(latLng, 1) / double(util::tileSize);
+
+    // Annotations across the antimeridian are drawn in the world copies the painter draws.
+    p.x -= std::floor(p.x);
+    const double max = std::numeric_limits<uint32_t>::max();
+    return {
+        static_cast<uint32_t>(util::clamp(p.x * 4294967296.0, 0.0, max)),
+        static_cast<uint32_t>(util::clamp(p.y * 4294967296.0, 0.0, max))
+    };
+}
+
+const auto byID = [] (const auto& instance, const AnnotationID& id) {
+    return instance.id < id;
+};
+
+const std::string& iconName(const SymbolAnnotation& annotation) {
+    static const std::string defaultMarker = "default_marker";
+    return annotation.icon.empty() ? defaultMarker : annotation.icon;
+}
+
+} // namespace
+
+SymbolAnnotationInstances::SymbolAnnotationInstances(SpriteAtlas& atlas_)
+    : atlas(atlas_) {
+}
+
+SymbolAnnotationInstances::~SymbolAnnotationInstances() {
+    atlas.removeRequestor(*this);
+}
+
+std::vector<SymbolAnnotationInstances::Instance>::iterator
+SymbolAnnotationInstances::find(const AnnotationID& id) {
+    auto it = std::lower_bound(instances.begin(), instances.end(), id, byID);
+    return it != instances.end() && it->id == id ? it : instances.end();
+}
+
+void SymbolAnnotationInstances::add(const AnnotationID& id, const SymbolAnnotation& annotation) {
+    auto it = std::lower_bound(instances.begin(), instances.end(), id, byID);
+    assert(it == instances.end() || it->id != id);
+    it = instances.insert(it, Instance { id, project(annotation.geometry), iconName(annotation) });
+    requestIcon(iconName(annotation));
+    changed(it->position);
+    rebuild = true;
+}
+
+void SymbolAnnotationInstances::update(const AnnotationID& id, const SymbolAnnotation& annotation) {
+    auto it = find(id);
+    if (it == instances.end()) {
+        assert(false); // Attempt to update a non-existent symbol annotation
+        return;
+    }
+
+    changed(it->position);
+    it->position = project(annotation.geometry);
+    changed(it->position);
+    if (it->icon != iconName(annotation)) {
+        it->icon = iconName(annotation);
+        requestIcon(it->icon);
+    }
+    invalidate(it - instances.begin());
+}
+
+void SymbolAnnotationInstances::remove(const AnnotationID& id) {
+    auto it = find(id);
+    if (it != instances.end()) {
+        changed(it->position);
+        instances.erase(it);
+        rebuild = true;
+    }
+}
+
+void SymbolAnnotationInstances::clear() {
+    for (const auto& instance : instances) {
+        changed(instance.position);
+    }
+    instances.clear();
+    rebuild = true;
+}
+
+void SymbolAnnotationInstances::updateIcons() {
+    std::set<std::string> names;
+    for (const auto& instance : instances) {
+        names.insert(instance.icon);
+        changed(instance.position);
+    }
+
+    icons.clear();
+    maxIconSize = 0;
+    atlas.removeRequestor(*this);
+    atlas.getIcons(*this, IconDependencies(names.begin(), names.end()));
+
+    if (!instances.empty()) {
+        dirtyBegin = 0;
+        dirtyEnd = instances.size();
+    }
+}
+
+optional<SpriteAtlasElement> SymbolAnnotationInstances::getIcon(const SymbolAnnotation& annotation) const {
+    auto it = icons.find(iconName(annotation));
+    if (it == icons.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+void SymbolAnnotationInstances::requestIcon(const std::string& name) {
+    if (icons.find(name) == icons.end()) {
+        atlas.getIcons(*this, { name });
+    }
+}
+
+void SymbolAnnotationInstances::onIconsAvailable(SpriteAtlas*, IconMap newIcons) {
+    for (auto& pair : newIcons) {
+        maxIconSize = std::max({ maxIconSize, pair.second.width, pair.second.height });
+        icons.erase(pair.first);
+        icons.emplace(pair.first, std::move(pair.second));
+    }
+
+    // Instances that were waiting for these icons were written without an image.
+    for (std::size_t i = 0; i < instances.size(); i++) {
+        if (newIcons.count(instances[i].icon)) {
+            invalidate(i);
+            changed(instances[i].position);
+        }
+    }
+}
+
+void SymbolAnnotationInstances::invalidate(std::size_t index) {
+    if (dirtyBegin == dirtyEnd) {
+        dirtyBegin = index;
+        dirtyEnd = index + 1;
+    } else {
+        dirtyBegin = std::min(dirtyBegin, index);
+        dirtyEnd = std::max(dirtyEnd, index + 1);
+    }
+}
+
+void SymbolAnnotationInstances::changed(const Point<uint32_t>& position) {
+    changes.maxIconSize = std::max(changes.maxIconSize, maxIconSize);
+    if (changes.all) {
+        return;
+    }
+    if (changes.positions.size() >= maxTrackedChanges) {
+        changes.all = true;
+        changes.positions.clear();
+        return;
+    }
+    changes.positions.push_back(position);
+}
+
+SymbolAnnotationInstances::Changes SymbolAnnotationInstances::takeChanges() {
+    Changes result = std::move(changes);
+    result.maxIconSize = std::max(result.maxIconSize, maxIconSize);
+    changes = {};
+    return result;
+}
+
+AnnotationIconInstanceVertex SymbolAnnotationInstances::vertex(const Instance& instance) const {
+    auto it = icons.find(instance.icon);
+    if (it == icons.end()) {
+        // Draws nothing until the icon is added.
+        return AnnotationIconProgram::instanceVertex(instance.position, {{ 0, 0, 0, 0 }}, {{ 0, 0 }});
+    }
+
+    // The icon's rectangle in the atlas, within its transparent border; see the
+    // SpriteAtlasElement constructor.
+    const SpriteAtlasElement& icon = it->second;
+    const uint16_t left = icon.pos.x + 1;
+    const uint16_t top = icon.pos.y + 1;
+    return AnnotationIconProgram::instanceVertex(
+        instance.position,
+        {{
+            left,
+            top,
+            static_cast<uint16_t>(left + std::round(icon.width * icon.relativePixelRatio)),
+            static_cast<uint16_t>(top + std::round(icon.height * icon.relativePixelRatio))
+        }},
+        {{ icon.width, icon.height }});
+}
+
+void SymbolAnnotationInstances::upload(gl::Context& context) {
+    const bool instancing = context.supportsInstancing();
+    const std::size_t verticesPerInstance = instancing ? 1 : 4;
+
+    if (rebuild || instancing != instanced) {
+        rebuild = false;
+        instanced = instancing;
+        dirtyBegin = dirtyEnd = 0;
+
+        cornerBuffer = {};
+        instanceBuffer = {};
+        indexBuffer = {};
+        segments.clear();
+        instanceVertices.release();
+
+        if (instances.empty()) {
+            return;
+        }
+
+        gl::VertexVector<AnnotationIconCornerVertex> corners;
+        gl::IndexVector<gl::Triangles> indices;
+        const std::size_t quads = instanced ? 1 : instances.size();
+        for (std::size_t i = 0; i < quads; i++) {
+            corners.emplace_back(AnnotationIconCornerVertex {{{ -1, -1 }}});
+            corners.emplace_back(AnnotationIconCornerVertex {{{ 1, -1 }}});
+            corners.emplace_back(AnnotationIconCornerVertex {{{ -1, 1 }}});
+            corners.emplace_back(AnnotationIconCornerVertex {{{ 1, 1 }}});
+        }
+
+        // All segments index their quads from their first vertex, so they share the indices.
+        for (std::size_t i = 0; i < std::min(quads, maxQuadsPerSegment); i++) {
+            const uint16_t index = i * 4;
+            indices.emplace_back(index, index + 1, index + 2);
+            indices.emplace_back(index + 1, index + 2, index + 3);
+        }
+        for (std::size_t first = 0; first < quads; first += maxQuadsPerSegment) {
+            const std::size_t count = std::min(quads - first, maxQuadsPerSegment);
+            segments.emplace_back(first * 4, 0, count * 4, count * 6);
+        }
+
+        for (const auto& instance : instances) {
+            const auto vertex_ = vertex(instance);
+            for (std::size_t i = 0; i < verticesPerInstance; i++) {
+                instanceVertices.emplace_back(vertex_);
+            }
+        }
+
+        cornerBuffer = context.createVertexBuffer(std::move(corners));
+        indexBuffer = context.createIndexBuffer(std::move(indices));
+        instanceBuffer = context.createVertexBuffer(std::move(instanceVertices));
+        return;
+    }
+
+    if (dirtyBegin < dirtyEnd) {
+        for (std::size_t i = dirtyBegin; i < dirtyEnd; i++) {
+            const auto vertex_ = vertex(instances[i]);
+            for (std::size_t j = 0; j < verticesPerInstance; j++) {
+                instanceVertices[i * verticesPerInstance + j] = vertex_;
+            }
+        }
+        context.updateVertexBuffer(*instanceBuffer, instanceVertices,
+                                   dirtyBegin * verticesPerInstance,
+                                   (dirtyEnd - dirtyBegin) * verticesPerInstance);
+        dirtyBegin = dirtyEnd = 0;
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <mbgl/annotation/annotation.hpp>
+#include <mbgl/programs/annotation_icon_program.hpp>
+#include <mbgl/sprite/sprite_atlas.hpp>
+#include <mbgl/gl/vertex_buffer.hpp>
+#include <mbgl/gl/index_buffer.hpp>
+#include <mbgl/gl/segment.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+namespace gl {
+class Context;
+} // namespace gl
+
+// The icons of symbol annotations, drawn straight from a buffer with an instance per annotation
+// rather than laid out into the tiles of the annotation source. Unlike the tiles' symbols, the
+// icons aren't shaped, placed or clipped at tile boundaries, so that moving an annotation only
+// rewrites its instance. The icons are drawn above all layers, in the order of their IDs, as the
+// annotation source's layer draws them.
+class SymbolAnnotationInstances : public IconRequestor, private util::noncopyable {
+public:
+    explicit SymbolAnnotationInstances(SpriteAtlas&);
+    ~SymbolAnnotationInstances();
+
+    void add(const AnnotationID&, const SymbolAnnotation&);
+    void update(const AnnotationID&, const SymbolAnnotation&);
+    void remove(const AnnotationID&);
+    void clear();
+
+    // Picks up icons that were added to the atlas, or changed, since they were last requested.
+    void updateIcons();
+
+    bool empty() const { return instances.empty(); }
+
+    // Returns the icon that the annotation is drawn with, if the atlas has it.
+    optional<SpriteAtlasElement> getIcon(const SymbolAnnotation&) const;
+
+    // The largest width or height of the icons, in pixels.
+    float getMaxIconSize() const { return maxIconSize; }
+
+    // Uploads the instances that changed since the last upload, or all of them if annotations
+    // were added or removed in between.
+    void upload(gl::Context&);
+    // Whether upload() has instances to upload.
+    bool needsUpload() const { return rebuild || dirtyBegin < dirtyEnd; }
+
+    // Where icons appeared, disappeared or changed since the last call, so that views which keep
+    // their contents only draw those places again.
+    struct Changes {
+        std::vector<Point<uint32_t>> positions;
+        // Set instead of the positions when too many icons changed to track them one by one.
+        bool all = false;
+        // The largest width or height of the icons, in pixels, while they changed.
+        float maxIconSize = 0;
+    };
+    Changes takeChanges();
+
+    void onIconsAvailable(SpriteAtlas*, IconMap) override;
+
+    SpriteAtlas& atlas;
+
+    // Whether the buffers hold an instance per annotation, or the four vertices of its quad.
+    bool instanced = false;
+
+    optional<gl::VertexBuffer<AnnotationIconCornerVertex>> cornerBuffer;
+    optional<gl::VertexBuffer<AnnotationIconInstanceVertex>> instanceBuffer;
+    optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+    gl::SegmentVector<AnnotationIconProgram::Attributes> segments;
+
+private:
+    struct Instance {
+        AnnotationID id;
+        Point<uint32_t> position;
+        std::string icon;
+    };
+
+    std::vector<Instance>::iterator find(const AnnotationID&);
+    void requestIcon(const std::string&);
+    AnnotationIconInstanceVertex vertex(const Instance&) const;
+    void invalidate(std::size_t index);
+    void changed(const Point<uint32_t>& position);
+
+    // Sorted by ID.
+    std::vector<Instance> instances;
+    IconMap icons;
+    float maxIconSize = 0;
+
+    gl::VertexVector<AnnotationIconInstanceVertex> instanceVertices;
+
+    // Set when the number of instances changed, so that the buffers need to be rebuilt.
+    bool rebuild = true;
+    // The range of instances that changed since the last upload.
+    std::size_t dirtyBegin = 0;
+    std::size_t dirtyEnd = 0;
+
+    Changes changes;
+};
+
+} // namespace mbgl
@@ -0,0 +1,71 @@
+#include <mbgl/geometry/dem_data.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace mbgl {
+
+DEMData::DEMData(const UnassociatedImage& source)
+    : dim(source.size.width),
+      stride(dim + 2),
+      image({ uint32_t(stride), uint32_t(stride) }) {
+    if (source.size.height != source.size.width) {
+        throw std::runtime_error("raster-dem tiles must be square");
+    }
+
+    for (int32_t y = 0; y < dim; y++) {
+        std::memcpy(image.data.get() + offset(0, y), source.data.get() + std::size_t(y) * dim * 4,
+                    std::size_t(dim) * 4);
+    }
+
+    // The border repeats the edge pixels, the corners included, until the neighbours load.
+    for (int32_t y = 0; y < dim; y++) {
+        std::memcpy(image.data.get() + offset(-1, y), image.data.get() + offset(0, y), 4);
+        std::memcpy(image.data.get() + offset(dim, y), image.data.get() + offset(dim - 1, y), 4);
+    }
+    std::memcpy(image.data.get() + offset(-1, -1), image.data.get() + offset(-1, 0), std::size_t(stride) * 4);
+    std::memcpy(image.data.get() + offset(-1, dim), image.data.get() + offset(-1, dim - 1), std::size_t(stride) * 4);
+}
+
+void DEMData::backfillBorder(const DEMData& other, int8_t dx, int8_t dy) {
+    assert(dim == other.dim);
+    assert(dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1);
+
+    // The pixels of the border that the other tile covers, in the coordinates of this tile.
+    int32_t xMin = dx * dim;
+    int32_t xMax = dx * dim + dim;
+    int32_t yMin = dy * dim;
+    int32_t yMax = dy * dim + dim;
+    if (dx == -1) {
+        xMin = xMax - 1;
+    } else if (dx == 1) {
+        xMax = xMin + 1;
+    }
+    if (dy == -1) {
+        yMin = yMax - 1;
+    } else if (dy == 1) {
+        yMax = yMin + 1;
+    }
+    xMin = std::max(xMin, -1);
+    xMax = std::min(xMax, dim + 1);
+    yMin = std::max(yMin, -1);
+    yMax = std::min(yMax, dim + 1);
+
+    const int32_t ox = -dx * dim;
+    const int32_t oy = -dy * dim;
+    for (int32_t y = yMin; y < yMax; y++) {
+        std::memcpy(image.data.get() + offset(xMin, y),
+                    other.image.data.get() + other.offset(xMin + ox, y + oy),
+                    std::size_t(xMax - xMin) * 4);
+    }
+}
+
+float DEMData::get(int32_t x, int32_t y) const {
+    assert(x >= -1 && x <= dim && y >= -1 && y <= dim);
+    const uint8_t* pixel = image.data.get() + offset(x, y);
+    return (pixel[0] * 256 * 256 + pixel[1] * 256 + pixel[2]) / 10.0f - 10000.0f;
+}
+
+} // namespace mbgl
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <mbgl/util/image.hpp>
+
+#include <cstdint>
+
+namespace mbgl {
+
+// The elevations of a raster-dem tile, in the Mapbox Terrain-RGB encoding that the tile was
+// decoded from. They're kept with a border of one pixel around the tile, so that the slopes at
+// its edges can be computed from the tiles next to it. Until those are loaded, the border
+// repeats the edge of the tile.
+class DEMData {
+public:
+    // Throws std::runtime_error if the image isn't square.
+    DEMData(const UnassociatedImage&);
+
+    // Copies the edge of a tile of the same size next to this one into the border, given the
+    // offset of the other tile in tiles, e.g. { -1, 0 } for the tile on the left.
+    void backfillBorder(const DEMData& other, int8_t dx, int8_t dy);
+
+    // Returns the elevation in meters of a pixel, between -1 and dim inclusive.
+    float get(int32_t x, int32_t y) const;
+
+    // The width and height of the tile, without the border.
+    const int32_t dim;
+    // The width and height of the image, with the border.
+    const int32_t stride;
+
+    // The encoded elevations, with the border.
+    UnassociatedImage image;
+
+private:
+    std::size_t offset(int32_t x, int32_t y) const {
+        return (std::size_t(y + 1) * stride + std::size_t(x + 1)) * 4;
+    }
+};
+
+} // namespace mbgl
@@ -8,12 +8,14 @@
 #include <mbgl/util/math.hpp>
 #include <mbgl/math/minmax.hpp>
 #include <mbgl/map/query.hpp>
+#include <mbgl/tile/tile_id.hpp>
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/filter_evaluator.hpp>
 
 #include <mapbox/geometry/envelope.hpp>
 
 #include <cassert>
+#include <limits>
 #include <string>
 
 namespace mbgl {
@@ -22,12 +24,32 @@ FeatureIndex::FeatureIndex()
     : grid(util::EXTENT, 16, 0) {
 }
 
+static uint16_t findOrAdd(std::vector<std::string>& names, const std::string& name) {
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it == names.end()) {
+        assert(names.size() < std::numeric_limits<uint16_t>::max());
+        it = names.insert(names.end(), name);
+    }
+    return static_cast<uint16_t>(it - names.begin());
+}
+
+uint16_t FeatureIndex::addSourceLayerName(const std::string& sourceLayerName) {
+    return findOrAdd(sourceLayerNames, sourceLayerName);
+}
+
+uint16_t FeatureIndex::setBucketLayerIDs(const std::string& bucketName, const std::vector<std::string>& layerIDs) {
+    const uint16_t bucketID = findOrAdd(bucketNames, bucketName);
+    bucketLayerIDs.resize(bucketNames.size());
+    bucketLayerIDs[bucketID] = layerIDs;
+    return bucketID;
+}
+
 void FeatureIndex::insert(const GeometryCollection& geometries,
                           std::size_t index,
-                          const std::string& sourceLayerName,
-                          const std::string& bucketName) {
+                          uint16_t sourceLayerID,
+                          uint16_t bucketID) {
     for (const auto& ring : geometries) {
-        grid.insert(IndexedSubfeature { index, sourceLayerName, bucketName, sortIndex++ },
+        grid.insert(IndexedSubfeature { index, sourceLayerID, bucketID, sortIndex++ },
                     mapbox::geometry::envelope(ring));
     }
 }
@@ -64,6 +86,46 @@ void FeatureIndex::query(
         const CanonicalTileID& tileID,
         const style::Style& style,
         const CollisionTile* collisionTile) const {
+    visit([&] (const IndexedSubfeature&, const GeometryTileLayer&, const style::Layer& layer, const GeometryTileFeature& feature) {
+        result[layer.getID()].push_back(convertFeature(feature, tileID));
+    }, queryGeometry, bearing, tileSize, scale, queryOptions, geometryTileData, style, collisionTile);
+}
+
+void FeatureIndex::query(
+        std::vector<RenderedFeatureHandle>& result,
+        const GeometryCoordinates& queryGeometry,
+        const float bearing,
+        const double tileSize,
+        const double scale,
+        const RenderedQueryOptions& queryOptions,
+        const std::shared_ptr<const GeometryTileData>& geometryTileData,
+        const CanonicalTileID& tileID,
+        const style::Style& style,
+        const CollisionTile* collisionTile) const {
+    // The rings of a feature have consecutive sort indices, so their entries are adjacent.
+    const IndexedSubfeature* previous = nullptr;
+    visit([&] (const IndexedSubfeature& indexedFeature, const GeometryTileLayer& sourceLayer, const style::Layer& layer, const GeometryTileFeature&) {
+        if (previous && previous != &indexedFeature &&
+            previous->index == indexedFeature.index &&
+            previous->bucketID == indexedFeature.bucketID &&
+            previous->sourceLayerID == indexedFeature.sourceLayerID) {
+            return;
+        }
+        previous = &indexedFeature;
+        result.emplace_back(layer, geometryTileData, sourceLayer, indexedFeature.index, tileID);
+    }, queryGeometry, bearing, tileSize, scale, queryOptions, *geometryTileData, style, collisionTile);
+}
+
+void FeatureIndex::visit(
+        const Visitor& visitor,
+        const GeometryCoordinates& queryGeometry,
+        const float bearing,
+        const double tileSize,
+        const double scale,
+        const RenderedQueryOptions& queryOptions,
+        const GeometryTileData& geometryTileData,
+        const style::Style& style,
+        const CollisionTile* collisionTile) const {
 
     mapbox::geometry::box<int16_t> box = mapbox::geometry::envelope(queryGeometry);
 
@@ -72,14 +134,14 @@ void FeatureIndex::query(
     std::vector<IndexedSubfeature> features = grid.query({ box.min - additionalRadius, box.max + additionalRadius });
 
     std::sort(features.begin(), features.end(), topDown);
-    size_t previousSortIndex = std::numeric_limits<size_t>::max();
+    uint32_t previousSortIndex = std::numeric_limits<uint32_t>::max();
     for (const auto& indexedFeature : features) {
 
         // If this feature is the same as the previous feature, skip it.
         if (indexedFeature.sortIndex == previousSortIndex) continue;
         previousSortIndex = indexedFeature.sortIndex;
 
-        addFeature(result, indexedFeature, queryGeometry, queryOptions, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
+        addFeature(visitor, indexedFeature, queryGeometry, queryOptions, geometryTileData, style, bearing, pixelsToTileUnits);
     }
 
     // Query symbol features, if they've been placed.
@@ -90,27 +152,26 @@ void FeatureIndex::query(
     std::vector<IndexedSubfeature> symbolFeatures = collisionTile->queryRenderedSymbols(queryGeometry, scale);
     std::sort(symbolFeatures.begin(), symbolFeatures.end(), topDownSymbols);
     for (const auto& symbolFeature : symbolFeatures) {
-        addFeature(result, symbolFeature, queryGeometry, queryOptions, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
+        addFeature(visitor, symbolFeature, queryGeometry, queryOptions, geometryTileData, style, bearing, pixelsToTileUnits);
     }
 }
 
 void FeatureIndex::addFeature(
-    std::unordered_map<std::string, std::vector<Feature>>& result,
+    const Visitor& visitor,
     const IndexedSubfeature& indexedFeature,
     const GeometryCoordinates& queryGeometry,
     const RenderedQueryOptions& options,
     const GeometryTileData& geometryTileData,
-    const CanonicalTileID& tileID,
     const style::Style& style,
     const float bearing,
     const float pixelsToTileUnits) const {
 
-    auto& layerIDs = bucketLayerIDs.at(indexedFeature.bucketName);
+    auto& layerIDs = bucketLayerIDs.at(indexedFeature.bucketID);
     if (options.layerIDs && !vectorsIntersect(layerIDs, *options.layerIDs)) {
         return;
     }
 
-    auto sourceLayer = geometryTileData.getLayer(indexedFeature.sourceLayerName);
+    auto sourceLayer = geometryTileData.getLayer(sourceLayerNames.at(indexedFeature.sourceLayerID));
     assert(sourceLayer);
 
     auto geometryTileFeature = sourceLayer->getFeature(indexedFeature.index);
@@ -132,7 +193,7 @@ void FeatureIndex::addFeature(
             continue;
         }
 
-        result[layerID].push_back(convertFeature(*geometryTileFeature, tileID));
+        visitor(indexedFeature, *sourceLayer, *styleLayer, *geometryTileFeature);
     }
 }
 
@@ -158,8 +219,4 @@ optional<GeometryCoordinates> FeatureIndex::translateQueryGeometry(
     return translated;
 }
 
-void FeatureIndex::setBucketLayerIDs(const std::string& bucketName, const std::vector<std::string>& layerIDs) {
-    bucketLayerIDs[bucketName] = layerIDs;
-}
-
 } // namespace mbgl
@@ -5,35 +5,51 @@
 #include <mbgl/util/grid_index.hpp>
 #include <mbgl/util/feature.hpp>
 
+#include <functional>
+#include <memory>
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <cstdint>
 
 namespace mbgl {
 
 class RenderedQueryOptions;
+class RenderedFeatureHandle;
 
 namespace style {
 class Style;
+class Layer;
 } // namespace style
 
 class CollisionTile;
 class CanonicalTileID;
 
+// Trivially copyable, so that the tens of thousands of entries of a dense tile take no memory
+// beyond their own: the names of the source layer and the bucket are stored once, in the tables
+// of the tile's FeatureIndex, and referred to by their positions in them.
 class IndexedSubfeature {
 public:
     IndexedSubfeature() = delete;
     std::size_t index;
-    std::string sourceLayerName;
-    std::string bucketName;
-    size_t sortIndex;
+    uint16_t sourceLayerID;
+    uint16_t bucketID;
+    uint32_t sortIndex;
 };
 
 class FeatureIndex {
 public:
     FeatureIndex();
 
-    void insert(const GeometryCollection&, std::size_t index, const std::string& sourceLayerName, const std::string& bucketName);
+    // Returns the ID that indexed subfeatures refer to the source layer by, adding its name to
+    // the table if it isn't in it yet.
+    uint16_t addSourceLayerName(const std::string& sourceLayerName);
+
+    // Sets the style layers of a bucket, and returns the ID that indexed subfeatures refer to
+    // the bucket by.
+    uint16_t setBucketLayerIDs(const std::string& bucketName, const std::vector<std::string>& layerIDs);
+
+    void insert(const GeometryCollection&, std::size_t index, uint16_t sourceLayerID, uint16_t bucketID);
 
     void query(
             std::unordered_map<std::string, std::vector<Feature>>& result,
@@ -47,6 +63,20 @@ public:
             const style::Style&,
             const CollisionTile*) const;
 
+    // Finds the same features as the query above, without converting them. A feature that is
+    // indexed once for each of its rings is only returned once for each layer.
+    void query(
+            std::vector<RenderedFeatureHandle>& result,
+            const GeometryCoordinates& queryGeometry,
+            const float bearing,
+            const double tileSize,
+            const double scale,
+            const RenderedQueryOptions& options,
+            const std::shared_ptr<const GeometryTileData>&,
+            const CanonicalTileID&,
+            const style::Style&,
+            const CollisionTile*) const;
+
     static optional<GeometryCoordinates> translateQueryGeometry(
             const GeometryCoordinates& queryGeometry,
             const std::array<float, 2>& translate,
@@ -54,23 +84,44 @@ public:
             const float bearing,
             const float pixelsToTileUnits);
 
-    void setBucketLayerIDs(const std::string& bucketName, const std::vector<std::string>& layerIDs);
+    std::size_t getByteSize() const {
+        return grid.getByteSize();
+    }
 
 private:
+    using Visitor = std::function<void (const IndexedSubfeature&,
+                                        const GeometryTileLayer&,
+                                        const style::Layer&,
+                                        const GeometryTileFeature&)>;
+
+    void visit(
+            const Visitor&,
+            const GeometryCoordinates& queryGeometry,
+            const float bearing,
+            const double tileSize,
+            const double scale,
+            const RenderedQueryOptions& options,
+            const GeometryTileData&,
+            const style::Style&,
+            const CollisionTile*) const;
+
     void addFeature(
-            std::unordered_map<std::string, std::vector<Feature>>& result,
+            const Visitor&,
             const IndexedSubfeature&,
             const GeometryCoordinates& queryGeometry,
             const RenderedQueryOptions& options,
             const GeometryTileData&,
-            const CanonicalTileID&,
             const style::Style&,
             const float bearing,
             const float pixelsToTileUnits) const;
 
     GridIndex<IndexedSubfeature> grid;
-    unsigned int sortIndex = 0;
+    uint32_t sortIndex = 0;
 
-    std::unordered_map<std::string, std::vector<std::string>> bucketLayerIDs;
+    // Indexed by the IDs of the indexed subfeatures. A tile has a few dozen of each at most, so
+    // names are looked up by scanning them.
+    std::vector<std::string> sourceLayerNames;
+    std::vector<std::string> bucketNames;
+    std::vector<std::vector<std::string>> bucketLayerIDs;
 };
 } // namespace mbgl
@@ -5,47 +5,156 @@
 
 #include <boost/functional/hash.hpp>
 
-#include <sstream>
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <iterator>
+#include <limits>
 
 namespace mbgl {
 
-LineAtlas::LineAtlas(const Size size)
-    : image(size),
-      dirty(true) {
+LineAtlas::LineAtlas(const Size size, const uint32_t maximumHeight_)
+    : maximumHeight(maximumHeight_),
+      image(size),
+      dirtyTop(0),
+      dirtyBottom(size.height) {
+    assert(size.height <= maximumHeight);
 }
 
 LineAtlas::~LineAtlas() = default;
 
+std::size_t LineAtlas::DashKeyHash::operator()(const DashKey& key) const {
+    size_t seed = key.cap == LinePatternCap::Round ? std::numeric_limits<size_t>::min()
+                                                   : std::numeric_limits<size_t>::max();
+    for (const float part : key.dasharray) {
+        boost::hash_combine<float>(seed, part);
+    }
+    return seed;
+}
+
 LinePatternPos LineAtlas::getDashPosition(const std::vector<float>& dasharray,
                                           LinePatternCap patternCap) {
-    size_t key = patternCap == LinePatternCap::Round ? std::numeric_limits<size_t>::min()
-                                                     : std::numeric_limits<size_t>::max();
+    DashKey key { dasharray, patternCap };
+
+    auto it = dashes.find(key);
+    if (it != dashes.end()) {
+        it->second.lastUsed = ++clock;
+        return getPosition(it->second);
+    }
+
+    const uint32_t n = patternCap == LinePatternCap::Round ? 7 : 0;
+    const uint32_t height = 2 * n + 1;
+
+    optional<uint32_t> row = allocateRows(height);
+    while (!row && (grow() || evict())) {
+        row = allocateRows(height);
+    }
+    if (!row) {
+        Log::Warning(Event::OpenGL, "line atlas bitmap overflow");
+        return LinePatternPos();
+    }
+
+    addDash(dasharray, patternCap, *row);
+
+    float length = 0;
     for (const float part : dasharray) {
-        boost::hash_combine<float>(key, part);
+        length += part;
+    }
+
+    auto inserted = dashes.emplace(std::move(key), Dash { *row, height, length, ++clock });
+    assert(inserted.second);
+    return getPosition(inserted.first->second);
+}
+
+LinePatternPos LineAtlas::getPosition(const Dash& dash) const {
+    const uint32_t n = (dash.height - 1) / 2;
+
+    LinePatternPos position;
+    position.y = (0.5 + dash.row + n) / image.size.height;
+    position.height = (2.0 * n) / image.size.height;
+    position.width = dash.length;
+    return position;
+}
+
+optional<uint32_t> LineAtlas::allocateRows(uint32_t height) {
+    for (auto it = freeRows.begin(); it != freeRows.end(); ++it) {
+        if (it->second >= height) {
+            const uint32_t row = it->first;
+            const uint32_t remaining = it->second - height;
+            freeRows.erase(it);
+            if (remaining) {
+                freeRows.emplace(row + height, remaining);
+            }
+            return row;
+        }
+    }
+
+    if (nextRow + height > image.size.height) {
+        return {};
+    }
+
+    const uint32_t row = nextRow;
+    nextRow += height;
+    return row;
+}
+
+void LineAtlas::releaseRows(uint32_t row, uint32_t height) {
+    // Merge with the adjacent free runs.
+    auto next = freeRows.lower_bound(row);
+    if (next != freeRows.end() && next->first == row + height) {
+        height += next->second;
+        next = freeRows.erase(next);
+    }
+    if (next != freeRows.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == row) {
+            row = prev->first;
+            height += prev->second;
+            freeRows.erase(prev);
+        }
     }
 
-    // Note: We're not handling hash collisions here.
-    const auto it = positions.find(key);
-    if (it == positions.end()) {
-        auto inserted = positions.emplace(key, addDash(dasharray, patternCap));
-        assert(inserted.second);
-        return inserted.first->second;
+    if (row + height == nextRow) {
+        nextRow = row;
     } else {
-        return it->second;
+        freeRows.emplace(row, height);
     }
 }
 
-LinePatternPos LineAtlas::addDash(const std::vector<float>& dasharray, LinePatternCap patternCap) {
-    const uint8_t n = patternCap == LinePatternCap::Round ? 7 : 0;
-    const uint8_t dashheight = 2 * n + 1;
-    const uint8_t offset = 128;
+bool LineAtlas::grow() {
+    if (image.size.height >= maximumHeight) {
+        return false;
+    }
 
-    if (nextRow + dashheight > image.size.height) {
-        Log::Warning(Event::OpenGL, "line atlas bitmap overflow");
-        return LinePatternPos();
+    AlphaImage grown({ image.size.width, std::min(image.size.height * 2, maximumHeight) });
+    AlphaImage::copy(image, grown, { 0, 0 }, { 0, 0 }, image.size);
+    image = std::move(grown);
+
+    // The texture has to be recreated at the new size.
+    dirtyTop = 0;
+    dirtyBottom = image.size.height;
+
+    return true;
+}
+
+bool LineAtlas::evict() {
+    if (dashes.empty()) {
+        return false;
     }
 
+    auto lru = std::min_element(dashes.begin(), dashes.end(), [] (const auto& a, const auto& b) {
+        return a.second.lastUsed < b.second.lastUsed;
+    });
+    releaseRows(lru->second.row, lru->second.height);
+    dashes.erase(lru);
+
+    return true;
+}
+
+void LineAtlas::addDash(const std::vector<float>& dasharray, LinePatternCap patternCap, uint32_t top) {
+    const uint8_t n = patternCap == LinePatternCap::Round ? 7 : 0;
+    const uint8_t offset = 128;
+
     float length = 0;
     for (const float part : dasharray) {
         length += part;
@@ -58,7 +167,7 @@ LinePatternPos LineAtlas::addDash(const std::vector<float>& dasharray, LinePatte
     bool oddLength = dasharray.size() % 2 == 1;
 
     for (int y = -n; y <= n; y++) {
-        int row = nextRow + n + y;
+        int row = top + n + y;
         int index = image.size.width * row;
 
         float left = 0;
@@ -105,16 +214,8 @@ LinePatternPos LineAtlas::addDash(const std::vector<float>& dasharray, LinePatte
         }
     }
 
-    LinePatternPos position;
-    position.y = (0.5 + nextRow + n) / image.size.height;
-    position.height = (2.0 * n) / image.size.height;
-    position.width = length;
-
-    nextRow += dashheight;
-
-    dirty = true;
-
-    return position;
+    dirtyTop = std::min(dirtyTop, top);
+    dirtyBottom = std::max<uint32_t>(dirtyBottom, top + 2 * n + 1);
 }
 
 Size LineAtlas::getSize() const {
@@ -124,11 +225,14 @@ Size LineAtlas::getSize() const {
 void LineAtlas::upload(gl::Context& context, gl::TextureUnit unit) {
     if (!texture) {
         texture = context.createTexture(image, unit);
-    } else if (dirty) {
+    } else if (texture->size != image.size) {
         context.updateTexture(*texture, image, unit);
+    } else if (dirtyTop < dirtyBottom) {
+        context.updateTextureRows(*texture, image, dirtyTop, dirtyBottom - dirtyTop, unit);
     }
 
-    dirty = false;
+    dirtyTop = image.size.height;
+    dirtyBottom = 0;
 }
 
 void LineAtlas::bind(gl::Context& context, gl::TextureUnit unit) {
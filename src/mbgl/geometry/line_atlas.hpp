@@ -5,6 +5,7 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <map>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -29,27 +30,76 @@ enum class LinePatternCap : bool {
 
 class LineAtlas {
 public:
-    LineAtlas(Size);
+    // The atlas starts out at the given size, and doubles in height whenever it fills up until it
+    // reaches the maximum height. Once it can't grow anymore, the least recently used dash
+    // patterns are evicted to make room for new ones.
+    LineAtlas(Size, uint32_t maximumHeight = 1024);
     ~LineAtlas();
 
     // Binds the atlas texture to the GPU, and uploads data if it is out of date.
     void bind(gl::Context&, gl::TextureUnit unit);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // the texture is only bound when the data is out of date (=dirty). Only the rows that dash
+    // patterns were added to since the last upload are sent, unless the atlas has grown.
     void upload(gl::Context&, gl::TextureUnit unit);
 
+    // Returns the position of the dash pattern, adding it to the atlas if needed. The position is
+    // only valid until the next call, because adding a pattern may grow the atlas or evict other
+    // patterns.
     LinePatternPos getDashPosition(const std::vector<float>&, LinePatternCap);
-    LinePatternPos addDash(const std::vector<float>& dasharray, LinePatternCap);
 
     Size getSize() const;
 
+    // Returns the number of dash patterns in the atlas.
+    std::size_t getDashCount() const { return dashes.size(); }
+
 private:
-    const AlphaImage image;
-    bool dirty;
+    struct DashKey {
+        std::vector<float> dasharray;
+        LinePatternCap cap;
+
+        bool operator==(const DashKey& other) const {
+            return cap == other.cap && dasharray == other.dasharray;
+        }
+    };
+
+    struct DashKeyHash {
+        std::size_t operator()(const DashKey&) const;
+    };
+
+    struct Dash {
+        uint32_t row;
+        uint32_t height;
+        float length;
+
+        // When the pattern was last looked up, for evicting the least recently used ones first.
+        uint64_t lastUsed;
+    };
+
+    optional<uint32_t> allocateRows(uint32_t height);
+    void releaseRows(uint32_t row, uint32_t height);
+    bool grow();
+    bool evict();
+
+    void addDash(const std::vector<float>& dasharray, LinePatternCap, uint32_t top);
+    LinePatternPos getPosition(const Dash&) const;
+
+    const uint32_t maximumHeight;
+    AlphaImage image;
     mbgl::optional<gl::Texture> texture;
+
+    // The rows of the image that changed since the last upload, from the first to the last.
+    uint32_t dirtyTop;
+    uint32_t dirtyBottom;
+
+    // Rows below nextRow have been used; freeRows holds the runs of them that are free again,
+    // by their first row.
     uint32_t nextRow = 0;
-    std::unordered_map<size_t, LinePatternPos> positions;
+    std::map<uint32_t, uint32_t> freeRows;
+
+    std::unordered_map<DashKey, Dash, DashKeyHash> dashes;
+    uint64_t clock = 0;
 };
 
 } // namespace mbgl
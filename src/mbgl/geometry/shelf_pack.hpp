@@ -0,0 +1,145 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/rect.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+// Packs rectangles into rows ("shelves") of similar height. A rectangle is placed on the first
+// shelf that is at least as tall as the rectangle, but not more than half again as tall, and
+// that has room left; otherwise a new shelf is opened below the last one. Released rectangles
+// are reused by later allocations of the same size, and shelves whose rectangles have all been
+// released are reset. Unlike BinPack, the cost of an allocation depends on the number of
+// shelves rather than on the number of rectangles that have been packed.
+template <typename T>
+class ShelfPack : private util::noncopyable {
+public:
+    ShelfPack(T width_, T height_)
+        : width(width_), height(height_) {}
+
+    T getWidth() const { return width; }
+    T getHeight() const { return height; }
+
+    // Returns an empty rectangle if there's no room left.
+    Rect<T> allocate(T w, T h) {
+        auto reusable = released.find({ w, h });
+        if (reusable != released.end()) {
+            Rect<T> rect = reusable->second.back();
+            reusable->second.pop_back();
+            if (reusable->second.empty()) {
+                released.erase(reusable);
+            }
+            shelves.at(rect.y).count++;
+            return rect;
+        }
+
+        const uint32_t maxHeight = uint32_t(h) + h / 2;
+        for (auto it = shelvesByHeight.lower_bound(h);
+             it != shelvesByHeight.end() && it->first <= maxHeight; ++it) {
+            Shelf& shelf = shelves.at(it->second);
+            if (width - shelf.x >= w) {
+                Rect<T> rect { shelf.x, shelf.y, w, h };
+                shelf.x += w;
+                shelf.count++;
+                return rect;
+            }
+        }
+
+        if (w > width || h > height - bottom) {
+            return Rect<T>{ 0, 0, 0, 0 };
+        }
+
+        Shelf& shelf = shelves[bottom];
+        shelf.y = bottom;
+        shelf.h = h;
+        shelf.x = w;
+        shelf.count = 1;
+        shelvesByHeight.emplace(h, bottom);
+        bottom += h;
+
+        return Rect<T>{ 0, shelf.y, w, h };
+    }
+
+    void release(Rect<T> rect) {
+        auto it = shelves.find(rect.y);
+        assert(it != shelves.end());
+        Shelf& shelf = it->second;
+        assert(shelf.count > 0);
+
+        if (--shelf.count > 0) {
+            released[{ rect.w, rect.h }].push_back(rect);
+            return;
+        }
+
+        // The shelf is empty: forget the rectangles released from it, and make all of its width
+        // available again. Empty shelves at the bottom give their height back.
+        for (auto r = released.begin(); r != released.end();) {
+            auto& rects = r->second;
+            rects.erase(std::remove_if(rects.begin(), rects.end(), [&] (const Rect<T>& other) {
+                return other.y == shelf.y;
+            }), rects.end());
+            r = rects.empty() ? released.erase(r) : std::next(r);
+        }
+
+        shelf.x = 0;
+
+        while (!shelves.empty() && std::prev(shelves.end())->second.count == 0) {
+            removeLastShelf();
+        }
+    }
+
+    // Grows the bin. Rectangles that have already been allocated keep their positions.
+    void resize(T width_, T height_) {
+        assert(width_ >= width && height_ >= height);
+        width = width_;
+        height = height_;
+    }
+
+private:
+    void removeLastShelf() {
+        auto it = std::prev(shelves.end());
+        auto range = shelvesByHeight.equal_range(it->second.h);
+        for (auto s = range.first; s != range.second; ++s) {
+            if (s->second == it->first) {
+                shelvesByHeight.erase(s);
+                break;
+            }
+        }
+        bottom = it->first;
+        shelves.erase(it);
+    }
+
+    struct Shelf {
+        T y = 0;
+        T h = 0;
+
+        // Start of the free space at the right end of the shelf.
+        T x = 0;
+
+        // Number of allocated rectangles on the shelf.
+        std::size_t count = 0;
+    };
+
+    T width;
+    T height;
+
+    // Top of the free space below the last shelf.
+    T bottom = 0;
+
+    // By their top edge.
+    std::map<T, Shelf> shelves;
+    std::multimap<T, T> shelvesByHeight;
+
+    // Rectangles that have been released from shelves still in use, by their width and height.
+    std::map<std::pair<T, T>, std::vector<Rect<T>>> released;
+};
+
+} // namespace mbgl
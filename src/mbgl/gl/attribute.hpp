@@ -13,27 +13,50 @@
 namespace mbgl {
 namespace gl {
 
+// Mixes a value into a hash of attribute bindings, with the finalizer of SplitMix64, so that
+// bindings which differ in any of their values are all but certain to differ in their hash.
+inline uint64_t hashCombine(uint64_t seed, uint64_t value) {
+    uint64_t z = seed ^ (value + 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
 template <class T, std::size_t N>
 class VariableAttributeBinding {
 public:
+    // A non-zero divisor advances the attribute once per that many instances of an instanced
+    // draw, rather than once per vertex.
     VariableAttributeBinding(BufferID vertexBuffer_,
                              std::size_t vertexSize_,
                              std::size_t attributeOffset_,
-                             std::size_t attributeSize_ = N)
+                             std::size_t attributeSize_ = N,
+                             uint32_t divisor_ = 0)
         : vertexBuffer(vertexBuffer_),
           vertexSize(vertexSize_),
           attributeOffset(attributeOffset_),
-          attributeSize(attributeSize_)
+          attributeSize(attributeSize_),
+          divisor(divisor_)
         {}
 
-    void bind(Context&, AttributeLocation, optional<VariableAttributeBinding<T, N>>&, std::size_t vertexOffset) const;
+    void bind(Context&, AttributeLocation, std::size_t vertexOffset) const;
+    void setValue(AttributeLocation) const {}
+
+    uint64_t hash(uint64_t seed) const {
+        seed = hashCombine(seed, vertexBuffer);
+        seed = hashCombine(seed, vertexSize);
+        seed = hashCombine(seed, attributeOffset);
+        seed = hashCombine(seed, attributeSize);
+        return hashCombine(seed, divisor);
+    }
 
     friend bool operator==(const VariableAttributeBinding& lhs,
                            const VariableAttributeBinding& rhs) {
         return lhs.vertexBuffer == rhs.vertexBuffer
             && lhs.vertexSize == rhs.vertexSize
             && lhs.attributeOffset == rhs.attributeOffset
-            && lhs.attributeSize == rhs.attributeSize;
+            && lhs.attributeSize == rhs.attributeSize
+            && lhs.divisor == rhs.divisor;
     }
 
 private:
@@ -41,6 +64,7 @@ private:
     std::size_t vertexSize;
     std::size_t attributeOffset;
     std::size_t attributeSize;
+    uint32_t divisor;
 };
 
 template <class T, std::size_t N>
@@ -52,7 +76,15 @@ public:
         : value(std::move(value_))
         {}
 
-    void bind(Context&, AttributeLocation, optional<VariableAttributeBinding<T, N>>&, std::size_t) const;
+    // Disables the vertex array of the attribute, which is state of the vertex array object,
+    // while setValue() sets the value, which isn't.
+    void bind(Context&, AttributeLocation, std::size_t) const;
+    void setValue(AttributeLocation) const;
+
+    // The value isn't part of the hash, since it is set for every draw.
+    uint64_t hash(uint64_t seed) const {
+        return hashCombine(seed, N);
+    }
 
     friend bool operator==(const ConstantAttributeBinding& lhs,
                            const ConstantAttributeBinding& rhs) {
@@ -93,23 +125,37 @@ public:
     template <class Vertex, class DrawMode>
     static VariableBinding variableBinding(const VertexBuffer<Vertex, DrawMode>& buffer,
                                            std::size_t attributeIndex,
-                                           std::size_t attributeSize = N) {
+                                           std::size_t attributeSize = N,
+                                           uint32_t divisor = 0) {
         static_assert(std::is_standard_layout<Vertex>::value, "vertex type must use standard layout");
         return VariableBinding {
-            buffer.buffer,
+            *buffer.buffer,
             sizeof(Vertex),
-            Vertex::attributeOffsets[attributeIndex],
-            attributeSize
+            buffer.byteOffset + Vertex::attributeOffsets[attributeIndex],
+            attributeSize,
+            divisor
         };
     }
 
     static void bind(Context& context,
                      const Location& location,
-                     optional<VariableBinding>& oldBinding,
-                     const Binding& newBinding,
+                     const Binding& binding,
                      std::size_t vertexOffset) {
-        Binding::visit(newBinding, [&] (const auto& binding) {
-            binding.bind(context, location, oldBinding, vertexOffset);
+        Binding::visit(binding, [&] (const auto& b) {
+            b.bind(context, location, vertexOffset);
+        });
+    }
+
+    static void setValue(const Location& location, const Binding& binding) {
+        Binding::visit(binding, [&] (const auto& b) {
+            b.setValue(location);
+        });
+    }
+
+    static uint64_t hash(uint64_t seed, const Location& location, const Binding& binding) {
+        seed = hashCombine(hashCombine(seed, location), binding.which());
+        return Binding::visit(binding, [&] (const auto& b) {
+            return b.hash(seed);
         });
     }
 };
@@ -242,9 +288,6 @@ public:
     using Bindings = IndexedTuple<
         TypeList<As...>,
         TypeList<typename As::Type::Binding...>>;
-    using VariableBindings = IndexedTuple<
-        TypeList<As...>,
-        TypeList<optional<typename As::Type::VariableBinding>...>>;
     using NamedLocations = std::vector<std::pair<const std::string, AttributeLocation>>;
 
     using Vertex = detail::Vertex<typename As::Type...>;
@@ -270,17 +313,39 @@ public:
         return Bindings { As::Type::variableBinding(buffer, Index<As>)... };
     }
 
+    // Binds the buffer's vertices to the attributes one per instance, for instanced draws.
+    template <class DrawMode>
+    static Bindings allInstanceBindings(const VertexBuffer<Vertex, DrawMode>& buffer) {
+        return Bindings { As::Type::variableBinding(buffer, Index<As>, As::Type::Dimensions, 1)... };
+    }
+
+    // Binds the vertex arrays of the attributes, and disables those of the constant ones.
     static void bind(Context& context,
                      const Locations& locations,
-                     VariableBindings& oldBindings,
-                     const Bindings& newBindings,
+                     const Bindings& bindings,
                      std::size_t vertexOffset) {
         util::ignore({ (As::Type::bind(context,
                                        locations.template get<As>(),
-                                       oldBindings.template get<As>(),
-                                       newBindings.template get<As>(),
+                                       bindings.template get<As>(),
                                        vertexOffset), 0)... });
     }
+
+    // Sets the values of the constant attributes, which are kept by the context rather than by
+    // vertex array objects, and so are set once for all the segments of a draw.
+    static void setValues(const Locations& locations, const Bindings& bindings) {
+        util::ignore({ (As::Type::setValue(locations.template get<As>(),
+                                           bindings.template get<As>()), 0)... });
+    }
+
+    // Hashes the locations and bindings of the attributes, once for all the segments of a draw,
+    // which bind them again only if it differs from the one they were last bound with.
+    static uint64_t hash(const Locations& locations, const Bindings& bindings) {
+        uint64_t seed = 0;
+        util::ignore({ (seed = As::Type::hash(seed,
+                                              locations.template get<As>(),
+                                              bindings.template get<As>()), 0)... });
+        return seed;
+    }
 };
 
 namespace detail {
@@ -0,0 +1,60 @@
+#include <mbgl/gl/buffer_arena.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+namespace gl {
+
+// Offsets are aligned so that any attribute type can start at them.
+static constexpr std::size_t alignment = 16;
+
+// Pages double in size up to the maximum, so that tiles with little data don't reserve a lot
+// of memory. Vectors larger than half a page get a buffer of their own.
+static constexpr std::size_t minimumPageSize = 32 * 1024;
+static constexpr std::size_t maximumPageSize = 1024 * 1024;
+
+template <class CreateBuffer>
+std::size_t BufferArena::reserve(Page& page, std::size_t size, CreateBuffer&& createBuffer) {
+    std::size_t offset = (page.used + alignment - 1) / alignment * alignment;
+    if (!page.buffer || offset + size > page.size) {
+        page.size = std::max(std::min(page.size * 2, maximumPageSize), minimumPageSize);
+        page.buffer = std::make_shared<UniqueBuffer>(createBuffer(page.size));
+        offset = 0;
+    }
+    page.used = offset + size;
+    return offset;
+}
+
+BufferRange BufferArena::allocateVertices(Context& context, const void* data, std::size_t size) {
+    if (size > maximumPageSize / 2) {
+        return { std::make_shared<UniqueBuffer>(context.createVertexBuffer(data, size)), 0 };
+    }
+
+    const std::size_t offset = reserve(vertexPage, size, [&] (std::size_t pageSize) {
+        return context.createVertexBuffer(nullptr, pageSize);
+    });
+
+    context.vertexBuffer = *vertexPage.buffer;
+    MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+    return { vertexPage.buffer, offset };
+}
+
+BufferRange BufferArena::allocateIndices(Context& context, const void* data, std::size_t size) {
+    if (size > maximumPageSize / 2) {
+        return { std::make_shared<UniqueBuffer>(context.createIndexBuffer(data, size)), 0 };
+    }
+
+    const std::size_t offset = reserve(indexPage, size, [&] (std::size_t pageSize) {
+        return context.createIndexBuffer(nullptr, pageSize);
+    });
+
+    context.vertexArrayObject = 0;
+    context.elementBuffer = *indexPage.buffer;
+    MBGL_CHECK_ERROR(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, size, data));
+    return { indexPage.buffer, offset };
+}
+
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <mbgl/gl/object.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+
+namespace mbgl {
+namespace gl {
+
+class Context;
+
+class BufferRange {
+public:
+    SharedBuffer buffer;
+    std::size_t offset;
+};
+
+// Suballocates vertex and index buffers from a few large GL buffers, so that the buckets of a
+// tile share buffer objects instead of creating one per vertex or index vector. Space is never
+// reused; a page is deleted once no buffer allocated from it remains. Install an arena with
+// Context::bufferArena while uploading.
+class BufferArena : private util::noncopyable {
+public:
+    BufferRange allocateVertices(Context&, const void* data, std::size_t size);
+    BufferRange allocateIndices(Context&, const void* data, std::size_t size);
+
+    // Stops allocating from the current pages, so that they are deleted as soon as the buffers
+    // allocated from them are, rather than once the arena is.
+    void release() {
+        vertexPage = Page();
+        indexPage = Page();
+    }
+
+private:
+    class Page {
+    public:
+        SharedBuffer buffer;
+        std::size_t size = 0;
+        std::size_t used = 0;
+    };
+
+    // Returns the offset of a range of the given size in the page, starting a new page if the
+    // current one is too full.
+    template <class CreateBuffer>
+    std::size_t reserve(Page&, std::size_t size, CreateBuffer&&);
+
+    Page vertexPage;
+    Page indexPage;
+};
+
+} // namespace gl
+} // namespace mbgl
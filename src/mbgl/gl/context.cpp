@@ -3,13 +3,24 @@
 #include <mbgl/gl/gl.hpp>
 #include <mbgl/gl/debugging_extension.hpp>
 #include <mbgl/gl/vertex_array_extension.hpp>
+#include <mbgl/gl/timer_query_extension.hpp>
+#include <mbgl/gl/instancing_extension.hpp>
 #include <mbgl/gl/program_binary_extension.hpp>
+#include <mbgl/gl/pixel_buffer_extension.hpp>
+#include <mbgl/gl/multisample_extension.hpp>
+#include <mbgl/gl/parallel_shader_compile_extension.hpp>
+#include <mbgl/util/compressed_image.hpp>
 #include <mbgl/util/traits.hpp>
 #include <mbgl/util/std.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <algorithm>
 #include <cstring>
 
+#if not MBGL_USE_GLES2 && !defined(GL_RGBA16F_ARB)
+#define GL_RGBA16F_ARB 0x881A
+#endif
+
 namespace mbgl {
 namespace gl {
 
@@ -36,6 +47,13 @@ static_assert(std::is_same<std::underlying_type_t<TextureFormat>, GLenum>::value
 static_assert(underlying_type(TextureFormat::RGBA) == GL_RGBA, "OpenGL type mismatch");
 static_assert(underlying_type(TextureFormat::Alpha) == GL_ALPHA, "OpenGL type mismatch");
 
+static_assert(std::is_same<std::underlying_type_t<IndexType>, GLenum>::value, "OpenGL type mismatch");
+static_assert(underlying_type(IndexType::UnsignedShort) == GL_UNSIGNED_SHORT, "OpenGL type mismatch");
+static_assert(underlying_type(IndexType::UnsignedInt) == GL_UNSIGNED_INT, "OpenGL type mismatch");
+
+static_assert(std::is_same<std::underlying_type_t<TextureType>, GLenum>::value, "OpenGL type mismatch");
+static_assert(underlying_type(TextureType::UnsignedByte) == GL_UNSIGNED_BYTE, "OpenGL type mismatch");
+
 static_assert(std::is_same<BinaryProgramFormat, GLenum>::value, "OpenGL type mismatch");
 
 Context::Context() = default;
@@ -64,10 +82,44 @@ void Context::initializeExtensions(const std::function<gl::ProcAddress(const cha
         if (!disableVAOExtension) {
             vertexArray = std::make_unique<extension::VertexArray>(fn);
         }
+        timerQuery = std::make_unique<extension::TimerQuery>(fn);
+        if (!timerQuery->supported()) {
+            timerQuery.reset();
+        }
+        instancedArrays = std::make_unique<extension::InstancedArrays>(fn);
+        if (!instancedArrays->supported()) {
+            instancedArrays.reset();
+        }
+        pixelBuffer = std::make_unique<extension::PixelBuffer>(fn);
+        if (!pixelBuffer->supported()) {
+            pixelBuffer.reset();
+        }
+        multisample = std::make_unique<extension::Multisample>(fn);
+        if (!multisample->supported()) {
+            multisample.reset();
+        }
+        parallelShaderCompile = std::make_unique<extension::ParallelShaderCompile>(fn);
+        if (parallelShaderCompile->supported()) {
+            // Lets the driver choose how many threads it compiles with.
+            MBGL_CHECK_ERROR(parallelShaderCompile->maxShaderCompilerThreads(0xFFFFFFFF));
+        } else {
+            parallelShaderCompile.reset();
+        }
 #if MBGL_HAS_BINARY_PROGRAMS
         programBinary = std::make_unique<extension::ProgramBinary>(fn);
 #endif
 
+#if MBGL_USE_GLES2
+        halfFloatTextures = strstr(extensions, "GL_OES_texture_half_float") != nullptr &&
+                            strstr(extensions, "GL_OES_texture_half_float_linear") != nullptr &&
+                            strstr(extensions, "GL_EXT_color_buffer_half_float") != nullptr;
+        uint32Indices = strstr(extensions, "GL_OES_element_index_uint") != nullptr;
+#else
+        halfFloatTextures = strstr(extensions, "GL_ARB_texture_float") != nullptr;
+        // Desktop OpenGL has always drawn unsigned int indices.
+        uint32Indices = true;
+#endif // MBGL_USE_GLES2
+
         if (!supportsVertexArrays()) {
             Log::Warning(Event::OpenGL, "Not using Vertex Array Objects");
         }
@@ -98,17 +150,21 @@ UniqueShader Context::createShader(ShaderType type, const std::string& source) {
     MBGL_CHECK_ERROR(glShaderSource(result, 1, &sources, &lengths));
     MBGL_CHECK_ERROR(glCompileShader(result));
 
+    return result;
+}
+
+void Context::verifyShaderCompilation(ShaderID shader) {
     GLint status = 0;
-    MBGL_CHECK_ERROR(glGetShaderiv(result, GL_COMPILE_STATUS, &status));
+    MBGL_CHECK_ERROR(glGetShaderiv(shader, GL_COMPILE_STATUS, &status));
     if (status != 0) {
-        return result;
+        return;
     }
 
     GLint logLength;
-    MBGL_CHECK_ERROR(glGetShaderiv(result, GL_INFO_LOG_LENGTH, &logLength));
+    MBGL_CHECK_ERROR(glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength));
     if (logLength > 0) {
         const auto log = std::make_unique<GLchar[]>(logLength);
-        MBGL_CHECK_ERROR(glGetShaderInfoLog(result, logLength, &logLength, log.get()));
+        MBGL_CHECK_ERROR(glGetShaderInfoLog(shader, logLength, &logLength, log.get()));
         Log::Error(Event::Shader, "Shader failed to compile: %s", log.get());
     }
 
@@ -143,7 +199,19 @@ UniqueProgram Context::createProgram(BinaryProgramFormat, const std::string&) {
 
 void Context::linkProgram(ProgramID program_) {
     MBGL_CHECK_ERROR(glLinkProgram(program_));
-    verifyProgramLinkage(program_);
+}
+
+bool Context::supportsParallelShaderCompile() const {
+    return bool(parallelShaderCompile);
+}
+
+bool Context::isProgramLinkComplete(ProgramID program_) const {
+    if (!parallelShaderCompile) {
+        return true;
+    }
+    GLint complete = GL_FALSE;
+    MBGL_CHECK_ERROR(glGetProgramiv(program_, GL_COMPLETION_STATUS_KHR, &complete));
+    return complete == GL_TRUE;
 }
 
 void Context::verifyProgramLinkage(ProgramID program_) {
@@ -164,15 +232,35 @@ void Context::verifyProgramLinkage(ProgramID program_) {
     throw std::runtime_error("program failed to link");
 }
 
+BufferRange Context::allocateVertexBuffer(const void* data, std::size_t size) {
+    if (bufferArena) {
+        return bufferArena->allocateVertices(*this, data, size);
+    }
+    return { std::make_shared<UniqueBuffer>(createVertexBuffer(data, size)), 0 };
+}
+
+BufferRange Context::allocateIndexBuffer(const void* data, std::size_t size) {
+    if (bufferArena) {
+        return bufferArena->allocateIndices(*this, data, size);
+    }
+    return { std::make_shared<UniqueBuffer>(createIndexBuffer(data, size)), 0 };
+}
+
 UniqueBuffer Context::createVertexBuffer(const void* data, std::size_t size) {
     BufferID id = 0;
     MBGL_CHECK_ERROR(glGenBuffers(1, &id));
     UniqueBuffer result { std::move(id), { this } };
     vertexBuffer = result;
     MBGL_CHECK_ERROR(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+    track(bufferBytes, result.get(), size);
     return result;
 }
 
+void Context::updateVertexBuffer(const UniqueBuffer& buffer, std::size_t offset, const void* data, std::size_t size) {
+    vertexBuffer = buffer.get();
+    MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
+
 UniqueBuffer Context::createIndexBuffer(const void* data, std::size_t size) {
     BufferID id = 0;
     MBGL_CHECK_ERROR(glGenBuffers(1, &id));
@@ -180,9 +268,16 @@ UniqueBuffer Context::createIndexBuffer(const void* data, std::size_t size) {
     vertexArrayObject = 0;
     elementBuffer = result;
     MBGL_CHECK_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+    track(bufferBytes, result.get(), size);
     return result;
 }
 
+void Context::updateIndexBuffer(const UniqueBuffer& buffer, std::size_t offset, const void* data, std::size_t size) {
+    vertexArrayObject = 0;
+    elementBuffer = buffer.get();
+    MBGL_CHECK_ERROR(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, size, data));
+}
+
 UniqueTexture Context::createTexture() {
     if (pooledTextures.empty()) {
         pooledTextures.resize(TextureMax);
@@ -201,6 +296,15 @@ bool Context::supportsVertexArrays() const {
            vertexArray->deleteVertexArrays;
 }
 
+bool Context::supportsInstancing() const {
+    return instancedArrays && supportsVertexArrays();
+}
+
+void Context::vertexAttribDivisor(AttributeLocation location, uint32_t divisor) {
+    assert(supportsInstancing());
+    MBGL_CHECK_ERROR(instancedArrays->vertexAttribDivisor(location, divisor));
+}
+
 #if MBGL_HAS_BINARY_PROGRAMS
 bool Context::supportsProgramBinaries() const {
     return programBinary && programBinary->programBinary && programBinary->getProgramBinary;
@@ -223,12 +327,42 @@ Context::getBinaryProgram(ProgramID program_) const {
     }
     return { { binaryFormat, std::move(binary) } };
 }
+
+std::vector<BinaryProgramFormat> Context::getBinaryProgramFormats() const {
+    if (!supportsProgramBinaries()) {
+        return {};
+    }
+    GLint count = 0;
+    MBGL_CHECK_ERROR(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count));
+    std::vector<GLint> formats(count);
+    if (count > 0) {
+        MBGL_CHECK_ERROR(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data()));
+    }
+    return { formats.begin(), formats.end() };
+}
 #else
 optional<std::pair<BinaryProgramFormat, std::string>> Context::getBinaryProgram(ProgramID) const {
     return {};
 }
+
+std::vector<BinaryProgramFormat> Context::getBinaryProgramFormats() const {
+    return {};
+}
 #endif
 
+std::string Context::getDriverIdentifier() const {
+    std::string result;
+    for (const GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        if (const char* value = reinterpret_cast<const char*>(MBGL_CHECK_ERROR(glGetString(name)))) {
+            if (!result.empty()) {
+                result += '\n';
+            }
+            result += value;
+        }
+    }
+    return result;
+}
+
 UniqueVertexArray Context::createVertexArray() {
     assert(supportsVertexArrays());
     VertexArrayID id = 0;
@@ -242,17 +376,51 @@ UniqueFramebuffer Context::createFramebuffer() {
     return UniqueFramebuffer{ std::move(id), { this } };
 }
 
-UniqueRenderbuffer Context::createRenderbuffer(const RenderbufferType type, const Size size) {
+UniqueRenderbuffer Context::createRenderbuffer(const RenderbufferType type, const Size size, const uint32_t samples) {
     RenderbufferID id = 0;
     MBGL_CHECK_ERROR(glGenRenderbuffers(1, &id));
     UniqueRenderbuffer renderbuffer{ std::move(id), { this } };
 
     bindRenderbuffer = renderbuffer;
-    MBGL_CHECK_ERROR(
-        glRenderbufferStorage(GL_RENDERBUFFER, static_cast<GLenum>(type), size.width, size.height));
+    if (samples > 1) {
+        assert(multisample && samples <= getMaxSamples());
+        MBGL_CHECK_ERROR(multisample->renderbufferStorageMultisample(
+            GL_RENDERBUFFER, samples, static_cast<GLenum>(type), size.width, size.height));
+    } else {
+        MBGL_CHECK_ERROR(
+            glRenderbufferStorage(GL_RENDERBUFFER, static_cast<GLenum>(type), size.width, size.height));
+    }
+    // Both types take four bytes per sample.
+    track(renderbufferBytes, renderbuffer.get(), std::size_t(size.area()) * 4 * std::max(samples, 1u));
     return renderbuffer;
 }
 
+uint32_t Context::getMaxSamples() {
+    if (!maxSamples) {
+        GLint samples = 0;
+        if (multisample) {
+            MBGL_CHECK_ERROR(glGetIntegerv(GL_MAX_SAMPLES_EXT, &samples));
+        }
+        maxSamples = uint32_t(std::max(samples, 0));
+    }
+    return *maxSamples;
+}
+
+void Context::resolveFramebuffer(const Framebuffer& multisampled, const Framebuffer& target) {
+    assert(multisample && multisampled.size == target.size);
+    MBGL_CHECK_ERROR(glBindFramebuffer(GL_READ_FRAMEBUFFER_EXT, multisampled.framebuffer));
+    MBGL_CHECK_ERROR(glBindFramebuffer(GL_DRAW_FRAMEBUFFER_EXT, target.framebuffer));
+    const auto width = GLint(target.size.width);
+    const auto height = GLint(target.size.height);
+    MBGL_CHECK_ERROR(multisample->blitFramebuffer(0, 0, width, height, 0, 0, width, height,
+                                                  GL_COLOR_BUFFER_BIT, GL_NEAREST));
+
+    // The read binding changed behind the back of the tracked state, so the target is bound
+    // for both again.
+    bindFramebuffer.setDirty();
+    bindFramebuffer = target.framebuffer;
+}
+
 std::unique_ptr<uint8_t[]> Context::readFramebuffer(const Size size, const TextureFormat format, const bool flip) {
     const size_t stride = size.width * (format == TextureFormat::RGBA ? 4 : 1);
     auto data = std::make_unique<uint8_t[]>(stride * size.height);
@@ -279,6 +447,12 @@ std::unique_ptr<uint8_t[]> Context::readFramebuffer(const Size size, const Textu
     return data;
 }
 
+std::array<uint8_t, 4> Context::readPixel(const uint32_t x, const uint32_t y) {
+    std::array<uint8_t, 4> pixel;
+    MBGL_CHECK_ERROR(glReadPixels(x, y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel.data()));
+    return pixel;
+}
+
 #if not MBGL_USE_GLES2
 void Context::drawPixels(const Size size, const void* data, TextureFormat format) {
     pixelStoreUnpack = { 1 };
@@ -384,10 +558,10 @@ Framebuffer Context::createFramebuffer(const Texture& color) {
     return { color.size, std::move(fbo) };
 }
 
-UniqueTexture
-Context::createTexture(const Size size, const void* data, TextureFormat format, TextureUnit unit) {
+UniqueTexture Context::createTexture(
+    const Size size, const void* data, TextureFormat format, TextureUnit unit, TextureType type) {
     auto obj = createTexture();
-    updateTexture(obj, size, data, format, unit);
+    updateTexture(obj, size, data, format, unit, type);
     // We are using clamp to edge here since OpenGL ES doesn't allow GL_REPEAT on NPOT textures.
     // We use those when the pixelRatio isn't a power of two, e.g. on iPhone 6 Plus.
     MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
@@ -397,13 +571,85 @@ Context::createTexture(const Size size, const void* data, TextureFormat format,
     return obj;
 }
 
-void Context::updateTexture(
-    TextureID id, const Size size, const void* data, TextureFormat format, TextureUnit unit) {
+bool Context::supportsCompressedTextureFormat(const uint32_t format) {
+    if (!compressedTextureFormats) {
+        GLint count = 0;
+        MBGL_CHECK_ERROR(glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count));
+        std::vector<GLint> formats(count);
+        if (count > 0) {
+            MBGL_CHECK_ERROR(glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data()));
+        }
+        compressedTextureFormats = std::vector<uint32_t>(formats.begin(), formats.end());
+    }
+    return std::find(compressedTextureFormats->begin(), compressedTextureFormats->end(), format) !=
+           compressedTextureFormats->end();
+}
+
+Texture Context::createTexture(const CompressedImage& image, TextureUnit unit) {
+    assert(supportsCompressedTextureFormat(image.format));
+    auto obj = createTexture();
+    activeTexture = unit;
+    texture[unit] = obj;
+    MBGL_CHECK_ERROR(glCompressedTexImage2D(GL_TEXTURE_2D, 0, image.format, image.size.width,
+                                            image.size.height, 0, image.bytes, image.data.get()));
+    track(textureBytes, obj.get(), image.bytes);
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    return { image.size, std::move(obj) };
+}
+
+void Context::updateTexture(TextureID id,
+                            const Size size,
+                            const void* data,
+                            TextureFormat format,
+                            TextureUnit unit,
+                            TextureType type) {
     activeTexture = unit;
     texture[unit] = id;
-    MBGL_CHECK_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLenum>(format), size.width,
-                                  size.height, 0, static_cast<GLenum>(format), GL_UNSIGNED_BYTE,
-                                  data));
+    GLint internalFormat = static_cast<GLenum>(format);
+#if not MBGL_USE_GLES2
+    // Desktop OpenGL only keeps half floats when the internal format asks for them.
+    if (type == TextureType::HalfFloat) {
+        assert(format == TextureFormat::RGBA);
+        internalFormat = GL_RGBA16F_ARB;
+    }
+#endif // MBGL_USE_GLES2
+    MBGL_CHECK_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, size.width, size.height, 0,
+                                  static_cast<GLenum>(format), static_cast<GLenum>(type), data));
+    const std::size_t channels = format == TextureFormat::RGBA ? 4 : 1;
+    const std::size_t channelBytes = type == TextureType::HalfFloat ? 2 : 1;
+    track(textureBytes, id, std::size_t(size.area()) * channels * channelBytes);
+}
+
+void Context::updateTextureSubImage(TextureID id,
+                                    const uint32_t x,
+                                    const uint32_t y,
+                                    const Size size,
+                                    const void* data,
+                                    TextureFormat format,
+                                    TextureUnit unit) {
+    activeTexture = unit;
+    texture[unit] = id;
+    MBGL_CHECK_ERROR(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, size.width, size.height,
+                                     static_cast<GLenum>(format), GL_UNSIGNED_BYTE, data));
+}
+
+bool Context::supportsMipmaps(const Size size) const {
+#if MBGL_USE_GLES2
+    return !size.isEmpty() && (size.width & (size.width - 1)) == 0 && (size.height & (size.height - 1)) == 0;
+#else
+    return !size.isEmpty();
+#endif // MBGL_USE_GLES2
+}
+
+void Context::generateMipmap(Texture& obj, TextureUnit unit) {
+    assert(supportsMipmaps(obj.size));
+    activeTexture = unit;
+    texture[unit] = obj.texture;
+    MBGL_CHECK_ERROR(glGenerateMipmap(GL_TEXTURE_2D));
+    obj.mipmapped = true;
 }
 
 void Context::bindTexture(Texture& obj,
@@ -458,25 +704,61 @@ void Context::reset() {
 void Context::setDirtyState() {
     // Note: does not set viewport/bindFramebuffer to dirty since they are handled separately in
     // the view object.
-    stencilFunc.setDirty();
-    stencilMask.setDirty();
-    stencilTest.setDirty();
-    stencilOp.setDirty();
+    setDirtyDepthState();
+    setDirtyStencilState();
+    setDirtyColorState();
+    setDirtyScissorState();
+    setDirtyBufferState();
+    setDirtyTextureState();
+    setDirtyOtherState();
+    program.setDirty();
+}
+
+void Context::setDirtyDepthState() {
     depthRange.setDirty();
     depthMask.setDirty();
     depthTest.setDirty();
     depthFunc.setDirty();
+}
+
+void Context::setDirtyStencilState() {
+    stencilFunc.setDirty();
+    stencilMask.setDirty();
+    stencilTest.setDirty();
+    stencilOp.setDirty();
+}
+
+void Context::setDirtyColorState() {
     blend.setDirty();
     blendEquation.setDirty();
     blendFunc.setDirty();
     blendColor.setDirty();
     colorMask.setDirty();
+}
+
+void Context::setDirtyScissorState() {
+    scissorTest.setDirty();
+    scissor.setDirty();
+}
+
+void Context::setDirtyBufferState() {
+    vertexBuffer.setDirty();
+    elementBuffer.setDirty();
+    vertexArrayObject.setDirty();
+}
+
+void Context::setDirtyTextureState() {
+    activeTexture.setDirty();
+    for (auto& tex : texture) {
+       tex.setDirty();
+    }
+}
+
+void Context::setDirtyOtherState() {
     clearDepth.setDirty();
     clearColor.setDirty();
     clearStencil.setDirty();
-    program.setDirty();
     lineWidth.setDirty();
-    activeTexture.setDirty();
 #if not MBGL_USE_GLES2
     pointSize.setDirty();
     pixelZoom.setDirty();
@@ -486,12 +768,6 @@ void Context::setDirtyState() {
     pixelTransferDepth.setDirty();
     pixelTransferStencil.setDirty();
 #endif // MBGL_USE_GLES2
-    for (auto& tex : texture) {
-       tex.setDirty();
-    }
-    vertexBuffer.setDirty();
-    elementBuffer.setDirty();
-    vertexArrayObject.setDirty();
 }
 
 void Context::clear(optional<mbgl::Color> color,
@@ -583,13 +859,66 @@ void Context::setColorMode(const ColorMode& color) {
 }
 
 void Context::draw(PrimitiveType primitiveType,
+                   IndexType indexType,
                    std::size_t indexOffset,
                    std::size_t indexLength) {
+    const std::size_t indexSize = indexType == IndexType::UnsignedInt ? sizeof(uint32_t) : sizeof(uint16_t);
     MBGL_CHECK_ERROR(glDrawElements(
         static_cast<GLenum>(primitiveType),
         static_cast<GLsizei>(indexLength),
-        GL_UNSIGNED_SHORT,
-        reinterpret_cast<GLvoid*>(sizeof(uint16_t) * indexOffset)));
+        static_cast<GLenum>(indexType),
+        reinterpret_cast<GLvoid*>(indexSize * indexOffset)));
+    draws++;
+}
+
+void Context::drawInstanced(PrimitiveType primitiveType,
+                            IndexType indexType,
+                            std::size_t indexOffset,
+                            std::size_t indexLength,
+                            std::size_t instanceCount) {
+    assert(supportsInstancing());
+    const std::size_t indexSize = indexType == IndexType::UnsignedInt ? sizeof(uint32_t) : sizeof(uint16_t);
+    MBGL_CHECK_ERROR(instancedArrays->drawElementsInstanced(
+        static_cast<GLenum>(primitiveType),
+        static_cast<GLsizei>(indexLength),
+        static_cast<GLenum>(indexType),
+        reinterpret_cast<GLvoid*>(indexSize * indexOffset),
+        static_cast<GLsizei>(instanceCount)));
+    draws++;
+}
+
+Context::Stats Context::Stats::operator-(const Stats& other) const {
+    Stats result;
+    result.draws = draws - other.draws;
+    result.programSwitches = programSwitches - other.programSwitches;
+    result.textureBinds = textureBinds - other.textureBinds;
+    result.vertexArrayBinds = vertexArrayBinds - other.vertexArrayBinds;
+    return result;
+}
+
+Context::Stats Context::getStats() const {
+    Stats result;
+    result.draws = draws;
+    result.programSwitches = program.getChangeCount();
+    for (const auto& unit : texture) {
+        result.textureBinds += unit.getChangeCount();
+    }
+    result.vertexArrayBinds = vertexArrayObject.getChangeCount();
+    return result;
+}
+
+void Context::track(ObjectBytes& objects, const uint32_t id, const std::size_t bytes) {
+    std::size_t& tracked = objects[id];
+    memoryUsage = memoryUsage - tracked + bytes;
+    tracked = bytes;
+}
+
+void Context::untrack(ObjectBytes& objects, const uint32_t id) {
+    auto it = objects.find(id);
+    if (it != objects.end()) {
+        memoryUsage -= it->second;
+        objects.erase(it);
+    }
 }
 
 void Context::performCleanup() {
@@ -9,23 +9,28 @@
 #include <mbgl/gl/framebuffer.hpp>
 #include <mbgl/gl/vertex_buffer.hpp>
 #include <mbgl/gl/index_buffer.hpp>
+#include <mbgl/gl/buffer_arena.hpp>
 #include <mbgl/gl/types.hpp>
 #include <mbgl/gl/draw_mode.hpp>
 #include <mbgl/gl/depth_mode.hpp>
 #include <mbgl/gl/stencil_mode.hpp>
 #include <mbgl/gl/color_mode.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
 
 
+#include <cassert>
 #include <functional>
 #include <memory>
 #include <vector>
 #include <array>
 #include <string>
+#include <unordered_map>
 
 namespace mbgl {
 
 class View;
+class CompressedImage;
 
 namespace gl {
 
@@ -35,7 +40,12 @@ using ProcAddress = void (*)();
 namespace extension {
 class VertexArray;
 class Debugging;
+class TimerQuery;
+class InstancedArrays;
+class PixelBuffer;
+class Multisample;
 class ProgramBinary;
+class ParallelShaderCompile;
 } // namespace extension
 
 class Context : private util::noncopyable {
@@ -47,38 +57,106 @@ public:
 
     void enableDebugging();
 
+    // Compiling and linking don't check their results, so that contexts that support
+    // KHR_parallel_shader_compile can do them in the background. The verify functions wait for
+    // them, and throw if they failed.
     UniqueShader createShader(ShaderType type, const std::string& source);
     UniqueProgram createProgram(ShaderID vertexShader, ShaderID fragmentShader);
     UniqueProgram createProgram(BinaryProgramFormat binaryFormat, const std::string& binaryProgram);
+    void verifyShaderCompilation(ShaderID);
     void verifyProgramLinkage(ProgramID);
     void linkProgram(ProgramID);
+
+    bool supportsParallelShaderCompile() const;
+
+    // Whether verifying the linkage of the program would return without waiting for it.
+    bool isProgramLinkComplete(ProgramID) const;
     UniqueTexture createTexture();
 
     bool supportsVertexArrays() const;
     UniqueVertexArray createVertexArray();
 
+    // Instanced draws are only made with vertex array objects, which keep the divisors of their
+    // attributes to themselves: attributes of other draws never advance per instance by accident.
+    bool supportsInstancing() const;
+    void vertexAttribDivisor(AttributeLocation, uint32_t divisor);
+
 #if MBGL_HAS_BINARY_PROGRAMS
     bool supportsProgramBinaries() const;
 #else
     constexpr bool supportsProgramBinaries() const { return false; }
 #endif
     optional<std::pair<BinaryProgramFormat, std::string>> getBinaryProgram(ProgramID) const;
+    std::vector<BinaryProgramFormat> getBinaryProgramFormats() const;
+
+    // Identifies the GPU and driver version, since binary programs only load into contexts of
+    // the same driver.
+    std::string getDriverIdentifier() const;
 
     template <class Vertex, class DrawMode>
     VertexBuffer<Vertex, DrawMode> createVertexBuffer(VertexVector<Vertex, DrawMode>&& v) {
+        BufferRange range = allocateVertexBuffer(v.data(), v.byteSize());
         return VertexBuffer<Vertex, DrawMode> {
             v.vertexSize(),
-            createVertexBuffer(v.data(), v.byteSize())
+            std::move(range.buffer),
+            range.offset
         };
     }
 
+    // Replaces the vertices of a buffer with as many new ones.
+    template <class Vertex, class DrawMode>
+    void updateVertexBuffer(VertexBuffer<Vertex, DrawMode>& buffer, const VertexVector<Vertex, DrawMode>& v) {
+        assert(v.vertexSize() == buffer.vertexCount);
+        updateVertexBuffer(*buffer.buffer, buffer.byteOffset, v.data(), v.byteSize());
+    }
+
+    // Replaces `count` vertices of a buffer, starting at `first`, with those of a vector of the
+    // same size.
+    template <class Vertex, class DrawMode>
+    void updateVertexBuffer(VertexBuffer<Vertex, DrawMode>& buffer, const VertexVector<Vertex, DrawMode>& v,
+                            std::size_t first, std::size_t count) {
+        assert(v.vertexSize() == buffer.vertexCount);
+        assert(first + count <= buffer.vertexCount);
+        updateVertexBuffer(*buffer.buffer, buffer.byteOffset + first * sizeof(Vertex),
+                           v.data() + first, count * sizeof(Vertex));
+    }
+
     template <class DrawMode>
     IndexBuffer<DrawMode> createIndexBuffer(IndexVector<DrawMode>&& v) {
+        BufferRange range = allocateIndexBuffer(v.data(), v.byteSize());
         return IndexBuffer<DrawMode> {
-            createIndexBuffer(v.data(), v.byteSize())
+            v.indexSize(),
+            std::move(range.buffer),
+            range.offset
         };
     }
 
+    // Replaces the indices of a buffer with those of a vector of the same size.
+    template <class DrawMode>
+    void updateIndexBuffer(IndexBuffer<DrawMode>& buffer, const IndexVector<DrawMode>& v) {
+        assert(v.indexSize() == buffer.indexCount);
+        assert(buffer.type == IndexType::UnsignedShort);
+        updateIndexBuffer(*buffer.buffer, buffer.byteOffset, v.data(), v.byteSize());
+    }
+
+    // Uploads indices of 32 bits each. Requires supportsUint32Indices().
+    template <class DrawMode>
+    IndexBuffer<DrawMode> createIndexBuffer(const std::vector<uint32_t>& indices) {
+        assert(supportsUint32Indices());
+        BufferRange range = allocateIndexBuffer(indices.data(), indices.size() * sizeof(uint32_t));
+        return IndexBuffer<DrawMode> {
+            indices.size(),
+            std::move(range.buffer),
+            range.offset,
+            IndexType::UnsignedInt
+        };
+    }
+
+    // Whether index buffers may hold 32-bit indices, which address more than 65535 vertices.
+    bool supportsUint32Indices() const {
+        return uint32Indices;
+    }
+
     template <RenderbufferType type>
     Renderbuffer<type> createRenderbuffer(const Size size) {
         static_assert(type == RenderbufferType::RGBA || type == RenderbufferType::DepthStencil,
@@ -86,6 +164,23 @@ public:
         return { size, createRenderbuffer(type, size) };
     }
 
+    // Returns the largest number of samples of multisampled renderbuffers, or 0 if the context
+    // can't render into them.
+    uint32_t getMaxSamples();
+
+    // Multisampled renderbuffers need to be resolved into a framebuffer with single-sampled ones
+    // before they are read.
+    template <RenderbufferType type>
+    Renderbuffer<type> createRenderbuffer(const Size size, const uint32_t samples) {
+        static_assert(type == RenderbufferType::RGBA || type == RenderbufferType::DepthStencil,
+                      "invalid renderbuffer type");
+        return { size, createRenderbuffer(type, size, samples) };
+    }
+
+    // Resolves the color of a multisampled framebuffer into a single-sampled one of the same size,
+    // which is bound afterwards.
+    void resolveFramebuffer(const Framebuffer& multisampled, const Framebuffer& target);
+
     Framebuffer createFramebuffer(const Renderbuffer<RenderbufferType::RGBA>&,
                                   const Renderbuffer<RenderbufferType::DepthStencil>&);
     Framebuffer createFramebuffer(const Renderbuffer<RenderbufferType::RGBA>&);
@@ -102,6 +197,10 @@ public:
         return { size, readFramebuffer(size, format, flip) };
     }
 
+    // Reads the RGBA color of a single pixel of the bound framebuffer, whose rows are counted
+    // from the bottom.
+    std::array<uint8_t, 4> readPixel(uint32_t x, uint32_t y);
+
 #if not MBGL_USE_GLES2
     template <typename Image>
     void drawPixels(const Image& image) {
@@ -124,13 +223,45 @@ public:
         obj.size = image.size;
     }
 
+    // Replaces `rows` rows of the texture, starting at `top`, with those of an image of the
+    // same size. Whole rows are contiguous in memory, so they need no copy to be uploaded.
+    template <typename Image>
+    void updateTextureRows(Texture& obj, const Image& image, uint32_t top, uint32_t rows, TextureUnit unit = 0) {
+        assert(obj.size == image.size);
+        assert(top + rows <= image.size.height);
+        auto format = image.channels == 4 ? TextureFormat::RGBA : TextureFormat::Alpha;
+        updateTextureSubImage(obj.texture.get(), 0, top, { image.size.width, rows },
+                              image.data.get() + top * image.stride(), format, unit);
+    }
+
+    // Whether createTexture can upload images that are compressed in the format.
+    bool supportsCompressedTextureFormat(uint32_t format);
+
+    // Create a texture from an image that is compressed in a format that the context supports.
+    Texture createTexture(const CompressedImage&, TextureUnit unit = 0);
+
     // Creates an empty texture with the specified dimensions.
     Texture createTexture(const Size size,
                           TextureFormat format = TextureFormat::RGBA,
-                          TextureUnit unit = 0) {
-        return { size, createTexture(size, nullptr, format, unit) };
+                          TextureUnit unit = 0,
+                          TextureType type = TextureType::UnsignedByte) {
+        return { size, createTexture(size, nullptr, format, unit, type) };
+    }
+
+    // Whether RGBA textures of half floats can be created, rendered to with blending, and
+    // sampled with linear filtering.
+    bool supportsHalfFloatTextures() const {
+        return halfFloatTextures;
     }
 
+    // Whether generateMipmap can build the levels of a texture of this size. OpenGL ES 2 only
+    // mipmaps textures whose sides are powers of two.
+    bool supportsMipmaps(Size) const;
+
+    // Builds the smaller levels of the texture from its base level. Updating the texture
+    // afterwards leaves them stale.
+    void generateMipmap(Texture&, TextureUnit = 0);
+
     void bindTexture(Texture&,
                      TextureUnit = 0,
                      TextureFilter = TextureFilter::Nearest,
@@ -153,9 +284,17 @@ public:
     void setColorMode(const ColorMode&);
 
     void draw(PrimitiveType,
+              IndexType,
               std::size_t indexOffset,
               std::size_t indexLength);
 
+    // Draws the indexed primitives `instanceCount` times. Requires supportsInstancing().
+    void drawInstanced(PrimitiveType,
+                       IndexType,
+                       std::size_t indexOffset,
+                       std::size_t indexLength,
+                       std::size_t instanceCount);
+
     // Actually remove the objects we marked as abandoned with the above methods.
     // Only call this while the OpenGL context is exclusive to this thread.
     void performCleanup();
@@ -176,6 +315,63 @@ public:
 
     void setDirtyState();
 
+    // Mark groups of state dirty, for when code outside of this context changed only some of it.
+    void setDirtyDepthState();
+    void setDirtyStencilState();
+    void setDirtyColorState();
+    void setDirtyScissorState();
+    void setDirtyBufferState();
+    void setDirtyTextureState();
+    void setDirtyOtherState();
+
+    // Counts the OpenGL calls made through this context since it was created. Subtract two
+    // snapshots to measure a frame.
+    class Stats {
+    public:
+        std::size_t draws = 0;
+        std::size_t programSwitches = 0;
+        std::size_t textureBinds = 0;
+        std::size_t vertexArrayBinds = 0;
+
+        Stats operator-(const Stats&) const;
+    };
+
+    Stats getStats() const;
+
+    // Limits the bytes of the buffers, textures and renderbuffers that the context holds. The
+    // context only counts them, as they are created and abandoned; its owner releases objects
+    // while it is over budget. Zero, the default, means no limit.
+    void setMemoryBudget(std::size_t bytes) {
+        memoryBudget = bytes;
+    }
+
+    std::size_t getMemoryBudget() const {
+        return memoryBudget;
+    }
+
+    std::size_t getMemoryUsage() const {
+        return memoryUsage;
+    }
+
+    bool isOverBudget() const {
+        return memoryBudget && memoryUsage > memoryBudget;
+    }
+
+    // Returns the resource that users of the context share under the key, such as the programs
+    // of the maps that render to it, or the one that the function creates if no user holds it
+    // anymore. The context only keeps weak references, so a resource is released along with
+    // its last user.
+    template <class T, class Fn>
+    std::shared_ptr<T> getSharedResource(const std::string& key, Fn&& create) {
+        if (auto resource = sharedResources[key].lock()) {
+            return std::static_pointer_cast<T>(resource);
+        }
+        // The function may share other resources, which invalidates references into the map.
+        std::shared_ptr<T> resource = create();
+        sharedResources[key] = resource;
+        return resource;
+    }
+
     extension::Debugging* getDebuggingExtension() const {
         return debugging.get();
     }
@@ -184,9 +380,31 @@ public:
         return vertexArray.get();
     }
 
+    // Returns nullptr if the context doesn't support timer queries.
+    extension::TimerQuery* getTimerQueryExtension() const {
+        return timerQuery.get();
+    }
+
+    // Returns nullptr if the context can't read framebuffers into pixel pack buffers.
+    extension::PixelBuffer* getPixelBufferExtension() const {
+        return pixelBuffer.get();
+    }
+
+    // Returns nullptr if the context can't render into multisampled renderbuffers.
+    extension::Multisample* getMultisampleExtension() const {
+        return multisample.get();
+    }
+
 private:
+    std::unordered_map<std::string, std::weak_ptr<void>> sharedResources;
+
     std::unique_ptr<extension::Debugging> debugging;
     std::unique_ptr<extension::VertexArray> vertexArray;
+    std::unique_ptr<extension::TimerQuery> timerQuery;
+    std::unique_ptr<extension::InstancedArrays> instancedArrays;
+    std::unique_ptr<extension::PixelBuffer> pixelBuffer;
+    std::unique_ptr<extension::Multisample> multisample;
+    std::unique_ptr<extension::ParallelShaderCompile> parallelShaderCompile;
 #if MBGL_HAS_BINARY_PROGRAMS
     std::unique_ptr<extension::ProgramBinary> programBinary;
 #endif
@@ -195,12 +413,18 @@ public:
     State<value::ActiveTexture> activeTexture;
     State<value::BindFramebuffer> bindFramebuffer;
     State<value::Viewport> viewport;
+    State<value::ScissorTest> scissorTest;
+    State<value::Scissor> scissor;
     std::array<State<value::BindTexture>, 2> texture;
     State<value::BindVertexArray, const Context&> vertexArrayObject { *this };
     State<value::Program> program;
     State<value::BindVertexBuffer> vertexBuffer;
     State<value::BindElementBuffer> elementBuffer;
 
+    // While set, vertex and index buffers are allocated from this arena rather than getting
+    // buffer objects of their own.
+    BufferArena* bufferArena = nullptr;
+
 #if not MBGL_USE_GLES2
     State<value::PixelZoom> pixelZoom;
     State<value::RasterPos> rasterPos;
@@ -233,17 +457,23 @@ private:
     State<value::PointSize> pointSize;
 #endif // MBGL_USE_GLES2
 
+    BufferRange allocateVertexBuffer(const void* data, std::size_t size);
+    BufferRange allocateIndexBuffer(const void* data, std::size_t size);
     UniqueBuffer createVertexBuffer(const void* data, std::size_t size);
+    void updateVertexBuffer(const UniqueBuffer&, std::size_t offset, const void* data, std::size_t size);
     UniqueBuffer createIndexBuffer(const void* data, std::size_t size);
-    UniqueTexture createTexture(Size size, const void* data, TextureFormat, TextureUnit);
-    void updateTexture(TextureID, Size size, const void* data, TextureFormat, TextureUnit);
+    void updateIndexBuffer(const UniqueBuffer&, std::size_t offset, const void* data, std::size_t size);
+    UniqueTexture createTexture(Size size, const void* data, TextureFormat, TextureUnit, TextureType = TextureType::UnsignedByte);
+    void updateTexture(TextureID, Size size, const void* data, TextureFormat, TextureUnit, TextureType = TextureType::UnsignedByte);
+    void updateTextureSubImage(TextureID, uint32_t x, uint32_t y, Size size, const void* data, TextureFormat, TextureUnit);
     UniqueFramebuffer createFramebuffer();
-    UniqueRenderbuffer createRenderbuffer(RenderbufferType, Size size);
+    UniqueRenderbuffer createRenderbuffer(RenderbufferType, Size size, uint32_t samples = 1);
     std::unique_ptr<uint8_t[]> readFramebuffer(Size, TextureFormat, bool flip);
 #if not MBGL_USE_GLES2
     void drawPixels(Size size, const void* data, TextureFormat);
 #endif // MBGL_USE_GLES2
 
+    friend BufferArena;
     friend detail::ProgramDeleter;
     friend detail::ShaderDeleter;
     friend detail::BufferDeleter;
@@ -254,6 +484,27 @@ private:
 
     std::vector<TextureID> pooledTextures;
 
+    // The compressed texture formats that the context supports, once queried.
+    optional<std::vector<uint32_t>> compressedTextureFormats;
+    optional<uint32_t> maxSamples;
+
+    bool halfFloatTextures = false;
+    bool uint32Indices = false;
+
+    std::size_t draws = 0;
+
+    // The bytes of each object, as allocated when its storage was last specified. Pooled
+    // textures are counted as freed; their storage is specified again when they are reused.
+    using ObjectBytes = std::unordered_map<uint32_t, std::size_t>;
+    void track(ObjectBytes&, uint32_t id, std::size_t bytes);
+    void untrack(ObjectBytes&, uint32_t id);
+
+    ObjectBytes bufferBytes;
+    ObjectBytes textureBytes;
+    ObjectBytes renderbufferBytes;
+    std::size_t memoryUsage = 0;
+    std::size_t memoryBudget = 0;
+
     std::vector<ProgramID> abandonedPrograms;
     std::vector<ShaderID> abandonedShaders;
     std::vector<BufferID> abandonedBuffers;
@@ -0,0 +1,112 @@
+#include <mbgl/gl/gpu_timer.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/timer_query_extension.hpp>
+
+namespace mbgl {
+namespace gl {
+
+// Stops timing when the GPU falls this many frames behind, rather than allocating more queries.
+static constexpr std::size_t maximumPendingFrames = 4;
+
+GPUTimer::GPUTimer(Context& context_) : context(context_) {
+}
+
+GPUTimer::~GPUTimer() {
+    auto extension = context.getTimerQueryExtension();
+    if (!extension) {
+        return;
+    }
+
+    for (const auto& frame : pending) {
+        for (const auto& stage : frame) {
+            pool.push_back(stage.second);
+        }
+    }
+    for (const auto& stage : current) {
+        pool.push_back(stage.second);
+    }
+    if (!pool.empty()) {
+        MBGL_CHECK_ERROR(extension->deleteQueries(GLsizei(pool.size()), pool.data()));
+    }
+}
+
+void GPUTimer::beginStage(std::string name) {
+    auto extension = context.getTimerQueryExtension();
+    if (!extension || pending.size() >= maximumPendingFrames) {
+        return;
+    }
+
+    endStage();
+
+    if (pool.empty()) {
+        GLuint id = 0;
+        MBGL_CHECK_ERROR(extension->genQueries(1, &id));
+        pool.push_back(id);
+    }
+
+    const GLuint id = pool.back();
+    pool.pop_back();
+    MBGL_CHECK_ERROR(extension->beginQuery(GL_TIME_ELAPSED_EXT, id));
+    current.emplace_back(std::move(name), id);
+    timing = true;
+}
+
+void GPUTimer::endStage() {
+    if (timing) {
+        MBGL_CHECK_ERROR(context.getTimerQueryExtension()->endQuery(GL_TIME_ELAPSED_EXT));
+        timing = false;
+    }
+}
+
+void GPUTimer::endFrame() {
+    if (!context.getTimerQueryExtension()) {
+        return;
+    }
+
+    endStage();
+    if (!current.empty()) {
+        pending.push_back(std::move(current));
+        current.clear();
+    }
+    collect();
+}
+
+void GPUTimer::collect() {
+    auto extension = context.getTimerQueryExtension();
+
+    bool disjoint = false;
+    if (extension->reportsDisjoint()) {
+        GLint value = 0;
+        MBGL_CHECK_ERROR(glGetIntegerv(GL_GPU_DISJOINT_EXT, &value));
+        disjoint = value;
+    }
+
+    while (!pending.empty()) {
+        Frame& frame = pending.front();
+
+        // Queries complete in order, so the frame is done once its last query is.
+        GLuint available = 0;
+        MBGL_CHECK_ERROR(extension->getQueryObjectuiv(frame.back().second, GL_QUERY_RESULT_AVAILABLE_EXT, &available));
+        if (!available && !disjoint) {
+            break;
+        }
+
+        Stages result;
+        for (const auto& stage : frame) {
+            if (!disjoint) {
+                uint64_t nanoseconds = 0;
+                MBGL_CHECK_ERROR(extension->getQueryObjectui64v(stage.second, GL_QUERY_RESULT_EXT, &nanoseconds));
+                result.emplace_back(stage.first, std::chrono::nanoseconds(nanoseconds));
+            }
+            pool.push_back(stage.second);
+        }
+
+        if (!disjoint) {
+            lastResult = std::move(result);
+        }
+        pending.pop_front();
+    }
+}
+
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace gl {
+
+class Context;
+
+// Measures the GPU time of consecutive stages of a frame with timer queries. Stages may not
+// nest. The GPU finishes a frame some time after it was submitted, so the results describe
+// the most recent frame whose queries have completed, usually a few frames back.
+class GPUTimer : private util::noncopyable {
+public:
+    explicit GPUTimer(Context&);
+    ~GPUTimer();
+
+    // Ends the current stage, if any, and starts timing the named one.
+    void beginStage(std::string name);
+
+    // Ends the current stage and reads back the results of completed frames.
+    void endFrame();
+
+    using Stages = std::vector<std::pair<std::string, Duration>>;
+
+    // Empty if the context doesn't support timer queries.
+    const Stages& getLastResult() const { return lastResult; }
+
+private:
+    using Frame = std::vector<std::pair<std::string, uint32_t>>;
+
+    void endStage();
+    void collect();
+
+    Context& context;
+    Frame current;
+    bool timing = false;
+    std::deque<Frame> pending;
+    std::vector<uint32_t> pool;
+    Stages lastResult;
+};
+
+} // namespace gl
+} // namespace mbgl
@@ -2,6 +2,7 @@
 
 #include <mbgl/gl/object.hpp>
 #include <mbgl/gl/draw_mode.hpp>
+#include <mbgl/gl/types.hpp>
 #include <mbgl/util/ignore.hpp>
 
 #include <vector>
@@ -26,6 +27,12 @@ public:
     bool empty() const { return v.empty(); }
     const uint16_t* data() const { return v.data(); }
 
+    // Frees the capacity left unused by growing the vector.
+    void shrinkToFit() { v.shrink_to_fit(); }
+
+    // Removes all indices. Unlike std::vector::clear(), this frees the memory.
+    void release() { std::vector<uint16_t>().swap(v); }
+
 private:
     std::vector<uint16_t> v;
 };
@@ -33,7 +40,19 @@ private:
 template <class DrawMode>
 class IndexBuffer {
 public:
-    UniqueBuffer buffer;
+    std::size_t indexSize() const {
+        return type == IndexType::UnsignedInt ? sizeof(uint32_t) : sizeof(uint16_t);
+    }
+
+    std::size_t byteSize() const { return indexCount * indexSize(); }
+
+    std::size_t indexCount;
+    SharedBuffer buffer;
+
+    // Position of the first index in the buffer, which may hold other index buffers as well.
+    std::size_t byteOffset;
+
+    IndexType type = IndexType::UnsignedShort;
 };
 
 } // namespace gl
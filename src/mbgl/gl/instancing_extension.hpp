@@ -0,0 +1,39 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+class InstancedArrays {
+public:
+    template <typename Fn>
+    InstancedArrays(const Fn& loadExtension)
+        : vertexAttribDivisor(
+              loadExtension({ { "GL_ARB_instanced_arrays", "glVertexAttribDivisorARB" },
+                              { "GL_ANGLE_instanced_arrays", "glVertexAttribDivisorANGLE" },
+                              { "GL_EXT_instanced_arrays", "glVertexAttribDivisorEXT" },
+                              { "GL_NV_instanced_arrays", "glVertexAttribDivisorNV" } })),
+          drawElementsInstanced(
+              loadExtension({ { "GL_ARB_draw_instanced", "glDrawElementsInstancedARB" },
+                              { "GL_ANGLE_instanced_arrays", "glDrawElementsInstancedANGLE" },
+                              { "GL_EXT_draw_instanced", "glDrawElementsInstancedEXT" },
+                              { "GL_NV_draw_instanced", "glDrawElementsInstancedNV" } })) {
+    }
+
+    bool supported() const {
+        return vertexAttribDivisor && drawElementsInstanced;
+    }
+
+    const ExtensionFunction<void(GLuint index, GLuint divisor)> vertexAttribDivisor;
+
+    const ExtensionFunction<
+        void(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices, GLsizei primcount)>
+        drawElementsInstanced;
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#define GL_READ_FRAMEBUFFER_EXT           0x8CA8
+#define GL_DRAW_FRAMEBUFFER_EXT           0x8CA9
+#define GL_MAX_SAMPLES_EXT                0x8D57
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+class Multisample {
+public:
+    template <typename Fn>
+    Multisample(const Fn& loadExtension)
+        : renderbufferStorageMultisample(
+              loadExtension({ { "GL_ARB_framebuffer_object", "glRenderbufferStorageMultisample" },
+                              { "GL_EXT_framebuffer_multisample", "glRenderbufferStorageMultisampleEXT" },
+                              { "GL_ANGLE_framebuffer_multisample", "glRenderbufferStorageMultisampleANGLE" } })),
+          blitFramebuffer(
+              loadExtension({ { "GL_ARB_framebuffer_object", "glBlitFramebuffer" },
+                              { "GL_EXT_framebuffer_blit", "glBlitFramebufferEXT" },
+                              { "GL_ANGLE_framebuffer_blit", "glBlitFramebufferANGLE" } })) {
+    }
+
+    bool supported() const {
+        return renderbufferStorageMultisample && blitFramebuffer;
+    }
+
+    const ExtensionFunction<void(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height)> renderbufferStorageMultisample;
+
+    const ExtensionFunction<void(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1,
+                                 GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1,
+                                 GLbitfield mask, GLenum filter)> blitFramebuffer;
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
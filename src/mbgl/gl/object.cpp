@@ -19,11 +19,13 @@ void ShaderDeleter::operator()(ShaderID id) const {
 
 void BufferDeleter::operator()(BufferID id) const {
     assert(context);
+    context->untrack(context->bufferBytes, id);
     context->abandonedBuffers.push_back(id);
 }
 
 void TextureDeleter::operator()(TextureID id) const {
     assert(context);
+    context->untrack(context->textureBytes, id);
     if (context->pooledTextures.size() >= TextureMax) {
         context->abandonedTextures.push_back(id);
     } else {
@@ -43,6 +45,7 @@ void FramebufferDeleter::operator()(FramebufferID id) const {
 
 void RenderbufferDeleter::operator()(RenderbufferID id) const {
     assert(context);
+    context->untrack(context->renderbufferBytes, id);
     context->abandonedRenderbuffers.push_back(id);
 }
 
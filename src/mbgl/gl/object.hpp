@@ -4,6 +4,8 @@
 
 #include <unique_resource.hpp>
 
+#include <memory>
+
 namespace mbgl {
 namespace gl {
 
@@ -56,5 +58,8 @@ using UniqueVertexArray = std_experimental::unique_resource<VertexArrayID, detai
 using UniqueFramebuffer = std_experimental::unique_resource<FramebufferID, detail::FramebufferDeleter>;
 using UniqueRenderbuffer = std_experimental::unique_resource<RenderbufferID, detail::RenderbufferDeleter>;
 
+// A buffer that several vertex or index buffers may be allocated from; see BufferArena.
+using SharedBuffer = std::shared_ptr<const UniqueBuffer>;
+
 } // namespace gl
 } // namespace mbgl
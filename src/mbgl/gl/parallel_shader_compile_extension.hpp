@@ -0,0 +1,32 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+// With this extension, shaders are compiled and programs linked in the background, and only
+// querying their status waits for them.
+class ParallelShaderCompile {
+public:
+    template <typename Fn>
+    ParallelShaderCompile(const Fn& loadExtension)
+        : maxShaderCompilerThreads(
+              loadExtension({ { "GL_KHR_parallel_shader_compile", "glMaxShaderCompilerThreadsKHR" },
+                              { "GL_ARB_parallel_shader_compile", "glMaxShaderCompilerThreadsARB" } })) {
+    }
+
+    bool supported() const {
+        return bool(maxShaderCompilerThreads);
+    }
+
+    const ExtensionFunction<void(GLuint count)> maxShaderCompilerThreads;
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#define GL_PIXEL_PACK_BUFFER_EXT          0x88EB
+#define GL_STREAM_READ_EXT                0x88E1
+#define GL_MAP_READ_BIT_EXT               0x0001
+#define GL_SYNC_GPU_COMMANDS_COMPLETE_EXT 0x9117
+#define GL_ALREADY_SIGNALED_EXT           0x911A
+#define GL_CONDITION_SATISFIED_EXT        0x911C
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+class PixelBuffer {
+public:
+    template <typename Fn>
+    PixelBuffer(const Fn& loadExtension)
+        // glBindBuffer is core; it's only loaded to find out whether it takes GL_PIXEL_PACK_BUFFER.
+        : bindBuffer(
+              loadExtension({ { "GL_ARB_pixel_buffer_object", "glBindBuffer" },
+                              { "GL_NV_pixel_buffer_object", "glBindBuffer" } })),
+          mapBufferRange(
+              loadExtension({ { "GL_ARB_map_buffer_range", "glMapBufferRange" },
+                              { "GL_EXT_map_buffer_range", "glMapBufferRangeEXT" } })),
+          unmapBuffer(
+              loadExtension({ { "GL_ARB_map_buffer_range", "glUnmapBuffer" },
+                              { "GL_OES_mapbuffer", "glUnmapBufferOES" } })),
+          fenceSync(
+              loadExtension({ { "GL_ARB_sync", "glFenceSync" },
+                              { "GL_APPLE_sync", "glFenceSyncAPPLE" } })),
+          clientWaitSync(
+              loadExtension({ { "GL_ARB_sync", "glClientWaitSync" },
+                              { "GL_APPLE_sync", "glClientWaitSyncAPPLE" } })),
+          deleteSync(
+              loadExtension({ { "GL_ARB_sync", "glDeleteSync" },
+                              { "GL_APPLE_sync", "glDeleteSyncAPPLE" } })) {
+    }
+
+    bool supported() const {
+        return bindBuffer && mapBufferRange && unmapBuffer;
+    }
+
+    // Without fences, the only way to find out whether a read has finished is to map its buffer,
+    // which blocks until it has.
+    bool supportsFences() const {
+        return fenceSync && clientWaitSync && deleteSync;
+    }
+
+    const ExtensionFunction<void(GLenum target, GLuint buffer)> bindBuffer;
+
+    const ExtensionFunction<void*(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)> mapBufferRange;
+
+    const ExtensionFunction<GLboolean(GLenum target)> unmapBuffer;
+
+    // GLsync isn't declared by the OpenGL ES 2 headers; it is an opaque pointer.
+    const ExtensionFunction<void*(GLenum condition, GLbitfield flags)> fenceSync;
+
+    const ExtensionFunction<GLenum(void* sync, GLbitfield flags, uint64_t timeout)> clientWaitSync;
+
+    const ExtensionFunction<void(void* sync)> deleteSync;
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,119 @@
+#include <mbgl/gl/pixel_readback.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/pixel_buffer_extension.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace mbgl {
+namespace gl {
+
+// Keeps this many buffers around for later reads, which usually have the same size.
+static constexpr std::size_t maximumPooledBuffers = 2;
+
+PixelReadback::PixelReadback(Context& context_) : context(context_) {
+}
+
+PixelReadback::~PixelReadback() {
+    auto extension = context.getPixelBufferExtension();
+    for (auto& read : reads) {
+        if (read.fence) {
+            MBGL_CHECK_ERROR(extension->deleteSync(read.fence));
+        }
+    }
+}
+
+void PixelReadback::read(const Size size) {
+    auto extension = context.getPixelBufferExtension();
+    if (!extension) {
+        reads.push_back({ size, {}, 0, nullptr, context.readFramebuffer<PremultipliedImage>(size) });
+        return;
+    }
+
+    const std::size_t bytes = size.area() * PremultipliedImage::channels;
+
+    auto it = std::find_if(pool.begin(), pool.end(), [&](const auto& pooled) {
+        return pooled.first == bytes;
+    });
+    optional<UniqueBuffer> buffer;
+    if (it != pool.end()) {
+        buffer = std::move(it->second);
+        pool.erase(it);
+        MBGL_CHECK_ERROR(extension->bindBuffer(GL_PIXEL_PACK_BUFFER_EXT, *buffer));
+    } else {
+        BufferID id = 0;
+        MBGL_CHECK_ERROR(glGenBuffers(1, &id));
+        buffer = UniqueBuffer{ std::move(id), { &context } };
+        MBGL_CHECK_ERROR(extension->bindBuffer(GL_PIXEL_PACK_BUFFER_EXT, *buffer));
+        MBGL_CHECK_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER_EXT, bytes, nullptr, GL_STREAM_READ_EXT));
+    }
+
+#if not MBGL_USE_GLES2
+    context.pixelStorePack = { 1 };
+#endif // MBGL_USE_GLES2
+
+    // With a pack buffer bound, the pointer argument is an offset into it.
+    MBGL_CHECK_ERROR(glReadPixels(0, 0, size.width, size.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    MBGL_CHECK_ERROR(extension->bindBuffer(GL_PIXEL_PACK_BUFFER_EXT, 0));
+
+    void* fence = nullptr;
+    if (extension->supportsFences()) {
+        fence = MBGL_CHECK_ERROR(extension->fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE_EXT, 0));
+        // Fences are only signaled once they reach the GPU.
+        MBGL_CHECK_ERROR(glFlush());
+    }
+
+    reads.push_back({ size, std::move(buffer), bytes, fence, {} });
+}
+
+bool PixelReadback::ready() const {
+    assert(!reads.empty());
+    const Read& read = reads.front();
+    if (!read.fence) {
+        return !read.buffer;
+    }
+
+    const GLenum status = MBGL_CHECK_ERROR(context.getPixelBufferExtension()->clientWaitSync(read.fence, 0, 0));
+    return status == GL_ALREADY_SIGNALED_EXT || status == GL_CONDITION_SATISFIED_EXT;
+}
+
+PremultipliedImage PixelReadback::collect() {
+    assert(!reads.empty());
+    Read read = std::move(reads.front());
+    reads.pop_front();
+
+    if (!read.buffer) {
+        return std::move(read.image);
+    }
+
+    auto extension = context.getPixelBufferExtension();
+    if (read.fence) {
+        MBGL_CHECK_ERROR(extension->deleteSync(read.fence));
+    }
+
+    PremultipliedImage image(read.size);
+    MBGL_CHECK_ERROR(extension->bindBuffer(GL_PIXEL_PACK_BUFFER_EXT, *read.buffer));
+    const auto* pixels = reinterpret_cast<const uint8_t*>(MBGL_CHECK_ERROR(
+        extension->mapBufferRange(GL_PIXEL_PACK_BUFFER_EXT, 0, read.bytes, GL_MAP_READ_BIT_EXT)));
+    if (pixels) {
+        // The pixels have to be copied out of the buffer anyway, so they are flipped on the way
+        // rather than in a separate pass.
+        const std::size_t stride = read.size.width * PremultipliedImage::channels;
+        for (std::size_t row = 0; row < read.size.height; row++) {
+            std::memcpy(image.data.get() + row * stride,
+                        pixels + (read.size.height - row - 1) * stride, stride);
+        }
+        MBGL_CHECK_ERROR(extension->unmapBuffer(GL_PIXEL_PACK_BUFFER_EXT));
+    }
+    MBGL_CHECK_ERROR(extension->bindBuffer(GL_PIXEL_PACK_BUFFER_EXT, 0));
+
+    if (pool.size() < maximumPooledBuffers) {
+        pool.emplace_back(read.bytes, std::move(*read.buffer));
+    }
+
+    return image;
+}
+
+} // namespace gl
+} // namespace mbgl
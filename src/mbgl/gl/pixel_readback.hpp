@@ -0,0 +1,56 @@
+#pragma once
+
+#include <mbgl/gl/object.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace gl {
+
+class Context;
+
+// Reads framebuffers into pixel pack buffers. glReadPixels then returns once the copy is queued
+// rather than once the GPU has finished rendering, so that the next frame can be submitted before
+// the pixels of this one are collected. Reads are collected in the order they were queued. Falls
+// back to synchronous reads if the context doesn't support pixel pack buffers.
+class PixelReadback : private util::noncopyable {
+public:
+    explicit PixelReadback(Context&);
+    ~PixelReadback();
+
+    // Queues a read of the bound framebuffer.
+    void read(Size);
+
+    // The number of reads that haven't been collected yet.
+    std::size_t pending() const { return reads.size(); }
+
+    // Whether the oldest read has finished, so that collecting it won't block. Always false for
+    // reads into pixel pack buffers if the context doesn't support fences.
+    bool ready() const;
+
+    // Returns the pixels of the oldest read, top row first. Blocks until the GPU has finished it.
+    PremultipliedImage collect();
+
+private:
+    struct Read {
+        Size size;
+        // Empty for a synchronous read, whose pixels are in `image` instead.
+        optional<UniqueBuffer> buffer;
+        std::size_t bytes;
+        void* fence;
+        PremultipliedImage image;
+    };
+
+    Context& context;
+    std::deque<Read> reads;
+    // Buffers of collected reads and their sizes, for reuse by reads of the same size.
+    std::vector<std::pair<std::size_t, UniqueBuffer>> pool;
+};
+
+} // namespace gl
+} // namespace mbgl
@@ -6,6 +6,7 @@
 #include <mbgl/gl/vertex_buffer.hpp>
 #include <mbgl/gl/index_buffer.hpp>
 #include <mbgl/gl/attribute.hpp>
+#include <mbgl/gl/segment.hpp>
 #include <mbgl/gl/uniform.hpp>
 
 #include <mbgl/util/io.hpp>
@@ -29,34 +30,39 @@ public:
     using UniformValues = typename Uniforms::Values;
     using AttributeBindings = typename Attributes::Bindings;
 
+    // Starts compiling and linking the program. Contexts that support KHR_parallel_shader_compile
+    // do this in the background until the program is first drawn with, see link().
     Program(Context& context, const std::string& vertexSource, const std::string& fragmentSource)
-        : program(
-              context.createProgram(context.createShader(ShaderType::Vertex, vertexSource),
-                                    context.createShader(ShaderType::Fragment, fragmentSource))),
+        : vertexShader(context.createShader(ShaderType::Vertex, vertexSource)),
+          fragmentShader(context.createShader(ShaderType::Fragment, fragmentSource)),
+          program(context.createProgram(*vertexShader, *fragmentShader)),
           attributeLocations(Attributes::bindLocations(program)),
-          uniformsState((context.linkProgram(program), Uniforms::bindLocations(program))) {
+          linked(false) {
+        context.linkProgram(program);
     }
 
     template <class BinaryProgram>
     Program(Context& context, const BinaryProgram& binaryProgram)
         : program(context.createProgram(binaryProgram.format(), binaryProgram.code())),
           attributeLocations(Attributes::loadNamedLocations(binaryProgram)),
-          uniformsState(Uniforms::loadNamedLocations(binaryProgram)) {
+          uniformsState(Uniforms::loadNamedLocations(binaryProgram)),
+          linked(true) {
     }
     
     static Program createProgram(gl::Context& context,
                                  const ProgramParameters& programParameters,
                                  const char* name,
                                  const char* vertexSource_,
-                                 const char* fragmentSource_) {
+                                 const char* fragmentSource_,
+                                 const std::string& defines) {
 #if MBGL_HAS_BINARY_PROGRAMS
         if (!programParameters.cacheDir.empty() && context.supportsProgramBinaries()) {
             const std::string vertexSource =
-                shaders::vertexSource(programParameters, vertexSource_);
+                shaders::vertexSource(programParameters, vertexSource_, defines);
             const std::string fragmentSource =
                 shaders::fragmentSource(programParameters, fragmentSource_);
             const std::string cachePath =
-                shaders::programCachePath(programParameters, name);
+                shaders::programCachePath(programParameters, name, defines);
             const std::string identifier =
                 shaders::programIdentifier(vertexSource, fragmentSource_);
 
@@ -76,27 +82,52 @@ public:
                              error.what());
             }
 
-            // Compile the shader
+            // Compile the shader, and cache it once it has been linked.
             Program result{ context, vertexSource, fragmentSource };
+            result.pendingCache = std::make_pair(cachePath, identifier);
+            return std::move(result);
+        }
+#endif
+        (void)name;
+        return Program {
+            context, shaders::vertexSource(programParameters, vertexSource_, defines),
+            shaders::fragmentSource(programParameters, fragmentSource_)
+        };
+    }
+
+    // Whether link() would return without waiting for the driver.
+    bool isLinked(Context& context) const {
+        return linked || context.isProgramLinkComplete(program);
+    }
+
+    // Waits for the program to be linked, and looks up its uniforms. Throws if its shaders
+    // failed to compile or link.
+    void link(Context& context) {
+        if (linked) {
+            return;
+        }
 
+        context.verifyShaderCompilation(*vertexShader);
+        context.verifyShaderCompilation(*fragmentShader);
+        context.verifyProgramLinkage(program);
+        uniformsState = Uniforms::bindLocations(program);
+        vertexShader = {};
+        fragmentShader = {};
+        linked = true;
+
+        if (pendingCache) {
+            const auto cache = std::move(*pendingCache);
+            pendingCache = {};
             try {
                 if (const auto binaryProgram =
-                        result.template get<BinaryProgram>(context, identifier)) {
-                    util::write_file(cachePath, binaryProgram->serialize());
-                    Log::Warning(Event::OpenGL, "Caching program in: %s", cachePath.c_str());
+                        get<BinaryProgram>(context, cache.second)) {
+                    util::write_file(cache.first, binaryProgram->serialize());
+                    Log::Warning(Event::OpenGL, "Caching program in: %s", cache.first.c_str());
                 }
             } catch (std::runtime_error& error) {
                 Log::Warning(Event::OpenGL, "Failed to cache program: %s", error.what());
             }
-
-            return std::move(result);
         }
-#endif
-        (void)name;
-        return Program {
-            context, shaders::vertexSource(programParameters, vertexSource_),
-            shaders::fragmentSource(programParameters, fragmentSource_)
-        };
     }
 
     template <class BinaryProgram>
@@ -118,9 +149,12 @@ public:
               UniformValues&& uniformValues,
               AttributeBindings&& attributeBindings,
               const IndexBuffer<DrawMode>& indexBuffer,
-              const SegmentVector<Attributes>& segments) {
+              const SegmentVector<Attributes>& segments,
+              const SegmentFilter& filter = {}) {
         static_assert(std::is_same<Primitive, typename DrawMode::Primitive>::value, "incompatible draw mode");
 
+        link(context);
+
         context.setDrawMode(drawMode);
         context.setDepthMode(depthMode);
         context.setStencilMode(stencilMode);
@@ -130,23 +164,85 @@ public:
 
         Uniforms::bind(uniformsState, std::move(uniformValues));
 
+        Attributes::setValues(attributeLocations, attributeBindings);
+        const uint64_t attributeBindingsHash = Attributes::hash(attributeLocations, attributeBindings);
+
         for (const auto& segment : segments) {
+            if (filter && segment.bounds && !filter(*segment.bounds)) {
+                continue;
+            }
+
             segment.bind(context,
-                         indexBuffer.buffer,
+                         *indexBuffer.buffer,
                          attributeLocations,
-                         attributeBindings);
+                         attributeBindings,
+                         attributeBindingsHash);
 
             context.draw(drawMode.primitiveType,
-                         segment.indexOffset,
+                         indexBuffer.type,
+                         indexBuffer.byteOffset / indexBuffer.indexSize() + segment.indexOffset,
                          segment.indexLength);
         }
     }
 
+    // Like draw(), but draws each segment `instanceCount` times, for attributes that are bound
+    // with a divisor. Requires Context::supportsInstancing().
+    template <class DrawMode>
+    void drawInstanced(Context& context,
+                       DrawMode drawMode,
+                       DepthMode depthMode,
+                       StencilMode stencilMode,
+                       ColorMode colorMode,
+                       UniformValues&& uniformValues,
+                       AttributeBindings&& attributeBindings,
+                       const IndexBuffer<DrawMode>& indexBuffer,
+                       const SegmentVector<Attributes>& segments,
+                       std::size_t instanceCount) {
+        static_assert(std::is_same<Primitive, typename DrawMode::Primitive>::value, "incompatible draw mode");
+
+        link(context);
+
+        context.setDrawMode(drawMode);
+        context.setDepthMode(depthMode);
+        context.setStencilMode(stencilMode);
+        context.setColorMode(colorMode);
+
+        context.program = program;
+
+        Uniforms::bind(uniformsState, std::move(uniformValues));
+
+        Attributes::setValues(attributeLocations, attributeBindings);
+        const uint64_t attributeBindingsHash = Attributes::hash(attributeLocations, attributeBindings);
+
+        for (const auto& segment : segments) {
+            segment.bind(context,
+                         *indexBuffer.buffer,
+                         attributeLocations,
+                         attributeBindings,
+                         attributeBindingsHash);
+
+            context.drawInstanced(drawMode.primitiveType,
+                                  indexBuffer.type,
+                                  indexBuffer.byteOffset / indexBuffer.indexSize() + segment.indexOffset,
+                                  segment.indexLength,
+                                  instanceCount);
+        }
+    }
+
 private:
+    // Only kept until the program has been linked, to look up why it failed to.
+    optional<UniqueShader> vertexShader;
+    optional<UniqueShader> fragmentShader;
+
     UniqueProgram program;
 
     typename Attributes::Locations attributeLocations;
     typename Uniforms::State uniformsState;
+    bool linked;
+
+    // The cache path and identifier of a program that is written to the program cache once
+    // it has been linked.
+    optional<std::pair<std::string, std::string>> pendingCache;
 };
 
 } // namespace gl
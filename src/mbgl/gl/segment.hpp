@@ -2,15 +2,29 @@
 
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/vertex_buffer.hpp>
+#include <mbgl/gl/index_buffer.hpp>
+#include <mbgl/util/geometry.hpp>
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <vector>
 
 namespace mbgl {
 namespace gl {
 
+// The box around the vertices of a segment, in tile units.
+class SegmentBounds {
+public:
+    mbgl::Point<int16_t> min;
+    mbgl::Point<int16_t> max;
+};
+
+// Decides whether a segment with bounds is drawn. Segments without bounds are always drawn.
+using SegmentFilter = std::function<bool (const SegmentBounds&)>;
+
 template <class Attributes>
 class Segment {
 public:
@@ -29,10 +43,17 @@ public:
     std::size_t vertexLength;
     std::size_t indexLength;
 
+    // Recorded by buckets that split their segments with splitSegments().
+    optional<SegmentBounds> bounds;
+
+    // Binds the segment's vertex array object, and binds the attributes to it once the hash of
+    // their bindings differs from the one they were bound with before. Without vertex array
+    // objects, the attributes are bound for every draw.
     void bind(Context& context,
               BufferID indexBuffer_,
               const typename Attributes::Locations& attributeLocations,
-              const typename Attributes::Bindings& attributeBindings_) const {
+              const typename Attributes::Bindings& attributeBindings_,
+              uint64_t attributeBindingsHash) const {
         if (context.supportsVertexArrays()) {
             if (!vao) {
                 vao = context.createVertexArray();
@@ -44,15 +65,17 @@ public:
                 context.elementBuffer.setDirty();
                 context.elementBuffer = indexBuffer_;
             }
+            if (boundAttributesHash == attributeBindingsHash) {
+                return;
+            }
+            boundAttributesHash = attributeBindingsHash;
         } else {
             // No VAO support. Force attributes to be rebound.
             context.elementBuffer = indexBuffer_;
-            variableBindings = {};
         }
 
         Attributes::bind(context,
                          attributeLocations,
-                         variableBindings,
                          attributeBindings_,
                          vertexOffset);
     }
@@ -60,14 +83,132 @@ public:
 private:
     mutable optional<UniqueVertexArray> vao;
     mutable optional<BufferID> indexBuffer;
-    mutable typename Attributes::VariableBindings variableBindings;
+    mutable optional<uint64_t> boundAttributesHash;
 };
 
 template <class Attributes>
 class SegmentVector : public std::vector<Segment<Attributes>> {
 public:
     SegmentVector() = default;
+    SegmentVector(SegmentVector&&) = default;
+    SegmentVector& operator=(SegmentVector&&) = default;
+
+    // Copies the ranges of the segments, but not their vertex array objects, which belong to
+    // the context they were bound in.
+    SegmentVector(const SegmentVector& other)
+        : std::vector<Segment<Attributes>>() {
+        this->reserve(other.size());
+        for (const auto& segment : other) {
+            this->emplace_back(segment.vertexOffset, segment.indexOffset,
+                               segment.vertexLength, segment.indexLength);
+            this->back().bounds = segment.bounds;
+        }
+    }
 };
 
+// Splits each segment into runs of consecutive primitives whose vertices lie within a box of at
+// most `maxSize` tile units, and records the box of each run, so that the painter can skip the
+// runs that are off-screen. Runs of fewer than `minPrimitives` primitives are extended
+// regardless, which bounds the number of draw calls. The primitives keep their order, and so do
+// the features they were made of. The runs share the vertices of the segment they are part of.
+// `position` returns the position in the tile of a vertex, by its index in the vertex vector.
+template <class DrawMode, class Attributes, class Position>
+void splitSegments(const IndexVector<DrawMode>& indices,
+                   SegmentVector<Attributes>& segments,
+                   const Position& position,
+                   int32_t maxSize,
+                   std::size_t minPrimitives) {
+    constexpr std::size_t groupSize = DrawMode::bufferGroupSize;
+    const uint16_t* data = indices.data();
+
+    SegmentVector<Attributes> result;
+    for (const auto& segment : segments) {
+        const auto addRun = [&] (std::size_t begin, std::size_t end, const SegmentBounds& bounds) {
+            result.emplace_back(segment.vertexOffset, begin, segment.vertexLength, end - begin);
+            result.back().bounds = bounds;
+        };
+
+        const std::size_t end = segment.indexOffset + segment.indexLength;
+        if (segment.indexLength < groupSize) {
+            result.emplace_back(segment.vertexOffset, segment.indexOffset,
+                                segment.vertexLength, segment.indexLength);
+            continue;
+        }
+
+        std::size_t runBegin = segment.indexOffset;
+        std::size_t runPrimitives = 0;
+        SegmentBounds run;
+        for (std::size_t i = segment.indexOffset; i + groupSize <= end; i += groupSize) {
+            SegmentBounds primitive;
+            primitive.min = primitive.max = position(segment.vertexOffset + data[i]);
+            for (std::size_t j = 1; j < groupSize; j++) {
+                const mbgl::Point<int16_t> p = position(segment.vertexOffset + data[i + j]);
+                primitive.min = { std::min(primitive.min.x, p.x), std::min(primitive.min.y, p.y) };
+                primitive.max = { std::max(primitive.max.x, p.x), std::max(primitive.max.y, p.y) };
+            }
+
+            if (runPrimitives == 0) {
+                run = primitive;
+                runPrimitives = 1;
+                continue;
+            }
+
+            const SegmentBounds merged {
+                { std::min(run.min.x, primitive.min.x), std::min(run.min.y, primitive.min.y) },
+                { std::max(run.max.x, primitive.max.x), std::max(run.max.y, primitive.max.y) }
+            };
+            if (runPrimitives >= minPrimitives &&
+                (merged.max.x - merged.min.x > maxSize || merged.max.y - merged.min.y > maxSize)) {
+                addRun(runBegin, i, run);
+                runBegin = i;
+                run = primitive;
+                runPrimitives = 1;
+            } else {
+                run = merged;
+                runPrimitives++;
+            }
+        }
+        addRun(runBegin, end, run);
+    }
+
+    segments = std::move(result);
+}
+
+// Uploads the indices of the segments. Where the context supports 32-bit indices, they are
+// offset by the first vertices of their segments, and the segments are replaced with a single
+// one that is drawn with one call and bound with one vertex array object. Segments with bounds
+// are kept apart, so that they can still be skipped.
+template <class DrawMode, class Attributes>
+IndexBuffer<DrawMode> createIndexBuffer(Context& context,
+                                        IndexVector<DrawMode>&& indices,
+                                        SegmentVector<Attributes>& segments) {
+    if (segments.size() < 2 || !context.supportsUint32Indices() || segments.front().bounds) {
+        return context.createIndexBuffer(std::move(indices));
+    }
+
+    const Segment<Attributes>& first = segments.front();
+    const Segment<Attributes>& last = segments.back();
+
+    std::vector<uint32_t> wide(indices.indexSize());
+    const uint16_t* data = indices.data();
+    for (const auto& segment : segments) {
+        const auto vertexOffset = static_cast<uint32_t>(segment.vertexOffset - first.vertexOffset);
+        for (std::size_t i = segment.indexOffset; i < segment.indexOffset + segment.indexLength; i++) {
+            wide[i] = data[i] + vertexOffset;
+        }
+    }
+    indices.release();
+
+    // The segments of a bucket follow each other in the vertex and index vectors.
+    Segment<Attributes> merged(first.vertexOffset,
+                               first.indexOffset,
+                               last.vertexOffset + last.vertexLength - first.vertexOffset,
+                               last.indexOffset + last.indexLength - first.indexOffset);
+    segments.clear();
+    segments.push_back(std::move(merged));
+
+    return context.createIndexBuffer<DrawMode>(wide);
+}
+
 } // namespace gl
 } // namespace mbgl
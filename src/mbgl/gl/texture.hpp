@@ -14,6 +14,9 @@ public:
     TextureMipMap mipmap = TextureMipMap::No;
     TextureWrap wrapX = TextureWrap::Clamp;
     TextureWrap wrapY = TextureWrap::Clamp;
+    // Whether the levels below the base level have been generated, so that the texture can be
+    // sampled with TextureMipMap::Yes.
+    bool mipmapped = false;
 };
 
 } // namespace gl
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#define GL_QUERY_RESULT_EXT               0x8866
+#define GL_QUERY_RESULT_AVAILABLE_EXT     0x8867
+#define GL_TIME_ELAPSED_EXT               0x88BF
+#define GL_GPU_DISJOINT_EXT               0x8FBB
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+class TimerQuery {
+public:
+    template <typename Fn>
+    TimerQuery(const Fn& loadExtension)
+        : genQueries(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glGenQueriesEXT" },
+                              { "GL_ARB_timer_query", "glGenQueries" } })),
+          deleteQueries(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glDeleteQueriesEXT" },
+                              { "GL_ARB_timer_query", "glDeleteQueries" } })),
+          beginQuery(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glBeginQueryEXT" },
+                              { "GL_ARB_timer_query", "glBeginQuery" } })),
+          endQuery(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glEndQueryEXT" },
+                              { "GL_ARB_timer_query", "glEndQuery" } })),
+          getQueryObjectuiv(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glGetQueryObjectuivEXT" },
+                              { "GL_ARB_timer_query", "glGetQueryObjectuiv" } })),
+          getQueryObjectui64v(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glGetQueryObjectui64vEXT" },
+                              { "GL_ARB_timer_query", "glGetQueryObjectui64v" } })),
+          genQueriesEXT(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glGenQueriesEXT" } })) {
+    }
+
+    bool supported() const {
+        return genQueries && deleteQueries && beginQuery && endQuery && getQueryObjectuiv && getQueryObjectui64v;
+    }
+
+    const ExtensionFunction<void(GLsizei n, GLuint* ids)> genQueries;
+
+    const ExtensionFunction<void(GLsizei n, const GLuint* ids)> deleteQueries;
+
+    const ExtensionFunction<void(GLenum target, GLuint id)> beginQuery;
+
+    const ExtensionFunction<void(GLenum target)> endQuery;
+
+    const ExtensionFunction<void(GLuint id, GLenum pname, GLuint* params)> getQueryObjectuiv;
+
+    const ExtensionFunction<void(GLuint id, GLenum pname, uint64_t* params)> getQueryObjectui64v;
+
+    // Only loaded for GL_EXT_disjoint_timer_query, whose results must be discarded when the GPU
+    // reports a disjoint operation, e.g. a change of its clock frequency.
+    const ExtensionFunction<void(GLsizei n, GLuint* ids)> genQueriesEXT;
+
+    bool reportsDisjoint() const {
+        return bool(genQueriesEXT);
+    }
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
@@ -51,6 +51,20 @@ enum class TextureFormat : uint32_t {
 #endif // MBGL_USE_GLES2
 };
 
+enum class IndexType : uint32_t {
+    UnsignedShort = 0x1403,
+    UnsignedInt = 0x1405,
+};
+
+enum class TextureType : uint32_t {
+    UnsignedByte = 0x1401,
+#if MBGL_USE_GLES2
+    HalfFloat = 0x8D61, // GL_HALF_FLOAT_OES
+#else
+    HalfFloat = 0x140B,
+#endif // MBGL_USE_GLES2
+};
+
 enum class PrimitiveType {
     Points = 0x0000,
     Lines = 0x0001,
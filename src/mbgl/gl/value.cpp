@@ -267,6 +267,31 @@ Viewport::Type Viewport::Get() {
              { static_cast<uint32_t>(viewport[2]), static_cast<uint32_t>(viewport[3]) } };
 }
 
+const constexpr ScissorTest::Type ScissorTest::Default;
+
+void ScissorTest::Set(const Type& value) {
+    MBGL_CHECK_ERROR(value ? glEnable(GL_SCISSOR_TEST) : glDisable(GL_SCISSOR_TEST));
+}
+
+ScissorTest::Type ScissorTest::Get() {
+    Type scissorTest;
+    MBGL_CHECK_ERROR(scissorTest = glIsEnabled(GL_SCISSOR_TEST));
+    return scissorTest;
+}
+
+const constexpr Scissor::Type Scissor::Default;
+
+void Scissor::Set(const Type& value) {
+    MBGL_CHECK_ERROR(glScissor(value.x, value.y, value.size.width, value.size.height));
+}
+
+Scissor::Type Scissor::Get() {
+    GLint scissor[4];
+    MBGL_CHECK_ERROR(glGetIntegerv(GL_SCISSOR_BOX, scissor));
+    return { static_cast<int32_t>(scissor[0]), static_cast<int32_t>(scissor[1]),
+             { static_cast<uint32_t>(scissor[2]), static_cast<uint32_t>(scissor[3]) } };
+}
+
 const constexpr BindFramebuffer::Type BindFramebuffer::Default;
 
 void BindFramebuffer::Set(const Type& value) {
@@ -28,6 +28,14 @@ public:
     bool empty() const { return v.empty(); }
     const Vertex* data() const { return v.data(); }
 
+    Vertex& operator[](std::size_t i) { return v[i]; }
+
+    // Frees the capacity left unused by growing the vector.
+    void shrinkToFit() { v.shrink_to_fit(); }
+
+    // Removes all vertices. Unlike std::vector::clear(), this frees the memory.
+    void release() { std::vector<Vertex>().swap(v); }
+
 private:
     std::vector<Vertex> v;
 };
@@ -38,8 +46,13 @@ public:
     using Vertex = V;
     static constexpr std::size_t vertexSize = sizeof(Vertex);
 
+    std::size_t byteSize() const { return vertexCount * vertexSize; }
+
     std::size_t vertexCount;
-    UniqueBuffer buffer;
+    SharedBuffer buffer;
+
+    // Position of the first vertex in the buffer, which may hold other vertex buffers as well.
+    std::size_t byteOffset;
 };
 
 } // namespace gl
@@ -3,44 +3,91 @@
 
 #include <boost/functional/hash.hpp>
 
+#include <limits>
+#include <unordered_map>
+
 namespace mbgl {
 namespace util {
 
-// Map of key -> index into features
+namespace {
+
+// Map of key -> index of the feature that owns the merged line ending there
 using Index = std::unordered_map<size_t, size_t>;
 
-size_t mergeFromRight(std::vector<SymbolFeature>& features,
-                      Index& rightIndex,
-                      Index::iterator left,
-                      size_t rightKey,
-                      GeometryCollection& geom) {
-
-    const size_t index = left->second;
-    rightIndex.erase(left);
-    rightIndex[rightKey] = index;
-    features[index].geometry[0].pop_back();
-    features[index].geometry[0].insert(
-        features[index].geometry[0].end(), geom[0].begin(), geom[0].end());
-    geom[0].clear();
-    return index;
-}
+constexpr size_t none = std::numeric_limits<size_t>::max();
 
-size_t mergeFromLeft(std::vector<SymbolFeature>& features,
-                     Index& leftIndex,
-                     Index::iterator right,
-                     size_t leftKey,
-                     GeometryCollection& geom) {
-
-    const size_t index = right->second;
-    leftIndex.erase(right);
-    leftIndex[leftKey] = index;
-    geom[0].pop_back();
-    geom[0].insert(
-        geom[0].end(), features[index].geometry[0].begin(), features[index].geometry[0].end());
-    features[index].geometry[0].clear();
-    std::swap(features[index].geometry[0], geom[0]);
-    return index;
-}
+// Merged lines are kept as linked lists of the lines of the features they are made of, so
+// that merging doesn't move any coordinates. Each line is copied once, when the merged lines
+// are put together at the end.
+class Chains {
+public:
+    explicit Chains(size_t size)
+        : next(size, none), head(size, none), tail(size, none) {
+    }
+
+    void start(size_t index) {
+        head[index] = index;
+        tail[index] = index;
+    }
+
+    // Appends the line owned by `other` to the one owned by `index`.
+    void append(size_t index, size_t other) {
+        next[tail[index]] = head[other];
+        tail[index] = tail[other];
+        head[other] = none;
+    }
+
+    // Prepends the line owned by `other` to the one owned by `index`.
+    void prepend(size_t index, size_t other) {
+        next[tail[other]] = head[index];
+        head[index] = head[other];
+        head[other] = none;
+    }
+
+    size_t last(size_t index) const {
+        return tail[index];
+    }
+
+    // Puts the merged lines together, in the features that own them, and empties the lines of
+    // the features merged into them.
+    void join(std::vector<SymbolFeature>& features) const {
+        std::vector<std::pair<size_t, GeometryCoordinates>> merged;
+        for (size_t index = 0; index < features.size(); index++) {
+            if (head[index] == none || next[head[index]] == none) {
+                continue;
+            }
+
+            size_t count = 0;
+            for (size_t piece = head[index]; piece != none; piece = next[piece]) {
+                count += features[piece].geometry[0].size();
+            }
+
+            // Each line ends where the next one starts, so that point is taken from the next.
+            GeometryCoordinates line;
+            line.reserve(count);
+            for (size_t piece = head[index]; piece != none; piece = next[piece]) {
+                const GeometryCoordinates& coordinates = features[piece].geometry[0];
+                line.insert(line.end(), coordinates.begin(),
+                            next[piece] == none ? coordinates.end() : coordinates.end() - 1);
+            }
+            merged.emplace_back(index, std::move(line));
+        }
+
+        for (size_t index = 0; index < features.size(); index++) {
+            if (head[index] == none && tail[index] != none) {
+                features[index].geometry[0].clear();
+            }
+        }
+        for (auto& line : merged) {
+            features[line.first].geometry[0] = std::move(line.second);
+        }
+    }
+
+private:
+    std::vector<size_t> next;  // The line after each line in its merged line
+    std::vector<size_t> head;  // The first line of the merged line each feature owns, if any
+    std::vector<size_t> tail;  // The last line of the merged line each feature owns or owned
+};
 
 size_t getKey(const std::u16string& text, const GeometryCoordinate& coord) {
     auto hash = std::hash<std::u16string>()(text);
@@ -49,9 +96,12 @@ size_t getKey(const std::u16string& text, const GeometryCoordinate& coord) {
     return hash;
 }
 
+} // namespace
+
 void mergeLines(std::vector<SymbolFeature>& features) {
     Index leftIndex;
     Index rightIndex;
+    Chains chains(features.size());
 
     for (size_t k = 0; k < features.size(); k++) {
         SymbolFeature& feature = features[k];
@@ -61,6 +111,8 @@ void mergeLines(std::vector<SymbolFeature>& features) {
             continue;
         }
 
+        chains.start(k);
+
         const size_t leftKey = getKey(*feature.text, geometry[0].front());
         const size_t rightKey = getKey(*feature.text, geometry[0].back());
 
@@ -70,20 +122,30 @@ void mergeLines(std::vector<SymbolFeature>& features) {
         if (left != rightIndex.end() && right != leftIndex.end() && left->second != right->second) {
             // found lines with the same text adjacent to both ends of the current line, merge all
             // three
-            size_t j = mergeFromLeft(features, leftIndex, right, leftKey, geometry);
-            size_t i = mergeFromRight(features, rightIndex, left, rightKey, features[j].geometry);
+            const size_t i = left->second;
+            const size_t j = right->second;
+            chains.prepend(j, k);
+            chains.append(i, j);
 
+            rightIndex.erase(left);
+            leftIndex.erase(right);
             leftIndex.erase(leftKey);
             rightIndex.erase(rightKey);
-            rightIndex[getKey(*feature.text, features[i].geometry[0].back())] = i;
+            rightIndex[getKey(*feature.text, features[chains.last(i)].geometry[0].back())] = i;
 
         } else if (left != rightIndex.end()) {
             // found mergeable line adjacent to the start of the current line, merge
-            mergeFromRight(features, rightIndex, left, rightKey, geometry);
+            const size_t i = left->second;
+            chains.append(i, k);
+            rightIndex.erase(left);
+            rightIndex[rightKey] = i;
 
         } else if (right != leftIndex.end()) {
             // found mergeable line adjacent to the end of the current line, merge
-            mergeFromLeft(features, leftIndex, right, leftKey, geometry);
+            const size_t j = right->second;
+            chains.prepend(j, k);
+            leftIndex.erase(right);
+            leftIndex[leftKey] = j;
 
         } else {
             // no adjacent lines, add as a new item
@@ -91,6 +153,8 @@ void mergeLines(std::vector<SymbolFeature>& features) {
             rightIndex[rightKey] = k;
         }
     }
+
+    chains.join(features);
 }
 
 } // end namespace util
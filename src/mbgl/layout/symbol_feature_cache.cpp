@@ -0,0 +1,47 @@
+#include <mbgl/layout/symbol_feature_cache.hpp>
+#include <mbgl/util/buffer.hpp>
+
+namespace mbgl {
+
+SymbolFeatureCache& SymbolFeatureCache::get() {
+    static SymbolFeatureCache cache;
+    return cache;
+}
+
+std::shared_ptr<const SymbolFeatureCache::Features> SymbolFeatureCache::find(const std::string& key, const Buffer& data) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(key);
+    std::shared_ptr<const Features> features = it != entries.end() ? it->second.lock() : nullptr;
+    if (!features || *features->data != data) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    stats.hits++;
+    return features;
+}
+
+void SymbolFeatureCache::add(const std::string& key, const std::shared_ptr<const Features>& features) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Drops the features that no layout uses anymore.
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.expired()) {
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Replaces features that were read by another tile in the meantime, or from other data.
+    entries[key] = features;
+    stats.entries = entries.size();
+}
+
+SymbolFeatureCache::Stats SymbolFeatureCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+} // namespace mbgl
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mbgl/layout/symbol_feature.hpp>
+#include <mbgl/sprite/sprite_atlas.hpp>
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+class Buffer;
+
+// The features that symbol layouts read from the data of a canonical tile, shared by the tiles
+// that overzoom it. Past the maximum zoom level of a source, every overscaled tile lays out the
+// same data again. The features with their text, icons and merged lines are the same for each of
+// them unless those are read with zoom functions, so they are only read once. Anchors, quads and
+// placement still depend on the overscaling, and are computed by each tile.
+//
+// Features are kept as long as a layout uses them. It may be used from any thread.
+class SymbolFeatureCache : private util::noncopyable {
+public:
+    class Features {
+    public:
+        // The encoded tile the features were read from.
+        std::shared_ptr<const Buffer> data;
+
+        std::vector<SymbolFeature> features;
+        GlyphDependencies glyphDependencies;
+        IconDependencies iconDependencies;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+
+        std::size_t entries = 0;
+    };
+
+    static SymbolFeatureCache& get();
+
+    // Returns the features stored under the key if they were read from the given tile data.
+    std::shared_ptr<const Features> find(const std::string& key, const Buffer& data);
+    void add(const std::string& key, const std::shared_ptr<const Features>&);
+
+    Stats getStats() const;
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, std::weak_ptr<const Features>> entries;
+    Stats stats;
+};
+
+} // namespace mbgl
@@ -1,12 +1,15 @@
 #include <mbgl/layout/symbol_instance.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 
+#include <cassert>
+
 namespace mbgl {
 
 using namespace style;
 
-SymbolInstance::SymbolInstance(Anchor& anchor,
+SymbolInstance::SymbolInstance(Anchor& anchor_,
                                const GeometryCoordinates& line,
+                               std::shared_ptr<const GeometryCoordinates> collisionLine_,
                                const std::pair<Shaping, Shaping>& shapedTextOrientations,
                                optional<PositionedIcon> shapedIcon,
                                const SymbolLayoutProperties::Evaluated& layout,
@@ -20,17 +23,25 @@ SymbolInstance::SymbolInstance(Anchor& anchor,
                                const float iconPadding,
                                const SymbolPlacementType iconPlacement,
                                const GlyphPositions& face,
-                               const IndexedSubfeature& indexedFeature,
+                               const IndexedSubfeature& indexedFeature_,
                                const std::size_t featureIndex_) :
-    point(anchor.point),
+    point(anchor_.point),
     index(index_),
     hasText(shapedTextOrientations.first || shapedTextOrientations.second),
     hasIcon(shapedIcon),
-
-    // Create the collision features that will be used to check whether this symbol instance can be placed
-    textCollisionFeature(line, anchor, shapedTextOrientations.second ?: shapedTextOrientations.first, textBoxScale, textPadding, textPlacement, indexedFeature),
-    iconCollisionFeature(line, anchor, shapedIcon, iconBoxScale, iconPadding, iconPlacement, indexedFeature),
-    featureIndex(featureIndex_) {
+    featureIndex(featureIndex_),
+    anchor(anchor_),
+    collisionLine(std::move(collisionLine_)),
+    indexedFeature(indexedFeature_) {
+    const Shaping& collisionShaping = shapedTextOrientations.second ?: shapedTextOrientations.first;
+    textShape = { float(collisionShaping.top), float(collisionShaping.bottom),
+                  float(collisionShaping.left), float(collisionShaping.right),
+                  textBoxScale, textPadding, textPlacement };
+    iconShape = { shapedIcon ? shapedIcon->top() : 0,
+                  shapedIcon ? shapedIcon->bottom() : 0,
+                  shapedIcon ? shapedIcon->left() : 0,
+                  shapedIcon ? shapedIcon->right() : 0,
+                  iconBoxScale, iconPadding, iconPlacement };
 
     // Create the quads used for rendering the icon and glyphs.
     if (addToBuffers) {
@@ -58,4 +69,23 @@ SymbolInstance::SymbolInstance(Anchor& anchor,
     }
 }
 
+void SymbolInstance::makeCollisionFeatures() {
+    // Only symbols placed along a line have a line to make their features from.
+    static const GeometryCoordinates noLine;
+    const GeometryCoordinates& line = collisionLine ? *collisionLine : noLine;
+
+    auto make = [&] (const CollisionShape& shape, CollisionFeature::AlignmentType alignment) {
+        assert(shape.placement != SymbolPlacementType::Line || collisionLine);
+        return CollisionFeature(line, anchor, shape.top, shape.bottom, shape.left, shape.right,
+                                shape.boxScale, shape.padding, shape.placement, indexedFeature, alignment);
+    };
+
+    if (hasText && !textCollisionFeature) {
+        textCollisionFeature = make(textShape, CollisionFeature::AlignmentType::Curved);
+    }
+    if (hasIcon && !iconCollisionFeature) {
+        iconCollisionFeature = make(iconShape, CollisionFeature::AlignmentType::Straight);
+    }
+}
+
 } // namespace mbgl
@@ -4,16 +4,19 @@
 #include <mbgl/text/glyph.hpp>
 #include <mbgl/text/collision_feature.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
+#include <mbgl/util/optional.hpp>
 
-namespace mbgl {
+#include <memory>
 
-class Anchor;
-class IndexedSubfeature;
+namespace mbgl {
 
 class SymbolInstance {
 public:
+    // The line is only needed for the collision features of symbols that are placed along it;
+    // it is shared by all symbols of the line.
     SymbolInstance(Anchor& anchor,
                    const GeometryCoordinates& line,
+                   std::shared_ptr<const GeometryCoordinates> collisionLine,
                    const std::pair<Shaping, Shaping>& shapedTextOrientations,
                    optional<PositionedIcon> shapedIcon,
                    const style::SymbolLayoutProperties::Evaluated&,
@@ -36,10 +39,40 @@ public:
     bool hasIcon;
     SymbolQuads glyphQuads;
     optional<SymbolQuad> iconQuad;
-    CollisionFeature textCollisionFeature;
-    CollisionFeature iconCollisionFeature;
+
+    // Makes the collision features of the text and the icon that the symbol has, unless they
+    // were made already. They are only made once the symbol is placed, as symbols of tiles that
+    // are replaced before their placement never need them.
+    void makeCollisionFeatures();
+    optional<CollisionFeature> textCollisionFeature;
+    optional<CollisionFeature> iconCollisionFeature;
+
     WritingModeType writingModes;
     std::size_t featureIndex;
+
+    // Position of the first text and icon quads of the symbol in a bucket that keeps its quads
+    // for placement.
+    uint32_t firstTextQuad = 0;
+    uint32_t firstIconQuad = 0;
+
+private:
+    // The box that a collision feature bounds, relative to the anchor, and how it is placed.
+    class CollisionShape {
+    public:
+        float top;
+        float bottom;
+        float left;
+        float right;
+        float boxScale;
+        float padding;
+        style::SymbolPlacementType placement;
+    };
+
+    Anchor anchor;
+    std::shared_ptr<const GeometryCoordinates> collisionLine;
+    CollisionShape textShape;
+    CollisionShape iconShape;
+    IndexedSubfeature indexedFeature;
 };
 
 } // namespace mbgl
@@ -2,7 +2,7 @@
 #include <mbgl/layout/merge_lines.hpp>
 #include <mbgl/layout/clip_lines.hpp>
 #include <mbgl/renderer/symbol_bucket.hpp>
-#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/bucket_parameters.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
@@ -10,6 +10,7 @@
 #include <mbgl/text/get_anchors.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/text/shaping.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/utf.hpp>
 #include <mbgl/util/token.hpp>
@@ -42,9 +43,10 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
                            const GeometryTileLayer& sourceLayer,
                            IconDependencies& iconDependencies,
                            uintptr_t _spriteAtlasMapIndex,
-                           GlyphDependencies& glyphDependencies)
-    : sourceLayerName(sourceLayer.getName()),
-      bucketName(layers.at(0)->getID()),
+                           GlyphDependencies& glyphDependencies,
+                           const std::string& sharedKey,
+                           std::shared_ptr<const Buffer> encodedData)
+    : bucketName(layers.at(0)->getID()),
       overscaling(parameters.tileID.overscaleFactor()),
       zoom(parameters.tileID.overscaledZ),
       mode(parameters.mode),
@@ -52,7 +54,8 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
       tileSize(util::tileSize * overscaling),
       tilePixelRatio(float(util::EXTENT) / tileSize),
       textSize(layers.at(0)->as<SymbolLayer>()->impl->layout.unevaluated.get<TextSize>()),
-      iconSize(layers.at(0)->as<SymbolLayer>()->impl->layout.unevaluated.get<IconSize>())
+      iconSize(layers.at(0)->as<SymbolLayer>()->impl->layout.unevaluated.get<IconSize>()),
+      obsolete(parameters.obsolete)
     {
 
     const SymbolLayer::Impl& leader = *layers.at(0)->as<SymbolLayer>()->impl;
@@ -94,11 +97,40 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
         ));
     }
 
+    // The features only depend on the zoom level through these properties.
+    const auto& unevaluated = leader.layout.unevaluated;
+    const bool shareable = !sharedKey.empty() && encodedData &&
+        unevaluated.get<TextField>().isZoomConstant() &&
+        unevaluated.get<TextTransform>().isZoomConstant() &&
+        unevaluated.get<TextFont>().isZoomConstant() &&
+        unevaluated.get<IconImage>().isZoomConstant() &&
+        unevaluated.get<SymbolPlacement>().isZoomConstant();
+
+    SymbolFeatureCache& featureCache = SymbolFeatureCache::get();
+    if (shareable) {
+        features = featureCache.find(sharedKey, *encodedData);
+        if (features) {
+            for (const auto& dependency : features->glyphDependencies) {
+                glyphDependencies[dependency.first].insert(dependency.second.begin(), dependency.second.end());
+            }
+            iconDependencies.insert(features->iconDependencies.begin(), features->iconDependencies.end());
+            return;
+        }
+    }
+
+    auto read = std::make_shared<SymbolFeatureCache::Features>();
+    read->data = std::move(encodedData);
+
     // Determine glyph dependencies
     const size_t featureCount = sourceLayer.featureCount();
     for (size_t i = 0; i < featureCount; ++i) {
-        auto feature = sourceLayer.getFeature(i);
-        if (!leader.filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
+        // The features of a tile that is gone are neither kept nor shared.
+        if (isObsolete()) {
+            return;
+        }
+
+        auto feature = sourceLayer.getMatchingFeature(i, *leader.compiledFilter);
+        if (!feature)
             continue;
         
         SymbolFeature ft(std::move(feature));
@@ -139,10 +171,11 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
             ft.text = applyArabicShaping(util::utf8_to_utf16::convert(u8string));
 
             // Loop through all characters of this text and collect unique codepoints.
+            GlyphIDs& glyphIDs = read->glyphDependencies[layout.get<TextFont>()];
             for (char16_t chr : *ft.text) {
-                glyphDependencies[layout.get<TextFont>()].insert(chr);
+                glyphIDs.insert(chr);
                 if (char16_t verticalChr = util::i18n::verticalizePunctuation(chr)) {
-                    glyphDependencies[layout.get<TextFont>()].insert(verticalChr);
+                    glyphIDs.insert(verticalChr);
                 }
             }
         }
@@ -153,24 +186,34 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
                 icon = util::replaceTokens(icon, getValue);
             }
             ft.icon = icon;
-            iconDependencies.insert(*ft.icon);
+            read->iconDependencies.insert(*ft.icon);
         }
 
         if (ft.text || ft.icon) {
-            features.push_back(std::move(ft));
+            read->features.push_back(std::move(ft));
         }
     }
 
     if (layout.get<SymbolPlacement>() == SymbolPlacementType::Line) {
-        util::mergeLines(features);
+        util::mergeLines(read->features);
     }
+
+    for (const auto& dependency : read->glyphDependencies) {
+        glyphDependencies[dependency.first].insert(dependency.second.begin(), dependency.second.end());
+    }
+    iconDependencies.insert(read->iconDependencies.begin(), read->iconDependencies.end());
+
+    if (shareable) {
+        featureCache.add(sharedKey, read);
+    }
+    features = std::move(read);
 }
 
 bool SymbolLayout::hasSymbolInstances() const {
     return !symbolInstances.empty();
 }
 
-void SymbolLayout::prepare(const GlyphPositionMap& glyphs, const IconAtlasMap& iconMap) {
+void SymbolLayout::prepare(const GlyphPositionMap& glyphs, const IconAtlasMap& iconMap, ShapingCache* shapingCache) {
     float horizontalAlign = 0.5;
     float verticalAlign = 0.5;
 
@@ -216,7 +259,15 @@ void SymbolLayout::prepare(const GlyphPositionMap& glyphs, const IconAtlasMap& i
     const bool textAlongLine = layout.get<TextRotationAlignment>() == AlignmentType::Map &&
         layout.get<SymbolPlacement>() == SymbolPlacementType::Line;
 
-    for (auto it = features.begin(); it != features.end(); ++it) {
+    if (!features) {
+        return;
+    }
+
+    for (auto it = features->features.begin(); it != features->features.end(); ++it) {
+        if (isObsolete()) {
+            return;
+        }
+
         auto& feature = *it;
         if (feature.geometry.empty()) continue;
 
@@ -228,10 +279,11 @@ void SymbolLayout::prepare(const GlyphPositionMap& glyphs, const IconAtlasMap& i
         if (feature.text) {
             auto glyphPositions = glyphs.find(layout.get<TextFont>());
             if (glyphPositions != glyphs.end()) { // If there are no glyphs available for this feature, skip shaping
-                auto applyShaping = [&] (const std::u16string& text, WritingModeType writingMode) {
+                auto applyShaping = [&] (const std::u16string& text, WritingModeType writingMode) -> Shaping {
                     const float oneEm = 24.0f;
-                    const Shaping result = getShaping(
+                    ShapingCache::Key key {
                         /* string */ text,
+                        /* font stack */ layout.get<TextFont>(),
                         /* maxWidth: ems */ layout.get<SymbolPlacement>() != SymbolPlacementType::Line ?
                             layout.get<TextMaxWidth>() * oneEm : 0,
                         /* lineHeight: ems */ layout.get<TextLineHeight>() * oneEm,
@@ -241,11 +293,16 @@ void SymbolLayout::prepare(const GlyphPositionMap& glyphs, const IconAtlasMap& i
                         /* spacing: ems */ layout.get<TextLetterSpacing>() * oneEm,
                         /* translate */ Point<float>(layout.evaluate<TextOffset>(zoom, feature)[0] * oneEm, layout.evaluate<TextOffset>(zoom, feature)[1] * oneEm),
                         /* verticalHeight */ oneEm,
-                        /* writingMode */ writingMode,
-                        /* bidirectional algorithm object */ bidi,
-                        /* glyphs */ glyphPositions->second);
+                        /* writingMode */ writingMode
+                    };
+
+                    if (shapingCache) {
+                        return *shapingCache->getShaping(std::move(key), bidi, glyphPositions->second);
+                    }
 
-                    return result;
+                    return getShaping(key.text, key.maxWidth, key.lineHeight, key.horizontalAlign,
+                                      key.verticalAlign, key.justify, key.spacing, key.translate,
+                                      key.verticalHeight, key.writingMode, bidi, glyphPositions->second);
                 };
 
                 shapedTextOrientations.first = applyShaping(*feature.text, WritingModeType::Horizontal);
@@ -280,10 +337,8 @@ void SymbolLayout::prepare(const GlyphPositionMap& glyphs, const IconAtlasMap& i
         // if either shapedText or icon position is present, add the feature
         if (shapedTextOrientations.first || shapedIcon) {
             auto glyphPositionsIt = glyphs.find(layout.get<TextFont>());
-            addFeature(std::distance(features.begin(), it), feature, shapedTextOrientations, shapedIcon, glyphPositionsIt == glyphs.end() ? GlyphPositions() : glyphPositionsIt->second);
+            addFeature(std::distance(features->features.begin(), it), feature, shapedTextOrientations, shapedIcon, glyphPositionsIt == glyphs.end() ? GlyphPositions() : glyphPositionsIt->second);
         }
-        
-        feature.geometry.clear();
     }
 
     compareText.clear();
@@ -322,9 +377,11 @@ void SymbolLayout::addFeature(const std::size_t index,
                                                   ? SymbolPlacementType::Point
                                                   : layout.get<SymbolPlacement>();
     const float textRepeatDistance = symbolSpacing / 2;
-    IndexedSubfeature indexedFeature = {feature.index, sourceLayerName, bucketName, symbolInstances.size()};
+    IndexedSubfeature indexedFeature = { feature.index, sourceLayerID, bucketID,
+                                         static_cast<uint32_t>(symbolInstances.size()) };
     
-    auto addSymbolInstance = [&] (const GeometryCoordinates& line, Anchor& anchor) {
+    auto addSymbolInstance = [&] (const GeometryCoordinates& line, Anchor& anchor,
+                                  std::shared_ptr<const GeometryCoordinates> collisionLine) {
         // https://github.com/mapbox/vector-tile-spec/tree/master/2.1#41-layers
         // +-------------------+ Symbols with anchors located on tile edges
         // |(0,0)             || are duplicated on neighbor tiles.
@@ -345,7 +402,7 @@ void SymbolLayout::addFeature(const std::size_t index,
 
         const bool addToBuffers = mode == MapMode::Still || withinPlus0;
 
-        symbolInstances.emplace_back(anchor, line, shapedTextOrientations, shapedIcon,
+        symbolInstances.emplace_back(anchor, line, std::move(collisionLine), shapedTextOrientations, shapedIcon,
                 layout.evaluate(zoom, feature), layoutTextSize,
                 addToBuffers, symbolInstances.size(),
                 textBoxScale, textPadding, textPlacement,
@@ -369,9 +426,16 @@ void SymbolLayout::addFeature(const std::size_t index,
                                          textMaxBoxScale,
                                          overscaling);
 
+            // The collision features of the symbols along the line are made from a copy of it
+            // that they share, if either their text or their icon follows the line.
+            std::shared_ptr<const GeometryCoordinates> collisionLine;
             for (auto& anchor : anchors) {
                 if (!feature.text || !anchorIsTooClose(*feature.text, textRepeatDistance, anchor)) {
-                    addSymbolInstance(line, anchor);
+                    if (!collisionLine && (textPlacement == SymbolPlacementType::Line ||
+                                           iconPlacement == SymbolPlacementType::Line)) {
+                        collisionLine = std::make_shared<const GeometryCoordinates>(line);
+                    }
+                    addSymbolInstance(line, anchor, collisionLine);
                 }
             }
         }
@@ -389,18 +453,18 @@ void SymbolLayout::addFeature(const std::size_t index,
             // 1 pixel worth of precision, in tile coordinates
             auto poi = mapbox::polylabel(poly, double(util::EXTENT / util::tileSize));
             Anchor anchor(poi.x, poi.y, 0, minScale);
-            addSymbolInstance(polygon[0], anchor);
+            addSymbolInstance(polygon[0], anchor, nullptr);
         }
     } else if (type == FeatureType::LineString) {
         for (const auto& line : feature.geometry) {
             Anchor anchor(line[0].x, line[0].y, 0, minScale);
-            addSymbolInstance(line, anchor);
+            addSymbolInstance(line, anchor, nullptr);
         }
     } else if (type == FeatureType::Point) {
         for (const auto& points : feature.geometry) {
             for (const auto& point : points) {
                 Anchor anchor(point.x, point.y, 0, minScale);
-                addSymbolInstance({point}, anchor);
+                addSymbolInstance({point}, anchor, nullptr);
             }
         }
     }
@@ -421,9 +485,7 @@ bool SymbolLayout::anchorIsTooClose(const std::u16string& text, const float repe
     return false;
 }
 
-std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile) {
-    auto bucket = std::make_unique<SymbolBucket>(layout, layerPaintProperties, textSize, iconSize, zoom, sdfIcons, iconsNeedLinear);
-
+std::pair<std::shared_ptr<SymbolBucket>, optional<SymbolBucket::Placement>> SymbolLayout::place(CollisionTile& collisionTile) {
     // Calculate which labels can be shown and when they can be shown and
     // create the bufers used for rendering.
 
@@ -439,6 +501,25 @@ std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile)
 
     const bool keepUpright = layout.get<TextKeepUpright>();
 
+    // Collision boxes are drawn as they were placed. Otherwise the quads of all symbols are
+    // added once, and placing them again only changes the zoom levels from which they are shown,
+    // and the order in which the bucket draws the symbols that may overlap.
+    const bool keepQuads = !collisionTile.config.debug;
+
+    std::shared_ptr<SymbolBucket> bucket;
+    optional<SymbolBucket::Placement> placement;
+    if (keepQuads && quadsBucket) {
+        bucket = quadsBucket;
+        placement.emplace();
+        placement->text.resize(textQuadCount);
+        placement->icon.resize(iconQuadCount);
+        placement->angle = collisionTile.config.angle;
+    } else {
+        bucket = std::make_shared<SymbolBucket>(layout, layerPaintProperties, textSize, iconSize, zoom, sdfIcons, iconsNeedLinear);
+        bucket->keepsQuadsForPlacement = keepQuads;
+        quadsBucket = keepQuads ? bucket : nullptr;
+    }
+
     // Sort symbols by their y position on the canvas so that they lower symbols
     // are drawn on top of higher symbols.
     // Don't sort symbols that won't overlap because it isn't necessary and
@@ -457,21 +538,31 @@ std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile)
     }
 
     for (SymbolInstance &symbolInstance : symbolInstances) {
+        if (isObsolete()) {
+            break;
+        }
+
+        if (!placement) {
+            symbolInstance.firstTextQuad = bucket->text.vertices.vertexSize();
+            symbolInstance.firstIconQuad = bucket->icon.vertices.vertexSize();
+        }
 
         const bool hasText = symbolInstance.hasText;
         const bool hasIcon = symbolInstance.hasIcon;
 
+        symbolInstance.makeCollisionFeatures();
+
         const bool iconWithoutText = layout.get<TextOptional>() || !hasText;
         const bool textWithoutIcon = layout.get<IconOptional>() || !hasIcon;
 
         // Calculate the scales at which the text and icon can be placed without collision.
 
         float glyphScale = hasText ?
-            collisionTile.placeFeature(symbolInstance.textCollisionFeature,
+            collisionTile.placeFeature(*symbolInstance.textCollisionFeature,
                     layout.get<TextAllowOverlap>(), layout.get<SymbolAvoidEdges>()) :
             collisionTile.minScale;
         float iconScale = hasIcon ?
-            collisionTile.placeFeature(symbolInstance.iconCollisionFeature,
+            collisionTile.placeFeature(*symbolInstance.iconCollisionFeature,
                     layout.get<IconAllowOverlap>(), layout.get<SymbolAvoidEdges>()) :
             collisionTile.minScale;
 
@@ -486,82 +577,107 @@ std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile)
             iconScale = util::max(iconScale, glyphScale);
         }
 
-        const auto& feature = features.at(symbolInstance.featureIndex);
+        const auto& feature = features->features.at(symbolInstance.featureIndex);
 
         // Insert final placement into collision tree and add glyphs/icons to buffers
 
-        if (hasText) {
-            const float placementZoom = util::max(util::log2(glyphScale) + zoom, 0.0f);
-            collisionTile.insertFeature(symbolInstance.textCollisionFeature, glyphScale, layout.get<TextIgnorePlacement>());
-            if (glyphScale < collisionTile.maxScale) {
-                for (const auto& symbol : symbolInstance.glyphQuads) {
-                    addSymbol(
-                        bucket->text, *bucket->textSizeBinder, symbol, feature, placementZoom,
-                        keepUpright, textPlacement, collisionTile.config.angle, symbolInstance.writingModes);
+        uint32_t textQuad = symbolInstance.firstTextQuad;
+        uint32_t iconQuad = symbolInstance.firstIconQuad;
+
+        auto addQuad = [&] (auto& buffer, SymbolSizeBinder& sizeBinder, std::vector<SymbolQuadPlacement>* quads, uint32_t& quad,
+                            const SymbolQuad& symbol, const float scale, const SymbolPlacementType symbolPlacement) {
+            if (!keepQuads && scale >= collisionTile.maxScale) {
+                return;
+            }
+
+            const float placementZoom = util::max(util::log2(scale) + zoom, 0.0f);
+            const optional<SymbolQuadPlacement> quadPlacement = scale < collisionTile.maxScale
+                ? placeQuad(symbol, placementZoom, keepUpright, symbolPlacement, collisionTile.config.angle, symbolInstance.writingModes)
+                : optional<SymbolQuadPlacement>();
+
+            if (quads) {
+                if (hasZoomRange(symbol)) {
+                    quads->at(quad++) = quadPlacement.value_or(SymbolQuadPlacement::hidden());
                 }
+            } else if (quadPlacement || (keepQuads && hasZoomRange(symbol))) {
+                addSymbol(buffer, sizeBinder, symbol, feature, quadPlacement.value_or(SymbolQuadPlacement::hidden()));
+            }
+        };
+
+        if (hasText) {
+            collisionTile.insertFeature(*symbolInstance.textCollisionFeature, glyphScale, layout.get<TextIgnorePlacement>());
+            for (const auto& symbol : symbolInstance.glyphQuads) {
+                addQuad(bucket->text, *bucket->textSizeBinder, placement ? &placement->text : nullptr, textQuad,
+                        symbol, glyphScale, textPlacement);
             }
         }
 
         if (hasIcon) {
-            const float placementZoom = util::max(util::log2(iconScale) + zoom, 0.0f);
-            collisionTile.insertFeature(symbolInstance.iconCollisionFeature, iconScale, layout.get<IconIgnorePlacement>());
-            if (iconScale < collisionTile.maxScale && symbolInstance.iconQuad) {
-                addSymbol(
-                    bucket->icon, *bucket->iconSizeBinder, *symbolInstance.iconQuad, feature, placementZoom,
-                    keepUpright, iconPlacement, collisionTile.config.angle, symbolInstance.writingModes);
+            collisionTile.insertFeature(*symbolInstance.iconCollisionFeature, iconScale, layout.get<IconIgnorePlacement>());
+            if (symbolInstance.iconQuad) {
+                addQuad(bucket->icon, *bucket->iconSizeBinder, placement ? &placement->icon : nullptr, iconQuad,
+                        *symbolInstance.iconQuad, iconScale, iconPlacement);
             }
         }
-        
-        for (auto& pair : bucket->paintPropertyBinders) {
-            pair.second.first.populateVertexVectors(feature, bucket->icon.vertices.vertexSize());
-            pair.second.second.populateVertexVectors(feature, bucket->text.vertices.vertexSize());
+
+        if (!placement) {
+            for (auto& pair : bucket->paintPropertyBinders) {
+                pair.second.first.populateVertexVectors(feature, bucket->icon.vertices.vertexSize());
+                pair.second.second.populateVertexVectors(feature, bucket->text.vertices.vertexSize());
+            }
+            if (keepQuads && mayOverlap) {
+                bucket->sortedSymbols.push_back({
+                    symbolInstance.point,
+                    symbolInstance.index,
+                    symbolInstance.firstTextQuad,
+                    symbolInstance.firstIconQuad,
+                    static_cast<uint16_t>(bucket->text.vertices.vertexSize() - symbolInstance.firstTextQuad),
+                    static_cast<uint16_t>(bucket->icon.vertices.vertexSize() - symbolInstance.firstIconQuad)
+                });
+            }
         }
     }
 
+    if (!placement && keepQuads) {
+        textQuadCount = bucket->text.vertices.vertexSize();
+        iconQuadCount = bucket->icon.vertices.vertexSize();
+    }
+
     if (collisionTile.config.debug) {
         addToDebugBuffers(collisionTile, *bucket);
     }
 
-    return bucket;
+    return { std::move(bucket), std::move(placement) };
 }
 
-template <typename Buffer>
-void SymbolLayout::addSymbol(Buffer& buffer,
-                             SymbolSizeBinder& sizeBinder,
-                             const SymbolQuad& symbol,
-                             const SymbolFeature& feature,
-                             const float placementZoom,
-                             const bool keepUpright,
-                             const style::SymbolPlacementType placement,
-                             const float placementAngle,
-                             const WritingModeType writingModes) {
-    constexpr const uint16_t vertexLength = 4;
-
-    const auto &tl = symbol.tl;
-    const auto &tr = symbol.tr;
-    const auto &bl = symbol.bl;
-    const auto &br = symbol.br;
-    const auto &tex = symbol.tex;
+bool SymbolLayout::hasZoomRange(const SymbolQuad& symbol) const {
+    return util::min(zoom + util::log2(symbol.maxScale), util::MAX_ZOOM_F) > zoom + util::log2(symbol.minScale);
+}
 
+optional<SymbolQuadPlacement> SymbolLayout::placeQuad(const SymbolQuad& symbol,
+                                                      const float placementZoom,
+                                                      const bool keepUpright,
+                                                      const style::SymbolPlacementType placement,
+                                                      const float placementAngle,
+                                                      const WritingModeType writingModes) const {
     float minZoom = util::max(zoom + util::log2(symbol.minScale), placementZoom);
     float maxZoom = util::min(zoom + util::log2(symbol.maxScale), util::MAX_ZOOM_F);
-    const auto &anchorPoint = symbol.anchorPoint;
 
     // drop incorrectly oriented glyphs
     const float a = std::fmod(symbol.anchorAngle + placementAngle + M_PI, M_PI * 2);
     if (writingModes & WritingModeType::Vertical) {
         if (placement == style::SymbolPlacementType::Line && symbol.writingMode == WritingModeType::Vertical) {
             if (keepUpright && placement == style::SymbolPlacementType::Line && (a <= (M_PI * 5 / 4) || a > (M_PI * 7 / 4)))
-                return;
+                return {};
         } else if (keepUpright && placement == style::SymbolPlacementType::Line && (a <= (M_PI * 3 / 4) || a > (M_PI * 5 / 4)))
-            return;
+            return {};
     } else if (keepUpright && placement == style::SymbolPlacementType::Line &&
         (a <= M_PI / 2 || a > M_PI * 3 / 2)) {
-        return;
+        return {};
     }
 
     if (maxZoom <= minZoom)
-        return;
+        return {};
 
     // Lower min zoom so that while fading out the label
     // it can be shown outside of collision-free zoom levels
@@ -569,37 +685,26 @@ void SymbolLayout::addSymbol(Buffer& buffer,
         minZoom = 0;
     }
 
-    if (buffer.segments.empty() || buffer.segments.back().vertexLength + vertexLength > std::numeric_limits<uint16_t>::max()) {
-        buffer.segments.emplace_back(buffer.vertices.vertexSize(), buffer.triangles.indexSize());
-    }
+    return SymbolQuadPlacement::fromZoom(minZoom, placementZoom);
+}
 
-    // We're generating triangle fans, so we always start with the first
-    // coordinate in this polygon.
-    auto& segment = buffer.segments.back();
-    assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
-    uint16_t index = segment.vertexLength;
+template <typename Buffer>
+void SymbolLayout::addSymbol(Buffer& buffer,
+                             SymbolSizeBinder& sizeBinder,
+                             const SymbolQuad& symbol,
+                             const SymbolFeature& feature,
+                             const SymbolQuadPlacement placement) {
+    const float maxZoom = util::min(zoom + util::log2(symbol.maxScale), util::MAX_ZOOM_F);
 
     // Encode angle of glyph
     uint8_t glyphAngle = std::round((symbol.glyphAngle / (M_PI * 2)) * 256);
 
-    // coordinates (2 triangles)
-    buffer.vertices.emplace_back(SymbolLayoutAttributes::vertex(anchorPoint, tl, tex.x, tex.y,
-                        minZoom, maxZoom, placementZoom, glyphAngle));
-    buffer.vertices.emplace_back(SymbolLayoutAttributes::vertex(anchorPoint, tr, tex.x + tex.w, tex.y,
-                        minZoom, maxZoom, placementZoom, glyphAngle));
-    buffer.vertices.emplace_back(SymbolLayoutAttributes::vertex(anchorPoint, bl, tex.x, tex.y + tex.h,
-                        minZoom, maxZoom, placementZoom, glyphAngle));
-    buffer.vertices.emplace_back(SymbolLayoutAttributes::vertex(anchorPoint, br, tex.x + tex.w, tex.y + tex.h,
-                        minZoom, maxZoom, placementZoom, glyphAngle));
-    
-    sizeBinder.populateVertexVector(feature);
-
-    // add the two triangles, referencing the four coordinates we just inserted.
-    buffer.triangles.emplace_back(index + 0, index + 1, index + 2);
-    buffer.triangles.emplace_back(index + 1, index + 2, index + 3);
+    auto instance = SymbolInstanceAttributes::instance(symbol.anchorPoint, symbol.tl, symbol.tr, symbol.bl,
+                                                       symbol.tex, maxZoom, glyphAngle);
+    SymbolLayoutAttributes::place(instance, placement);
+    buffer.vertices.emplace_back(instance);
 
-    segment.vertexLength += vertexLength;
-    segment.indexLength += 6;
+    sizeBinder.populateVertexVector(feature);
 }
 
 void SymbolLayout::addToDebugBuffers(CollisionTile& collisionTile, SymbolBucket& bucket) {
@@ -653,8 +758,12 @@ void SymbolLayout::addToDebugBuffers(CollisionTile& collisionTile, SymbolBucket&
                 segment.indexLength += indexLength;
             }
         };
-        populateCollisionBox(symbolInstance.textCollisionFeature);
-        populateCollisionBox(symbolInstance.iconCollisionFeature);
+        if (symbolInstance.textCollisionFeature) {
+            populateCollisionBox(*symbolInstance.textCollisionFeature);
+        }
+        if (symbolInstance.iconCollisionFeature) {
+            populateCollisionBox(*symbolInstance.iconCollisionFeature);
+        }
     }
 }
 
@@ -3,11 +3,15 @@
 #include <mbgl/map/mode.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 #include <mbgl/layout/symbol_feature.hpp>
+#include <mbgl/layout/symbol_feature_cache.hpp>
 #include <mbgl/layout/symbol_instance.hpp>
 #include <mbgl/text/bidi.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/programs/symbol_program.hpp>
+#include <mbgl/renderer/symbol_bucket.hpp>
+#include <mbgl/util/optional.hpp>
 
+#include <atomic>
 #include <memory>
 #include <map>
 #include <unordered_set>
@@ -17,8 +21,8 @@ namespace mbgl {
 
 class GeometryTileLayer;
 class CollisionTile;
-class SymbolBucket;
 class Anchor;
+class ShapingCache;
 
 namespace style {
 class BucketParameters;
@@ -28,19 +32,38 @@ class Layer;
 
 class SymbolLayout {
 public:
+    // Reads the features through the SymbolFeatureCache when given the key of the layers and the
+    // encoded data of the tile.
     SymbolLayout(const style::BucketParameters&,
                  const std::vector<const style::Layer*>&,
                  const GeometryTileLayer&,
                  IconDependencies&,
                  uintptr_t,
-                 GlyphDependencies&);
+                 GlyphDependencies&,
+                 const std::string& sharedKey = {},
+                 std::shared_ptr<const Buffer> encodedData = nullptr);
 
-    void prepare(const GlyphPositionMap& glyphs, const IconAtlasMap& icons);
+    // Shapes the text of the features, through the cache if one is given.
+    void prepare(const GlyphPositionMap& glyphs, const IconAtlasMap& icons, ShapingCache* = nullptr);
 
-    std::unique_ptr<SymbolBucket> place(CollisionTile&);
+    // Places the symbols, and returns a new bucket for them. When the quads of the bucket that was
+    // returned before can be kept, returns that bucket instead, together with the new placement
+    // of its quads for SymbolBucket::setPlacement().
+    std::pair<std::shared_ptr<SymbolBucket>, optional<SymbolBucket::Placement>> place(CollisionTile&);
 
     bool hasSymbolInstances() const;
 
+    const std::string& getBucketName() const {
+        return bucketName;
+    }
+
+    // Sets the IDs that the tile's FeatureIndex refers to the source layer and the bucket by,
+    // before prepare() adds the features.
+    void setFeatureIndexIDs(uint16_t sourceLayerID_, uint16_t bucketID_) {
+        sourceLayerID = sourceLayerID_;
+        bucketID = bucketID_;
+    }
+
     enum State {
         Pending,  // Waiting for the necessary glyphs or icons to be available.
         Placed    // The final positions have been determined, taking into account prior layers.
@@ -63,20 +86,29 @@ private:
 
     void addToDebugBuffers(CollisionTile&, SymbolBucket&);
 
-    // Adds placed items to the buffer.
+    // Returns whether a quad can be shown at all, regardless of its placement.
+    bool hasZoomRange(const SymbolQuad&) const;
+
+    // Returns the zoom levels from which a quad is shown when its symbol is placed at the given
+    // zoom level, or nothing if the quad isn't shown at that angle.
+    optional<SymbolQuadPlacement> placeQuad(const SymbolQuad&,
+                                            float placementZoom,
+                                            const bool keepUpright,
+                                            const style::SymbolPlacementType,
+                                            const float placementAngle,
+                                            WritingModeType writingModes) const;
+
+    // Adds items to the buffer.
     template <typename Buffer>
     void addSymbol(Buffer&,
                    SymbolSizeBinder& sizeBinder,
                    const SymbolQuad&,
                    const SymbolFeature& feature,
-                   float scale,
-                   const bool keepUpright,
-                   const style::SymbolPlacementType,
-                   const float placementAngle,
-                   WritingModeType writingModes);
+                   SymbolQuadPlacement);
 
-    const std::string sourceLayerName;
     const std::string bucketName;
+    uint16_t sourceLayerID = 0;
+    uint16_t bucketID = 0;
     const float overscaling;
     const float zoom;
     const MapMode mode;
@@ -94,10 +126,24 @@ private:
     style::TextSize::UnevaluatedType textSize;
     style::IconSize::UnevaluatedType iconSize;
 
+    // Set once the tile is being destroyed; see style::BucketParameters. A layout that stops
+    // early is never placed again.
+    const std::atomic<bool>* obsolete;
+    bool isObsolete() const {
+        return obsolete && *obsolete;
+    }
+
     std::vector<SymbolInstance> symbolInstances;
-    std::vector<SymbolFeature> features;
+    // Shared with the layouts of other tiles of the same canonical tile; must not be modified.
+    std::shared_ptr<const SymbolFeatureCache::Features> features;
+
+    // The most recent bucket with the quads of all symbols, which placing the symbols again
+    // reuses. The bucket is shared with the tile; it must not be modified here once returned.
+    std::shared_ptr<SymbolBucket> quadsBucket;
+    std::size_t textQuadCount = 0;
+    std::size_t iconQuadCount = 0;
 
-    BiDi bidi; // Consider moving this up to geometry tile worker to reduce reinstantiation costs; use of BiDi/ubiditransform object must be constrained to one thread
+    BiDi bidi;
 };
 
 } // namespace mbgl
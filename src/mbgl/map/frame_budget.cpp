@@ -0,0 +1,40 @@
+#include <mbgl/map/frame_budget.hpp>
+
+namespace mbgl {
+
+constexpr uint32_t FrameBudget::settleFrames;
+
+void FrameBudget::setTarget(Duration target_) {
+    target = target_;
+    if (target == Duration::zero()) {
+        restore();
+    }
+}
+
+bool FrameBudget::record(Duration frameTime) {
+    if (target == Duration::zero()) {
+        return false;
+    }
+
+    // An exponential moving average, so that a single slow frame, e.g. one that compiles a
+    // program, doesn't lower the quality.
+    average = frames == 0 ? frameTime : (average * 4 + frameTime) / 5;
+    if (++frames < settleFrames || average <= target || quality == RenderQuality::Lowest) {
+        return false;
+    }
+
+    quality = RenderQuality(underlying_type(quality) + 1);
+    frames = 0;
+    return true;
+}
+
+bool FrameBudget::restore() {
+    frames = 0;
+    if (quality == RenderQuality::Full) {
+        return false;
+    }
+    quality = RenderQuality::Full;
+    return true;
+}
+
+} // namespace mbgl
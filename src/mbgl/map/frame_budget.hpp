@@ -0,0 +1,37 @@
+#pragma once
+
+#include <mbgl/map/mode.hpp>
+#include <mbgl/util/chrono.hpp>
+
+#include <cstdint>
+
+namespace mbgl {
+
+// Tracks how long frames take to render, and lowers the render quality one level at a time
+// while they take longer than the target.
+class FrameBudget {
+public:
+    // A target of zero disables the budget, and frames are always rendered in full quality.
+    void setTarget(Duration);
+    Duration getTarget() const { return target; }
+
+    RenderQuality getQuality() const { return quality; }
+
+    // Records the time a frame took to render. Returns true if the quality of the next frame
+    // changes.
+    bool record(Duration frameTime);
+
+    // Goes back to full quality, e.g. once the map is idle. Returns true if the quality changes.
+    bool restore();
+
+    // The number of frames averaged before the quality is lowered again.
+    static constexpr uint32_t settleFrames = 10;
+
+private:
+    Duration target = Duration::zero();
+    RenderQuality quality = RenderQuality::Full;
+    Duration average = Duration::zero();
+    uint32_t frames = 0;
+};
+
+} // namespace mbgl
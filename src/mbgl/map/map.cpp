@@ -1,18 +1,41 @@
 #include <mbgl/map/map.hpp>
 #include <mbgl/map/camera.hpp>
+#include <mbgl/map/metatile.hpp>
 #include <mbgl/map/view.hpp>
 #include <mbgl/map/backend.hpp>
 #include <mbgl/map/backend_scope.hpp>
 #include <mbgl/map/transform.hpp>
+#include <mbgl/map/frame_budget.hpp>
+#include <mbgl/map/tile_snapshot.hpp>
 #include <mbgl/map/transform_state.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/style/style.hpp>
+#include <mbgl/style/style_snapshot.hpp>
 #include <mbgl/style/source.hpp>
 #include <mbgl/style/layer.hpp>
+#include <mbgl/style/layers/background_layer.hpp>
+#include <mbgl/style/layers/custom_layer.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/hillshade_layer.hpp>
+#include <mbgl/style/layers/raster_layer.hpp>
 #include <mbgl/style/observer.hpp>
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/renderer/painter.hpp>
+#include <mbgl/programs/programs.hpp>
+#include <mbgl/programs/program_pack.hpp>
+#include <mbgl/programs/binary_program.hpp>
+#include <mbgl/style/source_impl.hpp>
+#include <mbgl/style/tile_source_impl.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/tile/tile.hpp>
+#include <mbgl/tile/shared_layout_cache.hpp>
+#include <mbgl/renderer/tessellation_cache.hpp>
+#include <mbgl/tile/tile_trace.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/text/glyph_store.hpp>
+#include <mbgl/geometry/line_atlas.hpp>
+#include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
@@ -21,17 +44,35 @@
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/exception.hpp>
 #include <mbgl/util/async_task.hpp>
+#include <mbgl/util/timer.hpp>
 #include <mbgl/util/mapbox.hpp>
 #include <mbgl/util/tile_coordinate.hpp>
 #include <mbgl/actor/scheduler.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/string.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/math/log2.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <set>
+
 namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+// When a continuous map of the process last drew a frame, in Clock ticks, so that still maps
+// that yield to them can tell whether one is being interacted with or animated.
+std::atomic<Clock::rep> lastContinuousFrame { Clock::time_point::min().time_since_epoch().count() };
+
+// How long after a continuous map drew a frame a yielding still map waits before rendering.
+const Duration continuousFrameGrace = Milliseconds(100);
+
+} // namespace
+
 enum class RenderState : uint8_t {
     Never,
     Partial,
@@ -39,12 +80,26 @@ enum class RenderState : uint8_t {
 };
 
 struct StillImageRequest {
-    StillImageRequest(View& view_, Map::StillImageCallback&& callback_)
-        : view(view_), callback(std::move(callback_)) {
+    StillImageRequest(View& view_,
+                      Map::StillImagesCallback&& callback_,
+                      std::vector<CameraOptions> cameras_,
+                      std::vector<TransformState> states_)
+        : view(view_),
+          callback(std::move(callback_)),
+          cameras(std::move(cameras_)),
+          states(std::move(states_)) {
     }
 
     View& view;
-    Map::StillImageCallback callback;
+    Map::StillImagesCallback callback;
+
+    // The cameras of a batch and their transform states; empty for a single image of the
+    // current camera.
+    const std::vector<CameraOptions> cameras;
+    const std::vector<TransformState> states;
+
+    // The camera that is rendered next.
+    std::size_t index = 0;
 };
 
 class Map::Impl : public style::Observer {
@@ -58,7 +113,8 @@ public:
          GLContextMode,
          ConstrainMode,
          ViewportMode,
-         const std::string& programCacheDir);
+         const std::string& programCacheDir,
+         optional<std::string> localFontFamily);
 
     void onSourceChanged(style::Source&) override;
     void onUpdate(Update) override;
@@ -66,10 +122,13 @@ public:
     void onStyleError(std::exception_ptr) override;
     void onResourceError(std::exception_ptr) override;
 
-    void render(View&);
+    void render(View&, TimePoint);
     void renderStill();
+    void startStillImageRequest(View&, StillImagesCallback&&, std::vector<CameraOptions>);
 
+    void resetStyle();
     void loadStyleJSON(const std::string&);
+    void didLoadStyle();
 
     Map& map;
     MapObserver& observer;
@@ -80,12 +139,23 @@ public:
     RenderState renderState = RenderState::Never;
     Transform transform;
 
+    // The camera of the frame that is being drawn. Tiles are updated and drawn for this copy
+    // rather than for the transform, which observers and still image callbacks may move while
+    // the frame is in progress; such changes take effect in the next frame.
+    TransformState frameState;
+
     const MapMode mode;
     const GLContextMode contextMode;
     const float pixelRatio;
     const std::string programCacheDir;
+    const optional<std::string> localFontFamily;
 
     MapDebugOptions debugOptions { MapDebugOptions::NoDebug };
+    bool releaseBucketData = false;
+    bool layerCaching = false;
+    bool idlePrelayout = false;
+    bool featurePicking = false;
+    bool yieldsToContinuousMaps = false;
 
     Update updateFlags = Update::Nothing;
 
@@ -98,13 +168,36 @@ public:
     bool styleMutated = false;
     bool cameraMutated = false;
 
+    // Set when something changed that the painter can't tell from the camera and the tiles, so
+    // that the next frame is drawn in full rather than only where its tiles changed.
+    bool redrawAll = true;
+
+    FrameBudget frameBudget;
+
     std::unique_ptr<AsyncRequest> styleRequest;
 
+    // Cache lookups of the tiles of a tile snapshot, kept until the map has fully rendered so
+    // that the tiles' own requests can join them.
+    std::vector<std::unique_ptr<AsyncRequest>> snapshotRequests;
+
     size_t sourceCacheSize;
+    std::size_t gpuMemoryBudget = 0;
+    // As of the end of the last frame.
+    std::size_t gpuMemoryUsage = 0;
     bool loading = false;
 
     util::AsyncTask asyncInvalidate;
     std::unique_ptr<StillImageRequest> stillImageRequest;
+    // Renders the still image once the continuous maps of the process have been idle for long
+    // enough; see Map::setYieldsToContinuousMaps().
+    util::Timer yieldTimer;
+
+    FrameStats frameStats;
+    void recordFrameStats(Duration recalculateStyle, Duration updateTiles, Duration cleanup);
+
+    // Releases the buffers of the tiles that aren't rendered while the context holds more than
+    // the GPU memory budget.
+    void enforceMemoryBudget(gl::Context&);
 };
 
 Map::Map(Backend& backend,
@@ -116,7 +209,8 @@ Map::Map(Backend& backend,
          GLContextMode contextMode,
          ConstrainMode constrainMode,
          ViewportMode viewportMode,
-         const std::string& programCacheDir)
+         const std::string& programCacheDir,
+         optional<std::string> localFontFamily)
     : impl(std::make_unique<Impl>(*this,
                                   backend,
                                   pixelRatio,
@@ -126,7 +220,8 @@ Map::Map(Backend& backend,
                                   contextMode,
                                   constrainMode,
                                   viewportMode,
-                                  programCacheDir)) {
+                                  programCacheDir,
+                                  std::move(localFontFamily))) {
     impl->transform.resize(size);
 }
 
@@ -139,7 +234,8 @@ Map::Impl::Impl(Map& map_,
                 GLContextMode contextMode_,
                 ConstrainMode constrainMode_,
                 ViewportMode viewportMode_,
-                const std::string& programCacheDir_)
+                const std::string& programCacheDir_,
+                optional<std::string> localFontFamily_)
     : map(map_),
       observer(backend_),
       backend(backend_),
@@ -148,10 +244,12 @@ Map::Impl::Impl(Map& map_,
       transform(observer,
                 constrainMode_,
                 viewportMode_),
+      frameState(transform.getState()),
       mode(mode_),
       contextMode(contextMode_),
       pixelRatio(pixelRatio_),
       programCacheDir(programCacheDir_),
+      localFontFamily(std::move(localFontFamily_)),
       annotationManager(std::make_unique<AnnotationManager>(pixelRatio)),
       asyncInvalidate([this] {
           if (mode == MapMode::Continuous) {
@@ -167,6 +265,10 @@ Map::~Map() {
 
     impl->styleRequest = nullptr;
 
+    if (impl->transform.isGestureInProgress()) {
+        impl->scheduler.setInteractive(false);
+    }
+
     // Explicit resets currently necessary because these abandon resources that need to be
     // cleaned up by context.reset();
     impl->style.reset();
@@ -180,28 +282,69 @@ void Map::renderStill(View& view, StillImageCallback callback) {
         return;
     }
 
-    if (impl->mode != MapMode::Still) {
-        callback(std::make_exception_ptr(util::MisuseException("Map is not in still image render mode")));
+    impl->startStillImageRequest(view, [callback = std::move(callback)] (std::exception_ptr error, std::size_t) {
+        callback(error);
+    }, {});
+}
+
+void Map::renderStills(View& view, std::vector<CameraOptions> cameras, StillImagesCallback callback) {
+    if (!callback) {
+        Log::Error(Event::General, "StillImagesCallback not set");
         return;
     }
 
-    if (impl->stillImageRequest) {
-        callback(std::make_exception_ptr(util::MisuseException("Map is currently rendering an image")));
+    if (cameras.empty()) {
+        callback(std::make_exception_ptr(util::MisuseException("No cameras to render")), 0);
         return;
     }
 
-    if (!impl->style) {
-        callback(std::make_exception_ptr(util::MisuseException("Map doesn't have a style")));
+    impl->startStillImageRequest(view, std::move(callback), std::move(cameras));
+}
+
+void Map::renderMetatile(View& view, const Metatile& metatile, StillImageCallback callback) {
+    if (impl->mode == MapMode::Still && !impl->stillImageRequest) {
+        setSize(metatile.getSize());
+        jumpTo(metatile.getCamera());
+    }
+    renderStill(view, std::move(callback));
+}
+
+void Map::Impl::startStillImageRequest(View& view, StillImagesCallback&& callback, std::vector<CameraOptions> cameras) {
+    if (mode != MapMode::Still) {
+        callback(std::make_exception_ptr(util::MisuseException("Map is not in still image render mode")), 0);
         return;
     }
 
-    if (impl->style->getLastError()) {
-        callback(impl->style->getLastError());
+    if (stillImageRequest) {
+        callback(std::make_exception_ptr(util::MisuseException("Map is currently rendering an image")), 0);
         return;
     }
 
-    impl->stillImageRequest = std::make_unique<StillImageRequest>(view, std::move(callback));
-    impl->onUpdate(Update::Repaint);
+    if (!style) {
+        callback(std::make_exception_ptr(util::MisuseException("Map doesn't have a style")), 0);
+        return;
+    }
+
+    if (style->getLastError()) {
+        callback(style->getLastError(), 0);
+        return;
+    }
+
+    std::vector<TransformState> states;
+    for (const auto& camera : cameras) {
+        Transform scratch(transform.getState());
+        scratch.jumpTo(camera);
+        states.push_back(scratch.getState());
+    }
+
+    if (!cameras.empty()) {
+        cameraMutated = true;
+        transform.jumpTo(cameras.front());
+    }
+
+    const Update flags = cameras.empty() ? Update::Repaint : Update::RecalculateStyle;
+    stillImageRequest = std::make_unique<StillImageRequest>(view, std::move(callback), std::move(cameras), std::move(states));
+    onUpdate(flags);
 }
 
 void Map::Impl::renderStill() {
@@ -211,25 +354,47 @@ void Map::Impl::renderStill() {
 
     // TODO: determine whether we need activate/deactivate
     BackendScope guard(backend);
-    render(stillImageRequest->view);
+    render(stillImageRequest->view, Clock::now());
+}
+
+void Map::Impl::recordFrameStats(Duration recalculateStyle, Duration updateTiles, Duration cleanup) {
+    frameStats = painter->getFrameStats();
+    frameStats.recalculateStyle = recalculateStyle;
+    frameStats.updateTiles = updateTiles;
+    frameStats.cleanup = cleanup;
+}
+
+void Map::Impl::enforceMemoryBudget(gl::Context& context) {
+    context.setMemoryBudget(gpuMemoryBudget);
+    if (context.isOverBudget()) {
+        style->releaseBuffers([&] { return !context.isOverBudget(); });
+    }
+    gpuMemoryUsage = context.getMemoryUsage();
 }
 
 void Map::triggerRepaint() {
+    impl->redrawAll = true;
     impl->backend.invalidate();
 }
 
 void Map::render(View& view) {
-    impl->render(view);
+    impl->render(view, Clock::now());
+}
+
+void Map::render(View& view, TimePoint presentationTime) {
+    impl->render(view, presentationTime);
 }
 
-void Map::Impl::render(View& view) {
+void Map::Impl::render(View& view, const TimePoint timePoint) {
     if (!style) {
         return;
     }
 
-    TimePoint timePoint = Clock::now();
+    // The time that the frame takes is measured on the clock, whichever time it is drawn for.
+    const TimePoint frameStart = Clock::now();
 
     auto flags = transform.updateTransitions(timePoint);
+    frameState = transform.getState();
 
     updateFlags |= flags;
 
@@ -246,8 +411,12 @@ void Map::Impl::render(View& view) {
         style->cascade(timePoint, mode);
     }
 
-    if (updateFlags & Update::Classes || updateFlags & Update::RecalculateStyle) {
-        style->recalculate(transform.getZoom(), timePoint, mode);
+    Duration recalculateStyle = Duration::zero();
+    const bool styleRecalculated = updateFlags & Update::Classes || updateFlags & Update::RecalculateStyle;
+    if (styleRecalculated) {
+        const TimePoint start = Clock::now();
+        style->recalculate(frameState.getZoom(), timePoint, mode);
+        recalculateStyle = Clock::now() - start;
     }
 
     if (updateFlags & Update::Layout) {
@@ -256,20 +425,45 @@ void Map::Impl::render(View& view) {
 
     style::UpdateParameters parameters(pixelRatio,
                                        debugOptions,
-                                       transform.getState(),
+                                       frameState,
                                        scheduler,
                                        fileSource,
                                        mode,
                                        *annotationManager,
                                        *style);
+    if (mode == MapMode::Continuous) {
+        parameters.prefetchStates = transform.getTransitionPath();
+        parameters.cameraMoving = transform.inTransition() || transform.isGestureInProgress();
+        parameters.prelayout = idlePrelayout;
+    } else if (stillImageRequest) {
+        // Loads the tiles of the cameras that are rendered later along with those of this one,
+        // and keeps them until they are rendered.
+        const auto& states = stillImageRequest->states;
+        if (stillImageRequest->index + 1 < states.size()) {
+            parameters.prefetchStates.assign(states.begin() + stillImageRequest->index + 1, states.end());
+        }
+    }
+    parameters.featurePicking = featurePicking;
+    parameters.multisampling = view.isMultisampled();
 
+    const TimePoint updateTilesStart = Clock::now();
     style->updateTiles(parameters);
+    const Duration updateTiles = Clock::now() - updateTilesStart;
+
+    const bool fullRedraw = redrawAll ||
+        updateFlags & (Update::Classes | Update::RecalculateStyle | Update::Layout | Update::AnnotationStyle);
+    redrawAll = false;
 
     updateFlags = Update::Nothing;
 
     gl::Context& context = backend.getContext();
     if (!painter) {
-        painter = std::make_unique<Painter>(context, transform.getState(), pixelRatio, programCacheDir);
+        painter = std::make_unique<Painter>(context, frameState, pixelRatio, programCacheDir);
+    }
+
+    // Compiles the programs of new layers before their tiles are loaded.
+    if (styleRecalculated) {
+        painter->preparePrograms(*style);
     }
 
     if (mode == MapMode::Continuous) {
@@ -283,16 +477,30 @@ void Map::Impl::render(View& view) {
                               pixelRatio,
                               mode,
                               contextMode,
-                              debugOptions };
+                              debugOptions,
+                              releaseBucketData,
+                              layerCaching,
+                              fullRedraw,
+                              frameBudget.getQuality() };
 
         backend.updateAssumedState();
 
         painter->render(*style,
                         frameData,
                         view,
-                        annotationManager->getSpriteAtlas());
+                        *annotationManager);
+        lastContinuousFrame = frameStart.time_since_epoch().count();
 
+        const TimePoint cleanupStart = Clock::now();
+        enforceMemoryBudget(context);
         painter->cleanup();
+        const TimePoint frameEnd = Clock::now();
+        recordFrameStats(recalculateStyle, updateTiles, frameEnd - cleanupStart);
+
+        if (frameBudget.record(frameEnd - frameStart)) {
+            observer.onRenderQualityChanged(frameBudget.getQuality());
+            redrawAll = true;
+        }
 
         observer.onDidFinishRenderingFrame(style->isLoaded() ? MapObserver::RenderMode::Full : MapObserver::RenderMode::Partial);
 
@@ -300,6 +508,7 @@ void Map::Impl::render(View& view) {
             renderState = RenderState::Partial;
         } else if (renderState != RenderState::Fully) {
             renderState = RenderState::Fully;
+            snapshotRequests.clear();
             observer.onDidFinishRenderingMap(MapObserver::RenderMode::Full);
             if (loading) {
                 loading = false;
@@ -313,17 +522,44 @@ void Map::Impl::render(View& view) {
             flags |= Update::Repaint;
         }
 
+        // The picking buffer is only drawn once the map has come to rest, rather than in every
+        // frame of an animation.
+        if (featurePicking && flags == Update::Nothing) {
+            painter->renderPicking(*style, view);
+        }
+
+        // Once the map is idle, it is drawn again at full quality.
+        if (flags == Update::Nothing && frameBudget.restore()) {
+            observer.onRenderQualityChanged(frameBudget.getQuality());
+            redrawAll = true;
+            flags |= Update::Repaint;
+        }
+
         // Only schedule an update if we need to paint another frame due to transitions or
         // animations that are still in progress
         if (flags != Update::Nothing) {
             onUpdate(flags);
         }
     } else if (stillImageRequest && style->isLoaded()) {
+        if (yieldsToContinuousMaps) {
+            const TimePoint resume = TimePoint(Duration(lastContinuousFrame.load())) + continuousFrameGrace;
+            if (resume > frameStart) {
+                yieldTimer.start(resume - frameStart, Duration::zero(), [this] {
+                    onUpdate(Update::Repaint);
+                });
+                return;
+            }
+        }
+
         FrameData frameData { timePoint,
                               pixelRatio,
                               mode,
                               contextMode,
-                              debugOptions };
+                              debugOptions,
+                              releaseBucketData,
+                              layerCaching,
+                              fullRedraw,
+                              frameBudget.getQuality() };
 
         backend.updateAssumedState();
 
@@ -331,16 +567,31 @@ void Map::Impl::render(View& view) {
             painter->render(*style,
                             frameData,
                             view,
-                            annotationManager->getSpriteAtlas());
+                            *annotationManager);
         } catch (...) {
             Log::Error(Event::General, "Exception in render: %s", util::toString(std::current_exception()).c_str());
             exit(1);
         }
 
-        auto request = std::move(stillImageRequest);
-        request->callback(nullptr);
+        if (featurePicking) {
+            painter->renderPicking(*style, view);
+        }
 
+        const std::size_t index = stillImageRequest->index++;
+        if (stillImageRequest->index < stillImageRequest->cameras.size()) {
+            stillImageRequest->callback(nullptr, index);
+            transform.jumpTo(stillImageRequest->cameras[stillImageRequest->index]);
+            onUpdate(Update::RecalculateStyle);
+        } else {
+            // Moved out of the way first, so that the callback can start another request.
+            auto request = std::move(stillImageRequest);
+            request->callback(nullptr, index);
+        }
+
+        const TimePoint cleanupStart = Clock::now();
+        enforceMemoryBudget(context);
         painter->cleanup();
+        recordFrameStats(recalculateStyle, updateTiles, Clock::now() - cleanupStart);
     }
 }
 
@@ -360,7 +611,7 @@ void Map::setStyleURL(const std::string& url) {
     impl->styleJSON.clear();
     impl->styleMutated = false;
 
-    impl->style = std::make_unique<Style>(impl->fileSource, impl->pixelRatio);
+    impl->resetStyle();
 
     impl->styleRequest = impl->fileSource.request(Resource::style(impl->styleURL), [this](Response res) {
         // Once we get a fresh style, or the style is mutated, stop revalidating.
@@ -388,7 +639,7 @@ void Map::setStyleURL(const std::string& url) {
         } else if (res.notModified || res.noContent) {
             return;
         } else {
-            impl->loadStyleJSON(*res.data);
+            impl->loadStyleJSON(res.data->toString());
         }
     });
 }
@@ -406,16 +657,69 @@ void Map::setStyleJSON(const std::string& json) {
     impl->styleJSON.clear();
     impl->styleMutated = false;
 
-    impl->style = std::make_unique<Style>(impl->fileSource, impl->pixelRatio);
+    impl->resetStyle();
 
     impl->loadStyleJSON(json);
 }
 
+void Map::setStyleBinary(const std::string& binary) {
+    impl->loading = true;
+
+    impl->observer.onWillStartLoadingMap();
+
+    impl->styleURL.clear();
+    impl->styleJSON.clear();
+    impl->styleMutated = false;
+
+    impl->resetStyle();
+
+    impl->style->setObserver(impl.get());
+    impl->style->setBinary(binary);
+    impl->didLoadStyle();
+}
+
+void Map::setStyleSnapshot(std::shared_ptr<const style::StyleSnapshot> snapshot) {
+    impl->loading = true;
+
+    impl->observer.onWillStartLoadingMap();
+
+    impl->styleURL.clear();
+    impl->styleJSON.clear();
+    impl->styleMutated = false;
+
+    impl->resetStyle();
+
+    impl->style->setObserver(impl.get());
+    impl->style->setSnapshot(*snapshot);
+    impl->didLoadStyle();
+}
+
+std::shared_ptr<const style::StyleSnapshot> Map::getStyleSnapshot() const {
+    if (!impl->style) {
+        throw std::runtime_error("Can't take a snapshot before a style is loaded");
+    }
+    return impl->style->getSnapshot();
+}
+
+void Map::Impl::resetStyle() {
+    // The current style stays until the new one is loaded into it, so that the map isn't blank
+    // in the meantime and the sources that both styles share keep their tiles.
+    if (style) {
+        style->loaded = false;
+    } else {
+        style = std::make_unique<Style>(fileSource, pixelRatio, localFontFamily);
+    }
+}
+
 void Map::Impl::loadStyleJSON(const std::string& json) {
     style->setObserver(this);
     style->setJSON(json);
     styleJSON = json;
 
+    didLoadStyle();
+}
+
+void Map::Impl::didLoadStyle() {
     // force style cascade, causing all pending transitions to complete.
     style->cascade(Clock::now(), mode);
 
@@ -427,7 +731,7 @@ void Map::Impl::loadStyleJSON(const std::string& json) {
         map.setPitch(map.getDefaultPitch());
     }
 
-    onUpdate(Update::Classes | Update::RecalculateStyle | Update::AnnotationStyle);
+    onUpdate(Update::Classes | Update::RecalculateStyle | Update::Layout | Update::AnnotationStyle);
 }
 
 std::string Map::getStyleURL() const {
@@ -446,6 +750,10 @@ void Map::cancelTransitions() {
 }
 
 void Map::setGestureInProgress(bool inProgress) {
+    // Tiles that come into view during the gesture are laid out on the fastest cores.
+    if (inProgress != impl->transform.isGestureInProgress()) {
+        impl->scheduler.setInteractive(inProgress);
+    }
     impl->transform.setGestureInProgress(inProgress);
     impl->onUpdate(Update::Repaint);
 }
@@ -823,14 +1131,48 @@ LatLng Map::latLngForPixel(const ScreenCoordinate& pixel) const {
     return impl->transform.screenCoordinateToLatLng(pixel);
 }
 
+std::vector<ScreenCoordinate> Map::pixelsForLatLngs(const std::vector<LatLng>& latLngs) const {
+    std::vector<ScreenCoordinate> pixels;
+    pixelsForLatLngs(latLngs, pixels);
+    return pixels;
+}
+
+void Map::pixelsForLatLngs(const std::vector<LatLng>& latLngs, std::vector<ScreenCoordinate>& pixels) const {
+    // Unwrapped like they are in pixelForLatLng().
+    const LatLng center = getLatLng();
+    std::vector<LatLng> unwrappedLatLngs;
+    unwrappedLatLngs.reserve(latLngs.size());
+    for (const auto& latLng : latLngs) {
+        unwrappedLatLngs.push_back(latLng.wrapped());
+        unwrappedLatLngs.back().unwrapForShortestPath(center);
+    }
+    impl->transform.latLngsToScreenCoordinates(unwrappedLatLngs, pixels);
+}
+
+std::vector<LatLng> Map::latLngsForPixels(const std::vector<ScreenCoordinate>& pixels) const {
+    std::vector<LatLng> latLngs;
+    latLngsForPixels(pixels, latLngs);
+    return latLngs;
+}
+
+void Map::latLngsForPixels(const std::vector<ScreenCoordinate>& pixels, std::vector<LatLng>& latLngs) const {
+    impl->transform.screenCoordinatesToLatLngs(pixels, latLngs);
+}
+
 #pragma mark - Annotations
 
 void Map::addAnnotationIcon(const std::string& name, std::shared_ptr<const SpriteImage> sprite) {
     impl->annotationManager->addIcon(name, sprite);
+    if (impl->annotationManager->getInstancedSymbols()) {
+        impl->onUpdate(Update::Repaint);
+    }
 }
 
 void Map::removeAnnotationIcon(const std::string& name) {
     impl->annotationManager->removeIcon(name);
+    if (impl->annotationManager->getInstancedSymbols()) {
+        impl->onUpdate(Update::Repaint);
+    }
 }
 
 double Map::getTopOffsetPixelsForAnnotationIcon(const std::string& name) {
@@ -852,6 +1194,14 @@ void Map::removeAnnotation(AnnotationID annotation) {
     impl->onUpdate(Update::AnnotationStyle | Update::AnnotationData);
 }
 
+void Map::setInstancedPointAnnotations(bool enabled) {
+    impl->onUpdate(impl->annotationManager->setInstancedSymbols(enabled));
+}
+
+bool Map::getInstancedPointAnnotations() const {
+    return impl->annotationManager->getInstancedSymbols();
+}
+
 #pragma mark - Feature query api
 
 std::vector<Feature> Map::queryRenderedFeatures(const ScreenCoordinate& point, const RenderedQueryOptions& options) {
@@ -864,23 +1214,150 @@ std::vector<Feature> Map::queryRenderedFeatures(const ScreenCoordinate& point, c
     );
 }
 
+static ScreenLineString boxGeometry(const ScreenBox& box) {
+    return {
+        box.min,
+        { box.max.x, box.min.y },
+        box.max,
+        { box.min.x, box.max.y },
+        box.min
+    };
+}
+
 std::vector<Feature> Map::queryRenderedFeatures(const ScreenBox& box, const RenderedQueryOptions& options) {
     if (!impl->style) return {};
 
     return impl->style->queryRenderedFeatures(
-        {
-            box.min,
-            { box.max.x, box.min.y },
-            box.max,
-            { box.min.x, box.max.y },
-            box.min
-        },
+        boxGeometry(box),
+        impl->transform.getState(),
+        options
+    );
+}
+
+std::vector<RenderedFeatureHandle> Map::queryRenderedFeatureHandles(const ScreenCoordinate& point, const RenderedQueryOptions& options) {
+    if (!impl->style) return {};
+
+    return impl->style->queryRenderedFeatureHandles(
+        { point },
         impl->transform.getState(),
         options
     );
 }
 
+std::vector<RenderedFeatureHandle> Map::queryRenderedFeatureHandles(const ScreenBox& box, const RenderedQueryOptions& options) {
+    if (!impl->style) return {};
+
+    return impl->style->queryRenderedFeatureHandles(
+        boxGeometry(box),
+        impl->transform.getState(),
+        options
+    );
+}
+
+// Whether the picking buffer holds all features that a query of the layer could find.
+static bool pickable(const Layer& layer) {
+    return layer.is<FillLayer>() || layer.is<BackgroundLayer>() ||
+           layer.is<RasterLayer>() || layer.is<HillshadeLayer>() || layer.is<CustomLayer>();
+}
+
+optional<RenderedFeatureHandle> Map::pickRenderedFeature(const ScreenCoordinate& point, const RenderedQueryOptions& options) {
+    if (!impl->style) return {};
+
+    // The picking buffer holds neither filtered features nor those of changes that haven't been
+    // rendered yet.
+    bool usePicking = impl->featurePicking && impl->painter && !options.filter &&
+                      impl->updateFlags == Update::Nothing;
+    if (usePicking) {
+        if (options.layerIDs) {
+            for (const auto& layerID : *options.layerIDs) {
+                const Layer* layer = impl->style->getLayer(layerID);
+                if (layer && !pickable(*layer)) {
+                    usePicking = false;
+                    break;
+                }
+            }
+        } else {
+            for (const Layer* layer : impl->style->getLayers()) {
+                if (!pickable(*layer)) {
+                    usePicking = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (usePicking) {
+        BackendScope guard(impl->backend);
+        optional<RenderedFeatureHandle> picked;
+        if (impl->painter->pickFeature(point, picked)) {
+            // A fill that isn't queried may cover those that are.
+            if (!picked || !options.layerIDs ||
+                std::find(options.layerIDs->begin(), options.layerIDs->end(),
+                          picked->getLayer().getID()) != options.layerIDs->end()) {
+                return picked;
+            }
+        }
+    }
+
+    std::vector<RenderedFeatureHandle> handles = queryRenderedFeatureHandles(point, options);
+    if (handles.empty()) {
+        return {};
+    }
+
+    // The handles of a layer are found top to bottom, and the layers are ordered bottom to top.
+    auto first = std::prev(handles.end());
+    while (first != handles.begin() && &std::prev(first)->getLayer() == &first->getLayer()) {
+        --first;
+    }
+    return std::move(*first);
+}
+
+void Map::setFeaturePicking(bool enabled) {
+    impl->featurePicking = enabled;
+    impl->onUpdate(Update::Repaint);
+}
+
+bool Map::getFeaturePicking() const {
+    return impl->featurePicking;
+}
+
+void Map::setFrameBudget(Duration budget) {
+    impl->frameBudget.setTarget(budget);
+    impl->redrawAll = true;
+    impl->onUpdate(Update::Repaint);
+}
+
+Duration Map::getFrameBudget() const {
+    return impl->frameBudget.getTarget();
+}
+
+RenderQuality Map::getRenderQuality() const {
+    return impl->frameBudget.getQuality();
+}
+
+void Map::setFeatureState(const std::string& sourceID, const std::string& sourceLayer,
+                          const FeatureIdentifier& featureID, PropertyMap state) {
+    if (!impl->style) return;
+
+    if (Source* source = impl->style->getSource(sourceID)) {
+        source->baseImpl->setFeatureState(sourceLayer, featureID, std::move(state));
+        impl->onUpdate(Update::Repaint);
+    }
+}
+
+PropertyMap Map::getFeatureState(const std::string& sourceID, const std::string& sourceLayer,
+                                 const FeatureIdentifier& featureID) const {
+    if (!impl->style) return {};
+
+    const Source* source = impl->style->getSource(sourceID);
+    return source ? source->baseImpl->getFeatureState(sourceLayer, featureID) : PropertyMap();
+}
+
 AnnotationIDs Map::queryPointAnnotations(const ScreenBox& box) {
+    if (impl->annotationManager->getInstancedSymbols()) {
+        return impl->annotationManager->querySymbolInstances(box, impl->transform.getState());
+    }
+
     RenderedQueryOptions options;
     options.layerIDs = {{ AnnotationManager::PointLayerID }};
     auto features = queryRenderedFeatures(box, options);
@@ -971,6 +1448,7 @@ void Map::addImage(const std::string& name, std::unique_ptr<const SpriteImage> i
 
     impl->styleMutated = true;
     impl->style->spriteAtlas->setSprite(name, std::move(image));
+    impl->redrawAll = true;
     impl->onUpdate(Update::Repaint);
 }
 
@@ -981,6 +1459,7 @@ void Map::removeImage(const std::string& name) {
 
     impl->styleMutated = true;
     impl->style->spriteAtlas->removeSprite(name);
+    impl->redrawAll = true;
     impl->onUpdate(Update::Repaint);
 }
 
@@ -1119,6 +1598,71 @@ void Map::setSourceTileCacheSize(size_t size) {
     }
 }
 
+void Map::setGPUMemoryBudget(std::size_t bytes) {
+    impl->gpuMemoryBudget = bytes;
+    impl->backend.invalidate();
+}
+
+std::size_t Map::getGPUMemoryBudget() const {
+    return impl->gpuMemoryBudget;
+}
+
+FrameStats Map::getFrameStats() const {
+    return impl->frameStats;
+}
+
+void Map::setSharedLayoutCacheSize(size_t size) {
+    SharedLayoutCache::get().setMaximumBytes(size);
+}
+
+void Map::setTessellationCacheSize(size_t size) {
+    TessellationCache::get().setMaximumBytes(size);
+}
+
+void Map::preloadGlyphs(const std::string& glyphURL, const FontStack& fontStack,
+                        std::pair<uint16_t, uint16_t> range, const std::string& data) {
+    GlyphStore::get().preload(glyphURL, fontStack, range, data);
+}
+
+void Map::clearPreloadedGlyphs() {
+    GlyphStore::get().clear();
+}
+
+void Map::setReleaseBucketData(bool release) {
+    impl->releaseBucketData = release;
+}
+
+void Map::setLayerCaching(bool enabled) {
+    impl->layerCaching = enabled;
+    impl->redrawAll = true;
+    impl->onUpdate(Update::Repaint);
+}
+
+bool Map::getLayerCaching() const {
+    return impl->layerCaching;
+}
+
+void Map::setIdlePrelayout(bool enabled) {
+    impl->idlePrelayout = enabled;
+    impl->onUpdate(Update::Repaint);
+}
+
+bool Map::getIdlePrelayout() const {
+    return impl->idlePrelayout;
+}
+
+void Map::setYieldsToContinuousMaps(bool yields) {
+    impl->yieldsToContinuousMaps = yields;
+    if (!yields) {
+        impl->yieldTimer.stop();
+        impl->onUpdate(Update::Repaint);
+    }
+}
+
+bool Map::getYieldsToContinuousMaps() const {
+    return impl->yieldsToContinuousMaps;
+}
+
 void Map::onLowMemory() {
     if (impl->painter) {
         BackendScope guard(impl->backend);
@@ -1150,8 +1694,137 @@ void Map::Impl::onStyleError(std::exception_ptr error) {
 void Map::Impl::onResourceError(std::exception_ptr error) {
     if (mode == MapMode::Still && stillImageRequest) {
         auto request = std::move(stillImageRequest);
-        request->callback(error);
+        request->callback(error, request->index);
+    }
+}
+
+std::string Map::getTileTraces() const {
+    std::vector<std::pair<std::string, const TileTrace*>> traces;
+    if (impl->style) {
+        for (const auto& source : impl->style->getSources()) {
+            source->baseImpl->getTileTraces(traces);
+        }
+    }
+    return encodeChromeTrace(traces);
+}
+
+MemoryUsage Map::getMemoryUsage() const {
+    MemoryUsage usage;
+    if (impl->style) {
+        for (const auto& source : impl->style->getSources()) {
+            usage.sources.emplace(source->getID(), source->baseImpl->getMemoryUsage());
+        }
+        usage.glyphAtlas = impl->style->glyphAtlas->getSize().area();
+        usage.spriteAtlas = impl->style->spriteAtlas->getByteSize();
+        usage.lineAtlas = impl->style->lineAtlas->getSize().area();
+    }
+    usage.spriteAtlas += impl->annotationManager->getSpriteAtlas().getByteSize();
+    usage.fileSource = impl->fileSource.getMemoryUsage();
+    usage.gpu = impl->gpuMemoryUsage;
+    return usage;
+}
+
+std::string Map::getTileSnapshot() const {
+    std::vector<TileSnapshot::Source> sources;
+    if (!impl->style) {
+        return TileSnapshot(std::move(sources)).serialize();
+    }
+    for (const auto& source : impl->style->getSources()) {
+        if (source->baseImpl->type != SourceType::Vector && source->baseImpl->type != SourceType::Raster &&
+            source->baseImpl->type != SourceType::RasterDEM) {
+            continue;
+        }
+        const auto& tileSource = static_cast<const style::TileSourceImpl&>(*source->baseImpl);
+        if (!tileSource.loaded || tileSource.getTileset().tiles.empty()) {
+            continue;
+        }
+        TileSnapshot::Source snapshotSource { tileSource.getTileset().tiles.at(0),
+                                              tileSource.getTileset().scheme, {} };
+        for (const auto& pair : source->baseImpl->getRenderTiles()) {
+            snapshotSource.tiles.push_back(pair.second.tile.id.canonical);
+        }
+        if (!snapshotSource.tiles.empty()) {
+            sources.push_back(std::move(snapshotSource));
+        }
+    }
+    return TileSnapshot(std::move(sources)).serialize();
+}
+
+void Map::setTileSnapshot(const std::string& data) {
+    const TileSnapshot snapshot(data);
+    impl->snapshotRequests.clear();
+    for (const auto& source : snapshot.sources()) {
+        const TileURLTemplate urlTemplate(source.urlTemplate);
+        for (const auto& tile : source.tiles) {
+            impl->snapshotRequests.push_back(impl->fileSource.request(
+                Resource::tile(urlTemplate, impl->pixelRatio, tile.x, tile.y, tile.z,
+                               source.scheme, Resource::Optional),
+                [](Response) {}));
+        }
+    }
+}
+
+std::string Map::generateProgramPack(const std::vector<float>& pixelRatios) {
+    BackendScope guard(impl->backend);
+    gl::Context& context = impl->backend.getContext();
+    if (!context.supportsProgramBinaries()) {
+        throw std::runtime_error("binary programs are not supported");
+    }
+
+    std::vector<ProgramPack::Entry> entries;
+    // The debug and collision box programs are the same with and without overdraw.
+    std::set<std::pair<std::string, float>> added;
+    for (const float ratio : pixelRatios) {
+        for (const bool overdraw : { false, true }) {
+            // Without a cache directory, the programs don't read or write the program cache.
+            Programs programs { context, ProgramParameters(ratio, overdraw, "") };
+            programs.warmUp(context, [&](std::string fileName, float pixelRatio, std::string binaryProgram) {
+                if (added.emplace(fileName, pixelRatio).second) {
+                    entries.push_back({ std::move(fileName), pixelRatio, std::move(binaryProgram) });
+                }
+            });
+        }
+    }
+    return ProgramPack(context.getDriverIdentifier(), std::move(entries)).serialize();
+}
+
+std::size_t Map::importProgramPack(const std::string& data) {
+    if (impl->programCacheDir.empty()) {
+        return 0;
+    }
+
+    BackendScope guard(impl->backend);
+    gl::Context& context = impl->backend.getContext();
+    if (!context.supportsProgramBinaries()) {
+        return 0;
+    }
+
+    std::size_t imported = 0;
+    try {
+        const ProgramPack pack(data);
+        if (pack.driverIdentifier() != context.getDriverIdentifier()) {
+            Log::Info(Event::OpenGL, "Program pack was generated with a different driver");
+            return 0;
+        }
+
+        const auto formats = context.getBinaryProgramFormats();
+        for (const auto& entry : pack.entries()) {
+            if (entry.pixelRatio != impl->pixelRatio) {
+                continue;
+            }
+            BinaryProgram binaryProgram(std::string(entry.binaryProgram));
+            if (std::find(formats.begin(), formats.end(), binaryProgram.format()) == formats.end()) {
+                continue;
+            }
+            // Throws if the driver rejects the binary.
+            context.createProgram(binaryProgram.format(), binaryProgram.code());
+            util::write_file(impl->programCacheDir + "/" + entry.fileName, entry.binaryProgram);
+            imported++;
+        }
+    } catch (const std::runtime_error& error) {
+        Log::Warning(Event::OpenGL, "Could not import program pack: %s", error.what());
     }
+    return imported;
 }
 
 void Map::dumpDebugLogs() const {
@@ -1162,6 +1835,9 @@ void Map::dumpDebugLogs() const {
     } else {
         Log::Info(Event::General, "no style loaded");
     }
+    const FrameStats& stats = impl->frameStats;
+    Log::Info(Event::General, "Last frame: %zu draws, %zu program switches, %zu texture binds, %zu vertex array binds",
+              stats.draws, stats.programSwitches, stats.textureBinds, stats.vertexArrayBinds);
     Log::Info(Event::General, "--------------------------------------------------------------------------------");
 }
 
@@ -0,0 +1,65 @@
+#include <mbgl/map/metatile.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/projection.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace mbgl {
+
+Metatile::Metatile(uint8_t z_, uint32_t x_, uint32_t y_, uint32_t count, uint16_t tileSize_, uint16_t buffer_)
+    : z(z_),
+      x(x_),
+      y(y_),
+      columns(std::min<uint64_t>(count, (uint64_t(1) << z) - std::min<uint64_t>(x, uint64_t(1) << z))),
+      rows(std::min<uint64_t>(count, (uint64_t(1) << z) - std::min<uint64_t>(y, uint64_t(1) << z))),
+      tileSize(tileSize_),
+      buffer(buffer_) {
+    if (columns == 0 || rows == 0 || tileSize == 0) {
+        throw std::invalid_argument("metatile is empty");
+    }
+}
+
+Size Metatile::getSize() const {
+    return { columns * tileSize + 2u * buffer, rows * tileSize + 2u * buffer };
+}
+
+CameraOptions Metatile::getCamera() const {
+    const double scale = std::pow(2.0, z);
+    const Point<double> center { (x + columns / 2.0) * util::tileSize,
+                                 (y + rows / 2.0) * util::tileSize };
+
+    CameraOptions camera;
+    camera.center = Projection::unproject(center, scale, LatLng::Wrapped);
+    // Tiles of util::tileSize pixels cover the world at zoom level z.
+    camera.zoom = z + std::log2(double(tileSize) / util::tileSize);
+    camera.angle = 0.0;
+    camera.pitch = 0.0;
+    return camera;
+}
+
+std::vector<PremultipliedImage> Metatile::slice(const PremultipliedImage& image) const {
+    const Size size = getSize();
+    if (image.size.width % size.width != 0 || image.size.width / size.width * size.height != image.size.height) {
+        throw std::invalid_argument("image doesn't have the size of the metatile");
+    }
+
+    const uint32_t ratio = image.size.width / size.width;
+    const uint32_t tile = tileSize * ratio;
+    const uint32_t offset = buffer * ratio;
+
+    std::vector<PremultipliedImage> tiles;
+    tiles.reserve(columns * rows);
+    for (uint32_t row = 0; row < rows; row++) {
+        for (uint32_t column = 0; column < columns; column++) {
+            PremultipliedImage result({ tile, tile });
+            PremultipliedImage::copy(image, result, { offset + column * tile, offset + row * tile },
+                                     { 0, 0 }, result.size);
+            tiles.push_back(std::move(result));
+        }
+    }
+    return tiles;
+}
+
+} // namespace mbgl
@@ -0,0 +1,41 @@
+#include <mbgl/map/query.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/tile_id.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+RenderedFeatureHandle::RenderedFeatureHandle(const style::Layer& layer_,
+                                             std::shared_ptr<const GeometryTileData> data_,
+                                             const GeometryTileLayer& sourceLayer_,
+                                             std::size_t index_,
+                                             const CanonicalTileID& tileID)
+    : layer(&layer_),
+      data(std::move(data_)),
+      sourceLayer(&sourceLayer_),
+      index(index_),
+      z(tileID.z),
+      x(tileID.x),
+      y(tileID.y) {
+}
+
+optional<FeatureIdentifier> RenderedFeatureHandle::getID() const {
+    auto feature = sourceLayer->getFeature(index);
+    assert(feature);
+    return feature->getID();
+}
+
+optional<Value> RenderedFeatureHandle::getValue(const std::string& key) const {
+    auto feature = sourceLayer->getFeature(index);
+    assert(feature);
+    return feature->getValue(key);
+}
+
+Feature RenderedFeatureHandle::getFeature() const {
+    auto feature = sourceLayer->getFeature(index);
+    assert(feature);
+    return convertFeature(*feature, { z, x, y });
+}
+
+} // namespace mbgl
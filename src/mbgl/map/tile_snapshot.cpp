@@ -0,0 +1,102 @@
+#include <mbgl/map/tile_snapshot.hpp>
+
+#include <protozero/pbf_reader.hpp>
+#include <protozero/pbf_writer.hpp>
+
+#include <stdexcept>
+
+static mbgl::CanonicalTileID parseTile(protozero::pbf_reader&& pbf) {
+    bool hasZ = false, hasX = false, hasY = false;
+    uint32_t z = 0, x = 0, y = 0;
+    while (pbf.next()) {
+        switch (pbf.tag()) {
+        case 1: // z
+            z = pbf.get_uint32();
+            hasZ = true;
+            break;
+        case 2: // x
+            x = pbf.get_uint32();
+            hasX = true;
+            break;
+        case 3: // y
+            y = pbf.get_uint32();
+            hasY = true;
+            break;
+        default:
+            pbf.skip();
+            break;
+        }
+    }
+    if (!hasZ || !hasX || !hasY) {
+        throw std::runtime_error("TileSnapshot tile is missing required fields");
+    }
+    // The CanonicalTileID constructor asserts on coordinates out of range.
+    if (z > 32 || x >= (1ull << z) || y >= (1ull << z)) {
+        throw std::runtime_error("TileSnapshot tile is out of range");
+    }
+    return { static_cast<uint8_t>(z), x, y };
+}
+
+static mbgl::TileSnapshot::Source parseSource(protozero::pbf_reader&& pbf) {
+    bool hasURLTemplate = false;
+    mbgl::TileSnapshot::Source source { {}, mbgl::Tileset::Scheme::XYZ, {} };
+    while (pbf.next()) {
+        switch (pbf.tag()) {
+        case 1: // URL template
+            source.urlTemplate = pbf.get_string();
+            hasURLTemplate = true;
+            break;
+        case 2: // scheme
+            source.scheme = pbf.get_bool() ? mbgl::Tileset::Scheme::TMS : mbgl::Tileset::Scheme::XYZ;
+            break;
+        case 3: // tile
+            source.tiles.push_back(parseTile(pbf.get_message()));
+            break;
+        default:
+            pbf.skip();
+            break;
+        }
+    }
+    if (!hasURLTemplate) {
+        throw std::runtime_error("TileSnapshot source is missing required fields");
+    }
+    return source;
+}
+
+namespace mbgl {
+
+TileSnapshot::TileSnapshot(std::vector<Source>&& sources_) : tileSources(std::move(sources_)) {
+}
+
+TileSnapshot::TileSnapshot(const std::string& data) {
+    protozero::pbf_reader pbf(data);
+    while (pbf.next()) {
+        switch (pbf.tag()) {
+        case 1: // source
+            tileSources.push_back(parseSource(pbf.get_message()));
+            break;
+        default:
+            pbf.skip();
+            break;
+        }
+    }
+}
+
+std::string TileSnapshot::serialize() const {
+    std::string data;
+    protozero::pbf_writer pbf(data);
+    for (const auto& source : tileSources) {
+        protozero::pbf_writer pbf_source(pbf, 1 /* source */);
+        pbf_source.add_string(1 /* URL template */, source.urlTemplate);
+        pbf_source.add_bool(2 /* scheme */, source.scheme == Tileset::Scheme::TMS);
+        for (const auto& tile : source.tiles) {
+            protozero::pbf_writer pbf_tile(pbf_source, 3 /* tile */);
+            pbf_tile.add_uint32(1 /* z */, tile.z);
+            pbf_tile.add_uint32(2 /* x */, tile.x);
+            pbf_tile.add_uint32(3 /* y */, tile.y);
+        }
+    }
+    return data;
+}
+
+} // namespace mbgl
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/tileset.hpp>
+
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// The tiles that a map rendered last, by the URL template of their source, so that a map that
+// starts at the same camera can look them up in the cache before its style has loaded.
+class TileSnapshot {
+public:
+    class Source {
+    public:
+        std::string urlTemplate;
+        Tileset::Scheme scheme;
+        std::vector<CanonicalTileID> tiles;
+    };
+
+    TileSnapshot(std::vector<Source>&&);
+
+    // Initialize a TileSnapshot object from a serialized representation.
+    TileSnapshot(const std::string& data);
+
+    std::string serialize() const;
+
+    const std::vector<Source>& sources() const {
+        return tileSources;
+    }
+
+private:
+    std::vector<Source> tileSources;
+};
+
+} // namespace mbgl
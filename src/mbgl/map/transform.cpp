@@ -17,6 +17,9 @@
 
 namespace mbgl {
 
+// The number of states of an animated transition that getTransitionPath() samples.
+constexpr int transitionPathSamples = 4;
+
 /** Converts the given angle (in radians) to be numerically close to the anchor angle, allowing it to be interpolated properly without sudden jumps. */
 static double _normalizeAngle(double angle, double anchorAngle)
 {
@@ -553,6 +556,18 @@ void Transform::startTransition(const CameraOptions& camera,
     transitionStart = Clock::now();
     transitionDuration = duration;
 
+    if (isAnimated) {
+        // Frames only depend on the time, so they can be computed ahead of it.
+        const TransformState current = state;
+        const util::UnitBezier ease = animation.easing ? *animation.easing : util::DEFAULT_TRANSITION_EASE;
+        for (int i = 1; i <= transitionPathSamples; i++) {
+            frame(ease.solve(double(i) / transitionPathSamples, 0.001));
+            if (anchor) state.moveLatLng(anchorLatLng, *anchor);
+            transitionPath.push_back(state);
+        }
+        state = current;
+    }
+
     transitionFrameFn = [isAnimated, animation, frame, anchor, anchorLatLng, this](const TimePoint now) {
         float t = isAnimated ? (std::chrono::duration<float>(now - transitionStart) / transitionDuration) : 1.0;
         Update result;
@@ -583,6 +598,7 @@ void Transform::startTransition(const CameraOptions& camera,
     };
 
     transitionFinishFn = [isAnimated, animation, this] {
+        transitionPath.clear();
         state.panning = false;
         state.scaling = false;
         state.rotating = false;
@@ -632,4 +648,19 @@ LatLng Transform::screenCoordinateToLatLng(const ScreenCoordinate& point) const
     return state.screenCoordinateToLatLng(flippedPoint).wrapped();
 }
 
+void Transform::latLngsToScreenCoordinates(const std::vector<LatLng>& latLngs, std::vector<ScreenCoordinate>& points) const {
+    state.latLngsToScreenCoordinates(latLngs, points);
+    for (auto& point : points) {
+        point.y = state.size.height - point.y;
+    }
+}
+
+void Transform::screenCoordinatesToLatLngs(const std::vector<ScreenCoordinate>& points, std::vector<LatLng>& latLngs) const {
+    std::vector<ScreenCoordinate> flippedPoints = points;
+    for (auto& point : flippedPoints) {
+        point.y = state.size.height - point.y;
+    }
+    state.screenCoordinatesToLatLngs(flippedPoints, latLngs, LatLng::Wrapped);
+}
+
 } // namespace mbgl
@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <cmath>
 #include <functional>
+#include <vector>
 
 namespace mbgl {
 
@@ -133,6 +134,11 @@ public:
     Duration getTransitionDuration() const { return transitionDuration; }
     void cancelTransitions();
 
+    // Samples of the states that the current animated transition passes through, ending with
+    // the one it arrives at, so that tiles can be loaded before the camera gets there. Empty
+    // when there's no animated transition.
+    const std::vector<TransformState>& getTransitionPath() const { return transitionPath; }
+
     // Gesture
     void setGestureInProgress(bool);
     bool isGestureInProgress() const { return state.isGestureInProgress(); }
@@ -146,6 +152,8 @@ public:
     // Conversion and projection
     ScreenCoordinate latLngToScreenCoordinate(const LatLng&) const;
     LatLng screenCoordinateToLatLng(const ScreenCoordinate&) const;
+    void latLngsToScreenCoordinates(const std::vector<LatLng>&, std::vector<ScreenCoordinate>&) const;
+    void screenCoordinatesToLatLngs(const std::vector<ScreenCoordinate>&, std::vector<LatLng>&) const;
 
 private:
     MapObserver& observer;
@@ -160,6 +168,7 @@ private:
     Duration transitionDuration;
     std::function<Update(const TimePoint)> transitionFrameFn;
     std::function<void()> transitionFinishFn;
+    std::vector<TransformState> transitionPath;
 };
 
 } // namespace mbgl
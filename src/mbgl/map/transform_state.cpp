@@ -249,12 +249,29 @@ ScreenCoordinate TransformState::latLngToScreenCoordinate(const LatLng& latLng)
         return {};
     }
 
-    mat4 mat = coordinatePointMatrix(getZoom());
-    vec4 p;
-    Point<double> pt = Projection::project(latLng, scale) / double(util::tileSize);
-    vec4 c = {{ pt.x, pt.y, 0, 1 }};
-    matrix::transformMat4(p, c, mat);
-    return { p[0] / p[3], size.height - p[1] / p[3] };
+    return latLngToScreenCoordinate(latLng, coordinatePointMatrix(getZoom()));
+}
+
+void TransformState::latLngsToScreenCoordinates(const std::vector<LatLng>& latLngs, std::vector<ScreenCoordinate>& points) const {
+    points.resize(latLngs.size());
+    if (size.isEmpty()) {
+        std::fill(points.begin(), points.end(), ScreenCoordinate());
+        return;
+    }
+
+    const mat4 mat = coordinatePointMatrix(getZoom());
+    for (std::size_t i = 0; i < latLngs.size(); i++) {
+        points[i] = latLngToScreenCoordinate(latLngs[i], mat);
+    }
+}
+
+ScreenCoordinate TransformState::latLngToScreenCoordinate(const LatLng& latLng, const mat4& mat) const {
+    // Points on the map have z = 0 and w = 1, and the z coordinate of the result isn't used.
+    const Point<double> pt = Projection::project(latLng, scale) / double(util::tileSize);
+    const double px = mat[0] * pt.x + mat[4] * pt.y + mat[12];
+    const double py = mat[1] * pt.x + mat[5] * pt.y + mat[13];
+    const double pw = mat[3] * pt.x + mat[7] * pt.y + mat[15];
+    return { px / pw, size.height - py / pw };
 }
 
 LatLng TransformState::screenCoordinateToLatLng(const ScreenCoordinate& point, LatLng::WrapMode wrapMode) const {
@@ -262,14 +279,24 @@ LatLng TransformState::screenCoordinateToLatLng(const ScreenCoordinate& point, L
         return {};
     }
 
-    float targetZ = 0;
-    mat4 mat = coordinatePointMatrix(getZoom());
+    return screenCoordinateToLatLng(point, wrapMode, invertedCoordinatePointMatrix());
+}
 
-    mat4 inverted;
-    bool err = matrix::invert(inverted, mat);
+void TransformState::screenCoordinatesToLatLngs(const std::vector<ScreenCoordinate>& points, std::vector<LatLng>& latLngs, LatLng::WrapMode wrapMode) const {
+    latLngs.resize(points.size());
+    if (size.isEmpty()) {
+        std::fill(latLngs.begin(), latLngs.end(), LatLng());
+        return;
+    }
 
-    if (err) throw std::runtime_error("failed to invert coordinatePointMatrix");
+    const mat4 inverted = invertedCoordinatePointMatrix();
+    for (std::size_t i = 0; i < points.size(); i++) {
+        latLngs[i] = screenCoordinateToLatLng(points[i], wrapMode, inverted);
+    }
+}
 
+LatLng TransformState::screenCoordinateToLatLng(const ScreenCoordinate& point, LatLng::WrapMode wrapMode, const mat4& inverted) const {
+    float targetZ = 0;
     double flippedY = size.height - point.y;
 
     // since we don't know the correct projected z value for the point,
@@ -305,6 +332,16 @@ mat4 TransformState::coordinatePointMatrix(double z) const {
     return proj;
 }
 
+mat4 TransformState::invertedCoordinatePointMatrix() const {
+    mat4 mat = coordinatePointMatrix(getZoom());
+
+    mat4 inverted;
+    bool err = matrix::invert(inverted, mat);
+
+    if (err) throw std::runtime_error("failed to invert coordinatePointMatrix");
+    return inverted;
+}
+
 mat4 TransformState::getPixelMatrix() const {
     mat4 m;
     matrix::identity(m);
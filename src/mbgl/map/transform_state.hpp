@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <array>
 #include <limits>
+#include <vector>
 
 namespace mbgl {
 
@@ -78,6 +79,11 @@ public:
     ScreenCoordinate latLngToScreenCoordinate(const LatLng&) const;
     LatLng screenCoordinateToLatLng(const ScreenCoordinate&, LatLng::WrapMode = LatLng::Unwrapped) const;
 
+    // Convert many points at once, computing the matrix they have in common only once. The
+    // results are written to the given vector, which is resized to fit them.
+    void latLngsToScreenCoordinates(const std::vector<LatLng>&, std::vector<ScreenCoordinate>&) const;
+    void screenCoordinatesToLatLngs(const std::vector<ScreenCoordinate>&, std::vector<LatLng>&, LatLng::WrapMode = LatLng::Unwrapped) const;
+
     double zoomScale(double zoom) const;
     double scaleZoom(double scale) const;
 
@@ -103,8 +109,13 @@ private:
     Size size;
 
     mat4 coordinatePointMatrix(double z) const;
+    mat4 invertedCoordinatePointMatrix() const;
     mat4 getPixelMatrix() const;
 
+    // Take the coordinate point matrix, or its inverse.
+    ScreenCoordinate latLngToScreenCoordinate(const LatLng&, const mat4&) const;
+    LatLng screenCoordinateToLatLng(const ScreenCoordinate&, LatLng::WrapMode, const mat4&) const;
+
     /** Recenter the map so that the given coordinate is located at the given
         point on screen. */
     void moveLatLng(const LatLng&, const ScreenCoordinate&);
@@ -0,0 +1,8 @@
+#include <mbgl/programs/annotation_icon_program.hpp>
+
+namespace mbgl {
+
+static_assert(sizeof(AnnotationIconCornerVertex) == 4, "expected AnnotationIconCornerVertex size");
+static_assert(sizeof(AnnotationIconInstanceVertex) == 20, "expected AnnotationIconInstanceVertex size");
+
+} // namespace mbgl
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <mbgl/programs/program.hpp>
+#include <mbgl/programs/attributes.hpp>
+#include <mbgl/programs/uniforms.hpp>
+#include <mbgl/programs/symbol_program.hpp>
+#include <mbgl/shaders/annotation_icon.hpp>
+#include <mbgl/util/geometry.hpp>
+
+#include <array>
+#include <cmath>
+
+namespace mbgl {
+
+namespace attributes {
+MBGL_DEFINE_ATTRIBUTE(uint16_t, 4, a_projected_pos);
+MBGL_DEFINE_ATTRIBUTE(uint16_t, 4, a_texture_rect);
+} // namespace attributes
+
+namespace uniforms {
+MBGL_DEFINE_UNIFORM_VECTOR(float, 4, u_anchor);
+MBGL_DEFINE_UNIFORM_SCALAR(float, u_world_scale);
+} // namespace uniforms
+
+// The corners of the icons' quads, which all instances share.
+using AnnotationIconCornerAttributes = gl::Attributes<
+    attributes::a_pos>;
+
+// An icon's position and its image in the atlas, which the corners of its quad share.
+using AnnotationIconInstanceAttributes = gl::Attributes<
+    attributes::a_projected_pos,
+    attributes::a_texture_rect,
+    attributes::a_extrude>;
+
+// Draws the icons of point annotations. Contexts that support instancing draw a single quad per
+// atlas, once for each icon; the others draw a quad per icon, with the icon's attributes repeated
+// at each of its vertices.
+class AnnotationIconProgram : public Program<
+    shaders::annotation_icon,
+    gl::Triangle,
+    gl::ConcatenateAttributes<AnnotationIconCornerAttributes, AnnotationIconInstanceAttributes>,
+    gl::Uniforms<
+        uniforms::u_matrix,
+        uniforms::u_anchor,
+        uniforms::u_world_scale,
+        uniforms::u_extrude_scale,
+        uniforms::u_texsize,
+        uniforms::u_texture>,
+    style::PaintProperties<>>
+{
+public:
+    using Program::Program;
+
+    using CornerVertex = AnnotationIconCornerAttributes::Vertex;
+    using InstanceVertex = AnnotationIconInstanceAttributes::Vertex;
+
+    // The position is in 1 / 2^32 of the world's size, and the size of the icon in pixels.
+    static InstanceVertex instanceVertex(Point<uint32_t> position,
+                                         std::array<uint16_t, 4> textureRect,
+                                         std::array<float, 2> size) {
+        return InstanceVertex {
+            {{
+                static_cast<uint16_t>(position.x >> 16),
+                static_cast<uint16_t>(position.y >> 16),
+                static_cast<uint16_t>(position.x & 0xFFFF),
+                static_cast<uint16_t>(position.y & 0xFFFF)
+            }},
+            textureRect,
+            {{
+                static_cast<int16_t>(::round(size[0] * 4)),
+                static_cast<int16_t>(::round(size[1] * 4))
+            }}
+        };
+    }
+
+    void draw(gl::Context& context,
+              gl::DepthMode depthMode,
+              gl::StencilMode stencilMode,
+              gl::ColorMode colorMode,
+              UniformValues&& uniformValues,
+              const gl::VertexBuffer<CornerVertex>& cornerBuffer,
+              const gl::VertexBuffer<InstanceVertex>& instanceBuffer,
+              const gl::IndexBuffer<gl::Triangles>& indexBuffer,
+              const gl::SegmentVector<Attributes>& segments,
+              bool instanced) {
+        auto attributeBindings = AnnotationIconCornerAttributes::allVariableBindings(cornerBuffer)
+            .concat(instanced
+                ? AnnotationIconInstanceAttributes::allInstanceBindings(instanceBuffer)
+                : AnnotationIconInstanceAttributes::allVariableBindings(instanceBuffer));
+
+        if (instanced) {
+            get(context).drawInstanced(context, gl::Triangles(), depthMode, stencilMode, colorMode,
+                                       std::move(uniformValues), std::move(attributeBindings),
+                                       indexBuffer, segments, instanceBuffer.vertexCount);
+        } else {
+            get(context).draw(context, gl::Triangles(), depthMode, stencilMode, colorMode,
+                              std::move(uniformValues), std::move(attributeBindings),
+                              indexBuffer, segments);
+        }
+    }
+};
+
+using AnnotationIconCornerVertex = AnnotationIconProgram::CornerVertex;
+using AnnotationIconInstanceVertex = AnnotationIconProgram::InstanceVertex;
+
+} // namespace mbgl
@@ -24,6 +24,10 @@ MBGL_DEFINE_ATTRIBUTE(int16_t, 2, a_pos);
 MBGL_DEFINE_ATTRIBUTE(int16_t, 2, a_extrude);
 MBGL_DEFINE_ATTRIBUTE(int16_t, 4, a_pos_offset);
 MBGL_DEFINE_ATTRIBUTE(uint16_t, 2, a_texture_pos);
+MBGL_DEFINE_ATTRIBUTE(int16_t, 4, a_normal_ed);
+
+// The corner of a quad that instances of the quad share.
+MBGL_DEFINE_ATTRIBUTE(int16_t, 2, a_corner);
 
 template <typename T, std::size_t N>
 struct a_data {
@@ -44,29 +48,31 @@ struct a_offset {
 
 // Paint attributes
 
+// Colors are packed into a pair of 16-bit values, which the shaders read as the floats they
+// would otherwise be stored as; see attributeValue(const Color&).
 struct a_color {
     static auto name() { return "a_color"; }
-    using Type = gl::Attribute<float, 2>;
+    using Type = gl::Attribute<uint16_t, 2>;
 };
 
 struct a_fill_color {
     static auto name() { return "a_fill_color"; }
-    using Type = gl::Attribute<float, 2>;
+    using Type = gl::Attribute<uint16_t, 2>;
 };
 
 struct a_halo_color {
     static auto name() { return "a_halo_color"; }
-    using Type = gl::Attribute<float, 2>;
+    using Type = gl::Attribute<uint16_t, 2>;
 };
 
 struct a_stroke_color {
     static auto name() { return "a_stroke_color"; }
-    using Type = gl::Attribute<float, 2>;
+    using Type = gl::Attribute<uint16_t, 2>;
 };
 
 struct a_outline_color {
     static auto name() { return "a_outline_color"; }
-    using Type = gl::Attribute<float, 2>;
+    using Type = gl::Attribute<uint16_t, 2>;
 };
 
 struct a_opacity {
@@ -89,6 +95,11 @@ struct a_radius {
     using Type = gl::Attribute<float, 1>;
 };
 
+struct a_weight {
+    static auto name() { return "a_weight"; }
+    using Type = gl::Attribute<float, 1>;
+};
+
 struct a_width {
     static auto name() { return "a_width"; }
     using Type = gl::Attribute<float, 1>;
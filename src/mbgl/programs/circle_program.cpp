@@ -3,5 +3,6 @@
 namespace mbgl {
 
 static_assert(sizeof(CircleLayoutVertex) == 4, "expected CircleLayoutVertex size");
+static_assert(sizeof(CircleCornerVertex) == 4, "expected CircleCornerVertex size");
 
 } // namespace mbgl
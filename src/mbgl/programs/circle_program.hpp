@@ -3,7 +3,7 @@
 #include <mbgl/programs/program.hpp>
 #include <mbgl/programs/attributes.hpp>
 #include <mbgl/programs/uniforms.hpp>
-#include <mbgl/shaders/circle.hpp>
+#include <mbgl/shaders/circle_instanced.hpp>
 #include <mbgl/util/geometry.hpp>
 #include <mbgl/style/layers/circle_layer_properties.hpp>
 
@@ -13,11 +13,21 @@ namespace uniforms {
 MBGL_DEFINE_UNIFORM_SCALAR(bool, u_scale_with_map);
 } // namespace uniforms
 
+// The position of a circle, with the corner of its quad in the lowest bit of each coordinate.
+using CircleLayoutAttributes = gl::Attributes<
+    attributes::a_pos>;
+
+// The corners of the quad that instanced circles share, which are added to their positions.
+using CircleCornerAttributes = gl::Attributes<
+    attributes::a_corner>;
+
+// Draws the circles of a bucket. Contexts that support instancing draw a single quad, once for
+// each circle, with a vertex per circle that the corners are added to; the others draw a quad
+// per circle, with the circle's vertex repeated at each of its corners.
 class CircleProgram : public Program<
-    shaders::circle,
+    shaders::circle_instanced,
     gl::Triangle,
-    gl::Attributes<
-        attributes::a_pos>,
+    gl::ConcatenateAttributes<CircleLayoutAttributes, CircleCornerAttributes>,
     gl::Uniforms<
         uniforms::u_matrix,
         uniforms::u_scale_with_map,
@@ -27,6 +37,9 @@ class CircleProgram : public Program<
 public:
     using Program::Program;
 
+    using LayoutVertex = CircleLayoutAttributes::Vertex;
+    using CornerVertex = CircleCornerAttributes::Vertex;
+
     /*
      * @param {number} x vertex position
      * @param {number} y vertex position
@@ -41,9 +54,45 @@ public:
             }}
         };
     }
+
+    // Draws the circles as instances of the quad if a corner buffer is given.
+    void draw(gl::Context& context,
+              gl::DepthMode depthMode,
+              gl::StencilMode stencilMode,
+              gl::ColorMode colorMode,
+              UniformValues&& uniformValues,
+              const gl::VertexBuffer<LayoutVertex>& layoutVertexBuffer,
+              const gl::VertexBuffer<CornerVertex>* cornerBuffer,
+              const gl::IndexBuffer<gl::Triangles>& indexBuffer,
+              const gl::SegmentVector<Attributes>& segments,
+              const PaintPropertyBinders& paintPropertyBinders,
+              const typename style::CirclePaintProperties::Evaluated& currentProperties,
+              float currentZoom) {
+        auto& program = get(context, paintPropertyBinders.variant());
+        auto allUniformValues = uniformValues.concat(paintPropertyBinders.uniformValues(currentZoom));
+
+        if (cornerBuffer) {
+            program.drawInstanced(
+                context, gl::Triangles(), depthMode, stencilMode, colorMode,
+                std::move(allUniformValues),
+                CircleLayoutAttributes::allInstanceBindings(layoutVertexBuffer)
+                    .concat(CircleCornerAttributes::allVariableBindings(*cornerBuffer))
+                    .concat(paintPropertyBinders.instanceBindings(currentProperties)),
+                indexBuffer, segments, layoutVertexBuffer.vertexCount);
+        } else {
+            program.draw(
+                context, gl::Triangles(), depthMode, stencilMode, colorMode,
+                std::move(allUniformValues),
+                CircleLayoutAttributes::allVariableBindings(layoutVertexBuffer)
+                    .concat(CircleCornerAttributes::Bindings { attributes::a_corner::Type::ConstantBinding() })
+                    .concat(paintPropertyBinders.attributeBindings(currentProperties)),
+                indexBuffer, segments);
+        }
+    }
 };
 
 using CircleLayoutVertex = CircleProgram::LayoutVertex;
+using CircleCornerVertex = CircleProgram::CornerVertex;
 using CircleAttributes = CircleProgram::Attributes;
 
 } // namespace mbgl
@@ -0,0 +1,29 @@
+#include <mbgl/programs/fill_extrusion_program.hpp>
+#include <mbgl/map/transform_state.hpp>
+#include <mbgl/util/constants.hpp>
+
+namespace mbgl {
+
+static_assert(sizeof(FillExtrusionLayoutVertex) == 12, "expected FillExtrusionLayoutVertex size");
+
+FillExtrusionUniforms::Values
+FillExtrusionUniforms::values(mat4 matrix, const TransformState& state) {
+    // The light's position in spherical coordinates: its distance, its azimuth clockwise from
+    // the top of the viewport in degrees, and its angle from the zenith in degrees.
+    const double radial = 1.15;
+    const double azimuthal = (210.0 + 90.0) * util::DEG2RAD - state.getAngle();
+    const double polar = 30.0 * util::DEG2RAD;
+
+    return FillExtrusionUniforms::Values {
+        uniforms::u_matrix::Value{ matrix },
+        uniforms::u_lightcolor::Value{ {{ 1, 1, 1 }} },
+        uniforms::u_lightpos::Value{ {{
+            float(radial * std::cos(azimuthal) * std::sin(polar)),
+            float(radial * std::sin(azimuthal) * std::sin(polar)),
+            float(radial * std::cos(polar))
+        }} },
+        uniforms::u_lightintensity::Value{ 0.5f }
+    };
+}
+
+} // namespace mbgl
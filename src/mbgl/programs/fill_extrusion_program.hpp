@@ -0,0 +1,90 @@
+#pragma once
+
+#include <mbgl/programs/program.hpp>
+#include <mbgl/programs/attributes.hpp>
+#include <mbgl/programs/uniforms.hpp>
+#include <mbgl/shaders/fill_extrusion.hpp>
+#include <mbgl/shaders/extrusion_texture.hpp>
+#include <mbgl/util/geometry.hpp>
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer_properties.hpp>
+
+#include <cmath>
+
+namespace mbgl {
+
+class TransformState;
+
+namespace uniforms {
+MBGL_DEFINE_UNIFORM_VECTOR(float, 3, u_lightpos);
+MBGL_DEFINE_UNIFORM_VECTOR(float, 3, u_lightcolor);
+MBGL_DEFINE_UNIFORM_SCALAR(float,    u_lightintensity);
+} // namespace uniforms
+
+struct FillExtrusionLayoutAttributes : gl::Attributes<
+    attributes::a_pos,
+    attributes::a_normal_ed>
+{};
+
+struct FillExtrusionUniforms : gl::Uniforms<
+    uniforms::u_matrix,
+    uniforms::u_lightcolor,
+    uniforms::u_lightpos,
+    uniforms::u_lightintensity>
+{
+    // Lights the extrusions from the top left of the viewport, whatever the bearing of the map.
+    static Values values(mat4 matrix, const TransformState&);
+};
+
+class FillExtrusionProgram : public Program<
+    shaders::fill_extrusion,
+    gl::Triangle,
+    FillExtrusionLayoutAttributes,
+    FillExtrusionUniforms,
+    style::FillExtrusionPaintProperties>
+{
+public:
+    using Program::Program;
+
+    // The normal is scaled to the range of the attribute. The lowest bit of its x component
+    // marks the vertices at the top of a wall, which are raised to the height of the feature
+    // rather than its base. The edge distance is the length of the walls of the ring before
+    // this vertex.
+    static LayoutVertex layoutVertex(Point<int16_t> p, double nx, double ny, double nz, bool top, uint16_t edgeDistance) {
+        const double factor = 1 << 13;
+        return LayoutVertex {
+            {{
+                p.x,
+                p.y
+            }},
+            {{
+                static_cast<int16_t>(std::floor(nx * factor) * 2 + top),
+                static_cast<int16_t>(ny * factor * 2),
+                static_cast<int16_t>(nz * factor * 2),
+                static_cast<int16_t>(edgeDistance)
+            }}
+        };
+    }
+};
+
+// Composites the extrusions of a layer, which are drawn into a texture of the size of the
+// viewport, with the layer's opacity.
+class ExtrusionTextureProgram : public Program<
+    shaders::extrusion_texture,
+    gl::Triangle,
+    gl::Attributes<attributes::a_pos>,
+    gl::Uniforms<
+        uniforms::u_matrix,
+        uniforms::u_image,
+        uniforms::u_opacity>,
+    style::PaintProperties<>>
+{
+public:
+    using Program::Program;
+};
+
+using FillExtrusionLayoutVertex = FillExtrusionProgram::LayoutVertex;
+using FillExtrusionAttributes = FillExtrusionProgram::Attributes;
+using ExtrusionTextureAttributes = ExtrusionTextureProgram::Attributes;
+
+} // namespace mbgl
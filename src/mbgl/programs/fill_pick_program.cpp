@@ -0,0 +1,7 @@
+#include <mbgl/programs/fill_pick_program.hpp>
+
+namespace mbgl {
+
+static_assert(sizeof(FillPickVertex) == 4, "expected FillPickVertex size");
+
+} // namespace mbgl
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <mbgl/programs/program.hpp>
+#include <mbgl/programs/attributes.hpp>
+#include <mbgl/programs/uniforms.hpp>
+#include <mbgl/programs/fill_program.hpp>
+#include <mbgl/shaders/fill_pick.hpp>
+
+#include <cstdint>
+
+namespace mbgl {
+
+namespace attributes {
+MBGL_DEFINE_ATTRIBUTE(uint8_t, 4, a_pick_id);
+} // namespace attributes
+
+namespace uniforms {
+MBGL_DEFINE_UNIFORM_SCALAR(float, u_pick_draw);
+} // namespace uniforms
+
+// The feature of each vertex of a fill bucket, in a buffer of its own, so that the bucket's
+// regular vertices stay the same whether or not picking is enabled.
+using FillPickAttributes = gl::Attributes<
+    attributes::a_pick_id>;
+
+// Draws the triangles of fill buckets into the picking buffer: each pixel holds the index of the
+// feature drawn last at it plus one, in red, green and blue, and the number of the draw in alpha.
+class FillPickProgram : public Program<
+    shaders::fill_pick,
+    gl::Triangle,
+    gl::ConcatenateAttributes<FillLayoutAttributes, FillPickAttributes>,
+    gl::Uniforms<
+        uniforms::u_matrix,
+        uniforms::u_pick_draw>,
+    style::PaintProperties<>>
+{
+public:
+    using Program::Program;
+
+    using PickVertex = FillPickAttributes::Vertex;
+
+    // Feature indices that don't fit into the three bytes can't be picked.
+    static constexpr std::size_t maxFeatureIndex = 0xFFFFFE;
+
+    static PickVertex pickVertex(std::size_t index) {
+        const std::size_t id = index + 1;
+        return PickVertex {
+            {{
+                static_cast<uint8_t>(id & 0xFF),
+                static_cast<uint8_t>((id >> 8) & 0xFF),
+                static_cast<uint8_t>((id >> 16) & 0xFF),
+                0
+            }}
+        };
+    }
+
+    void draw(gl::Context& context,
+              gl::DepthMode depthMode,
+              gl::StencilMode stencilMode,
+              gl::ColorMode colorMode,
+              UniformValues&& uniformValues,
+              const gl::VertexBuffer<FillLayoutVertex>& layoutVertexBuffer,
+              const gl::VertexBuffer<PickVertex>& pickVertexBuffer,
+              const gl::IndexBuffer<gl::Triangles>& indexBuffer,
+              const gl::SegmentVector<Attributes>& segments) {
+        get(context).draw(context, gl::Triangles(), depthMode, stencilMode, colorMode,
+                          std::move(uniformValues),
+                          FillLayoutAttributes::allVariableBindings(layoutVertexBuffer)
+                             .concat(FillPickAttributes::allVariableBindings(pickVertexBuffer)),
+                          indexBuffer, segments);
+    }
+};
+
+using FillPickVertex = FillPickProgram::PickVertex;
+
+} // namespace mbgl
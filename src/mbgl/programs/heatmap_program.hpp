@@ -0,0 +1,70 @@
+#pragma once
+
+#include <mbgl/programs/program.hpp>
+#include <mbgl/programs/attributes.hpp>
+#include <mbgl/programs/uniforms.hpp>
+#include <mbgl/shaders/heatmap.hpp>
+#include <mbgl/shaders/heatmap_texture.hpp>
+#include <mbgl/util/geometry.hpp>
+#include <mbgl/style/layers/heatmap_layer_properties.hpp>
+
+namespace mbgl {
+
+namespace uniforms {
+MBGL_DEFINE_UNIFORM_SCALAR(float, u_intensity);
+MBGL_DEFINE_UNIFORM_SCALAR(gl::TextureUnit, u_color_ramp);
+} // namespace uniforms
+
+// Adds the kernels of a layer's points to the density in the heatmap texture.
+class HeatmapProgram : public Program<
+    shaders::heatmap,
+    gl::Triangle,
+    gl::Attributes<
+        attributes::a_pos>,
+    gl::Uniforms<
+        uniforms::u_matrix,
+        uniforms::u_extrude_scale,
+        uniforms::u_intensity>,
+    style::HeatmapPaintProperties>
+{
+public:
+    using Program::Program;
+
+    /*
+     * @param {number} x vertex position
+     * @param {number} y vertex position
+     * @param {number} ex extrude normal
+     * @param {number} ey extrude normal
+     */
+    static LayoutVertex vertex(Point<int16_t> p, float ex, float ey) {
+        return LayoutVertex {
+            {{
+                static_cast<int16_t>((p.x * 2) + ((ex + 1) / 2)),
+                static_cast<int16_t>((p.y * 2) + ((ey + 1) / 2))
+            }}
+        };
+    }
+};
+
+// Colors the density in the heatmap texture, which is smaller than the viewport, with the
+// layer's color ramp and opacity.
+class HeatmapTextureProgram : public Program<
+    shaders::heatmap_texture,
+    gl::Triangle,
+    gl::Attributes<attributes::a_pos>,
+    gl::Uniforms<
+        uniforms::u_matrix,
+        uniforms::u_image,
+        uniforms::u_color_ramp,
+        uniforms::u_opacity>,
+    style::PaintProperties<>>
+{
+public:
+    using Program::Program;
+};
+
+using HeatmapLayoutVertex = HeatmapProgram::LayoutVertex;
+using HeatmapAttributes = HeatmapProgram::Attributes;
+using HeatmapTextureAttributes = HeatmapTextureProgram::Attributes;
+
+} // namespace mbgl
@@ -0,0 +1,11 @@
+#include <mbgl/programs/hillshade_program.hpp>
+#include <mbgl/programs/raster_program.hpp>
+
+#include <type_traits>
+
+namespace mbgl {
+
+// Both programs draw the vertices that raster tiles are drawn with.
+static_assert(std::is_same<HillshadeAttributes, RasterAttributes>::value, "expected the attributes of raster tiles");
+
+} // namespace mbgl
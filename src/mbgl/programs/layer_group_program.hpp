@@ -0,0 +1,28 @@
+#pragma once
+
+#include <mbgl/programs/program.hpp>
+#include <mbgl/programs/attributes.hpp>
+#include <mbgl/programs/uniforms.hpp>
+#include <mbgl/shaders/layer_group.hpp>
+#include <mbgl/style/paint_property.hpp>
+
+namespace mbgl {
+
+// Composites the texture that a group of layers was drawn into, which is larger than the
+// viewport and moved by how far the map panned since.
+class LayerGroupProgram : public Program<
+    shaders::layer_group,
+    gl::Triangle,
+    gl::Attributes<attributes::a_pos>,
+    gl::Uniforms<
+        uniforms::u_matrix,
+        uniforms::u_image>,
+    style::PaintProperties<>>
+{
+public:
+    using Program::Program;
+};
+
+using LayerGroupAttributes = LayerGroupProgram::Attributes;
+
+} // namespace mbgl
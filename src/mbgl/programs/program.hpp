@@ -9,6 +9,8 @@
 #include <mbgl/shaders/shaders.hpp>
 #include <mbgl/util/io.hpp>
 
+#include <map>
+
 namespace mbgl {
 
 template <class Shaders,
@@ -31,15 +33,45 @@ public:
 
     using ProgramType = gl::Program<Primitive, Attributes, AllUniforms>;
 
-    ProgramType program;
+    Program(gl::Context&, const ProgramParameters& programParameters)
+        : parameters(programParameters) {
+    }
 
-    Program(gl::Context& context, const ProgramParameters& programParameters)
-        : program(ProgramType::createProgram(
-            context,
-            programParameters,
-            Shaders::name,
-            Shaders::vertexSource,
-            Shaders::fragmentSource)) {
+    // Returns the variant of the program for a combination of paint property binders, which is
+    // compiled, or loaded from the program cache, the first time it is used.
+    ProgramType& get(gl::Context& context, const typename PaintPropertyBinders::Variant& variant = {}) {
+        auto it = variants.find(variant.to_ulong());
+        if (it == variants.end()) {
+            it = variants.emplace(variant.to_ulong(), ProgramType::createProgram(
+                context,
+                parameters,
+                Shaders::name,
+                Shaders::vertexSource,
+                Shaders::fragmentSource,
+                PaintPropertyBinders::defines(variant))).first;
+        }
+        return it->second;
+    }
+
+    // Creates and links every variant of the program, and passes the cache file name and the
+    // serialized binary of each variant that the context can read back to the function.
+    template <class Fn>
+    void warmUp(gl::Context& context, Fn&& fn) {
+        using Variant = typename PaintPropertyBinders::Variant;
+        for (unsigned long key = 0; key < (1ul << Variant().size()); ++key) {
+            const Variant variant(key);
+            const std::string defines = PaintPropertyBinders::defines(variant);
+            ProgramType& program = get(context, variant);
+            program.link(context);
+
+            const std::string identifier = shaders::programIdentifier(
+                shaders::vertexSource(parameters, Shaders::vertexSource, defines),
+                Shaders::fragmentSource);
+            if (auto binaryProgram = program.template get<BinaryProgram>(context, identifier)) {
+                fn(shaders::programCacheFileName(parameters, Shaders::name, defines),
+                   parameters.pixelRatio, binaryProgram->serialize());
+            }
+        }
     }
 
     template <class DrawMode>
@@ -54,8 +86,9 @@ public:
               const gl::SegmentVector<Attributes>& segments,
               const PaintPropertyBinders& paintPropertyBinders,
               const typename PaintProperties::Evaluated& currentProperties,
-              float currentZoom) {
-        program.draw(
+              float currentZoom,
+              const gl::SegmentFilter& filter = {}) {
+        get(context, paintPropertyBinders.variant()).draw(
             context,
             std::move(drawMode),
             std::move(depthMode),
@@ -66,9 +99,14 @@ public:
             LayoutAttributes::allVariableBindings(layoutVertexBuffer)
                 .concat(paintPropertyBinders.attributeBindings(currentProperties)),
             indexBuffer,
-            segments
+            segments,
+            filter
         );
     }
+
+private:
+    const ProgramParameters parameters;
+    std::map<unsigned long, ProgramType> variants;
 };
 
 } // namespace mbgl
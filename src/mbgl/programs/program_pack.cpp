@@ -0,0 +1,83 @@
+#include <mbgl/programs/program_pack.hpp>
+
+#include <protozero/pbf_reader.hpp>
+#include <protozero/pbf_writer.hpp>
+
+#include <stdexcept>
+
+static mbgl::ProgramPack::Entry parseEntry(protozero::pbf_reader&& pbf) {
+    bool hasFileName = false, hasPixelRatio = false, hasBinaryProgram = false;
+    mbgl::ProgramPack::Entry entry { {}, 0, {} };
+    while (pbf.next()) {
+        switch (pbf.tag()) {
+        case 1: // file name
+            entry.fileName = pbf.get_string();
+            hasFileName = true;
+            break;
+        case 2: // pixel ratio
+            entry.pixelRatio = pbf.get_float();
+            hasPixelRatio = true;
+            break;
+        case 3: // binary program
+            entry.binaryProgram = pbf.get_bytes();
+            hasBinaryProgram = true;
+            break;
+        default:
+            pbf.skip();
+            break;
+        }
+    }
+    if (!hasFileName || !hasPixelRatio || !hasBinaryProgram) {
+        throw std::runtime_error("ProgramPack entry is missing required fields");
+    }
+    // Entries are written into the program cache directory, and mustn't point out of it.
+    if (entry.fileName.find('/') != std::string::npos || entry.fileName.find('\\') != std::string::npos ||
+        entry.fileName.empty() || entry.fileName[0] == '.') {
+        throw std::runtime_error("ProgramPack entry has an invalid file name");
+    }
+    return entry;
+}
+
+namespace mbgl {
+
+ProgramPack::ProgramPack(std::string driverIdentifier, std::vector<Entry>&& entries_)
+    : driver(std::move(driverIdentifier)), programs(std::move(entries_)) {
+}
+
+ProgramPack::ProgramPack(const std::string& data) {
+    bool hasDriver = false;
+    protozero::pbf_reader pbf(data);
+    while (pbf.next()) {
+        switch (pbf.tag()) {
+        case 1: // driver identifier
+            driver = pbf.get_string();
+            hasDriver = true;
+            break;
+        case 2: // entry
+            programs.push_back(parseEntry(pbf.get_message()));
+            break;
+        default:
+            pbf.skip();
+            break;
+        }
+    }
+
+    if (!hasDriver) {
+        throw std::runtime_error("ProgramPack is missing required fields");
+    }
+}
+
+std::string ProgramPack::serialize() const {
+    std::string data;
+    protozero::pbf_writer pbf(data);
+    pbf.add_string(1 /* driver identifier */, driver);
+    for (const auto& entry : programs) {
+        protozero::pbf_writer pbf_entry(pbf, 2 /* entry */);
+        pbf_entry.add_string(1 /* file name */, entry.fileName);
+        pbf_entry.add_float(2 /* pixel ratio */, entry.pixelRatio);
+        pbf_entry.add_bytes(3 /* binary program */, entry.binaryProgram.data(), entry.binaryProgram.size());
+    }
+    return data;
+}
+
+} // namespace mbgl
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// The binary programs of a GPU driver, as they are written to the program cache, so that devices
+// with the same driver can fill their program caches without compiling any shaders.
+class ProgramPack {
+public:
+    class Entry {
+    public:
+        // The name of the program's file in the program cache directory.
+        std::string fileName;
+        float pixelRatio;
+        // A serialized BinaryProgram.
+        std::string binaryProgram;
+    };
+
+    ProgramPack(std::string driverIdentifier, std::vector<Entry>&&);
+
+    // Initialize a ProgramPack object from a serialized representation.
+    ProgramPack(const std::string& data);
+
+    std::string serialize() const;
+
+    const std::string& driverIdentifier() const {
+        return driver;
+    }
+    const std::vector<Entry>& entries() const {
+        return programs;
+    }
+
+private:
+    std::string driver;
+    std::vector<Entry> programs;
+};
+
+} // namespace mbgl
@@ -2,9 +2,14 @@
 
 #include <mbgl/programs/circle_program.hpp>
 #include <mbgl/programs/fill_program.hpp>
+#include <mbgl/programs/fill_extrusion_program.hpp>
+#include <mbgl/programs/heatmap_program.hpp>
+#include <mbgl/programs/hillshade_program.hpp>
+#include <mbgl/programs/layer_group_program.hpp>
 #include <mbgl/programs/line_program.hpp>
 #include <mbgl/programs/raster_program.hpp>
 #include <mbgl/programs/symbol_program.hpp>
+#include <mbgl/programs/annotation_icon_program.hpp>
 #include <mbgl/programs/debug_program.hpp>
 #include <mbgl/programs/collision_box_program.hpp>
 #include <mbgl/programs/program_parameters.hpp>
@@ -19,6 +24,14 @@ public:
           fillPattern(context, programParameters),
           fillOutline(context, programParameters),
           fillOutlinePattern(context, programParameters),
+          fillExtrusion(context, programParameters),
+          extrusionTexture(context, programParameters),
+          heatmap(context, programParameters),
+          heatmapTexture(context, programParameters),
+          hillshade(context, programParameters),
+          // The slopes are computed before the frame is drawn, so they aren't inspected for overdraw.
+          hillshadePrepare(context, ProgramParameters(programParameters.pixelRatio, false, programParameters.cacheDir)),
+          layerGroup(context, programParameters),
           line(context, programParameters),
           lineSDF(context, programParameters),
           linePattern(context, programParameters),
@@ -26,15 +39,50 @@ public:
           symbolIcon(context, programParameters),
           symbolIconSDF(context, programParameters),
           symbolGlyph(context, programParameters),
+          annotationIcon(context, programParameters),
           debug(context, ProgramParameters(programParameters.pixelRatio, false, programParameters.cacheDir)),
           collisionBox(context, ProgramParameters(programParameters.pixelRatio, false, programParameters.cacheDir)) {
     }
 
+    // Creates and links every variant of every program; see Program::warmUp().
+    template <class Fn>
+    void warmUp(gl::Context& context, Fn&& fn) {
+        circle.warmUp(context, fn);
+        fill.warmUp(context, fn);
+        fillPattern.warmUp(context, fn);
+        fillOutline.warmUp(context, fn);
+        fillOutlinePattern.warmUp(context, fn);
+        fillExtrusion.warmUp(context, fn);
+        extrusionTexture.warmUp(context, fn);
+        heatmap.warmUp(context, fn);
+        heatmapTexture.warmUp(context, fn);
+        hillshade.warmUp(context, fn);
+        hillshadePrepare.warmUp(context, fn);
+        layerGroup.warmUp(context, fn);
+        line.warmUp(context, fn);
+        lineSDF.warmUp(context, fn);
+        linePattern.warmUp(context, fn);
+        raster.warmUp(context, fn);
+        symbolIcon.warmUp(context, fn);
+        symbolIconSDF.warmUp(context, fn);
+        symbolGlyph.warmUp(context, fn);
+        annotationIcon.warmUp(context, fn);
+        debug.warmUp(context, fn);
+        collisionBox.warmUp(context, fn);
+    }
+
     CircleProgram circle;
     FillProgram fill;
     FillPatternProgram fillPattern;
     FillOutlineProgram fillOutline;
     FillOutlinePatternProgram fillOutlinePattern;
+    FillExtrusionProgram fillExtrusion;
+    ExtrusionTextureProgram extrusionTexture;
+    HeatmapProgram heatmap;
+    HeatmapTextureProgram heatmapTexture;
+    HillshadeProgram hillshade;
+    HillshadePrepareProgram hillshadePrepare;
+    LayerGroupProgram layerGroup;
     LineProgram line;
     LineSDFProgram lineSDF;
     LinePatternProgram linePattern;
@@ -42,6 +90,7 @@ public:
     SymbolIconProgram symbolIcon;
     SymbolSDFIconProgram symbolIconSDF;
     SymbolSDFTextProgram symbolGlyph;
+    AnnotationIconProgram annotationIcon;
 
     DebugProgram debug;
     CollisionBoxProgram collisionBox;
@@ -10,6 +10,7 @@ namespace mbgl {
 using namespace style;
 
 static_assert(sizeof(SymbolLayoutVertex) == 16, "expected SymbolLayoutVertex size");
+static_assert(sizeof(SymbolInstanceVertex) == 24, "expected SymbolInstanceVertex size");
 
 std::unique_ptr<SymbolSizeBinder> SymbolSizeBinder::create(const float tileZoom,
                                                     const style::DataDrivenPropertyValue<float>& sizeProperty,
@@ -105,7 +106,8 @@ typename SymbolSDFProgram<PaintProperties>::UniformValues SymbolSDFProgram<Paint
         uniforms::u_bearing::Value{ -1.0f * state.getAngle() },
         uniforms::u_aspect_ratio::Value{ (state.getSize().width * 1.0f) / (state.getSize().height * 1.0f) },
         uniforms::u_pitch_with_map::Value{ values.pitchAlignment == AlignmentType::Map },
-        uniforms::u_is_halo::Value{ part == SymbolSDFPart::Halo }
+        uniforms::u_is_halo::Value{ part == SymbolSDFPart::Halo },
+        uniforms::u_is_halo_and_fill::Value{ part == SymbolSDFPart::HaloAndFill }
     );
 }
 
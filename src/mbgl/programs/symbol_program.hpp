@@ -7,16 +7,19 @@
 
 #include <mbgl/programs/attributes.hpp>
 #include <mbgl/programs/uniforms.hpp>
-#include <mbgl/shaders/symbol_icon.hpp>
-#include <mbgl/shaders/symbol_sdf.hpp>
+#include <mbgl/shaders/symbol_icon_instanced.hpp>
+#include <mbgl/shaders/symbol_sdf_instanced.hpp>
 #include <mbgl/util/geometry.hpp>
+#include <mbgl/util/rect.hpp>
 #include <mbgl/util/size.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 
 
+#include <algorithm>
 #include <cmath>
 #include <array>
+#include <map>
 
 namespace mbgl {
 
@@ -27,6 +30,10 @@ class SymbolPropertyValues;
 class RenderTile;
 class TransformState;
 
+namespace attributes {
+MBGL_DEFINE_ATTRIBUTE(int16_t, 4, a_quad);
+} // namespace attributes
+
 namespace uniforms {
 MBGL_DEFINE_UNIFORM_VECTOR(float, 2, u_texsize);
 MBGL_DEFINE_UNIFORM_SCALAR(bool, u_rotate_with_map);
@@ -35,6 +42,7 @@ MBGL_DEFINE_UNIFORM_SCALAR(gl::TextureUnit, u_texture);
 MBGL_DEFINE_UNIFORM_SCALAR(gl::TextureUnit, u_fadetexture);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_aspect_ratio);
 MBGL_DEFINE_UNIFORM_SCALAR(bool, u_is_halo);
+MBGL_DEFINE_UNIFORM_SCALAR(bool, u_is_halo_and_fill);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_gamma_scale);
 
 MBGL_DEFINE_UNIFORM_SCALAR(bool, u_is_text);
@@ -45,6 +53,22 @@ MBGL_DEFINE_UNIFORM_SCALAR(float, u_size);
 MBGL_DEFINE_UNIFORM_SCALAR(float, u_layout_size);
 } // namespace uniforms
 
+// The zoom levels from which placement shows the four vertices of a quad, in tenths of zoom
+// levels as stored in the vertices. Quads that aren't shown at all start beyond the maximum zoom
+// level.
+struct SymbolQuadPlacement {
+    uint8_t minZoom;
+    uint8_t labelMinZoom;
+
+    static SymbolQuadPlacement hidden() {
+        return { 255, 255 };
+    }
+
+    static SymbolQuadPlacement fromZoom(float minZoom, float labelMinZoom) {
+        return { static_cast<uint8_t>(minZoom * 10), static_cast<uint8_t>(labelMinZoom * 10) };
+    }
+};
+
 struct SymbolLayoutAttributes : gl::Attributes<
     attributes::a_pos_offset,
     attributes::a_data<uint16_t, 4>>
@@ -79,6 +103,97 @@ struct SymbolLayoutAttributes : gl::Attributes<
             }}
         };
     }
+
+    // Replaces the zoom levels that placement determines, keeping the rest of the vertex.
+    template <class V>
+    static void place(V& vertex, SymbolQuadPlacement placement) {
+        auto& data = vertex.a2;
+        data[2] = mbgl::attributes::packUint8Pair(placement.labelMinZoom, static_cast<uint8_t>(data[2] & 0xFF));
+        data[3] = mbgl::attributes::packUint8Pair(placement.minZoom, static_cast<uint8_t>(data[3] & 0xFF));
+    }
+};
+
+// The edges of a quad, for drawing it as an instance: the offset of its top right corner from
+// its top left one, in 1/64 pixels, the signed length of its left edge, which is at a right
+// angle to the top one, and the size of its texture, packed like the texture coordinates.
+using SymbolQuadAttributes = gl::Attributes<
+    attributes::a_quad>;
+
+using SymbolCornerAttributes = gl::Attributes<
+    attributes::a_corner>;
+
+// A vertex per quad: the attributes of its top left corner, and its edges. Contexts that support
+// instancing draw it at the corners of a single quad; for the others, corners() expands it into
+// the vertices of its four corners.
+struct SymbolInstanceAttributes : gl::Attributes<
+    attributes::a_pos_offset,
+    attributes::a_data<uint16_t, 4>,
+    attributes::a_quad>
+{
+    // Quads are rectangles, which may be rotated.
+    static Vertex instance(Point<float> anchor,
+                           Point<float> tl,
+                           Point<float> tr,
+                           Point<float> bl,
+                           Rect<uint16_t> tex,
+                           float maxzoom,
+                           uint8_t labelangle) {
+        const SymbolLayoutAttributes::Vertex corner =
+            SymbolLayoutAttributes::vertex(anchor, tl, tex.x, tex.y, 0, maxzoom, 0, labelangle);
+
+        // The edges are taken between the offsets as the vertices of the corners store them, so
+        // that the top right corner of an expanded quad is where its vertex would have put it.
+        const auto offset = [] (Point<float> p) {
+            return Point<float>(::round(p.x * 64), ::round(p.y * 64));
+        };
+        const Point<float> right = offset(tr) - offset(tl);
+        const Point<float> down = offset(bl) - offset(tl);
+        const float width = std::max(std::hypot(right.x, right.y), 1.0f);
+
+        return Vertex {
+            corner.a1,
+            corner.a2,
+            {{
+                static_cast<int16_t>(right.x),
+                static_cast<int16_t>(right.y),
+                static_cast<int16_t>(::round((right.x * down.y - right.y * down.x) / width)),
+                static_cast<int16_t>(mbgl::attributes::packUint8Pair(
+                    (tex.x + tex.w) / 4 - tex.x / 4,
+                    (tex.y + tex.h) / 4 - tex.y / 4))
+            }}
+        };
+    }
+
+    // The vertices of the top left, top right, bottom left and bottom right corners of the quad,
+    // as the vertex shader puts them when it draws the quad as an instance.
+    static std::array<SymbolLayoutAttributes::Vertex, 4> corners(const Vertex& instance) {
+        const auto& quad = instance.a3;
+        const Point<float> right(quad[0], quad[1]);
+        const float height = quad[2] / std::max(std::hypot(right.x, right.y), 1.0f);
+        const Point<float> down(-right.y * height, right.x * height);
+        const uint16_t texsize = static_cast<uint16_t>(quad[3]);
+
+        std::array<SymbolLayoutAttributes::Vertex, 4> result;
+        for (std::size_t i = 0; i < 4; i++) {
+            const uint16_t x = i & 1;
+            const uint16_t y = i >> 1;
+            result[i] = SymbolLayoutAttributes::Vertex {
+                {{
+                    instance.a1[0],
+                    instance.a1[1],
+                    static_cast<int16_t>(::round(instance.a1[2] + x * right.x + y * down.x)),
+                    static_cast<int16_t>(::round(instance.a1[3] + x * right.y + y * down.y))
+                }},
+                {{
+                    static_cast<uint16_t>(instance.a2[0] + x * (texsize >> 8)),
+                    static_cast<uint16_t>(instance.a2[1] + y * (texsize & 0xFF)),
+                    instance.a2[2],
+                    instance.a2[3]
+                }}
+            };
+        }
+        return result;
+    }
 };
     
 class SymbolSizeAttributes : public gl::Attributes<attributes::a_size> {
@@ -104,10 +219,15 @@ public:
                                                     const style::DataDrivenPropertyValue<float>& sizeProperty,
                                                     const float defaultValue);
 
-    virtual SymbolSizeAttributes::Bindings attributeBindings(const style::PossiblyEvaluatedPropertyValue<float> currentValue) const = 0;
+    // A non-zero divisor binds the vertices one per that many instances, for instanced draws.
+    virtual SymbolSizeAttributes::Bindings attributeBindings(const style::PossiblyEvaluatedPropertyValue<float> currentValue, uint32_t divisor) const = 0;
+    // Adds a vertex for a quad.
     virtual void populateVertexVector(const GeometryTileFeature& feature) = 0;
     virtual UniformValues uniformValues(float currentZoom) const = 0;
-    virtual void upload(gl::Context&) = 0;
+    // Uploads each vertex `repeat` times; see style::repeatVertices().
+    virtual void upload(gl::Context&, std::size_t repeat) = 0;
+    virtual void shrinkToFit() = 0;
+    virtual void releaseVertexVector() = 0;
 };
 
 // Return the smallest range of stops that covers the interval [lowerZoom, upperZoom]
@@ -154,10 +274,12 @@ public:
         );
     }
     
-    SymbolSizeAttributes::Bindings attributeBindings(const style::PossiblyEvaluatedPropertyValue<float>) const override {
+    SymbolSizeAttributes::Bindings attributeBindings(const style::PossiblyEvaluatedPropertyValue<float>, uint32_t) const override {
         return SymbolSizeAttributes::Bindings { SymbolSizeAttributes::Attribute::ConstantBinding {{{0, 0, 0}}} };
     }
-    void upload(gl::Context&) override {}
+    void upload(gl::Context&, std::size_t) override {}
+    void shrinkToFit() override {}
+    void releaseVertexVector() override {}
     void populateVertexVector(const GeometryTileFeature&) override {};
     
     UniformValues uniformValues(float currentZoom) const override {
@@ -208,12 +330,12 @@ public:
           defaultValue(defaultValue_) {
     }
 
-    SymbolSizeAttributes::Bindings attributeBindings(const style::PossiblyEvaluatedPropertyValue<float> currentValue) const override {
+    SymbolSizeAttributes::Bindings attributeBindings(const style::PossiblyEvaluatedPropertyValue<float> currentValue, uint32_t divisor) const override {
         if (currentValue.isConstant()) {
             return SymbolSizeAttributes::Bindings { SymbolSizeAttributes::Attribute::ConstantBinding {{{0, 0, 0}}} };
         }
         
-        return SymbolSizeAttributes::Bindings { SymbolSizeAttributes::Attribute::variableBinding(*buffer, 0, 1) };
+        return SymbolSizeAttributes::Bindings { SymbolSizeAttributes::Attribute::variableBinding(*buffer, 0, 1, divisor) };
     }
     
     void populateVertexVector(const GeometryTileFeature& feature) override {
@@ -224,9 +346,6 @@ public:
         };
         
         vertices.emplace_back(sizeVertex);
-        vertices.emplace_back(sizeVertex);
-        vertices.emplace_back(sizeVertex);
-        vertices.emplace_back(sizeVertex);
     };
     
     UniformValues uniformValues(float) const override {
@@ -239,8 +358,18 @@ public:
         };
     }
     
-    void upload(gl::Context& context) override {
-        buffer = VertexBuffer { context.createVertexBuffer(std::move(vertices)) };
+    void upload(gl::Context& context, std::size_t repeat) override {
+        buffer = VertexBuffer { repeat == 1
+            ? context.createVertexBuffer(std::move(vertices))
+            : context.createVertexBuffer(style::repeatVertices(vertices, repeat)) };
+    }
+
+    void shrinkToFit() override {
+        vertices.shrinkToFit();
+    }
+
+    void releaseVertexVector() override {
+        vertices.release();
     }
     
     const style::SourceFunction<float>& function;
@@ -265,12 +394,12 @@ public:
             return getCoveringStops(stops, tileZoom, tileZoom + 1); }))
     {}
 
-    SymbolSizeAttributes::Bindings attributeBindings(const style::PossiblyEvaluatedPropertyValue<float> currentValue) const override {
+    SymbolSizeAttributes::Bindings attributeBindings(const style::PossiblyEvaluatedPropertyValue<float> currentValue, uint32_t divisor) const override {
         if (currentValue.isConstant()) {
             return SymbolSizeAttributes::Bindings { SymbolSizeAttributes::Attribute::ConstantBinding {{{0, 0, 0}}} };
         }
         
-        return SymbolSizeAttributes::Bindings { SymbolSizeAttributes::Attribute::variableBinding(*buffer, 0) };
+        return SymbolSizeAttributes::Bindings { SymbolSizeAttributes::Attribute::variableBinding(*buffer, 0, 3, divisor) };
     }
     
     void populateVertexVector(const GeometryTileFeature& feature) override {
@@ -283,9 +412,6 @@ public:
         };
         
         vertices.emplace_back(sizeVertex);
-        vertices.emplace_back(sizeVertex);
-        vertices.emplace_back(sizeVertex);
-        vertices.emplace_back(sizeVertex);
     };
     
     UniformValues uniformValues(float currentZoom) const override {
@@ -303,8 +429,18 @@ public:
         };
     }
     
-    void upload(gl::Context& context) override {
-        buffer = VertexBuffer { context.createVertexBuffer(std::move(vertices)) };
+    void upload(gl::Context& context, std::size_t repeat) override {
+        buffer = VertexBuffer { repeat == 1
+            ? context.createVertexBuffer(std::move(vertices))
+            : context.createVertexBuffer(style::repeatVertices(vertices, repeat)) };
+    }
+
+    void shrinkToFit() override {
+        vertices.shrinkToFit();
+    }
+
+    void releaseVertexVector() override {
+        vertices.release();
     }
     
     const style::CompositeFunction<float>& function;
@@ -317,16 +453,21 @@ public:
 };
 
 
+// Draws the quads of a bucket. Contexts that support instancing draw a single quad, once for
+// each quad of the bucket, with a vertex per quad whose top left corner is offset along its edges
+// to the corners; the others draw the vertices of the corners of each quad.
 template <class Shaders,
           class Primitive,
-          class LayoutAttrs,
           class Uniforms,
           class PaintProperties>
 class SymbolProgram {
 public:
-    using LayoutAttributes = LayoutAttrs;
-    using LayoutVertex = typename LayoutAttributes::Vertex;
-    
+    using InstanceAttributes = SymbolInstanceAttributes;
+    using InstanceVertex = InstanceAttributes::Vertex;
+    using LayoutVertex = SymbolLayoutAttributes::Vertex;
+    using CornerVertex = SymbolCornerAttributes::Vertex;
+
+    using LayoutAttributes = gl::ConcatenateAttributes<InstanceAttributes, SymbolCornerAttributes>;
     using LayoutAndSizeAttributes = gl::ConcatenateAttributes<LayoutAttributes, SymbolSizeAttributes>;
 
     using PaintPropertyBinders = typename PaintProperties::Binders;
@@ -340,17 +481,49 @@ public:
 
     using ProgramType = gl::Program<Primitive, Attributes, AllUniforms>;
 
-    ProgramType program;
+    SymbolProgram(gl::Context&, const ProgramParameters& programParameters)
+        : parameters(programParameters) {
+    }
+
+    // Returns the variant of the program for a combination of paint property binders; see
+    // Program::get().
+    ProgramType& get(gl::Context& context, const typename PaintPropertyBinders::Variant& variant) {
+        auto it = variants.find(variant.to_ulong());
+        if (it == variants.end()) {
+            it = variants.emplace(variant.to_ulong(), ProgramType::createProgram(
+                context,
+                parameters,
+                Shaders::name,
+                Shaders::vertexSource,
+                Shaders::fragmentSource,
+                PaintPropertyBinders::defines(variant))).first;
+        }
+        return it->second;
+    }
 
-    SymbolProgram(gl::Context& context, const ProgramParameters& programParameters)
-        : program(ProgramType::createProgram(
-            context,
-            programParameters,
-            Shaders::name,
-            Shaders::vertexSource,
-            Shaders::fragmentSource)) {
+    // Creates and links every variant of the program, and passes the cache file name and the
+    // serialized binary of each variant that the context can read back to the function.
+    template <class Fn>
+    void warmUp(gl::Context& context, Fn&& fn) {
+        using Variant = typename PaintPropertyBinders::Variant;
+        for (unsigned long key = 0; key < (1ul << Variant().size()); ++key) {
+            const Variant variant(key);
+            const std::string defines = PaintPropertyBinders::defines(variant);
+            ProgramType& program = get(context, variant);
+            program.link(context);
+
+            const std::string identifier = shaders::programIdentifier(
+                shaders::vertexSource(parameters, Shaders::vertexSource, defines),
+                Shaders::fragmentSource);
+            if (auto binaryProgram = program.template get<BinaryProgram>(context, identifier)) {
+                fn(shaders::programCacheFileName(parameters, Shaders::name, defines),
+                   parameters.pixelRatio, binaryProgram->serialize());
+            }
+        }
     }
 
+    // Draws the quads as instances of the corner buffer's quad if an instance buffer is given,
+    // and from the vertices of their corners otherwise.
     template <class DrawMode>
     void draw(gl::Context& context,
               DrawMode drawMode,
@@ -358,7 +531,9 @@ public:
               gl::StencilMode stencilMode,
               gl::ColorMode colorMode,
               UniformValues&& uniformValues,
-              const gl::VertexBuffer<LayoutVertex>& layoutVertexBuffer,
+              const gl::VertexBuffer<InstanceVertex>* instanceBuffer,
+              const gl::VertexBuffer<CornerVertex>& cornerBuffer,
+              const gl::VertexBuffer<LayoutVertex>* layoutVertexBuffer,
               const SymbolSizeBinder& symbolSizeBinder,
               const style::PossiblyEvaluatedPropertyValue<float>& currentSizeValue,
               const gl::IndexBuffer<DrawMode>& indexBuffer,
@@ -366,28 +541,42 @@ public:
               const PaintPropertyBinders& paintPropertyBinders,
               const typename PaintProperties::Evaluated& currentProperties,
               float currentZoom) {
-        program.draw(
-            context,
-            std::move(drawMode),
-            std::move(depthMode),
-            std::move(stencilMode),
-            std::move(colorMode),
-            uniformValues
-                .concat(symbolSizeBinder.uniformValues(currentZoom))
-                .concat(paintPropertyBinders.uniformValues(currentZoom)),
-            LayoutAttributes::allVariableBindings(layoutVertexBuffer)
-                .concat(symbolSizeBinder.attributeBindings(currentSizeValue))
-                .concat(paintPropertyBinders.attributeBindings(currentProperties)),
-            indexBuffer,
-            segments
-        );
+        auto& program = get(context, paintPropertyBinders.variant());
+        auto allUniformValues = uniformValues
+            .concat(symbolSizeBinder.uniformValues(currentZoom))
+            .concat(paintPropertyBinders.uniformValues(currentZoom));
+
+        if (instanceBuffer) {
+            program.drawInstanced(
+                context, std::move(drawMode), depthMode, stencilMode, colorMode,
+                std::move(allUniformValues),
+                InstanceAttributes::allInstanceBindings(*instanceBuffer)
+                    .concat(SymbolCornerAttributes::allVariableBindings(cornerBuffer))
+                    .concat(symbolSizeBinder.attributeBindings(currentSizeValue, 1))
+                    .concat(paintPropertyBinders.instanceBindings(currentProperties)),
+                indexBuffer, segments, instanceBuffer->vertexCount);
+        } else {
+            assert(layoutVertexBuffer);
+            program.draw(
+                context, std::move(drawMode), depthMode, stencilMode, colorMode,
+                std::move(allUniformValues),
+                SymbolLayoutAttributes::allVariableBindings(*layoutVertexBuffer)
+                    .concat(SymbolQuadAttributes::Bindings { attributes::a_quad::Type::ConstantBinding() })
+                    .concat(SymbolCornerAttributes::Bindings { attributes::a_corner::Type::ConstantBinding() })
+                    .concat(symbolSizeBinder.attributeBindings(currentSizeValue, 0))
+                    .concat(paintPropertyBinders.attributeBindings(currentProperties)),
+                indexBuffer, segments);
+        }
     }
+
+private:
+    const ProgramParameters parameters;
+    std::map<unsigned long, ProgramType> variants;
 };
 
 class SymbolIconProgram : public SymbolProgram<
-    shaders::symbol_icon,
+    shaders::symbol_icon_instanced,
     gl::Triangle,
-    SymbolLayoutAttributes,
     gl::Uniforms<
         uniforms::u_matrix,
         uniforms::u_extrude_scale,
@@ -410,16 +599,19 @@ public:
                                        const TransformState&);
 };
 
+// HaloAndFill draws the halo and the fill of each glyph in one pass, with the fill over the halo.
+// Unlike drawing all halos before all fills, a halo may then cover the fill of a neighbouring
+// glyph where the two are closer than the halo is wide.
 enum class SymbolSDFPart {
     Fill = 1,
-    Halo = 0
+    Halo = 0,
+    HaloAndFill = 2
 };
 
 template <class PaintProperties>
 class SymbolSDFProgram : public SymbolProgram<
-    shaders::symbol_sdf,
+    shaders::symbol_sdf_instanced,
     gl::Triangle,
-    SymbolLayoutAttributes,
     gl::Uniforms<
         uniforms::u_matrix,
         uniforms::u_extrude_scale,
@@ -434,13 +626,13 @@ class SymbolSDFProgram : public SymbolProgram<
         uniforms::u_bearing,
         uniforms::u_aspect_ratio,
         uniforms::u_pitch_with_map,
-        uniforms::u_is_halo>,
+        uniforms::u_is_halo,
+        uniforms::u_is_halo_and_fill>,
     PaintProperties>
 {
 public:
-    using BaseProgram = SymbolProgram<shaders::symbol_sdf,
+    using BaseProgram = SymbolProgram<shaders::symbol_sdf_instanced,
         gl::Triangle,
-        SymbolLayoutAttributes,
         gl::Uniforms<
             uniforms::u_matrix,
             uniforms::u_extrude_scale,
@@ -455,7 +647,8 @@ public:
             uniforms::u_bearing,
             uniforms::u_aspect_ratio,
             uniforms::u_pitch_with_map,
-            uniforms::u_is_halo>,
+            uniforms::u_is_halo,
+            uniforms::u_is_halo_and_fill>,
         PaintProperties>;
     
     using UniformValues = typename BaseProgram::UniformValues;
@@ -477,6 +670,8 @@ using SymbolSDFIconProgram = SymbolSDFProgram<style::IconPaintProperties>;
 using SymbolSDFTextProgram = SymbolSDFProgram<style::TextPaintProperties>;
 
 using SymbolLayoutVertex = SymbolLayoutAttributes::Vertex;
+using SymbolInstanceVertex = SymbolInstanceAttributes::Vertex;
+using SymbolCornerVertex = SymbolCornerAttributes::Vertex;
 using SymbolIconAttributes = SymbolIconProgram::Attributes;
 using SymbolTextAttributes = SymbolSDFTextProgram::Attributes;
 
@@ -2,9 +2,20 @@
 
 #include <mbgl/renderer/render_pass.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/feature_state.hpp>
+#include <mbgl/tile/property_columns.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace mbgl {
 
@@ -18,6 +29,7 @@ class Context;
 
 namespace style {
 class Layer;
+class BucketParameters;
 } // namespace style
 
 class Bucket : private util::noncopyable {
@@ -25,8 +37,17 @@ public:
     Bucket() = default;
     virtual ~Bucket() = default;
 
+    // Adds a feature of the tile's source layer, given its index within the layer.
     virtual void addFeature(const GeometryTileFeature&,
-                            const GeometryCollection&) {};
+                            const GeometryCollection&,
+                            std::size_t /* index */) {};
+
+    // The feature properties that the data-driven paint properties of the bucket's layers read.
+    // Layout decodes them for all features at once, and passes the features to addFeature() as
+    // ColumnarFeatures.
+    virtual std::vector<std::string> paintPropertyKeys() const {
+        return {};
+    }
 
     // As long as this bucket has a Prepare render pass, this function is getting called. Typically,
     // this only happens once when the bucket is being rendered for the first time.
@@ -38,12 +59,137 @@ public:
 
     virtual bool hasData() const = 0;
 
+    // Returns the number of bytes of vertex, index or image data held by this bucket, whether
+    // or not it has been uploaded.
+    virtual std::size_t getByteSize() const = 0;
+
+    // Returns the part of getByteSize() that has been uploaded to buffers and textures.
+    virtual std::size_t getBufferByteSize() const {
+        return 0;
+    }
+
+    // Splits the segments by where their primitives are in the tile, so that the painter can
+    // skip the ones that are off-screen. Called once layout has added all features.
+    virtual void splitSegments() {}
+
+    // Frees the capacity that layout left unused in the vertex and index vectors, so that
+    // buckets which keep their data hold no more memory than they need.
+    virtual void shrinkToFit() {}
+
+    // Frees the vertex, index or image data once upload() has copied it to the GPU. The bucket
+    // can still be rendered, but neither uploaded again nor cloned.
+    virtual void releaseData() {}
+
+    // Frees the buffers of the bucket, which is uploaded again before it is next rendered, for
+    // when the context holds more than its memory budget. Returns false without freeing them if
+    // the bucket couldn't be uploaded again, because upload() or releaseData() consumed its data,
+    // or because the bucket doesn't support this.
+    virtual bool releaseBuffers() {
+        return false;
+    }
+
+    // Returns a copy of a bucket that has not been uploaded yet, for sharing layout results
+    // between maps, or nullptr if the bucket doesn't support copying.
+    virtual std::unique_ptr<Bucket> clone() const {
+        return nullptr;
+    }
+
+    // Whether the bucket would be the same if it was laid out from the same data at another
+    // zoom level, which lets the tiles that overzoom a canonical tile share it; see
+    // OverzoomBucketCache.
+    virtual bool isZoomConstant() const {
+        return false;
+    }
+
+    // Evaluates the paint properties of the layers again for the features that were added to
+    // this bucket, for a layout in which only their data-driven paint properties or the states
+    // of the features changed. The
+    // bucket may be uploaded meanwhile, so this only reads it; the returned function replaces its
+    // paint property binders on the render thread. Returns an empty function if the bucket
+    // doesn't support this.
+    virtual std::function<void ()> repaint(const style::BucketParameters&,
+                                           const std::vector<const style::Layer*>&,
+                                           const GeometryTileLayer&,
+                                           const FeatureStateMap*) {
+        return {};
+    }
+
     bool needsUpload() const {
         return !uploaded;
     }
 
 protected:
+    // Segments split by splitSegments() span at most half of the tile, unless that would leave
+    // them with fewer primitives than this, each of them being drawn with a call of its own.
+    static constexpr int32_t maxSegmentSize = util::EXTENT / 2;
+    static constexpr std::size_t minSegmentPrimitives = 1024;
+
+    // Called by addFeature() once the vertices of the feature were added.
+    void addFeatureVertices(std::size_t index, std::size_t vertexCount) {
+        featureVertices.emplace_back(index, vertexCount);
+    }
+
+    template <class Binders>
+    static std::vector<std::string> paintPropertyKeys(const std::map<std::string, Binders>& binders) {
+        std::vector<std::string> keys;
+        for (const auto& pair : binders) {
+            pair.second.addPropertyKeys(keys);
+        }
+        return keys;
+    }
+
+    // Binders depend on the zoom level of the tile only when they interpolate between the values
+    // of a composite function.
+    template <class Binders>
+    static bool isZoomConstant(const std::map<std::string, Binders>& binders) {
+        return std::all_of(binders.begin(), binders.end(), [] (const auto& pair) {
+            return pair.second.variant().all();
+        });
+    }
+
+    // Populates paint property binders with the values of the features that were added.
+    template <class Binders>
+    void populatePaintPropertyBinders(std::map<std::string, Binders>& binders,
+                                      const GeometryTileLayer& sourceLayer,
+                                      const FeatureStateMap* states) const {
+        PropertyColumns columns(paintPropertyKeys(binders), sourceLayer.featureCount());
+        if (!columns.getKeys().empty()) {
+            sourceLayer.decodeProperties(columns);
+        }
+
+        for (const auto& pair : featureVertices) {
+            auto feature = sourceLayer.getFeature(pair.first);
+            const ColumnarFeature columnar(*feature, columns, pair.first);
+            const PropertyMap* state = findFeatureState(states, *feature);
+            for (auto& binder : binders) {
+                if (state) {
+                    binder.second.populateVertexVectors(FeatureWithState(columnar, *state), pair.second);
+                } else {
+                    binder.second.populateVertexVectors(columnar, pair.second);
+                }
+            }
+        }
+    }
+
+    // Replaces the paint property binders, so that only they are uploaded again if the bucket
+    // was uploaded before.
+    template <class Binders>
+    void setPaintPropertyBinders(std::map<std::string, Binders>& target,
+                                 std::map<std::string, Binders>&& binders) {
+        target = std::move(binders);
+        if (uploaded) {
+            paintChanged = true;
+            uploaded = false;
+        }
+    }
+
     std::atomic<bool> uploaded { false };
+
+    // Whether only the paint property binders need to be uploaded.
+    bool paintChanged = false;
+
+    // The index of each feature that was added, with the number of vertices once it was added.
+    std::vector<std::pair<std::size_t, std::size_t>> featureVertices;
 };
 
 } // namespace mbgl
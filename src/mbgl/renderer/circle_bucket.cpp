@@ -6,33 +6,154 @@
 #include <mbgl/style/layers/circle_layer_impl.hpp>
 #include <mbgl/util/constants.hpp>
 
+#include <cassert>
+#include <limits>
+
 namespace mbgl {
 
 using namespace style;
 
-CircleBucket::CircleBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers)
-    : mode(parameters.mode) {
+static std::map<std::string, CircleProgram::PaintPropertyBinders>
+createPaintPropertyBinders(const BucketParameters& parameters, const std::vector<const Layer*>& layers) {
+    std::map<std::string, CircleProgram::PaintPropertyBinders> binders;
     for (const auto& layer : layers) {
-        paintPropertyBinders.emplace(
+        binders.emplace(
             std::piecewise_construct,
             std::forward_as_tuple(layer->getID()),
             std::forward_as_tuple(
                 layer->as<CircleLayer>()->impl->paint.evaluated,
                 parameters.tileID.overscaledZ));
     }
+    return binders;
+}
+
+CircleBucket::CircleBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers)
+    : paintPropertyBinders(createPaintPropertyBinders(parameters, layers)),
+      mode(parameters.mode) {
+}
+
+CircleBucket::CircleBucket(const CircleBucket& other)
+    : vertices(other.vertices),
+      paintPropertyBinders(other.paintPropertyBinders),
+      mode(other.mode),
+      circleCount(other.circleCount) {
+    featureVertices = other.featureVertices;
+}
+
+std::unique_ptr<Bucket> CircleBucket::clone() const {
+    assert(!uploaded);
+    return std::unique_ptr<Bucket>(new CircleBucket(*this));
+}
+
+std::function<void ()> CircleBucket::repaint(const BucketParameters& parameters,
+                                             const std::vector<const Layer*>& layers,
+                                             const GeometryTileLayer& sourceLayer,
+                                             const FeatureStateMap* states) {
+    auto binders = std::make_shared<std::map<std::string, CircleProgram::PaintPropertyBinders>>(
+        createPaintPropertyBinders(parameters, layers));
+    populatePaintPropertyBinders(*binders, sourceLayer, states);
+    for (auto& pair : *binders) {
+        pair.second.shrinkToFit();
+    }
+    return [this, binders] {
+        setPaintPropertyBinders(paintPropertyBinders, std::move(*binders));
+    };
 }
 
 void CircleBucket::upload(gl::Context& context) {
-    vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    indexBuffer = context.createIndexBuffer(std::move(triangles));
+    if (!paintChanged) {
+        instanced = context.supportsInstancing();
+        segments.clear();
+        indexBuffer = {};
+
+        if (instanced) {
+            segments.emplace_back(0, 0, 4, 6);
+            vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        } else {
+            constexpr const uint16_t vertexLength = 4;
+
+            gl::VertexVector<CircleLayoutVertex> quads;
+            gl::IndexVector<gl::Triangles> triangles;
+            for (std::size_t i = 0; i < vertices.vertexSize(); i++) {
+                if (segments.empty() || segments.back().vertexLength + vertexLength > std::numeric_limits<uint16_t>::max()) {
+                    // Move to a new segments because the old one can't hold the geometry.
+                    segments.emplace_back(quads.vertexSize(), triangles.indexSize());
+                }
+
+                // Each circle is drawn as two triangles.
+                //
+                // ┌─────────┐
+                // │ 4     3 │
+                // │         │
+                // │ 1     2 │
+                // └─────────┘
+                //
+                const int16_t x = vertices.data()[i].a1[0];
+                const int16_t y = vertices.data()[i].a1[1];
+                quads.emplace_back(CircleLayoutVertex {{{ x, y }}});                             // 1
+                quads.emplace_back(CircleLayoutVertex {{{ int16_t(x + 1), y }}});                // 2
+                quads.emplace_back(CircleLayoutVertex {{{ int16_t(x + 1), int16_t(y + 1) }}});   // 3
+                quads.emplace_back(CircleLayoutVertex {{{ x, int16_t(y + 1) }}});                // 4
+
+                auto& segment = segments.back();
+                assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
+                uint16_t index = segment.vertexLength;
+
+                // 1, 2, 3
+                // 1, 4, 3
+                triangles.emplace_back(index, index + 1, index + 2);
+                triangles.emplace_back(index, index + 3, index + 2);
+
+                segment.vertexLength += vertexLength;
+                segment.indexLength += 6;
+            }
+
+            vertexBuffer = context.createVertexBuffer(std::move(quads));
+            indexBuffer = gl::createIndexBuffer(context, std::move(triangles), segments);
+        }
+    }
 
     for (auto& pair : paintPropertyBinders) {
-        pair.second.upload(context);
+        pair.second.upload(context, instanced ? 1 : 4);
     }
 
+    paintChanged = false;
     uploaded = true;
 }
 
+void CircleBucket::shrinkToFit() {
+    vertices.shrinkToFit();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.shrinkToFit();
+    }
+}
+
+void CircleBucket::releaseData() {
+    assert(uploaded);
+    vertices.release();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.releaseVertexVectors();
+    }
+}
+
+bool CircleBucket::releaseBuffers() {
+    if (vertexBuffer && vertices.empty()) {
+        return false;
+    }
+
+    // upload() builds the segments again.
+    vertexBuffer = {};
+    indexBuffer = {};
+    segments.clear();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.releaseVertexBuffers();
+    }
+
+    paintChanged = false;
+    uploaded = false;
+    return true;
+}
+
 void CircleBucket::render(Painter& painter,
                         PaintParameters& parameters,
                         const Layer& layer,
@@ -41,13 +162,21 @@ void CircleBucket::render(Painter& painter,
 }
 
 bool CircleBucket::hasData() const {
-    return !segments.empty();
+    return circleCount > 0;
 }
 
-void CircleBucket::addFeature(const GeometryTileFeature& feature,
-                              const GeometryCollection& geometry) {
-    constexpr const uint16_t vertexLength = 4;
+std::size_t CircleBucket::getByteSize() const {
+    return vertices.byteSize() + getBufferByteSize();
+}
 
+std::size_t CircleBucket::getBufferByteSize() const {
+    return (vertexBuffer ? vertexBuffer->byteSize() : 0) +
+        (indexBuffer ? indexBuffer->byteSize() : 0);
+}
+
+void CircleBucket::addFeature(const GeometryTileFeature& feature,
+                              const GeometryCollection& geometry,
+                              std::size_t featureIndex) {
     for (auto& circle : geometry) {
         for(auto& point : circle) {
             auto x = point.x;
@@ -59,42 +188,16 @@ void CircleBucket::addFeature(const GeometryTileFeature& feature,
             if ((mode != MapMode::Still) &&
                 (x < 0 || x >= util::EXTENT || y < 0 || y >= util::EXTENT)) continue;
 
-            if (segments.empty() || segments.back().vertexLength + vertexLength > std::numeric_limits<uint16_t>::max()) {
-                // Move to a new segments because the old one can't hold the geometry.
-                segments.emplace_back(vertices.vertexSize(), triangles.indexSize());
-            }
-
-            // this geometry will be of the Point type, and we'll derive
-            // two triangles from it.
-            //
-            // ┌─────────┐
-            // │ 4     3 │
-            // │         │
-            // │ 1     2 │
-            // └─────────┘
-            //
-            vertices.emplace_back(CircleProgram::vertex(point, -1, -1)); // 1
-            vertices.emplace_back(CircleProgram::vertex(point,  1, -1)); // 2
-            vertices.emplace_back(CircleProgram::vertex(point,  1,  1)); // 3
-            vertices.emplace_back(CircleProgram::vertex(point, -1,  1)); // 4
-
-            auto& segment = segments.back();
-            assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
-            uint16_t index = segment.vertexLength;
-
-            // 1, 2, 3
-            // 1, 4, 3
-            triangles.emplace_back(index, index + 1, index + 2);
-            triangles.emplace_back(index, index + 3, index + 2);
-
-            segment.vertexLength += vertexLength;
-            segment.indexLength += 6;
+            // The vertex of the lower left corner, which the other corners are offset from.
+            vertices.emplace_back(CircleProgram::vertex(point, -1, -1));
+            circleCount++;
         }
     }
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.populateVertexVectors(feature, vertices.vertexSize());
     }
+    addFeatureVertices(featureIndex, vertices.vertexSize());
 }
 
 } // namespace mbgl
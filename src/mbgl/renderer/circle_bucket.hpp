@@ -20,22 +20,47 @@ public:
     CircleBucket(const style::BucketParameters&, const std::vector<const style::Layer*>&);
 
     void addFeature(const GeometryTileFeature&,
-                    const GeometryCollection&) override;
+                    const GeometryCollection&,
+                    std::size_t index) override;
+    std::vector<std::string> paintPropertyKeys() const override {
+        return Bucket::paintPropertyKeys(paintPropertyBinders);
+    }
+    bool isZoomConstant() const override {
+        return Bucket::isZoomConstant(paintPropertyBinders);
+    }
     bool hasData() const override;
+    std::size_t getByteSize() const override;
+    std::size_t getBufferByteSize() const override;
+    std::unique_ptr<Bucket> clone() const override;
+    std::function<void ()> repaint(const style::BucketParameters&,
+                                   const std::vector<const style::Layer*>&,
+                                   const GeometryTileLayer&,
+                                   const FeatureStateMap*) override;
 
     void upload(gl::Context&) override;
+    void shrinkToFit() override;
+    void releaseData() override;
+    bool releaseBuffers() override;
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
 
+    // A vertex per circle. Contexts that support instancing draw the painter's quad once for
+    // each; for the others, upload() repeats the vertex at the corners of a quad per circle.
     gl::VertexVector<CircleLayoutVertex> vertices;
-    gl::IndexVector<gl::Triangles> triangles;
     gl::SegmentVector<CircleAttributes> segments;
 
     optional<gl::VertexBuffer<CircleLayoutVertex>> vertexBuffer;
+    // Only for circles that aren't drawn as instances.
     optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+    bool instanced = false;
 
     std::map<std::string, CircleProgram::PaintPropertyBinders> paintPropertyBinders;
 
     const MapMode mode;
+
+private:
+    CircleBucket(const CircleBucket&);
+
+    std::size_t circleCount = 0;
 };
 
 } // namespace mbgl
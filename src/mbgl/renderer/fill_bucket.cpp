@@ -4,43 +4,87 @@
 #include <mbgl/style/bucket_parameters.hpp>
 #include <mbgl/style/layers/fill_layer.hpp>
 #include <mbgl/style/layers/fill_layer_impl.hpp>
-
-#include <mapbox/earcut.hpp>
+#include <mbgl/renderer/tessellation_cache.hpp>
 
 #include <cassert>
 
-namespace mapbox {
-namespace util {
-template <> struct nth<0, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.x; };
-};
-
-template <> struct nth<1, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.y; };
-};
-} // namespace util
-} // namespace mapbox
-
 namespace mbgl {
 
 using namespace style;
 
 struct GeometryTooLongException : std::exception {};
 
-FillBucket::FillBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers) {
+static std::map<std::string, FillProgram::PaintPropertyBinders>
+createPaintPropertyBinders(const BucketParameters& parameters, const std::vector<const Layer*>& layers) {
+    std::map<std::string, FillProgram::PaintPropertyBinders> binders;
     for (const auto& layer : layers) {
-        paintPropertyBinders.emplace(
+        binders.emplace(
             std::piecewise_construct,
             std::forward_as_tuple(layer->getID()),
             std::forward_as_tuple(
                 layer->as<FillLayer>()->impl->paint.evaluated,
                 parameters.tileID.overscaledZ));
     }
+    return binders;
+}
+
+// Outlines are drawn where they have a color of their own, and to antialias the edges of fills
+// that multisampling doesn't.
+static bool needsOutlines(const BucketParameters& parameters, const std::vector<const Layer*>& layers) {
+    if (!parameters.multisampling) {
+        return true;
+    }
+    for (const auto& layer : layers) {
+        if (!layer->as<FillLayer>()->impl->paint.unevaluated.get<FillOutlineColor>().isUndefined()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+FillBucket::FillBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers)
+    : outlines(needsOutlines(parameters, layers)),
+      pickable(parameters.featurePicking),
+      paintPropertyBinders(createPaintPropertyBinders(parameters, layers)),
+      obsolete(parameters.obsolete) {
+}
+
+FillBucket::FillBucket(const FillBucket& other)
+    : vertices(other.vertices),
+      lines(other.lines),
+      triangles(other.triangles),
+      lineSegments(other.lineSegments),
+      triangleSegments(other.triangleSegments),
+      outlines(other.outlines),
+      pickable(other.pickable),
+      pickVertices(other.pickVertices),
+      paintPropertyBinders(other.paintPropertyBinders) {
+    featureVertices = other.featureVertices;
+}
+
+std::unique_ptr<Bucket> FillBucket::clone() const {
+    assert(!uploaded);
+    return std::unique_ptr<Bucket>(new FillBucket(*this));
 }
 
 void FillBucket::addFeature(const GeometryTileFeature& feature,
-                            const GeometryCollection& geometry) {
-    for (auto& polygon : classifyRings(geometry)) {
+                            const GeometryCollection& geometry,
+                            std::size_t index) {
+    // Features whose index doesn't fit into the picking buffer make the bucket unpickable, so
+    // that picking falls back to querying the feature index.
+    if (pickable && index > FillPickProgram::maxFeatureIndex) {
+        pickable = false;
+        pickVertices.release();
+    }
+    const std::size_t polygonCount = classifyRings(geometry, polygons);
+    for (std::size_t p = 0; p < polygonCount; p++) {
+        // The bucket of a tile that is gone is dropped half-built.
+        if (obsolete && *obsolete) {
+            return;
+        }
+
+        GeometryCollection& polygon = polygons[p];
+
         // Optimize polygons with many interior rings for earcut tesselation.
         limitHoles(polygon, 500);
 
@@ -60,6 +104,13 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
             if (nVertices == 0)
                 continue;
 
+            if (!outlines) {
+                for (const auto& point : ring) {
+                    vertices.emplace_back(FillProgram::layoutVertex(point));
+                }
+                continue;
+            }
+
             if (lineSegments.empty() || lineSegments.back().vertexLength + nVertices > std::numeric_limits<uint16_t>::max()) {
                 lineSegments.emplace_back(vertices.vertexSize(), lines.indexSize());
             }
@@ -80,7 +131,7 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
             lineSegment.indexLength += nVertices * 2;
         }
 
-        std::vector<uint32_t> indices = mapbox::earcut(polygon);
+        std::vector<uint32_t> indices = TessellationCache::get().tessellate(polygon);
 
         std::size_t nIndicies = indices.size();
         assert(nIndicies % 3 == 0);
@@ -103,23 +154,119 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
         triangleSegment.indexLength += nIndicies;
     }
 
+    if (pickable) {
+        const FillPickVertex pickVertex = FillPickProgram::pickVertex(index);
+        while (pickVertices.vertexSize() < vertices.vertexSize()) {
+            pickVertices.emplace_back(pickVertex);
+        }
+    }
+
     for (auto& pair : paintPropertyBinders) {
         pair.second.populateVertexVectors(feature, vertices.vertexSize());
     }
+    addFeatureVertices(index, vertices.vertexSize());
+}
+
+std::function<void ()> FillBucket::repaint(const BucketParameters& parameters,
+                                           const std::vector<const Layer*>& layers,
+                                           const GeometryTileLayer& sourceLayer,
+                                           const FeatureStateMap* states) {
+    // Outlines that were left out are only added by laying the bucket out again.
+    if (!outlines && needsOutlines(parameters, layers)) {
+        return {};
+    }
+
+    auto binders = std::make_shared<std::map<std::string, FillProgram::PaintPropertyBinders>>(
+        createPaintPropertyBinders(parameters, layers));
+    populatePaintPropertyBinders(*binders, sourceLayer, states);
+    for (auto& pair : *binders) {
+        pair.second.shrinkToFit();
+    }
+    return [this, binders] {
+        setPaintPropertyBinders(paintPropertyBinders, std::move(*binders));
+    };
 }
 
 void FillBucket::upload(gl::Context& context) {
-    vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    lineIndexBuffer = context.createIndexBuffer(std::move(lines));
-    triangleIndexBuffer = context.createIndexBuffer(std::move(triangles));
+    if (!paintChanged) {
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        if (outlines) {
+            lineIndexBuffer = gl::createIndexBuffer(context, std::move(lines), lineSegments);
+        }
+        triangleIndexBuffer = gl::createIndexBuffer(context, std::move(triangles), triangleSegments);
+
+        if (pickable) {
+            pickVertexBuffer = context.createVertexBuffer(std::move(pickVertices));
+            for (const auto& segment : triangleSegments) {
+                pickSegments.emplace_back(segment.vertexOffset, segment.indexOffset,
+                                          segment.vertexLength, segment.indexLength);
+            }
+        }
+    }
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(context);
     }
 
+    paintChanged = false;
     uploaded = true;
 }
 
+void FillBucket::splitSegments() {
+    const auto position = [&] (std::size_t i) {
+        const auto& pos = vertices.data()[i].a1;
+        return Point<int16_t>(pos[0], pos[1]);
+    };
+    gl::splitSegments(lines, lineSegments, position, maxSegmentSize, minSegmentPrimitives);
+    gl::splitSegments(triangles, triangleSegments, position, maxSegmentSize, minSegmentPrimitives);
+}
+
+void FillBucket::shrinkToFit() {
+    std::vector<GeometryCollection>().swap(polygons);
+    vertices.shrinkToFit();
+    lines.shrinkToFit();
+    triangles.shrinkToFit();
+    pickVertices.shrinkToFit();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.shrinkToFit();
+    }
+}
+
+void FillBucket::releaseData() {
+    assert(uploaded);
+    vertices.release();
+    lines.release();
+    triangles.release();
+    pickVertices.release();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.releaseVertexVectors();
+    }
+}
+
+bool FillBucket::releaseBuffers() {
+    // Where the context supports 32-bit indices, upload() may merge the segments and release
+    // the 16-bit indices.
+    if (vertexBuffer && (vertices.empty() || triangles.empty() || (outlines && lines.empty()))) {
+        return false;
+    }
+
+    vertexBuffer = {};
+    lineIndexBuffer = {};
+    triangleIndexBuffer = {};
+    pickVertexBuffer = {};
+    pickSegments.clear();
+    // Copies leave behind the vertex array objects, which refer to the released buffers.
+    lineSegments = gl::SegmentVector<FillAttributes>(lineSegments);
+    triangleSegments = gl::SegmentVector<FillAttributes>(triangleSegments);
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.releaseVertexBuffers();
+    }
+
+    paintChanged = false;
+    uploaded = false;
+    return true;
+}
+
 void FillBucket::render(Painter& painter,
                         PaintParameters& parameters,
                         const Layer& layer,
@@ -131,4 +278,16 @@ bool FillBucket::hasData() const {
     return !triangleSegments.empty() || !lineSegments.empty();
 }
 
+std::size_t FillBucket::getByteSize() const {
+    return vertices.byteSize() + lines.byteSize() + triangles.byteSize() + pickVertices.byteSize() +
+        getBufferByteSize();
+}
+
+std::size_t FillBucket::getBufferByteSize() const {
+    return (vertexBuffer ? vertexBuffer->byteSize() : 0) +
+        (lineIndexBuffer ? lineIndexBuffer->byteSize() : 0) +
+        (triangleIndexBuffer ? triangleIndexBuffer->byteSize() : 0) +
+        (pickVertexBuffer ? pickVertexBuffer->byteSize() : 0);
+}
+
 } // namespace mbgl
@@ -6,8 +6,10 @@
 #include <mbgl/gl/index_buffer.hpp>
 #include <mbgl/gl/segment.hpp>
 #include <mbgl/programs/fill_program.hpp>
+#include <mbgl/programs/fill_pick_program.hpp>
 #include <mbgl/style/layers/fill_layer_properties.hpp>
 
+#include <atomic>
 #include <vector>
 
 namespace mbgl {
@@ -21,10 +23,28 @@ public:
     FillBucket(const style::BucketParameters&, const std::vector<const style::Layer*>&);
 
     void addFeature(const GeometryTileFeature&,
-                    const GeometryCollection&) override;
+                    const GeometryCollection&,
+                    std::size_t index) override;
+    std::vector<std::string> paintPropertyKeys() const override {
+        return Bucket::paintPropertyKeys(paintPropertyBinders);
+    }
+    bool isZoomConstant() const override {
+        return Bucket::isZoomConstant(paintPropertyBinders);
+    }
     bool hasData() const override;
+    std::size_t getByteSize() const override;
+    std::size_t getBufferByteSize() const override;
+    std::unique_ptr<Bucket> clone() const override;
+    std::function<void ()> repaint(const style::BucketParameters&,
+                                   const std::vector<const style::Layer*>&,
+                                   const GeometryTileLayer&,
+                                   const FeatureStateMap*) override;
 
     void upload(gl::Context&) override;
+    void splitSegments() override;
+    void shrinkToFit() override;
+    void releaseData() override;
+    bool releaseBuffers() override;
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
 
     gl::VertexVector<FillLayoutVertex> vertices;
@@ -33,11 +53,31 @@ public:
     gl::SegmentVector<FillAttributes> lineSegments;
     gl::SegmentVector<FillAttributes> triangleSegments;
 
+    // Whether the bucket has outlines, which it leaves out if they would only antialias the edges
+    // of fills in a multisampled view. Without them, it has no line index buffer.
+    bool outlines;
+
     optional<gl::VertexBuffer<FillLayoutVertex>> vertexBuffer;
     optional<gl::IndexBuffer<gl::Lines>> lineIndexBuffer;
     optional<gl::IndexBuffer<gl::Triangles>> triangleIndexBuffer;
 
+    // The feature of each vertex, which is only recorded while feature picking is enabled, and
+    // as long as all feature indices can be picked.
+    bool pickable;
+    gl::VertexVector<FillPickVertex> pickVertices;
+    optional<gl::VertexBuffer<FillPickVertex>> pickVertexBuffer;
+    gl::SegmentVector<FillPickProgram::Attributes> pickSegments;
+
     std::map<std::string, FillProgram::PaintPropertyBinders> paintPropertyBinders;
+
+private:
+    FillBucket(const FillBucket&);
+
+    // The polygons of the feature that is being added, which keep their memory for the next one.
+    std::vector<GeometryCollection> polygons;
+
+    // Not copied, since copies are made once all features are added.
+    const std::atomic<bool>* obsolete = nullptr;
 };
 
 } // namespace mbgl
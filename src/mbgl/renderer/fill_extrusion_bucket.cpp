@@ -0,0 +1,216 @@
+#include <mbgl/renderer/fill_extrusion_bucket.hpp>
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/programs/fill_extrusion_program.hpp>
+#include <mbgl/style/bucket_parameters.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer_impl.hpp>
+#include <mbgl/renderer/tessellation_cache.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/math.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+using namespace style;
+
+static std::map<std::string, FillExtrusionProgram::PaintPropertyBinders>
+createPaintPropertyBinders(const BucketParameters& parameters, const std::vector<const Layer*>& layers) {
+    std::map<std::string, FillExtrusionProgram::PaintPropertyBinders> binders;
+    for (const auto& layer : layers) {
+        binders.emplace(
+            std::piecewise_construct,
+            std::forward_as_tuple(layer->getID()),
+            std::forward_as_tuple(
+                layer->as<FillExtrusionLayer>()->impl->paint.evaluated,
+                parameters.tileID.overscaledZ));
+    }
+    return binders;
+}
+
+// Walls along the edge of the tile's buffer are hidden by the neighbouring tile's buildings.
+static bool isBoundaryEdge(const GeometryCoordinate& p1, const GeometryCoordinate& p2) {
+    return (p1.x == p2.x && (p1.x < 0 || p1.x > util::EXTENT)) ||
+           (p1.y == p2.y && (p1.y < 0 || p1.y > util::EXTENT));
+}
+
+FillExtrusionBucket::FillExtrusionBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers)
+    : paintPropertyBinders(createPaintPropertyBinders(parameters, layers)) {
+}
+
+FillExtrusionBucket::FillExtrusionBucket(const FillExtrusionBucket& other)
+    : vertices(other.vertices),
+      triangles(other.triangles),
+      triangleSegments(other.triangleSegments),
+      paintPropertyBinders(other.paintPropertyBinders) {
+    featureVertices = other.featureVertices;
+}
+
+std::unique_ptr<Bucket> FillExtrusionBucket::clone() const {
+    assert(!uploaded);
+    return std::unique_ptr<Bucket>(new FillExtrusionBucket(*this));
+}
+
+void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
+                                     const GeometryCollection& geometry,
+                                     std::size_t index) {
+    const std::size_t polygonCount = classifyRings(geometry, polygons);
+    for (std::size_t p = 0; p < polygonCount; p++) {
+        GeometryCollection& polygon = polygons[p];
+
+        // Optimize polygons with many interior rings for earcut tesselation.
+        limitHoles(polygon, 500);
+
+        // Each point of a ring is a vertex of the roof, and of the walls on either side of it.
+        std::size_t totalVertices = 0;
+        for (const auto& ring : polygon) {
+            totalVertices += ring.size() * 5;
+        }
+
+        // Polygons whose vertices don't fit into a segment are skipped.
+        if (totalVertices > std::numeric_limits<uint16_t>::max()) {
+            continue;
+        }
+
+        if (triangleSegments.empty() || triangleSegments.back().vertexLength + totalVertices > std::numeric_limits<uint16_t>::max()) {
+            triangleSegments.emplace_back(vertices.vertexSize(), triangles.indexSize());
+        }
+
+        auto& segment = triangleSegments.back();
+        assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
+        const uint16_t roofIndex = segment.vertexLength;
+
+        // The roof.
+        std::size_t roofVertices = 0;
+        for (const auto& ring : polygon) {
+            for (const auto& point : ring) {
+                vertices.emplace_back(FillExtrusionProgram::layoutVertex(point, 0, 0, 1, true, 0));
+            }
+            roofVertices += ring.size();
+        }
+
+        std::vector<uint32_t> indices = TessellationCache::get().tessellate(polygon);
+        assert(indices.size() % 3 == 0);
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            triangles.emplace_back(roofIndex + indices[i],
+                                   roofIndex + indices[i + 1],
+                                   roofIndex + indices[i + 2]);
+        }
+        segment.vertexLength += roofVertices;
+        segment.indexLength += indices.size();
+
+        // The walls.
+        for (const auto& ring : polygon) {
+            const std::size_t nVertices = ring.size();
+            if (nVertices < 2) {
+                continue;
+            }
+
+            uint32_t edgeDistance = 0;
+            for (std::size_t i = 0; i < nVertices; i++) {
+                // Rings may or may not repeat their first point at the end; the closing edge of
+                // a ring that does is empty and skipped.
+                const GeometryCoordinate& p1 = ring[i];
+                const GeometryCoordinate& p2 = ring[(i + 1) % nVertices];
+                if (p1 == p2 || isBoundaryEdge(p1, p2)) {
+                    continue;
+                }
+
+                const Point<double> perp = util::unit(util::perp(convertPoint<double>(p2 - p1)));
+                const uint16_t wallIndex = segment.vertexLength;
+
+                vertices.emplace_back(FillExtrusionProgram::layoutVertex(p1, perp.x, perp.y, 0, false, edgeDistance));
+                vertices.emplace_back(FillExtrusionProgram::layoutVertex(p1, perp.x, perp.y, 0, true, edgeDistance));
+
+                edgeDistance += util::dist<uint32_t>(p1, p2);
+                // The distance wraps around before it overflows the attribute.
+                if (edgeDistance > std::numeric_limits<int16_t>::max()) {
+                    edgeDistance = 0;
+                }
+
+                vertices.emplace_back(FillExtrusionProgram::layoutVertex(p2, perp.x, perp.y, 0, false, edgeDistance));
+                vertices.emplace_back(FillExtrusionProgram::layoutVertex(p2, perp.x, perp.y, 0, true, edgeDistance));
+
+                triangles.emplace_back(wallIndex, wallIndex + 1, wallIndex + 2);
+                triangles.emplace_back(wallIndex + 1, wallIndex + 2, wallIndex + 3);
+
+                segment.vertexLength += 4;
+                segment.indexLength += 6;
+            }
+        }
+    }
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+    }
+    addFeatureVertices(index, vertices.vertexSize());
+}
+
+std::function<void ()> FillExtrusionBucket::repaint(const BucketParameters& parameters,
+                                                    const std::vector<const Layer*>& layers,
+                                                    const GeometryTileLayer& sourceLayer,
+                                                    const FeatureStateMap* states) {
+    auto binders = std::make_shared<std::map<std::string, FillExtrusionProgram::PaintPropertyBinders>>(
+        createPaintPropertyBinders(parameters, layers));
+    populatePaintPropertyBinders(*binders, sourceLayer, states);
+    for (auto& pair : *binders) {
+        pair.second.shrinkToFit();
+    }
+    return [this, binders] {
+        setPaintPropertyBinders(paintPropertyBinders, std::move(*binders));
+    };
+}
+
+void FillExtrusionBucket::upload(gl::Context& context) {
+    if (!paintChanged) {
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        indexBuffer = gl::createIndexBuffer(context, std::move(triangles), triangleSegments);
+    }
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.upload(context);
+    }
+
+    paintChanged = false;
+    uploaded = true;
+}
+
+void FillExtrusionBucket::shrinkToFit() {
+    std::vector<GeometryCollection>().swap(polygons);
+    vertices.shrinkToFit();
+    triangles.shrinkToFit();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.shrinkToFit();
+    }
+}
+
+void FillExtrusionBucket::releaseData() {
+    assert(uploaded);
+    vertices.release();
+    triangles.release();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.releaseVertexVectors();
+    }
+}
+
+void FillExtrusionBucket::render(Painter& painter,
+                                 PaintParameters& parameters,
+                                 const Layer& layer,
+                                 const RenderTile& tile) {
+    painter.renderFillExtrusion(parameters, *this, *layer.as<FillExtrusionLayer>(), tile);
+}
+
+bool FillExtrusionBucket::hasData() const {
+    return !triangleSegments.empty();
+}
+
+std::size_t FillExtrusionBucket::getByteSize() const {
+    return vertices.byteSize() + triangles.byteSize() + getBufferByteSize();
+}
+
+std::size_t FillExtrusionBucket::getBufferByteSize() const {
+    return (vertexBuffer ? vertexBuffer->byteSize() : 0) +
+        (indexBuffer ? indexBuffer->byteSize() : 0);
+}
+
+} // namespace mbgl
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/gl/vertex_buffer.hpp>
+#include <mbgl/gl/index_buffer.hpp>
+#include <mbgl/gl/segment.hpp>
+#include <mbgl/programs/fill_extrusion_program.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer_properties.hpp>
+
+#include <vector>
+
+namespace mbgl {
+
+namespace style {
+class BucketParameters;
+} // namespace style
+
+class FillExtrusionBucket : public Bucket {
+public:
+    FillExtrusionBucket(const style::BucketParameters&, const std::vector<const style::Layer*>&);
+
+    void addFeature(const GeometryTileFeature&,
+                    const GeometryCollection&,
+                    std::size_t index) override;
+    std::vector<std::string> paintPropertyKeys() const override {
+        return Bucket::paintPropertyKeys(paintPropertyBinders);
+    }
+    bool isZoomConstant() const override {
+        return Bucket::isZoomConstant(paintPropertyBinders);
+    }
+    bool hasData() const override;
+    std::size_t getByteSize() const override;
+    std::size_t getBufferByteSize() const override;
+    std::unique_ptr<Bucket> clone() const override;
+    std::function<void ()> repaint(const style::BucketParameters&,
+                                   const std::vector<const style::Layer*>&,
+                                   const GeometryTileLayer&,
+                                   const FeatureStateMap*) override;
+
+    void upload(gl::Context&) override;
+    void shrinkToFit() override;
+    void releaseData() override;
+    void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
+
+    // The roof of each polygon shares the vertices of its rings, and each wall is a quad of its
+    // own, so that it is lit by its own normal. All of the vertices of a polygon are in the same
+    // segment, and polygons only start a new segment once the current one is full.
+    gl::VertexVector<FillExtrusionLayoutVertex> vertices;
+    gl::IndexVector<gl::Triangles> triangles;
+    gl::SegmentVector<FillExtrusionAttributes> triangleSegments;
+
+    optional<gl::VertexBuffer<FillExtrusionLayoutVertex>> vertexBuffer;
+    optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+
+    std::map<std::string, FillExtrusionProgram::PaintPropertyBinders> paintPropertyBinders;
+
+private:
+    FillExtrusionBucket(const FillExtrusionBucket&);
+
+    // The polygons of the feature that is being added, which keep their memory for the next one.
+    std::vector<GeometryCollection> polygons;
+};
+
+} // namespace mbgl
@@ -20,6 +20,10 @@ public:
     void record(const TimePoint&, float zoom, const Duration&);
 
     bool needsAnimation(const Duration&) const;
+    // Whether the opacities changed since they were last uploaded.
+    bool isDirty() const {
+        return dirty;
+    }
     void bind(gl::Context&, uint32_t);
     void upload(gl::Context&, uint32_t);
 
@@ -0,0 +1,169 @@
+#include <mbgl/renderer/heatmap_bucket.hpp>
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/programs/heatmap_program.hpp>
+#include <mbgl/style/bucket_parameters.hpp>
+#include <mbgl/style/layers/heatmap_layer.hpp>
+#include <mbgl/style/layers/heatmap_layer_impl.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+using namespace style;
+
+static std::map<std::string, HeatmapProgram::PaintPropertyBinders>
+createPaintPropertyBinders(const BucketParameters& parameters, const std::vector<const Layer*>& layers) {
+    std::map<std::string, HeatmapProgram::PaintPropertyBinders> binders;
+    for (const auto& layer : layers) {
+        binders.emplace(
+            std::piecewise_construct,
+            std::forward_as_tuple(layer->getID()),
+            std::forward_as_tuple(
+                layer->as<HeatmapLayer>()->impl->paint.evaluated,
+                parameters.tileID.overscaledZ));
+    }
+    return binders;
+}
+
+HeatmapBucket::HeatmapBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers)
+    : paintPropertyBinders(createPaintPropertyBinders(parameters, layers)),
+      mode(parameters.mode) {
+}
+
+HeatmapBucket::HeatmapBucket(const HeatmapBucket& other)
+    : vertices(other.vertices),
+      triangles(other.triangles),
+      segments(other.segments),
+      paintPropertyBinders(other.paintPropertyBinders),
+      mode(other.mode) {
+    featureVertices = other.featureVertices;
+}
+
+std::unique_ptr<Bucket> HeatmapBucket::clone() const {
+    assert(!uploaded);
+    return std::unique_ptr<Bucket>(new HeatmapBucket(*this));
+}
+
+std::function<void ()> HeatmapBucket::repaint(const BucketParameters& parameters,
+                                              const std::vector<const Layer*>& layers,
+                                              const GeometryTileLayer& sourceLayer,
+                                              const FeatureStateMap* states) {
+    auto binders = std::make_shared<std::map<std::string, HeatmapProgram::PaintPropertyBinders>>(
+        createPaintPropertyBinders(parameters, layers));
+    populatePaintPropertyBinders(*binders, sourceLayer, states);
+    for (auto& pair : *binders) {
+        pair.second.shrinkToFit();
+    }
+    return [this, binders] {
+        setPaintPropertyBinders(paintPropertyBinders, std::move(*binders));
+    };
+}
+
+void HeatmapBucket::upload(gl::Context& context) {
+    if (!paintChanged) {
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        indexBuffer = gl::createIndexBuffer(context, std::move(triangles), segments);
+    }
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.upload(context);
+    }
+
+    paintChanged = false;
+    uploaded = true;
+}
+
+void HeatmapBucket::shrinkToFit() {
+    vertices.shrinkToFit();
+    triangles.shrinkToFit();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.shrinkToFit();
+    }
+}
+
+void HeatmapBucket::releaseData() {
+    assert(uploaded);
+    vertices.release();
+    triangles.release();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.releaseVertexVectors();
+    }
+}
+
+void HeatmapBucket::render(Painter& painter,
+                           PaintParameters& parameters,
+                           const Layer& layer,
+                           const RenderTile& tile) {
+    painter.renderHeatmap(parameters, *this, *layer.as<HeatmapLayer>(), tile);
+}
+
+bool HeatmapBucket::hasData() const {
+    return !segments.empty();
+}
+
+std::size_t HeatmapBucket::getByteSize() const {
+    return vertices.byteSize() + triangles.byteSize() + getBufferByteSize();
+}
+
+std::size_t HeatmapBucket::getBufferByteSize() const {
+    return (vertexBuffer ? vertexBuffer->byteSize() : 0) +
+        (indexBuffer ? indexBuffer->byteSize() : 0);
+}
+
+void HeatmapBucket::addFeature(const GeometryTileFeature& feature,
+                               const GeometryCollection& geometry,
+                               std::size_t featureIndex) {
+    constexpr const uint16_t vertexLength = 4;
+
+    for (auto& points : geometry) {
+        for (auto& point : points) {
+            auto x = point.x;
+            auto y = point.y;
+
+            // Do not include points that are outside the tile boundaries.
+            // Include all points in Still mode. You need to include points from
+            // neighbouring tiles so that they are not clipped at tile boundaries.
+            if ((mode != MapMode::Still) &&
+                (x < 0 || x >= util::EXTENT || y < 0 || y >= util::EXTENT)) continue;
+
+            if (segments.empty() || segments.back().vertexLength + vertexLength > std::numeric_limits<uint16_t>::max()) {
+                // Move to a new segments because the old one can't hold the geometry.
+                segments.emplace_back(vertices.vertexSize(), triangles.indexSize());
+            }
+
+            // this geometry will be of the Point type, and we'll derive
+            // two triangles from it.
+            //
+            // ┌─────────┐
+            // │ 4     3 │
+            // │         │
+            // │ 1     2 │
+            // └─────────┘
+            //
+            vertices.emplace_back(HeatmapProgram::vertex(point, -1, -1)); // 1
+            vertices.emplace_back(HeatmapProgram::vertex(point,  1, -1)); // 2
+            vertices.emplace_back(HeatmapProgram::vertex(point,  1,  1)); // 3
+            vertices.emplace_back(HeatmapProgram::vertex(point, -1,  1)); // 4
+
+            auto& segment = segments.back();
+            assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
+            uint16_t index = segment.vertexLength;
+
+            // 1, 2, 3
+            // 1, 4, 3
+            triangles.emplace_back(index, index + 1, index + 2);
+            triangles.emplace_back(index, index + 3, index + 2);
+
+            segment.vertexLength += vertexLength;
+            segment.indexLength += 6;
+        }
+    }
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(feature, vertices.vertexSize());
+    }
+    addFeatureVertices(featureIndex, vertices.vertexSize());
+}
+
+} // namespace mbgl
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/map/mode.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/gl/vertex_buffer.hpp>
+#include <mbgl/gl/index_buffer.hpp>
+#include <mbgl/gl/segment.hpp>
+#include <mbgl/programs/heatmap_program.hpp>
+#include <mbgl/style/layers/heatmap_layer_properties.hpp>
+
+namespace mbgl {
+
+namespace style {
+class BucketParameters;
+} // namespace style
+
+class HeatmapBucket : public Bucket {
+public:
+    HeatmapBucket(const style::BucketParameters&, const std::vector<const style::Layer*>&);
+
+    void addFeature(const GeometryTileFeature&,
+                    const GeometryCollection&,
+                    std::size_t index) override;
+    std::vector<std::string> paintPropertyKeys() const override {
+        return Bucket::paintPropertyKeys(paintPropertyBinders);
+    }
+    bool isZoomConstant() const override {
+        return Bucket::isZoomConstant(paintPropertyBinders);
+    }
+    bool hasData() const override;
+    std::size_t getByteSize() const override;
+    std::size_t getBufferByteSize() const override;
+    std::unique_ptr<Bucket> clone() const override;
+    std::function<void ()> repaint(const style::BucketParameters&,
+                                   const std::vector<const style::Layer*>&,
+                                   const GeometryTileLayer&,
+                                   const FeatureStateMap*) override;
+
+    void upload(gl::Context&) override;
+    void shrinkToFit() override;
+    void releaseData() override;
+    void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
+
+    gl::VertexVector<HeatmapLayoutVertex> vertices;
+    gl::IndexVector<gl::Triangles> triangles;
+    gl::SegmentVector<HeatmapAttributes> segments;
+
+    optional<gl::VertexBuffer<HeatmapLayoutVertex>> vertexBuffer;
+    optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
+
+    std::map<std::string, HeatmapProgram::PaintPropertyBinders> paintPropertyBinders;
+
+    const MapMode mode;
+
+private:
+    HeatmapBucket(const HeatmapBucket&);
+};
+
+} // namespace mbgl
@@ -0,0 +1,55 @@
+#include <mbgl/renderer/hillshade_bucket.hpp>
+#include <mbgl/style/layers/hillshade_layer.hpp>
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/gl/context.hpp>
+
+namespace mbgl {
+
+using namespace style;
+
+HillshadeBucket::HillshadeBucket(DEMData&& dem_) : dem(std::move(dem_)) {
+}
+
+HillshadeBucket::~HillshadeBucket() = default;
+
+void HillshadeBucket::upload(gl::Context& context) {
+    if (!demTexture) {
+        demTexture = context.createTexture(dem.image);
+    } else {
+        context.updateTexture(*demTexture, dem.image);
+    }
+    prepared = false;
+    uploaded = true;
+}
+
+void HillshadeBucket::render(Painter& painter,
+                             PaintParameters& parameters,
+                             const Layer& layer,
+                             const RenderTile& tile) {
+    painter.renderHillshade(parameters, *this, *layer.as<HillshadeLayer>(), tile);
+}
+
+void HillshadeBucket::backfillBorder(const HillshadeBucket& other, int8_t dx, int8_t dy) {
+    // Tiles of different sizes don't line up pixel by pixel, so their borders keep repeating
+    // their own edges.
+    if (dem.dim != other.dem.dim) {
+        return;
+    }
+    dem.backfillBorder(other.dem, dx, dy);
+    uploaded = false;
+}
+
+bool HillshadeBucket::hasData() const {
+    return true;
+}
+
+std::size_t HillshadeBucket::getByteSize() const {
+    return dem.image.bytes() + getBufferByteSize();
+}
+
+std::size_t HillshadeBucket::getBufferByteSize() const {
+    return (demTexture ? dem.image.bytes() : 0) +
+           (texture ? std::size_t(dem.dim) * dem.dim * 4 : 0);
+}
+
+} // namespace mbgl
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/geometry/dem_data.hpp>
+#include <mbgl/util/offscreen_texture.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/gl/texture.hpp>
+
+#include <memory>
+
+namespace mbgl {
+
+// The elevations of a raster-dem tile. They are uploaded as they are, and the painter then
+// computes the slopes of the tile from them into a texture of its own once, in the prepare
+// pass, which the tile is shaded from every frame.
+class HillshadeBucket : public Bucket {
+public:
+    HillshadeBucket(DEMData&&);
+    ~HillshadeBucket() override;
+
+    void upload(gl::Context&) override;
+    void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
+    bool hasData() const override;
+    std::size_t getByteSize() const override;
+    std::size_t getBufferByteSize() const override;
+
+    // Copies the edge of a neighbouring tile into the border of the elevations. They're uploaded
+    // again, and the slopes prepared again, before the tile is drawn next.
+    void backfillBorder(const HillshadeBucket& other, int8_t dx, int8_t dy);
+
+    // Whether the slopes in the texture are computed from the elevations that were uploaded most
+    // recently.
+    bool isPrepared() const {
+        return prepared;
+    }
+    void setPrepared(bool prepared_) {
+        prepared = prepared_;
+    }
+
+    // The elevations are kept after they were uploaded, as the borders may still change.
+    DEMData dem;
+    optional<gl::Texture> demTexture;
+    // The slopes of the tile, which the prepare pass draws into.
+    std::unique_ptr<OffscreenTexture> texture;
+
+private:
+    bool prepared = false;
+};
+
+} // namespace mbgl
@@ -12,30 +12,77 @@ namespace mbgl {
 
 using namespace style;
 
-LineBucket::LineBucket(const BucketParameters& parameters,
-                       const std::vector<const Layer*>& layers,
-                       const style::LineLayoutProperties& layout_)
-    : layout(layout_.evaluate(PropertyEvaluationParameters(parameters.tileID.overscaledZ))),
-      overscaling(parameters.tileID.overscaleFactor()) {
+static std::map<std::string, LineProgram::PaintPropertyBinders>
+createPaintPropertyBinders(const BucketParameters& parameters, const std::vector<const Layer*>& layers) {
+    std::map<std::string, LineProgram::PaintPropertyBinders> binders;
     for (const auto& layer : layers) {
-        paintPropertyBinders.emplace(
+        binders.emplace(
             std::piecewise_construct,
             std::forward_as_tuple(layer->getID()),
             std::forward_as_tuple(
                 layer->as<LineLayer>()->impl->paint.evaluated,
                 parameters.tileID.overscaledZ));
     }
+    return binders;
+}
+
+LineBucket::LineBucket(const BucketParameters& parameters,
+                       const std::vector<const Layer*>& layers,
+                       const style::LineLayoutProperties& layout_)
+    : layout(layout_.evaluate(PropertyEvaluationParameters(parameters.tileID.overscaledZ))),
+      paintPropertyBinders(createPaintPropertyBinders(parameters, layers)),
+      overscaling(parameters.tileID.overscaleFactor()),
+      obsolete(parameters.obsolete) {
+}
+
+LineBucket::LineBucket(const LineBucket& other)
+    : layout(other.layout),
+      vertices(other.vertices),
+      triangles(other.triangles),
+      segments(other.segments),
+      paintPropertyBinders(other.paintPropertyBinders),
+      e1(other.e1),
+      e2(other.e2),
+      e3(other.e3),
+      overscaling(other.overscaling) {
+    featureVertices = other.featureVertices;
+}
+
+std::unique_ptr<Bucket> LineBucket::clone() const {
+    assert(!uploaded);
+    return std::unique_ptr<Bucket>(new LineBucket(*this));
 }
 
 void LineBucket::addFeature(const GeometryTileFeature& feature,
-                            const GeometryCollection& geometryCollection) {
+                            const GeometryCollection& geometryCollection,
+                            std::size_t index) {
     for (auto& line : geometryCollection) {
+        // The bucket of a tile that is gone is dropped half-built.
+        if (obsolete && *obsolete) {
+            return;
+        }
         addGeometry(line, feature.getType());
     }
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.populateVertexVectors(feature, vertices.vertexSize());
     }
+    addFeatureVertices(index, vertices.vertexSize());
+}
+
+std::function<void ()> LineBucket::repaint(const BucketParameters& parameters,
+                                           const std::vector<const Layer*>& layers,
+                                           const GeometryTileLayer& sourceLayer,
+                                           const FeatureStateMap* states) {
+    auto binders = std::make_shared<std::map<std::string, LineProgram::PaintPropertyBinders>>(
+        createPaintPropertyBinders(parameters, layers));
+    populatePaintPropertyBinders(*binders, sourceLayer, states);
+    for (auto& pair : *binders) {
+        pair.second.shrinkToFit();
+    }
+    return [this, binders] {
+        setPaintPropertyBinders(paintPropertyBinders, std::move(*binders));
+    };
 }
 
 /*
@@ -102,8 +149,21 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates, FeatureType
         nextNormal = util::perp(util::unit(convertPoint<double>(firstCoordinate - *currentCoordinate)));
     }
 
+    // Calculate the normals of all segments towards the next vertex up front, in a tight loop
+    // over contiguous memory that doesn't depend on the join and cap logic below. Segments of
+    // duplicate vertices get a zero normal, but are skipped when adding vertices anyway.
+    std::vector<Point<double>>& segmentNormals = segmentNormalsScratch;
+    segmentNormals.assign(len, Point<double>());
+    for (std::size_t i = 0; i + 1 < len; ++i) {
+        segmentNormals[i] = util::perp(util::unit(convertPoint<double>(coordinates[i + 1] - coordinates[i])));
+    }
+    if (type == FeatureType::Polygon) {
+        segmentNormals[len - 1] = util::perp(util::unit(convertPoint<double>(coordinates[1] - coordinates[len - 1])));
+    }
+
     const std::size_t startVertex = vertices.vertexSize();
-    std::vector<TriangleElement> triangleStore;
+    std::vector<TriangleElement>& triangleStore = triangleStoreScratch;
+    triangleStore.clear();
 
     for (std::size_t i = 0; i < len; ++i) {
         if (type == FeatureType::Polygon && i == len - 1) {
@@ -134,8 +194,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates, FeatureType
         // Calculate the normal towards the next vertex in this line. In case
         // there is no next vertex, pretend that the line is continuing straight,
         // meaning that we are just using the previous normal.
-        nextNormal = nextCoordinate ? util::perp(util::unit(convertPoint<double>(*nextCoordinate - *currentCoordinate)))
-                                : prevNormal;
+        nextNormal = nextCoordinate ? segmentNormals[i] : prevNormal;
 
         // If we still don't have a previous normal, this is the beginning of a
         // non-closed line, so we're doing a straight "join".
@@ -439,16 +498,67 @@ void LineBucket::addPieSliceVertex(const GeometryCoordinate& currentVertex,
 }
 
 void LineBucket::upload(gl::Context& context) {
-    vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    indexBuffer = context.createIndexBuffer(std::move(triangles));
+    if (!paintChanged) {
+        vertexBuffer = context.createVertexBuffer(std::move(vertices));
+        indexBuffer = gl::createIndexBuffer(context, std::move(triangles), segments);
+    }
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(context);
     }
 
+    paintChanged = false;
     uploaded = true;
 }
 
+void LineBucket::splitSegments() {
+    // The lowest bit of each coordinate holds the texture coordinate of the vertex.
+    const auto position = [&] (std::size_t i) {
+        const auto& pos = vertices.data()[i].a1;
+        return Point<int16_t>(pos[0] >> 1, pos[1] >> 1);
+    };
+    gl::splitSegments(triangles, segments, position, maxSegmentSize, minSegmentPrimitives);
+}
+
+void LineBucket::shrinkToFit() {
+    std::vector<Point<double>>().swap(segmentNormalsScratch);
+    std::vector<TriangleElement>().swap(triangleStoreScratch);
+    vertices.shrinkToFit();
+    triangles.shrinkToFit();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.shrinkToFit();
+    }
+}
+
+void LineBucket::releaseData() {
+    assert(uploaded);
+    vertices.release();
+    triangles.release();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.releaseVertexVectors();
+    }
+}
+
+bool LineBucket::releaseBuffers() {
+    // Where the context supports 32-bit indices, upload() may merge the segments and release
+    // the 16-bit indices.
+    if (vertexBuffer && (vertices.empty() || triangles.empty())) {
+        return false;
+    }
+
+    vertexBuffer = {};
+    indexBuffer = {};
+    // Copies leave behind the vertex array objects, which refer to the released buffers.
+    segments = gl::SegmentVector<LineAttributes>(segments);
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.releaseVertexBuffers();
+    }
+
+    paintChanged = false;
+    uploaded = false;
+    return true;
+}
+
 void LineBucket::render(Painter& painter,
                         PaintParameters& parameters,
                         const Layer& layer,
@@ -460,4 +570,13 @@ bool LineBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t LineBucket::getByteSize() const {
+    return vertices.byteSize() + triangles.byteSize() + getBufferByteSize();
+}
+
+std::size_t LineBucket::getBufferByteSize() const {
+    return (vertexBuffer ? vertexBuffer->byteSize() : 0) +
+        (indexBuffer ? indexBuffer->byteSize() : 0);
+}
+
 } // namespace mbgl
@@ -8,6 +8,7 @@
 #include <mbgl/programs/line_program.hpp>
 #include <mbgl/style/layers/line_layer_properties.hpp>
 
+#include <atomic>
 #include <vector>
 
 namespace mbgl {
@@ -23,10 +24,25 @@ public:
                const style::LineLayoutProperties&);
 
     void addFeature(const GeometryTileFeature&,
-                    const GeometryCollection&) override;
+                    const GeometryCollection&,
+                    std::size_t index) override;
+    std::vector<std::string> paintPropertyKeys() const override {
+        return Bucket::paintPropertyKeys(paintPropertyBinders);
+    }
     bool hasData() const override;
+    std::size_t getByteSize() const override;
+    std::size_t getBufferByteSize() const override;
+    std::unique_ptr<Bucket> clone() const override;
+    std::function<void ()> repaint(const style::BucketParameters&,
+                                   const std::vector<const style::Layer*>&,
+                                   const GeometryTileLayer&,
+                                   const FeatureStateMap*) override;
 
     void upload(gl::Context&) override;
+    void splitSegments() override;
+    void shrinkToFit() override;
+    void releaseData() override;
+    bool releaseBuffers() override;
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
 
     style::LineLayoutProperties::PossiblyEvaluated layout;
@@ -41,6 +57,8 @@ public:
     std::map<std::string, LineProgram::PaintPropertyBinders> paintPropertyBinders;
 
 private:
+    LineBucket(const LineBucket&);
+
     void addGeometry(const GeometryCoordinates&, FeatureType);
 
     struct TriangleElement {
@@ -54,11 +72,19 @@ private:
             const Point<double>& extrude, bool lineTurnsLeft, std::size_t startVertex,
             std::vector<TriangleElement>& triangleStore);
 
+    // The normals and triangles of the line that is being added, which keep their memory for the
+    // next one.
+    std::vector<Point<double>> segmentNormalsScratch;
+    std::vector<TriangleElement> triangleStoreScratch;
+
     std::ptrdiff_t e1;
     std::ptrdiff_t e2;
     std::ptrdiff_t e3;
 
     const uint32_t overscaling;
+
+    // Not copied, since copies are made once all features are added.
+    const std::atomic<bool>* obsolete = nullptr;
 };
 
 } // namespace mbgl
@@ -16,6 +16,15 @@
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/custom_layer.hpp>
 #include <mbgl/style/layers/custom_layer_impl.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer.hpp>
+#include <mbgl/style/layers/heatmap_layer.hpp>
+#include <mbgl/style/layers/hillshade_layer.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+
+#include <mbgl/renderer/symbol_bucket.hpp>
+#include <mbgl/renderer/hillshade_bucket.hpp>
+
+#include <mbgl/annotation/annotation_manager.hpp>
 
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/geometry/line_atlas.hpp>
@@ -23,6 +32,7 @@
 
 #include <mbgl/programs/program_parameters.hpp>
 #include <mbgl/programs/programs.hpp>
+#include <mbgl/programs/fill_pick_program.hpp>
 
 #include <mbgl/algorithm/generate_clip_ids.hpp>
 #include <mbgl/algorithm/generate_clip_ids_impl.hpp>
@@ -30,6 +40,7 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/mat3.hpp>
 #include <mbgl/util/string.hpp>
+#include <mbgl/util/tile_cover.hpp>
 
 #include <mbgl/util/offscreen_texture.hpp>
 
@@ -37,7 +48,11 @@
 
 #include <cassert>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace mbgl {
@@ -79,41 +94,102 @@ static gl::VertexVector<RasterLayoutVertex> rasterVertices() {
     return result;
 }
 
+static gl::VertexVector<CircleCornerVertex> quadCorners() {
+    gl::VertexVector<CircleCornerVertex> result;
+    result.emplace_back(CircleCornerVertex {{{ 0, 0 }}});
+    result.emplace_back(CircleCornerVertex {{{ 1, 0 }}});
+    result.emplace_back(CircleCornerVertex {{{ 0, 1 }}});
+    result.emplace_back(CircleCornerVertex {{{ 1, 1 }}});
+    return result;
+}
+
+struct Painter::StaticBuffers {
+    StaticBuffers(gl::Context& context)
+        : tileVertexBuffer(context.createVertexBuffer(tileVertices())),
+          rasterVertexBuffer(context.createVertexBuffer(rasterVertices())),
+          quadCornerBuffer(context.createVertexBuffer(quadCorners())),
+          tileTriangleIndexBuffer(context.createIndexBuffer(tileTriangleIndices())),
+          tileBorderIndexBuffer(context.createIndexBuffer(tileLineStripIndices())) {
+    }
+
+    gl::VertexBuffer<FillLayoutVertex> tileVertexBuffer;
+    gl::VertexBuffer<RasterLayoutVertex> rasterVertexBuffer;
+    gl::VertexBuffer<CircleCornerVertex> quadCornerBuffer;
+    gl::IndexBuffer<gl::Triangles> tileTriangleIndexBuffer;
+    gl::IndexBuffer<gl::LineStrip> tileBorderIndexBuffer;
+};
+
+// Programs differ in the pixel ratio that they are compiled for and the directory that their
+// binaries are cached in.
+static std::shared_ptr<Programs> sharedPrograms(gl::Context& context, const ProgramParameters& parameters) {
+    const std::string key = std::string("mbgl.programs/") + std::to_string(parameters.pixelRatio) +
+                            (parameters.overdraw ? "/overdraw/" : "/") + parameters.cacheDir;
+    return context.getSharedResource<Programs>(key, [&] {
+        return std::make_shared<Programs>(context, parameters);
+    });
+}
+
 Painter::Painter(gl::Context& context_,
                  const TransformState& state_,
                  float pixelRatio,
-                 const std::string& programCacheDir)
+                 const std::string& programCacheDir_)
     : context(context_),
       state(state_),
-      tileVertexBuffer(context.createVertexBuffer(tileVertices())),
-      rasterVertexBuffer(context.createVertexBuffer(rasterVertices())),
-      tileTriangleIndexBuffer(context.createIndexBuffer(tileTriangleIndices())),
-      tileBorderIndexBuffer(context.createIndexBuffer(tileLineStripIndices())) {
+      gpuTimer(context),
+      programCacheDir(programCacheDir_),
+      staticBuffers(context.getSharedResource<StaticBuffers>("mbgl.painter/static-buffers", [&] {
+          return std::make_shared<StaticBuffers>(context);
+      })),
+      tileVertexBuffer(staticBuffers->tileVertexBuffer),
+      rasterVertexBuffer(staticBuffers->rasterVertexBuffer),
+      quadCornerBuffer(staticBuffers->quadCornerBuffer),
+      tileTriangleIndexBuffer(staticBuffers->tileTriangleIndexBuffer),
+      tileBorderIndexBuffer(staticBuffers->tileBorderIndexBuffer) {
 
     tileTriangleSegments.emplace_back(0, 0, 4, 6);
     tileBorderSegments.emplace_back(0, 0, 4, 5);
     rasterSegments.emplace_back(0, 0, 4, 6);
+    extrusionTextureSegments.emplace_back(0, 0, 4, 6);
+    heatmapTextureSegments.emplace_back(0, 0, 4, 6);
+    layerGroupSegments.emplace_back(0, 0, 4, 6);
 
-    programs = std::make_unique<Programs>(context,
-                                          ProgramParameters{ pixelRatio, false, programCacheDir });
+    programs = sharedPrograms(context, ProgramParameters{ pixelRatio, false, programCacheDir });
 #ifndef NDEBUG
-    overdrawPrograms =
-        std::make_unique<Programs>(context, ProgramParameters{ pixelRatio, true, programCacheDir });
+    overdrawPrograms = sharedPrograms(context, ProgramParameters{ pixelRatio, true, programCacheDir });
 #endif
 }
 
 Painter::~Painter() = default;
 
 bool Painter::needsAnimation() const {
-    return frameHistory.needsAnimation(util::DEFAULT_FADE_DURATION);
+    return uploadsPending || frameHistory.needsAnimation(util::DEFAULT_FADE_DURATION);
+}
+
+const Painter::PatternPositions& Painter::getPatternPositions(const style::Layer& layer, const Faded<std::string>& pattern) {
+    if (patternPositions.layer != &layer) {
+        patternPositions.layer = &layer;
+        patternPositions.from = spriteAtlas->getPattern(pattern.from);
+        patternPositions.to = spriteAtlas->getPattern(pattern.to);
+    }
+    return patternPositions;
 }
 
 void Painter::cleanup() {
     context.performCleanup();
 }
 
-void Painter::render(const Style& style, const FrameData& frame_, View& view, SpriteAtlas& annotationSpriteAtlas) {
+void Painter::render(const Style& style, const FrameData& frame_, View& view, AnnotationManager& annotationManager) {
     frame = frame_;
+    frameStats = {};
+    pickingValid = false;
+    pickingDraws.clear();
+    const gl::Context::Stats statsBefore = context.getStats();
+    TimePoint stageStart = Clock::now();
+    auto endStage = [&] (Duration& stage) {
+        const TimePoint now = Clock::now();
+        stage = now - stageStart;
+        stageStart = now;
+    };
     if (frame.contextMode == GLContextMode::Shared) {
         context.setDirtyState();
     }
@@ -130,10 +206,11 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
     glyphAtlas = style.glyphAtlas.get();
     spriteAtlas = style.spriteAtlas.get();
     lineAtlas = style.lineAtlas.get();
+    patternPositions = {};
 
     RenderData renderData = style.getRenderData(frame.debugOptions, state.getAngle());
     const std::vector<RenderItem>& order = renderData.order;
-    const std::unordered_set<Source*>& sources = renderData.sources;
+    const std::vector<Source*>& sources = renderData.sources;
 
     // Update the default matrices to the current viewport dimensions.
     state.getProjMatrix(projMatrix);
@@ -144,11 +221,19 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
     }
 
     frameHistory.record(frame.timePoint, state.getZoom(),
-        frame.mapMode == MapMode::Continuous ? util::DEFAULT_FADE_DURATION : Milliseconds(0));
+        frame.mapMode == MapMode::Continuous && frame.quality < RenderQuality::NoFadeIn
+            ? util::DEFAULT_FADE_DURATION
+            : Milliseconds(0));
+
+    // Symbols fade by zoom level rather than by tile, so a fade changes all of them.
+    const bool fading = frameHistory.isDirty();
+    std::unordered_set<const Bucket*> uploadedBuckets;
 
 
     // - UPLOAD PASS -------------------------------------------------------------------------------
     // Uploads all required buffers and images before we do any actual rendering.
+    stageStart = Clock::now();
+    gpuTimer.beginStage("upload");
     {
         MBGL_DEBUG_GROUP(context, "upload");
 
@@ -157,21 +242,96 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
         lineAtlas->upload(context, 0);
         glyphAtlas->upload(context, 0);
         frameHistory.upload(context, 0);
-        annotationSpriteAtlas.upload(context, 0);
+        annotationManager.getSpriteAtlas().upload(context, 0);
+        if (annotationManager.getInstancedSymbols()) {
+            annotationManager.getSymbolInstances().upload(context);
+        }
+
+        // In continuous mode, buckets are uploaded tile by tile until the frame's budget is used
+        // up, so that many tiles arriving at once don't stall a single frame. The buckets of the
+        // remaining tiles are uploaded in the following frames and not rendered until then.
+        const std::size_t budget = frame.mapMode != MapMode::Continuous
+            ? std::numeric_limits<std::size_t>::max()
+            : frame.quality < RenderQuality::ReducedUploads
+                ? util::DEFAULT_UPLOAD_BYTES_PER_FRAME
+                : util::DEFAULT_UPLOAD_BYTES_PER_FRAME / 4;
+        std::size_t uploadedBytes = 0;
+        std::unordered_map<Tile*, std::pair<TimePoint, Duration>> uploadingTiles;
+        uploadsPending = false;
 
         for (const auto& item : order) {
-            if (item.bucket && item.bucket->needsUpload()) {
-                item.bucket->upload(context);
+            if (!item.bucket || !item.bucket->needsUpload()) {
+                continue;
             }
+
+            Tile& tile = item.tile->tile;
+            const TimePoint start = Clock::now();
+            auto it = uploadingTiles.find(&tile);
+            if (it == uploadingTiles.end()) {
+                // Always upload at least one tile per frame.
+                if (uploadedBytes >= budget && !uploadingTiles.empty()) {
+                    uploadsPending = true;
+                    continue;
+                }
+                it = uploadingTiles.emplace(&tile, std::make_pair(start, Duration::zero())).first;
+            }
+
+            uploadedBytes += item.bucket->getByteSize();
+            context.bufferArena = tile.getBufferArena();
+            item.bucket->upload(context);
+            uploadedBuckets.insert(item.bucket);
+            if (frame.releaseBucketData) {
+                item.bucket->releaseData();
+            }
+            it->second.second += Clock::now() - start;
+        }
+
+        context.bufferArena = nullptr;
+
+        // The buckets of a tile are uploaded interleaved with those of other tiles, so the
+        // upload stage of a tile is traced as the sum of its bucket uploads.
+        for (const auto& pair : uploadingTiles) {
+            pair.first->trace.add(TileTrace::Upload, pair.second.first, pair.second.first + pair.second.second);
         }
     }
 
+    // - PREPARE PASS ------------------------------------------------------------------------------
+    // Computes the slopes of the hillshade tiles whose elevations changed, once for all the
+    // frames that they're drawn in. The layers of a source share its tiles' buckets.
+    gpuTimer.beginStage("prepare");
+    {
+        MBGL_DEBUG_GROUP(context, "prepare");
+
+        for (const auto& item : order) {
+            if (!item.bucket || !item.layer.is<HillshadeLayer>()) {
+                continue;
+            }
+            auto& bucket = static_cast<HillshadeBucket&>(*item.bucket);
+            if (!bucket.needsUpload() && !bucket.isPrepared()) {
+                prepareHillshade(parameters, bucket, *item.tile);
+            }
+        }
+    }
+    endStage(frameStats.upload);
+
+    // In views that keep what was drawn into them, only the parts of the viewport that changed
+    // since the last frame are drawn again.
+    view.bind();
+    updateRedrawRegion(order, view, uploadedBuckets, fading, annotationManager.getSymbolInstances());
+    if (redrawRegion && redrawRegion->size.isEmpty()) {
+        frameStats.redrawnArea = 0;
+        gpuTimer.endFrame();
+        return;
+    }
+
     // - CLEAR -------------------------------------------------------------------------------------
     // Renders the backdrop of the OpenGL view. This also paints in areas where we don't have any
     // tiles whatsoever.
+    gpuTimer.beginStage("clear");
     {
         MBGL_DEBUG_GROUP(context, "clear");
         view.bind();
+        resetScissor();
         context.clear(paintMode() == PaintMode::Overdraw
                         ? Color::black()
                         : renderData.backgroundColor,
@@ -181,26 +341,61 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
 
     // - CLIPPING MASKS ----------------------------------------------------------------------------
     // Draws the clipping masks to the stencil buffer.
+    gpuTimer.beginStage("clip");
     {
         MBGL_DEBUG_GROUP(context, "clip");
 
-        // Update all clipping IDs.
-        algorithm::ClipIDGenerator generator;
+        // The clip IDs are only assigned again when the render tiles that are drawn change.
+        std::vector<Source*> clippedSources;
+        std::vector<bool> usedTiles;
+        bool renderTilesChanged = false;
         for (const auto& source : sources) {
-            source->baseImpl->startRender(generator, projMatrix, state);
+            source->baseImpl->startRender(projMatrix, state);
+            if (source->baseImpl->isClipped()) {
+                clippedSources.push_back(source);
+                renderTilesChanged = renderTilesChanged || source->baseImpl->haveRenderTilesChanged();
+                for (const auto& pair : source->baseImpl->getRenderTiles()) {
+                    usedTiles.push_back(pair.second.used);
+                }
+            }
+        }
+
+        if (renderTilesChanged || clippedSources != clipSources || usedTiles != clipUsedTiles) {
+            algorithm::ClipIDGenerator generator;
+            for (const auto& source : clippedSources) {
+                source->baseImpl->updateClipIDs(generator);
+            }
+            stencils = generator.getStencils();
+            clipOverlaps = generator.hasOverlaps();
+            clipSources = std::move(clippedSources);
+            clipUsedTiles = std::move(usedTiles);
         }
 
-        MBGL_DEBUG_GROUP(context, "clipping masks");
+        // Without rotation or pitch, tiles are rectangles on the screen, and unless a tile covers
+        // another one of its source, the scissor test clips them just like their stencil masks.
+        scissorClipping = state.getAngle() == 0 && state.getPitch() == 0 &&
+                          !clipOverlaps &&
+                          !(frame.debugOptions & MapDebugOptions::StencilClip);
 
-        for (const auto& stencil : generator.getStencils()) {
-            MBGL_DEBUG_GROUP(context, std::string{ "mask: " } + util::toString(stencil.first));
-            renderClippingMask(stencil.first, stencil.second);
+        if (!scissorClipping) {
+            MBGL_DEBUG_GROUP(context, "clipping masks");
+
+            for (const auto& stencil : stencils) {
+                MBGL_DEBUG_GROUP(context, std::string{ "mask: " } + util::toString(stencil.first));
+                renderClippingMask(stencil.first, stencil.second);
+            }
         }
     }
+    endStage(frameStats.clipping);
+
+    for (const auto& source : sources) {
+        frameStats.renderTiles[source->getID()] = source->baseImpl->getRenderTiles().size();
+    }
 
 #if not MBGL_USE_GLES2 and not defined(NDEBUG)
     if (frame.debugOptions & MapDebugOptions::StencilClip) {
         renderClipMasks(parameters);
+        gpuTimer.endFrame();
         return;
     }
 #endif
@@ -208,27 +403,58 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
     // Actually render the layers
     if (debug::renderTree) { Log::Info(Event::Render, "{"); indent++; }
 
-    // TODO: Correctly compute the number of layers recursively beforehand.
-    depthRangeSize = 1 - (order.size() + 2) * numSublayers * depthEpsilon;
+    // The render items of a layer are adjacent, and share the layer's depth range: its tiles
+    // don't overlap, and a layer's depth then only depends on its position in the style.
+    uint32_t layerCount = 0;
+    for (auto it = order.begin(); it != order.end(); ++it) {
+        if (it == order.begin() || &std::prev(it)->layer != &it->layer) {
+            layerCount++;
+        }
+    }
+    depthRangeSize = 1 - (layerCount + 2) * numSublayers * depthEpsilon;
+
+    // - LAYER GROUPS ------------------------------------------------------------------------------
+    // Draws the cached layer groups that are out of date into their textures. The passes below
+    // composite the groups instead of drawing their layers.
+    gpuTimer.beginStage("layer groups");
+    {
+        MBGL_DEBUG_GROUP(context, "layer groups");
+        updateLayerGroups(parameters, order, sources, uploadedBuckets, layerCount);
+    }
 
     // - OPAQUE PASS -------------------------------------------------------------------------------
     // Render everything top-to-bottom by using reverse iterators. Render opaque objects first.
+    gpuTimer.beginStage("opaque");
     renderPass(parameters,
                RenderPass::Opaque,
                order.rbegin(), order.rend(),
                0, 1);
+    endStage(frameStats.opaquePass);
 
     // - TRANSLUCENT PASS --------------------------------------------------------------------------
     // Make a second pass, rendering translucent objects. This time, we render bottom-to-top.
+    gpuTimer.beginStage("translucent");
     renderPass(parameters,
                RenderPass::Translucent,
                order.begin(), order.end(),
-               static_cast<uint32_t>(order.size()) - 1, -1);
+               layerCount - 1, -1);
+    if (annotationManager.getInstancedSymbols()) {
+        MBGL_DEBUG_GROUP(context, "symbol annotations");
+        renderSymbolInstances(parameters, annotationManager.getSymbolInstances());
+    }
+    endStage(frameStats.translucentPass);
+
+#ifndef NDEBUG
+    if (paintMode() == PaintMode::Overdraw) {
+        frameStats.overdraw = measureOverdraw();
+    }
+#endif
 
     if (debug::renderTree) { Log::Info(Event::Render, "}"); indent--; }
 
     // - DEBUG PASS --------------------------------------------------------------------------------
     // Renders debug overlays.
+    gpuTimer.beginStage("debug");
     {
         MBGL_DEBUG_GROUP(context, "debug");
 
@@ -239,6 +465,7 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
         for (const auto& source : sources) {
             source->baseImpl->finishRender(*this);
         }
+        resetScissor();
     }
 
 #if not MBGL_USE_GLES2 and not defined(NDEBUG)
@@ -258,7 +485,17 @@ void Painter::render(const Style& style, const FrameData& frame_, View& view, Sp
         context.texture[0] = 0;
 
         context.vertexArrayObject = 0;
+        context.scissorTest = false;
     }
+
+    gpuTimer.endFrame();
+    frameStats.gpuStages = gpuTimer.getLastResult();
+
+    const gl::Context::Stats glStats = context.getStats() - statsBefore;
+    frameStats.draws = glStats.draws;
+    frameStats.programSwitches = glStats.programSwitches;
+    frameStats.textureBinds = glStats.textureBinds;
+    frameStats.vertexArrayBinds = glStats.vertexArrayBinds;
 }
 
 template <class Iterator>
@@ -275,12 +512,32 @@ void Painter::renderPass(PaintParameters& parameters,
                   pass == RenderPass::Opaque ? "opaque" : "translucent");
     }
 
-    for (; it != end; ++it, i += increment) {
-        currentLayer = i;
-
+    const Layer* previousLayer = nullptr;
+    const LayerGroup* compositedGroup = nullptr;
+    for (; it != end; ++it) {
         const auto& item = *it;
         const Layer& layer = item.layer;
 
+        if (previousLayer && previousLayer != &layer) {
+            i += increment;
+        }
+        previousLayer = &layer;
+        currentLayer = i;
+
+        // The layers of a cached group are composited from its texture, once, at the point of
+        // the translucent pass where the group's bottommost layer is drawn.
+        if (!renderingLayerGroup) {
+            auto group = layerGroupOfLayer.find(&layer);
+            if (group != layerGroupOfLayer.end()) {
+                if (pass == RenderPass::Translucent && group->second != compositedGroup) {
+                    MBGL_DEBUG_GROUP(context, "layer group");
+                    compositeLayerGroup(parameters, *group->second);
+                    compositedGroup = group->second;
+                }
+                continue;
+            }
+        }
+
         if (!layer.baseImpl->hasRenderPass(pass))
             continue;
 
@@ -296,15 +553,130 @@ void Painter::renderPass(PaintParameters& parameters,
             context.setStencilMode(gl::StencilMode::disabled());
             context.setColorMode(colorModeForRenderPass());
 
-            layer.as<CustomLayer>()->impl->render(state);
-
-            // Reset the view back to our original one, just in case the CustomLayer changed
-            // the viewport or Framebuffer.
+            const CustomLayer::Impl& custom = *layer.as<CustomLayer>()->impl;
+            CustomLayerRenderParameters customParameters;
+            for (const auto& tileID : util::tileCover(state, state.getIntegerZoom())) {
+                CustomLayerTile tile;
+                tile.z = tileID.canonical.z;
+                tile.x = tileID.canonical.x;
+                tile.y = tileID.canonical.y;
+                tile.wrap = tileID.wrap;
+                tile.matrix = matrixForTile(tileID);
+                customParameters.tiles.push_back(tile);
+            }
+            customParameters.tileQuad = {
+                tileVertexBuffer.buffer->get(), tileVertexBuffer.byteOffset,
+                tileTriangleIndexBuffer.buffer->get(), tileTriangleIndexBuffer.byteOffset
+            };
+            custom.render(state, customParameters);
+
+            // Only the state that the layer declared it changes is set up again.
+            const CustomLayerGLState glState = custom.getGLState();
+            if (glState & CustomLayerGLState::Framebuffer) {
+                context.bindFramebuffer.setDirty();
+                context.viewport.setDirty();
+            }
             parameters.view.bind();
-            context.setDirtyState();
+            if (glState & CustomLayerGLState::Depth) {
+                context.setDirtyDepthState();
+            }
+            if (glState & CustomLayerGLState::Stencil) {
+                context.setDirtyStencilState();
+            }
+            if (glState & CustomLayerGLState::Color) {
+                context.setDirtyColorState();
+            }
+            if (glState & CustomLayerGLState::Scissor) {
+                context.setDirtyScissorState();
+            }
+            if (glState & CustomLayerGLState::Program) {
+                context.program.setDirty();
+            }
+            if (glState & CustomLayerGLState::Buffers) {
+                context.setDirtyBufferState();
+            }
+            if (glState & CustomLayerGLState::Textures) {
+                context.setDirtyTextureState();
+            }
+            if (glState & CustomLayerGLState::Other) {
+                context.setDirtyOtherState();
+            }
+        } else if (layer.is<FillExtrusionLayer>()) {
+            MBGL_DEBUG_GROUP(context, layer.baseImpl->id + " - extrusions");
+
+            // The extrusions of all of the layer's tiles are drawn into a texture first, so that
+            // they hide each other before the layer is composited with its opacity.
+            Iterator last = it;
+            while (std::next(last) != end && &std::next(last)->layer == &layer) {
+                ++last;
+            }
+
+            beginExtrusions();
+            for (Iterator tileItem = it; ; ++tileItem) {
+                if (!tileItem->bucket->needsUpload()) {
+                    tileItem->bucket->render(*this, parameters, layer, *tileItem->tile);
+                }
+                if (tileItem == last) {
+                    break;
+                }
+            }
+            finishExtrusions(parameters, *layer.as<FillExtrusionLayer>());
+
+            it = last;
+        } else if (layer.is<HeatmapLayer>()) {
+            MBGL_DEBUG_GROUP(context, layer.baseImpl->id + " - heatmap");
+
+            // The density of all of the layer's tiles accumulates in a texture before it's
+            // colored, as the color of a pixel depends on the sum of the kernels that reach it.
+            Iterator last = it;
+            while (std::next(last) != end && &std::next(last)->layer == &layer) {
+                ++last;
+            }
+
+            beginHeatmap();
+            for (Iterator tileItem = it; ; ++tileItem) {
+                if (!tileItem->bucket->needsUpload()) {
+                    tileItem->bucket->render(*this, parameters, layer, *tileItem->tile);
+                }
+                if (tileItem == last) {
+                    break;
+                }
+            }
+            finishHeatmap(parameters, *layer.as<HeatmapLayer>());
+
+            it = last;
+        } else if (layer.is<SymbolLayer>()) {
+            MBGL_DEBUG_GROUP(context, layer.baseImpl->id + " - symbols");
+
+            // Draw each part of the layer for all of its tiles before the next part, so that
+            // programs, textures and uniforms change once per part rather than once per tile.
+            Iterator last = it;
+            while (std::next(last) != end && &std::next(last)->layer == &layer) {
+                ++last;
+            }
+
+            for (SymbolPart part : symbolParts) {
+                for (Iterator tileItem = it; ; ++tileItem) {
+                    if (!tileItem->bucket->needsUpload()) {
+                        renderSymbol(parameters, static_cast<SymbolBucket&>(*tileItem->bucket),
+                                     *layer.as<SymbolLayer>(), *tileItem->tile, part);
+                        resetScissor();
+                    }
+                    if (tileItem == last) {
+                        break;
+                    }
+                }
+            }
+
+            it = last;
         } else {
+            if (item.bucket->needsUpload()) {
+                continue; // Deferred to a later frame by the upload budget.
+            }
+
             MBGL_DEBUG_GROUP(context, layer.baseImpl->id + " - " + util::toString(item.tile->id));
             item.bucket->render(*this, parameters, layer, *item.tile);
+            resetScissor();
         }
     }
 
@@ -313,6 +685,40 @@ void Painter::renderPass(PaintParameters& parameters,
     }
 }
 
+void Painter::renderLayerGroup(PaintParameters& parameters,
+                               LayerGroup& group,
+                               const std::vector<RenderItem>& order,
+                               Size size) {
+    if (!group.texture || group.texture->getSize() != size) {
+        group.texture = std::make_unique<OffscreenTexture>(
+            context, size, OffscreenTextureAttachment::DepthStencil);
+    }
+
+    group.texture->bind();
+    context.clear(Color{ 0.0f, 0.0f, 0.0f, 0.0f }, 1.0f, 0);
+
+    // The texture has a stencil buffer of its own, which the masks are drawn into again.
+    if (!scissorClipping) {
+        for (const auto& stencil : stencils) {
+            renderClippingMask(stencil.first, stencil.second);
+        }
+    }
+
+    // The layers keep the depth ranges they have in the frame.
+    const auto begin = order.begin() + group.begin;
+    const auto end = order.begin() + group.end;
+    renderingLayerGroup = true;
+    renderPass(parameters,
+               RenderPass::Opaque,
+               std::make_reverse_iterator(end), std::make_reverse_iterator(begin),
+               group.top, 1);
+    renderPass(parameters,
+               RenderPass::Translucent,
+               begin, end,
+               group.top + group.layers - 1, -1);
+    renderingLayerGroup = false;
+}
+
 mat4 Painter::matrixForTile(const UnwrappedTileID& tileID) {
     mat4 matrix;
     state.matrixFor(matrix, tileID);
@@ -326,7 +732,90 @@ gl::DepthMode Painter::depthModeForSublayer(uint8_t n, gl::DepthMode::Mask mask)
     return gl::DepthMode { gl::DepthMode::LessEqual, mask, { nearDepth, farDepth } };
 }
 
-gl::StencilMode Painter::stencilModeForClipping(const ClipID& id) const {
+gl::value::Scissor::Type Painter::viewportRegion(const mat4& tileMatrix, int32_t margin) const {
+    const auto viewport = context.viewport.getCurrentValue();
+
+    // Rounding the edges to whole pixels assigns each pixel to the tile that covers its
+    // center, as the stencil masks do.
+    const auto toPixel = [] (double clip, double w, int32_t offset, uint32_t size) {
+        return offset + static_cast<int32_t>(std::round((clip / w + 1) / 2 * size));
+    };
+
+    int32_t x0 = std::numeric_limits<int32_t>::max();
+    int32_t y0 = std::numeric_limits<int32_t>::max();
+    int32_t x1 = std::numeric_limits<int32_t>::min();
+    int32_t y1 = std::numeric_limits<int32_t>::min();
+    for (const auto& corner : { std::make_pair(-margin, -margin),
+                                std::make_pair(util::EXTENT + margin, -margin),
+                                std::make_pair(-margin, util::EXTENT + margin),
+                                std::make_pair(util::EXTENT + margin, util::EXTENT + margin) }) {
+        vec4 point = {{ double(corner.first), double(corner.second), 0, 1 }};
+        matrix::transformMat4(point, point, tileMatrix);
+        const int32_t x = toPixel(point[0], point[3], viewport.x, viewport.size.width);
+        const int32_t y = toPixel(point[1], point[3], viewport.y, viewport.size.height);
+        x0 = std::min(x0, x);
+        y0 = std::min(y0, y);
+        x1 = std::max(x1, x);
+        y1 = std::max(y1, y);
+    }
+
+    return { x0, y0, { static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0) } };
+}
+
+gl::SegmentFilter Painter::segmentFilter(const mat4& tileMatrix, float margin) const {
+    const auto viewport = context.viewport.getCurrentValue();
+    if (viewport.size.isEmpty()) {
+        return {};
+    }
+
+    // The edges of the viewport in clip space, moved out by the margin.
+    const double edgeX = 1 + 2 * margin * frame.pixelRatio / viewport.size.width;
+    const double edgeY = 1 + 2 * margin * frame.pixelRatio / viewport.size.height;
+
+    return [tileMatrix, edgeX, edgeY] (const gl::SegmentBounds& bounds) {
+        bool left = true;
+        bool right = true;
+        bool below = true;
+        bool above = true;
+        for (const auto& corner : { bounds.min, Point<int16_t>(bounds.max.x, bounds.min.y),
+                                    Point<int16_t>(bounds.min.x, bounds.max.y), bounds.max }) {
+            vec4 point = {{ double(corner.x), double(corner.y), 0, 1 }};
+            matrix::transformMat4(point, point, tileMatrix);
+            const double w = point[3];
+            if (w <= 0) {
+                // The corner is behind the camera, where the box can't be told to be off-screen
+                // by its corners.
+                return true;
+            }
+            left = left && point[0] < -edgeX * w;
+            right = right && point[0] > edgeX * w;
+            below = below && point[1] < -edgeY * w;
+            above = above && point[1] > edgeY * w;
+        }
+        return !(left || right || below || above);
+    };
+}
+
+gl::StencilMode Painter::stencilModeForClipping(const RenderTile& tile) {
+    if (scissorClipping) {
+        auto region = viewportRegion(tile.matrix);
+        if (redrawRegion) {
+            const int32_t x0 = std::max(region.x, redrawRegion->x);
+            const int32_t y0 = std::max(region.y, redrawRegion->y);
+            const int32_t x1 = std::min<int32_t>(region.x + region.size.width,
+                                                 redrawRegion->x + redrawRegion->size.width);
+            const int32_t y1 = std::min<int32_t>(region.y + region.size.height,
+                                                 redrawRegion->y + redrawRegion->size.height);
+            region = { x0, y0, { static_cast<uint32_t>(std::max(0, x1 - x0)),
+                                 static_cast<uint32_t>(std::max(0, y1 - y0)) } };
+        }
+
+        context.scissorTest = true;
+        context.scissor = region;
+        return gl::StencilMode::disabled();
+    }
+
+    const ClipID& id = tile.clip;
     return gl::StencilMode {
         gl::StencilMode::Equal { static_cast<uint32_t>(id.mask.to_ulong()) },
         static_cast<int32_t>(id.reference.to_ulong()),
@@ -9,14 +9,23 @@
 #include <mbgl/renderer/bucket.hpp>
 
 #include <mbgl/gl/context.hpp>
+#include <mbgl/gl/gpu_timer.hpp>
+#include <mbgl/map/frame_stats.hpp>
 #include <mbgl/programs/debug_program.hpp>
 #include <mbgl/programs/program_parameters.hpp>
 #include <mbgl/programs/fill_program.hpp>
+#include <mbgl/programs/circle_program.hpp>
 #include <mbgl/programs/raster_program.hpp>
+#include <mbgl/programs/fill_extrusion_program.hpp>
+#include <mbgl/programs/heatmap_program.hpp>
+#include <mbgl/programs/layer_group_program.hpp>
 
 #include <mbgl/style/style.hpp>
+#include <mbgl/style/cross_faded_property_evaluator.hpp>
+#include <mbgl/sprite/sprite_atlas.hpp>
 
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/clip_id.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/constants.hpp>
 
@@ -24,11 +33,15 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 
 class RenderTile;
 class SpriteAtlas;
+class AnnotationManager;
+class SymbolAnnotationInstances;
 class View;
 class GlyphAtlas;
 class LineAtlas;
@@ -37,33 +50,66 @@ class Tile;
 
 class DebugBucket;
 class FillBucket;
+class FillExtrusionBucket;
 class LineBucket;
 class CircleBucket;
+class HeatmapBucket;
+class HillshadeBucket;
 class SymbolBucket;
 class RasterBucket;
 
 class Programs;
+class FillPickProgram;
 class PaintParameters;
-
-struct ClipID;
+class OffscreenTexture;
+class RenderedFeatureHandle;
 
 namespace style {
 class Style;
 class Source;
 class FillLayer;
+class FillExtrusionLayer;
 class LineLayer;
 class CircleLayer;
+class HeatmapLayer;
+class HillshadeLayer;
 class SymbolLayer;
 class RasterLayer;
 class BackgroundLayer;
 } // namespace style
 
+// The parts of a symbol layer, in drawing order. Each part is drawn for all tiles of a layer
+// before the next one.
+enum class SymbolPart : uint8_t {
+    IconHalo,
+    IconFill,
+    TextHalo,
+    TextFill,
+    CollisionBox,
+};
+
+constexpr SymbolPart symbolParts[] = {
+    SymbolPart::IconHalo,
+    SymbolPart::IconFill,
+    SymbolPart::TextHalo,
+    SymbolPart::TextFill,
+    SymbolPart::CollisionBox,
+};
+
 struct FrameData {
     TimePoint timePoint;
     float pixelRatio;
     MapMode mapMode;
     GLContextMode contextMode;
     MapDebugOptions debugOptions;
+    bool releaseBucketData;
+    // Whether runs of fill, line and circle layers are drawn into cached textures; see
+    // Map::setLayerCaching().
+    bool layerCaching;
+    // Whether the frame must be drawn in full, even where its tiles didn't change.
+    bool fullRedraw;
+    // The quality that the frame budget allows; see RenderQuality.
+    RenderQuality quality;
 };
 
 class Painter : private util::noncopyable {
@@ -74,28 +120,61 @@ public:
     void render(const style::Style&,
                 const FrameData&,
                 View&,
-                SpriteAtlas& annotationSpriteAtlas);
+                AnnotationManager&);
 
     void cleanup();
 
+    // Starts compiling the programs that the style's layers are drawn with, so that they are
+    // ready, or compiling in the background, by the time the first of their tiles is drawn.
+    void preparePrograms(const style::Style&);
+
     void renderClippingMask(const UnwrappedTileID&, const ClipID&);
     void renderTileDebug(const RenderTile&);
     void renderFill(PaintParameters&, FillBucket&, const style::FillLayer&, const RenderTile&);
+    void renderFillExtrusion(PaintParameters&, FillExtrusionBucket&, const style::FillExtrusionLayer&, const RenderTile&);
+    // Binds the texture that the extrusions of a layer are drawn into, and clears it.
+    void beginExtrusions();
+    // Binds the view again and composites the layer's extrusions with its opacity.
+    void finishExtrusions(PaintParameters&, const style::FillExtrusionLayer&);
     void renderLine(PaintParameters&, LineBucket&, const style::LineLayer&, const RenderTile&);
     void renderCircle(PaintParameters&, CircleBucket&, const style::CircleLayer&, const RenderTile&);
-    void renderSymbol(PaintParameters&, SymbolBucket&, const style::SymbolLayer&, const RenderTile&);
+    void renderHeatmap(PaintParameters&, HeatmapBucket&, const style::HeatmapLayer&, const RenderTile&);
+    // Binds the downsampled texture that the density of a heatmap layer accumulates in, and
+    // clears it.
+    void beginHeatmap();
+    // Binds the view again and colors the layer's density with its color ramp and opacity.
+    void finishHeatmap(PaintParameters&, const style::HeatmapLayer&);
+    void renderSymbol(PaintParameters&, SymbolBucket&, const style::SymbolLayer&, const RenderTile&, SymbolPart);
     void renderRaster(PaintParameters&, RasterBucket&, const style::RasterLayer&, const RenderTile&);
+    // Computes the slopes of a hillshade tile from its elevations into the bucket's texture.
+    void prepareHillshade(PaintParameters&, HillshadeBucket&, const RenderTile&);
+    void renderHillshade(PaintParameters&, HillshadeBucket&, const style::HillshadeLayer&, const RenderTile&);
     void renderBackground(PaintParameters&, const style::BackgroundLayer&);
+    void renderSymbolInstances(PaintParameters&, SymbolAnnotationInstances&);
 
 #ifndef NDEBUG
     // Renders tile clip boundaries, using stencil buffer to calculate fill color.
     void renderClipMasks(PaintParameters&);
     // Renders the depth buffer.
     void renderDepthBuffer(PaintParameters&);
+    // Returns the average number of fragments that were drawn per pixel of the viewport, which
+    // the overdraw mode adds up in the colors of the framebuffer.
+    float measureOverdraw();
 #endif
 
     bool needsAnimation() const;
 
+    // Draws the fills of the last frame into the picking buffer, each pixel holding the feature
+    // that is drawn last at it, and binds the view again. Rendering a frame outdates the buffer.
+    void renderPicking(const style::Style&, View&);
+
+    // Finds the fill feature at the point in the picking buffer, and returns true, or returns
+    // false if the buffer is out of date or doesn't hold all of the last frame's fills.
+    bool pickFeature(const ScreenCoordinate&, optional<RenderedFeatureHandle>& result);
+
+    // Returns the profile of the painter's part of the last frame.
+    const FrameStats& getFrameStats() const { return frameStats; }
+
 private:
     std::vector<RenderItem> determineRenderOrder(const style::Style&);
 
@@ -107,7 +186,71 @@ private:
 
     mat4 matrixForTile(const UnwrappedTileID&);
     gl::DepthMode depthModeForSublayer(uint8_t n, gl::DepthMode::Mask) const;
-    gl::StencilMode stencilModeForClipping(const ClipID&) const;
+    // Clips the draws that follow to the tile, either with the scissor test or with the tile's
+    // stencil mask, and returns the stencil mode they are drawn with.
+    gl::StencilMode stencilModeForClipping(const RenderTile&);
+
+    // Returns the bounds of a tile in the viewport, in framebuffer pixels, grown by a margin in
+    // tile units.
+    gl::value::Scissor::Type viewportRegion(const mat4& tileMatrix, int32_t margin = 0) const;
+
+    // Returns a filter that skips the segments that are off-screen, given the matrix they are
+    // drawn with and the distance in pixels that what they draw reaches beyond their vertices.
+    gl::SegmentFilter segmentFilter(const mat4& tileMatrix, float margin) const;
+
+    // Finds the part of the viewport that changed since the last frame drawn into the view, from
+    // the render items whose buckets were added, removed or uploaded and from the symbol
+    // annotations drawn as instances that changed, and remembers what this frame draws for the
+    // next one.
+    void updateRedrawRegion(const std::vector<RenderItem>&,
+                            const View&,
+                            const std::unordered_set<const Bucket*>& uploadedBuckets,
+                            bool fading,
+                            SymbolAnnotationInstances&);
+
+    // A run of adjacent fill, line and circle layers that is drawn into a texture larger than the
+    // viewport. While the map only pans, frames composite the texture, moved by how far the map
+    // moved, instead of drawing the layers.
+    struct LayerGroup {
+        // The bottommost layer, by which a group is matched with those of the last frame.
+        const style::Layer* layer;
+        // The range of the group's render items in the render order.
+        std::size_t begin;
+        std::size_t end;
+        // The number of the group's layers, and the depth index of the topmost one.
+        uint32_t layers;
+        uint32_t top;
+        // What the texture holds, and the projection matrix it was drawn with. It is drawn again
+        // when the items change or one of their buckets is uploaded again.
+        std::vector<std::pair<const style::Layer*, const Bucket*>> items;
+        mat4 matrix;
+        bool drawn = false;
+        std::unique_ptr<OffscreenTexture> texture;
+    };
+
+    // Finds the layer groups of the frame and draws those that are out of date into their
+    // textures. Clears them when caching is off or the map is pitched, where a pan doesn't just
+    // move what is drawn.
+    void updateLayerGroups(PaintParameters&,
+                           const std::vector<RenderItem>&,
+                           const std::vector<style::Source*>&,
+                           const std::unordered_set<const Bucket*>& uploadedBuckets,
+                           uint32_t layerCount);
+    void renderLayerGroup(PaintParameters&, LayerGroup&, const std::vector<RenderItem>&, Size);
+    void compositeLayerGroup(PaintParameters&, const LayerGroup&);
+
+    struct PatternPositions {
+        const style::Layer* layer = nullptr;
+        optional<SpriteAtlasElement> from;
+        optional<SpriteAtlasElement> to;
+    };
+
+    // Returns the positions of the images of a layer's pattern in the sprite atlas. They are
+    // looked up once per frame for the first tile of the layer and kept for the others.
+    const PatternPositions& getPatternPositions(const style::Layer&, const style::Faded<std::string>&);
+
+    // Restricts the draws that follow to the redraw region, if the frame has one.
+    void resetScissor();
     gl::ColorMode colorModeForRenderPass() const;
 
 #ifndef NDEBUG
@@ -151,22 +294,93 @@ private:
     GlyphAtlas* glyphAtlas = nullptr;
     LineAtlas* lineAtlas = nullptr;
 
+    // The pattern positions of the layer that was drawn last in this frame.
+    PatternPositions patternPositions;
+
     FrameHistory frameHistory;
 
-    std::unique_ptr<Programs> programs;
+    // Whether the upload budget left buckets to be uploaded in the next frame.
+    bool uploadsPending = false;
+
+    // Whether this frame's tiles are clipped with the scissor test instead of stencil masks.
+    bool scissorClipping = false;
+
+    // The stencil masks of the render tiles, and the sources and used tiles they were generated
+    // for, so that they are only generated again when those change.
+    std::vector<std::pair<UnwrappedTileID, ClipID>> stencils;
+    bool clipOverlaps = false;
+    std::vector<style::Source*> clipSources;
+    std::vector<bool> clipUsedTiles;
+
+    // The part of the viewport that this frame draws, or none when it draws all of it.
+    optional<gl::value::Scissor::Type> redrawRegion;
+
+    // What the last frame drew, so that the next one can tell what it changes.
+    const View* drawnView = nullptr;
+    mat4 drawnMatrix;
+    Size drawnSize;
+    MapDebugOptions drawnDebugOptions = MapDebugOptions::NoDebug;
+    std::map<std::pair<const style::Layer*, const Bucket*>, UnwrappedTileID> drawnItems;
+
+    // The layer groups of the last frame, and the group of each of their layers.
+    std::vector<LayerGroup> layerGroups;
+    std::unordered_map<const style::Layer*, const LayerGroup*> layerGroupOfLayer;
+    // Whether a group is being drawn into its texture, rather than composited.
+    bool renderingLayerGroup = false;
+
+    FrameStats frameStats;
+    gl::GPUTimer gpuTimer;
+
+    // Shared with the painters of other maps that render to the same context.
+    std::shared_ptr<Programs> programs;
 #ifndef NDEBUG
-    std::unique_ptr<Programs> overdrawPrograms;
+    std::shared_ptr<Programs> overdrawPrograms;
 #endif
 
-    gl::VertexBuffer<FillLayoutVertex> tileVertexBuffer;
-    gl::VertexBuffer<RasterLayoutVertex> rasterVertexBuffer;
-
-    gl::IndexBuffer<gl::Triangles> tileTriangleIndexBuffer;
-    gl::IndexBuffer<gl::LineStrip> tileBorderIndexBuffer;
+    // The draws of the picking buffer, which the alpha channel of its pixels numbers from one.
+    struct PickingDraw {
+        const style::Layer* layer;
+        std::shared_ptr<const GeometryTileData> data;
+        CanonicalTileID tileID;
+    };
+
+    const std::string programCacheDir;
+    std::unique_ptr<FillPickProgram> fillPickProgram;
+    std::unique_ptr<OffscreenTexture> pickingTexture;
+    std::unique_ptr<OffscreenTexture> extrusionTexture;
+    std::unique_ptr<OffscreenTexture> heatmapTexture;
+    optional<gl::Texture> heatmapColorRampTexture;
+    // The color ramp that heatmapColorRampTexture holds.
+    std::shared_ptr<const PremultipliedImage> heatmapColorRamp;
+    std::vector<PickingDraw> pickingDraws;
+    bool pickingValid = false;
+
+    // The buffers of the tile and raster quads, which never change; the painters of the same
+    // context share them.
+    struct StaticBuffers;
+    std::shared_ptr<StaticBuffers> staticBuffers;
+
+    gl::VertexBuffer<FillLayoutVertex>& tileVertexBuffer;
+    gl::VertexBuffer<RasterLayoutVertex>& rasterVertexBuffer;
+    // The quad of instanced circles and symbols, which is indexed like the tile's.
+    gl::VertexBuffer<CircleCornerVertex>& quadCornerBuffer;
+
+    gl::IndexBuffer<gl::Triangles>& tileTriangleIndexBuffer;
+    gl::IndexBuffer<gl::LineStrip>& tileBorderIndexBuffer;
 
     gl::SegmentVector<FillAttributes> tileTriangleSegments;
     gl::SegmentVector<DebugAttributes> tileBorderSegments;
     gl::SegmentVector<RasterAttributes> rasterSegments;
+    gl::SegmentVector<ExtrusionTextureAttributes> extrusionTextureSegments;
+    gl::SegmentVector<HeatmapTextureAttributes> heatmapTextureSegments;
+    gl::SegmentVector<LayerGroupAttributes> layerGroupSegments;
+
+    // The quads of the tiles that backgrounds without a pattern were last drawn in; see
+    // renderBackground().
+    std::vector<UnwrappedTileID> backgroundTileIDs;
+    optional<gl::VertexBuffer<FillLayoutVertex>> backgroundVertexBuffer;
+    optional<gl::IndexBuffer<gl::Triangles>> backgroundIndexBuffer;
+    gl::SegmentVector<FillAttributes> backgroundSegments;
 };
 
 } // namespace mbgl
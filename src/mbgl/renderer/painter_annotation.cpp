@@ -0,0 +1,96 @@
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/annotation/symbol_annotation_instances.hpp>
+#include <mbgl/sprite/sprite_atlas.hpp>
+#include <mbgl/programs/programs.hpp>
+#include <mbgl/programs/annotation_icon_program.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/math/clamp.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/util/projection.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mbgl {
+
+void Painter::renderSymbolInstances(PaintParameters& parameters, SymbolAnnotationInstances& instances) {
+    if (!instances.instanceBuffer || instances.segments.empty()) {
+        return;
+    }
+
+    SpriteAtlas& atlas = instances.atlas;
+    atlas.bind(state.isChanging() || state.getPitch() != 0 || frame.pixelRatio != atlas.getPixelRatio(),
+               context, 0);
+
+    const double worldSize = Projection::worldSize(state.zoomScale(state.getZoom()));
+
+    // The instances' positions are relative to the center of the map, which a float holds
+    // precisely enough at any zoom level.
+    const Point<double> center = Projection::project(state.getLatLng(), 1) / double(util::tileSize);
+    const double centerWrap = std::floor(center.x);
+    const Point<double> anchor {
+        center.x - centerWrap,
+        util::clamp(center.y, 0.0, 1.0)
+    };
+    const Point<uint32_t> fixedAnchor {
+        static_cast<uint32_t>(std::min(anchor.x * 4294967296.0, 4294967295.0)),
+        static_cast<uint32_t>(std::min(anchor.y * 4294967296.0, 4294967295.0))
+    };
+
+    // The world copies that the viewport, padded by the largest icon, shows.
+    const Size size = state.getSize();
+    const double padding = instances.getMaxIconSize();
+    double minWrap = centerWrap;
+    double maxWrap = centerWrap;
+    for (const ScreenCoordinate& corner : {
+             ScreenCoordinate { -padding, -padding },
+             ScreenCoordinate { size.width + padding, -padding },
+             ScreenCoordinate { -padding, size.height + padding },
+             ScreenCoordinate { size.width + padding, size.height + padding } }) {
+        const double wrap = std::floor((state.screenCoordinateToLatLng(corner).longitude() + util::LONGITUDE_MAX) / util::DEGREES_MAX);
+        minWrap = std::min(minWrap, wrap);
+        maxWrap = std::max(maxWrap, wrap);
+    }
+    // Pitched views can reach far beyond the horizon.
+    minWrap = std::max(minWrap, centerWrap - 2);
+    maxWrap = std::min(maxWrap, centerWrap + 2);
+
+    const Size texsize = atlas.getSize();
+
+    for (double wrap = minWrap; wrap <= maxWrap; wrap++) {
+        mat4 matrix;
+        matrix::identity(matrix);
+        matrix::translate(matrix, matrix, (fixedAnchor.x / 4294967296.0 + wrap) * worldSize,
+                          fixedAnchor.y / 4294967296.0 * worldSize, 0);
+        matrix::multiply(matrix, projMatrix, matrix);
+
+        parameters.programs.annotationIcon.draw(
+            context,
+            gl::DepthMode::disabled(),
+            gl::StencilMode::disabled(),
+            colorModeForRenderPass(),
+            AnnotationIconProgram::UniformValues {
+                uniforms::u_matrix::Value{ matrix },
+                uniforms::u_anchor::Value{ std::array<float, 4> {{
+                    float(fixedAnchor.x >> 16),
+                    float(fixedAnchor.y >> 16),
+                    float(fixedAnchor.x & 0xFFFF),
+                    float(fixedAnchor.y & 0xFFFF)
+                }} },
+                uniforms::u_world_scale::Value{ float(worldSize / 4294967296.0) },
+                uniforms::u_extrude_scale::Value{ pixelsToGLUnits },
+                uniforms::u_texsize::Value{ std::array<float, 2> {{ float(texsize.width), float(texsize.height) }} },
+                uniforms::u_texture::Value{ 0 }
+            },
+            *instances.cornerBuffer,
+            *instances.instanceBuffer,
+            *instances.indexBuffer,
+            instances.segments,
+            instances.instanced
+        );
+    }
+}
+
+} // namespace mbgl
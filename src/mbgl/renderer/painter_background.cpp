@@ -6,6 +6,7 @@
 #include <mbgl/programs/fill_program.hpp>
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/util/tile_cover.hpp>
+#include <mbgl/util/mat4.hpp>
 
 namespace mbgl {
 
@@ -57,25 +58,62 @@ void Painter::renderBackground(PaintParameters& parameters, const BackgroundLaye
             );
         }
     } else {
-        for (const auto& tileID : util::tileCover(state, state.getIntegerZoom())) {
-            parameters.programs.fill.draw(
-                context,
-                gl::Triangles(),
-                depthModeForSublayer(0, gl::DepthMode::ReadOnly),
-                gl::StencilMode::disabled(),
-                colorModeForRenderPass(),
-                FillProgram::UniformValues {
-                    uniforms::u_matrix::Value{ matrixForTile(tileID) },
-                    uniforms::u_world::Value{ context.viewport.getCurrentValue().size },
-                },
-                tileVertexBuffer,
-                tileTriangleIndexBuffer,
-                tileTriangleSegments,
-                paintAttibuteData,
-                properties,
-                state.getZoom()
-            );
+        // Without a pattern, the tiles differ only in their position, so their quads are drawn at
+        // once, in whole tiles from the first one.
+        std::vector<UnwrappedTileID> tileIDs = util::tileCover(state, state.getIntegerZoom());
+        if (tileIDs.empty()) {
+            return;
         }
+
+        if (tileIDs != backgroundTileIDs) {
+            const UnwrappedTileID& first = tileIDs.front();
+            const int64_t tiles = 1ll << first.canonical.z;
+            gl::VertexVector<FillLayoutVertex> vertices;
+            gl::IndexVector<gl::Triangles> indices;
+            for (const auto& tileID : tileIDs) {
+                const auto x = static_cast<int16_t>((tileID.canonical.x + tileID.wrap * tiles) -
+                                                    (first.canonical.x + first.wrap * tiles));
+                const auto y = static_cast<int16_t>(int64_t(tileID.canonical.y) - first.canonical.y);
+                const auto x1 = static_cast<int16_t>(x + 1);
+                const auto y1 = static_cast<int16_t>(y + 1);
+                const auto index = static_cast<uint16_t>(vertices.vertexSize());
+                vertices.emplace_back(FillProgram::layoutVertex({ x, y }));
+                vertices.emplace_back(FillProgram::layoutVertex({ x1, y }));
+                vertices.emplace_back(FillProgram::layoutVertex({ x, y1 }));
+                vertices.emplace_back(FillProgram::layoutVertex({ x1, y1 }));
+                indices.emplace_back(index, index + 1, index + 2);
+                indices.emplace_back(index + 1, index + 2, index + 3);
+            }
+
+            backgroundSegments.clear();
+            backgroundSegments.emplace_back(0, 0, vertices.vertexSize(), indices.indexSize());
+            backgroundVertexBuffer = context.createVertexBuffer(std::move(vertices));
+            backgroundIndexBuffer = context.createIndexBuffer(std::move(indices));
+            backgroundTileIDs.swap(tileIDs);
+        }
+
+        // The vertices are in tiles rather than tile units.
+        mat4 matrix = matrixForTile(backgroundTileIDs.front());
+        matrix::scale(matrix, matrix, util::EXTENT, util::EXTENT, 1);
+
+        parameters.programs.fill.draw(
+            context,
+            gl::Triangles(),
+            depthModeForSublayer(0, pass == RenderPass::Opaque ? gl::DepthMode::ReadWrite
+                                                               : gl::DepthMode::ReadOnly),
+            gl::StencilMode::disabled(),
+            colorModeForRenderPass(),
+            FillProgram::UniformValues {
+                uniforms::u_matrix::Value{ matrix },
+                uniforms::u_world::Value{ context.viewport.getCurrentValue().size },
+            },
+            *backgroundVertexBuffer,
+            *backgroundIndexBuffer,
+            backgroundSegments,
+            paintAttibuteData,
+            properties,
+            state.getZoom()
+        );
     }
 }
 
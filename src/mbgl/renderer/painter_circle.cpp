@@ -25,10 +25,9 @@ void Painter::renderCircle(PaintParameters& parameters,
 
     parameters.programs.circle.draw(
         context,
-        gl::Triangles(),
         depthModeForSublayer(0, gl::DepthMode::ReadOnly),
         frame.mapMode == MapMode::Still
-            ? stencilModeForClipping(tile.clip)
+            ? stencilModeForClipping(tile)
             : gl::StencilMode::disabled(),
         colorModeForRenderPass(),
         CircleProgram::UniformValues {
@@ -46,7 +45,8 @@ void Painter::renderCircle(PaintParameters& parameters,
                 : pixelsToGLUnits }
         },
         *bucket.vertexBuffer,
-        *bucket.indexBuffer,
+        bucket.instanced ? &quadCornerBuffer : nullptr,
+        bucket.instanced ? tileTriangleIndexBuffer : *bucket.indexBuffer,
         bucket.segments,
         bucket.paintPropertyBinders.at(layer.getID()),
         properties,
@@ -28,7 +28,7 @@ void Painter::renderTileDebug(const RenderTile& renderTile) {
             context,
             drawMode,
             gl::DepthMode::disabled(),
-            stencilModeForClipping(renderTile.clip),
+            stencilModeForClipping(renderTile),
             gl::ColorMode::unblended(),
             DebugProgram::UniformValues {
                 uniforms::u_matrix::Value{ renderTile.matrix },
@@ -129,6 +129,23 @@ void Painter::renderDepthBuffer(PaintParameters&) {
     context.drawPixels(image);
 #endif // MBGL_USE_GLES2
 }
+
+float Painter::measureOverdraw() {
+    const auto viewport = context.viewport.getCurrentValue();
+    const std::size_t pixels = viewport.size.area();
+    if (!pixels) {
+        return 0;
+    }
+
+    const auto image = context.readFramebuffer<PremultipliedImage>(viewport.size, false);
+    uint64_t sum = 0;
+    for (std::size_t i = 0; i < pixels; ++i) {
+        sum += image.data[i * 4];
+    }
+
+    // Each fragment adds an eighth of the full intensity, so counts saturate at 8.
+    return sum / (255.0f / 8.0f) / pixels;
+}
 #endif // NDEBUG
 
 } // namespace mbgl
@@ -1,4 +1,5 @@
 #include <mbgl/renderer/painter.hpp>
+#include <mbgl/map/view.hpp>
 #include <mbgl/renderer/paint_parameters.hpp>
 #include <mbgl/renderer/fill_bucket.hpp>
 #include <mbgl/renderer/render_tile.hpp>
@@ -19,13 +20,27 @@ void Painter::renderFill(PaintParameters& parameters,
                          const RenderTile& tile) {
     const FillPaintProperties::Evaluated& properties = layer.impl->paint.evaluated;
 
+    const mat4 matrix = tile.translatedMatrix(properties.get<FillTranslate>(),
+                                              properties.get<FillTranslateAnchor>(),
+                                              state);
+    // The outlines reach a pixel beyond the vertices.
+    const gl::SegmentFilter filter = segmentFilter(matrix, 1);
+
+    // Outlines without a color of their own only antialias the edges, which multisampling does
+    // already. The bucket may have been laid out without outlines for another view.
+    const bool outlineColor = !layer.impl->paint.unevaluated.get<FillOutlineColor>().isUndefined();
+    const bool antialiasOutlines = properties.get<FillAntialias>() && !outlineColor &&
+        !parameters.view.isMultisampled() && bucket.lineIndexBuffer;
+    const bool colorOutlines = properties.get<FillAntialias>() && outlineColor && bucket.lineIndexBuffer;
+
     if (!properties.get<FillPattern>().from.empty()) {
         if (pass != RenderPass::Translucent) {
             return;
         }
 
-        optional<SpriteAtlasElement> imagePosA = spriteAtlas->getPattern(properties.get<FillPattern>().from);
-        optional<SpriteAtlasElement> imagePosB = spriteAtlas->getPattern(properties.get<FillPattern>().to);
+        const PatternPositions& patterns = getPatternPositions(layer, properties.get<FillPattern>());
+        const optional<SpriteAtlasElement>& imagePosA = patterns.from;
+        const optional<SpriteAtlasElement>& imagePosB = patterns.to;
 
         if (!imagePosA || !imagePosB) {
             return;
@@ -42,12 +57,10 @@ void Painter::renderFill(PaintParameters& parameters,
                 context,
                 drawMode,
                 depthModeForSublayer(sublayer, gl::DepthMode::ReadWrite),
-                stencilModeForClipping(tile.clip),
+                stencilModeForClipping(tile),
                 colorModeForRenderPass(),
                 FillPatternUniforms::values(
-                    tile.translatedMatrix(properties.get<FillTranslate>(),
-                                          properties.get<FillTranslateAnchor>(),
-                                          state),
+                    matrix,
                     context.viewport.getCurrentValue().size,
                     *imagePosA,
                     *imagePosB,
@@ -60,7 +73,8 @@ void Painter::renderFill(PaintParameters& parameters,
                 segments,
                 bucket.paintPropertyBinders.at(layer.getID()),
                 properties,
-                state.getZoom()
+                state.getZoom(),
+                filter
             );
         };
 
@@ -70,7 +84,7 @@ void Painter::renderFill(PaintParameters& parameters,
              *bucket.triangleIndexBuffer,
              bucket.triangleSegments);
 
-        if (!properties.get<FillAntialias>() || !layer.impl->paint.unevaluated.get<FillOutlineColor>().isUndefined()) {
+        if (!antialiasOutlines) {
             return;
         }
 
@@ -89,14 +103,10 @@ void Painter::renderFill(PaintParameters& parameters,
                 context,
                 drawMode,
                 depthModeForSublayer(sublayer, gl::DepthMode::ReadWrite),
-                stencilModeForClipping(tile.clip),
+                stencilModeForClipping(tile),
                 colorModeForRenderPass(),
                 FillProgram::UniformValues {
-                    uniforms::u_matrix::Value{
-                        tile.translatedMatrix(properties.get<FillTranslate>(),
-                                              properties.get<FillTranslateAnchor>(),
-                                              state)
-                    },
+                    uniforms::u_matrix::Value{ matrix },
                     uniforms::u_world::Value{ context.viewport.getCurrentValue().size },
                 },
                 *bucket.vertexBuffer,
@@ -104,11 +114,12 @@ void Painter::renderFill(PaintParameters& parameters,
                 segments,
                 bucket.paintPropertyBinders.at(layer.getID()),
                 properties,
-                state.getZoom()
+                state.getZoom(),
+                filter
             );
         };
 
-        if (properties.get<FillAntialias>() && !layer.impl->paint.unevaluated.get<FillOutlineColor>().isUndefined() && pass == RenderPass::Translucent) {
+        if (colorOutlines && pass == RenderPass::Translucent) {
             draw(2,
                  parameters.programs.fillOutline,
                  gl::Lines { 2.0f },
@@ -127,7 +138,7 @@ void Painter::renderFill(PaintParameters& parameters,
                  bucket.triangleSegments);
         }
 
-        if (properties.get<FillAntialias>() && layer.impl->paint.unevaluated.get<FillOutlineColor>().isUndefined() && pass == RenderPass::Translucent) {
+        if (antialiasOutlines && pass == RenderPass::Translucent) {
             draw(2,
                  parameters.programs.fillOutline,
                  gl::Lines { 2.0f },
@@ -0,0 +1,92 @@
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/renderer/fill_extrusion_bucket.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/map/view.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer_impl.hpp>
+#include <mbgl/programs/programs.hpp>
+#include <mbgl/programs/fill_extrusion_program.hpp>
+#include <mbgl/util/offscreen_texture.hpp>
+#include <mbgl/util/projection.hpp>
+
+namespace mbgl {
+
+using namespace style;
+
+void Painter::renderFillExtrusion(PaintParameters& parameters,
+                                  FillExtrusionBucket& bucket,
+                                  const FillExtrusionLayer& layer,
+                                  const RenderTile& tile) {
+    const FillExtrusionPaintProperties::Evaluated& properties = layer.impl->paint.evaluated;
+
+    // Heights are in meters, and the z axis of the tile matrix is in pixels.
+    mat4 matrix = tile.translatedMatrix(properties.get<FillExtrusionTranslate>(),
+                                        properties.get<FillExtrusionTranslateAnchor>(),
+                                        state);
+    const double metersPerPixel = Projection::getMetersPerPixelAtLatitude(
+        state.getLatLng().latitude(), state.getZoom());
+    matrix::scale(matrix, matrix, 1, 1, 1 / metersPerPixel);
+
+    // The extrusions are drawn with a depth range of their own, into the depth buffer of the
+    // extrusion texture, and aren't clipped, as the stencil masks are in the view's buffer.
+    parameters.programs.fillExtrusion.draw(
+        context,
+        gl::Triangles(),
+        gl::DepthMode { gl::DepthMode::LessEqual, gl::DepthMode::ReadWrite, { 0, 1 } },
+        gl::StencilMode::disabled(),
+        colorModeForRenderPass(),
+        FillExtrusionUniforms::values(matrix, state),
+        *bucket.vertexBuffer,
+        *bucket.indexBuffer,
+        bucket.triangleSegments,
+        bucket.paintPropertyBinders.at(layer.getID()),
+        properties,
+        state.getZoom()
+    );
+}
+
+void Painter::beginExtrusions() {
+    const Size size = context.viewport.getCurrentValue().size;
+    if (!extrusionTexture || extrusionTexture->getSize() != size) {
+        extrusionTexture = std::make_unique<OffscreenTexture>(
+            context, size, OffscreenTextureAttachment::DepthStencil);
+    }
+
+    extrusionTexture->bind();
+    context.clear(Color{ 0.0f, 0.0f, 0.0f, 0.0f }, 1.0f, {});
+}
+
+void Painter::finishExtrusions(PaintParameters& parameters, const FillExtrusionLayer& layer) {
+    parameters.view.bind();
+
+    static const PaintProperties<>::Evaluated properties {};
+    static const ExtrusionTextureProgram::PaintPropertyBinders paintAttributeData(properties, 0);
+
+    mat4 matrix;
+    matrix::ortho(matrix, 0, util::EXTENT, 0, util::EXTENT, 0, 1);
+
+    context.bindTexture(extrusionTexture->getTexture(), 0, gl::TextureFilter::Nearest);
+
+    // Layers above that were drawn in the opaque pass still hide the extrusions.
+    parameters.programs.extrusionTexture.draw(
+        context,
+        gl::Triangles(),
+        depthModeForSublayer(0, gl::DepthMode::ReadOnly),
+        gl::StencilMode::disabled(),
+        colorModeForRenderPass(),
+        ExtrusionTextureProgram::UniformValues {
+            uniforms::u_matrix::Value{ matrix },
+            uniforms::u_image::Value{ 0 },
+            uniforms::u_opacity::Value{ layer.impl->paint.evaluated.get<FillExtrusionOpacity>() }
+        },
+        tileVertexBuffer,
+        tileTriangleIndexBuffer,
+        extrusionTextureSegments,
+        paintAttributeData,
+        properties,
+        state.getZoom()
+    );
+}
+
+} // namespace mbgl
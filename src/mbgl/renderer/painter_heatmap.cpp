@@ -0,0 +1,120 @@
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/renderer/heatmap_bucket.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/map/view.hpp>
+#include <mbgl/style/layers/heatmap_layer.hpp>
+#include <mbgl/style/layers/heatmap_layer_impl.hpp>
+#include <mbgl/programs/programs.hpp>
+#include <mbgl/programs/heatmap_program.hpp>
+#include <mbgl/util/offscreen_texture.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+using namespace style;
+
+// The density is smooth, so it accumulates at a fraction of the viewport's resolution in each
+// dimension, where the kernels of the points cover that fraction squared of the fragments.
+static constexpr uint32_t heatmapTextureScale = 4;
+
+void Painter::renderHeatmap(PaintParameters& parameters,
+                            HeatmapBucket& bucket,
+                            const HeatmapLayer& layer,
+                            const RenderTile& tile) {
+    if (pass == RenderPass::Opaque) {
+        return;
+    }
+
+    const HeatmapPaintProperties::Evaluated& properties = layer.impl->paint.evaluated;
+
+    // The kernels add up, and aren't clipped, as they reach into the neighbouring tiles.
+    parameters.programs.heatmap.draw(
+        context,
+        gl::Triangles(),
+        gl::DepthMode::disabled(),
+        gl::StencilMode::disabled(),
+        gl::ColorMode {
+            gl::ColorMode::Add { gl::ColorMode::One, gl::ColorMode::One },
+            {},
+            { true, true, true, true }
+        },
+        HeatmapProgram::UniformValues {
+            uniforms::u_matrix::Value{ tile.matrix },
+            uniforms::u_extrude_scale::Value{ pixelsToGLUnits },
+            uniforms::u_intensity::Value{ properties.get<HeatmapIntensity>() }
+        },
+        *bucket.vertexBuffer,
+        *bucket.indexBuffer,
+        bucket.segments,
+        bucket.paintPropertyBinders.at(layer.getID()),
+        properties,
+        state.getZoom()
+    );
+}
+
+void Painter::beginHeatmap() {
+    const Size viewportSize = context.viewport.getCurrentValue().size;
+    const Size size {
+        std::max<uint32_t>(1, (viewportSize.width + heatmapTextureScale - 1) / heatmapTextureScale),
+        std::max<uint32_t>(1, (viewportSize.height + heatmapTextureScale - 1) / heatmapTextureScale)
+    };
+    if (!heatmapTexture || heatmapTexture->getSize() != size) {
+        // Half floats keep densities above one, and the faint edges of the kernels, which
+        // eight bits per channel round away.
+        heatmapTexture = std::make_unique<OffscreenTexture>(
+            context, size, OffscreenTextureAttachment::None,
+            context.supportsHalfFloatTextures() ? gl::TextureType::HalfFloat
+                                                : gl::TextureType::UnsignedByte);
+    }
+
+    heatmapTexture->bind();
+    context.clear(Color{ 0.0f, 0.0f, 0.0f, 0.0f }, {}, {});
+}
+
+void Painter::finishHeatmap(PaintParameters& parameters, const HeatmapLayer& layer) {
+    parameters.view.bind();
+
+    static const PaintProperties<>::Evaluated properties {};
+    static const HeatmapTextureProgram::PaintPropertyBinders paintAttributeData(properties, 0);
+
+    // The ramp is uploaded again only when a layer with a different one is drawn.
+    if (!heatmapColorRampTexture) {
+        heatmapColorRampTexture = context.createTexture(*layer.impl->colorRamp, 1);
+        heatmapColorRamp = layer.impl->colorRamp;
+    } else if (heatmapColorRamp != layer.impl->colorRamp) {
+        context.updateTexture(*heatmapColorRampTexture, *layer.impl->colorRamp, 1);
+        heatmapColorRamp = layer.impl->colorRamp;
+    }
+
+    mat4 matrix;
+    matrix::ortho(matrix, 0, util::EXTENT, 0, util::EXTENT, 0, 1);
+
+    // The texture is smaller than the viewport, so it's interpolated as it's sampled.
+    context.bindTexture(heatmapTexture->getTexture(), 0, gl::TextureFilter::Linear);
+    context.bindTexture(*heatmapColorRampTexture, 1, gl::TextureFilter::Linear);
+
+    // Layers above that were drawn in the opaque pass still hide the heatmap.
+    parameters.programs.heatmapTexture.draw(
+        context,
+        gl::Triangles(),
+        depthModeForSublayer(0, gl::DepthMode::ReadOnly),
+        gl::StencilMode::disabled(),
+        colorModeForRenderPass(),
+        HeatmapTextureProgram::UniformValues {
+            uniforms::u_matrix::Value{ matrix },
+            uniforms::u_image::Value{ 0 },
+            uniforms::u_color_ramp::Value{ 1 },
+            uniforms::u_opacity::Value{ layer.impl->paint.evaluated.get<HeatmapOpacity>() }
+        },
+        tileVertexBuffer,
+        tileTriangleIndexBuffer,
+        heatmapTextureSegments,
+        paintAttributeData,
+        properties,
+        state.getZoom()
+    );
+}
+
+} // namespace mbgl
@@ -0,0 +1,107 @@
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/renderer/hillshade_bucket.hpp>
+#include <mbgl/map/view.hpp>
+#include <mbgl/style/layers/hillshade_layer.hpp>
+#include <mbgl/style/layers/hillshade_layer_impl.hpp>
+#include <mbgl/programs/programs.hpp>
+#include <mbgl/programs/hillshade_program.hpp>
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/offscreen_texture.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+using namespace style;
+
+void Painter::prepareHillshade(PaintParameters& parameters,
+                               HillshadeBucket& bucket,
+                               const RenderTile& tile) {
+    assert(bucket.demTexture);
+
+    const Size size { uint32_t(bucket.dem.dim), uint32_t(bucket.dem.dim) };
+    if (!bucket.texture || bucket.texture->getSize() != size) {
+        bucket.texture = std::make_unique<OffscreenTexture>(context, size);
+    }
+    bucket.texture->bind();
+
+    static const PaintProperties<>::Evaluated properties {};
+    static const HillshadePrepareProgram::PaintPropertyBinders paintAttributeData(properties, 0);
+
+    mat4 matrix;
+    matrix::ortho(matrix, 0, util::EXTENT, 0, util::EXTENT, 0, 1);
+
+    // The slopes are computed from neighbouring pixels, which mustn't be blended together.
+    context.bindTexture(*bucket.demTexture, 0, gl::TextureFilter::Nearest);
+
+    parameters.programs.hillshadePrepare.draw(
+        context,
+        gl::Triangles(),
+        gl::DepthMode::disabled(),
+        gl::StencilMode::disabled(),
+        gl::ColorMode::unblended(),
+        HillshadePrepareProgram::UniformValues {
+            uniforms::u_matrix::Value{ matrix },
+            uniforms::u_dimension::Value{ {{ float(bucket.dem.stride), float(bucket.dem.stride) }} },
+            uniforms::u_zoom::Value{ float(tile.id.canonical.z) },
+            uniforms::u_image::Value{ 0 }
+        },
+        rasterVertexBuffer,
+        tileTriangleIndexBuffer,
+        rasterSegments,
+        paintAttributeData,
+        properties,
+        state.getZoom()
+    );
+
+    bucket.setPrepared(true);
+}
+
+void Painter::renderHillshade(PaintParameters& parameters,
+                              HillshadeBucket& bucket,
+                              const HillshadeLayer& layer,
+                              const RenderTile& tile) {
+    if (pass != RenderPass::Translucent)
+        return;
+    if (!bucket.isPrepared())
+        return;
+
+    const HillshadePaintProperties::Evaluated& properties = layer.impl->paint.evaluated;
+    const HillshadeProgram::PaintPropertyBinders paintAttributeData(properties, 0);
+
+    float azimuth = properties.get<HillshadeIlluminationDirection>() * util::DEG2RAD;
+    if (properties.get<HillshadeIlluminationAnchor>() == HillshadeIlluminationAnchorType::Viewport) {
+        azimuth -= state.getAngle();
+    }
+
+    const LatLngBounds bounds(tile.id.canonical);
+
+    context.bindTexture(bucket.texture->getTexture(), 0, gl::TextureFilter::Linear);
+
+    parameters.programs.hillshade.draw(
+        context,
+        gl::Triangles(),
+        depthModeForSublayer(0, gl::DepthMode::ReadOnly),
+        gl::StencilMode::disabled(),
+        colorModeForRenderPass(),
+        HillshadeProgram::UniformValues {
+            uniforms::u_matrix::Value{ tile.matrix },
+            uniforms::u_image::Value{ 0 },
+            uniforms::u_highlight::Value{ properties.get<HillshadeHighlightColor>() },
+            uniforms::u_shadow::Value{ properties.get<HillshadeShadowColor>() },
+            uniforms::u_accent::Value{ properties.get<HillshadeAccentColor>() },
+            uniforms::u_light::Value{ {{ properties.get<HillshadeExaggeration>(), azimuth }} },
+            uniforms::u_latrange::Value{ {{ float(bounds.north()), float(bounds.south()) }} },
+        },
+        rasterVertexBuffer,
+        tileTriangleIndexBuffer,
+        rasterSegments,
+        paintAttributeData,
+        properties,
+        state.getZoom()
+    );
+}
+
+} // namespace mbgl
@@ -0,0 +1,251 @@
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/map/view.hpp>
+#include <mbgl/gl/debugging.hpp>
+#include <mbgl/programs/programs.hpp>
+#include <mbgl/style/layer.hpp>
+#include <mbgl/style/source.hpp>
+#include <mbgl/style/source_impl.hpp>
+#include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/offscreen_texture.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mbgl {
+
+using namespace style;
+
+namespace {
+
+// Fewer layers aren't worth drawing into a texture and compositing.
+const uint32_t minLayerGroupLayers = 4;
+
+// Each group holds a texture larger than the viewport, so only the largest ones are cached.
+const std::size_t maxLayerGroups = 3;
+
+// The textures reach past each edge of the viewport by this fraction of its size, which is how
+// far the map can pan before the groups are drawn again.
+const uint32_t layerGroupMarginDivisor = 4;
+
+// Fills, lines and circles are drawn within the tiles of their sources, the same way wherever
+// the tiles are on the screen. Symbols are placed in the viewport, backgrounds only cover its
+// tiles, rasters and hillshades fade in over time, and extrusions and heatmaps are composited
+// from textures of their own.
+bool isCacheable(const Layer& layer) {
+    return layer.is<FillLayer>() || layer.is<LineLayer>() || layer.is<CircleLayer>();
+}
+
+// Whether two projection matrices only differ in the translation in the plane of the map, which
+// moves what they draw across the viewport without otherwise changing it while there is no pitch.
+bool onlyTranslated(const mat4& a, const mat4& b) {
+    for (std::size_t i = 0; i < a.size(); i++) {
+        if (i != 12 && i != 13 && a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void Painter::updateLayerGroups(PaintParameters& parameters,
+                                const std::vector<RenderItem>& order,
+                                const std::vector<Source*>& sources,
+                                const std::unordered_set<const Bucket*>& uploadedBuckets,
+                                uint32_t layerCount) {
+    layerGroupOfLayer.clear();
+
+    const Size viewportSize = context.viewport.getCurrentValue().size;
+    // The textures aren't multisampled, so the fills of a multisampled view, which have no
+    // outlines to antialias them, would have jagged edges in them.
+    if (!frame.layerCaching ||
+        parameters.view.isMultisampled() ||
+        frame.mapMode != MapMode::Continuous ||
+        frame.debugOptions != MapDebugOptions::NoDebug ||
+        paintMode() != PaintMode::Regular ||
+        state.getPitch() != 0 ||
+        viewportSize.isEmpty()) {
+        layerGroups.clear();
+        return;
+    }
+
+    // Finds the runs of adjacent cacheable layers. Layers are numbered for their depth the way
+    // renderPass() numbers them, from the top.
+    std::vector<LayerGroup> groups;
+    uint32_t layerIndex = layerCount;
+    for (std::size_t i = 0; i < order.size(); i++) {
+        const Layer& layer = order[i].layer;
+        const bool firstOfLayer = i == 0 || &order[i - 1].layer != &layer;
+        if (firstOfLayer) {
+            layerIndex--;
+        }
+        if (!isCacheable(layer)) {
+            continue;
+        }
+
+        if (groups.empty() || groups.back().end != i) {
+            groups.emplace_back();
+            groups.back().layer = &layer;
+            groups.back().begin = i;
+            groups.back().layers = 0;
+        }
+
+        LayerGroup& group = groups.back();
+        group.end = i + 1;
+        if (firstOfLayer) {
+            group.layers++;
+            group.top = layerIndex;
+        }
+        // Items are only drawn once their buckets are uploaded; see renderPass().
+        if (!order[i].bucket->needsUpload()) {
+            group.items.emplace_back(&layer, order[i].bucket);
+        }
+    }
+
+    groups.erase(std::remove_if(groups.begin(), groups.end(), [] (const LayerGroup& group) {
+        return group.layers < minLayerGroupLayers;
+    }), groups.end());
+    if (groups.size() > maxLayerGroups) {
+        std::stable_sort(groups.begin(), groups.end(), [] (const LayerGroup& a, const LayerGroup& b) {
+            return a.items.size() > b.items.size();
+        });
+        groups.erase(groups.begin() + maxLayerGroups, groups.end());
+        std::sort(groups.begin(), groups.end(), [] (const LayerGroup& a, const LayerGroup& b) {
+            return a.begin < b.begin;
+        });
+    }
+
+    const uint32_t marginX = viewportSize.width / layerGroupMarginDivisor;
+    const uint32_t marginY = viewportSize.height / layerGroupMarginDivisor;
+    const Size textureSize { viewportSize.width + 2 * marginX, viewportSize.height + 2 * marginY };
+
+    // A texture is drawn again unless the map only panned, by less than the margin, since it was
+    // drawn. At rest, the texture is only used where it was drawn, as it's interpolated between
+    // pixels elsewhere.
+    const auto outdated = [&] (const LayerGroup& group) {
+        if (!group.drawn || frame.fullRedraw || group.texture->getSize() != textureSize ||
+            !onlyTranslated(group.matrix, projMatrix)) {
+            return true;
+        }
+        for (const auto& item : group.items) {
+            if (uploadedBuckets.count(item.second)) {
+                return true;
+            }
+        }
+        const double dx = (projMatrix[12] - group.matrix[12]) / projMatrix[15] * viewportSize.width / 2;
+        const double dy = (projMatrix[13] - group.matrix[13]) / projMatrix[15] * viewportSize.height / 2;
+        return std::abs(dx) > marginX || std::abs(dy) > marginY ||
+               (!state.isChanging() && (dx != 0 || dy != 0));
+    };
+
+    bool anyOutdated = false;
+    for (LayerGroup& group : groups) {
+        auto previous = std::find_if(layerGroups.begin(), layerGroups.end(), [&] (const LayerGroup& other) {
+            return other.layer == group.layer && other.texture;
+        });
+        if (previous != layerGroups.end()) {
+            group.texture = std::move(previous->texture);
+            group.matrix = previous->matrix;
+            group.drawn = previous->drawn && previous->items == group.items;
+        }
+        group.drawn = group.drawn && !outdated(group);
+        anyOutdated = anyOutdated || !group.drawn;
+    }
+    layerGroups = std::move(groups);
+
+    if (anyOutdated) {
+        // The textures are drawn as the viewport would be if it had their size: a pixel covers as
+        // much of the map, and the viewport's pixels are in the middle of the texture.
+        const mat4 viewProjMatrix = projMatrix;
+        const std::array<float, 2> viewPixelsToGLUnits = pixelsToGLUnits;
+        const optional<gl::value::Scissor::Type> viewRedrawRegion = redrawRegion;
+
+        mat4 scale;
+        matrix::identity(scale);
+        scale[0] = double(viewportSize.width) / textureSize.width;
+        scale[5] = double(viewportSize.height) / textureSize.height;
+        matrix::multiply(projMatrix, scale, projMatrix);
+        pixelsToGLUnits[0] *= scale[0];
+        pixelsToGLUnits[1] *= scale[5];
+        redrawRegion = {};
+        for (const auto& source : sources) {
+            source->baseImpl->startRender(projMatrix, state);
+        }
+
+        for (LayerGroup& group : layerGroups) {
+            if (!group.drawn) {
+                MBGL_DEBUG_GROUP(context, "layer group");
+                renderLayerGroup(parameters, group, order, textureSize);
+                group.matrix = viewProjMatrix;
+                group.drawn = true;
+                frameStats.layerGroupsDrawn++;
+            }
+        }
+
+        projMatrix = viewProjMatrix;
+        pixelsToGLUnits = viewPixelsToGLUnits;
+        redrawRegion = viewRedrawRegion;
+        for (const auto& source : sources) {
+            source->baseImpl->startRender(projMatrix, state);
+        }
+
+        parameters.view.bind();
+        resetScissor();
+    }
+
+    for (const LayerGroup& group : layerGroups) {
+        for (std::size_t i = group.begin; i < group.end; i++) {
+            layerGroupOfLayer.emplace(&order[i].layer, &group);
+        }
+    }
+    frameStats.layerGroups = layerGroups.size();
+}
+
+void Painter::compositeLayerGroup(PaintParameters& parameters, const LayerGroup& group) {
+    static const PaintProperties<>::Evaluated properties {};
+    static const LayerGroupProgram::PaintPropertyBinders paintAttributeData(properties, 0);
+
+    const Size viewportSize = context.viewport.getCurrentValue().size;
+    const Size textureSize = group.texture->getSize();
+    const double scaleX = double(textureSize.width) / viewportSize.width;
+    const double scaleY = double(textureSize.height) / viewportSize.height;
+
+    // Without pitch, the map is parallel to the viewport, so a pan moves all of it by the same
+    // distance in clip coordinates, and all of it is at the same depth.
+    mat4 matrix;
+    matrix::identity(matrix);
+    matrix[0] = 2 * scaleX / util::EXTENT;
+    matrix[5] = 2 * scaleY / util::EXTENT;
+    matrix[10] = 0;
+    matrix[12] = (projMatrix[12] - group.matrix[12]) / projMatrix[15] - scaleX;
+    matrix[13] = (projMatrix[13] - group.matrix[13]) / projMatrix[15] - scaleY;
+    matrix[14] = projMatrix[14] / projMatrix[15];
+
+    context.bindTexture(group.texture->getTexture(), 0, gl::TextureFilter::Linear);
+
+    // Layers above that were drawn in the opaque pass still hide the group.
+    currentLayer = group.top;
+    parameters.programs.layerGroup.draw(
+        context,
+        gl::Triangles(),
+        depthModeForSublayer(0, gl::DepthMode::ReadOnly),
+        gl::StencilMode::disabled(),
+        colorModeForRenderPass(),
+        LayerGroupProgram::UniformValues {
+            uniforms::u_matrix::Value{ matrix },
+            uniforms::u_image::Value{ 0 }
+        },
+        tileVertexBuffer,
+        tileTriangleIndexBuffer,
+        layerGroupSegments,
+        paintAttributeData,
+        properties,
+        state.getZoom()
+    );
+}
+
+} // namespace mbgl
@@ -9,6 +9,8 @@
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/geometry/line_atlas.hpp>
 
+#include <cmath>
+
 namespace mbgl {
 
 using namespace style;
@@ -23,12 +25,27 @@ void Painter::renderLine(PaintParameters& parameters,
 
     const LinePaintProperties::Evaluated& properties = layer.impl->paint.evaluated;
 
+    // Lines reach beyond their vertices by half their width, their offset and their blur, which
+    // are only known here where they don't vary by feature.
+    gl::SegmentFilter filter;
+    const optional<float> gapWidth = properties.get<LineGapWidth>().constant();
+    const optional<float> offset = properties.get<LineOffset>().constant();
+    const optional<float> blur = properties.get<LineBlur>().constant();
+    if (gapWidth && offset && blur) {
+        const float lineWidth = properties.get<LineWidth>();
+        const float width = *gapWidth > 0 ? *gapWidth + 2 * lineWidth : lineWidth;
+        filter = segmentFilter(tile.translatedMatrix(properties.get<LineTranslate>(),
+                                                     properties.get<LineTranslateAnchor>(),
+                                                     state),
+                               width / 2 + std::abs(*offset) + *blur + 1);
+    }
+
     auto draw = [&] (auto& program, auto&& uniformValues) {
         program.draw(
             context,
             gl::Triangles(),
             depthModeForSublayer(0, gl::DepthMode::ReadOnly),
-            stencilModeForClipping(tile.clip),
+            stencilModeForClipping(tile),
             colorModeForRenderPass(),
             std::move(uniformValues),
             *bucket.vertexBuffer,
@@ -36,7 +53,8 @@ void Painter::renderLine(PaintParameters& parameters,
             bucket.segments,
             bucket.paintPropertyBinders.at(layer.getID()),
             properties,
-            state.getZoom()
+            state.getZoom(),
+            filter
         );
     };
 
@@ -46,6 +64,9 @@ void Painter::renderLine(PaintParameters& parameters,
         LinePatternPos posA = lineAtlas->getDashPosition(properties.get<LineDasharray>().from, cap);
         LinePatternPos posB = lineAtlas->getDashPosition(properties.get<LineDasharray>().to, cap);
 
+        // Adding the second pattern may have grown the atlas, which moves the first one.
+        posA = lineAtlas->getDashPosition(properties.get<LineDasharray>().from, cap);
+
         lineAtlas->bind(context, 0);
 
         draw(parameters.programs.lineSDF,
@@ -61,8 +82,9 @@ void Painter::renderLine(PaintParameters& parameters,
                  lineAtlas->getSize().width));
 
     } else if (!properties.get<LinePattern>().from.empty()) {
-        optional<SpriteAtlasElement> posA = spriteAtlas->getPattern(properties.get<LinePattern>().from);
-        optional<SpriteAtlasElement> posB = spriteAtlas->getPattern(properties.get<LinePattern>().to);
+        const PatternPositions& patterns = getPatternPositions(layer, properties.get<LinePattern>());
+        const optional<SpriteAtlasElement>& posA = patterns.from;
+        const optional<SpriteAtlasElement>& posB = patterns.to;
 
         if (!posA || !posB)
             return;
@@ -0,0 +1,127 @@
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/tile/tile.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/fill_layer_impl.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/programs/fill_pick_program.hpp>
+#include <mbgl/map/query.hpp>
+#include <mbgl/map/view.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/debugging.hpp>
+#include <mbgl/util/offscreen_texture.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+using namespace style;
+
+// The alpha channel numbers the draws, zero standing for none.
+static constexpr std::size_t maxPickingDraws = 255;
+
+void Painter::renderPicking(const Style& style, View& view) {
+    MBGL_DEBUG_GROUP(context, "picking");
+
+    if (!fillPickProgram) {
+        fillPickProgram = std::make_unique<FillPickProgram>(
+            context, ProgramParameters{ frame.pixelRatio, false, programCacheDir });
+    }
+
+    // The buffer has a pixel per logical pixel of the map, which is as precise as the points
+    // that are picked.
+    const Size size = state.getSize();
+    if (!pickingTexture || pickingTexture->getSize() != size) {
+        pickingTexture = std::make_unique<OffscreenTexture>(context, size);
+    }
+
+    pickingDraws.clear();
+    pickingValid = true;
+
+    pickingTexture->bind();
+    context.clear(Color { 0.0f, 0.0f, 0.0f, 0.0f }, {}, {});
+
+    // Draws the fills bottom to top, like the translucent pass, so that the pixels end up with
+    // the features that are rendered on top. The tiles aren't clipped, so a feature in the buffer
+    // of a tile may cover that of an adjacent one; both are rendered there.
+    const RenderData renderData = style.getRenderData(frame.debugOptions, state.getAngle());
+    for (const auto& item : renderData.order) {
+        const FillLayer* layer = item.layer.as<FillLayer>();
+        if (!layer || !item.bucket) {
+            continue;
+        }
+
+        auto& bucket = static_cast<FillBucket&>(*item.bucket);
+        std::shared_ptr<const GeometryTileData> data = item.tile->tile.getSharedData();
+        if (bucket.needsUpload() || !bucket.pickVertexBuffer || !data ||
+            pickingDraws.size() == maxPickingDraws) {
+            pickingValid = false;
+            break;
+        }
+
+        pickingDraws.push_back({ layer, std::move(data), item.tile->id.canonical });
+
+        const FillPaintProperties::Evaluated& properties = layer->impl->paint.evaluated;
+        fillPickProgram->draw(
+            context,
+            gl::DepthMode::disabled(),
+            gl::StencilMode::disabled(),
+            gl::ColorMode::unblended(),
+            FillPickProgram::UniformValues {
+                uniforms::u_matrix::Value{
+                    item.tile->translatedMatrix(properties.get<FillTranslate>(),
+                                                properties.get<FillTranslateAnchor>(),
+                                                state)
+                },
+                uniforms::u_pick_draw::Value{ float(pickingDraws.size()) }
+            },
+            *bucket.vertexBuffer,
+            *bucket.pickVertexBuffer,
+            *bucket.triangleIndexBuffer,
+            bucket.pickSegments
+        );
+    }
+
+    if (!pickingValid) {
+        pickingDraws.clear();
+    }
+
+    context.vertexArrayObject = 0;
+    view.bind();
+}
+
+bool Painter::pickFeature(const ScreenCoordinate& point, optional<RenderedFeatureHandle>& result) {
+    if (!pickingValid) {
+        return false;
+    }
+
+    const Size size = pickingTexture->getSize();
+    if (point.x < 0 || point.y < 0 || point.x >= size.width || point.y >= size.height) {
+        return false;
+    }
+
+    const auto previousFramebuffer = context.bindFramebuffer.getCurrentValue();
+    pickingTexture->bind();
+    const std::array<uint8_t, 4> pixel = context.readPixel(
+        static_cast<uint32_t>(point.x), size.height - 1 - static_cast<uint32_t>(point.y));
+    context.bindFramebuffer = previousFramebuffer;
+
+    result = {};
+    if (pixel[3] == 0) {
+        return true;
+    }
+
+    const std::size_t index = (pixel[0] | (pixel[1] << 8) | (pixel[2] << 16)) - 1;
+    assert(pixel[3] <= pickingDraws.size());
+    const PickingDraw& draw = pickingDraws[pixel[3] - 1];
+    const GeometryTileLayer* sourceLayer = draw.data->getLayer(draw.layer->baseImpl->sourceLayer);
+    if (!sourceLayer || index >= sourceLayer->featureCount()) {
+        return false;
+    }
+
+    result.emplace(*draw.layer, draw.data, *sourceLayer, index, draw.tileID);
+    return true;
+}
+
+} // namespace mbgl
@@ -0,0 +1,94 @@
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/style/layers/background_layer.hpp>
+#include <mbgl/style/layers/background_layer_impl.hpp>
+#include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/circle_layer_impl.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer_impl.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/fill_layer_impl.hpp>
+#include <mbgl/style/layers/heatmap_layer.hpp>
+#include <mbgl/style/layers/heatmap_layer_impl.hpp>
+#include <mbgl/style/layers/hillshade_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/style/layers/line_layer_impl.hpp>
+#include <mbgl/style/layers/raster_layer.hpp>
+#include <mbgl/style/layers/raster_layer_impl.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/style/layers/symbol_layer_impl.hpp>
+#include <mbgl/programs/programs.hpp>
+
+namespace mbgl {
+
+using namespace style;
+
+void Painter::preparePrograms(const Style& style) {
+    // Getting a program variant creates it if it doesn't exist yet, which starts compiling it.
+    // The draws that use it only wait for it if it hasn't been linked by then.
+    Programs& target = *programs;
+
+    for (const Layer* layer : style.getLayers()) {
+        if (const BackgroundLayer* background = layer->as<BackgroundLayer>()) {
+            // Backgrounds are drawn with constant fill properties; see renderBackground().
+            const auto variant = FillProgram::PaintPropertyBinders::Variant().set();
+            if (background->impl->paint.evaluated.get<BackgroundPattern>().to.empty()) {
+                target.fill.get(context, variant);
+            } else {
+                target.fillPattern.get(context, variant);
+            }
+        } else if (const FillLayer* fill = layer->as<FillLayer>()) {
+            const FillPaintProperties::Evaluated& properties = fill->impl->paint.evaluated;
+            const auto variant = FillProgram::PaintPropertyBinders::variant(properties);
+            if (properties.get<FillPattern>().from.empty()) {
+                target.fill.get(context, variant);
+                if (properties.get<FillAntialias>()) {
+                    target.fillOutline.get(context, variant);
+                }
+            } else {
+                target.fillPattern.get(context, variant);
+                if (properties.get<FillAntialias>()) {
+                    target.fillOutlinePattern.get(context, variant);
+                }
+            }
+        } else if (const FillExtrusionLayer* extrusion = layer->as<FillExtrusionLayer>()) {
+            target.fillExtrusion.get(context,
+                FillExtrusionProgram::PaintPropertyBinders::variant(extrusion->impl->paint.evaluated));
+            target.extrusionTexture.get(context);
+        } else if (const LineLayer* line = layer->as<LineLayer>()) {
+            const LinePaintProperties::Evaluated& properties = line->impl->paint.evaluated;
+            const auto variant = LineProgram::PaintPropertyBinders::variant(properties);
+            if (!properties.get<LineDasharray>().from.empty()) {
+                target.lineSDF.get(context, variant);
+            } else if (!properties.get<LinePattern>().from.empty()) {
+                target.linePattern.get(context, variant);
+            } else {
+                target.line.get(context, variant);
+            }
+        } else if (const CircleLayer* circle = layer->as<CircleLayer>()) {
+            target.circle.get(context,
+                CircleProgram::PaintPropertyBinders::variant(circle->impl->paint.evaluated));
+        } else if (const HeatmapLayer* heatmap = layer->as<HeatmapLayer>()) {
+            target.heatmap.get(context,
+                HeatmapProgram::PaintPropertyBinders::variant(heatmap->impl->paint.evaluated));
+            target.heatmapTexture.get(context);
+        } else if (const SymbolLayer* symbol = layer->as<SymbolLayer>()) {
+            // Whether icons are drawn as SDFs depends on their images, which aren't known yet.
+            if (!symbol->getIconImage().isUndefined()) {
+                target.symbolIcon.get(context,
+                    SymbolIconProgram::PaintPropertyBinders::variant(symbol->impl->iconPaintProperties()));
+            }
+            if (!symbol->getTextField().isUndefined()) {
+                target.symbolGlyph.get(context,
+                    SymbolSDFTextProgram::PaintPropertyBinders::variant(symbol->impl->textPaintProperties()));
+            }
+        } else if (layer->is<RasterLayer>()) {
+            target.raster.get(context);
+        } else if (layer->is<HillshadeLayer>()) {
+            target.hillshade.get(context);
+            target.hillshadePrepare.get(context);
+        }
+    }
+}
+
+} // namespace mbgl
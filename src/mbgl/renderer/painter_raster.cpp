@@ -52,8 +52,9 @@ void Painter::renderRaster(PaintParameters& parameters,
     const RasterProgram::PaintPropertyBinders paintAttributeData(properties, 0);
 
     assert(bucket.texture);
-    context.bindTexture(*bucket.texture, 0, gl::TextureFilter::Linear);
-    context.bindTexture(*bucket.texture, 1, gl::TextureFilter::Linear);
+    const auto mipmap = bucket.texture->mipmapped ? gl::TextureMipMap::Yes : gl::TextureMipMap::No;
+    context.bindTexture(*bucket.texture, 0, gl::TextureFilter::Linear, mipmap);
+    context.bindTexture(*bucket.texture, 1, gl::TextureFilter::Linear, mipmap);
 
     parameters.programs.raster.draw(
         context,
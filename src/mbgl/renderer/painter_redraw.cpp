@@ -0,0 +1,188 @@
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/annotation/symbol_annotation_instances.hpp>
+#include <mbgl/map/view.hpp>
+#include <mbgl/style/layer.hpp>
+#include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/custom_layer.hpp>
+#include <mbgl/style/layers/fill_extrusion_layer.hpp>
+#include <mbgl/style/layers/heatmap_layer.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/util/projection.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mbgl {
+
+using namespace style;
+
+namespace {
+
+using Region = gl::value::Scissor::Type;
+
+bool isEmpty(const Region& region) {
+    return region.size.width == 0 || region.size.height == 0;
+}
+
+Region unite(const Region& a, const Region& b) {
+    if (isEmpty(a)) {
+        return b;
+    }
+    if (isEmpty(b)) {
+        return a;
+    }
+    const int32_t x0 = std::min(a.x, b.x);
+    const int32_t y0 = std::min(a.y, b.y);
+    const int32_t x1 = std::max<int32_t>(a.x + a.size.width, b.x + b.size.width);
+    const int32_t y1 = std::max<int32_t>(a.y + a.size.height, b.y + b.size.height);
+    return { x0, y0, { static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0) } };
+}
+
+Region intersect(const Region& a, const Region& b) {
+    const int32_t x0 = std::max(a.x, b.x);
+    const int32_t y0 = std::max(a.y, b.y);
+    const int32_t x1 = std::min<int32_t>(a.x + a.size.width, b.x + b.size.width);
+    const int32_t y1 = std::min<int32_t>(a.y + a.size.height, b.y + b.size.height);
+    if (x1 <= x0 || y1 <= y0) {
+        return { x0, y0, { 0, 0 } };
+    }
+    return { x0, y0, { static_cast<uint32_t>(x1 - x0), static_cast<uint32_t>(y1 - y0) } };
+}
+
+// Circles and symbols aren't clipped to their tiles, and may reach into the neighbouring ones.
+int32_t marginForLayer(const Layer& layer) {
+    return layer.is<CircleLayer>() || layer.is<SymbolLayer>() ? util::EXTENT : 0;
+}
+
+} // namespace
+
+void Painter::updateRedrawRegion(const std::vector<RenderItem>& order,
+                                 const View& view,
+                                 const std::unordered_set<const Bucket*>& uploadedBuckets,
+                                 bool fading,
+                                 SymbolAnnotationInstances& instances) {
+    const auto current = context.viewport.getCurrentValue();
+    const Region viewport = { current.x, current.y, current.size };
+
+    // Taken in every frame, so that the changes of frames drawn in full aren't drawn again later.
+    // Instances that are cleared when annotations stop being drawn as instances leave changes
+    // behind too.
+    const SymbolAnnotationInstances::Changes instanceChanges = instances.takeChanges();
+
+    bool fullRedraw = instanceChanges.all ||
+                      !view.preservesContents() ||
+                      frame.mapMode != MapMode::Continuous ||
+                      frame.fullRedraw ||
+                      frame.contextMode == GLContextMode::Shared ||
+                      frame.debugOptions != MapDebugOptions::NoDebug ||
+                      drawnDebugOptions != frame.debugOptions ||
+                      drawnView != &view ||
+                      drawnSize != viewport.size ||
+                      drawnMatrix != projMatrix;
+
+    // Items are only drawn once their buckets are uploaded; see renderPass().
+    std::map<std::pair<const Layer*, const Bucket*>, UnwrappedTileID> items;
+    for (const auto& item : order) {
+        if (item.layer.is<CustomLayer>()) {
+            fullRedraw = true;
+        }
+        if (item.tile && item.bucket && !item.bucket->needsUpload()) {
+            items.emplace(std::make_pair(&item.layer, item.bucket), item.tile->id);
+        }
+    }
+
+    Region region = { viewport.x, viewport.y, { 0, 0 } };
+    const auto add = [&] (const Layer& layer, const UnwrappedTileID& tileID) {
+        // Extrusions rise above their tiles, as far as the camera's pitch and position make them.
+        // The color of a heatmap depends on all of the kernels that reach a pixel, and its
+        // density is drawn at a lower resolution, so it's colored again in full.
+        if (layer.is<FillExtrusionLayer>() || layer.is<HeatmapLayer>()) {
+            fullRedraw = true;
+        }
+        region = unite(region, viewportRegion(matrixForTile(tileID), marginForLayer(layer)));
+    };
+
+    if (!fullRedraw) {
+        for (const auto& item : items) {
+            const Layer& layer = *item.first.first;
+            if (drawnItems.find(item.first) == drawnItems.end() ||
+                uploadedBuckets.count(item.first.second) ||
+                (fading && layer.is<SymbolLayer>())) {
+                add(layer, item.second);
+            }
+        }
+        for (const auto& item : drawnItems) {
+            if (items.find(item.first) == items.end()) {
+                add(*item.first.first, item.second);
+            }
+        }
+
+        // The icons are drawn above all layers, in the world copies that the viewport shows, and
+        // reach half their size past their positions; see renderSymbolInstances().
+        const double worldSize = Projection::worldSize(state.zoomScale(state.getZoom()));
+        const double centerWrap = std::floor(Projection::project(state.getLatLng(), 1).x / util::tileSize);
+        const double pixelRatio = state.getSize().width ? double(viewport.size.width) / state.getSize().width : 1;
+        const int32_t halfSize = std::ceil(instanceChanges.maxIconSize / 2 * pixelRatio);
+        for (const auto& position : instanceChanges.positions) {
+            for (double wrap = centerWrap - 1; wrap <= centerWrap + 1; wrap++) {
+                vec4 point = {{ (position.x / 4294967296.0 + wrap) * worldSize,
+                                position.y / 4294967296.0 * worldSize, 0, 1 }};
+                matrix::transformMat4(point, point, projMatrix);
+                if (point[3] <= 0) {
+                    // Behind the camera, where the icon can't be told to be off-screen.
+                    fullRedraw = true;
+                    continue;
+                }
+                const int32_t x = viewport.x + static_cast<int32_t>(std::round((point[0] / point[3] + 1) / 2 * viewport.size.width));
+                const int32_t y = viewport.y + static_cast<int32_t>(std::round((point[1] / point[3] + 1) / 2 * viewport.size.height));
+                const Region icon = intersect({ x - halfSize, y - halfSize,
+                    { static_cast<uint32_t>(2 * halfSize), static_cast<uint32_t>(2 * halfSize) } }, viewport);
+                if (!isEmpty(icon)) {
+                    region = unite(region, icon);
+                }
+            }
+        }
+
+        // Antialiased edges reach half a pixel past the geometry.
+        if (!isEmpty(region)) {
+            region.x -= 1;
+            region.y -= 1;
+            region.size.width += 2;
+            region.size.height += 2;
+        }
+        region = intersect(region, viewport);
+
+        // Beyond this, the scissor test saves little over drawing everything.
+        const uint64_t area = uint64_t(region.size.width) * region.size.height;
+        fullRedraw = fullRedraw || area * 2 > uint64_t(viewport.size.width) * viewport.size.height;
+    }
+
+    if (fullRedraw) {
+        redrawRegion = {};
+        frameStats.redrawnArea = 1;
+    } else {
+        redrawRegion = region;
+        frameStats.redrawnArea = isEmpty(viewport) ? 0 :
+            float(region.size.width) * region.size.height / viewport.size.width / viewport.size.height;
+    }
+
+    drawnView = &view;
+    drawnMatrix = projMatrix;
+    drawnSize = viewport.size;
+    drawnDebugOptions = frame.debugOptions;
+    drawnItems = std::move(items);
+}
+
+void Painter::resetScissor() {
+    if (redrawRegion) {
+        context.scissorTest = true;
+        context.scissor = *redrawRegion;
+    } else {
+        context.scissorTest = false;
+    }
+}
+
+} // namespace mbgl
@@ -21,7 +21,8 @@ using namespace style;
 void Painter::renderSymbol(PaintParameters& parameters,
                            SymbolBucket& bucket,
                            const SymbolLayer& layer,
-                           const RenderTile& tile) {
+                           const RenderTile& tile,
+                           SymbolPart part) {
     if (pass == RenderPass::Opaque) {
         return;
     }
@@ -30,6 +31,15 @@ void Painter::renderSymbol(PaintParameters& parameters,
 
     frameHistory.bind(context, 1);
 
+    // At lower qualities, SDF halos are drawn in the pass of their fills, if they have any.
+    const bool singlePassHalos = frame.quality >= RenderQuality::SinglePassHalos;
+    auto sdfPart = [&] (const SymbolPropertyValues& values_, bool halo) {
+        if (singlePassHalos && values_.hasHalo && values_.hasFill) {
+            return halo ? optional<SymbolSDFPart>() : optional<SymbolSDFPart>(SymbolSDFPart::HaloAndFill);
+        }
+        return optional<SymbolSDFPart>(halo ? SymbolSDFPart::Halo : SymbolSDFPart::Fill);
+    };
+
     auto draw = [&] (auto& program,
                      auto&& uniformValues,
                      const auto& buffers,
@@ -48,14 +58,16 @@ void Painter::renderSymbol(PaintParameters& parameters,
                 ? depthModeForSublayer(0, gl::DepthMode::ReadOnly)
                 : gl::DepthMode::disabled(),
             needsClipping
-                ? stencilModeForClipping(tile.clip)
+                ? stencilModeForClipping(tile)
                 : gl::StencilMode::disabled(),
             colorModeForRenderPass(),
             std::move(uniformValues),
-            *buffers.vertexBuffer,
+            buffers.instanceBuffer ? &*buffers.instanceBuffer : nullptr,
+            quadCornerBuffer,
+            buffers.vertexBuffer ? &*buffers.vertexBuffer : nullptr,
             *symbolSizeBinder,
             values_.layoutSize,
-            *buffers.indexBuffer,
+            buffers.instanceBuffer ? tileTriangleIndexBuffer : *buffers.indexBuffer,
             buffers.segments,
             binders,
             paintProperties,
@@ -63,10 +75,25 @@ void Painter::renderSymbol(PaintParameters& parameters,
         );
     };
 
-    if (bucket.hasIconData()) {
+    if (part == SymbolPart::IconHalo || part == SymbolPart::IconFill) {
+        if (!bucket.hasIconData()) {
+            return;
+        }
+
         auto values = layer.impl->iconPropertyValues(layout);
         auto paintPropertyValues = layer.impl->iconPaintProperties();
 
+        if (part == SymbolPart::IconHalo && !(bucket.sdfIcons && values.hasHalo)) {
+            return;
+        }
+        if (part == SymbolPart::IconFill && bucket.sdfIcons && !values.hasFill) {
+            return;
+        }
+        const optional<SymbolSDFPart> iconPart = sdfPart(values, part == SymbolPart::IconHalo);
+        if (bucket.sdfIcons && !iconPart) {
+            return;
+        }
+
         SpriteAtlas& atlas = *layer.impl->spriteAtlas;
         const bool iconScaled = layout.get<IconSize>().constantOr(1.0) != 1.0 ||
             frame.pixelRatio != atlas.getPixelRatio() ||
@@ -77,25 +104,13 @@ void Painter::renderSymbol(PaintParameters& parameters,
         const Size texsize = atlas.getSize();
 
         if (bucket.sdfIcons) {
-            if (values.hasHalo) {
-                draw(parameters.programs.symbolIconSDF,
-                     SymbolSDFIconProgram::uniformValues(false, values, texsize, pixelsToGLUnits, tile, state, SymbolSDFPart::Halo),
-                     bucket.icon,
-                     bucket.iconSizeBinder,
-                     values,
-                     bucket.paintPropertyBinders.at(layer.getID()).first,
-                     paintPropertyValues);
-            }
-
-            if (values.hasFill) {
-                draw(parameters.programs.symbolIconSDF,
-                     SymbolSDFIconProgram::uniformValues(false, values, texsize, pixelsToGLUnits, tile, state, SymbolSDFPart::Fill),
-                     bucket.icon,
-                     bucket.iconSizeBinder,
-                     values,
-                     bucket.paintPropertyBinders.at(layer.getID()).first,
-                     paintPropertyValues);
-            }
+            draw(parameters.programs.symbolIconSDF,
+                 SymbolSDFIconProgram::uniformValues(false, values, texsize, pixelsToGLUnits, tile, state, *iconPart),
+                 bucket.icon,
+                 bucket.iconSizeBinder,
+                 values,
+                 bucket.paintPropertyBinders.at(layer.getID()).first,
+                 paintPropertyValues);
         } else {
             draw(parameters.programs.symbolIcon,
                  SymbolIconProgram::uniformValues(false, values, texsize, pixelsToGLUnits, tile, state),
@@ -107,36 +122,37 @@ void Painter::renderSymbol(PaintParameters& parameters,
         }
     }
 
-    if (bucket.hasTextData()) {
-        glyphAtlas->bind(context, 0);
+    if (part == SymbolPart::TextHalo || part == SymbolPart::TextFill) {
+        if (!bucket.hasTextData()) {
+            return;
+        }
 
         auto values = layer.impl->textPropertyValues(layout);
         auto paintPropertyValues = layer.impl->textPaintProperties();
 
-        const Size texsize = glyphAtlas->getSize();
-
-        if (values.hasHalo) {
-            draw(parameters.programs.symbolGlyph,
-                 SymbolSDFTextProgram::uniformValues(true, values, texsize, pixelsToGLUnits, tile, state, SymbolSDFPart::Halo),
-                 bucket.text,
-                 bucket.textSizeBinder,
-                 values,
-                 bucket.paintPropertyBinders.at(layer.getID()).second,
-                 paintPropertyValues);
+        if (!(part == SymbolPart::TextHalo ? values.hasHalo : values.hasFill)) {
+            return;
         }
-
-        if (values.hasFill) {
-            draw(parameters.programs.symbolGlyph,
-                 SymbolSDFTextProgram::uniformValues(true, values, texsize, pixelsToGLUnits, tile, state, SymbolSDFPart::Fill),
-                 bucket.text,
-                 bucket.textSizeBinder,
-                 values,
-                 bucket.paintPropertyBinders.at(layer.getID()).second,
-                 paintPropertyValues);
+        const optional<SymbolSDFPart> textPart = sdfPart(values, part == SymbolPart::TextHalo);
+        if (!textPart) {
+            return;
         }
+
+        glyphAtlas->bind(context, 0);
+
+        const Size texsize = glyphAtlas->getSize();
+
+        draw(parameters.programs.symbolGlyph,
+             SymbolSDFTextProgram::uniformValues(true, values, texsize, pixelsToGLUnits, tile, state, *textPart),
+             bucket.text,
+             bucket.textSizeBinder,
+             values,
+             bucket.paintPropertyBinders.at(layer.getID()).second,
+             paintPropertyValues);
     }
 
-    if (bucket.hasCollisionBoxData()) {
+    if (part == SymbolPart::CollisionBox && bucket.hasCollisionBoxData() &&
+        frame.quality < RenderQuality::NoCollisionDebug) {
         static const style::PaintProperties<>::Evaluated properties {};
         static const CollisionBoxProgram::PaintPropertyBinders paintAttributeData(properties, 0);
 
@@ -3,6 +3,9 @@
 #include <mbgl/programs/raster_program.hpp>
 #include <mbgl/renderer/painter.hpp>
 #include <mbgl/gl/context.hpp>
+#include <mbgl/util/logging.hpp>
+
+#include <cassert>
 
 namespace mbgl {
 
@@ -11,11 +14,37 @@ using namespace style;
 RasterBucket::RasterBucket(UnassociatedImage&& image_) : image(std::move(image_)) {
 }
 
+RasterBucket::RasterBucket(CompressedImage&& compressedImage_)
+    : compressedImage(std::move(compressedImage_)) {
+}
+
 void RasterBucket::upload(gl::Context& context) {
-    texture = context.createTexture(std::move(image));
+    if (!compressedImage.data) {
+        texture = context.createTexture(image);
+        textureBytes = image.bytes();
+        // Tiles are minified while zooming out until their parents load, and alias without
+        // the smaller levels, which add up to a third of the base level.
+        if (context.supportsMipmaps(image.size)) {
+            context.generateMipmap(*texture);
+            textureBytes += image.bytes() / 3;
+        }
+    } else if (context.supportsCompressedTextureFormat(compressedImage.format)) {
+        texture = context.createTexture(compressedImage);
+        textureBytes = compressedImage.bytes;
+    } else {
+        // There is no software decoder for GPU formats; the tile stays empty.
+        Log::Warning(Event::OpenGL, "Raster tile is compressed in unsupported texture format 0x%x",
+                     compressedImage.format);
+    }
     uploaded = true;
 }
 
+void RasterBucket::releaseData() {
+    assert(uploaded);
+    image = {};
+    compressedImage = {};
+}
+
 void RasterBucket::render(Painter& painter,
                           PaintParameters& parameters,
                           const Layer& layer,
@@ -24,7 +53,16 @@ void RasterBucket::render(Painter& painter,
 }
 
 bool RasterBucket::hasData() const {
-    return true;
+    // Compressed images that the context can't sample don't get a texture.
+    return !uploaded || texture;
+}
+
+std::size_t RasterBucket::getByteSize() const {
+    return image.bytes() + compressedImage.bytes + getBufferByteSize();
+}
+
+std::size_t RasterBucket::getBufferByteSize() const {
+    return texture ? textureBytes : 0;
 }
 
 } // namespace mbgl
@@ -2,6 +2,7 @@
 
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/compressed_image.hpp>
 #include <mbgl/util/optional.hpp>
 #include <mbgl/gl/texture.hpp>
 
@@ -10,13 +11,20 @@ namespace mbgl {
 class RasterBucket : public Bucket {
 public:
     RasterBucket(UnassociatedImage&&);
+    RasterBucket(CompressedImage&&);
 
     void upload(gl::Context&) override;
+    void releaseData() override;
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
     bool hasData() const override;
+    std::size_t getByteSize() const override;
+    std::size_t getBufferByteSize() const override;
 
     UnassociatedImage image;
+    // Replaces the image for tiles that are compressed in a format that GPUs sample directly.
+    CompressedImage compressedImage;
     optional<gl::Texture> texture;
+    std::size_t textureBytes = 0;
 };
 
 } // namespace mbgl
@@ -2,7 +2,6 @@
 
 #include <mbgl/util/color.hpp>
 
-#include <unordered_set>
 #include <vector>
 
 namespace mbgl {
@@ -31,7 +30,7 @@ public:
 class RenderData {
 public:
     Color backgroundColor;
-    std::unordered_set<style::Source*> sources;
+    std::vector<style::Source*> sources;
     std::vector<RenderItem> order;
 };
 
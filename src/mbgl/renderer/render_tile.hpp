@@ -6,11 +6,13 @@
 #include <mbgl/style/types.hpp>
 
 #include <array>
+#include <vector>
 
 namespace mbgl {
 
 class Tile;
 class TransformState;
+class Bucket;
 
 class RenderTile {
 public:
@@ -26,6 +28,12 @@ public:
     mat4 matrix;
     bool used = false;
 
+    // The tile's bucket for each of the style's layers, by their index, as Style::getRenderData
+    // last looked them up. They are looked up again once the generation differs from the
+    // style's, which changes with its layers, or is reset as the tile changes.
+    std::vector<Bucket*> buckets;
+    uint64_t bucketsGeneration = 0;
+
     mat4 translatedMatrix(const std::array<float, 2>& translate,
                           style::TranslateAnchorType anchor,
                           const TransformState&) const;
@@ -4,10 +4,95 @@
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
 namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+// Quads drawn from the vertices of their corners are indexed with 16 bits.
+const std::size_t maxQuadsPerSegment = std::numeric_limits<uint16_t>::max() / 4;
+
+// Returns the vertices of the corners of the quads of a buffer.
+template <class Buffer>
+gl::VertexVector<SymbolLayoutVertex> cornerVertices(const Buffer& buffer) {
+    gl::VertexVector<SymbolLayoutVertex> vertices;
+    for (std::size_t i = 0; i < buffer.vertices.vertexSize(); i++) {
+        for (const auto& vertex : SymbolInstanceAttributes::corners(buffer.vertices.data()[i])) {
+            vertices.emplace_back(vertex);
+        }
+    }
+    return vertices;
+}
+
+// Replaces the segments of a buffer with those that draw its quads as instances, or from the
+// vertices of their corners.
+template <class Buffer>
+void addSegments(Buffer& buffer, bool instanced) {
+    const std::size_t quads = buffer.vertices.vertexSize();
+    buffer.segments.clear();
+    if (quads == 0) {
+        return;
+    }
+
+    if (instanced) {
+        buffer.segments.emplace_back(0, 0, 4, 6);
+        return;
+    }
+
+    for (std::size_t first = 0; first < quads; first += maxQuadsPerSegment) {
+        const std::size_t count = std::min(quads - first, maxQuadsPerSegment);
+        buffer.segments.emplace_back(first * 4, first * 6, count * 4, count * 6);
+    }
+}
+
+// Returns the triangles of the quads of a buffer, in the order of the quads.
+template <class Buffer>
+gl::IndexVector<gl::Triangles> quadTriangles(const Buffer& buffer) {
+    gl::IndexVector<gl::Triangles> triangles;
+    for (const auto& segment : buffer.segments) {
+        for (std::size_t vertex = 0; vertex < segment.vertexLength; vertex += 4) {
+            const uint16_t index = vertex;
+            triangles.emplace_back(index + 0, index + 1, index + 2);
+            triangles.emplace_back(index + 1, index + 2, index + 3);
+        }
+    }
+    return triangles;
+}
+
+// Returns the triangles of the quads of a buffer, ordered by the symbols within each segment.
+// Segments are drawn one after the other, so symbols are only ordered across segments by the
+// order they had when the quads were added.
+template <class Buffer, class QuadRange>
+gl::IndexVector<gl::Triangles> sortedTriangles(const Buffer& buffer,
+                                               const std::vector<SymbolBucket::SortedSymbol>& symbols,
+                                               const std::vector<uint32_t>& order,
+                                               QuadRange quadRange) {
+    gl::IndexVector<gl::Triangles> triangles;
+    for (const auto& segment : buffer.segments) {
+        for (const uint32_t position : order) {
+            const auto range = quadRange(symbols[position]);
+            for (std::size_t quad = range.first; quad < range.first + range.second; quad++) {
+                const std::size_t vertex = quad * 4;
+                if (vertex < segment.vertexOffset || vertex >= segment.vertexOffset + segment.vertexLength) {
+                    continue;
+                }
+                const uint16_t index = vertex - segment.vertexOffset;
+                triangles.emplace_back(index + 0, index + 1, index + 2);
+                triangles.emplace_back(index + 1, index + 2, index + 3);
+            }
+        }
+    }
+    return triangles;
+}
+
+} // namespace
+
 SymbolBucket::SymbolBucket(style::SymbolLayoutProperties::PossiblyEvaluated layout_,
                            const std::map<std::string, std::pair<
                                style::IconPaintProperties::Evaluated, style::TextPaintProperties::Evaluated>>& layerPaintProperties,
@@ -34,17 +119,57 @@ SymbolBucket::SymbolBucket(style::SymbolLayoutProperties::PossiblyEvaluated layo
 }
 
 void SymbolBucket::upload(gl::Context& context) {
+    if (placementChanged) {
+        auto updateQuads = [&] (auto& buffer) {
+            if (buffer.instanceBuffer) {
+                context.updateVertexBuffer(*buffer.instanceBuffer, buffer.vertices);
+            } else if (buffer.vertexBuffer) {
+                context.updateVertexBuffer(*buffer.vertexBuffer, cornerVertices(buffer));
+            }
+        };
+        updateQuads(text);
+        updateQuads(icon);
+        if (orderChanged) {
+            if (text.indexBuffer) {
+                context.updateIndexBuffer(*text.indexBuffer, sortedTextTriangles());
+            }
+            if (icon.indexBuffer) {
+                context.updateIndexBuffer(*icon.indexBuffer, sortedIconTriangles());
+            }
+        }
+        placementChanged = false;
+        orderChanged = false;
+        uploaded = true;
+        return;
+    }
+
+    // Instances are drawn in the order of their vertices, which sorting symbols doesn't change.
+    instanced = context.supportsInstancing() && sortedSymbols.empty();
+    const std::size_t repeat = instanced ? 1 : 4;
+
+    addSegments(text, instanced);
+    addSegments(icon, instanced);
+
+    auto uploadQuads = [&] (auto& buffer, SymbolSizeBinder& sizeBinder, gl::IndexVector<gl::Triangles> triangles) {
+        if (instanced) {
+            buffer.instanceBuffer = context.createVertexBuffer(std::move(buffer.vertices));
+        } else {
+            buffer.vertexBuffer = context.createVertexBuffer(cornerVertices(buffer));
+            buffer.indexBuffer = context.createIndexBuffer(std::move(triangles));
+        }
+        sizeBinder.upload(context, repeat);
+    };
+
     if (hasTextData()) {
-        text.vertexBuffer = context.createVertexBuffer(std::move(text.vertices));
-        text.indexBuffer = context.createIndexBuffer(std::move(text.triangles));
-        textSizeBinder->upload(context);
+        uploadQuads(text, *textSizeBinder,
+                    instanced ? gl::IndexVector<gl::Triangles>() : orderChanged ? sortedTextTriangles() : quadTriangles(text));
     }
 
     if (hasIconData()) {
-        icon.vertexBuffer = context.createVertexBuffer(std::move(icon.vertices));
-        icon.indexBuffer = context.createIndexBuffer(std::move(icon.triangles));
-        iconSizeBinder->upload(context);
+        uploadQuads(icon, *iconSizeBinder,
+                    instanced ? gl::IndexVector<gl::Triangles>() : orderChanged ? sortedIconTriangles() : quadTriangles(icon));
     }
+    orderChanged = false;
 
     if (!collisionBox.vertices.empty()) {
         collisionBox.vertexBuffer = context.createVertexBuffer(std::move(collisionBox.vertices));
@@ -52,18 +177,131 @@ void SymbolBucket::upload(gl::Context& context) {
     }
 
     for (auto& pair : paintPropertyBinders) {
-        pair.second.first.upload(context);
-        pair.second.second.upload(context);
+        pair.second.first.upload(context, repeat);
+        pair.second.second.upload(context, repeat);
     }
 
     uploaded = true;
 }
 
+void SymbolBucket::shrinkToFit() {
+    text.vertices.shrinkToFit();
+    textSizeBinder->shrinkToFit();
+    icon.vertices.shrinkToFit();
+    iconSizeBinder->shrinkToFit();
+    collisionBox.vertices.shrinkToFit();
+    collisionBox.lines.shrinkToFit();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.first.shrinkToFit();
+        pair.second.second.shrinkToFit();
+    }
+}
+
+void SymbolBucket::releaseData() {
+    assert(uploaded);
+    if (!keepsQuadsForPlacement) {
+        text.vertices.release();
+        icon.vertices.release();
+    }
+    textSizeBinder->releaseVertexVector();
+    iconSizeBinder->releaseVertexVector();
+    collisionBox.vertices.release();
+    collisionBox.lines.release();
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.first.releaseVertexVectors();
+        pair.second.second.releaseVertexVectors();
+    }
+}
+
+void SymbolBucket::setPlacement(const Placement& placement) {
+    assert(keepsQuadsForPlacement);
+    assert(placement.text.size() == text.vertices.vertexSize());
+    assert(placement.icon.size() == icon.vertices.vertexSize());
+
+    auto place = [] (auto& vertices, const std::vector<SymbolQuadPlacement>& quads) {
+        for (std::size_t i = 0; i < quads.size(); i++) {
+            SymbolLayoutAttributes::place(vertices[i], quads[i]);
+        }
+    };
+    place(text.vertices, placement.text);
+    place(icon.vertices, placement.icon);
+
+    if (!sortedSymbols.empty() && sortSymbols(placement.angle)) {
+        orderChanged = true;
+    }
+
+    // Buckets that haven't been uploaded yet are uploaded with the new placement.
+    if (uploaded) {
+        placementChanged = true;
+        uploaded = false;
+    }
+}
+
+bool SymbolBucket::sortSymbols(float angle) {
+    if (symbolOrder.size() != sortedSymbols.size()) {
+        symbolOrder.resize(sortedSymbols.size());
+        for (uint32_t i = 0; i < symbolOrder.size(); i++) {
+            symbolOrder[i] = i;
+        }
+        sortKeys.resize(sortedSymbols.size());
+    }
+
+    const float sin = std::sin(angle);
+    const float cos = std::cos(angle);
+    for (std::size_t i = 0; i < sortedSymbols.size(); i++) {
+        const Point<float>& anchor = sortedSymbols[i].anchor;
+        sortKeys[i] = sin * anchor.x + cos * anchor.y;
+    }
+
+    auto before = [&] (uint32_t a, uint32_t b) {
+        return sortKeys[a] != sortKeys[b] ?
+            sortKeys[a] < sortKeys[b] :
+            sortedSymbols[a].index > sortedSymbols[b].index;
+    };
+
+    // An insertion sort takes linear time on nearly sorted symbols, but quadratic time when
+    // the angle changed a lot, in which case the symbols are sorted from scratch instead.
+    const std::size_t maxMoves = symbolOrder.size() * 8;
+    std::size_t moves = 0;
+    bool changed = false;
+    for (std::size_t i = 1; i < symbolOrder.size(); i++) {
+        const uint32_t position = symbolOrder[i];
+        std::size_t j = i;
+        for (; j > 0 && before(position, symbolOrder[j - 1]); j--) {
+            symbolOrder[j] = symbolOrder[j - 1];
+            if (++moves > maxMoves) {
+                symbolOrder[j - 1] = position;
+                std::sort(symbolOrder.begin(), symbolOrder.end(), before);
+                return true;
+            }
+        }
+        if (j != i) {
+            symbolOrder[j] = position;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+gl::IndexVector<gl::Triangles> SymbolBucket::sortedTextTriangles() const {
+    return sortedTriangles(text, sortedSymbols, symbolOrder, [] (const SortedSymbol& symbol) {
+        return std::make_pair(symbol.firstTextQuad, symbol.textQuadCount);
+    });
+}
+
+gl::IndexVector<gl::Triangles> SymbolBucket::sortedIconTriangles() const {
+    return sortedTriangles(icon, sortedSymbols, symbolOrder, [] (const SortedSymbol& symbol) {
+        return std::make_pair(symbol.firstIconQuad, symbol.iconQuadCount);
+    });
+}
+
 void SymbolBucket::render(Painter& painter,
                           PaintParameters& parameters,
                           const Layer& layer,
                           const RenderTile& tile) {
-    painter.renderSymbol(parameters, *this, *layer.as<SymbolLayer>(), tile);
+    for (SymbolPart part : symbolParts) {
+        painter.renderSymbol(parameters, *this, *layer.as<SymbolLayer>(), tile, part);
+    }
 }
 
 bool SymbolBucket::hasData() const {
@@ -71,12 +309,30 @@ bool SymbolBucket::hasData() const {
     return false;
 }
 
+std::size_t SymbolBucket::getByteSize() const {
+    return text.vertices.byteSize() + icon.vertices.byteSize() +
+        collisionBox.vertices.byteSize() + collisionBox.lines.byteSize() +
+        getBufferByteSize();
+}
+
+std::size_t SymbolBucket::getBufferByteSize() const {
+    return (text.instanceBuffer ? text.instanceBuffer->byteSize() : 0) +
+        (text.vertexBuffer ? text.vertexBuffer->byteSize() : 0) +
+        (text.indexBuffer ? text.indexBuffer->byteSize() : 0) +
+        (icon.instanceBuffer ? icon.instanceBuffer->byteSize() : 0) +
+        (icon.vertexBuffer ? icon.vertexBuffer->byteSize() : 0) +
+        (icon.indexBuffer ? icon.indexBuffer->byteSize() : 0) +
+        (collisionBox.vertexBuffer ? collisionBox.vertexBuffer->byteSize() : 0) +
+        (collisionBox.indexBuffer ? collisionBox.indexBuffer->byteSize() : 0);
+}
+
+// Segments are added by upload(), and the vertices may be released after it.
 bool SymbolBucket::hasTextData() const {
-    return !text.segments.empty();
+    return !text.vertices.empty() || !text.segments.empty();
 }
 
 bool SymbolBucket::hasIconData() const {
-    return !icon.segments.empty();
+    return !icon.vertices.empty() || !icon.segments.empty();
 }
 
 bool SymbolBucket::hasCollisionBoxData() const {
@@ -26,27 +26,79 @@ public:
                  bool iconsNeedLinear);
 
     void upload(gl::Context&) override;
+    void shrinkToFit() override;
+    void releaseData() override;
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
     bool hasData() const override;
+    std::size_t getByteSize() const override;
+    std::size_t getBufferByteSize() const override;
     bool hasTextData() const;
     bool hasIconData() const;
     bool hasCollisionBoxData() const;
 
+    // Placement of the quads of the bucket, in their order.
+    class Placement {
+    public:
+        std::vector<SymbolQuadPlacement> text;
+        std::vector<SymbolQuadPlacement> icon;
+
+        // The angle of the map that the quads were placed at.
+        float angle = 0;
+    };
+
+    // Places the quads again, without changing them otherwise. Only the vertices of the quads are
+    // uploaded again, not their indices or the attributes of their size and paint properties.
+    // Requires a bucket that keeps its quads for placement.
+    void setPlacement(const Placement&);
+
+    // A symbol of a bucket whose symbols may overlap, which are drawn in the order of their
+    // position on the screen: from top to bottom, and otherwise in the reverse order of their
+    // indices. Only the indices of the quads are uploaded again when that order changes. Buckets
+    // with sorted symbols draw the vertices of the corners of their quads, since the order of
+    // instances can't be changed by their indices.
+    struct SortedSymbol {
+        Point<float> anchor;
+        uint32_t index;
+        uint32_t firstTextQuad;
+        uint32_t firstIconQuad;
+        uint16_t textQuadCount;
+        uint16_t iconQuadCount;
+    };
+
+    // The symbols in the order in which their quads were added, which must be the order of
+    // their position at the angle of their first placement. Empty when the order of the quads
+    // doesn't matter.
+    std::vector<SortedSymbol> sortedSymbols;
+
+    // Orders the symbols by their position at the given angle, and returns whether their order
+    // changed. As the order at nearby angles is nearly the same, this mostly only moves a few
+    // symbols.
+    bool sortSymbols(float angle);
+
     const style::SymbolLayoutProperties::PossiblyEvaluated layout;
     const bool sdfIcons;
     const bool iconsNeedLinear;
 
+    // Whether the bucket holds the quads of all symbols, including those that placement hides,
+    // so that it can be placed again. Its vertices are kept after they have been uploaded.
+    bool keepsQuadsForPlacement = false;
+
     std::map<std::string, std::pair<
         SymbolIconProgram::PaintPropertyBinders,
         SymbolSDFTextProgram::PaintPropertyBinders>> paintPropertyBinders;
     
     std::unique_ptr<SymbolSizeBinder> textSizeBinder;
 
+    // A vertex per quad, as are the vertices of the size and paint property binders. Contexts
+    // that support instancing draw the painter's quad once for each; for the others, upload()
+    // expands them into the vertices of the corners of the quads, and builds the indices and
+    // segments there.
     struct TextBuffer {
-        gl::VertexVector<SymbolLayoutVertex> vertices;
-        gl::IndexVector<gl::Triangles> triangles;
+        gl::VertexVector<SymbolInstanceVertex> vertices;
         gl::SegmentVector<SymbolTextAttributes> segments;
 
+        optional<gl::VertexBuffer<SymbolInstanceVertex>> instanceBuffer;
+        // Only for quads that aren't drawn as instances.
         optional<gl::VertexBuffer<SymbolLayoutVertex>> vertexBuffer;
         optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
     } text;
@@ -54,14 +106,18 @@ public:
     std::unique_ptr<SymbolSizeBinder> iconSizeBinder;
     
     struct IconBuffer {
-        gl::VertexVector<SymbolLayoutVertex> vertices;
-        gl::IndexVector<gl::Triangles> triangles;
+        gl::VertexVector<SymbolInstanceVertex> vertices;
         gl::SegmentVector<SymbolIconAttributes> segments;
 
+        optional<gl::VertexBuffer<SymbolInstanceVertex>> instanceBuffer;
+        // Only for quads that aren't drawn as instances.
         optional<gl::VertexBuffer<SymbolLayoutVertex>> vertexBuffer;
         optional<gl::IndexBuffer<gl::Triangles>> indexBuffer;
     } icon;
 
+    // Whether the quads were uploaded as instances.
+    bool instanced = false;
+
     struct CollisionBoxBuffer {
         gl::VertexVector<CollisionBoxVertex> vertices;
         gl::IndexVector<gl::Lines> lines;
@@ -70,6 +126,20 @@ public:
         optional<gl::VertexBuffer<CollisionBoxVertex>> vertexBuffer;
         optional<gl::IndexBuffer<gl::Lines>> indexBuffer;
     } collisionBox;
+
+private:
+    // Whether only the vertices of the text and icons remain to be uploaded.
+    bool placementChanged = false;
+
+    // Whether the indices of the text and icons remain to be uploaded in the order of the symbols.
+    bool orderChanged = false;
+
+    // The positions of the sorted symbols in their order, and the key each is sorted by.
+    std::vector<uint32_t> symbolOrder;
+    std::vector<int32_t> sortKeys;
+
+    gl::IndexVector<gl::Triangles> sortedTextTriangles() const;
+    gl::IndexVector<gl::Triangles> sortedIconTriangles() const;
 };
 
 } // namespace mbgl
@@ -0,0 +1,140 @@
+#include <mbgl/renderer/tessellation_cache.hpp>
+
+#include <mapbox/earcut.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace mapbox {
+namespace util {
+template <> struct nth<0, mbgl::GeometryCoordinate> {
+    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.x; };
+};
+
+template <> struct nth<1, mbgl::GeometryCoordinate> {
+    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.y; };
+};
+} // namespace util
+} // namespace mapbox
+
+namespace mbgl {
+
+namespace {
+
+std::size_t vertexCount(const GeometryCollection& polygon) {
+    std::size_t count = 0;
+    for (const auto& ring : polygon) {
+        count += ring.size();
+    }
+    return count;
+}
+
+std::size_t polygonHash(const GeometryCollection& polygon) {
+    std::size_t seed = 0;
+    for (const auto& ring : polygon) {
+        boost::hash_combine(seed, ring.size());
+        for (const auto& point : ring) {
+            boost::hash_combine(seed, (uint32_t(uint16_t(point.x)) << 16) | uint16_t(point.y));
+        }
+    }
+    return seed;
+}
+
+} // namespace
+
+TessellationCache& TessellationCache::get() {
+    static TessellationCache cache(8 * 1024 * 1024);
+    return cache;
+}
+
+TessellationCache::TessellationCache(std::size_t maximumBytes_)
+    : maximumBytes(maximumBytes_) {
+}
+
+void TessellationCache::setMaximumBytes(std::size_t maximumBytes_) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maximumBytes = maximumBytes_;
+    evict();
+}
+
+TessellationCache::Indices TessellationCache::tessellate(const GeometryCollection& polygon) {
+    if (!isEnabled() || vertexCount(polygon) < minimumVertices) {
+        return mapbox::earcut<uint32_t>(polygon);
+    }
+
+    const std::size_t hash = polygonHash(polygon);
+    if (auto indices = find(hash, polygon)) {
+        return *indices;
+    }
+
+    // Tessellate outside of the lock; another thread may do the same polygon meanwhile, in
+    // which case the later result replaces the earlier one.
+    auto indices = std::make_shared<const Indices>(mapbox::earcut<uint32_t>(polygon));
+    add(hash, polygon, indices);
+    return *indices;
+}
+
+std::shared_ptr<const TessellationCache::Indices> TessellationCache::find(std::size_t hash, const GeometryCollection& polygon) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = index.find(hash);
+    if (it == index.end() || it->second->polygon != polygon) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    entries.splice(entries.begin(), entries, it->second);
+    stats.hits++;
+    return it->second->indices;
+}
+
+void TessellationCache::add(std::size_t hash, const GeometryCollection& polygon, std::shared_ptr<const Indices> indices) {
+    const std::size_t bytes = vertexCount(polygon) * sizeof(GeometryCoordinate) +
+                              indices->size() * sizeof(uint32_t);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (bytes > maximumBytes) {
+        return;
+    }
+
+    auto it = index.find(hash);
+    if (it != index.end()) {
+        stats.bytes -= it->second->bytes;
+        it->second->polygon = polygon;
+        it->second->indices = std::move(indices);
+        it->second->bytes = bytes;
+        entries.splice(entries.begin(), entries, it->second);
+    } else {
+        entries.push_front({ hash, polygon, std::move(indices), bytes });
+        index.emplace(hash, entries.begin());
+        stats.polygons++;
+    }
+
+    stats.bytes += bytes;
+    evict();
+}
+
+void TessellationCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    stats.polygons = 0;
+    stats.bytes = 0;
+}
+
+TessellationCache::Stats TessellationCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void TessellationCache::evict() {
+    while (stats.bytes > maximumBytes) {
+        const Entry& oldest = entries.back();
+        stats.bytes -= oldest.bytes;
+        stats.polygons--;
+        stats.evictions++;
+        index.erase(oldest.hash);
+        entries.pop_back();
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+// Triangulations of large polygons, shared by all fill buckets in the process. Overzoomed tiles
+// lay out the geometry of the same source tile at every zoom level past the source's maximum zoom,
+// and maps showing the same data lay out the same polygons; huge landuse or water polygons are
+// tessellated once rather than once per tile.
+//
+// Entries are keyed by the polygon itself, so they are found regardless of the tile or layer
+// they come from. It may be used from any thread.
+class TessellationCache : private util::noncopyable {
+public:
+    using Indices = std::vector<uint32_t>;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+
+        std::size_t polygons = 0;
+        std::size_t bytes = 0;
+    };
+
+    // Polygons with fewer vertices are tessellated faster than they are looked up and are
+    // not cached.
+    static constexpr std::size_t minimumVertices = 1024;
+
+    static TessellationCache& get();
+
+    TessellationCache(std::size_t maximumBytes = 0);
+
+    void setMaximumBytes(std::size_t);
+    std::size_t getMaximumBytes() const { return maximumBytes; }
+    bool isEnabled() const { return maximumBytes > 0; }
+
+    // Returns the triangle indices of the polygon, tessellating and caching it if it is large
+    // enough and wasn't cached yet.
+    Indices tessellate(const GeometryCollection& polygon);
+
+    void clear();
+
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        std::size_t hash;
+        GeometryCollection polygon;
+        std::shared_ptr<const Indices> indices;
+        std::size_t bytes;
+    };
+
+    std::shared_ptr<const Indices> find(std::size_t hash, const GeometryCollection&);
+    void add(std::size_t hash, const GeometryCollection&, std::shared_ptr<const Indices>);
+    void evict();
+
+    std::atomic<std::size_t> maximumBytes;
+
+    mutable std::mutex mutex;
+
+    // Most recently used first.
+    std::list<Entry> entries;
+    std::unordered_map<std::size_t, std::list<Entry>::iterator> index;
+    Stats stats;
+};
+
+} // namespace mbgl
@@ -0,0 +1,53 @@
+#include <mbgl/shaders/annotation_icon.hpp>
+
+namespace mbgl {
+namespace shaders {
+
+const char* annotation_icon::name = "annotation_icon";
+const char* annotation_icon::vertexSource = R"MBGL_SHADER(
+// The corner of the icon's quad, each coordinate either -1 or 1.
+attribute vec2 a_pos;
+
+// The position of the annotation in the world, in 1 / 2^32 of its size, split into the upper and
+// the lower 16 bits of x and y: a float can't hold the position precisely enough for high zoom
+// levels, but it can hold its difference to the nearby reference point u_anchor.
+attribute vec4 a_projected_pos;
+// The icon's rectangle in the atlas: left, top, right, bottom.
+attribute vec4 a_texture_rect;
+// The size of the icon, in quarter pixels.
+attribute vec2 a_extrude;
+
+// Positions the reference point.
+uniform mat4 u_matrix;
+uniform vec4 u_anchor;
+// Pixels per 1 / 2^32 of the world.
+uniform float u_world_scale;
+uniform vec2 u_extrude_scale;
+uniform vec2 u_texsize;
+
+varying vec2 v_tex;
+
+void main() {
+    vec2 offset = (a_projected_pos.xy - u_anchor.xy) * 65536.0 + (a_projected_pos.zw - u_anchor.zw);
+    gl_Position = u_matrix * vec4(offset * u_world_scale, 0, 1);
+    gl_Position.xy += a_pos * a_extrude / 8.0 * u_extrude_scale * gl_Position.w;
+
+    v_tex = mix(a_texture_rect.xy, a_texture_rect.zw, (a_pos + 1.0) / 2.0) / u_texsize;
+}
+)MBGL_SHADER";
+const char* annotation_icon::fragmentSource = R"MBGL_SHADER(
+uniform sampler2D u_texture;
+
+varying vec2 v_tex;
+
+void main() {
+    gl_FragColor = texture2D(u_texture, v_tex);
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+)MBGL_SHADER";
+
+} // namespace shaders
+} // namespace mbgl
@@ -39,13 +39,41 @@ varying vec2 v_extrude;
 varying lowp float v_antialiasblur;
 
 void main(void) {
+    #ifdef ZOOM_CONSTANT_a_color
+    color = unpack_vec4(a_color);
+#else
     color = unpack_mix_vec4(a_color, a_color_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_radius
+    radius = unpack_vec2(a_radius);
+#else
     radius = unpack_mix_vec2(a_radius, a_radius_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_blur
+    blur = unpack_vec2(a_blur);
+#else
     blur = unpack_mix_vec2(a_blur, a_blur_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_opacity
+    opacity = unpack_vec2(a_opacity);
+#else
     opacity = unpack_mix_vec2(a_opacity, a_opacity_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_stroke_color
+    stroke_color = unpack_vec4(a_stroke_color);
+#else
     stroke_color = unpack_mix_vec4(a_stroke_color, a_stroke_color_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_stroke_width
+    stroke_width = unpack_vec2(a_stroke_width);
+#else
     stroke_width = unpack_mix_vec2(a_stroke_width, a_stroke_width_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_stroke_opacity
+    stroke_opacity = unpack_vec2(a_stroke_opacity);
+#else
     stroke_opacity = unpack_mix_vec2(a_stroke_opacity, a_stroke_opacity_t);
+#endif
 
     // unencode the extrusion vector that we snuck into the a_pos vector
     v_extrude = vec2(mod(a_pos, 2.0) * 2.0 - 1.0);
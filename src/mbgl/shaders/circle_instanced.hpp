@@ -0,0 +1,17 @@
+#pragma once
+
+namespace mbgl {
+namespace shaders {
+
+// Unlike the other shaders, which are generated from those of mapbox-gl-js, this one is native
+// only: it is the circle shader with the corners of instanced quads added to the positions of
+// the circles, see CircleProgram::draw.
+class circle_instanced {
+public:
+    static const char* name;
+    static const char* vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+} // namespace mbgl
@@ -0,0 +1,39 @@
+#include <mbgl/shaders/extrusion_texture.hpp>
+
+namespace mbgl {
+namespace shaders {
+
+const char* extrusion_texture::name = "extrusion_texture";
+const char* extrusion_texture::vertexSource = R"MBGL_SHADER(
+uniform mat4 u_matrix;
+
+attribute vec2 a_pos;
+
+varying vec2 v_pos;
+
+void main() {
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+
+    // The texture covers the viewport, so its coordinates follow from the clip coordinates.
+    v_pos = gl_Position.xy * 0.5 + 0.5;
+}
+
+)MBGL_SHADER";
+const char* extrusion_texture::fragmentSource = R"MBGL_SHADER(
+uniform sampler2D u_image;
+uniform float u_opacity;
+
+varying vec2 v_pos;
+
+void main() {
+    gl_FragColor = texture2D(u_image, v_pos) * u_opacity;
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(0.0);
+#endif
+}
+
+)MBGL_SHADER";
+
+} // namespace shaders
+} // namespace mbgl
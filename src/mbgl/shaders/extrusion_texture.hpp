@@ -0,0 +1,17 @@
+#pragma once
+
+namespace mbgl {
+namespace shaders {
+
+// Unlike the other shaders, which are generated from those of mapbox-gl-js, this one is native
+// only: it composites the texture that fill extrusion layers are drawn into, see
+// Painter::finishExtrusions.
+class extrusion_texture {
+public:
+    static const char* name;
+    static const char* vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+} // namespace mbgl
@@ -19,8 +19,16 @@ attribute lowp vec2 a_opacity;
 varying lowp float opacity;
 
 void main() {
+    #ifdef ZOOM_CONSTANT_a_color
+    color = unpack_vec4(a_color);
+#else
     color = unpack_mix_vec4(a_color, a_color_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_opacity
+    opacity = unpack_vec2(a_opacity);
+#else
     opacity = unpack_mix_vec2(a_opacity, a_opacity_t);
+#endif
 
     gl_Position = u_matrix * vec4(a_pos, 0, 1);
 }
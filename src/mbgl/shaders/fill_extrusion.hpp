@@ -0,0 +1,17 @@
+#pragma once
+
+namespace mbgl {
+namespace shaders {
+
+// Unlike the other shaders, which are generated from those of mapbox-gl-js, this one is native
+// only: it draws the walls and roofs of fill extrusion layers into their offscreen texture, see
+// Painter::renderFillExtrusion.
+class fill_extrusion {
+public:
+    static const char* name;
+    static const char* vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+} // namespace mbgl
@@ -22,8 +22,16 @@ attribute lowp vec2 a_opacity;
 varying lowp float opacity;
 
 void main() {
+    #ifdef ZOOM_CONSTANT_a_outline_color
+    outline_color = unpack_vec4(a_outline_color);
+#else
     outline_color = unpack_mix_vec4(a_outline_color, a_outline_color_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_opacity
+    opacity = unpack_vec2(a_opacity);
+#else
     opacity = unpack_mix_vec2(a_opacity, a_opacity_t);
+#endif
 
     gl_Position = u_matrix * vec4(a_pos, 0, 1);
     v_pos = (gl_Position.xy / gl_Position.w + 1.0) / 2.0 * u_world;
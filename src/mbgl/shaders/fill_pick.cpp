@@ -0,0 +1,33 @@
+#include <mbgl/shaders/fill_pick.hpp>
+
+namespace mbgl {
+namespace shaders {
+
+const char* fill_pick::name = "fill_pick";
+const char* fill_pick::vertexSource = R"MBGL_SHADER(
+attribute vec2 a_pos;
+// The index of the feature in its source layer plus one, split into its lower three bytes.
+attribute vec4 a_pick_id;
+
+uniform mat4 u_matrix;
+
+varying vec3 v_pick_id;
+
+void main() {
+    v_pick_id = a_pick_id.rgb;
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+}
+)MBGL_SHADER";
+const char* fill_pick::fragmentSource = R"MBGL_SHADER(
+// The number of the draw, which identifies the layer and the tile of the feature.
+uniform float u_pick_draw;
+
+varying vec3 v_pick_id;
+
+void main() {
+    gl_FragColor = vec4(v_pick_id, u_pick_draw) / 255.0;
+}
+)MBGL_SHADER";
+
+} // namespace shaders
+} // namespace mbgl
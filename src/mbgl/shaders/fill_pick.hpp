@@ -0,0 +1,16 @@
+#pragma once
+
+namespace mbgl {
+namespace shaders {
+
+// Unlike the other shaders, which are generated from those of mapbox-gl-js, this one is native
+// only: it draws the features of fill layers into the picking buffer, see Painter::renderPicking.
+class fill_pick {
+public:
+    static const char* name;
+    static const char* vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+} // namespace mbgl
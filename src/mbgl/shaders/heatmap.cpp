@@ -0,0 +1,74 @@
+#include <mbgl/shaders/heatmap.hpp>
+
+namespace mbgl {
+namespace shaders {
+
+const char* heatmap::name = "heatmap";
+const char* heatmap::vertexSource = R"MBGL_SHADER(
+uniform mat4 u_matrix;
+uniform vec2 u_extrude_scale;
+
+attribute vec2 a_pos;
+
+uniform lowp float a_radius_t;
+attribute mediump vec2 a_radius;
+varying mediump float radius;
+uniform lowp float a_weight_t;
+attribute highp vec2 a_weight;
+varying highp float weight;
+
+varying vec2 v_extrude;
+
+void main(void) {
+    #ifdef ZOOM_CONSTANT_a_radius
+    radius = unpack_vec2(a_radius);
+#else
+    radius = unpack_mix_vec2(a_radius, a_radius_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_weight
+    weight = unpack_vec2(a_weight);
+#else
+    weight = unpack_mix_vec2(a_weight, a_weight_t);
+#endif
+
+    // unencode the extrusion vector that we snuck into the a_pos vector
+    v_extrude = vec2(mod(a_pos, 2.0) * 2.0 - 1.0);
+
+    // multiply a_pos by 0.5, since we had it * 2 in order to sneak
+    // in extrusion data
+    gl_Position = u_matrix * vec4(floor(a_pos * 0.5), 0, 1);
+    gl_Position.xy += v_extrude * radius * u_extrude_scale * gl_Position.w;
+}
+
+)MBGL_SHADER";
+const char* heatmap::fragmentSource = R"MBGL_SHADER(
+uniform highp float u_intensity;
+
+varying mediump float radius;
+varying highp float weight;
+
+varying vec2 v_extrude;
+
+// 1 / sqrt(2 * PI), the peak of the normal distribution.
+#define GAUSS_COEF 0.3989422804014327
+
+void main() {
+    
+    
+
+    // The kernel is a normal distribution that reaches three standard deviations at the
+    // edge of the quad.
+    float d = -0.5 * 3.0 * 3.0 * dot(v_extrude, v_extrude);
+    float density = weight * u_intensity * GAUSS_COEF * exp(d);
+
+    gl_FragColor = vec4(density, 1.0, 1.0, 1.0);
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+
+)MBGL_SHADER";
+
+} // namespace shaders
+} // namespace mbgl
@@ -0,0 +1,76 @@
+#include <mbgl/shaders/hillshade_prepare.hpp>
+
+namespace mbgl {
+namespace shaders {
+
+const char* hillshade_prepare::name = "hillshade_prepare";
+const char* hillshade_prepare::vertexSource = R"MBGL_SHADER(
+uniform mat4 u_matrix;
+uniform vec2 u_dimension;
+
+attribute vec2 a_pos;
+attribute vec2 a_texture_pos;
+
+varying vec2 v_pos;
+
+void main() {
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+
+    // The elevations have a border of one pixel, which the tile itself doesn't cover.
+    highp vec2 epsilon = 1.0 / u_dimension;
+    float scale = (u_dimension.x - 2.0) / u_dimension.x;
+    v_pos = (a_texture_pos / 32767.0) * scale + epsilon;
+}
+
+)MBGL_SHADER";
+const char* hillshade_prepare::fragmentSource = R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#endif
+
+uniform sampler2D u_image;
+varying vec2 v_pos;
+uniform vec2 u_dimension;
+uniform float u_zoom;
+
+// Decodes the elevation of a pixel in meters from the Terrain-RGB encoding.
+float getElevation(vec2 coord) {
+    vec4 data = texture2D(u_image, coord) * 255.0;
+    return (data.r * 65536.0 + data.g * 256.0 + data.b) / 10.0 - 10000.0;
+}
+
+void main() {
+    vec2 epsilon = 1.0 / u_dimension;
+
+    // The elevations of the pixel and the eight around it:
+    // a b c
+    // d e f
+    // g h i
+    float a = getElevation(v_pos + vec2(-epsilon.x, -epsilon.y));
+    float b = getElevation(v_pos + vec2(0, -epsilon.y));
+    float c = getElevation(v_pos + vec2(epsilon.x, -epsilon.y));
+    float d = getElevation(v_pos + vec2(-epsilon.x, 0));
+    float f = getElevation(v_pos + vec2(epsilon.x, 0));
+    float g = getElevation(v_pos + vec2(-epsilon.x, epsilon.y));
+    float h = getElevation(v_pos + vec2(0, epsilon.y));
+    float i = getElevation(v_pos + vec2(epsilon.x, epsilon.y));
+
+    // The Sobel operator weighs the differences across the pixel eight times, so they're divided
+    // by eight times the size of a pixel in meters at the equator: 2^16.2562 meters at zoom level
+    // 0 for 512 pixels.
+    vec2 deriv = vec2(
+        (c + f + f + i) - (a + d + d + g),
+        (g + h + h + i) - (a + b + b + c)
+    ) / (pow(2.0, 19.2562 - u_zoom) * 512.0 / (u_dimension.x - 2.0));
+
+    gl_FragColor = clamp(vec4(
+        deriv.x / 2.0 + 0.5,
+        deriv.y / 2.0 + 0.5,
+        1.0,
+        1.0), 0.0, 1.0);
+}
+
+)MBGL_SHADER";
+
+} // namespace shaders
+} // namespace mbgl
@@ -0,0 +1,38 @@
+#include <mbgl/shaders/layer_group.hpp>
+
+namespace mbgl {
+namespace shaders {
+
+const char* layer_group::name = "layer_group";
+const char* layer_group::vertexSource = R"MBGL_SHADER(
+uniform mat4 u_matrix;
+
+attribute vec2 a_pos;
+
+varying vec2 v_pos;
+
+void main() {
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+
+    // The quad spans the texture with the extent of a tile.
+    v_pos = a_pos / 8192.0;
+}
+
+)MBGL_SHADER";
+const char* layer_group::fragmentSource = R"MBGL_SHADER(
+uniform sampler2D u_image;
+
+varying vec2 v_pos;
+
+void main() {
+    gl_FragColor = texture2D(u_image, v_pos);
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(0.0);
+#endif
+}
+
+)MBGL_SHADER";
+
+} // namespace shaders
+} // namespace mbgl
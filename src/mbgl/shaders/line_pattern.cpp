@@ -50,10 +50,26 @@ attribute mediump vec2 a_gapwidth;
 varying mediump float gapwidth;
 
 void main() {
+    #ifdef ZOOM_CONSTANT_a_blur
+    blur = unpack_vec2(a_blur);
+#else
     blur = unpack_mix_vec2(a_blur, a_blur_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_opacity
+    opacity = unpack_vec2(a_opacity);
+#else
     opacity = unpack_mix_vec2(a_opacity, a_opacity_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_offset
+    offset = unpack_vec2(a_offset);
+#else
     offset = unpack_mix_vec2(a_offset, a_offset_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_gapwidth
+    gapwidth = unpack_vec2(a_gapwidth);
+#else
     gapwidth = unpack_mix_vec2(a_gapwidth, a_gapwidth_t);
+#endif
 
     vec2 a_extrude = a_data.xy - 128.0;
     float a_direction = mod(a_data.z, 4.0) - 1.0;
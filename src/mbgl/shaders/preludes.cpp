@@ -94,6 +94,16 @@ vec2 get_pattern_pos(const vec2 pixel_coord_upper, const vec2 pixel_coord_lower,
     return (tile_units_to_pixels * pos + offset) / pattern_size;
 }
 
+// Unpack the first of a pair of paint values, for the program variants that
+// don't interpolate the property; see PaintPropertyBinders::variant().
+float unpack_vec2(const vec2 packedValue) {
+    return packedValue[0];
+}
+
+vec4 unpack_vec4(const vec4 packedColors) {
+    return decode_color(vec2(packedColors[0], packedColors[1]));
+}
+
 )MBGL_SHADER";
 const char* fragmentPrelude = R"MBGL_SHADER(
 #ifdef GL_ES
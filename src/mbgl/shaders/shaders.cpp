@@ -26,13 +26,23 @@ std::string fragmentSource(const ProgramParameters& parameters, const char* frag
     return source;
 }
 
-std::string vertexSource(const ProgramParameters& parameters, const char* vertexSource) {
-    return pixelRatioDefine(parameters) + vertexPrelude + vertexSource;
+std::string vertexSource(const ProgramParameters& parameters, const char* vertexSource, const std::string& defines) {
+    return pixelRatioDefine(parameters) + defines + vertexPrelude + vertexSource;
 }
 
-std::string programCachePath(const ProgramParameters& parameters, const char* name) {
-    return parameters.cacheDir + "/com.mapbox.gl.shader." + name +
-           (parameters.overdraw ? ".overdraw.pbf" : ".pbf");
+std::string programCacheFileName(const ProgramParameters& parameters, const char* name, const std::string& defines) {
+    std::string fileName = std::string("com.mapbox.gl.shader.") + name;
+    if (!defines.empty()) {
+        // Each variant of a program is cached in a file of its own.
+        std::ostringstream ss;
+        ss << std::hex << std::hash<std::string>()(defines);
+        fileName += "." + ss.str();
+    }
+    return fileName + (parameters.overdraw ? ".overdraw.pbf" : ".pbf");
+}
+
+std::string programCachePath(const ProgramParameters& parameters, const char* name, const std::string& defines) {
+    return parameters.cacheDir + "/" + programCacheFileName(parameters, name, defines);
 }
 
 std::string programIdentifier(const std::string& vertexSource, const std::string& fragmentSource) {
@@ -9,8 +9,9 @@ class ProgramParameters;
 namespace shaders {
 
 std::string fragmentSource(const ProgramParameters&, const char* fragmentSource);
-std::string vertexSource(const ProgramParameters&, const char* vertexSource);
-std::string programCachePath(const ProgramParameters&, const char* name);
+std::string vertexSource(const ProgramParameters&, const char* vertexSource, const std::string& defines);
+std::string programCacheFileName(const ProgramParameters&, const char* name, const std::string& defines);
+std::string programCachePath(const ProgramParameters&, const char* name, const std::string& defines);
 std::string programIdentifier(const std::string& vertexSource, const std::string& fragmentSource);
 
 } // namespace shaders
@@ -63,11 +63,31 @@ varying float v_gamma_scale;
 varying float v_size;
 
 void main() {
+    #ifdef ZOOM_CONSTANT_a_fill_color
+    fill_color = unpack_vec4(a_fill_color);
+#else
     fill_color = unpack_mix_vec4(a_fill_color, a_fill_color_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_halo_color
+    halo_color = unpack_vec4(a_halo_color);
+#else
     halo_color = unpack_mix_vec4(a_halo_color, a_halo_color_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_opacity
+    opacity = unpack_vec2(a_opacity);
+#else
     opacity = unpack_mix_vec2(a_opacity, a_opacity_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_halo_width
+    halo_width = unpack_vec2(a_halo_width);
+#else
     halo_width = unpack_mix_vec2(a_halo_width, a_halo_width_t);
+#endif
+    #ifdef ZOOM_CONSTANT_a_halo_blur
+    halo_blur = unpack_vec2(a_halo_blur);
+#else
     halo_blur = unpack_mix_vec2(a_halo_blur, a_halo_blur_t);
+#endif
 
     vec2 a_pos = a_pos_offset.xy;
     vec2 a_offset = a_pos_offset.zw;
@@ -0,0 +1,18 @@
+#pragma once
+
+namespace mbgl {
+namespace shaders {
+
+// Unlike the other shaders, which are generated from those of mapbox-gl-js, this one is native
+// only: it is the symbol_sdf shader with the corners of instanced quads moved along the edges in
+// a_quad, see SymbolProgram::draw, and with a branch that draws halos and fills in the same pass,
+// see SymbolSDFPart.
+class symbol_sdf_instanced {
+public:
+    static const char* name;
+    static const char* vertexSource;
+    static const char* fragmentSource;
+};
+
+} // namespace shaders
+} // namespace mbgl
@@ -15,14 +15,15 @@
 #include <cassert>
 #include <cmath>
 #include <algorithm>
+#include <vector>
 
 namespace mbgl {
 
 static SpriteAtlasObserver nullObserver;
 
 struct SpriteAtlas::Loader {
-    std::shared_ptr<const std::string> image;
-    std::shared_ptr<const std::string> json;
+    std::shared_ptr<const Buffer> image;
+    std::shared_ptr<const Buffer> json;
     std::unique_ptr<AsyncRequest> jsonRequest;
     std::unique_ptr<AsyncRequest> spriteRequest;
 };
@@ -50,8 +51,7 @@ SpriteAtlas::SpriteAtlas(Size size_, float pixelRatio_)
     : size(std::move(size_)),
       pixelRatio(pixelRatio_),
       observer(&nullObserver),
-      bin(size.width, size.height),
-      dirty(true) {
+      bin(size.width, size.height) {
 }
 
 SpriteAtlas::~SpriteAtlas() = default;
@@ -71,7 +71,7 @@ void SpriteAtlas::load(const std::string& url, FileSource& fileSource) {
         } else if (res.notModified) {
             return;
         } else if (res.noContent) {
-            loader->json = std::make_shared<const std::string>();
+            loader->json = std::make_shared<const Buffer>(std::string());
             emitSpriteLoadedIfComplete();
         } else {
             // Only trigger a sprite loaded event we got new data.
@@ -86,7 +86,7 @@ void SpriteAtlas::load(const std::string& url, FileSource& fileSource) {
         } else if (res.notModified) {
             return;
         } else if (res.noContent) {
-            loader->image = std::make_shared<const std::string>();
+            loader->image = std::make_shared<const Buffer>(std::string());
             emitSpriteLoadedIfComplete();
         } else {
             loader->image = res.data;
@@ -102,20 +102,31 @@ void SpriteAtlas::emitSpriteLoadedIfComplete() {
         return;
     }
 
-    auto result = parseSprite(*loader->image, *loader->json);
+    // A sprite is parsed once per style, so it isn't worth parsing it out of the buffers.
+    auto result = parseSprite(loader->image->toString(), loader->json->toString());
     if (result.is<Sprites>()) {
-        loaded = true;
-        setSprites(result.get<Sprites>());
-        observer->onSpriteLoaded();
-        for (auto requestor : requestors) {
-            requestor->onIconsAvailable(this, buildIconMap());
-        }
-        requestors.clear();
+        emitSpriteLoaded(result.get<Sprites>());
     } else {
         observer->onSpriteError(result.get<std::exception_ptr>());
     }
 }
 
+void SpriteAtlas::load(const Sprites& sprites) {
+    loader.reset();
+    emitSpriteLoaded(sprites);
+}
+
+void SpriteAtlas::emitSpriteLoaded(const Sprites& sprites) {
+    loaded = true;
+    setSprites(sprites);
+    observer->onSpriteLoaded();
+    auto pending = std::move(requestors);
+    requestors.clear();
+    for (const auto& pair : pending) {
+        pair.first->onIconsAvailable(this, buildIconMap(*pair.first, pair.second));
+    }
+}
+
 void SpriteAtlas::setObserver(SpriteAtlasObserver* observer_) {
     observer = observer_;
 }
@@ -135,7 +146,6 @@ void SpriteAtlas::setSprite(const std::string& name, std::shared_ptr<const Sprit
 }
 
 void SpriteAtlas::removeSprite(const std::string& name) {
-    icons.clear();
     auto it = entries.find(name);
     if (it == entries.end()) {
         return;
@@ -144,11 +154,11 @@ void SpriteAtlas::removeSprite(const std::string& name) {
     Entry& entry = it->second;
 
     if (entry.iconRect) {
-        bin.release(*entry.iconRect);
+        release(*entry.iconRect);
     }
 
     if (entry.patternRect) {
-        bin.release(*entry.patternRect);
+        release(*entry.patternRect);
     }
 
     entries.erase(it);
@@ -156,22 +166,21 @@ void SpriteAtlas::removeSprite(const std::string& name) {
 
 void SpriteAtlas::_setSprite(const std::string& name,
                              const std::shared_ptr<const SpriteImage>& sprite) {
-    icons.clear();
-    if (!sprite->image.valid()) {
+    if (sprite->size.isEmpty()) {
         Log::Warning(Event::Sprite, "invalid sprite image '%s'", name.c_str());
         return;
     }
 
     auto it = entries.find(name);
     if (it == entries.end()) {
-        entries.emplace(name, Entry { sprite, {}, {} });
+        entries.emplace(name, Entry { sprite, {}, {}, {}, 0 });
         return;
     }
 
     Entry& entry = it->second;
 
     // There is already a sprite with that name in our store.
-    if (entry.spriteImage->image.size != sprite->image.size) {
+    if (entry.spriteImage->size != sprite->size) {
         Log::Warning(Event::Sprite, "Can't change sprite dimensions for '%s'", name.c_str());
         return;
     }
@@ -187,6 +196,14 @@ void SpriteAtlas::_setSprite(const std::string& name,
     }
 }
 
+SpriteAtlas::Sprites SpriteAtlas::getSprites() const {
+    Sprites sprites;
+    for (const auto& entry : entries) {
+        sprites.emplace(entry.first, entry.second.spriteImage);
+    }
+    return sprites;
+}
+
 std::shared_ptr<const SpriteImage> SpriteAtlas::getSprite(const std::string& name) {
     const auto it = entries.find(name);
     if (it != entries.end()) {
@@ -199,16 +216,21 @@ std::shared_ptr<const SpriteImage> SpriteAtlas::getSprite(const std::string& nam
     }
 }
 
-void SpriteAtlas::getIcons(IconRequestor& requestor) {
+void SpriteAtlas::getIcons(IconRequestor& requestor, IconDependencies dependencies) {
     if (isLoaded()) {
-        requestor.onIconsAvailable(this, buildIconMap());
+        requestor.onIconsAvailable(this, buildIconMap(requestor, dependencies));
     } else {
-        requestors.insert(&requestor);
+        requestors[&requestor].insert(dependencies.begin(), dependencies.end());
     }
 }
 
 void SpriteAtlas::removeRequestor(IconRequestor& requestor) {
     requestors.erase(&requestor);
+    for (auto& pair : entries) {
+        if (pair.second.requestors.erase(&requestor)) {
+            pair.second.lastUsed = ++clock;
+        }
+    }
 }
 
 optional<SpriteAtlasElement> SpriteAtlas::getIcon(const std::string& name) {
@@ -242,8 +264,8 @@ optional<SpriteAtlasElement> SpriteAtlas::getImage(const std::string& name,
         };
     }
 
-    const uint16_t pixelWidth = std::ceil(entry.spriteImage->image.size.width / pixelRatio);
-    const uint16_t pixelHeight = std::ceil(entry.spriteImage->image.size.height / pixelRatio);
+    const uint16_t pixelWidth = std::ceil(entry.spriteImage->size.width / pixelRatio);
+    const uint16_t pixelHeight = std::ceil(entry.spriteImage->size.height / pixelRatio);
 
     // Increase to next number divisible by 4, but at least 1.
     // This is so we can scale down the texture coordinates and pack them
@@ -252,11 +274,9 @@ optional<SpriteAtlasElement> SpriteAtlas::getImage(const std::string& name,
     const uint16_t packHeight = (pixelHeight + 1) + (4 - (pixelHeight + 1) % 4);
 
     // We have to allocate a new area in the bin, and store an empty image in it.
-    Rect<uint16_t> rect = bin.allocate(packWidth, packHeight);
+    Rect<uint16_t> rect = allocate(packWidth, packHeight);
     if (rect.w == 0) {
-        if (debug::spriteWarnings) {
-            Log::Warning(Event::Sprite, "sprite atlas bitmap overflow");
-        }
+        Log::Warning(Event::Sprite, "sprite atlas bitmap overflow");
         return {};
     }
 
@@ -271,6 +291,67 @@ optional<SpriteAtlasElement> SpriteAtlas::getImage(const std::string& name,
     };
 }
 
+Rect<uint16_t> SpriteAtlas::allocate(uint16_t width, uint16_t height) {
+    Rect<uint16_t> rect = bin.allocate(width, height);
+    if (rect.hasArea()) {
+        return rect;
+    }
+
+    // The atlas is full. Make room by evicting the icons that no requestor holds on to anymore,
+    // least recently used first; shelves whose icons have all been evicted are reset. Icons that
+    // are in use stay where they are, because their positions are baked into the symbol buckets
+    // of the tiles that requested them.
+    std::vector<Entry*> unused;
+    for (auto& pair : entries) {
+        if (pair.second.iconRect && pair.second.requestors.empty()) {
+            unused.push_back(&pair.second);
+        }
+    }
+
+    std::sort(unused.begin(), unused.end(), [] (const Entry* a, const Entry* b) {
+        return a->lastUsed < b->lastUsed;
+    });
+
+    for (Entry* entry : unused) {
+        release(*entry->iconRect);
+        entry->iconRect = {};
+
+        rect = bin.allocate(width, height);
+        if (rect.hasArea()) {
+            break;
+        }
+    }
+
+    return rect;
+}
+
+void SpriteAtlas::release(const Rect<uint16_t>& rect) {
+    bin.release(rect);
+
+    if (!image.valid()) {
+        return;
+    }
+
+    // Clear out the image, so that its border doesn't bleed into icons placed there later.
+    const uint32_t x = rect.x * pixelRatio;
+    const uint32_t y = rect.y * pixelRatio;
+    const uint32_t right = std::min<uint32_t>(std::ceil((rect.x + rect.w) * pixelRatio), image.size.width);
+    const uint32_t bottom = std::min<uint32_t>(std::ceil((rect.y + rect.h) * pixelRatio), image.size.height);
+    for (uint32_t row = y; row < bottom; row++) {
+        uint8_t* data = image.data.get() + row * image.stride();
+        std::fill(data + x * 4, data + right * 4, 0);
+    }
+
+    markDirty(rect);
+}
+
+void SpriteAtlas::markDirty(const Rect<uint16_t>& rect) {
+    const uint32_t top = rect.y * pixelRatio;
+    const uint32_t bottom = std::min<uint32_t>(std::ceil((rect.y + rect.h) * pixelRatio), image.size.height);
+    dirtyTop = dirtyTop < dirtyBottom ? std::min(dirtyTop, top) : top;
+    dirtyBottom = std::max(dirtyBottom, bottom);
+}
+
 void SpriteAtlas::copy(const Entry& entry, optional<Rect<uint16_t>> Entry::*entryRect) {
     if (!image.valid()) {
         image = PremultipliedImage({ static_cast<uint32_t>(std::ceil(size.width * pixelRatio)),
@@ -278,7 +359,7 @@ void SpriteAtlas::copy(const Entry& entry, optional<Rect<uint16_t>> Entry::*entr
         image.fill(0);
     }
 
-    const PremultipliedImage& src = entry.spriteImage->image;
+    const SpriteImage& src = *entry.spriteImage;
     const Rect<uint16_t>& rect = *(entry.*entryRect);
 
     const uint32_t padding = 1;
@@ -287,26 +368,35 @@ void SpriteAtlas::copy(const Entry& entry, optional<Rect<uint16_t>> Entry::*entr
     const uint32_t w = src.size.width;
     const uint32_t h = src.size.height;
 
-    PremultipliedImage::copy(src, image, { 0, 0 }, { x, y }, { w, h });
+    // Sprite images are only copied out of their sheet once they are requested.
+    src.copy(image, { 0, 0 }, { x, y }, { w, h });
 
     if (entryRect == &Entry::patternRect) {
         // Add 1 pixel wrapped padding on each side of the image.
-        PremultipliedImage::copy(src, image, { 0, h - 1 }, { x, y - 1 }, { w, 1 }); // T
-        PremultipliedImage::copy(src, image, { 0,     0 }, { x, y + h }, { w, 1 }); // B
-        PremultipliedImage::copy(src, image, { w - 1, 0 }, { x - 1, y }, { 1, h }); // L
-        PremultipliedImage::copy(src, image, { 0,     0 }, { x + w, y }, { 1, h }); // R
+        src.copy(image, { 0, h - 1 }, { x, y - 1 }, { w, 1 }); // T
+        src.copy(image, { 0,     0 }, { x, y + h }, { w, 1 }); // B
+        src.copy(image, { w - 1, 0 }, { x - 1, y }, { 1, h }); // L
+        src.copy(image, { 0,     0 }, { x + w, y }, { 1, h }); // R
     }
 
-    dirty = true;
+    markDirty(rect);
 }
 
-IconMap SpriteAtlas::buildIconMap() {
-    if (icons.empty()) {
-        for (auto entry : entries) {
-            icons.emplace(std::piecewise_construct,
-                          std::forward_as_tuple(entry.first),
-                          std::forward_as_tuple(*getIcon(entry.first)));
+IconMap SpriteAtlas::buildIconMap(IconRequestor& requestor, const IconDependencies& dependencies) {
+    IconMap icons;
+    for (const auto& name : dependencies) {
+        auto it = entries.find(name);
+        if (it == entries.end()) {
+            continue;
+        }
+
+        // Hold on to the icon before adding it, so that adding the other icons doesn't evict it.
+        Entry& entry = it->second;
+        entry.requestors.insert(&requestor);
+        entry.lastUsed = ++clock;
 
+        if (auto icon = getIcon(name)) {
+            icons.emplace(name, *icon);
         }
     }
     return icons;
@@ -315,19 +405,22 @@ IconMap SpriteAtlas::buildIconMap() {
 void SpriteAtlas::upload(gl::Context& context, gl::TextureUnit unit) {
     if (!texture) {
         texture = context.createTexture(image, unit);
-    } else if (dirty) {
+    } else if (texture->size != image.size) {
         context.updateTexture(*texture, image, unit);
+    } else if (dirtyTop < dirtyBottom) {
+        context.updateTextureRows(*texture, image, dirtyTop, dirtyBottom - dirtyTop, unit);
     }
 
 #if not MBGL_USE_GLES2
-//    if (dirty) {
+//    if (dirtyTop < dirtyBottom) {
 //        platform::showColorDebugImage("Sprite Atlas",
 //                                      reinterpret_cast<const char*>(image.data.get()), size.width,
 //                                      size.height, image.size.width, image.size.height);
 //    }
 #endif // MBGL_USE_GLES2
 
-    dirty = false;
+    dirtyTop = 0;
+    dirtyBottom = 0;
 }
 
 void SpriteAtlas::bind(bool linear, gl::Context& context, gl::TextureUnit unit) {
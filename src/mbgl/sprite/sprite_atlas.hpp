@@ -1,6 +1,6 @@
 #pragma once
 
-#include <mbgl/geometry/binpack.hpp>
+#include <mbgl/geometry/shelf_pack.hpp>
 #include <mbgl/gl/texture.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/optional.hpp>
@@ -10,6 +10,7 @@
 #include <map>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <array>
 #include <memory>
 
@@ -58,6 +59,10 @@ public:
 
     void load(const std::string& url, FileSource&);
 
+    // Loads sprite images that were parsed already, such as those of a style snapshot, rather
+    // than requesting the sprite.
+    void load(const Sprites&);
+
     bool isLoaded() const {
         return loaded;
     }
@@ -71,7 +76,14 @@ public:
     
     std::shared_ptr<const SpriteImage> getSprite(const std::string& name);
 
-    void getIcons(IconRequestor& requestor);
+    // All the sprite images of the atlas, which are shared rather than copied.
+    Sprites getSprites() const;
+
+    // Adds the requested icons to the atlas and notifies the requestor of their positions, once
+    // the sprite has loaded. Icons that the sprite doesn't contain are left out. The icons keep
+    // their positions until the requestor is removed; afterwards, they may be evicted to make room
+    // for other icons when the atlas is full.
+    void getIcons(IconRequestor& requestor, IconDependencies);
     void removeRequestor(IconRequestor& requestor);
 
     optional<SpriteAtlasElement> getIcon(const std::string& name);
@@ -81,12 +93,16 @@ public:
     void bind(bool linear, gl::Context&, gl::TextureUnit unit);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // the texture is only bound when the data is out of date (=dirty). Only the rows that changed
+    // since the last upload are sent.
     void upload(gl::Context&, gl::TextureUnit unit);
 
     Size getSize() const { return size; }
     float getPixelRatio() const { return pixelRatio; }
 
+    // Returns the size of the atlas image in CPU memory.
+    std::size_t getByteSize() const { return image.bytes(); }
+
     // Only for use in tests.
     void setSprites(const Sprites& sprites);
     const PremultipliedImage& getAtlasImage() const {
@@ -96,6 +112,7 @@ public:
 private:
     void _setSprite(const std::string&, const std::shared_ptr<const SpriteImage>& = nullptr);
     void emitSpriteLoadedIfComplete();
+    void emitSpriteLoaded(const Sprites&);
 
 
     const Size size;
@@ -117,21 +134,36 @@ private:
         // pixel border wrapped from the opposite side.
         optional<Rect<uint16_t>> iconRect;
         optional<Rect<uint16_t>> patternRect;
+
+        // Requestors that were given the position of the icon.
+        std::unordered_set<IconRequestor*> requestors;
+
+        // When the icon was last requested or released, for evicting the least recently used
+        // icons first.
+        uint64_t lastUsed = 0;
     };
 
     optional<SpriteAtlasElement> getImage(const std::string& name, optional<Rect<uint16_t>> Entry::*rect);
+    Rect<uint16_t> allocate(uint16_t width, uint16_t height);
+    void release(const Rect<uint16_t>&);
     void copy(const Entry&, optional<Rect<uint16_t>> Entry::*rect);
-    
-    IconMap buildIconMap();
+    void markDirty(const Rect<uint16_t>&);
+
+    IconMap buildIconMap(IconRequestor&, const IconDependencies&);
 
     std::unordered_map<std::string, Entry> entries;
-    BinPack<uint16_t> bin;
+    ShelfPack<uint16_t> bin;
     PremultipliedImage image;
     mbgl::optional<gl::Texture> texture;
-    bool dirty;
-    
-    std::set<IconRequestor*> requestors;
-    IconMap icons;
+
+    // The rows of the image that changed since the last upload, from the first to the last.
+    uint32_t dirtyTop = 0;
+    uint32_t dirtyBottom = 0;
+
+    uint64_t clock = 0;
+
+    // Requestors waiting for the sprite to load, with the icons they need.
+    std::unordered_map<IconRequestor*, IconDependencies> requestors;
 };
 
 } // namespace mbgl
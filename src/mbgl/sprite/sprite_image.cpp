@@ -9,15 +9,53 @@ namespace mbgl {
 SpriteImage::SpriteImage(PremultipliedImage&& image_,
                          const float pixelRatio_,
                          bool sdf_)
-    : image(std::move(image_)),
+    : size(image_.size),
       pixelRatio(pixelRatio_),
-      sdf(sdf_) {
+      sdf(sdf_),
+      pixels(image_.valid() ? std::make_shared<const PremultipliedImage>(std::move(image_)) : nullptr),
+      origin({ 0, 0 }) {
+    validate();
+}
+
+SpriteImage::SpriteImage(std::shared_ptr<const PremultipliedImage> pixels_,
+                         const Point<uint32_t> origin_,
+                         const Size size_,
+                         const float pixelRatio_,
+                         bool sdf_)
+    : size(size_),
+      pixelRatio(pixelRatio_),
+      sdf(sdf_),
+      pixels(std::move(pixels_)),
+      origin(origin_) {
+    validate();
+}
 
-    if (!image.valid()) {
+void SpriteImage::validate() const {
+    if (!pixels || size.isEmpty()) {
         throw util::SpriteImageException("Sprite image dimensions may not be zero");
     } else if (pixelRatio <= 0) {
         throw util::SpriteImageException("Sprite pixelRatio may not be <= 0");
+    } else if (size.width > pixels->size.width - origin.x || size.height > pixels->size.height - origin.y ||
+               origin.x > pixels->size.width || origin.y > pixels->size.height) {
+        throw util::SpriteImageException("Sprite image must lie within its sprite sheet");
+    }
+}
+
+PremultipliedImage SpriteImage::getImage() const {
+    PremultipliedImage result(size);
+    copy(result, { 0, 0 }, { 0, 0 }, size);
+    return result;
+}
+
+void SpriteImage::copy(PremultipliedImage& dst,
+                       const Point<uint32_t>& srcPt,
+                       const Point<uint32_t>& dstPt,
+                       const Size& copySize) const {
+    if (copySize.width > size.width || copySize.height > size.height ||
+        srcPt.x > size.width - copySize.width || srcPt.y > size.height - copySize.height) {
+        throw std::out_of_range("out of range source coordinates for image copy");
     }
+    PremultipliedImage::copy(*pixels, dst, { origin.x + srcPt.x, origin.y + srcPt.y }, dstPt, copySize);
 }
 
 } // namespace mbgl
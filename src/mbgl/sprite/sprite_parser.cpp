@@ -13,14 +13,15 @@
 
 namespace mbgl {
 
-SpriteImagePtr createSpriteImage(const PremultipliedImage& image,
-                                 const uint32_t srcX,
-                                 const uint32_t srcY,
-                                 const uint32_t width,
-                                 const uint32_t height,
-                                 const double ratio,
-                                 const bool sdf) {
-    // Disallow invalid parameter configurations.
+namespace {
+
+// Disallows invalid parameter configurations.
+bool isValidSpriteImage(const PremultipliedImage& image,
+                        const uint32_t srcX,
+                        const uint32_t srcY,
+                        const uint32_t width,
+                        const uint32_t height,
+                        const double ratio) {
     if (width <= 0 || height <= 0 || width > 1024 || height > 1024 ||
         ratio <= 0 || ratio > 10 ||
         srcX >= image.size.width || srcY >= image.size.height ||
@@ -29,6 +30,21 @@ SpriteImagePtr createSpriteImage(const PremultipliedImage& image,
             width, height, srcX, srcY,
             image.size.width, image.size.height,
             util::toString(ratio).c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+SpriteImagePtr createSpriteImage(const PremultipliedImage& image,
+                                 const uint32_t srcX,
+                                 const uint32_t srcY,
+                                 const uint32_t width,
+                                 const uint32_t height,
+                                 const double ratio,
+                                 const bool sdf) {
+    if (!isValidSpriteImage(image, srcX, srcY, width, height, ratio)) {
         return nullptr;
     }
 
@@ -40,6 +56,20 @@ SpriteImagePtr createSpriteImage(const PremultipliedImage& image,
     return std::make_unique<const SpriteImage>(std::move(dstImage), ratio, sdf);
 }
 
+SpriteImagePtr createSpriteImage(const std::shared_ptr<const PremultipliedImage>& sheet,
+                                 const uint32_t srcX,
+                                 const uint32_t srcY,
+                                 const uint32_t width,
+                                 const uint32_t height,
+                                 const double ratio,
+                                 const bool sdf) {
+    if (!isValidSpriteImage(*sheet, srcX, srcY, width, height, ratio)) {
+        return nullptr;
+    }
+
+    return std::make_shared<const SpriteImage>(sheet, Point<uint32_t>{ srcX, srcY }, Size{ width, height }, ratio, sdf);
+}
+
 namespace {
 
 uint16_t getUInt16(const JSValue& value, const char* name, const uint16_t def = 0) {
@@ -86,10 +116,11 @@ bool getBoolean(const JSValue& value, const char* name, const bool def = false)
 
 SpriteParseResult parseSprite(const std::string& image, const std::string& json) {
     Sprites sprites;
-    PremultipliedImage raster;
+    std::shared_ptr<const PremultipliedImage> raster;
 
     try {
-        raster = decodeImage(image);
+        // The sheet is kept as a whole for the images of the sprite, which only refer to it.
+        raster = std::make_shared<const PremultipliedImage>(decodeImage(image));
     } catch (...) {
         return std::current_exception();
     }
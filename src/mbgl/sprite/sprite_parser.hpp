@@ -24,6 +24,16 @@ SpriteImagePtr createSpriteImage(const PremultipliedImage&,
                                  double ratio,
                                  bool sdf);
 
+// Returns an individual image of a spritesheet at the given location, which shares the pixels of
+// the sheet instead of copying them.
+SpriteImagePtr createSpriteImage(const std::shared_ptr<const PremultipliedImage>&,
+                                 uint32_t srcX,
+                                 uint32_t srcY,
+                                 uint32_t srcWidth,
+                                 uint32_t srcHeight,
+                                 double ratio,
+                                 bool sdf);
+
 using Sprites = std::map<std::string, SpriteImagePtr>;
 
 
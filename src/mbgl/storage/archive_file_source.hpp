@@ -0,0 +1,29 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+namespace mbgl {
+
+namespace util {
+template <typename T> class Thread;
+} // namespace util
+
+// Serves tiles out of MBTiles and PMTiles archives on the local file system, given tile URL
+// templates such as "archive:///path/to/tileset.pmtiles/{z}/{x}/{y}" of sources with the default
+// "xyz" scheme: the path ends where the first token begins. Archives stay open, and
+// memory-mapped, for the lifetime of the source.
+class ArchiveFileSource : public FileSource {
+public:
+    ArchiveFileSource();
+    ~ArchiveFileSource() override;
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+    static bool acceptsURL(const std::string& url);
+
+private:
+    class Impl;
+    std::unique_ptr<util::Thread<Impl>> thread;
+};
+
+} // namespace mbgl
@@ -10,7 +10,10 @@ public:
     ~HTTPFileSource() override;
 
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+    void preconnect(const std::string& url) override;
 
+    // The number of requests to have in flight at once. Where requests to a host can share a
+    // connection, this is a number of streams rather than of connections.
     static uint32_t maximumConcurrentRequests();
 
     class Impl;
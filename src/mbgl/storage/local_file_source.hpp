@@ -2,6 +2,9 @@
 
 #include <mbgl/storage/file_source.hpp>
 
+#include <atomic>
+#include <vector>
+
 namespace mbgl {
 
 namespace util {
@@ -19,7 +22,11 @@ public:
 
 private:
     class Impl;
-    std::unique_ptr<util::Thread<Impl>> thread;
+
+    // Requests are handed to the threads in turn, so that a slow read doesn't hold up the
+    // requests behind it.
+    std::vector<std::unique_ptr<util::Thread<Impl>>> threads;
+    std::atomic<std::size_t> nextThread { 0 };
 };
 
 } // namespace mbgl
@@ -2,6 +2,8 @@
 
 #include <mbgl/util/async_task.hpp>
 
+#include <algorithm>
+
 // Example: Allocate a reachability object
 // Reachability* reach = [Reachability reachabilityForInternetConnection];
 // reach.reachableBlock = ^(Reachability* reach) { NetworkStatus::Reachable(); };
@@ -9,7 +11,23 @@
 
 namespace mbgl {
 
+namespace {
+
+// Transfers smaller than this mostly measure the latency of the request rather than the
+// throughput, and are left out of the estimate.
+const std::size_t minimumTransferSize = 4 * 1024;
+
+// How much each transfer moves the estimate, so that it follows a change of network within a
+// dozen tiles without jumping at every slow server.
+const double transferWeight = 0.2;
+
+// Below this, a retina raster tile takes a second or more to arrive.
+const double slowThroughput = 64 * 1024;
+
+} // namespace
+
 std::atomic<bool> NetworkStatus::online(true);
+std::atomic<double> NetworkStatus::throughput(0);
 std::mutex NetworkStatus::mtx;
 std::unordered_set<util::AsyncTask *> NetworkStatus::observers;
 
@@ -51,4 +69,30 @@ void NetworkStatus::Reachable() {
     }
 }
 
+double NetworkStatus::GetThroughput() {
+    return throughput;
+}
+
+void NetworkStatus::SetThroughput(double bytesPerSecond) {
+    throughput = std::max(0.0, bytesPerSecond);
+}
+
+void NetworkStatus::RecordTransfer(std::size_t bytes, Duration duration) {
+    if (bytes < minimumTransferSize || duration <= Duration::zero()) {
+        return;
+    }
+
+    const double sample = bytes / std::chrono::duration<double>(duration).count();
+    double estimate = throughput;
+    double updated;
+    do {
+        updated = estimate > 0 ? estimate + transferWeight * (sample - estimate) : sample;
+    } while (!throughput.compare_exchange_weak(estimate, updated));
+}
+
+bool NetworkStatus::IsSlow() {
+    const double estimate = throughput;
+    return estimate > 0 && estimate < slowThroughput;
+}
+
 } // namespace mbgl
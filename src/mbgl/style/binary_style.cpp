@@ -0,0 +1,445 @@
+#include <mbgl/style/binary_style.hpp>
+#include <mbgl/style/binary_style_conversion.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+using Type = BinaryStyleValue::Type;
+
+const char magic[4] = { 'M', 'B', 'S', 'B' };
+const uint32_t version = 1;
+const std::size_t headerSize = sizeof(magic) + sizeof(uint32_t);
+
+// Deeper values are rejected rather than risking the stack while they are validated.
+const unsigned maxDepth = 256;
+
+uint32_t readUint32(const char* data) {
+    uint32_t value = 0;
+    for (std::size_t i = 0; i < sizeof(value); i++) {
+        value |= uint32_t(uint8_t(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t readUint64(const char* data) {
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < sizeof(value); i++) {
+        value |= uint64_t(uint8_t(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+class Encoder {
+public:
+    std::string data;
+
+    void encode(const JSValue& value, unsigned depth) {
+        if (depth > maxDepth) {
+            throw std::runtime_error("style is nested too deeply");
+        }
+
+        switch (value.GetType()) {
+        case rapidjson::kNullType:
+            writeType(Type::Null);
+            break;
+
+        case rapidjson::kFalseType:
+            writeType(Type::False);
+            break;
+
+        case rapidjson::kTrueType:
+            writeType(Type::True);
+            break;
+
+        case rapidjson::kNumberType:
+            if (value.IsUint64()) {
+                writeType(Type::Uint);
+                writeUint64(value.GetUint64());
+            } else if (value.IsInt64()) {
+                writeType(Type::Int);
+                writeUint64(uint64_t(value.GetInt64()));
+            } else {
+                const double number = value.GetDouble();
+                uint64_t bits;
+                std::memcpy(&bits, &number, sizeof(bits));
+                writeType(Type::Double);
+                writeUint64(bits);
+            }
+            break;
+
+        case rapidjson::kStringType:
+            writeType(Type::String);
+            writeString(value.GetString(), value.GetStringLength());
+            break;
+
+        case rapidjson::kArrayType: {
+            writeType(Type::Array);
+            const std::size_t end = reserveUint32();
+            writeUint32(value.Size());
+            const std::size_t offsets = data.size();
+            data.append(value.Size() * sizeof(uint32_t), '\0');
+            for (rapidjson::SizeType i = 0; i < value.Size(); i++) {
+                patchUint32(offsets + i * sizeof(uint32_t), data.size());
+                encode(value[i], depth + 1);
+            }
+            patchUint32(end, data.size());
+            break;
+        }
+
+        case rapidjson::kObjectType: {
+            writeType(Type::Object);
+            const std::size_t end = reserveUint32();
+            writeUint32(value.MemberCount());
+            for (const auto& member : value.GetObject()) {
+                writeString(member.name.GetString(), member.name.GetStringLength());
+                encode(member.value, depth + 1);
+            }
+            patchUint32(end, data.size());
+            break;
+        }
+        }
+    }
+
+    void writeUint32(std::size_t value) {
+        if (value > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("style is too large to encode");
+        }
+        for (std::size_t i = 0; i < sizeof(uint32_t); i++) {
+            data.push_back(char((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+private:
+    void writeType(Type type) {
+        data.push_back(char(type));
+    }
+
+    void writeUint64(uint64_t value) {
+        for (std::size_t i = 0; i < sizeof(value); i++) {
+            data.push_back(char((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void writeString(const char* string, std::size_t length) {
+        writeUint32(length);
+        data.append(string, length);
+    }
+
+    std::size_t reserveUint32() {
+        const std::size_t position = data.size();
+        data.append(sizeof(uint32_t), '\0');
+        return position;
+    }
+
+    void patchUint32(std::size_t position, std::size_t value) {
+        if (value > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("style is too large to encode");
+        }
+        for (std::size_t i = 0; i < sizeof(uint32_t); i++) {
+            data[position + i] = char((value >> (8 * i)) & 0xFF);
+        }
+    }
+};
+
+class Validator {
+public:
+    explicit Validator(const std::string& data_) : data(data_) {}
+
+    // Returns the end of the value that starts at the offset, which must end by the limit.
+    std::size_t validate(std::size_t offset, std::size_t limit, unsigned depth) const {
+        if (depth > maxDepth || offset >= limit) {
+            corrupt();
+        }
+
+        const std::size_t start = offset + 1;
+        switch (Type(data[offset])) {
+        case Type::Null:
+        case Type::False:
+        case Type::True:
+            return start;
+
+        case Type::Uint:
+        case Type::Int:
+        case Type::Double:
+            return bounded(start, sizeof(uint64_t), limit);
+
+        case Type::String:
+            return string(start, limit);
+
+        case Type::Array: {
+            const std::size_t end = uint32(start, limit);
+            if (end > limit) {
+                corrupt();
+            }
+            const std::size_t count = uint32(start + sizeof(uint32_t), end);
+            const std::size_t offsets = start + 2 * sizeof(uint32_t);
+            std::size_t position = bounded(offsets, count * sizeof(uint32_t), end);
+            for (std::size_t i = 0; i < count; i++) {
+                // The elements follow each other in order.
+                if (uint32(offsets + i * sizeof(uint32_t), end) != position) {
+                    corrupt();
+                }
+                position = validate(position, end, depth + 1);
+            }
+            if (position != end) {
+                corrupt();
+            }
+            return end;
+        }
+
+        case Type::Object: {
+            const std::size_t end = uint32(start, limit);
+            if (end > limit) {
+                corrupt();
+            }
+            const std::size_t count = uint32(start + sizeof(uint32_t), end);
+            std::size_t position = start + 2 * sizeof(uint32_t);
+            for (std::size_t i = 0; i < count; i++) {
+                position = validate(string(position, end), end, depth + 1);
+            }
+            if (position != end) {
+                corrupt();
+            }
+            return end;
+        }
+
+        default:
+            corrupt();
+        }
+    }
+
+private:
+    [[noreturn]] static void corrupt() {
+        throw std::runtime_error("binary style is truncated or corrupt");
+    }
+
+    static std::size_t bounded(std::size_t offset, std::size_t size, std::size_t limit) {
+        if (offset > limit || size > limit - offset) {
+            corrupt();
+        }
+        return offset + size;
+    }
+
+    std::size_t uint32(std::size_t offset, std::size_t limit) const {
+        bounded(offset, sizeof(uint32_t), limit);
+        return readUint32(data.data() + offset);
+    }
+
+    std::size_t string(std::size_t offset, std::size_t limit) const {
+        const std::size_t length = uint32(offset, limit);
+        return bounded(offset + sizeof(uint32_t), length, limit);
+    }
+
+    const std::string& data;
+};
+
+} // namespace
+
+std::string encodeBinaryStyle(const std::string& json) {
+    JSDocument document;
+    document.Parse<0>(json.c_str());
+
+    if (document.HasParseError()) {
+        std::stringstream message;
+        message << document.GetErrorOffset() << " - "
+            << rapidjson::GetParseError_En(document.GetParseError());
+        throw std::runtime_error(message.str());
+    }
+
+    Encoder encoder;
+    encoder.data.append(magic, sizeof(magic));
+    encoder.writeUint32(version);
+    encoder.encode(document, 0);
+    return std::move(encoder.data);
+}
+
+BinaryStyleValue decodeBinaryStyle(const std::string& data) {
+    if (data.size() < headerSize || std::memcmp(data.data(), magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("data is not a binary style");
+    }
+    if (readUint32(data.data() + sizeof(magic)) != version) {
+        throw std::runtime_error("unsupported binary style version");
+    }
+    if (Validator(data).validate(headerSize, data.size(), 0) != data.size()) {
+        throw std::runtime_error("binary style is truncated or corrupt");
+    }
+    return { data.data(), headerSize };
+}
+
+BinaryStyleValue::BinaryStyleValue(const char* data_, std::size_t offset_)
+    : data(data_),
+      offset(offset_) {
+}
+
+BinaryStyleValue::Type BinaryStyleValue::getType() const {
+    return Type(data[offset]);
+}
+
+uint64_t BinaryStyleValue::getUint() const {
+    assert(getType() == Type::Uint);
+    return readUint64(data + offset + 1);
+}
+
+int64_t BinaryStyleValue::getInt() const {
+    assert(getType() == Type::Int);
+    return int64_t(readUint64(data + offset + 1));
+}
+
+double BinaryStyleValue::getDouble() const {
+    assert(getType() == Type::Double);
+    const uint64_t bits = readUint64(data + offset + 1);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string BinaryStyleValue::getString() const {
+    assert(getType() == Type::String);
+    return { data + offset + 1 + sizeof(uint32_t), readUint32(data + offset + 1) };
+}
+
+std::size_t BinaryStyleValue::size() const {
+    assert(getType() == Type::Array || getType() == Type::Object);
+    return readUint32(data + offset + 1 + sizeof(uint32_t));
+}
+
+BinaryStyleValue BinaryStyleValue::operator[](std::size_t i) const {
+    assert(getType() == Type::Array && i < size());
+    return { data, readUint32(data + offset + 1 + (2 + i) * sizeof(uint32_t)) };
+}
+
+optional<BinaryStyleValue> BinaryStyleValue::member(const char* name) const {
+    assert(getType() == Type::Object);
+    const std::size_t length = std::strlen(name);
+    const std::size_t count = size();
+    std::size_t position = offset + 1 + 2 * sizeof(uint32_t);
+    for (std::size_t i = 0; i < count; i++) {
+        const uint32_t keyLength = readUint32(data + position);
+        const char* key = data + position + sizeof(uint32_t);
+        BinaryStyleValue value { data, position + sizeof(uint32_t) + keyLength };
+        if (keyLength == length && std::memcmp(key, name, length) == 0) {
+            return value;
+        }
+        position = value.end();
+    }
+    return {};
+}
+
+void BinaryStyleValue::eachMember(const std::function<bool (const std::string&, const BinaryStyleValue&)>& fn) const {
+    assert(getType() == Type::Object);
+    const std::size_t count = size();
+    std::size_t position = offset + 1 + 2 * sizeof(uint32_t);
+    for (std::size_t i = 0; i < count; i++) {
+        const uint32_t keyLength = readUint32(data + position);
+        const std::string key { data + position + sizeof(uint32_t), keyLength };
+        BinaryStyleValue value { data, position + sizeof(uint32_t) + keyLength };
+        if (!fn(key, value)) {
+            return;
+        }
+        position = value.end();
+    }
+}
+
+std::size_t BinaryStyleValue::end() const {
+    switch (getType()) {
+    case Type::Null:
+    case Type::False:
+    case Type::True:
+        return offset + 1;
+
+    case Type::Uint:
+    case Type::Int:
+    case Type::Double:
+        return offset + 1 + sizeof(uint64_t);
+
+    case Type::String:
+        return offset + 1 + sizeof(uint32_t) + readUint32(data + offset + 1);
+
+    case Type::Array:
+    case Type::Object:
+        return readUint32(data + offset + 1);
+    }
+    return offset + 1;
+}
+
+namespace conversion {
+
+namespace {
+
+// Copies the value into a RapidJSON value.
+void toJSValue(const BinaryStyleValue& value, JSValue& result, rapidjson::CrtAllocator& allocator) {
+    switch (value.getType()) {
+    case Type::Null:
+        result.SetNull();
+        break;
+
+    case Type::False:
+        result.SetBool(false);
+        break;
+
+    case Type::True:
+        result.SetBool(true);
+        break;
+
+    case Type::Uint:
+        result.SetUint64(value.getUint());
+        break;
+
+    case Type::Int:
+        result.SetInt64(value.getInt());
+        break;
+
+    case Type::Double:
+        result.SetDouble(value.getDouble());
+        break;
+
+    case Type::String: {
+        const std::string string = value.getString();
+        result.SetString(string.data(), rapidjson::SizeType(string.size()), allocator);
+        break;
+    }
+
+    case Type::Array:
+        result.SetArray();
+        for (std::size_t i = 0; i < value.size(); i++) {
+            JSValue element;
+            toJSValue(value[i], element, allocator);
+            result.PushBack(element, allocator);
+        }
+        break;
+
+    case Type::Object:
+        result.SetObject();
+        value.eachMember([&] (const std::string& name, const BinaryStyleValue& member) {
+            JSValue key { name.data(), rapidjson::SizeType(name.size()), allocator };
+            JSValue element;
+            toJSValue(member, element, allocator);
+            result.AddMember(key, element, allocator);
+            return true;
+        });
+        break;
+    }
+}
+
+} // namespace
+
+template <>
+optional<GeoJSON> convertGeoJSON(const BinaryStyleValue& value, Error& error) {
+    // GeoJSON is converted from RapidJSON values; inline data is rare and usually small.
+    JSDocument document;
+    toJSValue(value, document, document.GetAllocator());
+    return convertGeoJSON<JSValue>(document, error);
+}
+
+} // namespace conversion
+
+} // namespace style
+} // namespace mbgl
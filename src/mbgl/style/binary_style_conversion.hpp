@@ -0,0 +1,168 @@
+#pragma once
+
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/style/conversion/geojson.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace mbgl {
+namespace style {
+
+// A value of a style that encodeBinaryStyle has encoded. Refers to the encoded data, which must
+// outlive it.
+//
+// All numbers are little-endian, and offsets are relative to the start of the data. Each value
+// starts with the byte of its type, which scalars follow with their 64 bit value, and strings
+// with their 32 bit length and bytes. Arrays and objects follow it with the offset of their end and
+// their 32 bit member count. Then arrays have the offsets of their elements, and then the
+// elements; objects have their members, each a key, encoded like a string without its type, and
+// a value.
+class BinaryStyleValue {
+public:
+    enum class Type : uint8_t {
+        Null,
+        False,
+        True,
+        Uint,
+        Int,
+        Double,
+        String,
+        Array,
+        Object,
+    };
+
+    BinaryStyleValue(const char* data, std::size_t offset);
+
+    Type getType() const;
+
+    uint64_t getUint() const;
+    int64_t getInt() const;
+    double getDouble() const;
+    std::string getString() const;
+
+    // The number of elements of an array, or of members of an object.
+    std::size_t size() const;
+    BinaryStyleValue operator[](std::size_t) const;
+
+    optional<BinaryStyleValue> member(const char* name) const;
+
+    // Calls the function with each member of the object, until it returns false.
+    void eachMember(const std::function<bool (const std::string&, const BinaryStyleValue&)>&) const;
+
+private:
+    // The offset of the byte that follows the value.
+    std::size_t end() const;
+
+    const char* data;
+    std::size_t offset;
+};
+
+// Validates the binary style and returns its root value. Throws std::runtime_error if the data
+// isn't a binary style, or is truncated or corrupt.
+BinaryStyleValue decodeBinaryStyle(const std::string& data);
+
+namespace conversion {
+
+inline bool isUndefined(const BinaryStyleValue& value) {
+    return value.getType() == BinaryStyleValue::Type::Null;
+}
+
+inline bool isArray(const BinaryStyleValue& value) {
+    return value.getType() == BinaryStyleValue::Type::Array;
+}
+
+inline std::size_t arrayLength(const BinaryStyleValue& value) {
+    return value.size();
+}
+
+inline BinaryStyleValue arrayMember(const BinaryStyleValue& value, std::size_t i) {
+    return value[i];
+}
+
+inline bool isObject(const BinaryStyleValue& value) {
+    return value.getType() == BinaryStyleValue::Type::Object;
+}
+
+inline optional<BinaryStyleValue> objectMember(const BinaryStyleValue& value, const char* name) {
+    return value.member(name);
+}
+
+template <class Fn>
+optional<Error> eachMember(const BinaryStyleValue& value, Fn&& fn) {
+    assert(isObject(value));
+    optional<Error> result;
+    value.eachMember([&] (const std::string& name, const BinaryStyleValue& member) {
+        result = fn(name, member);
+        return !result;
+    });
+    return result;
+}
+
+inline optional<bool> toBool(const BinaryStyleValue& value) {
+    switch (value.getType()) {
+        case BinaryStyleValue::Type::False:
+            return false;
+        case BinaryStyleValue::Type::True:
+            return true;
+        default:
+            return {};
+    }
+}
+
+inline optional<float> toNumber(const BinaryStyleValue& value) {
+    switch (value.getType()) {
+        case BinaryStyleValue::Type::Uint:
+            return float(value.getUint());
+        case BinaryStyleValue::Type::Int:
+            return float(value.getInt());
+        case BinaryStyleValue::Type::Double:
+            return float(value.getDouble());
+        default:
+            return {};
+    }
+}
+
+inline optional<std::string> toString(const BinaryStyleValue& value) {
+    if (value.getType() != BinaryStyleValue::Type::String) {
+        return {};
+    }
+    return value.getString();
+}
+
+inline optional<Value> toValue(const BinaryStyleValue& value) {
+    switch (value.getType()) {
+        case BinaryStyleValue::Type::Null:
+        case BinaryStyleValue::Type::False:
+            return { false };
+
+        case BinaryStyleValue::Type::True:
+            return { true };
+
+        case BinaryStyleValue::Type::Uint:
+            return { value.getUint() };
+
+        case BinaryStyleValue::Type::Int:
+            return { value.getInt() };
+
+        case BinaryStyleValue::Type::Double:
+            return { value.getDouble() };
+
+        case BinaryStyleValue::Type::String:
+            return { value.getString() };
+
+        default:
+            return {};
+    }
+}
+
+template <>
+optional<GeoJSON> convertGeoJSON(const BinaryStyleValue&, Error&);
+
+} // namespace conversion
+} // namespace style
+} // namespace mbgl
@@ -3,6 +3,8 @@
 #include <mbgl/map/mode.hpp>
 #include <mbgl/tile/tile_id.hpp>
 
+#include <atomic>
+
 namespace mbgl {
 namespace style {
 
@@ -10,6 +12,14 @@ class BucketParameters {
 public:
     const OverscaledTileID tileID;
     const MapMode mode;
+    // Whether fill buckets record the index of the feature of each vertex, for the picking buffer.
+    const bool featurePicking = false;
+    // Whether the tile is rendered multisampled, so that fill buckets leave out the outlines
+    // that only antialias their edges.
+    const bool multisampling = false;
+    // Set once the tile is being destroyed, so that buckets and layouts stop adding features
+    // midway through long ones. Only read while features are added.
+    const std::atomic<bool>* obsolete = nullptr;
 };
 
 } // namespace style
@@ -0,0 +1,14 @@
+#include <mbgl/style/camera_function_cache.hpp>
+
+#include <atomic>
+
+namespace mbgl {
+namespace style {
+
+uint64_t CameraFunctionCache::nextSerial() {
+    static std::atomic<uint64_t> serial { 1 };
+    return serial++;
+}
+
+} // namespace style
+} // namespace mbgl
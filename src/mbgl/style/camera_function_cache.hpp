@@ -0,0 +1,165 @@
+#pragma once
+
+#include <mbgl/style/function/camera_function.hpp>
+#include <mbgl/style/property_value.hpp>
+#include <mbgl/style/data_driven_property_value.hpp>
+#include <mbgl/style/property_evaluation_parameters.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace mbgl {
+namespace style {
+
+/*
+   Results of camera functions, keyed by their serials and the zoom levels that they were
+   evaluated at. Style layers that share a deduplicated function, such as the same width ramp
+   of many road layers, evaluate it once per zoom level rather than once per layer.
+
+   A style owns one cache, which is only used on the thread that evaluates its paint
+   properties. The most recent zoom levels of each function are kept, since cross-fading and
+   line dash patterns evaluate it at neighbouring and integer zoom levels too.
+*/
+class CameraFunctionCache : private util::noncopyable {
+public:
+    // Returns the function with the serial of an identical function that was deduplicated
+    // before, or with a new serial.
+    template <class T>
+    static CameraFunction<T> deduplicate(CameraFunction<T>);
+
+    template <class T>
+    static PropertyValue<T> deduplicate(PropertyValue<T>);
+
+    template <class T>
+    static DataDrivenPropertyValue<T> deduplicate(DataDrivenPropertyValue<T>);
+
+    template <class T>
+    T evaluate(const CameraFunction<T>&, float zoom);
+
+    // Forgets the results, including those of functions that aren't used anymore.
+    void clear() {
+        entries.clear();
+    }
+
+    // The number of distinct functions with results.
+    std::size_t size() const {
+        return entries.size();
+    }
+
+private:
+    static uint64_t nextSerial();
+
+    class EntryBase {
+    public:
+        virtual ~EntryBase() = default;
+    };
+
+    template <class T>
+    class Entry : public EntryBase {
+    public:
+        std::array<optional<std::pair<float, T>>, 4> results;
+        std::size_t next = 0;
+    };
+
+    // Serials are unique among the functions of all types, so each entry has the type of the
+    // function that made it.
+    std::unordered_map<uint64_t, std::unique_ptr<EntryBase>> entries;
+};
+
+template <class T>
+CameraFunction<T> CameraFunctionCache::deduplicate(CameraFunction<T> function) {
+    static std::mutex mutex;
+    static std::unordered_multimap<std::size_t, CameraFunction<T>> functions;
+
+    // Functions that differ in their stop outputs or bases collide; equality tells them apart.
+    std::size_t key = function.stops.which();
+    function.stops.match([&] (const auto& stops) {
+        boost::hash_combine(key, stops.stops.size());
+        for (const auto& stop : stops.stops) {
+            boost::hash_combine(key, stop.first);
+        }
+    });
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const auto range = functions.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == function) {
+            function.serial = it->second.serial;
+            return function;
+        }
+    }
+
+    // Functions that were forgotten keep their serials; identical ones that are deduplicated
+    // afterwards get a new one.
+    if (functions.size() >= 4096) {
+        functions.clear();
+    }
+
+    function.serial = nextSerial();
+    functions.emplace(key, function);
+    return function;
+}
+
+template <class T>
+PropertyValue<T> CameraFunctionCache::deduplicate(PropertyValue<T> value) {
+    if (value.isCameraFunction()) {
+        return deduplicate(value.asCameraFunction());
+    }
+    return value;
+}
+
+template <class T>
+DataDrivenPropertyValue<T> CameraFunctionCache::deduplicate(DataDrivenPropertyValue<T> value) {
+    return value.match(
+        [&] (const CameraFunction<T>& function) -> DataDrivenPropertyValue<T> {
+            return deduplicate(function);
+        },
+        [&] (const auto&) {
+            return value;
+        }
+    );
+}
+
+template <class T>
+T CameraFunctionCache::evaluate(const CameraFunction<T>& function, float zoom) {
+    if (!function.serial) {
+        return function.evaluate(zoom);
+    }
+
+    std::unique_ptr<EntryBase>& base = entries[function.serial];
+    if (!base) {
+        base = std::make_unique<Entry<T>>();
+    }
+    auto& entry = static_cast<Entry<T>&>(*base);
+
+    for (const auto& result : entry.results) {
+        if (result && result->first == zoom) {
+            return result->second;
+        }
+    }
+
+    T value = function.evaluate(zoom);
+    entry.results[entry.next] = std::make_pair(zoom, value);
+    entry.next = (entry.next + 1) % entry.results.size();
+    return value;
+}
+
+// Evaluates the function at the zoom level, through the cache of the parameters if they have one.
+template <class T>
+T evaluate(const CameraFunction<T>& function, float zoom, const PropertyEvaluationParameters& parameters) {
+    return parameters.functionCache
+        ? parameters.functionCache->evaluate(function, zoom)
+        : function.evaluate(zoom);
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,223 @@
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/conversion/stringify.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace mbgl {
+namespace style {
+
+class FilterCompiler {
+public:
+    CompiledFilter& result;
+
+    void operator()(const NullFilter&) {
+        emit(CompiledFilter::Op::True);
+    }
+
+    void operator()(const EqualsFilter& filter) {
+        emit(CompiledFilter::Op::Equals, filter.key, { filter.value });
+    }
+
+    void operator()(const NotEqualsFilter& filter) {
+        emit(CompiledFilter::Op::NotEquals, filter.key, { filter.value });
+    }
+
+    void operator()(const LessThanFilter& filter) {
+        emit(CompiledFilter::Op::LessThan, filter.key, { filter.value });
+    }
+
+    void operator()(const LessThanEqualsFilter& filter) {
+        emit(CompiledFilter::Op::LessThanEquals, filter.key, { filter.value });
+    }
+
+    void operator()(const GreaterThanFilter& filter) {
+        emit(CompiledFilter::Op::GreaterThan, filter.key, { filter.value });
+    }
+
+    void operator()(const GreaterThanEqualsFilter& filter) {
+        emit(CompiledFilter::Op::GreaterThanEquals, filter.key, { filter.value });
+    }
+
+    void operator()(const InFilter& filter) {
+        emit(CompiledFilter::Op::In, filter.key, filter.values);
+    }
+
+    void operator()(const NotInFilter& filter) {
+        emit(CompiledFilter::Op::NotIn, filter.key, filter.values);
+    }
+
+    void operator()(const AnyFilter& filter) {
+        emit(CompiledFilter::Op::Any, filter.filters);
+    }
+
+    void operator()(const AllFilter& filter) {
+        emit(CompiledFilter::Op::All, filter.filters);
+    }
+
+    void operator()(const NoneFilter& filter) {
+        emit(CompiledFilter::Op::None, filter.filters);
+    }
+
+    void operator()(const HasFilter& filter) {
+        emit(CompiledFilter::Op::Has, filter.key, {});
+    }
+
+    void operator()(const NotHasFilter& filter) {
+        emit(CompiledFilter::Op::NotHas, filter.key, {});
+    }
+
+    void operator()(const TypeEqualsFilter& filter) {
+        emit(CompiledFilter::Op::TypeIn, result.types, { filter.value });
+    }
+
+    void operator()(const TypeNotEqualsFilter& filter) {
+        emit(CompiledFilter::Op::TypeNotIn, result.types, { filter.value });
+    }
+
+    void operator()(const TypeInFilter& filter) {
+        emit(CompiledFilter::Op::TypeIn, result.types, filter.values);
+    }
+
+    void operator()(const TypeNotInFilter& filter) {
+        emit(CompiledFilter::Op::TypeNotIn, result.types, filter.values);
+    }
+
+    void operator()(const IdentifierEqualsFilter& filter) {
+        emit(CompiledFilter::Op::IdentifierIn, result.identifiers, { filter.value });
+    }
+
+    void operator()(const IdentifierNotEqualsFilter& filter) {
+        emit(CompiledFilter::Op::IdentifierNotIn, result.identifiers, { filter.value });
+    }
+
+    void operator()(const IdentifierInFilter& filter) {
+        emit(CompiledFilter::Op::IdentifierIn, result.identifiers, filter.values);
+    }
+
+    void operator()(const IdentifierNotInFilter& filter) {
+        emit(CompiledFilter::Op::IdentifierNotIn, result.identifiers, filter.values);
+    }
+
+    void operator()(const HasIdentifierFilter&) {
+        emit(CompiledFilter::Op::HasIdentifier);
+    }
+
+    void operator()(const NotHasIdentifierFilter&) {
+        emit(CompiledFilter::Op::NotHasIdentifier);
+    }
+
+private:
+    uint32_t intern(const std::string& key) {
+        auto it = std::find(result.keys.begin(), result.keys.end(), key);
+        if (it != result.keys.end()) {
+            return it - result.keys.begin();
+        }
+        result.keys.push_back(key);
+        return result.keys.size() - 1;
+    }
+
+    void emit(CompiledFilter::Op op, uint32_t key = 0, uint32_t first = 0, uint32_t last = 0) {
+        const uint32_t pc = result.program.size();
+        result.program.push_back({ op, key, first, last, pc + 1 });
+    }
+
+    template <class T>
+    void emit(CompiledFilter::Op op, std::vector<T>& operands, const std::vector<T>& values) {
+        const uint32_t first = operands.size();
+        operands.insert(operands.end(), values.begin(), values.end());
+        emit(op, 0, first, operands.size());
+    }
+
+    void emit(CompiledFilter::Op op, const std::string& key, const std::vector<Value>& values) {
+        const uint32_t first = result.values.size();
+        result.values.insert(result.values.end(), values.begin(), values.end());
+        emit(op, intern(key), first, result.values.size());
+    }
+
+    void emit(CompiledFilter::Op op, const std::vector<Filter>& filters) {
+        const uint32_t pc = result.program.size();
+        emit(op);
+        for (const auto& filter : filters) {
+            Filter::visit(filter, *this);
+        }
+        result.program[pc].next = result.program.size();
+    }
+};
+
+namespace {
+
+std::atomic<uint64_t> nextSerial { 1 };
+
+std::string filterKey(const Filter& filter) {
+    rapidjson::StringBuffer s;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+    conversion::stringify(writer, filter);
+    return s.GetString();
+}
+
+} // namespace
+
+CompiledFilter::CompiledFilter(const Filter& filter_)
+    : filter(filter_),
+      serial(nextSerial++) {
+    Filter::visit(filter, FilterCompiler { *this });
+}
+
+std::shared_ptr<const CompiledFilter> CompiledFilter::get(const Filter& filter) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::weak_ptr<const CompiledFilter>> cache;
+    static std::size_t sizeAfterPruning = 0;
+
+    const std::string key = filterKey(filter);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::weak_ptr<const CompiledFilter>& entry = cache[key];
+    if (auto existing = entry.lock()) {
+        if (existing->getFilter() == filter) {
+            return existing;
+        }
+        // Filters that differ only in the types of their numeric values stringify the same,
+        // but don't necessarily evaluate the same.
+        return std::make_shared<const CompiledFilter>(filter);
+    }
+
+    auto compiled = std::make_shared<const CompiledFilter>(filter);
+    entry = compiled;
+
+    if (cache.size() > 2 * sizeAfterPruning) {
+        for (auto it = cache.begin(); it != cache.end();) {
+            it = it->second.expired() ? cache.erase(it) : std::next(it);
+        }
+        sizeAfterPruning = cache.size();
+    }
+
+    return compiled;
+}
+
+bool CompiledFilter::operator()(const Feature& feature) const {
+    struct Accessor {
+        const Feature& feature;
+        const std::vector<std::string>& keys;
+
+        FeatureType getType() const { return apply_visitor(ToFeatureType(), feature.geometry); }
+        optional<FeatureIdentifier> getID() const { return feature.id; }
+        optional<Value> getValue(std::size_t key) const {
+            auto it = feature.properties.find(keys[key]);
+            if (it == feature.properties.end())
+                return {};
+            return it->second;
+        }
+    };
+    return evaluate(Accessor { feature, keys });
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <mbgl/style/filter.hpp>
+#include <mbgl/style/filter_evaluator.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+/*
+   A `Filter` compiled into a flat array of instructions, which is evaluated without visiting
+   the variant tree or constructing a `FilterEvaluator` for each feature.
+
+   Property keys are interned: instructions refer to them by their index in `getKeys()`, so
+   that the source of the features can resolve each key once per filter rather than once per
+   comparison. Features are evaluated through an accessor object with the members
+
+       FeatureType getType() const;
+       optional<FeatureIdentifier> getID() const;
+       optional<Value> getValue(std::size_t key) const; // key indexes getKeys()
+
+   Compiled filters are immutable. Use `CompiledFilter::get` to share them between layers
+   with identical filters.
+*/
+class CompiledFilter {
+public:
+    // Returns the compiled form of the filter, shared with other users of an identical filter.
+    static std::shared_ptr<const CompiledFilter> get(const Filter&);
+
+    explicit CompiledFilter(const Filter&);
+
+    const Filter& getFilter() const { return filter; }
+    const std::vector<std::string>& getKeys() const { return keys; }
+
+    // Unique among all compiled filters created during the lifetime of the process, unlike
+    // their addresses.
+    uint64_t getSerial() const { return serial; }
+
+    bool operator()(const Feature&) const;
+
+    template <class GeometryTileFeature>
+    bool operator()(const GeometryTileFeature&) const;
+
+    template <class Accessor>
+    bool evaluate(const Accessor&) const;
+
+private:
+    friend class FilterCompiler;
+
+    enum class Op : uint8_t {
+        True,
+        Equals,
+        NotEquals,
+        LessThan,
+        LessThanEquals,
+        GreaterThan,
+        GreaterThanEquals,
+        In,
+        NotIn,
+        Has,
+        NotHas,
+        TypeIn,
+        TypeNotIn,
+        IdentifierIn,
+        IdentifierNotIn,
+        HasIdentifier,
+        NotHasIdentifier,
+        Any,
+        All,
+        None,
+    };
+
+    struct Instruction {
+        Op op;
+        // Index into `keys`, for property instructions.
+        uint32_t key;
+        // Range of operands, in the operand array for the kind of instruction.
+        uint32_t first;
+        uint32_t last;
+        // Index of the instruction that follows this one and its operand instructions.
+        uint32_t next;
+    };
+
+    template <class Accessor>
+    bool evaluate(const Accessor&, std::size_t pc) const;
+
+    const Filter filter;
+    const uint64_t serial;
+
+    std::vector<Instruction> program;
+    std::vector<std::string> keys;
+    std::vector<Value> values;
+    std::vector<FeatureType> types;
+    std::vector<FeatureIdentifier> identifiers;
+};
+
+template <class GeometryTileFeature>
+bool CompiledFilter::operator()(const GeometryTileFeature& feature) const {
+    struct Accessor {
+        const GeometryTileFeature& feature;
+        const std::vector<std::string>& keys;
+
+        FeatureType getType() const { return feature.getType(); }
+        optional<FeatureIdentifier> getID() const { return feature.getID(); }
+        optional<Value> getValue(std::size_t key) const { return feature.getValue(keys[key]); }
+    };
+    return evaluate(Accessor { feature, keys });
+}
+
+template <class Accessor>
+bool CompiledFilter::evaluate(const Accessor& accessor) const {
+    return evaluate(accessor, 0);
+}
+
+template <class Accessor>
+bool CompiledFilter::evaluate(const Accessor& accessor, std::size_t pc) const {
+    const Instruction& instruction = program[pc];
+
+    switch (instruction.op) {
+    case Op::True:
+        return true;
+
+    case Op::Equals: {
+        optional<Value> actual = accessor.getValue(instruction.key);
+        return actual && equalValues(*actual, values[instruction.first]);
+    }
+
+    case Op::NotEquals: {
+        optional<Value> actual = accessor.getValue(instruction.key);
+        return !actual || !equalValues(*actual, values[instruction.first]);
+    }
+
+    case Op::LessThan: {
+        optional<Value> actual = accessor.getValue(instruction.key);
+        return actual && compareValues(*actual, values[instruction.first], [] (const auto& lhs_, const auto& rhs_) { return lhs_ < rhs_; });
+    }
+
+    case Op::LessThanEquals: {
+        optional<Value> actual = accessor.getValue(instruction.key);
+        return actual && compareValues(*actual, values[instruction.first], [] (const auto& lhs_, const auto& rhs_) { return lhs_ <= rhs_; });
+    }
+
+    case Op::GreaterThan: {
+        optional<Value> actual = accessor.getValue(instruction.key);
+        return actual && compareValues(*actual, values[instruction.first], [] (const auto& lhs_, const auto& rhs_) { return lhs_ > rhs_; });
+    }
+
+    case Op::GreaterThanEquals: {
+        optional<Value> actual = accessor.getValue(instruction.key);
+        return actual && compareValues(*actual, values[instruction.first], [] (const auto& lhs_, const auto& rhs_) { return lhs_ >= rhs_; });
+    }
+
+    case Op::In:
+    case Op::NotIn: {
+        const bool in = instruction.op == Op::In;
+        optional<Value> actual = accessor.getValue(instruction.key);
+        if (!actual) {
+            return !in;
+        }
+        for (uint32_t i = instruction.first; i < instruction.last; ++i) {
+            if (equalValues(*actual, values[i])) {
+                return in;
+            }
+        }
+        return !in;
+    }
+
+    case Op::Has:
+        return bool(accessor.getValue(instruction.key));
+
+    case Op::NotHas:
+        return !accessor.getValue(instruction.key);
+
+    case Op::TypeIn:
+    case Op::TypeNotIn: {
+        const bool in = instruction.op == Op::TypeIn;
+        const FeatureType type = accessor.getType();
+        for (uint32_t i = instruction.first; i < instruction.last; ++i) {
+            if (type == types[i]) {
+                return in;
+            }
+        }
+        return !in;
+    }
+
+    case Op::IdentifierIn:
+    case Op::IdentifierNotIn: {
+        const bool in = instruction.op == Op::IdentifierIn;
+        const optional<FeatureIdentifier> id = accessor.getID();
+        for (uint32_t i = instruction.first; i < instruction.last; ++i) {
+            if (id == identifiers[i]) {
+                return in;
+            }
+        }
+        return !in;
+    }
+
+    case Op::HasIdentifier:
+        return bool(accessor.getID());
+
+    case Op::NotHasIdentifier:
+        return !accessor.getID();
+
+    case Op::Any:
+        for (std::size_t child = pc + 1; child < instruction.next; child = program[child].next) {
+            if (evaluate(accessor, child)) {
+                return true;
+            }
+        }
+        return false;
+
+    case Op::All:
+        for (std::size_t child = pc + 1; child < instruction.next; child = program[child].next) {
+            if (!evaluate(accessor, child)) {
+                return false;
+            }
+        }
+        return true;
+
+    case Op::None:
+        for (std::size_t child = pc + 1; child < instruction.next; child = program[child].next) {
+            if (evaluate(accessor, child)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace style
+} // namespace mbgl
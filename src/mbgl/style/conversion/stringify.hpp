@@ -3,11 +3,13 @@
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/property_value.hpp>
 #include <mbgl/style/layout_property.hpp>
+#include <mbgl/style/possibly_evaluated_property_value.hpp>
 #include <mbgl/util/enum.hpp>
 #include <mbgl/util/color.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/ignore.hpp>
 #include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/type_list.hpp>
 
 #include <array>
 #include <vector>
@@ -453,6 +455,24 @@ void stringify(Writer& writer, const LayoutProperties<Ps...>& ps) {
     writer.EndObject();
 }
 
+template <class Writer, class T>
+void stringify(Writer& writer, const PossiblyEvaluatedPropertyValue<T>& v) {
+    v.match([&] (const auto& v_) { stringify(writer, v_); });
+}
+
+template <class Writer, class Evaluated, class... Ps>
+void stringifyEvaluated(Writer& writer, const Evaluated& evaluated, TypeList<Ps...>) {
+    writer.StartArray();
+    util::ignore({ (stringify(writer, evaluated.template get<Ps>()), 0)... });
+    writer.EndArray();
+}
+
+// Writes the evaluated values of the data-driven properties of a set of paint properties.
+template <class Writer, class PaintProperties>
+void stringifyDataDriven(Writer& writer, const PaintProperties& ps) {
+    stringifyEvaluated(writer, ps.evaluated, typename PaintProperties::DataDrivenProperties());
+}
+
 } // namespace conversion
 } // namespace style
 } // namespace mbgl
@@ -1,4 +1,5 @@
 #include <mbgl/style/cross_faded_property_evaluator.hpp>
+#include <mbgl/style/camera_function_cache.hpp>
 #include <mbgl/util/chrono.hpp>
 
 #include <cmath>
@@ -18,9 +19,9 @@ Faded<T> CrossFadedPropertyEvaluator<T>::operator()(const T& constant) const {
 
 template <typename T>
 Faded<T> CrossFadedPropertyEvaluator<T>::operator()(const CameraFunction<T>& function) const {
-    return calculate(function.evaluate(parameters.z - 1.0f),
-                     function.evaluate(parameters.z),
-                     function.evaluate(parameters.z + 1.0f));
+    return calculate(evaluate(function, parameters.z - 1.0f, parameters),
+                     evaluate(function, parameters.z, parameters),
+                     evaluate(function, parameters.z + 1.0f, parameters));
 }
 
 template <typename T>
@@ -2,6 +2,7 @@
 
 #include <mbgl/style/property_value.hpp>
 #include <mbgl/style/property_evaluation_parameters.hpp>
+#include <mbgl/style/camera_function_cache.hpp>
 #include <mbgl/style/possibly_evaluated_property_value.hpp>
 
 namespace mbgl {
@@ -25,7 +26,7 @@ public:
     }
 
     ResultType operator()(const CameraFunction<T>& function) const {
-        return ResultType(function.evaluate(parameters.z));
+        return ResultType(evaluate(function, parameters.z, parameters));
     }
 
     template <class Function>
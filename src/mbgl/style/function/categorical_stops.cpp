@@ -2,30 +2,44 @@
 #include <mbgl/style/types.hpp>
 #include <mbgl/util/color.hpp>
 
+#include <algorithm>
 #include <array>
 
 namespace mbgl {
 namespace style {
 
-optional<CategoricalValue> categoricalValue(const Value& value) {
-    return value.match(
-        [] (bool t) { return optional<CategoricalValue>(t); },
-        [] (uint64_t t) { return optional<CategoricalValue>(int64_t(t)); },
-        [] (int64_t t) { return optional<CategoricalValue>(t); },
-        [] (double t) { return optional<CategoricalValue>(int64_t(t)); },
-        [] (const std::string& t) { return optional<CategoricalValue>(t); },
-        [] (const auto&) { return optional<CategoricalValue>(); }
-    );
+template <class T>
+CategoricalStops<T>::CategoricalStops(Stops stops_)
+    : stops(std::move(stops_)) {
+    assert(stops.size() > 0);
+
+    // The stops are sorted by type, and then by value, so the arrays come out sorted as well.
+    for (const auto& stop : stops) {
+        stop.first.match(
+            [&] (bool t) { (t ? trueStop : falseStop) = stop.second; },
+            [&] (int64_t t) { integerStops.emplace_back(t, stop.second); },
+            [&] (const std::string& t) { stringStops.emplace_back(t, stop.second); }
+        );
+    }
+}
+
+template <class K, class T>
+static optional<T> findStop(const std::vector<std::pair<K, T>>& stops, const K& key) {
+    auto it = std::lower_bound(stops.begin(), stops.end(), key,
+        [] (const std::pair<K, T>& stop, const K& k) { return stop.first < k; });
+    return it == stops.end() || it->first != key ? optional<T>() : it->second;
 }
 
 template <class T>
 optional<T> CategoricalStops<T>::evaluate(const Value& value) const {
-    auto v = categoricalValue(value);
-    if (!v) {
-        return {};
-    }
-    auto it = stops.find(*v);
-    return it == stops.end() ? optional<T>() : it->second;
+    return value.match(
+        [&] (bool t) { return t ? trueStop : falseStop; },
+        [&] (uint64_t t) { return findStop(integerStops, int64_t(t)); },
+        [&] (int64_t t) { return findStop(integerStops, t); },
+        [&] (double t) { return findStop(integerStops, int64_t(t)); },
+        [&] (const std::string& t) { return findStop(stringStops, t); },
+        [&] (const auto&) { return optional<T>(); }
+    );
 }
 
 template class CategoricalStops<float>;
@@ -15,6 +15,11 @@ namespace style {
 std::string layoutKey(const Layer& layer) {
     using namespace conversion;
 
+    const std::string& snapshotKey = layer.baseImpl->getSnapshotLayoutKey();
+    if (!snapshotKey.empty()) {
+        return snapshotKey;
+    }
+
     rapidjson::StringBuffer s;
     rapidjson::Writer<rapidjson::StringBuffer> writer(s);
 
@@ -32,7 +37,21 @@ std::string layoutKey(const Layer& layer) {
     return s.GetString();
 }
 
-std::vector<std::vector<const Layer*>> groupByLayout(const std::vector<std::unique_ptr<Layer>>& layers) {
+std::string bucketKey(const Layer& layer) {
+    rapidjson::StringBuffer s;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+
+    writer.StartArray();
+    const std::string key = layoutKey(layer);
+    writer.String(key.data(), key.size());
+    layer.baseImpl->stringifyDataDrivenPaint(writer);
+    writer.EndArray();
+
+    return s.GetString();
+}
+
+template <class Layers>
+static std::vector<std::vector<const Layer*>> groupLayers(const Layers& layers) {
     std::unordered_map<std::string, std::vector<const Layer*>> map;
     for (auto& layer : layers) {
         map[layoutKey(*layer)].push_back(layer.get());
@@ -46,5 +65,13 @@ std::vector<std::vector<const Layer*>> groupByLayout(const std::vector<std::uniq
     return result;
 }
 
+std::vector<std::vector<const Layer*>> groupByLayout(const std::vector<std::unique_ptr<Layer>>& layers) {
+    return groupLayers(layers);
+}
+
+std::vector<std::vector<const Layer*>> groupByLayout(const std::vector<std::shared_ptr<const Layer>>& layers) {
+    return groupLayers(layers);
+}
+
 } // namespace style
 } // namespace mbgl
@@ -2,13 +2,22 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 
 namespace mbgl {
 namespace style {
 
 class Layer;
 
+// Layers with equal keys share their layout and buckets.
+std::string layoutKey(const Layer&);
+
+// Layers with equal keys lay out the same tile data into equal buckets. Unlike the layout key,
+// the key includes the layer's evaluated data-driven paint properties.
+std::string bucketKey(const Layer&);
+
 std::vector<std::vector<const Layer*>> groupByLayout(const std::vector<std::unique_ptr<Layer>>&);
+std::vector<std::vector<const Layer*>> groupByLayout(const std::vector<std::shared_ptr<const Layer>>&);
 
 } // namespace style
 } // namespace mbgl
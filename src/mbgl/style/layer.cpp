@@ -22,6 +22,7 @@ void Layer::setVisibility(VisibilityType value) {
     if (value == getVisibility())
         return;
     baseImpl->visibility = value;
+    baseImpl->invalidateSnapshot();
     baseImpl->observer->onLayerVisibilityChanged(*this);
 }
 
@@ -31,6 +32,7 @@ float Layer::getMinZoom() const {
 
 void Layer::setMinZoom(float minZoom) const {
     baseImpl->minZoom = minZoom;
+    baseImpl->invalidateSnapshot();
 }
 
 float Layer::getMaxZoom() const {
@@ -39,6 +41,7 @@ float Layer::getMaxZoom() const {
 
 void Layer::setMaxZoom(float maxZoom) const {
     baseImpl->maxZoom = maxZoom;
+    baseImpl->invalidateSnapshot();
 }
 
 } // namespace style
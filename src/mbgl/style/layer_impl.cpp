@@ -1,4 +1,6 @@
 #include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/group_by_layout.hpp>
+#include <mbgl/style/property_evaluation_parameters.hpp>
 
 namespace mbgl {
 namespace style {
@@ -15,6 +17,41 @@ bool Layer::Impl::hasRenderPass(RenderPass pass) const {
     return bool(passes & pass);
 }
 
+std::shared_ptr<const Layer> Layer::Impl::getSnapshot() const {
+    if (!snapshot.layer) {
+        std::unique_ptr<Layer> layer = clone();
+        layer->baseImpl->snapshot.layoutKey = layoutKey(*layer);
+        snapshot.layer = std::move(layer);
+    }
+    return snapshot.layer;
+}
+
+void Layer::Impl::cascadeProperties(const CascadeParameters& parameters) {
+    cascade(parameters);
+    evaluated = false;
+    invalidateSnapshot();
+}
+
+bool Layer::Impl::evaluateProperties(const PropertyEvaluationParameters& parameters) {
+    // Hidden layers are evaluated once they are shown.
+    if (visibility == VisibilityType::None || parameters.z < minZoom || parameters.z > maxZoom) {
+        return false;
+    }
+
+    // Without transitions, the evaluation only changes with the zoom level, and with the time
+    // while the properties cross-fade after the zoom level crossed an integer.
+    if (evaluated && !transitioning && (isZoomConstant() || (parameters.z == evaluatedZoom && crossFaded))) {
+        return false;
+    }
+
+    transitioning = evaluate(parameters);
+    evaluated = true;
+    invalidateSnapshot();
+    evaluatedZoom = parameters.z;
+    crossFaded = parameters.now >= parameters.zoomHistory.lastIntegerZoomTime + parameters.defaultFadeDuration;
+    return transitioning;
+}
+
 bool Layer::Impl::needsRendering(float zoom) const {
     return passes != RenderPass::None
         && visibility != VisibilityType::None
@@ -22,6 +59,12 @@ bool Layer::Impl::needsRendering(float zoom) const {
         && maxZoom >= zoom;
 }
 
+void Layer::Impl::setFilter(const Filter& filter_) {
+    filter = filter_;
+    compiledFilter = CompiledFilter::get(filter);
+    invalidateSnapshot();
+}
+
 void Layer::Impl::setObserver(LayerObserver* observer_) {
     observer = observer_;
 }
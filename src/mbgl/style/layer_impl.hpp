@@ -3,6 +3,7 @@
 #include <mbgl/style/layer.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/style/filter.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/layer_observer.hpp>
 #include <mbgl/renderer/render_pass.hpp>
 #include <mbgl/util/noncopyable.hpp>
@@ -51,9 +52,28 @@ public:
     // Create a layer, copying all properties except id and paint properties from this layer.
     virtual std::unique_ptr<Layer> cloneRef(const std::string& id) const = 0;
 
+    // Returns an immutable copy of this layer, which all tiles share with their workers rather than
+    // each cloning the layer. The copy is made at most once between changes of the layer.
+    std::shared_ptr<const Layer> getSnapshot() const;
+
+    // Drops the snapshot of the layer once its properties have changed.
+    void invalidateSnapshot() {
+        snapshot.layer.reset();
+    }
+
+    // The layout key of a snapshot, which is computed once as the snapshot is made, since the
+    // snapshot can't change. Empty for any other layer.
+    const std::string& getSnapshotLayoutKey() const {
+        return snapshot.layoutKey;
+    }
+
     // Utility function for automatic layer grouping.
     virtual void stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const = 0;
 
+    // Writes the evaluated data-driven paint properties, which together with the layout
+    // determine the contents of the layer's buckets.
+    virtual void stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>&) const = 0;
+
     // Partially evaluate paint properties based on a set of classes.
     virtual void cascade(const CascadeParameters&) = 0;
 
@@ -61,6 +81,19 @@ public:
     // Returns true if any paint properties have active transitions.
     virtual bool evaluate(const PropertyEvaluationParameters&) = 0;
 
+    // Whether evaluating the cascaded paint properties gives the same result at any zoom level
+    // and time.
+    virtual bool isZoomConstant() const { return false; }
+
+    // Cascades the paint properties, which invalidates their evaluation.
+    void cascadeProperties(const CascadeParameters&);
+
+    // Evaluates the paint properties, unless the layer is hidden at the zoom level, or the
+    // properties are without transitions and were already evaluated since they were cascaded,
+    // at the same zoom level or for any zoom level. Returns true if any paint properties have
+    // active transitions.
+    bool evaluateProperties(const PropertyEvaluationParameters&);
+
     virtual std::unique_ptr<Bucket> createBucket(const BucketParameters&, const std::vector<const Layer*>&) const = 0;
 
     // Checks whether this layer needs to be rendered in the given render pass.
@@ -78,11 +111,15 @@ public:
 
     void setObserver(LayerObserver*);
 
+    // Sets `filter` along with its compiled form, which is what layout evaluates.
+    void setFilter(const Filter&);
+
 public:
     std::string id;
     std::string source;
     std::string sourceLayer;
     Filter filter;
+    std::shared_ptr<const CompiledFilter> compiledFilter = CompiledFilter::get(filter);
     float minZoom = -std::numeric_limits<float>::infinity();
     float maxZoom = std::numeric_limits<float>::infinity();
     VisibilityType visibility = VisibilityType::Visible;
@@ -98,6 +135,26 @@ protected:
     // Stores what render passes this layer is currently enabled for. This depends on the
     // evaluated StyleProperties object and is updated accordingly.
     RenderPass passes = RenderPass::None;
+
+private:
+    // Whether the paint properties were evaluated since they were last cascaded, and whether
+    // they were transitioning then.
+    bool evaluated = false;
+    bool transitioning = false;
+    // The zoom level of the last evaluation, and whether cross-fading was complete then.
+    float evaluatedZoom = 0;
+    bool crossFaded = false;
+
+    // Copies of the layer don't share its snapshot.
+    class Snapshot {
+    public:
+        Snapshot() = default;
+        Snapshot(const Snapshot&) {}
+
+        std::shared_ptr<const Layer> layer;
+        std::string layoutKey;
+    };
+    mutable Snapshot snapshot;
 };
 
 } // namespace style
@@ -34,6 +34,10 @@ std::unique_ptr<Layer> BackgroundLayer::Impl::cloneRef(const std::string& id_) c
 void BackgroundLayer::Impl::stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const {
 }
 
+void BackgroundLayer::Impl::stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>& writer) const {
+    conversion::stringifyDataDriven(writer, paint);
+}
+
 
 // Layout properties
 
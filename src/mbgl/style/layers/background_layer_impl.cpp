@@ -11,11 +11,24 @@ void BackgroundLayer::Impl::cascade(const CascadeParameters& parameters) {
 bool BackgroundLayer::Impl::evaluate(const PropertyEvaluationParameters& parameters) {
     paint.evaluate(parameters);
 
-    passes = paint.evaluated.get<BackgroundOpacity>() > 0 ? RenderPass::Translucent : RenderPass::None;
+    // An opaque background is drawn in the opaque pass, so that the depth test discards the
+    // fragments of the layers below it.
+    const bool opaque = paint.unevaluated.get<BackgroundPattern>().isUndefined() &&
+                        paint.evaluated.get<BackgroundColor>().a >= 1.0f &&
+                        paint.evaluated.get<BackgroundOpacity>() >= 1.0f;
+    if (paint.evaluated.get<BackgroundOpacity>() <= 0) {
+        passes = RenderPass::None;
+    } else {
+        passes = opaque ? RenderPass::Opaque : RenderPass::Translucent;
+    }
 
     return paint.hasTransition();
 }
 
+bool BackgroundLayer::Impl::isZoomConstant() const {
+    return paint.isZoomConstant();
+}
+
 std::unique_ptr<Bucket> BackgroundLayer::Impl::createBucket(const BucketParameters&, const std::vector<const Layer*>&) const {
     assert(false);
     return nullptr;
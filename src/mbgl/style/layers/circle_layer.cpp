@@ -35,6 +35,10 @@ std::unique_ptr<Layer> CircleLayer::Impl::cloneRef(const std::string& id_) const
 void CircleLayer::Impl::stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const {
 }
 
+void CircleLayer::Impl::stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>& writer) const {
+    conversion::stringifyDataDriven(writer, paint);
+}
+
 // Source
 
 const std::string& CircleLayer::getSourceID() const {
@@ -43,6 +47,7 @@ const std::string& CircleLayer::getSourceID() const {
 
 void CircleLayer::setSourceLayer(const std::string& sourceLayer) {
     impl->sourceLayer = sourceLayer;
+    impl->invalidateSnapshot();
 }
 
 const std::string& CircleLayer::getSourceLayer() const {
@@ -52,7 +57,7 @@ const std::string& CircleLayer::getSourceLayer() const {
 // Filter
 
 void CircleLayer::setFilter(const Filter& filter) {
-    impl->filter = filter;
+    impl->setFilter(filter);
     impl->observer->onLayerFilterChanged(*this);
 }
 
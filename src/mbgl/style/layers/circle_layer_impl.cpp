@@ -25,6 +25,10 @@ bool CircleLayer::Impl::evaluate(const PropertyEvaluationParameters& parameters)
     return paint.hasTransition();
 }
 
+bool CircleLayer::Impl::isZoomConstant() const {
+    return paint.isZoomConstant();
+}
+
 std::unique_ptr<Bucket> CircleLayer::Impl::createBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers) const {
     return std::make_unique<CircleBucket>(parameters, layers);
 }
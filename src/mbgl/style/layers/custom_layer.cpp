@@ -8,8 +8,9 @@ CustomLayer::CustomLayer(const std::string& layerID,
                          CustomLayerInitializeFunction init,
                          CustomLayerRenderFunction render,
                          CustomLayerDeinitializeFunction deinit,
-                         void* context)
-    : Layer(Type::Custom, std::make_unique<Impl>(layerID, init, render, deinit, context))
+                         void* context,
+                         CustomLayerGLState glState)
+    : Layer(Type::Custom, std::make_unique<Impl>(layerID, init, render, deinit, context, glState))
     , impl(static_cast<Impl*>(baseImpl.get())) {
 }
 
@@ -9,12 +9,14 @@ CustomLayer::Impl::Impl(const std::string& id_,
                          CustomLayerInitializeFunction initializeFn_,
                          CustomLayerRenderFunction renderFn_,
                          CustomLayerDeinitializeFunction deinitializeFn_,
-                         void* context_) {
+                         void* context_,
+                         CustomLayerGLState glState_) {
     id = id_;
     initializeFn = initializeFn_;
     renderFn = renderFn_;
     deinitializeFn = deinitializeFn_;
     context = context_;
+    glState = glState_;
 }
 
 CustomLayer::Impl::Impl(const CustomLayer::Impl& other)
@@ -37,6 +39,9 @@ std::unique_ptr<Layer> CustomLayer::Impl::cloneRef(const std::string&) const {
 void CustomLayer::Impl::stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const {
 }
 
+void CustomLayer::Impl::stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>&) const {
+}
+
 void CustomLayer::Impl::initialize() {
     assert(initializeFn);
     initializeFn(context);
@@ -48,11 +53,9 @@ void CustomLayer::Impl::deinitialize() {
     }
 }
 
-void CustomLayer::Impl::render(const TransformState& state) const {
+void CustomLayer::Impl::render(const TransformState& state, CustomLayerRenderParameters& parameters) const {
     assert(renderFn);
 
-    CustomLayerRenderParameters parameters;
-
     parameters.width = state.getSize().width;
     parameters.height = state.getSize().height;
     parameters.latitude = state.getLatLng().latitude();
@@ -70,6 +73,10 @@ bool CustomLayer::Impl::evaluate(const PropertyEvaluationParameters&) {
     return false;
 }
 
+bool CustomLayer::Impl::isZoomConstant() const {
+    return true;
+}
+
 std::unique_ptr<Bucket> CustomLayer::Impl::createBucket(const BucketParameters&, const std::vector<const Layer*>&) const {
     assert(false);
     return nullptr;
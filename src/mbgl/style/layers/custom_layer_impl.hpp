@@ -15,22 +15,28 @@ public:
          CustomLayerInitializeFunction,
          CustomLayerRenderFunction,
          CustomLayerDeinitializeFunction,
-         void* context);
+         void* context,
+         CustomLayerGLState);
 
     Impl(const Impl&);
     ~Impl() final;
 
     void initialize();
     void deinitialize();
-    void render(const TransformState&) const;
+    // Fills in the camera of the parameters; the painter fills in the rest.
+    void render(const TransformState&, CustomLayerRenderParameters&) const;
+
+    CustomLayerGLState getGLState() const { return glState; }
 
 private:
     std::unique_ptr<Layer> clone() const override;
     std::unique_ptr<Layer> cloneRef(const std::string& id) const override;
     void stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const override;
+    void stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>&) const override;
 
     void cascade(const CascadeParameters&) final {}
     bool evaluate(const PropertyEvaluationParameters&) final;
+    bool isZoomConstant() const final;
 
     std::unique_ptr<Bucket> createBucket(const BucketParameters&, const std::vector<const Layer*>&) const final;
 
@@ -38,6 +44,7 @@ private:
     CustomLayerRenderFunction renderFn = nullptr;
     CustomLayerDeinitializeFunction deinitializeFn = nullptr;
     void* context = nullptr;
+    CustomLayerGLState glState = CustomLayerGLState::All;
 };
 
 } // namespace style
@@ -35,6 +35,10 @@ std::unique_ptr<Layer> FillExtrusionLayer::Impl::cloneRef(const std::string& id_
 void FillExtrusionLayer::Impl::stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const {
 }
 
+void FillExtrusionLayer::Impl::stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>& writer) const {
+    conversion::stringifyDataDriven(writer, paint);
+}
+
 // Source
 
 const std::string& FillExtrusionLayer::getSourceID() const {
@@ -43,6 +47,7 @@ const std::string& FillExtrusionLayer::getSourceID() const {
 
 void FillExtrusionLayer::setSourceLayer(const std::string& sourceLayer) {
     impl->sourceLayer = sourceLayer;
+    impl->invalidateSnapshot();
 }
 
 const std::string& FillExtrusionLayer::getSourceLayer() const {
@@ -52,7 +57,7 @@ const std::string& FillExtrusionLayer::getSourceLayer() const {
 // Filter
 
 void FillExtrusionLayer::setFilter(const Filter& filter) {
-    impl->filter = filter;
+    impl->setFilter(filter);
     impl->observer->onLayerFilterChanged(*this);
 }
 
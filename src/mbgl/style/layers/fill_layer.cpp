@@ -35,6 +35,10 @@ std::unique_ptr<Layer> FillLayer::Impl::cloneRef(const std::string& id_) const {
 void FillLayer::Impl::stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const {
 }
 
+void FillLayer::Impl::stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>& writer) const {
+    conversion::stringifyDataDriven(writer, paint);
+}
+
 // Source
 
 const std::string& FillLayer::getSourceID() const {
@@ -43,6 +47,7 @@ const std::string& FillLayer::getSourceID() const {
 
 void FillLayer::setSourceLayer(const std::string& sourceLayer) {
     impl->sourceLayer = sourceLayer;
+    impl->invalidateSnapshot();
 }
 
 const std::string& FillLayer::getSourceLayer() const {
@@ -52,7 +57,7 @@ const std::string& FillLayer::getSourceLayer() const {
 // Filter
 
 void FillLayer::setFilter(const Filter& filter) {
-    impl->filter = filter;
+    impl->setFilter(filter);
     impl->observer->onLayerFilterChanged(*this);
 }
 
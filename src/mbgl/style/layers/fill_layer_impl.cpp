@@ -35,6 +35,10 @@ bool FillLayer::Impl::evaluate(const PropertyEvaluationParameters& parameters) {
     return paint.hasTransition();
 }
 
+bool FillLayer::Impl::isZoomConstant() const {
+    return paint.isZoomConstant();
+}
+
 std::unique_ptr<Bucket> FillLayer::Impl::createBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers) const {
     return std::make_unique<FillBucket>(parameters, layers);
 }
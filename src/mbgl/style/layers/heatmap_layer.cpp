@@ -0,0 +1,193 @@
+#include <mbgl/style/layers/heatmap_layer.hpp>
+#include <mbgl/style/layers/heatmap_layer_impl.hpp>
+#include <mbgl/style/conversion/stringify.hpp>
+
+namespace mbgl {
+namespace style {
+
+HeatmapLayer::HeatmapLayer(const std::string& layerID, const std::string& sourceID)
+    : Layer(Type::Heatmap, std::make_unique<Impl>())
+    , impl(static_cast<Impl*>(baseImpl.get())) {
+    impl->id = layerID;
+    impl->source = sourceID;
+}
+
+HeatmapLayer::HeatmapLayer(const Impl& other)
+    : Layer(Type::Heatmap, std::make_unique<Impl>(other))
+    , impl(static_cast<Impl*>(baseImpl.get())) {
+}
+
+HeatmapLayer::~HeatmapLayer() = default;
+
+std::unique_ptr<Layer> HeatmapLayer::Impl::clone() const {
+    return std::make_unique<HeatmapLayer>(*this);
+}
+
+std::unique_ptr<Layer> HeatmapLayer::Impl::cloneRef(const std::string& id_) const {
+    auto result = std::make_unique<HeatmapLayer>(*this);
+    result->impl->id = id_;
+    result->impl->paint = HeatmapPaintProperties();
+    result->impl->setColor(HeatmapLayer::getDefaultHeatmapColor());
+    return std::move(result);
+}
+
+void HeatmapLayer::Impl::stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const {
+}
+
+void HeatmapLayer::Impl::stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>& writer) const {
+    conversion::stringifyDataDriven(writer, paint);
+}
+
+// Source
+
+const std::string& HeatmapLayer::getSourceID() const {
+    return impl->source;
+}
+
+void HeatmapLayer::setSourceLayer(const std::string& sourceLayer) {
+    impl->sourceLayer = sourceLayer;
+    impl->invalidateSnapshot();
+}
+
+const std::string& HeatmapLayer::getSourceLayer() const {
+    return impl->sourceLayer;
+}
+
+// Filter
+
+void HeatmapLayer::setFilter(const Filter& filter) {
+    impl->setFilter(filter);
+    impl->observer->onLayerFilterChanged(*this);
+}
+
+const Filter& HeatmapLayer::getFilter() const {
+    return impl->filter;
+}
+
+// Paint properties
+
+DataDrivenPropertyValue<float> HeatmapLayer::getDefaultHeatmapRadius() {
+    return { 30 };
+}
+
+DataDrivenPropertyValue<float> HeatmapLayer::getHeatmapRadius(const optional<std::string>& klass) const {
+    return impl->paint.get<HeatmapRadius>(klass);
+}
+
+void HeatmapLayer::setHeatmapRadius(DataDrivenPropertyValue<float> value, const optional<std::string>& klass) {
+    if (value == getHeatmapRadius(klass))
+        return;
+    impl->paint.set<HeatmapRadius>(value, klass);
+    if (value.isDataDriven()) {
+        impl->observer->onLayerDataDrivenPaintPropertyChanged(*this);
+    } else {
+        impl->observer->onLayerPaintPropertyChanged(*this);
+    }
+}
+
+void HeatmapLayer::setHeatmapRadiusTransition(const TransitionOptions& value, const optional<std::string>& klass) {
+    impl->paint.setTransition<HeatmapRadius>(value, klass);
+}
+
+TransitionOptions HeatmapLayer::getHeatmapRadiusTransition(const optional<std::string>& klass) const {
+    return impl->paint.getTransition<HeatmapRadius>(klass);
+}
+
+DataDrivenPropertyValue<float> HeatmapLayer::getDefaultHeatmapWeight() {
+    return { 1 };
+}
+
+DataDrivenPropertyValue<float> HeatmapLayer::getHeatmapWeight(const optional<std::string>& klass) const {
+    return impl->paint.get<HeatmapWeight>(klass);
+}
+
+void HeatmapLayer::setHeatmapWeight(DataDrivenPropertyValue<float> value, const optional<std::string>& klass) {
+    if (value == getHeatmapWeight(klass))
+        return;
+    impl->paint.set<HeatmapWeight>(value, klass);
+    if (value.isDataDriven()) {
+        impl->observer->onLayerDataDrivenPaintPropertyChanged(*this);
+    } else {
+        impl->observer->onLayerPaintPropertyChanged(*this);
+    }
+}
+
+void HeatmapLayer::setHeatmapWeightTransition(const TransitionOptions& value, const optional<std::string>& klass) {
+    impl->paint.setTransition<HeatmapWeight>(value, klass);
+}
+
+TransitionOptions HeatmapLayer::getHeatmapWeightTransition(const optional<std::string>& klass) const {
+    return impl->paint.getTransition<HeatmapWeight>(klass);
+}
+
+PropertyValue<float> HeatmapLayer::getDefaultHeatmapIntensity() {
+    return { 1 };
+}
+
+PropertyValue<float> HeatmapLayer::getHeatmapIntensity(const optional<std::string>& klass) const {
+    return impl->paint.get<HeatmapIntensity>(klass);
+}
+
+void HeatmapLayer::setHeatmapIntensity(PropertyValue<float> value, const optional<std::string>& klass) {
+    if (value == getHeatmapIntensity(klass))
+        return;
+    impl->paint.set<HeatmapIntensity>(value, klass);
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+void HeatmapLayer::setHeatmapIntensityTransition(const TransitionOptions& value, const optional<std::string>& klass) {
+    impl->paint.setTransition<HeatmapIntensity>(value, klass);
+}
+
+TransitionOptions HeatmapLayer::getHeatmapIntensityTransition(const optional<std::string>& klass) const {
+    return impl->paint.getTransition<HeatmapIntensity>(klass);
+}
+
+PropertyValue<float> HeatmapLayer::getDefaultHeatmapOpacity() {
+    return { 1 };
+}
+
+PropertyValue<float> HeatmapLayer::getHeatmapOpacity(const optional<std::string>& klass) const {
+    return impl->paint.get<HeatmapOpacity>(klass);
+}
+
+void HeatmapLayer::setHeatmapOpacity(PropertyValue<float> value, const optional<std::string>& klass) {
+    if (value == getHeatmapOpacity(klass))
+        return;
+    impl->paint.set<HeatmapOpacity>(value, klass);
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+void HeatmapLayer::setHeatmapOpacityTransition(const TransitionOptions& value, const optional<std::string>& klass) {
+    impl->paint.setTransition<HeatmapOpacity>(value, klass);
+}
+
+TransitionOptions HeatmapLayer::getHeatmapOpacityTransition(const optional<std::string>& klass) const {
+    return impl->paint.getTransition<HeatmapOpacity>(klass);
+}
+
+ExponentialStops<Color> HeatmapLayer::getDefaultHeatmapColor() {
+    // Transparent blue, royal blue, cyan, lime, yellow and red, premultiplied.
+    return ExponentialStops<Color>({
+        { 0.0f, Color { 0.0f, 0.0f, 0.0f, 0.0f } },
+        { 0.1f, Color { 65.0f / 255, 105.0f / 255, 225.0f / 255, 1.0f } },
+        { 0.3f, Color { 0.0f, 1.0f, 1.0f, 1.0f } },
+        { 0.5f, Color { 0.0f, 1.0f, 0.0f, 1.0f } },
+        { 0.7f, Color { 1.0f, 1.0f, 0.0f, 1.0f } },
+        { 1.0f, Color { 1.0f, 0.0f, 0.0f, 1.0f } },
+    });
+}
+
+const ExponentialStops<Color>& HeatmapLayer::getHeatmapColor() const {
+    return impl->color;
+}
+
+void HeatmapLayer::setHeatmapColor(ExponentialStops<Color> value) {
+    if (value == getHeatmapColor())
+        return;
+    impl->setColor(std::move(value));
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,70 @@
+#include <mbgl/style/layers/heatmap_layer_impl.hpp>
+#include <mbgl/renderer/heatmap_bucket.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/util/intersection_tests.hpp>
+
+#include <cmath>
+
+namespace mbgl {
+namespace style {
+
+HeatmapLayer::Impl::Impl() {
+    setColor(HeatmapLayer::getDefaultHeatmapColor());
+}
+
+void HeatmapLayer::Impl::cascade(const CascadeParameters& parameters) {
+    paint.cascade(parameters);
+}
+
+bool HeatmapLayer::Impl::evaluate(const PropertyEvaluationParameters& parameters) {
+    paint.evaluate(parameters);
+
+    passes = (paint.evaluated.get<HeatmapRadius>().constantOr(1) > 0
+           && paint.evaluated.get<HeatmapWeight>().constantOr(1) > 0
+           && paint.evaluated.get<HeatmapIntensity>() > 0
+           && paint.evaluated.get<HeatmapOpacity>() > 0)
+        ? RenderPass::Translucent : RenderPass::None;
+
+    return paint.hasTransition();
+}
+
+bool HeatmapLayer::Impl::isZoomConstant() const {
+    return paint.isZoomConstant();
+}
+
+std::unique_ptr<Bucket> HeatmapLayer::Impl::createBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers) const {
+    return std::make_unique<HeatmapBucket>(parameters, layers);
+}
+
+float HeatmapLayer::Impl::getQueryRadius() const {
+    return paint.evaluated.get<HeatmapRadius>().constantOr(HeatmapRadius::defaultValue());
+}
+
+bool HeatmapLayer::Impl::queryIntersectsGeometry(
+        const GeometryCoordinates& queryGeometry,
+        const GeometryCollection& geometry,
+        const float,
+        const float pixelsToTileUnits) const {
+    auto heatmapRadius = paint.evaluated.get<HeatmapRadius>().constantOr(HeatmapRadius::defaultValue()) * pixelsToTileUnits;
+
+    return util::polygonIntersectsBufferedMultiPoint(queryGeometry, geometry, heatmapRadius);
+}
+
+void HeatmapLayer::Impl::setColor(ExponentialStops<Color> color_) {
+    color = std::move(color_);
+
+    auto ramp = std::make_shared<PremultipliedImage>(Size { 256, 1 });
+    for (uint32_t i = 0; i < 256; ++i) {
+        const Color c = color.stops.empty()
+            ? Color()
+            : color.evaluate(Value(double(i) / 255)).value_or(Color());
+        ramp->data[i * 4 + 0] = std::lround(c.r * 255);
+        ramp->data[i * 4 + 1] = std::lround(c.g * 255);
+        ramp->data[i * 4 + 2] = std::lround(c.b * 255);
+        ramp->data[i * 4 + 3] = std::lround(c.a * 255);
+    }
+    colorRamp = std::move(ramp);
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/layers/heatmap_layer.hpp>
+#include <mbgl/style/layers/heatmap_layer_properties.hpp>
+#include <mbgl/util/image.hpp>
+
+namespace mbgl {
+namespace style {
+
+class HeatmapLayer::Impl : public Layer::Impl {
+public:
+    Impl();
+
+    std::unique_ptr<Layer> clone() const override;
+    std::unique_ptr<Layer> cloneRef(const std::string& id) const override;
+    void stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const override;
+    void stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>&) const override;
+
+    void cascade(const CascadeParameters&) override;
+    bool evaluate(const PropertyEvaluationParameters&) override;
+    bool isZoomConstant() const override;
+
+    std::unique_ptr<Bucket> createBucket(const BucketParameters&, const std::vector<const Layer*>&) const override;
+
+    float getQueryRadius() const override;
+    bool queryIntersectsGeometry(
+            const GeometryCoordinates& queryGeometry,
+            const GeometryCollection& geometry,
+            const float bearing,
+            const float pixelsToTileUnits) const override;
+
+    // Sets the color stops, and samples them into the color ramp.
+    void setColor(ExponentialStops<Color>);
+
+    HeatmapPaintProperties paint;
+    ExponentialStops<Color> color;
+
+    // The colors of 256 evenly spaced densities, which the accumulated density is looked up in.
+    // It's replaced rather than changed, so that the painter can tell whether it has uploaded it.
+    std::shared_ptr<const PremultipliedImage> colorRamp;
+};
+
+} // namespace style
+} // namespace mbgl
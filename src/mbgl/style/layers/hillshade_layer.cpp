@@ -0,0 +1,187 @@
+#include <mbgl/style/layers/hillshade_layer.hpp>
+#include <mbgl/style/layers/hillshade_layer_impl.hpp>
+#include <mbgl/style/conversion/stringify.hpp>
+
+namespace mbgl {
+namespace style {
+
+HillshadeLayer::HillshadeLayer(const std::string& layerID, const std::string& sourceID)
+    : Layer(Type::Hillshade, std::make_unique<Impl>())
+    , impl(static_cast<Impl*>(baseImpl.get())) {
+    impl->id = layerID;
+    impl->source = sourceID;
+}
+
+HillshadeLayer::HillshadeLayer(const Impl& other)
+    : Layer(Type::Hillshade, std::make_unique<Impl>(other))
+    , impl(static_cast<Impl*>(baseImpl.get())) {
+}
+
+HillshadeLayer::~HillshadeLayer() = default;
+
+std::unique_ptr<Layer> HillshadeLayer::Impl::clone() const {
+    return std::make_unique<HillshadeLayer>(*this);
+}
+
+std::unique_ptr<Layer> HillshadeLayer::Impl::cloneRef(const std::string& id_) const {
+    auto result = std::make_unique<HillshadeLayer>(*this);
+    result->impl->id = id_;
+    result->impl->paint = HillshadePaintProperties();
+    return std::move(result);
+}
+
+void HillshadeLayer::Impl::stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const {
+}
+
+void HillshadeLayer::Impl::stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>& writer) const {
+    conversion::stringifyDataDriven(writer, paint);
+}
+
+// Source
+
+const std::string& HillshadeLayer::getSourceID() const {
+    return impl->source;
+}
+
+// Paint properties
+
+PropertyValue<float> HillshadeLayer::getDefaultHillshadeIlluminationDirection() {
+    return { 335 };
+}
+
+PropertyValue<float> HillshadeLayer::getHillshadeIlluminationDirection(const optional<std::string>& klass) const {
+    return impl->paint.get<HillshadeIlluminationDirection>(klass);
+}
+
+void HillshadeLayer::setHillshadeIlluminationDirection(PropertyValue<float> value, const optional<std::string>& klass) {
+    if (value == getHillshadeIlluminationDirection(klass))
+        return;
+    impl->paint.set<HillshadeIlluminationDirection>(value, klass);
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+void HillshadeLayer::setHillshadeIlluminationDirectionTransition(const TransitionOptions& value, const optional<std::string>& klass) {
+    impl->paint.setTransition<HillshadeIlluminationDirection>(value, klass);
+}
+
+TransitionOptions HillshadeLayer::getHillshadeIlluminationDirectionTransition(const optional<std::string>& klass) const {
+    return impl->paint.getTransition<HillshadeIlluminationDirection>(klass);
+}
+
+PropertyValue<HillshadeIlluminationAnchorType> HillshadeLayer::getDefaultHillshadeIlluminationAnchor() {
+    return { HillshadeIlluminationAnchorType::Viewport };
+}
+
+PropertyValue<HillshadeIlluminationAnchorType> HillshadeLayer::getHillshadeIlluminationAnchor(const optional<std::string>& klass) const {
+    return impl->paint.get<HillshadeIlluminationAnchor>(klass);
+}
+
+void HillshadeLayer::setHillshadeIlluminationAnchor(PropertyValue<HillshadeIlluminationAnchorType> value, const optional<std::string>& klass) {
+    if (value == getHillshadeIlluminationAnchor(klass))
+        return;
+    impl->paint.set<HillshadeIlluminationAnchor>(value, klass);
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+void HillshadeLayer::setHillshadeIlluminationAnchorTransition(const TransitionOptions& value, const optional<std::string>& klass) {
+    impl->paint.setTransition<HillshadeIlluminationAnchor>(value, klass);
+}
+
+TransitionOptions HillshadeLayer::getHillshadeIlluminationAnchorTransition(const optional<std::string>& klass) const {
+    return impl->paint.getTransition<HillshadeIlluminationAnchor>(klass);
+}
+
+PropertyValue<float> HillshadeLayer::getDefaultHillshadeExaggeration() {
+    return { 0.5 };
+}
+
+PropertyValue<float> HillshadeLayer::getHillshadeExaggeration(const optional<std::string>& klass) const {
+    return impl->paint.get<HillshadeExaggeration>(klass);
+}
+
+void HillshadeLayer::setHillshadeExaggeration(PropertyValue<float> value, const optional<std::string>& klass) {
+    if (value == getHillshadeExaggeration(klass))
+        return;
+    impl->paint.set<HillshadeExaggeration>(value, klass);
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+void HillshadeLayer::setHillshadeExaggerationTransition(const TransitionOptions& value, const optional<std::string>& klass) {
+    impl->paint.setTransition<HillshadeExaggeration>(value, klass);
+}
+
+TransitionOptions HillshadeLayer::getHillshadeExaggerationTransition(const optional<std::string>& klass) const {
+    return impl->paint.getTransition<HillshadeExaggeration>(klass);
+}
+
+PropertyValue<Color> HillshadeLayer::getDefaultHillshadeShadowColor() {
+    return { Color::black() };
+}
+
+PropertyValue<Color> HillshadeLayer::getHillshadeShadowColor(const optional<std::string>& klass) const {
+    return impl->paint.get<HillshadeShadowColor>(klass);
+}
+
+void HillshadeLayer::setHillshadeShadowColor(PropertyValue<Color> value, const optional<std::string>& klass) {
+    if (value == getHillshadeShadowColor(klass))
+        return;
+    impl->paint.set<HillshadeShadowColor>(value, klass);
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+void HillshadeLayer::setHillshadeShadowColorTransition(const TransitionOptions& value, const optional<std::string>& klass) {
+    impl->paint.setTransition<HillshadeShadowColor>(value, klass);
+}
+
+TransitionOptions HillshadeLayer::getHillshadeShadowColorTransition(const optional<std::string>& klass) const {
+    return impl->paint.getTransition<HillshadeShadowColor>(klass);
+}
+
+PropertyValue<Color> HillshadeLayer::getDefaultHillshadeHighlightColor() {
+    return { Color::white() };
+}
+
+PropertyValue<Color> HillshadeLayer::getHillshadeHighlightColor(const optional<std::string>& klass) const {
+    return impl->paint.get<HillshadeHighlightColor>(klass);
+}
+
+void HillshadeLayer::setHillshadeHighlightColor(PropertyValue<Color> value, const optional<std::string>& klass) {
+    if (value == getHillshadeHighlightColor(klass))
+        return;
+    impl->paint.set<HillshadeHighlightColor>(value, klass);
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+void HillshadeLayer::setHillshadeHighlightColorTransition(const TransitionOptions& value, const optional<std::string>& klass) {
+    impl->paint.setTransition<HillshadeHighlightColor>(value, klass);
+}
+
+TransitionOptions HillshadeLayer::getHillshadeHighlightColorTransition(const optional<std::string>& klass) const {
+    return impl->paint.getTransition<HillshadeHighlightColor>(klass);
+}
+
+PropertyValue<Color> HillshadeLayer::getDefaultHillshadeAccentColor() {
+    return { Color::black() };
+}
+
+PropertyValue<Color> HillshadeLayer::getHillshadeAccentColor(const optional<std::string>& klass) const {
+    return impl->paint.get<HillshadeAccentColor>(klass);
+}
+
+void HillshadeLayer::setHillshadeAccentColor(PropertyValue<Color> value, const optional<std::string>& klass) {
+    if (value == getHillshadeAccentColor(klass))
+        return;
+    impl->paint.set<HillshadeAccentColor>(value, klass);
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+void HillshadeLayer::setHillshadeAccentColorTransition(const TransitionOptions& value, const optional<std::string>& klass) {
+    impl->paint.setTransition<HillshadeAccentColor>(value, klass);
+}
+
+TransitionOptions HillshadeLayer::getHillshadeAccentColorTransition(const optional<std::string>& klass) const {
+    return impl->paint.getTransition<HillshadeAccentColor>(klass);
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,33 @@
+#include <mbgl/style/layers/hillshade_layer_impl.hpp>
+#include <mbgl/renderer/bucket.hpp>
+
+namespace mbgl {
+namespace style {
+
+void HillshadeLayer::Impl::cascade(const CascadeParameters& parameters) {
+    paint.cascade(parameters);
+}
+
+bool HillshadeLayer::Impl::evaluate(const PropertyEvaluationParameters& parameters) {
+    paint.evaluate(parameters);
+
+    // The shadows and highlights fade out as the exaggeration goes to zero, and the accent with
+    // them, so the layer is only drawn while it would show.
+    passes = paint.evaluated.get<HillshadeExaggeration>() > 0
+        ? RenderPass::Translucent : RenderPass::None;
+
+    return paint.hasTransition();
+}
+
+bool HillshadeLayer::Impl::isZoomConstant() const {
+    return paint.isZoomConstant();
+}
+
+// The buckets of hillshade layers are the elevations that the source's tiles decode.
+std::unique_ptr<Bucket> HillshadeLayer::Impl::createBucket(const BucketParameters&, const std::vector<const Layer*>&) const {
+    assert(false);
+    return nullptr;
+}
+
+} // namespace style
+} // namespace mbgl
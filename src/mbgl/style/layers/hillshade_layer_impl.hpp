@@ -0,0 +1,27 @@
+#pragma once
+
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/layers/hillshade_layer.hpp>
+#include <mbgl/style/layers/hillshade_layer_properties.hpp>
+
+namespace mbgl {
+namespace style {
+
+class HillshadeLayer::Impl : public Layer::Impl {
+public:
+    std::unique_ptr<Layer> clone() const override;
+    std::unique_ptr<Layer> cloneRef(const std::string& id) const override;
+    void stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const override;
+    void stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>&) const override;
+
+    void cascade(const CascadeParameters&) override;
+    bool evaluate(const PropertyEvaluationParameters&) override;
+    bool isZoomConstant() const override;
+
+    std::unique_ptr<Bucket> createBucket(const BucketParameters&, const std::vector<const Layer*>&) const override;
+
+    HillshadePaintProperties paint;
+};
+
+} // namespace style
+} // namespace mbgl
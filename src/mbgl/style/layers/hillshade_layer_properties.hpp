@@ -0,0 +1,45 @@
+#pragma once
+
+#include <mbgl/style/types.hpp>
+#include <mbgl/style/layout_property.hpp>
+#include <mbgl/style/paint_property.hpp>
+#include <mbgl/programs/attributes.hpp>
+
+namespace mbgl {
+namespace style {
+
+struct HillshadeIlluminationDirection : PaintProperty<float> {
+    static float defaultValue() { return 335; }
+};
+
+struct HillshadeIlluminationAnchor : PaintProperty<HillshadeIlluminationAnchorType> {
+    static HillshadeIlluminationAnchorType defaultValue() { return HillshadeIlluminationAnchorType::Viewport; }
+};
+
+struct HillshadeExaggeration : PaintProperty<float> {
+    static float defaultValue() { return 0.5; }
+};
+
+struct HillshadeShadowColor : PaintProperty<Color> {
+    static Color defaultValue() { return Color::black(); }
+};
+
+struct HillshadeHighlightColor : PaintProperty<Color> {
+    static Color defaultValue() { return Color::white(); }
+};
+
+struct HillshadeAccentColor : PaintProperty<Color> {
+    static Color defaultValue() { return Color::black(); }
+};
+
+class HillshadePaintProperties : public PaintProperties<
+    HillshadeIlluminationDirection,
+    HillshadeIlluminationAnchor,
+    HillshadeExaggeration,
+    HillshadeShadowColor,
+    HillshadeHighlightColor,
+    HillshadeAccentColor
+> {};
+
+} // namespace style
+} // namespace mbgl
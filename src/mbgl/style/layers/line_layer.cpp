@@ -36,6 +36,10 @@ void LineLayer::Impl::stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>
     conversion::stringify(writer, layout);
 }
 
+void LineLayer::Impl::stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>& writer) const {
+    conversion::stringifyDataDriven(writer, paint);
+}
+
 // Source
 
 const std::string& LineLayer::getSourceID() const {
@@ -44,6 +48,7 @@ const std::string& LineLayer::getSourceID() const {
 
 void LineLayer::setSourceLayer(const std::string& sourceLayer) {
     impl->sourceLayer = sourceLayer;
+    impl->invalidateSnapshot();
 }
 
 const std::string& LineLayer::getSourceLayer() const {
@@ -53,7 +58,7 @@ const std::string& LineLayer::getSourceLayer() const {
 // Filter
 
 void LineLayer::setFilter(const Filter& filter) {
-    impl->filter = filter;
+    impl->setFilter(filter);
     impl->observer->onLayerFilterChanged(*this);
 }
 
@@ -75,6 +80,7 @@ void LineLayer::setLineCap(PropertyValue<LineCapType> value) {
     if (value == getLineCap())
         return;
     impl->layout.unevaluated.get<LineCap>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "line-cap");
 }
 PropertyValue<LineJoinType> LineLayer::getDefaultLineJoin() {
@@ -89,6 +95,7 @@ void LineLayer::setLineJoin(PropertyValue<LineJoinType> value) {
     if (value == getLineJoin())
         return;
     impl->layout.unevaluated.get<LineJoin>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "line-join");
 }
 PropertyValue<float> LineLayer::getDefaultLineMiterLimit() {
@@ -103,6 +110,7 @@ void LineLayer::setLineMiterLimit(PropertyValue<float> value) {
     if (value == getLineMiterLimit())
         return;
     impl->layout.unevaluated.get<LineMiterLimit>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "line-miter-limit");
 }
 PropertyValue<float> LineLayer::getDefaultLineRoundLimit() {
@@ -117,6 +125,7 @@ void LineLayer::setLineRoundLimit(PropertyValue<float> value) {
     if (value == getLineRoundLimit())
         return;
     impl->layout.unevaluated.get<LineRoundLimit>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "line-round-limit");
 }
 
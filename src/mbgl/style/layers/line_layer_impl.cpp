@@ -28,6 +28,10 @@ bool LineLayer::Impl::evaluate(const PropertyEvaluationParameters& parameters) {
     return paint.hasTransition();
 }
 
+bool LineLayer::Impl::isZoomConstant() const {
+    return paint.isZoomConstant();
+}
+
 std::unique_ptr<Bucket> LineLayer::Impl::createBucket(const BucketParameters& parameters, const std::vector<const Layer*>& layers) const {
     return std::make_unique<LineBucket>(parameters, layers, layout);
 }
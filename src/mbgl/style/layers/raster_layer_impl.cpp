@@ -16,6 +16,10 @@ bool RasterLayer::Impl::evaluate(const PropertyEvaluationParameters& parameters)
     return paint.hasTransition();
 }
 
+bool RasterLayer::Impl::isZoomConstant() const {
+    return paint.isZoomConstant();
+}
+
 std::unique_ptr<Bucket> RasterLayer::Impl::createBucket(const BucketParameters&, const std::vector<const Layer*>&) const {
     assert(false);
     return nullptr;
@@ -36,6 +36,10 @@ void SymbolLayer::Impl::stringifyLayout(rapidjson::Writer<rapidjson::StringBuffe
     conversion::stringify(writer, layout);
 }
 
+void SymbolLayer::Impl::stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>& writer) const {
+    conversion::stringifyDataDriven(writer, paint);
+}
+
 // Source
 
 const std::string& SymbolLayer::getSourceID() const {
@@ -44,6 +48,7 @@ const std::string& SymbolLayer::getSourceID() const {
 
 void SymbolLayer::setSourceLayer(const std::string& sourceLayer) {
     impl->sourceLayer = sourceLayer;
+    impl->invalidateSnapshot();
 }
 
 const std::string& SymbolLayer::getSourceLayer() const {
@@ -53,7 +58,7 @@ const std::string& SymbolLayer::getSourceLayer() const {
 // Filter
 
 void SymbolLayer::setFilter(const Filter& filter) {
-    impl->filter = filter;
+    impl->setFilter(filter);
     impl->observer->onLayerFilterChanged(*this);
 }
 
@@ -75,6 +80,7 @@ void SymbolLayer::setSymbolPlacement(PropertyValue<SymbolPlacementType> value) {
     if (value == getSymbolPlacement())
         return;
     impl->layout.unevaluated.get<SymbolPlacement>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "symbol-placement");
 }
 PropertyValue<float> SymbolLayer::getDefaultSymbolSpacing() {
@@ -89,6 +95,7 @@ void SymbolLayer::setSymbolSpacing(PropertyValue<float> value) {
     if (value == getSymbolSpacing())
         return;
     impl->layout.unevaluated.get<SymbolSpacing>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "symbol-spacing");
 }
 PropertyValue<bool> SymbolLayer::getDefaultSymbolAvoidEdges() {
@@ -103,6 +110,7 @@ void SymbolLayer::setSymbolAvoidEdges(PropertyValue<bool> value) {
     if (value == getSymbolAvoidEdges())
         return;
     impl->layout.unevaluated.get<SymbolAvoidEdges>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "symbol-avoid-edges");
 }
 PropertyValue<bool> SymbolLayer::getDefaultIconAllowOverlap() {
@@ -117,6 +125,7 @@ void SymbolLayer::setIconAllowOverlap(PropertyValue<bool> value) {
     if (value == getIconAllowOverlap())
         return;
     impl->layout.unevaluated.get<IconAllowOverlap>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "icon-allow-overlap");
 }
 PropertyValue<bool> SymbolLayer::getDefaultIconIgnorePlacement() {
@@ -131,6 +140,7 @@ void SymbolLayer::setIconIgnorePlacement(PropertyValue<bool> value) {
     if (value == getIconIgnorePlacement())
         return;
     impl->layout.unevaluated.get<IconIgnorePlacement>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "icon-ignore-placement");
 }
 PropertyValue<bool> SymbolLayer::getDefaultIconOptional() {
@@ -145,6 +155,7 @@ void SymbolLayer::setIconOptional(PropertyValue<bool> value) {
     if (value == getIconOptional())
         return;
     impl->layout.unevaluated.get<IconOptional>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "icon-optional");
 }
 PropertyValue<AlignmentType> SymbolLayer::getDefaultIconRotationAlignment() {
@@ -159,6 +170,7 @@ void SymbolLayer::setIconRotationAlignment(PropertyValue<AlignmentType> value) {
     if (value == getIconRotationAlignment())
         return;
     impl->layout.unevaluated.get<IconRotationAlignment>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "icon-rotation-alignment");
 }
 DataDrivenPropertyValue<float> SymbolLayer::getDefaultIconSize() {
@@ -173,6 +185,7 @@ void SymbolLayer::setIconSize(DataDrivenPropertyValue<float> value) {
     if (value == getIconSize())
         return;
     impl->layout.unevaluated.get<IconSize>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "icon-size");
 }
 PropertyValue<IconTextFitType> SymbolLayer::getDefaultIconTextFit() {
@@ -187,6 +200,7 @@ void SymbolLayer::setIconTextFit(PropertyValue<IconTextFitType> value) {
     if (value == getIconTextFit())
         return;
     impl->layout.unevaluated.get<IconTextFit>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "icon-text-fit");
 }
 PropertyValue<std::array<float, 4>> SymbolLayer::getDefaultIconTextFitPadding() {
@@ -201,6 +215,7 @@ void SymbolLayer::setIconTextFitPadding(PropertyValue<std::array<float, 4>> valu
     if (value == getIconTextFitPadding())
         return;
     impl->layout.unevaluated.get<IconTextFitPadding>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "icon-text-fit-padding");
 }
 DataDrivenPropertyValue<std::string> SymbolLayer::getDefaultIconImage() {
@@ -215,6 +230,7 @@ void SymbolLayer::setIconImage(DataDrivenPropertyValue<std::string> value) {
     if (value == getIconImage())
         return;
     impl->layout.unevaluated.get<IconImage>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "icon-image");
 }
 DataDrivenPropertyValue<float> SymbolLayer::getDefaultIconRotate() {
@@ -229,6 +245,7 @@ void SymbolLayer::setIconRotate(DataDrivenPropertyValue<float> value) {
     if (value == getIconRotate())
         return;
     impl->layout.unevaluated.get<IconRotate>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "icon-rotate");
 }
 PropertyValue<float> SymbolLayer::getDefaultIconPadding() {
@@ -243,6 +260,7 @@ void SymbolLayer::setIconPadding(PropertyValue<float> value) {
     if (value == getIconPadding())
         return;
     impl->layout.unevaluated.get<IconPadding>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "icon-padding");
 }
 PropertyValue<bool> SymbolLayer::getDefaultIconKeepUpright() {
@@ -257,6 +275,7 @@ void SymbolLayer::setIconKeepUpright(PropertyValue<bool> value) {
     if (value == getIconKeepUpright())
         return;
     impl->layout.unevaluated.get<IconKeepUpright>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "icon-keep-upright");
 }
 DataDrivenPropertyValue<std::array<float, 2>> SymbolLayer::getDefaultIconOffset() {
@@ -271,6 +290,7 @@ void SymbolLayer::setIconOffset(DataDrivenPropertyValue<std::array<float, 2>> va
     if (value == getIconOffset())
         return;
     impl->layout.unevaluated.get<IconOffset>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "icon-offset");
 }
 PropertyValue<AlignmentType> SymbolLayer::getDefaultTextPitchAlignment() {
@@ -285,6 +305,7 @@ void SymbolLayer::setTextPitchAlignment(PropertyValue<AlignmentType> value) {
     if (value == getTextPitchAlignment())
         return;
     impl->layout.unevaluated.get<TextPitchAlignment>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-pitch-alignment");
 }
 PropertyValue<AlignmentType> SymbolLayer::getDefaultTextRotationAlignment() {
@@ -299,6 +320,7 @@ void SymbolLayer::setTextRotationAlignment(PropertyValue<AlignmentType> value) {
     if (value == getTextRotationAlignment())
         return;
     impl->layout.unevaluated.get<TextRotationAlignment>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-rotation-alignment");
 }
 DataDrivenPropertyValue<std::string> SymbolLayer::getDefaultTextField() {
@@ -313,6 +335,7 @@ void SymbolLayer::setTextField(DataDrivenPropertyValue<std::string> value) {
     if (value == getTextField())
         return;
     impl->layout.unevaluated.get<TextField>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-field");
 }
 PropertyValue<std::vector<std::string>> SymbolLayer::getDefaultTextFont() {
@@ -327,6 +350,7 @@ void SymbolLayer::setTextFont(PropertyValue<std::vector<std::string>> value) {
     if (value == getTextFont())
         return;
     impl->layout.unevaluated.get<TextFont>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-font");
 }
 DataDrivenPropertyValue<float> SymbolLayer::getDefaultTextSize() {
@@ -341,6 +365,7 @@ void SymbolLayer::setTextSize(DataDrivenPropertyValue<float> value) {
     if (value == getTextSize())
         return;
     impl->layout.unevaluated.get<TextSize>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-size");
 }
 PropertyValue<float> SymbolLayer::getDefaultTextMaxWidth() {
@@ -355,6 +380,7 @@ void SymbolLayer::setTextMaxWidth(PropertyValue<float> value) {
     if (value == getTextMaxWidth())
         return;
     impl->layout.unevaluated.get<TextMaxWidth>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-max-width");
 }
 PropertyValue<float> SymbolLayer::getDefaultTextLineHeight() {
@@ -369,6 +395,7 @@ void SymbolLayer::setTextLineHeight(PropertyValue<float> value) {
     if (value == getTextLineHeight())
         return;
     impl->layout.unevaluated.get<TextLineHeight>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-line-height");
 }
 PropertyValue<float> SymbolLayer::getDefaultTextLetterSpacing() {
@@ -383,6 +410,7 @@ void SymbolLayer::setTextLetterSpacing(PropertyValue<float> value) {
     if (value == getTextLetterSpacing())
         return;
     impl->layout.unevaluated.get<TextLetterSpacing>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-letter-spacing");
 }
 PropertyValue<TextJustifyType> SymbolLayer::getDefaultTextJustify() {
@@ -397,6 +425,7 @@ void SymbolLayer::setTextJustify(PropertyValue<TextJustifyType> value) {
     if (value == getTextJustify())
         return;
     impl->layout.unevaluated.get<TextJustify>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-justify");
 }
 PropertyValue<TextAnchorType> SymbolLayer::getDefaultTextAnchor() {
@@ -411,6 +440,7 @@ void SymbolLayer::setTextAnchor(PropertyValue<TextAnchorType> value) {
     if (value == getTextAnchor())
         return;
     impl->layout.unevaluated.get<TextAnchor>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-anchor");
 }
 PropertyValue<float> SymbolLayer::getDefaultTextMaxAngle() {
@@ -425,6 +455,7 @@ void SymbolLayer::setTextMaxAngle(PropertyValue<float> value) {
     if (value == getTextMaxAngle())
         return;
     impl->layout.unevaluated.get<TextMaxAngle>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-max-angle");
 }
 DataDrivenPropertyValue<float> SymbolLayer::getDefaultTextRotate() {
@@ -439,6 +470,7 @@ void SymbolLayer::setTextRotate(DataDrivenPropertyValue<float> value) {
     if (value == getTextRotate())
         return;
     impl->layout.unevaluated.get<TextRotate>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-rotate");
 }
 PropertyValue<float> SymbolLayer::getDefaultTextPadding() {
@@ -453,6 +485,7 @@ void SymbolLayer::setTextPadding(PropertyValue<float> value) {
     if (value == getTextPadding())
         return;
     impl->layout.unevaluated.get<TextPadding>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-padding");
 }
 PropertyValue<bool> SymbolLayer::getDefaultTextKeepUpright() {
@@ -467,6 +500,7 @@ void SymbolLayer::setTextKeepUpright(PropertyValue<bool> value) {
     if (value == getTextKeepUpright())
         return;
     impl->layout.unevaluated.get<TextKeepUpright>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-keep-upright");
 }
 DataDrivenPropertyValue<TextTransformType> SymbolLayer::getDefaultTextTransform() {
@@ -481,6 +515,7 @@ void SymbolLayer::setTextTransform(DataDrivenPropertyValue<TextTransformType> va
     if (value == getTextTransform())
         return;
     impl->layout.unevaluated.get<TextTransform>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-transform");
 }
 DataDrivenPropertyValue<std::array<float, 2>> SymbolLayer::getDefaultTextOffset() {
@@ -495,6 +530,7 @@ void SymbolLayer::setTextOffset(DataDrivenPropertyValue<std::array<float, 2>> va
     if (value == getTextOffset())
         return;
     impl->layout.unevaluated.get<TextOffset>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-offset");
 }
 PropertyValue<bool> SymbolLayer::getDefaultTextAllowOverlap() {
@@ -509,6 +545,7 @@ void SymbolLayer::setTextAllowOverlap(PropertyValue<bool> value) {
     if (value == getTextAllowOverlap())
         return;
     impl->layout.unevaluated.get<TextAllowOverlap>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-allow-overlap");
 }
 PropertyValue<bool> SymbolLayer::getDefaultTextIgnorePlacement() {
@@ -523,6 +560,7 @@ void SymbolLayer::setTextIgnorePlacement(PropertyValue<bool> value) {
     if (value == getTextIgnorePlacement())
         return;
     impl->layout.unevaluated.get<TextIgnorePlacement>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-ignore-placement");
 }
 PropertyValue<bool> SymbolLayer::getDefaultTextOptional() {
@@ -537,6 +575,7 @@ void SymbolLayer::setTextOptional(PropertyValue<bool> value) {
     if (value == getTextOptional())
         return;
     impl->layout.unevaluated.get<TextOptional>() = value;
+    impl->invalidateSnapshot();
     impl->observer->onLayerLayoutPropertyChanged(*this, "text-optional");
 }
 
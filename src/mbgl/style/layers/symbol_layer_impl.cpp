@@ -25,6 +25,10 @@ bool SymbolLayer::Impl::evaluate(const PropertyEvaluationParameters& parameters)
     return paint.hasTransition();
 }
 
+bool SymbolLayer::Impl::isZoomConstant() const {
+    return paint.isZoomConstant();
+}
+
 std::unique_ptr<Bucket> SymbolLayer::Impl::createBucket(const BucketParameters&, const std::vector<const Layer*>&) const {
     assert(false); // Should be calling createLayout() instead.
     return nullptr;
@@ -34,13 +38,17 @@ std::unique_ptr<SymbolLayout> SymbolLayer::Impl::createLayout(const BucketParame
                                                               const std::vector<const Layer*>& group,
                                                               const GeometryTileLayer& layer,
                                                               GlyphDependencies& glyphDependencies,
-                                                              IconDependencyMap& iconDependencyMap) const {
+                                                              IconDependencyMap& iconDependencyMap,
+                                                              const std::string& sharedKey,
+                                                              std::shared_ptr<const Buffer> encodedData) const {
     return std::make_unique<SymbolLayout>(parameters,
                                           group,
                                           layer,
                                           iconDependencyMap[spriteAtlas],
                                           (uintptr_t)spriteAtlas,
-                                          glyphDependencies);
+                                          glyphDependencies,
+                                          sharedKey,
+                                          std::move(encodedData));
 }
 
 IconPaintProperties::Evaluated SymbolLayer::Impl::iconPaintProperties() const {
@@ -9,6 +9,7 @@
 
 namespace mbgl {
 
+class Buffer;
 class SymbolLayout;
 
 namespace style {
@@ -62,13 +63,17 @@ public:
     std::unique_ptr<Layer> clone() const override;
     std::unique_ptr<Layer> cloneRef(const std::string& id) const override;
     void stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const override;
+    void stringifyDataDrivenPaint(rapidjson::Writer<rapidjson::StringBuffer>&) const override;
 
     void cascade(const CascadeParameters&) override;
     bool evaluate(const PropertyEvaluationParameters&) override;
+    bool isZoomConstant() const override;
 
     std::unique_ptr<Bucket> createBucket(const BucketParameters&, const std::vector<const Layer*>&) const override;
     std::unique_ptr<SymbolLayout> createLayout(const BucketParameters&, const std::vector<const Layer*>&,
-                                               const GeometryTileLayer&, GlyphDependencies&, IconDependencyMap&) const;
+                                               const GeometryTileLayer&, GlyphDependencies&, IconDependencyMap&,
+                                               const std::string& sharedKey = {},
+                                               std::shared_ptr<const Buffer> encodedData = nullptr) const;
 
     IconPaintProperties::Evaluated iconPaintProperties() const;
     TextPaintProperties::Evaluated textPaintProperties() const;
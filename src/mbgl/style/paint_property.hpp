@@ -9,6 +9,7 @@
 #include <mbgl/style/property_evaluation_parameters.hpp>
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/style/cascade_parameters.hpp>
+#include <mbgl/style/camera_function_cache.hpp>
 #include <mbgl/style/paint_property_binder.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/interpolate.hpp>
@@ -98,8 +99,9 @@ public:
         return it == values.end() ? staticValue : it->second;
     }
 
+    // Camera functions are deduplicated with those of other layers as they're set.
     void set(const Value& value_, const optional<std::string>& klass) {
-        values[klass ? ClassDictionary::Get().lookup(*klass) : ClassID::Default] = value_;
+        values[klass ? ClassDictionary::Get().lookup(*klass) : ClassID::Default] = CameraFunctionCache::deduplicate(value_);
     }
 
     const TransitionOptions& getTransition(const optional<std::string>& klass) const {
@@ -151,6 +153,10 @@ public:
     using EvaluatorType = PropertyEvaluator<T>;
     using EvaluatedType = T;
     static constexpr bool IsDataDriven = false;
+
+    static bool isZoomConstant(const UnevaluatedType& value) {
+        return value.getValue().isZoomConstant();
+    }
 };
 
 template <class T, class A>
@@ -163,6 +169,10 @@ public:
     using EvaluatedType = PossiblyEvaluatedPropertyValue<T>;
     static constexpr bool IsDataDriven = true;
 
+    static bool isZoomConstant(const UnevaluatedType& value) {
+        return value.getValue().isZoomConstant();
+    }
+
     using Type = T;
     using Attribute = A;
 };
@@ -176,6 +186,11 @@ public:
     using EvaluatorType = CrossFadedPropertyEvaluator<T>;
     using EvaluatedType = Faded<T>;
     static constexpr bool IsDataDriven = false;
+
+    // Cross-fading follows the zoom history, even between constant images.
+    static bool isZoomConstant(const UnevaluatedType& value) {
+        return value.isUndefined();
+    }
 };
 
 template <class P>
@@ -256,6 +271,14 @@ public:
         return result;
     }
 
+    // Whether evaluating the cascaded properties gives the same result at any zoom level and
+    // time, once their transitions are over.
+    bool isZoomConstant() const {
+        bool result = true;
+        util::ignore({ result &= Ps::isZoomConstant(unevaluated.template get<Ps>())... });
+        return result;
+    }
+
     Cascading cascading;
     Unevaluated unevaluated;
     Evaluated evaluated;
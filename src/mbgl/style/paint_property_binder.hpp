@@ -5,6 +5,13 @@
 #include <mbgl/gl/uniform.hpp>
 #include <mbgl/util/type_list.hpp>
 
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cassert>
+#include <string>
+#include <vector>
+
 namespace mbgl {
 namespace style {
 
@@ -22,22 +29,37 @@ inline std::array<float, 1> attributeValue(float v) {
 }
 
 /*
-    Encode a four-component color value into a pair of floats.  Since csscolorparser
-    uses 8-bit precision for each color component, for each float we use the upper 8
+    Encode a four-component color value into a pair of 16-bit values.  Since csscolorparser
+    uses 8-bit precision for each color component, for each value we use the upper 8
     bits for one component (e.g. (color.r * 255) * 256), and the lower 8 for another.
+    The shaders decode the pair from floats, which represent any 16-bit value exactly, so
+    the attribute is stored at half the size of a pair of floats.
     
     Also note that colors come in as floats 0..1, so we scale by 255.
 */
-inline std::array<float, 2> attributeValue(const Color& color) {
+inline std::array<uint16_t, 2> attributeValue(const Color& color) {
     return {{
-        static_cast<float>(mbgl::attributes::packUint8Pair(255 * color.r, 255 * color.g)),
-        static_cast<float>(mbgl::attributes::packUint8Pair(255 * color.b, 255 * color.a))
+        mbgl::attributes::packUint8Pair(255 * color.r, 255 * color.g),
+        mbgl::attributes::packUint8Pair(255 * color.b, 255 * color.a)
     }};
 }
 
-template <size_t N>
-std::array<float, N*2> zoomInterpolatedAttributeValue(const std::array<float, N>& min, const std::array<float, N>& max) {
-    std::array<float, N*2> result;
+// Repeats each vertex of the vector `count` times, for buckets that lay out a vertex per instance
+// of a quad, but draw a quad of their own for each instance where instancing isn't supported.
+template <class Vertex>
+gl::VertexVector<Vertex> repeatVertices(const gl::VertexVector<Vertex>& vertices, std::size_t count) {
+    gl::VertexVector<Vertex> result;
+    for (std::size_t i = 0; i < vertices.vertexSize(); ++i) {
+        for (std::size_t j = 0; j < count; ++j) {
+            result.emplace_back(vertices.data()[i]);
+        }
+    }
+    return result;
+}
+
+template <class T, size_t N>
+std::array<T, N*2> zoomInterpolatedAttributeValue(const std::array<T, N>& min, const std::array<T, N>& max) {
+    std::array<T, N*2> result;
     for (size_t i = 0; i < N; i++) {
         result[i]   = min[i];
         result[i+N] = max[i];
@@ -73,8 +95,11 @@ std::array<float, N*2> zoomInterpolatedAttributeValue(const std::array<float, N>
    interpolation uniform value is set to zero, and the second attribute element is
    unused. This differs from the GL JS implementation, which dynamically generates
    shader source based on the strategy used. We found that in WebGL, using
-   `glVertexAttrib*` was unnacceptably slow. Additionally, in GL Native we have
-   implemented binary shader caching, which works better if the shaders are constant.
+   `glVertexAttrib*` was unnacceptably slow.
+
+   Programs are however compiled in variants that leave out the interpolation of the
+   properties whose binders don't interpolate, see PaintPropertyBinders::variant(). Each
+   variant is compiled the first time it is drawn, and cached as a binary program of its own.
 */
 template <class T, class A>
 class PaintPropertyBinder {
@@ -85,10 +110,26 @@ public:
     virtual ~PaintPropertyBinder() = default;
 
     virtual void populateVertexVector(const GeometryTileFeature& feature, std::size_t length) = 0;
-    virtual void upload(gl::Context& context) = 0;
-    virtual AttributeBinding attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const = 0;
+
+    // Uploads each vertex `repeat` times; see repeatVertices().
+    virtual void upload(gl::Context& context, std::size_t repeat) = 0;
+    virtual void shrinkToFit() = 0;
+    virtual void releaseVertexVector() = 0;
+    virtual void releaseVertexBuffer() = 0;
+
+    // A non-zero divisor binds the vertices one per that many instances, for instanced draws.
+    virtual AttributeBinding attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue, uint32_t divisor) const = 0;
     virtual float interpolationFactor(float currentZoom) const = 0;
 
+    // Whether the shaders need to interpolate between the two values of the attribute.
+    virtual bool isInterpolated() const = 0;
+
+    // The feature property that the binder evaluates, if it is data-driven.
+    virtual const std::string* propertyKey() const = 0;
+
+    // Copies a binder whose vertex data has not been uploaded yet.
+    virtual std::unique_ptr<PaintPropertyBinder> clone() const = 0;
+
     static std::unique_ptr<PaintPropertyBinder> create(const PossiblyEvaluatedPropertyValue<T>& value, float zoom, T defaultValue);
 };
 
@@ -103,9 +144,12 @@ public:
     }
 
     void populateVertexVector(const GeometryTileFeature&, std::size_t) override {}
-    void upload(gl::Context&) override {}
+    void upload(gl::Context&, std::size_t) override {}
+    void shrinkToFit() override {}
+    void releaseVertexVector() override {}
+    void releaseVertexBuffer() override {}
 
-    AttributeBinding attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const override {
+    AttributeBinding attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue, uint32_t) const override {
         auto value = attributeValue(currentValue.constantOr(constant));
         return typename Attribute::ConstantBinding {
             zoomInterpolatedAttributeValue(value, value)
@@ -116,6 +160,18 @@ public:
         return 0.0f;
     }
 
+    bool isInterpolated() const override {
+        return false;
+    }
+
+    const std::string* propertyKey() const override {
+        return nullptr;
+    }
+
+    std::unique_ptr<PaintPropertyBinder<T, A>> clone() const override {
+        return std::make_unique<ConstantPaintPropertyBinder>(constant);
+    }
+
 private:
     T constant;
 };
@@ -135,6 +191,13 @@ public:
           defaultValue(std::move(defaultValue_)) {
     }
 
+    SourceFunctionPaintPropertyBinder(const SourceFunctionPaintPropertyBinder& other)
+        : function(other.function),
+          defaultValue(other.defaultValue),
+          vertexVector(other.vertexVector) {
+        assert(!other.vertexBuffer);
+    }
+
     void populateVertexVector(const GeometryTileFeature& feature, std::size_t length) override {
         auto value = attributeValue(function.evaluate(feature, defaultValue));
         for (std::size_t i = vertexVector.vertexSize(); i < length; ++i) {
@@ -142,18 +205,32 @@ public:
         }
     }
 
-    void upload(gl::Context& context) override {
-        vertexBuffer = context.createVertexBuffer(std::move(vertexVector));
+    void upload(gl::Context& context, std::size_t repeat) override {
+        vertexBuffer = repeat == 1
+            ? context.createVertexBuffer(std::move(vertexVector))
+            : context.createVertexBuffer(repeatVertices(vertexVector, repeat));
+    }
+
+    void shrinkToFit() override {
+        vertexVector.shrinkToFit();
     }
 
-    AttributeBinding attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const override {
+    void releaseVertexVector() override {
+        vertexVector.release();
+    }
+
+    void releaseVertexBuffer() override {
+        vertexBuffer = {};
+    }
+
+    AttributeBinding attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue, uint32_t divisor) const override {
         if (currentValue.isConstant()) {
             BaseAttributeValue value = attributeValue(*currentValue.constant());
             return typename Attribute::ConstantBinding {
                 zoomInterpolatedAttributeValue(value, value)
             };
         } else {
-            return Attribute::variableBinding(*vertexBuffer, 0, BaseAttribute::Dimensions);
+            return Attribute::variableBinding(*vertexBuffer, 0, BaseAttribute::Dimensions, divisor);
         }
     }
 
@@ -161,6 +238,18 @@ public:
         return 0.0f;
     }
 
+    bool isInterpolated() const override {
+        return false;
+    }
+
+    const std::string* propertyKey() const override {
+        return &function.property;
+    }
+
+    std::unique_ptr<PaintPropertyBinder<T, A>> clone() const override {
+        return std::make_unique<SourceFunctionPaintPropertyBinder>(*this);
+    }
+
 private:
     SourceFunction<T> function;
     T defaultValue;
@@ -185,6 +274,14 @@ public:
           coveringRanges(function.coveringRanges(zoom)) {
     }
 
+    CompositeFunctionPaintPropertyBinder(const CompositeFunctionPaintPropertyBinder& other)
+        : function(other.function),
+          defaultValue(other.defaultValue),
+          coveringRanges(other.coveringRanges),
+          vertexVector(other.vertexVector) {
+        assert(!other.vertexBuffer);
+    }
+
     void populateVertexVector(const GeometryTileFeature& feature, std::size_t length) override {
         Range<T> range = function.evaluate(std::get<1>(coveringRanges), feature, defaultValue);
         AttributeValue value = zoomInterpolatedAttributeValue(
@@ -195,18 +292,32 @@ public:
         }
     }
 
-    void upload(gl::Context& context) override {
-        vertexBuffer = context.createVertexBuffer(std::move(vertexVector));
+    void upload(gl::Context& context, std::size_t repeat) override {
+        vertexBuffer = repeat == 1
+            ? context.createVertexBuffer(std::move(vertexVector))
+            : context.createVertexBuffer(repeatVertices(vertexVector, repeat));
+    }
+
+    void shrinkToFit() override {
+        vertexVector.shrinkToFit();
     }
 
-    AttributeBinding attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const override {
+    void releaseVertexVector() override {
+        vertexVector.release();
+    }
+
+    void releaseVertexBuffer() override {
+        vertexBuffer = {};
+    }
+
+    AttributeBinding attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue, uint32_t divisor) const override {
         if (currentValue.isConstant()) {
             BaseAttributeValue value = attributeValue(*currentValue.constant());
             return typename Attribute::ConstantBinding {
                 zoomInterpolatedAttributeValue(value, value)
             };
         } else {
-            return Attribute::variableBinding(*vertexBuffer, 0);
+            return Attribute::variableBinding(*vertexBuffer, 0, Attribute::Dimensions, divisor);
         }
     }
 
@@ -214,6 +325,18 @@ public:
         return util::interpolationFactor(1.0f, std::get<0>(coveringRanges), currentZoom);
     }
 
+    bool isInterpolated() const override {
+        return true;
+    }
+
+    const std::string* propertyKey() const override {
+        return &function.property;
+    }
+
+    std::unique_ptr<PaintPropertyBinder<T, A>> clone() const override {
+        return std::make_unique<CompositeFunctionPaintPropertyBinder>(*this);
+    }
+
 private:
     using InnerStops = typename CompositeFunction<T>::InnerStops;
     CompositeFunction<T> function;
@@ -239,6 +362,14 @@ PaintPropertyBinder<T, A>::create(const PossiblyEvaluatedPropertyValue<T>& value
     );
 }
 
+// Whether the binder that PaintPropertyBinder::create() makes for the value interpolates.
+template <class T>
+bool isInterpolated(const PossiblyEvaluatedPropertyValue<T>& value) {
+    return value.match(
+        [] (const CompositeFunction<T>&) { return true; },
+        [] (const auto&) { return false; });
+}
+
 template <class Attr>
 struct ZoomInterpolatedAttribute {
     static auto name() { return Attr::name(); }
@@ -273,7 +404,11 @@ public:
     }
 
     PaintPropertyBinders(PaintPropertyBinders&&) = default;
-    PaintPropertyBinders(const PaintPropertyBinders&) = delete;
+
+    // Copies binders that have not been uploaded yet.
+    PaintPropertyBinders(const PaintPropertyBinders& other)
+        : binders(other.binders.template get<Ps>()->clone()...) {
+    }
 
     void populateVertexVectors(const GeometryTileFeature& feature, std::size_t length) {
         util::ignore({
@@ -281,9 +416,34 @@ public:
         });
     }
 
-    void upload(gl::Context& context) {
+    // Adds the feature properties that the binders evaluate to the keys, unless they're there.
+    void addPropertyKeys(std::vector<std::string>& keys) const {
+        util::ignore({
+            (addPropertyKey(binders.template get<Ps>()->propertyKey(), keys), 0)...
+        });
+    }
+
+    void upload(gl::Context& context, std::size_t repeat = 1) {
+        util::ignore({
+            (binders.template get<Ps>()->upload(context, repeat), 0)...
+        });
+    }
+
+    void shrinkToFit() {
+        util::ignore({
+            (binders.template get<Ps>()->shrinkToFit(), 0)...
+        });
+    }
+
+    void releaseVertexVectors() {
+        util::ignore({
+            (binders.template get<Ps>()->releaseVertexVector(), 0)...
+        });
+    }
+
+    void releaseVertexBuffers() {
         util::ignore({
-            (binders.template get<Ps>()->upload(context), 0)...
+            (binders.template get<Ps>()->releaseVertexBuffer(), 0)...
         });
     }
 
@@ -296,7 +456,15 @@ public:
     template <class EvaluatedProperties>
     AttributeBindings attributeBindings(const EvaluatedProperties& currentProperties) const {
         return AttributeBindings {
-            binders.template get<Ps>()->attributeBinding(currentProperties.template get<Ps>())...
+            binders.template get<Ps>()->attributeBinding(currentProperties.template get<Ps>(), 0)...
+        };
+    }
+
+    // Binds the vertices one per instance, for buckets that draw their features as instances.
+    template <class EvaluatedProperties>
+    AttributeBindings instanceBindings(const EvaluatedProperties& currentProperties) const {
+        return AttributeBindings {
+            binders.template get<Ps>()->attributeBinding(currentProperties.template get<Ps>(), 1)...
         };
     }
 
@@ -312,7 +480,54 @@ public:
         };
     }
 
+    // The variant of the program that draws the binders: one bit for each property whose
+    // binder doesn't interpolate, in the order of the properties.
+    using Variant = std::bitset<sizeof...(Ps)>;
+
+    Variant variant() const {
+        Variant result;
+        std::size_t i = 0;
+        util::ignore({
+            (result.set(i++, !binders.template get<Ps>()->isInterpolated()), 0)...
+        });
+        (void)i;
+        return result;
+    }
+
+    // The variant of the binders that the properties would be bound with, so that the programs a
+    // style needs can be prepared before any bucket is created.
+    template <class EvaluatedProperties>
+    static Variant variant(const EvaluatedProperties& properties) {
+        Variant result;
+        std::size_t i = 0;
+        util::ignore({
+            (result.set(i++, !isInterpolated(properties.template get<Ps>())), 0)...
+        });
+        (void)i;
+        (void)properties;
+        return result;
+    }
+
+    // The preprocessor definitions that let the vertex shader of a variant read the properties
+    // that aren't interpolated without interpolating them.
+    static std::string defines(const Variant& variant) {
+        static const std::array<const char*, sizeof...(Ps)> names {{ Ps::Attribute::name()... }};
+        std::string result;
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            if (variant.test(i)) {
+                result += std::string("#define ZOOM_CONSTANT_") + names[i] + "\n";
+            }
+        }
+        return result;
+    }
+
 private:
+    static void addPropertyKey(const std::string* key, std::vector<std::string>& keys) {
+        if (key && std::find(keys.begin(), keys.end(), *key) == keys.end()) {
+            keys.push_back(*key);
+        }
+    }
+
     Binders binders;
 };
 
@@ -1,6 +1,7 @@
 #include <mbgl/style/parser.hpp>
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/binary_style_conversion.hpp>
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/style/conversion/source.hpp>
 #include <mbgl/style/conversion/layer.hpp>
@@ -19,10 +20,47 @@
 namespace mbgl {
 namespace style {
 
+namespace {
+
+// The values of the layers by ID, and the layers converted from them so far. Keeps references to
+// the values of array elements that are returned by reference, and copies of those that aren't.
+template <class V>
+using LayerValues = std::unordered_map<std::string,
+    std::pair<decltype(conversion::arrayMember(std::declval<const V&>(), 0)), std::unique_ptr<Layer>>>;
+
+// Converts a number without narrowing it to a float, as conversion::toNumber does.
+template <class V>
+optional<double> toDouble(const V& value) {
+    optional<Value> converted = conversion::toValue(value);
+    if (!converted) {
+        return {};
+    } else if (converted->template is<double>()) {
+        return converted->template get<double>();
+    } else if (converted->template is<uint64_t>()) {
+        return double(converted->template get<uint64_t>());
+    } else if (converted->template is<int64_t>()) {
+        return double(converted->template get<int64_t>());
+    }
+    return {};
+}
+
+// Whether the layer's layout hides it, without converting the layer.
+template <class V>
+bool isHidden(const V& layer) {
+    auto layout = conversion::objectMember(layer, "layout");
+    if (!layout || !conversion::isObject(*layout)) {
+        return false;
+    }
+    auto visibility = conversion::objectMember(*layout, "visibility");
+    return visibility && conversion::toString(*visibility) == std::string("none");
+}
+
+} // namespace
+
 Parser::~Parser() = default;
 
-StyleParseResult Parser::parse(const std::string& json) {
-    rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> document;
+StyleParseResult Parser::parse(const std::string& json, std::function<void ()> onSourcesParsed) {
+    JSDocument document;
     document.Parse<0>(json.c_str());
 
     if (document.HasParseError()) {
@@ -33,147 +71,185 @@ StyleParseResult Parser::parse(const std::string& json) {
         return std::make_exception_ptr(std::runtime_error(message.str()));
     }
 
-    if (!document.IsObject()) {
+    return parseStyle<JSValue>(document, onSourcesParsed);
+}
+
+StyleParseResult Parser::parseBinary(const std::string& data, std::function<void ()> onSourcesParsed) {
+    optional<BinaryStyleValue> document;
+    try {
+        document = decodeBinaryStyle(data);
+    } catch (const std::runtime_error&) {
+        return std::current_exception();
+    }
+
+    return parseStyle(*document, onSourcesParsed);
+}
+
+template <class V>
+StyleParseResult Parser::parseStyle(const V& document, const std::function<void ()>& onSourcesParsed) {
+    using namespace conversion;
+
+    if (!isObject(document)) {
         return std::make_exception_ptr(std::runtime_error("style must be an object"));
     }
 
-    if (document.HasMember("version")) {
-        const JSValue& versionValue = document["version"];
-        const int version = versionValue.IsNumber() ? versionValue.GetInt() : 0;
-        if (version != 8) {
+    if (auto versionValue = objectMember(document, "version")) {
+        const optional<double> version = toDouble(*versionValue);
+        if (!version || *version != 8) {
             Log::Warning(Event::ParseStyle, "current renderer implementation only supports style spec version 8; using an outdated style will cause rendering errors");
         }
     }
 
-    if (document.HasMember("name")) {
-        const JSValue& value = document["name"];
-        if (value.IsString()) {
-            name = { value.GetString(), value.GetStringLength() };
+    if (auto value = objectMember(document, "name")) {
+        if (optional<std::string> string = toString(*value)) {
+            name = *string;
         }
     }
 
-    if (document.HasMember("center")) {
-        const JSValue& value = document["center"];
-        if (value.IsArray() && value.Size() >= 2) {
+    if (auto value = objectMember(document, "center")) {
+        if (isArray(*value) && arrayLength(*value) >= 2) {
             // Style spec uses lon/lat order
-            latLng = LatLng(value[1].IsNumber() ? value[1].GetDouble() : 0,
-                            value[0].IsNumber() ? value[0].GetDouble() : 0);
+            latLng = LatLng(toDouble(arrayMember(*value, 1)).value_or(0),
+                            toDouble(arrayMember(*value, 0)).value_or(0));
         }
     }
 
-    if (document.HasMember("zoom")) {
-        const JSValue& value = document["zoom"];
-        if (value.IsNumber()) {
-            zoom = value.GetDouble();
+    if (auto value = objectMember(document, "zoom")) {
+        if (optional<double> number = toDouble(*value)) {
+            zoom = *number;
         }
     }
 
-    if (document.HasMember("bearing")) {
-        const JSValue& value = document["bearing"];
-        if (value.IsNumber()) {
-            bearing = value.GetDouble();
+    if (auto value = objectMember(document, "bearing")) {
+        if (optional<double> number = toDouble(*value)) {
+            bearing = *number;
         }
     }
 
-    if (document.HasMember("pitch")) {
-        const JSValue& value = document["pitch"];
-        if (value.IsNumber()) {
-            pitch = value.GetDouble();
+    if (auto value = objectMember(document, "pitch")) {
+        if (optional<double> number = toDouble(*value)) {
+            pitch = *number;
         }
     }
 
-    if (document.HasMember("sources")) {
-        parseSources(document["sources"]);
+    if (auto value = objectMember(document, "sources")) {
+        parseSources(*value);
     }
 
-    if (document.HasMember("layers")) {
-        parseLayers(document["layers"]);
+    LayerValues<V> layerValues;
+    std::vector<std::string> ids;
+    if (auto value = objectMember(document, "layers")) {
+        ids = indexLayers(*value, layerValues);
     }
 
-    if (document.HasMember("sprite")) {
-        const JSValue& sprite = document["sprite"];
-        if (sprite.IsString()) {
-            spriteURL = { sprite.GetString(), sprite.GetStringLength() };
+    if (auto value = objectMember(document, "sprite")) {
+        if (optional<std::string> string = toString(*value)) {
+            spriteURL = *string;
         }
     }
 
-    if (document.HasMember("glyphs")) {
-        const JSValue& glyphs = document["glyphs"];
-        if (glyphs.IsString()) {
-            glyphURL = { glyphs.GetString(), glyphs.GetStringLength() };
+    if (auto value = objectMember(document, "glyphs")) {
+        if (optional<std::string> string = toString(*value)) {
+            glyphURL = *string;
         }
     }
 
+    if (onSourcesParsed) {
+        onSourcesParsed();
+    }
+
+    parseLayers(ids, layerValues);
+
     return nullptr;
 }
 
-void Parser::parseSources(const JSValue& value) {
-    if (!value.IsObject()) {
+template <class V>
+void Parser::parseSources(const V& value) {
+    if (!conversion::isObject(value)) {
         Log::Warning(Event::ParseStyle, "sources must be an object");
         return;
     }
 
-    for (const auto& property : value.GetObject()) {
-        std::string id = *conversion::toString(property.name);
-
+    conversion::eachMember(value, [&] (const std::string& id, const V& sourceValue) -> optional<conversion::Error> {
         conversion::Error error;
         optional<std::unique_ptr<Source>> source =
-            conversion::convert<std::unique_ptr<Source>>(property.value, error, id);
+            conversion::convert<std::unique_ptr<Source>>(sourceValue, error, id);
         if (!source) {
             Log::Warning(Event::ParseStyle, error.message);
-            continue;
+            return {};
         }
 
         sourcesMap.emplace(id, (*source).get());
         sources.emplace_back(std::move(*source));
-    }
+        return {};
+    });
 }
 
-void Parser::parseLayers(const JSValue& value) {
+template <class V, class Layers>
+std::vector<std::string> Parser::indexLayers(const V& value, Layers& layerValues) {
+    using namespace conversion;
+
     std::vector<std::string> ids;
 
-    if (!value.IsArray()) {
+    if (!isArray(value)) {
         Log::Warning(Event::ParseStyle, "layers must be an array");
-        return;
+        return ids;
     }
 
-    for (auto& layerValue : value.GetArray()) {
-        if (!layerValue.IsObject()) {
+    for (std::size_t i = 0; i < arrayLength(value); i++) {
+        auto&& layerValue = arrayMember(value, i);
+
+        if (!isObject(layerValue)) {
             Log::Warning(Event::ParseStyle, "layer must be an object");
             continue;
         }
 
-        if (!layerValue.HasMember("id")) {
+        auto id = objectMember(layerValue, "id");
+        if (!id) {
             Log::Warning(Event::ParseStyle, "layer must have an id");
             continue;
         }
 
-        const JSValue& id = layerValue["id"];
-        if (!id.IsString()) {
+        optional<std::string> layerID = toString(*id);
+        if (!layerID) {
             Log::Warning(Event::ParseStyle, "layer id must be a string");
             continue;
         }
 
-        const std::string layerID = { id.GetString(), id.GetStringLength() };
-        if (layersMap.find(layerID) != layersMap.end()) {
-            Log::Warning(Event::ParseStyle, "duplicate layer id %s", layerID.c_str());
+        if (layerValues.find(*layerID) != layerValues.end()) {
+            Log::Warning(Event::ParseStyle, "duplicate layer id %s", layerID->c_str());
             continue;
         }
 
-        layersMap.emplace(layerID, std::pair<const JSValue&, std::unique_ptr<Layer>> { layerValue, nullptr });
-        ids.push_back(layerID);
+        layerValues.emplace(*layerID, typename Layers::mapped_type { layerValue, nullptr });
+        ids.push_back(*layerID);
+
+        // Layers that use a "ref" share the source of the layer they refer to, which is listed
+        // on its own.
+        if (auto source = objectMember(layerValue, "source")) {
+            optional<std::string> sourceID = toString(*source);
+            if (sourceID && !isHidden(layerValue)) {
+                layerSources.insert(*sourceID);
+            }
+        }
     }
 
+    return ids;
+}
+
+template <class Layers>
+void Parser::parseLayers(const std::vector<std::string>& ids, Layers& layerValues) {
     for (const auto& id : ids) {
-        auto it = layersMap.find(id);
+        auto it = layerValues.find(id);
 
         parseLayer(it->first,
                    it->second.first,
-                   it->second.second);
+                   it->second.second,
+                   layerValues);
     }
 
     for (const auto& id : ids) {
-        auto it = layersMap.find(id);
+        auto it = layerValues.find(id);
 
         if (it->second.second) {
             layers.emplace_back(std::move(it->second.second));
@@ -181,7 +257,8 @@ void Parser::parseLayers(const JSValue& value) {
     }
 }
 
-void Parser::parseLayer(const std::string& id, const JSValue& value, std::unique_ptr<Layer>& layer) {
+template <class V, class Layers>
+void Parser::parseLayer(const std::string& id, const V& value, std::unique_ptr<Layer>& layer, Layers& layerValues) {
     if (layer) {
         // Skip parsing this again. We already have a valid layer definition.
         return;
@@ -193,18 +270,17 @@ void Parser::parseLayer(const std::string& id, const JSValue& value, std::unique
         return;
     }
 
-    if (value.HasMember("ref")) {
+    if (auto refValue = conversion::objectMember(value, "ref")) {
         // This layer is referencing another layer. Recursively parse that layer.
-        const JSValue& refVal = value["ref"];
-        if (!refVal.IsString()) {
+        optional<std::string> ref = conversion::toString(*refValue);
+        if (!ref) {
             Log::Warning(Event::ParseStyle, "layer ref of '%s' must be a string", id.c_str());
             return;
         }
 
-        const std::string ref { refVal.GetString(), refVal.GetStringLength() };
-        auto it = layersMap.find(ref);
-        if (it == layersMap.end()) {
-            Log::Warning(Event::ParseStyle, "layer '%s' references unknown layer %s", id.c_str(), ref.c_str());
+        auto it = layerValues.find(*ref);
+        if (it == layerValues.end()) {
+            Log::Warning(Event::ParseStyle, "layer '%s' references unknown layer %s", id.c_str(), ref->c_str());
             return;
         }
 
@@ -212,7 +288,8 @@ void Parser::parseLayer(const std::string& id, const JSValue& value, std::unique
         stack.push_front(id);
         parseLayer(it->first,
                    it->second.first,
-                   it->second.second);
+                   it->second.second,
+                   layerValues);
         stack.pop_front();
 
         Layer* reference = it->second.second.get();
@@ -9,10 +9,12 @@
 
 #include <vector>
 #include <memory>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <forward_list>
+#include <functional>
 
 namespace mbgl {
 namespace style {
@@ -23,7 +25,13 @@ class Parser {
 public:
     ~Parser();
 
-    StyleParseResult parse(const std::string&);
+    // Parses the style. `onSourcesParsed`, if given, is called once `sources`, `layerSources`,
+    // `spriteURL` and `glyphURL` are complete and before any of the layers are converted, so
+    // that the resources of the style can start loading while the layers are being parsed.
+    StyleParseResult parse(const std::string&, std::function<void ()> onSourcesParsed = {});
+
+    // Parses a style that encodeBinaryStyle has encoded, like parse.
+    StyleParseResult parseBinary(const std::string&, std::function<void ()> onSourcesParsed = {});
 
     std::string spriteURL;
     std::string glyphURL;
@@ -31,6 +39,9 @@ public:
     std::vector<std::unique_ptr<Source>> sources;
     std::vector<std::unique_ptr<Layer>> layers;
 
+    // The IDs of the sources that the layers which aren't hidden by their visibility refer to.
+    std::set<std::string> layerSources;
+
     std::string name;
     LatLng latLng;
     double zoom = 0;
@@ -41,12 +52,19 @@ public:
     std::vector<FontStack> fontStacks() const;
 
 private:
-    void parseSources(const JSValue&);
-    void parseLayers(const JSValue&);
-    void parseLayer(const std::string& id, const JSValue&, std::unique_ptr<Layer>&);
+    // Parses the style from any value that the conversions support.
+    template <class V>
+    StyleParseResult parseStyle(const V&, const std::function<void ()>& onSourcesParsed);
+    template <class V>
+    void parseSources(const V&);
+    template <class V, class Layers>
+    std::vector<std::string> indexLayers(const V&, Layers&);
+    template <class Layers>
+    void parseLayers(const std::vector<std::string>& ids, Layers&);
+    template <class V, class Layers>
+    void parseLayer(const std::string& id, const V&, std::unique_ptr<Layer>&, Layers&);
 
     std::unordered_map<std::string, const Source*> sourcesMap;
-    std::unordered_map<std::string, std::pair<const JSValue&, std::unique_ptr<Layer>>> layersMap;
 
     // Store a stack of layer IDs we're parsing right now. This is to prevent reference cycles.
     std::forward_list<std::string> stack;
@@ -6,10 +6,12 @@
 namespace mbgl {
 namespace style {
 
+class CameraFunctionCache;
+
 class PropertyEvaluationParameters {
 public:
     explicit PropertyEvaluationParameters(float z_)
-        : z(z_) {}
+        : z(z_), defaultFadeDuration(Duration::zero()) {}
 
     PropertyEvaluationParameters(float z_,
                           TimePoint now_,
@@ -24,6 +26,10 @@ public:
     TimePoint now;
     ZoomHistory zoomHistory;
     Duration defaultFadeDuration;
+
+    // Shares the results of deduplicated camera functions between the layers of a style, if
+    // set; functions are evaluated directly otherwise.
+    CameraFunctionCache* functionCache = nullptr;
 };
 
 } // namespace style
@@ -2,6 +2,7 @@
 
 #include <mbgl/style/property_value.hpp>
 #include <mbgl/style/property_evaluation_parameters.hpp>
+#include <mbgl/style/camera_function_cache.hpp>
 
 namespace mbgl {
 namespace style {
@@ -17,7 +18,7 @@ public:
 
     T operator()(const Undefined&) const { return defaultValue; }
     T operator()(const T& constant) const { return constant; }
-    T operator()(const CameraFunction<T>& fn) const { return fn.evaluate(parameters.z); }
+    T operator()(const CameraFunction<T>& fn) const { return evaluate(fn, parameters.z, parameters); }
 
 private:
     const PropertyEvaluationParameters& parameters;
@@ -1,5 +1,6 @@
 #include <mbgl/style/source.hpp>
 #include <mbgl/style/source_impl.hpp>
+#include <mbgl/util/async_request.hpp>
 
 namespace mbgl {
 namespace style {
@@ -14,6 +15,10 @@ const std::string& Source::getID() const {
     return baseImpl->id;
 }
 
+std::unique_ptr<Source> Source::copy(const std::string& id) const {
+    return baseImpl->clone(id);
+}
+
 optional<std::string> Source::getAttribution() const {
     return baseImpl->getAttribution();
 }
@@ -26,5 +31,9 @@ std::vector<Feature> Source::querySourceFeatures(const SourceQueryOptions& optio
     return baseImpl->querySourceFeatures(options);
 }
 
+std::unique_ptr<AsyncRequest> Source::querySourceFeatures(const SourceQueryOptions& options, SourceQueryCallback callback) {
+    return baseImpl->querySourceFeatures(options, std::move(callback));
+}
+
 } // namespace style
 } // namespace mbgl
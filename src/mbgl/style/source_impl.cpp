@@ -4,13 +4,16 @@
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/renderer/painter.hpp>
 #include <mbgl/style/update_parameters.hpp>
+#include <mbgl/text/collision_feature.hpp>
 #include <mbgl/text/placement_config.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/math/clamp.hpp>
 #include <mbgl/util/tile_cover.hpp>
+#include <mbgl/util/tile_coordinate.hpp>
 #include <mbgl/util/enum.hpp>
 #include <mbgl/map/query.hpp>
 #include <mbgl/style/query.hpp>
+#include <mbgl/style/source_query.hpp>
 
 #include <mbgl/algorithm/update_renderables.hpp>
 #include <mbgl/algorithm/generate_clip_ids.hpp>
@@ -19,12 +22,85 @@
 #include <mapbox/geometry/envelope.hpp>
 
 #include <algorithm>
+#include <limits>
+#include <unordered_set>
 
 namespace mbgl {
 namespace style {
 
 static SourceObserver nullObserver;
 
+// Tiles closer to the center of the viewport and closer to the ideal zoom level get a higher
+// priority, so that their pending layout work is processed first.
+static int32_t tilePriority(const OverscaledTileID& tileID, const TileCoordinate& center, int32_t idealZoom) {
+    const double tileScale = std::pow(2.0, tileID.canonical.z);
+    const double idealScale = std::pow(2.0, idealZoom);
+
+    // Distance from the tile's center to the viewport center, in ideal tile units. Tiles are
+    // shared by all world copies, so the horizontal distance wraps around.
+    double dx = std::abs((tileID.canonical.x + 0.5) / tileScale - center.p.x);
+    dx = std::min(dx, 1.0 - dx) * idealScale;
+    const double dy = ((tileID.canonical.y + 0.5) / tileScale - center.p.y) * idealScale;
+    const double distance = std::sqrt(dx * dx + dy * dy);
+
+    const int32_t zoomDifference = std::abs(int32_t(tileID.overscaledZ) - idealZoom);
+
+    return -int32_t(util::clamp(distance * 16.0, 0.0, 1e6)) - zoomDifference * 256;
+}
+
+// Tiles loaded ahead of a camera animation come after all tiles of the viewport, and those that
+// the camera gets to first come first. Each state of the path spans 2^21 priorities, more than
+// tilePriority() ever takes away.
+static int32_t prefetchPriority(std::size_t pathIndex, int32_t priority) {
+    return std::numeric_limits<int32_t>::min() / 2 - int32_t(pathIndex << 21) + priority;
+}
+
+// Tiles laid out while the map is idle come after those of camera animations as well.
+static int32_t prelayoutPriority(int32_t priority) {
+    return std::numeric_limits<int32_t>::min() + (1 << 22) + priority;
+}
+
+// The tiles next to the ideal ones at their zoom level, their parents and their children, which
+// a small pan or zoom from the current camera needs.
+static std::vector<OverscaledTileID> prelayoutRing(const std::vector<OverscaledTileID>& idealTiles,
+                                                   const Range<uint8_t>& zoomRange,
+                                                   uint8_t maxOverscaledZoom,
+                                                   bool overscaling) {
+    std::vector<OverscaledTileID> ring;
+    for (const auto& tileID : idealTiles) {
+        const CanonicalTileID& canonical = tileID.canonical;
+        const int64_t dim = int64_t(1) << canonical.z;
+        for (int8_t dy = -1; dy <= 1; dy++) {
+            for (int8_t dx = -1; dx <= 1; dx++) {
+                const int64_t y = int64_t(canonical.y) + dy;
+                if ((dx == 0 && dy == 0) || y < 0 || y >= dim) {
+                    continue;
+                }
+                const auto x = static_cast<uint32_t>((int64_t(canonical.x) + dx + dim) % dim);
+                ring.emplace_back(tileID.overscaledZ, canonical.z, x, static_cast<uint32_t>(y));
+            }
+        }
+
+        if (tileID.overscaledZ > zoomRange.min) {
+            ring.push_back(tileID.scaledTo(tileID.overscaledZ - 1));
+        }
+
+        if (tileID.overscaledZ < maxOverscaledZoom) {
+            if (canonical.z < zoomRange.max) {
+                for (const auto& child : canonical.children()) {
+                    ring.emplace_back(tileID.overscaledZ + 1, child);
+                }
+            } else if (overscaling) {
+                ring.emplace_back(tileID.overscaledZ + 1, canonical);
+            }
+        }
+    }
+
+    std::sort(ring.begin(), ring.end());
+    ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+    return ring;
+}
+
 Source::Impl::Impl(SourceType type_, std::string id_, Source& base_)
     : type(type_),
       id(std::move(id_)),
@@ -53,18 +129,12 @@ void Source::Impl::detach() {
 void Source::Impl::invalidateTiles() {
     tiles.clear();
     renderTiles.clear();
+    renderTilesChanged = true;
     cache.clear();
 }
 
-void Source::Impl::startRender(algorithm::ClipIDGenerator& generator,
-                         const mat4& projMatrix,
+void Source::Impl::startRender(const mat4& projMatrix,
                          const TransformState& transform) {
-    if (type == SourceType::Vector ||
-        type == SourceType::GeoJSON ||
-        type == SourceType::Annotations) {
-        generator.update(renderTiles);
-    }
-
     for (auto& pair : renderTiles) {
         auto& tile = pair.second;
         transform.matrixFor(tile.matrix, tile.id);
@@ -81,11 +151,47 @@ void Source::Impl::finishRender(Painter& painter) {
     }
 }
 
-std::map<UnwrappedTileID, RenderTile>& Source::Impl::getRenderTiles() {
+bool Source::Impl::isClipped() const {
+    return type == SourceType::Vector ||
+           type == SourceType::GeoJSON ||
+           type == SourceType::Annotations;
+}
+
+void Source::Impl::updateClipIDs(algorithm::ClipIDGenerator& generator) {
+    generator.update(renderTiles);
+    renderTilesChanged = false;
+}
+
+util::FlatMap<UnwrappedTileID, RenderTile>& Source::Impl::getRenderTiles() {
     return renderTiles;
 }
 
 void Source::Impl::updateTiles(const UpdateParameters& parameters) {
+    workerScheduler = &parameters.workerScheduler;
+    setWorkerScheduler(parameters.workerScheduler);
+
+    // The buckets of fill layers are only laid out for picking while it is enabled, and with
+    // outlines while the view isn't multisampled, so the tiles of the sources that have fills are
+    // laid out anew once either is switched.
+    if (parameters.featurePicking != featurePicking || parameters.multisampling != multisampling) {
+        featurePicking = parameters.featurePicking;
+        multisampling = parameters.multisampling;
+        if (type == SourceType::Vector ||
+            type == SourceType::GeoJSON ||
+            type == SourceType::Annotations) {
+            invalidateTiles();
+        }
+    }
+
+    for (auto& pair : changedFeatureStates) {
+        if (pair.second->empty()) {
+            featureStates.erase(pair.first);
+        } else {
+            featureStates[pair.first] = std::move(pair.second);
+        }
+    }
+    changedFeatureStates.clear();
+
     if (!loaded) {
         return;
     }
@@ -93,21 +199,31 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
     const uint16_t tileSize = getTileSize();
     const optional<Range<uint8_t>> zoomRange = getZoomRange();
 
-    // Determine the overzooming/underzooming amounts and required tiles.
-    int32_t overscaledZoom = util::coveringZoomLevel(parameters.transformState.getZoom(), type, tileSize);
-    int32_t tileZoom = overscaledZoom;
+    // Determines the overzooming/underzooming amounts and the ideal tiles of a state.
+    auto coverFn = [&](const TransformState& state, int32_t& tileZoom) {
+        const int32_t overscaledZoom = util::coveringZoomLevel(state.getZoom(), type, tileSize);
+        tileZoom = overscaledZoom;
 
-    std::vector<UnwrappedTileID> idealTiles;
-    if (overscaledZoom >= zoomRange->min) {
-        int32_t idealZoom = std::min<int32_t>(zoomRange->max, overscaledZoom);
+        std::vector<UnwrappedTileID> cover;
+        if (overscaledZoom >= zoomRange->min) {
+            int32_t idealZoom = std::min<int32_t>(zoomRange->max, overscaledZoom);
+
+            // Make sure we're not reparsing overzoomed raster tiles.
+            if (type == SourceType::Raster || type == SourceType::RasterDEM) {
+                tileZoom = idealZoom;
+            }
 
-        // Make sure we're not reparsing overzoomed raster tiles.
-        if (type == SourceType::Raster) {
-            tileZoom = idealZoom;
+            // Tilted views show the tiles far from the camera at a smaller scale, so those are
+            // of lower zoom levels.
+            cover = state.getPitch() != 0
+                ? util::lodTileCover(state, idealZoom, zoomRange->min)
+                : util::tileCover(state, idealZoom);
         }
+        return cover;
+    };
 
-        idealTiles = util::tileCover(parameters.transformState, idealZoom);
-    }
+    int32_t tileZoom;
+    const std::vector<UnwrappedTileID> idealTiles = coverFn(parameters.transformState, tileZoom);
 
     // Stores a list of all the tiles that we're definitely going to retain. There are two
     // kinds of tiles we need: the ideal tiles determined by the tile cover. They may not yet be in
@@ -137,15 +253,79 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
         return tiles.emplace(tileID, std::move(tile)).first->second.get();
     };
     auto renderTileFn = [this](const UnwrappedTileID& tileID, Tile& tile) {
-        renderTiles.emplace(tileID, RenderTile{ tileID, tile });
+        nextRenderTiles.emplace_back(tileID, &tile);
     };
 
-    renderTiles.clear();
+    // While the camera moves, the tiles drawn in the previous frame aren't evicted to the cache,
+    // where they couldn't stand in for the new ideal tiles, before those are loaded. When zooming
+    // out, they are also looked for more than one zoom level below the ideal ones.
+    uint8_t descendantZoomLevels = 1;
+    if (parameters.cameraMoving) {
+        for (auto& pair : renderTiles) {
+            retainTileFn(pair.second.tile, Resource::Necessity::Optional);
+        }
+        descendantZoomLevels = 3;
+    }
+
+    nextRenderTiles.clear();
     algorithm::updateRenderables(getTileFn, createTileFn, retainTileFn, renderTileFn,
-                                 idealTiles, *zoomRange, tileZoom);
+                                 idealTiles, *zoomRange, tileZoom, descendantZoomLevels);
+
+    // While the camera moves within the same tiles, the render tiles are kept along with their
+    // clip IDs, so that they are only assigned again once the tiles change.
+    bool sameRenderTiles = nextRenderTiles.size() == renderTiles.size();
+    for (auto it = nextRenderTiles.begin(); sameRenderTiles && it != nextRenderTiles.end(); ++it) {
+        auto renderTile = renderTiles.find(it->first);
+        sameRenderTiles = renderTile != renderTiles.end() && &renderTile->second.tile == it->second;
+    }
+    if (!sameRenderTiles) {
+        // updateRenderables() finds each render tile once, so appending them in order keeps
+        // the keys unique.
+        std::sort(nextRenderTiles.begin(), nextRenderTiles.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        renderTiles.clear();
+        renderTiles.reserve(nextRenderTiles.size());
+        for (const auto& pair : nextRenderTiles) {
+            renderTiles.emplaceBack(pair.first, pair.first, *pair.second);
+        }
+        renderTilesChanged = true;
+    }
 
+    // Load the tiles of the states that a camera animation passes through, after those of the
+    // viewport. They are only retained while the animation lasts.
+    util::FlatMap<OverscaledTileID, int32_t> prefetchTiles;
     if (type != SourceType::Annotations) {
-        size_t conservativeCacheSize =
+        const auto& path = parameters.prefetchStates;
+        for (std::size_t i = 0; i < path.size(); i++) {
+            int32_t pathTileZoom;
+            const std::vector<UnwrappedTileID> pathTiles = coverFn(path[i], pathTileZoom);
+            const TileCoordinate pathCenter = TileCoordinate::fromLatLng(0, path[i].getLatLng(LatLng::Wrapped));
+            for (const auto& pathTile : pathTiles) {
+                const OverscaledTileID tileID(
+                    algorithm::dataTileZoomFor(pathTile, *zoomRange, pathTileZoom), pathTile.canonical);
+                if (retain.count(tileID) || prefetchTiles.count(tileID)) {
+                    continue;
+                }
+                Tile* tile = getTileFn(tileID);
+                if (!tile) {
+                    tile = createTileFn(tileID);
+                }
+                if (tile) {
+                    prefetchTiles.emplace(tileID, prefetchPriority(i, tilePriority(tileID, pathCenter, pathTileZoom)));
+                }
+            }
+        }
+        for (const auto& pair : prefetchTiles) {
+            // Prioritized before they're required, so that their requests start out behind.
+            Tile& tile = *tiles.at(pair.first);
+            tile.setPriority(pair.second);
+            retainTileFn(tile, Resource::Necessity::Required);
+        }
+    }
+
+    size_t conservativeCacheSize = 0;
+    if (type != SourceType::Annotations) {
+        conservativeCacheSize =
             std::max((float)parameters.transformState.getSize().width / tileSize, 1.0f) *
             std::max((float)parameters.transformState.getSize().height / tileSize, 1.0f) *
             (parameters.transformState.getMaxZoom() - parameters.transformState.getMinZoom() + 1) *
@@ -153,39 +333,153 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
         cache.setSize(conservativeCacheSize);
     }
 
+    const TileCoordinate center = TileCoordinate::fromLatLng(0, parameters.transformState.getLatLng(LatLng::Wrapped));
+
+    // While the map is idle, the tiles around the ideal ones are laid out from what the file
+    // source has cached, behind all other tiles. They are no more than the tile cache holds, so
+    // that all of them are evicted to it, rather than dropped, once the camera moves again and
+    // they aren't retained anymore.
+    if (parameters.prelayout && !parameters.cameraMoving && type != SourceType::Annotations) {
+        std::vector<OverscaledTileID> ideal;
+        ideal.reserve(idealTiles.size());
+        for (const auto& idealTile : idealTiles) {
+            ideal.emplace_back(algorithm::dataTileZoomFor(idealTile, *zoomRange, tileZoom), idealTile.canonical);
+        }
+
+        const bool overscaling = type != SourceType::Raster && type != SourceType::RasterDEM;
+        const auto maxOverscaledZoom = uint8_t(util::coveringZoomLevel(parameters.transformState.getMaxZoom(), type, tileSize));
+
+        std::vector<std::pair<int32_t, OverscaledTileID>> ring;
+        for (const auto& tileID : prelayoutRing(ideal, *zoomRange, maxOverscaledZoom, overscaling)) {
+            if (!retain.count(tileID)) {
+                ring.emplace_back(prelayoutPriority(tilePriority(tileID, center, tileZoom)), tileID);
+            }
+        }
+        std::sort(ring.begin(), ring.end(), [](const auto& a, const auto& b) {
+            return a.first > b.first;
+        });
+        if (ring.size() > conservativeCacheSize) {
+            ring.erase(ring.begin() + conservativeCacheSize, ring.end());
+        }
+
+        for (const auto& pair : ring) {
+            Tile* tile = getTileFn(pair.second);
+            if (!tile) {
+                tile = createTileFn(pair.second);
+            }
+            if (tile) {
+                prefetchTiles.emplace(pair.second, pair.first);
+                retainTileFn(*tile, Resource::Necessity::Optional);
+            }
+        }
+    }
+
     removeStaleTiles(retain);
+    for (auto& pair : tiles) {
+        auto prefetch = prefetchTiles.find(pair.first);
+        pair.second->setPriority(prefetch == prefetchTiles.end()
+            ? tilePriority(pair.first, center, tileZoom)
+            : prefetch->second);
+    }
+
+    for (auto& pair : tiles) {
+        pair.second->setFeatureStates(featureStates);
+    }
 
     const PlacementConfig config { parameters.transformState.getAngle(),
                                    parameters.transformState.getPitch(),
                                    parameters.debugOptions & MapDebugOptions::Collision };
 
     for (auto& pair : tiles) {
-        pair.second->setPlacementConfig(config);
+        const OverscaledTileID& tileID = pair.first;
+        PlacementConfig tileConfig = config;
+
+        // Place the symbols of the tile around those of the adjacent tiles that come before it,
+        // so that of two symbols colliding at a seam, the one in the later tile gives way. A tile
+        // is only placed again once the symbols near the edges of those tiles changed.
+        const CanonicalTileID& canonical = tileID.canonical;
+        const int64_t dim = int64_t(1) << canonical.z;
+        for (int8_t dy = -1; dy <= 1; dy++) {
+            for (int8_t dx = -1; dx <= 1; dx++) {
+                const int64_t y = int64_t(canonical.y) + dy;
+                if ((dx == 0 && dy == 0) || y < 0 || y >= dim) {
+                    continue;
+                }
+
+                // Wrap around the antimeridian.
+                const auto x = static_cast<uint32_t>((int64_t(canonical.x) + dx + dim) % dim);
+                const OverscaledTileID neighbourID { tileID.overscaledZ, canonical.z, x, static_cast<uint32_t>(y) };
+                if (!(neighbourID < tileID)) {
+                    continue;
+                }
+
+                auto it = tiles.find(neighbourID);
+                if (it == tiles.end()) {
+                    continue;
+                }
+
+                auto boxes = it->second->getEdgeCollisionBoxes();
+                if (boxes && !boxes->empty()) {
+                    tileConfig.neighbours.push_back({ dx, dy, std::move(boxes) });
+                }
+            }
+        }
+
+        pair.second->setPlacementConfig(tileConfig);
+    }
+}
+
+void Source::Impl::setFeatureState(const std::string& sourceLayer, const FeatureIdentifier& featureID, PropertyMap state) {
+    auto changed = changedFeatureStates.find(sourceLayer);
+    if (changed == changedFeatureStates.end()) {
+        auto current = featureStates.find(sourceLayer);
+        changed = changedFeatureStates.emplace(sourceLayer, current == featureStates.end()
+            ? std::make_shared<FeatureStateMap>()
+            : std::make_shared<FeatureStateMap>(*current->second)).first;
+    }
+
+    if (state.empty()) {
+        changed->second->erase(featureID);
+    } else {
+        (*changed->second)[featureID] = std::move(state);
+    }
+}
+
+PropertyMap Source::Impl::getFeatureState(const std::string& sourceLayer, const FeatureIdentifier& featureID) const {
+    const FeatureStateMap* states = nullptr;
+    auto changed = changedFeatureStates.find(sourceLayer);
+    if (changed != changedFeatureStates.end()) {
+        states = changed->second.get();
+    } else {
+        auto current = featureStates.find(sourceLayer);
+        if (current != featureStates.end()) {
+            states = current->second.get();
+        }
+    }
+
+    if (!states) {
+        return {};
     }
+    auto it = states->find(featureID);
+    return it == states->end() ? PropertyMap() : it->second;
 }
 
 // Moves all tiles to the cache except for those specified in the retain set.
 void Source::Impl::removeStaleTiles(const std::set<OverscaledTileID>& retain) {
-    // Remove stale tiles. This goes through the (sorted!) tiles map and retain set in lockstep
-    // and removes items from tiles that don't have the corresponding key in the retain set.
-    auto tilesIt = tiles.begin();
-    auto retainIt = retain.begin();
-    while (tilesIt != tiles.end()) {
-        if (retainIt == retain.end() || tilesIt->first < *retainIt) {
-            tilesIt->second->setNecessity(Tile::Necessity::Optional);
-            cache.add(tilesIt->first, std::move(tilesIt->second));
-            tiles.erase(tilesIt++);
-        } else {
-            if (!(*retainIt < tilesIt->first)) {
-                ++tilesIt;
-            }
-            ++retainIt;
+    // Moving the tiles out first lets the entries of all of them be erased in a single pass.
+    for (auto& pair : tiles) {
+        if (!retain.count(pair.first)) {
+            pair.second->setNecessity(Tile::Necessity::Optional);
+            pair.second->setPriority(std::numeric_limits<int32_t>::min());
+            cache.add(pair.first, std::move(pair.second));
         }
     }
+    tiles.eraseIf([](const auto& pair) { return !pair.second; });
 }
 
 void Source::Impl::removeTiles() {
     renderTiles.clear();
+    renderTilesChanged = true;
     if (!tiles.empty()) {
         removeStaleTiles({});
     }
@@ -203,8 +497,32 @@ std::unordered_map<std::string, std::vector<Feature>> Source::Impl::queryRendere
                                            const TransformState& transformState,
                                            const RenderedQueryOptions& options) const {
     std::unordered_map<std::string, std::vector<Feature>> result;
+    forEachQueriedTile(geometry, transformState, [&] (const RenderTile& renderTile, const GeometryCoordinates& tileSpaceQueryGeometry) {
+        renderTile.tile.queryRenderedFeatures(result,
+                                              tileSpaceQueryGeometry,
+                                              transformState,
+                                              options);
+    });
+    return result;
+}
+
+void Source::Impl::queryRenderedFeatureHandles(std::vector<RenderedFeatureHandle>& result,
+                                               const ScreenLineString& geometry,
+                                               const TransformState& transformState,
+                                               const RenderedQueryOptions& options) const {
+    forEachQueriedTile(geometry, transformState, [&] (const RenderTile& renderTile, const GeometryCoordinates& tileSpaceQueryGeometry) {
+        renderTile.tile.queryRenderedFeatureHandles(result,
+                                                    tileSpaceQueryGeometry,
+                                                    transformState,
+                                                    options);
+    });
+}
+
+void Source::Impl::forEachQueriedTile(const ScreenLineString& geometry,
+                                      const TransformState& transformState,
+                                      const std::function<void (const RenderTile&, const GeometryCoordinates&)>& fn) const {
     if (renderTiles.empty() || geometry.empty()) {
-        return result;
+        return;
     }
 
     LineString<double> queryGeometry;
@@ -226,6 +544,9 @@ std::unordered_map<std::string, std::vector<Feature>> Source::Impl::queryRendere
                    [](const auto& pair) { return std::ref(pair.second); });
     std::sort(sortedTiles.begin(), sortedTiles.end(), sortRenderTiles);
 
+    GeometryCoordinates tileSpaceQueryGeometry;
+    tileSpaceQueryGeometry.reserve(queryGeometry.size());
+
     for (const auto& renderTileRef : sortedTiles) {
         const RenderTile& renderTile = renderTileRef.get();
         GeometryCoordinate tileSpaceBoundsMin = TileCoordinate::toGeometryCoordinate(renderTile.id, box.min);
@@ -238,19 +559,13 @@ std::unordered_map<std::string, std::vector<Feature>> Source::Impl::queryRendere
             continue;
         }
 
-        GeometryCoordinates tileSpaceQueryGeometry;
-        tileSpaceQueryGeometry.reserve(queryGeometry.size());
+        tileSpaceQueryGeometry.clear();
         for (const auto& c : queryGeometry) {
             tileSpaceQueryGeometry.push_back(TileCoordinate::toGeometryCoordinate(renderTile.id, c));
         }
 
-        renderTile.tile.queryRenderedFeatures(result,
-                                              tileSpaceQueryGeometry,
-                                              transformState,
-                                              options);
+        fn(renderTile, tileSpaceQueryGeometry);
     }
-
-    return result;
 }
 
 std::vector<Feature> Source::Impl::querySourceFeatures(const SourceQueryOptions& options) {
@@ -270,26 +585,99 @@ std::vector<Feature> Source::Impl::querySourceFeatures(const SourceQueryOptions&
     return result;
 }
 
+std::unique_ptr<AsyncRequest> Source::Impl::querySourceFeatures(const SourceQueryOptions& options,
+                                                                Source::SourceQueryCallback callback) {
+    std::vector<SourceQuery::QueriedTile> queried;
+
+    // Only VectorSource and GeoJSON source supported
+    if (type != SourceType::GeoJSON && type != SourceType::Vector) {
+        Log::Warning(Event::General, "Source type not supported");
+    } else {
+        for (const auto& pair : tiles) {
+            auto data = pair.second->getSharedData();
+            if (!data) {
+                continue;
+            }
+            auto sourceLayers = pair.second->getSourceQueryLayers(options);
+            if (sourceLayers.empty()) {
+                continue;
+            }
+            queried.push_back({ std::move(data), pair.first.canonical, std::move(sourceLayers) });
+        }
+    }
+
+    return std::make_unique<SourceQuery>(workerScheduler, std::move(queried), options.filter, std::move(callback));
+}
+
 void Source::Impl::setCacheSize(size_t size) {
     cache.setSize(size);
 }
 
+void Source::Impl::setCacheBudget(std::shared_ptr<TileCache::Budget> budget) {
+    cache.setBudget(std::move(budget));
+}
+
 void Source::Impl::onLowMemory() {
     cache.clear();
 }
 
+void Source::Impl::releaseCachedBuffers(const std::function<bool ()>& satisfied) {
+    cache.releaseBuffers(satisfied);
+}
+
+void Source::Impl::releaseHiddenBuffers(const std::function<bool ()>& satisfied) {
+    std::unordered_set<const Tile*> rendered;
+    for (const auto& pair : renderTiles) {
+        rendered.insert(&pair.second.tile);
+    }
+    for (auto& pair : tiles) {
+        if (satisfied()) {
+            return;
+        }
+        if (!rendered.count(pair.second.get())) {
+            pair.second->releaseBuffers();
+        }
+    }
+}
+
 void Source::Impl::setObserver(SourceObserver* observer_) {
     observer = observer_;
 }
 
 void Source::Impl::onTileChanged(Tile& tile) {
+    invalidateRenderTileBuckets(tile);
+    updateTileNeighbours(tile);
     observer->onTileChanged(base, tile.id);
 }
 
 void Source::Impl::onTileError(Tile& tile, std::exception_ptr error) {
+    invalidateRenderTileBuckets(tile);
     observer->onTileError(base, tile.id, error);
 }
 
+void Source::Impl::invalidateRenderTileBuckets(const Tile& tile) {
+    for (auto& pair : renderTiles) {
+        if (&pair.second.tile == &tile) {
+            pair.second.bucketsGeneration = 0;
+        }
+    }
+}
+
+void Source::Impl::getTileTraces(std::vector<std::pair<std::string, const TileTrace*>>& traces) const {
+    for (const auto& pair : tiles) {
+        traces.emplace_back(base.getID() + " " + util::toString(pair.first), &pair.second->trace);
+    }
+}
+
+MemoryUsage::Source Source::Impl::getMemoryUsage() const {
+    MemoryUsage::Source usage;
+    for (const auto& pair : tiles) {
+        pair.second->getMemoryUsage(usage.tiles);
+    }
+    usage.cachedTiles = cache.getStats().bytes;
+    return usage;
+}
+
 void Source::Impl::dumpDebugLogs() const {
     Log::Info(Event::General, "Source::id: %s", base.getID().c_str());
     Log::Info(Event::General, "Source::loaded: %d", loaded);
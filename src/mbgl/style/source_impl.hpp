@@ -5,6 +5,7 @@
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/tile/tile_observer.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/tile/feature_state.hpp>
 #include <mbgl/tile/tile_cache.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/style/query.hpp>
@@ -13,7 +14,9 @@
 #include <mbgl/util/mat4.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/range.hpp>
+#include <mbgl/util/flat_map.hpp>
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -23,9 +26,12 @@ namespace mbgl {
 
 class Painter;
 class FileSource;
+class Scheduler;
 class TransformState;
 class RenderTile;
 class RenderedQueryOptions;
+class RenderedFeatureHandle;
+class AsyncRequest;
 
 namespace algorithm {
 class ClipIDGenerator;
@@ -42,6 +48,10 @@ public:
     ~Impl() override;
 
     virtual void loadDescription(FileSource&) = 0;
+
+    // Creates a source with the ID that is defined like this one, and that starts out with the
+    // description and data that this one has loaded, without loading them again.
+    virtual std::unique_ptr<Source> clone(const std::string& id) const = 0;
     bool isLoaded() const;
 
     // Called when the camera has changed. May load new tiles, unload obsolete tiles, or
@@ -58,26 +68,56 @@ public:
     // data with fresh style information.
     void reloadTiles();
 
-    void startRender(algorithm::ClipIDGenerator&,
-                     const mat4& projMatrix,
+    void startRender(const mat4& projMatrix,
                      const TransformState&);
     void finishRender(Painter&);
 
-    std::map<UnwrappedTileID, RenderTile>& getRenderTiles();
+    // Whether the render tiles of this source are clipped to their tile boundaries.
+    bool isClipped() const;
+    // Assigns the clip IDs of the render tiles.
+    void updateClipIDs(algorithm::ClipIDGenerator&);
+    // Whether the render tiles changed since their clip IDs were last assigned.
+    bool haveRenderTilesChanged() const {
+        return renderTilesChanged;
+    }
+
+    util::FlatMap<UnwrappedTileID, RenderTile>& getRenderTiles();
 
     std::unordered_map<std::string, std::vector<Feature>>
     queryRenderedFeatures(const ScreenLineString& geometry,
                           const TransformState& transformState,
                           const RenderedQueryOptions& options) const;
 
+    void queryRenderedFeatureHandles(std::vector<RenderedFeatureHandle>& result,
+                                     const ScreenLineString& geometry,
+                                     const TransformState& transformState,
+                                     const RenderedQueryOptions& options) const;
+
     std::vector<Feature> querySourceFeatures(const SourceQueryOptions&);
+    std::unique_ptr<AsyncRequest> querySourceFeatures(const SourceQueryOptions&, Source::SourceQueryCallback);
+
+    // Sets the state of a feature of a source layer, which the tiles pick up when they are
+    // updated next. An empty state removes the feature's state.
+    void setFeatureState(const std::string& sourceLayer, const FeatureIdentifier&, PropertyMap state);
+    PropertyMap getFeatureState(const std::string& sourceLayer, const FeatureIdentifier&) const;
 
     void setCacheSize(size_t);
+    void setCacheBudget(std::shared_ptr<TileCache::Budget>);
     void onLowMemory();
 
+    // Releases the buffers of the cached tiles, or of the loaded tiles that aren't rendered, such
+    // as those kept while the tiles that replace them load, until `satisfied` returns true.
+    void releaseCachedBuffers(const std::function<bool ()>& satisfied);
+    void releaseHiddenBuffers(const std::function<bool ()>& satisfied);
+
     void setObserver(SourceObserver*);
     void dumpDebugLogs() const;
 
+    // Appends the traces of this source's loaded tiles, labelled by source ID and tile ID.
+    void getTileTraces(std::vector<std::pair<std::string, const TileTrace*>>&) const;
+
+    MemoryUsage::Source getMemoryUsage() const;
+
     const SourceType type;
     const std::string id;
 
@@ -97,20 +137,49 @@ public:
 protected:
     Source& base;
     SourceObserver* observer = nullptr;
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
+    util::FlatMap<OverscaledTileID, std::unique_ptr<Tile>> tiles;
     TileCache cache;
 
 private:
     void removeStaleTiles(const std::set<OverscaledTileID>&);
 
+    // Calls the function with each render tile that the geometry may intersect, and the geometry
+    // in the coordinates of the tile.
+    void forEachQueriedTile(const ScreenLineString& geometry,
+                            const TransformState&,
+                            const std::function<void (const RenderTile&, const GeometryCoordinates&)>&) const;
+
     // TileObserver implementation.
     void onTileChanged(Tile&) override;
     void onTileError(Tile&, std::exception_ptr) override;
 
     virtual uint16_t getTileSize() const = 0;
+    // Called as the tiles are updated with the scheduler that the tiles do their work on, for
+    // sources that do work of their own on the worker threads.
+    virtual void setWorkerScheduler(Scheduler&) {}
+    // The scheduler of the last update, which source queries are run on.
+    Scheduler* workerScheduler = nullptr;
     virtual std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) = 0;
-
-    std::map<UnwrappedTileID, RenderTile> renderTiles;
+    // Called when a tile changed, before the observer hears of it, for sources whose tiles
+    // depend on the tiles around them.
+    virtual void updateTileNeighbours(Tile&) {}
+    // The buckets of a tile that changed are looked up again the next time it is rendered.
+    void invalidateRenderTileBuckets(const Tile&);
+
+    util::FlatMap<UnwrappedTileID, RenderTile> renderTiles;
+    bool renderTilesChanged = true;
+    // The render tiles as they are found while updating the tiles, before they are compared with
+    // the current ones. Kept to reuse its memory.
+    std::vector<std::pair<UnwrappedTileID, Tile*>> nextRenderTiles;
+
+    // Whether the tiles were created for feature picking, and for a multisampled view.
+    bool featurePicking = false;
+    bool multisampling = false;
+
+    // The feature states that the tiles were last given, and copies of the states of the source
+    // layers that changed since, so that a batch of changes copies each layer once.
+    FeatureStates featureStates;
+    std::unordered_map<std::string, std::shared_ptr<FeatureStateMap>> changedFeatureStates;
 };
 
 } // namespace style
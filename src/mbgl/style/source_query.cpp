@@ -0,0 +1,56 @@
+#include <mbgl/style/source_query.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+namespace style {
+
+SourceQuery::SourceQuery(Scheduler* scheduler,
+                         std::vector<QueriedTile> tiles,
+                         optional<Filter> filter,
+                         Source::SourceQueryCallback callback_)
+    : callback(std::move(callback_)),
+      pending(tiles.size()),
+      mailbox(std::make_shared<Mailbox>(*util::RunLoop::Get())) {
+    assert(scheduler || tiles.empty());
+
+    if (tiles.empty()) {
+        // Complete asynchronously all the same, like a query that finds nothing.
+        pending = 1;
+        ActorRef<SourceQuery>(*this, mailbox).invoke(&SourceQuery::onFeatures, std::vector<Feature>());
+        return;
+    }
+
+    // Each tile gets an actor of its own, so that the tiles are queried side by side.
+    workers.reserve(tiles.size());
+    for (auto& tile : tiles) {
+        workers.push_back(std::make_unique<Actor<SourceQueryWorker>>(*scheduler, ActorRef<SourceQuery>(*this, mailbox)));
+        workers.back()->invoke(&SourceQueryWorker::query, std::move(tile.data), tile.id, std::move(tile.sourceLayers), filter);
+    }
+}
+
+SourceQuery::~SourceQuery() = default;
+
+void SourceQuery::onFeatures(std::vector<Feature> features) {
+    assert(pending > 0);
+    pending--;
+
+    // Tiles overlap where their buffers do, so features with an ID may be found more than once.
+    std::vector<Feature> result;
+    result.reserve(features.size());
+    for (auto& feature : features) {
+        if (!feature.id || ids.insert(*feature.id).second) {
+            result.push_back(std::move(feature));
+        }
+    }
+
+    // The callback may release this query, so it is called on a copy, and last.
+    const bool done = pending == 0;
+    Source::SourceQueryCallback callback_ = done ? std::move(callback) : callback;
+    callback_(std::move(result), done);
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <mbgl/style/source.hpp>
+#include <mbgl/style/source_query_worker.hpp>
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/async_request.hpp>
+#include <mbgl/util/feature.hpp>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+class Scheduler;
+class Mailbox;
+
+namespace style {
+
+// A querySourceFeatures() call that gathers the features of each tile on a worker thread, and
+// passes them to the callback on the thread it was made on, as the tiles are done. Features
+// that more than one tile holds are passed once. Destroying the query cancels it.
+class SourceQuery : public AsyncRequest {
+public:
+    class QueriedTile {
+    public:
+        std::shared_ptr<const GeometryTileData> data;
+        CanonicalTileID id;
+        std::vector<std::string> sourceLayers;
+    };
+
+    // The scheduler may only be null if there are no tiles.
+    SourceQuery(Scheduler*, std::vector<QueriedTile>, optional<Filter>, Source::SourceQueryCallback);
+    ~SourceQuery() override;
+
+    void onFeatures(std::vector<Feature>);
+
+private:
+    Source::SourceQueryCallback callback;
+    std::size_t pending;
+    std::set<FeatureIdentifier> ids;
+
+    std::shared_ptr<Mailbox> mailbox;
+    std::vector<std::unique_ptr<Actor<SourceQueryWorker>>> workers;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,31 @@
+#include <mbgl/style/source_query_worker.hpp>
+#include <mbgl/style/source_query.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/string.hpp>
+
+namespace mbgl {
+namespace style {
+
+SourceQueryWorker::SourceQueryWorker(ActorRef<SourceQueryWorker>, ActorRef<SourceQuery> parent_)
+    : parent(std::move(parent_)) {
+}
+
+void SourceQueryWorker::query(std::shared_ptr<const GeometryTileData> data,
+                              CanonicalTileID tileID,
+                              std::vector<std::string> sourceLayers,
+                              optional<Filter> filter) {
+    std::vector<Feature> result;
+    try {
+        mbgl::querySourceFeatures(result, *data, tileID, sourceLayers, filter);
+    } catch (...) {
+        // The tile reports malformed data when it is parsed; its features are left out here.
+        Log::Warning(Event::General, "Querying tile features failed: %s",
+                     util::toString(std::current_exception()).c_str());
+        result.clear();
+    }
+    parent.invoke(&SourceQuery::onFeatures, std::move(result));
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/style/filter.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+class GeometryTileData;
+
+namespace style {
+
+class SourceQuery;
+
+// Gathers the features of one tile for a SourceQuery on a worker thread.
+class SourceQueryWorker {
+public:
+    SourceQueryWorker(ActorRef<SourceQueryWorker>, ActorRef<SourceQuery>);
+
+    void query(std::shared_ptr<const GeometryTileData>,
+               CanonicalTileID,
+               std::vector<std::string> sourceLayers,
+               optional<Filter>);
+
+private:
+    ActorRef<SourceQuery> parent;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,286 @@
+#include <mbgl/style/sources/cluster_index.hpp>
+#include <mbgl/math/clamp.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <string>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+using WorldPoint = mapbox::geometry::point<double>;
+
+WorldPoint project(const mapbox::geometry::point<double>& lngLat) {
+    const double sine = std::sin(util::clamp(lngLat.y, -util::LATITUDE_MAX, util::LATITUDE_MAX) * util::DEG2RAD);
+    return {
+        lngLat.x / util::DEGREES_MAX + 0.5,
+        util::clamp(0.5 - 0.25 * std::log((1 + sine) / (1 - sine)) / M_PI, 0.0, 1.0)
+    };
+}
+
+// A static k-d tree of points, as kdbush makes them: the entries are ordered so that the one in
+// the middle of each range splits it by x or y, alternating with the depth.
+class PointIndex {
+public:
+    struct Entry {
+        WorldPoint point;
+        uint32_t id;
+    };
+
+    explicit PointIndex(std::vector<Entry> entries_)
+        : entries(std::move(entries_)) {
+        sort(0, entries.size(), 0);
+    }
+
+    // Calls the function with the IDs of the points in the box.
+    template <class Fn>
+    void range(double minX, double minY, double maxX, double maxY, Fn&& fn) const {
+        search([&] (const WorldPoint& p) {
+            return p.x >= minX && p.x <= maxX && p.y >= minY && p.y <= maxY;
+        }, [&] (const WorldPoint& p, uint8_t axis) {
+            return axis == 0 ? p.x >= minX : p.y >= minY;
+        }, [&] (const WorldPoint& p, uint8_t axis) {
+            return axis == 0 ? p.x <= maxX : p.y <= maxY;
+        }, fn);
+    }
+
+    // Calls the function with the IDs of the points within the radius around the point.
+    template <class Fn>
+    void within(const WorldPoint& center, double radius, Fn&& fn) const {
+        const double r2 = radius * radius;
+        search([&] (const WorldPoint& p) {
+            const double dx = p.x - center.x;
+            const double dy = p.y - center.y;
+            return dx * dx + dy * dy <= r2;
+        }, [&] (const WorldPoint& p, uint8_t axis) {
+            return axis == 0 ? center.x - radius <= p.x : center.y - radius <= p.y;
+        }, [&] (const WorldPoint& p, uint8_t axis) {
+            return axis == 0 ? center.x + radius >= p.x : center.y + radius >= p.y;
+        }, fn);
+    }
+
+private:
+    // Ranges of no more entries than this are scanned rather than split.
+    static constexpr std::size_t nodeSize = 64;
+
+    void sort(std::size_t left, std::size_t right, uint8_t axis) {
+        if (right - left <= nodeSize) {
+            return;
+        }
+        const std::size_t middle = left + (right - left) / 2;
+        std::nth_element(entries.begin() + left, entries.begin() + middle, entries.begin() + right,
+                         [axis] (const Entry& a, const Entry& b) {
+                             return axis == 0 ? a.point.x < b.point.x : a.point.y < b.point.y;
+                         });
+        sort(left, middle, 1 - axis);
+        sort(middle + 1, right, 1 - axis);
+    }
+
+    // Visits the ranges that the entries splitting them say may hold matching points.
+    template <class Matches, class GoLeft, class GoRight, class Fn>
+    void search(Matches&& matches, GoLeft&& goLeft, GoRight&& goRight, Fn&& fn) const {
+        struct Range {
+            std::size_t left;
+            std::size_t right;
+            uint8_t axis;
+        };
+        std::vector<Range> stack { { 0, entries.size(), 0 } };
+
+        while (!stack.empty()) {
+            const Range range = stack.back();
+            stack.pop_back();
+
+            if (range.right - range.left <= nodeSize) {
+                for (std::size_t i = range.left; i < range.right; i++) {
+                    if (matches(entries[i].point)) {
+                        fn(entries[i].id);
+                    }
+                }
+                continue;
+            }
+
+            const std::size_t middle = range.left + (range.right - range.left) / 2;
+            const Entry& entry = entries[middle];
+            if (matches(entry.point)) {
+                fn(entry.id);
+            }
+            if (goLeft(entry.point, range.axis)) {
+                stack.push_back({ range.left, middle, uint8_t(1 - range.axis) });
+            }
+            if (goRight(entry.point, range.axis)) {
+                stack.push_back({ middle + 1, range.right, uint8_t(1 - range.axis) });
+            }
+        }
+    }
+
+    std::vector<Entry> entries;
+};
+
+// As mapbox-gl-js abbreviates them: 1234 is "1.2k" and 12345 is "12k".
+std::string abbreviate(uint32_t count) {
+    if (count >= 10000) {
+        return std::to_string(static_cast<uint32_t>(std::round(count / 1000.0))) + "k";
+    }
+    if (count >= 1000) {
+        const uint32_t hundreds = static_cast<uint32_t>(std::round(count / 100.0));
+        return std::to_string(hundreds / 10) + (hundreds % 10 ? "." + std::to_string(hundreds % 10) : "") + "k";
+    }
+    return std::to_string(count);
+}
+
+} // namespace
+
+class ClusterIndex::Level {
+public:
+    struct Cluster {
+        WorldPoint point;
+        uint32_t numPoints;
+        // The feature of the first of the points.
+        uint32_t id;
+    };
+
+    explicit Level(std::vector<Cluster> clusters_)
+        : clusters(std::move(clusters_)),
+          index(entries(clusters)) {
+    }
+
+    static std::vector<PointIndex::Entry> entries(const std::vector<Cluster>& clusters) {
+        std::vector<PointIndex::Entry> result;
+        result.reserve(clusters.size());
+        for (uint32_t i = 0; i < clusters.size(); i++) {
+            result.push_back({ clusters[i].point, i });
+        }
+        return result;
+    }
+
+    const std::vector<Cluster> clusters;
+    const PointIndex index;
+};
+
+ClusterIndex::ClusterIndex(std::shared_ptr<const FeatureCollection> features_, Options options_)
+    : features(std::move(features_)),
+      options(std::move(options_)),
+      levels(options.maxZoom + 2) {
+    std::vector<Level::Cluster> clusters;
+    points.reserve(features->size());
+    clusters.reserve(features->size());
+    for (const auto& feature : *features) {
+        points.push_back(project(feature.geometry.get<mapbox::geometry::point<double>>()));
+        clusters.push_back({ points.back(), 1, static_cast<uint32_t>(clusters.size()) });
+    }
+    levels.back() = std::make_shared<const Level>(std::move(clusters));
+}
+
+ClusterIndex::~ClusterIndex() = default;
+
+uint8_t ClusterIndex::levelOf(uint8_t zoom) const {
+    return std::min<uint8_t>(zoom, options.maxZoom + 1);
+}
+
+uint8_t ClusterIndex::levelCount() const {
+    return options.maxZoom + 2;
+}
+
+std::shared_ptr<const ClusterIndex::Level> ClusterIndex::getLevel(uint8_t level) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return levels.at(level);
+}
+
+bool ClusterIndex::isBuilt(uint8_t level) const {
+    return bool(getLevel(level));
+}
+
+void ClusterIndex::buildLevel(uint8_t level) {
+    if (isBuilt(level)) {
+        return;
+    }
+
+    const auto pointsLevel = getLevel(levelCount() - 1);
+    const double radius = double(options.radius) / (options.extent * std::pow(2, level));
+
+    // Each point that isn't part of a cluster yet absorbs those around it, in the order of the
+    // features.
+    std::vector<Level::Cluster> clusters;
+    std::vector<bool> clustered(points.size(), false);
+    for (uint32_t i = 0; i < points.size(); i++) {
+        if (clustered[i]) {
+            continue;
+        }
+        clustered[i] = true;
+        WorldPoint sum = points[i];
+        uint32_t numPoints = 1;
+        pointsLevel->index.within(points[i], radius, [&] (uint32_t j) {
+            if (clustered[j]) {
+                return;
+            }
+            clustered[j] = true;
+            sum.x += points[j].x;
+            sum.y += points[j].y;
+            numPoints++;
+        });
+        clusters.push_back({ { sum.x / numPoints, sum.y / numPoints }, numPoints, i });
+    }
+
+    auto built = std::make_shared<const Level>(std::move(clusters));
+
+    // Another thread may have built the level meanwhile; they are the same.
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!levels[level]) {
+        levels[level] = std::move(built);
+    }
+}
+
+mapbox::geometry::feature_collection<int16_t> ClusterIndex::getTile(uint8_t z, uint32_t x, uint32_t y) const {
+    const auto level = getLevel(levelOf(z));
+    assert(level);
+
+    mapbox::geometry::feature_collection<int16_t> result;
+    if (!level) {
+        return result;
+    }
+
+    const double tiles = std::pow(2, z);
+    const double r = double(options.radius) / options.extent;
+    double tileX = x;
+
+    const auto add = [&] (uint32_t id) {
+        const Level::Cluster& cluster = level->clusters[id];
+        mapbox::geometry::feature<int16_t> feature {
+            mapbox::geometry::point<int16_t>(
+                static_cast<int16_t>(std::round(options.extent * (cluster.point.x * tiles - tileX))),
+                static_cast<int16_t>(std::round(options.extent * (cluster.point.y * tiles - y))))
+        };
+        if (cluster.numPoints == 1) {
+            feature.id = (*features)[cluster.id].id;
+            feature.properties = (*features)[cluster.id].properties;
+        } else {
+            feature.properties["cluster"] = true;
+            feature.properties["point_count"] = uint64_t(cluster.numPoints);
+            feature.properties["point_count_abbreviated"] = abbreviate(cluster.numPoints);
+        }
+        result.push_back(std::move(feature));
+    };
+
+    const double top = (y - r) / tiles;
+    const double bottom = (y + 1 + r) / tiles;
+    level->index.range((x - r) / tiles, top, (x + 1 + r) / tiles, bottom, add);
+
+    // The buffers of the tiles at the edges of the world reach into its other side.
+    if (x == 0) {
+        tileX = tiles;
+        level->index.range(1 - r / tiles, top, 1, bottom, add);
+    }
+    if (x == tiles - 1) {
+        tileX = -1;
+        level->index.range(0, top, r / tiles, bottom, add);
+    }
+
+    return result;
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <mbgl/util/geojson.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <mapbox/geometry/feature.hpp>
+#include <mapbox/geometry/point.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+/*
+   The clusters of the points of a GeoJSON source, in tiles, as Supercluster makes them: at each
+   zoom level, a point absorbs the points within the radius around it that no earlier point has
+   absorbed, and becomes a cluster at their center.
+
+   Unlike Supercluster, which clusters each zoom level from the clusters of the level above, and
+   so has to build all of them in order, each level is clustered from the points directly. The
+   levels are independent of one another: they can be built concurrently, and only once a tile
+   at their zoom level is needed. Every level refers to the same projected points rather than to
+   copies of them.
+
+   The points are indexed when the index is made. Levels are built with buildLevel(), from any
+   thread; tiles can be read from those that are built.
+*/
+class ClusterIndex : private util::noncopyable {
+public:
+    struct Options {
+        // The highest zoom level that is clustered; tiles above it have the points themselves.
+        uint8_t maxZoom = 16;
+        // The radius of a cluster, and the extent of the tiles, in tile units.
+        uint16_t radius = 40;
+        uint16_t extent = 512;
+    };
+
+    // The features must all be points.
+    ClusterIndex(std::shared_ptr<const FeatureCollection>, Options);
+    ~ClusterIndex();
+
+    // The level that has the clusters of tiles at the zoom level.
+    uint8_t levelOf(uint8_t zoom) const;
+    // The number of levels, including that of the points.
+    uint8_t levelCount() const;
+
+    bool isBuilt(uint8_t level) const;
+    // Clusters the points for the level, unless another call did already.
+    void buildLevel(uint8_t level);
+
+    // The clusters of the tile, which must be of a built level, and the points within its buffer
+    // of the radius. Clusters have the properties "cluster", "point_count" and
+    // "point_count_abbreviated"; points that weren't clustered have their own.
+    mapbox::geometry::feature_collection<int16_t> getTile(uint8_t z, uint32_t x, uint32_t y) const;
+
+private:
+    class Level;
+
+    std::shared_ptr<const Level> getLevel(uint8_t level) const;
+
+    const std::shared_ptr<const FeatureCollection> features;
+    const Options options;
+    // The points in world coordinates, which range from 0 to 1 across the world.
+    std::vector<mapbox::geometry::point<double>> points;
+
+    mutable std::mutex mutex;
+    // By level; the last one has the points themselves, and is built with the index.
+    std::vector<std::shared_ptr<const Level>> levels;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,308 @@
+#include <mbgl/style/sources/geojson_parser.hpp>
+#include <mbgl/util/feature.hpp>
+
+#include <rapidjson/reader.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/error/en.h>
+
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+using Array = std::vector<Value>;
+
+const Value* member(const PropertyMap& object, const char* name) {
+    auto it = object.find(name);
+    return it == object.end() ? nullptr : &it->second;
+}
+
+const Array& toArray(const Value& value, const char* error) {
+    if (!value.is<Array>()) {
+        throw std::runtime_error(error);
+    }
+    return value.get<Array>();
+}
+
+double toDouble(const Value& value) {
+    if (value.is<double>()) {
+        return value.get<double>();
+    } else if (value.is<uint64_t>()) {
+        return value.get<uint64_t>();
+    } else if (value.is<int64_t>()) {
+        return value.get<int64_t>();
+    }
+    throw std::runtime_error("coordinates must be numbers");
+}
+
+mapbox::geometry::point<double> toPoint(const Value& value) {
+    const Array& coordinates = toArray(value, "coordinates must be arrays");
+    if (coordinates.size() < 2) {
+        throw std::runtime_error("coordinates array must have at least 2 numbers");
+    }
+    return { toDouble(coordinates[0]), toDouble(coordinates[1]) };
+}
+
+template <class Container>
+Container toPoints(const Value& value) {
+    Container points;
+    for (const auto& coordinates : toArray(value, "coordinates must be arrays")) {
+        points.push_back(toPoint(coordinates));
+    }
+    return points;
+}
+
+template <class Container>
+Container toLines(const Value& value) {
+    Container lines;
+    for (const auto& coordinates : toArray(value, "coordinates must be arrays")) {
+        lines.push_back(toPoints<typename Container::value_type>(coordinates));
+    }
+    return lines;
+}
+
+mapbox::geometry::geometry<double> toGeometry(const Value& value) {
+    if (!value.is<PropertyMap>()) {
+        throw std::runtime_error("Geometry must be an object");
+    }
+    const PropertyMap& object = value.get<PropertyMap>();
+
+    const Value* type = member(object, "type");
+    if (!type || !type->is<std::string>()) {
+        throw std::runtime_error("Geometry must have a type property");
+    }
+    const std::string& name = type->get<std::string>();
+
+    if (name == "GeometryCollection") {
+        const Value* geometries = member(object, "geometries");
+        if (!geometries) {
+            throw std::runtime_error("GeometryCollection must have a geometries property");
+        }
+        mapbox::geometry::geometry_collection<double> collection;
+        for (const auto& geometry : toArray(*geometries, "GeometryCollection geometries property must be an array")) {
+            collection.push_back(toGeometry(geometry));
+        }
+        return collection;
+    }
+
+    const Value* coordinates = member(object, "coordinates");
+    if (!coordinates) {
+        throw std::runtime_error(name + " geometry must have a coordinates property");
+    }
+
+    if (name == "Point") {
+        return toPoint(*coordinates);
+    } else if (name == "MultiPoint") {
+        return toPoints<mapbox::geometry::multi_point<double>>(*coordinates);
+    } else if (name == "LineString") {
+        return toPoints<mapbox::geometry::line_string<double>>(*coordinates);
+    } else if (name == "MultiLineString") {
+        return toLines<mapbox::geometry::multi_line_string<double>>(*coordinates);
+    } else if (name == "Polygon") {
+        return toLines<mapbox::geometry::polygon<double>>(*coordinates);
+    } else if (name == "MultiPolygon") {
+        mapbox::geometry::multi_polygon<double> polygons;
+        for (const auto& polygon : toArray(*coordinates, "coordinates must be arrays")) {
+            polygons.push_back(toLines<mapbox::geometry::polygon<double>>(polygon));
+        }
+        return polygons;
+    }
+
+    throw std::runtime_error(name + " not yet implemented");
+}
+
+Feature toFeature(Value&& value) {
+    if (!value.is<PropertyMap>()) {
+        throw std::runtime_error("Feature must be an object");
+    }
+    PropertyMap& object = value.get<PropertyMap>();
+
+    const Value* type = member(object, "type");
+    if (!type || !type->is<std::string>() || type->get<std::string>() != "Feature") {
+        throw std::runtime_error("Feature must have a type property with value 'Feature'");
+    }
+
+    const Value* geometry = member(object, "geometry");
+    if (!geometry) {
+        throw std::runtime_error("Feature must have a geometry property");
+    }
+
+    // Features without a location have empty geometries.
+    Feature feature { geometry->is<NullValue>()
+        ? mapbox::geometry::geometry<double> { mapbox::geometry::geometry_collection<double> {} }
+        : toGeometry(*geometry) };
+
+    auto properties = object.find("properties");
+    if (properties != object.end() && !properties->second.is<NullValue>()) {
+        if (!properties->second.is<PropertyMap>()) {
+            throw std::runtime_error("Feature properties must be an object");
+        }
+        feature.properties = std::move(properties->second.get<PropertyMap>());
+    }
+
+    if (const Value* id = member(object, "id")) {
+        if (id->is<uint64_t>()) {
+            feature.id = { id->get<uint64_t>() };
+        } else if (id->is<int64_t>()) {
+            feature.id = { id->get<int64_t>() };
+        } else if (id->is<double>()) {
+            feature.id = { id->get<double>() };
+        } else if (id->is<std::string>()) {
+            feature.id = { id->get<std::string>() };
+        } else {
+            throw std::runtime_error("Feature id must be a string or number");
+        }
+    }
+
+    return feature;
+}
+
+// Builds values from the reader's events, except for the elements of the root object's
+// "features" array, which it converts to features as soon as each of them is complete.
+class Handler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Handler> {
+public:
+    Handler(const rapidjson::MemoryStream& stream_, std::size_t size_, std::function<void (double)> progress_)
+        : stream(stream_), size(size_), progress(std::move(progress_)) {
+    }
+
+    bool Null() { return add(NullValue()); }
+    bool Bool(bool b) { return add(b); }
+    bool Int(int i) { return add(i < 0 ? Value(int64_t(i)) : Value(uint64_t(i))); }
+    bool Uint(unsigned u) { return add(uint64_t(u)); }
+    bool Int64(int64_t i) { return add(i < 0 ? Value(i) : Value(uint64_t(i))); }
+    bool Uint64(uint64_t u) { return add(u); }
+    bool Double(double d) { return add(d); }
+
+    bool String(const char* str, rapidjson::SizeType length, bool) {
+        return add(std::string(str, length));
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool) {
+        stack.back().key.assign(str, length);
+        return true;
+    }
+
+    bool StartObject() {
+        stack.emplace_back(true);
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        Value object { std::move(stack.back().members) };
+        stack.pop_back();
+        return add(std::move(object));
+    }
+
+    bool StartArray() {
+        if (stack.size() == 1 && stack.back().object && stack.back().key == "features") {
+            streaming = true;
+        }
+        stack.emplace_back(false);
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        if (streaming && stack.size() == 2) {
+            streaming = false;
+            hasFeatures = true;
+            stack.pop_back();
+            return true;
+        }
+        Value array { std::move(stack.back().elements) };
+        stack.pop_back();
+        return add(std::move(array));
+    }
+
+    GeoJSON result() {
+        if (!root.is<PropertyMap>()) {
+            throw std::runtime_error("GeoJSON must be an object");
+        }
+        const Value* type = member(root.get<PropertyMap>(), "type");
+        if (!type || !type->is<std::string>()) {
+            throw std::runtime_error("GeoJSON must have a type property");
+        }
+
+        if (type->get<std::string>() == "FeatureCollection") {
+            if (!hasFeatures) {
+                throw std::runtime_error("FeatureCollection must have features property");
+            }
+            return std::move(features);
+        } else if (type->get<std::string>() == "Feature") {
+            return toFeature(std::move(root));
+        } else {
+            return toGeometry(root);
+        }
+    }
+
+private:
+    struct Frame {
+        explicit Frame(bool object_) : object(object_) {}
+
+        bool object;
+        std::string key;
+        PropertyMap members;
+        Array elements;
+    };
+
+    bool add(Value&& value) {
+        if (stack.empty()) {
+            root = std::move(value);
+        } else if (streaming && stack.size() == 2) {
+            features.push_back(toFeature(std::move(value)));
+            reportProgress();
+        } else if (stack.back().object) {
+            Frame& frame = stack.back();
+            frame.members[frame.key] = std::move(value);
+        } else {
+            stack.back().elements.push_back(std::move(value));
+        }
+        return true;
+    }
+
+    void reportProgress() {
+        const std::size_t position = stream.Tell();
+        if (progress && size && (position - reported) * 100 >= size) {
+            reported = position;
+            progress(double(position) / size);
+        }
+    }
+
+    const rapidjson::MemoryStream& stream;
+    const std::size_t size;
+    const std::function<void (double)> progress;
+    std::size_t reported = 0;
+
+    std::vector<Frame> stack;
+    Value root;
+    bool streaming = false;
+    bool hasFeatures = false;
+    FeatureCollection features;
+};
+
+} // namespace
+
+GeoJSON parseGeoJSON(const Buffer& data, std::function<void (double)> progress) {
+    rapidjson::MemoryStream stream(data.data(), data.size());
+    Handler handler(stream, data.size(), progress);
+
+    rapidjson::Reader reader;
+    const rapidjson::ParseResult result = reader.Parse(stream, handler);
+    if (result.IsError()) {
+        std::stringstream message;
+        message << result.Offset() << " - " << rapidjson::GetParseError_En(result.Code());
+        throw GeoJSONSyntaxError(message.str());
+    }
+
+    GeoJSON geoJSON = handler.result();
+    if (progress) {
+        progress(1.0);
+    }
+    return geoJSON;
+}
+
+} // namespace style
+} // namespace mbgl
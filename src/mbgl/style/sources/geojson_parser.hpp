@@ -0,0 +1,28 @@
+#pragma once
+
+#include <mbgl/util/geojson.hpp>
+#include <mbgl/util/buffer.hpp>
+
+#include <mapbox/geojson.hpp>
+
+#include <functional>
+#include <stdexcept>
+
+namespace mbgl {
+namespace style {
+
+// Thrown by parseGeoJSON() for data that isn't JSON, as opposed to JSON that isn't GeoJSON.
+class GeoJSONSyntaxError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Parses GeoJSON from the events of a streaming JSON reader rather than from a JSON document,
+// converting the features of a feature collection one at a time, so that no more than a single
+// feature's JSON is held in memory alongside the parsed features. Calls the progress function
+// with the fraction of the data that has been read, from 0 to 1. Throws GeoJSONSyntaxError for
+// malformed JSON and std::runtime_error for JSON that isn't GeoJSON.
+GeoJSON parseGeoJSON(const Buffer& data, std::function<void (double)> progress = {});
+
+} // namespace style
+} // namespace mbgl
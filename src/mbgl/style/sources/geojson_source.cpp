@@ -18,9 +18,26 @@ void GeoJSONSource::setGeoJSON(const mapbox::geojson::geojson& geoJSON) {
     impl->setGeoJSON(geoJSON);
 }
 
+void GeoJSONSource::updateFeatures(const FeatureCollection& features,
+                                   const std::vector<FeatureIdentifier>& removed) {
+    impl->updateFeatures(features, removed);
+}
+
+void GeoJSONSource::setFeature(const Feature& feature) {
+    impl->updateFeatures({ feature }, {});
+}
+
+void GeoJSONSource::removeFeature(const FeatureIdentifier& id) {
+    impl->updateFeatures({}, { id });
+}
+
 optional<std::string> GeoJSONSource::getURL() const {
     return impl->getURL();
 }
 
+void GeoJSONSource::setProgressCallback(std::function<void (double)> callback) {
+    impl->setProgressCallback(std::move(callback));
+}
+
 } // namespace style
 } // namespace mbgl
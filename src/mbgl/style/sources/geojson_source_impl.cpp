@@ -1,10 +1,13 @@
-#include <mbgl/util/logging.hpp>
+#include <mbgl/actor/mailbox.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/style/conversion/geojson.hpp>
 #include <mbgl/style/source_observer.hpp>
 #include <mbgl/style/sources/geojson_source_impl.hpp>
+#include <mbgl/style/sources/cluster_index.hpp>
 #include <mbgl/tile/geojson_tile.hpp>
 #include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/run_loop.hpp>
 
 #include <mapbox/geojson.hpp>
 #include <mapbox/geojson/rapidjson.hpp>
@@ -12,9 +15,9 @@
 #include <mapbox/geojsonvt/convert.hpp>
 #include <supercluster.hpp>
 
-#include <rapidjson/error/en.h>
-
-#include <sstream>
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
 
 namespace mbgl {
 namespace style {
@@ -39,6 +42,9 @@ GeoJSONSource::Impl::~Impl() = default;
 
 void GeoJSONSource::Impl::setURL(std::string url_) {
     url = std::move(url_);
+    features.reset();
+    fetched = false;
+    copied = false;
 
     // Signal that the source description needs a reload
     if (loaded || req) {
@@ -52,49 +58,190 @@ optional<std::string> GeoJSONSource::Impl::getURL() const {
     return url;
 }
 
-
 void GeoJSONSource::Impl::setGeoJSON(const GeoJSON& geoJSON) {
     req.reset();
-    _setGeoJSON(geoJSON);
+    dispatch([geoJSON] (Actor<GeoJSONSourceWorker>& worker_) {
+        worker_.invoke(&GeoJSONSourceWorker::setGeoJSON, geoJSON);
+    });
 }
 
-// Private implementation
-void GeoJSONSource::Impl::_setGeoJSON(const GeoJSON& geoJSON) {
-    double scale = util::EXTENT / util::tileSize;
+void GeoJSONSource::Impl::updateFeatures(const FeatureCollection& changed, const std::vector<FeatureIdentifier>& removed) {
+    for (const auto& feature : changed) {
+        if (!feature.id) {
+            throw std::invalid_argument("GeoJSON features must have an ID to be updated");
+        }
+    }
+
+    dispatch([changed, removed] (Actor<GeoJSONSourceWorker>& worker_) {
+        worker_.invoke(&GeoJSONSourceWorker::updateFeatures, changed, removed);
+    });
+}
 
-    cache.clear();
+void GeoJSONSource::Impl::setProgressCallback(std::function<void (double)> callback) {
+    progressCallback = std::move(callback);
+}
 
-    if (options.cluster
-        && geoJSON.is<mapbox::geometry::feature_collection<double>>()
-        && !geoJSON.get<mapbox::geometry::feature_collection<double>>().empty()) {
-        mapbox::supercluster::Options clusterOptions;
-        clusterOptions.maxZoom = options.clusterMaxZoom;
-        clusterOptions.extent = util::EXTENT;
-        clusterOptions.radius = std::round(scale * options.clusterRadius);
-
-        const auto& features = geoJSON.get<mapbox::geometry::feature_collection<double>>();
-        geoJSONOrSupercluster =
-            std::make_unique<mapbox::supercluster::Supercluster>(features, clusterOptions);
+void GeoJSONSource::Impl::dispatch(Job job) {
+    pendingJobs.push_back(job);
+    if (worker) {
+        job(*worker);
     } else {
-        mapbox::geojsonvt::Options vtOptions;
-        vtOptions.maxZoom = options.maxzoom;
-        vtOptions.extent = util::EXTENT;
-        vtOptions.buffer = std::round(scale * options.buffer);
-        vtOptions.tolerance = scale * options.tolerance;
-        geoJSONOrSupercluster = std::make_unique<mapbox::geojsonvt::GeoJSONVT>(geoJSON, vtOptions);
+        queuedJobs.push_back(std::move(job));
+    }
+}
+
+void GeoJSONSource::Impl::setWorkerScheduler(Scheduler& scheduler_) {
+    if (worker) {
+        return;
+    }
+
+    scheduler = &scheduler_;
+    mailbox = std::make_shared<Mailbox>(*util::RunLoop::Get());
+    worker = std::make_unique<Actor<GeoJSONSourceWorker>>(
+        scheduler_, ActorRef<GeoJSONSource::Impl>(*this, mailbox), options);
+
+    for (auto& job : queuedJobs) {
+        job(*worker);
+    }
+    queuedJobs.clear();
+}
+
+namespace {
+
+// Whether the tile, or the buffer around it that its features extend into, intersects the extent,
+// in any of the world's copies that the tiles wrap features into.
+bool intersects(const CanonicalTileID& tileID, const mapbox::geometry::box<double>& bounds, double buffer) {
+    const double tiles = 1u << tileID.z;
+    const double minY = (tileID.y - buffer) / tiles;
+    const double maxY = (tileID.y + 1 + buffer) / tiles;
+    if (bounds.max.y < minY || bounds.min.y > maxY) {
+        return false;
+    }
+
+    for (const double shift : { -1.0, 0.0, 1.0 }) {
+        const double minX = (tileID.x - buffer) / tiles + shift;
+        const double maxX = (tileID.x + 1 + buffer) / tiles + shift;
+        if (bounds.max.x >= minX && bounds.min.x <= maxX) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+void GeoJSONSource::Impl::onUpdate(GeoJSONSourceUpdate update) {
+    assert(pendingJobs.size() >= update.jobs);
+    pendingJobs.erase(pendingJobs.begin(), pendingJobs.begin() + update.jobs);
+
+    if (!update.index) {
+        return;
+    }
+    geoJSONOrSupercluster = std::move(*update.index);
+    features = std::move(update.features);
+
+    requestedClusterLevels.clear();
+    if (geoJSONOrSupercluster.is<ClusterIndexPointer>() &&
+        options.clusterLevels == GeoJSONOptions::ClusterLevels::Parallel) {
+        for (uint8_t level = 0; level < geoJSONOrSupercluster.get<ClusterIndexPointer>()->levelCount(); level++) {
+            buildClusterLevel(level);
+        }
+    }
+
+    if (!loaded) {
+        loaded = true;
+        observer->onSourceLoaded(base);
+        return;
+    }
+
+    // Clusters merge points from anywhere in the tiles at lower zoom levels.
+    const bool clustered = !geoJSONOrSupercluster.is<GeoJSONVTPointer>();
+    const double buffer = double(options.buffer) / util::tileSize;
+    for (auto const &item : tiles) {
+        GeoJSONTile* geoJSONTile = static_cast<GeoJSONTile*>(item.second.get());
+        const bool affected = clustered || !update.changedBounds ||
+            std::any_of(update.changedBounds->begin(), update.changedBounds->end(), [&] (const auto& bounds) {
+                return intersects(geoJSONTile->id.canonical, bounds, buffer);
+            });
+        if (affected) {
+            setTileData(*geoJSONTile, geoJSONTile->id);
+        }
+    }
+
+    // The cache can't tell which of its tiles the changes touch.
+    cache.clear();
+    observer->onSourceChanged(base);
+}
+
+void GeoJSONSource::Impl::onError(std::exception_ptr error) {
+    assert(!pendingJobs.empty());
+    pendingJobs.pop_front();
+    observer->onSourceError(base, error);
+}
+
+void GeoJSONSource::Impl::onProgress(double progress) {
+    if (progressCallback) {
+        progressCallback(progress);
+    }
+}
+
+void GeoJSONSource::Impl::buildClusterLevel(uint8_t level) {
+    assert(scheduler);
+    if (!requestedClusterLevels.insert(level).second) {
+        return;
+    }
+
+    auto& builder = clusterLevelBuilders[level];
+    if (!builder) {
+        builder = std::make_unique<Actor<ClusterLevelBuilder>>(
+            *scheduler, ActorRef<GeoJSONSource::Impl>(*this, mailbox));
+    }
+    builder->invoke(&ClusterLevelBuilder::build, geoJSONOrSupercluster.get<ClusterIndexPointer>(), level);
+}
+
+void GeoJSONSource::Impl::onClusterLevel(ClusterIndexPointer clusterIndex, uint8_t level) {
+    if (!geoJSONOrSupercluster.is<ClusterIndexPointer>() ||
+        geoJSONOrSupercluster.get<ClusterIndexPointer>() != clusterIndex) {
+        // The features were indexed again meanwhile.
+        return;
     }
 
     for (auto const &item : tiles) {
         GeoJSONTile* geoJSONTile = static_cast<GeoJSONTile*>(item.second.get());
-        setTileData(*geoJSONTile, geoJSONTile->id);
+        if (clusterIndex->levelOf(geoJSONTile->id.canonical.z) == level) {
+            setTileData(*geoJSONTile, geoJSONTile->id);
+        }
     }
+
+    // Tiles of the level may have been cached before they got their data.
+    cache.clear([&] (const OverscaledTileID& tileID) {
+        return clusterIndex->levelOf(tileID.canonical.z) == level;
+    });
+    observer->onSourceChanged(base);
 }
 
 void GeoJSONSource::Impl::setTileData(GeoJSONTile& tile, const OverscaledTileID& tileID) {
     if (geoJSONOrSupercluster.is<GeoJSONVTPointer>()) {
-        tile.updateData(geoJSONOrSupercluster.get<GeoJSONVTPointer>()->getTile(tileID.canonical.z,
-                                                                               tileID.canonical.x,
-                                                                               tileID.canonical.y).features);
+        const auto& geoJSONVT = geoJSONOrSupercluster.get<GeoJSONVTPointer>();
+        if (!geoJSONVT) {
+            // Sources without data have no index.
+            tile.updateData({});
+            return;
+        }
+        tile.updateData(geoJSONVT->getTile(tileID.canonical.z,
+                                           tileID.canonical.x,
+                                           tileID.canonical.y).features);
+    } else if (geoJSONOrSupercluster.is<ClusterIndexPointer>()) {
+        const auto& clusterIndex = geoJSONOrSupercluster.get<ClusterIndexPointer>();
+        const uint8_t level = clusterIndex->levelOf(tileID.canonical.z);
+        if (!clusterIndex->isBuilt(level)) {
+            // The tile keeps its data, if any, until onClusterLevel() sets it.
+            buildClusterLevel(level);
+            return;
+        }
+        tile.updateData(clusterIndex->getTile(tileID.canonical.z,
+                                              tileID.canonical.x,
+                                              tileID.canonical.y));
     } else {
         assert(geoJSONOrSupercluster.is<SuperclusterPointer>());
         tile.updateData(geoJSONOrSupercluster.get<SuperclusterPointer>()->getTile(tileID.canonical.z,
@@ -104,8 +251,11 @@ void GeoJSONSource::Impl::setTileData(GeoJSONTile& tile, const OverscaledTileID&
 }
 
 void GeoJSONSource::Impl::loadDescription(FileSource& fileSource) {
-    if (!url) {
-        loaded = true;
+    if (!url || copied) {
+        // Data that is set directly is loaded once the worker has indexed it.
+        if (pendingJobs.empty()) {
+            loaded = true;
+        }
         return;
     }
 
@@ -123,38 +273,35 @@ void GeoJSONSource::Impl::loadDescription(FileSource& fileSource) {
             observer->onSourceError(
                 base, std::make_exception_ptr(std::runtime_error("unexpectedly empty GeoJSON")));
         } else {
-            rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> d;
-            d.Parse<0>(res.data->c_str());
-
-            if (d.HasParseError()) {
-                std::stringstream message;
-                message << d.GetErrorOffset() << " - "
-                        << rapidjson::GetParseError_En(d.GetParseError());
-                observer->onSourceError(base,
-                                        std::make_exception_ptr(std::runtime_error(message.str())));
-                return;
-            }
-
-            invalidateTiles();
-
-            conversion::Error error;
-            optional<GeoJSON> geoJSON = conversion::convertGeoJSON<JSValue>(d, error);
-            if (!geoJSON) {
-                Log::Error(Event::ParseStyle, "Failed to parse GeoJSON data: %s",
-                           error.message.c_str());
-                // Create an empty GeoJSON VT object to make sure we're not infinitely waiting for
-                // tiles to load.
-                _setGeoJSON(GeoJSON{ FeatureCollection{} });
-            } else {
-                _setGeoJSON(*geoJSON);
-            }
-
-            loaded = true;
-            observer->onSourceLoaded(base);
+            fetched = true;
+            std::shared_ptr<const Buffer> data = res.data;
+            dispatch([data] (Actor<GeoJSONSourceWorker>& worker_) {
+                worker_.invoke(&GeoJSONSourceWorker::parse, data);
+            });
         }
     });
 }
 
+std::unique_ptr<Source> GeoJSONSource::Impl::clone(const std::string& id_) const {
+    auto source = std::make_unique<GeoJSONSource>(id_, options);
+    Impl& copy = *source->impl;
+    copy.url = url;
+    copy.copied = url && (features || fetched);
+
+    // The copy indexes the same features rather than fetching and parsing them again, and then
+    // makes the changes that this source's worker hasn't made yet.
+    if (features) {
+        copy.features = features;
+        copy.dispatch([features_ = features] (Actor<GeoJSONSourceWorker>& worker_) {
+            worker_.invoke(&GeoJSONSourceWorker::setFeatures, features_);
+        });
+    }
+    for (const auto& job : pendingJobs) {
+        copy.dispatch(job);
+    }
+    return std::move(source);
+}
+
 optional<Range<uint8_t>> GeoJSONSource::Impl::getZoomRange() const {
     if (loaded) {
         return { { 0, options.maxzoom }};
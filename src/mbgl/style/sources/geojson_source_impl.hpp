@@ -1,13 +1,22 @@
 #pragma once
 
+#include <mbgl/actor/actor.hpp>
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/sources/geojson_source.hpp>
-#include <mbgl/util/variant.hpp>
+#include <mbgl/style/sources/geojson_source_worker.hpp>
 #include <mbgl/tile/geojson_tile.hpp>
 
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
+
 namespace mbgl {
 
 class AsyncRequest;
+class Mailbox;
 
 namespace style {
 
@@ -20,9 +29,18 @@ public:
     optional<std::string> getURL() const;
 
     void setGeoJSON(const GeoJSON&);
+    void updateFeatures(const FeatureCollection&, const std::vector<FeatureIdentifier>& removed);
     void setTileData(GeoJSONTile&, const OverscaledTileID& tileID);
+    void setProgressCallback(std::function<void (double)>);
+
+    // Messages from the worker.
+    void onUpdate(GeoJSONSourceUpdate);
+    void onError(std::exception_ptr);
+    void onProgress(double);
+    void onClusterLevel(ClusterIndexPointer, uint8_t level);
 
     void loadDescription(FileSource&) final;
+    std::unique_ptr<Source> clone(const std::string& id) const final;
 
     uint16_t getTileSize() const final {
         return util::tileSize;
@@ -31,14 +49,42 @@ public:
     optional<Range<uint8_t>> getZoomRange() const final;
 
 private:
-    void _setGeoJSON(const GeoJSON&);
+    using Job = std::function<void (Actor<GeoJSONSourceWorker>&)>;
+
+    // Sends the job to the worker, or queues it until the worker is started.
+    void dispatch(Job);
+    // Has the level of the ClusterIndex built, unless it is or is being built already.
+    void buildClusterLevel(uint8_t level);
 
+    void setWorkerScheduler(Scheduler&) final;
     std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) final;
 
     GeoJSONOptions options;
     optional<std::string> url;
     std::unique_ptr<AsyncRequest> req;
-    variant<GeoJSONVTPointer, SuperclusterPointer> geoJSONOrSupercluster;
+    // Whether the data of the URL arrived, and whether it was rather passed on by the source
+    // that this one is a copy of, so that this one doesn't fetch it again.
+    bool fetched = false;
+    bool copied = false;
+    // Empty until the worker has indexed the features for the first time.
+    GeoJSONIndex geoJSONOrSupercluster;
+    // The features that the index was built from, which copies of the source start out with.
+    std::shared_ptr<const FeatureCollection> features;
+    std::function<void (double)> progressCallback;
+
+    // The worker is started once the source learns of the scheduler that its tiles use.
+    std::shared_ptr<Mailbox> mailbox;
+    std::unique_ptr<Actor<GeoJSONSourceWorker>> worker;
+    std::vector<Job> queuedJobs;
+    // The jobs that the worker hasn't replied to yet, oldest first, which copies of the source
+    // replay on top of the features that were indexed last.
+    std::deque<Job> pendingJobs;
+
+    // The builders of the levels of the ClusterIndex, by level, and the levels of the current
+    // index that they were asked to build.
+    Scheduler* scheduler = nullptr;
+    std::map<uint8_t, std::unique_ptr<Actor<ClusterLevelBuilder>>> clusterLevelBuilders;
+    std::set<uint8_t> requestedClusterLevels;
 };
 
 } // namespace style
@@ -0,0 +1,245 @@
+#include <mbgl/style/sources/geojson_source_worker.hpp>
+#include <mbgl/style/sources/geojson_source_impl.hpp>
+#include <mbgl/style/sources/cluster_index.hpp>
+#include <mbgl/style/sources/geojson_parser.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/projection.hpp>
+#include <mbgl/math/clamp.hpp>
+
+#include <mapbox/geojsonvt.hpp>
+#include <mapbox/geometry/envelope.hpp>
+#include <supercluster.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+// Returns the extent of the feature in world coordinates, which range from 0 to 1 across the
+// world's first copy, or nothing for empty geometries.
+optional<mapbox::geometry::box<double>> worldBounds(const Feature& feature) {
+    const auto box = mapbox::geometry::envelope(feature.geometry);
+    if (box.min.x > box.max.x || box.min.y > box.max.y) {
+        return {};
+    }
+
+    auto project = [] (double lng, double lat) {
+        return Projection::project({ util::clamp(lat, -util::LATITUDE_MAX, util::LATITUDE_MAX), lng }, 1) / double(util::tileSize);
+    };
+    // Latitudes increase to the north, world coordinates to the south.
+    return mapbox::geometry::box<double> { project(box.min.x, box.max.y), project(box.max.x, box.min.y) };
+}
+
+} // namespace
+
+GeoJSONSourceWorker::GeoJSONSourceWorker(ActorRef<GeoJSONSourceWorker> self_,
+                                         ActorRef<GeoJSONSource::Impl> parent_,
+                                         GeoJSONOptions options_)
+    : self(std::move(self_)),
+      parent(std::move(parent_)),
+      options(std::move(options_)) {
+}
+
+GeoJSONSourceWorker::~GeoJSONSourceWorker() = default;
+
+void GeoJSONSourceWorker::setGeoJSON(GeoJSON geoJSON) {
+    features = std::make_shared<FeatureCollection>(geoJSON.match(
+        [] (mapbox::geometry::geometry<double>& geometry) {
+            return FeatureCollection { Feature { std::move(geometry) } };
+        },
+        [] (Feature& feature) {
+            return FeatureCollection { std::move(feature) };
+        },
+        [] (FeatureCollection& collection) {
+            return std::move(collection);
+        }));
+
+    indexPositions();
+    invalidate({});
+}
+
+void GeoJSONSourceWorker::setFeatures(std::shared_ptr<const FeatureCollection> features_) {
+    // Collections are only ever made by workers, which copy shared ones before changing them.
+    features = std::const_pointer_cast<FeatureCollection>(std::move(features_));
+
+    indexPositions();
+    invalidate({});
+}
+
+void GeoJSONSourceWorker::indexPositions() {
+    featurePositions.clear();
+    for (std::size_t i = 0; i < features->size(); i++) {
+        if ((*features)[i].id) {
+            featurePositions[*(*features)[i].id] = i;
+        }
+    }
+}
+
+void GeoJSONSourceWorker::parse(std::shared_ptr<const Buffer> data) {
+    GeoJSON geoJSON;
+    try {
+        geoJSON = parseGeoJSON(*data, [&] (double progress) {
+            parent.invokeLatest(&GeoJSONSource::Impl::onProgress, progress);
+        });
+    } catch (const GeoJSONSyntaxError&) {
+        parent.invoke(&GeoJSONSource::Impl::onError, std::current_exception());
+        return;
+    } catch (const std::exception& ex) {
+        Log::Error(Event::ParseStyle, "Failed to parse GeoJSON data: %s", ex.what());
+        // Create an empty GeoJSON VT object to make sure we're not infinitely waiting for
+        // tiles to load.
+        geoJSON = FeatureCollection {};
+    }
+
+    setGeoJSON(std::move(geoJSON));
+}
+
+void GeoJSONSourceWorker::updateFeatures(FeatureCollection changed, std::vector<FeatureIdentifier> removed) {
+    // The extents of the features before and after the changes.
+    std::vector<mapbox::geometry::box<double>> extents;
+    auto addBounds = [&] (const Feature& feature) {
+        if (auto bounds = worldBounds(feature)) {
+            extents.push_back(*bounds);
+        }
+    };
+
+    // The source, or a copy of it, may still hold the features that were indexed last. Once the
+    // worker is the only owner, no one else can get them back, so they can be changed in place
+    // after the fence orders this after whatever the last of the other owners read.
+    if (features.use_count() > 1) {
+        features = std::make_shared<FeatureCollection>(*features);
+    } else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    FeatureCollection& collection = *features;
+
+    if (!removed.empty()) {
+        std::vector<bool> erased(collection.size(), false);
+        for (const auto& id : removed) {
+            auto it = featurePositions.find(id);
+            if (it != featurePositions.end()) {
+                erased[it->second] = true;
+                addBounds(collection[it->second]);
+                featurePositions.erase(it);
+            }
+        }
+
+        std::size_t position = 0;
+        for (std::size_t i = 0; i < collection.size(); i++) {
+            if (erased[i]) {
+                continue;
+            }
+            if (i != position) {
+                collection[position] = std::move(collection[i]);
+            }
+            if (collection[position].id) {
+                auto it = featurePositions.find(*collection[position].id);
+                if (it != featurePositions.end() && it->second == i) {
+                    it->second = position;
+                }
+            }
+            position++;
+        }
+        collection.resize(position);
+    }
+
+    for (auto& feature : changed) {
+        addBounds(feature);
+        auto it = featurePositions.find(*feature.id);
+        if (it != featurePositions.end()) {
+            addBounds(collection[it->second]);
+            collection[it->second] = std::move(feature);
+        } else {
+            featurePositions.emplace(*feature.id, collection.size());
+            collection.push_back(std::move(feature));
+        }
+    }
+
+    invalidate(std::move(extents));
+}
+
+void GeoJSONSourceWorker::invalidate(optional<std::vector<mapbox::geometry::box<double>>> bounds) {
+    unindexedJobs++;
+    if (bounds) {
+        changedBounds.insert(changedBounds.end(), bounds->begin(), bounds->end());
+    } else {
+        allChanged = true;
+    }
+
+    // Supersedes the rebuild that an earlier job scheduled, if it hasn't run yet.
+    self.invokeLatest(&GeoJSONSourceWorker::index);
+}
+
+void GeoJSONSourceWorker::index() {
+    GeoJSONSourceUpdate update;
+    update.jobs = unindexedJobs;
+    unindexedJobs = 0;
+
+    if (!allChanged && changedBounds.empty()) {
+        // The jobs changed nothing that the index holds.
+        parent.invoke(&GeoJSONSource::Impl::onUpdate, std::move(update));
+        return;
+    }
+
+    if (!allChanged) {
+        update.changedBounds = std::move(changedBounds);
+    }
+    allChanged = false;
+    changedBounds.clear();
+
+    double scale = util::EXTENT / util::tileSize;
+
+    // Only points are clustered.
+    const bool clusterable = !features->empty() &&
+        std::all_of(features->begin(), features->end(), [] (const Feature& feature) {
+            return feature.geometry.is<mapbox::geometry::point<double>>();
+        });
+
+    if (options.cluster && clusterable && options.clusterLevels != GeoJSONOptions::ClusterLevels::Hierarchical) {
+        // The source has the levels built once it has the index.
+        ClusterIndex::Options clusterOptions;
+        clusterOptions.maxZoom = options.clusterMaxZoom;
+        clusterOptions.extent = util::EXTENT;
+        clusterOptions.radius = std::round(scale * options.clusterRadius);
+
+        update.index = GeoJSONIndex {
+            std::make_shared<ClusterIndex>(features, clusterOptions) };
+    } else if (options.cluster && clusterable) {
+        mapbox::supercluster::Options clusterOptions;
+        clusterOptions.maxZoom = options.clusterMaxZoom;
+        clusterOptions.extent = util::EXTENT;
+        clusterOptions.radius = std::round(scale * options.clusterRadius);
+
+        update.index = GeoJSONIndex {
+            std::make_unique<mapbox::supercluster::Supercluster>(*features, clusterOptions) };
+    } else {
+        mapbox::geojsonvt::Options vtOptions;
+        vtOptions.maxZoom = options.maxzoom;
+        vtOptions.extent = util::EXTENT;
+        vtOptions.buffer = std::round(scale * options.buffer);
+        vtOptions.tolerance = scale * options.tolerance;
+        update.index = GeoJSONIndex {
+            std::make_unique<mapbox::geojsonvt::GeoJSONVT>(*features, vtOptions) };
+    }
+
+    update.features = features;
+    parent.invoke(&GeoJSONSource::Impl::onUpdate, std::move(update));
+}
+
+ClusterLevelBuilder::ClusterLevelBuilder(ActorRef<ClusterLevelBuilder>,
+                                         ActorRef<GeoJSONSource::Impl> parent_)
+    : parent(std::move(parent_)) {
+}
+
+void ClusterLevelBuilder::build(ClusterIndexPointer clusterIndex, uint8_t level) {
+    clusterIndex->buildLevel(level);
+    parent.invoke(&GeoJSONSource::Impl::onClusterLevel, std::move(clusterIndex), level);
+}
+
+} // namespace style
+} // namespace mbgl
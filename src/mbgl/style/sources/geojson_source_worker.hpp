@@ -0,0 +1,91 @@
+#pragma once
+
+#include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/variant.hpp>
+
+#include <mapbox/geometry/box.hpp>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace mbgl {
+
+class Buffer;
+
+namespace style {
+
+class ClusterIndex;
+
+// Shared with the builders of its levels.
+using ClusterIndexPointer = std::shared_ptr<ClusterIndex>;
+using GeoJSONIndex = variant<GeoJSONVTPointer, SuperclusterPointer, ClusterIndexPointer>;
+
+// What the jobs of the worker changed: the new index of the source's features, if any of them
+// changed, and the world extents of the changes, or none if all of the features may have.
+class GeoJSONSourceUpdate {
+public:
+    optional<GeoJSONIndex> index;
+    optional<std::vector<mapbox::geometry::box<double>>> changedBounds;
+    // The features that the index was built from, which the worker copies before changing them
+    // again if the source still holds them.
+    std::shared_ptr<const FeatureCollection> features;
+    // The number of jobs that the update covers.
+    std::size_t jobs = 0;
+};
+
+// Parses and indexes the data of a GeoJSON source on the worker threads, and replies to its jobs
+// with GeoJSONSourceUpdates, or with an error. Keeps the source's features, so that the index can
+// be rebuilt when some of them change. Rebuilding waits for the jobs that are already queued, so
+// that a burst of changes rebuilds the index, which can take seconds for clustered sources, once.
+class GeoJSONSourceWorker {
+public:
+    GeoJSONSourceWorker(ActorRef<GeoJSONSourceWorker>,
+                        ActorRef<GeoJSONSource::Impl>,
+                        GeoJSONOptions);
+    ~GeoJSONSourceWorker();
+
+    void setGeoJSON(GeoJSON);
+    void parse(std::shared_ptr<const Buffer>);
+    void updateFeatures(FeatureCollection changed, std::vector<FeatureIdentifier> removed);
+    // Takes the features of another source, such as the one that a style snapshot was made of.
+    void setFeatures(std::shared_ptr<const FeatureCollection>);
+
+private:
+    // Schedules rebuilding the index after the queued jobs.
+    void invalidate(optional<std::vector<mapbox::geometry::box<double>>> changedBounds);
+    void index();
+    void indexPositions();
+
+    ActorRef<GeoJSONSourceWorker> self;
+    ActorRef<GeoJSONSource::Impl> parent;
+    const GeoJSONOptions options;
+
+    // The changes that the index doesn't reflect yet.
+    std::size_t unindexedJobs = 0;
+    bool allChanged = false;
+    std::vector<mapbox::geometry::box<double>> changedBounds;
+
+    // The features that the index was built from, in their original order, and the positions
+    // of those with IDs. The features are shared with the source once they are indexed.
+    std::shared_ptr<FeatureCollection> features = std::make_shared<FeatureCollection>();
+    std::map<FeatureIdentifier, std::size_t> featurePositions;
+};
+
+// Builds levels of the source's ClusterIndex on the worker threads, and replies with their
+// index and level once they are built. Each builder builds one level at a time; the source
+// uses one for each level, so that the levels are built concurrently.
+class ClusterLevelBuilder {
+public:
+    ClusterLevelBuilder(ActorRef<ClusterLevelBuilder>, ActorRef<GeoJSONSource::Impl>);
+
+    void build(ClusterIndexPointer, uint8_t level);
+
+private:
+    ActorRef<GeoJSONSource::Impl> parent;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,22 @@
+#include <mbgl/style/sources/raster_dem_source.hpp>
+#include <mbgl/style/sources/raster_dem_source_impl.hpp>
+
+namespace mbgl {
+namespace style {
+
+RasterDEMSource::RasterDEMSource(std::string id, variant<std::string, Tileset> urlOrTileset, uint16_t tileSize)
+    : Source(SourceType::RasterDEM, std::make_unique<RasterDEMSource::Impl>(std::move(id), *this, std::move(urlOrTileset), tileSize)),
+      impl(static_cast<Impl*>(baseImpl.get())) {
+}
+
+optional<std::string> RasterDEMSource::getURL() const {
+    auto urlOrTileset = impl->getURLOrTileset();
+    if (urlOrTileset.is<std::string>()) {
+        return urlOrTileset.get<std::string>();
+    } else {
+        return {};
+    }
+}
+
+} // namespace style
+} // namespace mbgl
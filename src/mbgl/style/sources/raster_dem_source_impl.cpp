@@ -0,0 +1,50 @@
+#include <mbgl/style/sources/raster_dem_source_impl.hpp>
+#include <mbgl/tile/raster_dem_tile.hpp>
+
+namespace mbgl {
+namespace style {
+
+RasterDEMSource::Impl::Impl(std::string id_, Source& base_,
+                            variant<std::string, Tileset> urlOrTileset_,
+                            uint16_t tileSize_)
+    : TileSourceImpl(SourceType::RasterDEM, std::move(id_), base_, std::move(urlOrTileset_), tileSize_) {
+}
+
+std::unique_ptr<Source> RasterDEMSource::Impl::clone(const std::string& id_) const {
+    auto source = std::make_unique<RasterDEMSource>(id_, urlOrTileset, tileSize);
+    source->impl->copyDescription(*this);
+    return std::move(source);
+}
+
+std::unique_ptr<Tile> RasterDEMSource::Impl::createTile(const OverscaledTileID& tileID,
+                                                        const UpdateParameters& parameters) {
+    return std::make_unique<RasterDEMTile>(tileID, parameters, tileset);
+}
+
+void RasterDEMSource::Impl::updateTileNeighbours(Tile& tile) {
+    auto& demTile = static_cast<RasterDEMTile&>(tile);
+    const CanonicalTileID& canonical = tile.id.canonical;
+    const int64_t dim = int64_t(1) << canonical.z;
+
+    for (int8_t dy = -1; dy <= 1; dy++) {
+        for (int8_t dx = -1; dx <= 1; dx++) {
+            const int64_t y = int64_t(canonical.y) + dy;
+            if ((dx == 0 && dy == 0) || y < 0 || y >= dim) {
+                continue;
+            }
+            // The world repeats horizontally, so the tiles at its edges are next to each other.
+            const int64_t x = (int64_t(canonical.x) + dx + dim) % dim;
+
+            auto it = tiles.find(OverscaledTileID(tile.id.overscaledZ, canonical.z, uint32_t(x), uint32_t(y)));
+            if (it == tiles.end()) {
+                continue;
+            }
+            auto& neighbour = static_cast<RasterDEMTile&>(*it->second);
+            demTile.backfillBorder(neighbour, dx, dy);
+            neighbour.backfillBorder(demTile, -dx, -dy);
+        }
+    }
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <mbgl/style/sources/raster_dem_source.hpp>
+#include <mbgl/style/tile_source_impl.hpp>
+
+namespace mbgl {
+namespace style {
+
+class RasterDEMSource::Impl : public TileSourceImpl {
+public:
+    Impl(std::string id, Source&, variant<std::string, Tileset>, uint16_t tileSize);
+
+    std::unique_ptr<Source> clone(const std::string& id) const final;
+
+private:
+    std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) final;
+
+    // Fills the borders of a tile that loaded and of the loaded tiles around it from each other.
+    void updateTileNeighbours(Tile&) final;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -10,6 +10,12 @@ RasterSource::Impl::Impl(std::string id_, Source& base_,
     : TileSourceImpl(SourceType::Raster, std::move(id_), base_, std::move(urlOrTileset_), tileSize_) {
 }
 
+std::unique_ptr<Source> RasterSource::Impl::clone(const std::string& id_) const {
+    auto source = std::make_unique<RasterSource>(id_, urlOrTileset, tileSize);
+    source->impl->copyDescription(*this);
+    return std::move(source);
+}
+
 std::unique_ptr<Tile> RasterSource::Impl::createTile(const OverscaledTileID& tileID,
                                                const UpdateParameters& parameters) {
     return std::make_unique<RasterTile>(tileID, parameters, tileset);
@@ -10,6 +10,8 @@ class RasterSource::Impl : public TileSourceImpl {
 public:
     Impl(std::string id, Source&, variant<std::string, Tileset>, uint16_t tileSize);
 
+    std::unique_ptr<Source> clone(const std::string& id) const final;
+
 private:
     std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) final;
 };
@@ -1,5 +1,4 @@
 #include <mbgl/style/sources/vector_source_impl.hpp>
-#include <mbgl/tile/vector_tile.hpp>
 
 namespace mbgl {
 namespace style {
@@ -8,9 +7,15 @@ VectorSource::Impl::Impl(std::string id_, Source& base_, variant<std::string, Ti
     : TileSourceImpl(SourceType::Vector, std::move(id_), base_, std::move(urlOrTileset_), util::tileSize) {
 }
 
+std::unique_ptr<Source> VectorSource::Impl::clone(const std::string& id_) const {
+    auto source = std::make_unique<VectorSource>(id_, urlOrTileset);
+    source->impl->copyDescription(*this);
+    return std::move(source);
+}
+
 std::unique_ptr<Tile> VectorSource::Impl::createTile(const OverscaledTileID& tileID,
                                                      const UpdateParameters& parameters) {
-    return std::make_unique<VectorTile>(tileID, base.getID(), parameters, tileset);
+    return std::make_unique<VectorTile>(tileID, base.getID(), parameters, tileset, dataCache);
 }
 
 } // namespace style
@@ -2,6 +2,7 @@
 
 #include <mbgl/style/sources/vector_source.hpp>
 #include <mbgl/style/tile_source_impl.hpp>
+#include <mbgl/tile/vector_tile.hpp>
 
 namespace mbgl {
 namespace style {
@@ -10,8 +11,12 @@ class VectorSource::Impl : public TileSourceImpl {
 public:
     Impl(std::string id, Source&, variant<std::string, Tileset>);
 
+    std::unique_ptr<Source> clone(const std::string& id) const final;
+
 private:
     std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) final;
+
+    VectorTileDataCache dataCache;
 };
 
 } // namespace style
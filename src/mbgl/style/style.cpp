@@ -1,6 +1,8 @@
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/observer.hpp>
 #include <mbgl/style/source_impl.hpp>
+#include <mbgl/style/tile_source_impl.hpp>
+#include <mbgl/style/group_by_layout.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/style/layers/custom_layer.hpp>
@@ -11,9 +13,12 @@
 #include <mbgl/style/layers/fill_extrusion_layer.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/heatmap_layer.hpp>
+#include <mbgl/style/layers/hillshade_layer.hpp>
 #include <mbgl/style/layers/raster_layer.hpp>
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/parser.hpp>
+#include <mbgl/style/style_snapshot.hpp>
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/style/class_dictionary.hpp>
 #include <mbgl/style/update_parameters.hpp>
@@ -21,6 +26,7 @@
 #include <mbgl/style/property_evaluation_parameters.hpp>
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/text/local_glyph_rasterizer.hpp>
 #include <mbgl/geometry/line_atlas.hpp>
 #include <mbgl/renderer/render_item.hpp>
 #include <mbgl/renderer/render_tile.hpp>
@@ -40,11 +46,15 @@ namespace style {
 
 static Observer nullObserver;
 
-Style::Style(FileSource& fileSource_, float pixelRatio)
+Style::Style(FileSource& fileSource_, float pixelRatio_, const optional<std::string>& localFontFamily_)
     : fileSource(fileSource_),
-      glyphAtlas(std::make_unique<GlyphAtlas>(Size{ 2048, 2048 }, fileSource)),
-      spriteAtlas(std::make_unique<SpriteAtlas>(Size{ 1024, 1024 }, pixelRatio)),
-      lineAtlas(std::make_unique<LineAtlas>(Size{ 256, 512 })),
+      glyphAtlas(std::make_unique<GlyphAtlas>(Size{ 512, 512 }, fileSource,
+                                              std::make_unique<LocalGlyphRasterizer>(localFontFamily_))),
+      spriteAtlas(std::make_unique<SpriteAtlas>(Size{ 1024, 1024 }, pixelRatio_)),
+      lineAtlas(std::make_unique<LineAtlas>(Size{ 256, 64 })),
+      tileCacheBudget(std::make_shared<TileCache::Budget>(util::DEFAULT_TILE_CACHE_BYTES)),
+      pixelRatio(pixelRatio_),
+      localFontFamily(localFontFamily_),
       observer(&nullObserver) {
     glyphAtlas->setObserver(this);
     spriteAtlas->setObserver(this);
@@ -101,14 +111,147 @@ TransitionOptions Style::getTransitionOptions() const {
 }
 
 void Style::setJSON(const std::string& json) {
+    load([&] (Parser& parser, std::function<void ()> onSourcesParsed) {
+        return parser.parse(json, std::move(onSourcesParsed));
+    });
+}
+
+void Style::setBinary(const std::string& binary) {
+    load([&] (Parser& parser, std::function<void ()> onSourcesParsed) {
+        return parser.parseBinary(binary, std::move(onSourcesParsed));
+    });
+}
+
+void Style::setSnapshot(const StyleSnapshot& snapshot) {
+    // Sprite images are only shared between atlases of the same pixel ratio.
+    const bool shareSprites = snapshot.sprites && snapshot.pixelRatio == pixelRatio;
+    load([&] (Parser& parser, std::function<void ()> onSourcesParsed) {
+        snapshot.copyInto(parser);
+        onSourcesParsed();
+        return std::exception_ptr();
+    }, shareSprites ? &*snapshot.sprites : nullptr);
+}
+
+std::shared_ptr<const StyleSnapshot> Style::getSnapshot() const {
+    if (!loaded) {
+        throw std::runtime_error("Can't take a snapshot of a style that isn't loaded");
+    }
+
+    auto snapshot = std::make_shared<StyleSnapshot>();
+
+    std::unordered_set<std::string> annotationSourceIDs;
+    for (const auto& source : sources) {
+        if (source->baseImpl->type == SourceType::Annotations) {
+            annotationSourceIDs.insert(source->getID());
+        } else {
+            snapshot->sources.push_back(source->copy(source->getID()));
+        }
+    }
+
+    for (const auto& layer : layers) {
+        const Layer::Impl& impl = *layer->baseImpl;
+        if (layer->is<CustomLayer>() || annotationSourceIDs.count(impl.source)) {
+            continue;
+        }
+        std::unique_ptr<Layer> copy = impl.clone();
+        copy->baseImpl->setObserver(&copy->baseImpl->nullObserver);
+        if (SymbolLayer* symbolLayer = copy->as<SymbolLayer>()) {
+            // The style that loads the snapshot gives its layers its own atlas.
+            symbolLayer->impl->spriteAtlas = nullptr;
+        }
+        if (!impl.source.empty() && impl.visibility != VisibilityType::None) {
+            snapshot->layerSources.insert(impl.source);
+        }
+        snapshot->layers.push_back(std::move(copy));
+    }
+
+    snapshot->spriteURL = spriteURL.value_or("");
+    snapshot->glyphURL = glyphURL.value_or("");
+    if (spriteAtlas->isLoaded()) {
+        snapshot->sprites = spriteAtlas->getSprites();
+    }
+    snapshot->pixelRatio = pixelRatio;
+
+    snapshot->name = name;
+    snapshot->latLng = defaultLatLng;
+    snapshot->zoom = defaultZoom;
+    snapshot->bearing = defaultBearing;
+    snapshot->pitch = defaultPitch;
+
+    return std::move(snapshot);
+}
+
+// Whether a source of the new style is defined like a source of the previous style, so that it
+// can keep the previous source's tiles. GeoJSON sources are always replaced, as their data
+// could have been changed since the style was loaded.
+static bool isEquivalent(const Source& a, const Source& b) {
+    if (a.getID() != b.getID() || a.baseImpl->type != b.baseImpl->type) {
+        return false;
+    }
+    if (a.baseImpl->type != SourceType::Vector && a.baseImpl->type != SourceType::Raster &&
+        a.baseImpl->type != SourceType::RasterDEM) {
+        return false;
+    }
+    const auto& implA = static_cast<const TileSourceImpl&>(*a.baseImpl);
+    const auto& implB = static_cast<const TileSourceImpl&>(*b.baseImpl);
+    return implA.getTileSize() == implB.getTileSize() && implA.getURLOrTileset() == implB.getURLOrTileset();
+}
+
+void Style::load(const std::function<std::exception_ptr (Parser&, std::function<void ()>)>& parse,
+                 const SpriteAtlas::Sprites* sprites) {
+    std::vector<std::unique_ptr<Source>> previousSources = std::move(sources);
+    std::vector<std::unique_ptr<Layer>> previousLayers = std::move(layers);
     sources.clear();
     layers.clear();
+    invalidateLayerSources();
     classes.clear();
     transitionOptions = {};
     updateBatch = {};
+    previousBucketKeys.clear();
+    loaded = false;
 
     Parser parser;
-    auto error = parser.parse(json);
+    auto error = parse(parser, [&] {
+        // The buckets of the previous tiles refer to the previous sprite and glyphs.
+        if (glyphURL && *glyphURL != parser.glyphURL) {
+            previousSources.clear();
+            glyphAtlas->setObserver(nullptr);
+            glyphAtlas = std::make_unique<GlyphAtlas>(Size{ 512, 512 }, fileSource,
+                                                      std::make_unique<LocalGlyphRasterizer>(localFontFamily));
+            glyphAtlas->setObserver(this);
+        }
+        if (spriteURL && *spriteURL != parser.spriteURL) {
+            previousSources.clear();
+            spriteAtlas->setObserver(nullptr);
+            spriteAtlas = std::make_unique<SpriteAtlas>(Size{ 1024, 1024 }, pixelRatio);
+            spriteAtlas->setObserver(this);
+        }
+
+        // Request the descriptions of the sources that the layers use and the sprite now, rather
+        // than on the first update and once the layers are converted, so that they are all in
+        // flight at once while the layers are converted.
+        for (auto& source : parser.sources) {
+            auto previous = std::find_if(previousSources.begin(), previousSources.end(), [&](const auto& existing) {
+                return existing && isEquivalent(*existing, *source);
+            });
+            if (previous != previousSources.end()) {
+                source = std::move(*previous);
+            }
+            Source& added = *source;
+            addSource(std::move(source));
+            if (parser.layerSources.count(added.getID()) && !added.baseImpl->loaded) {
+                added.baseImpl->loadDescription(fileSource);
+            }
+        }
+        glyphAtlas->setURL(parser.glyphURL);
+        if (sprites && (spriteURL != parser.spriteURL || !spriteAtlas->isLoaded())) {
+            spriteAtlas->load(*sprites);
+        } else if (spriteURL != parser.spriteURL) {
+            spriteAtlas->load(parser.spriteURL, fileSource);
+        }
+        spriteURL = parser.spriteURL;
+        glyphURL = parser.glyphURL;
+    });
 
     if (error) {
         std::string message = "Failed to parse style: " + util::toString(error);
@@ -118,23 +261,50 @@ void Style::setJSON(const std::string& json) {
         return;
     }
 
-    for (auto& source : parser.sources) {
-        addSource(std::move(source));
-    }
-
     for (auto& layer : parser.layers) {
         addLayer(std::move(layer));
     }
 
+    // The tiles that sources kept have buckets for the layers of the previous style, by layer ID.
+    // They are laid out anew for the layers that were added or removed, and once the layers are
+    // evaluated, for the layers whose buckets changed. Where a layer changed its type, the
+    // buckets can't be drawn with it even until then, and the tiles are dropped.
+    std::unordered_set<std::string> invalidSourceIDs;
+    for (const auto& previous : previousLayers) {
+        const std::string& sourceID = previous->baseImpl->source;
+        if (sourceID.empty() || !getSource(sourceID)) {
+            continue;
+        }
+        const Layer* layer = getLayer(previous->getID());
+        if (!layer || layer->baseImpl->source != sourceID) {
+            updateBatch.sourceIDs.insert(sourceID);
+        } else if (layer->type != previous->type) {
+            invalidSourceIDs.insert(sourceID);
+        } else {
+            previousBucketKeys.emplace(layer->getID(), bucketKey(*previous));
+        }
+    }
+    for (const auto& layer : layers) {
+        const auto previous = std::find_if(previousLayers.begin(), previousLayers.end(), [&](const auto& existing) {
+            return existing->getID() == layer->getID();
+        });
+        if (previous == previousLayers.end() || (*previous)->baseImpl->source != layer->baseImpl->source) {
+            if (!layer->baseImpl->source.empty() && getSource(layer->baseImpl->source)) {
+                updateBatch.sourceIDs.insert(layer->baseImpl->source);
+            }
+        }
+    }
+    for (const auto& sourceID : invalidSourceIDs) {
+        getSource(sourceID)->baseImpl->invalidateTiles();
+        updateBatch.sourceIDs.erase(sourceID);
+    }
+
     name = parser.name;
     defaultLatLng = parser.latLng;
     defaultZoom = parser.zoom;
     defaultBearing = parser.bearing;
     defaultPitch = parser.pitch;
 
-    glyphAtlas->setURL(parser.glyphURL);
-    spriteAtlas->load(parser.spriteURL, fileSource);
-
     loaded = true;
 
     observer->onStyleLoaded();
@@ -152,7 +322,9 @@ void Style::addSource(std::unique_ptr<Source> source) {
     }
 
     source->baseImpl->setObserver(this);
+    source->baseImpl->setCacheBudget(tileCacheBudget);
     sources.emplace_back(std::move(source));
+    invalidateLayerSources();
 }
 
 std::unique_ptr<Source> Style::removeSource(const std::string& id) {
@@ -166,9 +338,11 @@ std::unique_ptr<Source> Style::removeSource(const std::string& id) {
 
     auto source = std::move(*it);
     sources.erase(it);
+    invalidateLayerSources();
     updateBatch.sourceIDs.erase(id);
 
     source->baseImpl->detach();
+    source->baseImpl->setCacheBudget(nullptr);
     return source;
 }
 
@@ -224,6 +398,7 @@ Layer* Style::addLayer(std::unique_ptr<Layer> layer, optional<std::string> befor
     }
 
     layer->baseImpl->setObserver(this);
+    invalidateLayerSources();
 
     return layers.emplace(before ? findLayer(*before) : layers.end(), std::move(layer))->get();
 }
@@ -243,9 +418,14 @@ std::unique_ptr<Layer> Style::removeLayer(const std::string& id) {
     }
 
     layers.erase(it);
+    invalidateLayerSources();
     return layer;
 }
 
+void Style::invalidateLayerSources() {
+    layerSourcesChanged = true;
+}
+
 std::string Style::getName() const {
     return name;
 }
@@ -275,6 +455,15 @@ void Style::updateTiles(const UpdateParameters& parameters) {
 }
 
 void Style::relayout() {
+    // The layers that replaced those of a previous style have been evaluated by now.
+    for (const auto& pair : previousBucketKeys) {
+        const Layer* layer = getLayer(pair.first);
+        if (layer && bucketKey(*layer) != pair.second) {
+            updateBatch.sourceIDs.insert(layer->baseImpl->source);
+        }
+    }
+    previousBucketKeys.clear();
+
     for (const auto& sourceID : updateBatch.sourceIDs) {
         Source* source = getSource(sourceID);
         if (source && source->baseImpl->enabled) {
@@ -303,8 +492,12 @@ void Style::cascade(const TimePoint& timePoint, MapMode mode) {
         mode == MapMode::Continuous ? transitionOptions : immediateTransition
     };
 
+    // Paint properties only change along with a cascade, so the results of the functions
+    // that aren't used anymore are dropped here.
+    functionCache.clear();
+
     for (const auto& layer : layers) {
-        layer->baseImpl->cascade(parameters);
+        layer->baseImpl->cascadeProperties(parameters);
     }
 }
 
@@ -317,16 +510,17 @@ void Style::recalculate(float z, const TimePoint& timePoint, MapMode mode) {
 
     zoomHistory.update(z, timePoint);
 
-    const PropertyEvaluationParameters parameters {
+    PropertyEvaluationParameters parameters {
         z,
         mode == MapMode::Continuous ? timePoint : Clock::time_point::max(),
         zoomHistory,
         mode == MapMode::Continuous ? util::DEFAULT_FADE_DURATION : Duration::zero()
     };
+    parameters.functionCache = &functionCache;
 
     hasPendingTransitions = false;
     for (const auto& layer : layers) {
-        hasPendingTransitions |= layer->baseImpl->evaluate(parameters);
+        hasPendingTransitions |= layer->baseImpl->evaluateProperties(parameters);
 
         // Disable this layer if it doesn't need to be rendered.
         const bool needsRendering = layer->baseImpl->needsRendering(zoomHistory.lastZoom);
@@ -402,13 +596,30 @@ bool Style::isLoaded() const {
 RenderData Style::getRenderData(MapDebugOptions debugOptions, float angle) const {
     RenderData result;
 
+    if (layerSourcesChanged) {
+        layerSources.clear();
+        layerSources.reserve(layers.size());
+        for (const auto& layer : layers) {
+            const std::string& sourceID = layer->baseImpl->source;
+            layerSources.push_back(sourceID.empty() ? nullptr : getSource(sourceID));
+        }
+        layerSourcesChanged = false;
+        layerSourcesGeneration++;
+    }
+
     for (const auto& source : sources) {
         if (source->baseImpl->enabled) {
-            result.sources.insert(source.get());
+            result.sources.push_back(source.get());
+        }
+        // The render tiles are kept while they don't change, so the ones that this frame's
+        // layers use are marked again.
+        for (auto& pair : source->baseImpl->getRenderTiles()) {
+            pair.second.used = false;
         }
     }
 
-    for (const auto& layer : layers) {
+    for (std::size_t i = 0; i < layers.size(); i++) {
+        const auto& layer = layers[i];
         if (!layer->baseImpl->needsRendering(zoomHistory.lastZoom)) {
             continue;
         }
@@ -435,7 +646,7 @@ RenderData Style::getRenderData(MapDebugOptions debugOptions, float angle) const
             continue;
         }
 
-        Source* source = getSource(layer->baseImpl->source);
+        Source* source = layerSources[i];
         if (!source) {
             Log::Warning(Event::Render, "can't find source for layer '%s'", layer->baseImpl->id.c_str());
             continue;
@@ -443,6 +654,8 @@ RenderData Style::getRenderData(MapDebugOptions debugOptions, float angle) const
 
         auto& renderTiles = source->baseImpl->getRenderTiles();
         const bool symbolLayer = layer->is<SymbolLayer>();
+        const bool clippedLayer = !symbolLayer && !layer->is<FillExtrusionLayer>() &&
+                                  !layer->is<HeatmapLayer>();
 
         // Sort symbol tiles in opposite y position, so tiles with overlapping
         // symbols are drawn on top of each other, with lower symbols being
@@ -469,10 +682,11 @@ RenderData Style::getRenderData(MapDebugOptions debugOptions, float angle) const
                 continue;
             }
 
-            // We're not clipping symbol layers, so when we have both parents and children of symbol
-            // layers, we drop all children in favor of their parent to avoid duplicate labels.
+            // We're not clipping symbol and fill extrusion layers, so when we have both parents
+            // and children of them, we drop all children in favor of their parent to avoid
+            // duplicate labels and buildings.
             // See https://github.com/mapbox/mapbox-gl-native/issues/2482
-            if (symbolLayer) {
+            if (!clippedLayer) {
                 bool skip = false;
                 // Look back through the buckets we decided to render to find out whether there is
                 // already a bucket from this layer that is a parent of this tile. Tiles are ordered
@@ -488,7 +702,18 @@ RenderData Style::getRenderData(MapDebugOptions debugOptions, float angle) const
                 }
             }
 
-            auto bucket = tile.tile.getBucket(*layer);
+            if (tile.bucketsGeneration != layerSourcesGeneration) {
+                // Looks up the tile's buckets for all the layers of its source at once.
+                tile.buckets.assign(layers.size(), nullptr);
+                for (std::size_t j = 0; j < layers.size(); j++) {
+                    if (layerSources[j] == source) {
+                        tile.buckets[j] = tile.tile.getBucket(*layers[j]);
+                    }
+                }
+                tile.bucketsGeneration = layerSourcesGeneration;
+            }
+
+            Bucket* bucket = tile.buckets[i];
             if (bucket) {
                 result.order.emplace_back(*layer, &tile, bucket);
                 tile.used = true;
@@ -499,9 +724,7 @@ RenderData Style::getRenderData(MapDebugOptions debugOptions, float angle) const
     return result;
 }
 
-std::vector<Feature> Style::queryRenderedFeatures(const ScreenLineString& geometry,
-                                                  const TransformState& transformState,
-                                                  const RenderedQueryOptions& options) const {
+std::unordered_set<std::string> Style::querySourceIDs(const RenderedQueryOptions& options) const {
     std::unordered_set<std::string> sourceFilter;
 
     if (options.layerIDs) {
@@ -511,6 +734,14 @@ std::vector<Feature> Style::queryRenderedFeatures(const ScreenLineString& geomet
         }
     }
 
+    return sourceFilter;
+}
+
+std::vector<Feature> Style::queryRenderedFeatures(const ScreenLineString& geometry,
+                                                  const TransformState& transformState,
+                                                  const RenderedQueryOptions& options) const {
+    const std::unordered_set<std::string> sourceFilter = querySourceIDs(options);
+
     std::vector<Feature> result;
     std::unordered_map<std::string, std::vector<Feature>> resultsByLayer;
 
@@ -541,6 +772,53 @@ std::vector<Feature> Style::queryRenderedFeatures(const ScreenLineString& geomet
     return result;
 }
 
+std::vector<RenderedFeatureHandle> Style::queryRenderedFeatureHandles(const ScreenLineString& geometry,
+                                                                      const TransformState& transformState,
+                                                                      const RenderedQueryOptions& options) const {
+    const std::unordered_set<std::string> sourceFilter = querySourceIDs(options);
+
+    std::vector<RenderedFeatureHandle> handles;
+
+    for (const auto& source : sources) {
+        if (!sourceFilter.empty() && sourceFilter.find(source->getID()) == sourceFilter.end()) {
+            continue;
+        }
+
+        source->baseImpl->queryRenderedFeatureHandles(handles, geometry, transformState, options);
+    }
+
+    std::vector<RenderedFeatureHandle> result;
+    if (handles.empty()) {
+        return result;
+    }
+
+    // Combine all results based on the style layer order. Grouping the handles by layer keeps
+    // the order in which each layer's features were found.
+    struct ByLayer {
+        bool operator()(const RenderedFeatureHandle& a, const RenderedFeatureHandle& b) const {
+            return std::less<const Layer*>()(&a.getLayer(), &b.getLayer());
+        }
+        bool operator()(const RenderedFeatureHandle& a, const Layer* b) const {
+            return std::less<const Layer*>()(&a.getLayer(), b);
+        }
+        bool operator()(const Layer* a, const RenderedFeatureHandle& b) const {
+            return std::less<const Layer*>()(a, &b.getLayer());
+        }
+    };
+    std::stable_sort(handles.begin(), handles.end(), ByLayer());
+
+    result.reserve(handles.size());
+    for (const auto& layer : layers) {
+        if (!layer->baseImpl->needsRendering(zoomHistory.lastZoom)) {
+            continue;
+        }
+        auto range = std::equal_range(handles.begin(), handles.end(), static_cast<const Layer*>(layer.get()), ByLayer());
+        std::move(range.first, range.second, std::back_inserter(result));
+    }
+
+    return result;
+}
+
 float Style::getQueryRadius() const {
     float additionalRadius = 0;
     for (auto& layer : layers) {
@@ -559,12 +837,29 @@ void Style::setSourceTileCacheSize(size_t size) {
     }
 }
 
+void Style::setTileCacheMaximumBytes(std::size_t bytes) {
+    tileCacheBudget->setMaximumBytes(bytes);
+}
+
+TileCache::Stats Style::getTileCacheStats() const {
+    return tileCacheBudget->getStats();
+}
+
 void Style::onLowMemory() {
     for (const auto& source : sources) {
         source->baseImpl->onLowMemory();
     }
 }
 
+void Style::releaseBuffers(const std::function<bool ()>& satisfied) {
+    for (const auto& source : sources) {
+        source->baseImpl->releaseCachedBuffers(satisfied);
+    }
+    for (const auto& source : sources) {
+        source->baseImpl->releaseHiddenBuffers(satisfied);
+    }
+}
+
 void Style::setObserver(style::Observer* observer_) {
     observer = observer_;
 }
@@ -637,6 +932,7 @@ struct QueueSourceReloadVisitor {
     // they don't participate in layout.
     void operator()(CustomLayer&) {}
     void operator()(RasterLayer&) {}
+    void operator()(HillshadeLayer&) {}
     void operator()(BackgroundLayer&) {}
 
     template <class VectorLayer>
@@ -5,10 +5,12 @@
 #include <mbgl/style/source_observer.hpp>
 #include <mbgl/style/layer_observer.hpp>
 #include <mbgl/style/update_batch.hpp>
+#include <mbgl/style/camera_function_cache.hpp>
 #include <mbgl/text/glyph_atlas_observer.hpp>
 #include <mbgl/sprite/sprite_atlas_observer.hpp>
 #include <mbgl/map/mode.hpp>
 #include <mbgl/map/zoom_history.hpp>
+#include <mbgl/tile/tile_cache.hpp>
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/chrono.hpp>
@@ -17,8 +19,13 @@
 #include <mbgl/util/geo.hpp>
 
 #include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace mbgl {
@@ -26,14 +33,18 @@ namespace mbgl {
 class FileSource;
 class GlyphAtlas;
 class SpriteAtlas;
+class SpriteImage;
 class LineAtlas;
 class RenderData;
 class TransformState;
 class RenderedQueryOptions;
+class RenderedFeatureHandle;
 
 namespace style {
 
 class Layer;
+class Parser;
+class StyleSnapshot;
 class UpdateParameters;
 class QueryParameters;
 
@@ -43,10 +54,18 @@ class Style : public GlyphAtlasObserver,
               public LayerObserver,
               public util::noncopyable {
 public:
-    Style(FileSource&, float pixelRatio);
+    Style(FileSource&, float pixelRatio, const optional<std::string>& localFontFamily = {});
     ~Style() override;
 
     void setJSON(const std::string&);
+    // Loads a style that encodeBinaryStyle has encoded, like setJSON.
+    void setBinary(const std::string&);
+    // Loads copies of the style that the snapshot was taken of, like setJSON.
+    void setSnapshot(const StyleSnapshot&);
+
+    // Takes a snapshot of the style as it is now, which other styles load rather than parsing
+    // the style again. Throws if the style isn't loaded.
+    std::shared_ptr<const StyleSnapshot> getSnapshot() const;
 
     void setObserver(Observer*);
 
@@ -100,12 +119,21 @@ public:
     std::vector<Feature> queryRenderedFeatures(const ScreenLineString& geometry,
                                                const TransformState& transformState,
                                                const RenderedQueryOptions& options) const;
+    std::vector<RenderedFeatureHandle> queryRenderedFeatureHandles(const ScreenLineString& geometry,
+                                                                   const TransformState& transformState,
+                                                                   const RenderedQueryOptions& options) const;
 
     float getQueryRadius() const;
 
     void setSourceTileCacheSize(size_t);
+    void setTileCacheMaximumBytes(std::size_t);
+    TileCache::Stats getTileCacheStats() const;
     void onLowMemory();
 
+    // Releases the buffers of the tiles that aren't rendered until `satisfied` returns true:
+    // those of the cached tiles of all sources first, and then those of the others.
+    void releaseBuffers(const std::function<bool ()>& satisfied);
+
     void dumpDebugLogs() const;
 
     FileSource& fileSource;
@@ -114,6 +142,14 @@ public:
     std::unique_ptr<LineAtlas> lineAtlas;
 
 private:
+    std::unordered_set<std::string> querySourceIDs(const RenderedQueryOptions&) const;
+
+    // Shared by the tile caches of all sources.
+    std::shared_ptr<TileCache::Budget> tileCacheBudget;
+
+    const float pixelRatio;
+    const optional<std::string> localFontFamily;
+
     std::vector<std::unique_ptr<Source>> sources;
     std::vector<std::unique_ptr<Layer>> layers;
     std::vector<std::string> classes;
@@ -126,7 +162,30 @@ private:
     double defaultBearing = 0;
     double defaultPitch = 0;
 
+    // The sprite and glyph URLs of the style that was loaded last.
+    optional<std::string> spriteURL;
+    optional<std::string> glyphURL;
+
+    // The bucket keys that the layers had in the previous style, by the ID of the layers of the
+    // current style that replaced them on a source that kept its tiles.
+    std::unordered_map<std::string, std::string> previousBucketKeys;
+
+    // Replaces the style with the one that the function parses. Sources that the new style
+    // defines like the previous one keep their tiles, as long as the sprite and glyphs stay the
+    // same, and only the tiles whose layers changed are laid out anew. The sprite images, if
+    // given, are used rather than requesting the sprite.
+    void load(const std::function<std::exception_ptr (Parser&, std::function<void ()> onSourcesParsed)>&,
+              const std::map<std::string, std::shared_ptr<const SpriteImage>>* sprites = nullptr);
+
     std::vector<std::unique_ptr<Layer>>::const_iterator findLayer(const std::string& layerID) const;
+
+    // The source of each layer, by the index of the layer, for getRenderData to walk rather than
+    // looking the sources up by ID every frame. Resolved again once layers or sources are added
+    // or removed, which also moves to a new generation of the buckets cached in render tiles.
+    void invalidateLayerSources();
+    mutable std::vector<Source*> layerSources;
+    mutable bool layerSourcesChanged = true;
+    mutable uint64_t layerSourcesGeneration = 0;
     void reloadLayerSource(Layer&);
 
     // GlyphStoreObserver implementation.
@@ -159,6 +218,7 @@ private:
 
     UpdateBatch updateBatch;
     ZoomHistory zoomHistory;
+    CameraFunctionCache functionCache;
     bool hasPendingTransitions = false;
 
 public:
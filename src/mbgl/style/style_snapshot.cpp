@@ -0,0 +1,30 @@
+#include <mbgl/style/style_snapshot.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/parser.hpp>
+
+namespace mbgl {
+namespace style {
+
+void StyleSnapshot::copyInto(Parser& parser) const {
+    parser.sources.clear();
+    for (const auto& source : sources) {
+        parser.sources.push_back(source->copy(source->getID()));
+    }
+
+    parser.layers.clear();
+    for (const auto& layer : layers) {
+        parser.layers.push_back(layer->baseImpl->clone());
+    }
+
+    parser.layerSources = layerSources;
+    parser.spriteURL = spriteURL;
+    parser.glyphURL = glyphURL;
+    parser.name = name;
+    parser.latLng = latLng;
+    parser.zoom = zoom;
+    parser.bearing = bearing;
+    parser.pitch = pitch;
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mbgl/style/layer.hpp>
+#include <mbgl/style/source.hpp>
+#include <mbgl/sprite/sprite_atlas.hpp>
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+class Parser;
+
+// A loaded style that other maps are made from without parsing it or loading its resources
+// again. The snapshot is immutable once it is taken, so any number of maps can share it, on any
+// thread; each one that loads it gets copies of its sources and layers. Sources
+// that loaded their TileJSON and GeoJSON sources that indexed their data pass them on, and the
+// sprite images are shared rather than copied. Annotations and custom layers aren't part of
+// the snapshot, as they belong to the map rather than to the style.
+class StyleSnapshot : private util::noncopyable {
+public:
+    // Fills the parser in with new copies of the style, as if it had parsed it.
+    void copyInto(Parser&) const;
+
+    std::vector<std::unique_ptr<Source>> sources;
+    std::vector<std::unique_ptr<Layer>> layers;
+    std::set<std::string> layerSources;
+
+    std::string spriteURL;
+    std::string glyphURL;
+
+    // The sprite images, if the sprite had loaded, and the pixel ratio that they were loaded for.
+    optional<SpriteAtlas::Sprites> sprites;
+    float pixelRatio = 1;
+
+    std::string name;
+    LatLng latLng;
+    double zoom = 0;
+    double bearing = 0;
+    double pitch = 0;
+};
+
+} // namespace style
+} // namespace mbgl
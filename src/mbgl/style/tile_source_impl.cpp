@@ -3,6 +3,7 @@
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion/tileset.hpp>
 #include <mbgl/util/tileset.hpp>
+#include <mbgl/util/tile_url_template.hpp>
 #include <mbgl/util/mapbox.hpp>
 #include <mbgl/storage/file_source.hpp>
 
@@ -40,6 +41,15 @@ Tileset TileSourceImpl::parseTileJSON(const std::string& json, const std::string
     return *result;
 }
 
+// The tiles of a source all share the parsed template, rather than each parsing it again.
+static void parseURLTemplate(Tileset& tileset) {
+    if (!tileset.tiles.empty()) {
+        tileset.urlTemplate = std::make_shared<const TileURLTemplate>(tileset.tiles.front());
+    } else {
+        tileset.urlTemplate.reset();
+    }
+}
+
 TileSourceImpl::TileSourceImpl(SourceType type_, std::string id_, Source& base_,
                                variant<std::string, Tileset> urlOrTileset_,
                                uint16_t tileSize_)
@@ -50,10 +60,17 @@ TileSourceImpl::TileSourceImpl(SourceType type_, std::string id_, Source& base_,
 
 TileSourceImpl::~TileSourceImpl() = default;
 
+void TileSourceImpl::copyDescription(const TileSourceImpl& other) {
+    tileset = other.tileset;
+    loaded = other.loaded;
+}
+
 void TileSourceImpl::loadDescription(FileSource& fileSource) {
     if (urlOrTileset.is<Tileset>()) {
         tileset = urlOrTileset.get<Tileset>();
+        parseURLTemplate(tileset);
         loaded = true;
+        preconnect(fileSource);
         return;
     }
 
@@ -62,7 +79,7 @@ void TileSourceImpl::loadDescription(FileSource& fileSource) {
     }
 
     const std::string& url = urlOrTileset.get<std::string>();
-    req = fileSource.request(Resource::source(url), [this, url](Response res) {
+    req = fileSource.request(Resource::source(url), [this, url, &fileSource](Response res) {
         if (res.error) {
             observer->onSourceError(base, std::make_exception_ptr(std::runtime_error(res.error->message)));
         } else if (res.notModified) {
@@ -76,7 +93,7 @@ void TileSourceImpl::loadDescription(FileSource& fileSource) {
             // from the stylesheet. Then merge in the values parsed from the TileJSON we retrieved
             // via the URL.
             try {
-                newTileset = parseTileJSON(*res.data, url, type, tileSize);
+                newTileset = parseTileJSON(res.data->toString(), url, type, tileSize);
             } catch (...) {
                 observer->onSourceError(base, std::current_exception());
                 return;
@@ -104,7 +121,9 @@ void TileSourceImpl::loadDescription(FileSource& fileSource) {
             }
 
             tileset = newTileset;
+            parseURLTemplate(tileset);
             loaded = true;
+            preconnect(fileSource);
 
             observer->onSourceLoaded(base);
             if (attributionChanged) {
@@ -114,6 +133,13 @@ void TileSourceImpl::loadDescription(FileSource& fileSource) {
     });
 }
 
+void TileSourceImpl::preconnect(FileSource& fileSource) const {
+    // Connecting takes a few round trips, which can overlap with working out the tiles to load.
+    for (const auto& tileURL : tileset.tiles) {
+        fileSource.preconnect(tileURL);
+    }
+}
+
 optional<Range<uint8_t>> TileSourceImpl::getZoomRange() const {
     if (loaded) {
         return tileset.zoomRange;
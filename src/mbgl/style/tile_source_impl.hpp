@@ -34,10 +34,20 @@ public:
         return urlOrTileset;
     }
 
+    // The loaded TileJSON, or the tileset the source was created with.
+    const Tileset& getTileset() const {
+        return tileset;
+    }
+
     optional<std::string> getAttribution() const override;
     optional<Range<uint8_t>> getZoomRange() const final;
 
 protected:
+    void preconnect(FileSource&) const;
+
+    // Takes over the TileJSON that another source with the same URL has loaded.
+    void copyDescription(const TileSourceImpl&);
+
     const variant<std::string, Tileset> urlOrTileset;
     const uint16_t tileSize;
 
@@ -8,6 +8,7 @@ using namespace style;
 MBGL_DEFINE_ENUM(SourceType, {
     { SourceType::Vector, "vector" },
     { SourceType::Raster, "raster" },
+    { SourceType::RasterDEM, "raster-dem" },
     { SourceType::GeoJSON, "geojson" },
     { SourceType::Video, "video" },
     { SourceType::Annotations, "annotations" },
@@ -33,6 +34,11 @@ MBGL_DEFINE_ENUM(CirclePitchScaleType, {
     { CirclePitchScaleType::Viewport, "viewport" },
 });
 
+MBGL_DEFINE_ENUM(HillshadeIlluminationAnchorType, {
+    { HillshadeIlluminationAnchorType::Map, "map" },
+    { HillshadeIlluminationAnchorType::Viewport, "viewport" },
+});
+
 MBGL_DEFINE_ENUM(LineCapType, {
     { LineCapType::Round, "round" },
     { LineCapType::Butt, "butt" },
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <mbgl/map/mode.hpp>
+#include <mbgl/map/transform_state.hpp>
+
+#include <vector>
 
 namespace mbgl {
 
-class TransformState;
 class Scheduler;
 class FileSource;
 class AnnotationManager;
@@ -40,6 +42,23 @@ public:
     const MapMode mode;
     AnnotationManager& annotationManager;
 
+    // States that the camera is about to pass through, whose tiles are loaded ahead of time.
+    std::vector<TransformState> prefetchStates;
+
+    // Whether the camera is moving in an animation or a gesture. While it is, the tiles drawn in
+    // the previous frame stay loaded, and stand in for the ones the camera moves on to.
+    bool cameraMoving = false;
+
+    // Whether the tiles around the viewport, and a zoom level above and below it, are laid out
+    // from the cache while the camera doesn't move; see Map::setIdlePrelayout().
+    bool prelayout = false;
+
+    // Whether the buckets of fill layers are laid out for the picking buffer.
+    bool featurePicking = false;
+
+    // Whether the view is multisampled; see BucketParameters.
+    bool multisampling = false;
+
     // TODO: remove
     Style& style;
 };
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <set>
 #include <string>
 #include <vector>
 #include <memory>
@@ -19,11 +18,13 @@ public:
     BiDi();
     ~BiDi();
 
-    std::vector<std::u16string> processText(const std::u16string&, std::set<std::size_t>);
+    // Breaks the text into lines after the given ascending line break points, and reorders each
+    // line for display.
+    std::vector<std::u16string> processText(const std::u16string&, std::vector<std::size_t>);
 
 private:
-    void mergeParagraphLineBreaks(std::set<std::size_t>&);
-    std::vector<std::u16string> applyLineBreaking(std::set<std::size_t>);
+    void mergeParagraphLineBreaks(std::vector<std::size_t>&);
+    std::vector<std::u16string> applyLineBreaking(std::vector<std::size_t>);
     std::u16string getLine(std::size_t start, std::size_t end);
 
     std::unique_ptr<BiDiImpl> impl;
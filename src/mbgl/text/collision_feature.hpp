@@ -29,6 +29,11 @@ public:
 
     // the scale at which the label can first be shown
     float placementScale = 0.0f;
+
+    bool operator==(const CollisionBox& rhs) const {
+        return anchor == rhs.anchor && x1 == rhs.x1 && y1 == rhs.y1 && x2 == rhs.x2 && y2 == rhs.y2 &&
+               maxScale == rhs.maxScale && placementScale == rhs.placementScale;
+    }
 };
 
 class CollisionFeature {
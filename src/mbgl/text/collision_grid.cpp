@@ -0,0 +1,100 @@
+#include <mbgl/text/collision_grid.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace mbgl {
+
+namespace {
+
+constexpr uint32_t endOfList = std::numeric_limits<uint32_t>::max();
+
+} // namespace
+
+CollisionGrid::CollisionGrid(float min_, float max_, uint32_t n_)
+    : min(min_),
+      scale(n_ / (max_ - min_)),
+      n(n_) {
+    assert(max_ > min_ && n_ > 0);
+}
+
+uint32_t CollisionGrid::convertToCellCoord(float x) const {
+    const float cell = (x - min) * scale;
+    // Also catches NaN.
+    if (!(cell > 0)) {
+        return 0;
+    }
+    if (cell >= n - 1) {
+        return n - 1;
+    }
+    return static_cast<uint32_t>(cell);
+}
+
+void CollisionGrid::insert(const CollisionGridBox& box, const CollisionBox& collisionBox, const IndexedSubfeature& feature) {
+    if (heads.empty()) {
+        heads.resize(n * n, endOfList);
+    }
+
+    const auto uid = static_cast<uint32_t>(elements.size());
+    elements.push_back({ box, collisionBox, feature });
+    queryStamps.push_back(0);
+
+    const uint32_t cx1 = convertToCellCoord(box.x1);
+    const uint32_t cy1 = convertToCellCoord(box.y1);
+    const uint32_t cx2 = convertToCellCoord(box.x2);
+    const uint32_t cy2 = convertToCellCoord(box.y2);
+
+    for (uint32_t y = cy1; y <= cy2; ++y) {
+        for (uint32_t x = cx1; x <= cx2; ++x) {
+            uint32_t& head = heads[n * y + x];
+            nodes.push_back({ uid, head });
+            head = static_cast<uint32_t>(nodes.size() - 1);
+        }
+    }
+}
+
+void CollisionGrid::query(const CollisionGridBox& queryBox, std::vector<uint32_t>& result) const {
+    result.clear();
+    if (elements.empty()) {
+        return;
+    }
+
+    if (++queryStamp == 0) {
+        // The stamps wrapped around; forget the stamps of earlier queries.
+        std::fill(queryStamps.begin(), queryStamps.end(), 0);
+        queryStamp = 1;
+    }
+
+    const uint32_t cx1 = convertToCellCoord(queryBox.x1);
+    const uint32_t cy1 = convertToCellCoord(queryBox.y1);
+    const uint32_t cx2 = convertToCellCoord(queryBox.x2);
+    const uint32_t cy2 = convertToCellCoord(queryBox.y2);
+
+    for (uint32_t y = cy1; y <= cy2; ++y) {
+        for (uint32_t x = cx1; x <= cx2; ++x) {
+            for (uint32_t node = heads[n * y + x]; node != endOfList; node = nodes[node].next) {
+                const uint32_t uid = nodes[node].element;
+                if (queryStamps[uid] == queryStamp) {
+                    continue;
+                }
+                queryStamps[uid] = queryStamp;
+
+                if (intersects(queryBox, elements[uid].box)) {
+                    result.push_back(uid);
+                }
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+}
+
+std::size_t CollisionGrid::getByteSize() const {
+    return elements.capacity() * sizeof(Element) +
+           heads.capacity() * sizeof(uint32_t) +
+           nodes.capacity() * sizeof(Node) +
+           queryStamps.capacity() * sizeof(uint32_t);
+}
+
+} // namespace mbgl
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/text/collision_feature.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace mbgl {
+
+// An axis-aligned box in the rotated space of a collision tile.
+struct CollisionGridBox {
+    float x1;
+    float y1;
+    float x2;
+    float y2;
+};
+
+// Whether two boxes intersect. Boxes that touch intersect.
+inline bool intersects(const CollisionGridBox& a, const CollisionGridBox& b) {
+    return a.x1 <= b.x2 && a.y1 <= b.y2 && a.x2 >= b.x1 && a.y2 >= b.y1;
+}
+
+// Collision boxes in a uniform grid of square cells spanning [min, max) on both axes. Boxes
+// that reach outside of the grid are kept in the border cells, so they are still found, just
+// not as quickly. Elements and cell lists live in flat arrays, and queries write into a vector
+// owned by the caller, so that placing a label doesn't allocate.
+//
+// Queries are not safe to run concurrently on the same grid.
+class CollisionGrid {
+public:
+    struct Element {
+        CollisionGridBox box;
+        CollisionBox collisionBox;
+        IndexedSubfeature feature;
+    };
+
+    CollisionGrid(float min, float max, uint32_t n);
+
+    void insert(const CollisionGridBox&, const CollisionBox&, const IndexedSubfeature&);
+
+    // Replaces the contents of `result` with the indices of the elements whose boxes intersect
+    // the given box, in the order the elements were inserted. Boxes that touch intersect.
+    void query(const CollisionGridBox&, std::vector<uint32_t>& result) const;
+
+    const Element& operator[](uint32_t index) const {
+        return elements[index];
+    }
+
+    std::size_t size() const {
+        return elements.size();
+    }
+
+    bool empty() const {
+        return elements.empty();
+    }
+
+    // Returns the number of bytes allocated for elements and cells.
+    std::size_t getByteSize() const;
+
+private:
+    uint32_t convertToCellCoord(float) const;
+
+    const float min;
+    const float scale;
+    const uint32_t n;
+
+    std::vector<Element> elements;
+
+    // Cell lists are singly linked lists of nodes, starting at the head of each cell. Heads are
+    // allocated on the first insertion, as many tiles leave one of their grids empty.
+    struct Node {
+        uint32_t element;
+        uint32_t next;
+    };
+    std::vector<uint32_t> heads;
+    std::vector<Node> nodes;
+
+    // The number of the last query of each element, so that elements in more than one of the
+    // queried cells are reported once.
+    mutable std::vector<uint32_t> queryStamps;
+    mutable uint32_t queryStamp = 0;
+};
+
+} // namespace mbgl
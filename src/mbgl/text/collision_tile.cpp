@@ -10,10 +10,34 @@
 #include <mapbox/geometry/multi_point.hpp>
 
 #include <cmath>
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 
-CollisionTile::CollisionTile(PlacementConfig config_) : config(std::move(config_)) {
+namespace {
+
+// Boxes are placed in tile coordinates rotated around the tile origin, so the grids cover the
+// tile rotated by any angle, plus the labels reaching beyond it. Cells are 32 pixels wide at
+// the tile's own zoom level, which is about the height of a line of text.
+constexpr float gridMin = -2.0f * util::EXTENT;
+constexpr float gridMax = 2.0f * util::EXTENT;
+constexpr uint32_t gridSize = 64;
+
+// Distance from the tile edges within which the boxes of placed symbols are handed to the
+// neighbours of the tile, beyond the reach of the boxes themselves. It leaves room for the
+// reach of the boxes of the neighbours.
+constexpr float edgeMargin = util::EXTENT / 4;
+
+} // namespace
+
+CollisionTile::CollisionTile(PlacementConfig config_)
+    : config(std::move(config_)),
+      grid(gridMin, gridMax, gridSize),
+      ignoredGrid(gridMin, gridMax, gridSize),
+      neighbourGrid(gridMin, gridMax, gridSize) {
     // Compute the transformation matrix.
     const float angle_sin = std::sin(config.angle);
     const float angle_cos = std::cos(config.angle);
@@ -26,6 +50,18 @@ CollisionTile::CollisionTile(PlacementConfig config_) : config(std::move(config_
     // The amount the map is squished depends on the y position.
     // Sort of account for this by making all boxes a bit bigger.
     yStretch = std::pow(_yStretch, 1.3f);
+
+    const IndexedSubfeature neighbourFeature { 0, 0, 0, 0 };
+    for (const auto& neighbour : config.neighbours) {
+        if (!neighbour.boxes) {
+            continue;
+        }
+        for (CollisionBox box : *neighbour.boxes) {
+            box.anchor.x += neighbour.dx * util::EXTENT;
+            box.anchor.y += neighbour.dy * util::EXTENT;
+            neighbourGrid.insert(getTreeBox(util::matrixMultiply(rotationMatrix, box.anchor), box), box, neighbourFeature);
+        }
+    }
 }
 
 
@@ -83,16 +119,53 @@ float CollisionTile::placeFeature(const CollisionFeature& feature, bool allowOve
 
     float minPlacementScale = minScale;
 
+    featureBoxes.clear();
     for (auto& box : feature.boxes) {
         const auto anchor = util::matrixMultiply(rotationMatrix, box.anchor);
+        featureBoxes.emplace_back(anchor, getTreeBox(anchor, box));
+    }
 
-        if (!allowOverlap) {
-            for (auto it = tree.qbegin(bgi::intersects(getTreeBox(anchor, box))); it != tree.qend(); ++it) {
-                const CollisionBox& blocking = std::get<1>(*it);
-                Point<float> blockingAnchor = util::matrixMultiply(rotationMatrix, blocking.anchor);
+    // Line labels have a box for each step along the line. The grids are queried once with the
+    // box that bounds them all, and each box is then only tested against the boxes found, so
+    // that a label that is clear of other labels is cleared with one query per grid.
+    bool mayBeBlocked = !allowOverlap && !featureBoxes.empty();
+    if (mayBeBlocked) {
+        CollisionGridBox bounds = featureBoxes.front().second;
+        for (const auto& featureBox : featureBoxes) {
+            bounds.x1 = util::min(bounds.x1, featureBox.second.x1);
+            bounds.y1 = util::min(bounds.y1, featureBox.second.y1);
+            bounds.x2 = util::max(bounds.x2, featureBox.second.x2);
+            bounds.y2 = util::max(bounds.y2, featureBox.second.y2);
+        }
+        grid.query(bounds, blockingBoxes);
+        neighbourGrid.query(bounds, blockingNeighbourBoxes);
+        mayBeBlocked = !blockingBoxes.empty() || !blockingNeighbourBoxes.empty();
+    }
 
-                minPlacementScale = util::max(minPlacementScale, findPlacementScale(anchor, box, blockingAnchor, blocking));
-                if (minPlacementScale >= maxScale) return minPlacementScale;
+    const std::pair<const CollisionGrid*, const std::vector<uint32_t>*> blockingGrids[] = {
+        { &grid, &blockingBoxes },
+        { &neighbourGrid, &blockingNeighbourBoxes }
+    };
+
+    for (std::size_t i = 0; i < feature.boxes.size(); ++i) {
+        const CollisionBox& box = feature.boxes[i];
+        const Point<float>& anchor = featureBoxes[i].first;
+
+        if (mayBeBlocked) {
+            const CollisionGridBox& treeBox = featureBoxes[i].second;
+            for (const auto& blockingGrid : blockingGrids) {
+                for (const uint32_t index : *blockingGrid.second) {
+                    const CollisionGrid::Element& element = (*blockingGrid.first)[index];
+                    if (!intersects(treeBox, element.box)) {
+                        continue;
+                    }
+
+                    const CollisionBox& blocking = element.collisionBox;
+                    Point<float> blockingAnchor = util::matrixMultiply(rotationMatrix, blocking.anchor);
+
+                    minPlacementScale = util::max(minPlacementScale, findPlacementScale(anchor, box, blockingAnchor, blocking));
+                    if (minPlacementScale >= maxScale) return minPlacementScale;
+                }
             }
         }
 
@@ -124,19 +197,32 @@ void CollisionTile::insertFeature(CollisionFeature& feature, float minPlacementS
     }
 
     if (minPlacementScale < maxScale) {
-        std::vector<CollisionTreeBox> treeBoxes;
+        CollisionGrid& target = ignorePlacement ? ignoredGrid : grid;
         for (auto& box : feature.boxes) {
-            treeBoxes.emplace_back(getTreeBox(util::matrixMultiply(rotationMatrix, box.anchor), box), box, feature.indexedFeature);
-        }
-        if (ignorePlacement) {
-            ignoredTree.insert(treeBoxes.begin(), treeBoxes.end());
-        } else {
-            tree.insert(treeBoxes.begin(), treeBoxes.end());
+            target.insert(getTreeBox(util::matrixMultiply(rotationMatrix, box.anchor), box), box, feature.indexedFeature);
         }
     }
 
 }
 
+std::vector<CollisionBox> CollisionTile::getEdgeBoxes() const {
+    std::vector<CollisionBox> result;
+    for (uint32_t index = 0; index < grid.size(); ++index) {
+        const CollisionBox& box = grid[index].collisionBox;
+
+        // Boxes are largest at the minimum scale.
+        const float dx = util::max(std::abs(box.x1), std::abs(box.x2));
+        const float dy = util::max(std::abs(box.y1), std::abs(box.y2)) * yStretch;
+        const float reach = std::sqrt(dx * dx + dy * dy) / minScale + edgeMargin;
+
+        if (box.anchor.x < reach || box.anchor.x > util::EXTENT - reach ||
+            box.anchor.y < reach || box.anchor.y > util::EXTENT - reach) {
+            result.push_back(box);
+        }
+    }
+    return result;
+}
+
 // +---------------------------+ As you zoom, the size of the symbol changes
 // |(x1,y1)      |             | relative to the tile e.g. when zooming in,
 // |             |             | the symbol gets smaller relative to the tile.
@@ -154,23 +240,19 @@ void CollisionTile::insertFeature(CollisionFeature& feature, float minPlacementS
 // |             |             | calculating the bounds at current zoom level
 // |             |      (x2,y2)| we must unscale the box using its center as
 // +---------------------------+ transform origin.
-Box CollisionTile::getTreeBox(const Point<float>& anchor, const CollisionBox& box, const float scale) {
+CollisionGridBox CollisionTile::getTreeBox(const Point<float>& anchor, const CollisionBox& box, const float scale) {
     assert(box.x1 <= box.x2 && box.y1 <= box.y2);
-    return Box{
-        CollisionPoint{
-            anchor.x + box.x1 / scale,
-            anchor.y + box.y1 / scale * yStretch
-        },
-        CollisionPoint{
-            anchor.x + box.x2 / scale,
-            anchor.y + box.y2 / scale * yStretch
-        }
+    return CollisionGridBox {
+        anchor.x + box.x1 / scale,
+        anchor.y + box.y1 / scale * yStretch,
+        anchor.x + box.x2 / scale,
+        anchor.y + box.y2 / scale * yStretch
     };
 }
 
 std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const GeometryCoordinates& queryGeometry, float scale) const {
     std::vector<IndexedSubfeature> result;
-    if (queryGeometry.empty() || (tree.empty() && ignoredTree.empty())) {
+    if (queryGeometry.empty() || (grid.empty() && ignoredGrid.empty())) {
         return result;
     }
 
@@ -182,52 +264,50 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const Geometr
         polygon.push_back(convertPoint<int16_t>(rotated));
     }
 
-    // Predicate for ruling out already seen features.
-    std::unordered_map<std::string, std::unordered_set<std::size_t>> sourceLayerFeatures;
-    auto seenFeature = [&] (const CollisionTreeBox& treeBox) -> bool {
-        const IndexedSubfeature& feature = std::get<2>(treeBox);
-        const auto& seenFeatures = sourceLayerFeatures[feature.sourceLayerName];
-        return seenFeatures.find(feature.index) == seenFeatures.end();
-    };
+    std::unordered_map<uint16_t, std::unordered_set<std::size_t>> sourceLayerFeatures;
 
     // Account for the rounding done when updating symbol shader variables.
     const float roundedScale = std::pow(2.0f, std::ceil(util::log2(scale) * 10.0f) / 10.0f);
 
-    // Check if feature is rendered (collision free) at current scale.
-    auto visibleAtScale = [&] (const CollisionTreeBox& treeBox) -> bool {
-        const CollisionBox& box = std::get<1>(treeBox);
-        return roundedScale >= box.placementScale && roundedScale <= box.maxScale;
-    };
+    // The grids hold the boxes at scale 1 rather than at the query scale, so every box is
+    // checked against the query geometry.
+    auto queryGrid = [&] (const CollisionGrid& grid_) {
+        for (uint32_t index = 0; index < grid_.size(); ++index) {
+            const CollisionGrid::Element& element = grid_[index];
+            const IndexedSubfeature& feature = element.feature;
+
+            // Rule out already seen features.
+            auto& seenFeatures = sourceLayerFeatures[feature.sourceLayerID];
+            if (seenFeatures.find(feature.index) != seenFeatures.end()) {
+                continue;
+            }
 
-    // Check if query polygon intersects with the feature box at current scale.
-    auto intersectsAtScale = [&] (const CollisionTreeBox& treeBox) -> bool {
-        const CollisionBox& collisionBox = std::get<1>(treeBox);
-        const auto anchor = util::matrixMultiply(rotationMatrix, collisionBox.anchor);
-        const int16_t x1 = anchor.x + collisionBox.x1 / scale;
-        const int16_t y1 = anchor.y + collisionBox.y1 / scale * yStretch;
-        const int16_t x2 = anchor.x + collisionBox.x2 / scale;
-        const int16_t y2 = anchor.y + collisionBox.y2 / scale * yStretch;
-        auto bbox = GeometryCoordinates {
-            { x1, y1 }, { x2, y1 }, { x2, y2 }, { x1, y2 }
-        };
-        return util::polygonIntersectsPolygon(polygon, bbox);
-    };
+            // Check if feature is rendered (collision free) at current scale.
+            const CollisionBox& collisionBox = element.collisionBox;
+            if (roundedScale < collisionBox.placementScale || roundedScale > collisionBox.maxScale) {
+                continue;
+            }
 
-    auto predicates = bgi::satisfies(seenFeature)
-                   && bgi::satisfies(visibleAtScale)
-                   && bgi::satisfies(intersectsAtScale);
+            // Check if query polygon intersects with the feature box at current scale.
+            const auto anchor = util::matrixMultiply(rotationMatrix, collisionBox.anchor);
+            const int16_t x1 = anchor.x + collisionBox.x1 / scale;
+            const int16_t y1 = anchor.y + collisionBox.y1 / scale * yStretch;
+            const int16_t x2 = anchor.x + collisionBox.x2 / scale;
+            const int16_t y2 = anchor.y + collisionBox.y2 / scale * yStretch;
+            auto bbox = GeometryCoordinates {
+                { x1, y1 }, { x2, y1 }, { x2, y2 }, { x1, y2 }
+            };
+            if (!util::polygonIntersectsPolygon(polygon, bbox)) {
+                continue;
+            }
 
-    auto queryTree = [&](const auto& tree_) {
-        for (auto it = tree_.qbegin(predicates); it != tree_.qend(); ++it) {
-            const IndexedSubfeature& feature = std::get<2>(*it);
-            auto& seenFeatures = sourceLayerFeatures[feature.sourceLayerName];
             seenFeatures.insert(feature.index);
             result.push_back(feature);
         }
     };
 
-    queryTree(tree);
-    queryTree(ignoredTree);
+    queryGrid(grid);
+    queryGrid(ignoredGrid);
 
     return result;
 }
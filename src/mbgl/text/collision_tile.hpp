@@ -1,40 +1,17 @@
 #pragma once
 
 #include <mbgl/text/collision_feature.hpp>
+#include <mbgl/text/collision_grid.hpp>
 #include <mbgl/text/placement_config.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-function"
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#pragma GCC diagnostic ignored "-Wunused-variable"
-#pragma GCC diagnostic ignored "-Wshadow"
-#ifdef __clang__
-#pragma GCC diagnostic ignored "-Wunknown-pragmas"
-#endif
-#pragma GCC diagnostic ignored "-Wpragmas"
-#pragma GCC diagnostic ignored "-Wdeprecated-register"
-#pragma GCC diagnostic ignored "-Wshorten-64-to-32"
-#pragma GCC diagnostic ignored "-Wunused-local-typedefs"
-#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
-#include <boost/geometry.hpp>
-#include <boost/geometry/geometries/point.hpp>
-#include <boost/geometry/geometries/box.hpp>
-#include <boost/geometry/index/rtree.hpp>
-#pragma GCC diagnostic pop
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 namespace mbgl {
 
-namespace bg = boost::geometry;
-namespace bgm = bg::model;
-namespace bgi = bg::index;
-typedef bgm::point<float, 2, bg::cs::cartesian> CollisionPoint;
-typedef bgm::box<CollisionPoint> Box;
-typedef std::tuple<Box, CollisionBox, IndexedSubfeature> CollisionTreeBox;
-typedef bgi::rtree<CollisionTreeBox, bgi::linear<16, 4>> Tree;
-
-class IndexedSubfeature;
-
 class CollisionTile {
 public:
     explicit CollisionTile(PlacementConfig);
@@ -44,6 +21,15 @@ public:
 
     std::vector<IndexedSubfeature> queryRenderedSymbols(const GeometryCoordinates&, float scale) const;
 
+    // Returns the boxes of placed symbols that may collide with symbols of the adjacent tiles,
+    // for placing those around them.
+    std::vector<CollisionBox> getEdgeBoxes() const;
+
+    // Returns the number of bytes held by the collision boxes and their grids.
+    std::size_t getByteSize() const {
+        return grid.getByteSize() + ignoredGrid.getByteSize() + neighbourGrid.getByteSize();
+    }
+
     const PlacementConfig config;
 
     const float minScale = 0.5f;
@@ -57,10 +43,22 @@ private:
     float findPlacementScale(
             const Point<float>& anchor, const CollisionBox& box,
             const Point<float>& blockingAnchor, const CollisionBox& blocking);
-    Box getTreeBox(const Point<float>& anchor, const CollisionBox& box, const float scale = 1.0);
+    CollisionGridBox getTreeBox(const Point<float>& anchor, const CollisionBox& box, const float scale = 1.0);
+
+    // Boxes of placed symbols, and of symbols that ignore placement: those don't block other
+    // symbols, but can still be queried.
+    CollisionGrid grid;
+    CollisionGrid ignoredGrid;
+
+    // Boxes the neighbours of the tile placed near its edges. They block symbols, but aren't
+    // symbols of this tile.
+    CollisionGrid neighbourGrid;
 
-    Tree tree;
-    Tree ignoredTree;
+    // Reused by placeFeature() for the rotated anchors and tree boxes of the feature's boxes,
+    // and for the boxes of each blocking grid that may block any of them.
+    std::vector<std::pair<Point<float>, CollisionGridBox>> featureBoxes;
+    std::vector<uint32_t> blockingBoxes;
+    std::vector<uint32_t> blockingNeighbourBoxes;
 };
 
 } // namespace mbgl
@@ -1,6 +1,6 @@
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/glyph_atlas_observer.hpp>
-#include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/text/glyph_store.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/platform.hpp>
@@ -15,12 +15,48 @@ namespace mbgl {
 
 static GlyphAtlasObserver nullObserver;
 
-GlyphAtlas::GlyphAtlas(const Size size, FileSource& fileSource_)
+GlyphIDs ResidentGlyphs::find(const FontStack& fontStack, const GlyphIDs& glyphIDs, GlyphPositions& result) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto font = positions.find(fontStack);
+    if (font == positions.end()) {
+        return glyphIDs;
+    }
+
+    GlyphIDs missing;
+    for (const GlyphID glyphID : glyphIDs) {
+        auto it = font->second.find(glyphID);
+        if (it != font->second.end()) {
+            result.emplace(glyphID, it->second);
+        } else {
+            missing.insert(glyphID);
+        }
+    }
+    return missing;
+}
+
+void ResidentGlyphs::add(const FontStack& fontStack, GlyphID glyphID, const Glyph& glyph) {
+    std::lock_guard<std::mutex> lock(mutex);
+    positions[fontStack].emplace(glyphID, glyph);
+}
+
+constexpr std::size_t GlyphAtlas::maximumResidentGlyphs;
+
+GlyphAtlas::GlyphAtlas(const Size size,
+                       FileSource& fileSource_,
+                       std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer_,
+                       const Size maximumSize_)
     : fileSource(fileSource_),
+      localGlyphRasterizer(std::move(localGlyphRasterizer_)),
+      shapingCache(std::make_shared<ShapingCache>()),
+      residentGlyphs(std::make_shared<ResidentGlyphs>()),
       observer(&nullObserver),
+      maximumSize(maximumSize_),
       bin(size.width, size.height),
       image(size),
-      dirty(true) {
+      dirtyTop(0),
+      dirtyBottom(size.height) {
+    assert(size.width <= maximumSize.width && size.height <= maximumSize.height);
 }
 
 GlyphAtlas::~GlyphAtlas() = default;
@@ -39,6 +75,22 @@ void GlyphAtlas::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphDep
         const GlyphIDs& glyphIDs = dependency.second;
         GlyphRangeSet ranges;
         for (const auto& glyphID : glyphIDs) {
+            if (localGlyphRasterizer->canRasterizeGlyph(fontStack, glyphID)) {
+                if (entry.glyphs.count(glyphID)) {
+                    continue;
+                }
+
+                SDFGlyph glyph = localGlyphRasterizer->rasterizeGlyph(fontStack, glyphID);
+                if (glyph.bitmap.valid()) {
+                    entry.glyphs.emplace(glyphID, GlyphValue {
+                        std::make_shared<const SDFGlyph>(std::move(glyph)), {}, {}
+                    });
+                    continue;
+                }
+
+                // The local font doesn't contain the glyph; fall back to its glyph range.
+            }
+
             ranges.insert(getGlyphRange(glyphID));
         }
 
@@ -46,7 +98,9 @@ void GlyphAtlas::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphDep
             auto it = entry.ranges.find(range);
             if (it == entry.ranges.end() || !it->second.parsed) {
                 GlyphRequest& request = requestRange(entry, fontStack, range);
-                request.requestors[&requestor] = dependencies;
+                if (!request.parsed) {
+                    request.requestors[&requestor] = dependencies;
+                }
             }
         }
     }
@@ -65,6 +119,14 @@ GlyphAtlas::GlyphRequest& GlyphAtlas::requestRange(Entry& entry, const FontStack
         return request;
     }
 
+    // Another map may hold on to the glyphs already.
+    if (auto glyphs = GlyphStore::get().find(glyphURL, fontStack, range)) {
+        if (addRange(entry, fontStack, glyphs)) {
+            rangeLoaded(request, fontStack, range);
+            return request;
+        }
+    }
+
     request.req = fileSource.request(Resource::glyphs(glyphURL, fontStack, range), [this, fontStack, range](Response res) {
         processResponse(res, fontStack, range);
     });
@@ -86,40 +148,54 @@ void GlyphAtlas::processResponse(const Response& res, const FontStack& fontStack
     GlyphRequest& request = entry.ranges[range];
 
     if (!res.noContent) {
-        std::vector<SDFGlyph> glyphs;
+        std::shared_ptr<const GlyphStore::Glyphs> glyphs;
 
         try {
-            glyphs = parseGlyphPBF(range, *res.data);
+            glyphs = GlyphStore::get().add(glyphURL, fontStack, range, res.data->toString());
         } catch (...) {
             observer->onGlyphsError(fontStack, range, std::current_exception());
             return;
         }
 
-        for (auto& glyph : glyphs) {
-            auto it = entry.glyphs.find(glyph.id);
-            if (it == entry.glyphs.end()) {
-                // Glyph doesn't exist yet.
-                entry.glyphs.emplace(glyph.id, GlyphValue {
-                    std::move(glyph.bitmap),
-                    std::move(glyph.metrics),
-                    {}, {}
-                });
-            } else if (it->second.metrics == glyph.metrics) {
-                if (it->second.bitmap != glyph.bitmap) {
-                    // The actual bitmap was updated; this is unsupported.
-                    Log::Warning(Event::Glyph, "Modified glyph changed bitmap represenation");
-                }
-                // At least try to update it in case it's currently unused.
-                // If it is already used, we won't attempt to update the glyph atlas texture.
-                it->second.bitmap = std::move(glyph.bitmap);
-            } else {
-                // The metrics were updated; this is unsupported.
-                Log::Warning(Event::Glyph, "Modified glyph has different metrics");
-                return;
+        if (!addRange(entry, fontStack, glyphs)) {
+            return;
+        }
+    }
+
+    rangeLoaded(request, fontStack, range);
+}
+
+bool GlyphAtlas::addRange(Entry& entry, const FontStack& fontStack, const std::shared_ptr<const GlyphStore::Glyphs>& glyphs) {
+    for (const auto& pair : *glyphs) {
+        // Shares ownership of the whole range.
+        std::shared_ptr<const SDFGlyph> glyph(glyphs, &pair.second);
+
+        auto it = entry.glyphs.find(pair.first);
+        if (it != entry.glyphs.end() && localGlyphRasterizer->canRasterizeGlyph(fontStack, pair.first)) {
+            // Keep the locally rasterized glyph.
+            continue;
+        } else if (it == entry.glyphs.end()) {
+            // Glyph doesn't exist yet.
+            entry.glyphs.emplace(pair.first, GlyphValue { std::move(glyph), {}, {} });
+        } else if (it->second.glyph->metrics == glyph->metrics) {
+            if (it->second.glyph != glyph && it->second.glyph->bitmap != glyph->bitmap) {
+                // The actual bitmap was updated; this is unsupported.
+                Log::Warning(Event::Glyph, "Modified glyph changed bitmap represenation");
             }
+            // At least try to update it in case it's currently unused.
+            // If it is already used, we won't attempt to update the glyph atlas texture.
+            it->second.glyph = std::move(glyph);
+        } else {
+            // The metrics were updated; this is unsupported.
+            Log::Warning(Event::Glyph, "Modified glyph has different metrics");
+            return false;
         }
     }
 
+    return true;
+}
+
+void GlyphAtlas::rangeLoaded(GlyphRequest& request, const FontStack& fontStack, const GlyphRange& range) {
     request.parsed = true;
 
     for (auto& pair : request.requestors) {
@@ -135,6 +211,14 @@ void GlyphAtlas::processResponse(const Response& res, const FontStack& fontStack
     observer->onGlyphsLoaded(fontStack, range);
 }
 
+void GlyphAtlas::setURL(const std::string& url) {
+    if (url != glyphURL) {
+        // Glyphs of the same font stack may have other metrics at the new URL.
+        shapingCache = std::make_shared<ShapingCache>();
+    }
+    glyphURL = url;
+}
+
 void GlyphAtlas::setObserver(GlyphAtlasObserver* observer_) {
     observer = observer_ ? observer_ : &nullObserver;
 }
@@ -159,12 +243,22 @@ void GlyphAtlas::addGlyphs(GlyphRequestor& requestor, const GlyphDependencies& g
             if (it == entry.glyphs.end())
                 continue;
 
-            it->second.ids.insert(&requestor);
+            GlyphValue& value = it->second;
+            value.ids.insert(&requestor);
 
             glyph = Glyph {
-                addGlyph(it->second),
-                it->second.metrics
+                addGlyph(value),
+                value.glyph->metrics
             };
+
+            // The glyph is common to more than one tile, so it is likely to be used by others. Glyphs
+            // that didn't fit into the atlas are left to be requested again.
+            const bool placed = value.rect || !value.glyph->bitmap.valid();
+            if (!value.resident && placed && value.ids.size() > 1 && residentGlyphCount < maximumResidentGlyphs) {
+                value.resident = true;
+                residentGlyphCount++;
+                residentGlyphs->add(fontStack, glyphID, *glyph);
+            }
         }
     }
 
@@ -178,14 +272,15 @@ Rect<uint16_t> GlyphAtlas::addGlyph(GlyphValue& value) {
     }
 
     // We don't need to add glyphs without a bitmap (e.g. whitespace).
-    if (!value.bitmap.valid()) {
+    const AlphaImage& bitmap = value.glyph->bitmap;
+    if (!bitmap.valid()) {
         return {};
     }
 
     // Add a 1px border around every image.
     const uint32_t padding = 1;
-    uint16_t width = value.bitmap.size.width + 2 * padding;
-    uint16_t height = value.bitmap.size.height + 2 * padding;
+    uint16_t width = bitmap.size.width + 2 * padding;
+    uint16_t height = bitmap.size.height + 2 * padding;
 
     // Increase to next number divisible by 4, but at least 1.
     // This is so we can scale down the texture coordinates and pack them
@@ -194,22 +289,51 @@ Rect<uint16_t> GlyphAtlas::addGlyph(GlyphValue& value) {
     height += (4 - height % 4);
 
     Rect<uint16_t> rect = bin.allocate(width, height);
+    while (rect.w == 0 && grow()) {
+        rect = bin.allocate(width, height);
+    }
     if (rect.w == 0) {
         Log::Error(Event::OpenGL, "glyph bitmap overflow");
         return {};
     }
 
-    AlphaImage::copy(value.bitmap, image, { 0, 0 }, { rect.x + padding, rect.y + padding }, value.bitmap.size);
+    AlphaImage::copy(bitmap, image, { 0, 0 }, { rect.x + padding, rect.y + padding }, bitmap.size);
     value.rect = rect;
-    dirty = true;
+    dirtyTop = std::min<uint32_t>(dirtyTop, rect.y);
+    dirtyBottom = std::max<uint32_t>(dirtyBottom, rect.y + rect.h);
 
     return rect;
 }
 
+bool GlyphAtlas::grow() {
+    if (image.size == maximumSize) {
+        return false;
+    }
+
+    // Grow the shorter side first, so that the atlas stays roughly square.
+    Size size = image.size;
+    if (size.height < size.width || size.width == maximumSize.width) {
+        size.height = std::min(size.height * 2, maximumSize.height);
+    } else {
+        size.width = std::min(size.width * 2, maximumSize.width);
+    }
+
+    AlphaImage grown(size);
+    AlphaImage::copy(image, grown, { 0, 0 }, { 0, 0 }, image.size);
+    image = std::move(grown);
+    bin.resize(size.width, size.height);
+
+    // The texture has to be recreated at the new size.
+    dirtyTop = 0;
+    dirtyBottom = size.height;
+
+    return true;
+}
+
 void GlyphAtlas::removeGlyphValues(GlyphRequestor& requestor, std::map<GlyphID, GlyphValue>& values) {
     for (auto it = values.begin(); it != values.end(); it++) {
         GlyphValue& value = it->second;
-        if (value.ids.erase(&requestor) && value.ids.empty() && value.rect) {
+        if (value.ids.erase(&requestor) && value.ids.empty() && value.rect && !value.resident) {
             const Rect<uint16_t>& rect = *value.rect;
 
             // Clear out the bitmap.
@@ -247,11 +371,14 @@ Size GlyphAtlas::getSize() const {
 void GlyphAtlas::upload(gl::Context& context, gl::TextureUnit unit) {
     if (!texture) {
         texture = context.createTexture(image, unit);
-    } else if (dirty) {
+    } else if (texture->size != image.size) {
         context.updateTexture(*texture, image, unit);
+    } else if (dirtyTop < dirtyBottom) {
+        context.updateTextureRows(*texture, image, dirtyTop, dirtyBottom - dirtyTop, unit);
     }
-    
-    dirty = false;
+
+    dirtyTop = image.size.height;
+    dirtyBottom = 0;
 }
 
 void GlyphAtlas::bind(gl::Context& context, gl::TextureUnit unit) {
@@ -3,7 +3,10 @@
 #include <mbgl/text/glyph.hpp>
 #include <mbgl/text/glyph_atlas_observer.hpp>
 #include <mbgl/text/glyph_range.hpp>
-#include <mbgl/geometry/binpack.hpp>
+#include <mbgl/text/glyph_store.hpp>
+#include <mbgl/text/local_glyph_rasterizer.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/geometry/shelf_pack.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/font_stack.hpp>
@@ -12,6 +15,7 @@
 #include <mbgl/gl/texture.hpp>
 #include <mbgl/gl/object.hpp>
 
+#include <mutex>
 #include <string>
 #include <unordered_set>
 #include <unordered_map>
@@ -32,10 +36,30 @@ class GlyphRequestor {
 public:
     virtual void onGlyphsAvailable(GlyphPositionMap) = 0;
 };
+
+// Positions of the glyphs that the atlas keeps for as long as it exists, because more than one
+// tile used them. Workers look their glyphs up here first, so that a tile with only common glyphs
+// doesn't wait for the atlas to answer on the main thread. It may be used from any thread.
+class ResidentGlyphs : private util::noncopyable {
+public:
+    // Copies the positions of the resident glyphs among the given ones, and returns the others.
+    GlyphIDs find(const FontStack&, const GlyphIDs&, GlyphPositions&) const;
+    void add(const FontStack&, GlyphID, const Glyph&);
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<FontStack, std::map<GlyphID, Glyph>, FontStackHash> positions;
+};
     
 class GlyphAtlas : public util::noncopyable {
 public:
-    GlyphAtlas(Size, FileSource&);
+    // The atlas starts out at the given size, and doubles in size whenever it fills up until it
+    // reaches the maximum size. Glyphs keep their position when it grows. Glyphs that the local
+    // rasterizer can draw aren't requested from the FileSource.
+    GlyphAtlas(Size,
+               FileSource&,
+               std::unique_ptr<LocalGlyphRasterizer> = std::make_unique<LocalGlyphRasterizer>(),
+               Size maximumSize = { 2048, 2048 });
     ~GlyphAtlas();
 
     // Workers send a `getGlyphs` message to the main thread once they have determined
@@ -50,30 +74,50 @@ public:
     void getGlyphs(GlyphRequestor&, GlyphDependencies);
     void removeGlyphs(GlyphRequestor&);
 
-    void setURL(const std::string& url) {
-        glyphURL = url;
+    void setURL(const std::string& url);
+
+    // The shapings of text drawn with the glyphs of this atlas, which tile workers share. A new
+    // cache is made whenever the glyph URL changes.
+    std::shared_ptr<ShapingCache> getShapingCache() const {
+        return shapingCache;
     }
 
+    std::shared_ptr<const ResidentGlyphs> getResidentGlyphs() const {
+        return residentGlyphs;
+    }
+
+    // At most this many glyphs become resident, so that they don't fill the atlas.
+    static constexpr std::size_t maximumResidentGlyphs = 1024;
+
     void setObserver(GlyphAtlasObserver*);
 
     // Binds the atlas texture to the GPU, and uploads data if it is out of date.
     void bind(gl::Context&, gl::TextureUnit unit);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // the texture is only bound when the data is out of date (=dirty). Only the rows that glyphs
+    // were added to since the last upload are sent, unless the atlas has grown.
     void upload(gl::Context&, gl::TextureUnit unit);
 
     Size getSize() const;
 
 private:
     FileSource& fileSource;
+    std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer;
     std::string glyphURL;
+    std::shared_ptr<ShapingCache> shapingCache;
+    std::shared_ptr<ResidentGlyphs> residentGlyphs;
+    std::size_t residentGlyphCount = 0;
 
     struct GlyphValue {
-        AlphaImage bitmap;
-        GlyphMetrics metrics;
+        // Points into the glyphs of the range held by the GlyphStore, unless the glyph was
+        // rasterized locally.
+        std::shared_ptr<const SDFGlyph> glyph;
         optional<Rect<uint16_t>> rect;
         std::unordered_set<GlyphRequestor*> ids;
+
+        // Kept in the atlas even when no requestor uses it anymore.
+        bool resident = false;
     };
 
     struct GlyphRequest {
@@ -91,18 +135,26 @@ private:
 
     GlyphRequest& requestRange(Entry&, const FontStack&, const GlyphRange&);
     void processResponse(const Response&, const FontStack&, const GlyphRange&);
+    bool addRange(Entry&, const FontStack&, const std::shared_ptr<const GlyphStore::Glyphs>&);
+    void rangeLoaded(GlyphRequest&, const FontStack&, const GlyphRange&);
 
     void addGlyphs(GlyphRequestor&, const GlyphDependencies&);
     Rect<uint16_t> addGlyph(GlyphValue&);
+    bool grow();
 
     void removeGlyphValues(GlyphRequestor&, std::map<GlyphID, GlyphValue>&);
     void removePendingRanges(GlyphRequestor&, std::map<GlyphRange, GlyphRequest>&);
 
     GlyphAtlasObserver* observer = nullptr;
 
-    BinPack<uint16_t> bin;
+    const Size maximumSize;
+    ShelfPack<uint16_t> bin;
     AlphaImage image;
-    bool dirty;
+
+    // The rows of the image that changed since the last upload, from the first to the last.
+    uint32_t dirtyTop;
+    uint32_t dirtyBottom;
+
     mbgl::optional<gl::Texture> texture;
 };
 
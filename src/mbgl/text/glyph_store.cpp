@@ -0,0 +1,92 @@
+#include <mbgl/text/glyph_store.hpp>
+
+#include <functional>
+#include <iterator>
+
+namespace mbgl {
+
+GlyphStore& GlyphStore::get() {
+    static GlyphStore store;
+    return store;
+}
+
+std::shared_ptr<const GlyphStore::Glyphs> GlyphStore::find(const std::string& url, const FontStack& fontStack, const GlyphRange& range) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(Key { url, fontStack, range });
+    if (it == entries.end()) {
+        return nullptr;
+    }
+
+    auto glyphs = it->second.glyphs.lock();
+    if (!glyphs) {
+        entries.erase(it);
+    }
+    return glyphs;
+}
+
+std::shared_ptr<const GlyphStore::Glyphs> GlyphStore::add(const std::string& url, const FontStack& fontStack, const GlyphRange& range, const std::string& data) {
+    Key key { url, fontStack, range };
+    const std::size_t dataHash = std::hash<std::string>()(data);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second.dataHash == dataHash) {
+            if (auto glyphs = it->second.glyphs.lock()) {
+                return glyphs;
+            }
+        }
+    }
+
+    // Parse without holding the lock, so that maps loading other ranges don't have to wait.
+    auto glyphs = std::make_shared<Glyphs>();
+    for (auto& glyph : parseGlyphPBF(range, data)) {
+        const GlyphID id = glyph.id;
+        glyphs->emplace(id, std::move(glyph));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Forget the ranges that are no longer used.
+    for (auto it = entries.begin(); it != entries.end();) {
+        it = it->second.glyphs.expired() ? entries.erase(it) : std::next(it);
+    }
+
+    Entry& entry = entries[std::move(key)];
+    if (entry.dataHash == dataHash) {
+        // Another map added the same data in the meantime.
+        if (auto existing = entry.glyphs.lock()) {
+            return existing;
+        }
+    }
+
+    // Glyphs of newer data replace the old ones, but atlases that still reference the old
+    // glyphs keep them alive.
+    entry.glyphs = glyphs;
+    if (entry.preloaded) {
+        entry.preloaded = glyphs;
+    }
+    entry.dataHash = dataHash;
+    return std::move(glyphs);
+}
+
+void GlyphStore::preload(const std::string& url, const FontStack& fontStack, const GlyphRange& range, const std::string& data) {
+    auto glyphs = add(url, fontStack, range, data);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(Key { url, fontStack, range });
+    if (it != entries.end() && it->second.glyphs.lock() == glyphs) {
+        it->second.preloaded = std::move(glyphs);
+    }
+}
+
+void GlyphStore::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = entries.begin(); it != entries.end();) {
+        it->second.preloaded = nullptr;
+        it = it->second.glyphs.expired() ? entries.erase(it) : std::next(it);
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/text/glyph_range.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace mbgl {
+
+// Parsed glyph ranges, shared by the glyph atlases of all maps in the process. An atlas that
+// needs a range that another atlas already holds on to references the same glyphs instead of
+// requesting and parsing the PBF again. Ranges are dropped once no atlas references them,
+// unless they were preloaded.
+//
+// The store may be used from any thread.
+class GlyphStore : private util::noncopyable {
+public:
+    // The glyphs of one range of a font stack, by ID. Stored glyphs are never modified.
+    using Glyphs = std::map<GlyphID, SDFGlyph>;
+
+    static GlyphStore& get();
+
+    // Returns the glyphs of the range loaded from the glyph URL template, or nullptr if no atlas
+    // holds on to them and they weren't preloaded.
+    std::shared_ptr<const Glyphs> find(const std::string& url, const FontStack&, const GlyphRange&);
+
+    // Returns the glyphs of the given glyph PBF. The PBF is only parsed if the store doesn't hold
+    // on to the glyphs of the same data yet. Throws if the data is malformed.
+    std::shared_ptr<const Glyphs> add(const std::string& url, const FontStack&, const GlyphRange&, const std::string& data);
+
+    // Adds the glyphs of the given glyph PBF, and keeps them until the store is cleared even if
+    // no atlas references them.
+    void preload(const std::string& url, const FontStack&, const GlyphRange&, const std::string& data);
+
+    // Drops the preloaded ranges. Glyphs still referenced by an atlas are not affected.
+    void clear();
+
+private:
+    using Key = std::tuple<std::string, FontStack, GlyphRange>;
+
+    struct Entry {
+        std::weak_ptr<const Glyphs> glyphs;
+        std::shared_ptr<const Glyphs> preloaded;
+
+        // Hash of the PBF the glyphs were parsed from.
+        std::size_t dataHash = 0;
+    };
+
+    std::mutex mutex;
+    std::map<Key, Entry> entries;
+};
+
+} // namespace mbgl
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+// Draws glyphs with a font installed on the device instead of downloading their glyph range.
+// This is worthwhile for scripts with a large number of characters that all share one advance,
+// such as CJK ideographs, where a single label can touch many ranges.
+//
+// Each platform implements the rasterizer in terms of its font APIs; the default implementation
+// doesn't rasterize any glyphs. Local rasterization is disabled unless a font family is given.
+class LocalGlyphRasterizer : private util::noncopyable {
+public:
+    // Metrics of all locally rasterized glyphs, matching a 24px glyph PBF.
+    static constexpr const uint32_t glyphSize = 24;
+    static constexpr const int32_t glyphTop = -1;
+
+    explicit LocalGlyphRasterizer(const optional<std::string> fontFamily = {});
+    ~LocalGlyphRasterizer();
+
+    // Whether the glyph is rasterized locally rather than loaded from the glyph range.
+    bool canRasterizeGlyph(const FontStack&, GlyphID);
+
+    // Returns the signed distance field of the glyph, with the same border and metrics layout as
+    // glyphs parsed from a glyph PBF. Returns a glyph without a bitmap if the font doesn't
+    // contain the character.
+    SDFGlyph rasterizeGlyph(const FontStack&, GlyphID);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace mbgl
@@ -1,7 +1,31 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 namespace mbgl {
 
+class CollisionBox;
+
+// The collision boxes an adjacent tile of the same zoom level placed near its edges. Symbols in
+// a tile are placed around the symbols its neighbours show, so that labels don't overlap or
+// repeat at tile seams.
+class NeighbourCollisionBoxes {
+public:
+    // Position of the neighbour relative to the tile, in tiles.
+    int8_t dx;
+    int8_t dy;
+
+    // In the coordinates of the neighbour. Compared by identity: placing a tile again only yields
+    // new boxes if they changed.
+    std::shared_ptr<const std::vector<CollisionBox>> boxes;
+
+    bool operator==(const NeighbourCollisionBoxes& rhs) const {
+        return dx == rhs.dx && dy == rhs.dy && boxes == rhs.boxes;
+    }
+};
+
 class PlacementConfig {
 public:
     PlacementConfig(float angle_ = 0, float pitch_ = 0, bool debug_ = false)
@@ -9,7 +33,8 @@ public:
     }
 
     bool operator==(const PlacementConfig& rhs) const {
-        return angle == rhs.angle && pitch == rhs.pitch && debug == rhs.debug;
+        return angle == rhs.angle && pitch == rhs.pitch && debug == rhs.debug &&
+               neighbours == rhs.neighbours;
     }
 
     bool operator!=(const PlacementConfig& rhs) const {
@@ -20,6 +45,7 @@ public:
     float angle;
     float pitch;
     bool debug;
+    std::vector<NeighbourCollisionBoxes> neighbours;
 };
 
 } // namespace mbgl
@@ -84,7 +84,8 @@ float determineAverageLineWidth(const std::u16string& logicalInput,
 }
 
 float calculateBadness(const float lineWidth, const float targetWidth, const float penalty, const bool isLastBreak) {
-    const float raggedness = std::pow(lineWidth - targetWidth, 2);
+    const double deviation = lineWidth - targetWidth;
+    const float raggedness = deviation * deviation;
     if (isLastBreak) {
         // Favor finals lines shorter than average over longer than average
         if (lineWidth < targetWidth) {
@@ -94,9 +95,9 @@ float calculateBadness(const float lineWidth, const float targetWidth, const flo
         }
     }
     if (penalty < 0) {
-        return raggedness - std::pow(penalty, 2);
+        return raggedness - double(penalty) * penalty;
     }
-    return raggedness + std::pow(penalty, 2);
+    return raggedness + double(penalty) * penalty;
 }
 
 float calculatePenalty(char16_t codePoint, char16_t nextCodePoint) {
@@ -118,57 +119,60 @@ float calculatePenalty(char16_t codePoint, char16_t nextCodePoint) {
     return penalty;
 }
 
+static bool isWhitespace(char16_t chr) {
+    return chr == u' ' || chr == u'\t' || chr == u'\n' || chr == u'\v' || chr == u'\f' || chr == u'\r';
+}
+
 struct PotentialBreak {
-    PotentialBreak(const std::size_t p_index, const float p_x, const PotentialBreak* p_priorBreak, const float p_badness)
-    : index(p_index), x(p_x), priorBreak(p_priorBreak), badness(p_badness)
-    {}
-    
-    const std::size_t index;
-    const float x;
-    const PotentialBreak* priorBreak;
-    const float badness;
+    std::size_t index;
+    float x;
+    // The position of the best break before this one among the potential breaks, or -1 if the
+    // line that ends here is the first one.
+    int32_t priorBreak;
+    float badness;
 };
 
-
-PotentialBreak evaluateBreak(const std::size_t breakIndex, const float breakX, const float targetWidth, const std::list<PotentialBreak>& potentialBreaks, const float penalty, const bool isLastBreak) {
+PotentialBreak evaluateBreak(const std::size_t breakIndex, const float breakX, const float targetWidth, const std::vector<PotentialBreak>& potentialBreaks, const float penalty, const bool isLastBreak) {
     // We could skip evaluating breaks where the line length (breakX - priorBreak.x) > maxWidth
     //  ...but in fact we allow lines longer than maxWidth (if there's no break points)
     //  ...and when targetWidth and maxWidth are close, strictly enforcing maxWidth can give
     //     more lopsided results.
     
-    const PotentialBreak* bestPriorBreak = nullptr;
+    int32_t bestPriorBreak = -1;
     float bestBreakBadness = calculateBadness(breakX, targetWidth, penalty, isLastBreak);
-    for (const auto& potentialBreak : potentialBreaks) {
+    for (std::size_t i = 0; i < potentialBreaks.size(); i++) {
+        const PotentialBreak& potentialBreak = potentialBreaks[i];
         const float lineWidth = breakX - potentialBreak.x;
         float breakBadness =
         calculateBadness(lineWidth, targetWidth, penalty, isLastBreak) + potentialBreak.badness;
         if (breakBadness <= bestBreakBadness) {
-            bestPriorBreak = &potentialBreak;
+            bestPriorBreak = static_cast<int32_t>(i);
             bestBreakBadness = breakBadness;
         }
     }
     
-    return PotentialBreak(breakIndex, breakX, bestPriorBreak, bestBreakBadness);
+    return { breakIndex, breakX, bestPriorBreak, bestBreakBadness };
 }
 
-std::set<std::size_t> leastBadBreaks(const PotentialBreak& lastLineBreak) {
-    std::set<std::size_t> leastBadBreaks = { lastLineBreak.index };
-    const PotentialBreak* priorBreak = lastLineBreak.priorBreak;
-    while (priorBreak) {
-        leastBadBreaks.insert(priorBreak->index);
-        priorBreak = priorBreak->priorBreak;
+std::vector<std::size_t> leastBadBreaks(const PotentialBreak& lastLineBreak, const std::vector<PotentialBreak>& potentialBreaks) {
+    std::vector<std::size_t> leastBadBreaks = { lastLineBreak.index };
+    for (int32_t priorBreak = lastLineBreak.priorBreak; priorBreak >= 0;
+         priorBreak = potentialBreaks[priorBreak].priorBreak) {
+        leastBadBreaks.push_back(potentialBreaks[priorBreak].index);
     }
+    // Prior breaks come before the break they lead to, so the indices are unique.
+    std::reverse(leastBadBreaks.begin(), leastBadBreaks.end());
     return leastBadBreaks;
 }
 
 
 // We determine line breaks based on shaped text in logical order. Working in visual order would be
 //  more intuitive, but we can't do that because the visual order may be changed by line breaks!
-std::set<std::size_t> determineLineBreaks(const std::u16string& logicalInput,
-                                          const float spacing,
-                                          float maxWidth,
-                                          const WritingModeType writingMode,
-                                          const GlyphPositions& glyphs) {
+std::vector<std::size_t> determineLineBreaks(const std::u16string& logicalInput,
+                                             const float spacing,
+                                             float maxWidth,
+                                             const WritingModeType writingMode,
+                                             const GlyphPositions& glyphs) {
     if (!maxWidth || writingMode != WritingModeType::Horizontal) {
         return {};
     }
@@ -179,27 +183,26 @@ std::set<std::size_t> determineLineBreaks(const std::u16string& logicalInput,
     
     const float targetWidth = determineAverageLineWidth(logicalInput, spacing, maxWidth, glyphs);
     
-    std::list<PotentialBreak> potentialBreaks;
+    std::vector<PotentialBreak> potentialBreaks;
     float currentX = 0;
     
     for (std::size_t i = 0; i < logicalInput.size(); i++) {
         const char16_t codePoint = logicalInput[i];
         auto it = glyphs.find(codePoint);
-        if (it != glyphs.end() && it->second && !boost::algorithm::is_any_of(u" \t\n\v\f\r")(codePoint)) {
+        if (it != glyphs.end() && it->second && !isWhitespace(codePoint)) {
             currentX += it->second->metrics.advance + spacing;
         }
         
         // Ideographic characters, spaces, and word-breaking punctuation that often appear without
         // surrounding spaces.
-        if ((i < logicalInput.size() - 1) &&
-            (util::i18n::allowsWordBreaking(codePoint) || util::i18n::allowsIdeographicBreaking(codePoint))) {
+        if ((i < logicalInput.size() - 1) && util::i18n::allowsLineBreaking(codePoint)) {
             potentialBreaks.push_back(evaluateBreak(i+1, currentX, targetWidth, potentialBreaks,
                                                     calculatePenalty(codePoint, logicalInput[i+1]),
                                                     false));
         }
     }
     
-    return leastBadBreaks(evaluateBreak(logicalInput.size(), currentX, targetWidth, potentialBreaks, 0, true));
+    return leastBadBreaks(evaluateBreak(logicalInput.size(), currentX, targetWidth, potentialBreaks, 0, true), potentialBreaks);
 }
 
 void shapeLines(Shaping& shaping,
@@ -224,7 +227,7 @@ void shapeLines(Shaping& shaping,
     
     for (std::u16string line : lines) {
         // Collapse whitespace so it doesn't throw off justification
-        boost::algorithm::trim_if(line, boost::algorithm::is_any_of(u" \t\n\v\f\r"));
+        boost::algorithm::trim_if(line, isWhitespace);
         
         if (line.empty()) {
             y += lineHeight; // Still need a line feed after empty line
@@ -57,4 +57,12 @@ const Shaping getShaping(const std::u16string& string,
                          BiDi& bidi,
                          const GlyphPositions& glyphs);
 
+// Returns the positions in the logical string at which the lines of horizontal text that fits
+// maxWidth break, or none for other text. Exposed for benchmarks.
+std::vector<std::size_t> determineLineBreaks(const std::u16string& logicalInput,
+                                             float spacing,
+                                             float maxWidth,
+                                             const WritingModeType,
+                                             const GlyphPositions& glyphs);
+
 } // namespace mbgl
@@ -0,0 +1,83 @@
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/text/shaping.hpp>
+
+#include <tuple>
+
+namespace mbgl {
+
+bool ShapingCache::Key::operator<(const Key& other) const {
+    return std::tie(text, fontStack, maxWidth, lineHeight, horizontalAlign, verticalAlign,
+                    justify, spacing, translate.x, translate.y, verticalHeight, writingMode) <
+        std::tie(other.text, other.fontStack, other.maxWidth, other.lineHeight,
+                 other.horizontalAlign, other.verticalAlign, other.justify, other.spacing,
+                 other.translate.x, other.translate.y, other.verticalHeight, other.writingMode);
+}
+
+ShapingCache::ShapingCache(std::size_t maximumShapings_)
+    : maximumShapings(maximumShapings_) {
+}
+
+std::shared_ptr<const Shaping> ShapingCache::find(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    order.splice(order.begin(), order, it->second.position);
+    stats.hits++;
+    return it->second.shaping;
+}
+
+void ShapingCache::add(Key key, std::shared_ptr<const Shaping> shaping) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (maximumShapings == 0) {
+        return;
+    }
+
+    auto result = entries.emplace(std::move(key), Entry { std::move(shaping), {} });
+    if (!result.second) {
+        // Another worker shaped the same text in the meantime.
+        return;
+    }
+
+    order.push_front(&result.first->first);
+    result.first->second.position = order.begin();
+    stats.shapings++;
+
+    while (stats.shapings > maximumShapings) {
+        entries.erase(*order.back());
+        order.pop_back();
+        stats.shapings--;
+        stats.evictions++;
+    }
+}
+
+std::shared_ptr<const Shaping> ShapingCache::getShaping(Key key, BiDi& bidi, const GlyphPositions& glyphs) {
+    if (auto shaping = find(key)) {
+        return shaping;
+    }
+
+    auto shaping = std::make_shared<const Shaping>(mbgl::getShaping(
+        key.text, key.maxWidth, key.lineHeight, key.horizontalAlign, key.verticalAlign,
+        key.justify, key.spacing, key.translate, key.verticalHeight, key.writingMode, bidi, glyphs));
+
+    for (const char16_t chr : key.text) {
+        if (glyphs.find(chr) == glyphs.end()) {
+            return shaping;
+        }
+    }
+
+    add(std::move(key), shaping);
+    return shaping;
+}
+
+ShapingCache::Stats ShapingCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+} // namespace mbgl
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/geometry.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace mbgl {
+
+class BiDi;
+
+// Shapings of label text, shared by the workers of all tiles of a style. Labels like road names
+// repeat across many tiles and zoom levels, and would otherwise be broken into lines and reordered
+// again for each of them. The least recently used shapings are dropped once the cache holds the
+// maximum number of them.
+//
+// Shaping only depends on the metrics of the glyphs, which don't change for a font stack as long
+// as the style's glyph URL stays the same. It may be used from any thread.
+class ShapingCache : private util::noncopyable {
+public:
+    class Key {
+    public:
+        std::u16string text;
+        FontStack fontStack;
+        float maxWidth;
+        float lineHeight;
+        float horizontalAlign;
+        float verticalAlign;
+        float justify;
+        float spacing;
+        Point<float> translate;
+        float verticalHeight;
+        WritingModeType writingMode;
+
+        bool operator<(const Key&) const;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+
+        std::size_t shapings = 0;
+    };
+
+    explicit ShapingCache(std::size_t maximumShapings = 4096);
+
+    std::shared_ptr<const Shaping> find(const Key&);
+    void add(Key, std::shared_ptr<const Shaping>);
+
+    // Returns the cached shaping of the text, or shapes it and caches the result. Text with
+    // glyphs that haven't been loaded yet is shaped without being cached.
+    std::shared_ptr<const Shaping> getShaping(Key, BiDi&, const GlyphPositions&);
+
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const Shaping> shaping;
+        std::list<const Key*>::iterator position;
+    };
+
+    const std::size_t maximumShapings;
+
+    mutable std::mutex mutex;
+
+    std::map<Key, Entry> entries;
+
+    // The keys of the entries, most recently used first.
+    std::list<const Key*> order;
+    Stats stats;
+};
+
+} // namespace mbgl
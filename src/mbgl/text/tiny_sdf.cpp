@@ -0,0 +1,100 @@
+#include <mbgl/text/tiny_sdf.hpp>
+#include <mbgl/math/clamp.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+const double INF = 1e20;
+
+// 1D squared distance transform of the sampled function f, after Felzenszwalb & Huttenlocher,
+// "Distance Transforms of Sampled Functions".
+void edt1d(const std::vector<double>& f, std::vector<double>& d, std::vector<int>& v,
+           std::vector<double>& z, int n) {
+    v[0] = 0;
+    z[0] = -INF;
+    z[1] = INF;
+
+    for (int q = 1, k = 0; q < n; q++) {
+        double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = INF;
+    }
+
+    for (int q = 0, k = 0; q < n; q++) {
+        while (z[k + 1] < q) {
+            k++;
+        }
+        d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+    }
+}
+
+// 2D squared distance transform of the grid, in place: columns first, then rows.
+void edt(std::vector<double>& grid, int width, int height) {
+    const int n = std::max(width, height);
+    std::vector<double> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            f[y] = grid[y * width + x];
+        }
+        edt1d(f, d, v, z, height);
+        for (int y = 0; y < height; y++) {
+            grid[y * width + x] = d[y];
+        }
+    }
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            f[x] = grid[y * width + x];
+        }
+        edt1d(f, d, v, z, width);
+        for (int x = 0; x < width; x++) {
+            grid[y * width + x] = d[x];
+        }
+    }
+}
+
+} // namespace
+
+AlphaImage transformRasterToSDF(const AlphaImage& raster, double radius, double cutoff) {
+    const int width = raster.size.width;
+    const int height = raster.size.height;
+    const std::size_t area = raster.size.area();
+
+    // Squared distances to the nearest pixel outside and inside of the glyph. Partially covered
+    // pixels are treated as being that far from the edge.
+    std::vector<double> gridOuter(area);
+    std::vector<double> gridInner(area);
+    for (std::size_t i = 0; i < area; i++) {
+        const double a = raster.data[i] / 255.0;
+        gridOuter[i] = a == 1 ? 0 : a == 0 ? INF : std::pow(std::max(0.0, 0.5 - a), 2);
+        gridInner[i] = a == 1 ? INF : a == 0 ? 0 : std::pow(std::max(0.0, a - 0.5), 2);
+    }
+
+    edt(gridOuter, width, height);
+    edt(gridInner, width, height);
+
+    AlphaImage sdf(raster.size);
+    for (std::size_t i = 0; i < area; i++) {
+        const double distance = std::sqrt(gridOuter[i]) - std::sqrt(gridInner[i]);
+        sdf.data[i] = static_cast<uint8_t>(util::clamp(std::round(255 - 255 * (distance / radius + cutoff)), 0.0, 255.0));
+    }
+
+    return sdf;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <mbgl/util/image.hpp>
+
+namespace mbgl {
+namespace util {
+
+// Turns the coverage of a rasterized glyph into a signed distance field of the same size, in the
+// encoding of the glyph PBFs: a value of 255 * (1 - cutoff) marks the edge of the glyph, and the
+// field falls off by 255 over the given radius in pixels.
+AlphaImage transformRasterToSDF(const AlphaImage& raster, double radius, double cutoff);
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,51 @@
+#include <mbgl/tile/feature_state.hpp>
+
+namespace mbgl {
+
+const PropertyMap* findFeatureState(const FeatureStateMap* states, const GeometryTileFeature& feature) {
+    if (!states || states->empty()) {
+        return nullptr;
+    }
+
+    const optional<FeatureIdentifier> id = feature.getID();
+    if (!id) {
+        return nullptr;
+    }
+
+    auto it = states->find(*id);
+    return it == states->end() ? nullptr : &it->second;
+}
+
+bool featureStatesDiffer(const GeometryTileLayer& layer, const FeatureStateMap* a, const FeatureStateMap* b) {
+    if (a == b) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < layer.featureCount(); i++) {
+        auto feature = layer.getFeature(i);
+        const PropertyMap* stateA = findFeatureState(a, *feature);
+        const PropertyMap* stateB = findFeatureState(b, *feature);
+        if (stateA != stateB && (!stateA || !stateB || *stateA != *stateB)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+optional<Value> FeatureWithState::getValue(const std::string& key) const {
+    auto it = state.find(key);
+    if (it != state.end()) {
+        return it->second;
+    }
+    return feature.getValue(key);
+}
+
+PropertyMap FeatureWithState::getProperties() const {
+    PropertyMap properties = feature.getProperties();
+    for (const auto& pair : state) {
+        properties[pair.first] = pair.second;
+    }
+    return properties;
+}
+
+} // namespace mbgl
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/feature.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+// The states of the features of a source layer, by feature identifier.
+using FeatureStateMap = std::map<FeatureIdentifier, PropertyMap>;
+
+// The feature states of a source, by the source layer that its style layers name. The states of
+// a layer are not modified once they are shared, so that comparing pointers tells which layers
+// changed.
+using FeatureStates = std::unordered_map<std::string, std::shared_ptr<const FeatureStateMap>>;
+
+// Returns the state of the feature, or nullptr if it has none.
+const PropertyMap* findFeatureState(const FeatureStateMap*, const GeometryTileFeature&);
+
+// Whether any feature of the layer has a different state in the two maps.
+bool featureStatesDiffer(const GeometryTileLayer&, const FeatureStateMap*, const FeatureStateMap*);
+
+// A feature whose state values are read in place of its properties of the same name.
+class FeatureWithState : public GeometryTileFeature {
+public:
+    FeatureWithState(const GeometryTileFeature& feature_, const PropertyMap& state_)
+        : feature(feature_), state(state_) {
+    }
+
+    FeatureType getType() const override { return feature.getType(); }
+    optional<Value> getValue(const std::string& key) const override;
+    PropertyMap getProperties() const override;
+    optional<FeatureIdentifier> getID() const override { return feature.getID(); }
+    GeometryCollection getGeometries() const override { return feature.getGeometries(); }
+    void readGeometries(GeometryCollection& result) const override { feature.readGeometries(result); }
+
+private:
+    const GeometryTileFeature& feature;
+    const PropertyMap& state;
+};
+
+} // namespace mbgl
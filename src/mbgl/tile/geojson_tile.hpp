@@ -19,9 +19,7 @@ public:
 
     void setNecessity(Necessity) final;
     
-    void querySourceFeatures(
-        std::vector<Feature>& result,
-        const style::SourceQueryOptions&) override;
+    std::vector<std::string> getSourceQueryLayers(const style::SourceQueryOptions&) const override;
 };
 
 } // namespace mbgl
@@ -0,0 +1,183 @@
+#include <mbgl/tile/geojson_tile_data.hpp>
+
+namespace mbgl {
+
+namespace {
+
+// Appends a feature's geometry as the rings that ToGeometryCollection would convert it to.
+class GeometryEncoder {
+public:
+    std::vector<uint32_t>& ringEnds;
+    std::vector<GeometryCoordinate>& points;
+
+    template <class Points>
+    void ring(const Points& ring_) {
+        for (const auto& point : ring_) {
+            points.emplace_back(point.x, point.y);
+        }
+        ringEnds.push_back(points.size());
+    }
+
+    void operator()(const mapbox::geometry::point<int16_t>& geom) {
+        points.emplace_back(geom.x, geom.y);
+        ringEnds.push_back(points.size());
+    }
+    void operator()(const mapbox::geometry::multi_point<int16_t>& geom) {
+        ring(geom);
+    }
+    void operator()(const mapbox::geometry::line_string<int16_t>& geom) {
+        ring(geom);
+    }
+    void operator()(const mapbox::geometry::multi_line_string<int16_t>& geom) {
+        for (const auto& line : geom) {
+            ring(line);
+        }
+    }
+    void operator()(const mapbox::geometry::polygon<int16_t>& geom) {
+        for (const auto& ring_ : geom) {
+            ring(ring_);
+        }
+    }
+    void operator()(const mapbox::geometry::multi_polygon<int16_t>& geom) {
+        for (const auto& polygon : geom) {
+            for (const auto& ring_ : polygon) {
+                ring(ring_);
+            }
+        }
+    }
+    void operator()(const mapbox::geometry::geometry_collection<int16_t>&) {
+    }
+};
+
+} // namespace
+
+GeoJSONTileEncoding::GeoJSONTileEncoding(const mapbox::geometry::feature_collection<int16_t>& features) {
+    types.reserve(features.size());
+    ids.reserve(features.size());
+    featureRingEnds.reserve(features.size());
+    featurePropertyEnds.reserve(features.size());
+
+    GeometryEncoder encoder { ringEnds, points };
+    for (const auto& feature : features) {
+        types.push_back(apply_visitor(ToFeatureType(), feature.geometry));
+        ids.push_back(feature.id);
+
+        apply_visitor(encoder, feature.geometry);
+        featureRingEnds.push_back(ringEnds.size());
+
+        for (const auto& property : feature.properties) {
+            auto it = keyIndices.find(property.first);
+            if (it == keyIndices.end()) {
+                it = keyIndices.emplace(property.first, keys.size()).first;
+                keys.push_back(property.first);
+            }
+            propertyKeys.push_back(it->second);
+            propertyValues.push_back(property.second);
+        }
+        featurePropertyEnds.push_back(propertyKeys.size());
+    }
+}
+
+std::size_t GeoJSONTileEncoding::getByteSize() const {
+    std::size_t size = types.size() * sizeof(FeatureType) +
+        ids.size() * sizeof(optional<FeatureIdentifier>) +
+        (featureRingEnds.size() + ringEnds.size() + featurePropertyEnds.size() + propertyKeys.size()) * sizeof(uint32_t) +
+        points.size() * sizeof(GeometryCoordinate) +
+        propertyValues.size() * sizeof(Value);
+    for (const auto& key : keys) {
+        size += key.size();
+    }
+    return size;
+}
+
+GeoJSONTileFeature::GeoJSONTileFeature(const GeoJSONTileEncoding& encoding_, std::size_t index_)
+    : encoding(encoding_),
+      index(index_) {
+}
+
+FeatureType GeoJSONTileFeature::getType() const {
+    return encoding.types[index];
+}
+
+PropertyMap GeoJSONTileFeature::getProperties() const {
+    PropertyMap properties;
+    const uint32_t begin = index ? encoding.featurePropertyEnds[index - 1] : 0;
+    const uint32_t end = encoding.featurePropertyEnds[index];
+    for (uint32_t i = begin; i < end; i++) {
+        properties.emplace(encoding.keys[encoding.propertyKeys[i]], encoding.propertyValues[i]);
+    }
+    return properties;
+}
+
+optional<FeatureIdentifier> GeoJSONTileFeature::getID() const {
+    return encoding.ids[index];
+}
+
+GeometryCollection GeoJSONTileFeature::getGeometries() const {
+    GeometryCollection geometry;
+    const uint32_t begin = index ? encoding.featureRingEnds[index - 1] : 0;
+    const uint32_t end = encoding.featureRingEnds[index];
+    geometry.reserve(end - begin);
+    for (uint32_t ring = begin; ring < end; ring++) {
+        const uint32_t first = ring ? encoding.ringEnds[ring - 1] : 0;
+        geometry.emplace_back(encoding.points.begin() + first,
+                              encoding.points.begin() + encoding.ringEnds[ring]);
+    }
+
+    // https://github.com/mapbox/geojson-vt-cpp/issues/44
+    if (getType() == FeatureType::Polygon) {
+        geometry = fixupPolygons(geometry);
+    }
+
+    return geometry;
+}
+
+optional<Value> GeoJSONTileFeature::getValue(const std::string& key) const {
+    auto it = encoding.keyIndices.find(key);
+    if (it == encoding.keyIndices.end()) {
+        return {};
+    }
+
+    const uint32_t begin = index ? encoding.featurePropertyEnds[index - 1] : 0;
+    const uint32_t end = encoding.featurePropertyEnds[index];
+    for (uint32_t i = begin; i < end; i++) {
+        if (encoding.propertyKeys[i] == it->second) {
+            return encoding.propertyValues[i];
+        }
+    }
+    return {};
+}
+
+GeoJSONTileData::GeoJSONTileData(const mapbox::geometry::feature_collection<int16_t>& features)
+    : encoding(std::make_shared<GeoJSONTileEncoding>(features)) {
+}
+
+GeoJSONTileData::GeoJSONTileData(std::shared_ptr<const GeoJSONTileEncoding> encoding_)
+    : encoding(std::move(encoding_)) {
+}
+
+std::unique_ptr<GeometryTileData> GeoJSONTileData::clone() const {
+    return std::make_unique<GeoJSONTileData>(encoding);
+}
+
+const GeometryTileLayer* GeoJSONTileData::getLayer(const std::string&) const {
+    return this;
+}
+
+std::size_t GeoJSONTileData::getByteSize() const {
+    return encoding->getByteSize();
+}
+
+std::string GeoJSONTileData::getName() const {
+    return "";
+}
+
+std::size_t GeoJSONTileData::featureCount() const {
+    return encoding->featureCount();
+}
+
+std::unique_ptr<GeometryTileFeature> GeoJSONTileData::getFeature(std::size_t i) const {
+    return std::make_unique<GeoJSONTileFeature>(*encoding, i);
+}
+
+} // namespace mbgl
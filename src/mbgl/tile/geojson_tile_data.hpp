@@ -0,0 +1,79 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+// The features of a GeoJSON tile, encoded once into flat arrays rather than kept as a collection
+// of features that each own their geometry and property map: the points of all rings, the ends of
+// the rings and of the features' rings, and the features' property values alongside indices
+// into a table of the tile's distinct keys. The encoding is immutable, so the tile and its worker
+// share it, and copies of GeoJSONTileData are free.
+class GeoJSONTileEncoding {
+public:
+    explicit GeoJSONTileEncoding(const mapbox::geometry::feature_collection<int16_t>&);
+
+    std::size_t featureCount() const { return types.size(); }
+    std::size_t getByteSize() const;
+
+private:
+    friend class GeoJSONTileFeature;
+
+    std::vector<FeatureType> types;
+    std::vector<optional<FeatureIdentifier>> ids;
+
+    // The ends of each feature's rings in `ringEnds`, and of each ring's points in `points`.
+    std::vector<uint32_t> featureRingEnds;
+    std::vector<uint32_t> ringEnds;
+    std::vector<GeometryCoordinate> points;
+
+    // The ends of each feature's properties in `propertyKeys` and `propertyValues`. The keys
+    // are indices into `keys`.
+    std::vector<uint32_t> featurePropertyEnds;
+    std::vector<uint32_t> propertyKeys;
+    std::vector<Value> propertyValues;
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, uint32_t> keyIndices;
+};
+
+class GeoJSONTileFeature : public GeometryTileFeature {
+public:
+    GeoJSONTileFeature(const GeoJSONTileEncoding&, std::size_t index);
+
+    FeatureType getType() const override;
+    PropertyMap getProperties() const override;
+    optional<FeatureIdentifier> getID() const override;
+    GeometryCollection getGeometries() const override;
+    optional<Value> getValue(const std::string& key) const override;
+
+private:
+    const GeoJSONTileEncoding& encoding;
+    const std::size_t index;
+};
+
+// A GeoJSON tile can only have one layer, and it is always returned regardless of which layer is
+// requested.
+class GeoJSONTileData : public GeometryTileData,
+                        public GeometryTileLayer {
+public:
+    explicit GeoJSONTileData(const mapbox::geometry::feature_collection<int16_t>&);
+    explicit GeoJSONTileData(std::shared_ptr<const GeoJSONTileEncoding>);
+
+    std::unique_ptr<GeometryTileData> clone() const override;
+    const GeometryTileLayer* getLayer(const std::string&) const override;
+    std::size_t getByteSize() const override;
+
+    std::string getName() const override;
+    std::size_t featureCount() const override;
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const override;
+
+private:
+    const std::shared_ptr<const GeoJSONTileEncoding> encoding;
+};
+
+} // namespace mbgl
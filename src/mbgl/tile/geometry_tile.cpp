@@ -19,6 +19,7 @@
 #include <mbgl/util/logging.hpp>
 
 #include <iostream>
+#include <unordered_set>
 
 namespace mbgl {
 
@@ -35,13 +36,17 @@ GeometryTile::GeometryTile(const OverscaledTileID& id_,
              ActorRef<GeometryTile>(*this, mailbox),
              id_,
              obsolete,
-             parameters.mode),
+             parameters.mode,
+             parameters.featurePicking,
+             parameters.multisampling,
+             parameters.style.glyphAtlas->getShapingCache(),
+             parameters.style.glyphAtlas->getResidentGlyphs()),
              glyphAtlas(*parameters.style.glyphAtlas) {
 }
 
 GeometryTile::~GeometryTile() {
     glyphAtlas.removeGlyphs(*this);
-    for (auto spriteAtlas : pendingSpriteAtlases) {
+    for (auto spriteAtlas : spriteAtlases) {
         spriteAtlas->removeRequestor(*this);
     }
     cancel();
@@ -55,7 +60,7 @@ void GeometryTile::setError(std::exception_ptr err) {
     observer->onTileError(*this, err);
 }
 
-void GeometryTile::setData(std::unique_ptr<const GeometryTileData> data_) {
+void GeometryTile::setData(std::shared_ptr<const GeometryTileData> data_) {
     // Mark the tile as pending again if it was complete before to prevent signaling a complete
     // state despite pending parse operations.
     if (availableData == DataAvailability::All) {
@@ -67,6 +72,10 @@ void GeometryTile::setData(std::unique_ptr<const GeometryTileData> data_) {
     redoLayout();
 }
 
+void GeometryTile::setPriority(int32_t priority) {
+    worker.setPriority(priority);
+}
+
 void GeometryTile::setPlacementConfig(const PlacementConfig& desiredConfig) {
     if (requestedConfig == desiredConfig) {
         return;
@@ -80,7 +89,11 @@ void GeometryTile::setPlacementConfig(const PlacementConfig& desiredConfig) {
 
     ++correlationID;
     requestedConfig = desiredConfig;
-    worker.invoke(&GeometryTileWorker::setPlacementConfig, desiredConfig, correlationID);
+    worker.invokeLatest(&GeometryTileWorker::setPlacementConfig, desiredConfig, correlationID);
+}
+
+std::shared_ptr<const std::vector<CollisionBox>> GeometryTile::getEdgeCollisionBoxes() const {
+    return edgeBoxes;
 }
 
 void GeometryTile::redoLayout() {
@@ -90,10 +103,10 @@ void GeometryTile::redoLayout() {
         availableData = DataAvailability::Some;
     }
 
-    std::vector<std::unique_ptr<Layer>> copy;
+    std::vector<std::shared_ptr<const Layer>> copy;
 
     for (const Layer* layer : style.getLayers()) {
-        // Avoid cloning and including irrelevant layers.
+        // Avoid including irrelevant layers.
         if (layer->is<BackgroundLayer>() ||
             layer->is<CustomLayer>() ||
             layer->baseImpl->source != sourceID ||
@@ -103,19 +116,39 @@ void GeometryTile::redoLayout() {
             continue;
         }
 
-        copy.push_back(layer->baseImpl->clone());
+        copy.push_back(layer->baseImpl->getSnapshot());
+    }
+
+    ++correlationID;
+    worker.invokeLatest(&GeometryTileWorker::setLayers, std::move(copy), correlationID);
+}
+
+void GeometryTile::setFeatureStates(const FeatureStates& states) {
+    if (featureStates == states) {
+        return;
+    }
+
+    // Mark the tile as pending again if it was complete before to prevent signaling a complete
+    // state despite pending parse operations.
+    if (availableData == DataAvailability::All) {
+        availableData = DataAvailability::Some;
     }
 
     ++correlationID;
-    worker.invoke(&GeometryTileWorker::setLayers, std::move(copy), correlationID);
+    featureStates = states;
+    worker.invoke(&GeometryTileWorker::setFeatureStates, states, correlationID);
 }
 
 void GeometryTile::onLayout(LayoutResult result) {
     availableData = DataAvailability::Some;
+    for (const auto& repaint : result.repaints) {
+        repaint();
+    }
     nonSymbolBuckets = std::move(result.nonSymbolBuckets);
     featureIndex = std::move(result.featureIndex);
     data = std::move(result.tileData);
     collisionTile.reset();
+    trace.add(std::move(result.trace));
     observer->onTileChanged(*this);
 }
 
@@ -124,7 +157,23 @@ void GeometryTile::onPlacement(PlacementResult result) {
         availableData = DataAvailability::All;
     }
     symbolBuckets = std::move(result.symbolBuckets);
+    for (const auto& placement : result.placements) {
+        placement.first->setPlacement(placement.second);
+    }
     collisionTile = std::move(result.collisionTile);
+    edgeBoxes = std::move(result.edgeBoxes);
+    trace.add(std::move(result.trace));
+    observer->onTileChanged(*this);
+}
+
+void GeometryTile::onRepaint(RepaintResult result) {
+    if (result.complete && result.correlationID == correlationID) {
+        availableData = DataAvailability::All;
+    }
+    for (const auto& repaint : result.repaints) {
+        repaint();
+    }
+    trace.add(std::move(result.trace));
     observer->onTileChanged(*this);
 }
 
@@ -149,12 +198,13 @@ void GeometryTile::onIconsAvailable(SpriteAtlas* spriteAtlas, IconMap icons) {
     }
 }
 
-// TODO: If there's any value to be gained by it, we can narrow our request to just the sprites
-//  we need, but SpriteAtlases are just "loaded" or "not loaded"
 void GeometryTile::getIcons(IconDependencyMap iconDependencyMap) {
-    for (auto dependency : iconDependencyMap) {
+    for (auto& dependency : iconDependencyMap) {
         pendingSpriteAtlases.insert(dependency.first);
-        dependency.first->getIcons(*this);
+        spriteAtlases.insert(dependency.first);
+    }
+    for (auto& dependency : iconDependencyMap) {
+        dependency.first->getIcons(*this, std::move(dependency.second));
     }
 }
 
@@ -169,6 +219,70 @@ Bucket* GeometryTile::getBucket(const Layer& layer) {
     return it->second.get();
 }
 
+bool GeometryTile::releaseBuffers() {
+    // Layers that share a layout share a bucket.
+    std::unordered_set<Bucket*> released;
+    bool all = true;
+    auto release = [&] (Bucket& bucket) {
+        if (released.insert(&bucket).second) {
+            all = bucket.releaseBuffers() && all;
+        }
+    };
+    for (const auto& pair : nonSymbolBuckets) {
+        release(*pair.second);
+    }
+    for (const auto& pair : symbolBuckets) {
+        release(*pair.second);
+    }
+    bufferArena.release();
+    return all;
+}
+
+std::size_t GeometryTile::getByteSize() const {
+    std::size_t size = 0;
+    for (const auto& pair : nonSymbolBuckets) {
+        size += pair.second->getByteSize();
+    }
+    for (const auto& pair : symbolBuckets) {
+        size += pair.second->getByteSize();
+    }
+    if (featureIndex) {
+        size += featureIndex->getByteSize();
+    }
+    if (data) {
+        size += data->getByteSize();
+    }
+    return size;
+}
+
+void GeometryTile::getMemoryUsage(MemoryUsage::Tiles& usage) const {
+    // Layers that share a layout share a bucket; count each bucket once.
+    std::unordered_set<const Bucket*> counted;
+    auto addBucket = [&] (const Bucket& bucket) {
+        if (!counted.insert(&bucket).second) {
+            return;
+        }
+        const std::size_t bufferSize = bucket.getBufferByteSize();
+        usage.vertexData += bucket.getByteSize() - bufferSize;
+        usage.bufferData += bufferSize;
+    };
+    for (const auto& pair : nonSymbolBuckets) {
+        addBucket(*pair.second);
+    }
+    for (const auto& pair : symbolBuckets) {
+        addBucket(*pair.second);
+    }
+    if (featureIndex) {
+        usage.featureIndex += featureIndex->getByteSize();
+    }
+    if (collisionTile) {
+        usage.collisionTile += collisionTile->getByteSize();
+    }
+    if (data) {
+        usage.tileData += data->getByteSize();
+    }
+}
+
 void GeometryTile::queryRenderedFeatures(
     std::unordered_map<std::string, std::vector<Feature>>& result,
     const GeometryCoordinates& queryGeometry,
@@ -189,6 +303,26 @@ void GeometryTile::queryRenderedFeatures(
                         collisionTile.get());
 }
 
+void GeometryTile::queryRenderedFeatureHandles(
+    std::vector<RenderedFeatureHandle>& result,
+    const GeometryCoordinates& queryGeometry,
+    const TransformState& transformState,
+    const RenderedQueryOptions& options) {
+
+    if (!featureIndex || !data) return;
+
+    featureIndex->query(result,
+                        queryGeometry,
+                        transformState.getAngle(),
+                        util::tileSize * id.overscaleFactor(),
+                        std::pow(2, transformState.getZoom() - id.overscaledZ),
+                        options,
+                        data,
+                        id.canonical,
+                        style,
+                        collisionTile.get());
+}
+
 void GeometryTile::querySourceFeatures(
     std::vector<Feature>& result,
     const style::SourceQueryOptions& options) {
@@ -197,32 +331,18 @@ void GeometryTile::querySourceFeatures(
     if (!data) {
         return;
     }
-    
+
+    mbgl::querySourceFeatures(result, *data, id.canonical, getSourceQueryLayers(options), options.filter);
+}
+
+std::vector<std::string> GeometryTile::getSourceQueryLayers(const style::SourceQueryOptions& options) const {
     // No source layers, specified, nothing to do
     if (!options.sourceLayers) {
         Log::Warning(Event::General, "At least one sourceLayer required");
-        return;
+        return {};
     }
 
-    for (auto sourceLayer : *options.sourceLayers) {
-        // Go throught all sourceLayers, if any
-        // to gather all the features
-        auto layer = data->getLayer(sourceLayer);
-        
-        if (layer) {
-            auto featureCount = layer->featureCount();
-            for (std::size_t i = 0; i < featureCount; i++) {
-                auto feature = layer->getFeature(i);
-
-                // Apply filter, if any
-                if (options.filter && !(*options.filter)(*feature)) {
-                    continue;
-                }
-
-                result.push_back(convertFeature(*feature, id.canonical));
-            }
-        }
-    }
+    return *options.sourceLayers;
 }
 
 } // namespace mbgl
@@ -7,8 +7,11 @@
 #include <mbgl/text/placement_config.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/actor/actor.hpp>
+#include <mbgl/gl/buffer_arena.hpp>
+#include <mbgl/renderer/symbol_bucket.hpp>
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -18,6 +21,7 @@ namespace mbgl {
 class GeometryTileData;
 class FeatureIndex;
 class CollisionTile;
+class CollisionBox;
 
 namespace style {
 class Style;
@@ -35,10 +39,14 @@ public:
     ~GeometryTile() override;
 
     void setError(std::exception_ptr);
-    void setData(std::unique_ptr<const GeometryTileData>);
+    void setData(std::shared_ptr<const GeometryTileData>);
 
+    void setPriority(int32_t) override;
     void setPlacementConfig(const PlacementConfig&) override;
+    std::shared_ptr<const std::vector<CollisionBox>> getEdgeCollisionBoxes() const override;
     void redoLayout() override;
+    void setFeatureStates(const FeatureStates&) override;
+    std::shared_ptr<const GeometryTileData> getSharedData() const override { return data; }
     
     void onGlyphsAvailable(GlyphPositionMap) override;
     void onIconsAvailable(SpriteAtlas*, IconMap) override;
@@ -47,6 +55,10 @@ public:
     void getIcons(IconDependencyMap);
 
     Bucket* getBucket(const style::Layer&) override;
+    gl::BufferArena* getBufferArena() override { return &bufferArena; }
+    bool releaseBuffers() override;
+    std::size_t getByteSize() const override;
+    void getMemoryUsage(MemoryUsage::Tiles&) const override;
 
     void queryRenderedFeatures(
             std::unordered_map<std::string, std::vector<Feature>>& result,
@@ -54,29 +66,60 @@ public:
             const TransformState&,
             const RenderedQueryOptions& options) override;
 
+    void queryRenderedFeatureHandles(
+            std::vector<RenderedFeatureHandle>& result,
+            const GeometryCoordinates& queryGeometry,
+            const TransformState&,
+            const RenderedQueryOptions& options) override;
+
     void querySourceFeatures(
         std::vector<Feature>& result,
         const style::SourceQueryOptions&) override;
 
+    std::vector<std::string> getSourceQueryLayers(const style::SourceQueryOptions&) const override;
+
     void cancel() override;
 
     class LayoutResult {
     public:
         std::unordered_map<std::string, std::shared_ptr<Bucket>> nonSymbolBuckets;
         std::unique_ptr<FeatureIndex> featureIndex;
-        std::unique_ptr<GeometryTileData> tileData;
+        std::shared_ptr<const GeometryTileData> tileData;
         uint64_t correlationID;
+        std::vector<TileTrace::Event> trace;
+
+        // New paint properties of non-symbol buckets that the tile already holds.
+        std::vector<std::function<void ()>> repaints;
     };
     void onLayout(LayoutResult);
 
     class PlacementResult {
     public:
         std::unordered_map<std::string, std::shared_ptr<Bucket>> symbolBuckets;
+
+        // New placements of symbol buckets that the tile already holds.
+        std::vector<std::pair<std::shared_ptr<SymbolBucket>, SymbolBucket::Placement>> placements;
+
         std::unique_ptr<CollisionTile> collisionTile;
+        std::shared_ptr<const std::vector<CollisionBox>> edgeBoxes;
         uint64_t correlationID;
+        std::vector<TileTrace::Event> trace;
     };
     void onPlacement(PlacementResult);
 
+    class RepaintResult {
+    public:
+        // New paint properties of non-symbol buckets that the tile already holds.
+        std::vector<std::function<void ()>> repaints;
+
+        // Whether the tile is complete once the repaints are applied.
+        bool complete;
+
+        uint64_t correlationID;
+        std::vector<TileTrace::Event> trace;
+    };
+    void onRepaint(RepaintResult);
+
     void onError(std::exception_ptr);
     
 protected:
@@ -96,17 +139,25 @@ private:
 
     GlyphAtlas& glyphAtlas;
     std::set<SpriteAtlas*> pendingSpriteAtlases;
+
+    // Atlases that hold on to icons for this tile.
+    std::set<SpriteAtlas*> spriteAtlases;
     IconAtlasMap iconAtlasMap;
     
     uint64_t correlationID = 0;
     optional<PlacementConfig> requestedConfig;
+    FeatureStates featureStates;
+
+    gl::BufferArena bufferArena;
 
     std::unordered_map<std::string, std::shared_ptr<Bucket>> nonSymbolBuckets;
     std::unique_ptr<FeatureIndex> featureIndex;
-    std::unique_ptr<const GeometryTileData> data;
+    // Shared with the handles of the features that queries find in it.
+    std::shared_ptr<const GeometryTileData> data;
 
     std::unordered_map<std::string, std::shared_ptr<Bucket>> symbolBuckets;
     std::unique_ptr<CollisionTile> collisionTile;
+    std::shared_ptr<const std::vector<CollisionBox>> edgeBoxes;
 };
 
 } // namespace mbgl
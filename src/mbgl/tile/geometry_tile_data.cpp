@@ -1,10 +1,35 @@
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/tile/tile_id.hpp>
+#include <mbgl/tile/property_columns.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/filter_evaluator.hpp>
 
 #include <mapbox/geometry/wagyu/wagyu.hpp>
 
 namespace mbgl {
 
+std::unique_ptr<GeometryTileFeature> GeometryTileLayer::getMatchingFeature(std::size_t i, const style::CompiledFilter& filter) const {
+    std::unique_ptr<GeometryTileFeature> feature = getFeature(i);
+    if (!filter(*feature)) {
+        return nullptr;
+    }
+    return feature;
+}
+
+util::ArenaPtr<GeometryTileFeature> GeometryTileLayer::getMatchingFeatureInArena(std::size_t i, const style::CompiledFilter& filter, util::MonotonicArena&) const {
+    return util::ArenaPtr<GeometryTileFeature>(getMatchingFeature(i, filter).release());
+}
+
+void GeometryTileLayer::decodeProperties(PropertyColumns& columns) const {
+    const std::vector<std::string>& keys = columns.getKeys();
+    for (std::size_t i = 0; i < columns.getFeatureCount(); i++) {
+        auto feature = getFeature(i);
+        for (std::size_t key = 0; key < keys.size(); key++) {
+            columns.get(key, i) = feature->getValue(keys[key]);
+        }
+    }
+}
+
 static double signedArea(const GeometryCoordinates& ring) {
     double sum = 0;
 
@@ -53,15 +78,47 @@ GeometryCollection fixupPolygons(const GeometryCollection& rings) {
 
 std::vector<GeometryCollection> classifyRings(const GeometryCollection& rings) {
     std::vector<GeometryCollection> polygons;
+    classifyRings(rings, polygons);
+    return polygons;
+}
+
+std::size_t classifyRings(const GeometryCollection& rings, std::vector<GeometryCollection>& polygons) {
+    std::size_t polygonCount = 0;
+    std::size_t ringCount = 0;
+
+    // Rings and polygons are copied into those left over from earlier calls where possible.
+    auto endPolygon = [&] {
+        if (polygonCount > 0) {
+            polygons[polygonCount - 1].resize(ringCount);
+        }
+    };
+    auto startPolygon = [&] {
+        endPolygon();
+        if (polygonCount == polygons.size()) {
+            polygons.emplace_back();
+        }
+        polygonCount++;
+        ringCount = 0;
+    };
+    auto addRing = [&] (const GeometryCoordinates& ring) {
+        GeometryCollection& polygon = polygons[polygonCount - 1];
+        if (ringCount == polygon.size()) {
+            polygon.emplace_back();
+        }
+        polygon[ringCount++].assign(ring.begin(), ring.end());
+    };
 
     std::size_t len = rings.size();
 
     if (len <= 1) {
-        polygons.push_back(rings);
-        return polygons;
+        startPolygon();
+        if (len == 1) {
+            addRing(rings[0]);
+        }
+        endPolygon();
+        return polygonCount;
     }
 
-    GeometryCollection polygon;
     int8_t ccw = 0;
 
     for (std::size_t i = 0; i < len; i++) {
@@ -73,18 +130,16 @@ std::vector<GeometryCollection> classifyRings(const GeometryCollection& rings) {
         if (ccw == 0)
             ccw = (area < 0 ? -1 : 1);
 
-        if (ccw == (area < 0 ? -1 : 1) && !polygon.empty()) {
-            polygons.push_back(polygon);
-            polygon.clear();
+        if (polygonCount == 0 || (ccw == (area < 0 ? -1 : 1) && ringCount > 0)) {
+            startPolygon();
         }
 
-        polygon.push_back(rings[i]);
+        addRing(rings[i]);
     }
 
-    if (!polygon.empty())
-        polygons.push_back(polygon);
+    endPolygon();
 
-    return polygons;
+    return polygonCount;
 }
 
 void limitHoles(GeometryCollection& polygon, uint32_t maxHoles) {
@@ -180,4 +235,26 @@ Feature convertFeature(const GeometryTileFeature& geometryTileFeature, const Can
     return feature;
 }
 
+void querySourceFeatures(std::vector<Feature>& result,
+                         const GeometryTileData& data,
+                         const CanonicalTileID& tileID,
+                         const std::vector<std::string>& sourceLayers,
+                         const optional<style::Filter>& filter) {
+    for (const auto& sourceLayer : sourceLayers) {
+        auto layer = data.getLayer(sourceLayer);
+        if (!layer) {
+            continue;
+        }
+
+        auto featureCount = layer->featureCount();
+        for (std::size_t i = 0; i < featureCount; i++) {
+            auto feature = layer->getFeature(i);
+            if (filter && !(*filter)(*feature)) {
+                continue;
+            }
+            result.push_back(convertFeature(*feature, tileID));
+        }
+    }
+}
+
 } // namespace mbgl
@@ -3,6 +3,7 @@
 #include <mbgl/util/geometry.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/monotonic_arena.hpp>
 
 #include <cstdint>
 #include <string>
@@ -11,7 +12,14 @@
 
 namespace mbgl {
 
+class Buffer;
 class CanonicalTileID;
+class PropertyColumns;
+
+namespace style {
+class CompiledFilter;
+class Filter;
+} // namespace style
 
 // Normalized vector tile coordinates.
 // Each geometry coordinate represents a point in a bidimensional space,
@@ -45,6 +53,13 @@ public:
     virtual PropertyMap getProperties() const { return PropertyMap(); }
     virtual optional<FeatureIdentifier> getID() const { return {}; }
     virtual GeometryCollection getGeometries() const = 0;
+
+    // Replaces the contents of the collection with the geometries. Features that decode their
+    // geometries reuse the memory of the collection's rings, so that the features of a layer
+    // decoded into the same collection only allocate as the rings grow.
+    virtual void readGeometries(GeometryCollection& result) const {
+        result = getGeometries();
+    }
 };
 
 class GeometryTileLayer {
@@ -53,6 +68,18 @@ public:
     virtual std::size_t featureCount() const = 0;
     virtual std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const = 0;
     virtual std::string getName() const = 0;
+
+    // Returns the feature at the given index if it matches the filter, or nullptr otherwise.
+    // Implementations may evaluate the filter without materializing the feature.
+    virtual std::unique_ptr<GeometryTileFeature> getMatchingFeature(std::size_t, const style::CompiledFilter&) const;
+
+    // Like getMatchingFeature(), but implementations may construct the feature in the arena,
+    // which must not be reset until the feature is destroyed.
+    virtual util::ArenaPtr<GeometryTileFeature> getMatchingFeatureInArena(std::size_t, const style::CompiledFilter&, util::MonotonicArena&) const;
+
+    // Fills the columns in with the values of all features. Implementations may decode the
+    // values of a feature in one pass, rather than looking each key up on its own.
+    virtual void decodeProperties(PropertyColumns&) const;
 };
 
 class GeometryTileData {
@@ -60,17 +87,36 @@ public:
     virtual ~GeometryTileData() = default;
     virtual std::unique_ptr<GeometryTileData> clone() const = 0;
     virtual const GeometryTileLayer* getLayer(const std::string&) const = 0;
+
+    // Returns the number of bytes of encoded data retained by this object, or 0 if the data
+    // is shared with other objects.
+    virtual std::size_t getByteSize() const { return 0; }
+
+    // Returns the encoded tile this data was parsed from, if there is one.
+    virtual std::shared_ptr<const Buffer> getEncodedData() const { return nullptr; }
 };
 
 // classifies an array of rings into polygons with outer rings and holes
 std::vector<GeometryCollection> classifyRings(const GeometryCollection&);
 
+// Classifies the rings like the function above, into the first polygons of `polygons`, and
+// returns their number. The polygons and their rings keep their memory for the next call; the
+// ones past the returned number are left over from earlier calls.
+std::size_t classifyRings(const GeometryCollection&, std::vector<GeometryCollection>& polygons);
+
 // Truncate polygon to the largest `maxHoles` inner rings by area.
 void limitHoles(GeometryCollection&, uint32_t maxHoles);
 
 // convert from GeometryTileFeature to Feature (eventually we should eliminate GeometryTileFeature)
 Feature convertFeature(const GeometryTileFeature&, const CanonicalTileID&);
 
+// Appends the converted features of the given layers of a tile that pass the filter, if any.
+void querySourceFeatures(std::vector<Feature>& result,
+                         const GeometryTileData&,
+                         const CanonicalTileID&,
+                         const std::vector<std::string>& sourceLayers,
+                         const optional<style::Filter>&);
+
 // Fix up possibly-non-V2-compliant polygon geometry using angus clipper.
 // The result is guaranteed to have correctly wound, strictly simple rings.
 GeometryCollection fixupPolygons(const GeometryCollection&);
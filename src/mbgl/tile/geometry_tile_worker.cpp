@@ -1,20 +1,30 @@
 #include <mbgl/tile/geometry_tile_worker.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/tile/geometry_tile.hpp>
+#include <mbgl/tile/property_columns.hpp>
+#include <mbgl/tile/shared_layout_cache.hpp>
+#include <mbgl/tile/overzoom_bucket_cache.hpp>
 #include <mbgl/text/collision_tile.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/layout/symbol_layout.hpp>
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/style/bucket_parameters.hpp>
 #include <mbgl/style/group_by_layout.hpp>
-#include <mbgl/style/filter.hpp>
-#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/renderer/symbol_bucket.hpp>
+#include <mbgl/util/buffer.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/exception.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+
+#include <boost/functional/hash.hpp>
 
 #include <unordered_set>
 
@@ -26,12 +36,20 @@ GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        ActorRef<GeometryTile> parent_,
                                        OverscaledTileID id_,
                                        const std::atomic<bool>& obsolete_,
-                                       const MapMode mode_)
+                                       const MapMode mode_,
+                                       const bool featurePicking_,
+                                       const bool multisampling_,
+                                       std::shared_ptr<ShapingCache> shapingCache_,
+                                       std::shared_ptr<const ResidentGlyphs> residentGlyphs_)
     : self(std::move(self_)),
       parent(std::move(parent_)),
       id(std::move(id_)),
       obsolete(obsolete_),
-      mode(mode_) {
+      mode(mode_),
+      featurePicking(featurePicking_),
+      multisampling(multisampling_),
+      shapingCache(std::move(shapingCache_)),
+      residentGlyphs(std::move(residentGlyphs_)) {
 }
 
 GeometryTileWorker::~GeometryTileWorker() {
@@ -70,9 +88,10 @@ GeometryTileWorker::~GeometryTileWorker() {
    since it will trigger placement when complete), or return to the [idle] state if not.
 */
 
-void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_, uint64_t correlationID_) {
+void GeometryTileWorker::setData(std::shared_ptr<const GeometryTileData> data_, uint64_t correlationID_) {
     try {
         data = std::move(data_);
+        groupBuckets.clear();
         correlationID = correlationID_;
 
         switch (state) {
@@ -92,9 +111,10 @@ void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_,
     }
 }
 
-void GeometryTileWorker::setLayers(std::vector<std::unique_ptr<Layer>> layers_, uint64_t correlationID_) {
+void GeometryTileWorker::setLayers(std::vector<std::shared_ptr<const Layer>> layers_, uint64_t correlationID_) {
     try {
         layers = std::move(layers_);
+        layerGroups = groupByLayout(*layers);
         correlationID = correlationID_;
 
         switch (state) {
@@ -140,8 +160,35 @@ void GeometryTileWorker::setPlacementConfig(PlacementConfig placementConfig_, ui
     }
 }
 
+void GeometryTileWorker::setFeatureStates(FeatureStates featureStates_, uint64_t correlationID_) {
+    try {
+        featureStates = std::move(featureStates_);
+        correlationID = correlationID_;
+
+        switch (state) {
+        case Idle:
+        case Coalescing:
+        case NeedPlacement:
+            repaint();
+            break;
+
+        case NeedLayout:
+            break;
+        }
+    } catch (...) {
+        parent.invoke(&GeometryTile::onError, std::current_exception());
+    }
+}
+
 void GeometryTileWorker::symbolDependenciesChanged() {
     try {
+        if (symbolDependenciesRequested && !hasPendingSymbolDependencies()) {
+            const TimePoint now = Clock::now();
+            trace.push_back({ TileTrace::SymbolDependencies, {}, *symbolDependenciesRequested,
+                              now - *symbolDependenciesRequested });
+            symbolDependenciesRequested = {};
+        }
+
         switch (state) {
         case Idle:
             if (hasPendingSymbolLayouts()) {
@@ -220,7 +267,13 @@ void GeometryTileWorker::onIconsAvailable(IconAtlasMap newIcons) {
     for (auto& atlasIcons : newIcons) {
         auto pendingAtlasIcons = pendingIconDependencies.find((SpriteAtlas*)atlasIcons.first);
         if (pendingAtlasIcons != pendingIconDependencies.end()) {
-            icons[atlasIcons.first] = std::move(newIcons[atlasIcons.first]);
+            IconMap& iconMap = icons[atlasIcons.first];
+            for (auto& icon : atlasIcons.second) {
+                auto result = iconMap.emplace(icon.first, icon.second);
+                if (!result.second) {
+                    result.first->second = icon.second;
+                }
+            }
             pendingIconDependencies.erase((SpriteAtlas*)atlasIcons.first);
         }
     }
@@ -229,34 +282,139 @@ void GeometryTileWorker::onIconsAvailable(IconAtlasMap newIcons) {
 
 void GeometryTileWorker::requestNewGlyphs(const GlyphDependencies& glyphDependencies) {
     for (auto& fontDependencies : glyphDependencies) {
-        auto fontGlyphs = glyphPositions.find(fontDependencies.first);
+        GlyphPositions& fontGlyphs = glyphPositions[fontDependencies.first];
+        GlyphIDs missing;
         for (auto glyphID : fontDependencies.second) {
-            if (fontGlyphs == glyphPositions.end() || fontGlyphs->second.find(glyphID) == fontGlyphs->second.end()) {
-                pendingGlyphDependencies[fontDependencies.first].insert(glyphID);
+            if (fontGlyphs.find(glyphID) == fontGlyphs.end()) {
+                missing.insert(glyphID);
             }
         }
+        // Resident glyphs stay in the atlas, so the tile doesn't need to hold on to them.
+        if (!missing.empty() && residentGlyphs) {
+            missing = residentGlyphs->find(fontDependencies.first, missing, fontGlyphs);
+        }
+        if (!missing.empty()) {
+            pendingGlyphDependencies[fontDependencies.first].insert(missing.begin(), missing.end());
+        }
     }
     if (!pendingGlyphDependencies.empty()) {
+        if (!symbolDependenciesRequested) {
+            symbolDependenciesRequested = Clock::now();
+        }
         parent.invoke(&GeometryTile::getGlyphs, pendingGlyphDependencies);
     }
 }
 
 void GeometryTileWorker::requestNewIcons(const IconDependencyMap &iconDependencies) {
     for (auto& atlasDependency : iconDependencies) {
-        if (icons.find((uintptr_t)atlasDependency.first) == icons.end()) {
-            pendingIconDependencies[atlasDependency.first] = IconDependencies();
+        auto atlasIcons = icons.find((uintptr_t)atlasDependency.first);
+        for (const auto& name : atlasDependency.second) {
+            if (atlasIcons == icons.end() || atlasIcons->second.find(name) == atlasIcons->second.end()) {
+                pendingIconDependencies[atlasDependency.first].insert(name);
+            }
         }
     }
     if (!pendingIconDependencies.empty()) {
+        if (!symbolDependenciesRequested) {
+            symbolDependenciesRequested = Clock::now();
+        }
         parent.invoke(&GeometryTile::getIcons, pendingIconDependencies);
     }
 }
 
+// Identifies the contents of the buckets of a layer group within a tile: groups with equal keys
+// lay out the same tile data into equal buckets.
+static std::string groupKey(const std::vector<const Layer*>& group) {
+    rapidjson::StringBuffer s;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+
+    writer.StartArray();
+    const std::string leaderKey = layoutKey(*group.at(0));
+    writer.String(leaderKey.data(), leaderKey.size());
+    for (const auto& layer : group) {
+        writer.String(layer->getID());
+        layer->baseImpl->stringifyDataDrivenPaint(writer);
+    }
+    writer.EndArray();
+
+    return s.GetString();
+}
+
+// Identifies the layout of a tile across maps: maps whose layers are grouped and evaluated alike
+// lay out the same tile data into equal buckets and feature indexes.
+static std::string sharedLayoutKey(const OverscaledTileID& id,
+                                   MapMode mode,
+                                   bool featurePicking,
+                                   bool multisampling,
+                                   const Buffer& data,
+                                   const std::vector<std::string>& groupKeys) {
+    rapidjson::StringBuffer s;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+
+    writer.StartArray();
+    writer.Uint(id.overscaledZ);
+    writer.Uint(id.canonical.z);
+    writer.Uint(id.canonical.x);
+    writer.Uint(id.canonical.y);
+    writer.Uint(static_cast<uint32_t>(mode));
+    writer.Bool(featurePicking);
+    writer.Bool(multisampling);
+    writer.Uint64(data.size());
+    writer.Uint64(boost::hash_range(data.data(), data.data() + data.size()));
+    for (const auto& key : groupKeys) {
+        writer.String(key.data(), key.size());
+    }
+    writer.EndArray();
+
+    return s.GetString();
+}
+
+// Identifies the symbol features of a layer group, which are the same for all tiles that overzoom
+// the same canonical tile; see SymbolFeatureCache.
+static std::string symbolFeaturesKey(const CanonicalTileID& id, const std::string& groupKey) {
+    rapidjson::StringBuffer s;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+
+    writer.StartArray();
+    writer.Uint(id.z);
+    writer.Uint(id.x);
+    writer.Uint(id.y);
+    writer.String(groupKey.data(), groupKey.size());
+    writer.EndArray();
+
+    return s.GetString();
+}
+
+// Identifies the bucket of a non-symbol layer group that all tiles overzooming the same canonical
+// tile lay out alike; see OverzoomBucketCache.
+static std::string overzoomBucketKey(const CanonicalTileID& id,
+                                     MapMode mode,
+                                     bool featurePicking,
+                                     bool multisampling,
+                                     const std::string& groupKey) {
+    rapidjson::StringBuffer s;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+
+    writer.StartArray();
+    writer.Uint(id.z);
+    writer.Uint(id.x);
+    writer.Uint(id.y);
+    writer.Uint(static_cast<uint32_t>(mode));
+    writer.Bool(featurePicking);
+    writer.Bool(multisampling);
+    writer.String(groupKey.data(), groupKey.size());
+    writer.EndArray();
+
+    return s.GetString();
+}
+
 void GeometryTileWorker::redoLayout() {
     if (!data || !layers) {
         return;
     }
 
+    const TimePoint start = Clock::now();
+
     std::vector<std::string> symbolOrder;
     for (auto it = layers->rbegin(); it != layers->rend(); it++) {
         if ((*it)->is<SymbolLayer>()) {
@@ -267,17 +425,62 @@ void GeometryTileWorker::redoLayout() {
     std::unordered_map<std::string, std::unique_ptr<SymbolLayout>> symbolLayoutMap;
     std::unordered_map<std::string, std::shared_ptr<Bucket>> buckets;
     auto featureIndex = std::make_unique<FeatureIndex>();
-    BucketParameters parameters { id, mode };
+    BucketParameters parameters { id, mode, featurePicking, multisampling, &obsolete };
     
     GlyphDependencies glyphDependencies;
     IconDependencyMap iconDependencyMap;
 
-    std::vector<std::vector<const Layer*>> groups = groupByLayout(*layers);
-    for (auto& group : groups) {
+    const std::vector<std::vector<const Layer*>>& groups = layerGroups;
+    std::vector<std::string> groupKeys;
+    std::vector<std::string> groupLayoutKeys;
+    bool hasFeatureStates = false;
+    for (const auto& group : groups) {
+        groupKeys.push_back(groupKey(group));
+        groupLayoutKeys.push_back(layoutKey(*group.at(0)));
+        hasFeatureStates |= bool(getFeatureStates(group.at(0)->baseImpl->sourceLayer));
+    }
+
+    // Buckets of groups whose layout is unchanged since the previous layout are reused rather
+    // than rebuilt, and repainted if the paint of their layers changed; the new layout's groups
+    // replace them.
+    std::unordered_map<std::string, GroupBucket> nextGroupBuckets;
+    std::vector<std::function<void ()>> repaints;
+
+    SharedLayoutCache& sharedCache = SharedLayoutCache::get();
+    std::shared_ptr<const Buffer> encodedData = *data ? (*data)->getEncodedData() : nullptr;
+    std::string sharedKey;
+    std::shared_ptr<const SharedLayoutCache::Layout> sharedLayout;
+    // Layouts that are painted with feature states are specific to the map.
+    if (sharedCache.isEnabled() && encodedData && !hasFeatureStates) {
+        sharedKey = sharedLayoutKey(id, mode, featurePicking, multisampling, *encodedData, groupKeys);
+        sharedLayout = sharedCache.find(sharedKey, *encodedData);
+    }
+
+    // Overscaled tiles copy the buckets that another tile of the same canonical tile laid out.
+    OverzoomBucketCache& overzoomCache = OverzoomBucketCache::get();
+    const bool overzoomed = encodedData && id.overscaledZ > id.canonical.z;
+
+    // Copies of the non-symbol buckets for the shared cache, as long as all of them can be copied.
+    std::vector<std::pair<std::vector<std::string>, std::unique_ptr<const Bucket>>> sharedBuckets;
+    bool shareable = !sharedKey.empty() && !sharedLayout;
+
+    if (sharedLayout) {
+        featureIndex = std::make_unique<FeatureIndex>(*sharedLayout->featureIndex);
+        for (const auto& pair : sharedLayout->buckets) {
+            std::shared_ptr<Bucket> bucket = pair.second->clone();
+            for (const auto& layerID : pair.first) {
+                buckets.emplace(layerID, bucket);
+            }
+        }
+    }
+
+    for (std::size_t g = 0; g < groups.size(); g++) {
         if (obsolete) {
             return;
         }
 
+        const auto& group = groups[g];
+
         if (!*data) {
             continue; // Tile has no data.
         }
@@ -294,37 +497,139 @@ void GeometryTileWorker::redoLayout() {
             layerIDs.push_back(layer->getID());
         }
 
-        featureIndex->setBucketLayerIDs(leader.getID(), layerIDs);
+        const uint16_t bucketID = featureIndex->setBucketLayerIDs(leader.getID(), layerIDs);
+        const uint16_t sourceLayerID = featureIndex->addSourceLayerName(leader.baseImpl->sourceLayer);
 
         if (leader.is<SymbolLayer>()) {
-            symbolLayoutMap.emplace(leader.getID(),
-                leader.as<SymbolLayer>()->impl->createLayout(parameters, group, *geometryLayer, glyphDependencies, iconDependencyMap));
-        } else {
-            const Filter& filter = leader.baseImpl->filter;
-            const std::string& sourceLayerID = leader.baseImpl->sourceLayer;
-            std::shared_ptr<Bucket> bucket = leader.baseImpl->createBucket(parameters, group);
+            auto layout = leader.as<SymbolLayer>()->impl->createLayout(parameters, group, *geometryLayer, glyphDependencies, iconDependencyMap,
+                                                                       encodedData ? symbolFeaturesKey(id.canonical, groupKeys[g]) : std::string(),
+                                                                       encodedData);
+            layout->setFeatureIndexIDs(sourceLayerID, bucketID);
+            symbolLayoutMap.emplace(leader.getID(), std::move(layout));
+        } else if (!sharedLayout) {
+            const CompiledFilter& filter = *leader.baseImpl->compiledFilter;
+            const std::shared_ptr<const FeatureStateMap> states = getFeatureStates(leader.baseImpl->sourceLayer);
+
+            auto previous = groupBuckets.find(groupLayoutKeys[g]);
+            bool reuse = previous != groupBuckets.end();
+            if (reuse && previous->second.bucket &&
+                (previous->second.key != groupKeys[g] ||
+                 featureStatesDiffer(*geometryLayer, previous->second.states.get(), states.get()))) {
+                std::function<void ()> repaint = previous->second.bucket->repaint(parameters, group, *geometryLayer, states.get());
+                if (repaint) {
+                    repaints.push_back(std::move(repaint));
+                } else {
+                    reuse = false;
+                }
+            }
 
-            for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
-                std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
+            // Buckets painted with feature states are specific to the map.
+            std::string overzoomKey;
+            std::shared_ptr<const OverzoomBucketCache::Entry> overzoomEntry;
+            if (overzoomed && !reuse && !states) {
+                overzoomKey = overzoomBucketKey(id.canonical, mode, featurePicking, multisampling, groupKeys[g]);
+                overzoomEntry = overzoomCache.find(overzoomKey, *encodedData);
+            }
+            std::shared_ptr<Bucket> bucket;
+            if (reuse) {
+                bucket = previous->second.bucket;
+                overzoomEntry = previous->second.overzoom;
+            } else if (overzoomEntry) {
+                bucket = overzoomEntry->bucket->clone();
+            }
+            if (!reuse && !bucket) {
+                overzoomEntry = nullptr;
+                bucket = leader.baseImpl->createBucket(parameters, group);
+            }
+
+            // The features of copies are only inserted into the feature index.
+            const bool copied = !reuse && overzoomEntry;
 
-                if (!filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
+            // The properties that the data-driven paint properties of the group read are decoded
+            // for all features at once.
+            PropertyColumns columns(reuse || copied ? std::vector<std::string>() : bucket->paintPropertyKeys(),
+                                    geometryLayer->featureCount());
+            if (!columns.getKeys().empty()) {
+                geometryLayer->decodeProperties(columns);
+            }
+
+            // Decoded into the same collection for all features, which reuses the memory of its rings.
+            GeometryCollection geometries;
+            for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
+                // Only one feature is alive at a time, so the memory of the previous one is used again.
+                arena.reset();
+                util::ArenaPtr<GeometryTileFeature> feature = geometryLayer->getMatchingFeatureInArena(i, filter, arena);
+                if (!feature)
                     continue;
 
-                GeometryCollection geometries = feature->getGeometries();
-                bucket->addFeature(*feature, geometries);
-                featureIndex->insert(geometries, i, sourceLayerID, leader.getID());
+                feature->readGeometries(geometries);
+                if (!reuse && !copied) {
+                    const ColumnarFeature columnar(*feature, columns, i);
+                    const PropertyMap* featureState = findFeatureState(states.get(), *feature);
+                    if (featureState) {
+                        bucket->addFeature(FeatureWithState(columnar, *featureState), geometries, i);
+                    } else {
+                        bucket->addFeature(columnar, geometries, i);
+                    }
+                }
+                featureIndex->insert(geometries, i, sourceLayerID, bucketID);
+            }
+
+            // The bucket may have stopped midway through a feature.
+            if (obsolete) {
+                return;
+            }
+
+            // A reused bucket may have been uploaded by now, so it is neither inspected nor copied.
+            if (reuse) {
+                shareable = false;
+            } else if (!bucket->hasData()) {
+                bucket = nullptr;
+            } else if (!copied) {
+                bucket->splitSegments();
+                bucket->shrinkToFit();
+
+                if (!overzoomKey.empty() && bucket->isZoomConstant()) {
+                    auto entry = std::make_shared<OverzoomBucketCache::Entry>();
+                    entry->data = encodedData;
+                    entry->bucket = bucket->clone();
+                    if (entry->bucket) {
+                        overzoomCache.add(overzoomKey, entry);
+                        overzoomEntry = std::move(entry);
+                    }
+                }
             }
 
-            if (!bucket->hasData()) {
+            nextGroupBuckets.emplace(groupLayoutKeys[g], GroupBucket { groupKeys[g], bucket, states, overzoomEntry });
+
+            if (!bucket) {
                 continue;
             }
 
             for (const auto& layer : group) {
                 buckets.emplace(layer->getID(), bucket);
             }
+
+            if (shareable) {
+                std::unique_ptr<Bucket> copy = bucket->clone();
+                shareable = bool(copy);
+                sharedBuckets.emplace_back(std::move(layerIDs), std::move(copy));
+            }
         }
     }
 
+    // The tile still holds the buckets that are dropped here, so their GL resources are not
+    // released on this thread. Shared layouts are not tracked by group.
+    groupBuckets = std::move(nextGroupBuckets);
+
+    if (shareable && !obsolete) {
+        auto layout = std::make_shared<SharedLayoutCache::Layout>();
+        layout->data = std::move(encodedData);
+        layout->buckets = std::move(sharedBuckets);
+        layout->featureIndex = std::make_unique<FeatureIndex>(*featureIndex);
+        sharedCache.add(sharedKey, std::move(layout));
+    }
+
     symbolLayouts.clear();
     for (const auto& symbolLayerID : symbolOrder) {
         auto it = symbolLayoutMap.find(symbolLayerID);
@@ -336,16 +641,104 @@ void GeometryTileWorker::redoLayout() {
     requestNewGlyphs(glyphDependencies);
     requestNewIcons(iconDependencyMap);
 
+    trace.push_back({ TileTrace::Layout, {}, start, Clock::now() - start });
+
     parent.invoke(&GeometryTile::onLayout, GeometryTile::LayoutResult {
         std::move(buckets),
         std::move(featureIndex),
-        *data ? (*data)->clone() : nullptr,
-        correlationID
+        *data,
+        correlationID,
+        std::move(trace),
+        std::move(repaints)
     });
+    trace.clear();
 
     attemptPlacement();
 }
 
+std::shared_ptr<const FeatureStateMap> GeometryTileWorker::getFeatureStates(const std::string& sourceLayer) const {
+    auto it = featureStates.find(sourceLayer);
+    return it == featureStates.end() ? nullptr : it->second;
+}
+
+void GeometryTileWorker::repaint() {
+    if (!data || !layers) {
+        return;
+    }
+
+    const TimePoint start = Clock::now();
+    BucketParameters parameters { id, mode, featurePicking, multisampling, &obsolete };
+    std::vector<std::function<void ()>> repaints;
+    bool needsLayout = false;
+
+    for (const auto& group : layerGroups) {
+        if (obsolete) {
+            return;
+        }
+
+        const Layer& leader = *group.at(0);
+        const GeometryTileLayer* geometryLayer = *data ? (*data)->getLayer(leader.baseImpl->sourceLayer) : nullptr;
+        if (leader.is<SymbolLayer>() || !geometryLayer) {
+            continue;
+        }
+
+        const std::shared_ptr<const FeatureStateMap> states = getFeatureStates(leader.baseImpl->sourceLayer);
+        auto it = groupBuckets.find(layoutKey(leader));
+        if (it == groupBuckets.end()) {
+            // The bucket was copied from a shared layout, which has no feature states.
+            needsLayout |= bool(states);
+            continue;
+        }
+
+        GroupBucket& groupBucket = it->second;
+        if (!groupBucket.bucket ||
+            !featureStatesDiffer(*geometryLayer, groupBucket.states.get(), states.get())) {
+            groupBucket.states = states;
+            continue;
+        }
+
+        std::function<void ()> bucketRepaint = groupBucket.bucket->repaint(parameters, group, *geometryLayer, states.get());
+        if (bucketRepaint) {
+            repaints.push_back(std::move(bucketRepaint));
+            groupBucket.states = states;
+        } else {
+            groupBuckets.erase(it);
+            needsLayout = true;
+        }
+    }
+
+    trace.push_back({ TileTrace::Repaint, {}, start, Clock::now() - start });
+
+    // Unless the tile waits for anything else, it is complete once the buckets are repainted.
+    const bool complete = !needsLayout && (state == Idle || state == Coalescing) &&
+                          placementConfig && !hasPendingSymbolDependencies();
+
+    parent.invoke(&GeometryTile::onRepaint, GeometryTile::RepaintResult {
+        std::move(repaints),
+        complete,
+        correlationID,
+        std::move(trace)
+    });
+    trace.clear();
+
+    if (needsLayout) {
+        switch (state) {
+        case Idle:
+            redoLayout();
+            coalesce();
+            break;
+
+        case Coalescing:
+        case NeedPlacement:
+            state = NeedLayout;
+            break;
+
+        case NeedLayout:
+            break;
+        }
+    }
+}
+
 bool GeometryTileWorker::hasPendingSymbolLayouts() const {
     for (const auto& symbolLayout : symbolLayouts) {
         if (symbolLayout->state == SymbolLayout::Pending) {
@@ -373,6 +766,7 @@ void GeometryTileWorker::attemptPlacement() {
     
     auto collisionTile = std::make_unique<CollisionTile>(*placementConfig);
     std::unordered_map<std::string, std::shared_ptr<Bucket>> buckets;
+    std::vector<std::pair<std::shared_ptr<SymbolBucket>, SymbolBucket::Placement>> placements;
 
     for (auto& symbolLayout : symbolLayouts) {
         if (obsolete) {
@@ -380,25 +774,51 @@ void GeometryTileWorker::attemptPlacement() {
         }
         
         if (symbolLayout->state == SymbolLayout::Pending) {
-            symbolLayout->prepare(glyphPositions,icons);
+            const TimePoint start = Clock::now();
+            symbolLayout->prepare(glyphPositions, icons, shapingCache.get());
+            if (obsolete) {
+                return;
+            }
             symbolLayout->state = SymbolLayout::Placed;
+            trace.push_back({ TileTrace::Prepare, symbolLayout->getBucketName(), start, Clock::now() - start });
         }
         
         if (!symbolLayout->hasSymbolInstances()) {
             continue;
         }
 
-        std::shared_ptr<Bucket> bucket = symbolLayout->place(*collisionTile);
+        const TimePoint start = Clock::now();
+        auto placed = symbolLayout->place(*collisionTile);
+        if (obsolete) {
+            return;
+        }
+        std::shared_ptr<SymbolBucket> bucket = std::move(placed.first);
+        if (placed.second) {
+            // The tile already has the bucket; it only needs to be placed again.
+            placements.emplace_back(bucket, std::move(*placed.second));
+        } else {
+            bucket->shrinkToFit();
+        }
+        trace.push_back({ TileTrace::Place, symbolLayout->getBucketName(), start, Clock::now() - start });
         for (const auto& pair : symbolLayout->layerPaintProperties) {
             buckets.emplace(pair.first, bucket);
         }
     }
 
+    auto newEdgeBoxes = collisionTile->getEdgeBoxes();
+    if (!edgeBoxes || *edgeBoxes != newEdgeBoxes) {
+        edgeBoxes = std::make_shared<const std::vector<CollisionBox>>(std::move(newEdgeBoxes));
+    }
+
     parent.invoke(&GeometryTile::onPlacement, GeometryTile::PlacementResult {
         std::move(buckets),
+        std::move(placements),
         std::move(collisionTile),
-        correlationID
+        edgeBoxes,
+        correlationID,
+        std::move(trace)
     });
+    trace.clear();
 }
 
 } // namespace mbgl
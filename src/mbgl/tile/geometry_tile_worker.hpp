@@ -2,20 +2,29 @@
 
 #include <mbgl/map/mode.hpp>
 #include <mbgl/tile/tile_id.hpp>
+#include <mbgl/tile/tile_trace.hpp>
+#include <mbgl/tile/feature_state.hpp>
+#include <mbgl/tile/overzoom_bucket_cache.hpp>
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/text/glyph.hpp>
 #include <mbgl/text/placement_config.hpp>
 #include <mbgl/actor/actor_ref.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/monotonic_arena.hpp>
 
 #include <atomic>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace mbgl {
 
+class Bucket;
 class GeometryTile;
 class GeometryTileData;
 class GlyphAtlas;
+class ResidentGlyphs;
+class ShapingCache;
 class SymbolLayout;
 
 namespace style {
@@ -28,12 +37,17 @@ public:
                        ActorRef<GeometryTile> parent,
                        OverscaledTileID,
                        const std::atomic<bool>&,
-                       const MapMode);
+                       const MapMode,
+                       const bool featurePicking,
+                       const bool multisampling,
+                       std::shared_ptr<ShapingCache>,
+                       std::shared_ptr<const ResidentGlyphs>);
     ~GeometryTileWorker();
 
-    void setLayers(std::vector<std::unique_ptr<style::Layer>>, uint64_t correlationID);
-    void setData(std::unique_ptr<const GeometryTileData>, uint64_t correlationID);
+    void setLayers(std::vector<std::shared_ptr<const style::Layer>>, uint64_t correlationID);
+    void setData(std::shared_ptr<const GeometryTileData>, uint64_t correlationID);
     void setPlacementConfig(PlacementConfig, uint64_t correlationID);
+    void setFeatureStates(FeatureStates, uint64_t correlationID);
     
     void onGlyphsAvailable(GlyphPositionMap glyphs);
     void onIconsAvailable(IconAtlasMap icons);
@@ -42,6 +56,7 @@ private:
     void coalesced();
     void redoLayout();
     void attemptPlacement();
+    void repaint();
     
     void coalesce();
 
@@ -58,6 +73,10 @@ private:
     const OverscaledTileID id;
     const std::atomic<bool>& obsolete;
     const MapMode mode;
+    const bool featurePicking;
+    const bool multisampling;
+    const std::shared_ptr<ShapingCache> shapingCache;
+    const std::shared_ptr<const ResidentGlyphs> residentGlyphs;
 
     enum State {
         Idle,
@@ -70,15 +89,54 @@ private:
     uint64_t correlationID = 0;
 
     // Outer optional indicates whether we've received it or not.
-    optional<std::vector<std::unique_ptr<style::Layer>>> layers;
-    optional<std::unique_ptr<const GeometryTileData>> data;
+    optional<std::vector<std::shared_ptr<const style::Layer>>> layers;
+    // The layers grouped by their layout, which are grouped once per set of layers.
+    std::vector<std::vector<const style::Layer*>> layerGroups;
+    optional<std::shared_ptr<const GeometryTileData>> data;
     optional<PlacementConfig> placementConfig;
+    FeatureStates featureStates;
+
+    std::shared_ptr<const FeatureStateMap> getFeatureStates(const std::string& sourceLayer) const;
+
+    struct GroupBucket {
+        // The key of the layer group.
+        std::string key;
+
+        // nullptr for groups without data.
+        std::shared_ptr<Bucket> bucket;
+
+        // The states of the features of the source layer that the bucket was painted with.
+        std::shared_ptr<const FeatureStateMap> states;
+
+        // The copy of the bucket that the tiles overzooming the same canonical tile share, which
+        // the cache keeps as long as one of them holds it.
+        std::shared_ptr<const OverzoomBucketCache::Entry> overzoom;
+    };
+
+    // Non-symbol buckets of the most recent layout by the layout key of their layer group, so
+    // that a relayout only rebuilds the groups that changed, and only repaints those whose
+    // data-driven paint or feature states changed.
+    std::unordered_map<std::string, GroupBucket> groupBuckets;
+
+    // Holds the feature that the layout of non-symbol buckets is currently reading.
+    util::MonotonicArena arena;
 
     std::vector<std::unique_ptr<SymbolLayout>> symbolLayouts;
     GlyphDependencies pendingGlyphDependencies;
     IconDependencyMap pendingIconDependencies;
     GlyphPositionMap glyphPositions;
     IconAtlasMap icons;
+
+    // Boxes of the most recent placement that the neighbours of the tile place their symbols
+    // around. Kept when placing again yields the same boxes, so that the neighbours don't have
+    // to be placed again.
+    std::shared_ptr<const std::vector<CollisionBox>> edgeBoxes;
+
+    // When the glyphs and icons that are still pending were first requested.
+    optional<TimePoint> symbolDependenciesRequested;
+
+    // Events recorded since the last result was sent to the tile.
+    std::vector<TileTrace::Event> trace;
 };
 
 } // namespace mbgl
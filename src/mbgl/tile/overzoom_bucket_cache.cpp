@@ -0,0 +1,66 @@
+#include <mbgl/tile/overzoom_bucket_cache.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/util/buffer.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+constexpr std::size_t OverzoomBucketCache::minimumSweepSize;
+
+OverzoomBucketCache& OverzoomBucketCache::get() {
+    static OverzoomBucketCache cache;
+    return cache;
+}
+
+std::shared_ptr<const OverzoomBucketCache::Entry> OverzoomBucketCache::find(const std::string& key, const Buffer& data) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(key);
+    std::shared_ptr<const Entry> entry;
+    if (it != entries.end()) {
+        entry = it->second.lock();
+        if (!entry) {
+            // The tiles that held the buckets are gone.
+            entries.erase(it);
+            stats.entries = entries.size();
+        }
+    }
+
+    if (!entry || *entry->data != data) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    stats.hits++;
+    return entry;
+}
+
+void OverzoomBucketCache::add(const std::string& key, const std::shared_ptr<const Entry>& entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Replaces buckets that were laid out by another tile in the meantime, or from other data.
+    entries[key] = entry;
+
+    // Buckets of tiles that are gone and weren't looked up again are dropped once the entries have
+    // doubled since the last sweep, so that adding one takes constant time on average.
+    if (entries.size() > sweepSize) {
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (it->second.expired()) {
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        sweepSize = std::max(minimumSweepSize, 2 * entries.size());
+    }
+
+    stats.entries = entries.size();
+}
+
+OverzoomBucketCache::Stats OverzoomBucketCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+} // namespace mbgl
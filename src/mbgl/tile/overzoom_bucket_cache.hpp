@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+class Buffer;
+class Bucket;
+
+// The non-symbol buckets of the tiles that overzoom a canonical tile. Past the maximum zoom level
+// of a source, every overscaled tile lays out the same data of its canonical tile again. Buckets
+// whose paint properties aren't interpolated between zoom levels come out the same for each of
+// them, so the first overscaled tile keeps a copy here, and the next ones copy it instead of
+// laying out the group's features again. Each tile still uploads its own copies.
+//
+// Buckets are kept as long as a tile's worker holds them. It may be used from any thread.
+class OverzoomBucketCache : private util::noncopyable {
+public:
+    class Entry {
+    public:
+        // The encoded tile the bucket was laid out from.
+        std::shared_ptr<const Buffer> data;
+
+        // A bucket that has never been uploaded.
+        std::unique_ptr<const Bucket> bucket;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+
+        std::size_t entries = 0;
+    };
+
+    static OverzoomBucketCache& get();
+
+    // Returns the bucket stored under the key if it was laid out from the given tile data.
+    std::shared_ptr<const Entry> find(const std::string& key, const Buffer& data);
+    void add(const std::string& key, const std::shared_ptr<const Entry>&);
+
+    Stats getStats() const;
+
+private:
+    // Number of entries below which the cache is never swept.
+    static constexpr std::size_t minimumSweepSize = 64;
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, std::weak_ptr<const Entry>> entries;
+    // The number of entries above which add() drops the expired ones.
+    std::size_t sweepSize = minimumSweepSize;
+    Stats stats;
+};
+
+} // namespace mbgl
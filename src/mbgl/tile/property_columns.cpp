@@ -0,0 +1,22 @@
+#include <mbgl/tile/property_columns.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+
+constexpr std::size_t PropertyColumns::noKey;
+
+std::size_t PropertyColumns::find(const std::string& key) const {
+    auto it = std::find(keys.begin(), keys.end(), key);
+    return it == keys.end() ? noKey : std::size_t(it - keys.begin());
+}
+
+optional<Value> ColumnarFeature::getValue(const std::string& key) const {
+    const std::size_t column = columns.find(key);
+    if (column == PropertyColumns::noKey) {
+        return feature.getValue(key);
+    }
+    return columns.get(column, index);
+}
+
+} // namespace mbgl
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// The values of some properties of all the features of a source layer, one column for each
+// property. The data-driven paint properties of a layer group read the same few properties
+// of every feature; GeometryTileLayer::decodeProperties() fills the columns in one pass over
+// the features, rather than each binder looking its property up among the feature's tags.
+// Columns are referred to by the index of their key in getKeys().
+class PropertyColumns {
+public:
+    PropertyColumns(std::vector<std::string> keys_, std::size_t featureCount_)
+        : keys(std::move(keys_)),
+          featureCount(featureCount_),
+          values(keys.size() * featureCount) {
+    }
+
+    const std::vector<std::string>& getKeys() const { return keys; }
+    std::size_t getFeatureCount() const { return featureCount; }
+
+    // Returns the index of the key, or noKey if there's no column for it.
+    std::size_t find(const std::string& key) const;
+
+    const optional<Value>& get(std::size_t key, std::size_t feature) const {
+        return values[key * featureCount + feature];
+    }
+
+    optional<Value>& get(std::size_t key, std::size_t feature) {
+        return values[key * featureCount + feature];
+    }
+
+    static constexpr std::size_t noKey = std::numeric_limits<std::size_t>::max();
+
+private:
+    std::vector<std::string> keys;
+    std::size_t featureCount;
+    std::vector<optional<Value>> values;
+};
+
+// A feature whose properties that have a column are read from it; the others are looked up as
+// usual.
+class ColumnarFeature : public GeometryTileFeature {
+public:
+    ColumnarFeature(const GeometryTileFeature& feature_, const PropertyColumns& columns_, std::size_t index_)
+        : feature(feature_), columns(columns_), index(index_) {
+    }
+
+    FeatureType getType() const override { return feature.getType(); }
+    optional<Value> getValue(const std::string& key) const override;
+    PropertyMap getProperties() const override { return feature.getProperties(); }
+    optional<FeatureIdentifier> getID() const override { return feature.getID(); }
+    GeometryCollection getGeometries() const override { return feature.getGeometries(); }
+    void readGeometries(GeometryCollection& result) const override { feature.readGeometries(result); }
+
+private:
+    const GeometryTileFeature& feature;
+    const PropertyColumns& columns;
+    const std::size_t index;
+};
+
+} // namespace mbgl
@@ -0,0 +1,86 @@
+#include <mbgl/tile/raster_dem_tile.hpp>
+#include <mbgl/tile/raster_dem_tile_worker.hpp>
+#include <mbgl/tile/tile_observer.hpp>
+#include <mbgl/tile/tile_loader_impl.hpp>
+#include <mbgl/style/source.hpp>
+#include <mbgl/style/update_parameters.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/renderer/hillshade_bucket.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+namespace mbgl {
+
+RasterDEMTile::RasterDEMTile(const OverscaledTileID& id_,
+                             const style::UpdateParameters& parameters,
+                             const Tileset& tileset)
+    : Tile(id_),
+      // Neighbouring tiles backfill each other's borders, which takes them being the same size.
+      loader(*this, id_, parameters, tileset, false),
+      mailbox(std::make_shared<Mailbox>(*util::RunLoop::Get())),
+      worker(parameters.workerScheduler,
+             ActorRef<RasterDEMTile>(*this, mailbox)) {
+}
+
+RasterDEMTile::~RasterDEMTile() = default;
+
+void RasterDEMTile::cancel() {
+}
+
+void RasterDEMTile::setError(std::exception_ptr err) {
+    observer->onTileError(*this, err);
+}
+
+void RasterDEMTile::setData(std::shared_ptr<const Buffer> data,
+                            optional<Timestamp> modified_,
+                            optional<Timestamp> expires_) {
+    modified = modified_;
+    expires = expires_;
+    worker.invokeLatest(&RasterDEMTileWorker::parse, data);
+}
+
+void RasterDEMTile::onParsed(std::unique_ptr<HillshadeBucket> result) {
+    bucket = std::move(result);
+    availableData = bucket ? DataAvailability::All : DataAvailability::None;
+    observer->onTileChanged(*this);
+}
+
+void RasterDEMTile::onError(std::exception_ptr err) {
+    bucket.reset();
+    availableData = DataAvailability::None;
+    observer->onTileError(*this, err);
+}
+
+void RasterDEMTile::backfillBorder(const RasterDEMTile& other, int8_t dx, int8_t dy) {
+    if (bucket && other.bucket) {
+        bucket->backfillBorder(*other.bucket, dx, dy);
+    }
+}
+
+Bucket* RasterDEMTile::getBucket(const style::Layer&) {
+    return bucket.get();
+}
+
+std::size_t RasterDEMTile::getByteSize() const {
+    return bucket ? bucket->getByteSize() : 0;
+}
+
+void RasterDEMTile::getMemoryUsage(MemoryUsage::Tiles& usage) const {
+    if (bucket) {
+        const std::size_t bufferSize = bucket->getBufferByteSize();
+        usage.vertexData += bucket->getByteSize() - bufferSize;
+        usage.bufferData += bufferSize;
+    }
+}
+
+void RasterDEMTile::setPriority(int32_t priority) {
+    worker.setPriority(priority);
+    loader.setPriority(priority);
+}
+
+void RasterDEMTile::setNecessity(Necessity necessity) {
+    loader.setNecessity(necessity);
+}
+
+} // namespace mbgl
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <mbgl/tile/tile.hpp>
+#include <mbgl/tile/tile_loader.hpp>
+#include <mbgl/tile/raster_dem_tile_worker.hpp>
+#include <mbgl/actor/actor.hpp>
+
+namespace mbgl {
+
+class Tileset;
+class HillshadeBucket;
+
+namespace style {
+class Layer;
+class UpdateParameters;
+} // namespace style
+
+class RasterDEMTile : public Tile {
+public:
+    RasterDEMTile(const OverscaledTileID&,
+                  const style::UpdateParameters&,
+                  const Tileset&);
+    ~RasterDEMTile() final;
+
+    void setNecessity(Necessity) final;
+    void setPriority(int32_t) override;
+
+    void setError(std::exception_ptr);
+    void setData(std::shared_ptr<const Buffer> data,
+                 optional<Timestamp> modified_,
+                 optional<Timestamp> expires_);
+
+    void cancel() override;
+    Bucket* getBucket(const style::Layer&) override;
+    std::size_t getByteSize() const override;
+    void getMemoryUsage(MemoryUsage::Tiles&) const override;
+
+    // Copies the edge of a neighbouring tile into the border of this one, given the offset of
+    // the other tile in tiles. Does nothing unless the elevations of both tiles are loaded.
+    void backfillBorder(const RasterDEMTile& other, int8_t dx, int8_t dy);
+
+    void onParsed(std::unique_ptr<HillshadeBucket> result);
+    void onError(std::exception_ptr);
+
+private:
+    TileLoader<RasterDEMTile> loader;
+
+    std::shared_ptr<Mailbox> mailbox;
+    Actor<RasterDEMTileWorker> worker;
+
+    // Holds the elevations of the tile once it's parsed.
+    std::unique_ptr<HillshadeBucket> bucket;
+};
+
+} // namespace mbgl
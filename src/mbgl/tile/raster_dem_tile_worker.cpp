@@ -0,0 +1,28 @@
+#include <mbgl/tile/raster_dem_tile_worker.hpp>
+#include <mbgl/tile/raster_dem_tile.hpp>
+#include <mbgl/renderer/hillshade_bucket.hpp>
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/buffer.hpp>
+
+namespace mbgl {
+
+RasterDEMTileWorker::RasterDEMTileWorker(ActorRef<RasterDEMTileWorker>, ActorRef<RasterDEMTile> parent_)
+    : parent(std::move(parent_)) {
+}
+
+void RasterDEMTileWorker::parse(std::shared_ptr<const Buffer> data) {
+    if (!data) {
+        parent.invoke(&RasterDEMTile::onParsed, nullptr); // No data; empty tile.
+        return;
+    }
+
+    try {
+        auto bucket = std::make_unique<HillshadeBucket>(
+            DEMData(decodeUnassociatedImage(data->bytes(), data->size())));
+        parent.invoke(&RasterDEMTile::onParsed, std::move(bucket));
+    } catch (...) {
+        parent.invoke(&RasterDEMTile::onError, std::current_exception());
+    }
+}
+
+} // namespace mbgl
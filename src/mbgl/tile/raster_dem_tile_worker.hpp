@@ -0,0 +1,24 @@
+#pragma once
+
+#include <mbgl/actor/actor_ref.hpp>
+
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class Buffer;
+class RasterDEMTile;
+
+class RasterDEMTileWorker {
+public:
+    RasterDEMTileWorker(ActorRef<RasterDEMTileWorker>, ActorRef<RasterDEMTile>);
+
+    // Decodes the image and its elevations, so that the render thread only uploads them.
+    void parse(std::shared_ptr<const Buffer> data);
+
+private:
+    ActorRef<RasterDEMTile> parent;
+};
+
+} // namespace mbgl
@@ -31,12 +31,12 @@ void RasterTile::setError(std::exception_ptr err) {
     observer->onTileError(*this, err);
 }
 
-void RasterTile::setData(std::shared_ptr<const std::string> data,
+void RasterTile::setData(std::shared_ptr<const Buffer> data,
                              optional<Timestamp> modified_,
                              optional<Timestamp> expires_) {
     modified = modified_;
     expires = expires_;
-    worker.invoke(&RasterTileWorker::parse, data);
+    worker.invokeLatest(&RasterTileWorker::parse, data);
 }
 
 void RasterTile::onParsed(std::unique_ptr<Bucket> result) {
@@ -55,6 +55,23 @@ Bucket* RasterTile::getBucket(const style::Layer&) {
     return bucket.get();
 }
 
+std::size_t RasterTile::getByteSize() const {
+    return bucket ? bucket->getByteSize() : 0;
+}
+
+void RasterTile::getMemoryUsage(MemoryUsage::Tiles& usage) const {
+    if (bucket) {
+        const std::size_t bufferSize = bucket->getBufferByteSize();
+        usage.vertexData += bucket->getByteSize() - bufferSize;
+        usage.bufferData += bufferSize;
+    }
+}
+
+void RasterTile::setPriority(int32_t priority) {
+    worker.setPriority(priority);
+    loader.setPriority(priority);
+}
+
 void RasterTile::setNecessity(Necessity necessity) {
     loader.setNecessity(necessity);
 }
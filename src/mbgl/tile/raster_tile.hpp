@@ -22,14 +22,17 @@ public:
     ~RasterTile() final;
 
     void setNecessity(Necessity) final;
+    void setPriority(int32_t) override;
 
     void setError(std::exception_ptr);
-    void setData(std::shared_ptr<const std::string> data,
+    void setData(std::shared_ptr<const Buffer> data,
                  optional<Timestamp> modified_,
                  optional<Timestamp> expires_);
 
     void cancel() override;
     Bucket* getBucket(const style::Layer&) override;
+    std::size_t getByteSize() const override;
+    void getMemoryUsage(MemoryUsage::Tiles&) const override;
 
     void onParsed(std::unique_ptr<Bucket> result);
     void onError(std::exception_ptr);
@@ -2,7 +2,8 @@
 #include <mbgl/tile/raster_tile.hpp>
 #include <mbgl/renderer/raster_bucket.hpp>
 #include <mbgl/actor/actor.hpp>
-#include <mbgl/util/premultiply.hpp>
+#include <mbgl/util/buffer.hpp>
+#include <mbgl/util/compressed_image.hpp>
 
 namespace mbgl {
 
@@ -10,14 +11,16 @@ RasterTileWorker::RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTi
     : parent(std::move(parent_)) {
 }
 
-void RasterTileWorker::parse(std::shared_ptr<const std::string> data) {
+void RasterTileWorker::parse(std::shared_ptr<const Buffer> data) {
     if (!data) {
         parent.invoke(&RasterTile::onParsed, nullptr); // No data; empty tile.
         return;
     }
 
     try {
-        auto bucket = std::make_unique<RasterBucket>(util::unpremultiply(decodeImage(*data)));
+        auto bucket = isKTX(data->bytes(), data->size())
+            ? std::make_unique<RasterBucket>(decodeKTX(data->bytes(), data->size()))
+            : std::make_unique<RasterBucket>(decodeUnassociatedImage(data->bytes(), data->size()));
         parent.invoke(&RasterTile::onParsed, std::move(bucket));
     } catch (...) {
         parent.invoke(&RasterTile::onError, std::current_exception());
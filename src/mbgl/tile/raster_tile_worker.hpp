@@ -7,13 +7,14 @@
 
 namespace mbgl {
 
+class Buffer;
 class RasterTile;
 
 class RasterTileWorker {
 public:
     RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile>);
 
-    void parse(std::shared_ptr<const std::string> data);
+    void parse(std::shared_ptr<const Buffer> data);
 
 private:
     ActorRef<RasterTile> parent;
@@ -0,0 +1,94 @@
+#include <mbgl/tile/shared_layout_cache.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/util/buffer.hpp>
+
+namespace mbgl {
+
+std::size_t SharedLayoutCache::Layout::getByteSize() const {
+    std::size_t size = data ? data->size() : 0;
+    for (const auto& bucket : buckets) {
+        size += bucket.second->getByteSize();
+    }
+    if (featureIndex) {
+        size += featureIndex->getByteSize();
+    }
+    return size;
+}
+
+SharedLayoutCache& SharedLayoutCache::get() {
+    static SharedLayoutCache cache;
+    return cache;
+}
+
+void SharedLayoutCache::setMaximumBytes(std::size_t maximumBytes_) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maximumBytes = maximumBytes_;
+    evict();
+}
+
+std::shared_ptr<const SharedLayoutCache::Layout> SharedLayoutCache::find(const std::string& key, const Buffer& data) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = index.find(key);
+    if (it == index.end() || *it->second->layout->data != data) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    entries.splice(entries.begin(), entries, it->second);
+    stats.hits++;
+    return it->second->layout;
+}
+
+void SharedLayoutCache::add(const std::string& key, std::shared_ptr<const Layout> layout) {
+    const std::size_t bytes = layout->getByteSize();
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (bytes > maximumBytes) {
+        return;
+    }
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Another map laid out the same tile in the meantime, or the tile data changed.
+        stats.bytes -= it->second->bytes;
+        it->second->layout = std::move(layout);
+        it->second->bytes = bytes;
+        entries.splice(entries.begin(), entries, it->second);
+    } else {
+        entries.push_front({ key, std::move(layout), bytes });
+        index.emplace(key, entries.begin());
+        stats.layouts++;
+    }
+
+    stats.bytes += bytes;
+    evict();
+}
+
+void SharedLayoutCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    stats.layouts = 0;
+    stats.bytes = 0;
+}
+
+SharedLayoutCache::Stats SharedLayoutCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void SharedLayoutCache::evict() {
+    while (stats.bytes > maximumBytes) {
+        const Entry& oldest = entries.back();
+        stats.bytes -= oldest.bytes;
+        stats.layouts--;
+        stats.evictions++;
+        index.erase(oldest.key);
+        entries.pop_back();
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+class Buffer;
+class Bucket;
+class FeatureIndex;
+
+// Layout results of vector tiles, shared by all maps in the process. A map that renders the
+// same layers over the same tile data as another one copies the other map's non-symbol buckets
+// and feature index from here instead of laying out the tile again. Each map uploads its own
+// copies; symbol layout and placement are not shared.
+//
+// The cache is disabled until it is given a size. It may be used from any thread.
+class SharedLayoutCache : private util::noncopyable {
+public:
+    class Layout {
+    public:
+        // The encoded tile the layout was computed from.
+        std::shared_ptr<const Buffer> data;
+
+        // Buckets that have never been uploaded, with the IDs of the layers that share them.
+        std::vector<std::pair<std::vector<std::string>, std::unique_ptr<const Bucket>>> buckets;
+
+        std::unique_ptr<const FeatureIndex> featureIndex;
+
+        std::size_t getByteSize() const;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+
+        std::size_t layouts = 0;
+        std::size_t bytes = 0;
+    };
+
+    static SharedLayoutCache& get();
+
+    void setMaximumBytes(std::size_t);
+    bool isEnabled() const { return maximumBytes > 0; }
+
+    // Returns the layout stored under the key if it was computed from the given tile data.
+    std::shared_ptr<const Layout> find(const std::string& key, const Buffer& data);
+    void add(const std::string& key, std::shared_ptr<const Layout>);
+    void clear();
+
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const Layout> layout;
+        std::size_t bytes;
+    };
+
+    void evict();
+
+    std::atomic<std::size_t> maximumBytes { 0 };
+
+    mutable std::mutex mutex;
+
+    // Most recently used first.
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    Stats stats;
+};
+
+} // namespace mbgl
@@ -36,6 +36,12 @@ void Tile::queryRenderedFeatures(
         const TransformState&,
         const RenderedQueryOptions&) {}
 
+void Tile::queryRenderedFeatureHandles(
+        std::vector<RenderedFeatureHandle>&,
+        const GeometryCoordinates&,
+        const TransformState&,
+        const RenderedQueryOptions&) {}
+
 void Tile::querySourceFeatures(
         std::vector<Feature>&,
         const style::SourceQueryOptions&) {}
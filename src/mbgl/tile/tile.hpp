@@ -5,9 +5,12 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/tile_coordinate.hpp>
+#include <mbgl/map/memory_usage.hpp>
 #include <mbgl/tile/tile_id.hpp>
+#include <mbgl/tile/tile_trace.hpp>
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/feature_state.hpp>
 #include <mbgl/storage/resource.hpp>
 
 #include <string>
@@ -21,7 +24,13 @@ class DebugBucket;
 class TransformState;
 class TileObserver;
 class PlacementConfig;
+class CollisionBox;
 class RenderedQueryOptions;
+class RenderedFeatureHandle;
+
+namespace gl {
+class BufferArena;
+} // namespace gl
 
 namespace style {
 class Layer;
@@ -49,19 +58,67 @@ public:
 
     virtual Bucket* getBucket(const style::Layer&) = 0;
 
+    // Returns the arena that the vertex and index buffers of this tile's buckets are allocated
+    // from, or nullptr if each bucket creates its own buffers.
+    virtual gl::BufferArena* getBufferArena() { return nullptr; }
+
+    // Frees the buffers of the tile's buckets, which are uploaded again once the tile is rendered,
+    // for when the context holds more than its memory budget. Returns false if some of them
+    // couldn't be freed; see Bucket::releaseBuffers().
+    virtual bool releaseBuffers() { return false; }
+
+    // Returns the approximate number of bytes retained by this tile: its buckets, feature
+    // index and source data. Used to limit the memory held by the tile cache.
+    virtual std::size_t getByteSize() const = 0;
+
+    // Adds the breakdown of getByteSize() to the given totals.
+    virtual void getMemoryUsage(MemoryUsage::Tiles&) const {}
+
+    // Hints how urgently this tile's pending work should be processed relative to other
+    // tiles. Work for tiles with a higher priority is processed first.
+    virtual void setPriority(int32_t) {}
+
     virtual void setPlacementConfig(const PlacementConfig&) {}
+
+    // Returns the boxes of the symbols placed near the edges of the tile, which the adjacent
+    // tiles place their own symbols around, or nullptr if the tile hasn't been placed yet.
+    virtual std::shared_ptr<const std::vector<CollisionBox>> getEdgeCollisionBoxes() const {
+        return nullptr;
+    }
+
     virtual void redoLayout() {}
 
+    // Repaints the buckets whose features changed state since the tile was last given the
+    // states of its source.
+    virtual void setFeatureStates(const FeatureStates&) {}
+
+    // Returns the data that the tile's buckets were laid out from, or nullptr if the tile has
+    // no features.
+    virtual std::shared_ptr<const GeometryTileData> getSharedData() const {
+        return nullptr;
+    }
+
     virtual void queryRenderedFeatures(
             std::unordered_map<std::string, std::vector<Feature>>& result,
             const GeometryCoordinates& queryGeometry,
             const TransformState&,
             const RenderedQueryOptions& options);
 
+    virtual void queryRenderedFeatureHandles(
+            std::vector<RenderedFeatureHandle>& result,
+            const GeometryCoordinates& queryGeometry,
+            const TransformState&,
+            const RenderedQueryOptions& options);
+
     virtual void querySourceFeatures(
             std::vector<Feature>& result,
             const style::SourceQueryOptions&);
 
+    // Returns the layers of getSharedData() that a source query with the given options reads.
+    virtual std::vector<std::string> getSourceQueryLayers(const style::SourceQueryOptions&) const {
+        return {};
+    }
+
     void setTriedOptional();
 
     // Returns true when the tile source has received a first response, regardless of whether a load
@@ -90,6 +147,8 @@ public:
     // Contains the tile ID string for painting debug information.
     std::unique_ptr<DebugBucket> debugBucket;
 
+    TileTrace trace;
+
 protected:
     bool triedOptional = false;
 
@@ -5,16 +5,72 @@
 
 namespace mbgl {
 
+TileCache::Budget::Budget(std::size_t maximumBytes_)
+    : maximumBytes(maximumBytes_) {
+}
+
+TileCache::Budget::~Budget() {
+    // Caches hold on to their budget, so it can only be destroyed once they are empty.
+    assert(!entries.front());
+}
+
+void TileCache::Budget::setMaximumBytes(std::size_t maximumBytes_) {
+    maximumBytes = maximumBytes_;
+    evict();
+}
+
+void TileCache::Budget::insert(Entry& entry) {
+    entries.push_back(entry);
+    stats.tiles++;
+    stats.bytes += entry.bytes;
+}
+
+void TileCache::Budget::erase(Entry& entry) {
+    entries.erase(entry);
+    stats.tiles--;
+    stats.bytes -= entry.bytes;
+}
+
+void TileCache::Budget::evict() {
+    while (stats.bytes > maximumBytes) {
+        Entry& oldest = *entries.front();
+        oldest.cache->evict(oldest);
+    }
+}
+
+TileCache::TileCache(size_t size_)
+    : size(size_) {
+}
+
+TileCache::~TileCache() {
+    clear();
+}
+
 void TileCache::setSize(size_t size_) {
     size = size_;
 
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.pop_front();
-        tiles.erase(key);
+    while (stats.tiles > size) {
+        evict(*entries.front());
+    }
+
+    assert(tiles.size() <= size);
+}
+
+void TileCache::setBudget(std::shared_ptr<Budget> budget_) {
+    if (budget) {
+        for (Entry* entry = entries.front(); entry; entry = entry->cacheHook.next) {
+            budget->erase(*entry);
+        }
     }
 
-    assert(orderedKeys.size() <= size);
+    budget = std::move(budget_);
+
+    if (budget) {
+        for (Entry* entry = entries.front(); entry; entry = entry->cacheHook.next) {
+            budget->insert(*entry);
+        }
+        budget->evict();
+    }
 }
 
 void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
@@ -22,33 +78,60 @@ void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
         return;
     }
 
-    // insert new or query existing tile
-    if (tiles.emplace(key, std::move(tile)).second) {
-        // remove existing tile key
-        orderedKeys.remove(key);
+    auto it = tiles.find(key);
+    if (it != tiles.end()) {
+        // Keep the existing tile, but treat it as the newest.
+        Entry& entry = it->second;
+        entries.erase(entry);
+        entries.push_back(entry);
+        if (budget) {
+            budget->erase(entry);
+            budget->insert(entry);
+        }
+        return;
+    }
+
+    const std::size_t bytes = tile->getByteSize();
+    if (budget && bytes > budget->maximumBytes) {
+        // Caching it would evict everything else.
+        stats.evictions++;
+        budget->stats.evictions++;
+        return;
     }
 
-    // (re-)insert tile key as newest
-    orderedKeys.push_back(key);
+    Entry& entry = tiles.emplace(key, Entry { key, std::move(tile), bytes, this, {}, {} }).first->second;
+    entries.push_back(entry);
+    stats.tiles++;
+    stats.bytes += bytes;
+
+    // purge oldest tiles if necessary
+    if (stats.tiles > size) {
+        evict(*entries.front());
+    }
 
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
-        get(orderedKeys.front());
+    if (budget) {
+        budget->insert(entry);
+        budget->evict();
     }
 
-    assert(orderedKeys.size() <= size);
+    assert(tiles.size() <= size);
 }
 
 std::unique_ptr<Tile> TileCache::get(const OverscaledTileID& key) {
-
     std::unique_ptr<Tile> tile;
 
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        tile = std::move(it->second);
-        tiles.erase(it);
-        orderedKeys.remove(key);
+        tile = std::move(it->second.tile);
+        erase(it);
         assert(tile->isRenderable());
+        stats.hits++;
+    } else {
+        stats.misses++;
+    }
+
+    if (budget) {
+        (tile ? budget->stats.hits : budget->stats.misses)++;
     }
 
     return tile;
@@ -59,8 +142,50 @@ bool TileCache::has(const OverscaledTileID& key) {
 }
 
 void TileCache::clear() {
-    orderedKeys.clear();
-    tiles.clear();
+    while (Entry* entry = entries.front()) {
+        erase(tiles.find(entry->id));
+    }
+}
+
+void TileCache::clear(const std::function<bool (const OverscaledTileID&)>& predicate) {
+    Entry* entry = entries.front();
+    while (entry) {
+        Entry* next = entry->cacheHook.next;
+        if (predicate(entry->id)) {
+            erase(tiles.find(entry->id));
+        }
+        entry = next;
+    }
+}
+
+void TileCache::releaseBuffers(const std::function<bool ()>& satisfied) {
+    Entry* entry = entries.front();
+    while (entry && !satisfied()) {
+        Entry* next = entry->cacheHook.next;
+        if (!entry->tile->releaseBuffers()) {
+            evict(*entry);
+        }
+        entry = next;
+    }
+}
+
+void TileCache::erase(Tiles::iterator it) {
+    Entry& entry = it->second;
+    entries.erase(entry);
+    stats.tiles--;
+    stats.bytes -= entry.bytes;
+    if (budget) {
+        budget->erase(entry);
+    }
+    tiles.erase(it);
+}
+
+void TileCache::evict(Entry& entry) {
+    stats.evictions++;
+    if (budget) {
+        budget->stats.evictions++;
+    }
+    erase(tiles.find(entry.id));
 }
 
 } // namespace mbgl
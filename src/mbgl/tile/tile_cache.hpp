@@ -1,31 +1,138 @@
 #pragma once
 
 #include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/noncopyable.hpp>
 
-#include <list>
+#include <cstdint>
+#include <functional>
 #include <memory>
-#include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
 class Tile;
 
-class TileCache {
+// Holds tiles that are no longer needed for rendering so that they can be reused when they are
+// needed again. Tiles are evicted in the order in which they were added once the cache holds
+// more than `size` tiles, or once the caches that share its budget hold more than the budget's
+// number of bytes.
+class TileCache : private util::noncopyable {
+private:
+    struct Entry;
+
+    struct Hook {
+        Entry* previous = nullptr;
+        Entry* next = nullptr;
+    };
+
+    // A doubly linked list threaded through the entries, so that an entry can be removed from
+    // the cache and from its budget in constant time.
+    template <Hook Entry::*hook>
+    class List {
+    public:
+        Entry* front() const { return first; }
+
+        void push_back(Entry& entry) {
+            (entry.*hook).previous = last;
+            (entry.*hook).next = nullptr;
+            (last ? (last->*hook).next : first) = &entry;
+            last = &entry;
+        }
+
+        void erase(Entry& entry) {
+            Hook& links = entry.*hook;
+            (links.previous ? (links.previous->*hook).next : first) = links.next;
+            (links.next ? (links.next->*hook).previous : last) = links.previous;
+            links = Hook();
+        }
+
+    private:
+        Entry* first = nullptr;
+        Entry* last = nullptr;
+    };
+
+    struct Entry {
+        OverscaledTileID id;
+        std::unique_ptr<Tile> tile;
+        std::size_t bytes;
+        TileCache* cache;
+
+        Hook cacheHook;
+        Hook budgetHook;
+    };
+
 public:
-    TileCache(size_t size_ = 0) : size(size_) {}
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+
+        std::size_t tiles = 0;
+        std::size_t bytes = 0;
+    };
+
+    // Limits the total size of the tiles in all caches that share it, typically the caches of
+    // all sources of a style. The least recently added tile of any of the caches is evicted
+    // first, and its statistics cover all of them.
+    class Budget : private util::noncopyable {
+    public:
+        explicit Budget(std::size_t maximumBytes);
+        ~Budget();
+
+        void setMaximumBytes(std::size_t);
+        std::size_t getMaximumBytes() const { return maximumBytes; }
+
+        const Stats& getStats() const { return stats; }
+
+    private:
+        friend class TileCache;
+
+        void insert(Entry&);
+        void erase(Entry&);
+        void evict();
+
+        std::size_t maximumBytes;
+        Stats stats;
+        List<&Entry::budgetHook> entries;
+    };
+
+    TileCache(size_t size_ = 0);
+    ~TileCache();
 
     void setSize(size_t);
     size_t getSize() const { return size; };
+
+    // Tiles are measured when they are added; the cache does not track changes to the size of
+    // the tiles it holds.
+    void setBudget(std::shared_ptr<Budget>);
+
     void add(const OverscaledTileID& key, std::unique_ptr<Tile> data);
     std::unique_ptr<Tile> get(const OverscaledTileID& key);
     bool has(const OverscaledTileID& key);
     void clear();
 
+    // Removes the tiles for which `predicate` returns true, for example because their data is out
+    // of date. Like clear(), this doesn't count as evicting them.
+    void clear(const std::function<bool (const OverscaledTileID&)>& predicate);
+
+    // Releases the buffers of the tiles, the least recently added first, until `satisfied`
+    // returns true. Tiles whose buffers can't all be released are evicted instead.
+    void releaseBuffers(const std::function<bool ()>& satisfied);
+
+    const Stats& getStats() const { return stats; }
+
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
-    std::list<OverscaledTileID> orderedKeys;
+    using Tiles = std::unordered_map<OverscaledTileID, Entry>;
+
+    void erase(Tiles::iterator);
+    void evict(Entry&);
+
+    Tiles tiles;
+    List<&Entry::cacheHook> entries;
 
     size_t size;
+    std::shared_ptr<Budget> budget;
+    Stats stats;
 };
 
 } // namespace mbgl
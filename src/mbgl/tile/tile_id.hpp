@@ -30,9 +30,9 @@ public:
     CanonicalTileID scaledTo(uint8_t z) const;
     std::array<CanonicalTileID, 4> children() const;
 
-    const uint8_t z;
-    const uint32_t x;
-    const uint32_t y;
+    uint8_t z;
+    uint32_t x;
+    uint32_t y;
 };
 
 ::std::ostream& operator<<(::std::ostream& os, const CanonicalTileID& rhs);
@@ -59,8 +59,8 @@ public:
     OverscaledTileID scaledTo(uint8_t z) const;
     UnwrappedTileID unwrapTo(int16_t wrap) const;
 
-    const uint8_t overscaledZ;
-    const CanonicalTileID canonical;
+    uint8_t overscaledZ;
+    CanonicalTileID canonical;
 };
 
 ::std::ostream& operator<<(::std::ostream& os, const OverscaledTileID& rhs);
@@ -84,8 +84,8 @@ public:
     OverscaledTileID overscaleTo(uint8_t z) const;
     float pixelsToTileUnits(float pixelValue, float zoom) const;
 
-    const int16_t wrap;
-    const CanonicalTileID canonical;
+    int16_t wrap;
+    CanonicalTileID canonical;
 };
 
 ::std::ostream& operator<<(::std::ostream& os, const UnwrappedTileID& rhs);
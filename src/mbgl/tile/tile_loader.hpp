@@ -3,6 +3,7 @@
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/util/optional.hpp>
 
 namespace mbgl {
 
@@ -18,26 +19,39 @@ class UpdateParameters;
 template <typename T>
 class TileLoader : private util::noncopyable {
 public:
+    // Unless the resolution is adaptive, tiles are always requested at the pixel ratio of the map.
     TileLoader(T&,
                const OverscaledTileID&,
                const style::UpdateParameters&,
-               const Tileset&);
+               const Tileset&,
+               bool adaptiveResolution = true);
     ~TileLoader();
 
     using Necessity = Resource::Necessity;
 
     void setNecessity(Necessity newNecessity) {
-        if (newNecessity != necessity) {
+        if (!started) {
+            necessity = newNecessity;
+            start();
+        } else if (newNecessity != necessity) {
             necessity = newNecessity;
             if (necessity == Necessity::Required) {
                 makeRequired();
             } else {
                 makeOptional();
             }
+        } else if (fullResolution && necessity == Necessity::Required) {
+            upgradeResolution();
         }
     }
 
+    // Passes the priority of the tile on to the request for its data while the tile has none
+    // yet. Revalidations of tiles that already have data keep the priority they started with.
+    void setPriority(int32_t);
+
 private:
+    static Resource tileResource(const Tileset&, float pixelRatio, const CanonicalTileID&);
+
     // called when the tile is one of the ideal tiles that we want to show definitely. the tile source
     // should try to make every effort (e.g. fetch from internet, or revalidate existing resources).
     void makeRequired();
@@ -48,15 +62,33 @@ private:
     // an up-to-date version or load new data
     void makeOptional();
 
+    // Makes the first request, once the source has told the tile whether it is required.
+    void start();
+
     void loadOptional();
     void loadedData(const Response&);
     void loadRequired();
+    // Loads the tile from the cache and then from the network with a single request, which
+    // reports a cache miss like an optional request would.
+    void loadCacheThenNetwork();
+
+    // Replaces the data that was requested at a lower resolution on a slow network with that of
+    // the full resolution, once the network is faster and the tile is still visible.
+    void upgradeResolution();
 
     T& tile;
     Necessity necessity;
     Resource resource;
     FileSource& fileSource;
     std::unique_ptr<AsyncRequest> request;
+
+    // The resource at the pixel ratio of the map, while the tile is loaded at a lower one.
+    optional<Resource> fullResolution;
+
+    // Whether the first request was made, and whether a request of loadCacheThenNetwork() is
+    // still waiting for the answer of the cache.
+    bool started = false;
+    bool awaitingCache = false;
 };
 
 } // namespace mbgl
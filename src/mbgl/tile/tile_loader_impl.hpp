@@ -2,8 +2,10 @@
 
 #include <mbgl/tile/tile_loader.hpp>
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/util/tileset.hpp>
+#include <mbgl/util/tile_url_template.hpp>
 
 #include <cassert>
 
@@ -13,48 +15,74 @@ template <typename T>
 TileLoader<T>::TileLoader(T& tile_,
                           const OverscaledTileID& id,
                           const style::UpdateParameters& parameters,
-                          const Tileset& tileset)
+                          const Tileset& tileset,
+                          bool adaptiveResolution)
     : tile(tile_),
       necessity(Necessity::Optional),
-      resource(Resource::tile(
-        tileset.tiles.at(0),
-        parameters.pixelRatio,
-        id.canonical.x,
-        id.canonical.y,
-        id.canonical.z,
-        tileset.scheme)),
+      resource(tileResource(tileset, parameters.pixelRatio, id.canonical)),
       fileSource(parameters.fileSource) {
+    // On a slow network, continuous maps request tiles at a pixel ratio of 1 first, and the full
+    // resolution once the network allows. That only makes a difference to tiles whose URL
+    // depends on the ratio.
+    if (adaptiveResolution && parameters.mode == MapMode::Continuous && parameters.pixelRatio > 1 &&
+        NetworkStatus::IsSlow()) {
+        Resource reduced = tileResource(tileset, 1, id.canonical);
+        if (reduced.url != resource.url) {
+            fullResolution = std::move(resource);
+            resource = std::move(reduced);
+        }
+    }
+
+    // The first request waits for the necessity, which the source sets right after creating
+    // the tile. We're using this field to check whether the pending request is optional or
+    // required.
+    resource.necessity = Resource::Optional;
+}
+
+template <typename T>
+TileLoader<T>::~TileLoader() = default;
+
+template <typename T>
+Resource TileLoader<T>::tileResource(const Tileset& tileset, float pixelRatio, const CanonicalTileID& id) {
+    // Sources parse the template once for all of their tiles; tilesets that weren't loaded by a
+    // source are parsed here.
+    if (tileset.urlTemplate) {
+        return Resource::tile(*tileset.urlTemplate, pixelRatio, id.x, id.y, id.z, tileset.scheme);
+    }
+    return Resource::tile(tileset.tiles.at(0), pixelRatio, id.x, id.y, id.z, tileset.scheme);
+}
+
+template <typename T>
+void TileLoader<T>::start() {
     assert(!request);
+    started = true;
+
     if (fileSource.supportsOptionalRequests()) {
-        // When supported, the first request is always optional, even if the TileLoader
-        // is marked as required. That way, we can let the first optional request continue
-        // to load when the TileLoader is later changed from required to optional. If we
-        // started out with a required request, we'd have to cancel everything, including the
-        // initial optional part of the request.
-        loadOptional();
-    } else {
-        // When the FileSource doesn't support optional requests, we do nothing until the
-        // data is definitely required.
         if (necessity == Necessity::Required) {
-            loadRequired();
+            // Tiles that are required from the start are looked up in the cache and then loaded
+            // from the network by the file source itself, rather than with one request for each.
+            loadCacheThenNetwork();
         } else {
-            // We're using this field to check whether the pending request is optional or required.
-            resource.necessity = Resource::Optional;
+            loadOptional();
         }
+    } else if (necessity == Necessity::Required) {
+        // When the FileSource doesn't support optional requests, we do nothing until the
+        // data is definitely required.
+        loadRequired();
     }
 }
 
-template <typename T>
-TileLoader<T>::~TileLoader() = default;
-
 template <typename T>
 void TileLoader<T>::loadOptional() {
     assert(!request);
 
     resource.necessity = Resource::Optional;
-    request = fileSource.request(resource, [this](Response res) {
+    const TimePoint requested = Clock::now();
+    request = fileSource.request(resource, [this, requested](Response res) {
         request.reset();
 
+        tile.trace.addRequest(requested, res);
+
         tile.setTriedOptional();
 
         if (res.error && res.error->reason == Response::Error::Reason::NotFound) {
@@ -84,7 +112,40 @@ void TileLoader<T>::makeOptional() {
     if (resource.necessity == Resource::Required && request) {
         // Abort a potential HTTP request.
         request.reset();
+        if (awaitingCache) {
+            // The tile can still use what the cache has.
+            awaitingCache = false;
+            loadOptional();
+        }
+    }
+}
+
+template <typename T>
+void TileLoader<T>::setPriority(int32_t priority) {
+    if (priority != resource.priority) {
+        resource.priority = priority;
+        if (request && resource.necessity == Resource::Required && !tile.isRenderable()) {
+            request->setPriority(priority);
+        }
+    }
+}
+
+template <typename T>
+void TileLoader<T>::upgradeResolution() {
+    // Tiles that are still waiting for their data finish loading it first, and none are
+    // upgraded while the network is still slow.
+    if (!tile.isRenderable() || awaitingCache || NetworkStatus::IsSlow()) {
+        return;
     }
+
+    // The full resource takes over the priority, but not the validators of the reduced one,
+    // which belong to another URL.
+    fullResolution->priority = resource.priority;
+    resource = std::move(*fullResolution);
+    fullResolution = {};
+
+    request.reset();
+    loadRequired();
 }
 
 template <typename T>
@@ -108,7 +169,39 @@ void TileLoader<T>::loadRequired() {
     assert(!request);
 
     resource.necessity = Resource::Required;
-    request = fileSource.request(resource, [this](Response res) { loadedData(res); });
+    const TimePoint requested = Clock::now();
+    request = fileSource.request(resource, [this, requested](Response res) {
+        tile.trace.addRequest(requested, res);
+        loadedData(res);
+    });
+}
+
+template <typename T>
+void TileLoader<T>::loadCacheThenNetwork() {
+    assert(!request);
+
+    resource.necessity = Resource::Required;
+    resource.reportCacheMiss = true;
+    awaitingCache = true;
+    const TimePoint requested = Clock::now();
+    request = fileSource.request(resource, [this, requested](Response res) {
+        tile.trace.addRequest(requested, res);
+
+        if (awaitingCache) {
+            // The first response is the cache's, which the network's follows unless the
+            // request is cancelled.
+            awaitingCache = false;
+            resource.reportCacheMiss = false;
+            tile.setTriedOptional();
+            if (res.error && res.error->reason == Response::Error::Reason::NotFound) {
+                // Like the miss of an optional request; see loadOptional().
+                resource.priorExpires = Timestamp{ Seconds::zero() };
+                return;
+            }
+        }
+
+        loadedData(res);
+    });
 }
 
 } // namespace mbgl
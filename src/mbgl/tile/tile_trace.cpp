@@ -0,0 +1,116 @@
+#include <mbgl/tile/tile_trace.hpp>
+#include <mbgl/storage/response.hpp>
+
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+
+namespace mbgl {
+
+constexpr const char* TileTrace::Queue;
+constexpr const char* TileTrace::Network;
+constexpr const char* TileTrace::Store;
+constexpr const char* TileTrace::Request;
+constexpr const char* TileTrace::SetData;
+constexpr const char* TileTrace::Layout;
+constexpr const char* TileTrace::Repaint;
+constexpr const char* TileTrace::SymbolDependencies;
+constexpr const char* TileTrace::Prepare;
+constexpr const char* TileTrace::Place;
+constexpr const char* TileTrace::Upload;
+constexpr std::size_t TileTrace::MaxEvents;
+
+void TileTrace::add(const char* name, TimePoint start, TimePoint end, std::string layer) {
+    events.push_back({ name, std::move(layer), start, end - start });
+    if (events.size() > MaxEvents) {
+        events.pop_front();
+    }
+}
+
+void TileTrace::add(std::vector<Event> newEvents) {
+    for (auto& event : newEvents) {
+        events.push_back(std::move(event));
+    }
+    while (events.size() > MaxEvents) {
+        events.pop_front();
+    }
+}
+
+void TileTrace::addRequest(TimePoint requested, const Response& response) {
+    if (response.timing) {
+        const Response::Timing& timing = *response.timing;
+        add(Queue, timing.queued, timing.started);
+        add(Network, timing.started, timing.finished);
+        if (timing.store > Duration::zero()) {
+            add(Store, timing.finished, timing.finished + timing.store);
+        }
+    }
+    add(Request, requested, Clock::now());
+}
+
+static int64_t microseconds(Duration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+std::string encodeChromeTrace(const std::vector<std::pair<std::string, const TileTrace*>>& traces) {
+    rapidjson::StringBuffer s;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+
+    writer.StartObject();
+    writer.Key("traceEvents");
+    writer.StartArray();
+
+    int tid = 0;
+    for (const auto& trace : traces) {
+        tid++;
+
+        // Names the row that the tile's events are shown in.
+        writer.StartObject();
+        writer.Key("name");
+        writer.String("thread_name");
+        writer.Key("ph");
+        writer.String("M");
+        writer.Key("pid");
+        writer.Int(0);
+        writer.Key("tid");
+        writer.Int(tid);
+        writer.Key("args");
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(trace.first);
+        writer.EndObject();
+        writer.EndObject();
+
+        for (const auto& event : trace.second->getEvents()) {
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(event.name);
+            writer.Key("cat");
+            writer.String("tile");
+            writer.Key("ph");
+            writer.String("X");
+            writer.Key("ts");
+            writer.Int64(microseconds(event.start.time_since_epoch()));
+            writer.Key("dur");
+            writer.Int64(microseconds(event.duration));
+            writer.Key("pid");
+            writer.Int(0);
+            writer.Key("tid");
+            writer.Int(tid);
+            if (!event.layer.empty()) {
+                writer.Key("args");
+                writer.StartObject();
+                writer.Key("layer");
+                writer.String(event.layer);
+                writer.EndObject();
+            }
+            writer.EndObject();
+        }
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+
+    return s.GetString();
+}
+
+} // namespace mbgl
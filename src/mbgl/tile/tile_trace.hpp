@@ -0,0 +1,67 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+class Response;
+
+// Timestamps of the stages a tile went through, from requesting its data to uploading its
+// buckets: waiting for a network connection, the download, storing the response in the
+// offline database, parsing, layout and repainting on the worker, symbol preparation and
+// placement, waiting for glyphs and icons, and the GL upload. Only the most recent events are
+// kept.
+class TileTrace {
+public:
+    class Event {
+    public:
+        // One of the stage names below.
+        const char* name;
+
+        // The layer a symbol stage worked on; empty for the other stages.
+        std::string layer;
+
+        TimePoint start;
+        Duration duration;
+    };
+
+    static constexpr const char* Queue = "queue";
+    static constexpr const char* Network = "network";
+    static constexpr const char* Store = "store";
+    static constexpr const char* Request = "request";
+    static constexpr const char* SetData = "setData";
+    static constexpr const char* Layout = "layout";
+    static constexpr const char* Repaint = "repaint";
+    static constexpr const char* SymbolDependencies = "symbolDependencies";
+    static constexpr const char* Prepare = "prepare";
+    static constexpr const char* Place = "place";
+    static constexpr const char* Upload = "upload";
+
+    static constexpr std::size_t MaxEvents = 64;
+
+    void add(const char* name, TimePoint start, TimePoint end, std::string layer = {});
+    void add(std::vector<Event>);
+
+    // Adds the request stage, which spans from issuing the request to receiving the response,
+    // and the queue, network and store stages that the file source measured, if any.
+    void addRequest(TimePoint requested, const Response&);
+
+    const std::deque<Event>& getEvents() const {
+        return events;
+    }
+
+private:
+    std::deque<Event> events;
+};
+
+// Encodes the traces of the given tiles, labelled by the first member of each pair, in the
+// Chrome trace-event format, which can be loaded in about:tracing. Each tile appears as a
+// thread of its own.
+std::string encodeChromeTrace(const std::vector<std::pair<std::string, const TileTrace*>>&);
+
+} // namespace mbgl
@@ -2,29 +2,49 @@
 
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/tile/tile_loader.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <unordered_map>
 
 namespace mbgl {
 
+class Buffer;
 class Tileset;
+class VectorTileData;
 
 namespace style {
 class UpdateParameters;
 } // namespace style
 
+// The parsed data of the canonical tiles of a vector source, which the tiles overscaled from
+// one canonical tile share instead of each parsing the same bytes. Holds on to the data only
+// while a tile does.
+class VectorTileDataCache : private util::noncopyable {
+public:
+    std::shared_ptr<const VectorTileData> get(const CanonicalTileID&, std::shared_ptr<const Buffer>);
+
+private:
+    std::unordered_map<CanonicalTileID, std::weak_ptr<const VectorTileData>> entries;
+    std::size_t sweepSize = 64;
+};
+
 class VectorTile : public GeometryTile {
 public:
     VectorTile(const OverscaledTileID&,
                std::string sourceID,
                const style::UpdateParameters&,
-               const Tileset&);
+               const Tileset&,
+               VectorTileDataCache&);
 
     void setNecessity(Necessity) final;
-    void setData(std::shared_ptr<const std::string> data,
+    void setPriority(int32_t) final;
+    void setData(std::shared_ptr<const Buffer> data,
                  optional<Timestamp> modified,
                  optional<Timestamp> expires);
 
 private:
     TileLoader<VectorTile> loader;
+    VectorTileDataCache& dataCache;
 };
 
 } // namespace mbgl
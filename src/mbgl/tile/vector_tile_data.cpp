@@ -0,0 +1,465 @@
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/tile/property_columns.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace mbgl {
+
+namespace {
+
+Value parseValue(protozero::pbf_reader data) {
+    while (data.next())
+    {
+        switch (data.tag()) {
+        case 1: // string_value
+            return data.get_string();
+        case 2: // float_value
+            return static_cast<double>(data.get_float());
+        case 3: // double_value
+            return data.get_double();
+        case 4: // int_value
+            return data.get_int64();
+        case 5: // uint_value
+            return data.get_uint64();
+        case 6: // sint_value
+            return data.get_sint64();
+        case 7: // bool_value
+            return data.get_bool();
+        default:
+            data.skip();
+            break;
+        }
+    }
+    return false;
+}
+
+// Returns the encoded value of the given key among a feature's tags.
+optional<protozero::pbf_reader> findValue(const VectorTileLayerData& layerData, const packed_iter_type& tags, const std::string& key) {
+    auto start_itr = tags.begin();
+    const auto & end_itr = tags.end();
+    while (start_itr != end_itr) {
+        uint32_t tag_key = static_cast<uint32_t>(*start_itr++);
+
+        if (layerData.keys.size() <= tag_key) {
+            throw std::runtime_error("feature referenced out of range key");
+        }
+
+        if (start_itr == end_itr) {
+            throw std::runtime_error("uneven number of feature tag ids");
+        }
+
+        uint32_t tag_val = static_cast<uint32_t>(*start_itr++);
+        if (layerData.values.size() <= tag_val) {
+            throw std::runtime_error("feature referenced out of range value");
+        }
+
+        if (layerData.keys[tag_key] == key) {
+            return layerData.values[tag_val];
+        }
+    }
+
+    return {};
+}
+
+// Adapts an encoded feature for CompiledFilter::evaluate, with the filter's keys resolved
+// to indices into the layer's keys.
+class EncodedFeature {
+public:
+    const VectorTileLayerData& layerData;
+    const std::vector<uint32_t>& layerKeys;
+    const FeatureType type;
+    const optional<FeatureIdentifier> id;
+    const packed_iter_type tags;
+
+    FeatureType getType() const { return type; }
+    optional<FeatureIdentifier> getID() const { return id; }
+
+    optional<Value> getValue(std::size_t key) const {
+        const uint32_t layerKey = layerKeys[key];
+        if (layerKey == noKey) {
+            return {};
+        }
+
+        auto start_itr = tags.begin();
+        const auto & end_itr = tags.end();
+        while (start_itr != end_itr) {
+            uint32_t tag_key = static_cast<uint32_t>(*start_itr++);
+            if (layerData.keys.size() <= tag_key) {
+                throw std::runtime_error("feature referenced out of range key");
+            }
+
+            if (start_itr == end_itr) {
+                throw std::runtime_error("uneven number of feature tag ids");
+            }
+
+            uint32_t tag_val = static_cast<uint32_t>(*start_itr++);
+            if (tag_key == layerKey) {
+                if (layerData.values.size() <= tag_val) {
+                    throw std::runtime_error("feature referenced out of range value");
+                }
+                return parseValue(layerData.values[tag_val]);
+            }
+        }
+        return {};
+    }
+
+    static constexpr uint32_t noKey = std::numeric_limits<uint32_t>::max();
+};
+
+constexpr uint32_t EncodedFeature::noKey;
+
+// Reads a varint of packed geometry, to at most 32 bits like get_packed_uint32() does. Nearly
+// all command integers and coordinate deltas are one or two bytes long, so those are read
+// without a loop.
+inline uint32_t readGeometryVarint(const uint8_t*& it, const uint8_t* end) {
+    if (it != end && it[0] < 0x80) {
+        return *it++;
+    }
+    if (end - it >= 2 && it[1] < 0x80) {
+        const uint32_t value = (it[0] & 0x7f) | (uint32_t(it[1]) << 7);
+        it += 2;
+        return value;
+    }
+
+    uint32_t value = 0;
+    for (uint32_t shift = 0; it != end; shift += 7) {
+        const uint8_t byte = *it++;
+        if (shift < 32) {
+            value |= uint32_t(byte & 0x7f) << shift;
+        }
+        if (byte < 0x80) {
+            return value;
+        }
+    }
+    throw protozero::end_of_buffer_exception();
+}
+
+} // namespace
+
+VectorTileFeature::VectorTileFeature(protozero::pbf_reader feature_pbf, std::shared_ptr<VectorTileLayerData> layerData_)
+    : layerData(std::move(layerData_)) {
+    while (feature_pbf.next()) {
+        switch (feature_pbf.tag()) {
+        case 1: // id
+            id = { feature_pbf.get_uint64() };
+            break;
+        case 2: // tags
+            tags_iter = feature_pbf.get_packed_uint32();
+            break;
+        case 3: // type
+            type = static_cast<FeatureType>(feature_pbf.get_enum());
+            break;
+        case 4: // geometry
+            geometry = feature_pbf.get_data();
+            break;
+        default:
+            feature_pbf.skip();
+            break;
+        }
+    }
+}
+
+optional<Value> VectorTileFeature::getValue(const std::string& key) const {
+    if (auto value = findValue(*layerData, tags_iter, key)) {
+        return parseValue(*value);
+    }
+    return optional<Value>();
+}
+
+std::unordered_map<std::string,Value> VectorTileFeature::getProperties() const {
+    std::unordered_map<std::string,Value> properties;
+    auto start_itr = tags_iter.begin();
+    const auto & end_itr = tags_iter.end();
+    while (start_itr != end_itr) {
+        uint32_t tag_key = static_cast<uint32_t>(*start_itr++);
+        if (start_itr == end_itr) {
+            throw std::runtime_error("uneven number of feature tag ids");
+        }
+        uint32_t tag_val = static_cast<uint32_t>(*start_itr++);
+        properties[layerData->keys.at(tag_key).str()] = parseValue(layerData->values.at(tag_val));
+    }
+    return properties;
+}
+
+optional<FeatureIdentifier> VectorTileFeature::getID() const {
+    return id;
+}
+
+GeometryCollection VectorTileFeature::getGeometries() const {
+    GeometryCollection lines;
+    readGeometries(lines);
+    return lines;
+}
+
+void VectorTileFeature::readGeometries(GeometryCollection& lines) const {
+    uint8_t cmd = 1;
+    uint32_t length = 0;
+    int32_t x = 0;
+    int32_t y = 0;
+    const float scale = float(util::EXTENT) / layerData->extent;
+
+    // Tiles with the extent that we use need no scaling, which spares every point two
+    // multiplications and calls to round().
+    const bool unscaled = layerData->extent == util::EXTENT;
+
+    // Starts the next line in the ring of the collection that held it before, if there is one.
+    std::size_t lineCount = 0;
+    auto nextLine = [&] {
+        if (lineCount == lines.size()) {
+            lines.emplace_back();
+        } else {
+            lines[lineCount].clear();
+        }
+        return &lines[lineCount++];
+    };
+
+    GeometryCoordinates* line = nextLine();
+
+    const auto* it = reinterpret_cast<const uint8_t*>(geometry.first);
+    const auto* end = it + geometry.second;
+    while (it != end) {
+        if (length == 0) {
+            uint32_t cmd_length = readGeometryVarint(it, end);
+            cmd = cmd_length & 0x7;
+            length = cmd_length >> 3;
+        }
+
+        --length;
+
+        if (cmd == 1 || cmd == 2) {
+            x += protozero::decode_zigzag32(readGeometryVarint(it, end));
+            y += protozero::decode_zigzag32(readGeometryVarint(it, end));
+
+            if (cmd == 1 && !line->empty()) { // moveTo
+                line = nextLine();
+            }
+
+            if (unscaled) {
+                line->emplace_back(x, y);
+            } else {
+                line->emplace_back(::round(x * scale), ::round(y * scale));
+            }
+
+            // A line is a moveTo followed by a lineTo, whose count is its number of points but
+            // one, and maybe a closePolygon. Peeking at the lineTo reserves all of them at once.
+            if (cmd == 1 && length == 0 && it != end) {
+                const uint8_t* next = it;
+                const uint32_t next_cmd_length = readGeometryVarint(next, end);
+                if ((next_cmd_length & 0x7) == 2) {
+                    line->reserve(1 + (next_cmd_length >> 3) + 1);
+                }
+            }
+
+        } else if (cmd == 7) { // closePolygon
+            if (!line->empty()) {
+                line->push_back((*line)[0]);
+            }
+
+        } else {
+            throw std::runtime_error("unknown command");
+        }
+    }
+
+    lines.resize(lineCount);
+
+    if (layerData->version < 2 && type == FeatureType::Polygon) {
+        lines = fixupPolygons(lines);
+    }
+}
+
+VectorTileData::VectorTileData(std::shared_ptr<const Buffer> data_)
+    : data(std::move(data_)) {
+}
+
+const GeometryTileLayer* VectorTileData::getLayer(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!parsed) {
+        parsed = true;
+        protozero::pbf_reader tile_pbf(data->data(), data->size());
+        while (tile_pbf.next(3)) {
+            const protozero::pbf_reader layer_pbf = tile_pbf.get_message();
+
+            // Only read the name; the rest of the layer is parsed if it is requested.
+            protozero::pbf_reader name_pbf = layer_pbf;
+            VectorTileString layerName;
+            if (name_pbf.next(1)) {
+                layerName = name_pbf.get_data();
+            }
+
+            layers.push_back({ layerName, layer_pbf, nullptr });
+        }
+
+        // Stable, so that the first of several layers with the same name wins.
+        std::stable_sort(layers.begin(), layers.end(), [] (const LayerEntry& a, const LayerEntry& b) {
+            return a.name < b.name;
+        });
+    }
+
+    const VectorTileString key(name);
+    auto it = std::lower_bound(layers.begin(), layers.end(), key, [] (const LayerEntry& entry, const VectorTileString& k) {
+        return entry.name < k;
+    });
+    if (it == layers.end() || !(it->name == name)) {
+        return nullptr;
+    }
+
+    if (!it->layer) {
+        it->layer = std::make_unique<VectorTileLayer>(it->message, data);
+    }
+    return it->layer.get();
+}
+
+VectorTileLayerData::VectorTileLayerData(std::shared_ptr<const Buffer> pbfData) :
+    data(std::move(pbfData))
+{}
+
+VectorTileLayer::VectorTileLayer(protozero::pbf_reader layer_pbf, std::shared_ptr<const Buffer> pbfData)
+    : data(std::make_shared<VectorTileLayerData>(std::move(pbfData)))
+{
+    while (layer_pbf.next()) {
+        switch (layer_pbf.tag()) {
+        case 1: // name
+            name = layer_pbf.get_data();
+            break;
+        case 2: // feature
+            features.push_back(layer_pbf.get_message());
+            break;
+        case 3: // keys
+            data->keys.emplace_back(layer_pbf.get_data());
+            break;
+        case 4: // values
+            data->values.emplace_back(layer_pbf.get_message());
+            break;
+        case 5: // extent
+            data->extent = layer_pbf.get_uint32();
+            break;
+        case 15: // version
+            data->version = layer_pbf.get_uint32();
+            break;
+        default:
+            layer_pbf.skip();
+            break;
+        }
+    }
+}
+
+std::unique_ptr<GeometryTileFeature> VectorTileLayer::getFeature(std::size_t i) const {
+    return std::make_unique<VectorTileFeature>(features.at(i), data);
+}
+
+std::unique_ptr<GeometryTileFeature> VectorTileLayer::getMatchingFeature(std::size_t i, const style::CompiledFilter& filter) const {
+    if (!matches(i, filter)) {
+        return nullptr;
+    }
+    return getFeature(i);
+}
+
+util::ArenaPtr<GeometryTileFeature> VectorTileLayer::getMatchingFeatureInArena(std::size_t i, const style::CompiledFilter& filter, util::MonotonicArena& arena) const {
+    if (!matches(i, filter)) {
+        return nullptr;
+    }
+    return util::ArenaPtr<GeometryTileFeature>(arena.make<VectorTileFeature>(features.at(i), data), true);
+}
+
+bool VectorTileLayer::matches(std::size_t i, const style::CompiledFilter& filter) const {
+    std::shared_ptr<const FilterKeys> resolved = std::atomic_load(&filterKeys);
+    if (!resolved || resolved->serial != filter.getSerial()) {
+        auto next = std::make_shared<FilterKeys>();
+        next->serial = filter.getSerial();
+        for (const auto& key : filter.getKeys()) {
+            auto it = std::find_if(data->keys.begin(), data->keys.end(), [&] (const VectorTileString& k) { return k == key; });
+            next->keys.push_back(it == data->keys.end() ? EncodedFeature::noKey : uint32_t(it - data->keys.begin()));
+        }
+        resolved = std::move(next);
+        std::atomic_store(&filterKeys, resolved);
+    }
+
+    protozero::pbf_reader feature_pbf = features.at(i);
+
+    optional<FeatureIdentifier> id;
+    FeatureType type = FeatureType::Unknown;
+    packed_iter_type tags_iter;
+    while (feature_pbf.next()) {
+        switch (feature_pbf.tag()) {
+        case 1: // id
+            id = { feature_pbf.get_uint64() };
+            break;
+        case 2: // tags
+            tags_iter = feature_pbf.get_packed_uint32();
+            break;
+        case 3: // type
+            type = static_cast<FeatureType>(feature_pbf.get_enum());
+            break;
+        default:
+            feature_pbf.skip();
+            break;
+        }
+    }
+
+    return filter.evaluate(EncodedFeature { *data, resolved->keys, type, id, tags_iter });
+}
+
+void VectorTileLayer::decodeProperties(PropertyColumns& columns) const {
+    // The keys of the layer are resolved to columns once, so that the tags of the features are
+    // matched by index.
+    std::vector<std::size_t> columnOfKey;
+    columnOfKey.reserve(data->keys.size());
+    bool any = false;
+    for (const auto& key : data->keys) {
+        auto it = std::find_if(columns.getKeys().begin(), columns.getKeys().end(), [&] (const std::string& k) { return key == k; });
+        columnOfKey.push_back(it == columns.getKeys().end() ? PropertyColumns::noKey : std::size_t(it - columns.getKeys().begin()));
+        any = any || it != columns.getKeys().end();
+    }
+    if (!any) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < features.size(); i++) {
+        protozero::pbf_reader feature_pbf = features[i];
+        packed_iter_type tags_iter;
+        while (feature_pbf.next(2)) { // tags
+            tags_iter = feature_pbf.get_packed_uint32();
+        }
+
+        auto start_itr = tags_iter.begin();
+        const auto & end_itr = tags_iter.end();
+        while (start_itr != end_itr) {
+            uint32_t tag_key = static_cast<uint32_t>(*start_itr++);
+            if (columnOfKey.size() <= tag_key) {
+                throw std::runtime_error("feature referenced out of range key");
+            }
+
+            if (start_itr == end_itr) {
+                throw std::runtime_error("uneven number of feature tag ids");
+            }
+
+            uint32_t tag_val = static_cast<uint32_t>(*start_itr++);
+            const std::size_t column = columnOfKey[tag_key];
+            if (column == PropertyColumns::noKey) {
+                continue;
+            }
+
+            if (data->values.size() <= tag_val) {
+                throw std::runtime_error("feature referenced out of range value");
+            }
+
+            // Like getValue(), the first tag of a key wins.
+            optional<Value>& value = columns.get(column, i);
+            if (!value) {
+                value = parseValue(data->values[tag_val]);
+            }
+        }
+    }
+}
+
+std::string VectorTileLayer::getName() const {
+    return name.str();
+}
+
+} // namespace mbgl
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/buffer.hpp>
+
+#include <protozero/pbf_reader.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+// A string that points into the buffer of a vector tile, which must outlive it.
+class VectorTileString {
+public:
+    VectorTileString() = default;
+    VectorTileString(std::pair<const char*, protozero::pbf_length_type> data_)
+        : data(data_.first), size(data_.second) {
+    }
+    explicit VectorTileString(const std::string& string)
+        : data(string.data()), size(string.size()) {
+    }
+
+    std::string str() const {
+        return std::string(data, size);
+    }
+
+    int compare(const VectorTileString& other) const {
+        const int result = std::memcmp(data, other.data, std::min(size, other.size));
+        return result != 0 ? result : (size < other.size ? -1 : size > other.size);
+    }
+
+    friend bool operator==(const VectorTileString& lhs, const std::string& rhs) {
+        return lhs.size == rhs.size() && std::memcmp(lhs.data, rhs.data(), lhs.size) == 0;
+    }
+
+    friend bool operator<(const VectorTileString& lhs, const VectorTileString& rhs) {
+        return lhs.compare(rhs) < 0;
+    }
+
+private:
+    const char* data = "";
+    std::size_t size = 0;
+};
+
+using packed_iter_type = protozero::iterator_range<protozero::pbf_reader::const_uint32_iterator>;
+
+// Keys and values are kept as references into the pbf data; values are decoded only when a
+// feature is asked for them.
+struct VectorTileLayerData {
+    VectorTileLayerData(std::shared_ptr<const Buffer>);
+
+    // Hold a reference to the underlying pbf data that backs the lazily-built
+    // components of the owning VectorTileLayer and VectorTileFeature objects
+    std::shared_ptr<const Buffer> data;
+
+    uint32_t version = 1;
+    uint32_t extent = 4096;
+    std::vector<VectorTileString> keys;
+    std::vector<protozero::pbf_reader> values;
+};
+
+class VectorTileFeature : public GeometryTileFeature {
+public:
+    VectorTileFeature(protozero::pbf_reader, std::shared_ptr<VectorTileLayerData> layerData);
+
+    FeatureType getType() const override { return type; }
+    optional<Value> getValue(const std::string&) const override;
+    std::unordered_map<std::string,Value> getProperties() const override;
+    optional<FeatureIdentifier> getID() const override;
+    GeometryCollection getGeometries() const override;
+    void readGeometries(GeometryCollection&) const override;
+
+private:
+    std::shared_ptr<VectorTileLayerData> layerData;
+    optional<FeatureIdentifier> id;
+    FeatureType type = FeatureType::Unknown;
+    packed_iter_type tags_iter;
+    // The packed command integers and parameters, which are decoded directly by readGeometries.
+    std::pair<const char*, protozero::pbf_length_type> geometry { nullptr, 0 };
+};
+
+class VectorTileLayer : public GeometryTileLayer {
+public:
+    VectorTileLayer(protozero::pbf_reader, std::shared_ptr<const Buffer>);
+
+    std::size_t featureCount() const override { return features.size(); }
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const override;
+    std::unique_ptr<GeometryTileFeature> getMatchingFeature(std::size_t, const style::CompiledFilter&) const override;
+    util::ArenaPtr<GeometryTileFeature> getMatchingFeatureInArena(std::size_t, const style::CompiledFilter&, util::MonotonicArena&) const override;
+    void decodeProperties(PropertyColumns&) const override;
+    std::string getName() const override;
+
+private:
+    // Evaluates the filter on the encoded feature.
+    bool matches(std::size_t, const style::CompiledFilter&) const;
+
+    VectorTileString name;
+    std::vector<protozero::pbf_reader> features;
+    std::shared_ptr<VectorTileLayerData> data;
+
+    // The keys of the compiled filter last passed to getMatchingFeature(), resolved to
+    // indices into data->keys. Tiles share their data with the workers of other tiles, so the
+    // keys are replaced rather than changed in place, and loaded and stored atomically.
+    struct FilterKeys {
+        uint64_t serial;
+        std::vector<uint32_t> keys;
+    };
+    mutable std::shared_ptr<const FilterKeys> filterKeys;
+};
+
+// Layers are located on the first call to getLayer(), but only parsed once they are
+// requested; tiles commonly contain many more source layers than the style uses. The tile data
+// is immutable otherwise, and shared by the tiles overscaled from one canonical tile and their
+// workers, so getLayer() may be called from any thread.
+class VectorTileData : public GeometryTileData {
+public:
+    VectorTileData(std::shared_ptr<const Buffer> data);
+
+    std::unique_ptr<GeometryTileData> clone() const override {
+        return std::make_unique<VectorTileData>(data);
+    }
+
+    const GeometryTileLayer* getLayer(const std::string&) const override;
+
+    std::size_t getByteSize() const override {
+        return data->size();
+    }
+
+    std::shared_ptr<const Buffer> getEncodedData() const override {
+        return data;
+    }
+
+private:
+    struct LayerEntry {
+        VectorTileString name;
+        protozero::pbf_reader message;
+        std::unique_ptr<VectorTileLayer> layer;
+    };
+
+    std::shared_ptr<const Buffer> data;
+
+    mutable std::mutex mutex;
+    mutable bool parsed = false;
+
+    // Sorted by name.
+    mutable std::vector<LayerEntry> layers;
+};
+
+} // namespace mbgl
@@ -0,0 +1,105 @@
+#include <mbgl/util/compressed_image.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace mbgl {
+
+namespace {
+
+const uint8_t identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+// The fields of the header that follow the identifier, in the order of the file.
+enum Field {
+    Endianness,
+    GLType,
+    GLTypeSize,
+    GLFormat,
+    GLInternalFormat,
+    GLBaseInternalFormat,
+    PixelWidth,
+    PixelHeight,
+    PixelDepth,
+    NumberOfArrayElements,
+    NumberOfFaces,
+    NumberOfMipmapLevels,
+    BytesOfKeyValueData,
+    FieldCount,
+};
+
+const uint32_t nativeEndianness = 0x04030201;
+const uint32_t swappedEndianness = 0x01020304;
+
+uint32_t swap(uint32_t value) {
+    return ((value & 0x000000FF) << 24) | ((value & 0x0000FF00) << 8) |
+           ((value & 0x00FF0000) >> 8) | ((value & 0xFF000000) >> 24);
+}
+
+} // namespace
+
+bool isKTX(const uint8_t* data, std::size_t size) {
+    return size >= sizeof(identifier) && std::memcmp(data, identifier, sizeof(identifier)) == 0;
+}
+
+CompressedImage decodeKTX(const uint8_t* data, std::size_t size) {
+    const std::size_t headerSize = sizeof(identifier) + FieldCount * sizeof(uint32_t);
+    if (!isKTX(data, size) || size < headerSize) {
+        throw std::runtime_error("KTX Reader: failed to read header");
+    }
+
+    uint32_t header[FieldCount];
+    std::memcpy(header, data + sizeof(identifier), sizeof(header));
+
+    // The writer's byte order, which the fields and image sizes are in.
+    bool swapped;
+    if (header[Endianness] == nativeEndianness) {
+        swapped = false;
+    } else if (header[Endianness] == swappedEndianness) {
+        swapped = true;
+    } else {
+        throw std::runtime_error("KTX Reader: invalid endianness");
+    }
+    if (swapped) {
+        std::transform(header, header + FieldCount, header, swap);
+    }
+
+    // Compressed textures have neither a type nor a format, only an internal format.
+    if (header[GLType] != 0 || header[GLFormat] != 0) {
+        throw std::runtime_error("KTX Reader: texture is not compressed");
+    }
+    if (header[PixelWidth] == 0 || header[PixelHeight] == 0 || header[PixelDepth] > 1 ||
+        header[NumberOfArrayElements] > 1 || header[NumberOfFaces] != 1) {
+        throw std::runtime_error("KTX Reader: texture is not a 2D texture");
+    }
+
+    std::size_t offset = headerSize;
+    if (header[BytesOfKeyValueData] > size - offset) {
+        throw std::runtime_error("KTX Reader: failed to read key/value data");
+    }
+    offset += header[BytesOfKeyValueData];
+
+    uint32_t imageSize;
+    if (size - offset < sizeof(imageSize)) {
+        throw std::runtime_error("KTX Reader: failed to read image size");
+    }
+    std::memcpy(&imageSize, data + offset, sizeof(imageSize));
+    if (swapped) {
+        imageSize = swap(imageSize);
+    }
+    offset += sizeof(imageSize);
+
+    if (imageSize == 0 || imageSize > size - offset) {
+        throw std::runtime_error("KTX Reader: failed to read image data");
+    }
+
+    CompressedImage image;
+    image.size = { header[PixelWidth], header[PixelHeight] };
+    image.format = header[GLInternalFormat];
+    image.bytes = imageSize;
+    image.data = std::make_unique<uint8_t[]>(imageSize);
+    std::copy(data + offset, data + offset + imageSize, image.data.get());
+    return image;
+}
+
+} // namespace mbgl
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <mbgl/util/size.hpp>
+
+#include <cstdint>
+#include <memory>
+
+namespace mbgl {
+
+// An image that was compressed ahead of time in a format that GPUs sample from directly, such as
+// ETC2, ASTC or S3TC. `format` is the internal format that glCompressedTexImage2D takes.
+class CompressedImage {
+public:
+    Size size;
+    uint32_t format = 0;
+    std::unique_ptr<uint8_t[]> data;
+    std::size_t bytes = 0;
+};
+
+// Whether the data starts with the identifier of a KTX file.
+bool isKTX(const uint8_t* data, std::size_t size);
+
+// Returns the first mipmap level of a KTX file that holds a compressed 2D texture. Throws
+// std::runtime_error if the file is malformed or its texture isn't compressed.
+CompressedImage decodeKTX(const uint8_t* data, std::size_t size);
+
+} // namespace mbgl
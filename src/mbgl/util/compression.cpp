@@ -2,9 +2,14 @@
 
 #include <zlib.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <queue>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 // Check zlib library version.
 const static bool zlibVersionCheck __attribute__((unused)) = []() {
@@ -27,7 +32,9 @@ namespace util {
 // cause a link error.
 #undef compress
 
-std::string compress(const std::string &raw) {
+namespace {
+
+std::string deflateString(const char *raw, std::size_t size, const std::string *dictionary) {
     z_stream deflate_stream;
     memset(&deflate_stream, 0, sizeof(deflate_stream));
 
@@ -36,8 +43,14 @@ std::string compress(const std::string &raw) {
         throw std::runtime_error("failed to initialize deflate");
     }
 
-    deflate_stream.next_in = (Bytef *)raw.data();
-    deflate_stream.avail_in = uInt(raw.size());
+    if (dictionary && deflateSetDictionary(&deflate_stream, reinterpret_cast<const Bytef *>(dictionary->data()),
+                                           uInt(dictionary->size())) != Z_OK) {
+        deflateEnd(&deflate_stream);
+        throw std::runtime_error("failed to set deflate dictionary");
+    }
+
+    deflate_stream.next_in = (Bytef *)raw;
+    deflate_stream.avail_in = uInt(size);
 
     std::string result;
     char out[16384];
@@ -62,17 +75,18 @@ std::string compress(const std::string &raw) {
     return result;
 }
 
-std::string decompress(const std::string &raw) {
+std::string inflateString(const char *raw, std::size_t size, const std::string *dictionary) {
     z_stream inflate_stream;
     memset(&inflate_stream, 0, sizeof(inflate_stream));
 
     // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
+    // Accept gzip as well as zlib headers.
+    if (inflateInit2(&inflate_stream, 32 + MAX_WBITS) != Z_OK) {
         throw std::runtime_error("failed to initialize inflate");
     }
 
-    inflate_stream.next_in = (Bytef *)raw.data();
-    inflate_stream.avail_in = uInt(raw.size());
+    inflate_stream.next_in = (Bytef *)raw;
+    inflate_stream.avail_in = uInt(size);
 
     std::string result;
     char out[15384];
@@ -82,6 +96,10 @@ std::string decompress(const std::string &raw) {
         inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
         inflate_stream.avail_out = sizeof(out);
         code = inflate(&inflate_stream, 0);
+        if (code == Z_NEED_DICT && dictionary) {
+            code = inflateSetDictionary(&inflate_stream, reinterpret_cast<const Bytef *>(dictionary->data()),
+                                        uInt(dictionary->size()));
+        }
         // result.append(out, sizeof(out) - inflate_stream.avail_out);
         if (result.size() < inflate_stream.total_out) {
             result.append(out, inflate_stream.total_out - result.size());
@@ -96,5 +114,190 @@ std::string decompress(const std::string &raw) {
 
     return result;
 }
+
+std::string inflateStringSized(const char *raw, std::size_t size, std::size_t uncompressedSize,
+                               const std::string *dictionary) {
+    z_stream inflate_stream;
+    memset(&inflate_stream, 0, sizeof(inflate_stream));
+
+    if (inflateInit2(&inflate_stream, 32 + MAX_WBITS) != Z_OK) {
+        throw std::runtime_error("failed to initialize inflate");
+    }
+
+    inflate_stream.next_in = (Bytef *)raw;
+    inflate_stream.avail_in = uInt(size);
+
+    // One more byte than expected, so that a correct size finishes the stream without growing.
+    std::string result(uncompressedSize + 1, '\0');
+
+    int code;
+    do {
+        if (inflate_stream.total_out == result.size()) {
+            result.resize(result.size() * 2);
+        }
+        inflate_stream.next_out = reinterpret_cast<Bytef *>(&result[inflate_stream.total_out]);
+        inflate_stream.avail_out = uInt(result.size() - inflate_stream.total_out);
+        code = inflate(&inflate_stream, Z_FINISH);
+        if (code == Z_NEED_DICT && dictionary) {
+            code = inflateSetDictionary(&inflate_stream, reinterpret_cast<const Bytef *>(dictionary->data()),
+                                        uInt(dictionary->size()));
+        }
+    } while (code == Z_OK || (code == Z_BUF_ERROR && inflate_stream.avail_out == 0));
+
+    inflateEnd(&inflate_stream);
+
+    if (code != Z_STREAM_END) {
+        throw std::runtime_error(inflate_stream.msg ? inflate_stream.msg : "decompression error");
+    }
+
+    result.resize(inflate_stream.total_out);
+    return result;
+}
+
+} // namespace
+
+std::string compress(const std::string &raw) {
+    return deflateString(raw.data(), raw.size(), nullptr);
+}
+
+std::string compress(const char *raw, std::size_t size) {
+    return deflateString(raw, size, nullptr);
+}
+
+std::string decompress(const std::string &raw) {
+    return inflateString(raw.data(), raw.size(), nullptr);
+}
+
+std::string decompress(const char *raw, std::size_t size) {
+    return inflateString(raw, size, nullptr);
+}
+
+std::string compress(const std::string &raw, const std::string &dictionary) {
+    return deflateString(raw.data(), raw.size(), &dictionary);
+}
+
+std::string compress(const char *raw, std::size_t size, const std::string &dictionary) {
+    return deflateString(raw, size, &dictionary);
+}
+
+std::string decompress(const std::string &raw, const std::string &dictionary) {
+    return inflateString(raw.data(), raw.size(), &dictionary);
+}
+
+std::string decompress(const char *raw, std::size_t size, std::size_t uncompressedSize) {
+    return inflateStringSized(raw, size, uncompressedSize, nullptr);
+}
+
+std::string decompress(const char *raw, std::size_t size, std::size_t uncompressedSize,
+                       const std::string &dictionary) {
+    return inflateStringSized(raw, size, uncompressedSize, &dictionary);
+}
+
+// A simplified version of the "cover" algorithm of zstd's dictionary builder: the samples are
+// split into overlapping segments, each scored by how many other samples share its substrings
+// of kmerLength bytes. The best segments are picked greedily; once a substring is in the
+// dictionary it no longer adds to the score of other segments, so that the dictionary doesn't
+// repeat itself. Deflate encodes nearby matches more cheaply, so the best segments go last.
+std::string trainCompressionDictionary(const std::vector<std::string> &samples, std::size_t size) {
+    constexpr std::size_t kmerLength = sizeof(uint64_t);
+    constexpr std::size_t segmentLength = 64;
+    constexpr std::size_t segmentStep = segmentLength / 2;
+
+    size = std::min(size, maxCompressionDictionarySize);
+
+    auto kmerAt = [](const std::string &sample, std::size_t i) {
+        uint64_t kmer;
+        memcpy(&kmer, sample.data() + i, kmerLength);
+        return kmer;
+    };
+
+    // The number of samples in which each substring occurs.
+    std::unordered_map<uint64_t, uint32_t> frequencies;
+    for (const auto &sample : samples) {
+        std::unordered_set<uint64_t> seen;
+        for (std::size_t i = 0; i + kmerLength <= sample.size(); i++) {
+            if (seen.insert(kmerAt(sample, i)).second) {
+                frequencies[kmerAt(sample, i)]++;
+            }
+        }
+    }
+
+    struct Segment {
+        const std::string *sample;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    std::vector<Segment> segments;
+    auto score = [&](const Segment &segment) {
+        uint64_t total = 0;
+        std::unordered_set<uint64_t> seen;
+        for (std::size_t i = segment.begin; i + kmerLength <= segment.end; i++) {
+            const uint64_t kmer = kmerAt(*segment.sample, i);
+            if (seen.insert(kmer).second) {
+                const uint32_t frequency = frequencies[kmer];
+                // Substrings of a single sample don't help compressing any other.
+                total += frequency > 1 ? frequency : 0;
+            }
+        }
+        return total;
+    };
+
+    std::priority_queue<std::pair<uint64_t, std::size_t>> queue;
+    for (const auto &sample : samples) {
+        for (std::size_t begin = 0; begin + kmerLength <= sample.size(); begin += segmentStep) {
+            Segment segment { &sample, begin, std::min(begin + segmentLength, sample.size()) };
+            const uint64_t segmentScore = score(segment);
+            if (segmentScore > 0) {
+                queue.emplace(segmentScore, segments.size());
+                segments.push_back(segment);
+            }
+        }
+    }
+
+    std::vector<const Segment *> picked;
+    std::size_t pickedSize = 0;
+    while (!queue.empty() && pickedSize < size) {
+        const std::size_t index = queue.top().second;
+        queue.pop();
+
+        // Scores only decrease as segments are picked, so the segment is the best one left if
+        // its current score is still at least the previous score of the next one.
+        const uint64_t current = score(segments[index]);
+        if (current == 0) {
+            continue;
+        }
+        if (!queue.empty() && current < queue.top().first) {
+            queue.emplace(current, index);
+            continue;
+        }
+
+        // Trim the ends that are already in the dictionary, as overlapping segments would be.
+        Segment &segment = segments[index];
+        while (frequencies[kmerAt(*segment.sample, segment.begin)] <= 1) {
+            segment.begin++;
+        }
+        while (frequencies[kmerAt(*segment.sample, segment.end - kmerLength)] <= 1) {
+            segment.end--;
+        }
+
+        for (std::size_t i = segment.begin; i + kmerLength <= segment.end; i++) {
+            frequencies[kmerAt(*segment.sample, i)] = 0;
+        }
+        picked.push_back(&segment);
+        pickedSize += segment.end - segment.begin;
+    }
+
+    std::string dictionary;
+    dictionary.reserve(pickedSize);
+    for (auto it = picked.rbegin(); it != picked.rend(); ++it) {
+        dictionary.append(*(*it)->sample, (*it)->begin, (*it)->end - (*it)->begin);
+    }
+    if (dictionary.size() > size) {
+        dictionary.erase(0, dictionary.size() - size);
+    }
+    return dictionary;
+}
+
 } // namespace util
 } // namespace mbgl
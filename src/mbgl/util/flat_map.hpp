@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+// A map that keeps its entries sorted by key in a vector, for the small maps that are iterated
+// and looked up in every frame, like the tiles of a source. Lookups are binary searches in
+// contiguous memory, and iteration goes through the entries in the same order as std::map's.
+// Inserting and erasing move the entries after the position, and invalidate iterators and
+// references to them.
+template <class Key, class T, class Compare = std::less<Key>>
+class FlatMap {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using size_type = std::size_t;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+    const_iterator cbegin() const { return entries.cbegin(); }
+    const_iterator cend() const { return entries.cend(); }
+
+    bool empty() const { return entries.empty(); }
+    size_type size() const { return entries.size(); }
+    void clear() { entries.clear(); }
+    void reserve(size_type capacity) { entries.reserve(capacity); }
+
+    iterator lower_bound(const Key& key) {
+        return std::lower_bound(entries.begin(), entries.end(), key, KeyCompare());
+    }
+
+    const_iterator lower_bound(const Key& key) const {
+        return std::lower_bound(entries.begin(), entries.end(), key, KeyCompare());
+    }
+
+    iterator find(const Key& key) {
+        auto it = lower_bound(key);
+        return it != entries.end() && !Compare()(key, it->first) ? it : entries.end();
+    }
+
+    const_iterator find(const Key& key) const {
+        auto it = lower_bound(key);
+        return it != entries.end() && !Compare()(key, it->first) ? it : entries.end();
+    }
+
+    size_type count(const Key& key) const {
+        return find(key) != entries.end() ? 1 : 0;
+    }
+
+    T& at(const Key& key) {
+        auto it = find(key);
+        if (it == entries.end()) {
+            throw std::out_of_range("FlatMap::at");
+        }
+        return it->second;
+    }
+
+    const T& at(const Key& key) const {
+        auto it = find(key);
+        if (it == entries.end()) {
+            throw std::out_of_range("FlatMap::at");
+        }
+        return it->second;
+    }
+
+    T& operator[](const Key& key) {
+        return emplace(key, T()).first->second;
+    }
+
+    // Like std::map::emplace, leaves the map unchanged when it already has the key.
+    template <class... Args>
+    std::pair<iterator, bool> emplace(const Key& key, Args&&... args) {
+        auto it = lower_bound(key);
+        if (it != entries.end() && !Compare()(key, it->first)) {
+            return { it, false };
+        }
+        return { entries.emplace(it, std::piecewise_construct, std::forward_as_tuple(key),
+                                 std::forward_as_tuple(std::forward<Args>(args)...)),
+                 true };
+    }
+
+    // Appends an entry whose key comes after those of all other entries. Unlike emplace, it
+    // only needs the values to be move constructible, not assignable.
+    template <class... Args>
+    T& emplaceBack(const Key& key, Args&&... args) {
+        assert(entries.empty() || Compare()(entries.back().first, key));
+        entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+        return entries.back().second;
+    }
+
+    iterator erase(const_iterator it) {
+        return entries.erase(it);
+    }
+
+    size_type erase(const Key& key) {
+        auto it = find(key);
+        if (it == entries.end()) {
+            return 0;
+        }
+        entries.erase(it);
+        return 1;
+    }
+
+    // Removes the entries for which the predicate returns true in a single pass.
+    template <class Predicate>
+    void eraseIf(Predicate predicate) {
+        entries.erase(std::remove_if(entries.begin(), entries.end(), predicate), entries.end());
+    }
+
+private:
+    struct KeyCompare {
+        bool operator()(const value_type& entry, const Key& key) const {
+            return Compare()(entry.first, key);
+        }
+    };
+
+    std::vector<value_type> entries;
+};
+
+} // namespace util
+} // namespace mbgl
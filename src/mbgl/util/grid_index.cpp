@@ -2,7 +2,7 @@
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/math/minmax.hpp>
 
-#include <unordered_set>
+#include <algorithm>
 
 namespace mbgl {
 
@@ -43,7 +43,13 @@ void GridIndex<T>::insert(T&& t, const BBox& bbox) {
 template <class T>
 std::vector<T> GridIndex<T>::query(const BBox& queryBBox) const {
     std::vector<T> result;
-    std::unordered_set<size_t> seenUids;
+
+    marks.resize(elements.size());
+    if (++epoch == 0) {
+        // The stamps of 2^32 queries ago would be taken for those of this one.
+        std::fill(marks.begin(), marks.end(), 0);
+        epoch = 1;
+    }
 
     auto cx1 = convertToCellCoord(queryBBox.min.x);
     auto cy1 = convertToCellCoord(queryBBox.min.y);
@@ -55,8 +61,8 @@ std::vector<T> GridIndex<T>::query(const BBox& queryBBox) const {
         for (y = cy1; y <= cy2; ++y) {
             cellIndex = d * y + x;
             for (auto uid : cells[cellIndex]) {
-                if (seenUids.count(uid) == 0) {
-                    seenUids.insert(uid);
+                if (marks[uid] != epoch) {
+                    marks[uid] = epoch;
 
                     auto& pair = elements.at(uid);
                     auto& bbox = pair.second;
@@ -76,6 +82,17 @@ std::vector<T> GridIndex<T>::query(const BBox& queryBBox) const {
 }
 
 
+template <class T>
+std::size_t GridIndex<T>::getByteSize() const {
+    std::size_t size = elements.capacity() * sizeof(std::pair<T, BBox>) +
+        cells.capacity() * sizeof(std::vector<size_t>) +
+        marks.capacity() * sizeof(uint32_t);
+    for (const auto& cell : cells) {
+        size += cell.capacity() * sizeof(size_t);
+    }
+    return size;
+}
+
 template <class T>
 int32_t GridIndex<T>::convertToCellCoord(int32_t x) const {
     return util::max(0.0, util::min(d - 1.0, std::floor(x * scale) + padding));
@@ -19,6 +19,9 @@ public:
     void insert(T&& t, const BBox&);
     std::vector<T> query(const BBox&) const;
 
+    // Returns the number of bytes allocated for elements and cells.
+    std::size_t getByteSize() const;
+
 private:
     int32_t convertToCellCoord(int32_t x) const;
 
@@ -33,6 +36,10 @@ private:
     std::vector<std::pair<T, BBox>> elements;
     std::vector<std::vector<size_t>> cells;
 
+    // Elements that span several cells are only visited once by a query: each query stamps the
+    // elements it visits with a new epoch. Queries of an index don't run concurrently.
+    mutable std::vector<uint32_t> marks;
+    mutable uint32_t epoch = 0;
 };
 
 } // namespace mbgl
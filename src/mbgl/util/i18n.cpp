@@ -1,6 +1,8 @@
 #include "i18n.hpp"
 
+#include <array>
 #include <map>
+#include <vector>
 
 namespace {
 
@@ -310,13 +312,7 @@ const std::map<char16_t, char16_t> verticalPunctuation = {
     { u'｛', u'︷' }, { u'｜', u'―' },  { u'｝', u'︸' }, { u'｟', u'︵' }, { u'｠', u'︶' },
     { u'｡', u'︒' },  { u'｢', u'﹁' },  { u'｣', u'﹂' },
 };
-}
-
-namespace mbgl {
-namespace util {
-namespace i18n {
-
-bool allowsWordBreaking(char16_t chr) {
+bool isWordBreaking(char16_t chr) {
     return (chr == 0x0a      /* newline */
             || chr == 0x20   /* space */
             || chr == 0x26   /* ampersand */
@@ -332,16 +328,7 @@ bool allowsWordBreaking(char16_t chr) {
             || chr == 0x2013 /* en dash */);
 }
 
-bool allowsIdeographicBreaking(const std::u16string& string) {
-    for (char16_t chr : string) {
-        if (!allowsIdeographicBreaking(chr)) {
-            return false;
-        }
-    }
-    return true;
-}
-
-bool allowsIdeographicBreaking(char16_t chr) {
+bool isIdeographicBreaking(char16_t chr) {
     // Allow U+2027 "Interpunct" for hyphenation of Chinese words
     if (chr == 0x2027)
         return true;
@@ -374,13 +361,9 @@ bool allowsIdeographicBreaking(char16_t chr) {
     //        || isInCJKCompatibilityIdeographsSupplement(chr));
 }
 
-bool allowsVerticalWritingMode(const std::u16string& string) {
-    for (char32_t chr : string) {
-        if (hasUprightVerticalOrientation(chr)) {
-            return true;
-        }
-    }
-    return false;
+bool isFixedWidth(char16_t chr) {
+    // Ideographs and Hangul syllables all share one advance.
+    return isInCJKUnifiedIdeographs(chr) || isInHangulSyllables(chr);
 }
 
 // The following logic comes from
@@ -389,7 +372,7 @@ bool allowsVerticalWritingMode(const std::u16string& string) {
 // upright in vertical text but does not distinguish between upright and
 // “neutral” characters.
 
-bool hasUprightVerticalOrientation(char16_t chr) {
+bool isUprightVertical(char16_t chr) {
     if (chr == u'˪' || chr == u'˫')
         return true;
 
@@ -474,7 +457,7 @@ bool hasUprightVerticalOrientation(char16_t chr) {
     return false;
 }
 
-bool hasNeutralVerticalOrientation(char16_t chr) {
+bool isNeutralVertical(char16_t chr) {
     if (isInLatin1Supplement(chr)) {
         if (chr == u'§' || chr == u'©' || chr == u'®' || chr == u'±' || chr == u'¼' ||
             chr == u'½' || chr == u'¾' || chr == u'×' || chr == u'÷') {
@@ -525,8 +508,97 @@ bool hasNeutralVerticalOrientation(char16_t chr) {
     return false;
 }
 
+// Classifies the characters of the BMP in pages of 256 characters. Pages in which all characters
+// have the same classes, like most of those in the CJK blocks, are stored once.
+class CharacterClassTable {
+public:
+    CharacterClassTable() {
+        using namespace mbgl::util::i18n;
+        std::map<std::array<CharacterClasses, 256>, uint8_t> uniquePages;
+        for (uint32_t page = 0; page < pageIndices.size(); page++) {
+            std::array<CharacterClasses, 256> classes;
+            for (uint32_t offset = 0; offset < classes.size(); offset++) {
+                const char16_t chr = static_cast<char16_t>(page << 8 | offset);
+                classes[offset] =
+                    (isWordBreaking(chr) ? CharacterClass::WordBreaking : 0) |
+                    (isIdeographicBreaking(chr) ? CharacterClass::IdeographicBreaking : 0) |
+                    (isFixedWidth(chr) ? CharacterClass::FixedWidthGlyph : 0) |
+                    (isUprightVertical(chr) ? CharacterClass::UprightVertical : 0) |
+                    (isNeutralVertical(chr) ? CharacterClass::NeutralVertical : 0) |
+                    (verticalPunctuation.count(chr) ? CharacterClass::VerticalPunctuation : 0);
+            }
+            auto it = uniquePages.emplace(classes, uint8_t(pages.size()));
+            if (it.second) {
+                pages.push_back(classes);
+            }
+            pageIndices[page] = it.first->second;
+        }
+    }
+
+    mbgl::util::i18n::CharacterClasses get(char16_t chr) const {
+        return pages[pageIndices[chr >> 8]][chr & 0xFF];
+    }
+
+private:
+    std::array<uint8_t, 256> pageIndices;
+    std::vector<std::array<mbgl::util::i18n::CharacterClasses, 256>> pages;
+};
+
+} // namespace
+
+namespace mbgl {
+namespace util {
+namespace i18n {
+
+CharacterClasses getCharacterClasses(char16_t chr) {
+    static const CharacterClassTable table;
+    return table.get(chr);
+}
+
+bool allowsWordBreaking(char16_t chr) {
+    return getCharacterClasses(chr) & CharacterClass::WordBreaking;
+}
+
+bool allowsIdeographicBreaking(const std::u16string& string) {
+    for (char16_t chr : string) {
+        if (!allowsIdeographicBreaking(chr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool allowsIdeographicBreaking(char16_t chr) {
+    return getCharacterClasses(chr) & CharacterClass::IdeographicBreaking;
+}
+
+bool allowsLineBreaking(char16_t chr) {
+    return getCharacterClasses(chr) & (CharacterClass::WordBreaking | CharacterClass::IdeographicBreaking);
+}
+
+bool allowsFixedWidthGlyphGeneration(char16_t chr) {
+    return getCharacterClasses(chr) & CharacterClass::FixedWidthGlyph;
+}
+
+bool allowsVerticalWritingMode(const std::u16string& string) {
+    for (char32_t chr : string) {
+        if (hasUprightVerticalOrientation(chr)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool hasUprightVerticalOrientation(char16_t chr) {
+    return getCharacterClasses(chr) & CharacterClass::UprightVertical;
+}
+
+bool hasNeutralVerticalOrientation(char16_t chr) {
+    return getCharacterClasses(chr) & CharacterClass::NeutralVertical;
+}
+
 bool hasRotatedVerticalOrientation(char16_t chr) {
-    return !(hasUprightVerticalOrientation(chr) || hasNeutralVerticalOrientation(chr));
+    return !(getCharacterClasses(chr) & (CharacterClass::UprightVertical | CharacterClass::NeutralVertical));
 }
 
 std::u16string verticalizePunctuation(const std::u16string& input) {
@@ -538,9 +610,9 @@ std::u16string verticalizePunctuation(const std::u16string& input) {
 
         bool canReplacePunctuation =
             ((!nextCharCode || !hasRotatedVerticalOrientation(nextCharCode) ||
-              verticalPunctuation.count(input[i + 1])) &&
+              (getCharacterClasses(nextCharCode) & CharacterClass::VerticalPunctuation)) &&
              (!prevCharCode || !hasRotatedVerticalOrientation(prevCharCode) ||
-              verticalPunctuation.count(input[i - 1])));
+              (getCharacterClasses(prevCharCode) & CharacterClass::VerticalPunctuation)));
 
         if (char16_t repl = canReplacePunctuation ? verticalizePunctuation(input[i]) : 0) {
             output += repl;
@@ -553,7 +625,10 @@ std::u16string verticalizePunctuation(const std::u16string& input) {
 }
 
 char16_t verticalizePunctuation(char16_t chr) {
-    return verticalPunctuation.count(chr) ? verticalPunctuation.at(chr) : 0;
+    if (!(getCharacterClasses(chr) & CharacterClass::VerticalPunctuation)) {
+        return 0;
+    }
+    return verticalPunctuation.at(chr);
 }
 
 } // namespace i18n
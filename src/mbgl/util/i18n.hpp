@@ -1,11 +1,31 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace mbgl {
 namespace util {
 namespace i18n {
 
+namespace CharacterClass {
+enum : uint8_t {
+    WordBreaking = 1 << 0,
+    IdeographicBreaking = 1 << 1,
+    FixedWidthGlyph = 1 << 2,
+    UprightVertical = 1 << 3,
+    NeutralVertical = 1 << 4,
+    VerticalPunctuation = 1 << 5,
+};
+} // namespace CharacterClass
+
+/** A combination of the CharacterClass flags. */
+using CharacterClasses = uint8_t;
+
+/** Returns all classes of the character indicated by the given Unicode
+    codepoint at once. The functions below read the same flags, from a table
+    that covers the BMP and is computed on first use. */
+CharacterClasses getCharacterClasses(char16_t chr);
+
 /** Returns whether a line break can be inserted after the character indicated
     by the given Unicode codepoint due to word breaking. */
 bool allowsWordBreaking(char16_t chr);
@@ -19,6 +39,16 @@ bool allowsIdeographicBreaking(const std::u16string& string);
     by the given Unicode codepoint due to ideographic breaking. */
 bool allowsIdeographicBreaking(char16_t chr);
 
+/** Returns whether a line break can be inserted after the character indicated
+    by the given Unicode codepoint due to either word or ideographic breaking. */
+bool allowsLineBreaking(char16_t chr);
+
+/** Returns whether the character indicated by the given Unicode codepoint is
+    drawn with the same advance as every other character of its script, so that
+    its glyph can be generated locally with fixed metrics instead of being
+    downloaded. */
+bool allowsFixedWidthGlyphGeneration(char16_t chr);
+
 /** Returns whether any substring of the given string can be drawn as vertical
     text with upright glyphs. */
 bool allowsVerticalWritingMode(const std::u16string& string);
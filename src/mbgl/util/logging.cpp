@@ -1,10 +1,16 @@
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/enum.hpp>
-#include <mbgl/util/thread.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/platform.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdarg>
-#include <sstream>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
 
 namespace mbgl {
 
@@ -12,6 +18,190 @@ namespace {
 
 static std::unique_ptr<Log::Observer> currentObserver;
 
+// Events that log more than this many messages in a second have the rest left out, and are
+// followed by a count of what was left out once the next second starts.
+const uint32_t maxMessagesPerSecond = 50;
+
+class RateLimit {
+public:
+    // Counts a message of the event, and returns whether it is within the limit. Reports the
+    // messages that a previous second left out, if this is the first message of a new one.
+    bool admit(Event event, uint32_t& suppressed) {
+        Rate& rate = rates[uint8_t(event)];
+        const int64_t now = second();
+        int64_t current = rate.second.load(std::memory_order_relaxed);
+        if (current != now && rate.second.compare_exchange_strong(current, now, std::memory_order_relaxed)) {
+            rate.count.store(0, std::memory_order_relaxed);
+            suppressed = rate.suppressed.exchange(0, std::memory_order_relaxed);
+        }
+        if (rate.count.fetch_add(1, std::memory_order_relaxed) < maxMessagesPerSecond) {
+            return true;
+        }
+        rate.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Counts a message that was left out without asking.
+    void leaveOut(Event event) {
+        rates[uint8_t(event)].suppressed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Whether the event has used up the current second, without counting a message.
+    bool exhausted(Event event) const {
+        const Rate& rate = rates[uint8_t(event)];
+        return rate.second.load(std::memory_order_relaxed) == second() &&
+               rate.count.load(std::memory_order_relaxed) >= maxMessagesPerSecond;
+    }
+
+private:
+    static int64_t second() {
+        return std::chrono::duration_cast<Seconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    struct Rate {
+        std::atomic<int64_t> second { 0 };
+        std::atomic<uint32_t> count { 0 };
+        std::atomic<uint32_t> suppressed { 0 };
+    };
+
+    Rate rates[256];
+};
+
+void formatRecord(char* text, std::size_t size, const std::string& thread, Event event, int64_t code, const char* msg) {
+    char codeText[24] = "";
+    if (code >= 0) {
+        std::snprintf(codeText, sizeof(codeText), "(%lld)", static_cast<long long>(code));
+    }
+    std::snprintf(text, size, "{%s}[%s]%s%s%s", thread.c_str(), Enum<Event>::toString(event),
+                  codeText, *msg ? ": " : "", msg);
+}
+
+// Messages that the platform logger hasn't written yet. Any thread adds to it without taking a
+// lock or allocating, and a thread of its own writes the messages out, so that a flood of them
+// doesn't hold up the threads that log them. Messages that don't fit are dropped and counted.
+class LogBuffer {
+public:
+    using Writer = void (*)(EventSeverity, const std::string&);
+
+    explicit LogBuffer(Writer write_) : write(write_) {
+        for (std::size_t i = 0; i < capacity; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        std::thread([this] {
+            platform::setCurrentThreadName("Log");
+            platform::makeThreadLowPriority();
+            drain();
+        }).detach();
+    }
+
+    void push(EventSeverity severity, const std::string& thread, Event event, int64_t code, const char* msg) {
+        // A bounded queue after Dmitry Vyukov's: each slot's sequence says whether it is free for
+        // the position that a writer claims, or filled for the one that a reader claims.
+        std::size_t position = writePosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[position % capacity];
+            const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == position) {
+                if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (sequence < position) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                position = writePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->severity = severity;
+        formatRecord(slot->text, sizeof(slot->text), thread, event, code, msg);
+        slot->sequence.store(position + 1, std::memory_order_release);
+
+        // The thread that writes the messages holds the lock only while it checks for them and
+        // starts waiting, so this never waits for it. If it is in the middle of that, it picks the
+        // message up once its wait times out.
+        std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            condition.notify_one();
+        }
+    }
+
+    // Writes out the messages in the buffer on the calling thread.
+    void flush() {
+        EventSeverity severity;
+        std::string text;
+        while (pop(severity, text)) {
+            write(severity, text);
+        }
+
+        const std::size_t count = dropped.exchange(0, std::memory_order_relaxed);
+        if (count) {
+            write(EventSeverity::Warning, "{Log}: " + std::to_string(count) + " messages dropped");
+        }
+    }
+
+private:
+    bool pop(EventSeverity& severity, std::string& text) {
+        std::size_t position = readPosition.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position % capacity];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == position + 1) {
+                if (readPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    severity = slot.severity;
+                    text = slot.text;
+                    slot.sequence.store(position + capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (sequence < position + 1) {
+                return false;
+            } else {
+                position = readPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool empty() const {
+        const std::size_t position = readPosition.load(std::memory_order_relaxed);
+        return slots[position % capacity].sequence.load(std::memory_order_acquire) != position + 1;
+    }
+
+    void drain() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            lock.unlock();
+            flush();
+            lock.lock();
+            condition.wait_for(lock, std::chrono::seconds(1), [this] { return !empty(); });
+        }
+    }
+
+    static const std::size_t capacity = 128;
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        EventSeverity severity;
+        char text[1024];
+    };
+
+    const Writer write;
+    Slot slots[capacity];
+    std::atomic<std::size_t> writePosition { 0 };
+    std::atomic<std::size_t> readPosition { 0 };
+    std::atomic<std::size_t> dropped { 0 };
+
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+RateLimit rateLimit;
+
+// The buffer is never destroyed, as messages may be logged until the very end. What it holds
+// at exit is written out then.
+LogBuffer* buffer = nullptr;
+
 } // namespace
 
 void Log::setObserver(std::unique_ptr<Observer> observer) {
@@ -29,6 +219,13 @@ void Log::record(EventSeverity severity, Event event, const std::string &msg) {
 }
 
 void Log::record(EventSeverity severity, Event event, const char* format, ...) {
+    // Formatting is most of the cost of a message, so it is skipped for messages that would be
+    // left out anyway.
+    if (!currentObserver && rateLimit.exhausted(event)) {
+        rateLimit.leaveOut(event);
+        return;
+    }
+
     va_list args;
     va_start(args, format);
     char msg[4096];
@@ -48,20 +245,35 @@ void Log::record(EventSeverity severity, Event event, int64_t code, const std::s
         return;
     }
 
-    std::stringstream logStream;
+    uint32_t suppressed = 0;
+    if (!rateLimit.admit(event, suppressed)) {
+        return;
+    }
 
-    logStream << "{" << platform::getCurrentThreadName() << "}";
-    logStream << "[" << Enum<Event>::toString(event) << "]";
+    static LogBuffer& logBuffer = [] () -> LogBuffer& {
+        buffer = new LogBuffer([] (EventSeverity severity_, const std::string& text) {
+            platformRecord(severity_, text);
+        });
+        std::atexit([] { buffer->flush(); });
+        return *buffer;
+    }();
 
-    if (code >= 0) {
-        logStream << "(" << code << ")";
+    const std::string thread = platform::getCurrentThreadName();
+    if (suppressed) {
+        const std::string count = std::to_string(suppressed) + " similar messages were left out";
+        logBuffer.push(EventSeverity::Warning, thread, event, -1, count.c_str());
     }
 
-    if (!msg.empty()) {
-        logStream << ": " << msg;
+    if (severity == EventSeverity::Error) {
+        // Errors are written right away, after what is still in the buffer, so that they aren't
+        // lost if the process goes down.
+        logBuffer.flush();
+        char text[4096];
+        formatRecord(text, sizeof(text), thread, event, code, msg.c_str());
+        platformRecord(severity, text);
+    } else {
+        logBuffer.push(severity, thread, event, code, msg.c_str());
     }
-
-    platformRecord(severity, logStream.str());
 }
 
 } // namespace mbgl
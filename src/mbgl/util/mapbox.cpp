@@ -108,8 +108,22 @@ std::string normalizeTileURL(const std::string& baseURL,
         return str;
     }
 
-    const auto tpl = baseURL + "/v4{path}?access_token=" + accessToken;
-    return transformURL(tpl, str, url);
+    // Every tile request goes through here, so the URL is appended in one go instead of being
+    // run through a template like the other kinds of URLs.
+    static const std::string version = "/v4";
+    static const std::string token = "?access_token=";
+    std::string result;
+    result.reserve(baseURL.size() + version.size() + url.path.second + token.size() +
+                   accessToken.size() + url.query.second);
+    result.append(baseURL).append(version).append(str, url.path.first, url.path.second);
+    result.append(token).append(accessToken);
+
+    // Append the query string if it exists, following on from the access token.
+    if (url.query.second > 1) {
+        result += '&';
+        result.append(str, url.query.first + 1, url.query.second - 1);
+    }
+    return result;
 }
 
 std::string
@@ -0,0 +1,50 @@
+#include <mbgl/util/monotonic_arena.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace mbgl {
+namespace util {
+
+MonotonicArena::MonotonicArena(std::size_t blockSize_)
+    : blockSize(blockSize_) {
+}
+
+void* MonotonicArena::allocate(std::size_t size, std::size_t alignment) {
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    // Moves on to the next block that the allocation fits into, or appends one; the ones that are
+    // skipped are used again after the next reset.
+    while (true) {
+        if (current < blocks.size()) {
+            const Block& block = blocks[current];
+            const auto base = reinterpret_cast<uintptr_t>(block.data.get());
+            const uintptr_t start = (base + offset + alignment - 1) & ~uintptr_t(alignment - 1);
+            if (start + size <= base + block.size) {
+                offset = start + size - base;
+                return reinterpret_cast<void*>(start);
+            }
+            current++;
+            offset = 0;
+        } else {
+            const std::size_t newSize = std::max(blockSize, size + alignment);
+            blocks.push_back({ std::make_unique<uint8_t[]>(newSize), newSize });
+        }
+    }
+}
+
+void MonotonicArena::reset() {
+    current = 0;
+    offset = 0;
+}
+
+std::size_t MonotonicArena::getCapacity() const {
+    std::size_t capacity = 0;
+    for (const auto& block : blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+// Memory for short-lived objects that are freed all at once, like those a layout creates for each
+// feature. Allocating takes a pointer bump, freeing does nothing, and reset() makes all memory
+// available again. The blocks are kept across resets, so that an arena that is reset after each
+// tile stops allocating once it has grown to the needs of the largest one.
+class MonotonicArena : private util::noncopyable {
+public:
+    explicit MonotonicArena(std::size_t blockSize = 16 * 1024);
+
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    template <class T, class... Args>
+    T* make(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Objects allocated before must have been destroyed.
+    void reset();
+
+    // Returns the number of bytes held by the arena's blocks.
+    std::size_t getCapacity() const;
+
+private:
+    struct Block {
+        std::unique_ptr<uint8_t[]> data;
+        std::size_t size;
+    };
+
+    const std::size_t blockSize;
+    std::vector<Block> blocks;
+    std::size_t current = 0;
+    std::size_t offset = 0;
+};
+
+// Deletes an object that is either on the heap or in an arena, where only its destructor runs.
+template <class T>
+class ArenaDeleter {
+public:
+    ArenaDeleter(bool inArena_ = false) : inArena(inArena_) {}
+
+    void operator()(T* object) const {
+        if (inArena) {
+            object->~T();
+        } else {
+            delete object;
+        }
+    }
+
+private:
+    bool inArena;
+};
+
+template <class T>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter<T>>;
+
+} // namespace util
+} // namespace mbgl
@@ -8,14 +8,23 @@ namespace mbgl {
 
 class OffscreenTexture::Impl {
 public:
-    Impl(gl::Context& context_, const Size size_) : context(context_), size(std::move(size_)) {
+    Impl(gl::Context& context_,
+         const Size size_,
+         OffscreenTextureAttachment attachment_,
+         gl::TextureType type_)
+        : context(context_), size(std::move(size_)), attachment(attachment_), type(type_) {
         assert(!size.isEmpty());
     }
 
     void bind() {
         if (!framebuffer) {
-            texture = context.createTexture(size);
-            framebuffer = context.createFramebuffer(*texture);
+            texture = context.createTexture(size, gl::TextureFormat::RGBA, 0, type);
+            if (attachment == OffscreenTextureAttachment::DepthStencil) {
+                depthStencil = context.createRenderbuffer<gl::RenderbufferType::DepthStencil>(size);
+                framebuffer = context.createFramebuffer(*texture, *depthStencil);
+            } else {
+                framebuffer = context.createFramebuffer(*texture);
+            }
         } else {
             context.bindFramebuffer = framebuffer->framebuffer;
         }
@@ -39,12 +48,18 @@ public:
 private:
     gl::Context& context;
     const Size size;
+    const OffscreenTextureAttachment attachment;
+    const gl::TextureType type;
     optional<gl::Framebuffer> framebuffer;
     optional<gl::Texture> texture;
+    optional<gl::Renderbuffer<gl::RenderbufferType::DepthStencil>> depthStencil;
 };
 
-OffscreenTexture::OffscreenTexture(gl::Context& context, const Size size)
-    : impl(std::make_unique<Impl>(context, std::move(size))) {
+OffscreenTexture::OffscreenTexture(gl::Context& context,
+                                   const Size size,
+                                   OffscreenTextureAttachment attachment,
+                                   gl::TextureType type)
+    : impl(std::make_unique<Impl>(context, std::move(size), attachment, type)) {
     assert(!size.isEmpty());
 }
 
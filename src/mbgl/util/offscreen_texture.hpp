@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/map/view.hpp>
+#include <mbgl/gl/types.hpp>
 #include <mbgl/util/image.hpp>
 
 namespace mbgl {
@@ -10,9 +11,17 @@ class Context;
 class Texture;
 } // namespace gl
 
+enum class OffscreenTextureAttachment {
+    None,
+    DepthStencil,
+};
+
 class OffscreenTexture : public View {
 public:
-    OffscreenTexture(gl::Context&, Size size = { 256, 256 });
+    OffscreenTexture(gl::Context&,
+                     Size size = { 256, 256 },
+                     OffscreenTextureAttachment = OffscreenTextureAttachment::None,
+                     gl::TextureType = gl::TextureType::UnsignedByte);
     ~OffscreenTexture();
 
     void bind() override;
@@ -130,6 +130,7 @@ Thread<Object>::Thread(const ThreadContext& context, Args&&... args) {
 
         if (context.priority == ThreadPriority::Low) {
             platform::makeThreadLowPriority();
+            platform::setCurrentThreadPlacement(platform::ThreadPlacement::Efficiency);
         }
 
         run(std::move(params), std::index_sequence_for<Args...>{});
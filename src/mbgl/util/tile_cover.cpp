@@ -2,7 +2,10 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/interpolate.hpp>
 #include <mbgl/map/transform_state.hpp>
+#include <mbgl/math/clamp.hpp>
 
+#include <array>
+#include <cmath>
 #include <functional>
 
 namespace mbgl {
@@ -126,9 +129,72 @@ std::vector<UnwrappedTileID> tileCover(const Point<double>& tl,
 
 } // namespace
 
+TileCover::TileCover(const LatLngBounds& bounds_, int32_t z_) : z(z_) {
+    if (bounds_.isEmpty() ||
+        bounds_.south() >  util::LATITUDE_MAX ||
+        bounds_.north() < -util::LATITUDE_MAX) {
+        return;
+    }
+
+    LatLngBounds bounds = LatLngBounds::hull(
+        { std::max(bounds_.south(), -util::LATITUDE_MAX), bounds_.west() },
+        { std::min(bounds_.north(),  util::LATITUDE_MAX), bounds_.east() });
+
+    const Point<double> nw = TileCoordinate::fromLatLng(z, bounds.northwest()).p;
+    const Point<double> se = TileCoordinate::fromLatLng(z, bounds.southeast()).p;
+    const int64_t tiles = int64_t(1) << z;
+
+    // The bounds are a rectangle in tile coordinates, which the scan-line conversion in
+    // tileCover() fills with the tiles it touches. Bounds without height cover no tiles.
+    minX = std::floor(nw.x);
+    maxX = std::ceil(se.x);
+    minY = std::max<int64_t>(0, std::floor(nw.y));
+    maxY = std::min<int64_t>(tiles, std::ceil(se.y));
+
+    if (nw.y == se.y || minX >= maxX || minY >= maxY) {
+        minX = maxX = minY = maxY = 0;
+        return;
+    }
+
+    // Bounds that cross the antimeridian extend into the neighbouring copies of the world,
+    // each of which has its own tile tree.
+    auto world = [&](int64_t x) { return x >= 0 ? x / tiles : -((-x - 1) / tiles) - 1; };
+    for (int64_t wrap = world(maxX - 1); wrap >= world(minX); wrap--) {
+        stack.push_back({ 0, wrap, 0 });
+    }
+}
+
+uint64_t TileCover::size() const {
+    return (maxX - minX) * (maxY - minY);
+}
+
+optional<UnwrappedTileID> TileCover::next() {
+    while (!stack.empty()) {
+        const Node node = stack.back();
+        stack.pop_back();
+
+        if (node.z == z) {
+            return UnwrappedTileID(z, node.x, node.y);
+        }
+
+        // Push the children that overlap the cover, the first one in Z-order last.
+        const int64_t span = int64_t(1) << (z - node.z - 1);
+        for (int32_t i = 3; i >= 0; i--) {
+            const int64_t x = node.x * 2 + (i & 1);
+            const int64_t y = node.y * 2 + (i >> 1);
+            if (x * span < maxX && (x + 1) * span > minX &&
+                y * span < maxY && (y + 1) * span > minY) {
+                stack.push_back({ node.z + 1, x, y });
+            }
+        }
+    }
+
+    return {};
+}
+
 int32_t coveringZoomLevel(double zoom, SourceType type, uint16_t size) {
     zoom += std::log(util::tileSize / size) / std::log(2);
-    if (type == SourceType::Raster || type == SourceType::Video) {
+    if (type == SourceType::Raster || type == SourceType::RasterDEM || type == SourceType::Video) {
         return ::round(zoom);
     } else {
         return std::floor(zoom);
@@ -169,5 +235,119 @@ std::vector<UnwrappedTileID> tileCover(const TransformState& state, int32_t z) {
         z);
 }
 
+std::vector<UnwrappedTileID> lodTileCover(const TransformState& state, int32_t z, int32_t minZ) {
+    assert(state.valid());
+    minZ = std::min(minZ, z);
+
+    const double w = state.getSize().width;
+    const double h = state.getSize().height;
+    const std::array<Point<double>, 4> quad {{
+        TileCoordinate::fromScreenCoordinate(state, z, { 0, 0 }).p,
+        TileCoordinate::fromScreenCoordinate(state, z, { w, 0 }).p,
+        TileCoordinate::fromScreenCoordinate(state, z, { w, h }).p,
+        TileCoordinate::fromScreenCoordinate(state, z, { 0, h }).p,
+    }};
+    const Point<double> c = TileCoordinate::fromScreenCoordinate(state, z, { w/2, h/2 }).p;
+    const Point<double> top = TileCoordinate::fromScreenCoordinate(state, z, { w/2, 0 }).p;
+    const Point<double> bottom = TileCoordinate::fromScreenCoordinate(state, z, { w/2, h }).p;
+
+    // The camera looks down at the center of the viewport from the side of its nearer edge. All
+    // distances are in tiles of zoom level z.
+    const double centerDistance =
+        state.getCameraToCenterDistance() / (util::tileSize * std::pow(2.0, state.getZoom() - z));
+    const double cameraHeight = centerDistance * std::cos(state.getPitch());
+    const double toTop = std::hypot(top.x - c.x, top.y - c.y);
+    const double toBottom = std::hypot(bottom.x - c.x, bottom.y - c.y);
+    const Point<double>& near = toTop < toBottom ? top : bottom;
+    const double toNear = std::min(toTop, toBottom);
+    Point<double> camera = c;
+    if (toNear > 0) {
+        const double f = centerDistance * std::sin(state.getPitch()) / toNear;
+        camera = { c.x + (near.x - c.x) * f, c.y + (near.y - c.y) * f };
+    }
+
+    double minX = quad[0].x, minY = quad[0].y, maxX = quad[0].x, maxY = quad[0].y;
+    double area = 0;
+    for (std::size_t i = 0; i < quad.size(); i++) {
+        const auto& a = quad[i];
+        const auto& b = quad[(i + 1) % quad.size()];
+        minX = std::min(minX, a.x);
+        minY = std::min(minY, a.y);
+        maxX = std::max(maxX, a.x);
+        maxY = std::max(maxY, a.y);
+        area += a.x * b.y - b.x * a.y;
+    }
+
+    // A box outside of the bounding box of the viewport, or entirely outside of one of its edges,
+    // is separated from it, since the viewport is convex.
+    auto intersects = [&](double x0, double y0, double x1, double y1) {
+        if (x1 <= minX || x0 >= maxX || y1 <= minY || y0 >= maxY) {
+            return false;
+        }
+        const std::array<Point<double>, 4> corners {{ { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y1 } }};
+        for (std::size_t i = 0; i < quad.size(); i++) {
+            const auto& a = quad[i];
+            const auto& b = quad[(i + 1) % quad.size()];
+            const bool outside = std::all_of(corners.begin(), corners.end(), [&](const Point<double>& p) {
+                return ((b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x)) * area < 0;
+            });
+            if (outside) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    struct ID {
+        int32_t z;
+        int64_t x, y;
+        double sqDist;
+    };
+
+    std::vector<ID> t;
+
+    std::function<void(int32_t, int64_t, int64_t)> visit = [&](int32_t tz, int64_t x, int64_t y) {
+        const double size = std::pow(2.0, z - tz);
+        const double x0 = x * size, y0 = y * size;
+        if (!intersects(x0, y0, x0 + size, y0 + size)) {
+            return;
+        }
+
+        // Twice as far from the camera as the center of the viewport, a tile is drawn at half the
+        // scale, so that one of the next lower zoom level has as much detail as the pixels show.
+        const double dx = camera.x - util::clamp(camera.x, x0, x0 + size);
+        const double dy = camera.y - util::clamp(camera.y, y0, y0 + size);
+        const double distance = std::sqrt(dx * dx + dy * dy + cameraHeight * cameraHeight);
+        if (tz >= minZ && (tz == z || distance >= centerDistance * size)) {
+            const double cx = x0 + size / 2 - c.x, cy = y0 + size / 2 - c.y;
+            t.push_back(ID{ tz, x, y, cx * cx + cy * cy });
+            return;
+        }
+
+        for (int64_t cy = 0; cy < 2; cy++) {
+            for (int64_t cx = 0; cx < 2; cx++) {
+                visit(tz + 1, x * 2 + cx, y * 2 + cy);
+            }
+        }
+    };
+
+    // Start from the world copies that the viewport reaches into.
+    const double worldSize = std::pow(2.0, z);
+    for (int64_t x = std::floor(minX / worldSize); x <= std::floor(maxX / worldSize); x++) {
+        visit(0, x, 0);
+    }
+
+    // Sort first by distance, then by z/x/y.
+    std::sort(t.begin(), t.end(), [](const ID& a, const ID& b) {
+        return std::tie(a.sqDist, a.z, a.x, a.y) < std::tie(b.sqDist, b.z, b.x, b.y);
+    });
+
+    std::vector<UnwrappedTileID> result;
+    for (const auto& id : t) {
+        result.emplace_back(id.z, id.x, id.y);
+    }
+    return result;
+}
+
 } // namespace util
 } // namespace mbgl
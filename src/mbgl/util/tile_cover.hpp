@@ -3,6 +3,7 @@
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/util/tile_coordinate.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <vector>
 
@@ -18,5 +19,36 @@ int32_t coveringZoomLevel(double z, SourceType type, uint16_t tileSize);
 std::vector<UnwrappedTileID> tileCover(const TransformState&, int32_t z);
 std::vector<UnwrappedTileID> tileCover(const LatLngBounds&, int32_t z);
 
+// Covers the viewport with tiles of zoom level z near the camera, and of lower zoom levels, down
+// to minZ, the farther they are from it. In pitched views, this spares the many full-detail tiles
+// near the horizon that would otherwise be loaded to draw only a few pixels each.
+std::vector<UnwrappedTileID> lodTileCover(const TransformState&, int32_t z, int32_t minZ);
+
+// Enumerates the tiles of tileCover(const LatLngBounds&, z) one at a time instead of
+// materializing them, leaving out those that only touch bounds ending on a tile edge. The tiles come in Z-order, so that consecutive ones are near each other,
+// and only a stack of a few tile IDs per zoom level is kept while walking the tile tree.
+class TileCover {
+public:
+    TileCover(const LatLngBounds&, int32_t z);
+
+    // The number of tiles in the cover, computed without enumerating them.
+    uint64_t size() const;
+
+    // Returns the next tile, or an empty optional when all tiles have been returned.
+    optional<UnwrappedTileID> next();
+
+private:
+    struct Node {
+        int32_t z;
+        int64_t x;
+        int64_t y;
+    };
+
+    int32_t z;
+    int64_t minX = 0, maxX = 0;
+    int64_t minY = 0, maxY = 0;
+    std::vector<Node> stack;
+};
+
 } // namespace util
 } // namespace mbgl
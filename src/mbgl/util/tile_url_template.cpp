@@ -0,0 +1,163 @@
+#include <mbgl/util/tile_url_template.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/token.hpp>
+
+#include <mapbox/geometry/point.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mbgl {
+
+namespace {
+
+// Large enough for the digits of z, x or y; other tokens grow the string as they need to.
+const std::size_t tokenLengthEstimate = 8;
+
+void appendInteger(std::string& result, int32_t value) {
+    char digits[10];
+    char* const end = digits + sizeof(digits);
+    char* begin = end;
+    uint32_t magnitude = value < 0 ? 0u - uint32_t(value) : uint32_t(value);
+    do {
+        *--begin = char('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0) {
+        result += '-';
+    }
+    result.append(begin, end);
+}
+
+void appendQuadKey(std::string& result, int32_t x, int32_t y, int8_t z) {
+    for (int8_t i = z; i > 0; i--) {
+        const int32_t mask = 1 << (i - 1);
+        result += char('0' + ((x & mask ? 1 : 0) + (y & mask ? 2 : 0)));
+    }
+}
+
+mapbox::geometry::point<double> getMercCoord(int32_t x, int32_t y, int8_t z) {
+    double resolution = (util::M2PI * util::EARTH_RADIUS_M / 256) / std::pow(2.0f, z);
+    return {
+        x * resolution - util::M2PI * util::EARTH_RADIUS_M / 2,
+        y * resolution - util::M2PI * util::EARTH_RADIUS_M / 2,
+    };
+}
+
+void appendTileBBox(std::string& result, int32_t x, int32_t y, int8_t z) {
+    // Alter the y for the Google/OSM tile scheme.
+    y = std::pow(2.0f, z) - y - 1;
+
+    auto min = getMercCoord(x * 256, y * 256, z);
+    auto max = getMercCoord((x + 1) * 256, (y + 1) * 256, z);
+
+    result.append(util::toString(min.x)).append(",").append(util::toString(min.y)).append(",");
+    result.append(util::toString(max.x)).append(",").append(util::toString(max.y));
+}
+
+} // namespace
+
+TileURLTemplate::TileURLTemplate(std::string source_)
+    : source(std::move(source_)) {
+    // Tokens are delimited the same way util::replaceTokens delimits them, and unknown tokens
+    // are left out of the URL just as they are replaced with nothing there.
+    const auto begin = source.begin();
+    const auto end = source.end();
+    auto pos = begin;
+
+    const auto addLiteral = [&](auto first, auto last) {
+        if (first == last) {
+            return;
+        }
+        const std::size_t offset = first - begin;
+        const std::size_t length = last - first;
+        if (!segments.empty() && segments.back().token == Token::Literal &&
+            segments.back().offset + segments.back().length == offset) {
+            segments.back().length += length;
+        } else {
+            segments.push_back({ Token::Literal, offset, length });
+        }
+        literalLength += length;
+    };
+
+    const auto addToken = [&](const std::string& token) {
+        Token kind;
+        if (token == "z") {
+            kind = Token::Z;
+        } else if (token == "x") {
+            kind = Token::X;
+        } else if (token == "y") {
+            kind = Token::Y;
+        } else if (token == "quadkey") {
+            kind = Token::QuadKey;
+        } else if (token == "bbox-epsg-3857") {
+            kind = Token::BBox;
+        } else if (token == "prefix") {
+            kind = Token::Prefix;
+        } else if (token == "ratio") {
+            kind = Token::Ratio;
+            ratio = true;
+        } else {
+            return;
+        }
+        segments.push_back({ kind, 0, 0 });
+    };
+
+    while (pos != end) {
+        auto brace = std::find(pos, end, '{');
+        addLiteral(pos, brace);
+        pos = brace;
+        if (pos != end) {
+            for (brace++; brace != end && util::tokenReservedChars.find(*brace) == std::string::npos; brace++);
+            if (brace != end && *brace == '}') {
+                addToken({ pos + 1, brace });
+                pos = brace + 1;
+            } else {
+                addLiteral(pos, brace);
+                pos = brace;
+            }
+        }
+    }
+}
+
+std::string TileURLTemplate::url(float pixelRatio, int32_t x, int32_t y, int8_t z) const {
+    std::string result;
+    result.reserve(literalLength + tokenLengthEstimate * segments.size());
+
+    for (const Segment& segment : segments) {
+        switch (segment.token) {
+        case Token::Literal:
+            result.append(source, segment.offset, segment.length);
+            break;
+        case Token::Z:
+            appendInteger(result, z);
+            break;
+        case Token::X:
+            appendInteger(result, x);
+            break;
+        case Token::Y:
+            appendInteger(result, y);
+            break;
+        case Token::QuadKey:
+            appendQuadKey(result, x, y, z);
+            break;
+        case Token::BBox:
+            appendTileBBox(result, x, y, z);
+            break;
+        case Token::Prefix:
+            result += "0123456789abcdef"[x % 16];
+            result += "0123456789abcdef"[y % 16];
+            break;
+        case Token::Ratio:
+            if (pixelRatio > 1.0) {
+                result += "@2x";
+            }
+            break;
+        }
+    }
+
+    return result;
+}
+
+} // namespace mbgl
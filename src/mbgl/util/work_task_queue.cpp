@@ -0,0 +1,59 @@
+#include <mbgl/util/work_task_queue.hpp>
+#include <mbgl/util/work_task.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+namespace util {
+
+WorkTaskQueue::~WorkTaskQueue() {
+    release(head.exchange(nullptr, std::memory_order_acquire));
+}
+
+void WorkTaskQueue::release(WorkTask* task) {
+    while (task) {
+        WorkTask* next = task->next;
+        task->queued.reset();
+        task = next;
+    }
+}
+
+void WorkTaskQueue::push(std::shared_ptr<WorkTask> task) {
+    assert(task && !task->queued);
+
+    // The queue holds on to the task through the task itself until it runs.
+    WorkTask* const raw = task.get();
+    raw->queued = std::move(task);
+
+    WorkTask* first = head.load(std::memory_order_relaxed);
+    do {
+        raw->next = first;
+    } while (!head.compare_exchange_weak(first, raw, std::memory_order_release,
+                                         std::memory_order_relaxed));
+}
+
+void WorkTaskQueue::process() {
+    // The stack holds the most recently pushed task first.
+    WorkTask* task = head.exchange(nullptr, std::memory_order_acquire);
+    WorkTask* ordered = nullptr;
+    while (task) {
+        WorkTask* next = task->next;
+        task->next = ordered;
+        ordered = task;
+        task = next;
+    }
+
+    struct Remaining {
+        WorkTask* task;
+        ~Remaining() { release(task); }
+    } remaining { ordered };
+
+    while (remaining.task) {
+        std::shared_ptr<WorkTask> current = std::move(remaining.task->queued);
+        remaining.task = remaining.task->next;
+        (*current)();
+    }
+}
+
+} // namespace util
+} // namespace mbgl
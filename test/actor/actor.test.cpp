@@ -1,11 +1,14 @@
 #include <mbgl/actor/actor.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/platform.hpp>
 
 #include <mbgl/test/util.hpp>
 
 #include <chrono>
 #include <functional>
 #include <future>
+#include <memory>
+#include <thread>
 
 using namespace mbgl;
 using namespace std::chrono_literals;
@@ -67,6 +70,46 @@ TEST(Actor, DestructionClosesMailbox) {
     exitingPromise.set_value();
 }
 
+TEST(Actor, DestructionReleasesPendingMessages) {
+    // Messages that were still queued when the actor is destroyed are released with it, not
+    // received.
+
+    struct Test {
+        Test(ActorRef<Test>) {}
+
+        void block(std::promise<void> entered, std::shared_future<void> release) {
+            entered.set_value();
+            release.wait();
+        }
+
+        void hold(std::shared_ptr<int>) {
+            FAIL() << "received a message after destruction";
+        }
+    };
+
+    ThreadPool pool { 1 };
+    auto test = std::make_unique<Actor<Test>>(pool);
+
+    std::promise<void> enteredPromise;
+    std::future<void> enteredFuture = enteredPromise.get_future();
+    std::promise<void> releasePromise;
+    test->invoke(&Test::block, std::move(enteredPromise), releasePromise.get_future().share());
+
+    auto data = std::make_shared<int>(1);
+    std::weak_ptr<int> weak = data;
+    test->invoke(&Test::hold, std::move(data));
+
+    enteredFuture.wait();
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(1ms);
+        releasePromise.set_value();
+    });
+    test.reset();
+    releaser.join();
+
+    EXPECT_TRUE(weak.expired());
+}
+
 TEST(Actor, OrderedMailbox) {
     // Messages are processed in order.
 
@@ -102,6 +145,38 @@ TEST(Actor, OrderedMailbox) {
     endedFuture.wait();
 }
 
+TEST(Actor, InteractivePool) {
+    // Messages are processed while the pool's threads move between cores.
+
+    struct Test {
+        std::promise<void> promise;
+
+        Test(ActorRef<Test>, std::promise<void> promise_)
+            : promise(std::move(promise_))  {
+        }
+
+        void end() {
+            promise.set_value();
+        }
+    };
+
+    ThreadPool pool { 2 };
+    EXPECT_GE(platform::getPerformanceCoreCount(), 1u);
+
+    // Interactions nest.
+    pool.setInteractive(true);
+    pool.setInteractive(true);
+    pool.setInteractive(false);
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<Test> test(pool, std::move(endedPromise));
+    test.invoke(&Test::end);
+    endedFuture.wait();
+
+    pool.setInteractive(false);
+}
+
 TEST(Actor, NonConcurrentMailbox) {
     // An individual actor is never itself concurrent.
 
@@ -137,3 +212,125 @@ TEST(Actor, NonConcurrentMailbox) {
     test.invoke(&Test::end);
     endedFuture.wait();
 }
+
+TEST(Actor, Priority) {
+    // Pending mailboxes with a higher priority are received first.
+
+    struct Blocker {
+        std::promise<void> entered;
+        std::shared_future<void> release;
+
+        Blocker(ActorRef<Blocker>, std::promise<void> entered_, std::shared_future<void> release_)
+            : entered(std::move(entered_)),
+              release(std::move(release_)) {
+        }
+
+        void block() {
+            entered.set_value();
+            release.wait();
+        }
+    };
+
+    struct Test {
+        int id;
+        std::vector<int>& order;
+
+        Test(ActorRef<Test>, int id_, std::vector<int>& order_)
+            : id(id_), order(order_) {
+        }
+
+        void receive() {
+            order.push_back(id);
+        }
+    };
+
+    ThreadPool pool { 1 };
+
+    std::promise<void> enteredPromise;
+    std::future<void> enteredFuture = enteredPromise.get_future();
+    std::promise<void> releasePromise;
+    Actor<Blocker> blocker(pool, std::move(enteredPromise), releasePromise.get_future().share());
+
+    // Occupy the only thread so that the following mailboxes are all pending at once.
+    blocker.invoke(&Blocker::block);
+    enteredFuture.wait();
+
+    std::vector<int> order;
+    Actor<Test> low(pool, 1, std::ref(order));
+    Actor<Test> high(pool, 2, std::ref(order));
+    Actor<Test> normal(pool, 3, std::ref(order));
+    low.setPriority(-10);
+    high.setPriority(10);
+
+    low.invoke(&Test::receive);
+    high.invoke(&Test::receive);
+    normal.invoke(&Test::receive);
+
+    releasePromise.set_value();
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    std::promise<void> ready;
+    ready.set_value();
+    Actor<Blocker> end(pool, std::move(endedPromise), ready.get_future().share());
+    end.setPriority(-100);
+    end.invoke(&Blocker::block);
+    endedFuture.wait();
+
+    EXPECT_EQ((std::vector<int>{ 2, 3, 1 }), order);
+}
+
+TEST(Actor, InvokeLatest) {
+    // A message sent with invokeLatest supersedes a still-pending one for the same member
+    // function. It takes the pending one's place if that is the last message in the queue, and is
+    // queued behind the messages sent after it otherwise.
+
+    struct Test {
+        std::vector<int> received;
+
+        Test(ActorRef<Test>) {}
+
+        void block(std::shared_future<void> release) {
+            release.wait();
+        }
+
+        void latest(int value) {
+            received.push_back(value);
+        }
+
+        void other(int value) {
+            received.push_back(-value);
+        }
+
+        void done(std::promise<std::vector<int>> promise) {
+            promise.set_value(received);
+        }
+    };
+
+    ThreadPool pool { 1 };
+    Actor<Test> test(pool);
+
+    std::promise<void> releasePromise;
+    test.invoke(&Test::block, releasePromise.get_future().share());
+
+    test.invokeLatest(&Test::latest, 1);
+    test.invoke(&Test::other, 1);
+    test.invokeLatest(&Test::latest, 2);
+    test.invokeLatest(&Test::other, 2);
+    test.invokeLatest(&Test::latest, 3);
+    test.invokeLatest(&Test::latest, 4);
+
+    std::promise<std::vector<int>> result;
+    auto future = result.get_future();
+    test.invoke(&Test::done, std::move(result));
+
+    releasePromise.set_value();
+    EXPECT_EQ((std::vector<int>{ -1, -2, 4 }), future.get());
+
+    // Once the superseded message has been received, the next one is queued again.
+    std::promise<std::vector<int>> again;
+    future = again.get_future();
+    test.invokeLatest(&Test::latest, 5);
+    test.invoke(&Test::done, std::move(again));
+    EXPECT_EQ((std::vector<int>{ -1, -2, 4, 5 }), future.get());
+}
@@ -0,0 +1,123 @@
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/util/work_stealing_thread_pool.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <atomic>
+#include <future>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(WorkStealingThreadPool, OrderedMailbox) {
+    // Messages to a single actor are processed in order, even across workers.
+
+    struct Test {
+        int last = 0;
+        std::promise<void> promise;
+
+        Test(ActorRef<Test>, std::promise<void> promise_)
+            : promise(std::move(promise_))  {
+        }
+
+        void receive(int i) {
+            EXPECT_EQ(i, last + 1);
+            last = i;
+        }
+
+        void end() {
+            promise.set_value();
+        }
+    };
+
+    WorkStealingThreadPool pool { 4 };
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<Test> test(pool, std::move(endedPromise));
+
+    for (auto i = 1; i <= 10000; ++i) {
+        test.invoke(&Test::receive, i);
+    }
+
+    test.invoke(&Test::end);
+    endedFuture.wait();
+}
+
+TEST(WorkStealingThreadPool, NonConcurrentMailbox) {
+    // An individual actor is never processed concurrently.
+
+    struct Test {
+        std::atomic<bool> receiving { false };
+        std::promise<void> promise;
+
+        Test(ActorRef<Test>, std::promise<void> promise_)
+            : promise(std::move(promise_))  {
+        }
+
+        void receive() {
+            EXPECT_FALSE(receiving.exchange(true));
+            receiving = false;
+        }
+
+        void end() {
+            promise.set_value();
+        }
+    };
+
+    WorkStealingThreadPool pool { 8 };
+
+    std::vector<std::future<void>> futures;
+    std::vector<std::unique_ptr<Actor<Test>>> actors;
+    for (auto i = 0; i < 16; ++i) {
+        std::promise<void> promise;
+        futures.push_back(promise.get_future());
+        actors.push_back(std::make_unique<Actor<Test>>(pool, std::move(promise)));
+    }
+
+    for (auto i = 0; i < 1000; ++i) {
+        for (auto& actor : actors) {
+            actor->invoke(&Test::receive);
+        }
+    }
+
+    for (auto& actor : actors) {
+        actor->invoke(&Test::end);
+    }
+
+    for (auto& future : futures) {
+        future.wait();
+    }
+}
+
+TEST(WorkStealingThreadPool, SelfScheduling) {
+    // Messages sent from a worker (here, a chain of actors messaging each other) are
+    // processed by the pool like any other message.
+
+    struct Test {
+        ActorRef<Test> self;
+        std::promise<void> promise;
+
+        Test(ActorRef<Test> self_, std::promise<void> promise_)
+            : self(self_),
+              promise(std::move(promise_)) {
+        }
+
+        void countdown(int remaining) {
+            if (remaining == 0) {
+                promise.set_value();
+            } else {
+                self.invoke(&Test::countdown, remaining - 1);
+            }
+        }
+    };
+
+    WorkStealingThreadPool pool { 2 };
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<Test> test(pool, std::move(endedPromise));
+
+    test.invoke(&Test::countdown, 10000);
+    endedFuture.wait();
+}
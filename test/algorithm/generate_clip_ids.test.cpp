@@ -426,3 +426,29 @@ TEST(GenerateClipIDs, SecondSourceHasParentOfFirstSource) {
               }),
               stencils);
 }
+
+TEST(GenerateClipIDs, Overlaps) {
+    std::map<UnwrappedTileID, Renderable> adjacent{
+        { UnwrappedTileID{ 1, 0, 0 }, Renderable{ {} } },
+        { UnwrappedTileID{ 1, 1, 0 }, Renderable{ {} } },
+        { UnwrappedTileID{ 2, 0, 2 }, Renderable{ {} } },
+    };
+
+    algorithm::ClipIDGenerator generator;
+    generator.update(adjacent);
+    EXPECT_FALSE(generator.hasOverlaps());
+
+    std::map<UnwrappedTileID, Renderable> nested{
+        { UnwrappedTileID{ 1, 0, 0 }, Renderable{ {} } },
+        { UnwrappedTileID{ 2, 1, 1 }, Renderable{ {} } },
+    };
+
+    // Unused renderables are not drawn, and don't overlap the others.
+    nested[UnwrappedTileID{ 2, 1, 1 }].used = false;
+    generator.update(nested);
+    EXPECT_FALSE(generator.hasOverlaps());
+
+    nested[UnwrappedTileID{ 2, 1, 1 }].used = true;
+    generator.update(nested);
+    EXPECT_TRUE(generator.hasOverlaps());
+}
@@ -1226,3 +1226,113 @@ TEST(UpdateRenderables, RepeatedRenderWithMissingOptionals) {
               }),
               log);
 }
+
+TEST(UpdateRenderables, MixedZoomIdealTiles) {
+    ActionLog log;
+    MockSource source;
+    auto getTileData = getTileDataFn(log, source.dataTiles);
+    auto createTileData = createTileDataFn(log, source.dataTiles);
+    auto retainTileData = retainTileDataFn(log);
+    auto renderTile = renderTileFn(log);
+
+    // Far from the camera, a tile of a lower zoom level replaces four of the ideal zoom level.
+    source.zoomRange.max = 2;
+    source.idealTiles.emplace(UnwrappedTileID{ 2, 0, 0 });
+    source.idealTiles.emplace(UnwrappedTileID{ 1, 1, 0 });
+
+    auto tile_3_2_0_0 = source.createTileData(OverscaledTileID{ 3, { 2, 0, 0 } });
+    tile_3_2_0_0->renderable = true;
+    auto tile_1_1_1_0 = source.createTileData(OverscaledTileID{ 1, { 1, 1, 0 } });
+    tile_1_1_1_0->renderable = true;
+
+    // Only tiles of the source's maximum zoom level are overzoomed.
+    algorithm::updateRenderables(getTileData, createTileData, retainTileData, renderTile,
+                                 source.idealTiles, source.zoomRange, 3);
+    EXPECT_EQ(ActionLog({
+                  GetTileDataAction{ { 1, { 1, 1, 0 } }, Found },       // lower zoom ideal tile
+                  RetainTileDataAction{ { 1, { 1, 1, 0 } }, Resource::Necessity::Required }, //
+                  RenderTileAction{ { 1, 1, 0 }, *tile_1_1_1_0 },       //
+                  GetTileDataAction{ { 3, { 2, 0, 0 } }, Found },       // overzoomed ideal tile
+                  RetainTileDataAction{ { 3, { 2, 0, 0 } }, Resource::Necessity::Required }, //
+                  RenderTileAction{ { 2, 0, 0 }, *tile_3_2_0_0 },       //
+              }),
+              log);
+
+    // A missing lower zoom ideal tile is replaced with its own children and parents.
+    log.clear();
+    source.idealTiles.erase(UnwrappedTileID{ 2, 0, 0 });
+    source.dataTiles.erase(OverscaledTileID{ 1, { 1, 1, 0 } });
+    algorithm::updateRenderables(getTileData, createTileData, retainTileData, renderTile,
+                                 source.idealTiles, source.zoomRange, 3);
+    EXPECT_EQ(ActionLog({
+                  GetTileDataAction{ { 1, { 1, 1, 0 } }, NotFound },    // missing ideal tile
+                  CreateTileDataAction{ { 1, { 1, 1, 0 } } },           //
+                  RetainTileDataAction{ { 1, { 1, 1, 0 } }, Resource::Necessity::Required }, //
+                  GetTileDataAction{ { 2, { 2, 2, 0 } }, NotFound },    // child tile
+                  GetTileDataAction{ { 2, { 2, 2, 1 } }, NotFound },    // ...
+                  GetTileDataAction{ { 2, { 2, 3, 0 } }, NotFound },    // ...
+                  GetTileDataAction{ { 2, { 2, 3, 1 } }, NotFound },    // ...
+                  GetTileDataAction{ { 0, { 0, 0, 0 } }, NotFound },    // parent tile
+              }),
+              log);
+}
+
+TEST(UpdateRenderables, UseDescendantTiles) {
+    ActionLog log;
+    MockSource source;
+    auto getTileData = getTileDataFn(log, source.dataTiles);
+    auto createTileData = createTileDataFn(log, source.dataTiles);
+    auto retainTileData = retainTileDataFn(log);
+    auto renderTile = renderTileFn(log);
+
+    source.idealTiles.emplace(UnwrappedTileID{ 1, 0, 0 });
+
+    // The ideal tile is missing, and so are three of its children. The tiles below one of them,
+    // which were drawn before zooming out, are still loaded.
+    source.createTileData(OverscaledTileID{ 1, 0, 0 });
+    auto tile_2_2_0_0 = source.createTileData(OverscaledTileID{ 2, 0, 0 });
+    tile_2_2_0_0->renderable = true;
+    auto tile_3_3_2_0 = source.createTileData(OverscaledTileID{ 3, 2, 0 });
+    tile_3_3_2_0->renderable = true;
+    auto tile_3_3_2_1 = source.createTileData(OverscaledTileID{ 3, 2, 1 });
+    tile_3_3_2_1->renderable = true;
+    auto tile_3_3_3_0 = source.createTileData(OverscaledTileID{ 3, 3, 0 });
+    tile_3_3_3_0->renderable = true;
+    auto tile_3_3_3_1 = source.createTileData(OverscaledTileID{ 3, 3, 1 });
+    tile_3_3_3_1->renderable = true;
+
+    algorithm::updateRenderables(getTileData, createTileData, retainTileData, renderTile,
+                                 source.idealTiles, source.zoomRange, 1, 2);
+    EXPECT_EQ(ActionLog({
+                  GetTileDataAction{ { 1, { 1, 0, 0 } }, Found },       // ideal tile, not ready
+                  RetainTileDataAction{ { 1, { 1, 0, 0 } }, Resource::Necessity::Required }, //
+                  GetTileDataAction{ { 2, { 2, 0, 0 } }, Found },       // child tile
+                  RetainTileDataAction{ { 2, { 2, 0, 0 } }, Resource::Necessity::Optional }, //
+                  RenderTileAction{ { 2, 0, 0 }, *tile_2_2_0_0 },       //
+                  GetTileDataAction{ { 2, { 2, 0, 1 } }, NotFound },    // child tile
+                  GetTileDataAction{ { 3, { 3, 0, 2 } }, NotFound },    // grandchild tiles
+                  GetTileDataAction{ { 3, { 3, 0, 3 } }, NotFound },    // ...
+                  GetTileDataAction{ { 3, { 3, 1, 2 } }, NotFound },    // ...
+                  GetTileDataAction{ { 3, { 3, 1, 3 } }, NotFound },    // ...
+                  GetTileDataAction{ { 2, { 2, 1, 0 } }, NotFound },    // child tile
+                  GetTileDataAction{ { 3, { 3, 2, 0 } }, Found },       // grandchild tiles
+                  RetainTileDataAction{ { 3, { 3, 2, 0 } }, Resource::Necessity::Optional }, //
+                  RenderTileAction{ { 3, 2, 0 }, *tile_3_3_2_0 },       //
+                  GetTileDataAction{ { 3, { 3, 2, 1 } }, Found },       // ...
+                  RetainTileDataAction{ { 3, { 3, 2, 1 } }, Resource::Necessity::Optional }, //
+                  RenderTileAction{ { 3, 2, 1 }, *tile_3_3_2_1 },       //
+                  GetTileDataAction{ { 3, { 3, 3, 0 } }, Found },       // ...
+                  RetainTileDataAction{ { 3, { 3, 3, 0 } }, Resource::Necessity::Optional }, //
+                  RenderTileAction{ { 3, 3, 0 }, *tile_3_3_3_0 },       //
+                  GetTileDataAction{ { 3, { 3, 3, 1 } }, Found },       // ...
+                  RetainTileDataAction{ { 3, { 3, 3, 1 } }, Resource::Necessity::Optional }, //
+                  RenderTileAction{ { 3, 3, 1 }, *tile_3_3_3_1 },       //
+                  GetTileDataAction{ { 2, { 2, 1, 1 } }, NotFound },    // child tile
+                  GetTileDataAction{ { 3, { 3, 2, 2 } }, NotFound },    // grandchild tiles
+                  GetTileDataAction{ { 3, { 3, 2, 3 } }, NotFound },    // ...
+                  GetTileDataAction{ { 3, { 3, 3, 2 } }, NotFound },    // ...
+                  GetTileDataAction{ { 3, { 3, 3, 3 } }, NotFound },    // ...
+                  GetTileDataAction{ { 0, { 0, 0, 0 } }, NotFound },    // parent tile
+              }),
+              log);
+}
@@ -11,8 +11,12 @@
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/color.hpp>
+#include <mbgl/style/layer.hpp>
+
+#include <algorithm>
 
 using namespace mbgl;
+using namespace mbgl::style;
 
 namespace {
 
@@ -144,6 +148,53 @@ TEST(Annotations, OverlappingFillAnnotation) {
     test.checkRendering("overlapping_fill_annotation");
 }
 
+TEST(Annotations, BatchShapeAnnotations) {
+    AnnotationTest test;
+
+    auto shapeLayerCount = [&] {
+        auto layers = test.map.getLayers();
+        return std::count_if(layers.begin(), layers.end(), [] (const auto& layer) {
+            return layer->getID().find("com.mapbox.annotations.shape.") == 0;
+        });
+    };
+
+    test.map.setStyleJSON(util::read_file("test/fixtures/api/empty.json"));
+
+    // Lines of the same width share a layer, whatever their colors.
+    std::vector<AnnotationID> lines;
+    for (int i = 0; i < 600; ++i) {
+        LineAnnotation annotation { LineString<double> {{ { double(i % 90), 0 }, { double(i % 90), 45 } }} };
+        annotation.color = i % 2 ? Color::red() : Color::blue();
+        annotation.width = { 2 };
+        lines.push_back(test.map.addAnnotation(annotation));
+    }
+    LineAnnotation wide { LineString<double> {{ { 0, 0 }, { 45, 45 } }} };
+    wide.width = { 5 };
+    test.map.addAnnotation(wide);
+
+    Polygon<double> polygon = { {{ { 0, 0 }, { 0, 45 }, { 45, 45 }, { 45, 0 } }} };
+    FillAnnotation fill { polygon };
+    fill.color = Color::green();
+    test.map.addAnnotation(fill);
+
+    test::render(test.map, test.view);
+    EXPECT_EQ(shapeLayerCount(), 4);
+
+    // A batch's layer goes away with the last of its annotations; batches hold 512 annotations.
+    for (std::size_t i = 512; i < lines.size(); ++i) {
+        test.map.removeAnnotation(lines[i]);
+    }
+    test::render(test.map, test.view);
+    EXPECT_EQ(shapeLayerCount(), 3);
+
+    // Annotations styled with functions get layers of their own.
+    LineAnnotation zoomed { LineString<double> {{ { 0, 0 }, { 45, 45 } }} };
+    zoomed.color = CameraFunction<Color>(ExponentialStops<Color>({ { 0, Color::red() }, { 10, Color::blue() } }));
+    test.map.addAnnotation(zoomed);
+    test::render(test.map, test.view);
+    EXPECT_EQ(shapeLayerCount(), 4);
+}
+
 TEST(Annotations, StyleSourcedShapeAnnotation) {
     AnnotationTest test;
 
@@ -350,6 +401,30 @@ TEST(Annotations, QueryRenderedFeatures) {
     EXPECT_EQ(*features2[0].id, uint64_t(1));
 }
 
+TEST(Annotations, QueryInstancedSymbolAnnotations) {
+    AnnotationTest test;
+
+    auto viewSize = test.view.getSize();
+    auto box = ScreenBox { {}, { double(viewSize.width), double(viewSize.height) } };
+
+    test.map.setStyleJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.map.setInstancedPointAnnotations(true);
+    test.map.addAnnotationIcon("default_marker", namedMarker("default_marker.png"));
+    AnnotationID point = test.map.addAnnotation(SymbolAnnotation { Point<double> { 0, 0 }, "default_marker" });
+
+    test::render(test.map, test.view);
+
+    EXPECT_EQ(test.map.queryPointAnnotations(box), AnnotationIDs { point });
+
+    test.map.updateAnnotation(point, SymbolAnnotation { Point<double> { 100, 0 }, "default_marker" });
+    test::render(test.map, test.view);
+
+    const ScreenCoordinate center = test.map.pixelForLatLng({ 0, 0 });
+    EXPECT_TRUE(test.map.queryPointAnnotations({ center - ScreenCoordinate { 10, 10 }, center + ScreenCoordinate { 10, 10 } }).empty());
+    const ScreenCoordinate moved = test.map.pixelForLatLng({ 0, 100 });
+    EXPECT_EQ(test.map.queryPointAnnotations({ moved - ScreenCoordinate { 10, 10 }, moved + ScreenCoordinate { 10, 10 } }), AnnotationIDs { point });
+}
+
 TEST(Annotations, QueryFractionalZoomLevels) {
     AnnotationTest test;
 
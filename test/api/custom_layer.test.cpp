@@ -121,3 +121,45 @@ TEST(CustomLayer, Basic) {
 
     test::checkImage("test/fixtures/custom_layer/basic", test::render(map, view), 0.0006, 0.1);
 }
+
+TEST(CustomLayer, DeclaredGLState) {
+    util::RunLoop loop;
+
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    OffscreenView view { backend.getContext() };
+
+#ifdef MBGL_ASSET_ZIP
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets.zip");
+#else
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets");
+#endif
+
+    ThreadPool threadPool(4);
+
+    // The layer only changes the program and the buffers, so only they are set up again.
+    Map map(backend, view.getSize(), 1, fileSource, threadPool, MapMode::Still);
+    map.setStyleJSON(util::read_file("test/fixtures/api/water.json"));
+    map.setLatLngZoom({ 37.8, -122.5 }, 10);
+    map.addLayer(std::make_unique<CustomLayer>(
+        "custom",
+        [] (void* context) {
+            reinterpret_cast<TestLayer*>(context)->initialize();
+        },
+        [] (void* context, const CustomLayerRenderParameters& parameters) {
+            EXPECT_FALSE(parameters.tiles.empty());
+            EXPECT_NE(0u, parameters.tileQuad.vertexBuffer);
+            EXPECT_NE(0u, parameters.tileQuad.indexBuffer);
+            reinterpret_cast<TestLayer*>(context)->render();
+        },
+        [] (void* context) {
+            delete reinterpret_cast<TestLayer*>(context);
+        }, new TestLayer(), CustomLayerGLState::Program | CustomLayerGLState::Buffers));
+
+    auto layer = std::make_unique<FillLayer>("landcover", "mapbox");
+    layer->setSourceLayer("landcover");
+    layer->setFillColor(Color{ 1.0, 1.0, 0.0, 1.0 });
+    map.addLayer(std::move(layer));
+
+    test::checkImage("test/fixtures/custom_layer/basic", test::render(map, view), 0.0006, 0.1);
+}
@@ -9,7 +9,9 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/async_request.hpp>
 #include <mbgl/style/source.hpp>
+#include <mbgl/style/layer.hpp>
 
 using namespace mbgl;
 using namespace mbgl::style;
@@ -85,6 +87,79 @@ TEST(Query, QueryRenderedFeaturesFilter) {
     EXPECT_EQ(features3.size(), 1u);
 }
 
+TEST(Query, QueryRenderedFeatureHandles) {
+    QueryTest test;
+
+    auto zz = test.map.pixelForLatLng({ 0, 0 });
+
+    auto features = test.map.queryRenderedFeatures(zz);
+    auto handles = test.map.queryRenderedFeatureHandles(zz);
+    ASSERT_EQ(features.size(), handles.size());
+    for (std::size_t i = 0; i < handles.size(); i++) {
+        EXPECT_EQ(features[i], handles[i].getFeature());
+        EXPECT_EQ(features[i].id, handles[i].getID());
+    }
+
+    auto layer1 = test.map.queryRenderedFeatureHandles(zz, {{{ "layer1" }}, {}});
+    ASSERT_EQ(layer1.size(), 1u);
+    EXPECT_EQ("layer1", layer1[0].getLayer().getID());
+
+    EXPECT_EQ(test.map.queryRenderedFeatureHandles(test.map.pixelForLatLng({ 9, 9 })).size(), 0u);
+}
+
+TEST(Query, PickRenderedFeature) {
+    util::RunLoop loop;
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    OffscreenView view { backend.getContext() };
+    StubFileSource fileSource;
+    ThreadPool threadPool { 4 };
+    Map map { backend, view.getSize(), 1, fileSource, threadPool, MapMode::Still };
+
+    // Two overlapping squares in the lower layer, and a smaller one above them.
+    map.setStyleJSON(R"STYLE({
+      "version": 8,
+      "sources": {
+        "squares": {
+          "type": "geojson",
+          "data": { "type": "FeatureCollection", "features": [
+            { "type": "Feature", "id": 1, "properties": {}, "geometry": { "type": "Polygon",
+              "coordinates": [[[-20, -20], [10, -20], [10, 10], [-20, 10], [-20, -20]]] } },
+            { "type": "Feature", "id": 2, "properties": {}, "geometry": { "type": "Polygon",
+              "coordinates": [[[-10, -10], [20, -10], [20, 20], [-10, 20], [-10, -10]]] } }
+          ] }
+        },
+        "square": {
+          "type": "geojson",
+          "data": { "type": "Feature", "id": 3, "properties": {}, "geometry": { "type": "Polygon",
+            "coordinates": [[[-2, -2], [2, -2], [2, 2], [-2, 2], [-2, -2]]] } }
+        }
+      },
+      "layers": [
+        { "id": "lower", "type": "fill", "source": "squares" },
+        { "id": "upper", "type": "fill", "source": "square" }
+      ]
+    })STYLE");
+    map.setFeaturePicking(true);
+    EXPECT_TRUE(map.getFeaturePicking());
+    test::render(map, view);
+
+    auto pickedID = [&] (const LatLng& latLng, const RenderedQueryOptions& options) -> optional<FeatureIdentifier> {
+        const auto picked = map.pickRenderedFeature(map.pixelForLatLng(latLng), options);
+        return picked ? picked->getID() : optional<FeatureIdentifier>();
+    };
+
+    EXPECT_EQ(optional<FeatureIdentifier>(uint64_t(3)), pickedID({ 0, 0 }, {}));
+    EXPECT_EQ(optional<FeatureIdentifier>(uint64_t(2)), pickedID({ 0, 0 }, {{{ "lower" }}, {}}));
+    EXPECT_EQ(optional<FeatureIdentifier>(uint64_t(1)), pickedID({ -15, -15 }, {}));
+    EXPECT_EQ(optional<FeatureIdentifier>(uint64_t(2)), pickedID({ 15, 15 }, {}));
+    EXPECT_EQ(optional<FeatureIdentifier>(), pickedID({ 30, 30 }, {}));
+
+    // Filtered queries fall back to the feature index.
+    const IdentifierEqualsFilter idFilter = { uint64_t(1) };
+    EXPECT_EQ(optional<FeatureIdentifier>(uint64_t(1)), pickedID({ 0, 0 }, {{}, { idFilter }}));
+}
+
 TEST(Query, QuerySourceFeatures) {
     QueryTest test;
 
@@ -92,6 +167,41 @@ TEST(Query, QuerySourceFeatures) {
     EXPECT_EQ(features1.size(), 1u);
 }
 
+TEST(Query, QuerySourceFeaturesAsync) {
+    QueryTest test;
+
+    const EqualsFilter eqFilter = { "key1", std::string("value1") };
+    std::vector<Feature> features;
+    std::size_t calls = 0;
+    auto request = test.map.getSource("source4")->querySourceFeatures({{}, { eqFilter }},
+        [&] (std::vector<Feature> result, bool done) {
+            calls++;
+            std::move(result.begin(), result.end(), std::back_inserter(features));
+            if (done) {
+                test.loop.stop();
+            }
+        });
+
+    // The callback is never called from within the query.
+    EXPECT_EQ(0u, calls);
+    test.loop.run();
+
+    EXPECT_LE(1u, calls);
+    ASSERT_EQ(1u, features.size());
+    EXPECT_EQ(features, test.map.getSource("source4")->querySourceFeatures({{}, { eqFilter }}));
+
+    // Raster sources aren't supported, but the query still completes.
+    bool done = false;
+    request = test.map.getSource("source6")->querySourceFeatures({},
+        [&] (std::vector<Feature> result, bool done_) {
+            EXPECT_TRUE(result.empty());
+            done = done_;
+            test.loop.stop();
+        });
+    test.loop.run();
+    EXPECT_TRUE(done);
+}
+
 TEST(Query, QuerySourceFeaturesOptionValidation) {
     QueryTest test;
 
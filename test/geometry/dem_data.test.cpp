@@ -0,0 +1,83 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/geometry/dem_data.hpp>
+
+#include <stdexcept>
+
+using namespace mbgl;
+
+// Encodes an elevation in meters in the Terrain-RGB encoding.
+static void setElevation(UnassociatedImage& image, uint32_t x, uint32_t y, float meters) {
+    const uint32_t value = uint32_t((meters + 10000) * 10);
+    uint8_t* pixel = image.data.get() + (y * image.size.width + x) * 4;
+    pixel[0] = (value >> 16) & 0xFF;
+    pixel[1] = (value >> 8) & 0xFF;
+    pixel[2] = value & 0xFF;
+    pixel[3] = 0xFF;
+}
+
+// A tile whose elevation is the same everywhere.
+static UnassociatedImage flatImage(uint32_t dim, float meters) {
+    UnassociatedImage image({ dim, dim });
+    for (uint32_t y = 0; y < dim; y++) {
+        for (uint32_t x = 0; x < dim; x++) {
+            setElevation(image, x, y, meters);
+        }
+    }
+    return image;
+}
+
+TEST(DEMData, Constructor) {
+    UnassociatedImage image = flatImage(4, 0);
+    setElevation(image, 0, 0, 100);
+    setElevation(image, 3, 2, 8848);
+
+    DEMData dem(image);
+    EXPECT_EQ(4, dem.dim);
+    EXPECT_EQ(6, dem.stride);
+    EXPECT_EQ((Size { 6, 6 }), dem.image.size);
+    EXPECT_FLOAT_EQ(100, dem.get(0, 0));
+    EXPECT_NEAR(8848, dem.get(3, 2), 0.1);
+    EXPECT_FLOAT_EQ(0, dem.get(1, 1));
+
+    // The border repeats the edges.
+    EXPECT_FLOAT_EQ(100, dem.get(-1, -1));
+    EXPECT_FLOAT_EQ(100, dem.get(-1, 0));
+    EXPECT_FLOAT_EQ(100, dem.get(0, -1));
+    EXPECT_NEAR(8848, dem.get(4, 2), 0.1);
+    EXPECT_FLOAT_EQ(0, dem.get(4, 4));
+}
+
+TEST(DEMData, NotSquare) {
+    EXPECT_THROW(DEMData(UnassociatedImage({ 4, 2 })), std::runtime_error);
+}
+
+TEST(DEMData, BackfillBorder) {
+    DEMData dem(flatImage(4, 0));
+    DEMData left(flatImage(4, 10));
+    DEMData above(flatImage(4, 20));
+    DEMData belowRight(flatImage(4, 30));
+
+    dem.backfillBorder(left, -1, 0);
+    for (int32_t y = 0; y < 4; y++) {
+        EXPECT_FLOAT_EQ(10, dem.get(-1, y));
+    }
+    // The corners are left to the diagonal neighbours.
+    EXPECT_FLOAT_EQ(0, dem.get(-1, -1));
+    EXPECT_FLOAT_EQ(0, dem.get(-1, 4));
+    EXPECT_FLOAT_EQ(0, dem.get(0, 0));
+    EXPECT_FLOAT_EQ(0, dem.get(4, 0));
+
+    dem.backfillBorder(above, 0, -1);
+    for (int32_t x = 0; x < 4; x++) {
+        EXPECT_FLOAT_EQ(20, dem.get(x, -1));
+    }
+    EXPECT_FLOAT_EQ(0, dem.get(-1, -1));
+    EXPECT_FLOAT_EQ(10, dem.get(-1, 0));
+
+    // A diagonal neighbour only fills the corner.
+    dem.backfillBorder(belowRight, 1, 1);
+    EXPECT_FLOAT_EQ(30, dem.get(4, 4));
+    EXPECT_FLOAT_EQ(0, dem.get(3, 4));
+    EXPECT_FLOAT_EQ(0, dem.get(4, 3));
+}
@@ -0,0 +1,52 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/geometry/line_atlas.hpp>
+
+using namespace mbgl;
+
+TEST(LineAtlas, Deduplication) {
+    LineAtlas atlas({ 128, 16 });
+
+    const LinePatternPos a = atlas.getDashPosition({ 1, 2 }, LinePatternCap::Square);
+    const LinePatternPos b = atlas.getDashPosition({ 1, 2 }, LinePatternCap::Square);
+    EXPECT_EQ(a.y, b.y);
+    EXPECT_EQ(3, a.width);
+    EXPECT_EQ(1u, atlas.getDashCount());
+
+    // The cap is part of the key.
+    const LinePatternPos c = atlas.getDashPosition({ 1, 2 }, LinePatternCap::Round);
+    EXPECT_NE(a.y, c.y);
+    EXPECT_EQ(2u, atlas.getDashCount());
+}
+
+TEST(LineAtlas, Grow) {
+    LineAtlas atlas({ 128, 16 }, 32);
+
+    // Round patterns take up 15 rows each.
+    const LinePatternPos a = atlas.getDashPosition({ 1, 2 }, LinePatternCap::Round);
+    EXPECT_FLOAT_EQ(7.5f / 16, a.y);
+    atlas.getDashPosition({ 2, 2 }, LinePatternCap::Round);
+    EXPECT_EQ((Size { 128, 32 }), atlas.getSize());
+
+    // Patterns keep their rows when the atlas grows.
+    EXPECT_FLOAT_EQ(7.5f / 32, atlas.getDashPosition({ 1, 2 }, LinePatternCap::Round).y);
+    EXPECT_EQ(2u, atlas.getDashCount());
+}
+
+TEST(LineAtlas, Evict) {
+    LineAtlas atlas({ 128, 2 }, 2);
+
+    const float a = atlas.getDashPosition({ 1, 2 }, LinePatternCap::Square).y;
+    const float b = atlas.getDashPosition({ 2, 2 }, LinePatternCap::Square).y;
+    EXPECT_NE(a, b);
+
+    // The atlas is full and can't grow, so the least recently used pattern makes room.
+    atlas.getDashPosition({ 1, 2 }, LinePatternCap::Square);
+    EXPECT_EQ(b, atlas.getDashPosition({ 3, 2 }, LinePatternCap::Square).y);
+    EXPECT_EQ(a, atlas.getDashPosition({ 1, 2 }, LinePatternCap::Square).y);
+    EXPECT_EQ(2u, atlas.getDashCount());
+    EXPECT_EQ((Size { 128, 2 }), atlas.getSize());
+
+    // Patterns taller than the atlas don't fit at all.
+    EXPECT_EQ(0, atlas.getDashPosition({ 1, 2 }, LinePatternCap::Round).height);
+}
@@ -0,0 +1,93 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/geometry/shelf_pack.hpp>
+
+#include <iosfwd>
+#include <array>
+
+namespace mbgl {
+template <typename T> ::std::ostream& operator<<(::std::ostream& os, const Rect<T>& t) {
+    return os << "Rect { " << t.x << ", " << t.y << ", " << t.w << ", " << t.h << " }";
+}
+} // namespace mbgl
+
+using namespace mbgl;
+
+TEST(ShelfPack, Allocating) {
+    ShelfPack<uint16_t> bin(64, 64);
+    std::array<Rect<uint16_t>, 5> rects;
+
+    rects[0] = bin.allocate(32, 16);
+    ASSERT_EQ(Rect<uint16_t>(0, 0, 32, 16), rects[0]);
+
+    // Shorter rectangles share the shelf of taller ones.
+    rects[1] = bin.allocate(16, 12);
+    ASSERT_EQ(Rect<uint16_t>(32, 0, 16, 12), rects[1]);
+
+    // Much shorter rectangles start a shelf of their own.
+    rects[2] = bin.allocate(8, 8);
+    ASSERT_EQ(Rect<uint16_t>(0, 16, 8, 8), rects[2]);
+
+    // Rectangles that don't fit on a shelf anymore start a new one.
+    rects[3] = bin.allocate(32, 16);
+    ASSERT_EQ(Rect<uint16_t>(0, 24, 32, 16), rects[3]);
+
+    // Released rectangles are reused by rectangles of the same size.
+    bin.release(rects[1]);
+    rects[1] = bin.allocate(16, 12);
+    ASSERT_EQ(Rect<uint16_t>(32, 0, 16, 12), rects[1]);
+
+    rects[4] = bin.allocate(32, 32);
+    ASSERT_FALSE(rects[4].hasArea());
+}
+
+TEST(ShelfPack, ReleaseShelf) {
+    ShelfPack<uint16_t> bin(64, 64);
+
+    const Rect<uint16_t> a = bin.allocate(32, 16);
+    const Rect<uint16_t> b = bin.allocate(32, 16);
+    const Rect<uint16_t> c = bin.allocate(32, 32);
+    ASSERT_EQ(Rect<uint16_t>(0, 16, 32, 32), c);
+
+    // An empty shelf takes rectangles of any width again.
+    bin.release(a);
+    bin.release(b);
+    ASSERT_EQ(Rect<uint16_t>(0, 0, 64, 16), bin.allocate(64, 16));
+
+    // Empty shelves at the bottom return their height.
+    bin.release(c);
+    ASSERT_EQ(Rect<uint16_t>(0, 16, 64, 48), bin.allocate(64, 48));
+}
+
+TEST(ShelfPack, Full) {
+    ShelfPack<uint16_t> bin(128, 128);
+    std::vector<Rect<uint16_t>> rects;
+
+    for (int j = 0; j < 3; j++) {
+        for (int i = 0; i < 256; i++) {
+            auto rect = bin.allocate(8, 8);
+            ASSERT_TRUE(rect.hasArea());
+            rects.push_back(rect);
+        }
+
+        ASSERT_FALSE(bin.allocate(8, 8).hasArea());
+
+        for (auto& rect: rects) {
+            bin.release(rect);
+        }
+        rects.clear();
+    }
+}
+
+TEST(ShelfPack, Resize) {
+    ShelfPack<uint16_t> bin(32, 32);
+
+    ASSERT_EQ(Rect<uint16_t>(0, 0, 32, 32), bin.allocate(32, 32));
+    ASSERT_FALSE(bin.allocate(32, 32).hasArea());
+
+    bin.resize(64, 64);
+    EXPECT_EQ(64, bin.getWidth());
+    EXPECT_EQ(64, bin.getHeight());
+    ASSERT_EQ(Rect<uint16_t>(32, 0, 32, 32), bin.allocate(32, 32));
+    ASSERT_EQ(Rect<uint16_t>(0, 32, 64, 32), bin.allocate(64, 32));
+}
@@ -1,13 +1,23 @@
 #include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
 
 #include <mbgl/renderer/circle_bucket.hpp>
 #include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/renderer/fill_extrusion_bucket.hpp>
+#include <mbgl/renderer/heatmap_bucket.hpp>
 #include <mbgl/renderer/line_bucket.hpp>
 #include <mbgl/renderer/symbol_bucket.hpp>
 #include <mbgl/style/bucket_parameters.hpp>
+#include <mbgl/style/cascade_parameters.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/fill_layer_impl.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
+#include <mbgl/tile/geojson_tile_data.hpp>
 
 #include <mbgl/map/mode.hpp>
+#include <mbgl/map/backend_scope.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/gl/context.hpp>
 
 using namespace mbgl;
 
@@ -16,11 +26,210 @@ TEST(Buckets, CircleBucket) {
     ASSERT_FALSE(bucket.hasData());
 }
 
+TEST(Buckets, CircleBucketUpload) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    gl::Context& context = backend.getContext();
+
+    CircleBucket bucket { { {0, 0, 0}, MapMode::Still }, {} };
+    StubGeometryTileFeature feature { {} };
+    bucket.addFeature(feature, { { { 0, 0 }, { 10, 10 } } }, 0);
+    ASSERT_TRUE(bucket.hasData());
+
+    // Circles are laid out with a vertex each, and repeated at the corners of their quads only
+    // where they can't be drawn as instances.
+    EXPECT_EQ(2u, bucket.vertices.vertexSize());
+    bucket.upload(context);
+    EXPECT_EQ(context.supportsInstancing(), bucket.instanced);
+    EXPECT_EQ(bucket.instanced ? 2u : 8u, bucket.vertexBuffer->vertexCount);
+    EXPECT_EQ(!bucket.instanced, bool(bucket.indexBuffer));
+    EXPECT_EQ(1u, bucket.segments.size());
+}
+
 TEST(Buckets, FillBucket) {
     FillBucket bucket { { {0, 0, 0}, MapMode::Still }, {} };
     ASSERT_FALSE(bucket.hasData());
 }
 
+TEST(Buckets, FillBucketReleaseData) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+
+    FillBucket bucket { { {0, 0, 0}, MapMode::Still }, {} };
+    StubGeometryTileFeature feature { {} };
+    bucket.addFeature(feature, { { { 0, 0 }, { 0, 10 }, { 10, 10 }, { 10, 0 }, { 0, 0 } } }, 0);
+    bucket.shrinkToFit();
+    ASSERT_TRUE(bucket.hasData());
+
+    const std::size_t byteSize = bucket.getByteSize();
+    EXPECT_LT(0u, byteSize);
+    EXPECT_EQ(0u, bucket.getBufferByteSize());
+
+    bucket.upload(backend.getContext());
+    EXPECT_EQ(2 * byteSize, bucket.getByteSize());
+
+    bucket.releaseData();
+    EXPECT_TRUE(bucket.hasData());
+    EXPECT_EQ(byteSize, bucket.getByteSize());
+    EXPECT_EQ(byteSize, bucket.getBufferByteSize());
+}
+
+TEST(Buckets, FillBucketReleaseBuffers) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    gl::Context& context = backend.getContext();
+
+    FillBucket bucket { { {0, 0, 0}, MapMode::Still }, {} };
+    StubGeometryTileFeature feature { {} };
+    bucket.addFeature(feature, { { { 0, 0 }, { 0, 10 }, { 10, 10 }, { 10, 0 }, { 0, 0 } } }, 0);
+    ASSERT_TRUE(bucket.hasData());
+
+    const std::size_t usage = context.getMemoryUsage();
+    context.setMemoryBudget(usage + 1);
+    bucket.upload(context);
+    EXPECT_EQ(usage + bucket.getBufferByteSize(), context.getMemoryUsage());
+    EXPECT_TRUE(context.isOverBudget());
+
+    // The buffers are freed, and uploaded again from the data that the bucket kept.
+    EXPECT_TRUE(bucket.releaseBuffers());
+    EXPECT_TRUE(bucket.needsUpload());
+    EXPECT_FALSE(bucket.vertexBuffer);
+    EXPECT_EQ(usage, context.getMemoryUsage());
+    EXPECT_FALSE(context.isOverBudget());
+
+    bucket.upload(context);
+    EXPECT_FALSE(bucket.needsUpload());
+    EXPECT_EQ(1u, bucket.triangleSegments.size());
+
+    // Without its data, the bucket couldn't be uploaded again.
+    bucket.releaseData();
+    EXPECT_FALSE(bucket.releaseBuffers());
+    EXPECT_TRUE(bool(bucket.vertexBuffer));
+    EXPECT_FALSE(bucket.needsUpload());
+}
+
+TEST(Buckets, FillBucketMultisampling) {
+    // Fills that multisampling antialiases are laid out without outlines.
+    FillBucket bucket { { {0, 0, 0}, MapMode::Still, false, true }, {} };
+    StubGeometryTileFeature feature { {} };
+    bucket.addFeature(feature, { { { 0, 0 }, { 0, 10 }, { 10, 10 }, { 10, 0 }, { 0, 0 } } }, 0);
+    ASSERT_TRUE(bucket.hasData());
+
+    EXPECT_FALSE(bucket.outlines);
+    EXPECT_EQ(5u, bucket.vertices.vertexSize());
+    EXPECT_EQ(0u, bucket.lines.indexSize());
+    EXPECT_TRUE(bucket.lineSegments.empty());
+    EXPECT_EQ(1u, bucket.triangleSegments.size());
+}
+
+TEST(Buckets, FillBucketSplitSegments) {
+    FillBucket bucket { { {0, 0, 0}, MapMode::Still }, {} };
+    StubGeometryTileFeature feature { {} };
+    for (std::size_t i = 0; i < 1000; i++) {
+        bucket.addFeature(feature, { { { 0, 0 }, { 0, 10 }, { 10, 10 }, { 10, 0 }, { 0, 0 } } }, i);
+    }
+    for (std::size_t i = 0; i < 1000; i++) {
+        bucket.addFeature(feature, { { { 8000, 8000 }, { 8000, 8010 }, { 8010, 8010 }, { 8010, 8000 }, { 8000, 8000 } } }, i);
+    }
+    ASSERT_EQ(1u, bucket.triangleSegments.size());
+
+    // The features on either side of the tile end up in segments of their own, in order.
+    bucket.splitSegments();
+    ASSERT_EQ(2u, bucket.triangleSegments.size());
+    ASSERT_TRUE(bucket.triangleSegments[0].bounds);
+    EXPECT_EQ(Point<int16_t>(0, 0), bucket.triangleSegments[0].bounds->min);
+    EXPECT_EQ(Point<int16_t>(10, 10), bucket.triangleSegments[0].bounds->max);
+    ASSERT_TRUE(bucket.triangleSegments[1].bounds);
+    EXPECT_EQ(Point<int16_t>(8000, 8000), bucket.triangleSegments[1].bounds->min);
+    EXPECT_EQ(Point<int16_t>(8010, 8010), bucket.triangleSegments[1].bounds->max);
+    EXPECT_EQ(bucket.triangles.indexSize(),
+              bucket.triangleSegments[0].indexLength + bucket.triangleSegments[1].indexLength);
+    EXPECT_EQ(bucket.triangleSegments[0].indexLength, bucket.triangleSegments[1].indexOffset);
+
+    ASSERT_EQ(2u, bucket.lineSegments.size());
+    EXPECT_EQ(Point<int16_t>(10, 10), bucket.lineSegments[0].bounds->max);
+    EXPECT_EQ(Point<int16_t>(8000, 8000), bucket.lineSegments[1].bounds->min);
+}
+
+TEST(Buckets, FillBucketRepaint) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+
+    using namespace style;
+    const CascadeParameters cascade { { ClassID::Default }, Clock::now(), TransitionOptions {} };
+    FillLayer layer { "fill", "source" };
+    layer.setFillOpacity(SourceFunction<float> { "a", IdentityStops<float>() });
+    layer.baseImpl->cascadeProperties(cascade);
+    layer.baseImpl->evaluateProperties(PropertyEvaluationParameters(0));
+
+    const mapbox::geometry::polygon<int16_t> square { { { 0, 0 }, { 0, 10 }, { 10, 10 }, { 10, 0 }, { 0, 0 } } };
+    mapbox::geometry::feature_collection<int16_t> features;
+    features.push_back({ square, { { "a", 0.5 }, { "b", 1.0 } } });
+    features.push_back({ square, { { "a", 0.5 }, { "b", 0.25 } } });
+    const GeoJSONTileData data { features };
+
+    const BucketParameters parameters { {0, 0, 0}, MapMode::Still };
+    FillBucket bucket { parameters, { &layer } };
+    GeometryCollection geometries;
+    for (std::size_t i = 0; i < data.featureCount(); i++) {
+        auto feature = data.getFeature(i);
+        feature->readGeometries(geometries);
+        bucket.addFeature(*feature, geometries, i);
+    }
+    bucket.upload(backend.getContext());
+    bucket.releaseData();
+    const std::size_t bufferByteSize = bucket.getBufferByteSize();
+    EXPECT_FALSE(bucket.needsUpload());
+
+    // Only the paint property binders are uploaded again.
+    layer.setFillOpacity(SourceFunction<float> { "b", IdentityStops<float>() });
+    layer.baseImpl->cascadeProperties(cascade);
+    layer.baseImpl->evaluateProperties(PropertyEvaluationParameters(0));
+    auto repaint = bucket.repaint(parameters, { &layer }, data, nullptr);
+    ASSERT_TRUE(bool(repaint));
+    EXPECT_FALSE(bucket.needsUpload());
+
+    repaint();
+    EXPECT_TRUE(bucket.needsUpload());
+    bucket.upload(backend.getContext());
+    bucket.releaseData();
+    EXPECT_FALSE(bucket.needsUpload());
+    EXPECT_TRUE(bucket.hasData());
+    EXPECT_EQ(bufferByteSize, bucket.getBufferByteSize());
+}
+
+TEST(Buckets, FillExtrusionBucket) {
+    FillExtrusionBucket bucket { { {0, 0, 0}, MapMode::Still }, {} };
+    ASSERT_FALSE(bucket.hasData());
+
+    // The roof shares the vertices of the ring, and each of the four walls has its own quad.
+    StubGeometryTileFeature feature { {} };
+    bucket.addFeature(feature, { { { 0, 0 }, { 0, 10 }, { 10, 10 }, { 10, 0 } } }, 0);
+    ASSERT_TRUE(bucket.hasData());
+    EXPECT_EQ(4u + 4 * 4, bucket.vertices.vertexSize());
+    EXPECT_EQ(2u * 3 + 4 * 6, bucket.triangles.indexSize());
+
+    // The wall along the tile's buffer is dropped.
+    bucket.addFeature(feature, { { { -64, 0 }, { -64, 10 }, { 10, 10 }, { 10, 0 } } }, 1);
+    EXPECT_EQ(20u + 4 + 3 * 4, bucket.vertices.vertexSize());
+    EXPECT_EQ(1u, bucket.triangleSegments.size());
+    EXPECT_EQ(bucket.vertices.vertexSize(), bucket.triangleSegments.back().vertexLength);
+}
+
+TEST(Buckets, HeatmapBucket) {
+    HeatmapBucket bucket { { {0, 0, 0}, MapMode::Continuous }, {} };
+    ASSERT_FALSE(bucket.hasData());
+
+    // Each point is a quad that its kernel is drawn in. Points in the tile's buffer belong to
+    // the neighbouring tiles, which would otherwise add them to the density a second time.
+    StubGeometryTileFeature feature { {} };
+    bucket.addFeature(feature, { { { 0, 0 }, { 10, 10 }, { -10, 10 }, { 10, 8192 } } }, 0);
+    ASSERT_TRUE(bucket.hasData());
+    EXPECT_EQ(2u * 4, bucket.vertices.vertexSize());
+    EXPECT_EQ(2u * 6, bucket.triangles.indexSize());
+    EXPECT_EQ(1u, bucket.segments.size());
+}
+
 TEST(Buckets, LineBucket) {
     LineBucket bucket { { {0, 0, 0}, MapMode::Still }, {}, {} };
     ASSERT_FALSE(bucket.hasData());
@@ -36,3 +245,52 @@ TEST(Buckets, SymbolBucket) {
     ASSERT_FALSE(bucket.hasTextData());
     ASSERT_FALSE(bucket.hasCollisionBoxData());
 }
+
+TEST(Buckets, SymbolBucketUpload) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    gl::Context& context = backend.getContext();
+
+    style::SymbolLayoutProperties::PossiblyEvaluated layout;
+    SymbolBucket bucket { layout, {}, 16.0f, 1.0f, 0, false, false };
+    StubGeometryTileFeature feature { {} };
+    for (int16_t i = 0; i < 3; i++) {
+        bucket.text.vertices.emplace_back(SymbolInstanceAttributes::instance(
+            { 10.0f * i, 10 }, { -4, -4 }, { 4, -4 }, { -4, 4 }, { 0, 0, 8, 8 }, 18, 0));
+        bucket.textSizeBinder->populateVertexVector(feature);
+    }
+    ASSERT_TRUE(bucket.hasTextData());
+    ASSERT_FALSE(bucket.hasIconData());
+
+    // Quads are laid out with a vertex each, and expanded into their corners only where they
+    // can't be drawn as instances.
+    bucket.upload(context);
+    EXPECT_EQ(context.supportsInstancing(), bucket.instanced);
+    EXPECT_EQ(bucket.instanced, bool(bucket.text.instanceBuffer));
+    EXPECT_EQ(!bucket.instanced, bool(bucket.text.vertexBuffer));
+    EXPECT_EQ(!bucket.instanced, bool(bucket.text.indexBuffer));
+    if (!bucket.instanced) {
+        EXPECT_EQ(12u, bucket.text.vertexBuffer->vertexCount);
+    }
+    EXPECT_EQ(1u, bucket.text.segments.size());
+}
+
+TEST(Buckets, SymbolBucketSortSymbols) {
+    style::SymbolLayoutProperties::PossiblyEvaluated layout;
+    SymbolBucket bucket { layout, {}, 16.0f, 1.0f, 0, false, false };
+
+    // Added from top to bottom, as at an angle of 0.
+    for (uint32_t i = 0; i < 100; i++) {
+        bucket.sortedSymbols.push_back({ { float(i % 10) * 10, float(i) * 10 }, i, i, 0, 1, 0 });
+    }
+    EXPECT_FALSE(bucket.sortSymbols(0));
+
+    // Rotating slightly moves a few symbols, and sorting again at the same angle keeps them.
+    EXPECT_TRUE(bucket.sortSymbols(0.2));
+    EXPECT_FALSE(bucket.sortSymbols(0.2));
+
+    // Turning the map around reverses the order.
+    EXPECT_TRUE(bucket.sortSymbols(M_PI));
+    EXPECT_FALSE(bucket.sortSymbols(M_PI));
+    EXPECT_TRUE(bucket.sortSymbols(0));
+}
@@ -0,0 +1,39 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gl/context.hpp>
+
+#include <memory>
+
+using namespace mbgl;
+
+TEST(GLContext, SharedResource) {
+    gl::Context context;
+
+    int created = 0;
+    auto create = [&] {
+        created++;
+        return std::make_shared<int>(created);
+    };
+
+    // Users of the same key share one resource for as long as one of them holds it.
+    auto a = context.getSharedResource<int>("a", create);
+    auto b = context.getSharedResource<int>("a", create);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(1, created);
+
+    auto c = context.getSharedResource<int>("c", create);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(2, created);
+
+    a.reset();
+    EXPECT_EQ(b, context.getSharedResource<int>("a", create));
+    EXPECT_EQ(2, created);
+
+    // The context doesn't keep resources that nobody uses.
+    b.reset();
+    std::weak_ptr<int> released = c;
+    c.reset();
+    EXPECT_TRUE(released.expired());
+
+    EXPECT_EQ(3, *context.getSharedResource<int>("a", create));
+}
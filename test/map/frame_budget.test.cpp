@@ -0,0 +1,54 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/map/frame_budget.hpp>
+
+using namespace mbgl;
+
+TEST(FrameBudget, Disabled) {
+    FrameBudget budget;
+    for (uint32_t i = 0; i < 100; i++) {
+        EXPECT_FALSE(budget.record(Milliseconds(100)));
+    }
+    EXPECT_EQ(RenderQuality::Full, budget.getQuality());
+}
+
+TEST(FrameBudget, Degrade) {
+    FrameBudget budget;
+    budget.setTarget(Milliseconds(16));
+
+    // Frames within the budget, and a single slow one, keep the quality.
+    for (uint32_t i = 0; i < 2 * FrameBudget::settleFrames; i++) {
+        EXPECT_FALSE(budget.record(i == 15 ? Milliseconds(40) : Milliseconds(10)));
+    }
+    EXPECT_EQ(RenderQuality::Full, budget.getQuality());
+
+    // Each level is held for a number of frames before the next one.
+    uint32_t changes = 0;
+    uint32_t lastChange = 0;
+    for (uint32_t i = 0; i < 10 * FrameBudget::settleFrames; i++) {
+        if (budget.record(Milliseconds(30))) {
+            if (changes++) {
+                EXPECT_EQ(FrameBudget::settleFrames, i - lastChange);
+            }
+            lastChange = i;
+        }
+    }
+    EXPECT_EQ(4u, changes);
+    EXPECT_EQ(RenderQuality::Lowest, budget.getQuality());
+
+    EXPECT_TRUE(budget.restore());
+    EXPECT_FALSE(budget.restore());
+    EXPECT_EQ(RenderQuality::Full, budget.getQuality());
+}
+
+TEST(FrameBudget, Reset) {
+    FrameBudget budget;
+    budget.setTarget(Milliseconds(16));
+    for (uint32_t i = 0; i < FrameBudget::settleFrames; i++) {
+        budget.record(Milliseconds(30));
+    }
+    EXPECT_EQ(RenderQuality::NoCollisionDebug, budget.getQuality());
+
+    budget.setTarget(Duration::zero());
+    EXPECT_EQ(RenderQuality::Full, budget.getQuality());
+}
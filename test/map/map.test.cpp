@@ -3,7 +3,9 @@
 #include <mbgl/test/fake_file_source.hpp>
 #include <mbgl/test/fixture_log_observer.hpp>
 
+#include <mbgl/annotation/annotation.hpp>
 #include <mbgl/map/map.hpp>
+#include <mbgl/map/map_snapshotter.hpp>
 #include <mbgl/map/backend_scope.hpp>
 #include <mbgl/gl/headless_backend.hpp>
 #include <mbgl/gl/offscreen_view.hpp>
@@ -20,6 +22,10 @@
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/util/color.hpp>
 
+#include <mapbox/pixelmatch.hpp>
+
+#include <algorithm>
+
 using namespace mbgl;
 using namespace mbgl::style;
 using namespace std::literals::string_literals;
@@ -108,7 +114,7 @@ TEST(Map, Offline) {
 
     auto expiredItem = [] (const std::string& path) {
         Response response;
-        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/map/offline/"s + path));
+        response.data = std::make_shared<Buffer>(util::read_file("test/fixtures/map/offline/"s + path));
         response.expires = Timestamp{ Seconds(0) };
         return response;
     };
@@ -199,7 +205,7 @@ TEST(Map, StyleFresh) {
     EXPECT_EQ(1u, fileSource.requests.size());
 
     Response response;
-    response.data = std::make_shared<std::string>(util::read_file("test/fixtures/api/empty.json"));
+    response.data = std::make_shared<Buffer>(util::read_file("test/fixtures/api/empty.json"));
     response.expires = Timestamp::max();
 
     fileSource.respond(Resource::Style, response);
@@ -219,7 +225,7 @@ TEST(Map, StyleExpired) {
     EXPECT_EQ(1u, fileSource.requests.size());
 
     Response response;
-    response.data = std::make_shared<std::string>(util::read_file("test/fixtures/api/empty.json"));
+    response.data = std::make_shared<Buffer>(util::read_file("test/fixtures/api/empty.json"));
     response.expires = util::now() - 1h;
 
     fileSource.respond(Resource::Style, response);
@@ -246,7 +252,7 @@ TEST(Map, StyleExpiredWithAnnotations) {
     EXPECT_EQ(1u, fileSource.requests.size());
 
     Response response;
-    response.data = std::make_shared<std::string>(util::read_file("test/fixtures/api/empty.json"));
+    response.data = std::make_shared<Buffer>(util::read_file("test/fixtures/api/empty.json"));
     response.expires = util::now() - 1h;
 
     fileSource.respond(Resource::Style, response);
@@ -270,7 +276,7 @@ TEST(Map, StyleEarlyMutation) {
     map.addLayer(std::make_unique<style::BackgroundLayer>("bg"));
 
     Response response;
-    response.data = std::make_shared<std::string>(util::read_file("test/fixtures/api/water.json"));
+    response.data = std::make_shared<Buffer>(util::read_file("test/fixtures/api/water.json"));
     fileSource.respond(Resource::Style, response);
 
     EXPECT_EQ(0u, fileSource.requests.size());
@@ -351,6 +357,29 @@ TEST(Map, AddLayer) {
     test::checkImage("test/fixtures/map/add_layer", test::render(map, test.view));
 }
 
+TEST(Map, Snapshotter) {
+    MapTest test;
+
+    Map map(test.backend, test.view.getSize(), 1, test.fileSource, test.threadPool, MapMode::Still);
+    map.setStyleJSON(util::read_file("test/fixtures/api/empty.json"));
+
+    auto layer = std::make_unique<BackgroundLayer>("background");
+    layer->setBackgroundColor({ { 1, 0, 0, 1 } });
+    map.addLayer(std::move(layer));
+
+    MapSnapshotter snapshotter(test.fileSource, map.getStyleSnapshot(), test.view.getSize(), 1);
+
+    PremultipliedImage result;
+    auto request = snapshotter.snapshot(CameraOptions(), [&] (std::exception_ptr error, PremultipliedImage image) {
+        EXPECT_FALSE(error);
+        result = std::move(image);
+        test.runLoop.stop();
+    });
+    test.runLoop.run();
+
+    test::checkImage("test/fixtures/map/add_layer", result);
+}
+
 TEST(Map, WithoutVAOExtension) {
     MapTest test;
 
@@ -369,6 +398,34 @@ TEST(Map, WithoutVAOExtension) {
     test::checkImage("test/fixtures/map/no_vao", test::render(map, test.view), 0.002);
 }
 
+TEST(Map, MemoryUsage) {
+    MapTest test;
+
+#ifdef MBGL_ASSET_ZIP
+    // Regenerate with `cd test/fixtures/api/ && zip -r assets.zip assets/`
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets.zip");
+#else
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets");
+#endif
+
+    Map map(test.backend, test.view.getSize(), 1, fileSource, test.threadPool, MapMode::Still);
+    EXPECT_TRUE(map.getMemoryUsage().sources.empty());
+
+    map.setStyleJSON(util::read_file("test/fixtures/api/water.json"));
+    test::render(map, test.view);
+
+    const MemoryUsage usage = map.getMemoryUsage();
+    ASSERT_EQ(1u, usage.sources.size());
+    const MemoryUsage::Tiles& tiles = usage.sources.at("mapbox").tiles;
+    EXPECT_LT(0u, tiles.tileData);
+    EXPECT_LT(0u, tiles.bufferData);
+    EXPECT_LT(0u, tiles.featureIndex);
+    EXPECT_EQ(tiles.tileData + tiles.vertexData + tiles.bufferData + tiles.featureIndex +
+                  tiles.collisionTile,
+              tiles.total());
+    EXPECT_LT(0u, usage.lineAtlas);
+}
+
 TEST(Map, RemoveLayer) {
     MapTest test;
 
@@ -390,7 +447,7 @@ TEST(Map, DisabledSources) {
     test.fileSource.response = [] (const Resource& res) -> optional<Response> {
         if (res.url == "asset://tile.png") {
             Response response;
-            response.data = std::make_shared<std::string>(
+            response.data = std::make_shared<Buffer>(
                 util::read_file("test/fixtures/map/disabled_layers/tile.png"));
             return {std::move(response)};
         }
@@ -517,7 +574,7 @@ TEST(Map, GetImage) {
 
     map.setStyleJSON(util::read_file("test/fixtures/api/icon_style.json"));
     map.addImage("test-icon", std::move(image));
-    test::checkImage("test/fixtures/map/get_icon", map.getImage("test-icon")->image);
+    test::checkImage("test/fixtures/map/get_icon", map.getImage("test-icon")->getImage());
 }
 
 TEST(Map, DontLoadUnneededTiles) {
@@ -568,6 +625,59 @@ TEST(Map, DontLoadUnneededTiles) {
     }
 }
 
+TEST(Map, RenderStills) {
+    MapTest test;
+
+    Map map(test.backend, test.view.getSize(), 1, test.fileSource, test.threadPool, MapMode::Still);
+    map.setStyleJSON(R"STYLE({
+  "sources": {
+    "a": { "type": "vector", "tiles": [ "a/{z}/{x}/{y}" ] }
+  },
+  "layers": [{
+    "id": "a",
+    "type": "fill",
+    "source": "a",
+    "source-layer": "a"
+  }]
+})STYLE");
+
+    using Tiles = std::unordered_set<std::string>;
+    Tiles tiles;
+
+    test.fileSource.tileResponse = [&](const Resource& rsc) {
+        tiles.emplace(rsc.url);
+        Response res;
+        res.noContent = true;
+        return res;
+    };
+
+    CameraOptions first;
+    first.zoom = 0.0;
+    CameraOptions second;
+    second.zoom = 1.0;
+
+    std::vector<std::size_t> rendered;
+    map.renderStills(test.view, { first, second }, [&](std::exception_ptr error, std::size_t index) {
+        ASSERT_FALSE(error);
+        if (rendered.empty()) {
+            // The tiles of both cameras are loaded before the first is rendered.
+            EXPECT_EQ(Tiles({ "a/0/0/0", "a/1/1/0", "a/1/0/1", "a/1/0/0", "a/1/1/1" }), tiles);
+        }
+        EXPECT_EQ(map.getZoom(), index == 0 ? 0.0 : 1.0);
+        rendered.push_back(index);
+    });
+
+    while (rendered.size() < 2) {
+        util::RunLoop::Get()->runOnce();
+    }
+
+    EXPECT_EQ(std::vector<std::size_t>({ 0, 1 }), rendered);
+    EXPECT_EQ(1.0, map.getZoom());
+
+    map.renderStills(test.view, {}, [&](std::exception_ptr error, std::size_t) {
+        EXPECT_TRUE(error);
+    });
+}
 
 class MockBackend : public HeadlessBackend {
 public:
@@ -631,3 +741,185 @@ TEST(Map, TEST_DISABLED_ON_CI(ContinuousRendering)) {
     map.setStyleJSON(util::read_file("test/fixtures/api/water.json"));
     util::RunLoop::Get()->run();
 }
+
+TEST(Map, BackgroundTiles) {
+    // The tiles of a background without a pattern are drawn at once. Together they must cover the
+    // viewport exactly once, also where the world wraps.
+    MapTest test;
+
+    Map map(test.backend, test.view.getSize(), 1, test.fileSource, test.threadPool, MapMode::Still);
+    map.setStyleJSON(R"STYLE({
+  "version": 8,
+  "sources": {},
+  "layers": [{
+    "id": "bottom",
+    "type": "background",
+    "paint": { "background-color": "#ff0000" }
+  }, {
+    "id": "top",
+    "type": "background",
+    "paint": { "background-color": "#0000ff", "background-opacity": 0.5 }
+  }]
+})STYLE");
+    map.setLatLngZoom({ 10, 179 }, 2.5);
+    map.setBearing(30);
+
+    // The bottommost background is drawn with glClear, and the other one over it.
+    const PremultipliedImage image = test::render(map, test.view);
+    EXPECT_EQ(1u, map.getFrameStats().draws);
+    for (std::size_t i = 0; i < image.bytes(); i += 4) {
+        ASSERT_NEAR(128, image.data[i], 1) << "pixel " << i / 4;
+        ASSERT_EQ(0, image.data[i + 1]) << "pixel " << i / 4;
+        ASSERT_NEAR(128, image.data[i + 2], 1) << "pixel " << i / 4;
+        ASSERT_EQ(255, image.data[i + 3]) << "pixel " << i / 4;
+    }
+}
+
+TEST(Map, RenderAtPresentationTime) {
+    // Transitions are sampled at the time the frame is presented rather than drawn.
+    util::RunLoop runLoop;
+    MockBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    OffscreenView view { backend.getContext() };
+    StubFileSource fileSource;
+    ThreadPool threadPool { 4 };
+
+    Map map(backend, view.getSize(), 1, fileSource, threadPool, MapMode::Continuous);
+    map.setStyleJSON(util::read_file("test/fixtures/api/empty.json"));
+
+    map.setZoom(2, AnimationOptions(Seconds(10)));
+    map.render(view);
+    EXPECT_GT(2.0, map.getZoom());
+    EXPECT_TRUE(map.isScaling());
+
+    map.render(view, Clock::now() + Seconds(20));
+    EXPECT_DOUBLE_EQ(2.0, map.getZoom());
+    EXPECT_FALSE(map.isScaling());
+}
+
+TEST(Map, PartialRedraw) {
+    // Offscreen views keep their contents, so moving an annotation only draws the places that
+    // it left and went to, which must look the same as drawing everything again.
+    MapTest test;
+
+    Map map(test.backend, test.view.getSize(), 1, test.fileSource, test.threadPool, MapMode::Continuous);
+    map.setStyleJSON(R"STYLE({
+  "version": 8,
+  "sources": {},
+  "layers": [{
+    "id": "background",
+    "type": "background",
+    "paint": { "background-color": "#4080c0" }
+  }]
+})STYLE");
+    map.addAnnotationIcon("default_marker", std::make_shared<SpriteImage>(
+        decodeImage(util::read_file("test/fixtures/sprites/default_marker.png")), 1.0));
+    map.setInstancedPointAnnotations(true);
+    const AnnotationID id = map.addAnnotation(SymbolAnnotation { Point<double>(0, 0), "default_marker" });
+    map.addAnnotation(SymbolAnnotation { Point<double>(30, 30), "default_marker" });
+
+    while (!map.isFullyLoaded()) {
+        map.render(test.view);
+        util::RunLoop::Get()->runOnce();
+    }
+    map.render(test.view);
+
+    map.render(test.view);
+    EXPECT_EQ(0, map.getFrameStats().redrawnArea);
+
+    map.updateAnnotation(id, SymbolAnnotation { Point<double>(10, -10), "default_marker" });
+    map.render(test.view);
+    EXPECT_LT(0, map.getFrameStats().redrawnArea);
+    EXPECT_GT(1, map.getFrameStats().redrawnArea);
+    const PremultipliedImage partial = test.view.readStillImage();
+
+    map.triggerRepaint();
+    map.render(test.view);
+    EXPECT_EQ(1, map.getFrameStats().redrawnArea);
+    const PremultipliedImage full = test.view.readStillImage();
+
+    ASSERT_EQ(full.size, partial.size);
+    EXPECT_TRUE(std::equal(full.data.get(), full.data.get() + full.bytes(), partial.data.get()));
+}
+
+TEST(Map, LayerCaching) {
+    // A run of four layers is composited from its cached texture, which must look the same as
+    // drawing the layers into the view.
+    MapTest test;
+
+    Map map(test.backend, test.view.getSize(), 1, test.fileSource, test.threadPool, MapMode::Continuous);
+    map.setStyleJSON(R"STYLE({
+  "version": 8,
+  "sources": {
+    "shapes": {
+      "type": "geojson",
+      "data": {
+        "type": "FeatureCollection",
+        "features": [{
+          "type": "Feature",
+          "properties": {},
+          "geometry": {
+            "type": "Polygon",
+            "coordinates": [[[-60, -40], [60, -40], [60, 40], [-60, 40], [-60, -40]]]
+          }
+        }, {
+          "type": "Feature",
+          "properties": {},
+          "geometry": { "type": "Point", "coordinates": [20, 10] }
+        }]
+      }
+    }
+  },
+  "layers": [{
+    "id": "background",
+    "type": "background",
+    "paint": { "background-color": "#ffffff" }
+  }, {
+    "id": "fill",
+    "type": "fill",
+    "source": "shapes",
+    "paint": { "fill-color": "#ff0000", "fill-opacity": 0.5 }
+  }, {
+    "id": "outline",
+    "type": "line",
+    "source": "shapes",
+    "paint": { "line-color": "#0000ff", "line-width": 4 }
+  }, {
+    "id": "circle",
+    "type": "circle",
+    "source": "shapes",
+    "paint": { "circle-color": "#00ff00", "circle-radius": 10 }
+  }, {
+    "id": "inline",
+    "type": "line",
+    "source": "shapes",
+    "paint": { "line-color": "#000000", "line-width": 1 }
+  }]
+})STYLE");
+
+    while (!map.isFullyLoaded()) {
+        map.render(test.view);
+        util::RunLoop::Get()->runOnce();
+    }
+
+    map.setLayerCaching(true);
+    EXPECT_TRUE(map.getLayerCaching());
+    map.render(test.view);
+    EXPECT_EQ(1u, map.getFrameStats().layerGroups);
+    EXPECT_EQ(1u, map.getFrameStats().layerGroupsDrawn);
+    const PremultipliedImage cached = test.view.readStillImage();
+
+    map.setLayerCaching(false);
+    EXPECT_FALSE(map.getLayerCaching());
+    map.render(test.view);
+    EXPECT_EQ(0u, map.getFrameStats().layerGroups);
+    EXPECT_EQ(1, map.getFrameStats().redrawnArea);
+    const PremultipliedImage direct = test.view.readStillImage();
+
+    ASSERT_EQ(direct.size, cached.size);
+    PremultipliedImage diff { direct.size };
+    const double pixels = mapbox::pixelmatch(cached.data.get(), direct.data.get(),
+                                             direct.size.width, direct.size.height,
+                                             diff.data.get(), 0.1);
+    EXPECT_LE(pixels / (direct.size.width * direct.size.height), 0.0002);
+}
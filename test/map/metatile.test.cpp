@@ -0,0 +1,59 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/map/metatile.hpp>
+
+using namespace mbgl;
+
+TEST(Metatile, Camera) {
+    // The block of the four tiles at z2 around the center of the world.
+    Metatile metatile(2, 1, 1, 2);
+    EXPECT_EQ(Size(1024, 1024), metatile.getSize());
+
+    const CameraOptions camera = metatile.getCamera();
+    ASSERT_TRUE(camera.center);
+    EXPECT_NEAR(0.0, camera.center->latitude(), 1e-9);
+    EXPECT_NEAR(0.0, camera.center->longitude(), 1e-9);
+    EXPECT_DOUBLE_EQ(2.0, *camera.zoom);
+    EXPECT_DOUBLE_EQ(0.0, *camera.angle);
+
+    // 256 pixel tiles cover the world at one zoom level lower.
+    EXPECT_DOUBLE_EQ(1.0, *Metatile(2, 1, 1, 2, 256).getCamera().zoom);
+}
+
+TEST(Metatile, EdgeOfWorld) {
+    Metatile metatile(1, 1, 0, 4, 256, 16);
+    EXPECT_EQ(1u, metatile.getColumns());
+    EXPECT_EQ(2u, metatile.getRows());
+    EXPECT_EQ(Size(288, 544), metatile.getSize());
+    EXPECT_NEAR(90.0, metatile.getCamera().center->longitude(), 1e-9);
+
+    EXPECT_THROW(Metatile(1, 2, 0, 4), std::invalid_argument);
+}
+
+TEST(Metatile, Slice) {
+    Metatile metatile(3, 0, 0, 2, 2, 1);
+    ASSERT_EQ(Size(6, 6), metatile.getSize());
+
+    // Rendered at a pixel ratio of 2, with each pixel holding its coordinates.
+    PremultipliedImage image({ 12, 12 });
+    for (uint32_t y = 0; y < 12; y++) {
+        for (uint32_t x = 0; x < 12; x++) {
+            uint8_t* pixel = image.data.get() + (y * 12 + x) * 4;
+            pixel[0] = x;
+            pixel[1] = y;
+            pixel[2] = 0;
+            pixel[3] = 255;
+        }
+    }
+
+    const auto tiles = metatile.slice(image);
+    ASSERT_EQ(4u, tiles.size());
+    for (std::size_t i = 0; i < tiles.size(); i++) {
+        ASSERT_EQ(Size(4, 4), tiles[i].size);
+        // The top left pixel of each tile, past the buffer.
+        EXPECT_EQ(2 + (i % 2) * 4, tiles[i].data[0]);
+        EXPECT_EQ(2 + (i / 2) * 4, tiles[i].data[1]);
+    }
+
+    EXPECT_THROW(metatile.slice(PremultipliedImage({ 12, 6 })), std::invalid_argument);
+}
@@ -0,0 +1,25 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/map/tile_snapshot.hpp>
+
+using namespace mbgl;
+
+TEST(TileSnapshot, ObtainValues) {
+    const TileSnapshot snapshot{ { { "mapbox://tiles/{z}/{x}/{y}.vector.pbf", Tileset::Scheme::XYZ,
+                                     { { 14, 2620, 6332 }, { 13, 1310, 3166 } } },
+                                   { "http://example.com/{z}/{x}/{y}.png", Tileset::Scheme::TMS, {} } } };
+
+    const TileSnapshot snapshot2(snapshot.serialize());
+
+    ASSERT_EQ(2u, snapshot2.sources().size());
+    EXPECT_EQ("mapbox://tiles/{z}/{x}/{y}.vector.pbf", snapshot2.sources()[0].urlTemplate);
+    EXPECT_EQ(Tileset::Scheme::XYZ, snapshot2.sources()[0].scheme);
+    EXPECT_EQ((std::vector<CanonicalTileID>{ { 14, 2620, 6332 }, { 13, 1310, 3166 } }),
+              snapshot2.sources()[0].tiles);
+    EXPECT_EQ("http://example.com/{z}/{x}/{y}.png", snapshot2.sources()[1].urlTemplate);
+    EXPECT_EQ(Tileset::Scheme::TMS, snapshot2.sources()[1].scheme);
+    EXPECT_TRUE(snapshot2.sources()[1].tiles.empty());
+
+    EXPECT_TRUE(TileSnapshot(std::string()).sources().empty());
+    EXPECT_THROW(TileSnapshot(std::string("\x0a\x02\x1a\x00", 4)), std::runtime_error);
+}
@@ -108,6 +108,39 @@ TEST(Transform, PerspectiveProjection) {
     ASSERT_NEAR(point.y, 0, 0.02);
 }
 
+TEST(Transform, BatchProjection) {
+    Transform transform;
+    transform.resize({ 1000, 1000 });
+    transform.setZoom(10);
+    transform.setPitch(0.9);
+    transform.setAngle(0.5);
+    transform.setLatLng(LatLng(38, -77));
+
+    const std::vector<LatLng> latLngs = {
+        { 38, -77 }, { 38.74661326302018, -77.59198961199148 }, { 37.692872969426375, -76.75823239205641 }
+    };
+    std::vector<ScreenCoordinate> points;
+    transform.latLngsToScreenCoordinates(latLngs, points);
+    ASSERT_EQ(latLngs.size(), points.size());
+    for (std::size_t i = 0; i < latLngs.size(); i++) {
+        const ScreenCoordinate point = transform.latLngToScreenCoordinate(latLngs[i]);
+        EXPECT_DOUBLE_EQ(point.x, points[i].x);
+        EXPECT_DOUBLE_EQ(point.y, points[i].y);
+    }
+
+    // Previous contents of the output are replaced.
+    std::vector<LatLng> unprojected(10);
+    transform.screenCoordinatesToLatLngs(points, unprojected);
+    ASSERT_EQ(points.size(), unprojected.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const LatLng latLng = transform.screenCoordinateToLatLng(points[i]);
+        EXPECT_DOUBLE_EQ(latLng.latitude(), unprojected[i].latitude());
+        EXPECT_DOUBLE_EQ(latLng.longitude(), unprojected[i].longitude());
+        EXPECT_NEAR(latLngs[i].latitude(), unprojected[i].latitude(), 0.0001);
+        EXPECT_NEAR(latLngs[i].longitude(), unprojected[i].longitude(), 0.0001);
+    }
+}
+
 TEST(Transform, UnwrappedLatLng) {
     Transform transform;
     transform.resize({ 1000, 1000 });
@@ -455,6 +488,32 @@ TEST(Transform, Camera) {
     ASSERT_FALSE(transform.inTransition());
 }
 
+TEST(Transform, TransitionPath) {
+    Transform transform;
+    transform.resize({ 1000, 1000 });
+    transform.jumpTo(CameraOptions());
+    EXPECT_TRUE(transform.getTransitionPath().empty());
+
+    const LatLng latLng { 45, 135 };
+    CameraOptions cameraOptions;
+    cameraOptions.zoom = 10;
+    cameraOptions.center = latLng;
+    const double startZoom = transform.getZoom();
+    transform.flyTo(cameraOptions, AnimationOptions(Seconds(1)));
+
+    // The path ends where the camera arrives, and computing it doesn't move the camera.
+    const auto& path = transform.getTransitionPath();
+    ASSERT_EQ(4u, path.size());
+    EXPECT_NEAR(10, path.back().getZoom(), 0.00001);
+    EXPECT_NEAR(latLng.latitude(), path.back().getLatLng().latitude(), 0.001);
+    EXPECT_NEAR(latLng.longitude(), path.back().getLatLng().longitude(), 0.001);
+    EXPECT_DOUBLE_EQ(startZoom, transform.getZoom());
+
+    transform.updateTransitions(transform.getTransitionStart() + transform.getTransitionDuration());
+    EXPECT_FALSE(transform.inTransition());
+    EXPECT_TRUE(transform.getTransitionPath().empty());
+}
+
 TEST(Transform, DefaultTransform) {
     struct TransformObserver : public mbgl::MapObserver {
         void onCameraWillChange(MapObserver::CameraChangeMode) final {
@@ -0,0 +1,27 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/programs/program_pack.hpp>
+
+using namespace mbgl;
+
+TEST(ProgramPack, ObtainValues) {
+    const ProgramPack pack{ "vendor\nrenderer\nversion",
+                            { { "com.mapbox.gl.shader.fill.pbf", 1, "fill binary" },
+                              { "com.mapbox.gl.shader.fill.overdraw.pbf", 2, "overdraw binary" } } };
+
+    const ProgramPack pack2(pack.serialize());
+
+    EXPECT_EQ("vendor\nrenderer\nversion", pack2.driverIdentifier());
+    ASSERT_EQ(2u, pack2.entries().size());
+    EXPECT_EQ("com.mapbox.gl.shader.fill.pbf", pack2.entries()[0].fileName);
+    EXPECT_EQ(1, pack2.entries()[0].pixelRatio);
+    EXPECT_EQ("fill binary", pack2.entries()[0].binaryProgram);
+    EXPECT_EQ("com.mapbox.gl.shader.fill.overdraw.pbf", pack2.entries()[1].fileName);
+    EXPECT_EQ(2, pack2.entries()[1].pixelRatio);
+    EXPECT_EQ("overdraw binary", pack2.entries()[1].binaryProgram);
+
+    EXPECT_THROW(ProgramPack(std::string()), std::runtime_error);
+
+    const ProgramPack escaping{ "driver", { { "../fill.pbf", 1, "fill binary" } } };
+    EXPECT_THROW(ProgramPack(escaping.serialize()), std::runtime_error);
+}
@@ -0,0 +1,64 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/programs/symbol_program.hpp>
+#include <mbgl/util/math.hpp>
+
+#include <cmath>
+
+using namespace mbgl;
+
+TEST(SymbolProgram, PlaceVertex) {
+    auto vertex = SymbolLayoutAttributes::vertex({ 10, 20 }, { 1, 2 }, 8, 16, 14, 18, 15, 64);
+    const auto original = vertex;
+
+    SymbolLayoutAttributes::place(vertex, SymbolQuadPlacement::fromZoom(0, 16.5));
+    EXPECT_EQ(original.a1, vertex.a1);
+    EXPECT_EQ(original.a2[0], vertex.a2[0]);
+    EXPECT_EQ(original.a2[1], vertex.a2[1]);
+
+    // The label angle and the maximum zoom level are kept.
+    EXPECT_EQ(attributes::packUint8Pair(165, 64), vertex.a2[2]);
+    EXPECT_EQ(attributes::packUint8Pair(0, 180), vertex.a2[3]);
+
+    // Placing the vertex as it was laid out restores it.
+    SymbolLayoutAttributes::place(vertex, SymbolQuadPlacement::fromZoom(14, 15));
+    EXPECT_EQ(original.a2, vertex.a2);
+
+    SymbolLayoutAttributes::place(vertex, SymbolQuadPlacement::hidden());
+    EXPECT_EQ(attributes::packUint8Pair(255, 64), vertex.a2[2]);
+    EXPECT_EQ(attributes::packUint8Pair(255, 180), vertex.a2[3]);
+}
+
+TEST(SymbolProgram, InstanceCorners) {
+    // The vertices an instance expands into are those of the corners of its quad.
+    auto expect = [] (Point<float> tl, Point<float> tr, Point<float> bl, Point<float> br) {
+        const Rect<uint16_t> tex { 8, 16, 20, 30 };
+        const auto instance = SymbolInstanceAttributes::instance({ 10, 20 }, tl, tr, bl, tex, 18, 64);
+        const auto corners = SymbolInstanceAttributes::corners(instance);
+
+        const std::array<std::pair<Point<float>, Point<uint16_t>>, 4> expected {{
+            { tl, { tex.x, tex.y } },
+            { tr, { uint16_t(tex.x + tex.w), tex.y } },
+            { bl, { tex.x, uint16_t(tex.y + tex.h) } },
+            { br, { uint16_t(tex.x + tex.w), uint16_t(tex.y + tex.h) } }
+        }};
+        for (std::size_t i = 0; i < 4; i++) {
+            const auto vertex = SymbolLayoutAttributes::vertex({ 10, 20 }, expected[i].first,
+                expected[i].second.x, expected[i].second.y, 0, 18, 0, 64);
+            EXPECT_EQ(vertex.a1[0], corners[i].a1[0]);
+            EXPECT_EQ(vertex.a1[1], corners[i].a1[1]);
+            // Corners other than the top right one may be off by the rounding of the offsets.
+            EXPECT_NEAR(vertex.a1[2], corners[i].a1[2], 1);
+            EXPECT_NEAR(vertex.a1[3], corners[i].a1[3], 1);
+            EXPECT_EQ(vertex.a2, corners[i].a2);
+        }
+        EXPECT_EQ(SymbolLayoutAttributes::vertex({ 10, 20 }, tr, tex.x + tex.w, tex.y, 0, 18, 0, 64).a1, corners[1].a1);
+    };
+
+    expect({ -3, -4 }, { 5, -4 }, { -3, 6 }, { 5, 6 });
+
+    // Rotated quads keep their edges at right angles.
+    const float angle = 0.6;
+    auto rotate = [&] (Point<float> p) { return util::rotate(p, angle); };
+    expect(rotate({ -3, -4 }), rotate({ 5, -4 }), rotate({ -3, 6 }), rotate({ 5, 6 }));
+}
@@ -0,0 +1,74 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/renderer/tessellation_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// A square ring with enough vertices along its sides to be cached.
+GeometryCollection square(int16_t size) {
+    GeometryCoordinates ring;
+    const int16_t steps = TessellationCache::minimumVertices / 4;
+    for (int16_t i = 0; i < steps; i++) ring.emplace_back(size * i / steps, 0);
+    for (int16_t i = 0; i < steps; i++) ring.emplace_back(size, size * i / steps);
+    for (int16_t i = 0; i < steps; i++) ring.emplace_back(size - size * i / steps, size);
+    for (int16_t i = 0; i < steps; i++) ring.emplace_back(0, size - size * i / steps);
+    return { ring };
+}
+
+} // namespace
+
+TEST(TessellationCache, Disabled) {
+    TessellationCache cache;
+    EXPECT_FALSE(cache.isEnabled());
+
+    EXPECT_FALSE(cache.tessellate(square(4096)).empty());
+    EXPECT_EQ(0u, cache.getStats().polygons);
+}
+
+TEST(TessellationCache, SmallPolygons) {
+    TessellationCache cache(1 << 20);
+
+    const auto indices = cache.tessellate({ { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 0, 10 } } });
+    EXPECT_EQ(6u, indices.size());
+    EXPECT_EQ(0u, cache.getStats().polygons);
+    EXPECT_EQ(0u, cache.getStats().misses);
+}
+
+TEST(TessellationCache, Tessellate) {
+    TessellationCache cache(1 << 20);
+
+    const auto indices = cache.tessellate(square(4096));
+    EXPECT_EQ(1u, cache.getStats().misses);
+    EXPECT_EQ(1u, cache.getStats().polygons);
+
+    EXPECT_EQ(indices, cache.tessellate(square(4096)));
+    EXPECT_EQ(1u, cache.getStats().hits);
+
+    // Other polygons are tessellated on their own.
+    cache.tessellate(square(2048));
+    EXPECT_EQ(2u, cache.getStats().misses);
+    EXPECT_EQ(2u, cache.getStats().polygons);
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.getStats().bytes);
+    cache.tessellate(square(4096));
+    EXPECT_EQ(3u, cache.getStats().misses);
+}
+
+TEST(TessellationCache, Evict) {
+    TessellationCache cache(1 << 20);
+    cache.tessellate(square(4096));
+    const std::size_t bytes = cache.getStats().bytes;
+    EXPECT_LT(0u, bytes);
+
+    cache.setMaximumBytes(bytes);
+    cache.tessellate(square(2048));
+    EXPECT_EQ(1u, cache.getStats().polygons);
+    EXPECT_EQ(1u, cache.getStats().evictions);
+
+    // The most recently used polygon is kept.
+    cache.tessellate(square(2048));
+    EXPECT_EQ(1u, cache.getStats().hits);
+}
@@ -263,6 +263,79 @@ TEST(SpriteAtlas, ReplaceWithDifferentDimensions) {
     EXPECT_EQ(sprite1, atlas.getSprite("sprite"));
 }
 
+class StubIconRequestor : public IconRequestor {
+public:
+    void onIconsAvailable(SpriteAtlas*, IconMap icons_) override {
+        icons = std::move(icons_);
+    }
+
+    IconMap icons;
+};
+
+TEST(SpriteAtlas, Requestors) {
+    FixtureLog log;
+    util::RunLoop loop;
+    StubFileSource fileSource;
+
+    SpriteAtlas atlas({ 32, 32 }, 1);
+    StubIconRequestor requestor;
+
+    // Requests are answered once the sprite has loaded, with just the requested icons.
+    atlas.setSprite("one", std::make_shared<SpriteImage>(PremultipliedImage({ 16, 12 }), 1));
+    atlas.setSprite("two", std::make_shared<SpriteImage>(PremultipliedImage({ 16, 12 }), 1));
+    atlas.getIcons(requestor, { "one", "missing" });
+    EXPECT_TRUE(requestor.icons.empty());
+
+    atlas.load("", fileSource);
+    EXPECT_TRUE(atlas.isLoaded());
+    atlas.getIcons(requestor, { "one", "missing" });
+    ASSERT_EQ(1u, requestor.icons.size());
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 20, 16), requestor.icons.at("one").pos);
+
+    atlas.removeRequestor(requestor);
+    EXPECT_TRUE(log.empty());
+}
+
+TEST(SpriteAtlas, Eviction) {
+    FixtureLog log;
+    util::RunLoop loop;
+    StubFileSource fileSource;
+
+    // Each of the icons takes up half of the atlas.
+    SpriteAtlas atlas({ 32, 32 }, 1);
+    atlas.load("", fileSource);
+    atlas.setSprite("one", std::make_shared<SpriteImage>(PremultipliedImage({ 28, 12 }), 1));
+    atlas.setSprite("two", std::make_shared<SpriteImage>(PremultipliedImage({ 28, 12 }), 1));
+    atlas.setSprite("three", std::make_shared<SpriteImage>(PremultipliedImage({ 28, 12 }), 1));
+
+    StubIconRequestor a, b, c;
+    atlas.getIcons(a, { "one" });
+    atlas.getIcons(b, { "two" });
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 32, 16), a.icons.at("one").pos);
+    EXPECT_EQ(Rect<uint16_t>(0, 16, 32, 16), b.icons.at("two").pos);
+
+    // Icons that are in use are never evicted.
+    atlas.getIcons(c, { "three" });
+    EXPECT_TRUE(c.icons.empty());
+    EXPECT_EQ(1u, log.count({
+                      EventSeverity::Warning,
+                      Event::Sprite,
+                      int64_t(-1),
+                      "sprite atlas bitmap overflow",
+                  }));
+
+    // Once no requestor uses an icon anymore, its space is reused.
+    atlas.removeRequestor(b);
+    atlas.getIcons(c, { "three" });
+    EXPECT_EQ(Rect<uint16_t>(0, 16, 32, 16), c.icons.at("three").pos);
+
+    // The least recently used icon is evicted first.
+    atlas.removeRequestor(c);
+    atlas.removeRequestor(a);
+    atlas.getIcons(b, { "two" });
+    EXPECT_EQ(Rect<uint16_t>(0, 16, 32, 16), b.icons.at("two").pos);
+}
+
 class SpriteAtlasTest {
 public:
     SpriteAtlasTest() = default;
@@ -290,14 +363,14 @@ public:
 Response successfulSpriteImageResponse(const Resource& resource) {
     EXPECT_EQ("test/fixtures/resources/sprite.png", resource.url);
     Response response;
-    response.data = std::make_shared<std::string>(util::read_file(resource.url));
+    response.data = std::make_shared<Buffer>(util::read_file(resource.url));
     return response;
 }
 
 Response successfulSpriteJSONResponse(const Resource& resource) {
     EXPECT_EQ("test/fixtures/resources/sprite.json", resource.url);
     Response response;
-    response.data = std::make_shared<std::string>(util::read_file(resource.url));
+    response.data = std::make_shared<Buffer>(util::read_file(resource.url));
     return response;
 }
 
@@ -311,7 +384,7 @@ Response failedSpriteResponse(const Resource&) {
 
 Response corruptSpriteResponse(const Resource&) {
     Response response;
-    response.data = std::make_shared<std::string>("CORRUPT");
+    response.data = std::make_shared<Buffer>("CORRUPT");
     return response;
 }
 
@@ -40,9 +40,9 @@ TEST(Sprite, SpriteImage) {
     PremultipliedImage image({ 32, 24 });
     SpriteImage sprite(std::move(image), 2.0);
     EXPECT_EQ(16, sprite.getWidth());
-    EXPECT_EQ(32u, sprite.image.size.width);
+    EXPECT_EQ(32u, sprite.size.width);
     EXPECT_EQ(12, sprite.getHeight());
-    EXPECT_EQ(24u, sprite.image.size.height);
+    EXPECT_EQ(24u, sprite.size.height);
     EXPECT_EQ(2, sprite.pixelRatio);
 }
 
@@ -50,8 +50,31 @@ TEST(Sprite, SpriteImageFractionalRatio) {
     PremultipliedImage image({ 20, 12 });
     SpriteImage sprite(std::move(image), 1.5);
     EXPECT_EQ(float(20.0 / 1.5), sprite.getWidth());
-    EXPECT_EQ(20u, sprite.image.size.width);
+    EXPECT_EQ(20u, sprite.size.width);
     EXPECT_EQ(float(12.0 / 1.5), sprite.getHeight());
-    EXPECT_EQ(12u, sprite.image.size.height);
+    EXPECT_EQ(12u, sprite.size.height);
     EXPECT_EQ(1.5, sprite.pixelRatio);
 }
+
+TEST(Sprite, SpriteImageOfSheet) {
+    PremultipliedImage sheet({ 4, 4 });
+    for (std::size_t i = 0; i < sheet.bytes(); i++) {
+        sheet.data[i] = i;
+    }
+    auto sharedSheet = std::make_shared<const PremultipliedImage>(sheet.clone());
+
+    SpriteImage sprite(sharedSheet, { 1, 2 }, { 2, 2 }, 2.0);
+    EXPECT_EQ(1, sprite.getWidth());
+    EXPECT_EQ(2u, sprite.size.height);
+
+    PremultipliedImage expected({ 2, 2 });
+    PremultipliedImage::copy(sheet, expected, { 1, 2 }, { 0, 0 }, { 2, 2 });
+    EXPECT_EQ(expected, sprite.getImage());
+
+    try {
+        SpriteImage(sharedSheet, { 3, 3 }, { 2, 2 }, 1.0);
+        FAIL() << "Expected exception";
+    } catch (util::SpriteImageException& ex) {
+        EXPECT_STREQ("Sprite image must lie within its sprite sheet", ex.what());
+    }
+}
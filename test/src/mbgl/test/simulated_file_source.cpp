@@ -0,0 +1,236 @@
+#include <mbgl/test/simulated_file_source.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mbgl {
+
+class SimulatedFileRequest : public AsyncRequest {
+public:
+    enum class State { Waiting, Connecting, Transferring, Done };
+
+    SimulatedFileRequest(SimulatedFileSource& fileSource_, const Resource& resource_, FileSource::Callback callback_, uint64_t sequence_)
+        : fileSource(fileSource_),
+          resource(resource_),
+          callback(std::move(callback_)),
+          sequence(sequence_) {
+    }
+
+    ~SimulatedFileRequest() override {
+        fileSource.cancelled(*this);
+    }
+
+    void setPriority(int32_t priority) override {
+        // Only the order in which waiting requests get a connection depends on it.
+        resource.priority = priority;
+    }
+
+    SimulatedFileSource& fileSource;
+    Resource resource;
+    FileSource::Callback callback;
+    const uint64_t sequence;
+
+    State state = State::Waiting;
+
+    // When the first byte of the response arrives while connecting, and when all of it has
+    // arrived while transferring.
+    TimePoint due;
+
+    std::unique_ptr<AsyncRequest> originRequest;
+    optional<Response> response;
+};
+
+SimulatedFileSource::Conditions SimulatedFileSource::Conditions::datacenter() {
+    Conditions conditions;
+    conditions.latency = Milliseconds(2);
+    conditions.latencyDeviation = 0.2;
+    conditions.bandwidth = 0;
+    conditions.concurrency = 0;
+    conditions.failureRate = 0;
+    return conditions;
+}
+
+SimulatedFileSource::Conditions SimulatedFileSource::Conditions::lte() {
+    Conditions conditions;
+    conditions.latency = Milliseconds(70);
+    conditions.latencyDeviation = 0.4;
+    conditions.bandwidth = 1500 * 1024;
+    conditions.concurrency = 6;
+    conditions.failureRate = 0.001;
+    return conditions;
+}
+
+SimulatedFileSource::Conditions SimulatedFileSource::Conditions::threeG() {
+    Conditions conditions;
+    conditions.latency = Milliseconds(300);
+    conditions.latencyDeviation = 0.5;
+    conditions.bandwidth = 100 * 1024;
+    conditions.concurrency = 6;
+    conditions.failureRate = 0.01;
+    return conditions;
+}
+
+SimulatedFileSource::SimulatedFileSource(FileSource& origin_, Conditions conditions_, uint32_t seed)
+    : origin(origin_),
+      conditions(std::move(conditions_)),
+      random(seed) {
+}
+
+SimulatedFileSource::~SimulatedFileSource() = default;
+
+std::unique_ptr<AsyncRequest> SimulatedFileSource::request(const Resource& resource, Callback callback) {
+    auto req = std::make_unique<SimulatedFileRequest>(*this, resource, std::move(callback), nextSequence++);
+    stats.requests++;
+
+    waiting.push_back(req.get());
+    stats.maxWaiting = std::max(stats.maxWaiting, waiting.size());
+    start();
+
+    return std::move(req);
+}
+
+void SimulatedFileSource::start() {
+    // The values are drawn from the generator's output directly rather than through the
+    // distributions of <random>, whose algorithms differ between standard libraries.
+    auto uniform = [this] {
+        return (double(random()) + 0.5) / 4294967296.0;
+    };
+
+    while (!waiting.empty() && (conditions.concurrency == 0 || active.size() < conditions.concurrency)) {
+        // The highest priority first, and the oldest of those.
+        auto it = std::min_element(waiting.begin(), waiting.end(), [] (auto* a, auto* b) {
+            return a->resource.priority != b->resource.priority
+                ? a->resource.priority > b->resource.priority
+                : a->sequence < b->sequence;
+        });
+        SimulatedFileRequest& req = **it;
+        waiting.erase(it);
+        active.push_back(&req);
+
+        // Every request draws the same values, so that each sees the same latency and outcome
+        // under any conditions.
+        const double normal = std::sqrt(-2 * std::log(uniform())) * std::cos(util::M2PI * uniform());
+        const bool fails = uniform() < conditions.failureRate;
+
+        const auto latency = std::chrono::duration<double>(conditions.latency) *
+                             std::exp(conditions.latencyDeviation * normal);
+        req.due = Clock::now() + std::chrono::duration_cast<Duration>(latency);
+
+        if (fails) {
+            stats.failures++;
+            Response response;
+            response.error = std::make_unique<Response::Error>(
+                Response::Error::Reason::Connection, "simulated connection failure");
+            req.state = SimulatedFileRequest::State::Transferring;
+            req.response = std::move(response);
+            schedule();
+        } else {
+            req.state = SimulatedFileRequest::State::Connecting;
+            req.originRequest = origin.request(req.resource, [this, &req] (Response response) {
+                received(req, std::move(response));
+            });
+        }
+    }
+}
+
+void SimulatedFileSource::received(SimulatedFileRequest& req, Response response) {
+    // Origins such as StubFileSource may answer more than once; the first answer counts.
+    if (req.state != SimulatedFileRequest::State::Connecting) {
+        return;
+    }
+
+    // The data of the responses is sent over the link one after the other, in the order in
+    // which it is ready to go.
+    const std::size_t bytes = response.data ? response.data->size() : 0;
+    TimePoint transferStart = std::max(req.due, Clock::now());
+    if (conditions.bandwidth) {
+        transferStart = std::max(transferStart, linkAvailable);
+        req.due = transferStart + std::chrono::duration_cast<Duration>(
+            std::chrono::duration<double>(double(bytes) / conditions.bandwidth));
+        linkAvailable = req.due;
+    } else {
+        req.due = transferStart;
+    }
+
+    req.state = SimulatedFileRequest::State::Transferring;
+    req.response = std::move(response);
+    schedule();
+}
+
+void SimulatedFileSource::cancelled(SimulatedFileRequest& req) {
+    switch (req.state) {
+    case SimulatedFileRequest::State::Waiting:
+        waiting.remove(&req);
+        stats.cancellations++;
+        break;
+    case SimulatedFileRequest::State::Connecting:
+    case SimulatedFileRequest::State::Transferring:
+        // The data that is already on its way keeps the link busy.
+        active.remove(&req);
+        stats.cancellations++;
+        req.state = SimulatedFileRequest::State::Done;
+        req.originRequest.reset();
+        start();
+        schedule();
+        break;
+    case SimulatedFileRequest::State::Done:
+        break;
+    }
+}
+
+void SimulatedFileSource::deliver() {
+    const TimePoint now = Clock::now();
+
+    // Callbacks may cancel or make requests, so the next request is looked up after each one.
+    while (true) {
+        auto it = std::find_if(active.begin(), active.end(), [&] (auto* req) {
+            return req->state == SimulatedFileRequest::State::Transferring && req->due <= now;
+        });
+        if (it == active.end()) {
+            break;
+        }
+
+        SimulatedFileRequest& req = **it;
+        active.erase(it);
+        req.state = SimulatedFileRequest::State::Done;
+        req.originRequest.reset();
+
+        Response response = std::move(*req.response);
+        req.response = {};
+        if (response.data) {
+            stats.bytes += response.data->size();
+        }
+
+        // The callback may destroy the request along with its copy of the callback.
+        Callback callback = std::move(req.callback);
+        start();
+        callback(response);
+    }
+
+    schedule();
+}
+
+void SimulatedFileSource::schedule() {
+    optional<TimePoint> next;
+    for (auto* req : active) {
+        if (req->state == SimulatedFileRequest::State::Transferring && (!next || req->due < *next)) {
+            next = req->due;
+        }
+    }
+
+    if (next) {
+        // Timers count whole milliseconds; rounding up keeps them from firing too early.
+        const Duration delay = std::max(*next - Clock::now(), Duration::zero());
+        const Milliseconds timeout = std::chrono::duration_cast<Milliseconds>(delay + Milliseconds(1) - Duration(1));
+        timer.start(timeout, Duration::zero(), [this] {
+            deliver();
+        });
+    } else {
+        timer.stop();
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/timer.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <random>
+
+namespace mbgl {
+
+class SimulatedFileRequest;
+
+// Answers requests with the responses of another file source, such as a DefaultFileSource over
+// a fixture cache in offline mode or a StubFileSource, as they would arrive over a network with
+// the given conditions. Random latencies and failures are drawn from a generator with a fixed
+// seed, so that runs that make the same requests in the same order see the same network.
+//
+// Like a browser or OnlineFileSource, it has a number of connections; requests that are made
+// while they are all busy wait for one, highest priority first. Every response takes a latency,
+// and then the time its data takes to arrive over a link that all connections share.
+class SimulatedFileSource : public FileSource {
+public:
+    class Conditions {
+    public:
+        // The median time to the first byte of a response. Latencies are log-normal around it,
+        // with the given standard deviation of their logarithm; zero for a constant latency.
+        Duration latency = Duration::zero();
+        double latencyDeviation = 0;
+
+        // The bytes per second of the link, or zero for a link without limit.
+        std::size_t bandwidth = 0;
+
+        // The number of requests that can be in flight at once, or zero for no limit.
+        std::size_t concurrency = 0;
+
+        // The fraction of requests that fail with a connection error after their latency.
+        double failureRate = 0;
+
+        static Conditions datacenter();
+        static Conditions lte();
+        static Conditions threeG();
+    };
+
+    class Stats {
+    public:
+        std::size_t requests = 0;
+        std::size_t failures = 0;
+        std::size_t cancellations = 0;
+        std::size_t bytes = 0;
+
+        // The most requests that waited for a connection at once.
+        std::size_t maxWaiting = 0;
+    };
+
+    SimulatedFileSource(FileSource& origin, Conditions, uint32_t seed = 0);
+    ~SimulatedFileSource() override;
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+    void setConditions(Conditions conditions_) {
+        conditions = conditions_;
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+
+private:
+    friend class SimulatedFileRequest;
+
+    // Gives waiting requests the connections that are free.
+    void start();
+    void received(SimulatedFileRequest&, Response);
+    void cancelled(SimulatedFileRequest&);
+
+    // Answers the requests whose responses have arrived, and waits for the next one.
+    void deliver();
+    void schedule();
+
+    FileSource& origin;
+    Conditions conditions;
+    std::mt19937 random;
+    Stats stats;
+
+    uint64_t nextSequence = 0;
+    std::list<SimulatedFileRequest*> waiting;
+    std::list<SimulatedFileRequest*> active;
+
+    // When the link has sent all the data of the responses so far.
+    TimePoint linkAvailable = TimePoint::min();
+
+    util::Timer timer;
+};
+
+} // namespace mbgl
@@ -4,6 +4,7 @@
 #include <mbgl/util/timer.hpp>
 
 #include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
@@ -15,6 +16,13 @@ public:
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
     void remove(AsyncRequest*);
 
+    void preconnect(const std::string& url) override {
+        preconnections.push_back(url);
+    }
+
+    // The URLs passed to preconnect(), in order.
+    std::vector<std::string> preconnections;
+
     using ResponseFunction = std::function<optional<Response> (const Resource&)>;
 
     // You can set the response callback on a global level by assigning this callback:
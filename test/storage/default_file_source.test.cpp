@@ -2,6 +2,8 @@
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <cstdio>
+
 using namespace mbgl;
 
 TEST(DefaultFileSource, TEST_REQUIRES_SERVER(CacheResponse)) {
@@ -218,7 +220,7 @@ TEST(DefaultFileSource, OptionalNonExpired) {
     using namespace std::chrono_literals;
 
     Response response;
-    response.data = std::make_shared<std::string>("Cached value");
+    response.data = std::make_shared<Buffer>("Cached value");
     response.expires = util::now() + 1h;
     fs.put(optionalResource, response);
 
@@ -238,6 +240,46 @@ TEST(DefaultFileSource, OptionalNonExpired) {
     loop.run();
 }
 
+TEST(DefaultFileSource, TEST_REQUIRES_WRITE(SharedRequests)) {
+    util::RunLoop loop;
+
+    // Lookups in an in-memory cache are answered right away, before other requests can share them.
+    std::remove("test/fixtures/offline_database/shared.db");
+    DefaultFileSource fs("test/fixtures/offline_database/shared.db", ".");
+
+    const Resource optionalResource { Resource::Unknown, "http://127.0.0.1:3000/test", {}, Resource::Optional };
+
+    using namespace std::chrono_literals;
+
+    Response response;
+    response.data = std::make_shared<Buffer>("Cached value");
+    response.expires = util::now() + 1h;
+    fs.put(optionalResource, response);
+
+    // Requests made at once share the lookup, and each gets the response, even when the one
+    // that started it is cancelled.
+    std::unique_ptr<AsyncRequest> cancelled = fs.request(optionalResource, [&](Response) {
+        ADD_FAILURE() << "Cancelled request was answered";
+    });
+
+    std::size_t responses = 0;
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+    auto callback = [&](Response res) {
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Cached value", *res.data);
+        if (++responses == 2) {
+            loop.stop();
+        }
+    };
+    req1 = fs.request(optionalResource, callback);
+    req2 = fs.request(optionalResource, callback);
+    cancelled.reset();
+
+    loop.run();
+    EXPECT_EQ(2u, responses);
+}
+
 TEST(DefaultFileSource, OptionalExpired) {
     util::RunLoop loop;
     DefaultFileSource fs(":memory:", ".");
@@ -247,7 +289,7 @@ TEST(DefaultFileSource, OptionalExpired) {
     using namespace std::chrono_literals;
 
     Response response;
-    response.data = std::make_shared<std::string>("Cached value");
+    response.data = std::make_shared<Buffer>("Cached value");
     response.expires = util::now() - 1h;
     fs.put(optionalResource, response);
 
@@ -307,6 +349,35 @@ TEST(DefaultFileSource, OptionalNotFound) {
     loop.run();
 }
 
+TEST(DefaultFileSource, TEST_REQUIRES_SERVER(RequiredReportsCacheMiss)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    Resource resource { Resource::Unknown, "http://127.0.0.1:3000/test" };
+    resource.reportCacheMiss = true;
+
+    // The cache answers first, and the network after it over the same request.
+    int responses = 0;
+    std::unique_ptr<AsyncRequest> req;
+    req = fs.request(resource, [&](Response res) {
+        if (responses++ == 0) {
+            ASSERT_TRUE(res.error.get());
+            EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+            EXPECT_EQ("Not found in offline database", res.error->message);
+            EXPECT_FALSE(res.data);
+        } else {
+            req.reset();
+            EXPECT_EQ(nullptr, res.error);
+            ASSERT_TRUE(res.data.get());
+            EXPECT_EQ("Hello World!", *res.data);
+            loop.stop();
+        }
+    });
+
+    loop.run();
+    EXPECT_EQ(2, responses);
+}
+
 // Test that we can make a request with etag data that doesn't first try to load
 // from cache like a regular request
 TEST(DefaultFileSource, TEST_REQUIRES_SERVER(NoCacheRefreshEtagNotModified)) {
@@ -320,7 +391,7 @@ TEST(DefaultFileSource, TEST_REQUIRES_SERVER(NoCacheRefreshEtagNotModified)) {
 
     // Put a fake value into the cache to make sure we're not retrieving anything from the cache.
     Response response;
-    response.data = std::make_shared<std::string>("Cached value");
+    response.data = std::make_shared<Buffer>("Cached value");
     response.expires = util::now() + 1h;
     fs.put(resource, response);
 
@@ -354,7 +425,7 @@ TEST(DefaultFileSource, TEST_REQUIRES_SERVER(NoCacheRefreshEtagModified)) {
 
     // Put a fake value into the cache to make sure we're not retrieving anything from the cache.
     Response response;
-    response.data = std::make_shared<std::string>("Cached value");
+    response.data = std::make_shared<Buffer>("Cached value");
     response.expires = util::now() + 1h;
     fs.put(resource, response);
 
@@ -389,7 +460,7 @@ TEST(DefaultFileSource, TEST_REQUIRES_SERVER(NoCacheFull)) {
 
     // Put a fake value into the cache to make sure we're not retrieving anything from the cache.
     Response response;
-    response.data = std::make_shared<std::string>("Cached value");
+    response.data = std::make_shared<Buffer>("Cached value");
     response.expires = util::now() + 1h;
     fs.put(resource, response);
 
@@ -423,7 +494,7 @@ TEST(DefaultFileSource, TEST_REQUIRES_SERVER(NoCacheRefreshModifiedNotModified))
 
     // Put a fake value into the cache to make sure we're not retrieving anything from the cache.
     Response response;
-    response.data = std::make_shared<std::string>("Cached value");
+    response.data = std::make_shared<Buffer>("Cached value");
     response.expires = util::now() + 1h;
     fs.put(resource, response);
 
@@ -457,7 +528,7 @@ TEST(DefaultFileSource, TEST_REQUIRES_SERVER(NoCacheRefreshModifiedModified)) {
 
     // Put a fake value into the cache to make sure we're not retrieving anything from the cache.
     Response response;
-    response.data = std::make_shared<std::string>("Cached value");
+    response.data = std::make_shared<Buffer>("Cached value");
     response.expires = util::now() + 1h;
     fs.put(resource, response);
 
@@ -34,6 +34,22 @@ TEST(HTTPFileSource, TEST_REQUIRES_SERVER(HTTP200)) {
     loop.run();
 }
 
+TEST(HTTPFileSource, TEST_REQUIRES_SERVER(Preconnect)) {
+    util::RunLoop loop;
+    HTTPFileSource fs;
+
+    // Requests that follow a preconnection are served as usual, whichever finishes first.
+    fs.preconnect("http://127.0.0.1:3000/{z}/{x}/{y}.pbf");
+    auto req = fs.request({ Resource::Unknown, "http://127.0.0.1:3000/test" }, [&](Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Hello World!", *res.data);
+        loop.stop();
+    });
+
+    loop.run();
+}
+
 TEST(HTTPFileSource, TEST_REQUIRES_SERVER(HTTP404)) {
     util::RunLoop loop;
     HTTPFileSource fs;
@@ -122,3 +122,25 @@ TEST(LocalFileSource, URLLimit) {
 
     loop.run();
 }
+
+TEST(LocalFileSource, DataOutlivesSource) {
+    util::RunLoop loop;
+
+    std::shared_ptr<const Buffer> data;
+    {
+        LocalFileSource fs;
+
+        std::unique_ptr<AsyncRequest> req = fs.request({ Resource::Unknown, toAbsoluteURL("nonempty") }, [&](Response res) {
+            req.reset();
+            EXPECT_EQ(nullptr, res.error);
+            data = res.data;
+            loop.stop();
+        });
+
+        loop.run();
+    }
+
+    // The file is mapped rather than copied, and the mapping lives as long as the data does.
+    ASSERT_TRUE(data.get());
+    EXPECT_EQ("content is here\n", *data);
+}
@@ -52,3 +52,18 @@ TEST(OfflineTilePyramidRegionDefinition, TileCoverWrapped) {
     EXPECT_EQ((std::vector<CanonicalTileID>{ { 0, 0, 0 } }),
               region.tileCover(SourceType::Vector, 512, { 0, 22 }));
 }
+
+TEST(OfflineTilePyramidRegionDefinition, TileCount) {
+    OfflineTilePyramidRegionDefinition region("", sanFrancisco, 0, 22, 1.0);
+
+    // The tiles of z0 to z4 are the same ones tileCover() lists.
+    EXPECT_EQ(region.tileCover(SourceType::Vector, 512, { 0, 4 }).size(),
+              region.tileCount(SourceType::Vector, 512, { 0, 4 }));
+
+    EXPECT_EQ(0u, region.tileCount(SourceType::Vector, 512, { 23, 24 }));
+
+    OfflineTilePyramidRegionDefinition world("", LatLngBounds::world(), 0, 14, 1.0);
+
+    // 4^0 + 4^1 + ... + 4^14
+    EXPECT_EQ(357913941u, world.tileCount(SourceType::Vector, 512, { 0, 22 }));
+}
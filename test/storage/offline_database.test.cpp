@@ -166,7 +166,7 @@ TEST(OfflineDatabase, PutResource) {
     Resource resource { Resource::Style, "http://example.com/" };
     Response response;
 
-    response.data = std::make_shared<std::string>("first");
+    response.data = std::make_shared<Buffer>("first");
     auto insertPutResult = db.put(resource, response);
     EXPECT_TRUE(insertPutResult.first);
     EXPECT_EQ(5u, insertPutResult.second);
@@ -175,7 +175,7 @@ TEST(OfflineDatabase, PutResource) {
     EXPECT_EQ(nullptr, insertGetResult->error.get());
     EXPECT_EQ("first", *insertGetResult->data);
 
-    response.data = std::make_shared<std::string>("second");
+    response.data = std::make_shared<Buffer>("second");
     auto updatePutResult = db.put(resource, response);
     EXPECT_FALSE(updatePutResult.first);
     EXPECT_EQ(6u, updatePutResult.second);
@@ -200,7 +200,7 @@ TEST(OfflineDatabase, PutTile) {
     };
     Response response;
 
-    response.data = std::make_shared<std::string>("first");
+    response.data = std::make_shared<Buffer>("first");
     auto insertPutResult = db.put(resource, response);
     EXPECT_TRUE(insertPutResult.first);
     EXPECT_EQ(5u, insertPutResult.second);
@@ -209,7 +209,7 @@ TEST(OfflineDatabase, PutTile) {
     EXPECT_EQ(nullptr, insertGetResult->error.get());
     EXPECT_EQ("first", *insertGetResult->data);
 
-    response.data = std::make_shared<std::string>("second");
+    response.data = std::make_shared<Buffer>("second");
     auto updatePutResult = db.put(resource, response);
     EXPECT_FALSE(updatePutResult.first);
     EXPECT_EQ(6u, updatePutResult.second);
@@ -219,6 +219,42 @@ TEST(OfflineDatabase, PutTile) {
     EXPECT_EQ("second", *updateGetResult->data);
 }
 
+TEST(OfflineDatabase, PutTileNotModified) {
+    using namespace mbgl;
+    using namespace std::chrono_literals;
+
+    OfflineDatabase db(":memory:");
+
+    Resource resource { Resource::Tile, "http://example.com/" };
+    resource.tileData = Resource::TileData {
+        "http://example.com/",
+        1,
+        0,
+        0,
+        0
+    };
+    Response response;
+    response.data = std::make_shared<Buffer>("first");
+    response.etag = { "snowfall" };
+    response.expires = util::now() - 1h;
+    db.put(resource, response);
+
+    Response notModified;
+    notModified.notModified = true;
+    notModified.expires = util::now() + 1h;
+    auto putResult = db.put(resource, notModified);
+    EXPECT_FALSE(putResult.first);
+    EXPECT_EQ(0u, putResult.second);
+
+    auto res = db.get(resource);
+    EXPECT_EQ(nullptr, res->error);
+    ASSERT_TRUE(res->data.get());
+    EXPECT_EQ("first", *res->data);
+    EXPECT_EQ("snowfall", *res->etag);
+    ASSERT_TRUE(bool(res->expires));
+    EXPECT_EQ(*notModified.expires, *res->expires);
+}
+
 TEST(OfflineDatabase, PutResourceNoContent) {
     using namespace mbgl;
 
@@ -386,15 +422,40 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ConcurrentUse)) {
     thread2.join();
 }
 
-static std::shared_ptr<std::string> randomString(size_t size) {
-    auto result = std::make_shared<std::string>(size, 0);
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ReadOnly)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    OfflineDatabase writer("test/fixtures/offline_database/offline.db");
+    OfflineDatabase reader("test/fixtures/offline_database/offline.db",
+                           util::DEFAULT_MAX_CACHE_SIZE, OfflineDatabase::Mode::ReadOnly);
+
+    Resource resource { Resource::Style, "http://example.com/" };
+    EXPECT_FALSE(bool(reader.get(resource)));
+
+    Response response;
+    response.data = std::make_shared<Buffer>("data");
+    writer.put(resource, response);
+
+    auto result = reader.get(resource);
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ("data", *result->data);
+
+    EXPECT_THROW(reader.put(resource, response), mapbox::sqlite::Exception);
+    EXPECT_NO_THROW(writer.markAccessed(resource));
+}
+
+static std::shared_ptr<const mbgl::Buffer> randomString(size_t size) {
+    std::string result(size, 0);
     std::mt19937 random;
 
     for (size_t i = 0; i < size; i++) {
-        (*result)[i] = random();
+        result[i] = random();
     }
 
-    return result;
+    return std::make_shared<mbgl::Buffer>(std::move(result));
 }
 
 TEST(OfflineDatabase, PutReturnsSize) {
@@ -403,7 +464,7 @@ TEST(OfflineDatabase, PutReturnsSize) {
     OfflineDatabase db(":memory:");
 
     Response compressible;
-    compressible.data = std::make_shared<std::string>(1024, 0);
+    compressible.data = std::make_shared<Buffer>(std::string(1024, 0));
     EXPECT_EQ(17u, db.put(Resource::style("http://example.com/compressible"), compressible).second);
 
     Response incompressible;
@@ -432,6 +493,69 @@ TEST(OfflineDatabase, PutEvictsLeastRecentlyUsedResources) {
     EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
 }
 
+TEST(OfflineDatabase, TrimAmbientCache) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:", 1024 * 1024);
+
+    Response response;
+    response.data = randomString(1024 * 10);
+
+    // Below the high watermark of 90%, nothing is evicted.
+    for (uint32_t i = 1; i <= 60; i++) {
+        db.put(Resource::style("http://example.com/"s + util::toString(i)), response);
+    }
+    EXPECT_FALSE(db.trimAmbientCache());
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1"))));
+
+    // Past it, batches are evicted until the cache is below the low watermark of 75%.
+    for (uint32_t i = 61; i <= 75; i++) {
+        db.put(Resource::style("http://example.com/"s + util::toString(i)), response);
+    }
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1"))));
+    while (db.trimAmbientCache()) {
+    }
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
+    EXPECT_FALSE(db.trimAmbientCache());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(DeleteRegionVacuumsInBatches)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    // Without an ambient cache, everything that the region used is evicted when it's deleted.
+    OfflineDatabase db("test/fixtures/offline_database/offline.db", 0);
+    OfflineRegion region = db.createRegion({ "", LatLngBounds::world(), 0, INFINITY, 1.0 }, OfflineRegionMetadata());
+
+    db.batch([&] {
+        Response response;
+        for (uint32_t i = 1; i <= 500; i++) {
+            response.data = randomString(1024 * 20);
+            db.putRegionResource(region.getID(), Resource::style("http://example.com/"s + util::toString(i)), response);
+        }
+    });
+
+    auto fileSize = [] {
+        return util::read_file("test/fixtures/offline_database/offline.db").size();
+    };
+    const std::size_t full = fileSize();
+    EXPECT_LT(10u * 1024 * 1024, full);
+
+    // Deleting the region returns only a batch of the freed pages to the file system.
+    db.deleteRegion(std::move(region));
+    const std::size_t deleted = fileSize();
+    EXPECT_GT(full, deleted);
+    EXPECT_LT(1024u * 1024, deleted);
+
+    // Trimming returns the others.
+    EXPECT_TRUE(db.trimAmbientCache());
+    while (db.trimAmbientCache()) {
+    }
+    EXPECT_GT(1024u * 1024, fileSize());
+}
+
 TEST(OfflineDatabase, PutRegionResourceDoesNotEvict) {
     using namespace mbgl;
 
@@ -477,7 +601,7 @@ TEST(OfflineDatabase, GetRegionCompletedStatus) {
     EXPECT_EQ(0u, status1.completedTileSize);
 
     Response response;
-    response.data = std::make_shared<std::string>("data");
+    response.data = std::make_shared<Buffer>("data");
 
     uint64_t styleSize = db.putRegionResource(region.getID(), Resource::style("http://example.com/"), response);
 
@@ -494,6 +618,27 @@ TEST(OfflineDatabase, GetRegionCompletedStatus) {
     EXPECT_EQ(styleSize + tileSize, status3.completedResourceSize);
     EXPECT_EQ(1u, status3.completedTileCount);
     EXPECT_EQ(tileSize, status3.completedTileSize);
+
+    // Putting a tile again with other data updates the size of the regions that use it.
+    Response response2;
+    response2.data = std::make_shared<Buffer>("more data");
+    uint64_t tileSize2 = db.putRegionResource(region.getID(), Resource::tile("http://example.com/", 1.0, 0, 0, 0, Tileset::Scheme::XYZ), response2);
+
+    OfflineRegionStatus status4 = db.getRegionCompletedStatus(region.getID());
+    EXPECT_EQ(2u, status4.completedResourceCount);
+    EXPECT_EQ(styleSize + tileSize2, status4.completedResourceSize);
+    EXPECT_EQ(1u, status4.completedTileCount);
+    EXPECT_EQ(tileSize2, status4.completedTileSize);
+
+    // Deleting another region that shares the tile leaves the counts of this one as they were.
+    OfflineRegion region2 = db.createRegion(definition, metadata);
+    db.putRegionResource(region2.getID(), Resource::tile("http://example.com/", 1.0, 0, 0, 0, Tileset::Scheme::XYZ), response2);
+    EXPECT_EQ(1u, db.getRegionCompletedStatus(region2.getID()).completedTileCount);
+    db.deleteRegion(std::move(region2));
+
+    OfflineRegionStatus status5 = db.getRegionCompletedStatus(region.getID());
+    EXPECT_EQ(2u, status5.completedResourceCount);
+    EXPECT_EQ(styleSize + tileSize2, status5.completedResourceSize);
 }
 
 TEST(OfflineDatabase, HasRegionResource) {
@@ -535,7 +680,7 @@ TEST(OfflineDatabase, HasRegionResourceTile) {
     };
     Response response;
 
-    response.data = std::make_shared<std::string>("first");
+    response.data = std::make_shared<Buffer>("first");
 
     EXPECT_FALSE(bool(db.hasRegionResource(region.getID(), resource)));
     db.putRegionResource(region.getID(), resource, response);
@@ -549,6 +694,33 @@ TEST(OfflineDatabase, HasRegionResourceTile) {
 
 }
 
+TEST(OfflineDatabase, HasRegionResources) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:", 1024 * 100);
+    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+
+    Response response;
+    response.data = std::make_shared<Buffer>("first");
+
+    const Resource style = Resource::style("http://example.com/style");
+    const Resource tile = Resource::tile("http://example.com/{z}-{x}-{y}", 1, 0, 0, 0, Tileset::Scheme::XYZ);
+    const Resource missing = Resource::tile("http://example.com/{z}-{x}-{y}", 1, 1, 0, 1, Tileset::Scheme::XYZ);
+
+    db.putRegionResource(region.getID(), style, response);
+    db.put(tile, response);
+
+    const auto sizes = db.hasRegionResources(region.getID(), { style, missing, tile });
+    ASSERT_EQ(3u, sizes.size());
+    EXPECT_EQ(5, *sizes[0]);
+    EXPECT_FALSE(bool(sizes[1]));
+    EXPECT_EQ(5, *sizes[2]);
+
+    // Resources that are found become part of the region.
+    EXPECT_EQ(2u, db.getRegionCompletedStatus(region.getID()).completedResourceCount);
+}
+
 TEST(OfflineDatabase, OfflineMapboxTileCount) {
     using namespace mbgl;
 
@@ -564,7 +736,7 @@ TEST(OfflineDatabase, OfflineMapboxTileCount) {
     Resource mapboxTile2 = Resource::tile("mapbox://tiles/2", 1.0, 0, 0, 1, Tileset::Scheme::XYZ);
 
     Response response;
-    response.data = std::make_shared<std::string>("data");
+    response.data = std::make_shared<Buffer>("data");
 
     // Count is initially zero.
     EXPECT_EQ(0u, db.getOfflineMapboxTileCount());
@@ -634,6 +806,91 @@ static int databaseSyncMode(const std::string& path) {
     return stmt.get<int>(0);
 }
 
+static mbgl::Timestamp resourceAccessed(const std::string& path, const std::string& url) {
+    mapbox::sqlite::Database db(path, mapbox::sqlite::ReadOnly);
+    mapbox::sqlite::Statement stmt = db.prepare("SELECT accessed FROM resources WHERE url = ?1");
+    stmt.bind(1, url);
+    stmt.run();
+    return stmt.get<mbgl::Timestamp>(0);
+}
+
+static void setResourceAccessed(const std::string& path, const std::string& url, mbgl::Timestamp accessed) {
+    mapbox::sqlite::Database db(path, mapbox::sqlite::ReadWrite);
+    mapbox::sqlite::Statement stmt = db.prepare("UPDATE resources SET accessed = ?1 WHERE url = ?2");
+    stmt.bind(1, accessed);
+    stmt.bind(2, url);
+    stmt.run();
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(AccessedGranularity)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    const std::string path = "test/fixtures/offline_database/offline.db";
+    const std::string url = "http://example.com/";
+    Response response;
+    response.noContent = true;
+
+    OfflineDatabase db(path);
+    db.put(Resource::style(url), response);
+
+    // A resource accessed a minute ago keeps its access time.
+    const Timestamp recent = util::now() - Seconds(60);
+    setResourceAccessed(path, url, recent);
+    EXPECT_TRUE(bool(db.get(Resource::style(url))));
+    db.markAccessed(Resource::style(url));
+    EXPECT_EQ(recent, resourceAccessed(path, url));
+
+    // One accessed an hour ago gets the current time.
+    setResourceAccessed(path, url, util::now() - Seconds(3600));
+    EXPECT_TRUE(bool(db.get(Resource::style(url))));
+    EXPECT_LE(recent, resourceAccessed(path, url));
+
+    setResourceAccessed(path, url, util::now() - Seconds(3600));
+    db.markAccessed(Resource::style(url));
+    EXPECT_LE(recent, resourceAccessed(path, url));
+}
+
+static void setResourceUncompressedSize(const std::string& path, const std::string& url, mbgl::optional<int64_t> size) {
+    mapbox::sqlite::Database db(path, mapbox::sqlite::ReadWrite);
+    mapbox::sqlite::Statement stmt = db.prepare("UPDATE resources SET uncompressed_size = ?1 WHERE url = ?2");
+    stmt.bind(1, size);
+    stmt.bind(2, url);
+    stmt.run();
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(UncompressedSize)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    const std::string path = "test/fixtures/offline_database/offline.db";
+    const std::string url = "http://example.com/";
+    Response response;
+    response.data = std::make_shared<Buffer>(std::string(100000, 'a'));
+
+    OfflineDatabase db(path);
+    db.put(Resource::style(url), response);
+
+    auto result = db.get(Resource::style(url));
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ(*response.data, *result->data);
+
+    // Rows stored before the size was recorded, or with a size that's off, still decompress.
+    setResourceUncompressedSize(path, url, {});
+    result = db.get(Resource::style(url));
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ(*response.data, *result->data);
+
+    setResourceUncompressedSize(path, url, 10);
+    result = db.get(Resource::style(url));
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ(*response.data, *result->data);
+}
+
 TEST(OfflineDatabase, MigrateFromV2Schema) {
     using namespace mbgl;
 
@@ -650,11 +907,41 @@ TEST(OfflineDatabase, MigrateFromV2Schema) {
         }
     }
 
-    EXPECT_EQ(5, databaseUserVersion("test/fixtures/offline_database/v5.db"));
+    EXPECT_EQ(8, databaseUserVersion("test/fixtures/offline_database/v5.db"));
     EXPECT_LT(databasePageCount("test/fixtures/offline_database/v5.db"),
               databasePageCount("test/fixtures/offline_database/v2.db"));
 }
 
+TEST(OfflineDatabase, MigrateStats) {
+    using namespace mbgl;
+
+    deleteFile("test/fixtures/offline_database/v5.db");
+    writeFile("test/fixtures/offline_database/v5.db", util::read_file("test/fixtures/offline_database/v2.db"));
+
+    // The region stats are counted once by the migration, and agree with counting them from
+    // the unmigrated database, which a read-only one does.
+    OfflineDatabase migrated("test/fixtures/offline_database/v5.db", 0);
+    OfflineDatabase original("test/fixtures/offline_database/v2.db", 0, OfflineDatabase::Mode::ReadOnly);
+
+    auto regions = migrated.listRegions();
+    ASSERT_FALSE(regions.empty());
+    for (auto& region : regions) {
+        OfflineRegionStatus expected = original.getRegionCompletedStatus(region.getID());
+        OfflineRegionStatus status = migrated.getRegionCompletedStatus(region.getID());
+        EXPECT_LT(0u, status.completedResourceCount);
+        EXPECT_EQ(expected.completedResourceCount, status.completedResourceCount);
+        EXPECT_EQ(expected.completedResourceSize, status.completedResourceSize);
+        EXPECT_EQ(expected.completedTileCount, status.completedTileCount);
+        EXPECT_EQ(expected.completedTileSize, status.completedTileSize);
+    }
+    EXPECT_EQ(original.getOfflineMapboxTileCount(), migrated.getOfflineMapboxTileCount());
+
+    for (auto& region : regions) {
+        migrated.deleteRegion(std::move(region));
+    }
+    EXPECT_EQ(0u, migrated.getOfflineMapboxTileCount());
+}
+
 TEST(OfflineDatabase, MigrateFromV3Schema) {
     using namespace mbgl;
 
@@ -671,7 +958,7 @@ TEST(OfflineDatabase, MigrateFromV3Schema) {
         }
     }
 
-    EXPECT_EQ(5, databaseUserVersion("test/fixtures/offline_database/v5.db"));
+    EXPECT_EQ(8, databaseUserVersion("test/fixtures/offline_database/v5.db"));
 }
 
 TEST(OfflineDatabase, MigrateFromV4Schema) {
@@ -690,11 +977,227 @@ TEST(OfflineDatabase, MigrateFromV4Schema) {
         }
     }
 
-    EXPECT_EQ(5, databaseUserVersion("test/fixtures/offline_database/v5.db"));
+    EXPECT_EQ(8, databaseUserVersion("test/fixtures/offline_database/v5.db"));
 
-    // Journal mode should be DELETE after migration to v5.
+    // Journal mode should be DELETE after migration to v5 and later.
     EXPECT_EQ("delete", databaseJournalMode("test/fixtures/offline_database/v5.db"));
 
-    // Synchronous setting should be FULL (2) after migration to v5.
+    // Synchronous setting should be FULL (2) after migration to v5 and later.
     EXPECT_EQ(2, databaseSyncMode("test/fixtures/offline_database/v5.db"));
 }
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(WriteAheadLog)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    Resource resource { Resource::Style, "http://example.com/" };
+    Response response;
+    response.noContent = true;
+
+    {
+        OfflineDatabase db("test/fixtures/offline_database/offline.db", util::DEFAULT_MAX_CACHE_SIZE,
+                           OfflineDatabase::Mode::ReadWrite, OfflineDatabase::Journal::WriteAhead);
+        db.put(resource, response);
+    }
+
+    EXPECT_EQ("wal", databaseJournalMode("test/fixtures/offline_database/offline.db"));
+    EXPECT_EQ(8, databaseUserVersion("test/fixtures/offline_database/offline.db"));
+
+    // Opening it without the write-ahead log switches it back, and keeps its contents.
+    {
+        OfflineDatabase db("test/fixtures/offline_database/offline.db");
+        EXPECT_TRUE(bool(db.get(resource)));
+    }
+
+    EXPECT_EQ("delete", databaseJournalMode("test/fixtures/offline_database/offline.db"));
+}
+
+TEST(OfflineDatabase, Batch) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+
+    Response response;
+    response.noContent = true;
+
+    db.batch([&] {
+        db.put(Resource::style("http://example.com/1"), response);
+        db.put(Resource::style("http://example.com/2"), response);
+        db.markAccessed(Resource::style("http://example.com/1"));
+    });
+
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1"))));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/2"))));
+
+    // A batch that throws makes none of its writes.
+    EXPECT_THROW(db.batch([&] {
+        db.put(Resource::style("http://example.com/3"), response);
+        throw std::runtime_error("failed");
+    }), std::runtime_error);
+
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/3"))));
+
+    // Writes outside of a batch still commit on their own.
+    db.put(Resource::style("http://example.com/4"), response);
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/4"))));
+}
+
+static std::shared_ptr<const mbgl::Buffer> vectorTile(std::mt19937& random) {
+    static const auto shared = randomString(4096)->toString();
+
+    // Tiles of a tileset share most of their layer names, keys and values.
+    auto result = shared.substr(0, 2048);
+    for (size_t i = 0; i < 256; i++) {
+        result.push_back(random());
+    }
+    result.append(shared.substr(2048));
+    return std::make_shared<mbgl::Buffer>(std::move(result));
+}
+
+TEST(OfflineDatabase, TileCompressionDictionary) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    db.setTileCompression(OfflineDatabase::TileCompression::Dictionary);
+
+    std::mt19937 random;
+    Response response;
+
+    // Tiles are compressed on their own until there are enough of them to train a dictionary.
+    response.data = vectorTile(random);
+    const uint64_t withoutDictionary = db.put(Resource::tile("http://example.com/{z}-{x}-{y}.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ), response).second;
+    for (int32_t x = 1; x < 64; x++) {
+        response.data = vectorTile(random);
+        db.put(Resource::tile("http://example.com/{z}-{x}-{y}.pbf", 1, x, 0, 6, Tileset::Scheme::XYZ), response);
+    }
+
+    response.data = vectorTile(random);
+    const Resource resource = Resource::tile("http://example.com/{z}-{x}-{y}.pbf", 1, 0, 1, 6, Tileset::Scheme::XYZ);
+    const uint64_t withDictionary = db.put(resource, response).second;
+    EXPECT_LT(withDictionary * 4, withoutDictionary);
+
+    auto result = db.get(resource);
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ(*response.data, *result->data);
+
+    // Tiles stored before the dictionary remain readable.
+    EXPECT_TRUE(bool(db.get(Resource::tile("http://example.com/{z}-{x}-{y}.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ))));
+
+    db.setTileCompression(OfflineDatabase::TileCompression::Zlib);
+    response.data = vectorTile(random);
+    EXPECT_LT(withoutDictionary / 2, db.put(Resource::tile("http://example.com/{z}-{x}-{y}.pbf", 1, 0, 2, 6, Tileset::Scheme::XYZ), response).second);
+
+    // Turning dictionaries off keeps the tiles stored with one readable.
+    result = db.get(resource);
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ(256u + 4096u, result->data->size());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ExportImportRegion)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/region.archive");
+
+    const Resource style = Resource::style("http://example.com/style.json");
+    const Resource tile = Resource::tile("http://example.com/{z}-{x}-{y}.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ);
+    const Resource emptyTile = Resource::tile("http://example.com/{z}-{x}-{y}.pbf", 1, 1, 1, 1, Tileset::Scheme::XYZ);
+
+    Response styleResponse;
+    styleResponse.data = std::make_shared<Buffer>(std::string(4096, 's'));
+    styleResponse.etag = "\"etag\""s;
+    styleResponse.expires = Timestamp(Seconds(1500000000));
+    Response tileResponse;
+    tileResponse.data = randomString(1024);
+    Response emptyResponse;
+    emptyResponse.noContent = true;
+
+    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, 1, 1.0 };
+    const OfflineRegionMetadata metadata { 1, 2, 3 };
+
+    {
+        OfflineDatabase db(":memory:");
+        OfflineRegion region = db.createRegion(definition, metadata);
+        db.putRegionResource(region.getID(), style, styleResponse);
+        db.putRegionResource(region.getID(), tile, tileResponse);
+        db.putRegionResource(region.getID(), emptyTile, emptyResponse);
+
+        // Resources of the ambient cache aren't part of the region.
+        db.put(Resource::style("http://example.com/other.json"), styleResponse);
+
+        db.exportRegion(region.getID(), "test/fixtures/offline_database/region.archive");
+        EXPECT_THROW(db.exportRegion(region.getID() + 1, "test/fixtures/offline_database/other.archive"), std::runtime_error);
+    }
+
+    OfflineDatabase db(":memory:");
+    OfflineRegion region = db.importRegion("test/fixtures/offline_database/region.archive");
+    EXPECT_EQ(definition.styleURL, region.getDefinition().styleURL);
+    EXPECT_EQ(definition.maxZoom, region.getDefinition().maxZoom);
+    EXPECT_EQ(metadata, region.getMetadata());
+
+    OfflineRegionStatus status = db.getRegionCompletedStatus(region.getID());
+    EXPECT_EQ(3u, status.completedResourceCount);
+    EXPECT_EQ(2u, status.completedTileCount);
+
+    auto result = db.get(style);
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ(*styleResponse.data, *result->data);
+    EXPECT_EQ(styleResponse.etag, result->etag);
+    EXPECT_EQ(styleResponse.expires, result->expires);
+
+    result = db.get(tile);
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ(*tileResponse.data, *result->data);
+
+    result = db.get(emptyTile);
+    ASSERT_TRUE(bool(result));
+    EXPECT_TRUE(result->noContent);
+
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/other.json"))));
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ImportRegionIsAtomic)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/region.archive");
+
+    const Resource style = Resource::style("http://example.com/style.json");
+    const Resource tile = Resource::tile("mapbox://{z}-{x}-{y}.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ);
+    Response response;
+    response.data = randomString(1024);
+
+    {
+        OfflineDatabase db(":memory:");
+        OfflineRegion region = db.createRegion({ "", LatLngBounds::world(), 0, 1, 1.0 }, {});
+        db.putRegionResource(region.getID(), style, response);
+        db.putRegionResource(region.getID(), tile, response);
+        db.exportRegion(region.getID(), "test/fixtures/offline_database/region.archive");
+    }
+
+    // An archive that is cut short imports nothing.
+    const std::string archive = util::read_file("test/fixtures/offline_database/region.archive");
+    writeFile("test/fixtures/offline_database/region.archive", archive.substr(0, archive.size() - 1));
+
+    OfflineDatabase db(":memory:");
+    EXPECT_THROW(db.importRegion("test/fixtures/offline_database/region.archive"), std::runtime_error);
+    EXPECT_TRUE(db.listRegions().empty());
+    EXPECT_FALSE(bool(db.get(style)));
+
+    writeFile("test/fixtures/offline_database/region.archive", "not an archive");
+    EXPECT_THROW(db.importRegion("test/fixtures/offline_database/region.archive"), std::runtime_error);
+
+    // Neither does one that exceeds the Mapbox tile count limit.
+    writeFile("test/fixtures/offline_database/region.archive", archive);
+    db.setOfflineMapboxTileCountLimit(0);
+    EXPECT_THROW(db.importRegion("test/fixtures/offline_database/region.archive"), std::runtime_error);
+    EXPECT_TRUE(db.listRegions().empty());
+    EXPECT_EQ(0u, db.getOfflineMapboxTileCount());
+
+    db.setOfflineMapboxTileCountLimit(1);
+    db.importRegion("test/fixtures/offline_database/region.archive");
+    EXPECT_EQ(1u, db.listRegions().size());
+    EXPECT_EQ(1u, db.getOfflineMapboxTileCount());
+}
@@ -50,9 +50,9 @@ public:
 
     Response response(const std::string& path) {
         Response result;
-        result.data = std::make_shared<std::string>(util::read_file("test/fixtures/offline_download/"s + path));
+        result.data = std::make_shared<Buffer>(util::read_file("test/fixtures/offline_download/"s + path));
         size_t uncompressed = result.data->size();
-        size_t compressed = util::compress(*result.data).size();
+        size_t compressed = util::compress(result.data->data(), result.data->size()).size();
         size += std::min(uncompressed, compressed);
         return result;
     }
@@ -265,6 +265,115 @@ TEST(OfflineDownload, DoesNotFloodTheFileSourceWithRequests) {
     EXPECT_EQ(HTTPFileSource::maximumConcurrentRequests(), fileSource.requests.size());
 }
 
+TEST(OfflineDownload, ErrorsReduceConcurrency) {
+    FakeFileSource fileSource;
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 0.0, 1.0),
+        test.db, fileSource);
+
+    download.setObserver(std::make_unique<MockObserver>());
+    download.setState(OfflineRegionDownloadState::Active);
+    test.loop.runOnce();
+
+    fileSource.respond(Resource::Kind::Style, test.response("style.json"));
+    test.loop.runOnce();
+
+    const std::size_t maximum = HTTPFileSource::maximumConcurrentRequests();
+    ASSERT_EQ(maximum, fileSource.requests.size());
+
+    // The failed request stays in flight to be retried, and no other takes its place.
+    Response error;
+    error.error = std::make_unique<Response::Error>(Response::Error::Reason::Connection, "connection error");
+    fileSource.respond(Resource::Kind::Glyphs, error);
+    EXPECT_EQ(maximum, fileSource.requests.size());
+
+    // Half as many requests are made from now on.
+    for (std::size_t i = 0; i < maximum / 2; i++) {
+        fileSource.respond(Resource::Kind::Glyphs, test.response("glyph.pbf"));
+    }
+    EXPECT_EQ(maximum - maximum / 2, fileSource.requests.size());
+
+    fileSource.respond(Resource::Kind::Glyphs, test.response("glyph.pbf"));
+    EXPECT_EQ(maximum - maximum / 2, fileSource.requests.size());
+}
+
+TEST(OfflineDownload, LatencyReducesConcurrency) {
+    FakeFileSource fileSource;
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 0.0, 1.0),
+        test.db, fileSource);
+
+    download.setObserver(std::make_unique<MockObserver>());
+    download.setState(OfflineRegionDownloadState::Active);
+    test.loop.runOnce();
+
+    fileSource.respond(Resource::Kind::Style, test.response("style.json"));
+    test.loop.runOnce();
+
+    const std::size_t maximum = HTTPFileSource::maximumConcurrentRequests();
+    ASSERT_EQ(maximum, fileSource.requests.size());
+
+    auto respond = [&] (Milliseconds latency) {
+        Response response = test.response("glyph.pbf");
+        auto timing = std::make_unique<Response::Timing>();
+        timing->queued = timing->started = Clock::now();
+        timing->finished = timing->started + latency;
+        response.timing = std::move(timing);
+        fileSource.respond(Resource::Kind::Glyphs, response);
+    };
+
+    // Responses as fast as the fastest one are replaced by another request...
+    respond(Milliseconds(10));
+    EXPECT_EQ(maximum, fileSource.requests.size());
+
+    // ...but once latency grows, fewer requests are made.
+    respond(Milliseconds(100));
+    EXPECT_EQ(maximum - 1, fileSource.requests.size());
+}
+
+TEST(OfflineDownload, DownloadRate) {
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 0.0, 1.0),
+        test.db, test.fileSource);
+
+    test.fileSource.styleResponse = [&] (const Resource&) {
+        return test.response("inline_source.style.json");
+    };
+
+    test.fileSource.tileResponse = [&] (const Resource&) {
+        return test.response("0-0-0.vector.pbf");
+    };
+
+    auto observer = std::make_unique<MockObserver>();
+    observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+        if (status.complete() && status.downloadState == OfflineRegionDownloadState::Active) {
+            EXPECT_LT(0, status.downloadRate);
+            ASSERT_TRUE(bool(status.estimatedTimeRemaining));
+            EXPECT_EQ(Duration::zero(), *status.estimatedTimeRemaining);
+            test.loop.stop();
+        }
+    };
+
+    download.setObserver(std::move(observer));
+    download.setState(OfflineRegionDownloadState::Active);
+
+    test.loop.run();
+
+    // An inactive download isn't downloading anything.
+    download.setState(OfflineRegionDownloadState::Inactive);
+    EXPECT_EQ(0, download.getStatus().downloadRate);
+    EXPECT_FALSE(bool(download.getStatus().estimatedTimeRemaining));
+}
+
 TEST(OfflineDownload, GetStatusNoResources) {
     OfflineTest test;
     OfflineRegion region = test.createRegion();
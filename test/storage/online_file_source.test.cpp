@@ -1,5 +1,6 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/storage/online_file_source.hpp>
+#include <mbgl/storage/http_file_source.hpp>
 #include <mbgl/storage/network_status.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/run_loop.hpp>
@@ -8,6 +9,9 @@
 
 #include <gtest/gtest.h>
 
+#include <map>
+#include <vector>
+
 using namespace mbgl;
 
 TEST(OnlineFileSource, Cancel) {
@@ -220,6 +224,36 @@ TEST(OnlineFileSource, TEST_REQUIRES_SERVER(RespectPriorExpires)) {
     loop.run();
 }
 
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(RefreshExpiredTogether)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    // Both expire within the refresh window of the first, so they're refreshed together.
+    Resource resource1{ Resource::Unknown, "http://127.0.0.1:3000/test" };
+    resource1.priorExpires = util::now() + Seconds(1);
+    Resource resource2{ Resource::Unknown, "http://127.0.0.1:3000/test" };
+    resource2.priorExpires = util::now() + Seconds(2);
+
+    const auto start = Clock::now();
+    std::vector<TimePoint> refreshed;
+    const auto callback = [&](Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        refreshed.push_back(Clock::now());
+        if (refreshed.size() == 2) {
+            loop.stop();
+        }
+    };
+
+    std::unique_ptr<AsyncRequest> req1 = fs.request(resource1, callback);
+    std::unique_ptr<AsyncRequest> req2 = fs.request(resource2, callback);
+
+    loop.run();
+
+    ASSERT_EQ(2u, refreshed.size());
+    EXPECT_LE(Seconds(2), refreshed[0] - start);
+    EXPECT_GT(Milliseconds(500), refreshed[1] - refreshed[0]);
+}
+
 TEST(OnlineFileSource, TEST_REQUIRES_SERVER(Load)) {
     util::RunLoop loop;
     OnlineFileSource fs;
@@ -264,6 +298,44 @@ TEST(OnlineFileSource, TEST_REQUIRES_SERVER(Load)) {
 // trigger an immediate retry of all requests that are not in progress. This test makes sure that
 // we don't accidentally double-trigger the request.
 
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(Priority)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    // Take up all room for active requests, so that the following ones have to wait.
+    std::vector<std::unique_ptr<AsyncRequest>> delayed;
+    for (uint32_t i = 0; i < HTTPFileSource::maximumConcurrentRequests(); i++) {
+        delayed.push_back(fs.request({ Resource::Unknown, "http://127.0.0.1:3000/delayed" }, [](Response) {}));
+    }
+
+    std::map<std::string, TimePoint> started;
+    auto request = [&](const std::string& name, int32_t priority) {
+        Resource resource { Resource::Unknown, "http://127.0.0.1:3000/test" };
+        resource.priority = priority;
+        return fs.request(resource, [&, name](Response res) {
+            ASSERT_TRUE(res.timing.get());
+            started[name] = res.timing->started;
+            if (started.size() == 3) {
+                loop.stop();
+            }
+        });
+    };
+
+    auto low = request("low", -10);
+    auto raised = request("raised", -20);
+    auto high = request("high", 10);
+    auto cancelled = request("cancelled", 20);
+
+    raised->setPriority(20);
+    cancelled.reset();
+
+    loop.run();
+
+    EXPECT_LE(started["raised"], started["high"]);
+    EXPECT_LE(started["high"], started["low"]);
+    EXPECT_EQ(0u, started.count("cancelled"));
+}
+
 TEST(OnlineFileSource, TEST_REQUIRES_SERVER(NetworkStatusChange)) {
     util::RunLoop loop;
     OnlineFileSource fs;
@@ -361,6 +433,28 @@ TEST(OnlineFileSource, TEST_REQUIRES_SERVER(NetworkStatusOnlineOffline)) {
     loop.run();
 }
 
+TEST(OnlineFileSource, NetworkStatusThroughput) {
+    NetworkStatus::SetThroughput(0);
+    EXPECT_EQ(0, NetworkStatus::GetThroughput());
+    EXPECT_FALSE(NetworkStatus::IsSlow()) << "An unknown throughput isn't slow";
+
+    // Too small to tell the throughput from the latency.
+    NetworkStatus::RecordTransfer(1024, Milliseconds(1000));
+    EXPECT_EQ(0, NetworkStatus::GetThroughput());
+
+    // The first transfer sets the estimate, and later ones move it towards theirs.
+    NetworkStatus::RecordTransfer(32 * 1024, Milliseconds(1000));
+    EXPECT_DOUBLE_EQ(32 * 1024, NetworkStatus::GetThroughput());
+    EXPECT_TRUE(NetworkStatus::IsSlow());
+
+    NetworkStatus::RecordTransfer(1024 * 1024, Milliseconds(1000));
+    EXPECT_GT(NetworkStatus::GetThroughput(), 32 * 1024);
+    EXPECT_LT(NetworkStatus::GetThroughput(), 1024 * 1024);
+    EXPECT_FALSE(NetworkStatus::IsSlow());
+
+    NetworkStatus::SetThroughput(0);
+}
+
 TEST(OnlineFileSource, TEST_REQUIRES_SERVER(RateLimitStandard)) {
     util::RunLoop loop;
     OnlineFileSource fs;
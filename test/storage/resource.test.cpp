@@ -103,6 +103,25 @@ TEST(Resource, Tile) {
     EXPECT_EQ(3, tmsTile.tileData->z);
 }
 
+TEST(Resource, TileURLTemplate) {
+    using namespace mbgl;
+
+    const TileURLTemplate urlTemplate("http://{prefix}.example.com/{z}/{x}/{y}{ratio}{unknown}.png?a={b");
+    EXPECT_TRUE(urlTemplate.hasRatio());
+    EXPECT_EQ("http://12.example.com/3/1/2@2x.png?a={b", urlTemplate.url(2.0, 1, 2, 3));
+    EXPECT_EQ("http://98.example.com/14/8185/12008.png?a={b", urlTemplate.url(1.0, 8185, 12008, 14));
+
+    Resource tile = Resource::tile(urlTemplate, 2.0, 1, 2, 3, Tileset::Scheme::TMS);
+    EXPECT_EQ("http://15.example.com/3/1/5@2x.png?a={b", tile.url);
+    EXPECT_EQ(urlTemplate.getSource(), tile.tileData->urlTemplate);
+    EXPECT_EQ(2, tile.tileData->pixelRatio);
+    EXPECT_EQ(5, tile.tileData->y);
+
+    const TileURLTemplate literal("http://example.com/{{z}/tile");
+    EXPECT_FALSE(literal.hasRatio());
+    EXPECT_EQ("http://example.com/{3/tile", literal.url(2.0, 1, 2, 3));
+}
+
 TEST(Resource, Glyphs) {
     using namespace mbgl;
     Resource resource = Resource::glyphs("http://example.com/{fontstack}/{range}", {{"stack"}}, {0, 255});
@@ -0,0 +1,105 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response_cache.hpp>
+#include <mbgl/util/buffer.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+Response response(const std::string& data) {
+    Response result;
+    result.data = std::make_shared<Buffer>(data);
+    result.expires = util::now() + Seconds(60);
+    result.etag = std::string("a");
+    return result;
+}
+
+} // namespace
+
+TEST(ResponseCache, PutGet) {
+    ResponseCache cache(1024);
+    const Resource style = Resource::style("http://example.com/style.json");
+    EXPECT_FALSE(cache.get(style));
+
+    Response stored = response("style");
+    stored.timing = std::make_unique<Response::Timing>();
+    cache.put(style, stored);
+
+    auto held = cache.get(style);
+    ASSERT_TRUE(bool(held));
+    EXPECT_EQ(stored.data, held->data);
+    EXPECT_EQ(stored.expires, held->expires);
+    EXPECT_EQ(stored.etag, held->etag);
+    EXPECT_FALSE(held->timing);
+
+    // Tiles are told apart by their coordinates, not by their URL.
+    const Resource tile = Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1, 0, 0, 0, Tileset::Scheme::XYZ);
+    cache.put(tile, response("tile"));
+    EXPECT_EQ(std::string("tile"), *cache.get(tile)->data);
+    EXPECT_FALSE(cache.get(Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1, 1, 0, 1, Tileset::Scheme::XYZ)));
+
+    cache.remove(style);
+    EXPECT_FALSE(cache.get(style));
+    cache.clear();
+    EXPECT_FALSE(cache.get(tile));
+    EXPECT_EQ(0u, cache.getBytes());
+}
+
+TEST(ResponseCache, NotModified) {
+    ResponseCache cache(1024);
+    const Resource style = Resource::style("http://example.com/style.json");
+
+    // Errors aren't held, and Not Modified responses only refresh a response that is.
+    Response error;
+    error.error = std::make_unique<Response::Error>(Response::Error::Reason::Server);
+    cache.put(style, error);
+    EXPECT_FALSE(cache.get(style));
+
+    Response notModified;
+    notModified.notModified = true;
+    notModified.expires = util::now() + Seconds(120);
+    notModified.etag = std::string("b");
+    cache.put(style, notModified);
+    EXPECT_FALSE(cache.get(style));
+
+    cache.put(style, response("style"));
+    cache.put(style, notModified);
+    auto held = cache.get(style);
+    ASSERT_TRUE(bool(held));
+    EXPECT_FALSE(held->notModified);
+    EXPECT_EQ(std::string("style"), *held->data);
+    EXPECT_EQ(notModified.expires, held->expires);
+    EXPECT_EQ(std::string("b"), *held->etag);
+}
+
+TEST(ResponseCache, Evict) {
+    const Resource a = Resource::source("a");
+    const Resource b = Resource::source("b");
+    const Resource c = Resource::source("c");
+
+    // Each response takes 50 bytes with its key.
+    ResponseCache cache(200);
+    cache.put(a, response(std::string(49, 'a')));
+    cache.put(b, response(std::string(49, 'b')));
+    cache.put(c, response(std::string(49, 'c')));
+    EXPECT_EQ(150u, cache.getBytes());
+
+    // Too large for a quarter of the cache.
+    cache.put(Resource::source("d"), response(std::string(100, 'd')));
+    EXPECT_FALSE(cache.get(Resource::source("d")));
+
+    // The least recently used response goes first.
+    EXPECT_TRUE(bool(cache.get(a)));
+    cache.setMaximumBytes(100);
+    EXPECT_TRUE(bool(cache.get(a)));
+    EXPECT_FALSE(cache.get(b));
+    EXPECT_TRUE(bool(cache.get(c)));
+    EXPECT_EQ(100u, cache.getBytes());
+
+    cache.setMaximumBytes(0);
+    EXPECT_EQ(0u, cache.getBytes());
+    cache.put(a, response("a"));
+    EXPECT_FALSE(cache.get(a));
+}
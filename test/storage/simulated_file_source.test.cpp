@@ -0,0 +1,173 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/simulated_file_source.hpp>
+#include <mbgl/test/stub_file_source.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+void respondWith(StubFileSource& stub, std::size_t size) {
+    stub.response = [size] (const Resource&) {
+        Response response;
+        response.data = std::make_shared<Buffer>(std::string(size, 'x'));
+        return optional<Response>(response);
+    };
+}
+
+} // namespace
+
+TEST(SimulatedFileSource, Latency) {
+    util::RunLoop loop;
+    StubFileSource stub;
+    respondWith(stub, 16);
+
+    SimulatedFileSource::Conditions conditions;
+    conditions.latency = Milliseconds(50);
+    SimulatedFileSource fs(stub, conditions);
+
+    const auto start = Clock::now();
+    auto req = fs.request({ Resource::Unknown, "test" }, [&](Response res) {
+        EXPECT_GE(Clock::now() - start, Milliseconds(50));
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ(16u, res.data->size());
+        loop.stop();
+    });
+
+    loop.run();
+
+    EXPECT_EQ(1u, fs.getStats().requests);
+    EXPECT_EQ(16u, fs.getStats().bytes);
+}
+
+TEST(SimulatedFileSource, Bandwidth) {
+    util::RunLoop loop;
+    StubFileSource stub;
+    respondWith(stub, 10000);
+
+    // Two responses share the link, so the second one arrives after both have been sent.
+    SimulatedFileSource::Conditions conditions;
+    conditions.bandwidth = 100000;
+    SimulatedFileSource fs(stub, conditions);
+
+    const auto start = Clock::now();
+    int answered = 0;
+    auto callback = [&](Response) {
+        if (++answered == 2) {
+            EXPECT_GE(Clock::now() - start, Milliseconds(200));
+            loop.stop();
+        }
+    };
+    auto req1 = fs.request({ Resource::Unknown, "a" }, callback);
+    auto req2 = fs.request({ Resource::Unknown, "b" }, callback);
+
+    loop.run();
+
+    EXPECT_EQ(20000u, fs.getStats().bytes);
+}
+
+TEST(SimulatedFileSource, Concurrency) {
+    util::RunLoop loop;
+    StubFileSource stub;
+    respondWith(stub, 16);
+
+    SimulatedFileSource::Conditions conditions;
+    conditions.latency = Milliseconds(5);
+    conditions.concurrency = 1;
+    SimulatedFileSource fs(stub, conditions);
+
+    // The first request takes the only connection; the others get it highest priority first.
+    std::vector<std::string> order;
+    std::vector<std::unique_ptr<AsyncRequest>> requests;
+    for (const auto& url : { "a", "b", "c", "d" }) {
+        Resource resource { Resource::Unknown, url };
+        resource.priority = std::string(url) == "c" ? 1 : 0;
+        requests.push_back(fs.request(resource, [&, url](Response) {
+            order.push_back(url);
+            if (order.size() == 4) {
+                loop.stop();
+            }
+        }));
+    }
+
+    loop.run();
+
+    EXPECT_EQ((std::vector<std::string> { "a", "c", "b", "d" }), order);
+    EXPECT_EQ(3u, fs.getStats().maxWaiting);
+}
+
+TEST(SimulatedFileSource, Failures) {
+    // Returns which of the requests failed.
+    auto run = [] (uint32_t seed) {
+        util::RunLoop loop;
+        StubFileSource stub;
+        respondWith(stub, 16);
+
+        SimulatedFileSource::Conditions conditions;
+        conditions.failureRate = 0.5;
+        SimulatedFileSource fs(stub, conditions, seed);
+
+        const std::size_t count = 20;
+        std::vector<bool> failed(count);
+        std::size_t answered = 0;
+        std::vector<std::unique_ptr<AsyncRequest>> requests;
+        for (std::size_t i = 0; i < count; i++) {
+            requests.push_back(fs.request({ Resource::Unknown, std::to_string(i) }, [&, i](Response res) {
+                failed[i] = bool(res.error);
+                if (res.error) {
+                    EXPECT_EQ(Response::Error::Reason::Connection, res.error->reason);
+                }
+                if (++answered == count) {
+                    loop.stop();
+                }
+            }));
+        }
+
+        loop.run();
+
+        EXPECT_EQ(std::size_t(std::count(failed.begin(), failed.end(), true)), fs.getStats().failures);
+        return failed;
+    };
+
+    const std::vector<bool> failed = run(1);
+    EXPECT_EQ(failed, run(1));
+    EXPECT_NE(failed, run(2));
+
+    const auto failures = std::count(failed.begin(), failed.end(), true);
+    EXPECT_LT(0, failures);
+    EXPECT_GT(20, failures);
+}
+
+TEST(SimulatedFileSource, Cancel) {
+    util::RunLoop loop;
+    StubFileSource stub;
+    respondWith(stub, 16);
+
+    SimulatedFileSource::Conditions conditions;
+    conditions.latency = Milliseconds(5);
+    conditions.concurrency = 1;
+    SimulatedFileSource fs(stub, conditions);
+
+    // Cancelling the request that has the connection passes it on to the one that waits.
+    auto req1 = fs.request({ Resource::Unknown, "a" }, [&](Response) {
+        ADD_FAILURE() << "Callback should not be called";
+    });
+    auto req2 = fs.request({ Resource::Unknown, "b" }, [&](Response) {
+        loop.stop();
+    });
+    req1.reset();
+
+    loop.run();
+
+    EXPECT_EQ(2u, fs.getStats().requests);
+    EXPECT_EQ(1u, fs.getStats().cancellations);
+}
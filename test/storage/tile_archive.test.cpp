@@ -0,0 +1,39 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/tile_archive.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/buffer.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+void checkTiles(TileArchive& archive) {
+    EXPECT_EQ(std::string("tile 0/0/0"), *archive.get({ 0, 0, 0 }));
+    EXPECT_EQ(std::string("tile 1/0/y"), *archive.get({ 1, 0, 0 }));
+    EXPECT_EQ(std::string("tile 1/0/y"), *archive.get({ 1, 0, 1 }));
+    EXPECT_EQ(std::string("tile 1/1/1"), *archive.get({ 1, 1, 1 }));
+
+    EXPECT_FALSE(archive.get({ 1, 1, 0 }));
+    EXPECT_FALSE(archive.get({ 2, 0, 0 }));
+    EXPECT_FALSE(archive.get({ 14, 8192, 8192 }));
+}
+
+} // namespace
+
+TEST(TileArchive, MBTiles) {
+    auto archive = TileArchive::open("test/fixtures/storage/archive/tiles.mbtiles");
+    checkTiles(*archive);
+}
+
+TEST(TileArchive, PMTiles) {
+    // Has the tiles of zoom level 1 in a leaf directory, and one entry for two tiles.
+    auto archive = TileArchive::open("test/fixtures/storage/archive/tiles.pmtiles");
+    checkTiles(*archive);
+}
+
+TEST(TileArchive, NotAnArchive) {
+    EXPECT_ANY_THROW(TileArchive::open("test/fixtures/storage/assets/nonempty"));
+    EXPECT_ANY_THROW(TileArchive::open("test/fixtures/storage/archive/does_not_exist"));
+    EXPECT_ANY_THROW(TileArchive::open("test/fixtures/storage/archive"));
+}
@@ -0,0 +1,115 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/binary_style.hpp>
+#include <mbgl/style/binary_style_conversion.hpp>
+#include <mbgl/style/parser.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+const std::string json = R"STYLE({
+  "version": 8,
+  "name": "binary",
+  "center": [ -77.0369, 38.8951 ],
+  "zoom": 12.5,
+  "sources": {
+    "source": { "type": "vector", "tiles": [ "http://example.com/{z}/{x}/{y}.pbf" ] }
+  },
+  "layers": [{
+    "id": "line",
+    "type": "line",
+    "source": "source",
+    "source-layer": "roads",
+    "filter": [ "==", "class", "motorway" ],
+    "paint": {
+      "line-width": { "stops": [ [ 10, 1 ], [ 15, 4 ] ] },
+      "line-color": "#f00"
+    }
+  }, {
+    "id": "ref",
+    "ref": "line",
+    "paint": { "line-opacity": 0.5 }
+  }]
+})STYLE";
+
+} // namespace
+
+TEST(BinaryStyle, Values) {
+    const std::string binary = encodeBinaryStyle(R"JSON({
+      "null": null, "bool": true, "uint": 3, "int": -3, "double": 0.5,
+      "string": "string", "array": [ 1, [ 2 ], { "a": 3 } ]
+    })JSON");
+    const BinaryStyleValue root = decodeBinaryStyle(binary);
+
+    ASSERT_TRUE(conversion::isObject(root));
+    EXPECT_TRUE(conversion::isUndefined(*conversion::objectMember(root, "null")));
+    EXPECT_EQ(true, *conversion::toBool(*conversion::objectMember(root, "bool")));
+    EXPECT_EQ(Value(uint64_t(3)), *conversion::toValue(*conversion::objectMember(root, "uint")));
+    EXPECT_EQ(Value(int64_t(-3)), *conversion::toValue(*conversion::objectMember(root, "int")));
+    EXPECT_EQ(0.5f, *conversion::toNumber(*conversion::objectMember(root, "double")));
+    EXPECT_EQ(std::string("string"), *conversion::toString(*conversion::objectMember(root, "string")));
+    EXPECT_FALSE(conversion::objectMember(root, "missing"));
+
+    auto array = conversion::objectMember(root, "array");
+    ASSERT_TRUE(conversion::isArray(*array));
+    ASSERT_EQ(3u, conversion::arrayLength(*array));
+    EXPECT_EQ(1.0f, *conversion::toNumber(conversion::arrayMember(*array, 0)));
+    EXPECT_EQ(2.0f, *conversion::toNumber(conversion::arrayMember(conversion::arrayMember(*array, 1), 0)));
+    EXPECT_EQ(3.0f, *conversion::toNumber(*conversion::objectMember(conversion::arrayMember(*array, 2), "a")));
+
+    std::vector<std::string> keys;
+    conversion::eachMember(root, [&] (const std::string& key, const BinaryStyleValue&) -> optional<conversion::Error> {
+        keys.push_back(key);
+        return {};
+    });
+    EXPECT_EQ(std::vector<std::string>({ "null", "bool", "uint", "int", "double", "string", "array" }), keys);
+}
+
+TEST(BinaryStyle, Parse) {
+    Parser jsonParser;
+    ASSERT_FALSE(jsonParser.parse(json));
+
+    Parser binaryParser;
+    ASSERT_FALSE(binaryParser.parseBinary(encodeBinaryStyle(json)));
+
+    EXPECT_EQ(jsonParser.name, binaryParser.name);
+    EXPECT_EQ(jsonParser.latLng, binaryParser.latLng);
+    EXPECT_EQ(jsonParser.zoom, binaryParser.zoom);
+    EXPECT_EQ(jsonParser.layerSources, binaryParser.layerSources);
+
+    ASSERT_EQ(1u, binaryParser.sources.size());
+    EXPECT_EQ("source", binaryParser.sources[0]->getID());
+
+    ASSERT_EQ(2u, binaryParser.layers.size());
+    for (std::size_t i = 0; i < binaryParser.layers.size(); i++) {
+        const auto* expected = jsonParser.layers[i]->as<LineLayer>();
+        const auto* actual = binaryParser.layers[i]->as<LineLayer>();
+        ASSERT_TRUE(actual);
+        EXPECT_EQ(expected->getID(), actual->getID());
+        EXPECT_EQ(expected->getFilter(), actual->getFilter());
+        EXPECT_EQ(expected->getLineWidth(), actual->getLineWidth());
+        EXPECT_EQ(expected->getLineColor(), actual->getLineColor());
+        EXPECT_EQ(expected->getLineOpacity(), actual->getLineOpacity());
+    }
+}
+
+TEST(BinaryStyle, Errors) {
+    EXPECT_THROW(encodeBinaryStyle("{"), std::runtime_error);
+
+    Parser parser;
+    EXPECT_TRUE(parser.parseBinary(json));
+
+    const std::string binary = encodeBinaryStyle(json);
+    EXPECT_TRUE(parser.parseBinary(binary.substr(0, binary.size() - 1)));
+
+    // The end of the root object, which follows the header and the root's type.
+    std::string corrupt = binary;
+    corrupt[9] = char(0xFF);
+    EXPECT_TRUE(parser.parseBinary(corrupt));
+
+    EXPECT_TRUE(parser.sources.empty());
+    EXPECT_TRUE(parser.layers.empty());
+}
@@ -0,0 +1,125 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/sources/cluster_index.hpp>
+#include <mbgl/util/feature.hpp>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+Feature point(double lng, double lat, uint64_t id) {
+    Feature feature { mapbox::geometry::point<double> { lng, lat } };
+    feature.id = { id };
+    feature.properties["name"] = std::string("point ") + std::to_string(id);
+    return feature;
+}
+
+ClusterIndex::Options options() {
+    ClusterIndex::Options result;
+    result.maxZoom = 4;
+    return result;
+}
+
+} // namespace
+
+TEST(ClusterIndex, Levels) {
+    ClusterIndex index(std::make_shared<FeatureCollection>(FeatureCollection { point(0, 0, 1) }), options());
+
+    EXPECT_EQ(index.levelCount(), 6u);
+    EXPECT_EQ(index.levelOf(3), 3u);
+    EXPECT_EQ(index.levelOf(5), 5u);
+    EXPECT_EQ(index.levelOf(18), 5u);
+
+    // The level of the points is built with the index, and each of the others on its own.
+    EXPECT_TRUE(index.isBuilt(5));
+    EXPECT_FALSE(index.isBuilt(2));
+    index.buildLevel(2);
+    EXPECT_TRUE(index.isBuilt(2));
+    EXPECT_FALSE(index.isBuilt(1));
+    EXPECT_FALSE(index.isBuilt(3));
+    EXPECT_EQ(index.getTile(2, 2, 2).size(), 1u);
+}
+
+TEST(ClusterIndex, Clusters) {
+    ClusterIndex index(std::make_shared<FeatureCollection>(FeatureCollection {
+        point(0, 0, 1), point(0.1, 0.1, 2), point(90, 45, 3)
+    }), options());
+    index.buildLevel(0);
+
+    auto tile = index.getTile(0, 0, 0);
+    ASSERT_EQ(tile.size(), 2u);
+    EXPECT_EQ(tile[0].properties["cluster"], mapbox::geometry::value(true));
+    EXPECT_EQ(tile[0].properties["point_count"], mapbox::geometry::value(uint64_t(2)));
+    EXPECT_EQ(tile[0].properties["point_count_abbreviated"], mapbox::geometry::value(std::string("2")));
+    EXPECT_FALSE(bool(tile[0].id));
+    EXPECT_EQ(tile[0].geometry, mapbox::geometry::geometry<int16_t>(mapbox::geometry::point<int16_t>(256, 256)));
+    EXPECT_EQ(tile[1].id, FeatureIdentifier(uint64_t(3)));
+    EXPECT_EQ(tile[1].properties["name"], mapbox::geometry::value(std::string("point 3")));
+
+    // Above the highest clustered zoom level, tiles have the points themselves.
+    tile = index.getTile(6, 32, 31);
+    ASSERT_EQ(tile.size(), 2u);
+    EXPECT_EQ(tile[0].properties.count("cluster"), 0u);
+    EXPECT_EQ(tile[1].properties.count("cluster"), 0u);
+}
+
+TEST(ClusterIndex, AbbreviatedCount) {
+    auto features = std::make_shared<FeatureCollection>();
+    for (uint64_t id = 0; id < 1450; id++) {
+        features->push_back(point(10, 10, id));
+    }
+    ClusterIndex index(features, options());
+    index.buildLevel(0);
+
+    auto tile = index.getTile(0, 0, 0);
+    ASSERT_EQ(tile.size(), 1u);
+    EXPECT_EQ(tile[0].properties["point_count"], mapbox::geometry::value(uint64_t(1450)));
+    EXPECT_EQ(tile[0].properties["point_count_abbreviated"], mapbox::geometry::value(std::string("1.5k")));
+}
+
+TEST(ClusterIndex, WrapsTileBuffers) {
+    ClusterIndex index(std::make_shared<FeatureCollection>(FeatureCollection { point(179.9, 0, 1) }), options());
+    index.buildLevel(1);
+
+    // The point is in the eastern tile, and in the buffer of the western one.
+    auto tile = index.getTile(1, 0, 0);
+    ASSERT_EQ(tile.size(), 1u);
+    EXPECT_EQ(tile[0].geometry, mapbox::geometry::geometry<int16_t>(mapbox::geometry::point<int16_t>(0, 512)));
+    tile = index.getTile(1, 1, 0);
+    ASSERT_EQ(tile.size(), 1u);
+    EXPECT_EQ(tile[0].geometry, mapbox::geometry::geometry<int16_t>(mapbox::geometry::point<int16_t>(512, 512)));
+}
+
+TEST(ClusterIndex, ConcurrentLevels) {
+    auto features = std::make_shared<FeatureCollection>();
+    for (uint64_t id = 0; id < 5000; id++) {
+        features->push_back(point(-50 + (id % 100) * 0.7, -30 + (id / 100) * 1.3, id));
+    }
+
+    ClusterIndex sequential(features, options());
+    ClusterIndex concurrent(features, options());
+    std::vector<std::thread> threads;
+    for (uint8_t level = 0; level < concurrent.levelCount(); level++) {
+        sequential.buildLevel(level);
+        threads.emplace_back([&, level] { concurrent.buildLevel(level); });
+        threads.emplace_back([&, level] { concurrent.buildLevel(level); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (uint8_t z = 0; z <= 6; z++) {
+        const uint32_t tiles = 1u << z;
+        for (uint32_t x = 0; x < tiles; x++) {
+            for (uint32_t y = 0; y < tiles; y++) {
+                ASSERT_EQ(sequential.getTile(z, x, y), concurrent.getTile(z, x, y));
+            }
+        }
+    }
+}
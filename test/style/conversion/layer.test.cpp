@@ -4,6 +4,8 @@
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion/layer.hpp>
 #include <mbgl/style/layers/background_layer_impl.hpp>
+#include <mbgl/style/layers/heatmap_layer_impl.hpp>
+#include <mbgl/style/layers/hillshade_layer.hpp>
 #include <mbgl/util/rapidjson.hpp>
 
 using namespace mbgl;
@@ -45,3 +47,44 @@ TEST(StyleConversion, LayerTransition) {
     ASSERT_FALSE(bool(layer->as<BackgroundLayer>()->impl->paint.cascading
         .get<BackgroundColor>().getTransition({"class"}).delay));
 }
+
+TEST(StyleConversion, HeatmapLayer) {
+    auto layer = parseLayer(R"JSON({
+        "type": "heatmap",
+        "id": "heatmap",
+        "source": "points",
+        "paint": {
+            "heatmap-radius": 20,
+            "heatmap-weight": { "property": "magnitude", "stops": [[0, 0], [10, 1]] },
+            "heatmap-color": { "stops": [[0, "rgba(0, 0, 0, 0)"], [1, "red"]] }
+        }
+    })JSON");
+
+    ASSERT_TRUE(layer->is<HeatmapLayer>());
+    const HeatmapLayer& heatmap = *layer->as<HeatmapLayer>();
+    EXPECT_EQ("points", heatmap.getSourceID());
+    EXPECT_EQ(20.0f, heatmap.getHeatmapRadius());
+    EXPECT_TRUE(heatmap.getHeatmapWeight().isDataDriven());
+    EXPECT_EQ(2u, heatmap.getHeatmapColor().stops.size());
+    EXPECT_EQ(Color::red(), heatmap.getHeatmapColor().stops.at(1.0f));
+    EXPECT_EQ(255, heatmap.impl->colorRamp->data[255 * 4 + 0]);
+}
+
+TEST(StyleConversion, HillshadeLayer) {
+    auto layer = parseLayer(R"JSON({
+        "type": "hillshade",
+        "id": "hillshade",
+        "source": "dem",
+        "paint": {
+            "hillshade-exaggeration": 0.8,
+            "hillshade-illumination-anchor": "map"
+        }
+    })JSON");
+
+    ASSERT_TRUE(layer->is<HillshadeLayer>());
+    const HillshadeLayer& hillshade = *layer->as<HillshadeLayer>();
+    EXPECT_EQ("dem", hillshade.getSourceID());
+    EXPECT_EQ(0.8f, hillshade.getHillshadeExaggeration());
+    EXPECT_EQ(HillshadeIlluminationAnchorType::Map, hillshade.getHillshadeIlluminationAnchor());
+    EXPECT_EQ(335.0f, hillshade.getHillshadeIlluminationDirection());
+}
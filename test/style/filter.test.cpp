@@ -4,6 +4,7 @@
 
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/style/conversion/filter.hpp>
@@ -126,3 +127,64 @@ TEST(Filter, ID) {
 
     ASSERT_FALSE(parse("[\"==\", \"$id\", 1234]")(feature2));
 }
+
+TEST(Filter, Compiled) {
+    const std::vector<const char*> filters = {
+        "[\"==\", \"foo\", \"bar\"]",
+        "[\"!=\", \"foo\", 0]",
+        "[\"<\", \"foo\", 1]",
+        "[\"<=\", \"foo\", \"bar\"]",
+        "[\">\", \"foo\", 0]",
+        "[\">=\", \"foo\", 0]",
+        "[\"in\", \"foo\", 0, \"bar\"]",
+        "[\"!in\", \"foo\", 0, \"bar\"]",
+        "[\"has\", \"foo\"]",
+        "[\"!has\", \"foo\"]",
+        "[\"==\", \"$type\", \"LineString\"]",
+        "[\"in\", \"$type\", \"LineString\", \"Polygon\"]",
+        "[\"!in\", \"$type\", \"Point\"]",
+        "[\"==\", \"$id\", 1234]",
+        "[\"!has\", \"$id\"]",
+        "[\"any\"]",
+        "[\"all\"]",
+        "[\"none\"]",
+        "[\"any\", [\"==\", \"foo\", 1], [\"all\", [\"has\", \"bar\"], [\"none\", [\"==\", \"foo\", \"bar\"]]]]",
+        "[\"all\", [\"any\", [\"==\", \"foo\", 0]], [\"!=\", \"bar\", \"baz\"], [\"in\", \"foo\", 1, 0]]",
+    };
+
+    Feature withID { LineString<double>() };
+    withID.id = { uint64_t(1234) };
+    withID.properties = {{ "foo", std::string("bar") }, { "bar", true }};
+
+    const std::vector<Feature> features = {
+        feature({{}}),
+        feature({{ "foo", std::string("bar") }}),
+        feature({{ "foo", int64_t(0) }, { "bar", std::string("baz") }}),
+        feature({{ "foo", uint64_t(1) }, { "bar", false }}, LineString<double>()),
+        feature({{ "foo", 0.5 }}, Polygon<double>()),
+        withID,
+    };
+
+    // Compiled filters evaluate exactly like the filters they were compiled from.
+    for (const auto& expression : filters) {
+        const Filter filter = parse(expression);
+        const CompiledFilter compiled(filter);
+        for (const auto& f : features) {
+            EXPECT_EQ(filter(f), compiled(f)) << expression;
+        }
+    }
+}
+
+TEST(Filter, CompiledShared) {
+    auto a = CompiledFilter::get(parse("[\"==\", \"foo\", \"bar\"]"));
+    auto b = CompiledFilter::get(parse("[\"==\", \"foo\", \"bar\"]"));
+    auto c = CompiledFilter::get(parse("[\"==\", \"foo\", \"baz\"]"));
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+
+    // Filters that stringify identically must still be equal to be shared.
+    auto d = CompiledFilter::get(EqualsFilter { "foo", uint64_t(1) });
+    auto e = CompiledFilter::get(EqualsFilter { "foo", int64_t(1) });
+    EXPECT_NE(d, e);
+    EXPECT_EQ(Filter(EqualsFilter { "foo", int64_t(1) }), e->getFilter());
+}
@@ -3,6 +3,7 @@
 
 #include <mbgl/style/property_evaluator.hpp>
 #include <mbgl/style/property_evaluation_parameters.hpp>
+#include <mbgl/style/camera_function_cache.hpp>
 
 using namespace mbgl;
 using namespace mbgl::style;
@@ -77,3 +78,47 @@ TEST(CameraFunction, Stops) {
     EXPECT_TRUE(evaluate(discreteBool, 3));
     EXPECT_TRUE(evaluate(discreteBool, 4));
 }
+
+TEST(CameraFunction, Deduplicate) {
+    const ExponentialStops<float> stops { { { 6, 1.5 }, { 8, 3 } }, 1.75 };
+    auto a = CameraFunctionCache::deduplicate(CameraFunction<float>(stops));
+    auto b = CameraFunctionCache::deduplicate(CameraFunction<float>(stops));
+    auto c = CameraFunctionCache::deduplicate(CameraFunction<float>(ExponentialStops<float> { { { 6, 1.5 }, { 8, 3 } }, 1.5 }));
+    EXPECT_NE(0u, a.serial);
+    EXPECT_EQ(a.serial, b.serial);
+    EXPECT_NE(a.serial, c.serial);
+
+    // Deduplicated property values keep being equal to the others.
+    EXPECT_EQ(PropertyValue<float>(CameraFunction<float>(stops)),
+              CameraFunctionCache::deduplicate(PropertyValue<float>(CameraFunction<float>(stops))));
+    EXPECT_EQ(a.serial, CameraFunctionCache::deduplicate(PropertyValue<float>(CameraFunction<float>(stops)))
+        .asCameraFunction().serial);
+}
+
+TEST(CameraFunction, Cache) {
+    CameraFunctionCache cache;
+    PropertyEvaluationParameters parameters(7);
+    parameters.functionCache = &cache;
+
+    auto a = CameraFunctionCache::deduplicate(CameraFunction<float>(ExponentialStops<float> { { { 6, 1.5 }, { 8, 3 } }, 1.75 }));
+    auto b = a;
+    auto c = CameraFunctionCache::deduplicate(CameraFunction<std::string>(IntervalStops<std::string> { {{3, "string0"}, {6, "string1"}} }));
+
+    ASSERT_FLOAT_EQ(2.0454545454545454, PropertyValue<float>(a).evaluate(PropertyEvaluator<float>(parameters, 0)));
+    ASSERT_FLOAT_EQ(2.0454545454545454, PropertyValue<float>(b).evaluate(PropertyEvaluator<float>(parameters, 0)));
+    EXPECT_EQ("string1", PropertyValue<std::string>(c).evaluate(PropertyEvaluator<std::string>(parameters, "")));
+    EXPECT_EQ(2u, cache.size());
+
+    // Results are kept per zoom level.
+    parameters.z = 8;
+    EXPECT_EQ(3.0, PropertyValue<float>(b).evaluate(PropertyEvaluator<float>(parameters, 0)));
+    EXPECT_EQ(2u, cache.size());
+
+    // Functions that weren't deduplicated are evaluated directly.
+    CameraFunction<float> d(ExponentialStops<float> { { { 0, 2 }, { 8, 10 } }, 1 });
+    EXPECT_EQ(10, PropertyValue<float>(d).evaluate(PropertyEvaluator<float>(parameters, 0)));
+    EXPECT_EQ(2u, cache.size());
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+}
@@ -44,3 +44,35 @@ TEST(CompositeFunction, ZoomInterpolation) {
     }), 0.0f)
     .evaluate(0.0f, oneInteger, -1.0f)) << "Should interpolate TO the first stop";
 }
+
+TEST(CompositeFunction, CoveringRanges) {
+    CompositeFunction<float> fn("property", CompositeIntervalStops<float>({
+        {1.0f, {{0.0f, 10.0f}}},
+        {2.0f, {{0.0f, 20.0f}}},
+        {3.0f, {{0.0f, 30.0f}}}
+    }), 0.0f);
+
+    auto covering = [&] (float zoom) {
+        return std::get<0>(fn.coveringRanges(zoom));
+    };
+    EXPECT_EQ(Range<float>(1.0f, 1.0f), covering(0.0f)) << "Below the first stop";
+    EXPECT_EQ(Range<float>(1.0f, 2.0f), covering(1.0f)) << "At a stop";
+    EXPECT_EQ(Range<float>(2.0f, 3.0f), covering(2.5f)) << "Between stops";
+    EXPECT_EQ(Range<float>(3.0f, 3.0f), covering(4.0f)) << "Above the last stop";
+
+    EXPECT_EQ(25.0f, fn.evaluate(2.5f, oneInteger, -1.0f)) << "Should interpolate between stops";
+}
+
+TEST(CompositeFunction, Categorical) {
+    CompositeFunction<float> fn("property", CompositeCategoricalStops<float>({
+        {0.0f, {{int64_t(1), 10.0f}, {"1"s, 100.0f}}},
+        {10.0f, {{int64_t(1), 20.0f}, {"1"s, 200.0f}}}
+    }), 5.0f);
+
+    EXPECT_EQ(15.0f, fn.evaluate(5.0f, oneInteger, -1.0f));
+    EXPECT_EQ(150.0f, fn.evaluate(5.0f, StubGeometryTileFeature(PropertyMap {{ "property", "1"s }}), -1.0f));
+    EXPECT_EQ(5.0f, fn.evaluate(5.0f, StubGeometryTileFeature(PropertyMap {{ "property", "2"s }}), -1.0f))
+        << "Should use the default value for values without a stop";
+    EXPECT_EQ(5.0f, fn.evaluate(5.0f, StubGeometryTileFeature(PropertyMap {}), -1.0f))
+        << "Should use the default value for features without the property";
+}
@@ -0,0 +1,58 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/sources/geojson_parser.hpp>
+#include <mbgl/util/feature.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+TEST(GeoJSONParser, FeatureCollection) {
+    std::vector<double> progress;
+    GeoJSON geoJSON = parseGeoJSON(Buffer(R"JSON({
+        "type": "FeatureCollection",
+        "features": [{
+            "type": "Feature",
+            "id": 7,
+            "properties": { "name": "point", "rank": -1 },
+            "geometry": { "type": "Point", "coordinates": [1.5, 2] }
+        }, {
+            "type": "Feature",
+            "properties": null,
+            "geometry": { "type": "LineString", "coordinates": [[0, 0], [1, 1]] }
+        }]
+    })JSON"), [&] (double fraction) { progress.push_back(fraction); });
+
+    ASSERT_TRUE(geoJSON.is<FeatureCollection>());
+    const FeatureCollection& features = geoJSON.get<FeatureCollection>();
+    ASSERT_EQ(features.size(), 2u);
+
+    EXPECT_EQ(features[0].geometry, (mapbox::geometry::geometry<double> { mapbox::geometry::point<double> { 1.5, 2 } }));
+    EXPECT_EQ(*features[0].id, FeatureIdentifier { uint64_t(7) });
+    EXPECT_EQ(features[0].properties.at("name"), Value { std::string("point") });
+    EXPECT_EQ(features[0].properties.at("rank"), Value { int64_t(-1) });
+
+    EXPECT_TRUE(features[1].geometry.is<mapbox::geometry::line_string<double>>());
+    EXPECT_FALSE(features[1].id);
+    EXPECT_TRUE(features[1].properties.empty());
+
+    ASSERT_FALSE(progress.empty());
+    EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end()));
+    EXPECT_EQ(progress.back(), 1.0);
+}
+
+TEST(GeoJSONParser, Geometry) {
+    GeoJSON geoJSON = parseGeoJSON(Buffer(R"JSON({ "type": "Polygon", "coordinates": [[[0, 0], [1, 0], [1, 1], [0, 0]]] })JSON"));
+    ASSERT_TRUE(geoJSON.is<mapbox::geometry::geometry<double>>());
+    const auto& geometry = geoJSON.get<mapbox::geometry::geometry<double>>();
+    ASSERT_TRUE(geometry.is<mapbox::geometry::polygon<double>>());
+    EXPECT_EQ(geometry.get<mapbox::geometry::polygon<double>>()[0].size(), 4u);
+}
+
+TEST(GeoJSONParser, Errors) {
+    EXPECT_THROW(parseGeoJSON(Buffer(R"JSON({ "type": "FeatureCollection", "features": [)JSON")), GeoJSONSyntaxError);
+    EXPECT_THROW(parseGeoJSON(Buffer(R"JSON({ "type": "FeatureCollection" })JSON")), std::runtime_error);
+    EXPECT_THROW(parseGeoJSON(Buffer(R"JSON({ "type": "Point", "coordinates": [0] })JSON")), std::runtime_error);
+}
@@ -1,6 +1,7 @@
 #include <mbgl/test/util.hpp>
 
 #include <mbgl/style/group_by_layout.hpp>
+#include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
@@ -42,3 +43,21 @@ TEST(GroupByLayout, UnrelatedLayout) {
     auto result = groupByLayout(layers);
     ASSERT_EQ(2u, result.size());
 }
+
+TEST(GroupByLayout, Snapshots) {
+    auto a = std::make_unique<LineLayer>("a", "source");
+    auto b = std::make_unique<LineLayer>("b", "source");
+    b->setLineCap(LineCapType::Square);
+
+    // Snapshots keep the layout key of the layer they were made of.
+    std::vector<std::shared_ptr<const Layer>> layers;
+    layers.push_back(a->baseImpl->getSnapshot());
+    layers.push_back(b->baseImpl->getSnapshot());
+    EXPECT_EQ(layoutKey(*a), layoutKey(*layers[0]));
+    EXPECT_EQ(2u, groupByLayout(layers).size());
+
+    a->setLineCap(LineCapType::Square);
+    layers[0] = a->baseImpl->getSnapshot();
+    EXPECT_EQ(layoutKey(*a), layoutKey(*layers[0]));
+    EXPECT_EQ(1u, groupByLayout(layers).size());
+}
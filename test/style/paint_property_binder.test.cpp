@@ -0,0 +1,39 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/paint_property.hpp>
+#include <mbgl/programs/fill_program.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/color.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+TEST(PaintPropertyBinder, ColorAttributeValue) {
+    const std::array<uint16_t, 2> value = attributeValue(Color { 1.0f, 0.5f, 0.0f, 1.0f });
+    EXPECT_EQ(255 * 256 + 127, value[0]);
+    EXPECT_EQ(0 * 256 + 255, value[1]);
+
+    // Interpolated colors take as much space as the two floats a single color used to.
+    using Vertex = gl::detail::Vertex<ZoomInterpolatedAttributeType<attributes::a_color::Type>>;
+    EXPECT_EQ(8u, sizeof(Vertex));
+}
+
+TEST(PaintPropertyBinder, Variant) {
+    FillPaintProperties::Evaluated evaluated;
+    evaluated.get<FillOpacity>() = PossiblyEvaluatedPropertyValue<float>(CompositeFunction<float> {
+        "a", CompositeExponentialStops<float>({
+            { 0.0f, {{ uint64_t(1), 0.5f }} },
+            { 10.0f, {{ uint64_t(1), 1.0f }} }
+        }), 1.0f });
+    evaluated.get<FillColor>() = PossiblyEvaluatedPropertyValue<Color>(
+        SourceFunction<Color> { "b", IdentityStops<Color>() });
+    evaluated.get<FillOutlineColor>() = PossiblyEvaluatedPropertyValue<Color>(Color::black());
+
+    // Only the opacity is interpolated, so the variant leaves out the interpolation of the colors.
+    const FillProgram::PaintPropertyBinders binders { evaluated, 0 };
+    EXPECT_EQ("110", binders.variant().to_string());
+    EXPECT_EQ(binders.variant(), FillProgram::PaintPropertyBinders::variant(evaluated));
+    EXPECT_EQ("#define ZOOM_CONSTANT_a_color\n#define ZOOM_CONSTANT_a_outline_color\n",
+              FillProgram::PaintPropertyBinders::defines(binders.variant()));
+    EXPECT_EQ("", FillProgram::PaintPropertyBinders::defines({}));
+}
@@ -22,10 +22,14 @@
 #include <mbgl/style/layers/line_layer.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/annotation/annotation_source.hpp>
+#include <mbgl/renderer/render_tile.hpp>
 
 #include <mapbox/geojsonvt.hpp>
 
+#include <algorithm>
 #include <cstdint>
+#include <map>
+#include <set>
 
 using namespace mbgl;
 
@@ -127,7 +131,7 @@ TEST(Source, LoadingCorrupt) {
     test.fileSource.sourceResponse = [&] (const Resource& resource) {
         EXPECT_EQ("url", resource.url);
         Response response;
-        response.data = std::make_unique<std::string>("CORRUPTED");
+        response.data = std::make_shared<Buffer>("CORRUPTED");
         return response;
     };
 
@@ -202,6 +206,96 @@ TEST(Source, VectorTileEmpty) {
     test.run();
 }
 
+TEST(Source, PrefetchTransitionPath) {
+    SourceTest test;
+
+    // The camera is about to zoom in from z0 to z1.
+    Transform destination;
+    destination.resize({ 512, 512 });
+    destination.setLatLngZoom({ 0, 0 }, 1);
+    test.updateParameters.prefetchStates = { destination.getState() };
+
+    std::set<OverscaledTileID> requested;
+    test.fileSource.tileResponse = [&] (const Resource& resource) {
+        requested.emplace(resource.tileData->z, resource.tileData->x, resource.tileData->y);
+        if (requested.size() == 5) {
+            test.end();
+        }
+        Response response;
+        response.noContent = true;
+        return response;
+    };
+
+    Tileset tileset;
+    tileset.tiles = { "tiles" };
+
+    RasterSource source("source", tileset, 512);
+    source.baseImpl->setObserver(&test.observer);
+    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->updateTiles(test.updateParameters);
+
+    test.run();
+
+    EXPECT_EQ((std::set<OverscaledTileID> {
+        { 0, 0, 0 }, { 1, 0, 0 }, { 1, 0, 1 }, { 1, 1, 0 }, { 1, 1, 1 }
+    }), requested);
+}
+
+TEST(Source, IdlePrelayout) {
+    SourceTest test;
+
+    // Answers optional requests, which the tiles around the viewport are loaded with.
+    class CachingFileSource : public StubFileSource {
+    public:
+        bool supportsOptionalRequests() const override {
+            return true;
+        }
+    } fileSource;
+
+    style::UpdateParameters updateParameters {
+        1.0,
+        MapDebugOptions(),
+        test.transformState,
+        test.threadPool,
+        fileSource,
+        MapMode::Continuous,
+        test.annotationManager,
+        test.style
+    };
+    updateParameters.prelayout = true;
+
+    std::map<OverscaledTileID, Resource::Necessity> requested;
+    fileSource.tileResponse = [&] (const Resource& resource) {
+        requested.emplace(OverscaledTileID(resource.tileData->z, resource.tileData->x, resource.tileData->y),
+                          resource.necessity);
+        if (requested.size() == 5) {
+            test.end();
+        }
+        Response response;
+        response.noContent = true;
+        return response;
+    };
+
+    Tileset tileset;
+    tileset.tiles = { "tiles" };
+
+    RasterSource source("source", tileset, 512);
+    source.baseImpl->setObserver(&test.observer);
+    source.baseImpl->loadDescription(fileSource);
+    source.baseImpl->updateTiles(updateParameters);
+
+    test.run();
+
+    // The children of the ideal tile are only looked up in the cache.
+    EXPECT_EQ((std::map<OverscaledTileID, Resource::Necessity> {
+        { { 0, 0, 0 }, Resource::Required },
+        { { 1, 0, 0 }, Resource::Optional },
+        { { 1, 0, 1 }, Resource::Optional },
+        { { 1, 1, 0 }, Resource::Optional },
+        { { 1, 1, 1 }, Resource::Optional },
+    }), requested);
+}
+
 TEST(Source, RasterTileFail) {
     SourceTest test;
 
@@ -265,7 +359,7 @@ TEST(Source, RasterTileCorrupt) {
 
     test.fileSource.tileResponse = [&] (const Resource&) {
         Response response;
-        response.data = std::make_unique<std::string>("CORRUPTED");
+        response.data = std::make_shared<Buffer>("CORRUPTED");
         return response;
     };
 
@@ -293,7 +387,7 @@ TEST(Source, VectorTileCorrupt) {
 
     test.fileSource.tileResponse = [&] (const Resource&) {
         Response response;
-        response.data = std::make_unique<std::string>("CORRUPTED");
+        response.data = std::make_shared<Buffer>("CORRUPTED");
         return response;
     };
 
@@ -389,7 +483,7 @@ TEST(Source, RasterTileAttribution) {
     test.fileSource.sourceResponse = [&] (const Resource& resource) {
         EXPECT_EQ("url", resource.url);
         Response response;
-        response.data = std::make_unique<std::string>(R"TILEJSON({ "tilejson": "2.1.0", "attribution": ")TILEJSON" +
+        response.data = std::make_shared<Buffer>(R"TILEJSON({ "tilejson": "2.1.0", "attribution": ")TILEJSON" +
                                                       mapboxOSM +
                                                       R"TILEJSON(", "tiles": [ "tiles" ] })TILEJSON");
         return response;
@@ -413,13 +507,35 @@ TEST(Source, RasterTileAttribution) {
     test.run();
 }
 
+TEST(Source, PreconnectTileHosts) {
+    SourceTest test;
+
+    test.fileSource.sourceResponse = [&] (const Resource&) {
+        Response response;
+        response.data = std::make_shared<Buffer>(R"TILEJSON({ "tilejson": "2.1.0", "tiles": [ "http://a.example.com/{z}/{x}/{y}.png", "http://b.example.com/{z}/{x}/{y}.png" ] })TILEJSON");
+        return response;
+    };
+
+    test.observer.sourceLoaded = [&] (Source&) {
+        EXPECT_EQ((std::vector<std::string> { "http://a.example.com/{z}/{x}/{y}.png", "http://b.example.com/{z}/{x}/{y}.png" }),
+                  test.fileSource.preconnections);
+        test.end();
+    };
+
+    RasterSource source("source", "url", 512);
+    source.baseImpl->setObserver(&test.observer);
+    source.baseImpl->loadDescription(test.fileSource);
+
+    test.run();
+}
+
 TEST(Source, GeoJSonSourceUrlUpdate) {
     SourceTest test;
 
     test.fileSource.sourceResponse = [&] (const Resource& resource) {
         EXPECT_EQ("url", resource.url);
         Response response;
-        response.data = std::make_unique<std::string>("{\"geometry\": {\"type\": \"Point\", \"coordinates\": [1.1, 1.1]}, \"type\": \"Feature\", \"properties\": {}}");
+        response.data = std::make_shared<Buffer>("{\"geometry\": {\"type\": \"Point\", \"coordinates\": [1.1, 1.1]}, \"type\": \"Feature\", \"properties\": {}}");
         return response;
     };
 
@@ -446,3 +562,184 @@ TEST(Source, GeoJSonSourceUrlUpdate) {
 
     test.run();
 }
+
+TEST(Source, GeoJSONSourceUpdateFeatures) {
+    SourceTest test;
+
+    test.transform.setLatLngZoom({ 0, 0 }, 1);
+    test.transformState = test.transform.getState();
+
+    Feature north { mapbox::geometry::point<double> { 90, 45 } };
+    north.id = { uint64_t(1) };
+    Feature south { mapbox::geometry::point<double> { -90, -45 } };
+    south.id = { uint64_t(2) };
+
+    GeoJSONSource source("source");
+    source.setGeoJSON(FeatureCollection { north, south });
+    source.baseImpl->setObserver(&test.observer);
+    source.baseImpl->loadDescription(test.fileSource);
+
+    auto completeTiles = [&] {
+        std::set<CanonicalTileID> complete;
+        for (const auto& pair : source.baseImpl->getRenderTiles()) {
+            if (pair.second.tile.isComplete()) {
+                complete.insert(pair.first.canonical);
+            }
+        }
+        return complete;
+    };
+
+    test.observer.sourceLoaded = [&] (Source&) {
+        source.baseImpl->updateTiles(test.updateParameters);
+    };
+
+    test.observer.tileChanged = [&] (Source&, const OverscaledTileID&) {
+        source.baseImpl->updateTiles(test.updateParameters);
+        if (completeTiles().size() == 4) {
+            test.end();
+        }
+    };
+
+    // Starts indexing the features on the worker.
+    source.baseImpl->updateTiles(test.updateParameters);
+    EXPECT_FALSE(source.baseImpl->loaded);
+    test.run();
+
+    // Moving a feature within its tile reloads that tile only, once the worker has reindexed
+    // the features.
+    test.observer.tileChanged = nullptr;
+    test.observer.sourceChanged = [&] (Source&) {
+        test.end();
+    };
+
+    north.geometry = mapbox::geometry::point<double> { 91, 46 };
+    source.setFeature(north);
+    EXPECT_EQ(completeTiles().size(), 4u);
+    test.run();
+    EXPECT_EQ(completeTiles(), (std::set<CanonicalTileID> { { 1, 0, 0 }, { 1, 0, 1 }, { 1, 1, 1 } }));
+
+    EXPECT_THROW(source.setFeature(Feature { mapbox::geometry::point<double> { 0, 0 } }), std::invalid_argument);
+}
+
+TEST(Source, GeoJSONSourceClusterLevels) {
+    for (const auto clusterLevels : { GeoJSONOptions::ClusterLevels::Parallel, GeoJSONOptions::ClusterLevels::Lazy }) {
+        SourceTest test;
+
+        test.transform.setLatLngZoom({ 0, 0 }, 1);
+        test.transformState = test.transform.getState();
+
+        GeoJSONOptions options;
+        options.cluster = true;
+        options.clusterLevels = clusterLevels;
+        GeoJSONSource source("source", options);
+        source.setGeoJSON(FeatureCollection {
+            Feature { mapbox::geometry::point<double> { 90, 45 } },
+            Feature { mapbox::geometry::point<double> { 90.1, 45.1 } },
+            Feature { mapbox::geometry::point<double> { -90, -45 } }
+        });
+        source.baseImpl->setObserver(&test.observer);
+        source.baseImpl->loadDescription(test.fileSource);
+
+        // The tiles load once the levels of their zoom are built.
+        auto update = [&] (Source&) {
+            source.baseImpl->updateTiles(test.updateParameters);
+        };
+        test.observer.sourceLoaded = update;
+        test.observer.sourceChanged = update;
+        test.observer.tileChanged = [&] (Source&, const OverscaledTileID&) {
+            source.baseImpl->updateTiles(test.updateParameters);
+            const auto& renderTiles = source.baseImpl->getRenderTiles();
+            if (renderTiles.size() == 4 &&
+                std::all_of(renderTiles.begin(), renderTiles.end(), [] (const auto& pair) {
+                    return pair.second.tile.isComplete();
+                })) {
+                test.end();
+            }
+        };
+
+        source.baseImpl->updateTiles(test.updateParameters);
+        test.run();
+    }
+}
+
+TEST(Source, CopyKeepsDescription) {
+    SourceTest test;
+
+    std::size_t requests = 0;
+    test.fileSource.sourceResponse = [&] (const Resource&) {
+        requests++;
+        Response response;
+        response.data = std::make_shared<Buffer>(R"TILEJSON({ "tilejson": "2.1.0", "attribution": "attribution", "tiles": [ "tiles" ] })TILEJSON");
+        return response;
+    };
+
+    test.observer.sourceLoaded = [&] (Source&) {
+        test.end();
+    };
+
+    RasterSource source("source", "url", 512);
+    source.baseImpl->setObserver(&test.observer);
+    source.baseImpl->loadDescription(test.fileSource);
+    test.run();
+
+    std::unique_ptr<Source> copy = source.copy("copy");
+    EXPECT_EQ("copy", copy->getID());
+    EXPECT_TRUE(copy->is<RasterSource>());
+    EXPECT_TRUE(copy->baseImpl->loaded);
+    EXPECT_EQ(std::string("attribution"), copy->getAttribution());
+    EXPECT_EQ(1u, requests);
+
+    AnnotationSource annotationSource;
+    EXPECT_THROW(annotationSource.copy("copy"), std::runtime_error);
+}
+
+TEST(Source, GeoJSONSourceCopySharesFeatures) {
+    SourceTest test;
+
+    test.fileSource.sourceResponse = [&] (const Resource&) {
+        ADD_FAILURE() << "Should never be called";
+        return Response();
+    };
+
+    Feature point { mapbox::geometry::point<double> { 10, 10 } };
+    point.id = { uint64_t(1) };
+
+    GeoJSONSource source("source");
+    source.setGeoJSON(FeatureCollection { point });
+    source.baseImpl->setObserver(&test.observer);
+    source.baseImpl->loadDescription(test.fileSource);
+
+    test.observer.sourceLoaded = [&] (Source&) {
+        test.end();
+    };
+    source.baseImpl->updateTiles(test.updateParameters);
+    test.run();
+
+    std::unique_ptr<Source> copy = source.copy("copy");
+    copy->baseImpl->setObserver(&test.observer);
+    copy->baseImpl->loadDescription(test.fileSource);
+    EXPECT_FALSE(copy->baseImpl->loaded);
+
+    test.observer.sourceLoaded = [&] (Source& loaded) {
+        EXPECT_EQ(copy.get(), &loaded);
+        test.end();
+    };
+    copy->baseImpl->updateTiles(test.updateParameters);
+    test.run();
+
+    // The copy and the source change their features independently.
+    test.observer.sourceChanged = [&] (Source& changed) {
+        EXPECT_EQ(copy.get(), &changed);
+        test.end();
+    };
+    copy->as<GeoJSONSource>()->removeFeature(FeatureIdentifier { uint64_t(1) });
+    test.run();
+
+    test.observer.sourceChanged = [&] (Source& changed) {
+        EXPECT_EQ(&source, &changed);
+        test.end();
+    };
+    point.geometry = mapbox::geometry::point<double> { 20, 20 };
+    source.setFeature(point);
+    test.run();
+}
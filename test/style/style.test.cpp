@@ -2,9 +2,11 @@
 #include <mbgl/test/stub_file_source.hpp>
 
 #include <mbgl/style/style.hpp>
+#include <mbgl/style/style_snapshot.hpp>
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/sources/vector_source.hpp>
 #include <mbgl/style/layer.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 
@@ -134,3 +136,153 @@ TEST(Style, DuplicateSource) {
         // Expected
     }
 }
+
+TEST(Style, RequestsResourcesAtOnce) {
+    util::RunLoop loop;
+
+    // Records the requests, and leaves them pending.
+    class RecordingFileSource : public FileSource {
+    public:
+        std::unique_ptr<AsyncRequest> request(const Resource& resource, Callback) override {
+            resources.push_back(resource);
+            return std::make_unique<AsyncRequest>();
+        }
+
+        std::vector<Resource> resources;
+    };
+
+    RecordingFileSource fileSource;
+    Style style { fileSource, 1.0 };
+
+    style.setJSON(R"STYLE({
+        "version": 8,
+        "sprite": "http://example.com/sprite",
+        "sources": {
+            "vector": { "type": "vector", "url": "http://example.com/vector.json" },
+            "unused": { "type": "vector", "url": "http://example.com/unused.json" }
+        },
+        "layers": [{ "id": "fill", "type": "fill", "source": "vector", "source-layer": "water" }]
+    })STYLE");
+
+    // The TileJSON of the sources that are used and the sprite are all requested while the style
+    // loads, ahead of any tile.
+    ASSERT_EQ(3u, fileSource.resources.size());
+    EXPECT_EQ("http://example.com/vector.json", fileSource.resources[0].url);
+    EXPECT_EQ("http://example.com/sprite.json", fileSource.resources[1].url);
+    EXPECT_EQ("http://example.com/sprite.png", fileSource.resources[2].url);
+    for (const auto& resource : fileSource.resources) {
+        EXPECT_EQ(Resource::StylePriority, resource.priority);
+    }
+}
+
+TEST(Style, KeepsEquivalentSources) {
+    util::RunLoop loop;
+
+    StubFileSource fileSource;
+    Style style { fileSource, 1.0 };
+
+    const auto styleJSON = [](const std::string& tiles, const std::string& sprite, const std::string& color) {
+        return R"STYLE({
+            "version": 8,
+            "sprite": ")STYLE" + sprite + R"STYLE(",
+            "sources": {
+                "vector": { "type": "vector", "tiles": [")STYLE" + tiles + R"STYLE("] },
+                "geojson": { "type": "geojson", "data": { "type": "FeatureCollection", "features": [] } }
+            },
+            "layers": [
+                { "id": "fill", "type": "fill", "source": "vector", "source-layer": "water",
+                  "paint": { "fill-color": ")STYLE" + color + R"STYLE(" } },
+                { "id": "points", "type": "circle", "source": "geojson" }
+            ]
+        })STYLE";
+    };
+
+    // Marks the sources of the current style, which sources of a new style don't carry.
+    const auto mark = [&] {
+        for (Source* source : style.getSources()) {
+            source->peer = true;
+        }
+    };
+    const auto isKept = [&](const std::string& id) {
+        return !style.getSource(id)->peer.empty();
+    };
+
+    style.setJSON(styleJSON("http://example.com/{z}/{x}/{y}.pbf", "", "white"));
+    ASSERT_TRUE(style.getSource("vector"));
+    ASSERT_TRUE(style.getSource("geojson"));
+    mark();
+
+    // Tile sources that are defined alike are kept, but the layers are those of the new style.
+    style.setJSON(styleJSON("http://example.com/{z}/{x}/{y}.pbf", "", "black"));
+    EXPECT_TRUE(style.isLoaded());
+    EXPECT_TRUE(isKept("vector"));
+    EXPECT_FALSE(isKept("geojson"));
+    ASSERT_TRUE(style.getLayer("fill"));
+    EXPECT_EQ(DataDrivenPropertyValue<Color>(Color::black()), style.getLayer("fill")->as<FillLayer>()->getFillColor());
+    mark();
+
+    // Sources whose definition changed are replaced.
+    style.setJSON(styleJSON("http://example.com/{z}/{x}/{y}.mvt", "", "black"));
+    EXPECT_FALSE(isKept("vector"));
+    mark();
+
+    // All sources are replaced when the sprite changes.
+    style.setJSON(styleJSON("http://example.com/{z}/{x}/{y}.mvt", "http://example.com/sprite", "black"));
+    EXPECT_FALSE(isKept("vector"));
+}
+
+TEST(Style, Snapshot) {
+    util::RunLoop loop;
+
+    // Records the requests, and leaves them pending.
+    class RecordingFileSource : public FileSource {
+    public:
+        std::unique_ptr<AsyncRequest> request(const Resource& resource, Callback) override {
+            resources.push_back(resource);
+            return std::make_unique<AsyncRequest>();
+        }
+
+        std::vector<Resource> resources;
+    };
+
+    RecordingFileSource fileSource;
+    Style style { fileSource, 1.0 };
+    EXPECT_THROW(style.getSnapshot(), std::runtime_error);
+
+    style.setJSON(R"STYLE({
+        "version": 8,
+        "name": "Test",
+        "zoom": 3,
+        "sources": {
+            "vector": { "type": "vector", "tiles": ["http://example.com/{z}/{x}/{y}.pbf"] },
+            "geojson": { "type": "geojson", "data": { "type": "FeatureCollection", "features": [] } }
+        },
+        "layers": [
+            { "id": "fill", "type": "fill", "source": "vector", "source-layer": "water",
+              "paint": { "fill-color": "black" } },
+            { "id": "points", "type": "circle", "source": "geojson" }
+        ]
+    })STYLE");
+    auto snapshot = style.getSnapshot();
+    EXPECT_EQ(2u, snapshot->sources.size());
+    EXPECT_EQ(2u, snapshot->layers.size());
+
+    // Layers added to the style since leave the snapshot alone.
+    style.addLayer(std::make_unique<FillLayer>("other", "vector"));
+    EXPECT_EQ(2u, snapshot->layers.size());
+
+    // Styles that load the snapshot get copies of its sources and layers, without requesting
+    // anything that the style had loaded.
+    Style copy { fileSource, 1.0 };
+    copy.setSnapshot(*snapshot);
+    EXPECT_EQ("Test", copy.getName());
+    EXPECT_EQ(3, copy.getDefaultZoom());
+    ASSERT_TRUE(copy.getSource("vector"));
+    EXPECT_TRUE(copy.getSource("vector")->baseImpl->loaded);
+    EXPECT_NE(style.getSource("vector"), copy.getSource("vector"));
+    ASSERT_TRUE(copy.getLayer("fill"));
+    EXPECT_EQ(DataDrivenPropertyValue<Color>(Color::black()), copy.getLayer("fill")->as<FillLayer>()->getFillColor());
+    EXPECT_TRUE(copy.getLayer("points"));
+    EXPECT_FALSE(copy.getLayer("other"));
+    EXPECT_TRUE(fileSource.resources.empty());
+}
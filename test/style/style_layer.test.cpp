@@ -2,6 +2,8 @@
 #include <mbgl/test/stub_layer_observer.hpp>
 #include <mbgl/test/stub_file_source.hpp>
 #include <mbgl/style/style.hpp>
+#include <mbgl/style/cascade_parameters.hpp>
+#include <mbgl/style/property_evaluation_parameters.hpp>
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/background_layer_impl.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
@@ -10,6 +12,10 @@
 #include <mbgl/style/layers/custom_layer_impl.hpp>
 #include <mbgl/style/layers/fill_layer.hpp>
 #include <mbgl/style/layers/fill_layer_impl.hpp>
+#include <mbgl/style/layers/heatmap_layer.hpp>
+#include <mbgl/style/layers/heatmap_layer_impl.hpp>
+#include <mbgl/style/layers/hillshade_layer.hpp>
+#include <mbgl/style/layers/hillshade_layer_impl.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
 #include <mbgl/style/layers/line_layer_impl.hpp>
 #include <mbgl/style/layers/raster_layer.hpp>
@@ -65,6 +71,8 @@ TEST(Layer, Clone) {
     testClone<CircleLayer>("circle", "source");
     testClone<CustomLayer>("custom", [](void*){}, [](void*, const CustomLayerRenderParameters&){}, [](void*){}, nullptr),
     testClone<FillLayer>("fill", "source");
+    testClone<HeatmapLayer>("heatmap", "source");
+    testClone<HillshadeLayer>("hillshade", "source");
     testClone<LineLayer>("line", "source");
     testClone<RasterLayer>("raster", "source");
     testClone<SymbolLayer>("symbol", "source");
@@ -139,6 +147,41 @@ TEST(Layer, FillProperties) {
     EXPECT_EQ(layer->getFillTranslateAnchor(), translateAnchor);
 }
 
+TEST(Layer, HeatmapProperties) {
+    auto layer = std::make_unique<HeatmapLayer>("heatmap", "source");
+    EXPECT_TRUE(layer->is<HeatmapLayer>());
+
+    // Paint properties
+
+    layer->setHeatmapRadius(radius);
+    EXPECT_EQ(layer->getHeatmapRadius(), radius);
+
+    layer->setHeatmapWeight(1.0f);
+    EXPECT_EQ(layer->getHeatmapWeight(), 1.0f);
+
+    layer->setHeatmapIntensity(1.0f);
+    EXPECT_EQ(layer->getHeatmapIntensity(), 1.0f);
+
+    layer->setHeatmapOpacity(opacity);
+    EXPECT_EQ(layer->getHeatmapOpacity(), opacity);
+
+    // The ramp is sampled at 256 densities, from its first color to its last.
+    EXPECT_EQ(layer->getHeatmapColor(), HeatmapLayer::getDefaultHeatmapColor());
+    layer->setHeatmapColor(ExponentialStops<Color>({ { 0.0f, Color() }, { 1.0f, color } }));
+    EXPECT_EQ(layer->getHeatmapColor(),
+              ExponentialStops<Color>({ { 0.0f, Color() }, { 1.0f, color } }));
+
+    const PremultipliedImage& ramp = *layer->impl->colorRamp;
+    ASSERT_EQ(Size(256, 1), ramp.size);
+    EXPECT_EQ(0, ramp.data[0]);
+    EXPECT_EQ(0, ramp.data[3]);
+    EXPECT_EQ(128, ramp.data[128 * 4 + 0]);
+    EXPECT_EQ(128, ramp.data[128 * 4 + 3]);
+    EXPECT_EQ(255, ramp.data[255 * 4 + 0]);
+    EXPECT_EQ(0, ramp.data[255 * 4 + 1]);
+    EXPECT_EQ(255, ramp.data[255 * 4 + 3]);
+}
+
 TEST(Layer, LineProperties) {
     auto layer = std::make_unique<LineLayer>("line", "source");
     EXPECT_TRUE(layer->is<LineLayer>());
@@ -218,6 +261,31 @@ TEST(Layer, RasterProperties) {
     EXPECT_EQ(layer->getRasterFadeDuration(), duration);
 }
 
+TEST(Layer, HillshadeProperties) {
+    auto layer = std::make_unique<HillshadeLayer>("hillshade", "source");
+    EXPECT_TRUE(layer->is<HillshadeLayer>());
+
+    // Paint properties
+
+    layer->setHillshadeIlluminationDirection(hueRotate);
+    EXPECT_EQ(layer->getHillshadeIlluminationDirection(), hueRotate);
+
+    layer->setHillshadeIlluminationAnchor(HillshadeIlluminationAnchorType::Map);
+    EXPECT_EQ(layer->getHillshadeIlluminationAnchor(), HillshadeIlluminationAnchorType::Map);
+
+    layer->setHillshadeExaggeration(opacity);
+    EXPECT_EQ(layer->getHillshadeExaggeration(), opacity);
+
+    layer->setHillshadeShadowColor(color);
+    EXPECT_EQ(layer->getHillshadeShadowColor(), color);
+
+    layer->setHillshadeHighlightColor(color);
+    EXPECT_EQ(layer->getHillshadeHighlightColor(), color);
+
+    layer->setHillshadeAccentColor(color);
+    EXPECT_EQ(layer->getHillshadeAccentColor(), color);
+}
+
 TEST(Layer, Observer) {
     auto layer = std::make_unique<LineLayer>("line", "source");
     StubLayerObserver observer;
@@ -296,3 +364,67 @@ TEST(Layer, DuplicateLayer) {
     }
 }
 
+
+TEST(Layer, ZoomConstantEvaluation) {
+    auto layer = std::make_unique<LineLayer>("line", "source");
+    const CascadeParameters cascade { { ClassID::Default }, Clock::now(), TransitionOptions {} };
+
+    layer->setLineWidth(width);
+    layer->baseImpl->cascadeProperties(cascade);
+    EXPECT_TRUE(layer->baseImpl->isZoomConstant());
+    EXPECT_FALSE(layer->baseImpl->evaluateProperties(PropertyEvaluationParameters(1)));
+    EXPECT_EQ(width, layer->impl->paint.evaluated.get<LineWidth>());
+
+    // Constant properties are evaluated once per cascade, rather than at every zoom level.
+    layer->impl->paint.evaluated.get<LineWidth>() = 5;
+    layer->baseImpl->evaluateProperties(PropertyEvaluationParameters(2));
+    EXPECT_EQ(5, layer->impl->paint.evaluated.get<LineWidth>());
+
+    layer->setLineWidth(CameraFunction<float>(ExponentialStops<float> { { { 0, 0 }, { 10, 10 } }, 1 }));
+    layer->baseImpl->cascadeProperties(cascade);
+    EXPECT_FALSE(layer->baseImpl->isZoomConstant());
+    layer->baseImpl->evaluateProperties(PropertyEvaluationParameters(2));
+    EXPECT_EQ(2, layer->impl->paint.evaluated.get<LineWidth>());
+    layer->baseImpl->evaluateProperties(PropertyEvaluationParameters(3));
+    EXPECT_EQ(3, layer->impl->paint.evaluated.get<LineWidth>());
+
+    // Without transitions, properties are evaluated again only once the zoom level changes, such
+    // as while another layer transitions.
+    layer->impl->paint.evaluated.get<LineWidth>() = 5;
+    layer->baseImpl->evaluateProperties(PropertyEvaluationParameters(3));
+    EXPECT_EQ(5, layer->impl->paint.evaluated.get<LineWidth>());
+    layer->baseImpl->evaluateProperties(PropertyEvaluationParameters(2.5));
+    EXPECT_EQ(2.5, layer->impl->paint.evaluated.get<LineWidth>());
+    layer->baseImpl->evaluateProperties(PropertyEvaluationParameters(3));
+    EXPECT_EQ(3, layer->impl->paint.evaluated.get<LineWidth>());
+
+    // Hidden layers aren't evaluated until they are shown.
+    layer->setMaxZoom(3);
+    layer->baseImpl->evaluateProperties(PropertyEvaluationParameters(4));
+    EXPECT_EQ(3, layer->impl->paint.evaluated.get<LineWidth>());
+}
+
+TEST(Layer, Snapshot) {
+    auto layer = std::make_unique<LineLayer>("line", "source");
+    const CascadeParameters cascade { { ClassID::Default }, Clock::now(), TransitionOptions {} };
+
+    // Tiles share the snapshot, until the layer changes.
+    std::shared_ptr<const Layer> snapshot = layer->baseImpl->getSnapshot();
+    EXPECT_EQ(snapshot, layer->baseImpl->getSnapshot());
+    EXPECT_EQ("line", snapshot->getID());
+
+    layer->setLineCap(LineCapType::Round);
+    std::shared_ptr<const Layer> capped = layer->baseImpl->getSnapshot();
+    EXPECT_NE(snapshot, capped);
+    EXPECT_EQ(LineCapType::Round, capped->as<LineLayer>()->getLineCap().asConstant());
+
+    layer->setSourceLayer("road");
+    EXPECT_EQ("road", layer->baseImpl->getSnapshot()->baseImpl->sourceLayer);
+
+    layer->baseImpl->cascadeProperties(cascade);
+    EXPECT_NE(capped, layer->baseImpl->getSnapshot());
+
+    // Copies of the layer make their own snapshots.
+    auto copy = layer->baseImpl->copy("copy", "source");
+    EXPECT_EQ("copy", copy->baseImpl->getSnapshot()->getID());
+}
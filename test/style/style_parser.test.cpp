@@ -102,3 +102,40 @@ TEST(StyleParser, FontStacks) {
     ASSERT_EQ(FontStack({"a", "b"}), result[1]);
     ASSERT_EQ(FontStack({"a", "b", "c"}), result[2]);
 }
+
+TEST(StyleParser, SourcesBeforeLayers) {
+    style::Parser parser;
+    bool sourcesParsed = false;
+    auto error = parser.parse(R"STYLE({
+      "version": 8,
+      "sources": {
+        "visible": { "type": "vector", "tiles": [] },
+        "hidden": { "type": "vector", "tiles": [] },
+        "unused": { "type": "vector", "tiles": [] }
+      },
+      "layers": [{
+        "id": "visible",
+        "type": "fill",
+        "source": "visible",
+        "source-layer": "layer"
+      }, {
+        "id": "ref",
+        "ref": "visible"
+      }, {
+        "id": "hidden",
+        "type": "fill",
+        "source": "hidden",
+        "source-layer": "layer",
+        "layout": { "visibility": "none" }
+      }]
+    })STYLE", [&] {
+        sourcesParsed = true;
+        EXPECT_EQ(3u, parser.sources.size());
+        EXPECT_TRUE(parser.layers.empty());
+        EXPECT_EQ(std::set<std::string>({ "visible" }), parser.layerSources);
+    });
+
+    EXPECT_FALSE(error);
+    EXPECT_TRUE(sourcesParsed);
+    EXPECT_EQ(3u, parser.layers.size());
+}
@@ -0,0 +1,19 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/bidi.hpp>
+
+using namespace mbgl;
+
+TEST(BiDi, LeftToRight) {
+    BiDi bidi;
+
+    // Left-to-right text is broken at the break points, and at its end.
+    const std::vector<std::u16string> lines = bidi.processText(u"Main Street North", { 5, 12 });
+    ASSERT_EQ(3u, lines.size());
+    EXPECT_EQ(u"Main ", lines[0]);
+    EXPECT_EQ(u"Street ", lines[1]);
+    EXPECT_EQ(u"North", lines[2]);
+
+    EXPECT_EQ(std::vector<std::u16string>({ u"Main Street" }), bidi.processText(u"Main Street", {}));
+    EXPECT_EQ(u"Main Street", applyArabicShaping(u"Main Street"));
+}
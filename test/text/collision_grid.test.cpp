@@ -0,0 +1,57 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/collision_grid.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+void insert(CollisionGrid& grid, CollisionGridBox box, std::size_t index) {
+    grid.insert(box, CollisionBox({ 0, 0 }, 0, 0, 0, 0, 1), IndexedSubfeature { index, 0, 0, uint32_t(index) });
+}
+
+} // namespace
+
+TEST(CollisionGrid, Query) {
+    CollisionGrid grid(0, 100, 10);
+    std::vector<uint32_t> result;
+
+    grid.query({ 0, 0, 100, 100 }, result);
+    EXPECT_TRUE(result.empty());
+
+    insert(grid, { 45, 45, 55, 55 }, 0);
+    insert(grid, { 5, 5, 15, 15 }, 1);
+    insert(grid, { 0, 0, 100, 100 }, 2);
+    insert(grid, { 12, 12, 14, 14 }, 3);
+
+    grid.query({ 10, 10, 20, 20 }, result);
+    EXPECT_EQ((std::vector<uint32_t> { 1, 2, 3 }), result);
+
+    // Boxes that touch intersect.
+    grid.query({ 55, 55, 60, 60 }, result);
+    EXPECT_EQ((std::vector<uint32_t> { 0, 2 }), result);
+
+    grid.query({ 16, 16, 20, 20 }, result);
+    EXPECT_EQ((std::vector<uint32_t> { 2 }), result);
+
+    EXPECT_EQ(4u, grid.size());
+    EXPECT_EQ(3u, grid[3].feature.index);
+}
+
+TEST(CollisionGrid, OutsideOfGrid) {
+    CollisionGrid grid(0, 100, 10);
+    std::vector<uint32_t> result;
+
+    insert(grid, { -50, -50, -40, -40 }, 0);
+    insert(grid, { 150, 20, 200, 30 }, 1);
+    insert(grid, { -1000, 95, 1000, 1000 }, 2);
+
+    grid.query({ -45, -45, -45, -45 }, result);
+    EXPECT_EQ((std::vector<uint32_t> { 0 }), result);
+
+    grid.query({ 0, 0, 5, 5 }, result);
+    EXPECT_TRUE(result.empty());
+
+    grid.query({ 160, 0, 170, 500 }, result);
+    EXPECT_EQ((std::vector<uint32_t> { 1, 2 }), result);
+}
@@ -0,0 +1,84 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/util/constants.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// A point label of 120 by 24 pixels at the tile's own zoom level.
+CollisionFeature label(int16_t x, int16_t y) {
+    const float boxScale = util::EXTENT / util::tileSize;
+    return CollisionFeature(GeometryCoordinates { { x, y } }, Anchor(x, y, 0, 0.5f),
+                            -12, 12, -60, 60, boxScale, 0, style::SymbolPlacementType::Point,
+                            IndexedSubfeature { 0, 0, 0, 0 },
+                            CollisionFeature::AlignmentType::Straight);
+}
+
+// A label of 200 by 24 pixels along a diagonal line through the center of the tile.
+CollisionFeature lineLabel() {
+    const float boxScale = util::EXTENT / util::tileSize;
+    const int16_t center = util::EXTENT / 2;
+    return CollisionFeature(GeometryCoordinates { { 2048, 2048 }, { 6144, 6144 } }, Anchor(center, center, 0, 0.5f, 0),
+                            -12, 12, -100, 100, boxScale, 0, style::SymbolPlacementType::Line,
+                            IndexedSubfeature { 0, 0, 0, 0 },
+                            CollisionFeature::AlignmentType::Curved);
+}
+
+} // namespace
+
+TEST(CollisionTile, LineLabel) {
+    auto line = lineLabel();
+    ASSERT_LT(1u, line.boxes.size());
+
+    // A label in the corner of the box that bounds the line label doesn't block any of its boxes.
+    CollisionTile corner { PlacementConfig() };
+    auto cornerLabel = label(5000, 3000);
+    corner.insertFeature(cornerLabel, corner.placeFeature(cornerLabel, false, false), false);
+    EXPECT_EQ(corner.minScale, corner.placeFeature(line, false, false));
+
+    // A label across the line does.
+    CollisionTile across { PlacementConfig() };
+    auto acrossLabel = label(util::EXTENT / 2, util::EXTENT / 2);
+    across.insertFeature(acrossLabel, across.placeFeature(acrossLabel, false, false), false);
+    EXPECT_LT(across.minScale, across.placeFeature(line, false, false));
+    EXPECT_EQ(across.minScale, across.placeFeature(line, true, false));
+}
+
+TEST(CollisionTile, EdgeBoxes) {
+    CollisionTile tile { PlacementConfig() };
+
+    auto nearEdge = label(util::EXTENT - 100, util::EXTENT / 2);
+    tile.insertFeature(nearEdge, tile.placeFeature(nearEdge, false, false), false);
+    auto inside = label(util::EXTENT / 2, util::EXTENT / 2);
+    tile.insertFeature(inside, tile.placeFeature(inside, false, false), false);
+
+    const auto edgeBoxes = tile.getEdgeBoxes();
+    ASSERT_EQ(1u, edgeBoxes.size());
+    EXPECT_EQ(nearEdge.boxes.front(), edgeBoxes.front());
+}
+
+TEST(CollisionTile, NeighbourBoxes) {
+    CollisionTile left { PlacementConfig() };
+    auto leftLabel = label(util::EXTENT - 100, util::EXTENT / 2);
+    left.insertFeature(leftLabel, left.placeFeature(leftLabel, false, false), false);
+
+    // Without its neighbour, the tile shows the label right away.
+    auto rightLabel = label(100, util::EXTENT / 2);
+    CollisionTile alone { PlacementConfig() };
+    EXPECT_EQ(alone.minScale, alone.placeFeature(rightLabel, false, false));
+
+    // With it, the label gives way to the one across the seam...
+    PlacementConfig config;
+    config.neighbours.push_back({ -1, 0, std::make_shared<const std::vector<CollisionBox>>(left.getEdgeBoxes()) });
+    CollisionTile right { config };
+    EXPECT_LT(right.minScale, right.placeFeature(rightLabel, false, false));
+
+    // ...unless it may overlap.
+    EXPECT_EQ(right.minScale, right.placeFeature(rightLabel, true, false));
+
+    // Boxes of the neighbour aren't symbols of the tile.
+    EXPECT_TRUE(right.queryRenderedSymbols({ { 0, 0 }, { util::EXTENT, 0 }, { util::EXTENT, util::EXTENT }, { 0, util::EXTENT } }, 1).empty());
+    EXPECT_TRUE(right.getEdgeBoxes().empty());
+}
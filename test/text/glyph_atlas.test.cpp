@@ -49,7 +49,7 @@ TEST(GlyphAtlas, LoadingSuccess) {
     test.fileSource.glyphsResponse = [&] (const Resource& resource) {
         EXPECT_EQ(Resource::Kind::Glyphs, resource.kind);
         Response response;
-        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        response.data = std::make_shared<Buffer>(util::read_file("test/fixtures/resources/glyphs.pbf"));
         return response;
     };
 
@@ -82,6 +82,105 @@ TEST(GlyphAtlas, LoadingSuccess) {
         });
 }
 
+TEST(GlyphAtlas, Grow) {
+    GlyphAtlasTest test;
+
+    test.fileSource.glyphsResponse = [&] (const Resource&) {
+        Response response;
+        response.data = std::make_shared<Buffer>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        return response;
+    };
+
+    test.requestor.glyphsAvailable = [&] (GlyphPositionMap positions) {
+        const auto& testPositions = positions.at({{"Test Stack"}});
+
+        // With padding, the glyphs are 20x24 and 20x32 pixels, so the 32x32 atlas grows twice.
+        const Rect<uint16_t> a = testPositions.at(u'a')->rect;
+        const Rect<uint16_t> aring = testPositions.at(u'å')->rect;
+        EXPECT_EQ(Rect<uint16_t>(0, 0, 20, 24), a);
+        EXPECT_EQ(Rect<uint16_t>(0, 24, 20, 32), aring);
+        EXPECT_EQ((Size { 64, 64 }), test.glyphAtlas.getSize());
+
+        test.end();
+    };
+
+    test.run(
+        "test/fixtures/resources/glyphs.pbf",
+        GlyphDependencies {
+            {{{"Test Stack"}}, {u'a', u'å'}}
+        });
+}
+
+TEST(GlyphAtlas, ResidentGlyphs) {
+    GlyphAtlasTest test;
+
+    test.fileSource.glyphsResponse = [&] (const Resource&) {
+        Response response;
+        response.data = std::make_shared<Buffer>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        return response;
+    };
+
+    const FontStack fontStack {{"Test Stack"}};
+    StubGlyphRequestor other;
+
+    test.requestor.glyphsAvailable = [&] (GlyphPositionMap positions) {
+        const Rect<uint16_t> a = positions.at(fontStack).at(u'a')->rect;
+
+        // Glyphs only become resident once a second tile uses them.
+        GlyphPositions resident;
+        EXPECT_EQ(GlyphIDs({ u'a' }), test.glyphAtlas.getResidentGlyphs()->find(fontStack, { u'a' }, resident));
+
+        other.glyphsAvailable = [&] (GlyphPositionMap) {};
+        test.glyphAtlas.getGlyphs(other, GlyphDependencies { { fontStack, { u'a' } } });
+        EXPECT_EQ(GlyphIDs(), test.glyphAtlas.getResidentGlyphs()->find(fontStack, { u'a' }, resident));
+        EXPECT_EQ(a, resident.at(u'a')->rect);
+
+        // Resident glyphs keep their position when no tile uses them anymore.
+        test.glyphAtlas.removeGlyphs(test.requestor);
+        test.glyphAtlas.removeGlyphs(other);
+        other.glyphsAvailable = [&] (GlyphPositionMap again) {
+            EXPECT_EQ(a, again.at(fontStack).at(u'a')->rect);
+        };
+        test.glyphAtlas.getGlyphs(other, GlyphDependencies { { fontStack, { u'a', u'å' } } });
+        test.glyphAtlas.removeGlyphs(other);
+
+        test.end();
+    };
+
+    test.run(
+        "test/fixtures/resources/glyphs.pbf",
+        GlyphDependencies {
+            {fontStack, {u'a'}}
+        });
+}
+
+TEST(GlyphAtlas, LoadingPreloaded) {
+    GlyphAtlasTest test;
+
+    GlyphStore::get().preload("test/fixtures/resources/glyphs.pbf", {{"Test Stack"}}, { 0, 255 },
+                              util::read_file("test/fixtures/resources/glyphs.pbf"));
+
+    test.fileSource.glyphsResponse = [&] (const Resource&) {
+        ADD_FAILURE() << "Preloaded glyphs should not be requested";
+        return Response();
+    };
+
+    test.requestor.glyphsAvailable = [&] (GlyphPositionMap positions) {
+        const auto& testPositions = positions.at({{"Test Stack"}});
+        ASSERT_EQ(testPositions.count(u'a'), 1u);
+        EXPECT_TRUE(testPositions.at(u'a')->rect.hasArea());
+        test.end();
+    };
+
+    test.run(
+        "test/fixtures/resources/glyphs.pbf",
+        GlyphDependencies {
+            {{{"Test Stack"}}, {u'a'}}
+        });
+
+    GlyphStore::get().clear();
+}
+
 TEST(GlyphAtlas, LoadingFail) {
     GlyphAtlasTest test;
 
@@ -120,7 +219,7 @@ TEST(GlyphAtlas, LoadingCorrupted) {
 
     test.fileSource.glyphsResponse = [&] (const Resource&) {
         Response response;
-        response.data = std::make_unique<std::string>("CORRUPTED");
+        response.data = std::make_shared<Buffer>("CORRUPTED");
         return response;
     };
 
@@ -171,7 +270,7 @@ TEST(GlyphAtlas, LoadingInvalid) {
     test.fileSource.glyphsResponse = [&] (const Resource& resource) {
         EXPECT_EQ(Resource::Kind::Glyphs, resource.kind);
         Response response;
-        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/fake_glyphs-0-255.pbf"));
+        response.data = std::make_shared<Buffer>(util::read_file("test/fixtures/resources/fake_glyphs-0-255.pbf"));
         return response;
     };
 
@@ -0,0 +1,56 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/glyph_store.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+static const std::string url = "test/fixtures/resources/glyphs.pbf";
+static const FontStack fontStack { "Test Stack" };
+static const GlyphRange range { 0, 255 };
+
+TEST(GlyphStore, Shared) {
+    GlyphStore store;
+    const std::string data = util::read_file("test/fixtures/resources/glyphs.pbf");
+
+    EXPECT_EQ(nullptr, store.find(url, fontStack, range));
+
+    auto glyphs = store.add(url, fontStack, range, data);
+    ASSERT_NE(nullptr, glyphs);
+    EXPECT_EQ(1u, glyphs->count(u'a'));
+
+    // The same data isn't parsed again.
+    EXPECT_EQ(glyphs, store.add(url, fontStack, range, data));
+    EXPECT_EQ(glyphs, store.find(url, fontStack, range));
+
+    // Ranges are keyed by the glyph URL too.
+    EXPECT_EQ(nullptr, store.find("glyphs/{fontstack}/{range}.pbf", fontStack, range));
+    EXPECT_EQ(nullptr, store.find(url, FontStack { "Other Stack" }, range));
+
+    // Ranges are dropped once they're no longer used.
+    glyphs.reset();
+    EXPECT_EQ(nullptr, store.find(url, fontStack, range));
+}
+
+TEST(GlyphStore, Preload) {
+    GlyphStore store;
+    const std::string data = util::read_file("test/fixtures/resources/glyphs.pbf");
+
+    store.preload(url, fontStack, range, data);
+    auto glyphs = store.find(url, fontStack, range);
+    ASSERT_NE(nullptr, glyphs);
+    EXPECT_EQ(1u, glyphs->count(u'a'));
+
+    // Glyphs that are still used outlive clearing the store.
+    store.clear();
+    EXPECT_EQ(glyphs, store.find(url, fontStack, range));
+
+    glyphs.reset();
+    EXPECT_EQ(nullptr, store.find(url, fontStack, range));
+}
+
+TEST(GlyphStore, Malformed) {
+    GlyphStore store;
+    EXPECT_ANY_THROW(store.add(url, fontStack, range, "\x0a\xff"));
+    EXPECT_EQ(nullptr, store.find(url, fontStack, range));
+}
@@ -0,0 +1,71 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/bidi.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+
+using namespace mbgl;
+
+static ShapingCache::Key key(const std::u16string& text) {
+    return { text, { "Open Sans Regular" }, 240, 28.8, 0.5, 0.5, 0.5, 0, { 0, 0 }, 24,
+             WritingModeType::Horizontal };
+}
+
+TEST(ShapingCache, Find) {
+    ShapingCache cache;
+
+    auto shaping = std::make_shared<const Shaping>();
+    cache.add(key(u"Main Street"), shaping);
+    EXPECT_EQ(shaping, cache.find(key(u"Main Street")));
+
+    // Shapings of other text, or with other options, are not returned.
+    EXPECT_FALSE(bool(cache.find(key(u"Elm Street"))));
+    ShapingCache::Key vertical = key(u"Main Street");
+    vertical.writingMode = WritingModeType::Vertical;
+    EXPECT_FALSE(bool(cache.find(vertical)));
+
+    EXPECT_EQ(1u, cache.getStats().hits);
+    EXPECT_EQ(2u, cache.getStats().misses);
+    EXPECT_EQ(1u, cache.getStats().shapings);
+}
+
+TEST(ShapingCache, Evict) {
+    ShapingCache cache(2);
+
+    cache.add(key(u"a"), std::make_shared<const Shaping>());
+    cache.add(key(u"b"), std::make_shared<const Shaping>());
+
+    // Using "a" makes "b" the least recently used shaping.
+    EXPECT_TRUE(bool(cache.find(key(u"a"))));
+    cache.add(key(u"c"), std::make_shared<const Shaping>());
+
+    EXPECT_TRUE(bool(cache.find(key(u"a"))));
+    EXPECT_FALSE(bool(cache.find(key(u"b"))));
+    EXPECT_TRUE(bool(cache.find(key(u"c"))));
+    EXPECT_EQ(1u, cache.getStats().evictions);
+    EXPECT_EQ(2u, cache.getStats().shapings);
+}
+
+TEST(ShapingCache, GetShaping) {
+    ShapingCache cache;
+    BiDi bidi;
+
+    Glyph glyph;
+    glyph.metrics.width = 18;
+    glyph.metrics.height = 18;
+    glyph.metrics.advance = 20;
+
+    GlyphPositions glyphs;
+    glyphs.emplace(u'a', glyph);
+    glyphs.emplace(u'b', glyph);
+
+    auto shaping = cache.getShaping(key(u"ab"), bidi, glyphs);
+    ASSERT_TRUE(bool(shaping));
+    EXPECT_EQ(2u, shaping->positionedGlyphs.size());
+    EXPECT_EQ(shaping, cache.getShaping(key(u"ab"), bidi, glyphs));
+
+    // Text with glyphs that haven't been loaded is shaped again once they are.
+    auto partial = cache.getShaping(key(u"abc"), bidi, glyphs);
+    EXPECT_EQ(2u, partial->positionedGlyphs.size());
+    EXPECT_FALSE(bool(cache.find(key(u"abc"))));
+    EXPECT_EQ(1u, cache.getStats().shapings);
+}
@@ -0,0 +1,38 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/tiny_sdf.hpp>
+
+using namespace mbgl;
+
+TEST(TinySDF, Square) {
+    // A 4x4 square in the middle of a 12x12 raster.
+    AlphaImage raster({ 12, 12 });
+    for (uint32_t y = 4; y < 8; y++) {
+        for (uint32_t x = 4; x < 8; x++) {
+            raster.data[y * 12 + x] = 255;
+        }
+    }
+
+    const AlphaImage sdf = util::transformRasterToSDF(raster, 8, 0.25);
+    ASSERT_EQ(raster.size, sdf.size);
+
+    // The edge of the square is at 255 * (1 - cutoff), rising inside and falling outside.
+    const uint8_t edge = 191;
+    EXPECT_GT(sdf.data[5 * 12 + 5], edge);
+    EXPECT_LT(sdf.data[5 * 12 + 3], edge);
+    EXPECT_LT(sdf.data[5 * 12 + 0], sdf.data[5 * 12 + 3]);
+    EXPECT_EQ(sdf.data[5 * 12 + 5], sdf.data[6 * 12 + 6]);
+
+    // Pixels inside the square are one pixel away from the nearest one outside of it.
+    EXPECT_EQ(223, sdf.data[4 * 12 + 4]);
+}
+
+TEST(TinySDF, Empty) {
+    AlphaImage raster({ 8, 8 });
+    raster.fill(0);
+
+    const AlphaImage sdf = util::transformRasterToSDF(raster, 8, 0.25);
+    for (std::size_t i = 0; i < sdf.bytes(); i++) {
+        EXPECT_EQ(0, sdf.data[i]);
+    }
+}
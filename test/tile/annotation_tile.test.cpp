@@ -52,20 +52,25 @@ TEST(AnnotationTile, Issue8289) {
         {},
             std::make_unique<FeatureIndex>(),
             std::move(data),
-            0
+            0,
+            {},
+            {}
     });
 
     auto collisionTile = std::make_unique<CollisionTile>(PlacementConfig());
 
-    IndexedSubfeature subfeature { 0, "", "", 0 };
+    IndexedSubfeature subfeature { 0, 0, 0, 0 };
     CollisionFeature feature(GeometryCoordinates(), Anchor(0, 0, 0, 0), -5, 5, -5, 5, 1, 0, style::SymbolPlacementType::Point, subfeature, CollisionFeature::AlignmentType::Curved);
     collisionTile->insertFeature(feature, 0, true);
     collisionTile->placeFeature(feature, false, false);
 
     tile.onPlacement(GeometryTile::PlacementResult {
         {},
+            {},
             std::move(collisionTile),
-            0
+            nullptr,
+            0,
+            {}
     });
 
     // Simulate a second layout with empty data.
@@ -73,7 +78,9 @@ TEST(AnnotationTile, Issue8289) {
         {},
             std::make_unique<FeatureIndex>(),
             std::make_unique<AnnotationTileData>(),
-            0
+            0,
+            {},
+            {}
     });
 
     std::unordered_map<std::string, std::vector<Feature>> result;
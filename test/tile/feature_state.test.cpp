@@ -0,0 +1,55 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/tile/feature_state.hpp>
+#include <mbgl/tile/geojson_tile_data.hpp>
+
+using namespace mbgl;
+
+TEST(FeatureState, FeatureWithState) {
+    StubGeometryTileFeature feature { { { "color", std::string("red") }, { "width", 2.0 } } };
+    const PropertyMap state { { "color", std::string("green") } };
+    const FeatureWithState stateful { feature, state };
+
+    EXPECT_EQ(Value(std::string("green")), *stateful.getValue("color"));
+    EXPECT_EQ(Value(2.0), *stateful.getValue("width"));
+    EXPECT_FALSE(stateful.getValue("missing"));
+}
+
+TEST(FeatureState, Find) {
+    StubGeometryTileFeature feature { {} };
+    FeatureStateMap states { { FeatureIdentifier(uint64_t(1)), { { "a", 1.0 } } } };
+
+    // Features without an identifier have no state.
+    EXPECT_EQ(nullptr, findFeatureState(&states, feature));
+    EXPECT_EQ(nullptr, findFeatureState(nullptr, feature));
+
+    feature.id = FeatureIdentifier(uint64_t(1));
+    ASSERT_NE(nullptr, findFeatureState(&states, feature));
+    EXPECT_EQ(Value(1.0), findFeatureState(&states, feature)->at("a"));
+
+    feature.id = FeatureIdentifier(uint64_t(2));
+    EXPECT_EQ(nullptr, findFeatureState(&states, feature));
+}
+
+TEST(FeatureState, Differ) {
+    const mapbox::geometry::point<int16_t> point { 0, 0 };
+    mapbox::geometry::feature_collection<int16_t> features;
+    features.push_back({ point, {}, { uint64_t(1) } });
+    features.push_back({ point, {}, { uint64_t(2) } });
+    const GeoJSONTileData data { features };
+
+    const FeatureStateMap before { { FeatureIdentifier(uint64_t(1)), { { "a", 1.0 } } },
+                                   { FeatureIdentifier(uint64_t(3)), { { "a", 1.0 } } } };
+    FeatureStateMap after = before;
+    EXPECT_FALSE(featureStatesDiffer(data, &before, &after));
+
+    // Changes to features that the tile doesn't have don't matter.
+    after[FeatureIdentifier(uint64_t(3))] = { { "a", 2.0 } };
+    EXPECT_FALSE(featureStatesDiffer(data, &before, &after));
+
+    after[FeatureIdentifier(uint64_t(2))] = { { "a", 2.0 } };
+    EXPECT_TRUE(featureStatesDiffer(data, &before, &after));
+    EXPECT_TRUE(featureStatesDiffer(data, &before, nullptr));
+    EXPECT_FALSE(featureStatesDiffer(data, nullptr, nullptr));
+}
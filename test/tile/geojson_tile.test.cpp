@@ -2,6 +2,7 @@
 #include <mbgl/test/fake_file_source.hpp>
 #include <mbgl/test/stub_tile_observer.hpp>
 #include <mbgl/tile/geojson_tile.hpp>
+#include <mbgl/tile/geojson_tile_data.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
 
 #include <mbgl/util/default_thread_pool.hpp>
@@ -70,3 +71,39 @@ TEST(GeoJSONTile, Issue7648) {
         test.loop.runOnce();
     }
 }
+
+TEST(GeoJSONTile, EncodedData) {
+    mapbox::geometry::feature_collection<int16_t> features;
+    features.push_back(mapbox::geometry::feature<int16_t> {
+        mapbox::geometry::multi_point<int16_t> { { 1, 2 }, { 3, 4 } },
+        PropertyMap { { "name", std::string("points") }, { "rank", uint64_t(1) } },
+        { FeatureIdentifier { uint64_t(7) } }
+    });
+    features.push_back(mapbox::geometry::feature<int16_t> {
+        mapbox::geometry::multi_line_string<int16_t> { { { 0, 0 }, { 1, 1 } }, { { 2, 2 }, { 3, 3 }, { 4, 4 } } },
+        PropertyMap { { "rank", uint64_t(2) } }
+    });
+
+    GeoJSONTileData data(features);
+    const std::unique_ptr<GeometryTileData> copy = data.clone();
+    const GeometryTileLayer* layer = copy->getLayer("anything");
+    ASSERT_NE(nullptr, layer);
+    ASSERT_EQ(2u, layer->featureCount());
+
+    auto points = layer->getFeature(0);
+    EXPECT_EQ(FeatureType::Point, points->getType());
+    EXPECT_EQ(FeatureIdentifier { uint64_t(7) }, *points->getID());
+    EXPECT_EQ(Value { std::string("points") }, *points->getValue("name"));
+    EXPECT_EQ(2u, points->getProperties().size());
+    EXPECT_EQ((GeometryCollection { { { 1, 2 }, { 3, 4 } } }), points->getGeometries());
+
+    auto lines = layer->getFeature(1);
+    EXPECT_EQ(FeatureType::LineString, lines->getType());
+    EXPECT_FALSE(lines->getID());
+    EXPECT_FALSE(lines->getValue("name"));
+    EXPECT_EQ(Value { uint64_t(2) }, *lines->getValue("rank"));
+    EXPECT_EQ((GeometryCollection { { { 0, 0 }, { 1, 1 } }, { { 2, 2 }, { 3, 3 }, { 4, 4 } } }), lines->getGeometries());
+
+    // Copies share the encoding rather than copying the features.
+    EXPECT_EQ(data.getByteSize(), copy->getByteSize());
+}
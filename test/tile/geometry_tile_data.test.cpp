@@ -38,6 +38,28 @@ TEST(GeometryTileData, classifyRings2) {
     ASSERT_EQ(polygons[0].size(), 2u);
 }
 
+TEST(GeometryTileData, classifyRingsReused) {
+    std::vector<GeometryCollection> polygons;
+
+    // Two polygons, the first with a hole.
+    EXPECT_EQ(2u, classifyRings({
+      { {0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0} },
+      { {10, 10}, {20, 10}, {20, 20}, {10, 10} },
+      { {50, 0}, {50, 40}, {90, 40}, {90, 0}, {50, 0} }
+    }, polygons));
+    ASSERT_EQ(2u, polygons[0].size());
+    ASSERT_EQ(1u, polygons[1].size());
+    EXPECT_EQ(50, polygons[1][0][0].x);
+
+    // The rings of a single polygon replace those of the earlier call.
+    const GeometryCollection square = {
+      { {0, 0}, {0, 10}, {10, 10}, {10, 0}, {0, 0} }
+    };
+    EXPECT_EQ(1u, classifyRings(square, polygons));
+    EXPECT_EQ(square, polygons[0]);
+    EXPECT_EQ(classifyRings(square)[0], polygons[0]);
+}
+
 TEST(GeometryTileData, limitHoles1) {
     GeometryCollection polygon = {
       { {0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0} },
@@ -0,0 +1,214 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_file_source.hpp>
+#include <mbgl/test/stub_tile_observer.hpp>
+
+#include <mbgl/tile/overzoom_bucket_cache.hpp>
+#include <mbgl/tile/geometry_tile.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/annotation/annotation_manager.hpp>
+#include <mbgl/map/transform_state.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/style/update_parameters.hpp>
+#include <mbgl/util/buffer.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <memory>
+#include <string>
+
+using namespace mbgl;
+
+namespace {
+
+class StubBucket : public Bucket {
+public:
+    void upload(gl::Context&) override {}
+    void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override {}
+    bool hasData() const override { return true; }
+    std::size_t getByteSize() const override { return 0; }
+};
+
+std::shared_ptr<const OverzoomBucketCache::Entry> entry(const std::string& data) {
+    auto result = std::make_shared<OverzoomBucketCache::Entry>();
+    result->data = std::make_shared<Buffer>(data);
+    result->bucket = std::make_unique<StubBucket>();
+    return result;
+}
+
+} // namespace
+
+TEST(OverzoomBucketCache, Find) {
+    OverzoomBucketCache cache;
+
+    auto a = entry("tile a");
+    cache.add("a", a);
+    EXPECT_EQ(a, cache.find("a", Buffer("tile a")));
+
+    // Buckets of other tile data are not returned.
+    EXPECT_FALSE(bool(cache.find("a", Buffer("tile b"))));
+    EXPECT_FALSE(bool(cache.find("b", Buffer("tile a"))));
+
+    EXPECT_EQ(1u, cache.getStats().hits);
+    EXPECT_EQ(2u, cache.getStats().misses);
+}
+
+TEST(OverzoomBucketCache, Expire) {
+    OverzoomBucketCache cache;
+
+    auto a = entry("tile a");
+    cache.add("a", a);
+    EXPECT_EQ(1u, cache.getStats().entries);
+
+    // Buckets are dropped once no tile holds them.
+    a.reset();
+    EXPECT_FALSE(bool(cache.find("a", Buffer("tile a"))));
+
+    auto b = entry("tile b");
+    cache.add("b", b);
+    EXPECT_EQ(1u, cache.getStats().entries);
+
+    // Those that aren't looked up again are dropped by later additions.
+    for (int i = 0; i < 1000; i++) {
+        cache.add(std::to_string(i), entry("tile"));
+    }
+    EXPECT_LT(cache.getStats().entries, 100u);
+    EXPECT_EQ(b, cache.find("b", Buffer("tile b")));
+}
+
+namespace {
+
+class StubGeometryTile : public GeometryTile {
+public:
+    using GeometryTile::GeometryTile;
+    void setNecessity(Necessity) final {}
+};
+
+// Lays out overscaled tiles of one canonical tile on a worker, with a fill layer of the style.
+class OverzoomTest {
+public:
+    OverzoomTest(const std::string& fillColor) {
+        style.setJSON(R"STYLE({
+  "version": 8,
+  "sources": {
+    "source": { "type": "vector", "tiles": [ "tiles" ] }
+  },
+  "layers": [{
+    "id": "fill",
+    "type": "fill",
+    "source": "source",
+    "source-layer": "building",
+    "paint": { "fill-color": )STYLE" + fillColor + R"STYLE( }
+  }]
+})STYLE");
+        const TimePoint now = Clock::now();
+        style.cascade(now, MapMode::Continuous);
+        style.recalculate(12, now, MapMode::Continuous);
+    }
+
+    // Returns the tile once its worker has laid it out.
+    std::unique_ptr<StubGeometryTile> layOut(uint8_t overscaledZ, const FeatureStates& states = {}) {
+        auto tile = std::make_unique<StubGeometryTile>(OverscaledTileID(overscaledZ, canonical), "source", updateParameters);
+        tile->setObserver(&observer);
+        observer.tileChanged = [&] (Tile&) {
+            loop.stop();
+        };
+        tile->setFeatureStates(states);
+        tile->setData(std::make_shared<VectorTileData>(data));
+        loop.run();
+        return tile;
+    }
+
+    Bucket* bucket(GeometryTile& tile) {
+        return tile.getBucket(*style.getLayer("fill"));
+    }
+
+    util::RunLoop loop;
+    StubFileSource fileSource;
+    TransformState transformState;
+    ThreadPool threadPool { 1 };
+    AnnotationManager annotationManager { 1.0 };
+    style::Style style { fileSource, 1.0 };
+    StubTileObserver observer;
+
+    style::UpdateParameters updateParameters {
+        1.0,
+        MapDebugOptions(),
+        transformState,
+        threadPool,
+        fileSource,
+        MapMode::Continuous,
+        annotationManager,
+        style
+    };
+
+    const CanonicalTileID canonical { 10, 163, 395 };
+    const std::shared_ptr<const Buffer> data = std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+};
+
+} // namespace
+
+TEST(OverzoomBucketCache, OverscaledTilesShareBuckets) {
+    OverzoomTest test(R"("#ff0000")");
+    const auto before = OverzoomBucketCache::get().getStats();
+
+    // The first overscaled tile lays the group out and keeps a copy of its bucket, which the
+    // next one copies.
+    auto first = test.layOut(11);
+    ASSERT_NE(nullptr, test.bucket(*first));
+    EXPECT_EQ(before.hits, OverzoomBucketCache::get().getStats().hits);
+    EXPECT_EQ(before.misses + 1, OverzoomBucketCache::get().getStats().misses);
+
+    auto second = test.layOut(12);
+    ASSERT_NE(nullptr, test.bucket(*second));
+    EXPECT_EQ(before.hits + 1, OverzoomBucketCache::get().getStats().hits);
+    EXPECT_EQ(before.misses + 1, OverzoomBucketCache::get().getStats().misses);
+
+    // Each tile has its own copy, which it uploads itself.
+    EXPECT_NE(test.bucket(*first), test.bucket(*second));
+    EXPECT_EQ(test.bucket(*first)->getByteSize(), test.bucket(*second)->getByteSize());
+
+    // The copy is dropped with the tiles, so the next one lays the group out again.
+    first.reset();
+    second.reset();
+    auto third = test.layOut(13);
+    ASSERT_NE(nullptr, test.bucket(*third));
+    EXPECT_EQ(before.hits + 1, OverzoomBucketCache::get().getStats().hits);
+    EXPECT_EQ(before.misses + 2, OverzoomBucketCache::get().getStats().misses);
+}
+
+TEST(OverzoomBucketCache, ZoomDependentBucketsAreNotShared) {
+    // Composite functions interpolate between the zoom levels of the tile.
+    OverzoomTest test(R"({
+      "property": "height",
+      "stops": [[{ "zoom": 0, "value": 0 }, "#000000"], [{ "zoom": 20, "value": 100 }, "#ffffff"]]
+    })");
+    const auto before = OverzoomBucketCache::get().getStats();
+
+    auto first = test.layOut(11);
+    ASSERT_NE(nullptr, test.bucket(*first));
+    auto second = test.layOut(12);
+    ASSERT_NE(nullptr, test.bucket(*second));
+
+    EXPECT_EQ(before.hits, OverzoomBucketCache::get().getStats().hits);
+    EXPECT_EQ(before.misses + 2, OverzoomBucketCache::get().getStats().misses);
+    EXPECT_EQ(before.entries, OverzoomBucketCache::get().getStats().entries);
+}
+
+TEST(OverzoomBucketCache, BucketsWithFeatureStatesAreNotShared) {
+    OverzoomTest test(R"("#ff0000")");
+    const auto before = OverzoomBucketCache::get().getStats();
+
+    const FeatureStates states { { "building", std::make_shared<const FeatureStateMap>() } };
+    auto first = test.layOut(11, states);
+    ASSERT_NE(nullptr, test.bucket(*first));
+    auto second = test.layOut(12, states);
+    ASSERT_NE(nullptr, test.bucket(*second));
+
+    // The cache isn't even looked up.
+    EXPECT_EQ(before.hits, OverzoomBucketCache::get().getStats().hits);
+    EXPECT_EQ(before.misses, OverzoomBucketCache::get().getStats().misses);
+    EXPECT_EQ(before.entries, OverzoomBucketCache::get().getStats().entries);
+}
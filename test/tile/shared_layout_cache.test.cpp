@@ -0,0 +1,84 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/shared_layout_cache.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/util/buffer.hpp>
+
+using namespace mbgl;
+
+class FakeBucket : public Bucket {
+public:
+    FakeBucket(std::size_t bytes_) : bytes(bytes_) {}
+
+    void upload(gl::Context&) override {}
+    void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override {}
+    bool hasData() const override { return true; }
+    std::size_t getByteSize() const override { return bytes; }
+
+    const std::size_t bytes;
+};
+
+static std::shared_ptr<const SharedLayoutCache::Layout> layout(const std::string& data, std::size_t bytes) {
+    auto result = std::make_shared<SharedLayoutCache::Layout>();
+    result->data = std::make_shared<Buffer>(data);
+    result->buckets.emplace_back(std::vector<std::string> { "layer" }, std::make_unique<FakeBucket>(bytes));
+    result->featureIndex = std::make_unique<FeatureIndex>();
+    return result;
+}
+
+TEST(SharedLayoutCache, Disabled) {
+    SharedLayoutCache cache;
+    EXPECT_FALSE(cache.isEnabled());
+
+    cache.add("a", layout("a", 10));
+    EXPECT_FALSE(bool(cache.find("a", Buffer("a"))));
+    EXPECT_EQ(0u, cache.getStats().layouts);
+}
+
+TEST(SharedLayoutCache, Find) {
+    SharedLayoutCache cache;
+    cache.setMaximumBytes(1 << 20);
+    EXPECT_TRUE(cache.isEnabled());
+
+    cache.add("a", layout("tile a", 10));
+    EXPECT_TRUE(bool(cache.find("a", Buffer("tile a"))));
+
+    // Layouts of other tile data are not returned.
+    EXPECT_FALSE(bool(cache.find("a", Buffer("tile b"))));
+    EXPECT_FALSE(bool(cache.find("b", Buffer("tile a"))));
+
+    EXPECT_EQ(1u, cache.getStats().hits);
+    EXPECT_EQ(2u, cache.getStats().misses);
+    EXPECT_EQ(1u, cache.getStats().layouts);
+
+    cache.clear();
+    EXPECT_FALSE(bool(cache.find("a", Buffer("tile a"))));
+    EXPECT_EQ(0u, cache.getStats().bytes);
+}
+
+TEST(SharedLayoutCache, Evict) {
+    SharedLayoutCache cache;
+    const std::size_t base = layout("a", 0)->getByteSize();
+    cache.setMaximumBytes(2 * base + 100);
+
+    cache.add("a", layout("a", 40));
+    cache.add("b", layout("b", 40));
+    EXPECT_TRUE(bool(cache.find("a", Buffer("a"))));
+
+    // Evicts the least recently used layout.
+    cache.add("c", layout("c", 40));
+    EXPECT_TRUE(bool(cache.find("a", Buffer("a"))));
+    EXPECT_FALSE(bool(cache.find("b", Buffer("b"))));
+    EXPECT_TRUE(bool(cache.find("c", Buffer("c"))));
+    EXPECT_EQ(1u, cache.getStats().evictions);
+
+    // Layouts larger than the cache are not stored.
+    cache.add("d", layout("d", 2 * base + 100));
+    EXPECT_FALSE(bool(cache.find("d", Buffer("d"))));
+    EXPECT_EQ(2u, cache.getStats().layouts);
+
+    cache.setMaximumBytes(0);
+    EXPECT_EQ(0u, cache.getStats().layouts);
+    EXPECT_EQ(3u, cache.getStats().evictions);
+}
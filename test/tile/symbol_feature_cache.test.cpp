@@ -0,0 +1,44 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/layout/symbol_feature_cache.hpp>
+#include <mbgl/util/buffer.hpp>
+
+using namespace mbgl;
+
+static std::shared_ptr<const SymbolFeatureCache::Features> features(const std::string& data) {
+    auto result = std::make_shared<SymbolFeatureCache::Features>();
+    result->data = std::make_shared<Buffer>(data);
+    result->iconDependencies.insert("park");
+    return result;
+}
+
+TEST(SymbolFeatureCache, Find) {
+    SymbolFeatureCache cache;
+
+    auto a = features("tile a");
+    cache.add("a", a);
+    EXPECT_EQ(a, cache.find("a", Buffer("tile a")));
+
+    // Features of other tile data are not returned.
+    EXPECT_FALSE(bool(cache.find("a", Buffer("tile b"))));
+    EXPECT_FALSE(bool(cache.find("b", Buffer("tile a"))));
+
+    EXPECT_EQ(1u, cache.getStats().hits);
+    EXPECT_EQ(2u, cache.getStats().misses);
+}
+
+TEST(SymbolFeatureCache, Expire) {
+    SymbolFeatureCache cache;
+
+    auto a = features("tile a");
+    cache.add("a", a);
+    EXPECT_EQ(1u, cache.getStats().entries);
+
+    // Features are dropped once no layout holds them.
+    a.reset();
+    EXPECT_FALSE(bool(cache.find("a", Buffer("tile a"))));
+
+    auto b = features("tile b");
+    cache.add("b", b);
+    EXPECT_EQ(1u, cache.getStats().entries);
+}
@@ -0,0 +1,120 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/tile_cache.hpp>
+#include <mbgl/tile/tile.hpp>
+
+using namespace mbgl;
+
+class FakeTile : public Tile {
+public:
+    FakeTile(const OverscaledTileID& id_, std::size_t bytes_)
+        : Tile(id_), bytes(bytes_) {
+        availableData = DataAvailability::All;
+    }
+
+    void setNecessity(Necessity) override {}
+    void cancel() override {}
+    Bucket* getBucket(const style::Layer&) override { return nullptr; }
+    std::size_t getByteSize() const override { return bytes; }
+
+    const std::size_t bytes;
+};
+
+static std::unique_ptr<Tile> tile(uint32_t x, std::size_t bytes = 1) {
+    return std::make_unique<FakeTile>(OverscaledTileID { 3, x, 0 }, bytes);
+}
+
+TEST(TileCache, Size) {
+    TileCache cache(2);
+
+    cache.add({ 3, 0, 0 }, tile(0));
+    cache.add({ 3, 1, 0 }, tile(1));
+    cache.add({ 3, 2, 0 }, tile(2));
+
+    EXPECT_FALSE(cache.has({ 3, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 3, 1, 0 }));
+    EXPECT_TRUE(cache.has({ 3, 2, 0 }));
+
+    // Re-adding a tile makes it the newest.
+    cache.add({ 3, 1, 0 }, tile(1));
+    cache.add({ 3, 3, 0 }, tile(3));
+    EXPECT_TRUE(cache.has({ 3, 1, 0 }));
+    EXPECT_FALSE(cache.has({ 3, 2, 0 }));
+
+    cache.setSize(1);
+    EXPECT_FALSE(cache.has({ 3, 1, 0 }));
+    EXPECT_TRUE(cache.has({ 3, 3, 0 }));
+
+    EXPECT_TRUE(bool(cache.get({ 3, 3, 0 })));
+    EXPECT_FALSE(bool(cache.get({ 3, 3, 0 })));
+
+    EXPECT_EQ(1u, cache.getStats().hits);
+    EXPECT_EQ(1u, cache.getStats().misses);
+    EXPECT_EQ(3u, cache.getStats().evictions);
+    EXPECT_EQ(0u, cache.getStats().tiles);
+}
+
+TEST(TileCache, Budget) {
+    auto budget = std::make_shared<TileCache::Budget>(100);
+    TileCache a(10);
+    TileCache b(10);
+    a.setBudget(budget);
+    b.setBudget(budget);
+
+    a.add({ 3, 0, 0 }, tile(0, 40));
+    b.add({ 3, 1, 0 }, tile(1, 40));
+    a.add({ 3, 2, 0 }, tile(2, 10));
+    EXPECT_EQ(3u, budget->getStats().tiles);
+    EXPECT_EQ(90u, budget->getStats().bytes);
+
+    // Evicts the oldest tile, which belongs to the other cache.
+    b.add({ 3, 3, 0 }, tile(3, 50));
+    EXPECT_FALSE(a.has({ 3, 0, 0 }));
+    EXPECT_TRUE(b.has({ 3, 1, 0 }));
+    EXPECT_EQ(100u, budget->getStats().bytes);
+    EXPECT_EQ(10u, a.getStats().bytes);
+    EXPECT_EQ(90u, b.getStats().bytes);
+
+    // Tiles larger than the budget are not cached at all.
+    a.add({ 3, 4, 0 }, tile(4, 101));
+    EXPECT_FALSE(a.has({ 3, 4, 0 }));
+    EXPECT_TRUE(a.has({ 3, 2, 0 }));
+
+    budget->setMaximumBytes(60);
+    EXPECT_FALSE(b.has({ 3, 1, 0 }));
+    EXPECT_TRUE(a.has({ 3, 2, 0 }));
+    EXPECT_TRUE(b.has({ 3, 3, 0 }));
+
+    EXPECT_TRUE(bool(b.get({ 3, 3, 0 })));
+    EXPECT_FALSE(bool(a.get({ 3, 3, 0 })));
+    EXPECT_EQ(1u, budget->getStats().hits);
+    EXPECT_EQ(1u, budget->getStats().misses);
+    EXPECT_EQ(3u, budget->getStats().evictions);
+    EXPECT_EQ(10u, budget->getStats().bytes);
+
+    a.add({ 3, 5, 0 }, tile(5, 10));
+    a.setBudget(nullptr);
+    EXPECT_EQ(0u, budget->getStats().tiles);
+    EXPECT_TRUE(a.has({ 3, 5, 0 }));
+}
+
+TEST(TileCache, ClearIf) {
+    auto budget = std::make_shared<TileCache::Budget>(100);
+    TileCache cache(10);
+    cache.setBudget(budget);
+
+    cache.add({ 3, 0, 0 }, tile(0, 10));
+    cache.add({ 3, 1, 0 }, tile(1, 20));
+    cache.add({ 3, 2, 0 }, tile(2, 30));
+
+    cache.clear([] (const OverscaledTileID& id) {
+        return id.canonical.x != 1;
+    });
+    EXPECT_FALSE(cache.has({ 3, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 3, 1, 0 }));
+    EXPECT_FALSE(cache.has({ 3, 2, 0 }));
+    EXPECT_EQ(1u, cache.getStats().tiles);
+    EXPECT_EQ(20u, cache.getStats().bytes);
+    EXPECT_EQ(0u, cache.getStats().evictions);
+    EXPECT_EQ(20u, budget->getStats().bytes);
+}
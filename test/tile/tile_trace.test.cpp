@@ -0,0 +1,76 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/tile_trace.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+using namespace mbgl;
+
+TEST(TileTrace, MaxEvents) {
+    TileTrace trace;
+    const TimePoint start = Clock::now();
+    for (std::size_t i = 0; i < TileTrace::MaxEvents + 10; i++) {
+        trace.add(TileTrace::Layout, start + Milliseconds(i), start + Milliseconds(i + 1));
+    }
+
+    ASSERT_EQ(TileTrace::MaxEvents, trace.getEvents().size());
+    EXPECT_EQ(start + Milliseconds(10), trace.getEvents().front().start);
+    EXPECT_EQ(Milliseconds(1), trace.getEvents().front().duration);
+}
+
+TEST(TileTrace, Request) {
+    const TimePoint requested = Clock::now();
+
+    TileTrace cached;
+    cached.addRequest(requested, Response());
+    ASSERT_EQ(1u, cached.getEvents().size());
+    EXPECT_STREQ(TileTrace::Request, cached.getEvents()[0].name);
+
+    auto timing = std::make_unique<Response::Timing>();
+    timing->queued = requested + Milliseconds(1);
+    timing->started = requested + Milliseconds(3);
+    timing->finished = requested + Milliseconds(10);
+    timing->store = Milliseconds(2);
+
+    Response response;
+    response.timing = std::move(timing);
+
+    TileTrace online;
+    online.addRequest(requested, response);
+    ASSERT_EQ(4u, online.getEvents().size());
+    EXPECT_STREQ(TileTrace::Queue, online.getEvents()[0].name);
+    EXPECT_EQ(Milliseconds(2), online.getEvents()[0].duration);
+    EXPECT_STREQ(TileTrace::Network, online.getEvents()[1].name);
+    EXPECT_EQ(Milliseconds(7), online.getEvents()[1].duration);
+    EXPECT_STREQ(TileTrace::Store, online.getEvents()[2].name);
+    EXPECT_EQ(requested + Milliseconds(10), online.getEvents()[2].start);
+    EXPECT_EQ(Milliseconds(2), online.getEvents()[2].duration);
+    EXPECT_STREQ(TileTrace::Request, online.getEvents()[3].name);
+}
+
+TEST(TileTrace, ChromeTrace) {
+    TileTrace trace;
+    const TimePoint start = Clock::now();
+    trace.add(TileTrace::Layout, start, start + Milliseconds(5));
+    trace.add(TileTrace::Place, start + Milliseconds(5), start + Milliseconds(6), "labels");
+
+    JSDocument document;
+    document.Parse<0>(encodeChromeTrace({ { "source 1/0/0", &trace } }).c_str());
+    ASSERT_FALSE(document.HasParseError());
+
+    const JSValue& events = document["traceEvents"];
+    ASSERT_TRUE(events.IsArray());
+    ASSERT_EQ(3u, events.Size());
+
+    EXPECT_STREQ("M", events[0]["ph"].GetString());
+    EXPECT_STREQ("source 1/0/0", events[0]["args"]["name"].GetString());
+
+    EXPECT_STREQ("layout", events[1]["name"].GetString());
+    EXPECT_STREQ("X", events[1]["ph"].GetString());
+    EXPECT_EQ(5000, events[1]["dur"].GetInt64());
+    EXPECT_EQ(events[0]["tid"].GetInt(), events[1]["tid"].GetInt());
+    EXPECT_FALSE(events[1].HasMember("args"));
+
+    EXPECT_STREQ("place", events[2]["name"].GetString());
+    EXPECT_STREQ("labels", events[2]["args"]["layer"].GetString());
+}
@@ -2,11 +2,16 @@
 #include <mbgl/test/fake_file_source.hpp>
 #include <mbgl/tile/vector_tile.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/tile/property_columns.hpp>
 
 #include <mbgl/util/default_thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/style/style.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/query.hpp>
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
@@ -16,6 +21,8 @@
 #include <mbgl/annotation/annotation_manager.hpp>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 using namespace mbgl;
 
@@ -28,6 +35,7 @@ public:
     AnnotationManager annotationManager { 1.0 };
     style::Style style { fileSource, 1.0 };
     Tileset tileset { { "https://example.com" }, { 0, 22 }, "none" };
+    VectorTileDataCache dataCache;
 
     style::UpdateParameters updateParameters {
         1.0,
@@ -43,21 +51,21 @@ public:
 
 TEST(VectorTile, setError) {
     VectorTileTest test;
-    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset, test.dataCache);
     tile.setError(std::make_exception_ptr(std::runtime_error("test")));
     EXPECT_FALSE(tile.isRenderable());
 }
 
 TEST(VectorTile, onError) {
     VectorTileTest test;
-    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset, test.dataCache);
     tile.onError(std::make_exception_ptr(std::runtime_error("test")));
     EXPECT_TRUE(tile.isRenderable());
 }
 
 TEST(VectorTile, Issue7615) {
     VectorTileTest test;
-    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset, test.dataCache);
 
     style::SymbolLayer symbolLayer("symbol", "source");
     auto symbolBucket = std::make_shared<SymbolBucket>(
@@ -73,8 +81,11 @@ TEST(VectorTile, Issue7615) {
             symbolLayer.getID(),
             symbolBucket
         }},
+        {},
+        nullptr,
         nullptr,
-        0
+        0,
+        {}
     });
 
     // Subsequent onLayout should not cause the existing symbol bucket to be discarded.
@@ -82,7 +93,9 @@ TEST(VectorTile, Issue7615) {
         {},
         nullptr,
         nullptr,
-        0
+        0,
+        {},
+        {}
     });
 
     EXPECT_EQ(symbolBucket.get(), tile.getBucket(symbolLayer));
@@ -90,9 +103,223 @@ TEST(VectorTile, Issue7615) {
 
 TEST(VectorTile, Issue8542) {
     VectorTileTest test;
-    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset, test.dataCache);
 
     // Query before data is set
     std::vector<Feature> result;
     tile.querySourceFeatures(result, { { {"layer"} }, {} });
 }
+
+TEST(VectorTile, SharedData) {
+    VectorTileDataCache cache;
+    auto buffer = std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf"));
+
+    // Tiles overscaled from a canonical tile share its parsed data, even if their bytes were
+    // loaded separately.
+    std::shared_ptr<const VectorTileData> data = cache.get({ 10, 163, 395 }, buffer);
+    EXPECT_EQ(data, cache.get({ 10, 163, 395 }, buffer));
+    EXPECT_EQ(data, cache.get({ 10, 163, 395 }, std::make_shared<Buffer>(buffer->toString())));
+    EXPECT_NE(data, cache.get({ 10, 163, 396 }, buffer));
+
+    // Data that changed is parsed again.
+    std::shared_ptr<const VectorTileData> changed = cache.get({ 10, 163, 395 }, std::make_shared<Buffer>(std::string("changed")));
+    EXPECT_NE(data, changed);
+    EXPECT_EQ(changed, cache.get({ 10, 163, 395 }, std::make_shared<Buffer>(std::string("changed"))));
+}
+
+TEST(VectorTileData, ParseLayers) {
+    VectorTileData data(std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+
+    EXPECT_EQ(nullptr, data.getLayer("nonexistent"));
+
+    const GeometryTileLayer* layer = data.getLayer("road");
+    ASSERT_NE(nullptr, layer);
+    EXPECT_EQ("road", layer->getName());
+    EXPECT_EQ(layer, data.getLayer("road"));
+    ASSERT_GT(layer->featureCount(), 0u);
+
+    // Values are decoded on request, and agree with the full property map.
+    for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+        auto feature = layer->getFeature(i);
+        const PropertyMap properties = feature->getProperties();
+        for (const auto& property : properties) {
+            EXPECT_EQ(property.second, *feature->getValue(property.first));
+        }
+        EXPECT_FALSE(feature->getValue("nonexistent"));
+    }
+
+    // Clones are independent of the original's parsed layers.
+    auto clone = data.clone();
+    const GeometryTileLayer* cloneLayer = clone->getLayer("road");
+    ASSERT_NE(nullptr, cloneLayer);
+    EXPECT_NE(layer, cloneLayer);
+    EXPECT_EQ(layer->featureCount(), cloneLayer->featureCount());
+}
+
+TEST(VectorTileData, MatchingFeatures) {
+    using namespace style;
+
+    VectorTileData data(std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    const GeometryTileLayer* layer = data.getLayer("road");
+    ASSERT_NE(nullptr, layer);
+
+    const std::vector<Filter> filters = {
+        NullFilter {},
+        EqualsFilter { "class", std::string("ferry") },
+        NotEqualsFilter { "class", std::string("ferry") },
+        EqualsFilter { "class", int64_t(1) },
+        InFilter { "class", { std::string("motorway"), std::string("primary") } },
+        NotInFilter { "class", { std::string("ferry"), uint64_t(1) } },
+        HasFilter { "oneway" },
+        NotHasFilter { "class" },
+        LessThanFilter { "class", std::string("motorway") },
+        TypeEqualsFilter { FeatureType::LineString },
+        AllFilter { { TypeEqualsFilter { FeatureType::LineString }, EqualsFilter { "class", std::string("motorway") } } },
+        AnyFilter { { EqualsFilter { "class", std::string("primary") }, HasFilter { "nonexistent" } } },
+        NoneFilter { { InFilter { "class", { std::string("ferry"), std::string("motorway") } } } },
+    };
+
+    // Filtering encoded features agrees with filtering materialized ones.
+    for (const auto& filter : filters) {
+        const CompiledFilter compiled(filter);
+        std::size_t matches = 0;
+        for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+            auto feature = layer->getFeature(i);
+            auto matching = layer->getMatchingFeature(i, compiled);
+            EXPECT_EQ(filter(*feature), bool(matching));
+            if (matching) {
+                EXPECT_EQ(feature->getProperties(), matching->getProperties());
+                ++matches;
+            }
+        }
+        if (filter.is<NullFilter>()) {
+            EXPECT_EQ(layer->featureCount(), matches);
+        }
+    }
+}
+
+TEST(VectorTileData, ReadGeometries) {
+    VectorTileData data(std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+
+    // Reading the features of layers of all types into the same collection yields the same
+    // geometries as getting them anew.
+    GeometryCollection geometries;
+    for (const auto& name : { "road", "building", "poi_label" }) {
+        const GeometryTileLayer* layer = data.getLayer(name);
+        ASSERT_NE(nullptr, layer);
+        for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+            auto feature = layer->getFeature(i);
+            feature->readGeometries(geometries);
+            EXPECT_EQ(feature->getGeometries(), geometries);
+        }
+    }
+}
+
+namespace {
+
+void appendVarint(std::string& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+void appendMessage(std::string& out, uint32_t tag, const std::string& message) {
+    appendVarint(out, (tag << 3) | 2);
+    appendVarint(out, message.size());
+    out += message;
+}
+
+// A tile with a layer named "test" of one polygon with the given geometry, followed by the
+// raw bytes of the suffix.
+std::string polygonTile(uint32_t extent, const std::vector<uint32_t>& geometry, const std::string& suffix = "") {
+    std::string packed;
+    for (uint32_t value : geometry) {
+        appendVarint(packed, value);
+    }
+    packed += suffix;
+
+    std::string feature;
+    appendVarint(feature, (3 << 3) | 0); // type
+    appendVarint(feature, 3);
+    appendMessage(feature, 4, packed);   // geometry
+
+    std::string layer;
+    appendVarint(layer, (15 << 3) | 0);  // version
+    appendVarint(layer, 2);
+    appendMessage(layer, 1, "test");     // name
+    appendMessage(layer, 2, feature);    // features
+    appendVarint(layer, (5 << 3) | 0);   // extent
+    appendVarint(layer, extent);
+
+    std::string tile;
+    appendMessage(tile, 3, layer);
+    return tile;
+}
+
+uint32_t zigzag(int32_t value) {
+    return (uint32_t(value) << 1) ^ uint32_t(value >> 31);
+}
+
+} // namespace
+
+TEST(VectorTileData, DecodeGeometry) {
+    // Deltas of one, two and three bytes, and a second ring.
+    const std::vector<uint32_t> geometry {
+        (1 << 3) | 1, zigzag(10), zigzag(20),
+        (3 << 3) | 2, zigzag(300), zigzag(0), zigzag(0), zigzag(20000), zigzag(-300), zigzag(0),
+        (1 << 3) | 7,
+        (1 << 3) | 1, zigzag(40), zigzag(-19900),
+        (2 << 3) | 2, zigzag(100), zigzag(0), zigzag(0), zigzag(100),
+        (1 << 3) | 7,
+    };
+
+    const GeometryCollection expected {
+        { { 10, 20 }, { 310, 20 }, { 310, 20020 }, { 10, 20020 }, { 10, 20 } },
+        { { 50, 120 }, { 150, 120 }, { 150, 220 }, { 50, 120 } },
+    };
+
+    VectorTileData data(std::make_shared<Buffer>(polygonTile(util::EXTENT, geometry)));
+    const GeometryTileLayer* layer = data.getLayer("test");
+    ASSERT_NE(nullptr, layer);
+    ASSERT_EQ(1u, layer->featureCount());
+    EXPECT_EQ(expected, layer->getFeature(0)->getGeometries());
+
+    // Tiles with another extent are scaled to ours.
+    VectorTileData scaled(std::make_shared<Buffer>(polygonTile(util::EXTENT * 2, geometry)));
+    const GeometryCollection halved {
+        { { 5, 10 }, { 155, 10 }, { 155, 10010 }, { 5, 10010 }, { 5, 10 } },
+        { { 25, 60 }, { 75, 60 }, { 75, 110 }, { 25, 60 } },
+    };
+    EXPECT_EQ(halved, scaled.getLayer("test")->getFeature(0)->getGeometries());
+
+    // Geometry that ends in the middle of a varint is an error.
+    VectorTileData invalid(std::make_shared<Buffer>(
+        polygonTile(util::EXTENT, { (1 << 3) | 1, zigzag(10) }, "\x81")));
+    EXPECT_ANY_THROW(invalid.getLayer("test")->getFeature(0)->getGeometries());
+}
+
+TEST(VectorTileData, DecodeProperties) {
+    VectorTileData data(std::make_shared<Buffer>(
+        util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf")));
+    const GeometryTileLayer* layer = data.getLayer("road");
+    ASSERT_NE(nullptr, layer);
+
+    // Decoding the columns of all features at once agrees with looking the keys up one by one,
+    // including for keys that the layer doesn't have.
+    PropertyColumns columns({ "class", "oneway", "nonexistent" }, layer->featureCount());
+    layer->decodeProperties(columns);
+
+    for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+        auto feature = layer->getFeature(i);
+        const ColumnarFeature columnar(*feature, columns, i);
+        for (const auto& key : { "class", "oneway", "nonexistent", "type" }) {
+            EXPECT_EQ(feature->getValue(key), columnar.getValue(key));
+        }
+    }
+}
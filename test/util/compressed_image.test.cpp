@@ -0,0 +1,72 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/compressed_image.hpp>
+
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+const uint32_t GL_COMPRESSED_RGB8_ETC2 = 0x9274;
+
+// A KTX file with a 4x4 ETC2 texture, whose single block is 8 bytes.
+std::vector<uint8_t> ktx(bool swapped = false) {
+    std::vector<uint8_t> data = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    auto write = [&] (uint32_t value) {
+        if (swapped) {
+            value = ((value & 0x000000FF) << 24) | ((value & 0x0000FF00) << 8) |
+                    ((value & 0x00FF0000) >> 8) | ((value & 0xFF000000) >> 24);
+        }
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(value));
+    };
+    write(0x04030201);              // endianness
+    write(0);                       // glType
+    write(1);                       // glTypeSize
+    write(0);                       // glFormat
+    write(GL_COMPRESSED_RGB8_ETC2); // glInternalFormat
+    write(0x1907);                  // glBaseInternalFormat
+    write(4);                       // pixelWidth
+    write(4);                       // pixelHeight
+    write(0);                       // pixelDepth
+    write(0);                       // numberOfArrayElements
+    write(1);                       // numberOfFaces
+    write(1);                       // numberOfMipmapLevels
+    write(4);                       // bytesOfKeyValueData
+    write(0);                       // key/value data
+    write(8);                       // imageSize
+    for (uint8_t i = 0; i < 8; i++) {
+        data.push_back(i);
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(CompressedImage, KTX) {
+    for (bool swapped : { false, true }) {
+        const std::vector<uint8_t> data = ktx(swapped);
+        ASSERT_TRUE(isKTX(data.data(), data.size()));
+
+        CompressedImage image = decodeKTX(data.data(), data.size());
+        EXPECT_EQ(Size(4, 4), image.size);
+        EXPECT_EQ(GL_COMPRESSED_RGB8_ETC2, image.format);
+        ASSERT_EQ(8u, image.bytes);
+        for (uint8_t i = 0; i < 8; i++) {
+            EXPECT_EQ(i, image.data[i]);
+        }
+    }
+}
+
+TEST(CompressedImage, KTXErrors) {
+    const std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n', 0, 0, 0, 0 };
+    EXPECT_FALSE(isKTX(png.data(), png.size()));
+
+    std::vector<uint8_t> data = ktx();
+    EXPECT_THROW(decodeKTX(data.data(), data.size() - 1), std::runtime_error);
+
+    // An uncompressed texture has a type.
+    data[16] = 1;
+    EXPECT_THROW(decodeKTX(data.data(), data.size()), std::runtime_error);
+}
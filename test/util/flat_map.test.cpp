@@ -0,0 +1,75 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/flat_map.hpp>
+#include <mbgl/tile/tile_id.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+using namespace mbgl::util;
+
+TEST(FlatMap, SortedIteration) {
+    FlatMap<OverscaledTileID, std::string> map;
+    EXPECT_TRUE(map.emplace(OverscaledTileID{ 2, 1, 1 }, "2/1/1").second);
+    EXPECT_TRUE(map.emplace(OverscaledTileID{ 1, 0, 0 }, "1/0/0").second);
+    EXPECT_TRUE(map.emplace(OverscaledTileID{ 2, 0, 1 }, "2/0/1").second);
+
+    // Existing entries are kept, like those of std::map.
+    auto result = map.emplace(OverscaledTileID{ 1, 0, 0 }, "other");
+    EXPECT_FALSE(result.second);
+    EXPECT_EQ("1/0/0", result.first->second);
+
+    std::vector<std::string> values;
+    for (const auto& pair : map) {
+        values.push_back(pair.second);
+    }
+    EXPECT_EQ((std::vector<std::string>{ "1/0/0", "2/0/1", "2/1/1" }), values);
+    EXPECT_EQ(3u, map.size());
+}
+
+TEST(FlatMap, Lookup) {
+    FlatMap<OverscaledTileID, int> map;
+    map.emplace(OverscaledTileID{ 3, 2, 5 }, 1);
+    map[OverscaledTileID{ 3, 4, 1 }] = 2;
+
+    EXPECT_EQ(1, map.at(OverscaledTileID{ 3, 2, 5 }));
+    EXPECT_EQ(2, map.find(OverscaledTileID{ 3, 4, 1 })->second);
+    EXPECT_EQ(1u, map.count(OverscaledTileID{ 3, 4, 1 }));
+    EXPECT_EQ(0u, map.count(OverscaledTileID{ 3, 4, 2 }));
+    EXPECT_TRUE(map.find(OverscaledTileID{ 4, 2, 5 }) == map.end());
+    EXPECT_THROW(map.at(OverscaledTileID{ 0, 0, 0 }), std::out_of_range);
+}
+
+TEST(FlatMap, Erase) {
+    FlatMap<OverscaledTileID, std::unique_ptr<int>> map;
+    for (uint32_t x = 0; x < 4; x++) {
+        map.emplace(OverscaledTileID{ 2, x, 0 }, std::make_unique<int>(x));
+    }
+
+    EXPECT_EQ(1u, map.erase(OverscaledTileID{ 2, 1, 0 }));
+    EXPECT_EQ(0u, map.erase(OverscaledTileID{ 2, 1, 0 }));
+
+    map.eraseIf([](const auto& pair) { return *pair.second % 2 == 0; });
+    ASSERT_EQ(1u, map.size());
+    EXPECT_EQ(3, *map.begin()->second);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+}
+
+TEST(FlatMap, EmplaceBack) {
+    // Values with reference members can't be assigned, and are only appended.
+    struct Value {
+        Value(const int& ref_) : ref(ref_) {}
+        const int& ref;
+    };
+
+    const int a = 1, b = 2;
+    FlatMap<UnwrappedTileID, Value> map;
+    map.reserve(2);
+    map.emplaceBack(UnwrappedTileID{ 1, 0, 0 }, a);
+    map.emplaceBack(UnwrappedTileID{ 1, 1, 0 }, b);
+    EXPECT_EQ(&b, &map.find(UnwrappedTileID{ 1, 1, 0 })->second.ref);
+}
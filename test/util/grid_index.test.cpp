@@ -0,0 +1,33 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/grid_index.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+
+#include <type_traits>
+
+using namespace mbgl;
+
+static_assert(std::is_trivially_copyable<IndexedSubfeature>::value,
+              "indexed subfeatures must not own memory");
+
+TEST(GridIndex, QueryDeduplicates) {
+    GridIndex<IndexedSubfeature> grid(100, 10, 0);
+    // Spans all cells.
+    grid.insert(IndexedSubfeature { 0, 0, 0, 0 }, { { 0, 0 }, { 100, 100 } });
+    // Spans two cells.
+    grid.insert(IndexedSubfeature { 1, 0, 0, 1 }, { { 5, 5 }, { 15, 5 } });
+    // In a single cell the query misses.
+    grid.insert(IndexedSubfeature { 2, 0, 0, 2 }, { { 90, 90 }, { 95, 95 } });
+
+    for (int i = 0; i < 3; i++) {
+        // Repeated queries find the same elements once each.
+        auto result = grid.query({ { 0, 0 }, { 50, 50 } });
+        ASSERT_EQ(2u, result.size());
+        EXPECT_EQ(0u, result[0].index);
+        EXPECT_EQ(1u, result[1].index);
+    }
+
+    // Elements inserted after a query are found by the next one.
+    grid.insert(IndexedSubfeature { 3, 0, 0, 3 }, { { 20, 20 }, { 40, 40 } });
+    EXPECT_EQ(3u, grid.query({ { 0, 0 }, { 50, 50 } }).size());
+}
@@ -0,0 +1,38 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/i18n.hpp>
+
+using namespace mbgl::util::i18n;
+
+TEST(I18n, CharacterClasses) {
+    EXPECT_EQ(CharacterClass::WordBreaking, getCharacterClasses(u' '));
+    EXPECT_EQ(0, getCharacterClasses(u'a'));
+
+    // 一
+    EXPECT_EQ(CharacterClass::IdeographicBreaking | CharacterClass::FixedWidthGlyph |
+              CharacterClass::UprightVertical,
+              getCharacterClasses(0x4E00));
+
+    // 、
+    EXPECT_EQ(CharacterClass::IdeographicBreaking | CharacterClass::UprightVertical |
+              CharacterClass::NeutralVertical | CharacterClass::VerticalPunctuation,
+              getCharacterClasses(0x3001));
+
+    EXPECT_EQ(CharacterClass::VerticalPunctuation, getCharacterClasses(u'!'));
+    EXPECT_EQ(0xFE15, verticalizePunctuation(u'!'));
+    EXPECT_EQ(0, verticalizePunctuation(u'a'));
+}
+
+TEST(I18n, VerticalOrientation) {
+    EXPECT_TRUE(hasRotatedVerticalOrientation(u'a'));
+    EXPECT_FALSE(hasUprightVerticalOrientation(u'a'));
+
+    // ½
+    EXPECT_TRUE(hasNeutralVerticalOrientation(0x00BD));
+    EXPECT_FALSE(hasRotatedVerticalOrientation(0x00BD));
+
+    // 가
+    EXPECT_TRUE(hasUprightVerticalOrientation(0xAC00));
+    EXPECT_TRUE(allowsFixedWidthGlyphGeneration(0xAC00));
+    EXPECT_FALSE(allowsIdeographicBreaking(0xAC00));
+}
@@ -3,6 +3,7 @@
 #include <mbgl/util/premultiply.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
+#include <mbgl/util/default_thread_pool.hpp>
 
 using namespace mbgl;
 
@@ -50,6 +51,15 @@ TEST(Image, PNGReadNoProfileAlpha) {
     EXPECT_EQ(128, image.data[3]);
 }
 
+TEST(Image, PNGReadNoProfileAlphaUnassociated) {
+    const std::string data = util::read_file("test/fixtures/image/no_profile_alpha.png");
+    UnassociatedImage image = decodeUnassociatedImage(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    EXPECT_EQ(128, image.data[0]);
+    EXPECT_EQ(0, image.data[1]);
+    EXPECT_EQ(0, image.data[2]);
+    EXPECT_EQ(128, image.data[3]);
+}
+
 TEST(Image, PNGReadProfile) {
     PremultipliedImage image = decodeImage(util::read_file("test/fixtures/image/profile.png"));
     EXPECT_EQ(128, image.data[0]);
@@ -78,6 +88,17 @@ TEST(Image, JPEGTile) {
     EXPECT_EQ(256u, image.size.height);
 }
 
+TEST(Image, JPEGTileUnassociated) {
+    const std::string data = util::read_file("test/fixtures/image/tile.jpeg");
+    UnassociatedImage image = decodeUnassociatedImage(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    EXPECT_EQ(256u, image.size.width);
+    EXPECT_EQ(256u, image.size.height);
+
+    // JPEGs are opaque, so both forms have the same pixels.
+    PremultipliedImage premultiplied = decodeImage(data);
+    EXPECT_TRUE(std::equal(image.data.get(), image.data.get() + image.bytes(), premultiplied.data.get()));
+}
+
 #if !defined(__ANDROID__) && !defined(__APPLE__) && !defined(QT_IMAGE_DECODERS)
 TEST(Image, WebPTile) {
     PremultipliedImage image = decodeImage(util::read_file("test/fixtures/image/tile.webp"));
@@ -128,3 +149,59 @@ TEST(Image, Premultiply) {
     EXPECT_EQ(127, image.data[2]);
     EXPECT_EQ(128, image.data[3]);
 }
+
+namespace {
+
+PremultipliedImage gradientImage(Size size) {
+    PremultipliedImage image(size);
+    for (uint32_t y = 0; y < size.height; y++) {
+        for (uint32_t x = 0; x < size.width; x++) {
+            uint8_t* pixel = image.data.get() + y * image.stride() + x * 4;
+            pixel[0] = x;
+            pixel[1] = y;
+            pixel[2] = x ^ y;
+            pixel[3] = 255;
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+TEST(Image, PNGRoundTripOptions) {
+    const PremultipliedImage rgba = gradientImage({ 300, 200 });
+    ThreadPool threadPool(2);
+
+    using Filter = PNGEncodeOptions::Filter;
+    for (Filter filter : { Filter::None, Filter::Sub, Filter::Up, Filter::Average, Filter::Paeth, Filter::Adaptive }) {
+        for (Scheduler* scheduler : { static_cast<Scheduler*>(nullptr), static_cast<Scheduler*>(&threadPool) }) {
+            PNGEncodeOptions options;
+            options.filter = filter;
+            options.compressionLevel = 1;
+            options.scheduler = scheduler;
+            options.stripeRows = 64;
+            EXPECT_EQ(rgba, decodeImage(encodePNG(rgba, options)));
+        }
+    }
+}
+
+TEST(Image, PNGPalette) {
+    PremultipliedImage rgba({ 64, 64 });
+    for (uint32_t i = 0; i < rgba.size.area(); i++) {
+        // Four colors, one of them translucent.
+        const uint8_t color = (i / 7) % 4;
+        rgba.data[i * 4 + 0] = color * 40;
+        rgba.data[i * 4 + 1] = 0;
+        rgba.data[i * 4 + 2] = 0;
+        rgba.data[i * 4 + 3] = color == 3 ? 128 : 255;
+    }
+
+    PNGEncodeOptions options;
+    const std::string indexed = encodePNG(rgba, options);
+    options.palette = false;
+    const std::string direct = encodePNG(rgba, options);
+
+    EXPECT_EQ(rgba, decodeImage(indexed));
+    EXPECT_EQ(rgba, decodeImage(direct));
+    EXPECT_LT(indexed.size(), direct.size());
+}
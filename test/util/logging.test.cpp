@@ -0,0 +1,17 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/fixture_log_observer.hpp>
+
+#include <mbgl/util/logging.hpp>
+
+using namespace mbgl;
+
+TEST(Logging, ObserverSeesEveryMessage) {
+    FixtureLog log;
+
+    // Only what reaches the platform logger is limited to a number of messages a second.
+    for (int i = 0; i < 1000; i++) {
+        Log::Warning(Event::Render, "can't find source for layer '%s'", "water");
+    }
+
+    EXPECT_EQ(1000u, log.count({ EventSeverity::Warning, Event::Render, -1, "can't find source for layer 'water'" }));
+}
@@ -2,20 +2,30 @@
 #include <mbgl/test/getrss.hpp>
 #include <mbgl/test/util.hpp>
 
+#include <mbgl/annotation/annotation.hpp>
+#include <mbgl/map/camera.hpp>
 #include <mbgl/map/map.hpp>
 #include <mbgl/map/backend_scope.hpp>
+#include <mbgl/map/memory_usage.hpp>
+#include <mbgl/gl/context.hpp>
 #include <mbgl/gl/headless_backend.hpp>
 #include <mbgl/gl/offscreen_view.hpp>
+#include <mbgl/sprite/sprite_image.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/default_thread_pool.hpp>
+#include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 
 #include <algorithm>
 #include <iostream>
 #include <iterator>
+#include <random>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -49,7 +59,7 @@ private:
         if (it != cache.end()) {
             result.data = it->second;
         } else {
-            auto data = std::make_shared<std::string>(
+            auto data = std::make_shared<Buffer>(
                 util::read_file("test/fixtures/resources/"s + path));
 
             cache.insert(it, std::make_pair(path, data));
@@ -67,7 +77,7 @@ private:
         }
     };
 
-    std::unordered_map<std::string, std::shared_ptr<std::string>> cache;
+    std::unordered_map<std::string, std::shared_ptr<const Buffer>> cache;
 };
 
 TEST(Memory, Vector) {
@@ -165,3 +175,144 @@ TEST(Memory, Footprint) {
     ASSERT_LT(rasterFootprint, 25 * 1024 * 1024) << "\
         mbgl::Map footprint over 25MB for raster styles.";
 }
+
+namespace {
+
+// The memory that the map accounts for, except for the GPU memory, which is sampled separately.
+std::size_t accountedMemory(const MemoryUsage& usage) {
+    std::size_t total = usage.glyphAtlas + usage.spriteAtlas + usage.lineAtlas + usage.fileSource;
+    for (const auto& source : usage.sources) {
+        total += source.second.tiles.total() + source.second.cachedTiles;
+    }
+    return total;
+}
+
+struct SoakSample {
+    std::size_t rss;
+    std::size_t map;
+    std::size_t gpu;
+};
+
+// The largest value of a measure in the samples from the first to the last.
+template <typename Measure>
+std::size_t peak(const std::vector<SoakSample>& samples, std::size_t first, std::size_t last, Measure measure) {
+    std::size_t result = 0;
+    for (std::size_t i = first; i < last; ++i) {
+        result = std::max(result, measure(samples[i]));
+    }
+    return result;
+}
+
+} // namespace
+
+// Runs a map in continuous mode for as many seconds as MEMORY_SOAK_SECONDS says, moving the
+// camera at random, switching between a vector and a raster style and replacing annotations,
+// and fails if its memory keeps growing: the peaks of the second half of the run must stay close
+// to those of the first. To soak a map for four hours, use
+// `MEMORY_SOAK_SECONDS=14400 make run-test-Memory.Soak`.
+TEST(Memory, Soak) {
+    const char* seconds = getenv("MEMORY_SOAK_SECONDS");
+    if (!seconds) {
+        return;
+    }
+
+    const Duration duration = Seconds(std::atoi(seconds));
+    const Duration sampleInterval = std::max<Duration>(duration / 100, Seconds(1));
+
+    MemoryTest test;
+    gl::Context& context = test.backend.getContext();
+
+    // Warm up the view and the context, so that only what the map holds counts against it.
+    {
+        Map map(test.backend, test.view.getSize(), 1, test.fileSource, test.threadPool, MapMode::Still);
+        map.setStyleURL("mapbox://streets");
+        test::render(map, test.view);
+    }
+    test.runLoop.runOnce();
+    context.reset();
+    const std::size_t contextBaseline = context.getMemoryUsage();
+
+    std::vector<SoakSample> samples;
+    {
+        Map map(test.backend, test.view.getSize(), 1, test.fileSource, test.threadPool, MapMode::Continuous);
+        map.addAnnotationIcon("default_marker", std::make_shared<SpriteImage>(
+            decodeImage(util::read_file("test/fixtures/sprites/default_marker.png")), 1.0));
+
+        // The same seed for every run, so that runs of the same length do the same.
+        std::mt19937 random(0);
+        auto uniform = [&] (double min, double max) {
+            return std::uniform_real_distribution<double>(min, max)(random);
+        };
+
+        std::vector<AnnotationID> annotations;
+        const TimePoint start = Clock::now();
+        TimePoint nextSample = start;
+
+        for (std::size_t step = 0; Clock::now() - start < duration; ++step) {
+            if (step % 20 == 0) {
+                map.setStyleURL(step % 40 == 0 ? "mapbox://streets" : "mapbox://satellite");
+            }
+
+            for (const auto& id : annotations) {
+                map.removeAnnotation(id);
+            }
+            annotations.clear();
+            for (int i = 0; i < 20; ++i) {
+                annotations.push_back(map.addAnnotation(SymbolAnnotation {
+                    Point<double>(uniform(-180, 180), uniform(-80, 80)), "default_marker" }));
+            }
+            LineString<double> line;
+            for (int i = 0; i < 10; ++i) {
+                line.emplace_back(uniform(-180, 180), uniform(-80, 80));
+            }
+            annotations.push_back(map.addAnnotation(LineAnnotation { line }));
+
+            CameraOptions camera;
+            camera.center = LatLng { uniform(-60, 60), uniform(-180, 180) };
+            camera.zoom = uniform(0, 16);
+            camera.angle = uniform(0, util::M2PI);
+            camera.pitch = uniform(0, 60) * util::DEG2RAD;
+            const Duration animation = step % 2 ? Milliseconds(250) : Duration::zero();
+            map.easeTo(camera, AnimationOptions { animation });
+
+            // Draws frames until the camera has arrived and what it shows has loaded.
+            const TimePoint stepEnd = Clock::now() + animation;
+            do {
+                test.runLoop.runOnce();
+                map.render(test.view);
+            } while (Clock::now() < stepEnd || !map.isFullyLoaded());
+
+            if (Clock::now() >= nextSample) {
+                nextSample += sampleInterval;
+                samples.push_back({ test::getCurrentRSS(), accountedMemory(map.getMemoryUsage()),
+                                    context.getMemoryUsage() });
+            }
+        }
+
+        map.removeAnnotationIcon("default_marker");
+    }
+
+    // Everything the map created in the context is released with it.
+    test.runLoop.runOnce();
+    context.reset();
+    EXPECT_TRUE(context.empty());
+    EXPECT_EQ(contextBaseline, context.getMemoryUsage());
+
+    ASSERT_GE(samples.size(), 4u);
+
+    // The first sample is taken before the caches have filled, so it doesn't count.
+    const std::size_t half = samples.size() / 2;
+    auto expectBounded = [&] (const char* name, auto measure, std::size_t slack) {
+        const std::size_t first = peak(samples, 1, half, measure);
+        const std::size_t second = peak(samples, half, samples.size(), measure);
+        std::string values;
+        for (const auto& sample : samples) {
+            values += " " + std::to_string(measure(sample));
+        }
+        EXPECT_LE(second, first + first / 10 + slack)
+            << name << " grew from " << first << " to " << second << "; samples:" << values;
+    };
+    expectBounded("RSS", [] (const SoakSample& s) { return s.rss; }, 16 * 1024 * 1024);
+    expectBounded("Map memory", [] (const SoakSample& s) { return s.map; }, 1024 * 1024);
+    expectBounded("GPU memory", [] (const SoakSample& s) { return s.gpu; }, 1024 * 1024);
+}
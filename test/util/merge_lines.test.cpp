@@ -115,6 +115,28 @@ TEST(MergeLines, CircularLines) {
     }
 }
 
+TEST(MergeLines, ReverseOrder) {
+    // mergeLines merges lines that come in the reverse order into the last of them
+    std::vector<mbgl::SymbolFeature> input;
+    input.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {{{6, 0}, {7, 0}}, {{0, 1}}}, {}, aaa, {}, 0 });
+    input.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {{{4, 0}, {5, 0}, {6, 0}}}, {}, aaa, {}, 0 });
+    input.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {{{2, 0}, {3, 0}, {4, 0}}}, {}, aaa, {}, 0 });
+    input.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {{{0, 0}, {1, 0}, {2, 0}}}, {}, aaa, {}, 0 });
+
+    const std::vector<GeometryTileFeatureStub> expected = {
+        { {}, FeatureType::LineString, {{{0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0}}, {{0, 1}}}, {} },
+        { {}, FeatureType::LineString, {{}}, {} },
+        { {}, FeatureType::LineString, {{}}, {} },
+        { {}, FeatureType::LineString, {{}}, {} }
+    };
+
+    mbgl::util::mergeLines(input);
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(input[i].geometry, expected[i].getGeometries());
+    }
+}
+
 TEST(MergeLines, EmptyOuterGeometry) {
     std::vector<mbgl::SymbolFeature> input;
     input.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {}, {}, aaa, {}, 0 });
@@ -0,0 +1,77 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/monotonic_arena.hpp>
+
+#include <cstdint>
+
+using namespace mbgl;
+using namespace mbgl::util;
+
+TEST(MonotonicArena, Alignment) {
+    MonotonicArena arena(64);
+
+    arena.allocate(1, 1);
+    void* aligned = arena.allocate(8, 8);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(aligned) % 8);
+
+    arena.allocate(3, 1);
+    aligned = arena.allocate(16, 16);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(aligned) % 16);
+}
+
+TEST(MonotonicArena, Reset) {
+    MonotonicArena arena(64);
+
+    void* first = arena.allocate(32, 8);
+    arena.allocate(32, 8);
+    arena.allocate(32, 8);
+    const std::size_t capacity = arena.getCapacity();
+    EXPECT_LE(96u, capacity);
+
+    // The blocks are kept, so that the same allocations don't grow the arena again.
+    arena.reset();
+    EXPECT_EQ(first, arena.allocate(32, 8));
+    arena.allocate(32, 8);
+    arena.allocate(32, 8);
+    EXPECT_EQ(capacity, arena.getCapacity());
+}
+
+TEST(MonotonicArena, LargeAllocation) {
+    MonotonicArena arena(64);
+
+    arena.allocate(16, 8);
+    void* large = arena.allocate(1024, 8);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(large) % 8);
+    EXPECT_LE(64u + 1024u, arena.getCapacity());
+
+    // Fits into the remainder of the block that was appended for the large allocation.
+    const std::size_t capacity = arena.getCapacity();
+    arena.allocate(8, 8);
+    EXPECT_EQ(capacity, arena.getCapacity());
+}
+
+namespace {
+
+class Counted {
+public:
+    Counted(int& destroyed_) : destroyed(destroyed_) {}
+    ~Counted() { destroyed++; }
+
+private:
+    int& destroyed;
+};
+
+} // namespace
+
+TEST(MonotonicArena, ArenaPtr) {
+    MonotonicArena arena;
+    int destroyed = 0;
+
+    {
+        ArenaPtr<Counted> inArena(arena.make<Counted>(destroyed), true);
+        ArenaPtr<Counted> onHeap(new Counted(destroyed));
+    }
+    EXPECT_EQ(2, destroyed);
+
+    arena.reset();
+}
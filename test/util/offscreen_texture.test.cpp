@@ -8,6 +8,8 @@
 
 #include <mbgl/util/offscreen_texture.hpp>
 
+#include <cstring>
+
 using namespace mbgl;
 
 TEST(OffscreenTexture, EmptyRed) {
@@ -23,6 +25,39 @@ TEST(OffscreenTexture, EmptyRed) {
     test::checkImage("test/fixtures/offscreen_texture/empty-red", image, 0, 0);
 }
 
+TEST(OffscreenTexture, PipelinedReadback) {
+    HeadlessBackend backend { test::sharedDisplay() };
+    BackendScope scope { backend };
+    OffscreenView view(backend.getContext(), { 512, 256 });
+    view.bind();
+
+    // Only the bottom half is cleared, so that the images would differ if they weren't flipped.
+    auto render = [&] (float red, float green) {
+        MBGL_CHECK_ERROR(glClearColor(0.0f, 0.0f, 1.0f, 1.0f));
+        MBGL_CHECK_ERROR(glClear(GL_COLOR_BUFFER_BIT));
+        MBGL_CHECK_ERROR(glEnable(GL_SCISSOR_TEST));
+        MBGL_CHECK_ERROR(glScissor(0, 0, 512, 128));
+        MBGL_CHECK_ERROR(glClearColor(red, green, 0.0f, 1.0f));
+        MBGL_CHECK_ERROR(glClear(GL_COLOR_BUFFER_BIT));
+        MBGL_CHECK_ERROR(glDisable(GL_SCISSOR_TEST));
+    };
+
+    render(1.0f, 0.0f);
+    const auto red = view.readStillImage();
+    view.startReadStillImage();
+
+    render(0.0f, 1.0f);
+    const auto green = view.readStillImage();
+    view.startReadStillImage();
+
+    auto first = view.finishReadStillImage();
+    auto second = view.finishReadStillImage();
+    ASSERT_EQ(red.size, first.size);
+    EXPECT_EQ(0, std::memcmp(red.data.get(), first.data.get(), red.bytes()));
+    ASSERT_EQ(green.size, second.size);
+    EXPECT_EQ(0, std::memcmp(green.data.get(), second.data.get(), green.bytes()));
+}
+
 struct Shader {
     Shader(const GLchar* vertex, const GLchar* fragment) {
         program = MBGL_CHECK_ERROR(glCreateProgram());
@@ -3,6 +3,9 @@
 
 #include <mbgl/test/util.hpp>
 
+#include <thread>
+#include <vector>
+
 using namespace mbgl::util;
 
 TEST(RunLoop, Stop) {
@@ -50,3 +53,57 @@ TEST(RunLoop, MultipleRun) {
 
     EXPECT_TRUE(secondTimeout);
 }
+
+TEST(RunLoop, InvokeOrder) {
+    RunLoop loop(RunLoop::Type::New);
+
+    const int producers = 4;
+    const int tasksPerProducer = 1000;
+    std::vector<int> last(producers, -1);
+    int count = 0;
+    bool ordered = true;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < tasksPerProducer; i++) {
+                loop.invoke([&, p, i] {
+                    ordered = ordered && last[p] == i - 1;
+                    last[p] = i;
+                    if (++count == producers * tasksPerProducer) {
+                        loop.stop();
+                    }
+                });
+            }
+        });
+    }
+
+    loop.run();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(producers * tasksPerProducer, count);
+}
+
+TEST(RunLoop, InvokeWhileProcessing) {
+    RunLoop loop(RunLoop::Type::New);
+
+    std::vector<int> order;
+    loop.invoke([&] {
+        order.push_back(1);
+        // Tasks posted by a task run after those that were already queued.
+        loop.invoke([&] {
+            order.push_back(3);
+            loop.stop();
+        });
+    });
+    loop.invoke([&] {
+        order.push_back(2);
+    });
+
+    loop.run();
+
+    EXPECT_EQ((std::vector<int> { 1, 2, 3 }), order);
+}
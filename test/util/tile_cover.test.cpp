@@ -4,6 +4,8 @@
 
 #include <gtest/gtest.h>
 
+#include <set>
+
 using namespace mbgl;
 
 TEST(TileCover, Empty) {
@@ -83,3 +85,91 @@ TEST(TileCover, SanFranciscoZ0Wrapped) {
     EXPECT_EQ((std::vector<UnwrappedTileID>{ { 0, 1, 0 } }),
               util::tileCover(sanFranciscoWrapped, 0));
 }
+
+TEST(TileCover, PitchLOD) {
+    Transform transform;
+    transform.resize({ 2048, 1024 });
+    transform.setLatLng({ 37.7449, -122.4474 });
+    transform.setZoom(10);
+    transform.setPitch(60.0 * M_PI / 180.0);
+
+    const auto full = util::tileCover(transform.getState(), 10);
+    const auto lod = util::lodTileCover(transform.getState(), 10, 0);
+    EXPECT_LT(lod.size(), full.size());
+
+    // The tile at the center keeps its zoom level; the farthest ones have lower ones.
+    ASSERT_FALSE(lod.empty());
+    EXPECT_EQ(full.front(), lod.front());
+    EXPECT_LT(lod.back().canonical.z, 10);
+
+    for (const auto& a : lod) {
+        EXPECT_LE(a.canonical.z, 10);
+        for (const auto& b : lod) {
+            EXPECT_TRUE(a == b || !a.isChildOf(b));
+        }
+    }
+}
+
+TEST(TileCover, PitchLODMinZoom) {
+    Transform transform;
+    transform.resize({ 512, 512 });
+    transform.setLatLng({ 37.7449, -122.4474 });
+    transform.setZoom(10);
+    transform.setPitch(60.0 * M_PI / 180.0);
+
+    for (const auto& id : util::lodTileCover(transform.getState(), 10, 10)) {
+        EXPECT_EQ(10, id.canonical.z);
+    }
+}
+
+TEST(TileCover, Enumerate) {
+    for (int32_t z : { 0, 1, 10, 14 }) {
+        const auto expected = util::tileCover(sanFrancisco, z);
+
+        util::TileCover cover(sanFrancisco, z);
+        EXPECT_EQ(expected.size(), cover.size());
+
+        std::vector<UnwrappedTileID> tiles;
+        while (auto tile = cover.next()) {
+            tiles.push_back(*tile);
+        }
+        EXPECT_EQ(expected.size(), tiles.size());
+        EXPECT_EQ(std::set<UnwrappedTileID>(expected.begin(), expected.end()),
+                  std::set<UnwrappedTileID>(tiles.begin(), tiles.end()));
+    }
+}
+
+TEST(TileCover, EnumerateZOrder) {
+    util::TileCover cover(LatLngBounds::world(), 2);
+    EXPECT_EQ(16u, cover.size());
+
+    std::vector<UnwrappedTileID> tiles;
+    while (auto tile = cover.next()) {
+        tiles.push_back(*tile);
+    }
+
+    EXPECT_EQ((std::vector<UnwrappedTileID>{
+                  { 2, 0, 0 }, { 2, 1, 0 }, { 2, 0, 1 }, { 2, 1, 1 },
+                  { 2, 2, 0 }, { 2, 3, 0 }, { 2, 2, 1 }, { 2, 3, 1 },
+                  { 2, 0, 2 }, { 2, 1, 2 }, { 2, 0, 3 }, { 2, 1, 3 },
+                  { 2, 2, 2 }, { 2, 3, 2 }, { 2, 2, 3 }, { 2, 3, 3 },
+              }),
+              tiles);
+}
+
+TEST(TileCover, EnumerateEmpty) {
+    util::TileCover empty(LatLngBounds::empty(), 0);
+    EXPECT_EQ(0u, empty.size());
+    EXPECT_FALSE(empty.next());
+
+    util::TileCover singleton(LatLngBounds::singleton({ 0, 0 }), 1);
+    EXPECT_EQ(0u, singleton.size());
+    EXPECT_FALSE(singleton.next());
+}
+
+TEST(TileCover, EnumerateWrapped) {
+    util::TileCover cover(sanFranciscoWrapped, 0);
+    EXPECT_EQ(1u, cover.size());
+    EXPECT_EQ(UnwrappedTileID(0, 1, 0), *cover.next());
+    EXPECT_FALSE(cover.next());
+}